@@ -721,9 +721,11 @@ GeographicLib.GeodesicLine = {};
     return vals;
   };
 
-  // return a12, s12, azi1, azi2, m12, M12, M21, S12
-  g.Geodesic.prototype.GenInverse = function(lat1, lon1, lat2, lon2, outmask) {
-    var vals = {};
+  // return a12, s12, azi1, azi2, m12, M12, M21, S12; these are stored in
+  // vals, if given, instead of in a new object.
+  g.Geodesic.prototype.GenInverse = function(lat1, lon1, lat2, lon2, outmask,
+                                             vals) {
+    vals = vals || {};
     outmask &= g.OUT_MASK;
     // Compute longitude difference (AngDiff does this carefully).  Result is
     // in [-180, 180] but -180 is only for west-going geodesics.  180 is for
@@ -1089,13 +1091,15 @@ GeographicLib.GeodesicLine = {};
     return vals;
   };
 
-  // return a12, lat2, lon2, azi2, s12, m12, M12, M21, S12
+  // return a12, lat2, lon2, azi2, s12, m12, M12, M21, S12; these are
+  // stored in vals, if given, instead of in a new object.
   g.Geodesic.prototype.GenDirect = function (lat1, lon1, azi1,
-                                             arcmode, s12_a12, outmask) {
+                                             arcmode, s12_a12, outmask,
+                                             vals) {
     var line = new l.GeodesicLine(this, lat1, lon1, azi1,
      // Automatically supply DISTANCE_IN if necessary
      outmask | (arcmode ? g.NONE : g.DISTANCE_IN));
-    return line.GenPosition(arcmode, s12_a12, outmask);
+    return line.GenPosition(arcmode, s12_a12, outmask, vals);
   };
 
   g.WGS84 = new g.Geodesic(GeographicLib.Constants.WGS84.a,
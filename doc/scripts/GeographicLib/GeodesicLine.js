@@ -118,10 +118,11 @@
     }
   };
 
-  // return a12, lat2, lon2, azi2, s12, m12, M12, M21, S12
+  // return a12, lat2, lon2, azi2, s12, m12, M12, M21, S12; these are
+  // stored in vals, if given, instead of in a new object.
   l.GeodesicLine.prototype.GenPosition = function(arcmode, s12_a12,
-                                                  outmask) {
-    var vals = {};
+                                                  outmask, vals) {
+    vals = vals || {};
     outmask &= this._caps & g.OUT_MASK;
     if (!( arcmode || (this._caps & g.DISTANCE_IN & g.OUT_MASK) )) {
       // Uninitialized or impossible distance calculation requested
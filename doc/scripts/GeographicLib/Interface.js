@@ -17,7 +17,7 @@
  *    https://dx.doi.org/10.1007/s00190-012-0578-z
  *    Addenda: http://geographiclib.sf.net/geod-addenda.html
  *
- * Copyright (c) Charles Karney (2011-2014) <charles@karney.com> and licensed
+ * Copyright (c) Charles Karney (2011-2015) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * http://geographiclib.sourceforge.net/
  **********************************************************************
@@ -55,6 +55,27 @@
  *   GeographicLib.Geodesic.ALL
  *
  **********************************************************************
+ * GeographicLib.Geodesic.WGS84.InverseArray(lat1, lon1, lat2, lon2,
+ *                                           s12, azi1, azi2,
+ *                                           m12, M12, M21, S12);
+ * GeographicLib.Geodesic.WGS84.DirectArray(lat1, lon1, azi1, s12,
+ *                                          lat2, lon2, azi2, outmask);
+ *
+ * solve many inverse (or direct) problems in one call.  The inputs are
+ * arrays (typically Float64Arrays) of equal length n.  The results are
+ * written into the following arguments which must be arrays of length n
+ * (typically preallocated Float64Arrays) supplied by the caller (so that
+ * they can be reused from one call to the next).  Any output may be given
+ * as null (or omitted at the end of the argument list) and only the
+ * results needed for the supplied outputs are computed.  The results for
+ * the points are passed through a single object (the optional last
+ * argument of GenInverse and GenDirect), so that no result object is
+ * allocated for each point.  If
+ * a point is invalid (see Inverse and Direct), the corresponding outputs
+ * are set to NaN instead of an exception being thrown.  The only flag
+ * used from outmask in DirectArray is LONG_UNROLL.
+ *
+ **********************************************************************
  * GeographicLib.Geodesic.WGS84.InversePath(lat1, lon1, lat2, lon2, ds12, maxk);
  * GeographicLib.Geodesic.WGS84.DirectPath(lat1, lon1, azi1, s12, ds12, maxk);
  *
@@ -152,6 +173,75 @@
     return result;
   };
 
+  g.Geodesic.CheckArray = function(n, x) {
+    if (x && x.length !== n)
+      throw new Error("array lengths differ: " + x.length + " != " + n);
+    return x ? true : false;
+  };
+
+  g.Geodesic.prototype.InverseArray = function(lat1, lon1, lat2, lon2,
+                                               s12, azi1, azi2,
+                                               m12, M12, M21, S12) {
+    var n = lat1.length, c = g.Geodesic.CheckArray;
+    c(n, lon1); c(n, lat2); c(n, lon2);
+    var
+    ps12 = c(n, s12), pazi1 = c(n, azi1), pazi2 = c(n, azi2),
+    pm12 = c(n, m12), pM12 = c(n, M12), pM21 = c(n, M21), pS12 = c(n, S12),
+    outmask = (ps12 ? g.DISTANCE : g.NONE) |
+      (pazi1 || pazi2 ? g.AZIMUTH : g.NONE) |
+      (pm12 ? g.REDUCEDLENGTH : g.NONE) |
+      (pM12 || pM21 ? g.GEODESICSCALE : g.NONE) |
+      (pS12 ? g.AREA : g.NONE),
+    vals = {}, i;                 // vals is reused for all the points
+    for (i = 0; i < n; ++i) {
+      if (Math.abs(lat1[i]) <= 90 && lon1[i] >= -540 && lon1[i] < 540 &&
+          Math.abs(lat2[i]) <= 90 && lon2[i] >= -540 && lon2[i] < 540) {
+        this.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], outmask, vals);
+        if (ps12) s12[i] = vals.s12;
+        if (pazi1) azi1[i] = vals.azi1;
+        if (pazi2) azi2[i] = vals.azi2;
+        if (pm12) m12[i] = vals.m12;
+        if (pM12) M12[i] = vals.M12;
+        if (pM21) M21[i] = vals.M21;
+        if (pS12) S12[i] = vals.S12;
+      } else {
+        if (ps12) s12[i] = Number.NaN;
+        if (pazi1) azi1[i] = Number.NaN;
+        if (pazi2) azi2[i] = Number.NaN;
+        if (pm12) m12[i] = Number.NaN;
+        if (pM12) M12[i] = Number.NaN;
+        if (pM21) M21[i] = Number.NaN;
+        if (pS12) S12[i] = Number.NaN;
+      }
+    }
+  };
+
+  g.Geodesic.prototype.DirectArray = function(lat1, lon1, azi1, s12,
+                                              lat2, lon2, azi2, outmask) {
+    var n = lat1.length, c = g.Geodesic.CheckArray;
+    c(n, lon1); c(n, azi1); c(n, s12);
+    var
+    plat2 = c(n, lat2), plon2 = c(n, lon2), pazi2 = c(n, azi2),
+    mask = (plat2 ? g.LATITUDE : g.NONE) |
+      (plon2 ? g.LONGITUDE | (outmask & g.LONG_UNROLL) : g.NONE) |
+      (pazi2 ? g.AZIMUTH : g.NONE),
+    vals = {}, i;                 // vals is reused for all the points
+    for (i = 0; i < n; ++i) {
+      if (Math.abs(lat1[i]) <= 90 && lon1[i] >= -540 && lon1[i] < 540 &&
+          azi1[i] >= -540 && azi1[i] < 540 && isFinite(s12[i])) {
+        this.GenDirect(lat1[i], lon1[i], m.AngNormalize(azi1[i]),
+                       false, s12[i], mask, vals);
+        if (plat2) lat2[i] = vals.lat2;
+        if (plon2) lon2[i] = vals.lon2;
+        if (pazi2) azi2[i] = vals.azi2;
+      } else {
+        if (plat2) lat2[i] = Number.NaN;
+        if (plon2) lon2[i] = Number.NaN;
+        if (pazi2) azi2[i] = Number.NaN;
+      }
+    }
+  };
+
   g.Geodesic.prototype.InversePath =
     function(lat1, lon1, lat2, lon2, ds12, maxk) {
     var t = this.Inverse(lat1, lon1, lat2, lon2);
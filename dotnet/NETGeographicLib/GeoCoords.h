@@ -28,8 +28,8 @@ namespace NETGeographicLib
    * and longitude were given then the UTM/UPS coordinates follows the standard
    * conventions.
    *
-   * The mutable state consists of the UTM or UPS coordinates for a alternate
-   * zone.  A method SetAltZone is provided to set the alternate UPS/UTM zone.
+   * In addition, the UTM or UPS coordinates for a alternate zone are held.
+   * A method SetAltZone is provided to set the alternate UPS/UTM zone.
    *
    * Methods are provided to return the geographic coordinates, the input UTM
    * or UPS coordinates (and associated meridian convergence and scale), or
@@ -460,6 +460,89 @@ double Geodesic::GenInverse(double lat1, double lon1, double lat2, double lon2,
     return out;
 }
 
+//*****************************************************************************
+void Geodesic::DirectBatch(array<double>^ lat1, array<double>^ lon1,
+                           array<double>^ azi1, array<double>^ s12,
+                           array<double>^ lat2, array<double>^ lon2,
+                           array<double>^ azi2)
+{
+    int n = BatchArray::Length( lat1, -1 );
+    BatchArray::Length( lon1, n );
+    BatchArray::Length( azi1, n );
+    BatchArray::Length( s12, n );
+    BatchArray::Check( lat2, n );
+    BatchArray::Check( lon2, n );
+    BatchArray::Check( azi2, n );
+    unsigned outmask =
+        (lat2 != nullptr ? GeographicLib::Geodesic::LATITUDE : 0U) |
+        (lon2 != nullptr ? GeographicLib::Geodesic::LONGITUDE : 0U) |
+        (azi2 != nullptr ? GeographicLib::Geodesic::AZIMUTH : 0U);
+    pin_ptr<double> plat1 = BatchArray::Data( lat1 ),
+        plon1 = BatchArray::Data( lon1 ), pazi1 = BatchArray::Data( azi1 ),
+        ps12 = BatchArray::Data( s12 ), plat2 = BatchArray::Data( lat2 ),
+        plon2 = BatchArray::Data( lon2 ), pazi2 = BatchArray::Data( azi2 );
+    m_pGeodesic->DirectBatch( plat1, plon1, pazi1, ps12, size_t(n),
+                              plat2, plon2, pazi2, outmask );
+}
+
+//*****************************************************************************
+void Geodesic::InverseBatch(array<double>^ lat1, array<double>^ lon1,
+                            array<double>^ lat2, array<double>^ lon2,
+                            array<double>^ s12, array<double>^ azi1,
+                            array<double>^ azi2)
+{
+    InverseBatch( lat1, lon1, lat2, lon2, s12, azi1, azi2,
+                  nullptr, nullptr, nullptr, nullptr );
+}
+
+//*****************************************************************************
+void Geodesic::InverseBatch(array<double>^ lat1, array<double>^ lon1,
+                            array<double>^ lat2, array<double>^ lon2,
+                            array<double>^ s12, array<double>^ azi1,
+                            array<double>^ azi2, array<double>^ m12,
+                            array<double>^ M12, array<double>^ M21,
+                            array<double>^ S12)
+{
+    int n = BatchArray::Length( lat1, -1 );
+    BatchArray::Length( lon1, n );
+    BatchArray::Length( lat2, n );
+    BatchArray::Length( lon2, n );
+    BatchArray::Check( s12, n );
+    BatchArray::Check( azi1, n );
+    BatchArray::Check( azi2, n );
+    BatchArray::Check( m12, n );
+    BatchArray::Check( M12, n );
+    BatchArray::Check( M21, n );
+    BatchArray::Check( S12, n );
+    // GEODESICSCALE sets both M12 and M21 and AZIMUTH both azi1 and azi2, so
+    // the missing partner of a requested array is given scratch space.
+    if ( (azi1 == nullptr) != (azi2 == nullptr) )
+    {
+        if ( azi1 == nullptr ) azi1 = gcnew array<double>( n );
+        else azi2 = gcnew array<double>( n );
+    }
+    if ( (M12 == nullptr) != (M21 == nullptr) )
+    {
+        if ( M12 == nullptr ) M12 = gcnew array<double>( n );
+        else M21 = gcnew array<double>( n );
+    }
+    unsigned outmask =
+        (s12 != nullptr ? GeographicLib::Geodesic::DISTANCE : 0U) |
+        (azi1 != nullptr ? GeographicLib::Geodesic::AZIMUTH : 0U) |
+        (m12 != nullptr ? GeographicLib::Geodesic::REDUCEDLENGTH : 0U) |
+        (M12 != nullptr ? GeographicLib::Geodesic::GEODESICSCALE : 0U) |
+        (S12 != nullptr ? GeographicLib::Geodesic::AREA : 0U);
+    pin_ptr<double> plat1 = BatchArray::Data( lat1 ),
+        plon1 = BatchArray::Data( lon1 ), plat2 = BatchArray::Data( lat2 ),
+        plon2 = BatchArray::Data( lon2 ), ps12 = BatchArray::Data( s12 ),
+        pazi1 = BatchArray::Data( azi1 ), pazi2 = BatchArray::Data( azi2 ),
+        pm12 = BatchArray::Data( m12 ), pM12 = BatchArray::Data( M12 ),
+        pM21 = BatchArray::Data( M21 ), pS12 = BatchArray::Data( S12 );
+    m_pGeodesic->GenInverseBatch( plat1, plon1, plat2, plon2, size_t(n),
+                                  outmask, ps12, pazi1, pazi2,
+                                  pm12, pM12, pM21, pS12, 0 );
+}
+
 //*****************************************************************************
 System::IntPtr^ Geodesic::GetUnmanaged()
 {
@@ -688,7 +688,95 @@ namespace NETGeographicLib
                         [System::Runtime::InteropServices::Out] double% m12,
                         [System::Runtime::InteropServices::Out] double% M12,
                         [System::Runtime::InteropServices::Out] double% M21,
-                        [System::Runtime::InteropServices::Out] double% S12);
+
+
+        /** \name Batch versions of the direct and inverse problems.
+         **********************************************************************/
+        ///@{
+        /**
+         * Solve the direct geodesic problem for arrays of points.
+         *
+         * @param[in] lat1 array of latitudes of point 1 (degrees).
+         * @param[in] lon1 array of longitudes of point 1 (degrees).
+         * @param[in] azi1 array of azimuths at point 1 (degrees).
+         * @param[in] s12 array of distances between point 1 and point 2
+         *   (meters).
+         * @param[out] lat2 array of latitudes of point 2 (degrees).
+         * @param[out] lon2 array of longitudes of point 2 (degrees).
+         * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+         * @exception GeographicErr if an input array is null or if the arrays
+         *   have different lengths.
+         *
+         * The output arrays must be allocated by the caller.  Any of them may
+         * be null, in which case the corresponding quantity is not computed.
+         * The arrays are pinned and the calculation is carried out by
+         * GeographicLib::Geodesic::DirectBatch with a single transition to
+         * native code.  The results are identical to those returned by
+         * Geodesic::Direct.
+         **********************************************************************/
+        void DirectBatch(array<double>^ lat1, array<double>^ lon1,
+                         array<double>^ azi1, array<double>^ s12,
+                         array<double>^ lat2, array<double>^ lon2,
+                         array<double>^ azi2);
+
+        /**
+         * Solve the inverse geodesic problem for arrays of points.
+         *
+         * @param[in] lat1 array of latitudes of point 1 (degrees).
+         * @param[in] lon1 array of longitudes of point 1 (degrees).
+         * @param[in] lat2 array of latitudes of point 2 (degrees).
+         * @param[in] lon2 array of longitudes of point 2 (degrees).
+         * @param[out] s12 array of distances between point 1 and point 2
+         *   (meters).
+         * @param[out] azi1 array of azimuths at point 1 (degrees).
+         * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+         * @exception GeographicErr if an input array is null or if the arrays
+         *   have different lengths.
+         *
+         * The output arrays must be allocated by the caller.  Any of them may
+         * be null, in which case the corresponding quantity is not computed.
+         * The calculation is carried out by
+         * GeographicLib::Geodesic::GenInverseBatch with a single transition to
+         * native code.  The results are identical to those returned by
+         * Geodesic::Inverse.
+         **********************************************************************/
+        void InverseBatch(array<double>^ lat1, array<double>^ lon1,
+                          array<double>^ lat2, array<double>^ lon2,
+                          array<double>^ s12, array<double>^ azi1,
+                          array<double>^ azi2);
+
+        /**
+         * Solve the inverse geodesic problem for arrays of points returning
+         * all the geodesic quantities.
+         *
+         * @param[in] lat1 array of latitudes of point 1 (degrees).
+         * @param[in] lon1 array of longitudes of point 1 (degrees).
+         * @param[in] lat2 array of latitudes of point 2 (degrees).
+         * @param[in] lon2 array of longitudes of point 2 (degrees).
+         * @param[out] s12 array of distances between point 1 and point 2
+         *   (meters).
+         * @param[out] azi1 array of azimuths at point 1 (degrees).
+         * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+         * @param[out] m12 array of reduced lengths (meters).
+         * @param[out] M12 array of geodesic scales of point 2 relative to
+         *   point 1 (dimensionless).
+         * @param[out] M21 array of geodesic scales of point 1 relative to
+         *   point 2 (dimensionless).
+         * @param[out] S12 array of areas under the geodesics
+         *   (meters<sup>2</sup>).
+         * @exception GeographicErr if an input array is null or if the arrays
+         *   have different lengths.
+         *
+         * This is the same as the previous function with additional output
+         * arrays, any of which may be null.
+         **********************************************************************/
+        void InverseBatch(array<double>^ lat1, array<double>^ lon1,
+                          array<double>^ lat2, array<double>^ lon2,
+                          array<double>^ s12, array<double>^ azi1,
+                          array<double>^ azi2, array<double>^ m12,
+                          array<double>^ M12, array<double>^ M21,
+                          array<double>^ S12);
+        ///@}                        [System::Runtime::InteropServices::Out] double% S12);
         ///@}
 
         /** \name Interface to GeodesicLine.
@@ -213,3 +213,45 @@ double Geoid::MajorRadius::get() { return m_pGeoid->MajorRadius(); }
 
 //*****************************************************************************
 double Geoid::Flattening::get() { return m_pGeoid->Flattening(); }
+
+//*****************************************************************************
+void Geoid::HeightBatch(array<double>^ lat, array<double>^ lon,
+                        array<double>^ h)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), ph = BatchArray::Data( h );
+    try
+    {
+        m_pGeoid->HeightBatch( plat, plon, ph, size_t(n) );
+    }
+    catch ( const std::exception& err )
+    {
+        throw gcnew GeographicErr( err.what() );
+    }
+}
+
+//*****************************************************************************
+void Geoid::ConvertHeightBatch(array<double>^ lat, array<double>^ lon,
+                               array<double>^ h, ConvertFlag d,
+                               array<double>^ hout)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Length( hout, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), ph = BatchArray::Data( h ),
+        phout = BatchArray::Data( hout );
+    try
+    {
+        m_pGeoid->ConvertHeightBatch( plat, plon, ph, size_t(n),
+            static_cast<GeographicLib::Geoid::convertflag>(d), phout );
+    }
+    catch ( const std::exception& err )
+    {
+        throw gcnew GeographicErr( err.what() );
+    }
+}
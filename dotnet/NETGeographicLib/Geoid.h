@@ -242,6 +242,43 @@ namespace NETGeographicLib
         double ConvertHeight(double lat, double lon, double h,
                                  ConvertFlag d);
 
+        /**
+         * Compute the geoid heights for arrays of points.
+         *
+         * @param[in] lat array of latitudes of the points (degrees).
+         * @param[in] lon array of longitudes of the points (degrees).
+         * @param[out] h array of geoid heights (meters).
+         * @exception GeographicErr if an array is null, if the arrays have
+         *   different lengths, or if there's a problem reading the data.
+         *
+         * The output array must be allocated by the caller.  This calls
+         * GeographicLib::Geoid::HeightBatch with a single transition to native
+         * code.  The results are identical to those returned by Geoid::Height.
+         **********************************************************************/
+        void HeightBatch(array<double>^ lat, array<double>^ lon,
+                         array<double>^ h);
+
+        /**
+         * Convert arrays of heights above the geoid to heights above the
+         * ellipsoid and vice versa.
+         *
+         * @param[in] lat array of latitudes of the points (degrees).
+         * @param[in] lon array of longitudes of the points (degrees).
+         * @param[in] h array of heights of the points (meters).
+         * @param[in] d a Geoid::convertflag specifying the direction of the
+         *   conversion.
+         * @param[out] hout array of converted heights (meters); this may be
+         *   the same array as \e h.
+         * @exception GeographicErr if an array is null, if the arrays have
+         *   different lengths, or if there's a problem reading the data.
+         *
+         * This calls GeographicLib::Geoid::ConvertHeightBatch.  The results
+         * are identical to those returned by Geoid::ConvertHeight.
+         **********************************************************************/
+        void ConvertHeightBatch(array<double>^ lat, array<double>^ lon,
+                                array<double>^ h, ConvertFlag d,
+                                array<double>^ hout);
+
         ///@}
 
         /** \name Inspector functions
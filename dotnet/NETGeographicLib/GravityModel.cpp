@@ -264,3 +264,88 @@ double GravityModel::AngularVelocity::get()
 //*****************************************************************************
 double GravityModel::Flattening::get()
 { return m_pGravityModel->Flattening(); }
+
+//*****************************************************************************
+void GravityModel::GravityBatch(array<double>^ lat, array<double>^ lon,
+                                array<double>^ h, array<double>^ W,
+                                array<double>^ gx, array<double>^ gy,
+                                array<double>^ gz, int nthreads)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Length( W, n );
+    BatchArray::Length( gx, n );
+    BatchArray::Length( gy, n );
+    BatchArray::Length( gz, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ),
+        ph = BatchArray::Data( h ),
+        pW = BatchArray::Data( W ),
+        pgx = BatchArray::Data( gx ),
+        pgy = BatchArray::Data( gy ),
+        pgz = BatchArray::Data( gz );
+    m_pGravityModel->GravityBatch( plat, plon, ph, size_t(n),
+                                   pW, pgx, pgy, pgz, nthreads );
+}
+
+//*****************************************************************************
+void GravityModel::DisturbanceBatch(array<double>^ lat, array<double>^ lon,
+                                    array<double>^ h, array<double>^ T,
+                                    array<double>^ deltax,
+                                    array<double>^ deltay,
+                                    array<double>^ deltaz, int nthreads)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Length( T, n );
+    BatchArray::Length( deltax, n );
+    BatchArray::Length( deltay, n );
+    BatchArray::Length( deltaz, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ),
+        ph = BatchArray::Data( h ),
+        pT = BatchArray::Data( T ),
+        pdeltax = BatchArray::Data( deltax ),
+        pdeltay = BatchArray::Data( deltay ),
+        pdeltaz = BatchArray::Data( deltaz );
+    m_pGravityModel->DisturbanceBatch( plat, plon, ph, size_t(n),
+                                       pT, pdeltax, pdeltay, pdeltaz,
+                                       nthreads );
+}
+
+//*****************************************************************************
+void GravityModel::GeoidHeightBatch(array<double>^ lat, array<double>^ lon,
+                                    array<double>^ N, int nthreads)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( N, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ),
+        pN = BatchArray::Data( N );
+    m_pGravityModel->GeoidHeightBatch( plat, plon, size_t(n), pN, nthreads );
+}
+
+//*****************************************************************************
+void GravityModel::SphericalAnomalyBatch(array<double>^ lat, array<double>^ lon,
+                                         array<double>^ h, array<double>^ Dg01,
+                                         array<double>^ xi, array<double>^ eta,
+                                         int nthreads)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Length( Dg01, n );
+    BatchArray::Length( xi, n );
+    BatchArray::Length( eta, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ),
+        ph = BatchArray::Data( h ),
+        pDg01 = BatchArray::Data( Dg01 ),
+        pxi = BatchArray::Data( xi ),
+        peta = BatchArray::Data( eta );
+    m_pGravityModel->SphericalAnomalyBatch( plat, plon, ph, size_t(n),
+                                            pDg01, pxi, peta, nthreads );
+}
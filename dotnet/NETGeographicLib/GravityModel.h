@@ -260,6 +260,108 @@ namespace NETGeographicLib
             [System::Runtime::InteropServices::Out] double% eta);
         ///@}
 
+        /** \name Compute gravity for arrays of points
+         **********************************************************************/
+        ///@{
+        /**
+         * Evaluate the gravity at arrays of points.
+         *
+         * @param[in] lat array of geographic latitudes (degrees).
+         * @param[in] lon array of geographic longitudes (degrees).
+         * @param[in] h array of heights above the ellipsoid (meters).
+         * @param[out] W array of the sums of the gravitational and centrifugal
+         *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+         * @param[out] gx array of the easterly components of the acceleration
+         *   (m s<sup>&minus;2</sup>).
+         * @param[out] gy array of the northerly components of the acceleration
+         *   (m s<sup>&minus;2</sup>).
+         * @param[out] gz array of the upward components of the acceleration
+         *   (m s<sup>&minus;2</sup>).
+         * @param[in] nthreads the number of threads to use.
+         * @exception GeographicErr if an array is null or if the arrays have
+         *   different lengths.
+         *
+         * The output arrays must be allocated by the caller.  The arrays are
+         * pinned and GeographicLib::GravityModel::GravityBatch is called with
+         * a single transition to native code; this evaluates the spherical
+         * harmonic sums for groups of points together, dividing the points
+         * among \e nthreads threads.  The results are identical to those
+         * returned by GravityModel::Gravity.
+         **********************************************************************/
+        void GravityBatch(array<double>^ lat, array<double>^ lon,
+                          array<double>^ h, array<double>^ W,
+                          array<double>^ gx, array<double>^ gy,
+                          array<double>^ gz, int nthreads);
+
+        /**
+         * Evaluate the gravity disturbance vector at arrays of points.
+         *
+         * @param[in] lat array of geographic latitudes (degrees).
+         * @param[in] lon array of geographic longitudes (degrees).
+         * @param[in] h array of heights above the ellipsoid (meters).
+         * @param[out] T array of the disturbing potentials
+         *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+         * @param[out] deltax array of the easterly components of the
+         *   disturbance vector (m s<sup>&minus;2</sup>).
+         * @param[out] deltay array of the northerly components of the
+         *   disturbance vector (m s<sup>&minus;2</sup>).
+         * @param[out] deltaz array of the upward components of the disturbance
+         *   vector (m s<sup>&minus;2</sup>).
+         * @param[in] nthreads the number of threads to use.
+         * @exception GeographicErr if an array is null or if the arrays have
+         *   different lengths.
+         *
+         * The results are identical to those returned by
+         * GravityModel::Disturbance; see GravityModel::GravityBatch.
+         **********************************************************************/
+        void DisturbanceBatch(array<double>^ lat, array<double>^ lon,
+                              array<double>^ h, array<double>^ T,
+                              array<double>^ deltax, array<double>^ deltay,
+                              array<double>^ deltaz, int nthreads);
+
+        /**
+         * Evaluate the geoid height at arrays of points.
+         *
+         * @param[in] lat array of geographic latitudes (degrees).
+         * @param[in] lon array of geographic longitudes (degrees).
+         * @param[out] N array of the heights of the geoid above the
+         *   ReferenceEllipsoid() (meters).
+         * @param[in] nthreads the number of threads to use.
+         * @exception GeographicErr if an array is null or if the arrays have
+         *   different lengths.
+         *
+         * The results are identical to those returned by
+         * GravityModel::GeoidHeight; see GravityModel::GravityBatch.
+         **********************************************************************/
+        void GeoidHeightBatch(array<double>^ lat, array<double>^ lon,
+                              array<double>^ N, int nthreads);
+
+        /**
+         * Evaluate the components of the gravity anomaly vector using the
+         * spherical approximation at arrays of points.
+         *
+         * @param[in] lat array of geographic latitudes (degrees).
+         * @param[in] lon array of geographic longitudes (degrees).
+         * @param[in] h array of heights above the ellipsoid (meters).
+         * @param[out] Dg01 array of the gravity anomalies
+         *   (m s<sup>&minus;2</sup>).
+         * @param[out] xi array of the northerly components of the deflection
+         *   of the vertical (degrees).
+         * @param[out] eta array of the easterly components of the deflection
+         *   of the vertical (degrees).
+         * @param[in] nthreads the number of threads to use.
+         * @exception GeographicErr if an array is null or if the arrays have
+         *   different lengths.
+         *
+         * The results are identical to those returned by
+         * GravityModel::SphericalAnomaly; see GravityModel::GravityBatch.
+         **********************************************************************/
+        void SphericalAnomalyBatch(array<double>^ lat, array<double>^ lon,
+                                   array<double>^ h, array<double>^ Dg01,
+                                   array<double>^ xi, array<double>^ eta,
+                                   int nthreads);
+        ///@}
+
         /** \name Compute gravity in geocentric coordinates
          **********************************************************************/
         ///@{
@@ -178,3 +178,47 @@ double LocalCartesian::MajorRadius::get()
 //*****************************************************************************
 double LocalCartesian::Flattening::get()
 { return m_pLocalCartesian->Flattening(); }
+
+//*****************************************************************************
+void LocalCartesian::ForwardBatch(array<double>^ lat, array<double>^ lon,
+                                  array<double>^ h, array<double>^ x,
+                                  array<double>^ y, array<double>^ z,
+                                  array<double>^ M)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Length( x, n );
+    BatchArray::Length( y, n );
+    BatchArray::Length( z, n );
+    BatchArray::Check( M, 9 * n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), ph = BatchArray::Data( h ),
+        px = BatchArray::Data( x ), py = BatchArray::Data( y ),
+        pz = BatchArray::Data( z ), pM = BatchArray::Data( M );
+    double *lx = px, *ly = py, *lz = pz;
+    m_pLocalCartesian->ForwardBatch( plat, plon, ph, size_t(n),
+                                     lx, ly, lz, pM );
+}
+
+//*****************************************************************************
+void LocalCartesian::ReverseBatch(array<double>^ x, array<double>^ y,
+                                  array<double>^ z, array<double>^ lat,
+                                  array<double>^ lon, array<double>^ h,
+                                  array<double>^ M)
+{
+    int n = BatchArray::Length( x, -1 );
+    BatchArray::Length( y, n );
+    BatchArray::Length( z, n );
+    BatchArray::Length( lat, n );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( h, n );
+    BatchArray::Check( M, 9 * n );
+    pin_ptr<double> px = BatchArray::Data( x ),
+        py = BatchArray::Data( y ), pz = BatchArray::Data( z ),
+        plat = BatchArray::Data( lat ), plon = BatchArray::Data( lon ),
+        ph = BatchArray::Data( h ), pM = BatchArray::Data( M );
+    const double *lx = px, *ly = py, *lz = pz;
+    m_pLocalCartesian->ReverseBatch( lx, ly, lz, size_t(n),
+                                     plat, plon, ph, pM );
+}
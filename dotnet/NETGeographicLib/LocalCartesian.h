@@ -215,6 +215,56 @@ namespace NETGeographicLib
             [System::Runtime::InteropServices::Out] double% h,
             [System::Runtime::InteropServices::Out] array<double,2>^% M);
 
+        /**
+         * Convert arrays of geodetic coordinates to local cartesian
+         * coordinates.
+         *
+         * @param[in] lat array of latitudes of the points (degrees).
+         * @param[in] lon array of longitudes of the points (degrees).
+         * @param[in] h array of heights above the ellipsoid (meters).
+         * @param[out] x array of local cartesian coordinates (meters).
+         * @param[out] y array of local cartesian coordinates (meters).
+         * @param[out] z array of local cartesian coordinates (meters).
+         * @param[out] M if not null, an array of 9\e n elements which is
+         *   filled with the rotation matrices for the \e n points.  These are
+         *   stored by component: element \e k (in row-major order) of the
+         *   matrix for point \e i is M[\e k \e n + \e i].
+         * @exception GeographicErr if \e lat, \e lon, \e h, \e x, \e y, or \e
+         *   z is null or if the arrays have inconsistent lengths.
+         *
+         * The output arrays must be allocated by the caller.  This calls
+         * GeographicLib::LocalCartesian::ForwardBatch with a single transition
+         * to native code.  The results are identical to those returned by
+         * LocalCartesian::Forward.
+         **********************************************************************/
+        void ForwardBatch(array<double>^ lat, array<double>^ lon,
+                          array<double>^ h, array<double>^ x,
+                          array<double>^ y, array<double>^ z,
+                          array<double>^ M);
+
+        /**
+         * Convert arrays of local cartesian coordinates to geodetic
+         * coordinates.
+         *
+         * @param[in] x array of local cartesian coordinates (meters).
+         * @param[in] y array of local cartesian coordinates (meters).
+         * @param[in] z array of local cartesian coordinates (meters).
+         * @param[out] lat array of latitudes of the points (degrees).
+         * @param[out] lon array of longitudes of the points (degrees).
+         * @param[out] h array of heights above the ellipsoid (meters).
+         * @param[out] M if not null, an array of 9\e n elements which is
+         *   filled with the rotation matrices (stored by component).
+         * @exception GeographicErr if \e x, \e y, \e z, \e lat, \e lon, or \e
+         *   h is null or if the arrays have inconsistent lengths.
+         *
+         * This calls GeographicLib::LocalCartesian::ReverseBatch; the results
+         * are identical to those returned by LocalCartesian::Reverse.
+         **********************************************************************/
+        void ReverseBatch(array<double>^ x, array<double>^ y,
+                          array<double>^ z, array<double>^ lat,
+                          array<double>^ lon, array<double>^ h,
+                          array<double>^ M);
+
         /** \name Inspector functions
          **********************************************************************/
         ///@{
@@ -154,6 +154,45 @@ namespace NETGeographicLib
         {   return gcnew System::String( s.c_str() ); }
     };
 
+    /**
+     * Helpers for the array (batch) member functions.  These pin the managed
+     * arrays and pass pointers to their elements to the batch functions in
+     * GeographicLib so that the transition from managed to native code is
+     * made once per call instead of once per point.
+     **********************************************************************/
+    ref class BatchArray
+    {
+        BatchArray() {}
+    public:
+        // Return the length of the input array a which must not be null.  If
+        // n >= 0, a must have n elements.
+        template<typename T>
+        static int Length( array<T>^ a, int n )
+        {
+            if ( a == nullptr )
+                throw gcnew GeographicErr( "Input arrays cannot be null pointers." );
+            if ( n >= 0 && a->Length != n )
+                throw gcnew GeographicErr( "Arrays have different lengths." );
+            return a->Length;
+        }
+        // Check that the optional array a is null or has n elements.
+        template<typename T>
+        static void Check( array<T>^ a, int n )
+        {
+            if ( a != nullptr && a->Length != n )
+                throw gcnew GeographicErr( "Arrays have different lengths." );
+        }
+        // A pointer to the first element of a (null if a is null or empty);
+        // assign this to a pin_ptr.
+        template<typename T>
+        static interior_ptr<T> Data( array<T>^ a )
+        {
+            interior_ptr<T> p = nullptr;
+            if ( a != nullptr && a->Length > 0 ) p = &a[0];
+            return p;
+        }
+    };
+
     /**
      * @brief Physical constants
      *
@@ -121,3 +121,43 @@ double TransverseMercator::Flattening::get()
 //*****************************************************************************
 double TransverseMercator::CentralScale::get()
 { return m_pTransverseMercator->CentralScale(); }
+
+//*****************************************************************************
+void TransverseMercator::Forward(double lon0,
+                array<double>^ lat, array<double>^ lon,
+                array<double>^ x, array<double>^ y,
+                array<double>^ gamma, array<double>^ k)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( x, n );
+    BatchArray::Length( y, n );
+    BatchArray::Check( gamma, n );
+    BatchArray::Check( k, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), px = BatchArray::Data( x ),
+        py = BatchArray::Data( y ), pgamma = BatchArray::Data( gamma ),
+        pk = BatchArray::Data( k );
+    m_pTransverseMercator->Forward( lon0, plat, plon, size_t(n),
+                                    px, py, pgamma, pk );
+}
+
+//*****************************************************************************
+void TransverseMercator::Reverse(double lon0,
+                array<double>^ x, array<double>^ y,
+                array<double>^ lat, array<double>^ lon,
+                array<double>^ gamma, array<double>^ k)
+{
+    int n = BatchArray::Length( x, -1 );
+    BatchArray::Length( y, n );
+    BatchArray::Length( lat, n );
+    BatchArray::Length( lon, n );
+    BatchArray::Check( gamma, n );
+    BatchArray::Check( k, n );
+    pin_ptr<double> px = BatchArray::Data( x ),
+        py = BatchArray::Data( y ), plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), pgamma = BatchArray::Data( gamma ),
+        pk = BatchArray::Data( k );
+    m_pTransverseMercator->Reverse( lon0, px, py, size_t(n),
+                                    plat, plon, pgamma, pk );
+}
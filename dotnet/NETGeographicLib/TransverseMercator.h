@@ -163,6 +163,52 @@ namespace NETGeographicLib
                      [System::Runtime::InteropServices::Out] double% lat,
                      [System::Runtime::InteropServices::Out] double% lon);
 
+        /**
+         * Forward projection of arrays of points.
+         *
+         * @param[in] lon0 central meridian of the projection (degrees).
+         * @param[in] lat array of latitudes of the points (degrees).
+         * @param[in] lon array of longitudes of the points (degrees).
+         * @param[out] x array of eastings (meters).
+         * @param[out] y array of northings (meters).
+         * @param[out] gamma array of meridian convergences (degrees); may be
+         *   null.
+         * @param[out] k array of scales of the projection; may be null.
+         * @exception GeographicErr if \e lat, \e lon, \e x, or \e y is null
+         *   or if the arrays have different lengths.
+         *
+         * The output arrays must be allocated by the caller.  The arrays are
+         * pinned and the points are projected by the batch version of
+         * GeographicLib::TransverseMercator::Forward with a single transition
+         * to native code.  The results are identical to those returned by
+         * TransverseMercator::Forward.  If \e gamma and \e k are both null,
+         * the convergence and scale are not computed.
+         **********************************************************************/
+        void Forward(double lon0, array<double>^ lat, array<double>^ lon,
+                     array<double>^ x, array<double>^ y,
+                     array<double>^ gamma, array<double>^ k);
+
+        /**
+         * Reverse projection of arrays of points.
+         *
+         * @param[in] lon0 central meridian of the projection (degrees).
+         * @param[in] x array of eastings (meters).
+         * @param[in] y array of northings (meters).
+         * @param[out] lat array of latitudes of the points (degrees).
+         * @param[out] lon array of longitudes of the points (degrees).
+         * @param[out] gamma array of meridian convergences (degrees); may be
+         *   null.
+         * @param[out] k array of scales of the projection; may be null.
+         * @exception GeographicErr if \e x, \e y, \e lat, or \e lon is null
+         *   or if the arrays have different lengths.
+         *
+         * This is the batch counterpart of TransverseMercator::Reverse; see
+         * the array version of TransverseMercator::Forward.
+         **********************************************************************/
+        void Reverse(double lon0, array<double>^ x, array<double>^ y,
+                     array<double>^ lat, array<double>^ lon,
+                     array<double>^ gamma, array<double>^ k);
+
         /** \name Inspector functions
          **********************************************************************/
         ///@{
@@ -213,3 +213,50 @@ double UTMUPS::MajorRadius() { return GeographicLib::UTMUPS::MajorRadius(); }
 
 //****************************************************************************
 double UTMUPS::Flattening() { return GeographicLib::UTMUPS::Flattening(); }
+
+//****************************************************************************
+int UTMUPS::ForwardBatch(array<double>^ lat, array<double>^ lon,
+                array<int>^ zone, array<bool>^ northp,
+                array<double>^ x, array<double>^ y,
+                array<double>^ gamma, array<double>^ k, array<int>^ err,
+                int setzone, bool mgrslimits)
+{
+    int n = BatchArray::Length( lat, -1 );
+    BatchArray::Length( lon, n );
+    BatchArray::Length( zone, n );
+    BatchArray::Length( northp, n );
+    BatchArray::Length( x, n );
+    BatchArray::Length( y, n );
+    BatchArray::Check( gamma, n );
+    BatchArray::Check( k, n );
+    BatchArray::Check( err, n );
+    pin_ptr<double> plat = BatchArray::Data( lat ),
+        plon = BatchArray::Data( lon ), px = BatchArray::Data( x ),
+        py = BatchArray::Data( y ), pgamma = BatchArray::Data( gamma ),
+        pk = BatchArray::Data( k );
+    pin_ptr<int> pzone = BatchArray::Data( zone ),
+        perr = BatchArray::Data( err );
+    pin_ptr<bool> pnorthp = BatchArray::Data( northp );
+    try
+    {
+        return int( GeographicLib::UTMUPS::ForwardBatch( plat, plon, size_t(n),
+                                                         pzone, pnorthp,
+                                                         px, py, pgamma, pk,
+                                                         perr, setzone,
+                                                         mgrslimits ) );
+    }
+    catch ( const std::exception& xcpt )
+    {
+        throw gcnew GeographicErr( xcpt.what() );
+    }
+}
+
+//****************************************************************************
+int UTMUPS::ForwardBatch(array<double>^ lat, array<double>^ lon,
+                array<int>^ zone, array<bool>^ northp,
+                array<double>^ x, array<double>^ y)
+{
+    return ForwardBatch( lat, lon, zone, northp, x, y,
+                         nullptr, nullptr, nullptr,
+                         int(ZoneSpec::STANDARD), false );
+}
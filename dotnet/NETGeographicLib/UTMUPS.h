@@ -262,6 +262,52 @@ namespace NETGeographicLib
                     [System::Runtime::InteropServices::Out] double% lon,
                     bool mgrslimits);
 
+        /**
+         * Forward projection of arrays of points, from geographic to UTM/UPS.
+         *
+         * @param[in] lat array of latitudes of the points (degrees).
+         * @param[in] lon array of longitudes of the points (degrees).
+         * @param[out] zone array of UTM zones (zero means UPS).
+         * @param[out] northp array of hemispheres (true means north, false
+         *   means south).
+         * @param[out] x array of eastings (meters).
+         * @param[out] y array of northings (meters).
+         * @param[out] gamma array of meridian convergences (degrees); may be
+         *   null.
+         * @param[out] k array of scales of projection; may be null.
+         * @param[out] err array of status codes (see
+         *   GeographicLib::UTMUPS::status); may be null.
+         * @param[in] setzone zone override (use ZoneSpec.STANDARD for the
+         *   standard rules).
+         * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+         *   coordinates.
+         * @exception GeographicErr if \e lat, \e lon, \e zone, \e northp, \e
+         *   x, or \e y is null, if the arrays have different lengths, or if \e
+         *   setzone is outside the range [UTMUPS::MINPSEUDOZONE,
+         *   UTMUPS::MAXZONE] = [&minus;4, 60].
+         * @return the number of points which could not be converted.
+         *
+         * The output arrays must be allocated by the caller.  This calls
+         * GeographicLib::UTMUPS::ForwardBatch with a single transition to
+         * native code.  A point which cannot be converted does not throw an
+         * exception; instead its \e zone is set to ZoneSpec.INVALID and \e x, \e
+         * y, \e gamma, and \e k are set to NaN.  The results for the other
+         * points are identical to those returned by UTMUPS::Forward.
+         **********************************************************************/
+        static int ForwardBatch(array<double>^ lat, array<double>^ lon,
+                    array<int>^ zone, array<bool>^ northp,
+                    array<double>^ x, array<double>^ y,
+                    array<double>^ gamma, array<double>^ k, array<int>^ err,
+                    int setzone, bool mgrslimits);
+
+        /**
+         * UTMUPS::ForwardBatch using the standard zones and without returning
+         * convergence, scale, and status codes.
+         **********************************************************************/
+        static int ForwardBatch(array<double>^ lat, array<double>^ lon,
+                    array<int>^ zone, array<bool>^ northp,
+                    array<double>^ x, array<double>^ y);
+
         /**
          * Transfer UTM/UPS coordinated from one zone to another.
          *
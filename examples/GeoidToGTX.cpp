@@ -1,6 +1,11 @@
-// Write out a gtx file of geoid heights above the ellipsoid.  For egm2008 at
-// 1' resolution this takes about 40 mins on a 8-processor Intel 2.66 GHz
-// machine using OpenMP (-DHAVE_OPENMP=1).
+// Write out a gtx file of geoid heights above the ellipsoid.  The rows of
+// the grid are computed in batches; the rows of a batch are divided between
+// threads (by Executor::For) and each row is evaluated by
+// GravityCircle::GeoidHeightRow, which uses a fast Fourier transform.  Each
+// batch is written as soon as it is finished, so the memory needed is
+// independent of the size of the grid.  If compiled with OpenMP
+// (-DHAVE_OPENMP=1), the threads are those of OpenMP; otherwise they are
+// those of the library's thread pool.
 //
 // For the format of gtx files, see
 // http://vdatum.noaa.gov/dev/gtx_info.html#dev_gtx_binary
@@ -24,6 +29,7 @@
 #  include <omp.h>
 #endif
 
+#include <GeographicLib/Executor.hpp>
 #include <GeographicLib/GravityModel.hpp>
 #include <GeographicLib/GravityCircle.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -31,23 +37,65 @@
 using namespace std;
 using namespace GeographicLib;
 
+// Compute rows [i0, i1) of a batch of rows starting at row ilat0.
+class Rows {
+private:
+  const GravityModel& _g;
+  int _ndeg, _ndigits, _ilat0, _nlon;
+  Math::real _latorg, _lonorg, _delta;
+  vector<float>& _N;
+  Rows& operator=(const Rows&);
+public:
+  Rows(const GravityModel& g, int ndeg, int ndigits, int ilat0, int nlon,
+       Math::real latorg, Math::real lonorg, vector<float>& N)
+    : _g(g), _ndeg(ndeg), _ndigits(ndigits), _ilat0(ilat0), _nlon(nlon)
+    , _latorg(latorg), _lonorg(lonorg), _delta(1 / Math::real(ndeg)), _N(N)
+  {}
+  void operator()(size_t i0, size_t i1) const {
+    Utility::set_digits(_ndigits); // Set the precision for this thread
+    vector<Math::real> row(_nlon);
+    for (size_t i = i0; i < i1; ++i) {
+      int ilat = _ilat0 + int(i);
+      Math::real
+        lat = _latorg + (ilat / _ndeg) +
+        _delta * (ilat - _ndeg * (ilat / _ndeg)),
+        h = 0;
+      _g.Circle(lat, h, GravityModel::GEOID_HEIGHT).
+        GeoidHeightRow(_lonorg, _delta, _nlon, &row[0]);
+      for (int ilon = 0; ilon < _nlon; ++ilon)
+        _N[i * size_t(_nlon) + ilon] = float(row[ilon]);
+    }
+  }
+};
+
 int main(int argc, char* argv[]) {
-  // Hardwired for 3 args:
+  // Hardwired for 3 or 4 args:
   // 1 = the gravity model (e.g., egm2008)
   // 2 = intervals per degree
   // 3 = output GTX file
-  if (argc != 4) {
+  // 4 = the number of threads (default, the number the executor runs)
+  if (argc != 4 && argc != 5) {
     cerr << "Usage: " << argv[0]
-         << " gravity-model intervals-per-degree output.gtx\n";
+         << " gravity-model intervals-per-degree output.gtx [threads]\n";
     return 1;
   }
   try {
+#if HAVE_OPENMP
+    static OpenMPExecutor ompexec;
+    Executor::SetDefault(&ompexec);
+#endif
     // Will need to set the precision for each thread, so save return value
     int ndigits = Utility::set_digits();
     string model(argv[1]);
     // Number of intervals per degree
     int ndeg = Utility::num<int>(string(argv[2]));
     string filename(argv[3]);
+    int nthreads = argc == 5 ? Utility::num<int>(string(argv[4])) :
+      Executor::Default().Concurrency();
+    if (!(ndeg > 0))
+      throw GeographicErr("Intervals per degree must be positive");
+    if (!(nthreads > 0))
+      throw GeographicErr("Number of threads must be positive");
     GravityModel g(model);
     int
       nlat = 180 * ndeg + 1,
@@ -58,6 +106,9 @@ int main(int argc, char* argv[]) {
       lonorg = -180;
     // Write results as floats in binary mode
     ofstream file(filename.c_str(), ios::binary);
+    if (!file.good())
+      throw GeographicErr("Cannot open " + filename + " for writing");
+    file.exceptions(ofstream::eofbit | ofstream::failbit | ofstream::badbit);
 
     // Write header
     {
@@ -67,31 +118,18 @@ int main(int argc, char* argv[]) {
       Utility::writearray<unsigned, unsigned, true>(file, sizes, 2);
     }
 
-    // Compute and store results for nbatch latitudes at a time
-    const int nbatch = 64;
-    vector< vector<float> > N(nbatch, vector<float>(nlon));
+    // Compute and store results for nbatch latitudes at a time; several
+    // rows per thread balances the load.
+    const int nbatch = max(64, 4 * nthreads);
+    vector<float> N(size_t(nbatch) * size_t(nlon));
 
     for (int ilat0 = 0; ilat0 < nlat; ilat0 += nbatch) { // Loop over batches
-      int nlat0 = min(nlat, ilat0 + nbatch);
-
-#if HAVE_OPENMP
-#  pragma omp parallel for
-#endif
-      for (int ilat = ilat0; ilat < nlat0; ++ilat) { // Loop over latitudes
-        Utility::set_digits(ndigits);                // Set the precision
-        Math::real
-          lat = latorg + (ilat / ndeg) + delta * (ilat - ndeg * (ilat / ndeg)),
-          h = 0;
-        GravityCircle c(g.Circle(lat, h, GravityModel::GEOID_HEIGHT));
-        for (int ilon = 0; ilon < nlon; ++ilon) { // Loop over longitudes
-          Math::real lon = lonorg
-            + (ilon / ndeg) + delta * (ilon - ndeg * (ilon / ndeg));
-          N[ilat - ilat0][ilon] = float(c.GeoidHeight(lon));
-        } // longitude loop
-      }   // latitude loop -- end of parallel section
-
-      for (int ilat = ilat0; ilat < nlat0; ++ilat) // write out data
-        Utility::writearray<float, float, true>(file, N[ilat - ilat0]);
+      int nlat0 = min(nlat - ilat0, nbatch);
+      Executor::For(size_t(nlat0), size_t(nthreads),
+                    Rows(g, ndeg, ndigits, ilat0, nlon, latorg, lonorg, N));
+      // Write out data
+      Utility::writearray<float, float, true>(file, &N[0],
+                                              size_t(nlat0) * size_t(nlon));
     } // batch loop
   }
   catch (const exception& e) {
@@ -0,0 +1,160 @@
+// Convert a pgm file of geoid heights to the compressed tiled format read by
+// the Geoid class.
+//
+// For the format of tgm files, see
+// http://geographiclib.sourceforge.net/html/geoid.html#geoidformat
+//
+// The file consists of
+//   a text header which is the same as that of the pgm file except that the
+//     first line is "TGM1" and a "# TileSize n" line is added
+//   tile index = (ntiles + 1) file offsets (big-endian 64-bit integers) of
+//     the tiles in row-major order and of the end of the file
+//   the tiles, each an encoded array of (at most) n x n pixels
+
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// Append the encoding of a tile of w x h pixels to buf.  Each pixel is stored
+// as the difference from a planar prediction based on its neighbors to the
+// west, north, and north-west; this is zigzag encoded and written as a
+// sequence of 7-bit groups, least significant first, with the high bit set
+// on all but the last byte.
+void Encode(const unsigned* data, int w, int h, long long maxval,
+            vector<unsigned char>& buf) {
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      long long
+        p = y == 0 ? (x == 0 ? 0 : data[x - 1]) :
+        (x == 0 ? data[(y - 1) * w] :
+         min(maxval, max(0LL, (long long)(data[y * w + x - 1]) +
+                         data[(y - 1) * w + x] - data[(y - 1) * w + x - 1]))),
+        r = data[y * w + x] - p;
+      unsigned long long z = r < 0 ?
+        2ULL * (unsigned long long)(-(r + 1)) + 1 :
+        2ULL * (unsigned long long)(r);
+      while (z >= 0x80ULL) {
+        buf.push_back((unsigned char)(z & 0x7fULL) | 0x80u);
+        z >>= 7;
+      }
+      buf.push_back((unsigned char)(z));
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  // Hardwired for 2 or 3 args:
+  // 1 = the input pgm file (e.g., egm2008-1.pgm)
+  // 2 = the output tgm file (e.g., egm2008-1.tgm)
+  // 3 = the tile size (default 256)
+  if (argc != 3 && argc != 4) {
+    cerr << "Usage: " << argv[0]
+         << " input.pgm output.tgm [tile-size]\n";
+    return 1;
+  }
+  try {
+    string ifile(argv[1]), ofile(argv[2]);
+    int tsize = argc == 4 ? Utility::num<int>(string(argv[3])) : 256;
+    if (!(tsize > 0))
+      throw GeographicErr("Tile size must be positive");
+    ifstream in(ifile.c_str(), ios::binary);
+    if (!in.good())
+      throw GeographicErr("File not readable " + ifile);
+    string s;
+    if (!(getline(in, s) && s == "P5"))
+      throw GeographicErr("File not in PGM format " + ifile);
+    // Copy the comments to the new header
+    ostringstream header;
+    header << "TGM1\n";
+    int width = 0, height = 0;
+    while (getline(in, s)) {
+      if (s.empty())
+        continue;
+      if (s[0] == '#')
+        header << s << "\n";
+      else {
+        istringstream is(s);
+        if (!(is >> width >> height))
+          throw GeographicErr("Error reading raster size " + ifile);
+        break;
+      }
+    }
+    unsigned long long maxval;
+    if (!(in >> maxval) || !(maxval == 0xffffULL || maxval == 0xffffffffULL))
+      throw GeographicErr("Bad maxval " + ifile);
+    in.get();                   // Skip whitespace after maxval
+    bool wide = maxval != 0xffffULL;
+    header << "# TileSize " << tsize << "\n"
+           << width << " " << height << "\n" << maxval << "\n";
+    int
+      ntx = (width + tsize - 1) / tsize,
+      nty = (height + tsize - 1) / tsize;
+    vector<unsigned long long> index(size_t(ntx) * size_t(nty) + 1);
+
+    ofstream out(ofile.c_str(), ios::binary);
+    if (!out.good())
+      throw GeographicErr("File not writable " + ofile);
+    string h = header.str();
+    out.write(h.data(), h.size());
+    // Write a blank index; this is filled in at the end.
+    unsigned long long indexstart = h.size();
+    Utility::writearray<unsigned long long, unsigned long long, true>
+      (out, index);
+    index[0] = indexstart + 8ULL * index.size();
+
+    // Process a row of tiles at a time
+    vector<unsigned> strip(size_t(width) * tsize), tile;
+    vector<unsigned char> buf;
+    for (int ty = 0; ty < nty; ++ty) {
+      int th = min(tsize, height - ty * tsize);
+      if (wide)
+        Utility::readarray<unsigned, unsigned, true>
+          (in, &strip[0], size_t(width) * th);
+      else
+        Utility::readarray<unsigned short, unsigned, true>
+          (in, &strip[0], size_t(width) * th);
+      for (int tx = 0; tx < ntx; ++tx) {
+        int
+          x0 = tx * tsize,
+          tw = min(tsize, width - x0);
+        tile.resize(size_t(tw) * th);
+        for (int y = 0; y < th; ++y)
+          copy(strip.begin() + size_t(y) * width + x0,
+               strip.begin() + size_t(y) * width + x0 + tw,
+               tile.begin() + size_t(y) * tw);
+        buf.clear();
+        Encode(&tile[0], tw, th, (long long)(maxval), buf);
+        out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+        size_t id = size_t(ty) * ntx + tx;
+        index[id + 1] = index[id] + buf.size();
+      }
+    }
+    if (in.get() != char_traits<char>::eof())
+      throw GeographicErr("File has the wrong length " + ifile);
+    out.seekp(streamoff(indexstart));
+    Utility::writearray<unsigned long long, unsigned long long, true>
+      (out, index);
+    out.close();
+    if (!out.good())
+      throw GeographicErr("Error writing " + ofile);
+    cerr << ofile << ": " << ntx * nty << " tiles, "
+         << index.back() << " bytes\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,42 @@
+// Example of using the GeographicLib::AuthalicSphere class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/AuthalicSphere.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    AuthalicSphere sphere(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const AuthalicSphere& sphere = AuthalicSphere::WGS84();
+    {
+      // Approximate inverse calculation, JFK to LHR
+      double
+        lat1 = 40.6, lon1 = -73.8, // JFK Airport
+        lat2 = 51.6, lon2 = -0.5;  // LHR Airport
+      double s12;
+      sphere.Inverse(lat1, lon1, lat2, lon2, s12);
+      cout << s12 << "\n";
+    }
+    {
+      // Approximate area of a small polygon
+      PolygonAreaAuthalic poly(sphere);
+      poly.AddPoint(52.0, 0.0);
+      poly.AddPoint(52.1, 0.0);
+      poly.AddPoint(52.1, 0.2);
+      poly.AddPoint(52.0, 0.2);
+      double perimeter, area;
+      unsigned n = poly.Compute(false, true, perimeter, area);
+      cout << n << " " << perimeter << " " << area << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
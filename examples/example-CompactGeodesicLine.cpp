@@ -0,0 +1,42 @@
+// Example of using the GeographicLib::CompactGeodesicLineT class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <iomanip>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/CompactGeodesicLine.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    double
+      // JFK, LHR, NRT, SYD
+      lat[] = {40.640, 51.470,  35.765, -33.946},
+      lon[] = {-73.779, -0.454, 140.386, 151.177};
+    // Hold the legs JFK-LHR, LHR-NRT, NRT-SYD
+    vector<CompactGeodesicLine> legs;
+    for (int i = 0; i < 3; ++i) {
+      double s12, azi1, azi2;
+      geod.Inverse(lat[i], lon[i], lat[i + 1], lon[i + 1], s12, azi1, azi2);
+      legs.push_back(CompactGeodesicLine(geod, lat[i], lon[i], azi1));
+    }
+    // Print the position 1000 km along each leg
+    cout << fixed << setprecision(3);
+    for (size_t i = 0; i < legs.size(); ++i) {
+      double lat2, lon2;
+      legs[i].Position(1000e3, lat2, lon2);
+      cout << i << " " << lat2 << " " << lon2 << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+// Example of using the GeographicLib::EditablePolygonAreaT class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/EditablePolygonArea.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    EditablePolygonArea poly(geod);
+    poly.AddPoint( 52,  0);     // London
+    size_t ny =
+      poly.AddPoint( 41,-74);   // New York
+    poly.AddPoint(-23,-43);     // Rio de Janeiro
+    poly.AddPoint(-26, 28);     // Johannesburg
+    double perimeter, area;
+    size_t n = poly.Compute(false, true, perimeter, area);
+    cout << n << " " << perimeter << " " << area << "\n";
+    poly.MovePoint(ny, 40.7, -74); // Correct the latitude of New York
+    poly.InsertPoint(ny, 51.5, -55.5); // Insert Newfoundland before it
+    n = poly.Compute(false, true, perimeter, area);
+    cout << n << " " << perimeter << " " << area << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
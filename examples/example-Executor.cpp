@@ -0,0 +1,42 @@
+// Example of using the GeographicLib::Executor class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    const Geodesic& geod = Geodesic::WGS84();
+    // The distances from JFK to points spaced along the equator
+    size_t n = 3600;
+    vector<double> lat1(n, 40.64), lon1(n, -73.78), lat2(n, 0), lon2(n),
+      s12(n), t(n);
+    for (size_t i = 0; i < n; ++i) lon2[i] = 0.1 * double(i) - 180;
+    // Give the library a pool with 3 worker threads and split the batch into
+    // 8 chunks.
+    ThreadPoolExecutor pool(3);
+    Executor::SetDefault(&pool);
+    geod.InverseBatch(&lat1[0], &lon1[0], &lat2[0], &lon2[0], n,
+                      &s12[0], 0, 0, 8);
+    // Do the same work in the calling thread only; the results are the same.
+    SerialExecutor serial;
+    Executor::SetDefault(&serial);
+    geod.InverseBatch(&lat1[0], &lon1[0], &lat2[0], &lon2[0], n,
+                      &t[0], 0, 0, 8);
+    Executor::SetDefault(0);    // Restore the built-in executor
+    size_t ndiff = 0;
+    for (size_t i = 0; i < n; ++i) ndiff += s12[i] != t[i];
+    cout << "concurrency " << pool.Concurrency()
+         << " differences " << ndiff << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
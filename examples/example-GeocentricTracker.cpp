@@ -0,0 +1,32 @@
+// Example of using the GeographicLib::GeocentricTracker class
+
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/GeocentricTracker.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    const Geocentric& earth = Geocentric::WGS84();
+    GeocentricTracker tracker(earth);
+    // An aircraft climbing to the north east; positions at 1 s intervals
+    double lat0 = 40.6, lon0 = -73.8, h0 = 100;
+    for (int i = 0; i <= 4; ++i) {
+      double X, Y, Z;
+      earth.Forward(lat0 + i * 0.001, lon0 + i * 0.0013, h0 + i * 10,
+                    X, Y, Z);
+      double lat, lon, h;
+      tracker.Reverse(X, Y, Z, lat, lon, h);
+      cout << lat << " " << lon << " " << h << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,39 @@
+// Example of using the GeographicLib::GeodesicBuffer class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+#include <GeographicLib/GeodesicBuffer.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // A corridor extending 10 km on either side of a pipeline; the outline
+    // should be within 1 m of the true buffer.
+    GeodesicBuffer buffer(geod, 10e3, 1);
+    double
+      lat[] = {29.76, 30.27, 31.55, 32.78},  // Houston, Austin, Waco, Dallas
+      lon[] = {-95.37, -97.74, -97.15, -96.80};
+    vector<double> blat, blon;
+    buffer.Polyline(lat, lon, 4, blat, blon);
+    PolygonArea poly(geod);
+    poly.AddPoints(&blat[0], &blon[0], blat.size());
+    double perimeter, area;
+    poly.Compute(false, true, perimeter, area);
+    cout << blat.size() << " " << fixed << setprecision(1)
+         << perimeter/1e3 << " " << area/1e6 << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,39 @@
+// Example of using the GeographicLib::GeodesicIndex class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/GeodesicIndex.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    double
+      // London, New York, Rio, Johannesburg, Paris, Madrid
+      lat[] = { 52, 41, -23, -26, 49,  40 },
+      lon[] = {  0,-74, -43,  28,  2,  -4 };
+    size_t n = sizeof(lat) / sizeof(lat[0]);
+    GeodesicIndex index(geod, lat, lon, n);
+    // The 3 cities nearest to Berlin
+    size_t ind[3]; double s12[3];
+    size_t k = index.Nearest(52.5, 13.4, 3, ind, s12);
+    for (size_t j = 0; j < k; ++j)
+      cout << ind[j] << " " << s12[j] << "\n";
+    // The cities within 2000 km of Rome
+    vector<size_t> indr; vector<double> s12r;
+    index.Within(41.9, 12.5, 2000e3, indr, s12r);
+    for (size_t j = 0; j < indr.size(); ++j)
+      cout << indr[j] << " " << s12r[j] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
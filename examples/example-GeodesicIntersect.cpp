@@ -0,0 +1,39 @@
+// Example of using the GeographicLib::GeodesicIntersect class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/GeodesicIntersect.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    GeodesicIntersect inter(geod);
+    cout << fixed << setprecision(6);
+    {
+      // Where does the path JFK to LHR cross the path YYZ to CDG?
+      double lat, lon;
+      if (inter.SegmentIntersect(40.64, -73.78, 51.47, -0.45,
+                                 43.68, -79.63, 49.01, 2.55, lat, lon))
+        cout << lat << " " << lon << "\n";
+    }
+    {
+      // The closest approach of the path JFK to LHR to Reykjavik
+      double latn, lonn,
+        s = inter.Nearest(40.64, -73.78, 51.47, -0.45, 64.13, -21.94,
+                          true, latn, lonn);
+      cout << latn << " " << lonn << " " << setprecision(0) << s << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
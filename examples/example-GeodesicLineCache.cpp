@@ -0,0 +1,40 @@
+// Example of using the GeographicLib::GeodesicLineCache class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicLineCache.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // Hold up to 1000 lines for computing positions
+    GeodesicLineCache cache(geod, 1000,
+                            Geodesic::DISTANCE_IN | Geodesic::LONGITUDE);
+    // Two flight plans which start with the same leg from JFK
+    double
+      lat1 = 40.640, lon1 = -73.779, azi1 = 51.0, // JFK heading NE
+      dist[] = { 1000e3, 2000e3, 3000e3 };
+    for (int plan = 0; plan < 2; ++plan) {
+      // The second time around, the line is taken from the cache
+      GeodesicLine line = cache.Line(lat1, lon1, azi1);
+      for (int i = 0; i < 3; ++i) {
+        double lat, lon;
+        line.Position(dist[i], lat, lon);
+        cout << plan << " " << lat << " " << lon << "\n";
+      }
+    }
+    cout << "hits " << cache.Hits() << " misses " << cache.Misses() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
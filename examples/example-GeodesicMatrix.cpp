@@ -0,0 +1,34 @@
+// Example of using the GeographicLib::GeodesicMatrix class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/GeodesicMatrix.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    double
+      lat[] = { 52, 41, -23, -26 },   // London, New York, Rio, Johannesburg
+      lon[] = {  0,-74, -43,  28 };
+    size_t n = sizeof(lat) / sizeof(lat[0]);
+    // Compute the distances between all pairs of cities (upper triangle)
+    GeodesicMatrix mat(geod, lat, lon, n, true);
+    vector<double> s12(mat.Size());
+    mat.Compute(Geodesic::DISTANCE, &s12[0]);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = i + 1; j < n; ++j)
+        cout << i << " " << j << " " << s12[mat.Index(i, j)] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,36 @@
+// Example of using the GeographicLib::GeodesicPolygon class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/GeodesicPolygon.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    double
+      // A quadrilateral enclosing the North Sea (counter-clockwise)
+      lat[] = { 51, 51, 61, 58 },
+      lon[] = { -2,  8,  5, -5 };
+    GeodesicPolygon poly(geod, lat, lon, 4);
+    cout << poly.Area() << "\n";
+    // Edinburgh, Oslo, Hamburg, and Amsterdam
+    double
+      qlat[] = { 55.95, 59.91, 53.55, 52.37 },
+      qlon[] = { -3.19, 10.75,  9.99,  4.90 };
+    bool inside[4];
+    poly.ContainsBatch(qlat, qlon, 4, inside);
+    for (int i = 0; i < 4; ++i)
+      cout << inside[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
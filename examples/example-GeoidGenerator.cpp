@@ -0,0 +1,26 @@
+// Example of using the GeographicLib::GeoidGenerator class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GeoidGenerator.hpp>
+#include <GeographicLib/GravityModel.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    GravityModel egm96("egm96");
+    // A grid with 5' spacing whose tiles are computed when first needed
+    GeoidGenerator grid(egm96, 12);
+    Geoid geoid(grid);
+    double lat = 42, lon = -75;
+    cout << geoid(lat, lon) << " " << egm96.GeoidHeight(lat, lon) << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,38 @@
+// Example of using the GeographicLib::GravityCircleCache class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityCircleCache.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    GravityModel grav("egm96");
+    // Hold up to 100 circles on a grid of latitudes and heights with
+    // spacings 0.01 degree and 10 m.
+    GravityCircleCache cache(grav, 100, GravityModel::GRAVITY, 0.01, 10);
+    // An aircraft flying two laps of a holding pattern east of Mt Everest
+    // at 8820 m.  The second lap is evaluated with the cached circles.
+    double lat0 = 27.99, lon0 = 87.2, h = 8820;
+    for (int lap = 0; lap < 2; ++lap) {
+      for (int i = 0; i < 4; ++i) {
+        double
+          lat = lat0 + (i == 1 || i == 2 ? 0.1 : 0),
+          lon = lon0 + (i < 2 ? 0 : 0.2),
+          gx, gy, gz;
+        cache.Gravity(lat, lon, h, gx, gy, gz);
+        cout << lat << " " << lon << " "
+             << gx << " " << gy << " " << gz << "\n";
+      }
+    }
+    cout << "hits " << cache.Hits() << " misses " << cache.Misses() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
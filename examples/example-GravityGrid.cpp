@@ -0,0 +1,41 @@
+// Example of using the GeographicLib::GravityGrid class
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <exception>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityGrid.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // Map the coefficients into memory instead of reading them
+    GravityModel grav("egm96", "", true);
+    // Geoid heights on a 1 degree grid covering the earth
+    GravityGrid grid(grav, GravityGrid::GEOID_HEIGHT, 90, -180, 1, 181, 360);
+    // Split the grid into 4 bands, as for 4 processes, and compute the
+    // second band with 2 threads
+    int r0, r1;
+    GravityGrid::Band(grid.RowCount(), 4, 1, r0, r1);
+    vector<double> N(size_t(r1 - r0) * grid.ColumnCount());
+    double* v[] = {&N[0]};
+    grid.Rows(r0, r1, v, 2);
+    cout << "Rows " << r0 << " to " << r1 - 1 << "; N at "
+         << grid.Latitude(r0) << " " << grid.Longitude(0) << " = "
+         << N[0] << "\n";
+    // Write the band at its place in the grid file
+    vector<char> buf;
+    grid.Encode(v, r1 - r0, buf);
+    fstream file("geoid.bin", ios::in | ios::out | ios::binary | ios::trunc);
+    file.seekp(streamoff(grid.Offset(r0)));
+    file.write(&buf[0], streamsize(buf.size()));
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+// Example of using the GeographicLib::GridMapper class
+
+#include <iostream>
+#include <vector>
+#include <exception>
+#include <GeographicLib/GridMapper.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// The transformation from UTM zone 33 (destination) to geographic
+// coordinates (source)
+class UTMToGeographic : public GridMapper::Transform {
+private:
+  const TransverseMercator& _tm;
+  double _lon0;
+public:
+  UTMToGeographic(const TransverseMercator& tm, double lon0)
+    : _tm(tm), _lon0(lon0) {}
+  void operator()(const double x[], const double y[], size_t n,
+                  double u[], double v[]) const {
+    for (size_t i = 0; i < n; ++i)
+      // u = longitude, v = latitude
+      _tm.Reverse(_lon0, x[i] - 500000, y[i], v[i], u[i]);
+  }
+};
+
+int main() {
+  try {
+    const TransverseMercator& tm = TransverseMercator::UTM();
+    UTMToGeographic t(tm, 15);
+    // Interpolation errors less than 1e-7 degrees (about 1 cm)
+    GridMapper mapper(1e-7);
+    // A 1000 x 1000 grid of 30 m pixels
+    int nx = 1000, ny = 1000;
+    vector<double> lon(nx * ny), lat(nx * ny);
+    mapper.Map(t, 400000, 30, nx, 5500000, 30, ny, &lon[0], &lat[0]);
+    // Print the source coordinates of one pixel
+    int i = 517, j = 333;
+    cout << lat[j * nx + i] << " " << lon[j * nx + i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
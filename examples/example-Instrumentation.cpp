@@ -0,0 +1,48 @@
+// Example of using the GeographicLib::Instrumentation class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Instrumentation.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// A tracer which counts the spans
+class SpanCounter : public Instrumentation::Tracer {
+public:
+  unsigned long n;
+  SpanCounter() : n(0) {}
+  void Begin(Instrumentation::span) {}
+  void End(Instrumentation::span, double) { ++n; }
+};
+
+int main() {
+  try {
+    if (!Instrumentation::Enabled())
+      cout << "The library was compiled without instrumentation\n";
+    SpanCounter tracer;
+    Instrumentation::SetTracer(&tracer);
+    Instrumentation::Reset();
+    const Geodesic& geod = Geodesic::WGS84();
+    double s12;
+    for (int i = 0; i < 100; ++i)
+      geod.Inverse(0, 0, i * 0.5, 179.0, s12);
+    Instrumentation::Snapshot snap;
+    Instrumentation::GetSnapshot(snap);
+    Instrumentation::SetTracer();
+    // The histogram of the numbers of Lambda12 evaluations
+    for (int k = 0; k < Instrumentation::nbins_; ++k)
+      if (snap.hist[Instrumentation::LAMBDA12_ITERATIONS][k])
+        cout << k << " "
+             << snap.hist[Instrumentation::LAMBDA12_ITERATIONS][k] << "\n";
+    cout << Instrumentation::Name(Instrumentation::SPHERICAL_VALUE) << " "
+         << snap.calls[Instrumentation::SPHERICAL_VALUE] << " "
+         << tracer.n << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,37 @@
+// Example of using the GeographicLib::InverseCache class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/InverseCache.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // Hold up to 10000 results with the positions quantized to 1e-5 degree
+    // (roughly 1 m).
+    InverseCache cache(Geodesic::WGS84(), 10000, 1e-5);
+    // The distances of a round trip JFK -> LHR -> NRT -> JFK, flown twice;
+    // the second trip is evaluated with the cached results.
+    double
+      lat[] = {40.64, 51.47, 35.77},
+      lon[] = {-73.78, -0.46, 140.39};
+    for (int trip = 0; trip < 2; ++trip) {
+      double total = 0;
+      for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        double s12;
+        cache.Inverse(lat[i], lon[i], lat[j], lon[j], s12);
+        total += s12;
+      }
+      cout << "trip " << trip << " " << total / 1000 << " km\n";
+    }
+    cout << "hits " << cache.Hits() << " misses " << cache.Misses() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
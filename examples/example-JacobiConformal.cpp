@@ -0,0 +1,38 @@
+// Example of using the GeographicLib::JacobiConformal class
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <exception>
+#include <GeographicLib/JacobiConformal.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    double a = 6378137+35, b = 6378137-35, c = 6356752;
+    JacobiConformal jc(a, b, c, a-b, b-c);
+    cout  << fixed << setprecision(1)
+          << "Ellipsoid parameters: a = "
+          << a << ", b = " << b << ", c = " << c << "\n"
+          << setprecision(10)
+          << "Quadrants: x = " << jc.x() << ", y = " << jc.y() << "\n";
+    // Project the points omg = bet = 0, 5, ..., 90 together
+    vector<double> omg, bet;
+    for (int i = 0; i <= 90; i += 5) {
+      omg.push_back(i); bet.push_back(i);
+    }
+    size_t n = omg.size();
+    vector<double> x(n), y(n);
+    jc.Forward(&omg[0], &bet[0], n, &x[0], &y[0]);
+    cout << "Coordinates (angle x y) in degrees:\n";
+    for (size_t i = 0; i < n; ++i)
+      cout << int(omg[i]) << " " << x[i] << " " << y[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
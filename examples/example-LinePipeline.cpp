@@ -0,0 +1,46 @@
+// Example of using the GeographicLib::LinePipeline class
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <exception>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/LinePipeline.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// Each line of input is "lat1 lon1 lat2 lon2"; the output is the distance
+class Distance : public LinePipeline::Stage {
+private:
+  const Geodesic& _geod;
+public:
+  explicit Distance(const Geodesic& geod) : _geod(geod) {}
+  int operator()(const string& line, ostream& out) const {
+    istringstream str(line);
+    double lat1, lon1, lat2, lon2, s12;
+    if (!(str >> lat1 >> lon1 >> lat2 >> lon2)) {
+      out << "ERROR: " << line << "\n";
+      return 1;
+    }
+    _geod.Inverse(lat1, lon1, lat2, lon2, s12);
+    out << s12 << "\n";
+    return 0;
+  }
+};
+
+int main() {
+  try {
+    const Geodesic& geod = Geodesic::WGS84();
+    istringstream in("40.6 -73.8 51.6 -0.5\n"
+                     "-33.9 151.2 35.6 139.8\n"
+                     "0 0 0 90\n");
+    // Process the lines in 2 pieces concurrently
+    int ret = LinePipeline(2).Run(in, cout, Distance(geod));
+    return ret;
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,30 @@
+// Example of using the GeographicLib::MGRSGrid class
+
+#include <iostream>
+#include <vector>
+#include <exception>
+#include <GeographicLib/MGRSGrid.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // The 10 km grid squares with corners densified into 4 segments per side
+    MGRSGrid grid(1, 4);
+    vector<MGRSGrid::Square> squares;
+    vector<MGRSGrid::Line> lines;
+    // A viewport around Paris straddling the boundary of zones 30 and 31
+    grid.Generate(48.5, -0.5, 49.2, 0.5, squares, lines);
+    cout << squares.size() << " squares, " << lines.size() << " lines\n";
+    for (size_t i = 0; i < squares.size(); i += 10)
+      cout << squares[i].mgrs << " " << squares[i].lat[0] << " "
+           << squares[i].lon[0] << (squares[i].partial ? " partial" : "")
+           << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::MagneticCircleCache class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticCircleCache.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    MagneticModel mag("wmm2015");
+    // Hold up to 100 circles; the latitudes and heights are not quantized.
+    MagneticCircleCache cache(mag, 100);
+    // A satellite ground track which repeats every 10 days passes over the
+    // same latitudes at the same height.
+    double lat = 27.99, lon0 = 86.93, h = 400e3, t0 = 2016.0;
+    for (int pass = 0; pass < 3; ++pass) {
+      double t = t0 + pass * 10 / 365.25, lon = lon0 + pass * 0.001;
+      double Bx, By, Bz;
+      // The first pass constructs the circle, the others use it.
+      cache(t, lat, lon, h, Bx, By, Bz);
+      cout << t << " " << Bx << " " << By << " " << Bz << "\n";
+    }
+    cout << "hits " << cache.Hits() << " misses " << cache.Misses() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
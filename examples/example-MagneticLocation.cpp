@@ -0,0 +1,28 @@
+// Example of using the GeographicLib::MagneticLocation class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticLocation.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    MagneticModel mag("wmm2010");
+    // Evaluate the sums for Mt Everest once and then evaluate the field at
+    // several times.
+    MagneticLocation loc = mag.AtLocation(27.99, 86.93, 8820);
+    for (int i = 0; i < 4; ++i) {
+      double t = 2010 + 1.5 * i, Bx, By, Bz;
+      loc(t, Bx, By, Bz);
+      cout << t << " " << Bx << " " << By << " " << Bz << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,32 @@
+// Example of using the GeographicLib::MagneticSnapshot class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticSnapshot.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    MagneticModel mag("wmm2010");
+    double t = 2012;
+    // Combine the coefficients for time t once and then evaluate the field at
+    // several points.
+    MagneticSnapshot snap = mag.AtTime(t);
+    double lat[] = {27.99, -33.87, 51.48}, lon[] = {86.93, 151.21, 0},
+      h[] = {8820, 0, 0};
+    for (int i = 0; i < 3; ++i) {
+      double Bx, By, Bz;
+      snap(lat[i], lon[i], h[i], Bx, By, Bz);
+      cout << lat[i] << " " << lon[i] << " "
+           << Bx << " " << By << " " << Bz << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+// Example of using the GeographicLib::NumaReplicas class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/NumaReplicas.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// A spherical harmonic sum which owns its coefficients
+class Model {
+private:
+  vector<double> _C, _S;
+  SphericalHarmonic _h;
+public:
+  explicit Model(int N)
+    : _C((N + 1) * (N + 2) / 2), _S(N * (N + 1) / 2)
+  {
+    for (size_t i = 0; i < _C.size(); ++i) _C[i] = 1 / double(i + 1);
+    for (size_t i = 0; i < _S.size(); ++i) _S[i] = 1 / double(i + 2);
+    _h = SphericalHarmonic(_C, _S, N, 1);
+  }
+  double operator()(double x, double y, double z) const
+  { return _h(x, y, z); }
+};
+
+// The factory for the copies
+Model* MakeModel() { return new Model(360); }
+
+int main() {
+  try {
+    // One copy of the model per NUMA node
+    NumaReplicas<Model> model(MakeModel);
+    // Each thread evaluates the copy on its own node
+    double v = model.Local()(2, 3, 1);
+    cout << model.Count() << " copies; value " << v << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+// Example of using the GeographicLib::Projector class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Projector.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// A function which works with any projection
+void Print(const Projector& proj,
+           const double lat[], const double lon[], size_t n) {
+  double x[3], y[3];
+  proj.ForwardBatch(lat, lon, n, x, y);
+  for (size_t i = 0; i < n; ++i)
+    cout << x[i] << " " << y[i] << "\n";
+}
+
+int main() {
+  try {
+    double lat[] = {48.2, 50.1, 52.5}, lon[] = {16.4, 14.4, 13.4};
+    // UTM zone 33 (without the false easting and northing)
+    ProjectorT<TransverseMercator>
+      utm(TransverseMercator::UTM(), 15);
+    // A Lambert conformal conic projection for central Europe
+    ProjectorT<LambertConformalConic>
+      lcc(LambertConformalConic(Constants::WGS84_a(),
+                                Constants::WGS84_f(), 35, 65, 1), 10);
+    Print(utm, lat, lon, 3);
+    Print(lcc, lat, lon, 3);
+    // Convert the UTM coordinates to LCC without handling the geographic
+    // coordinates explicitly
+    double x[3], y[3], u[3], v[3];
+    utm.ForwardBatch(lat, lon, 3, x, y);
+    Reprojector(utm, lcc)(x, y, 3, u, v);
+    for (int i = 0; i < 3; ++i)
+      cout << u[i] << " " << v[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
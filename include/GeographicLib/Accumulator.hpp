@@ -33,6 +33,27 @@ namespace GeographicLib {
    * In the documentation of the member functions, \e sum stands for the value
    * currently held in the accumulator.
    *
+   * Partial sums held in several accumulators (e.g., one per thread) can be
+   * combined with Accumulator::operator+=(const Accumulator&) or
+   * Accumulator::operator+(const Accumulator&) const without losing
+   * precision; the latter allows an Accumulator to be used with
+   * std::accumulate or std::reduce.  If the calling code is compiled with
+   * OpenMP 4.0 or later, a user-defined reduction for Accumulator<> is
+   * declared, so that you can write, for example,
+   * \code
+   Accumulator<> sum;
+   #pragma omp parallel for reduction(+:sum)
+   for (long i = 0; i < n; ++i)
+     sum += x[i];
+   \endcode
+   * The combination of partial sums is not exactly associative (the sum
+   * held in an accumulator may depend on the order in which the partial sums
+   * are combined by about 1 ulp of the less significant component); so, if
+   * bit-for-bit reproducibility is required (the OpenMP reduction gives no
+   * such guarantee), compute the partial sums over fixed ranges of the terms
+   * and combine them with Accumulator::Reduce (as PolygonAreaT::AddPoints
+   * does).
+   *
    * Example of use:
    * \include example-Accumulator.cpp
    **********************************************************************/
@@ -91,6 +112,8 @@ namespace GeographicLib {
       a.Add(y);
       return a._s;
     }
+    // The number of independent accumulators used by AddArray
+    static const int lanes_ = 4;
   public:
     /**
      * Construct from a \e T.  This is not declared explicit, so that you can
@@ -127,6 +150,97 @@ namespace GeographicLib {
      * @param[in] y set \e sum += \e y.
      **********************************************************************/
     Accumulator& operator+=(T y) { Add(y); return *this; }
+    /**
+     * Add another accumulator to the accumulator.
+     *
+     * @param[in] a set \e sum += \e a.
+     *
+     * Both components of \e a are added so that the combination of partial
+     * sums (e.g., computed by different threads) is as accurate as a single
+     * accumulation.
+     **********************************************************************/
+    Accumulator& operator+=(const Accumulator& a)
+    { Add(a._t); Add(a._s); return *this; }
+    /**
+     * Return the sum of two accumulators.
+     *
+     * @param[in] a the accumulator to be added.
+     * @return an Accumulator holding \e sum + \e a.
+     *
+     * This is the same as Accumulator::operator+=(const Accumulator&) except
+     * that neither accumulator is changed.  It is suitable for use as the
+     * binary operation in std::accumulate and std::reduce.
+     **********************************************************************/
+    Accumulator operator+(const Accumulator& a) const
+    { Accumulator b(*this); b += a; return b; }
+    /**
+     * Combine an array of partial sums in a fixed order.
+     *
+     * @param[in] a the array of accumulators.
+     * @param[in] n the number of accumulators.
+     * @return an Accumulator holding the sum of the \e n partial sums.
+     *
+     * The partial sums are combined pairwise in a balanced binary tree whose
+     * shape depends only on \e n.  So, if a sum is split into partial sums
+     * over fixed ranges of its terms, the result is the same no matter how
+     * many threads computed the partial sums or in which order they
+     * finished.  The tree keeps the depth of the combination to about
+     * log<sub>2</sub><i>n</i> so that the round-off in the less significant
+     * component grows only slowly with \e n.
+     **********************************************************************/
+    static Accumulator Reduce(const Accumulator a[], size_t n) {
+      if (n == 0) return Accumulator();
+      if (n == 1) return a[0];
+      size_t m = n / 2;
+      Accumulator b(Reduce(a, m));
+      b += Reduce(a + m, n - m);
+      return b;
+    }
+    /**
+     * Add an array of numbers to the accumulator.
+     *
+     * @param[in] x the array of numbers.
+     * @param[in] n the number of elements in \e x.
+     * @return a reference to the accumulator.
+     *
+     * This is equivalent to adding the elements of \e x one at a time.
+     * However the elements are distributed cyclically among 4 accumulators
+     * which are then combined with Accumulator::Reduce.  The additions to
+     * the separate accumulators don't depend on each other, so the processor
+     * can overlap them (and the compiler can vectorize them); this is a few
+     * times faster than adding the elements one at a time for large \e n.
+     * Each element still goes through an error-free two-sum, so the result
+     * agrees with that for adding the elements in turn to within the
+     * round-off of the final sum, the same accuracy as combining partial
+     * sums computed by different threads.  The result depends only on the
+     * values in \e x and their order.
+     **********************************************************************/
+    Accumulator& AddArray(const T x[], size_t n) {
+      if (n < size_t(2 * lanes_)) {
+        for (size_t i = 0; i < n; ++i) Add(x[i]);
+        return *this;
+      }
+      // The lanes are held in separate arrays of the high and low parts so
+      // that the loop over the lanes is over contiguous elements.
+      T s[lanes_], t[lanes_];
+      for (int l = 0; l < lanes_; ++l) { s[l] = x[l]; t[l] = 0; }
+      size_t i = lanes_;
+      for (; i + lanes_ <= n; i += lanes_)
+        for (int l = 0; l < lanes_; ++l) {
+          // The same as Add(x[i + l]) for lane l
+          T u, y = Math::sum(x[i + l], t[l], u);
+          s[l] = Math::sum(y, s[l], t[l]);
+          if (s[l] == 0)
+            s[l] = u;
+          else
+            t[l] += u;
+        }
+      Accumulator a[lanes_];
+      for (int l = 0; l < lanes_; ++l) { a[l]._s = s[l]; a[l]._t = t[l]; }
+      for (; i < n; ++i) a[i % lanes_].Add(x[i]);
+      *this += Reduce(a, lanes_);
+      return *this;
+    }
     /**
      * Subtract a number from the accumulator.
      *
@@ -169,4 +283,11 @@ namespace GeographicLib {
 
 } // namespace GeographicLib
 
+#if defined(_OPENMP) && _OPENMP >= 201307
+// A user-defined reduction for combining the partial sums from each thread.
+#  pragma omp declare reduction(+ : GeographicLib::Accumulator<> :   \
+                                omp_out += omp_in)                    \
+  initializer(omp_priv = GeographicLib::Accumulator<>())
+#endif
+
 #endif  // GEOGRAPHICLIB_ACCUMULATOR_HPP
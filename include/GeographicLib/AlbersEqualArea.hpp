@@ -115,6 +115,12 @@ namespace GeographicLib {
     void Init(real sphi1, real cphi1, real sphi2, real cphi2, real k1);
     real txif(real tphi) const;
     real tphif(real txi) const;
+    // The parts of Forward which depend only on the latitude and only on the
+    // longitude relative to the central meridian.  These are combined by
+    // Forward and ForwardGrid.
+    void ForwardLat(real lat, real& drho, real& t, real& k) const;
+    void ForwardLon(real lon, real& sx, real& cy, real& ctheta, real& gamma)
+      const;
 
     friend class Ellipsoid;           // For access to txif, tphif, etc.
   public:
@@ -260,6 +266,75 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of azimuthal scales of projection.
+     *
+     * The results are identical to calling AlbersEqualArea::Forward for each
+     * point.  \e gamma and \e k may be null pointers (the default).
+     **********************************************************************/
+    void ForwardBatch(real lon0, const real lat[], const real lon[], size_t n,
+                      real x[], real y[], real gamma[] = 0, real k[] = 0)
+      const;
+
+    /**
+     * Forward projection of a regular grid of points.
+     *
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] lat1 the latitude of the first row (degrees).
+     * @param[in] dlat the latitude spacing of the rows (degrees).
+     * @param[in] nlat the number of rows.
+     * @param[in] lon1 the longitude of the first column (degrees).
+     * @param[in] dlon the longitude spacing of the columns (degrees).
+     * @param[in] nlon the number of columns.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of azimuthal scales of projection.
+     *
+     * The results for the point at \e lat = \e lat1 + \e i \e dlat, \e lon =
+     * \e lon1 + \e j \e dlon, for \e i = 0, 1, ..., \e nlat &minus; 1 and
+     * \e j = 0, 1, ..., \e nlon &minus; 1, are returned in element \e i
+     * \e nlon + \e j of the output arrays (i.e., in row-major order).  They
+     * are identical to calling AlbersEqualArea::Forward for each point.
+     * However, the quantities which depend only on latitude (including the
+     * scale) are computed once per row and those which depend only on
+     * longitude (including the convergence) once per column, so that each
+     * grid point requires just a few multiplications.  \e gamma and \e k
+     * may be null pointers (the default).
+     **********************************************************************/
+    void ForwardGrid(real lon0, real lat1, real dlat, int nlat,
+                     real lon1, real dlon, int nlon,
+                     real x[], real y[], real gamma[] = 0, real k[] = 0)
+      const;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of azimuthal scales of projection.
+     *
+     * The results are identical to calling AlbersEqualArea::Reverse for each
+     * point.  \e gamma and \e k may be null pointers (the default).
+     **********************************************************************/
+    void ReverseBatch(real lon0, const real x[], const real y[], size_t n,
+                      real lat[], real lon[], real gamma[] = 0, real k[] = 0)
+      const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
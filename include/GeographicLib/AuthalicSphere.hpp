@@ -0,0 +1,317 @@
+/**
+ * \file AuthalicSphere.hpp
+ * \brief Header for GeographicLib::AuthalicSphere class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_AUTHALICSPHERE_HPP)
+#define GEOGRAPHICLIB_AUTHALICSPHERE_HPP 1
+
+#include <GeographicLib/Ellipsoid.hpp>
+
+namespace GeographicLib {
+
+  template <class T> class PolygonAreaT;
+  template <class T> class EditablePolygonAreaT;
+
+  /**
+   * \brief Approximate geodesics using great circles on the authalic sphere
+   *
+   * The ellipsoid is mapped to the authalic sphere, the sphere with the same
+   * area as the ellipsoid, by replacing the latitude \e phi by the authalic
+   * latitude \e xi (see Ellipsoid::AuthalicLatitude); the longitude is
+   * unchanged.  This mapping preserves areas.  The path between two points
+   * is taken to be the image of the great circle through the corresponding
+   * points on the sphere, and the direct and inverse problems are solved
+   * with the closed-form formulas of spherical trigonometry.  In particular,
+   * the area \e S12 is given by the spherical excess of the quadrilateral
+   * with corners (<i>lat1</i>,<i>lon1</i>), (0,<i>lon1</i>),
+   * (0,<i>lon2</i>), and (<i>lat2</i>,<i>lon2</i>).
+   *
+   * This class provides the same interface as Geodesic and Rhumb for the
+   * quantities \e s12, \e azi1, \e azi2, and \e S12 (the reduced length and
+   * the geodesic scales are not available).  Its main use is as the template
+   * parameter for PolygonAreaT (see the typedef PolygonAreaAuthalic) when
+   * only an approximate area is needed, e.g., for screening large numbers of
+   * polygons.  PolygonAreaAuthalic is about 5 times faster than PolygonArea.
+   *
+   * The path approximates the geodesic to order \e f, so that the results
+   * differ from those given by Geodesic.  For WGS84:
+   * - \e s12 is the length of the great circle on the authalic sphere; it
+   *   differs from the geodesic distance by up to 0.12%.
+   * - \e azi1 and \e azi2 are the azimuths of the great circle on the sphere;
+   *   these differ from the geodesic azimuths by up to 2&deg; (the largest
+   *   errors are for paths passing close to a pole).
+   * - Because the mapping preserves areas, the error in the area of a
+   *   polygon arises only from the difference in the shapes of its edges.
+   *   For polygons with a diameter \e D, the relative error in the area is
+   *   less than 2 &times; 10<sup>&minus;8</sup> for \e D = 1 km, 2 &times;
+   *   10<sup>&minus;6</sup> for \e D = 100 km, 3 &times;
+   *   10<sup>&minus;5</sup> for \e D = 1000 km, and 2 &times;
+   *   10<sup>&minus;4</sup> for \e D = 3000 km.  The error may be larger for
+   *   long, narrow polygons.
+   * .
+   * If \e f = 0, the results agree with those of Geodesic to within
+   * roundoff.
+   *
+   * Example of use:
+   * \include example-AuthalicSphere.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT AuthalicSphere {
+  private:
+    typedef Math::real real;
+    template <class T> friend class PolygonAreaT;
+    template <class T> friend class EditablePolygonAreaT;
+    Ellipsoid _ell;
+    real tiny_, _e2, _es, _qp, _r, _c2;
+
+    // The function q(sin(phi)) (Snyder, Eq. 3-12) divided by (1 - e^2).
+    real q(real sphi) const {
+      return sphi / (1 - _e2 * Math::sq(sphi)) +
+        (_e2 != 0 ? Math::eatanhe(sphi, _es) / _e2 : sphi);
+    }
+    // Convert latitude phi to the sine and cosine of the authalic latitude.
+    void AuthalicSinCos(real phi, real& sxi, real& cxi) const;
+
+    // The following two functions (with lots of ignored arguments) mimic the
+    // interface to the corresponding Geodesic function.  These are needed by
+    // PolygonAreaT.
+    void GenDirect(real lat1, real lon1, real azi1,
+                   bool, real s12, unsigned outmask,
+                   real& lat2, real& lon2, real& azi2, real&, real&, real&,
+                   real&, real& S12) const {
+      GenDirect(lat1, lon1, azi1, s12, outmask, lat2, lon2, azi2, S12);
+    }
+    void GenInverse(real lat1, real lon1, real lat2, real lon2,
+                    unsigned outmask, real& s12, real& azi1, real& azi2,
+                    real& , real& , real& , real& S12) const {
+      GenInverse(lat1, lon1, lat2, lon2, outmask, s12, azi1, azi2, S12);
+    }
+  public:
+
+    /**
+     * Bit masks for what calculations to do.  They specify which results to
+     * return in the general routines AuthalicSphere::GenDirect and
+     * AuthalicSphere::GenInverse routines.
+     **********************************************************************/
+    enum mask {
+      /**
+       * No output.
+       * @hideinitializer
+       **********************************************************************/
+      NONE          = 0U,
+      /**
+       * Calculate latitude \e lat2.
+       * @hideinitializer
+       **********************************************************************/
+      LATITUDE      = 1U<<7,
+      /**
+       * Calculate longitude \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONGITUDE     = 1U<<8,
+      /**
+       * Calculate azimuths \e azi1 and \e azi2.
+       * @hideinitializer
+       **********************************************************************/
+      AZIMUTH       = 1U<<9,
+      /**
+       * Calculate distance \e s12.
+       * @hideinitializer
+       **********************************************************************/
+      DISTANCE      = 1U<<10,
+      /**
+       * Calculate area \e S12.
+       * @hideinitializer
+       **********************************************************************/
+      AREA          = 1U<<14,
+      /**
+       * Unroll \e lon2 in the direct calculation.
+       * @hideinitializer
+       **********************************************************************/
+      LONG_UNROLL   = 1U<<15,
+      /**
+       * Calculate everything.  (LONG_UNROLL is not included in this mask.)
+       * @hideinitializer
+       **********************************************************************/
+      ALL           = 0x7F80U,
+    };
+
+    /**
+     * Constructor for a ellipsoid with
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
+     *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
+     *   flattening to 1/\e f.
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     **********************************************************************/
+    AuthalicSphere(real a, real f);
+
+    /**
+     * Solve the direct problem.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] S12 area under the path (meters<sup>2</sup>).
+     *
+     * \e lat1 should be in the range [&minus;90&deg;, 90&deg;]; \e lon1 and \e
+     * azi1 should be in the range [&minus;540&deg;, 540&deg;).  The values of
+     * \e lon2 and \e azi2 returned are in the range [&minus;180&deg;,
+     * 180&deg;).
+     **********************************************************************/
+    void Direct(real lat1, real lon1, real azi1, real s12,
+                real& lat2, real& lon2, real& azi2, real& S12) const {
+      GenDirect(lat1, lon1, azi1, s12, LATITUDE | LONGITUDE | AZIMUTH | AREA,
+                lat2, lon2, azi2, S12);
+    }
+
+    /**
+     * Solve the direct problem without the azimuth and area.
+     **********************************************************************/
+    void Direct(real lat1, real lon1, real azi1, real s12,
+                real& lat2, real& lon2) const {
+      real t;
+      GenDirect(lat1, lon1, azi1, s12, LATITUDE | LONGITUDE,
+                lat2, lon2, t, t);
+    }
+
+    /**
+     * The general direct problem.  AuthalicSphere::Direct is defined in
+     * terms of this function.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[in] outmask a bitor'ed combination of AuthalicSphere::mask
+     *   values specifying which of the following parameters should be set.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] S12 area under the path (meters<sup>2</sup>).
+     *
+     * The AuthalicSphere::mask values possible for \e outmask are
+     * - \e outmask |= AuthalicSphere::LATITUDE for the latitude \e lat2;
+     * - \e outmask |= AuthalicSphere::LONGITUDE for the latitude \e lon2;
+     * - \e outmask |= AuthalicSphere::AZIMUTH for the azimuth \e azi2;
+     * - \e outmask |= AuthalicSphere::AREA for the area \e S12;
+     * - \e outmask |= AuthalicSphere::ALL for all of the above;
+     * - \e outmask |= AuthalicSphere::LONG_UNROLL to unroll \e lon2 instead
+     *   of wrapping it into the range [&minus;180&deg;, 180&deg;).
+     * .
+     * With the AuthalicSphere::LONG_UNROLL bit set, the quantity \e lon2
+     * &minus; \e lon1 indicates how many times and in what sense the path
+     * encircles the ellipsoid.
+     **********************************************************************/
+    void GenDirect(real lat1, real lon1, real azi1, real s12, unsigned outmask,
+                   real& lat2, real& lon2, real& azi2, real& S12) const;
+
+    /**
+     * Solve the inverse problem.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] S12 area under the path (meters<sup>2</sup>).
+     *
+     * \e lat1 and \e lat2 should be in the range [&minus;90&deg;, 90&deg;];
+     * \e lon1 and \e lon2 should be in the range [&minus;540&deg;, 540&deg;).
+     * The values of \e azi1 and \e azi2 returned are in the range
+     * [&minus;180&deg;, 180&deg;).
+     **********************************************************************/
+    void Inverse(real lat1, real lon1, real lat2, real lon2,
+                 real& s12, real& azi1, real& azi2, real& S12) const {
+      GenInverse(lat1, lon1, lat2, lon2, DISTANCE | AZIMUTH | AREA,
+                 s12, azi1, azi2, S12);
+    }
+
+    /**
+     * Solve the inverse problem without the azimuths and area.
+     **********************************************************************/
+    void Inverse(real lat1, real lon1, real lat2, real lon2,
+                 real& s12) const {
+      real t;
+      GenInverse(lat1, lon1, lat2, lon2, DISTANCE, s12, t, t, t);
+    }
+
+    /**
+     * The general inverse problem.  AuthalicSphere::Inverse is defined in
+     * terms of this function.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of AuthalicSphere::mask
+     *   values specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] S12 area under the path (meters<sup>2</sup>).
+     *
+     * The AuthalicSphere::mask values possible for \e outmask are
+     * - \e outmask |= AuthalicSphere::DISTANCE for the distance \e s12;
+     * - \e outmask |= AuthalicSphere::AZIMUTH for the azimuths \e azi1 and
+     *   \e azi2;
+     * - \e outmask |= AuthalicSphere::AREA for the area \e S12;
+     * - \e outmask |= AuthalicSphere::ALL for all of the above.
+     **********************************************************************/
+    void GenInverse(real lat1, real lon1, real lat2, real lon2,
+                    unsigned outmask,
+                    real& s12, real& azi1, real& azi2, real& S12) const;
+
+    /** \name Inspector functions.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _ell.MajorRadius(); }
+
+    /**
+     * @return \e f the  flattening of the ellipsoid.  This is the
+     *   value used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _ell.Flattening(); }
+
+    /**
+     * @return \e R the radius of the authalic sphere (meters).
+     **********************************************************************/
+    Math::real AuthalicRadius() const { return _r; }
+
+    /**
+     * @return total area of ellipsoid in meters<sup>2</sup>.  This is also
+     *   the area of the authalic sphere.
+     **********************************************************************/
+    Math::real EllipsoidArea() const { return _ell.Area(); }
+    ///@}
+
+    /**
+     * A global instantiation of AuthalicSphere with the parameters for the
+     * WGS84 ellipsoid.
+     **********************************************************************/
+    static const AuthalicSphere& WGS84();
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_AUTHALICSPHERE_HPP
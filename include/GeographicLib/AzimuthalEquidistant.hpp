@@ -120,6 +120,55 @@ namespace GeographicLib {
       Reverse(lat0, lon0, x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection of many points about a single center.
+     *
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] azi array of azimuths of the geodesics at the points
+     *   (degrees).
+     * @param[out] rk array of reciprocals of the azimuthal scales.
+     *
+     * The quantities which depend only on the center of the projection are
+     * computed once (as a Geodesic::Point).  The results are identical to
+     * calling AzimuthalEquidistant::Forward for each point.  \e azi and \e rk
+     * may be null pointers (the default).
+     **********************************************************************/
+    void ForwardBatch(real lat0, real lon0,
+                      const real lat[], const real lon[], size_t n,
+                      real x[], real y[], real azi[] = 0, real rk[] = 0)
+      const;
+
+    /**
+     * Reverse projection of many points about a single center.
+     *
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] azi array of azimuths of the geodesics at the points
+     *   (degrees).
+     * @param[out] rk array of reciprocals of the azimuthal scales.
+     *
+     * The GeodesicLine from the center is reused for runs of consecutive
+     * points which lie in the same direction from the center (e.g., the
+     * range bins of a radar beam).  The results are identical to calling
+     * AzimuthalEquidistant::Reverse for each point.  \e azi and \e rk may
+     * be null pointers (the default).
+     **********************************************************************/
+    void ReverseBatch(real lat0, real lon0,
+                      const real x[], const real y[], size_t n,
+                      real lat[], real lon[], real azi[] = 0, real rk[] = 0)
+      const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -168,6 +168,46 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] azi array of azimuths of the easting (x) directions
+     *   (degrees).
+     * @param[out] rk array of reciprocals of the azimuthal northing scales.
+     *
+     * The results are identical to calling CassiniSoldner::Forward for each
+     * point.  \e azi and \e rk may be null pointers (the default).  If the
+     * object has not been initialized, the arrays are not set.
+     **********************************************************************/
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[], real azi[] = 0, real rk[] = 0)
+      const;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] azi array of azimuths of the easting (x) directions
+     *   (degrees).
+     * @param[out] rk array of reciprocals of the azimuthal northing scales.
+     *
+     * The results are identical to calling CassiniSoldner::Reverse for each
+     * point.  \e azi and \e rk may be null pointers (the default).  If the
+     * object has not been initialized, the arrays are not set.
+     **********************************************************************/
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[], real azi[] = 0, real rk[] = 0)
+      const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
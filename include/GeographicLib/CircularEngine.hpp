@@ -41,9 +41,14 @@ namespace GeographicLib {
    * SphericalHarmonic2::Circle to create instances of this class.
    *
    * CircularEngine stores the coefficients needed to allow the summation over
-   * order to be performed in 2 or 6 vectors of length \e M + 1 (depending on
-   * whether gradients are to be calculated).  For this reason the constructor
-   * may throw a std::bad_alloc exception.
+   * order to be performed in a single vector of length 2(\e M + 1) or 6(\e
+   * M + 1) (depending on whether gradients are to be calculated).  For this
+   * reason the constructor may throw a std::bad_alloc exception.  Once
+   * constructed, CircularEngine::operator()() doesn't allocate memory.
+   * CircularEngine::EvaluateRow needs scratch space if it uses the FFT; with
+   * C++11, this is kept for each thread and reused by later calls, so that
+   * no allocation is needed once the scratch space has grown to the size
+   * needed.
    *
    * Example of use:
    * \include example-CircularEngine.cpp
@@ -60,11 +65,38 @@ namespace GeographicLib {
     bool _gradp;
     unsigned _norm;
     real _a, _r, _u, _t;
-    std::vector<real> _wc, _ws, _wrc, _wrs, _wtc, _wts;
+    // The coefficients for order m are _w[nw() * m + i] for i = 0, 1 (the
+    // cosine and sine coefficients) and, if _gradp, i = 2, 3 (their
+    // derivatives wrt r) and i = 4, 5 (their derivatives wrt theta).
+    std::vector<real> _w;
     real _q, _uq, _uq2;
 
+    int nw() const { return _gradp ? 6 : 2; }
+
+    // Scratch space for the rows.  With C++11, there are nwork_ arrays for
+    // each thread; the array k is grown as needed and reused by later calls
+    // (so two live Workspace objects must have different k).  Otherwise, a
+    // new array is allocated for each Workspace.  Row uses k = 0; the rows
+    // in GravityCircle and MagneticCircle use k = 1.
+    class GEOGRAPHICLIB_EXPORT Workspace {
+    private:
+      std::vector<real> _own;
+      real* _p;
+      Workspace(const Workspace&);            // copy constructor not allowed
+      Workspace& operator=(const Workspace&); // copy assignment not allowed
+    public:
+      static const int nwork_ = 2;
+      // Provide room for n reals in array k.
+      Workspace(int k, size_t n);
+      real* data() const { return _p; }
+    };
+
     Math::real Value(bool gradp, real cl, real sl,
                      real& gradx, real& grady, real& gradz) const;
+    // Should Row use an FFT?  If so, set P = 360/dlon.
+    bool FFTRow(real dlon, int nlon, int& P) const;
+    void Row(bool gradp, real lon0, real dlon, int nlon, real v[],
+             real gradx[], real grady[], real gradz[]) const;
 
     static inline void cossin(real x, real& cosx, real& sinx) {
       using std::abs; using std::cos; using std::sin;
@@ -86,27 +118,25 @@ namespace GeographicLib {
       , _r(r)
       , _u(u)
       , _t(t)
-      , _wc(std::vector<real>(_M + 1, 0))
-      , _ws(std::vector<real>(_M + 1, 0))
-      , _wrc(std::vector<real>(_gradp ? _M + 1 : 0, 0))
-      , _wrs(std::vector<real>(_gradp ? _M + 1 : 0, 0))
-      , _wtc(std::vector<real>(_gradp ? _M + 1 : 0, 0))
-      , _wts(std::vector<real>(_gradp ? _M + 1 : 0, 0))
+      , _w(std::vector<real>(nw() * (_M + 1), 0))
       {
         _q = _a / _r;
         _uq = _u * _q;
         _uq2 = Math::sq(_uq);
       }
 
-    void SetCoeff(int m, real wc, real ws)
-    { _wc[m] = wc; _ws[m] = ws; }
+    void SetCoeff(int m, real wc, real ws) {
+      real* w = &_w[nw() * m];
+      w[0] = wc; w[1] = ws;
+    }
 
     void SetCoeff(int m, real wc, real ws,
                   real wrc, real wrs, real wtc, real wts) {
-      _wc[m] = wc; _ws[m] = ws;
+      real* w = &_w[nw() * m];
+      w[0] = wc; w[1] = ws;
       if (_gradp) {
-        _wrc[m] = wrc; _wrs[m] = wrs;
-        _wtc[m] = wtc; _wts[m] = wts;
+        w[2] = wrc; w[3] = wrs;
+        w[4] = wtc; w[5] = wts;
       }
     }
 
@@ -120,8 +150,14 @@ namespace GeographicLib {
     CircularEngine()
       : _M(-1)
       , _gradp(true)
+      , _norm(FULL)
+      , _a(0)
+      , _r(0)
       , _u(0)
       , _t(1)
+      , _q(0)
+      , _uq(0)
+      , _uq2(0)
       {}
 
     /**
@@ -194,6 +230,55 @@ namespace GeographicLib {
       cossin(lon, coslon, sinlon);
       return (*this)(coslon, sinlon, gradx, grady, gradz);
     }
+
+    /**
+     * Evaluate the sum for a row of equally spaced longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] v array of the values of the sum for longitudes \e lon0 +
+     *   \e j \e dlon for \e j = 0, 1, ..., \e nlon &minus; 1.
+     * @exception std::bad_alloc if the memory for the FFT can't be allocated
+     *   (with C++11, this can only happen the first time a thread uses an
+     *   FFT of this size).
+     *
+     * If 360&deg;/\e dlon is an integer \e P, the sum over order \e m for
+     * all the longitudes is done with a fast Fourier transform of length \e
+     * P (taking about <i>P</i> log <i>P</i> operations) instead of by
+     * Clenshaw summation for each longitude (about <i>M</i> \e nlon
+     * operations); the method is picked based on an estimate of the cost.
+     * If the FFT is used, the results agree with those of
+     * CircularEngine::operator()() to within roundoff but are not
+     * bit-for-bit identical.  The FFT is only efficient if \e P has no large
+     * prime factors; this is the case for the grid spacings usually used.
+     **********************************************************************/
+    void EvaluateRow(real lon0, real dlon, int nlon, real v[]) const
+    { Row(false, lon0, dlon, nlon, v, 0, 0, 0); }
+
+    /**
+     * Evaluate the sum and its gradient for a row of equally spaced
+     * longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] v array of the values of the sum.
+     * @param[out] gradx array of the \e x components of the gradient.
+     * @param[out] grady array of the \e y components of the gradient.
+     * @param[out] gradz array of the \e z components of the gradient.
+     * @exception std::bad_alloc if the memory for the FFT can't be allocated
+     *   (with C++11, this can only happen the first time a thread uses an
+     *   FFT of this size).
+     *
+     * This is the same as the previous function except that the gradients are
+     * computed.  As with CircularEngine::operator()(), the gradients are
+     * only computed if the CircularEngine object was created with this
+     * capability; if not, \e gradx, etc., are not touched.
+     **********************************************************************/
+    void EvaluateRow(real lon0, real dlon, int nlon, real v[],
+                     real gradx[], real grady[], real gradz[]) const
+    { Row(true, lon0, dlon, nlon, v, gradx, grady, gradz); }
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,332 @@
+/**
+ * \file CompactGeodesicLine.hpp
+ * \brief Header for GeographicLib::CompactGeodesicLineT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_COMPACTGEODESICLINE_HPP)
+#define GEOGRAPHICLIB_COMPACTGEODESICLINE_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A geodesic line with a small memory footprint
+   *
+   * This computes positions on a geodesic in the same way as GeodesicLine;
+   * however an object only holds the starting point and azimuth, a few
+   * quantities derived from them with trigonometric functions, and a
+   * pointer to the Geodesic object.  The coefficients of the series
+   * expansions, which make up most of a GeodesicLine object, are
+   * recomputed from the equatorial azimuth for each position.  This is
+   * suitable when very many lines are held in memory.  Computing a
+   * position takes about 1.5 times as long as with GeodesicLine.
+   *
+   * The positions, azimuths, and distances are computed (the reduced
+   * length, geodesic scale, and area are not provided; use
+   * CompactGeodesicLineT::Line to obtain a GeodesicLine for these).  With
+   * \e T = Math::real, the results are identical to those returned by
+   * GeodesicLine and an object occupies 96 bytes (compared with about 500
+   * bytes for a GeodesicLine) on a 64-bit machine with doubles.  With \e T
+   * = float, the stored quantities are rounded to single precision; this
+   * reduces the size to 56 bytes and gives errors in the positions of up
+   * to a few meters.  In either case the calculations are carried out in
+   * Math::real.
+   *
+   * The Geodesic object passed to the constructor must outlive the
+   * CompactGeodesicLineT object.  The default copy constructor and
+   * assignment operators work with this class.
+   *
+   * @tparam T the type used to store the parameters of the line.
+   *
+   * Example of use:
+   * \include example-CompactGeodesicLine.cpp
+   **********************************************************************/
+
+  template <typename T = Math::real>
+  class CompactGeodesicLineT {
+  private:
+    typedef Math::real real;
+    static const int nC1_ = Geodesic::nC1_;
+    static const int nC1p_ = Geodesic::nC1p_;
+    static const int nC3_ = Geodesic::nC3_;
+    const Geodesic* _g;
+    T _lat1, _lon1, _azi1, _salp0, _calp0, _ssig1, _csig1, _somg1, _comg1,
+      _stau1, _ctau1;
+  public:
+
+    /**
+     * Bit masks for what calculations to do.  These are the corresponding
+     * values of Geodesic::mask which are supported by this class.
+     **********************************************************************/
+    enum mask {
+      /**
+       * No capabilities, no output.
+       * @hideinitializer
+       **********************************************************************/
+      NONE          = Geodesic::NONE,
+      /**
+       * Calculate latitude \e lat2.
+       * @hideinitializer
+       **********************************************************************/
+      LATITUDE      = Geodesic::LATITUDE,
+      /**
+       * Calculate longitude \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONGITUDE     = Geodesic::LONGITUDE,
+      /**
+       * Calculate azimuths \e azi2.
+       * @hideinitializer
+       **********************************************************************/
+      AZIMUTH       = Geodesic::AZIMUTH,
+      /**
+       * Calculate distance \e s12.
+       * @hideinitializer
+       **********************************************************************/
+      DISTANCE      = Geodesic::DISTANCE,
+      /**
+       * Unroll \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONG_UNROLL   = Geodesic::LONG_UNROLL,
+    };
+
+    /** \name Constructors
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Constructor for a compact geodesic line staring at latitude \e lat1,
+     * longitude \e lon1, and azimuth \e azi1 (all in degrees).
+     *
+     * @param[in] g A Geodesic object used to compute the necessary
+     *   information about the CompactGeodesicLineT; this must outlive the
+     *   CompactGeodesicLineT.
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     *
+     * \e lat1 should be in the range [&minus;90&deg;, 90&deg;]; \e lon1 and
+     * \e azi1 should be in the range [&minus;540&deg;, 540&deg;).
+     **********************************************************************/
+    CompactGeodesicLineT(const Geodesic& g, real lat1, real lon1, real azi1);
+
+    /**
+     * A default constructor.  If CompactGeodesicLineT::Position is called
+     * on the resulting object, it returns immediately (without doing any
+     * calculations).  The object can be set by assignment.  Use Init() to
+     * test whether object is still in this uninitialized state.
+     **********************************************************************/
+    CompactGeodesicLineT() : _g(0) {}
+    ///@}
+
+    /** \name Position in terms of distance
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 (meters)
+     * from point 1.
+     *
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can
+     *   be negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This is the same as GeodesicLine::Position.
+     **********************************************************************/
+    Math::real Position(real s12, real& lat2, real& lon2, real& azi2) const {
+      real t;
+      return GenPosition(false, s12, LATITUDE | LONGITUDE | AZIMUTH,
+                         lat2, lon2, azi2, t);
+    }
+
+    /**
+     * See the documentation for CompactGeodesicLineT::Position.
+     **********************************************************************/
+    Math::real Position(real s12, real& lat2, real& lon2) const {
+      real t;
+      return GenPosition(false, s12, LATITUDE | LONGITUDE,
+                         lat2, lon2, t, t);
+    }
+    ///@}
+
+    /** \name Position in terms of arc length
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Compute the position of point 2 which is an arc length \e a12
+     * (degrees) from point 1.
+     *
+     * @param[in] a12 arc length between point 1 and point 2 (degrees); it
+     *   can be negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     *
+     * This is the same as GeodesicLine::ArcPosition.
+     **********************************************************************/
+    void ArcPosition(real a12, real& lat2, real& lon2, real& azi2,
+                     real& s12) const {
+      GenPosition(true, a12, LATITUDE | LONGITUDE | AZIMUTH | DISTANCE,
+                  lat2, lon2, azi2, s12);
+    }
+
+    /**
+     * See the documentation for CompactGeodesicLineT::ArcPosition.
+     **********************************************************************/
+    void ArcPosition(real a12, real& lat2, real& lon2, real& azi2) const {
+      real t;
+      GenPosition(true, a12, LATITUDE | LONGITUDE | AZIMUTH,
+                  lat2, lon2, azi2, t);
+    }
+
+    /**
+     * See the documentation for CompactGeodesicLineT::ArcPosition.
+     **********************************************************************/
+    void ArcPosition(real a12, real& lat2, real& lon2) const {
+      real t;
+      GenPosition(true, a12, LATITUDE | LONGITUDE, lat2, lon2, t, t);
+    }
+    ///@}
+
+    /** \name The general position function.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * The general position function.  CompactGeodesicLineT::Position and
+     * CompactGeodesicLineT::ArcPosition are defined in terms of this
+     * function.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of the second
+     *   parameter.
+     * @param[in] s12_a12 if \e arcmode is false, this is the distance
+     *   between point 1 and point 2 (meters); otherwise it is the arc
+     *   length between point 1 and point 2 (degrees); it can be negative.
+     * @param[in] outmask a bitor'ed combination of
+     *   CompactGeodesicLineT::mask values specifying which of the following
+     *   parameters should be set.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees); requires that \e
+     *   outmask include CompactGeodesicLineT::LONGITUDE.
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees); requires that
+     *   \e outmask include CompactGeodesicLineT::AZIMUTH.
+     * @param[out] s12 distance between point 1 and point 2 (meters);
+     *   requires that \e outmask include CompactGeodesicLineT::DISTANCE.
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * The arguments have the same meaning as for GeodesicLine::GenPosition;
+     * only the coefficients needed by \e outmask are computed.
+     **********************************************************************/
+    Math::real GenPosition(bool arcmode, real s12_a12, unsigned outmask,
+                           real& lat2, real& lon2, real& azi2,
+                           real& s12) const;
+    ///@}
+
+    /**
+     * @param[in] caps bitor'ed combination of Geodesic::mask values
+     *   specifying the capabilities the GeodesicLine object should possess
+     *   (default Geodesic::ALL).
+     * @return a GeodesicLine for the same geodesic.
+     *
+     * This allows the reduced length, the geodesic scale, and the area to be
+     * computed.  With \e T = float, this is the line with the stored
+     * (rounded) starting point and azimuth.
+     **********************************************************************/
+    GeodesicLine Line(unsigned caps = Geodesic::ALL) const {
+      return Init() ? GeodesicLine(*_g, _lat1, _lon1, _azi1, caps) :
+        GeodesicLine();
+    }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _g != 0; }
+
+    /**
+     * @return \e lat1 the latitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Latitude() const
+    { return Init() ? real(_lat1) : Math::NaN(); }
+
+    /**
+     * @return \e lon1 the longitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Longitude() const
+    { return Init() ? real(_lon1) : Math::NaN(); }
+
+    /**
+     * @return \e azi1 the azimuth (degrees) of the geodesic line at point 1.
+     **********************************************************************/
+    Math::real Azimuth() const
+    { return Init() ? real(_azi1) : Math::NaN(); }
+
+    /**
+     * @return \e azi0 the azimuth (degrees) of the geodesic line as it crosses
+     *   the equator in a northward direction.
+     **********************************************************************/
+    Math::real EquatorialAzimuth() const {
+      using std::atan2;
+      return Init() ?
+        atan2(real(_salp0), real(_calp0)) / Math::degree() : Math::NaN();
+    }
+
+    /**
+     * @return \e a1 the arc length (degrees) between the northward equatorial
+     *   crossing and point 1.
+     **********************************************************************/
+    Math::real EquatorialArc() const {
+      using std::atan2;
+      return Init() ?
+        atan2(real(_ssig1), real(_csig1)) / Math::degree() : Math::NaN();
+    }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const
+    { return Init() ? _g->MajorRadius() : Math::NaN(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const
+    { return Init() ? _g->Flattening() : Math::NaN(); }
+    ///@}
+
+  };
+
+  /**
+   * @relates CompactGeodesicLineT
+   *
+   * Compact geodesic lines with the parameters stored in Math::real.
+   **********************************************************************/
+  typedef CompactGeodesicLineT<Math::real> CompactGeodesicLine;
+
+  /**
+   * @relates CompactGeodesicLineT
+   *
+   * Compact geodesic lines with the parameters stored in float.
+   **********************************************************************/
+  typedef CompactGeodesicLineT<float> CompactGeodesicLineFloat;
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_COMPACTGEODESICLINE_HPP
@@ -77,6 +77,32 @@
 #  endif
 #endif
 
+/**
+ * @relates GeographicLib::Constants
+ * Are C++14 constexpr functions (with local variables and loops) available?
+ **********************************************************************/
+#if !defined(GEOGRAPHICLIB_HAS_CONSTEXPR14)
+#  if __cplusplus >= 201402 || (defined(_MSC_VER) && _MSC_VER >= 1910)
+#    define GEOGRAPHICLIB_HAS_CONSTEXPR14 1
+#  else
+#    define GEOGRAPHICLIB_HAS_CONSTEXPR14 0
+#  endif
+#endif
+
+/**
+ * @relates GeographicLib::Constants
+ * Declare a function constexpr, if C++14 constexpr functions are available.
+ * This is used for the simple functions (e.g., Math::polyval) which can be
+ * used to evaluate quantities for a fixed ellipsoid at compile time.
+ **********************************************************************/
+#if !defined(GEOGRAPHICLIB_CONSTEXPR14)
+#  if GEOGRAPHICLIB_HAS_CONSTEXPR14
+#    define GEOGRAPHICLIB_CONSTEXPR14 constexpr
+#  else
+#    define GEOGRAPHICLIB_CONSTEXPR14
+#  endif
+#endif
+
 #if defined(_MSC_VER) && defined(GEOGRAPHICLIB_SHARED_LIB) && \
   GEOGRAPHICLIB_SHARED_LIB
 #  if GEOGRAPHICLIB_SHARED_LIB > 1
@@ -140,7 +166,7 @@ namespace GeographicLib {
      * @tparam T the type of the returned value.
      * @return the equatorial radius of WGS84 ellipsoid (6378137 m).
      **********************************************************************/
-    template<typename T> static inline T WGS84_a()
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline T WGS84_a()
     { return 6378137 * meter<T>(); }
     /**
      * A synonym for WGS84_a<real>().
@@ -150,7 +176,7 @@ namespace GeographicLib {
      * @tparam T the type of the returned value.
      * @return the flattening of WGS84 ellipsoid (1/298.257223563).
      **********************************************************************/
-    template<typename T> static inline T WGS84_f()
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline T WGS84_f()
     { return 1 / ( T(298257223563LL) / 1000000000 ); }
     /**
      * A synonym for WGS84_f<real>().
@@ -195,7 +221,7 @@ namespace GeographicLib {
      * @tparam T the type of the returned value.
      * @return the equatorial radius of GRS80 ellipsoid, \e a, in m.
      **********************************************************************/
-    template<typename T> static inline T GRS80_a()
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline T GRS80_a()
     { return 6378137 * meter<T>(); }
     /**
      * A synonym for GRS80_a<real>().
@@ -273,7 +299,8 @@ namespace GeographicLib {
      * This is unity, but this lets the internal system of units be changed if
      * necessary.
      **********************************************************************/
-    template<typename T> static inline T meter() { return T(1); }
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline T meter()
+    { return T(1); }
     /**
      * A synonym for meter<real>().
      **********************************************************************/
@@ -100,13 +100,16 @@ namespace GeographicLib {
         s.replace(p, pat.length(), 1, c);
       }
     }
-    static const std::string hemispheres_;
-    static const std::string signs_;
-    static const std::string digits_;
-    static const std::string dmsindicators_;
-    static const std::string components_[3];
+    static const char* const hemispheres_;
+    static const char* const signs_;
+    static const char* const digits_;
+    static const char* const dmsindicators_;
+    static const char* const components_[3];
     static Math::real NumMatch(const std::string& s);
     static Math::real InternalDecode(const std::string& dmsa, flag& ind);
+    static bool PlainDecode(const char* dms, size_t len, real& val);
+    // Enough for the result of Encode for angles in [-540d, 540d]
+    static const int maxencode_ = 48;
     DMS();                      // Disable constructor
 
   public:
@@ -198,6 +201,34 @@ namespace GeographicLib {
      **********************************************************************/
     static Math::real Decode(const std::string& dms, flag& ind);
 
+    /**
+     * Convert a character array in DMS to an angle.
+     *
+     * @param[in] dms the characters of the DMS string to convert.
+     * @param[in] len the number of characters.
+     * @param[out] ind a DMS::flag value signaling the presence of a
+     *   hemisphere indicator.
+     * @exception GeographicErr if \e dms is malformed (see below).
+     * @return angle (degrees).
+     *
+     * This is the same as DMS::Decode(const std::string&, flag&) except that
+     * the string need not be held in a std::string (it need not be null
+     * terminated).  A plain decimal number, e.g., -12.3456 (optionally
+     * surrounded by white space), with at most
+     * std::numeric_limits<real>::%digits10 significant digits is converted
+     * directly without allocating any memory or using the locale; the result
+     * is the correctly rounded value.  This is also the value returned by the
+     * general algorithm, so both versions of Decode use this fast path.
+     **********************************************************************/
+    static Math::real Decode(const char* dms, size_t len, flag& ind) {
+      real val;
+      if (PlainDecode(dms, len, val)) {
+        ind = NONE;
+        return val;
+      }
+      return Decode(std::string(dms, len), ind);
+    }
+
     /**
      * Convert DMS to an angle.
      *
@@ -354,6 +385,140 @@ namespace GeographicLib {
                ind, dmssep);
     }
 
+    /**
+     * Convert angle (in degrees) into a DMS string in a buffer.
+     *
+     * @param[out] buf the buffer for the result.
+     * @param[in] len the size of \e buf.
+     * @param[in] angle input angle (degrees)
+     * @param[in] trailing DMS::component value indicating the trailing units
+     *   of the string.
+     * @param[in] prec the number of digits after the decimal point for the
+     *   trailing component.
+     * @param[in] ind DMS::flag value indicated additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @return the length of the formatted string.
+     *
+     * The result is the same as DMS::Encode(real, component, unsigned, flag,
+     * char).  At most \e len &minus; 1 characters are written to \e buf
+     * followed by a null character (if \e len > 0); the result has been
+     * truncated if the return value is \e len or more.  No memory is
+     * allocated if \e angle lies in [&minus;540&deg;, 540&deg;].
+     **********************************************************************/
+    static int Encode(char buf[], size_t len, real angle, component trailing,
+                      unsigned prec, flag ind = NONE, char dmssep = char(0));
+
+    /**
+     * Convert angle into a DMS string in a buffer selecting the trailing
+     * component based on the precision.
+     *
+     * @param[out] buf the buffer for the result.
+     * @param[in] len the size of \e buf.
+     * @param[in] angle input angle (degrees)
+     * @param[in] prec the precision relative to 1 degree.
+     * @param[in] ind DMS::flag value indicated additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @return the length of the formatted string.
+     *
+     * The result is the same as DMS::Encode(real, unsigned, flag, char).
+     * \e buf and \e len are treated as in DMS::Encode(char[], size_t, real,
+     * component, unsigned, flag, char).
+     **********************************************************************/
+    static int Encode(char buf[], size_t len, real angle, unsigned prec,
+                      flag ind = NONE, char dmssep = char(0)) {
+      return ind == NUMBER ? Utility::str(buf, len, angle, int(prec)) :
+        Encode(buf, len, angle,
+               prec < 2 ? DEGREE : (prec < 4 ? MINUTE : SECOND),
+               prec < 2 ? prec : (prec < 4 ? prec - 2 : prec - 4),
+               ind, dmssep);
+    }
+
+    /**
+     * Convert many angles into DMS strings in a buffer.
+     *
+     * @param[in] angle array of input angles (degrees).
+     * @param[in] n the number of angles.
+     * @param[in] prec the precision relative to 1 degree.
+     * @param[in] ind DMS::flag value indicated additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @param[in] sep if non-null, a character to append to each string
+     *   (e.g., a newline).
+     * @param[out] buf the buffer for the results.
+     * @param[in] len the size of \e buf.
+     * @param[out] offsets if not null, an array of size at least \e n + 1
+     *   giving the starting positions of the strings in \e buf.
+     * @return the number \e k of angles converted.
+     *
+     * Each angle is formatted as by DMS::Encode(real, unsigned, flag, char)
+     * and the results (each followed by \e sep) are stored consecutively in
+     * \e buf; the results are not null terminated.  Conversion stops if the
+     * next result doesn't fit in \e buf; thus \e k < \e n indicates that
+     * the buffer is full (and that, after the contents of the buffer have
+     * been dealt with, the conversion should be resumed with angle + \e k).
+     * String \e i occupies the characters [<i>offsets</i>[<i>i</i>],
+     * <i>offsets</i>[<i>i</i>+1]) (including \e sep) of \e buf, and
+     * <i>offsets</i>[<i>k</i>] is the total number of characters used.  No
+     * memory is allocated.
+     **********************************************************************/
+    static size_t EncodeBatch(const real angle[], size_t n, unsigned prec,
+                              flag ind, char dmssep, char sep,
+                              char buf[], size_t len, size_t offsets[] = 0);
+
+    /**
+     * Convert many positions into strings in a buffer.
+     *
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] n the number of positions.
+     * @param[in] prec the precision relative to 1 degree.
+     * @param[in] dms if true, give the results as DMS with hemisphere
+     *   designators; otherwise give them as decimal numbers.
+     * @param[in] dmssep if non-null, use as the DMS separator character.
+     * @param[in] sep if non-null, a character to append to each string
+     *   (e.g., a newline).
+     * @param[out] buf the buffer for the results.
+     * @param[in] len the size of \e buf.
+     * @param[out] offsets if not null, an array of size at least \e n + 1
+     *   giving the starting positions of the strings in \e buf.
+     * @return the number \e k of positions converted.
+     *
+     * The string for each position consists of the latitude and the
+     * longitude formatted as by DMS::Encode(real, unsigned, flag, char) with
+     * \e ind = DMS::LATITUDE and DMS::LONGITUDE (if \e dms is true) or
+     * DMS::NUMBER (otherwise), separated by a space, e.g., "33.3 44.4" or
+     * "33d18'N 044d24'E".  The output arguments and the return value are as
+     * for DMS::EncodeBatch.
+     **********************************************************************/
+    static size_t EncodeLatLonBatch(const real lat[], const real lon[],
+                                    size_t n, unsigned prec, bool dms,
+                                    char dmssep, char sep,
+                                    char buf[], size_t len,
+                                    size_t offsets[] = 0);
+
+    /**
+     * Write many positions to a stream.
+     *
+     * @param[in,out] os the output stream.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] n the number of positions.
+     * @param[in] prec the precision relative to 1 degree.
+     * @param[in] dms if true, give the results as DMS with hemisphere
+     *   designators; otherwise give them as decimal numbers.
+     * @param[in] dmssep if non-null, use as the DMS separator character
+     *   (default null).
+     * @param[in] eol the character to end each line with (default newline).
+     * @exception GeographicErr if the data cannot be written.
+     *
+     * The positions are formatted as by DMS::EncodeLatLonBatch (one per line)
+     * into an internal buffer of 64 KiB which is written to \e os with
+     * std::ostream::write each time it fills up.
+     **********************************************************************/
+    static void WriteLatLonBatch(std::ostream& os,
+                                 const real lat[], const real lon[], size_t n,
+                                 unsigned prec, bool dms,
+                                 char dmssep = char(0), char eol = '\n');
+
     /**
      * Split angle into degrees and minutes
      *
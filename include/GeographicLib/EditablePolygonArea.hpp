@@ -0,0 +1,281 @@
+/**
+ * \file EditablePolygonArea.hpp
+ * \brief Header for GeographicLib::EditablePolygonAreaT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_EDITABLEPOLYGONAREA_HPP)
+#define GEOGRAPHICLIB_EDITABLEPOLYGONAREA_HPP 1
+
+#include <vector>
+#include <GeographicLib/PolygonArea.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Polygon areas with vertices which can be moved, inserted, and
+   *   removed
+   *
+   * This computes the same perimeter and area as PolygonAreaT; however the
+   * vertices of the polygon are held by the object and can be edited.
+   * Moving, inserting, or removing a vertex requires solving the inverse
+   * problem for the two edges (one in the case of removal) adjacent to the
+   * vertex; the other edges are not recomputed.  Each vertex is identified
+   * by an id (returned when it is added) which doesn't change as other
+   * vertices are added or removed; the ids of removed vertices are reused.
+   *
+   * The contributions of the edges to the perimeter, the area, and the
+   * number of crossings of the prime meridian are held in a segment tree
+   * (a binary tree whose nodes hold the sums for their children), so that
+   * an edit updates O(log \e N) nodes and the totals are available
+   * immediately; here \e N is the number of vertices.  The sums are
+   * accumulated with Accumulator objects.  Each node of the tree is
+   * recomputed from its children, so the results only depend on the
+   * current vertices (and not on the history of the edits); they agree
+   * with those of PolygonAreaT to within the round-off of the final sum.
+   *
+   * The edges are the ''shortest'' geodesics (or the lines given by the
+   * GeodType class) between successive vertices; the last vertex is
+   * connected to the first, unless the object was constructed with \e
+   * polyline = true.
+   *
+   * @tparam GeodType the geodesic class to use.
+   *
+   * Example of use:
+   * \include example-EditablePolygonArea.cpp
+   **********************************************************************/
+
+  template <class GeodType = Geodesic>
+  class EditablePolygonAreaT {
+  private:
+    typedef Math::real real;
+    // The id of no vertex
+    static const size_t nil_ = ~size_t(0);
+    PolygonAreaT<GeodType> _poly;
+    size_t _num, _first, _cap;
+    // The vertices and their neighbors indexed by id; _next[i] == nil_ for
+    // an unused id.
+    std::vector<real> _lat, _lon;
+    std::vector<size_t> _next, _prev, _free;
+    // The segment tree with the root at 1 and the leaves at _cap + i; leaf i
+    // holds the contributions for the edge from vertex i to _next[i].
+    std::vector< Accumulator<> > _perimeter, _area;
+    std::vector<int> _crossings;
+    void Check(size_t id) const;
+    size_t NewVertex(real lat, real lon);
+    void Link(size_t p, size_t v);
+    void SetLeaf(size_t i);
+    void Combine(size_t k);
+    void Update(size_t i);
+    void Rebuild();
+    void Reserve(size_t n);
+  public:
+
+    /**
+     * Constructor for EditablePolygonAreaT.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] polyline if true that treat the points as defining a polyline
+     *   instead of a polygon (default = false).
+     **********************************************************************/
+    EditablePolygonAreaT(const GeodType& earth, bool polyline = false)
+      : _poly(earth, polyline)
+    { Clear(); }
+
+    /**
+     * Remove all the vertices.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Add a vertex after the last vertex.
+     *
+     * @param[in] lat the latitude of the point (degrees).
+     * @param[in] lon the longitude of the point (degrees).
+     * @exception std::bad_alloc if the memory for the vertex can't be
+     *   allocated.
+     * @return the id of the new vertex.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;] and \e
+     * lon should be in the range [&minus;540&deg;, 540&deg;).
+     **********************************************************************/
+    size_t AddPoint(real lat, real lon);
+
+    /**
+     * Add several vertices after the last vertex.
+     *
+     * @param[in] lat the array of latitudes of the points (degrees).
+     * @param[in] lon the array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @exception std::bad_alloc if the memory for the vertices can't be
+     *   allocated.
+     * @return the id of the first new vertex; the ids of the others are
+     *   found with EditablePolygonAreaT::Next.
+     *
+     * This is equivalent to calling EditablePolygonAreaT::AddPoint for each
+     * point; however only \e n + 1 inverse problems are solved (instead of
+     * 2\e n) and the tree is rebuilt once.
+     **********************************************************************/
+    size_t AddPoints(const real lat[], const real lon[], size_t n);
+
+    /**
+     * Insert a vertex before an existing vertex.
+     *
+     * @param[in] id the id of the existing vertex.
+     * @param[in] lat the latitude of the new point (degrees).
+     * @param[in] lon the longitude of the new point (degrees).
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     * @exception std::bad_alloc if the memory for the vertex can't be
+     *   allocated.
+     * @return the id of the new vertex.
+     *
+     * The new vertex takes the place of vertex \e id in the sequence of
+     * vertices; in particular, if \e id is EditablePolygonAreaT::First(),
+     * the new vertex becomes the first vertex.  (Use
+     * EditablePolygonAreaT::AddPoint to add a vertex at the end.)
+     **********************************************************************/
+    size_t InsertPoint(size_t id, real lat, real lon);
+
+    /**
+     * Move a vertex.
+     *
+     * @param[in] id the id of the vertex.
+     * @param[in] lat the new latitude of the point (degrees).
+     * @param[in] lon the new longitude of the point (degrees).
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     **********************************************************************/
+    void MovePoint(size_t id, real lat, real lon);
+
+    /**
+     * Remove a vertex.
+     *
+     * @param[in] id the id of the vertex.
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     *
+     * Its neighbors are joined by a new edge and \e id may be returned by a
+     * later call to EditablePolygonAreaT::AddPoint or
+     * EditablePolygonAreaT::InsertPoint.
+     **********************************************************************/
+    void RemovePoint(size_t id);
+
+    /**
+     * Return the perimeter and area.
+     *
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the perimeter of the polygon or length of the
+     *   polyline (meters).
+     * @param[out] area the area of the polygon (meters<sup>2</sup>); only set
+     *   if \e polyline is false in the constructor.
+     * @return the number of points.
+     *
+     * No inverse problems are solved, so this is cheap.
+     **********************************************************************/
+    size_t Compute(bool reverse, bool sign, real& perimeter, real& area)
+      const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of vertices.
+     **********************************************************************/
+    size_t NumPoints() const { return _num; }
+
+    /**
+     * @return the id of the first vertex.  The result is undefined if there
+     *   are no vertices.
+     **********************************************************************/
+    size_t First() const { return _first; }
+
+    /**
+     * @param[in] id the id of a vertex.
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     * @return the id of the following vertex (the first vertex follows the
+     *   last).
+     **********************************************************************/
+    size_t Next(size_t id) const { Check(id); return _next[id]; }
+
+    /**
+     * @param[in] id the id of a vertex.
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     * @return the id of the preceding vertex (the last vertex precedes the
+     *   first).
+     **********************************************************************/
+    size_t Previous(size_t id) const { Check(id); return _prev[id]; }
+
+    /**
+     * Report the position of a vertex.
+     *
+     * @param[in] id the id of the vertex.
+     * @param[out] lat the latitude of the point (degrees).
+     * @param[out] lon the longitude of the point (degrees).
+     * @exception GeographicErr if \e id is not the id of a vertex.
+     *
+     * \e lon will be in the range [&minus;180&deg;, 180&deg;).
+     **********************************************************************/
+    void Point(size_t id, real& lat, real& lon) const
+    { Check(id); lat = _lat[id]; lon = _lon[id]; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _poly.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _poly.Flattening(); }
+    ///@}
+  };
+
+  /**
+   * @relates EditablePolygonAreaT
+   *
+   * Editable polygon areas using Geodesic.
+   **********************************************************************/
+  typedef EditablePolygonAreaT<Geodesic> EditablePolygonArea;
+
+  /**
+   * @relates EditablePolygonAreaT
+   *
+   * Editable polygon areas using GeodesicExact.
+   **********************************************************************/
+  typedef EditablePolygonAreaT<GeodesicExact> EditablePolygonAreaExact;
+
+  /**
+   * @relates EditablePolygonAreaT
+   *
+   * Editable polygon areas using Rhumb.
+   **********************************************************************/
+  typedef EditablePolygonAreaT<Rhumb> EditablePolygonAreaRhumb;
+
+  /**
+   * @relates EditablePolygonAreaT
+   *
+   * Approximate editable polygon areas using great circles on the authalic
+   * sphere.
+   **********************************************************************/
+  typedef EditablePolygonAreaT<AuthalicSphere> EditablePolygonAreaAuthalic;
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_EDITABLEPOLYGONAREA_HPP
@@ -40,11 +40,32 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     static const int numit_ = 10;
+    // The number of latitudes processed together by the array versions of
+    // the latitude conversions.
+    static const int nblock_ = 16;
+    // The number of auxiliary latitudes and the order of the series used by
+    // Ellipsoid::ConvertLatitude.
+    static const int naux_ = 6;
+    static const int auxorder_ = 6;
     real stol_;
     real _a, _f, _f1, _f12, _e2, _es, _e12, _n, _b;
     TransverseMercator _tm;
     EllipticFunction _ell;
     AlbersEqualArea _au;
+    // Whether the series are used and their coefficients; the coefficients
+    // for converting auxiliary latitude i to j start at
+    // _auxc[(naux_ * j + i) * auxorder_].
+    bool _auxseries;
+    real _auxc[naux_ * naux_ * auxorder_];
+
+    // Exact conversions between the auxiliary latitudes and the geographic
+    // latitude.
+    real ToGeographic(int auxin, real eta) const;
+    real FromGeographic(int auxout, real phi) const;
+    void ToGeographic(int auxin, const real eta[], size_t n, real phi[])
+      const;
+    void FromGeographic(int auxout, const real phi[], size_t n, real zeta[])
+      const;
 
     // These are the alpha and beta coefficients in the Krueger series from
     // TransverseMercator.  Thy are used by RhumbSolve to compute
@@ -53,6 +74,44 @@ namespace GeographicLib {
     const Math::real* RectifyingToConformalCoeffs() const { return _tm._bet; }
     friend class Rhumb; friend class RhumbLine;
   public:
+
+    /**
+     * The auxiliary latitudes which can be converted with
+     * Ellipsoid::ConvertLatitude.
+     **********************************************************************/
+    enum auxlatitude {
+      /**
+       * The geographic latitude &phi;.
+       * @hideinitializer
+       **********************************************************************/
+      GEOGRAPHIC = 0,
+      /**
+       * The parametric latitude &beta;.
+       * @hideinitializer
+       **********************************************************************/
+      PARAMETRIC = 1,
+      /**
+       * The geocentric latitude &theta;.
+       * @hideinitializer
+       **********************************************************************/
+      GEOCENTRIC = 2,
+      /**
+       * The rectifying latitude &mu;.
+       * @hideinitializer
+       **********************************************************************/
+      RECTIFYING = 3,
+      /**
+       * The conformal latitude &chi;.
+       * @hideinitializer
+       **********************************************************************/
+      CONFORMAL = 4,
+      /**
+       * The authalic latitude &xi;.
+       * @hideinitializer
+       **********************************************************************/
+      AUTHALIC = 5
+    };
+
     /** \name Constructor
      **********************************************************************/
     ///@{
@@ -184,7 +243,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &beta; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real ParametricLatitude(real phi) const;
+    Math::real ParametricLatitude(real phi) const
+    { return Math::atand(_f1 * Math::tand(phi)); }
 
     /**
      * @param[in] beta the parametric latitude (degrees).
@@ -194,7 +254,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &phi; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real InverseParametricLatitude(real beta) const;
+    Math::real InverseParametricLatitude(real beta) const
+    { return Math::atand(Math::tand(beta) / _f1); }
 
     /**
      * @param[in] phi the geographic latitude (degrees).
@@ -208,7 +269,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &theta; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real GeocentricLatitude(real phi) const;
+    Math::real GeocentricLatitude(real phi) const
+    { return Math::atand(_f12 * Math::tand(phi)); }
 
     /**
      * @param[in] theta the geocentric latitude (degrees).
@@ -218,7 +280,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &phi; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real InverseGeocentricLatitude(real theta) const;
+    Math::real InverseGeocentricLatitude(real theta) const
+    { return Math::atand(Math::tand(theta) / _f12); }
 
     /**
      * @param[in] phi the geographic latitude (degrees).
@@ -285,7 +348,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &chi; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real ConformalLatitude(real phi) const;
+    Math::real ConformalLatitude(real phi) const
+    { return Math::atand(Math::taupf(Math::tand(phi), _es)); }
 
     /**
      * @param[in] chi the conformal latitude (degrees).
@@ -295,7 +359,8 @@ namespace GeographicLib {
      * result is undefined if this condition does not hold.  The returned value
      * &phi; lies in [&minus;90&deg;, 90&deg;].
      **********************************************************************/
-    Math::real InverseConformalLatitude(real chi) const;
+    Math::real InverseConformalLatitude(real chi) const
+    { return Math::atand(Math::tauf(Math::tand(chi), _es)); }
 
     /**
      * @param[in] phi the geographic latitude (degrees).
@@ -312,7 +377,9 @@ namespace GeographicLib {
      * = &plusmn;90&deg; is some (positive or negative) large but finite value,
      * such that InverseIsometricLatitude returns the original value of &phi;.
      **********************************************************************/
-    Math::real IsometricLatitude(real phi) const;
+    Math::real IsometricLatitude(real phi) const {
+      return Math::asinh(Math::taupf(Math::tand(phi), _es)) / Math::degree();
+    }
 
     /**
      * @param[in] psi the isometric latitude (degrees).
@@ -321,7 +388,171 @@ namespace GeographicLib {
      * The returned value &phi; lies in [&minus;90&deg;, 90&deg;].  For a
      * sphere &phi; = tan<sup>&minus;1</sup> sinh &psi;.
      **********************************************************************/
-    Math::real InverseIsometricLatitude(real psi) const;
+    Math::real InverseIsometricLatitude(real psi) const {
+      using std::sinh;
+      return Math::atand(Math::tauf(sinh(psi * Math::degree()), _es));
+    }
+    ///@}
+
+    /** \name Latitude conversion for arrays.
+     **********************************************************************/
+    ///@{
+    /**
+     * The rectifying latitudes for an array of latitudes.
+     *
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] mu array of rectifying latitudes (degrees).
+     *
+     * The meridian distances are evaluated with the array version of
+     * EllipticFunction::Ed.  The results are identical to calling
+     * Ellipsoid::RectifyingLatitude(real) for each element.  \e phi and \e
+     * mu may be the same array; this also applies to the other array
+     * versions of the latitude conversions.
+     **********************************************************************/
+    void RectifyingLatitude(const real phi[], size_t n, real mu[]) const;
+
+    /**
+     * The geographic latitudes for an array of rectifying latitudes.
+     *
+     * @param[in] mu array of rectifying latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] phi array of geographic latitudes (degrees).
+     *
+     * The results are identical to calling
+     * Ellipsoid::InverseRectifyingLatitude(real) for each element.
+     **********************************************************************/
+    void InverseRectifyingLatitude(const real mu[], size_t n, real phi[])
+      const;
+
+    /**
+     * The authalic latitudes for an array of latitudes.
+     *
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] xi array of authalic latitudes (degrees).
+     *
+     * The results are identical to calling Ellipsoid::AuthalicLatitude(real)
+     * for each element.
+     **********************************************************************/
+    void AuthalicLatitude(const real phi[], size_t n, real xi[]) const;
+
+    /**
+     * The geographic latitudes for an array of authalic latitudes.
+     *
+     * @param[in] xi array of authalic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] phi array of geographic latitudes (degrees).
+     *
+     * The results are identical to calling
+     * Ellipsoid::InverseAuthalicLatitude(real) for each element.
+     **********************************************************************/
+    void InverseAuthalicLatitude(const real xi[], size_t n, real phi[]) const;
+
+    /**
+     * The conformal latitudes for an array of latitudes.
+     *
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] chi array of conformal latitudes (degrees).
+     *
+     * This uses the array version of Math::taupf.  The results are identical
+     * to calling Ellipsoid::ConformalLatitude(real) for each element.
+     **********************************************************************/
+    void ConformalLatitude(const real phi[], size_t n, real chi[]) const;
+
+    /**
+     * The geographic latitudes for an array of conformal latitudes.
+     *
+     * @param[in] chi array of conformal latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] phi array of geographic latitudes (degrees).
+     *
+     * This uses the array version of Math::tauf, which carries out the
+     * Newton iterations for a block of latitudes together.  The results are
+     * identical to calling Ellipsoid::InverseConformalLatitude(real) for each
+     * element.
+     **********************************************************************/
+    void InverseConformalLatitude(const real chi[], size_t n, real phi[])
+      const;
+
+    /**
+     * The isometric latitudes for an array of latitudes.
+     *
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] psi array of isometric latitudes (degrees).
+     *
+     * This uses the array version of Math::taupf.  The results are identical
+     * to calling Ellipsoid::IsometricLatitude(real) for each element.
+     **********************************************************************/
+    void IsometricLatitude(const real phi[], size_t n, real psi[]) const;
+
+    /**
+     * The geographic latitudes for an array of isometric latitudes.
+     *
+     * @param[in] psi array of isometric latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] phi array of geographic latitudes (degrees).
+     *
+     * This uses the array version of Math::tauf.  The results are identical
+     * to calling Ellipsoid::InverseIsometricLatitude(real) for each element.
+     **********************************************************************/
+    void InverseIsometricLatitude(const real psi[], size_t n, real phi[])
+      const;
+    ///@}
+
+    /** \name Conversions between any two auxiliary latitudes.
+     **********************************************************************/
+    ///@{
+    /**
+     * Convert one auxiliary latitude to another.
+     *
+     * @param[in] auxin the type of the given latitude (one of the
+     *   Ellipsoid::auxlatitude values).
+     * @param[in] auxout the type of the returned latitude.
+     * @param[in] eta the given latitude (degrees).
+     * @return &zeta; the converted latitude (degrees).
+     *
+     * If |\e n| &le; 0.003 (which includes all terrestrial ellipsoids), the
+     * conversion is carried out with the series
+     * &zeta; = &eta; + &sum;<sub><i>k</i>=1</sub><sup>6</sup>
+     * <i>c</i><sub><i>k</i></sub> sin 2<i>k</i>&eta;
+     * given in \ref auxlat, where the coefficients <i>c</i><sub><i>k</i></sub>
+     * are computed in the constructor and the sum is evaluated by Clenshaw
+     * summation.  This costs little more than a single trigonometric
+     * function and the result agrees with the exact conversion to within
+     * 10<sup>&minus;13</sup>&deg;.  Otherwise
+     * the result is found by converting \e eta to the geographic latitude
+     * and then to \e auxout using the exact functions above.
+     *
+     * \e eta must lie in the range [&minus;90&deg;, 90&deg;]; the result is
+     * undefined if this condition does not hold.  The returned value lies in
+     * [&minus;90&deg;, 90&deg;] and &plusmn;90&deg; are converted exactly.
+     **********************************************************************/
+    Math::real ConvertLatitude(auxlatitude auxin, auxlatitude auxout,
+                               real eta) const;
+
+    /**
+     * Convert an array of auxiliary latitudes.
+     *
+     * @param[in] auxin the type of the given latitudes.
+     * @param[in] auxout the type of the returned latitudes.
+     * @param[in] eta array of the given latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] zeta array of the converted latitudes (degrees).
+     *
+     * The results are identical to calling Ellipsoid::ConvertLatitude(enum
+     * auxlatitude, enum auxlatitude, real) for each element.  \e eta and \e
+     * zeta may be the same array.
+     **********************************************************************/
+    void ConvertLatitude(auxlatitude auxin, auxlatitude auxout,
+                         const real eta[], size_t n, real zeta[]) const;
+
+    /**
+     * @return whether Ellipsoid::ConvertLatitude uses the series.
+     **********************************************************************/
+    bool SeriesLatitudeConversion() const { return _auxseries; }
     ///@}
 
     /** \name Other quantities.
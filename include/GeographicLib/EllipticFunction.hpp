@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_ELLIPTICFUNCTION_HPP)
 #define GEOGRAPHICLIB_ELLIPTICFUNCTION_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 
 namespace GeographicLib {
@@ -47,12 +48,20 @@ namespace GeographicLib {
    *   complex elliptic integrals</a>, Numerical Algorithms 10, 13--26 (1995)
    * .
    * with the additional optimizations given in http://dlmf.nist.gov/19.36.i.
-   * The computation of the Jacobi elliptic functions uses the algorithm given
-   * in
+   * The complete integrals, which are computed by EllipticFunction::Reset,
+   * use instead Bulirsch's algorithm for the general complete integral
+   * (algorithm cel in the second reference below); this converges
+   * quadratically and gives \e K, \e E, and \e D in one pass and &Pi;, \e
+   * G, and \e H in a second.  The computation of the Jacobi elliptic
+   * functions uses the algorithm given in
    * - R. Bulirsch,
    *   <a href="https://dx.doi.org/10.1007/BF01397975"> Numerical Calculation of
    *   Elliptic Integrals and Elliptic Functions</a>, Numericshe Mathematik 7,
    *   78--90 (1965).
+   * - R. Bulirsch,
+   *   <a href="https://dx.doi.org/10.1007/BF02165405"> Numerical Calculation of
+   *   Elliptic Integrals and Elliptic Functions. III</a>, Numerische
+   *   Mathematik 13, 305--315 (1969).
    * .
    * The notation follows http://dlmf.nist.gov/19 and http://dlmf.nist.gov/22
    *
@@ -65,6 +74,30 @@ namespace GeographicLib {
     enum { num_ = 13 }; // Max depth required for sncndn.  Probably 5 is enough.
     real _k2, _kp2, _alpha2, _alphap2, _eps;
     real _Kc, _Ec, _Dc, _Pic, _Gc, _Hc;
+    // The AGM sequence for sncndn saved by PrecomputeJacobi (_Jl = 0 if it
+    // hasn't been saved).
+    unsigned _Jl;
+    real _Jc, _Jd, _Jm[num_], _Jn[num_];
+    // The Fourier coefficients saved by PrecomputeSeries (_Sn = 0 if they
+    // haven't been saved).  _S[i * _Sn + j - 1] is the coefficient of
+    // sin(2 j phi) for function i = nF_, nE_, nD_, nH_, nPi_, nEinv_.  The
+    // series for deltaPi is only used if alpha^2 < 1.
+    enum { nF_ = 0, nE_ = 1, nD_ = 2, nH_ = 3, nPi_ = 4, nEinv_ = 5,
+           nseries_ = 6 };
+    // Max number of samples used by PrecomputeSeries.
+    enum { maxsamples_ = 256 };
+    int _Sn;
+    std::vector<real> _S;
+    unsigned JacobiAGM(real m[], real n[], real& c, real& d) const;
+    // Bulirsch's cel(kc, p, a[i], b[i]) for i in [0, n), n <= 3.
+    static void Complete(real kc, real p, const real a[], const real b[],
+                         int n, real c[]);
+    void Jacobi(real x, unsigned l, const real m[], const real n[],
+                real c, real d, real& sn, real& cn, real& dn) const;
+    // Sum sum(c[j - 1] * sin(2 j phi), j, 1, n)
+    static real SinSeries(real sn, real cn, const real c[], int n);
+    real Periodic(int i, real sn, real cn) const
+    { return SinSeries(sn, cn, &_S[i * _Sn], _Sn); }
   public:
     /** \name Constructor
      **********************************************************************/
@@ -311,6 +344,22 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real Ed(real ang) const;
 
+    /**
+     * The incomplete integral of the second kind with the arguments given in
+     * degrees for an array of arguments.
+     *
+     * @param[in] ang array of angles in <i>degrees</i>.
+     * @param[in] n the size of the array.
+     * @param[out] e array of values \e E(&pi; <i>ang</i>[\e i]/180, \e k).
+     *
+     * The Carlson integrals are evaluated with their array versions (or,
+     * if EllipticFunction::PrecomputeSeries has been called, the Fourier
+     * series are summed).  The results are identical to calling
+     * EllipticFunction::Ed(real) \e n times.  \e ang and \e e may be the
+     * same array.
+     **********************************************************************/
+    void Ed(const real ang[], size_t n, real e[]) const;
+
     /**
      * The inverse of the incomplete integral of the second kind.
      *
@@ -581,6 +630,74 @@ namespace GeographicLib {
      **********************************************************************/
     void sncndn(real x, real& sn, real& cn, real& dn) const;
 
+    /**
+     * The Jacobi elliptic functions for an array of arguments.
+     *
+     * @param[in] x the array of arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] sn array of sn(\e x[\e i], \e k).
+     * @param[out] cn array of cn(\e x[\e i], \e k).
+     * @param[out] dn array of dn(\e x[\e i], \e k).
+     *
+     * The arithmetic-geometric mean sequence for the modulus is computed once
+     * (if it hasn't been saved with EllipticFunction::PrecomputeJacobi).  The
+     * results are identical to calling EllipticFunction::sncndn \e n times.
+     **********************************************************************/
+    void sncndn(const real x[], size_t n,
+                real sn[], real cn[], real dn[]) const;
+
+    /**
+     * Save the quantities depending on the modulus needed by
+     * EllipticFunction::sncndn.
+     *
+     * EllipticFunction::sncndn starts by computing an arithmetic-geometric
+     * mean sequence for the modulus (typically 4 or 5 terms; each term needs
+     * a square root).  If sncndn will be called many times with the same
+     * modulus, call this function once after constructing the object (or
+     * after EllipticFunction::Reset) to save the sequence; this makes
+     * subsequent calls to sncndn about 30% faster.  The results of sncndn
+     * are unchanged.  (This is not done automatically because the objects
+     * are frequently reset, e.g., by GeodesicExact, without sncndn being
+     * called.)
+     **********************************************************************/
+    void PrecomputeJacobi();
+
+    /**
+     * Save Fourier series for the periodic incomplete integrals.
+     *
+     * @return true if the series have been saved.
+     *
+     * For a fixed modulus, the periodic functions &delta;\e F, &delta;\e E,
+     * &delta;\e D, &delta;\e H, &delta;&Pi; (if &alpha;<sup>2</sup> < 1),
+     * and &delta;<i>E</i><sup>&minus;1</sup> are smooth odd functions with
+     * period &pi; and so are represented by Fourier sine series in 2&phi;.
+     * This function finds the coefficients of these series by sampling the
+     * functions at equally spaced points with successively doubled
+     * resolution until the coefficients converge to full accuracy.
+     * Subsequently, these functions (and the functions which are defined in
+     * terms of them, EllipticFunction::F(real), EllipticFunction::E(real),
+     * EllipticFunction::Ed, EllipticFunction::Einv, EllipticFunction::D(real),
+     * EllipticFunction::H(real), and EllipticFunction::Pi(real)) sum the
+     * series with Clenshaw summation instead of evaluating the Carlson
+     * integrals (and, for the inverse, Newton's method).  This is 5 to 10
+     * times faster (the biggest gain is for EllipticFunction::deltaEinv);
+     * the results differ from the direct evaluation by a few ulps.
+     *
+     * The number of terms needed grows as |<i>k</i><sup>2</sup>| increases.
+     * For the moduli encountered with geodesics on ellipsoids of revolution
+     * with |\e f| &le; 1/50, fewer than 10 terms suffice (and finding them
+     * costs as much as 30 to 100 evaluations of
+     * EllipticFunction::deltaEinv).  If
+     * the series do not converge with 128 terms (e.g., if
+     * <i>k</i><sup>2</sup> is close to 1, as for the second modulus of
+     * TransverseMercatorExact), nothing is saved and false is returned.
+     * The series are discarded by EllipticFunction::Reset.  (This is not done
+     * automatically because it only pays if the functions are evaluated
+     * many times with the same modulus, e.g., to compute many points on a
+     * GeodesicLineExact.)
+     **********************************************************************/
+    bool PrecomputeSeries();
+
     /**
      * The &Delta; amplitude function.
      *
@@ -701,6 +818,95 @@ namespace GeographicLib {
     static real RD(real x, real y, real z);
     ///@}
 
+    /** \name Symmetric elliptic integrals for arrays of arguments.
+     **********************************************************************/
+    ///@{
+    /**
+     * <i>R</i><sub><i>F</i></sub> for arrays of arguments.
+     *
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] rf array of values <i>R</i><sub><i>F</i></sub>(\e x[\e i],
+     *   \e y[\e i], \e z[\e i]), for 0 &le; \e i &lt; \e n.
+     *
+     * The duplication steps are applied to blocks of 8 integrals together
+     * (so that the inner loops can be vectorized by the compiler), with the
+     * convergence test applied to each integral separately.  The results are
+     * identical to calling EllipticFunction::RF(real, real, real) \e n times.
+     **********************************************************************/
+    static void RF(const real x[], const real y[], const real z[],
+                   size_t n, real rf[]);
+
+    /**
+     * <i>R</i><sub><i>C</i></sub> for arrays of arguments.
+     *
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] rc array of values <i>R</i><sub><i>C</i></sub>(\e x[\e i],
+     *   \e y[\e i]).
+     *
+     * The results are identical to calling EllipticFunction::RC(real, real)
+     * \e n times.
+     **********************************************************************/
+    static void RC(const real x[], const real y[], size_t n, real rc[]);
+
+    /**
+     * <i>R</i><sub><i>G</i></sub> for arrays of arguments.
+     *
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] rg array of values <i>R</i><sub><i>G</i></sub>(\e x[\e i],
+     *   \e y[\e i], \e z[\e i]).
+     *
+     * This is computed in terms of the array versions of
+     * <i>R</i><sub><i>F</i></sub> and <i>R</i><sub><i>D</i></sub>.  The
+     * results are identical to calling EllipticFunction::RG(real, real, real)
+     * \e n times.
+     **********************************************************************/
+    static void RG(const real x[], const real y[], const real z[],
+                   size_t n, real rg[]);
+
+    /**
+     * <i>R</i><sub><i>J</i></sub> for arrays of arguments.
+     *
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[in] p array of fourth arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] rj array of values <i>R</i><sub><i>J</i></sub>(\e x[\e i],
+     *   \e y[\e i], \e z[\e i], \e p[\e i]).
+     *
+     * The results are identical to calling EllipticFunction::RJ(real, real,
+     * real, real) \e n times.
+     **********************************************************************/
+    static void RJ(const real x[], const real y[], const real z[],
+                   const real p[], size_t n, real rj[]);
+
+    /**
+     * <i>R</i><sub><i>D</i></sub> for arrays of arguments.
+     *
+     * @param[in] x array of first arguments.
+     * @param[in] y array of second arguments.
+     * @param[in] z array of third arguments.
+     * @param[in] n the size of the arrays.
+     * @param[out] rd array of values <i>R</i><sub><i>D</i></sub>(\e x[\e i],
+     *   \e y[\e i], \e z[\e i]).
+     *
+     * The duplication steps are applied to blocks of 8 integrals together,
+     * as for the array version of <i>R</i><sub><i>F</i></sub>.  The results
+     * are identical to calling EllipticFunction::RD(real, real, real) \e n
+     * times.
+     **********************************************************************/
+    static void RD(const real x[], const real y[], const real z[],
+                   size_t n, real rd[]);
+    ///@}
+
   };
 
 } // namespace GeographicLib
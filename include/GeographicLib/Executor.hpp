@@ -0,0 +1,340 @@
+/**
+ * \file Executor.hpp
+ * \brief Header for GeographicLib::Executor class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_EXECUTOR_HPP)
+#define GEOGRAPHICLIB_EXECUTOR_HPP 1
+
+#include <cstddef>
+#include <algorithm>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_OPENMP)
+#  include <omp.h>
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    include <exception>
+#  endif
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief The interface to the executor which runs parallel loops
+   *
+   * The functions in GeographicLib which take an \e nthreads argument (e.g.,
+   * Geodesic::GenInverseBatch, GeodesicPolygon::ContainsBatch,
+   * SphericalEngine::Circle, TransverseMercator::Forward) divide their work
+   * into \e nthreads contiguous chunks.  Instead of starting their own
+   * threads, they hand the chunks to the current executor,
+   * Executor::Default(), which decides how many threads actually run them.
+   * An application which manages its own threads can install an executor
+   * which submits the chunks to its own pool with Executor::SetDefault, so
+   * that the library doesn't create threads which compete with those of the
+   * application.  The results of these functions don't depend on the
+   * executor or on \e nthreads.
+   *
+   * The library provides three executors:
+   * - SerialExecutor runs all the chunks in the calling thread;
+   * - ThreadPoolExecutor, the built-in default, maintains a pool of worker
+   *   threads; the calling thread takes part in running the chunks and
+   *   nested parallel loops can't deadlock;
+   * - OpenMPExecutor runs the chunks in an OpenMP parallel loop; this is
+   *   defined only if the code including this header is compiled with
+   *   OpenMP.
+   *
+   * Other threading libraries are easily accommodated.  For example, an
+   * executor using Intel's Threading Building Blocks is
+   * \code
+   class TBBExecutor : public GeographicLib::Executor {
+   public:
+     void ParallelFor(size_t n, size_t nchunks, const Range& body) {
+       size_t per = ChunkSize(n, nchunks), nc = Chunks(n, nchunks);
+       tbb::parallel_for(size_t(0), nc, [&](size_t k) {
+           body(k * per, std::min(n, (k + 1) * per));
+         });
+     }
+     int Concurrency() const
+     { return tbb::this_task_arena::max_concurrency(); }
+   };
+   \endcode
+   * and a C++17 executor uses std::for_each with the std::execution::par
+   * policy in the same way over a vector of the chunk indices.  Install it
+   * with
+   * \code
+   static TBBExecutor tbbexec;
+   GeographicLib::Executor::SetDefault(&tbbexec);
+   \endcode
+   *
+   * The functions of an executor may be called from several threads at
+   * once, including from within the body of a parallel loop.  If the body
+   * throws an exception for one of the chunks, ParallelFor should rethrow it
+   * in the calling thread (once all the chunks have finished).
+   *
+   * Example of use:
+   * \include example-Executor.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Executor {
+  public:
+    /**
+     * The body of a parallel loop.
+     **********************************************************************/
+    class Range {
+    public:
+      /**
+       * Do the work for the indices [\e i0, \e i1).
+       *
+       * @param[in] i0 the first index.
+       * @param[in] i1 one past the last index.
+       **********************************************************************/
+      virtual void operator()(size_t i0, size_t i1) const = 0;
+      virtual ~Range() {}
+    };
+
+    /**
+     * The destructor.
+     **********************************************************************/
+    virtual ~Executor() {}
+
+    /**
+     * Run a parallel loop.
+     *
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks into which the indices are
+     *   divided.
+     * @param[in] body the work to be done.
+     *
+     * The indices [0, \e n) are divided into Chunks(\e n, \e nchunks)
+     * contiguous chunks, each of ChunkSize(\e n, \e nchunks) indices (except
+     * possibly for the last); \e body is called once for each chunk and the
+     * chunks may be run concurrently.  This returns when all the chunks have
+     * been run.
+     **********************************************************************/
+    virtual void ParallelFor(size_t n, size_t nchunks, const Range& body) = 0;
+
+    /**
+     * @return the maximum number of chunks which are run concurrently
+     *   (default 1).
+     **********************************************************************/
+    virtual int Concurrency() const { return 1; }
+
+    /**
+     * @return the current executor.  Initially this is a ThreadPoolExecutor
+     *   with one worker fewer than the number of hardware threads (or a
+     *   SerialExecutor if the library was compiled without C++11 support).
+     *
+     * The built-in ThreadPoolExecutor is created on the first call (this is
+     * safe if several threads make the first call together) and is never
+     * destroyed; its idle workers end with the process.  An application
+     * which unloads the library before exiting (e.g., a Windows DLL which is
+     * freed) should install its own executor with Executor::SetDefault
+     * before the built-in one is created.
+     **********************************************************************/
+    static Executor& Default();
+
+    /**
+     * Change the current executor.
+     *
+     * @param[in] executor a pointer to the new executor; if this is null, the
+     *   built-in default is restored.
+     *
+     * The executor is not copied and must outlive its use by the library.
+     * This should be called before the executor is used by other threads.
+     **********************************************************************/
+    static void SetDefault(Executor* executor);
+
+    /**
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks requested.
+     * @return the number of indices in each chunk.
+     **********************************************************************/
+    static size_t ChunkSize(size_t n, size_t nchunks) {
+      size_t nc = (std::min)(n, (std::max)(nchunks, size_t(1)));
+      return nc ? (n + nc - 1) / nc : 0;
+    }
+
+    /**
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks requested.
+     * @return the number of non-empty chunks.
+     **********************************************************************/
+    static size_t Chunks(size_t n, size_t nchunks) {
+      size_t per = ChunkSize(n, nchunks);
+      return per ? (n + per - 1) / per : 0;
+    }
+
+    /**
+     * Run a parallel loop with the current executor.
+     *
+     * @tparam F the type of the body; this must be callable as \e f(\e i0,
+     *   \e i1).
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks into which the indices are
+     *   divided.
+     * @param[in] f the work to be done.
+     *
+     * If there's only one chunk, \e f is called in the calling thread without
+     * involving the executor.
+     **********************************************************************/
+    template<class F>
+    static void For(size_t n, size_t nchunks, const F& f) {
+      if (Chunks(n, nchunks) <= 1) {
+        if (n) f(size_t(0), n);
+      } else
+        Default().ParallelFor(n, nchunks, RangeFunction<F>(f));
+    }
+
+  private:
+    template<class F> class RangeFunction : public Range {
+    private:
+      const F& _f;
+      RangeFunction& operator=(const RangeFunction&);
+    public:
+      explicit RangeFunction(const F& f) : _f(f) {}
+      void operator()(size_t i0, size_t i1) const { _f(i0, i1); }
+    };
+  };
+
+  /**
+   * \brief An executor which runs all the chunks in the calling thread
+   *
+   * Install this with Executor::SetDefault to stop the library from running
+   * any work in other threads.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT SerialExecutor : public Executor {
+  public:
+    /**
+     * Run all the chunks, in order, in the calling thread.
+     *
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks into which the indices are
+     *   divided.
+     * @param[in] body the work to be done.
+     **********************************************************************/
+    void ParallelFor(size_t n, size_t nchunks, const Range& body) {
+      size_t per = ChunkSize(n, nchunks);
+      for (size_t i0 = 0; i0 < n; i0 += per)
+        body(i0, (std::min)(n, i0 + per));
+    }
+  };
+
+  /**
+   * \brief An executor with a pool of worker threads
+   *
+   * The worker threads are started by the constructor and wait for work.
+   * ParallelFor posts its chunks to the pool and the calling thread runs
+   * chunks too, until none are left to be claimed; it then waits for any
+   * chunks still being run by the workers.  Because a thread waiting for its
+   * loop to finish only waits on chunks which are already running, a chunk
+   * may itself call ParallelFor without any risk of deadlock.  The first
+   * exception thrown by a chunk is rethrown by ParallelFor in the calling
+   * thread.
+   *
+   * If the library was compiled without C++11 support, there are no worker
+   * threads and this is equivalent to a SerialExecutor.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT ThreadPoolExecutor : public Executor {
+  private:
+    class Impl;
+    Impl* _impl;
+    // copy constructor not allowed
+    ThreadPoolExecutor(const ThreadPoolExecutor&);
+    // nor copy assignment
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&);
+  public:
+    /**
+     * Constructor for ThreadPoolExecutor.
+     *
+     * @param[in] nworkers the number of worker threads; if this is negative
+     *   (the default), one fewer than the number of hardware threads is used.
+     * @exception std::bad_alloc if the memory for the pool can't be
+     *   allocated.
+     *
+     * If a worker thread can't be started, the pool has fewer workers.
+     **********************************************************************/
+    explicit ThreadPoolExecutor(int nworkers = -1);
+
+    /**
+     * The destructor waits for the worker threads to finish.  It must not be
+     * called while a ParallelFor is in progress.
+     **********************************************************************/
+    ~ThreadPoolExecutor();
+
+    /**
+     * Run a parallel loop with the worker threads.
+     *
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks into which the indices are
+     *   divided.
+     * @param[in] body the work to be done.
+     **********************************************************************/
+    void ParallelFor(size_t n, size_t nchunks, const Range& body);
+
+    /**
+     * @return the number of worker threads plus 1 (for the calling thread).
+     **********************************************************************/
+    int Concurrency() const;
+  };
+
+#if defined(_OPENMP) || defined(DOXYGEN)
+  /**
+   * \brief An executor using OpenMP
+   *
+   * The chunks are run by a parallel loop with dynamic scheduling in the
+   * OpenMP thread team.  This is defined only if the code including
+   * Executor.hpp is compiled with OpenMP; the library itself needn't be.
+   **********************************************************************/
+  class OpenMPExecutor : public Executor {
+  public:
+    /**
+     * Run the chunks in an OpenMP parallel loop.
+     *
+     * @param[in] n the number of indices.
+     * @param[in] nchunks the number of chunks into which the indices are
+     *   divided.
+     * @param[in] body the work to be done.
+     *
+     * An exception mustn't escape from an OpenMP parallel region; so the
+     * first exception thrown by a chunk is caught and rethrown once the loop
+     * has finished (this requires C++11; otherwise the exception terminates
+     * the program).
+     **********************************************************************/
+    void ParallelFor(size_t n, size_t nchunks, const Range& body) {
+      long
+        per = long(ChunkSize(n, nchunks)),
+        nc = long(Chunks(n, nchunks)),
+        nn = long(n);
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+      std::exception_ptr err;
+#    pragma omp parallel for schedule(dynamic)
+      for (long k = 0; k < nc; ++k) {
+        try {
+          body(size_t(k * per), size_t((std::min)(nn, (k + 1) * per)));
+        }
+        catch (...) {
+#    pragma omp critical(GeographicLib_OpenMPExecutor)
+          if (!err) err = std::current_exception();
+        }
+      }
+      if (err) std::rethrow_exception(err);
+#  else
+#    pragma omp parallel for schedule(dynamic)
+      for (long k = 0; k < nc; ++k)
+        body(size_t(k * per), size_t((std::min)(nn, (k + 1) * per)));
+#  endif
+    }
+
+    /**
+     * @return the maximum number of OpenMP threads.
+     **********************************************************************/
+    int Concurrency() const { return omp_get_max_threads(); }
+  };
+#endif
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_EXECUTOR_HPP
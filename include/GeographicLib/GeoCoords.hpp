@@ -29,8 +29,11 @@ namespace GeographicLib {
    * and longitude were given then the UTM/UPS coordinates follows the standard
    * conventions.
    *
-   * The mutable state consists of the UTM or UPS coordinates for a alternate
-   * zone.  A method SetAltZone is provided to set the alternate UPS/UTM zone.
+   * In addition, the UTM or UPS coordinates for a alternate zone are held.
+   * A method SetAltZone is provided to set the alternate UPS/UTM zone;
+   * GeoCoords::WithAltZone returns a copy with a different alternate zone.
+   * None of the const member functions modify the object, so a const
+   * GeoCoords may be shared between threads.
    *
    * Methods are provided to return the geographic coordinates, the input UTM
    * or UPS coordinates (and associated meridian convergence and scale), or
@@ -52,10 +55,10 @@ namespace GeographicLib {
     real _lat, _long, _easting, _northing, _gamma, _k;
     bool _northp;
     int _zone;                  // See UTMUPS::zonespec
-    mutable real _alt_easting, _alt_northing, _alt_gamma, _alt_k;
-    mutable int _alt_zone;
+    real _alt_easting, _alt_northing, _alt_gamma, _alt_k;
+    int _alt_zone;
 
-    void CopyToAlt() const {
+    void CopyToAlt() {
       _alt_easting = _easting;
       _alt_northing = _northing;
       _alt_gamma = _gamma;
@@ -64,9 +67,44 @@ namespace GeographicLib {
     }
     static void UTMUPSString(int zone, bool northp, real easting, real northing,
                              int prec, bool abbrev, std::string& utm);
+    static size_t UTMUPSString(int zone, bool northp,
+                               real easting, real northing,
+                               int prec, bool abbrev, char* utm, size_t cap);
     void FixHemisphere();
+    // Version of Reset which, if throwp = false, returns false instead of
+    // throwing an exception.
+    bool Reset(const std::string& s, int form, bool centerp, bool swaplatlong,
+               bool throwp);
   public:
 
+    /**
+     * The forms of the string representation of a position accepted by
+     * GeoCoords::Reset(const std::string&, inputform, bool, bool).  The
+     * value of each form is its number of elements.
+     **********************************************************************/
+    enum inputform {
+      /**
+       * Determine the form from the number of elements.
+       * @hideinitializer
+       **********************************************************************/
+      AUTOMATIC = 0,
+      /**
+       * An MGRS coordinate.
+       * @hideinitializer
+       **********************************************************************/
+      MGRSFORM = 1,
+      /**
+       * Latitude and longitude.
+       * @hideinitializer
+       **********************************************************************/
+      GEOGRAPHICFORM = 2,
+      /**
+       * UTM/UPS zone, easting, and northing.
+       * @hideinitializer
+       **********************************************************************/
+      UTMUPSFORM = 3,
+    };
+
     /** \name Initializing the GeoCoords object
      **********************************************************************/
     ///@{
@@ -225,6 +263,65 @@ namespace GeographicLib {
     void Reset(const std::string& s,
                bool centerp = true, bool swaplatlong = false);
 
+    /**
+     * Reset the location from a string returning a status instead of throwing
+     * an exception.
+     *
+     * @param[in] s 1-element, 2-element, or 3-element string representation of
+     *   the position.
+     * @param[in] centerp governs the interpretation of MGRS coordinates.
+     * @param[in] swaplatlong governs the interpretation of geographic
+     *   coordinates.
+     * @return true if \e s was parsed successfully; otherwise false, in which
+     *   case the coordinate is set as undefined (as with the default
+     *   constructor).
+     *
+     * MGRS and UTM/UPS coordinates are checked without throwing exceptions.
+     * The decoding of geographic coordinates and of UTM/UPS eastings and
+     * northings is carried out by DMS which does throw; these exceptions are
+     * caught, so that this function does not throw GeographicErr.
+     **********************************************************************/
+    bool TryReset(const std::string& s,
+                  bool centerp = true, bool swaplatlong = false);
+
+    /**
+     * Reset the location from a string of a given form.
+     *
+     * @param[in] s string representation of the position.
+     * @param[in] form the form of \e s (see GeoCoords::inputform).
+     * @param[in] centerp governs the interpretation of MGRS coordinates.
+     * @param[in] swaplatlong governs the interpretation of geographic
+     *   coordinates.
+     * @exception GeographicErr if the \e s is malformed or if it doesn't have
+     *   the number of elements implied by \e form.
+     *
+     * This is the same as Reset(const std::string&, bool, bool) except that
+     * the form of \e s is not inferred from the number of elements.  For
+     * \e form = GeoCoords::MGRSFORM, the string (after removing leading and
+     * trailing white space) is passed directly to MGRS::Reverse; so it
+     * should be used for data known to consist of MGRS coordinates.
+     **********************************************************************/
+    void Reset(const std::string& s, inputform form,
+               bool centerp = true, bool swaplatlong = false) {
+      Reset(s, form, centerp, swaplatlong, true);
+    }
+
+    /**
+     * Reset the location from a string of a given form returning a status
+     * instead of throwing an exception.
+     *
+     * @param[in] s string representation of the position.
+     * @param[in] form the form of \e s (see GeoCoords::inputform).
+     * @param[in] centerp governs the interpretation of MGRS coordinates.
+     * @param[in] swaplatlong governs the interpretation of geographic
+     *   coordinates.
+     * @return true if \e s was parsed successfully; otherwise false, in which
+     *   case the coordinate is set as undefined (as with the default
+     *   constructor).
+     **********************************************************************/
+    bool TryReset(const std::string& s, inputform form,
+                  bool centerp = true, bool swaplatlong = false);
+
     /**
      * Reset the location in terms of geographic coordinates.  See
      * GeoCoords(real latitude, real longitude, int zone).
@@ -338,7 +435,7 @@ namespace GeographicLib {
      * existing alternate representation.  Before this is called the alternate
      * zone is the input zone.
      **********************************************************************/
-    void SetAltZone(int zone = UTMUPS::STANDARD) const {
+    void SetAltZone(int zone = UTMUPS::STANDARD) {
       if (zone == UTMUPS::MATCH)
         return;
       zone = UTMUPS::StandardZone(_lat, _long, zone);
@@ -353,6 +450,22 @@ namespace GeographicLib {
       }
     }
 
+    /**
+     * Return a copy with a different alternate zone.
+     *
+     * @param[in] zone zone number for the alternate representation.
+     * @exception GeographicErr if \e zone cannot be used for this location.
+     * @return a copy of this object with SetAltZone(\e zone) applied.
+     *
+     * This leaves this object unchanged, so it may be used concurrently on a
+     * GeoCoords shared by several threads.
+     **********************************************************************/
+    GeoCoords WithAltZone(int zone = UTMUPS::STANDARD) const {
+      GeoCoords c(*this);
+      c.SetAltZone(zone);
+      return c;
+    }
+
     /**
      * @return current alternate zone (return 0 for UPS).
      **********************************************************************/
@@ -522,6 +635,122 @@ namespace GeographicLib {
                                         bool abbrev = true) const;
     ///@}
 
+    /** \name Representations written to character arrays
+     *
+     * These are the same as the corresponding functions returning a
+     * std::string except that the result is written, null terminated, to the
+     * array \e str of size \e cap.  No memory is allocated (unless
+     * Math::real is a multiprecision type), so these are suitable for bulk
+     * conversions.  The length of the result (excluding the terminating
+     * null) is returned.  A GeographicErr exception is thrown if \e cap is
+     * too small; in this case the contents of \e str are unspecified.  A
+     * buffer of size 64 suffices for all values of \e prec, provided
+     * Math::real is double.
+     **********************************************************************/
+    ///@{
+    /**
+     * Decimal latitude/longitude representation in a character array; see
+     * GeoCoords::GeoRepresentation(int, bool) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[in] swaplatlong if true give longitude first.
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t GeoRepresentation(int prec, bool swaplatlong,
+                             char* str, size_t cap) const;
+
+    /**
+     * MGRS string in a character array; see
+     * GeoCoords::MGRSRepresentation(int) const.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t MGRSRepresentation(int prec, char* str, size_t cap) const;
+
+    /**
+     * UTM/UPS string in a character array; see
+     * GeoCoords::UTMUPSRepresentation(int, bool) const.
+     *
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t UTMUPSRepresentation(int prec, bool abbrev,
+                                char* str, size_t cap) const;
+
+    /**
+     * UTM/UPS string with hemisphere override in a character array; see
+     * GeoCoords::UTMUPSRepresentation(bool, int, bool) const.
+     *
+     * @param[in] northp hemisphere override
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if the hemisphere override attempts to change
+     *   UPS N to UPS S or vice versa.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t UTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                char* str, size_t cap) const;
+
+    /**
+     * MGRS string for the alternate zone in a character array.
+     *
+     * @param[in] prec precision (relative to about 1m).
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t AltMGRSRepresentation(int prec, char* str, size_t cap) const;
+
+    /**
+     * UTM/UPS string for the alternate zone in a character array.
+     *
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t AltUTMUPSRepresentation(int prec, bool abbrev,
+                                   char* str, size_t cap) const;
+
+    /**
+     * UTM/UPS string for the alternate zone, with hemisphere override, in a
+     * character array.
+     *
+     * @param[in] northp hemisphere override
+     * @param[in] prec precision (relative to about 1m)
+     * @param[in] abbrev if true use abbreviated (n/s) notation for
+     *   hemisphere; otherwise spell out the hemisphere (north/south)
+     * @param[out] str the array for the result.
+     * @param[in] cap the size of \e str.
+     * @exception GeographicErr if the hemisphere override attempts to change
+     *   UPS n to UPS s or vice verse.
+     * @exception GeographicErr if \e cap is too small.
+     * @return the length of the result.
+     **********************************************************************/
+    size_t AltUTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                   char* str, size_t cap) const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -68,8 +68,10 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class LocalCartesian;
+    friend class GeocentricTracker; // GeocentricTracker uses IntReverse
     friend class MagneticCircle; // MagneticCircle uses Rotation
     friend class MagneticModel;  // MagneticModel uses IntForward
+    friend class MagneticSnapshot; // MagneticSnapshot uses IntForward
     friend class GravityCircle;  // GravityCircle uses Rotation
     friend class GravityModel;   // GravityModel uses IntForward
     friend class NormalGravity;  // NormalGravity uses IntForward
@@ -98,6 +100,45 @@ namespace GeographicLib {
                     real M[dim2_]) const;
     void IntReverse(real X, real Y, real Z, real& lat, real& lon, real& h,
                     real M[dim2_]) const;
+    // Batch versions with strides is (input) and os (output).  These are
+    // defined here so that OpenMP can be used by the calling code.  Element
+    // k of the matrix for point i is stored in M[k * n + i] (the same layout
+    // as in LocalCartesian).
+    void IntForwardBatch(const real* lat, const real* lon, const real* h,
+                         size_t is, size_t n,
+                         real* X, real* Y, real* Z, size_t os,
+                         real* M) const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long nl = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (long i = 0; i < nl; ++i) {
+        size_t ji = size_t(i) * is, jo = size_t(i) * os;
+        real t[dim2_];
+        IntForward(lat[ji], lon[ji], h[ji], X[jo], Y[jo], Z[jo],
+                   M ? t : NULL);
+        if (M)
+          for (size_t k = 0; k < dim2_; ++k) M[k * n + size_t(i)] = t[k];
+      }
+    }
+    void IntReverseBatch(const real* X, const real* Y, const real* Z,
+                         size_t is, size_t n,
+                         real* lat, real* lon, real* h, size_t os,
+                         real* M) const {
+      long nl = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (long i = 0; i < nl; ++i) {
+        size_t ji = size_t(i) * is, jo = size_t(i) * os;
+        real t[dim2_];
+        IntReverse(X[ji], Y[ji], Z[ji], lat[jo], lon[jo], h[jo],
+                   M ? t : NULL);
+        if (M)
+          for (size_t k = 0; k < dim2_; ++k) M[k * n + size_t(i)] = t[k];
+      }
+    }
 
   public:
 
@@ -235,6 +276,109 @@ namespace GeographicLib {
         IntReverse(X, Y, Z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert arrays of geodetic coordinates to geocentric coordinates.
+     *
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices for the points.
+     *   These are stored by component: element \e k (in row-major order) of
+     *   the matrix for point \e i is M[\e k \e n + \e i].
+     *
+     * The results are identical to those given by calling Geocentric::Forward
+     * for each point.  An output array may be the same as an input array.
+     * This function is defined in the header file; if the calling code is
+     * compiled with OpenMP, the points are divided among the threads.
+     **********************************************************************/
+    void ForwardBatch(const real lat[], const real lon[], const real h[],
+                      size_t n, real X[], real Y[], real Z[], real M[] = 0)
+      const {
+      if (Init())
+        IntForwardBatch(lat, lon, h, 1, n, X, Y, Z, 1, M);
+    }
+
+    /**
+     * Convert an array of geodetic coordinates to geocentric coordinates
+     * with interleaved storage.
+     *
+     * @param[in] llh array of 3 \e n elements holding the latitude, longitude,
+     *   and height of each point in turn.
+     * @param[in] n the number of points.
+     * @param[out] XYZ array of 3 \e n elements for the geocentric coordinates
+     *   \e X, \e Y, \e Z of each point in turn.
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices (stored by
+     *   component).
+     *
+     * \e XYZ may be the same as \e llh, so that a point cloud can be
+     * converted in place.  Otherwise, this is the same as
+     * Geocentric::ForwardBatch(const real[], const real[], const real[],
+     * size_t, real[], real[], real[], real[]) const.
+     **********************************************************************/
+    void ForwardBatch(const real llh[], size_t n, real XYZ[], real M[] = 0)
+      const {
+      if (Init())
+        IntForwardBatch(llh, llh + 1, llh + 2, dim_, n,
+                        XYZ, XYZ + 1, XYZ + 2, dim_, M);
+    }
+
+    /**
+     * Convert arrays of geocentric coordinates to geodetic coordinates.
+     *
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices for the points.
+     *   These are stored by component: element \e k (in row-major order) of
+     *   the matrix for point \e i is M[\e k \e n + \e i].
+     *
+     * The results are identical to those given by calling Geocentric::Reverse
+     * for each point.  An output array may be the same as an input array.
+     * This function is defined in the header file; if the calling code is
+     * compiled with OpenMP, the points are divided among the threads.
+     **********************************************************************/
+    void ReverseBatch(const real X[], const real Y[], const real Z[],
+                      size_t n, real lat[], real lon[], real h[],
+                      real M[] = 0) const {
+      if (Init())
+        IntReverseBatch(X, Y, Z, 1, n, lat, lon, h, 1, M);
+    }
+
+    /**
+     * Convert an array of geocentric coordinates to geodetic coordinates
+     * with interleaved storage.
+     *
+     * @param[in] XYZ array of 3 \e n elements holding the geocentric
+     *   coordinates \e X, \e Y, \e Z of each point in turn.
+     * @param[in] n the number of points.
+     * @param[out] llh array of 3 \e n elements for the latitude, longitude,
+     *   and height of each point in turn.
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices (stored by
+     *   component).
+     *
+     * \e llh may be the same as \e XYZ.  Otherwise, this is the same as
+     * Geocentric::ReverseBatch(const real[], const real[], const real[],
+     * size_t, real[], real[], real[], real[]) const.
+     **********************************************************************/
+    void ReverseBatch(const real XYZ[], size_t n, real llh[], real M[] = 0)
+      const {
+      if (Init())
+        IntReverseBatch(XYZ, XYZ + 1, XYZ + 2, dim_, n,
+                        llh, llh + 1, llh + 2, dim_, M);
+    }
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,147 @@
+/**
+ * \file GeocentricTracker.hpp
+ * \brief Header for GeographicLib::GeocentricTracker class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEOCENTRICTRACKER_HPP)
+#define GEOGRAPHICLIB_GEOCENTRICTRACKER_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geocentric.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geocentric to geodetic conversions along a trajectory
+   *
+   * The positions of a vehicle are often converted from geocentric to
+   * geodetic coordinates at a high rate, so that each position is close to
+   * the previous one.  GeocentricTracker::Reverse exploits this by starting
+   * from the latitude found on the previous call and refining it with
+   * Newton's method; typically one or two steps are needed and this is nearly
+   * twice as fast as Geocentric::Reverse.  If there is no previous
+   * solution, if the position has moved by more than about 60 km, or if the
+   * point is far from the surface of the ellipsoid (within \e a/2 of the
+   * center or farther than the limit given for Geocentric::Reverse), the
+   * full solution of Geocentric::Reverse is used instead.  In all cases the
+   * results agree with those of Geocentric::Reverse to within a few
+   * nanometers.
+   *
+   * An object of this class holds the state of a single trajectory; use a
+   * separate object for each trajectory (and for each thread).
+   *
+   * Example of use:
+   * \include example-GeocentricTracker.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeocentricTracker {
+  private:
+    typedef Math::real real;
+    static const size_t dim2_ = Geocentric::dim2_;
+    static const int maxit_ = 4;
+    Geocentric _earth;
+    real _sphi, _cphi;
+    bool _valid;
+    void IntReverse(real X, real Y, real Z, real& lat, real& lon, real& h,
+                    real M[dim2_]);
+  public:
+
+    /**
+     * Constructor for GeocentricTracker.
+     *
+     * @param[in] earth Geocentric object for the transformation; default
+     *   Geocentric::WGS84().
+     **********************************************************************/
+    explicit GeocentricTracker(const Geocentric& earth = Geocentric::WGS84())
+      : _earth(earth)
+      , _valid(false)
+    {}
+
+    /**
+     * Convert from geocentric to geodetic to coordinates using the previous
+     * solution as a starting point.
+     *
+     * @param[in] X geocentric coordinate (meters).
+     * @param[in] Y geocentric coordinate (meters).
+     * @param[in] Z geocentric coordinate (meters).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] h height of point above the ellipsoid (meters).
+     *
+     * The results are those of Geocentric::Reverse.  The latitude is
+     * remembered for the next call.
+     **********************************************************************/
+    void Reverse(real X, real Y, real Z, real& lat, real& lon, real& h) {
+      if (Init())
+        IntReverse(X, Y, Z, lat, lon, h, NULL);
+    }
+
+    /**
+     * Convert from geocentric to geodetic to coordinates using the previous
+     * solution as a starting point.
+     *
+     * @param[in] X geocentric coordinate (meters).
+     * @param[in] Y geocentric coordinate (meters).
+     * @param[in] Z geocentric coordinate (meters).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] h height of point above the ellipsoid (meters).
+     * @param[out] M if the length of the vector is 9, fill with the rotation
+     *   matrix in row-major order.
+     *
+     * The meaning of \e M is the same as for Geocentric::Reverse.
+     **********************************************************************/
+    void Reverse(real X, real Y, real Z, real& lat, real& lon, real& h,
+                 std::vector<real>& M) {
+      if (!Init())
+        return;
+      if (M.end() == M.begin() + dim2_) {
+        real t[dim2_];
+        IntReverse(X, Y, Z, lat, lon, h, t);
+        std::copy(t, t + dim2_, M.begin());
+      } else
+        IntReverse(X, Y, Z, lat, lon, h, NULL);
+    }
+
+    /**
+     * Forget the previous solution; the next call to
+     * GeocentricTracker::Reverse uses the full method.  Call this when the
+     * trajectory is interrupted.
+     **********************************************************************/
+    void Reset() { _valid = false; }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _earth.Init(); }
+
+    /**
+     * @return true if there is a previous solution to start from.
+     **********************************************************************/
+    bool Tracking() const { return _valid; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geocentric object used in the
+     *   constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _earth.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geocentric object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEOCENTRICTRACKER_HPP
@@ -23,9 +23,20 @@
     (GEOGRAPHICLIB_PRECISION == 3 ? 7 : 8)))
 #endif
 
+#if !defined(GEOGRAPHICLIB_GEODESIC_STATS)
+/**
+ * Whether Geodesic collects statistics on the solution of the inverse
+ * problem; see Geodesic::InverseStats.  This only has an effect when
+ * compiling the library.  The default, 0, disables the collection of
+ * statistics, so that the inverse calculation is unaffected.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_GEODESIC_STATS 0
+#endif
+
 namespace GeographicLib {
 
   class GeodesicLine;
+  template <typename T> class CompactGeodesicLineT;
 
   /**
    * \brief %Geodesic calculations
@@ -172,6 +183,9 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class GeodesicLine;
+    template <typename T> friend class CompactGeodesicLineT;
+    friend class GreatEllipse;
+    friend class GreatEllipseLine;
     static const int nA1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
     static const int nC1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
     static const int nC1p_ = GEOGRAPHICLIB_GEODESIC_ORDER;
@@ -201,18 +215,40 @@ namespace GeographicLib {
     };
 
     static real SinCosSeries(bool sinp,
-                             real sinx, real cosx, const real c[], int n);
+                             real sinx, real cosx, const real c[], int n) {
+      // Evaluate
+      // y = sinp ? sum(c[i] * sin( 2*i    * x), i, 1, n) :
+      //            sum(c[i] * cos((2*i+1) * x), i, 0, n-1)
+      // using Clenshaw summation.  N.B. c[0] is unused for sin series
+      // Approx operation count = (n + 5) mult and (2 * n + 2) add
+      c += (n + sinp);            // Point to one beyond last element
+      real
+        ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
+        y0 = n & 1 ? *--c : 0, y1 = 0;          // accumulators for sum
+      // Now n is even
+      n /= 2;
+      while (n--) {
+        // Unroll loop x 2, so accumulators return to their original role
+        y1 = ar * y0 - y1 + *--c;
+        y0 = ar * y1 - y0 + *--c;
+      }
+      return sinp
+        ? 2 * sinx * cosx * y0    // sin(2 * x) * y0
+        : cosx * (y0 - y1);       // cos(x) * (y0 - y1)
+    }
     static real Astroid(real x, real y);
 
     real _a, _f, _f1, _e2, _ep2, _n, _b, _c2, _etol2;
     real _A3x[nA3x_], _C3x[nC3x_], _C4x[nC4x_];
+    int _nC;                    // the order of the expansions used
+    real _tolv;
 
     void Lengths(real eps, real sig12,
                  real ssig1, real csig1, real dn1,
                  real ssig2, real csig2, real dn2,
-                 real cbet1, real cbet2,
+                 real cbet1, real cbet2, unsigned outmask,
                  real& s12s, real& m12a, real& m0,
-                 bool scalep, real& M12, real& M21,
+                 real& M12, real& M21,
                  real C1a[], real C2a[]) const;
     real InverseStart(real sbet1, real cbet1, real dn1,
                       real sbet2, real cbet2, real dn2,
@@ -220,6 +256,55 @@ namespace GeographicLib {
                       real& salp1, real& calp1,
                       real& salp2, real& calp2, real& dnm,
                       real C1a[], real C2a[]) const;
+    void ReducedLatitude(real lat, real& sbet, real& cbet, real& dn) const;
+    // If maxit > 0, at most maxit iterations of Newton's method are taken and
+    // the error estimate and the convergence flag are returned in *ds12 and
+    // *converged (if these are non-null).
+    real GenInverse(real lat1, real sbet1, real cbet1, real dn1,
+                    real lat2, real sbet2, real cbet2, real dn2,
+                    real lon12, unsigned outmask,
+                    real& s12, real& azi1, real& azi2,
+                    real& m12, real& M12, real& M21, real& S12,
+                    unsigned maxit = 0, real* ds12 = 0, bool* converged = 0)
+      const;
+    // The implementation of GenInverse.  If Mask != ALL, outmask is replaced
+    // by Mask so that the unneeded calculations are removed at compile time.
+    template<unsigned Mask>
+    real GenInverseT(real lat1, real sbet1, real cbet1, real dn1,
+                     real lat2, real sbet2, real cbet2, real dn2,
+                     real lon12, unsigned outmask,
+                     real& s12, real& azi1, real& azi2,
+                     real& m12, real& M12, real& M21, real& S12,
+                     unsigned maxit, real* ds12, bool* converged) const;
+    void IntDistanceBounds(real sbet1, real cbet1, real sbet2, real cbet2,
+                           real lon12, real& lo, real& hi) const;
+    // The batch calculations for the problems [i0, i1).
+    void GenDirectRange(const real* lat1, const real* lon1, const real* azi1,
+                        bool arcmode, const real* s12_a12,
+                        size_t i0, size_t i1, unsigned outmask,
+                        real* lat2, real* lon2, real* azi2,
+                        real* s12, real* m12, real* M12, real* M21,
+                        real* S12, real* a12) const;
+    void GenInverseRange(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2,
+                         size_t i0, size_t i1, unsigned outmask,
+                         real* s12, real* azi1, real* azi2,
+                         real* m12, real* M12, real* M21, real* S12,
+                         real* a12) const;
+    void LineRange(const real* lat1, const real* lon1, const real* azi1,
+                   size_t i0, size_t i1, unsigned caps,
+                   GeodesicLine* lines) const;
+    void GenDirectFanRange(real lat1, real lon1, const real* azi1,
+                           bool arcmode, const real* s12_a12, size_t ns,
+                           size_t i0, size_t i1, unsigned outmask,
+                           real* lat2, real* lon2, real* azi2,
+                           real* s12, real* m12, real* M12, real* M21,
+                           real* S12, real* a12) const;
+    void SegmentBoundsRange(const real* lat1, const real* lon1,
+                            const real* lat2, const real* lon2,
+                            size_t i0, size_t i1,
+                            real* latmin, real* latmax,
+                            real* lonmin, real* lonmax) const;
     real Lambda12(real sbet1, real cbet1, real dn1,
                   real sbet2, real cbet2, real dn2,
                   real salp1, real calp1,
@@ -230,12 +315,18 @@ namespace GeographicLib {
       const;
 
     // These are Maxima generated functions to provide series approximations to
-    // the integrals for the ellipsoidal geodesic.
-    static real A1m1f(real eps);
-    static void C1f(real eps, real c[]);
-    static void C1pf(real eps, real c[]);
-    static real A2m1f(real eps);
-    static void C2f(real eps, real c[]);
+    // the integrals for the ellipsoidal geodesic.  The tables are the
+    // coefficient arrays used by A1m1f, C1f, etc.
+    static const real* A1m1table();
+    static const real* C1table();
+    static const real* C1ptable();
+    static const real* A2m1table();
+    static const real* C2table();
+    static real A1m1f(real eps, int order);
+    static void C1f(real eps, real c[], int order);
+    static void C1pf(real eps, real c[], int order);
+    static real A2m1f(real eps, int order);
+    static void C2f(real eps, real c[], int order);
 
     void A3coeff();
     real A3f(real eps) const;
@@ -321,6 +412,143 @@ namespace GeographicLib {
       ALL           = OUT_ALL| CAP_ALL,
     };
 
+    /**
+     * \brief Statistics for the solution of the inverse problem
+     *
+     * If the library is compiled with GEOGRAPHICLIB_GEODESIC_STATS = 1,
+     * Geodesic::GenInverse (and the functions which call it) record how each
+     * inverse problem is solved in a thread-local Geodesic::InverseStats
+     * object.  The statistics for the calling thread are retrieved with
+     * Geodesic::GetInverseStats and reset with Geodesic::ResetInverseStats.
+     * Statistics collected in several threads can be combined with
+     * Geodesic::InverseStats::Add.
+     *
+     * Every solution is counted in exactly one of \e meridional,
+     * \e equatorial, \e shortline, and \e newton.  For the solutions
+     * counted in \e newton, \e hist[\e k] counts the solutions which
+     * required \e k evaluations of the longitude difference after the
+     * starting guess (the last bin also counts the solutions which needed
+     * more evaluations).
+     **********************************************************************/
+    struct GEOGRAPHICLIB_EXPORT InverseStats {
+      /**
+       * The number of bins in the histogram of iteration counts.
+       **********************************************************************/
+      static const int nbins_ = 32;
+      /**
+       * The total number of solutions of the inverse problem.
+       **********************************************************************/
+      unsigned long count;
+      /**
+       * The number of solutions where both points lie on a meridian.
+       **********************************************************************/
+      unsigned long meridional;
+      /**
+       * The number of solutions along the equator.
+       **********************************************************************/
+      unsigned long equatorial;
+      /**
+       * The number of solutions where the starting guess from the short-line
+       * approximation was used unchanged, so that Newton's method was
+       * skipped.
+       **********************************************************************/
+      unsigned long shortline;
+      /**
+       * The number of solutions found by Newton's method.
+       **********************************************************************/
+      unsigned long newton;
+      /**
+       * The total number of bisection steps taken in the Newton solutions
+       * (these are taken when the Newton step leaves the bracket for the
+       * azimuth or the derivative is not positive).
+       **********************************************************************/
+      unsigned long bisection;
+      /**
+       * The number of Newton solutions which were terminated because the
+       * bracket for the azimuth shrank below the tolerance (the \e tripb
+       * criterion).
+       **********************************************************************/
+      unsigned long tripb;
+      /**
+       * The number of Newton solutions which hit the iteration limit without
+       * converging.
+       **********************************************************************/
+      unsigned long failed;
+      /**
+       * The histogram of iteration counts for the Newton solutions.
+       **********************************************************************/
+      unsigned long hist[nbins_];
+      /**
+       * Add the counts from another InverseStats object to this one.
+       *
+       * @param[in] s the other InverseStats object.
+       **********************************************************************/
+      void Add(const InverseStats& s) {
+        count += s.count; meridional += s.meridional;
+        equatorial += s.equatorial; shortline += s.shortline;
+        newton += s.newton; bisection += s.bisection;
+        tripb += s.tripb; failed += s.failed;
+        for (int k = 0; k < nbins_; ++k) hist[k] += s.hist[k];
+      }
+    };
+
+    /**
+     * \brief A point prepared for repeated inverse calculations
+     *
+     * This holds the quantities for a point which Geodesic::GenInverse
+     * computes for each of its end points: the rounded latitude, the
+     * normalized longitude, and the sine and cosine of the reduced latitude.
+     * When the same point is used in many inverse calculations (for example,
+     * when finding the distances from one point to many others), construct a
+     * Geodesic::Point for it once and pass it to the versions of
+     * Geodesic::Inverse and Geodesic::GenInverse which accept Geodesic::Point
+     * arguments.  These then skip the trigonometric and normalization steps
+     * for both end points.  The results are identical to those returned by
+     * the versions of Geodesic::Inverse which accept latitudes and
+     * longitudes.
+     *
+     * A Geodesic::Point depends on the ellipsoid; it should only be used with
+     * the Geodesic object with which it was constructed (or another Geodesic
+     * object for the same ellipsoid).
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Point {
+    private:
+      friend class Geodesic;
+      real _lat, _lon, _sbet, _cbet, _dn;
+    public:
+      /**
+       * A default constructor.  The latitude and longitude are set to NaNs;
+       * inverse calculations with such a point return NaNs.
+       **********************************************************************/
+      Point()
+        : _lat(Math::NaN()), _lon(Math::NaN())
+        , _sbet(Math::NaN()), _cbet(Math::NaN()), _dn(Math::NaN()) {}
+
+      /**
+       * Constructor for a Geodesic::Point.
+       *
+       * @param[in] geod the Geodesic object for the ellipsoid.
+       * @param[in] lat the latitude of the point (degrees).
+       * @param[in] lon the longitude of the point (degrees).
+       *
+       * \e lat should be in the range [&minus;90&deg;, 90&deg;] and \e lon
+       * should be in the range [&minus;540&deg;, 540&deg;).
+       **********************************************************************/
+      Point(const Geodesic& geod, real lat, real lon);
+
+      /**
+       * @return the latitude of the point (degrees).  This is the value after
+       *   conversion of tiny values to 0 by Math::AngRound.
+       **********************************************************************/
+      Math::real Latitude() const { return _lat; }
+
+      /**
+       * @return the longitude of the point (degrees) reduced to the range
+       *   [&minus;180&deg;, 180&deg;).
+       **********************************************************************/
+      Math::real Longitude() const { return _lon; }
+    };
+
     /** \name Constructor
      **********************************************************************/
     ///@{
@@ -331,10 +559,26 @@ namespace GeographicLib {
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
      *   flattening to 1/\e f.
+     * @param[in] order the order of the series expansions (default
+     *   GEOGRAPHICLIB_GEODESIC_ORDER).
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
+     * @exception GeographicErr if \e order is not in [3,
+     *   GEOGRAPHICLIB_GEODESIC_ORDER].
+     *
+     * Setting \e order to a value less than GEOGRAPHICLIB_GEODESIC_ORDER
+     * truncates the series expansions and loosens the convergence criterion
+     * for the solution of the inverse problem; this trades accuracy for
+     * speed.  For the WGS84 ellipsoid, the maximum errors in the distance and
+     * in the position of point 2 are about 40 &mu;m for \e order = 3, 0.1
+     * &mu;m for \e order = 4, and 15 nm (the round-off error in the default
+     * case) for \e order = 5; with \e order = 3, the direct and inverse
+     * problems are solved about 20% faster than with \e order = 6.  The
+     * errors scale as <i>n</i><sup><i>order</i></sup> for other ellipsoids,
+     * where \e n is the third flattening.  GeodesicLine objects created from
+     * this object use the same order.
      **********************************************************************/
-    Geodesic(real a, real f);
+    Geodesic(real a, real f, int order = GEOGRAPHICLIB_GEODESIC_ORDER);
     ///@}
 
     /** \name Direct geodesic problem specified in terms of distance.
@@ -637,6 +881,178 @@ namespace GeographicLib {
                          real& S12) const;
     ///@}
 
+    /** \name Direct geodesic problem for arrays of points.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the direct geodesic problem for many starting points, azimuths,
+     * and distances.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] s12 array of distances between point 1 and point 2 (meters).
+     * @param[in] n the number of problems.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::LATITUDE,
+     *   Geodesic::LONGITUDE, Geodesic::AZIMUTH, and Geodesic::LONG_UNROLL
+     *   specifying which of the output arrays should be set and how the
+     *   longitude is treated; default Geodesic::LATITUDE |
+     *   Geodesic::LONGITUDE | Geodesic::AZIMUTH.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The \e i th problem is specified by \e lat1[\e i], \e lon1[\e i], \e
+     * azi1[\e i], \e s12[\e i], for 0 &le; \e i &lt; \e n.  The output arrays
+     * which are not requested by \e outmask are not referenced and may be null
+     * pointers.  The results are identical to those returned by
+     * Geodesic::Direct.  The problems are divided between \e nthreads
+     * threads as described for Geodesic::GenDirectBatch.
+     **********************************************************************/
+    void DirectBatch(const real* lat1, const real* lon1, const real* azi1,
+                     const real* s12, size_t n,
+                     real* lat2, real* lon2, real* azi2,
+                     unsigned outmask = LATITUDE | LONGITUDE | AZIMUTH,
+                     int nthreads = 1) const {
+      GenDirectBatch(lat1, lon1, azi1, false, s12, n,
+                     outmask & (LATITUDE | LONGITUDE | AZIMUTH | LONG_UNROLL),
+                     lat2, lon2, azi2, 0, 0, 0, 0, 0, 0, nthreads);
+    }
+
+    /**
+     * The general direct geodesic calculation for many problems.
+     * Geodesic::DirectBatch is defined in terms of this function.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of the \e
+     *   s12_a12.
+     * @param[in] s12_a12 array of distances (meters) if \e arcmode is false
+     *   or of arc lengths (degrees) if \e arcmode is true.
+     * @param[in] n the number of problems.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The interpretation of \e outmask is the same as for Geodesic::GenDirect.
+     * Output arrays not selected by \e outmask are not referenced and may be
+     * null pointers (both \e M12 and \e M21 are selected by
+     * Geodesic::GEODESICSCALE).  The arc length is always computed; it is
+     * stored in \e a12 if this is not a null pointer.  The results are
+     * identical to calling Geodesic::GenDirect \e n times.
+     *
+     * The problems are divided into \e nthreads contiguous ranges which are
+     * solved by Executor::Default() (concurrently, if the executor permits).
+     * If the library is compiled without C++11, all the work is done by the
+     * calling thread; in any case, the results do not depend on \e
+     * nthreads.
+     **********************************************************************/
+    void GenDirectBatch(const real* lat1, const real* lon1, const real* azi1,
+                        bool arcmode, const real* s12_a12, size_t n,
+                        unsigned outmask,
+                        real* lat2, real* lon2, real* azi2,
+                        real* s12, real* m12, real* M12, real* M21,
+                        real* S12, real* a12, int nthreads = 1) const;
+
+    /**
+     * Solve the direct geodesic problem from a single point for all
+     * combinations of several azimuths and distances.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] na the number of azimuths.
+     * @param[in] s12 array of distances from point 1 to point 2 (meters).
+     * @param[in] ns the number of distances.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the output arrays should be set; default
+     *   Geodesic::LATITUDE | Geodesic::LONGITUDE | Geodesic::AZIMUTH.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The result for \e azi1[\e i] and \e s12[\e j] is stored in element \e
+     * i \e ns + \e j of the output arrays, for 0 &le; \e i &lt; \e na and 0
+     * &le; \e j &lt; \e ns; so each row of the output traces out the
+     * geodesic with a given azimuth and each column gives a geodesic circle.
+     * The results are identical to those returned by Geodesic::Direct.  See
+     * Geodesic::GenDirectFan for the details.
+     **********************************************************************/
+    void DirectFan(real lat1, real lon1, const real* azi1, size_t na,
+                   const real* s12, size_t ns,
+                   real* lat2, real* lon2, real* azi2,
+                   unsigned outmask = LATITUDE | LONGITUDE | AZIMUTH,
+                   int nthreads = 1) const {
+      GenDirectFan(lat1, lon1, azi1, na, false, s12, ns,
+                   outmask & (LATITUDE | LONGITUDE | AZIMUTH | LONG_UNROLL),
+                   lat2, lon2, azi2, 0, 0, 0, 0, 0, 0, nthreads);
+    }
+
+    /**
+     * The general direct geodesic calculation from a single point for all
+     * combinations of several azimuths and distances.  Geodesic::DirectFan
+     * is defined in terms of this function.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] na the number of azimuths.
+     * @param[in] arcmode boolean flag determining the meaning of the \e
+     *   s12_a12.
+     * @param[in] s12_a12 array of distances (meters) if \e arcmode is false
+     *   or of arc lengths (degrees) if \e arcmode is true.
+     * @param[in] ns the number of distances or arc lengths.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The output arrays have \e na \e ns elements laid out as described for
+     * Geodesic::DirectFan.  The interpretation of \e outmask and of null
+     * output arrays is the same as for Geodesic::GenDirectBatch and the
+     * results are identical to calling Geodesic::GenDirect \e na \e ns
+     * times.
+     *
+     * A single GeodesicLine is constructed for each azimuth (these are
+     * constructed in blocks as in Geodesic::LineBatch) and is then used for
+     * all the distances; when \e ns is large, this is about twice as fast
+     * as Geodesic::GenDirectBatch.  The azimuths are divided between \e
+     * nthreads threads as described for Geodesic::GenDirectBatch.
+     **********************************************************************/
+    void GenDirectFan(real lat1, real lon1, const real* azi1, size_t na,
+                      bool arcmode, const real* s12_a12, size_t ns,
+                      unsigned outmask,
+                      real* lat2, real* lon2, real* azi2,
+                      real* s12, real* m12, real* M12, real* M21,
+                      real* S12, real* a12, int nthreads = 1) const;
+    ///@}
+
     /** \name Inverse geodesic problem.
      **********************************************************************/
     ///@{
@@ -679,10 +1095,8 @@ namespace GeographicLib {
     Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
                        real& s12, real& azi1, real& azi2, real& m12,
                        real& M12, real& M21, real& S12) const {
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE | AZIMUTH |
-                        REDUCEDLENGTH | GEODESICSCALE | AREA,
-                        s12, azi1, azi2, m12, M12, M21, S12);
+      return GenInverse<ALL>
+        (lat1, lon1, lat2, lon2, s12, azi1, azi2, m12, M12, M21, S12);
     }
 
     /**
@@ -691,9 +1105,8 @@ namespace GeographicLib {
     Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
                        real& s12) const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE,
-                        s12, t, t, t, t, t, t);
+      return GenInverse<DISTANCE>
+        (lat1, lon1, lat2, lon2, s12, t, t, t, t, t, t);
     }
 
     /**
@@ -702,9 +1115,8 @@ namespace GeographicLib {
     Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
                        real& azi1, real& azi2) const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        AZIMUTH,
-                        t, azi1, azi2, t, t, t, t);
+      return GenInverse<AZIMUTH>
+        (lat1, lon1, lat2, lon2, t, azi1, azi2, t, t, t, t);
     }
 
     /**
@@ -714,9 +1126,8 @@ namespace GeographicLib {
                        real& s12, real& azi1, real& azi2)
       const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE | AZIMUTH,
-                        s12, azi1, azi2, t, t, t, t);
+      return GenInverse<DISTANCE | AZIMUTH>
+        (lat1, lon1, lat2, lon2, s12, azi1, azi2, t, t, t, t);
     }
 
     /**
@@ -726,9 +1137,8 @@ namespace GeographicLib {
                        real& s12, real& azi1, real& azi2, real& m12)
       const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE | AZIMUTH | REDUCEDLENGTH,
-                        s12, azi1, azi2, m12, t, t, t);
+      return GenInverse<DISTANCE | AZIMUTH | REDUCEDLENGTH>
+        (lat1, lon1, lat2, lon2, s12, azi1, azi2, m12, t, t, t);
     }
 
     /**
@@ -738,9 +1148,8 @@ namespace GeographicLib {
                        real& s12, real& azi1, real& azi2,
                        real& M12, real& M21) const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE | AZIMUTH | GEODESICSCALE,
-                        s12, azi1, azi2, t, M12, M21, t);
+      return GenInverse<DISTANCE | AZIMUTH | GEODESICSCALE>
+        (lat1, lon1, lat2, lon2, s12, azi1, azi2, t, M12, M21, t);
     }
 
     /**
@@ -750,10 +1159,9 @@ namespace GeographicLib {
                        real& s12, real& azi1, real& azi2, real& m12,
                        real& M12, real& M21) const {
       real t;
-      return GenInverse(lat1, lon1, lat2, lon2,
-                        DISTANCE | AZIMUTH |
-                        REDUCEDLENGTH | GEODESICSCALE,
-                        s12, azi1, azi2, m12, M12, M21, t);
+      return GenInverse<DISTANCE | AZIMUTH |
+                        REDUCEDLENGTH | GEODESICSCALE>
+        (lat1, lon1, lat2, lon2, s12, azi1, azi2, m12, M12, M21, t);
     }
     ///@}
 
@@ -798,6 +1206,453 @@ namespace GeographicLib {
                           real& s12, real& azi1, real& azi2,
                           real& m12, real& M12, real& M21, real& S12)
       const;
+
+    /**
+     * The general inverse geodesic calculation specialized for a particular
+     * \e outmask.
+     *
+     * @tparam outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This returns the same results as GenInverse(\e lat1, \e lon1, \e lat2,
+     * \e lon2, \e outmask, \e s12, \e azi1, \e azi2, \e m12, \e M12, \e
+     * M21, \e S12).  However, because \e outmask is known at compile time,
+     * the calculations for the quantities not requested are omitted, e.g.,
+     * the series for the reduced length are not evaluated when computing
+     * just the distance.  For WGS84, this saves about 10% of the time when
+     * only the distance or only the azimuths are needed.  The overloaded
+     * versions of Geodesic::Inverse are defined in terms of this function.
+     * Only the following values of \e outmask are provided by the library:
+     * - Geodesic::DISTANCE;
+     * - Geodesic::AZIMUTH;
+     * - Geodesic::DISTANCE | Geodesic::AZIMUTH;
+     * - Geodesic::DISTANCE | Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH;
+     * - Geodesic::DISTANCE | Geodesic::AZIMUTH | Geodesic::GEODESICSCALE;
+     * - Geodesic::DISTANCE | Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH |
+     *   Geodesic::GEODESICSCALE;
+     * - Geodesic::DISTANCE | Geodesic::AREA;
+     * - Geodesic::ALL.
+     * .
+     * Other values of \e outmask will result in a link error.
+     * Geodesic::GenInverseBatch uses these functions for the corresponding
+     * values of \e outmask.
+     **********************************************************************/
+    template<unsigned outmask>
+    Math::real GenInverse(real lat1, real lon1, real lat2, real lon2,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12)
+      const;
+    ///@}
+
+    /** \name Inverse geodesic problem with a bounded number of iterations.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse geodesic problem with a limit on the number of
+     * iterations.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] maxit the maximum number of iterations.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] ds12 an estimate of the error in \e s12 (meters).
+     * @return true if the solution converged.
+     *
+     * See Geodesic::GenInverseBounded for details.
+     **********************************************************************/
+    bool InverseBounded(real lat1, real lon1, real lat2, real lon2,
+                        unsigned maxit,
+                        real& s12, real& azi1, real& azi2, real& ds12) const {
+      real t;
+      bool converged;
+      GenInverseBounded(lat1, lon1, lat2, lon2, DISTANCE | AZIMUTH, maxit,
+                        s12, azi1, azi2, t, t, t, t, ds12, converged);
+      return converged;
+    }
+
+    /**
+     * The general inverse geodesic calculation with a limit on the number of
+     * iterations.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[in] maxit the maximum number of iterations; if this is 0, 1 is
+     *   used.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @param[out] ds12 an estimate of the error in \e s12 (meters).
+     * @param[out] converged true if the solution converged.
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This is the same as Geodesic::GenInverse except that Newton's method
+     * for the azimuth \e azi1 (see \ref geodinverse) is stopped after \e
+     * maxit iterations, each of which involves one solution of the direct
+     * problem for the longitude.  (The meridional, equatorial, and short
+     * cases are solved without iteration.)  If the solution has converged
+     * within this budget, the results are identical to those of
+     * Geodesic::GenInverse.  Otherwise, the results are those for the last
+     * iterate: these describe a geodesic (all the returned quantities are
+     * consistent with one another) which starts at one of the end points and
+     * reaches the latitude of the other but misses it in longitude.  In all
+     * cases, \e ds12 is the distance by which the geodesic misses; to first
+     * order, this bounds the error in \e s12.  It is of the order of
+     * roundoff if \e converged is true.
+     *
+     * The time taken is bounded by a fixed amount (about a third of the
+     * average time for Geodesic::Inverse) plus \e maxit times the cost of an
+     * iteration (about a sixth of the average time for Geodesic::Inverse).
+     * For WGS84 (and double precision), random inputs, including nearly
+     * antipodal ones, converge with 4 iterations on average and with at most
+     * 7 iterations; with \e maxit = 5, the error in \e s12 is less than 1
+     * mm.  Geodesic::GenInverse itself limits the number of iterations to
+     * Geodesic::MaxIterations.
+     **********************************************************************/
+    Math::real GenInverseBounded(real lat1, real lon1, real lat2, real lon2,
+                                 unsigned outmask, unsigned maxit,
+                                 real& s12, real& azi1, real& azi2,
+                                 real& m12, real& M12, real& M21, real& S12,
+                                 real& ds12, bool& converged) const;
+    ///@}
+
+    /** \name Inverse geodesic problem for prepared points.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse geodesic problem between two prepared points.
+     *
+     * @param[in] p1 point 1.
+     * @param[in] p2 point 2.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This returns the same results as Geodesic::Inverse called with the
+     * latitudes and longitudes used to construct \e p1 and \e p2.
+     **********************************************************************/
+    Math::real Inverse(const Point& p1, const Point& p2, real& s12) const {
+      real t;
+      return GenInverse(p1, p2, DISTANCE, s12, t, t, t, t, t, t);
+    }
+
+    /**
+     * See the documentation for Geodesic::Inverse(const Point&, const
+     * Point&, real&) const.
+     **********************************************************************/
+    Math::real Inverse(const Point& p1, const Point& p2,
+                       real& s12, real& azi1, real& azi2) const {
+      real t;
+      return GenInverse(p1, p2, DISTANCE | AZIMUTH,
+                        s12, azi1, azi2, t, t, t, t);
+    }
+
+    /**
+     * The general inverse geodesic calculation between two prepared
+     * points.
+     *
+     * @param[in] p1 point 1.
+     * @param[in] p2 point 2.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * The interpretation of \e outmask is the same as for
+     * Geodesic::GenInverse.
+     **********************************************************************/
+    Math::real GenInverse(const Point& p1, const Point& p2,
+                          unsigned outmask,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12)
+      const {
+      return GenInverse(p1._lat, p1._sbet, p1._cbet, p1._dn,
+                        p2._lat, p2._sbet, p2._cbet, p2._dn,
+                        Math::AngDiff(p1._lon, p2._lon), outmask,
+                        s12, azi1, azi2, m12, M12, M21, S12);
+    }
+    ///@}
+
+    /** \name Inverse geodesic problem for arrays of points.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse geodesic problem for many pairs of points.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[out] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::DISTANCE and
+     *   Geodesic::AZIMUTH specifying which of the output arrays should be
+     *   set; default Geodesic::DISTANCE | Geodesic::AZIMUTH.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The input arrays are in "structure of arrays" form; the \e i th problem
+     * is specified by \e lat1[\e i], \e lon1[\e i], \e lat2[\e i], \e
+     * lon2[\e i], for 0 &le; \e i &lt; \e n.  The output arrays which are not
+     * requested by \e outmask are not referenced and may be null pointers.
+     * The results are identical to those returned by Geodesic::Inverse.  The
+     * problems are divided between \e nthreads threads as described for
+     * Geodesic::GenInverseBatch.
+     **********************************************************************/
+    void InverseBatch(const real* lat1, const real* lon1,
+                      const real* lat2, const real* lon2, size_t n,
+                      real* s12, real* azi1, real* azi2,
+                      unsigned outmask = DISTANCE | AZIMUTH,
+                      int nthreads = 1) const {
+      GenInverseBatch(lat1, lon1, lat2, lon2, n,
+                      outmask & (DISTANCE | AZIMUTH),
+                      s12, azi1, azi2, 0, 0, 0, 0, 0, nthreads);
+    }
+
+    /**
+     * The general inverse geodesic calculation for many pairs of points.
+     * Geodesic::InverseBatch is defined in terms of this function.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The interpretation of \e outmask is the same as for
+     * Geodesic::GenInverse.  Output arrays not selected by \e outmask are not
+     * referenced and may be null pointers (both \e M12 and \e M21 are
+     * selected by Geodesic::GEODESICSCALE).  The arc length is always
+     * computed; it is stored in \e a12 if this is not a null pointer.  The
+     * results are identical to calling Geodesic::GenInverse \e n times.
+     *
+     * The problems are divided into \e nthreads contiguous ranges which are
+     * solved by Executor::Default() (concurrently, if the executor permits).
+     * If the library is compiled without C++11, all the work is done by the
+     * calling thread; in any case, the results do not depend on \e
+     * nthreads.  Within each range, the
+     * problems are taken in blocks of 64 and are sorted by the method used
+     * to solve them (meridional, equatorial, short, or Newton's method) so
+     * that successive problems follow the same path through the code.
+     **********************************************************************/
+    void GenInverseBatch(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2, size_t n,
+                         unsigned outmask,
+                         real* s12, real* azi1, real* azi2,
+                         real* m12, real* M12, real* M21, real* S12,
+                         real* a12, int nthreads = 1) const;
+    ///@}
+
+    /** \name Bounds on the distance.
+     **********************************************************************/
+    ///@{
+    /**
+     * Bound the geodesic distance between two points.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] lo a lower bound on \e s12 (meters).
+     * @param[out] hi an upper bound on \e s12 (meters).
+     *
+     * The bounds satisfy \e lo &le; \e s12 &le; \e hi where \e s12 is the
+     * distance returned by Geodesic::Inverse.  These are found without
+     * solving the inverse problem and cost about as much as a great circle
+     * calculation.  The ellipsoid is the image of a sphere of radius \e a,
+     * with the points at their reduced latitudes, under a scaling of its
+     * axis by \e b/\e a.  This scaling changes lengths by factors between 1
+     * and \e b/\e a; so the geodesic distance is bounded by multiples of
+     * the great circle distance on the sphere.  These bounds are tightened
+     * using the straight line distance between the points (a lower bound)
+     * and the change in the \e z coordinate.  The width of the interval is
+     * at most about |\e f| \e s12 and is zero for equatorial geodesics.  The
+     * bounds are widened slightly to allow for roundoff.
+     **********************************************************************/
+    void DistanceBounds(real lat1, real lon1, real lat2, real lon2,
+                        real& lo, real& hi) const;
+
+    /**
+     * Bound the geodesic distance between two prepared points.
+     *
+     * @param[in] p1 point 1.
+     * @param[in] p2 point 2.
+     * @param[out] lo a lower bound on \e s12 (meters).
+     * @param[out] hi an upper bound on \e s12 (meters).
+     *
+     * This is the same as Geodesic::DistanceBounds(real, real, real, real,
+     * real&, real&) const with the points specified as Geodesic::Point
+     * objects.
+     **********************************************************************/
+    void DistanceBounds(const Point& p1, const Point& p2,
+                        real& lo, real& hi) const {
+      IntDistanceBounds(p1._sbet, p1._cbet, p2._sbet, p2._cbet,
+                        Math::AngDiff(p1._lon, p2._lon), lo, hi);
+    }
+
+    /**
+     * Test whether two points are within a given distance.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] r the distance (meters).
+     * @return whether \e s12 &le; \e r.
+     *
+     * The result is the same as comparing the distance returned by
+     * Geodesic::Inverse with \e r; however the inverse problem is only
+     * solved if Geodesic::DistanceBounds doesn't decide the question.  The
+     * result is false if any of the arguments is a NaN.
+     **********************************************************************/
+    bool WithinDistance(real lat1, real lon1, real lat2, real lon2, real r)
+      const;
+
+    /**
+     * Test whether two prepared points are within a given distance.
+     *
+     * @param[in] p1 point 1.
+     * @param[in] p2 point 2.
+     * @param[in] r the distance (meters).
+     * @return whether \e s12 &le; \e r.
+     *
+     * This is the same as Geodesic::WithinDistance(real, real, real, real,
+     * real) const with the points specified as Geodesic::Point objects.
+     **********************************************************************/
+    bool WithinDistance(const Point& p1, const Point& p2, real r) const {
+      real lo, hi;
+      DistanceBounds(p1, p2, lo, hi);
+      if (hi <= r) return true;
+      if (!(lo <= r)) return false;
+      real s12, t;
+      GenInverse(p1, p2, DISTANCE, s12, t, t, t, t, t, t);
+      return s12 <= r;
+    }
+    ///@}
+
+    /** \name Bounding boxes of geodesic segments.
+     **********************************************************************/
+    ///@{
+    /**
+     * The bounding box of the shortest geodesic between two points.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] latmin the minimum latitude on the geodesic (degrees).
+     * @param[out] latmax the maximum latitude on the geodesic (degrees).
+     * @param[out] lonmin the longitude of the western end (degrees).
+     * @param[out] lonmax the longitude of the eastern end (degrees).
+     *
+     * This solves the inverse problem for the azimuths and then finds the
+     * range of latitudes with Geodesic::LatitudeRange.  The longitude
+     * varies monotonically along a geodesic, so its range is given by the
+     * ends; \e lonmin is in [&minus;180&deg;, 180&deg;) and \e lonmax =
+     * \e lonmin + |<i>lon12</i>|, where \e lon12 is the longitude difference
+     * returned by Geodesic::Inverse.  Thus \e lonmax &ge; 180&deg; indicates
+     * that the geodesic crosses the antimeridian.  A geodesic which passes
+     * over a pole has |<i>lon12</i>| = 180&deg; and \e latmax = 90&deg; (or
+     * \e latmin = &minus;90&deg;).
+     **********************************************************************/
+    void SegmentBounds(real lat1, real lon1, real lat2, real lon2,
+                       real& latmin, real& latmax,
+                       real& lonmin, real& lonmax) const;
+
+    /**
+     * The bounding boxes of many geodesic segments.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of segments.
+     * @param[out] latmin array of minimum latitudes (degrees).
+     * @param[out] latmax array of maximum latitudes (degrees).
+     * @param[out] lonmin array of longitudes of the western ends (degrees).
+     * @param[out] lonmax array of longitudes of the eastern ends (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling Geodesic::SegmentBounds \e n
+     * times.  The segments are divided between \e nthreads threads as
+     * described for Geodesic::GenInverseBatch.
+     **********************************************************************/
+    void SegmentBoundsBatch(const real* lat1, const real* lon1,
+                            const real* lat2, const real* lon2, size_t n,
+                            real* latmin, real* latmax,
+                            real* lonmin, real* lonmax,
+                            int nthreads = 1) const;
+
+    /**
+     * The range of latitudes on a geodesic segment with known azimuths.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] latmin the minimum latitude on the geodesic (degrees).
+     * @param[out] latmax the maximum latitude on the geodesic (degrees).
+     *
+     * The azimuths are those returned by the solution of the inverse (or
+     * direct) problem for the segment.  If the geodesic heads north at
+     * point 1 and south at point 2 it passes through its northern vertex,
+     * whose latitude is found analytically from Clairaut's relation (and
+     * similarly for the southern vertex); otherwise the extreme latitudes
+     * are at the ends.  This is useful when the inverse problem has already
+     * been solved for other reasons (for example to find the area).
+     **********************************************************************/
+    void LatitudeRange(real lat1, real azi1, real lat2, real azi2,
+                       real& latmin, real& latmax) const;
     ///@}
 
     /** \name Interface to GeodesicLine.
@@ -844,6 +1699,32 @@ namespace GeographicLib {
     GeodesicLine Line(real lat1, real lon1, real azi1, unsigned caps = ALL)
       const;
 
+    /**
+     * Set up to compute many geodesic lines.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] n the number of lines.
+     * @param[out] lines array of the GeodesicLine objects.
+     * @param[in] caps bitor'ed combination of Geodesic::mask values
+     *   specifying the capabilities the GeodesicLine objects should possess
+     *   (default Geodesic::ALL).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * <i>lines</i>[<i>i</i>] is set to Geodesic::Line(<i>lat1</i>[<i>i</i>],
+     * <i>lon1</i>[<i>i</i>], <i>azi1</i>[<i>i</i>], \e caps) and the
+     * resulting objects are identical to those.  The coefficients of the
+     * series, whose evaluation is a large part of the cost of constructing a
+     * GeodesicLine, are computed for blocks of lines at a time in loops which
+     * the compiler can vectorize; with \e caps = Geodesic::ALL, this is
+     * about 25% faster than calling Geodesic::Line.  The lines are divided
+     * between \e nthreads threads as described for Geodesic::GenDirectBatch.
+     **********************************************************************/
+    void LineBatch(const real* lat1, const real* lon1, const real* azi1,
+                   size_t n, GeodesicLine* lines, unsigned caps = ALL,
+                   int nthreads = 1) const;
+
     ///@}
 
     /** \name Inspector functions.
@@ -862,6 +1743,19 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real Flattening() const { return _f; }
 
+    /**
+     * @return the order of the series expansions.  This is the value used in
+     *   the constructor.
+     **********************************************************************/
+    int Order() const { return _nC; }
+
+    /**
+     * @return the maximum number of iterations of Newton's method (including
+     *   bisection steps) taken by Geodesic::GenInverse.  This depends on the
+     *   precision of Math::real; it is 83 for doubles.
+     **********************************************************************/
+    unsigned MaxIterations() const { return maxit2_; }
+
     /// \cond SKIP
     /**
      * <b>DEPRECATED</b>
@@ -883,9 +1777,38 @@ namespace GeographicLib {
     /**
      * A global instantiation of Geodesic with the parameters for the WGS84
      * ellipsoid.
+     *
+     * This object is constructed the first time WGS84() is called, so it
+     * imposes no cost at program startup.  In any case, constructing a
+     * Geodesic object is cheap: the coefficients of the series, which depend
+     * only on the flattening, are found by evaluating a few polynomials;
+     * this takes about one tenth of the time for a single solution of the
+     * inverse problem.  The work in solving the direct and inverse problems
+     * lies in evaluating the series which depend on the parameter \e eps
+     * for the particular geodesic, and this cannot be done in advance for a
+     * specific ellipsoid.
      **********************************************************************/
     static const Geodesic& WGS84();
 
+    /** \name Statistics for the inverse problem
+     **********************************************************************/
+    ///@{
+    /**
+     * Retrieve the statistics for the inverse problem for the calling thread.
+     *
+     * @param[out] stats the statistics; see Geodesic::InverseStats.
+     * @return true if the library was compiled with
+     *   GEOGRAPHICLIB_GEODESIC_STATS = 1; otherwise \e stats is set to zero
+     *   and false is returned.
+     **********************************************************************/
+    static bool GetInverseStats(InverseStats& stats);
+
+    /**
+     * Reset the statistics for the inverse problem for the calling thread.
+     **********************************************************************/
+    static void ResetInverseStats();
+    ///@}
+
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,166 @@
+/**
+ * \file GeodesicBuffer.hpp
+ * \brief Header for GeographicLib::GeodesicBuffer class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICBUFFER_HPP)
+#define GEOGRAPHICLIB_GEODESICBUFFER_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicIntersect.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The outlines of geodesic buffers around paths and polygons
+   *
+   * The buffer of distance \e D around a path (a sequence of geodesic
+   * segments) is the set of points whose geodesic distance from the path is
+   * no more than \e D; for a polygon, the buffer also includes the interior
+   * of the polygon.  These arise, for example, as airspace buffers and
+   * safety corridors.  This class computes the outlines of such buffers as
+   * geodesic polygons which approximate the true outlines to within a given
+   * tolerance.
+   *
+   * The outline consists of the curves at a distance \e D to the side of
+   * each segment (found by solving the direct geodesic problem perpendicular
+   * to the segment) joined by circular arcs of radius \e D centered at the
+   * vertices where the path turns away from that side (and at the ends of a
+   * path).  Where the path turns towards the side, the curves for the
+   * adjacent segments cross and are trimmed at their intersection.  The
+   * vertices of the curves and arcs are spaced so that the geodesics
+   * joining them depart from the true outline by no more than the
+   * tolerance; the spacing is determined using the geodesic curvature of
+   * the curves on a sphere of radius \e b (the smallest radius of curvature
+   * of the ellipsoid).
+   *
+   * The outline is returned as the vertices of a polygon traversed
+   * counter-clockwise and without repeating the first vertex; so passing
+   * the vertices to PolygonAreaT::AddPoint (or PolygonAreaT::AddPoints)
+   * gives the (positive) area of the buffer.  Only the intersections of the
+   * curves at the vertices of the path are removed; if the path comes
+   * within 2\e D of itself elsewhere (or if the segments adjoining a vertex
+   * are shorter than the trimmed parts of the curves), the outline will
+   * intersect itself.
+   *
+   * The perpendicular offsets for all the segments are computed together
+   * with Geodesic::GenDirectBatch (and so may be divided between several
+   * threads) and the arcs with Geodesic::DirectFan.  The member functions
+   * are const; so a single GeodesicBuffer object may be used concurrently
+   * by several threads.
+   *
+   * Example of use:
+   * \include example-GeodesicBuffer.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicBuffer {
+  private:
+    typedef Math::real real;
+    Geodesic _earth;
+    GeodesicIntersect _inter;
+    real _d, _tol, _ds, _dazi;
+    void Outline(const std::vector<real>& lat, const std::vector<real>& lon,
+                 bool path, std::vector<real>& blat, std::vector<real>& blon,
+                 int nthreads) const;
+    void Circle(real lat, real lon,
+                std::vector<real>& blat, std::vector<real>& blon) const;
+  public:
+
+    /**
+     * Constructor for GeodesicBuffer.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] distance the distance \e D of the buffer (meters).
+     * @param[in] tolerance the maximum distance between the returned
+     *   outline and the true outline (meters).
+     * @exception GeographicErr if \e distance is not positive or is not
+     *   less than &pi;\e b/2 (roughly a quarter meridian), or if \e
+     *   tolerance is not positive.
+     **********************************************************************/
+    GeodesicBuffer(const Geodesic& earth, real distance, real tolerance);
+
+    /**
+     * The outline of the buffer around a path.
+     *
+     * @param[in] lat array of the latitudes of the vertices of the path
+     *   (degrees).
+     * @param[in] lon array of the longitudes of the vertices of the path
+     *   (degrees).
+     * @param[in] n the number of vertices.
+     * @param[out] blat the latitudes of the vertices of the outline
+     *   (degrees).
+     * @param[out] blon the longitudes of the vertices of the outline
+     *   (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The path consists of the shortest geodesics between successive
+     * vertices.  Repeated vertices are ignored; if there's only one
+     * distinct vertex, the outline is a circle of radius \e D.  The ends of
+     * the path are capped with semicircles.  \e blat and \e blon are
+     * cleared if \e n = 0.
+     **********************************************************************/
+    void Polyline(const real lat[], const real lon[], size_t n,
+                  std::vector<real>& blat, std::vector<real>& blon,
+                  int nthreads = 1) const;
+
+    /**
+     * The outline of the buffer around a polygon.
+     *
+     * @param[in] lat array of the latitudes of the vertices of the polygon
+     *   (degrees).
+     * @param[in] lon array of the longitudes of the vertices of the polygon
+     *   (degrees).
+     * @param[in] n the number of vertices.
+     * @param[out] blat the latitudes of the vertices of the outline
+     *   (degrees).
+     * @param[out] blon the longitudes of the vertices of the outline
+     *   (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The polygon is closed by the geodesic from the last vertex to the first
+     * (which should not be repeated) and may be traversed in either
+     * direction; it should not intersect itself.  The outline surrounds the
+     * polygon at a distance \e D.  Polygons with fewer than 3 distinct
+     * vertices are treated as paths.
+     **********************************************************************/
+    void Polygon(const real lat[], const real lon[], size_t n,
+                 std::vector<real>& blat, std::vector<real>& blon,
+                 int nthreads = 1) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e D the distance of the buffer (meters).  This is the value
+     *   used in the constructor.
+     **********************************************************************/
+    Math::real Distance() const { return _d; }
+
+    /**
+     * @return the tolerance for the outline (meters).  This is the value
+     *   used in the constructor.
+     **********************************************************************/
+    Math::real Tolerance() const { return _tol; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _earth.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICBUFFER_HPP
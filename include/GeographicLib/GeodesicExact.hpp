@@ -105,6 +105,7 @@ namespace GeographicLib {
 
     real _a, _f, _f1, _e2, _ep2, _n, _b, _c2, _etol2;
     real _C4x[nC4x_];
+    int _nC4;                   // the order of the C4 expansion used
 
     void Lengths(const EllipticFunction& E,
                  real sig12,
@@ -131,14 +132,6 @@ namespace GeographicLib {
     // the integrals for the area.
     void C4coeff();
     void C4f(real k2, real c[]) const;
-    // Large coefficients are split so that lo contains the low 52 bits and hi
-    // the rest.  This choice avoids double rounding with doubles and higher
-    // precision types.  float coefficients will suffer double rounding;
-    // however the accuracy is already lousy for floats.
-    static Math::real inline reale(long long hi, long long lo) {
-      using std::ldexp;
-      return ldexp(real(hi), 52) + lo;
-    }
 
   public:
 
@@ -228,10 +221,29 @@ namespace GeographicLib {
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
      *   flattening to 1/\e f.
+     * @param[in] order the order of the series expansion for the area
+     *   (default GEOGRAPHICLIB_GEODESICEXACT_ORDER).
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
-     **********************************************************************/
-    GeodesicExact(real a, real f);
+     * @exception GeographicErr if \e order is not in [6,
+     *   GEOGRAPHICLIB_GEODESICEXACT_ORDER].
+     *
+     * The distances and positions are computed exactly (in terms of elliptic
+     * integrals) and are not affected by \e order; only the area \e S12 is
+     * given by a series.  Setting \e order to a value less than
+     * GEOGRAPHICLIB_GEODESICEXACT_ORDER truncates this series, which makes
+     * the setup of the coefficients (in the constructor) and their
+     * evaluation for each geodesic cheaper.  The truncation error in the
+     * area scales as <i>n</i><sup><i>order</i></sup>, where \e n is the
+     * third flattening; for |\e f| &le; 0.05, \e order = 12 gives areas
+     * which are accurate to round-off in double precision.  With this
+     * setting, the constructor is about 5 times faster; however the
+     * solution of the inverse problem with the area is only a few percent
+     * faster, because its cost is dominated by the elliptic integrals.
+     * GeodesicLineExact objects created from this object use the same order.
+     **********************************************************************/
+    GeodesicExact(real a, real f,
+                  int order = GEOGRAPHICLIB_GEODESICEXACT_ORDER);
     ///@}
 
     /** \name Direct geodesic problem specified in terms of distance.
@@ -692,6 +704,80 @@ namespace GeographicLib {
       const;
     ///@}
 
+    /** \name Inverse geodesic problem for arrays of points.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse geodesic problem for many pairs of points.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[out] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::DISTANCE
+     *   and GeodesicExact::AZIMUTH specifying which of the output arrays
+     *   should be set; default GeodesicExact::DISTANCE |
+     *   GeodesicExact::AZIMUTH.
+     *
+     * The input arrays are in "structure of arrays" form; the \e i th problem
+     * is specified by \e lat1[\e i], \e lon1[\e i], \e lat2[\e i], \e
+     * lon2[\e i], for 0 &le; \e i &lt; \e n.  The output arrays which are not
+     * requested by \e outmask are not referenced and may be null pointers.
+     * The results are identical to those returned by GeodesicExact::Inverse.
+     **********************************************************************/
+    void InverseBatch(const real* lat1, const real* lon1,
+                      const real* lat2, const real* lon2, size_t n,
+                      real* s12, real* azi1, real* azi2,
+                      unsigned outmask = DISTANCE | AZIMUTH) const {
+      GenInverseBatch(lat1, lon1, lat2, lon2, n,
+                      outmask & (DISTANCE | AZIMUTH),
+                      s12, azi1, azi2, 0, 0, 0, 0, 0);
+    }
+
+    /**
+     * The general inverse geodesic calculation for many pairs of points.
+     * GeodesicExact::InverseBatch is defined in terms of this function.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     *
+     * The interpretation of \e outmask is the same as for
+     * GeodesicExact::GenInverse.  Output arrays not selected by \e outmask
+     * are not referenced and may be null pointers (both \e M12 and \e M21
+     * are selected by GeodesicExact::GEODESICSCALE).  The arc length is
+     * always computed; it is stored in \e a12 if this is not a null pointer.
+     * The results are identical to calling GeodesicExact::GenInverse \e n
+     * times.
+     **********************************************************************/
+    void GenInverseBatch(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2, size_t n,
+                         unsigned outmask,
+                         real* s12, real* azi1, real* azi2,
+                         real* m12, real* M12, real* M21, real* S12,
+                         real* a12) const;
+    ///@}
+
     /** \name Interface to GeodesicLineExact.
      **********************************************************************/
     ///@{
@@ -755,6 +841,12 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real Flattening() const { return _f; }
 
+    /**
+     * @return the order of the series expansion for the area.  This is the
+     *   value used in the constructor.
+     **********************************************************************/
+    int Order() const { return _nC4; }
+
     /// \cond SKIP
     /**
      * <b>DEPRECATED</b>
@@ -779,6 +871,30 @@ namespace GeographicLib {
      **********************************************************************/
     static const GeodesicExact& WGS84();
 
+    /**
+     * Return a GeodesicExact object for a given ellipsoid from a global cache.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     * @return a reference to a GeodesicExact object equivalent to
+     *   GeodesicExact(\e a, \e f).
+     *
+     * Constructing a GeodesicExact object entails evaluating the coefficients
+     * for the area series; this costs about half as much as solving an
+     * inverse problem.  If an application switches frequently between a set
+     * of ellipsoids (e.g., for different planetary bodies), this can be
+     * avoided by using this function.  The object for a given (\e a, \e f)
+     * is constructed on the first call and the same object is returned on
+     * subsequent calls with the same (\e a, \e f); the matching is exact.
+     * The objects are never deleted (so the references remain valid for the
+     * duration of the program); thus this function should only be used for a
+     * modest number of distinct ellipsoids.  If the library was compiled with
+     * C++11 support, it is safe to call this function from several threads.
+     **********************************************************************/
+    static const GeodesicExact& Cached(real a, real f);
+
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,212 @@
+/**
+ * \file GeodesicIndex.hpp
+ * \brief Header for GeographicLib::GeodesicIndex class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICINDEX_HPP)
+#define GEOGRAPHICLIB_GEODESICINDEX_HPP 1
+
+#include <vector>
+#include <utility>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Geocentric.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Nearest neighbor and radius searches with geodesic distances
+   *
+   * Hold a set of \e n points on the ellipsoid and find the points which are
+   * nearest to, or within a given distance of, a query point, where the
+   * distance is the length of the shortest geodesic.  The distances are
+   * those returned by Geodesic::GenInverse and the results are the same as
+   * would be found by computing the distances to all the points; however
+   * only the distances to a few of the points need to be computed.
+   *
+   * The points are held in a <i>k</i>-d tree in geocentric coordinates
+   * (the points are on the surface of the ellipsoid, \e h = 0), where the
+   * nodes of the tree are the bounding boxes of their points.  The distance
+   * in three dimensions from the query point to a box is a lower bound on
+   * the geodesic distance to any of its points (because the straight line
+   * between two points is shorter than any path on the surface); so the
+   * boxes which can't include a result are skipped.  Within a leaf of the
+   * tree, the straight line distance to each point is used in the same way
+   * and the geodesic distance is only computed for the points which survive
+   * this test.  For short distances, the straight line distance is very
+   * close to the geodesic distance, so that few geodesic distances are
+   * computed needlessly.  (If the library is configured with
+   * GEOGRAPHICLIB_INSTRUMENTATION = ON, the number of geodesic distances
+   * computed is recorded in Instrumentation::GEODESICINDEX_INVERSE.)
+   *
+   * If several points are at the same distance from the query point, they
+   * are ordered by their index.  Thus the results don't depend on the
+   * structure of the tree.  Points whose latitude or longitude is a NaN are
+   * never returned.
+   *
+   * The member functions are const and thread safe and
+   * GeodesicIndex::Nearest does not allocate memory.
+   * GeodesicIndex::NearestBatch performs many queries, optionally dividing
+   * them among several threads.
+   *
+   * Example of use:
+   * \include example-GeodesicIndex.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicIndex {
+  private:
+    typedef Math::real real;
+    // The maximum number of points in a leaf.
+    static const size_t leafsize_ = 8;
+    struct Node {
+      real lo[3], hi[3];        // The bounding box
+      size_t i0, i1;            // The points are [i0, i1)
+      size_t left, right;       // The children (0 for a leaf)
+    };
+    Geodesic _earth;
+    Geocentric _cart;
+    size_t _n;
+    // The slack, relative and absolute, applied to the lower bounds to
+    // account for roundoff.
+    real _tol, _slack;
+    // The points in tree order, their geocentric coordinates, and their
+    // indices.
+    std::vector<Geodesic::Point> _pts;
+    std::vector<real> _xyz;
+    std::vector<size_t> _ind;
+    std::vector<Node> _nodes;
+
+    size_t Build(size_t i0, size_t i1);
+    real Bound(const Node& node, const real q[]) const;
+    real Chord(size_t i, const real q[]) const;
+    real Distance(const Geodesic::Point& p, size_t i) const;
+    void NearestNode(size_t k, const Geodesic::Point& p, const real q[],
+                     size_t m, size_t& count,
+                     size_t ind[], real s12[]) const;
+    void WithinNode(size_t k, const Geodesic::Point& p, const real q[],
+                    real r, std::vector<std::pair<real, size_t> >& res)
+      const;
+    void NearestRange(const real lat[], const real lon[], size_t i0,
+                      size_t i1, size_t m, size_t ind[], real s12[]) const;
+  public:
+
+    /**
+     * Constructor for GeodesicIndex.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @exception std::bad_alloc if the memory for the tree can't be
+     *   allocated.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;] and \e lon
+     * should be in the range [&minus;540&deg;, 540&deg;).  The points are
+     * identified by their index in these arrays (0 to \e n &minus; 1), which
+     * are not referenced after the constructor returns.  Building the tree
+     * takes a time proportional to \e n log \e n.
+     **********************************************************************/
+    GeodesicIndex(const Geodesic& earth,
+                  const real lat[], const real lon[], size_t n);
+
+    /**
+     * Find the nearest points.
+     *
+     * @param[in] lat latitude of the query point (degrees).
+     * @param[in] lon longitude of the query point (degrees).
+     * @param[in] m the number of points sought.
+     * @param[out] ind array of the indices of the points.
+     * @param[out] s12 array of the distances to the points (meters).
+     * @return the number of points found, min(\e m, <i>n</i><sub>1</sub>),
+     *   where <i>n</i><sub>1</sub> is the number of points in the index
+     *   (excluding those with NaNs).
+     *
+     * \e ind and \e s12 must have room for \e m elements; the points are
+     * returned in order of increasing distance.  If \e lat or \e lon is a
+     * NaN, no points are found.  No memory is allocated.
+     **********************************************************************/
+    size_t Nearest(real lat, real lon, size_t m,
+                   size_t ind[], real s12[]) const;
+
+    /**
+     * Find the points within a given distance.
+     *
+     * @param[in] lat latitude of the query point (degrees).
+     * @param[in] lon longitude of the query point (degrees).
+     * @param[in] r the maximum distance (meters).
+     * @param[out] ind the indices of the points.
+     * @param[out] s12 the distances to the points (meters).
+     * @return the number of points found.
+     * @exception std::bad_alloc if the memory for the results can't be
+     *   allocated.
+     *
+     * The points with distance \e s12 &le; \e r are returned in \e ind and
+     * \e s12 (which are resized as needed) in order of increasing distance.
+     * If \e lat, \e lon, or \e r is a NaN, no points are found.
+     **********************************************************************/
+    size_t Within(real lat, real lon, real r,
+                  std::vector<size_t>& ind, std::vector<real>& s12) const;
+
+    /**
+     * Find the nearest points to many query points.
+     *
+     * @param[in] lat array of latitudes of the query points (degrees).
+     * @param[in] lon array of longitudes of the query points (degrees).
+     * @param[in] n the number of query points.
+     * @param[in] m the number of points sought for each query point.
+     * @param[out] ind array of the indices of the points.
+     * @param[out] s12 array of the distances to the points (meters).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results for query point \e i are stored in <i>ind</i>[<i>i</i>
+     * <i>m</i> + <i>j</i>] and <i>s12</i>[<i>i</i> <i>m</i> + <i>j</i>] for
+     * 0 &le; \e j &lt; \e m, as for GeodesicIndex::Nearest; if fewer than
+     * \e m points are found, the remaining elements of \e ind are set to
+     * GeodesicIndex::NumPoints() and those of \e s12 to NaN.  The query
+     * points are divided into \e nthreads contiguous ranges which are run
+     * by Executor::Default() (concurrently, if the executor permits).  If
+     * the library is compiled without C++11, all the work is done by the
+     * calling thread; in any case, the results are the same.
+     **********************************************************************/
+    void NearestBatch(const real lat[], const real lon[], size_t n, size_t m,
+                      size_t ind[], real s12[], int nthreads = 1) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e n the number of points given to the constructor.
+     **********************************************************************/
+    size_t NumPoints() const { return _n; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _earth.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEODESICINDEX_HPP
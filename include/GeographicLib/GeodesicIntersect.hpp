@@ -0,0 +1,273 @@
+/**
+ * \file GeodesicIntersect.hpp
+ * \brief Header for GeographicLib::GeodesicIntersect class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICINTERSECT_HPP)
+#define GEOGRAPHICLIB_GEODESICINTERSECT_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Gnomonic.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Intersections of geodesics and nearest points on geodesics
+   *
+   * Solve two problems which often arise in navigation:
+   * - the intersection of two geodesics, each specified by two points;
+   * - the point on a geodesic, specified by two points, which is closest to
+   *   a given point.
+   * .
+   * The geodesics may be treated as lines (i.e., extended indefinitely
+   * beyond the two points) or as segments between the points.
+   *
+   * Both problems are solved iteratively using the Gnomonic projection in
+   * which geodesics through the center of the projection appear as straight
+   * lines and other geodesics are nearly straight.  Starting with a guess
+   * for the solution, the points are projected with the guess as the
+   * center, the problem is solved in the plane (the intersection of two
+   * straight lines or the foot of a perpendicular on a straight line), and
+   * the resulting point is mapped back to the ellipsoid to give the next
+   * guess.  The iteration stops when the planar solution is within a
+   * distance of 0.01 sqrt(&epsilon;) \e a of the center, where &epsilon; is
+   * the machine precision; since the error of the planar solution decreases
+   * rapidly as the center approaches the solution, this gives results
+   * accurate to a few nanometers (provided, in the case of intersections,
+   * that the geodesics are not nearly parallel).  Typically between 2 and 4
+   * iterations are needed.
+   *
+   * The gnomonic projection is only defined for points less than a quarter
+   * meridian (roughly) from the center; so the points defining the
+   * geodesics should be within about 10000 km of the solution.  If the
+   * iteration fails then NaNs are returned.  Whereas two great circles
+   * intersect in two antipodal points, the intersection nearest the initial
+   * guess (the centroid of the four points) is returned here.
+   *
+   * GeodesicIntersect::SegmentIntersect first checks (without iterating)
+   * whether the two segments can possibly intersect: each segment lies in a
+   * ball, centered at its first point, whose radius is the length of the
+   * segment; if the distance between the first points (measured along a
+   * straight line through the ellipsoid) exceeds the sum of the lengths, the
+   * segments do not intersect.  This early exit makes the test for pairs of
+   * distant segments, the common case in conflict detection, cheap.
+   *
+   * The batch functions GeodesicIntersect::SegmentIntersectBatch and
+   * GeodesicIntersect::NearestBatch are defined in the header; if your code
+   * is compiled with OpenMP support, the computations are distributed among
+   * the OpenMP threads.  All the member functions are const and so a single
+   * GeodesicIntersect object may be used concurrently by several threads.
+   *
+   * Example of use:
+   * \include example-GeodesicIntersect.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicIntersect {
+  private:
+    typedef Math::real real;
+    real eps_;
+    Geodesic _earth;
+    Gnomonic _gnom;
+    real _a, _e2;
+    static const int maxit_ = 20;
+    void Cartesian(real lat, real lon, real r[]) const;
+    real Chord(real lat1, real lon1, real lat2, real lon2) const;
+    bool Solve(const real lat[], const real lon[],
+               real& lat0, real& lon0, real x[], real y[]) const;
+    static real Centroid(const real lon[], int n);
+  public:
+
+    /**
+     * Constructor for GeodesicIntersect.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     *   By default this uses the WGS84 ellipsoid.
+     **********************************************************************/
+    explicit GeodesicIntersect(const Geodesic& earth = Geodesic::WGS84());
+
+    /**
+     * The intersection of two geodesic lines.
+     *
+     * @param[in] latA1 latitude of the first point on line \e A (degrees).
+     * @param[in] lonA1 longitude of the first point on line \e A (degrees).
+     * @param[in] latA2 latitude of the second point on line \e A (degrees).
+     * @param[in] lonA2 longitude of the second point on line \e A (degrees).
+     * @param[in] latB1 latitude of the first point on line \e B (degrees).
+     * @param[in] lonB1 longitude of the first point on line \e B (degrees).
+     * @param[in] latB2 latitude of the second point on line \e B (degrees).
+     * @param[in] lonB2 longitude of the second point on line \e B (degrees).
+     * @param[out] lat latitude of the intersection (degrees).
+     * @param[out] lon longitude of the intersection (degrees).
+     * @return true if the iteration converged.
+     *
+     * The latitudes should be in the range [&minus;90&deg;, 90&deg;].  The
+     * lines are extended beyond the given points, if necessary.  If the
+     * iteration fails (e.g., because the lines are parallel or the
+     * intersection is too far from the given points), NaNs are returned for
+     * \e lat and \e lon.  \e lon will be in the range [&minus;180&deg;,
+     * 180&deg;).
+     **********************************************************************/
+    bool Intersect(real latA1, real lonA1, real latA2, real lonA2,
+                   real latB1, real lonB1, real latB2, real lonB2,
+                   real& lat, real& lon) const;
+
+    /**
+     * The intersection of two geodesic segments.
+     *
+     * @param[in] latA1 latitude of the first end of segment \e A (degrees).
+     * @param[in] lonA1 longitude of the first end of segment \e A (degrees).
+     * @param[in] latA2 latitude of the second end of segment \e A (degrees).
+     * @param[in] lonA2 longitude of the second end of segment \e A (degrees).
+     * @param[in] latB1 latitude of the first end of segment \e B (degrees).
+     * @param[in] lonB1 longitude of the first end of segment \e B (degrees).
+     * @param[in] latB2 latitude of the second end of segment \e B (degrees).
+     * @param[in] lonB2 longitude of the second end of segment \e B (degrees).
+     * @param[out] lat latitude of the intersection (degrees).
+     * @param[out] lon longitude of the intersection (degrees).
+     * @return true if the segments intersect.
+     *
+     * If the segments do not intersect, NaNs are returned for \e lat and \e
+     * lon.  The segments are the shortest geodesics between their ends; they
+     * are considered to intersect if the point of intersection lies on both
+     * segments (including their ends).
+     **********************************************************************/
+    bool SegmentIntersect(real latA1, real lonA1, real latA2, real lonA2,
+                          real latB1, real lonB1, real latB2, real lonB2,
+                          real& lat, real& lon) const;
+
+    /**
+     * The intersections of many pairs of geodesic segments.
+     *
+     * @param[in] latA1 array of latitudes of the first ends of the segments
+     *   \e A (degrees).
+     * @param[in] lonA1 array of longitudes of the first ends of the segments
+     *   \e A (degrees).
+     * @param[in] latA2 array of latitudes of the second ends of the segments
+     *   \e A (degrees).
+     * @param[in] lonA2 array of longitudes of the second ends of the segments
+     *   \e A (degrees).
+     * @param[in] latB1 array of latitudes of the first ends of the segments
+     *   \e B (degrees).
+     * @param[in] lonB1 array of longitudes of the first ends of the segments
+     *   \e B (degrees).
+     * @param[in] latB2 array of latitudes of the second ends of the segments
+     *   \e B (degrees).
+     * @param[in] lonB2 array of longitudes of the second ends of the segments
+     *   \e B (degrees).
+     * @param[in] n the number of pairs of segments.
+     * @param[out] lat array of latitudes of the intersections (degrees).
+     * @param[out] lon array of longitudes of the intersections (degrees).
+     * @return the number of pairs of segments which intersect.
+     *
+     * This calls GeodesicIntersect::SegmentIntersect for each pair (\e A[\e
+     * i], \e B[\e i]); NaNs are returned for the pairs which don't intersect.
+     * If the calling code is compiled with OpenMP, the pairs are computed in
+     * parallel.
+     **********************************************************************/
+    size_t SegmentIntersectBatch(const real latA1[], const real lonA1[],
+                                 const real latA2[], const real lonA2[],
+                                 const real latB1[], const real lonB1[],
+                                 const real latB2[], const real lonB2[],
+                                 size_t n, real lat[], real lon[]) const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long m = long(n), count = 0;
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 64) reduction(+:count)
+#endif
+      for (long i = 0; i < m; ++i)
+        if (SegmentIntersect(latA1[i], lonA1[i], latA2[i], lonA2[i],
+                             latB1[i], lonB1[i], latB2[i], lonB2[i],
+                             lat[i], lon[i]))
+          ++count;
+      return size_t(count);
+    }
+
+    /**
+     * The point on a geodesic closest to a given point.
+     *
+     * @param[in] lat1 latitude of the first point on the geodesic (degrees).
+     * @param[in] lon1 longitude of the first point on the geodesic (degrees).
+     * @param[in] lat2 latitude of the second point on the geodesic (degrees).
+     * @param[in] lon2 longitude of the second point on the geodesic
+     *   (degrees).
+     * @param[in] lat latitude of the given point (degrees).
+     * @param[in] lon longitude of the given point (degrees).
+     * @param[in] segment if true restrict the result to the segment between
+     *   points 1 and 2; otherwise consider the whole line through these
+     *   points.
+     * @param[out] latn latitude of the closest point (degrees).
+     * @param[out] lonn longitude of the closest point (degrees).
+     * @return the distance from the given point to the closest point
+     *   (meters).
+     *
+     * For a line, the geodesic from the given point to the closest point
+     * meets the line at right angles.  For a segment, the closest point may
+     * be one of the ends.  If the iteration fails, NaNs are returned.
+     **********************************************************************/
+    Math::real Nearest(real lat1, real lon1, real lat2, real lon2,
+                       real lat, real lon, bool segment,
+                       real& latn, real& lonn) const;
+
+    /**
+     * The points on a geodesic closest to many given points.
+     *
+     * @param[in] lat1 latitude of the first point on the geodesic (degrees).
+     * @param[in] lon1 longitude of the first point on the geodesic (degrees).
+     * @param[in] lat2 latitude of the second point on the geodesic (degrees).
+     * @param[in] lon2 longitude of the second point on the geodesic
+     *   (degrees).
+     * @param[in] lat array of latitudes of the given points (degrees).
+     * @param[in] lon array of longitudes of the given points (degrees).
+     * @param[in] n the number of given points.
+     * @param[in] segment if true restrict the results to the segment between
+     *   points 1 and 2.
+     * @param[out] latn array of latitudes of the closest points (degrees).
+     * @param[out] lonn array of longitudes of the closest points (degrees).
+     * @param[out] s array of distances from the given points to the closest
+     *   points (meters).
+     *
+     * This calls GeodesicIntersect::Nearest for each point.  \e s may be a
+     * null pointer (the default).  If the calling code is compiled with
+     * OpenMP, the points are computed in parallel.
+     **********************************************************************/
+    void NearestBatch(real lat1, real lon1, real lat2, real lon2,
+                      const real lat[], const real lon[], size_t n,
+                      bool segment, real latn[], real lonn[], real s[] = 0)
+      const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long m = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (long i = 0; i < m; ++i) {
+        real d = Nearest(lat1, lon1, lat2, lon2, lat[i], lon[i], segment,
+                         latn[i], lonn[i]);
+        if (s) s[i] = d;
+      }
+    }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _earth.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICINTERSECT_HPP
@@ -67,6 +67,7 @@ namespace GeographicLib {
     static const int nC4_ = Geodesic::nC4_;
 
     real tiny_;
+    int _nC;                    // the order of the expansions used
     real _lat1, _lon1, _azi1;
     real _a, _f, _b, _c2, _f1, _salp0, _calp0, _k2,
       _salp1, _calp1, _ssig1, _csig1, _dn1, _stau1, _ctau1, _somg1, _comg1,
@@ -88,6 +89,18 @@ namespace GeographicLib {
       OUT_ALL  = Geodesic::OUT_ALL,
       OUT_MASK = Geodesic::OUT_MASK,
     };
+
+    // Set _B11, _B21, etc., once the coefficients of the series are known.
+    void InitSums(const Geodesic& g);
+    void DistanceToArc(real s12, real stau12, real ctau12,
+                       real& sig12, real& ssig12, real& csig12,
+                       real& B12) const;
+    real GenPosition(bool arcmode, real s12_a12,
+                     real sig12, real ssig12, real csig12, real B12,
+                     unsigned outmask,
+                     real& lat2, real& lon2, real& azi2,
+                     real& s12, real& m12, real& M12, real& M21,
+                     real& S12) const;
   public:
 
     /**
@@ -528,6 +541,258 @@ namespace GeographicLib {
 
     ///@}
 
+    /** \name Positions for arrays of distances or arc lengths
+     **********************************************************************/
+    ///@{
+    /**
+     * Compute the positions of many points on the geodesic given their
+     * distances from point 1.
+     *
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::LATITUDE,
+     *   GeodesicLine::LONGITUDE, GeodesicLine::AZIMUTH, and
+     *   GeodesicLine::LONG_UNROLL specifying which of the output arrays
+     *   should be set (default all three arrays).
+     *
+     * The GeodesicLine object must have been constructed with \e caps |=
+     * GeodesicLine::DISTANCE_IN.  Output arrays not selected by \e outmask
+     * are not referenced and may be null pointers.  The results are identical
+     * to calling GeodesicLine::Position \e n times.
+     **********************************************************************/
+    void Positions(const real* s12, size_t n,
+                   real* lat2, real* lon2, real* azi2,
+                   unsigned outmask = LATITUDE | LONGITUDE | AZIMUTH) const {
+      GenPositions(false, s12, n,
+                   outmask & (LATITUDE | LONGITUDE | AZIMUTH | LONG_UNROLL),
+                   lat2, lon2, azi2, 0, 0, 0, 0, 0, 0);
+    }
+
+    /**
+     * Compute the positions of many points on the geodesic given their arc
+     * lengths from point 1.
+     *
+     * @param[in] a12 array of arc lengths from point 1 (degrees).
+     * @param[in] n the number of points.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::LATITUDE,
+     *   GeodesicLine::LONGITUDE, GeodesicLine::AZIMUTH, and
+     *   GeodesicLine::LONG_UNROLL specifying which of the output arrays
+     *   should be set (default all three arrays).
+     *
+     * Output arrays not selected by \e outmask are not referenced and may be
+     * null pointers.  The results are identical to calling
+     * GeodesicLine::ArcPosition \e n times.
+     **********************************************************************/
+    void ArcPositions(const real* a12, size_t n,
+                      real* lat2, real* lon2, real* azi2,
+                      unsigned outmask = LATITUDE | LONGITUDE | AZIMUTH)
+      const {
+      GenPositions(true, a12, n,
+                   outmask & (LATITUDE | LONGITUDE | AZIMUTH | LONG_UNROLL),
+                   lat2, lon2, azi2, 0, 0, 0, 0, 0, 0);
+    }
+
+    /**
+     * The general position function for many points.
+     * GeodesicLine::Positions and GeodesicLine::ArcPositions are defined in
+     * terms of this function.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) if \e arcmode is false
+     *   or of arc lengths (degrees) if \e arcmode is true.
+     * @param[in] n the number of points.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesic
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     *
+     * The interpretation of \e outmask and the requirements on the
+     * capabilities of the GeodesicLine object are the same as for
+     * GeodesicLine::GenPosition.  Output arrays not selected by \e outmask
+     * (or which the GeodesicLine object is not capable of computing) are not
+     * referenced and may be null pointers (both \e M12 and \e M21 are
+     * selected by GeodesicLine::GEODESICSCALE).  The arc length is always
+     * computed; it is stored in \e a12 if this is not a null pointer.  The
+     * results are identical to calling GeodesicLine::GenPosition \e n times.
+     **********************************************************************/
+    void GenPositions(bool arcmode, const real* s12_a12, size_t n,
+                      unsigned outmask,
+                      real* lat2, real* lon2, real* azi2,
+                      real* s12, real* m12, real* M12, real* M21,
+                      real* S12, real* a12) const;
+
+    /**
+     * Compute the positions of equally spaced points on the geodesic, with
+     * arc lengths \e a12 + \e i \e da12 from point 1, for 0 &le; \e i &lt;
+     * \e n.
+     *
+     * @param[in] a12 the arc length from point 1 to the first point
+     *   (degrees).
+     * @param[in] da12 the arc length between successive points (degrees).
+     * @param[in] n the number of points.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesic
+     *   (meters<sup>2</sup>).
+     *
+     * This is the fastest way of densifying a geodesic.  The sine and cosine
+     * of the arc length are updated using the angle-addition formulas instead
+     * of being evaluated afresh for each point; the evaluation is restarted
+     * every 16 points to limit the accumulation of round-off errors.  As a
+     * result, the results differ slightly from those given by
+     * GeodesicLine::ArcPosition (by up to a few tens of nanometers in
+     * position for the WGS84 ellipsoid).  This is about 25% faster than
+     * calling GeodesicLine::ArcPosition for each point.  Output arrays are
+     * treated as in GeodesicLine::GenPositions.
+     **********************************************************************/
+    void UniformArcPositions(real a12, real da12, size_t n, unsigned outmask,
+                             real* lat2, real* lon2, real* azi2,
+                             real* s12 = 0, real* m12 = 0,
+                             real* M12 = 0, real* M21 = 0,
+                             real* S12 = 0) const;
+    ///@}
+
+    /**
+     * \brief Generate equally spaced points on a geodesic line
+     *
+     * This is returned by GeodesicLine::Densify.  Each call to
+     * GeodesicLine::Densifier::Next returns the next point.  The sine and
+     * cosine of the spacing are computed once and the sine and cosine of the
+     * position on the auxiliary sphere are updated using the angle-addition
+     * formulas (being evaluated afresh every 16 points to limit the
+     * accumulation of round-off errors).  As a result, the positions differ
+     * from those given by GeodesicLine::Position or GeodesicLine::ArcPosition
+     * by up to a few tens of nanometers.  No memory is allocated.
+     *
+     * A Densifier refers to the GeodesicLine which created it which must,
+     * therefore, outlive it.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Densifier {
+    private:
+      friend class GeodesicLine;
+      const GeodesicLine* _line;
+      bool _arcmode;
+      real _step, _dang, _sdang, _cdang, _sang, _cang;
+      size_t _maxpoints, _count;
+      Densifier(const GeodesicLine* line, real step, size_t maxpoints,
+                bool arcmode);
+    public:
+      /**
+       * Return the next point.
+       *
+       * @param[out] lat2 latitude of the point (degrees).
+       * @param[out] lon2 longitude of the point (degrees).
+       * @return false if there are no more points (in this case, \e lat2
+       *   and \e lon2 are not set).
+       **********************************************************************/
+      bool Next(real& lat2, real& lon2) {
+        real t;
+        return GenNext(Geodesic::LATITUDE | Geodesic::LONGITUDE,
+                       lat2, lon2, t, t);
+      }
+
+      /**
+       * Return the next point and the azimuth there.
+       *
+       * @param[out] lat2 latitude of the point (degrees).
+       * @param[out] lon2 longitude of the point (degrees).
+       * @param[out] azi2 (forward) azimuth at the point (degrees).
+       * @return false if there are no more points (in this case, the
+       *   arguments are not set).
+       **********************************************************************/
+      bool Next(real& lat2, real& lon2, real& azi2) {
+        real t;
+        return GenNext(Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                       Geodesic::AZIMUTH, lat2, lon2, azi2, t);
+      }
+
+      /**
+       * The general function for returning the next point.
+       *
+       * @param[in] outmask a bitor'ed combination of GeodesicLine::LATITUDE,
+       *   GeodesicLine::LONGITUDE, GeodesicLine::AZIMUTH,
+       *   GeodesicLine::DISTANCE, and GeodesicLine::LONG_UNROLL specifying
+       *   which of the following parameters should be set.
+       * @param[out] lat2 latitude of the point (degrees).
+       * @param[out] lon2 longitude of the point (degrees).
+       * @param[out] azi2 (forward) azimuth at the point (degrees).
+       * @param[out] s12 distance from point 1 to the point (meters).
+       * @return false if there are no more points.
+       *
+       * In distance mode, \e s12 is set to its nominal value, \e i
+       * &times; \e step.
+       **********************************************************************/
+      bool GenNext(unsigned outmask,
+                   real& lat2, real& lon2, real& azi2, real& s12);
+
+      /**
+       * Restart the sequence of points at point 1.
+       **********************************************************************/
+      void Reset() { _count = 0; }
+
+      /**
+       * @return the number of points which have been returned.
+       **********************************************************************/
+      size_t Count() const { return _count; }
+
+      /**
+       * @return the total number of points which will be returned.
+       **********************************************************************/
+      size_t MaxPoints() const { return _maxpoints; }
+
+      /**
+       * @return the spacing of the points (meters or degrees).
+       **********************************************************************/
+      Math::real Step() const { return _step; }
+    };
+
+    /**
+     * Generate equally spaced points on the geodesic.
+     *
+     * @param[in] step the spacing of the points; this is a distance (meters)
+     *   if \e arcmode is false and an arc length (degrees) if \e arcmode is
+     *   true.
+     * @param[in] maxpoints the number of points to be generated.
+     * @param[in] arcmode whether \e step is an arc length (default false).
+     * @return a GeodesicLine::Densifier which generates the points.
+     *
+     * The points are those at \e i &times; \e step from point 1, for 0 &le;
+     * \e i &lt; \e maxpoints; the first point is point 1 itself.  Thus, to
+     * densify an edge of length \e s12 with \e n points, including both
+     * ends, use \e step = \e s12 / (\e n &minus; 1) and \e maxpoints = \e
+     * n.  No points are generated if the GeodesicLine object is not
+     * initialized or if \e arcmode is false and the object was not
+     * constructed with \e caps |= GeodesicLine::DISTANCE_IN.
+     **********************************************************************/
+    Densifier Densify(real step, size_t maxpoints, bool arcmode = false)
+      const
+    { return Densifier(this, step, maxpoints, arcmode); }
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,167 @@
+/**
+ * \file GeodesicLineCache.hpp
+ * \brief Header for GeographicLib::GeodesicLineCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICLINECACHE_HPP)
+#define GEOGRAPHICLIB_GEODESICLINECACHE_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A cache of recently used geodesic lines
+   *
+   * Constructing a GeodesicLine involves evaluating the coefficients of the
+   * series for the line, which costs about twice as much as computing a
+   * single position on the line.  If the same lines are used repeatedly (for
+   * example, the legs of flight plans which share waypoints), this can be
+   * avoided by obtaining the lines from a GeodesicLineCache.  This holds up
+   * to a given number of GeodesicLine objects, keyed on (\e lat1, \e lon1, \e
+   * azi1); when it is full, the least recently used line is discarded.
+   *
+   * GeodesicLineCache::Line returns a copy of the cached GeodesicLine (this
+   * is much cheaper than constructing the line).  Because the caller receives
+   * its own copy, it is unaffected by subsequent changes to the cache.  The
+   * results of using the returned line are identical to those obtained with
+   * a newly constructed GeodesicLine.
+   *
+   * If the library was compiled with C++11 support, the member functions
+   * lock an internal mutex so that a single cache can be shared by several
+   * threads; see GeodesicLineCache::ThreadSafe.  The construction of new
+   * lines takes place outside the lock.
+   *
+   * Example of use:
+   * \include example-GeodesicLineCache.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicLineCache {
+  private:
+    typedef Math::real real;
+    class Impl;
+    Impl* _impl;
+    // copy constructor not allowed
+    GeodesicLineCache(const GeodesicLineCache&);
+    // nor copy assignment
+    GeodesicLineCache& operator=(const GeodesicLineCache&);
+  public:
+
+    /**
+     * Constructor for GeodesicLineCache.
+     *
+     * @param[in] g the Geodesic object used to construct the lines.
+     * @param[in] capacity the maximum number of lines held by the cache.
+     * @param[in] caps bitor'ed combination of Geodesic::mask values
+     *   specifying the capabilities of the cached lines (default
+     *   Geodesic::ALL).
+     * @exception std::bad_alloc if the memory for the cache can't be
+     *   allocated.
+     *
+     * A copy of \e g is stored.  If \e capacity = 0, no lines are cached.
+     **********************************************************************/
+    GeodesicLineCache(const Geodesic& g, size_t capacity,
+                      unsigned caps = Geodesic::ALL);
+
+    /**
+     * The destructor.
+     **********************************************************************/
+    ~GeodesicLineCache();
+
+    /**
+     * Return a geodesic line, from the cache if possible.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @return a GeodesicLine equivalent to GeodesicLine(\e g, \e lat1, \e
+     *   lon1, \e azi1, \e caps).
+     *
+     * A cached line is used only if its key matches (\e lat1, \e lon1, \e
+     * azi1) exactly.  If any of the arguments is a NaN, the line is
+     * constructed and not cached.
+     **********************************************************************/
+    GeodesicLine Line(real lat1, real lon1, real azi1);
+
+    /**
+     * Remove all the lines from the cache.  The hit and miss counters are not
+     * changed.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Change the capacity of the cache.
+     *
+     * @param[in] capacity the new maximum number of lines.
+     *
+     * If the cache holds more than \e capacity lines, the least recently used
+     * ones are discarded.
+     **********************************************************************/
+    void SetCapacity(size_t capacity);
+
+    /**
+     * Reset the hit and miss counters to zero.
+     **********************************************************************/
+    void ResetCounters();
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the maximum number of lines held by the cache.
+     **********************************************************************/
+    size_t Capacity() const;
+
+    /**
+     * @return the number of lines currently in the cache.
+     **********************************************************************/
+    size_t Size() const;
+
+    /**
+     * @return the number of calls to GeodesicLineCache::Line which were
+     *   satisfied from the cache.
+     **********************************************************************/
+    unsigned long Hits() const;
+
+    /**
+     * @return the number of calls to GeodesicLineCache::Line which required
+     *   a new line to be constructed.
+     **********************************************************************/
+    unsigned long Misses() const;
+
+    /**
+     * @return the capabilities of the cached lines.  This is the \e caps
+     *   value used in the constructor.
+     **********************************************************************/
+    unsigned Capabilities() const;
+
+    /**
+     * @return true if the cache may be used by several threads
+     *   simultaneously.  This depends on whether the library was compiled
+     *   with C++11 support.
+     **********************************************************************/
+    static bool ThreadSafe();
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const;
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const;
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICLINECACHE_HPP
@@ -44,7 +44,8 @@ namespace GeographicLib {
       _salp1, _calp1, _ssig1, _csig1, _dn1, _stau1, _ctau1,
       _somg1, _comg1, _cchi1,
       _A4, _B41, _E0, _D0, _H0, _E1, _D1, _H1;
-    real _C4a[nC4_];            // all the elements of _C4a are used
+    real _C4a[nC4_];            // the first _nC4 elements of _C4a are used
+    int _nC4;                   // the order of the C4 expansion used
     EllipticFunction _E;
     unsigned _caps;
 
@@ -500,6 +501,24 @@ namespace GeographicLib {
                            real& s12, real& m12, real& M12, real& M21,
                            real& S12) const;
 
+    /**
+     * Speed up the subsequent calculation of many points on the geodesic.
+     *
+     * This calls EllipticFunction::PrecomputeSeries for the modulus of the
+     * geodesic so that GeodesicLineExact::GenPosition sums Fourier series for
+     * the periodic elliptic integrals instead of evaluating them directly
+     * (and, for positions given in terms of distance, instead of inverting
+     * the integral of the second kind with Newton's method).  This makes
+     * GeodesicLineExact::Position about 5 times faster; the results differ
+     * from those without the series by less than 0.1 nm.  Setting up the
+     * series costs about as much as computing 25 to 75 positions (for |\e
+     * f| &le; 1/50) and so this is only worthwhile if many points on the
+     * geodesic are needed (e.g., to compute a series of waypoints).  If the
+     * series don't converge (for very eccentric ellipsoids), the object is
+     * unchanged.
+     **********************************************************************/
+    void PrecomputeSeries();
+
     ///@}
 
     /** \name Inspector functions
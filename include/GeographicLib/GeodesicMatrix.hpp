@@ -0,0 +1,197 @@
+/**
+ * \file GeodesicMatrix.hpp
+ * \brief Header for GeographicLib::GeodesicMatrix class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICMATRIX_HPP)
+#define GEOGRAPHICLIB_GEODESICMATRIX_HPP 1
+
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Matrices of geodesic distances
+   *
+   * Compute the solutions of the inverse geodesic problem between all pairs
+   * of a set of \e n points.  The quantities which depend on a single point
+   * (the normalized longitude and the sine and cosine of the reduced
+   * latitude) are computed once in the constructor, as Geodesic::Point
+   * objects, instead of once for each pair.  The results are identical to
+   * those returned by Geodesic::GenInverse.
+   *
+   * Either the full \e n &times; \e n matrix or only its upper triangle
+   * (excluding the diagonal) can be computed.  The full matrix is stored in
+   * row-major order; the upper triangle is packed by rows so that it requires
+   * \e n (\e n &minus; 1)/2 elements.  Use GeodesicMatrix::Size to obtain
+   * the number of elements in the output arrays and GeodesicMatrix::Index to
+   * locate a particular element.  The output arrays are supplied by the
+   * caller; for very large \e n, these can, for example, be backed by a
+   * memory-mapped file.
+   *
+   * The work is split into square tiles of points so that the per-point data
+   * for a tile fits into cache.  Each tile can be computed independently by
+   * GeodesicMatrix::ComputeTile (a const, thread-safe member function), so
+   * that the tiles can be dispatched to a thread pool supplied by the caller.
+   * GeodesicMatrix::Compute computes all the tiles; this function is defined
+   * in the header and, if your code is compiled with OpenMP support, the
+   * tiles are distributed dynamically among the OpenMP threads.
+   *
+   * Example of use:
+   * \include example-GeodesicMatrix.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicMatrix {
+  private:
+    typedef Math::real real;
+    Geodesic _earth;
+    size_t _n, _tile, _nb;
+    bool _upper;
+    std::vector<Geodesic::Point> _pts;
+  public:
+
+    /**
+     * Constructor for GeodesicMatrix.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[in] upper if true compute only the upper triangle of the matrix
+     *   (default = false).
+     * @param[in] tile the number of points along each side of a tile
+     *   (default 64).
+     * @exception GeographicErr if \e tile = 0.
+     * @exception std::bad_alloc if the memory necessary for storing the
+     *   per-point quantities can't be allocated.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;] and \e lon
+     * should be in the range [&minus;540&deg;, 540&deg;).  The per-point
+     * quantities are computed by the constructor, so the arrays \e lat and \e
+     * lon are not referenced subsequently.
+     **********************************************************************/
+    GeodesicMatrix(const Geodesic& earth,
+                   const real* lat, const real* lon, size_t n,
+                   bool upper = false, size_t tile = 64);
+
+    /**
+     * Compute a single tile of the matrix.
+     *
+     * @param[in] k the index of the tile, 0 &le; \e k &lt;
+     *   GeodesicMatrix::NumTiles().
+     * @param[in] outmask a bitor'ed combination of Geodesic::DISTANCE and
+     *   Geodesic::AZIMUTH specifying which of the output arrays should be set.
+     * @param[out] s12 the array of distances (meters).
+     * @param[out] azi1 the array of azimuths at the first point (degrees).
+     * @param[out] azi2 the array of azimuths at the second point (degrees).
+     *
+     * The (\e i, \e j) element of the output arrays is the solution of the
+     * inverse problem from point \e i to point \e j; it is stored at position
+     * GeodesicMatrix::Index(\e i, \e j) of the arrays, each of which must
+     * have at least GeodesicMatrix::Size() elements.  Output arrays not
+     * selected by \e outmask are not referenced and may be null pointers.
+     * Different tiles write to disjoint elements of the output arrays, so
+     * several tiles may be computed concurrently.
+     **********************************************************************/
+    void ComputeTile(size_t k, unsigned outmask,
+                     real* s12, real* azi1, real* azi2) const;
+
+    /**
+     * Compute the whole matrix.
+     *
+     * @param[in] outmask a bitor'ed combination of Geodesic::DISTANCE and
+     *   Geodesic::AZIMUTH specifying which of the output arrays should be set.
+     * @param[out] s12 the array of distances (meters).
+     * @param[out] azi1 the array of azimuths at the first point (degrees).
+     * @param[out] azi2 the array of azimuths at the second point (degrees).
+     *
+     * This calls GeodesicMatrix::ComputeTile for each tile.  If the calling
+     * code is compiled with OpenMP, the tiles are computed in parallel.
+     **********************************************************************/
+    void Compute(unsigned outmask,
+                 real* s12, real* azi1 = 0, real* azi2 = 0) const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long nt = long(NumTiles());
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic)
+#endif
+      for (long k = 0; k < nt; ++k)
+        ComputeTile(size_t(k), outmask, s12, azi1, azi2);
+    }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e n the number of points.
+     **********************************************************************/
+    size_t NumPoints() const { return _n; }
+
+    /**
+     * @return true if only the upper triangle of the matrix is computed.
+     **********************************************************************/
+    bool Upper() const { return _upper; }
+
+    /**
+     * @return the number of points along each side of a tile.
+     **********************************************************************/
+    size_t TileSize() const { return _tile; }
+
+    /**
+     * @return the number of tiles.
+     **********************************************************************/
+    size_t NumTiles() const
+    { return _upper ? _nb * (_nb + 1) / 2 : _nb * _nb; }
+
+    /**
+     * @return the number of elements needed for each output array; this is
+     *   \e n<sup>2</sup> for the full matrix and \e n (\e n &minus; 1)/2 for
+     *   the upper triangle.
+     **********************************************************************/
+    size_t Size() const
+    { return _upper ? (_n > 0 ? _n * (_n - 1) / 2 : 0) : _n * _n; }
+
+    /**
+     * @param[in] i the index of the first point.
+     * @param[in] j the index of the second point.
+     * @return the position of element (\e i, \e j) in the output arrays.
+     *
+     * For the upper triangle, \e i &lt; \e j is required.
+     **********************************************************************/
+    size_t Index(size_t i, size_t j) const {
+      return _upper ? i * _n - (i * (i + 1)) / 2 + (j - i - 1) : i * _n + j;
+    }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _earth.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _earth.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEODESICMATRIX_HPP
@@ -0,0 +1,190 @@
+/**
+ * \file GeodesicPolygon.hpp
+ * \brief Header for GeographicLib::GeodesicPolygon class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICPOLYGON_HPP)
+#define GEOGRAPHICLIB_GEODESICPOLYGON_HPP 1
+
+#include <vector>
+#include <GeographicLib/PolygonArea.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Point in polygon tests for geodesic polygons
+   *
+   * Hold a polygon whose edges are the shortest geodesics between successive
+   * vertices (the same polygon as is given to PolygonArea) and determine
+   * whether query points lie inside it.  The inside of the polygon is the
+   * region to the left of the edges, i.e., the region for which the vertices
+   * are traversed counter-clockwise; this is the region whose area is given
+   * by PolygonArea::Compute with \e reverse = false.  If the object is
+   * constructed with \e reverse = true, the inside is the region to the
+   * right of the edges.  A polygon may encircle a pole and its edges may
+   * cross the antimeridian.
+   *
+   * The test counts the edges which cross the meridian of the query point
+   * north of the point.  An edge crosses a meridian if its ends lie on
+   * opposite sides of it (as determined by the same test that PolygonArea
+   * uses to count the crossings of the prime meridian); its crossing is
+   * north of the point if the azimuth from its western end to the point
+   * exceeds the azimuth of the edge at that end.  The number of crossings is
+   * combined with whether the north pole is inside, which is determined
+   * from the crossings of the prime meridian and, if there are an even
+   * number of these, from the sign of the area.
+   *
+   * The constructor solves the inverse problem for each edge and records
+   * the range of latitudes the edge spans and the azimuths at its ends.
+   * The edges are sorted into equal bins in longitude, each bin listing the
+   * edges which overlap it.  A query only needs to consider the edges in
+   * the bin containing the query point; an edge whose latitude range lies
+   * entirely north or south of the point is counted (or not) without
+   * further work and the inverse problem is only solved for the remaining
+   * edges, typically a handful.  (If the library is configured with
+   * GEOGRAPHICLIB_INSTRUMENTATION = ON, the number of these inverse
+   * problems is recorded in Instrumentation::GEODESICPOLYGON_INVERSE.)
+   *
+   * A point which lies on an edge (to within roundoff) may be classified
+   * either way; however points on the common boundary of two polygons
+   * (with the same vertices for the shared edges) are consistently assigned
+   * to one of them.  The vertices are not referenced after the constructor
+   * returns.
+   *
+   * The member functions are const and thread safe and
+   * GeodesicPolygon::Contains does not allocate memory.
+   * GeodesicPolygon::ContainsBatch performs many queries, optionally
+   * dividing them among several threads.
+   *
+   * Example of use:
+   * \include example-GeodesicPolygon.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicPolygon {
+  private:
+    typedef Math::real real;
+    struct Edge {
+      real lon1, lon2;          // The longitudes of the ends
+      real latlo, lathi;        // Bounds on the latitude
+      real aziw;                // The azimuth at the western end
+      size_t w;                 // The vertex at the western end
+    };
+    PolygonArea _poly;
+    size_t _n;
+    bool _reverse, _north;
+    int _crossings;
+    Accumulator<> _areasum, _perimetersum;
+    // The vertices, the edges, and the longitude bins; the edges which
+    // overlap bin b are _bins[_binstart[b]] to _bins[_binstart[b+1] - 1].
+    std::vector<Geodesic::Point> _pts;
+    std::vector<Edge> _edges;
+    std::vector<size_t> _binstart, _bins;
+    real _binwidth;
+
+    bool Above(const Edge& e, const Geodesic::Point& p) const;
+    void ContainsRange(const real lat[], const real lon[],
+                       size_t i0, size_t i1, bool inside[]) const;
+  public:
+
+    /**
+     * Constructor for GeodesicPolygon.
+     *
+     * @param[in] earth the Geodesic object to use for geodesic calculations.
+     * @param[in] lat array of latitudes of the vertices (degrees).
+     * @param[in] lon array of longitudes of the vertices (degrees).
+     * @param[in] n the number of vertices.
+     * @param[in] reverse if true then the inside of the polygon is to the
+     *   right of the edges (default = false).
+     * @exception std::bad_alloc if the memory for the index can't be
+     *   allocated.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;] and \e lon
+     * should be in the range [&minus;540&deg;, 540&deg;).  The last vertex
+     * is joined to the first.  This solves \e n inverse problems.
+     **********************************************************************/
+    GeodesicPolygon(const Geodesic& earth,
+                    const real lat[], const real lon[], size_t n,
+                    bool reverse = false);
+
+    /**
+     * Test whether a point is inside the polygon.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @return whether the point is inside.
+     *
+     * If \e lat or \e lon is a NaN, false is returned.  No memory is
+     * allocated.
+     **********************************************************************/
+    bool Contains(real lat, real lon) const;
+
+    /**
+     * Test whether many points are inside the polygon.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] inside array of the results.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * <i>inside</i>[<i>i</i>] is set to GeodesicPolygon::Contains(<i>lat</i>
+     * [<i>i</i>], <i>lon</i>[<i>i</i>]).  The points are divided into \e
+     * nthreads contiguous ranges which are run by Executor::Default().  If
+     * the library is compiled without C++11, all the work is done by the
+     * calling thread; in any case, the results are the same.
+     **********************************************************************/
+    void ContainsBatch(const real lat[], const real lon[], size_t n,
+                       bool inside[], int nthreads = 1) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e n the number of vertices.
+     **********************************************************************/
+    size_t NumPoints() const { return _n; }
+
+    /**
+     * @return the perimeter of the polygon (meters).
+     **********************************************************************/
+    Math::real Perimeter() const { return _perimetersum(); }
+
+    /**
+     * @return the area of the inside of the polygon (meters<sup>2</sup>).
+     *   This is the area computed by PolygonArea::Compute with the same value
+     *   of \e reverse and \e sign = false.
+     **********************************************************************/
+    Math::real Area() const;
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _poly.MajorRadius(); }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the Geodesic object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _poly.Flattening(); }
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEODESICPOLYGON_HPP
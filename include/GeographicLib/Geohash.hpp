@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_GEOHASH_HPP)
 #define GEOGRAPHICLIB_GEOHASH_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 
 #if defined(_MSC_VER)
@@ -20,6 +21,8 @@
 
 namespace GeographicLib {
 
+  class Geodesic;
+
   /**
    * \brief Conversions for geohashes
    *
@@ -55,8 +58,17 @@ namespace GeographicLib {
       return lateps;
     }
     static const real lateps_;
-    static const std::string lcdigits_;
-    static const std::string ucdigits_;
+    static const char* const lcdigits_;
+    static const char* const ucdigits_;
+    static const int maxbits_ = 64;
+    // Table for decoding the characters of a geohash.
+    class Decoder;
+    // Check lat and lon and convert them to 46-bit integers; return false if
+    // either is a NaN.
+    static bool Quantize(real lat, real lon,
+                         unsigned long long& ulat, unsigned long long& ulon);
+    // Write the geohash (unterminated) to geohash and return its length.
+    static int Encode(real lat, real lon, int len, char geohash[]);
     Geohash();                     // Disable constructor
 
   public:
@@ -80,6 +92,182 @@ namespace GeographicLib {
      **********************************************************************/
     static void Forward(real lat, real lon, int len, std::string& geohash);
 
+    /**
+     * Convert from geographic coordinates to a geohash stored in a character
+     * array.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] len the length of the resulting geohash.
+     * @param[out] geohash the geohash (null terminated).
+     * @param[in] cap the size of the array \e geohash.
+     * @exception GeographicErr if \e la is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @exception GeographicErr if \e lon is not in [&minus;540&deg;,
+     *   540&deg;).
+     * @exception GeographicErr if \e cap is too small to hold the result.
+     * @return the length of the geohash (excluding the terminating null).
+     *
+     * This is the same as Geohash::Forward(real, real, int, std::string&)
+     * except that no memory is allocated.  \e cap = 19 suffices for every \e
+     * len.
+     **********************************************************************/
+    static size_t Forward(real lat, real lon, int len,
+                          char* geohash, size_t cap);
+
+    /**
+     * Convert an array of geographic coordinates to geohashes stored in a
+     * contiguous character array.
+     *
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] n the number of points.
+     * @param[in] len the length of the resulting geohashes.
+     * @param[out] geohash the array of geohashes; this must have at least \e
+     *   n &times; \e stride elements.
+     * @param[in] stride the spacing of the geohashes in \e geohash.
+     * @exception GeographicErr if \e stride is too small to hold the results.
+     * @exception GeographicErr if any \e lat or \e lon is out of range.
+     *
+     * The geohash for point \e i is written, null terminated, starting at \e
+     * geohash[\e i &times; \e stride].  \e stride must exceed max(\e len,
+     * 3) (after \e len is put in the range [0, 18]).
+     **********************************************************************/
+    static void ForwardBatch(const real lat[], const real lon[], size_t n,
+                             int len, char* geohash, size_t stride);
+
+    /**
+     * Convert from geographic coordinates to the bits of a geohash.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] nbits the number of bits of the geohash to return.
+     * @exception GeographicErr if \e la is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @exception GeographicErr if \e lon is not in [&minus;540&deg;,
+     *   540&deg;).
+     * @exception GeographicErr if \e lat or \e lon is NaN.
+     * @return the leading \e nbits bits of the geohash as an integer in [0,
+     *   2<sup>\e nbits</sup>).
+     *
+     * The bits of a geohash alternately bisect the longitude and latitude
+     * ranges, beginning with longitude; these are placed in the result with
+     * the first bit most significant.  Internally, \e nbits is first put in
+     * the range [0, 64].  Each character of a geohash represents 5 bits;
+     * thus for \e len &le; 12, EncodeBits(\e lat, \e lon, 5 \e len) gives
+     * the integer whose base-32 digits are the characters of the geohash of
+     * length \e len.  Integers with the same number of bits preserve the
+     * ordering of the corresponding geohashes.
+     **********************************************************************/
+    static unsigned long long EncodeBits(real lat, real lon, int nbits);
+
+    /**
+     * Convert arrays of geographic coordinates to the bits of geohashes.
+     *
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] n the number of points.
+     * @param[in] nbits the number of bits of the geohash to return.
+     * @param[out] bits the array of results.
+     * @exception GeographicErr if any \e lat or \e lon is out of range or
+     *   is NaN.
+     **********************************************************************/
+    static void EncodeBits(const real lat[], const real lon[], size_t n,
+                           int nbits, unsigned long long bits[]);
+
+    /**
+     * Convert from the bits of a geohash to geographic coordinates.
+     *
+     * @param[in] bits the leading bits of a geohash (see
+     *   Geohash::EncodeBits).
+     * @param[in] nbits the number of bits in \e bits.
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[in] centerp if true (the default) return the center of the
+     *   geohash cell, otherwise return the south-west corner.
+     *
+     * Internally, \e nbits is first put in the range [0, 64].  Only the low
+     * \e nbits bits of \e bits are used.  For \e nbits = 5 \e len, the
+     * results are the same as those given by Geohash::Reverse for the
+     * corresponding geohash of length \e len.
+     **********************************************************************/
+    static void DecodeBits(unsigned long long bits, int nbits,
+                           real& lat, real& lon, bool centerp = true);
+
+    /**
+     * Find the neighbors of a geohash cell.
+     *
+     * @param[in] bits the leading bits of a geohash (see
+     *   Geohash::EncodeBits).
+     * @param[in] nbits the number of bits in \e bits.
+     * @param[out] neighbors an array, of length at least 8, for the bits of
+     *   the neighboring cells (each with \e nbits bits).
+     * @return the number of neighbors found.
+     *
+     * The neighbors are returned in the order N, NE, E, SE, S, SW, W, NW.
+     * Longitudes wrap around at the antimeridian; however there are no
+     * neighbors to the north of the cells adjoining the north pole (and
+     * similarly for the south pole), so these cells have only 5 neighbors.
+     * For very coarse cells (\e nbits &lt; 4), some of the neighbors coincide
+     * with one another or with the cell itself; only distinct neighbors are
+     * returned.  Internally, \e nbits is first put in the range [0, 64].
+     **********************************************************************/
+    static int Neighbors(unsigned long long bits, int nbits,
+                         unsigned long long neighbors[]);
+
+    /**
+     * Find the geohash cells covering a latitude-longitude box.
+     *
+     * @param[in] south the southern boundary of the box (degrees).
+     * @param[in] west the western boundary of the box (degrees).
+     * @param[in] north the northern boundary of the box (degrees).
+     * @param[in] east the eastern boundary of the box (degrees).
+     * @param[in] nbits the number of bits of the geohash cells.
+     * @param[out] cells the bits of the cells which intersect the box, in
+     *   increasing order.
+     * @exception GeographicErr if \e south or \e north is not in
+     *   [&minus;90&deg;, 90&deg;], if \e west or \e east is not in
+     *   [&minus;540&deg;, 540&deg;), or if \e north &lt; \e south.
+     * @exception std::bad_alloc if the memory for \e cells can't be allocated.
+     *
+     * The box extends eastwards from \e west to \e east; so it crosses the
+     * antimeridian if \e east lies to the west of \e west and it includes
+     * all longitudes if \e east &minus; \e west &ge; 360&deg;.  The cells are
+     * those containing the points of the box (with each cell including its
+     * south and west edges).  The previous content of \e cells is discarded,
+     * but its capacity is retained, so that the same vector can be reused for
+     * many queries.  Bear in mind that the number of cells grows as
+     * 2<sup>\e nbits</sup> times the area of the box.  The sorted cell bits
+     * can be combined into ranges for queries against an index of
+     * Geohash::EncodeBits values.
+     **********************************************************************/
+    static void Cover(real south, real west, real north, real east, int nbits,
+                      std::vector<unsigned long long>& cells);
+
+    /**
+     * Find the geohash cells covering a geodesic disc.
+     *
+     * @param[in] g the Geodesic object specifying the ellipsoid.
+     * @param[in] lat the latitude of the center (degrees).
+     * @param[in] lon the longitude of the center (degrees).
+     * @param[in] r the radius of the disc (meters).
+     * @param[in] nbits the number of bits of the geohash cells.
+     * @param[out] cells the bits of the cells, in increasing order.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;, 90&deg;],
+     *   if \e lon is not in [&minus;540&deg;, 540&deg;), or if \e r is
+     *   negative.
+     * @exception std::bad_alloc if the memory for \e cells can't be allocated.
+     *
+     * The disc consists of the points whose geodesic distance from the center
+     * is at most \e r.  This finds its latitude-longitude bounding box and
+     * calls Geohash::Cover; thus \e cells includes all the cells which
+     * intersect the disc together with (for small discs) about 25% more
+     * cells at the corners of the box.  If the disc includes a pole, the box
+     * spans all longitudes.
+     **********************************************************************/
+    static void CoverRadius(const Geodesic& g, real lat, real lon, real r,
+                            int nbits, std::vector<unsigned long long>& cells);
+
     /**
      * Convert from a geohash to geographic coordinates.
      *
@@ -100,6 +288,27 @@ namespace GeographicLib {
     static void Reverse(const std::string& geohash, real& lat, real& lon,
                         int& len, bool centerp = true);
 
+    /**
+     * Convert from a geohash stored in a character array to geographic
+     * coordinates.
+     *
+     * @param[in] geohash pointer to the geohash.
+     * @param[in] n the number of characters in the geohash.
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] len the length of the geohash.
+     * @param[in] centerp if true (the default) return the center of the
+     *   geohash location, otherwise return the south-west corner.
+     * @exception GeographicErr if \e geohash contains illegal characters.
+     *
+     * \e geohash need not be null terminated, so this allows a geohash
+     * embedded in a larger buffer to be decoded without copying it.
+     * Otherwise, this is the same as Geohash::Reverse(const std::string&,
+     * real&, real&, int&, bool).
+     **********************************************************************/
+    static void Reverse(const char* geohash, size_t n, real& lat, real& lon,
+                        int& len, bool centerp = true);
+
     /**
      * The latitude resolution of a geohash.
      *
@@ -13,6 +13,7 @@
 #include <vector>
 #include <fstream>
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Instrumentation.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector and constant conditional expressions
@@ -80,7 +81,14 @@ namespace GeographicLib {
    * threadsafe parameter to true in the constructor.  This causes the
    * constructor to read all the data into memory and to turn off the
    * single-cell caching which results in a Geoid object which \e is thread
-   * safe.
+   * safe.  Finally, several threads can share a Geoid object without reading
+   * all the data into memory by each supplying its own Geoid::Cell to
+   * Geoid::operator()(real, real, Cell&); this works best if the data file
+   * is mapped into memory with Geoid::CacheMap.
+   *
+   * The data may also be supplied as a compressed tiled file (see \ref
+   * geoidformat); the tiles are then decompressed into a tile cache (see
+   * Geoid::CacheTiles) as they are needed.
    *
    * Example of use:
    * \include example-Geoid.cpp
@@ -102,6 +110,8 @@ namespace GeographicLib {
     static const unsigned pixel_max_ = 0xffffffffu;
 #endif
     static const unsigned stencilsize_ = 12;
+    static const unsigned nsort_ = 1U << 16; // Block size for HeightBatch
+    static const int asynctile_ = 64; // Tile size for HeightAsync
     static const unsigned nterms_ = ((3 + 1) * (3 + 2))/2; // for a cubic fit
     static const int c0_;
     static const int c0n_;
@@ -109,7 +119,120 @@ namespace GeographicLib {
     static const int c3_[stencilsize_ * nterms_];
     static const int c3n_[stencilsize_ * nterms_];
     static const int c3s_[stencilsize_ * nterms_];
+    // The offsets (dx, dy) of the points of the stencils for the cubic and
+    // bilinear fits
+    static const int stencilc_[2 * stencilsize_];
+    static const int stencill_[2 * 4];
+
+  public:
+    /**
+     * \brief The single-cell cache for geoid evaluations
+     *
+     * This holds the interpolation coefficients for the most recently used
+     * cell of the grid.  A Geoid object maintains one Cell internally; a
+     * thread can supply its own Cell to Geoid::operator()(real, real, Cell&)
+     * so that several threads can share a Geoid object.  A Cell records the
+     * Geoid it was last used with, so it can be used with several Geoid
+     * objects (but it's only effective if it's used with a single one).
+     **********************************************************************/
+    class Cell {
+    private:
+      friend class Geoid;
+      const Geoid* _geoid;
+      int _ix, _iy;
+      real _v00, _v01, _v10, _v11;
+      real _t[nterms_];
+    public:
+      /**
+       * Construct an empty Cell.
+       **********************************************************************/
+      Cell() : _geoid(0), _ix(0), _iy(0) {}
+    };
+
+    /**
+     * \brief The action taken when an asynchronous request is complete
+     *
+     * See Geoid::HeightAsync.
+     **********************************************************************/
+    class Completion {
+    public:
+      /**
+       * Called once when the request is complete.
+       *
+       * @param[in] error empty if the heights have been computed; otherwise
+       *   a description of the error (and the heights are undefined).
+       *
+       * This must not throw an exception.
+       **********************************************************************/
+      virtual void operator()(const std::string& error) = 0;
+      virtual ~Completion() {}
+    };
+
+    /**
+     * \brief A source of geoid data other than a data file
+     *
+     * A Geoid constructed with Geoid::Geoid(const Source&, bool) obtains its
+     * grid from a Source, e.g., a GeoidGenerator, instead of a data file.
+     * The grid has the layout of a data file (see \ref geoidformat): there
+     * are Width() columns at longitudes 0, 360/Width(), ...  and Height()
+     * rows at latitudes 90, 90 - 180/(Height() - 1), ..., -90.  The data is
+     * requested in blocks of TileSize() &times; TileSize() pixels through
+     * the tile cache of the Geoid.  The member functions may be called by
+     * several threads at once.
+     **********************************************************************/
+    class Source {
+    public:
+      /**
+       * @return the number of columns of the grid (which must be even).
+       **********************************************************************/
+      virtual int Width() const = 0;
+      /**
+       * @return the number of rows of the grid (which must be odd).
+       **********************************************************************/
+      virtual int Height() const = 0;
+      /**
+       * @return the size of the blocks in which the data is requested.
+       **********************************************************************/
+      virtual int TileSize() const = 0;
+      /**
+       * @return the offset (meters) used in storing the heights; the
+       *   heights are held by the Geoid as Offset() + Scale() times an
+       *   integer in [0, 2<sup>16</sup> &minus; 1] (or [0,
+       *   2<sup>32</sup> &minus; 1] if the library was compiled with
+       *   GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH = 4).
+       **********************************************************************/
+      virtual Math::real Offset() const = 0;
+      /**
+       * @return the scale (meters) used in storing the heights.
+       **********************************************************************/
+      virtual Math::real Scale() const = 0;
+      /**
+       * @return the name of the data, returned by Geoid::GeoidName.
+       **********************************************************************/
+      virtual std::string Name() const = 0;
+      /**
+       * @return a description of the data, returned by
+       *   Geoid::Description.
+       **********************************************************************/
+      virtual std::string Description() const { return "NONE"; }
+      /**
+       * Compute the geoid heights for a block of the grid.
+       *
+       * @param[in] x0 the first column of the block.
+       * @param[in] y0 the first row of the block.
+       * @param[in] w the number of columns of the block.
+       * @param[in] h the number of rows of the block.
+       * @param[out] N the \e w &times; \e h heights (meters), in row-major
+       *   order.
+       * @exception GeographicErr (or any other std::exception) if the
+       *   heights can't be computed.
+       **********************************************************************/
+      virtual void Heights(int x0, int y0, int w, int h, Math::real N[])
+        const = 0;
+      virtual ~Source() {}
+    };
 
+  private:
     std::string _name, _dir, _filename;
     const bool _cubic;
     const real _a, _e2, _degree, _eps;
@@ -119,16 +242,37 @@ namespace GeographicLib {
     real _offset, _scale, _maxerror, _rmserror;
     int _width, _height;
     unsigned long long _datastart, _swidth;
-    bool _threadsafe;
-    // Area cache
-    mutable std::vector< std::vector<pixel_t> > _data;
+    bool _threadsafe, _hugepages;
+    // Compressed data file: the tile size and the file offsets of the tiles
+    bool _compressed;
+    int _tilesize;
+    std::vector<unsigned long long> _tileindex;
+    // Area cache: _ysize rows of _xsize pixels
+    mutable std::vector<pixel_t> _data;
     mutable bool _cache;
+    // Memory mapped data file (the whole file, including the header)
+    mutable const unsigned char* _map;
+    mutable unsigned long long _maplen, _mapstart; // _mapstart = data offset
+    mutable void* _maphandle;   // The file mapping object on Windows
+    // Coefficient cache: the interpolation coefficients for each cell, its NE
+    // corner and extent
+    mutable std::vector<real> _coeffs;
+    mutable int _cxoffset, _cyoffset, _cxsize, _cysize;
+    // Tile cache
+    class TileCache;
+    mutable TileCache* _tiles;
+    // Background loading of the area cache
+    class Preloader;
+    mutable Preloader* _preload;
+    // The reader serving HeightAsync
+    class AsyncReader;
+    mutable AsyncReader* _async;
+    // The source of the data, if not a data file
+    const Source* _source;
     // NE corner and extent of cache
     mutable int _xoffset, _yoffset, _xsize, _ysize;
     // Cell cache
-    mutable int _ix, _iy;
-    mutable real _v00, _v01, _v10, _v11;
-    mutable real _t[nterms_];
+    mutable Cell _cell;
     void filepos(int ix, int iy) const {
       _file.seekg(
 #if !(defined(__GNUC__) && __GNUC__ < 4)
@@ -138,7 +282,7 @@ namespace GeographicLib {
                   (_datastart +
                    pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix))));
     }
-    real rawval(int ix, int iy) const {
+    real rawval(int ix, int iy, bool shared) const {
       if (ix < 0)
         ix += _width;
       else if (ix >= _width)
@@ -146,42 +290,86 @@ namespace GeographicLib {
       if (_cache && iy >= _yoffset && iy < _yoffset + _ysize &&
           ((ix >= _xoffset && ix < _xoffset + _xsize) ||
            (ix + _width >= _xoffset && ix + _width < _xoffset + _xsize))) {
-        return real(_data[iy - _yoffset]
-                    [ix >= _xoffset ? ix - _xoffset : ix + _width - _xoffset]);
+        GEOGRAPHICLIB_COUNT(GEOID_CACHE_HIT);
+        return real(_data[size_t(iy - _yoffset) * size_t(_xsize) +
+                          (ix >= _xoffset ? ix - _xoffset :
+                           ix + _width - _xoffset)]);
       } else {
-        if (iy < 0 || iy >= _height) {
-          iy = iy < 0 ? -iy : 2 * (_height - 1) - iy;
-          ix += (ix < _width/2 ? 1 : -1) * _width/2;
-        }
-        try {
-          filepos(ix, iy);
-          // initial values to suppress warnings in case get fails
-          char a = 0, b = 0;
-          _file.get(a);
-          _file.get(b);
-          unsigned r = ((unsigned char)(a) << 8) | (unsigned char)(b);
-          if (pixel_size_ == 4) {
-            _file.get(a);
-            _file.get(b);
-            r = (r << 16) | ((unsigned char)(a) << 8) | (unsigned char)(b);
-          }
+        GEOGRAPHICLIB_COUNT(GEOID_CACHE_MISS);
+        reflect(ix, iy);
+        if (_map) {
+          // The data is stored in big-endian order.
+          const unsigned char* p = _map +
+            (_mapstart + pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix)));
+          unsigned r = (unsigned(p[0]) << 8) | unsigned(p[1]);
+          if (pixel_size_ == 4)
+            r = (r << 16) | (unsigned(p[2]) << 8) | unsigned(p[3]);
           return real(r);
         }
-        catch (const std::exception& e) {
-          // throw GeographicErr("Error reading " + _filename + ": "
-          //                      + e.what());
-          // triggers complaints about the "binary '+'" under Visual Studio.
-          // So use '+=' instead.
-          std::string err("Error reading ");
-          err += _filename;
-          err += ": ";
-          err += e.what();
-          throw GeographicErr(err);
-        }
+        return _tiles ? tileval(ix, iy, shared) : fileval(ix, iy, shared);
       }
     }
+    // Allow points "beyond" the poles (iy < 0 or iy >= _height) to support
+    // interpolation; ix must be in [0, _width).
+    void reflect(int& ix, int& iy) const {
+      if (iy < 0 || iy >= _height) {
+        iy = iy < 0 ? -iy : 2 * (_height - 1) - iy;
+        ix += (ix < _width/2 ? 1 : -1) * _width/2;
+      }
+    }
+    // The number of interpolation coefficients for a cell
+    unsigned ncoeffs() const { return _cubic ? nterms_ : 4; }
+    // The number of points in the stencil and their offsets
+    unsigned nstencil() const { return _cubic ? stencilsize_ : 4; }
+    const int* stencil() const { return _cubic ? stencilc_ : stencill_; }
+    // Compute the interpolation coefficients for cell (ix, iy) into t; pass
+    // shared to rawval.
+    void fitcell(int ix, int iy, bool shared, real t[]) const;
+    // Compute the interpolation coefficients for a cell in row iy from the
+    // values v at the points of the stencil.
+    void fitvalues(int iy, const real v[], real t[]) const;
+    // Set cell to hold the coefficients for cell (ix, iy), given the values v
+    // at the points of its stencil.
+    void fillcell(int ix, int iy, const real v[], Cell& cell) const;
+    // The range of data needed to cache an area
+    void cacherange(real south, real west, real north, real east,
+                    int& iw, int& in, int& xsize, int& ysize) const;
+    // Read n values of row iy starting at column ix (wrapping around in
+    // longitude) from str.
+    void readrow(std::istream& str, int ix, int iy, int n,
+                 pixel_t row[]) const;
+    // Open the data file on str for a separate reader, with exceptions
+    // enabled; with a Source, str is left closed.
+    void openstream(std::ifstream& str) const;
+    // Map the data in filename; the pixels start at offset start and the
+    // file has length len.
+    void mapfile(const std::string& filename, unsigned long long start,
+                 unsigned long long len) const;
+    // The comment lines of the header of a shared copy of the data; these
+    // identify the data set.
+    std::string sharedheader() const;
+    // Map the shared copy of the data in filename, if it exists and was made
+    // from the same data set.
+    bool attachshared(const std::string& filename) const;
+    // Install the preloaded area cache, if it's complete.
+    void preloadpoll() const;
+    // Read a value via the tile cache.
+    real tileval(int ix, int iy, bool shared) const;
+    // Read a value from the file; if shared, serialize access to the file.
+    real fileval(int ix, int iy, bool shared) const;
+    real height(real lat, real lon, bool gradp,
+                real& grade, real& gradn) const {
+      return height(lat, lon, gradp, grade, gradn, _cell, !_threadsafe, false);
+    }
+    // Use the cell cache, cell, if usecell; pass shared to rawval.  If
+    // gradfac is not null, it gives the result of gradfactors(lat).
     real height(real lat, real lon, bool gradp,
-                real& grade, real& gradn) const;
+                real& grade, real& gradn,
+                Cell& cell, bool usecell, bool shared,
+                const real* gradfac = 0) const;
+    // The factors, depending only on lat, needed for the gradients.
+    static const unsigned ngradfac_ = 4;
+    void gradfactors(real lat, real fac[]) const;
     Geoid(const Geoid&);            // copy constructor not allowed
     Geoid& operator=(const Geoid&); // copy assignment not allowed
   public:
@@ -219,20 +407,57 @@ namespace GeographicLib {
      *   true (the default) means cubic.
      * @param[in] threadsafe (optional), if true, construct a thread safe
      *   object.  The default is false
+     * @param[in] hugepages (optional), if true, ask for the cached data and
+     *   the memory mapped file to be backed by huge pages.  The default is
+     *   false.
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt.
      * @exception GeographicErr if \e threadsafe is true but the memory
      *   necessary for caching the data can't be allocated.
      *
-     * The data file is formed by appending ".pgm" to the name.  If \e path is
-     * specified (and is non-empty), then the file is loaded from directory, \e
-     * path.  Otherwise the path is given by DefaultGeoidPath().  If the \e
+     * The data file is formed by appending ".pgm" to the name.  If this file
+     * doesn't exist, the compressed tiled file formed by appending ".tgm" is
+     * used instead (see \ref geoidformat).  If \e path is specified (and is
+     * non-empty), then the file is loaded from directory, \e path.  Otherwise
+     * the path is given by DefaultGeoidPath().  If the \e
      * threadsafe parameter is true, the data set is read into memory, the data
      * file is closed, and single-cell caching is turned off; this results in a
      * Geoid object which \e is thread safe.
+     *
+     * If the \e hugepages parameter is true, the memory for the area cache
+     * and the mappings made by Geoid::CacheMap and Geoid::CacheShared are
+     * requested to be backed by huge pages (see Utility::advisehugepages).
+     * The whole of egm2008-1 occupies about 450 MB, so random lookups in the
+     * cache made by Geoid::CacheAll otherwise incur a TLB miss for nearly
+     * every point.
      **********************************************************************/
     explicit Geoid(const std::string& name, const std::string& path = "",
-                   bool cubic = true, bool threadsafe = false);
+                   bool cubic = true, bool threadsafe = false,
+                   bool hugepages = false);
+
+    /**
+     * Construct a geoid whose data is obtained from a Source.
+     *
+     * @param[in] source the source of the data.
+     * @param[in] cubic (optional) interpolation method; false means bilinear,
+     *   true (the default) means cubic.
+     * @exception GeographicErr if the size of the grid is invalid.
+     *
+     * The data is read from \e source a tile at a time, via a tile cache,
+     * as with a compressed data file (and Geoid::Compressed returns true).
+     * So, CacheTiles sets the budget for the tiles (the tile size is given by
+     * \e source); CacheArea, Preload, and CacheShared obtain the data from
+     * \e source; and CacheMap is not allowed.  The results are otherwise
+     * as if the grid were read from a data file.  \e source must outlive
+     * the Geoid.
+     **********************************************************************/
+    explicit Geoid(const Source& source, bool cubic = true);
+
+    /**
+     * The destructor.  This releases the memory mapping of the data file (if
+     * any).
+     **********************************************************************/
+    ~Geoid();
 
     /**
      * Set up a cache.
@@ -272,12 +497,217 @@ namespace GeographicLib {
     void CacheAll() const { CacheArea(real(-90), real(0),
                                       real(90), real(360)); }
 
+    /**
+     * Cache the data for an area in the background.
+     *
+     * @param[in] south latitude (degrees) of the south edge of the cached area.
+     * @param[in] west longitude (degrees) of the west edge of the cached area.
+     * @param[in] north latitude (degrees) of the north edge of the cached area.
+     * @param[in] east longitude (degrees) of the east edge of the cached area.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception GeographicErr if the library was compiled without C++11
+     *   support and CacheArea fails.
+     *
+     * This is like CacheArea except that the data is read by a background
+     * thread (using its own file stream) and this returns immediately.  In
+     * the meantime, the Geoid object can be used as usual with the data read
+     * as though the area were not cached.  When the data has been read, it
+     * replaces the area cache (if any); this happens in the calling thread in
+     * the next call to operator()(real, real) (or other member functions
+     * evaluating a single height), PreloadDone, or PreloadWait.  (It does not
+     * happen in HeightBatch or Geoid::operator()(real, real, Cell&), so the
+     * cache doesn't change while the object is shared between threads.)  Use
+     * PreloadProgress to monitor the progress of the loading.  Errors in
+     * reading the data (including running out of memory) are reported by
+     * PreloadWait; otherwise, a failed preload is silently discarded.
+     *
+     * Calling Preload, CacheArea, or CacheClear cancels a preload in progress.
+     * If the library was compiled without C++11 support, this just calls
+     * CacheArea.
+     **********************************************************************/
+    void Preload(real south, real west, real north, real east) const;
+
+    /**
+     * Cache all the data in the background.
+     *
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception GeographicErr if the library was compiled without C++11
+     *   support and CacheAll fails.
+     *
+     * See Preload.
+     **********************************************************************/
+    void PreloadAll() const { Preload(real(-90), real(0),
+                                      real(90), real(360)); }
+
+    /**
+     * Check whether a background load has completed.
+     *
+     * @return true if there's no background load in progress.
+     *
+     * If the background load started by Preload has completed successfully,
+     * this installs the data as the area cache.  This never throws an error.
+     **********************************************************************/
+    bool PreloadDone() const;
+
+    /**
+     * Wait for a background load to complete.
+     *
+     * @exception GeographicErr if the data couldn't be read.
+     *
+     * This blocks until the background load started by Preload is complete
+     * and then installs the data as the area cache.  This does nothing if
+     * there isn't a background load in progress.
+     **********************************************************************/
+    void PreloadWait() const;
+
+    /**
+     * @return the fraction of the data for the area (in [0, 1]) read by a
+     *   background load which is in progress.  This returns 1 if there is
+     *   no background load in progress.
+     **********************************************************************/
+    real PreloadProgress() const;
+
+    /**
+     * Precompute the interpolation coefficients for an area.
+     *
+     * @param[in] south latitude (degrees) of the south edge of the area.
+     * @param[in] west longitude (degrees) of the west edge of the area.
+     * @param[in] north latitude (degrees) of the north edge of the area.
+     * @param[in] east longitude (degrees) of the east edge of the area.
+     * @exception GeographicErr if the memory necessary for the coefficients
+     *   can't be allocated.
+     * @exception GeographicErr if there's a problem reading the data.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     *
+     * Normally, the interpolating polynomial for a cell of the grid is fit
+     * to the neighboring data values each time the cell changes; for cubic
+     * interpolation, this requires 12 data values and a 12 &times; 10 matrix
+     * multiplication.  This routine computes the coefficients (10 for cubic
+     * interpolation and 4 for bilinear interpolation) for all the cells
+     * overlapping the area and stores them; within the area, a geoid height
+     * is then evaluated at the cost of fetching the coefficients and
+     * evaluating a polynomial.  This helps query patterns which move
+     * between cells so frequently that the single-cell cache is ineffective.
+     * The coefficients for a cell take 80 bytes (for cubic interpolation with
+     * doubles); so this is practical only for limited areas with the finer
+     * grids, e.g., a 10&deg; square occupies 29 MB with egm2008-1.  (The
+     * coefficients for the whole of egm96-5 take 750 MB.)
+     *
+     * The coefficients are computed from the data; so this is fastest if the
+     * data for the area is cached (with CacheArea) or mapped (with CacheMap)
+     * first.  Calling this replaces any previous set of coefficients; if \e
+     * south &gt; \e north, the coefficients are discarded.  The coefficients
+     * are also discarded by CacheClear.  The use of the coefficients does not
+     * affect the values returned.
+     **********************************************************************/
+    void CacheCoefficients(real south, real west, real north, real east)
+      const;
+
+    /**
+     * Set up a tile cache.
+     *
+     * @param[in] maxbytes the memory budget for the cache (bytes).
+     * @param[in] prefetch if true, load the tiles neighboring a missed tile in
+     *   the background (default false).
+     * @param[in] tilesize the size of a square tile (pixels, default 256).
+     * @exception GeographicErr if \e tilesize is not positive.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     * @exception std::bad_alloc if the memory for the cache can't be
+     *   allocated.
+     *
+     * With a tile cache, data outside the area set by CacheArea is read from
+     * the data file a tile at a time and the tiles are held in memory.  When
+     * the number of tiles would exceed the budget, the least recently used
+     * tile is discarded.  At least one tile is always held.  This suits
+     * query patterns, e.g., from vehicles ranging over a continent, which
+     * aren't confined to a single rectangle.  For a 2-byte pixel, a 256
+     * &times; 256 tile takes 128 KB.  So a budget of 64 MB allows 512 tiles
+     * which covers about 14% of the egm2008-1 grid.
+     *
+     * If \e prefetch is true and the library was compiled with C++11
+     * support, the 8 tiles surrounding a missed tile are loaded by a
+     * background thread which uses its own file stream.  (If C++11 support
+     * isn't available, \e prefetch is ignored.)  Calling CacheTiles replaces
+     * any previous tile cache; the cache is discarded by CacheClear or by
+     * setting a budget of 0.  The tile cache is not used if the data file is
+     * mapped with CacheMap.  The use of the tile cache does not affect the
+     * values returned.
+     *
+     * A compressed data file is always read via a tile cache (which is set up
+     * by the constructor).  In this case, \e tilesize is ignored, since the
+     * tile size is fixed by the file; the budget counts the decompressed
+     * tiles; and a budget of 0 (or calling CacheClear) reverts to the default
+     * budget of 16 MB (or 2 rows of tiles, if this is larger).
+     **********************************************************************/
+    void CacheTiles(unsigned long long maxbytes, bool prefetch = false,
+                    int tilesize = 256) const;
+
     /**
      * Clear the cache.  This never throws an error.  (This does nothing with a
-     * thread safe Geoid.)
+     * thread safe Geoid.)  This also discards the tile cache and the
+     * interpolation coefficients (see CacheCoefficients).
      **********************************************************************/
     void CacheClear() const;
 
+    /**
+     * Map the data file into memory.
+     *
+     * @exception GeographicErr if the file can't be mapped or if memory
+     *   mapping is not supported on this system.
+     * @exception GeographicErr if the data file is compressed.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     *
+     * This maps the data file into the address space of the process (using
+     * mmap on POSIX systems and MapViewOfFile on Windows).  Subsequently,
+     * values outside the cached area (if any) are read directly from memory
+     * instead of via the file stream.  This is nearly as fast as CacheAll; but
+     * no memory is allocated, the operating system's page cache holds the
+     * data, and this is shared by all the processes using the same data file.
+     * Calling this on a Geoid whose file is already mapped does nothing.  The
+     * mapping is released by CacheUnmap or by the destructor.  In a 32-bit
+     * process, there may not be enough address space to map the egm2008-1
+     * data set (about 460 MB).
+     *
+     * Unlike the \e threadsafe option to the constructor, this does not make
+     * the Geoid object thread safe, since it still maintains a single-cell
+     * cache.
+     **********************************************************************/
+    void CacheMap() const;
+
+    /**
+     * Map a copy of the data which is shared between processes.
+     *
+     * @param[in] filename the name of the file holding the shared copy, e.g.,
+     *   "/dev/shm/egm2008-1.pgm".
+     * @exception GeographicErr if the file can't be created or mapped or if
+     *   memory mapping is not supported on this system.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     *
+     * If \e filename exists and holds a pgm file made by CacheShared from
+     * the same data set (the same data file, description, date, offset, and
+     * scale, recorded in its header) with the same dimensions as the data
+     * for this Geoid, it is mapped into memory (as with CacheMap).
+     * Otherwise, the data is read (and decompressed, in the case of a
+     * compressed data file) and written to \e filename, which is then
+     * mapped.  The file is written under a temporary name and renamed, so
+     * that other processes never see a partially written file.  If \e
+     * filename is on a memory file system, such as /dev/shm on Linux, the
+     * decoded data is then held in memory just once and shared by all the
+     * processes on the host; this avoids the need for each process to call
+     * CacheAll.  This is also useful with a compressed data file, since this
+     * cannot be mapped directly.  The data in \e filename are not checked
+     * beyond its header; if the data file is replaced by one with the same
+     * header, the shared copy should be removed.  The mapping is released
+     * by CacheUnmap or by the destructor; the file is not removed.
+     **********************************************************************/
+    void CacheShared(const std::string& filename) const;
+
+    /**
+     * Release the memory mapping of the data file set up by CacheMap or
+     * CacheShared.  This never throws an error.
+     **********************************************************************/
+    void CacheUnmap() const;
+
     ///@}
 
     /** \name Compute geoid heights
@@ -324,6 +754,37 @@ namespace GeographicLib {
       return height(lat, lon, true, gradn, grade);
     }
 
+    /**
+     * Compute the geoid height at a point using a caller-supplied cell cache
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in,out] cell the cell cache to use.
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if (\e lat, \e lon) is within a successfully cached area
+     *   or if the data file is mapped.
+     * @return the height of the geoid above the ellipsoid (meters).
+     *
+     * This is the same as Geoid::operator()(real, real) except that \e cell is
+     * used instead of the cell cache in the Geoid object.  Provided that each
+     * thread uses its own Cell, several threads may call this function on the
+     * same Geoid object simultaneously; the object is regarded as a store of
+     * data which is immutable during the calls.  So the cache must not be
+     * changed (by Geoid::CacheArea, Geoid::CacheMap, etc.) while these calls
+     * are in progress.  If the data required is not in the cached area and
+     * the data file is not mapped, the data is read from the file with the
+     * reads from all threads serialized by a mutex (see
+     * Geoid::Concurrent).  Thus with Geoid::CacheMap, the operating system
+     * loads the data lazily and shares it between threads (and processes);
+     * no lock is taken and the cached area need not include all the data.
+     * The results are identical to those given by Geoid::operator()(real,
+     * real).
+     **********************************************************************/
+    Math::real operator()(real lat, real lon, Cell& cell) const {
+      real gradn, grade;
+      return height(lat, lon, false, gradn, grade, cell, true, true);
+    }
+
     /**
      * Convert a height above the geoid to a height above the ellipsoid and
      * vice versa.
@@ -345,6 +806,135 @@ namespace GeographicLib {
       return h + real(d) * height(lat, lon, true, gradn, grade);
     }
 
+    /**
+     * Compute the geoid heights for an array of points
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @param[in] n the number of points.
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if the points are within a successfully cached area or
+     *   if the data file is mapped.
+     *
+     * The points are processed in blocks of 65536.  The points in a block
+     * are sorted by grid cell so that the interpolation coefficients for
+     * each cell are computed only once per block; this is most effective if
+     * there are many points per cell.  The results are identical to calling
+     * Geoid::operator()(real, real) for each point.  This uses its own cell
+     * cache; so it may be called from several threads under the same
+     * conditions as Geoid::operator()(real, real, Cell&).
+     **********************************************************************/
+    void HeightBatch(const real lat[], const real lon[], real h[],
+                     size_t n) const;
+
+    /**
+     * Compute the geoid heights for an array of points without blocking.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @param[in] n the number of points.
+     * @param[in] done the action taken when the heights have been computed.
+     * @exception std::bad_alloc if the memory for the request can't be
+     *   allocated.
+     *
+     * If the data is held in memory (because the Geoid is thread safe or
+     * its file is mapped with CacheMap), the heights are computed with
+     * HeightBatch and \e done is called before this returns.  Otherwise the
+     * request is queued and this returns immediately; the data is read by a
+     * background thread (started by the first request), using its own file
+     * stream, and \e done is called by that thread.  \e lat, \e lon, \e h,
+     * and \e done must remain valid until then.  All the requests which are
+     * queued while the thread is reading are served together; the data is
+     * read in tiles and each tile needed by these requests is read just
+     * once.  The most recently read tiles (up to 16 MB) are retained for
+     * later requests.  Errors in reading the data are passed to \e done.
+     * The results are identical to those of HeightBatch.
+     *
+     * This may be called from several threads at once, without a Geoid::Cell,
+     * provided that the caches of the Geoid are not changed.  Thus it suits
+     * a server whose threads mustn't be stalled by reading the data file:
+     * with C++20 coroutines, \e done can resume the suspended coroutine; or
+     * \e done can set the value of a std::promise whose std::future is
+     * waited on.  (If the library was compiled without C++11 support, the
+     * heights are always computed before this returns.)  The queued requests
+     * are completed by AsyncWait or by the destructor.
+     **********************************************************************/
+    void HeightAsync(const real lat[], const real lon[], real h[], size_t n,
+                     Completion& done) const;
+
+    /**
+     * Wait for the requests made by HeightAsync to be completed.
+     *
+     * This blocks until all the requests queued by HeightAsync (including
+     * those made while waiting) are complete.  It must not be called by
+     * Completion::operator()().
+     **********************************************************************/
+    void AsyncWait() const;
+
+    /**
+     * Convert an array of heights above the geoid to heights above the
+     * ellipsoid and vice versa.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] h array of heights of the points (meters).
+     * @param[in] n the number of points.
+     * @param[in] d a Geoid::convertflag specifying the direction of the
+     *   conversion.
+     * @param[out] hout array of converted heights (meters).
+     * @exception GeographicErr if there's a problem reading the data.
+     *
+     * The results are identical to calling Geoid::ConvertHeight for each
+     * point.  The geoid heights are computed by Geoid::HeightBatch.  \e h and
+     * \e hout may be the same array.
+     **********************************************************************/
+    void ConvertHeightBatch(const real lat[], const real lon[],
+                            const real h[], size_t n, convertflag d,
+                            real hout[]) const;
+
+    /**
+     * Compute the geoid heights and gradients on a regular grid.
+     *
+     * @param[in] lat0 latitude of the first row of the grid (degrees).
+     * @param[in] dlat latitude spacing of the rows (degrees).
+     * @param[in] nlat the number of rows.
+     * @param[in] lon0 longitude of the first column of the grid (degrees).
+     * @param[in] dlon longitude spacing of the columns (degrees).
+     * @param[in] nlon the number of columns.
+     * @param[out] h array of \e nlat &times; \e nlon heights of the geoid
+     *   above the ellipsoid (meters).
+     * @param[out] gradn array of \e nlat &times; \e nlon northerly gradients
+     *   (dimensionless).
+     * @param[out] grade array of \e nlat &times; \e nlon easterly gradients
+     *   (dimensionless).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if the grid is within a successfully cached area or
+     *   if the data file is mapped.
+     *
+     * The grid point in row \e i and column \e j has latitude \e lat0 + \e
+     * i \e dlat and longitude \e lon0 + \e j \e dlon, and its results are
+     * stored in element \e i \e nlon + \e j of the output arrays.  The
+     * results are identical to calling Geoid::operator()(real, real) (or
+     * Geoid::operator()(real, real, real&, real&), if the gradients are
+     * requested) for each grid point.  The grid is evaluated a row at a
+     * time with a cell cache for each column; so the interpolating
+     * polynomial for a cell of the data is computed just once when the grid
+     * is finer than the data (provided that, at most, two columns of the
+     * grid lie in one cell).  \e gradn and \e grade may be null pointers
+     * (the default), in which case the gradients are not computed; they must
+     * both be supplied to compute the gradients.  This may be called from
+     * several threads under the same conditions as
+     * Geoid::operator()(real, real, Cell&).  The use of this facility to
+     * compute gradients is <b>DEPRECATED</b>; see the class documentation.
+     **********************************************************************/
+    void HeightGrid(real lat0, real dlat, size_t nlat,
+                    real lon0, real dlon, size_t nlon,
+                    real h[], real gradn[] = 0, real grade[] = 0) const;
+
     ///@}
 
     /** \name Inspector functions
@@ -427,6 +1017,54 @@ namespace GeographicLib {
      **********************************************************************/
     bool Cache() const { return _cache; }
 
+    /**
+     * @return true if interpolation coefficients have been computed (see
+     *   CacheCoefficients).
+     **********************************************************************/
+    bool CoefficientsCached() const { return !_coeffs.empty(); }
+
+    /**
+     * @return true if the data file is mapped into memory (see CacheMap).
+     **********************************************************************/
+    bool CacheMapped() const { return _map != 0; }
+
+    /**
+     * @return true if a tile cache is active.
+     **********************************************************************/
+    bool CacheTiled() const { return _tiles != 0; }
+
+    /**
+     * @return true if the data file is compressed (see \ref geoidformat).
+     **********************************************************************/
+    bool Compressed() const { return _compressed; }
+
+    /**
+     * @return the number of accesses to data which were satisfied by the tile
+     *   cache.
+     **********************************************************************/
+    unsigned long TileHits() const;
+
+    /**
+     * @return the number of accesses to data which required a tile to be read
+     *   from the data file.
+     **********************************************************************/
+    unsigned long TileMisses() const;
+
+    /**
+     * @return the number of tiles discarded from the tile cache to keep
+     *   within the memory budget.
+     **********************************************************************/
+    unsigned long TileEvictions() const;
+
+    /**
+     * @return true if Geoid::operator()(real, real, Cell&) may be called
+     *   simultaneously from several threads.  This is the case if the library
+     *   was compiled with C++11 support (which is needed to serialize the
+     *   reads from the data file), if the object is thread safe, or if the
+     *   data file is mapped.
+     **********************************************************************/
+    bool Concurrent() const;
+
     /**
      * @return west edge of the cached area; the cache includes this edge.
      **********************************************************************/
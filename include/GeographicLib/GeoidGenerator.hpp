@@ -0,0 +1,138 @@
+/**
+ * \file GeoidGenerator.hpp
+ * \brief Header for GeographicLib::GeoidGenerator class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEOIDGENERATOR_HPP)
+#define GEOGRAPHICLIB_GEOIDGENERATOR_HPP 1
+
+#include <string>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geoid.hpp>
+
+namespace GeographicLib {
+
+  class GravityModel;
+
+  /**
+   * \brief Geoid grids computed on demand from a gravity model
+   *
+   * This is a Geoid::Source which computes the geoid heights of a grid with
+   * a given number of points per degree from a GravityModel.  A Geoid
+   * constructed from it then evaluates the geoid height by interpolating
+   * into this grid, exactly as with a data file.  This allows a geoid grid
+   * to be used at a resolution (or for a model) for which there's no data
+   * file, without computing the whole grid in advance: a tile is computed
+   * only when the Geoid first needs it.  The heights for each row of a tile
+   * are found with GravityCircle::GeoidHeightRow (so the cost of the
+   * spherical harmonic sums is shared by the points of the row) and the
+   * rows may be computed in parallel (using Executor::For).
+   *
+   * If a cache directory is given, each tile is written there when it's
+   * computed and it is read from there when it's needed again (in this or a
+   * later run of the program, or by another process).  The tiles are held as
+   * arrays of big-endian floats (see Utility::writearray) in files named
+   * <i>name</i>-<i>x0</i>-<i>y0</i>-<i>w</i>-<i>h</i>.dat, where \e name is
+   * given by GeoidGenerator::Name, and (\e x0, \e y0) and \e w &times; \e h
+   * are the position and size of the tile.  (The directory must exist.)
+   * Files are written to a temporary file which is then renamed, so that a
+   * partial file is never read.
+   *
+   * The heights are stored in the Geoid with the offset and scale of the
+   * standard geoid data files, -108 m and 0.003 m; heights outside [-108 m,
+   * 88.6 m] are clamped into this range.  The GravityModel must outlive the
+   * GeoidGenerator and this must outlive the Geoid.
+   *
+   * Example of use:
+   * \include example-GeoidGenerator.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeoidGenerator : public Geoid::Source {
+  private:
+    typedef Math::real real;
+    const GravityModel& _model;
+    int _ndeg, _tilesize, _nthreads;
+    std::string _cachedir, _name;
+    class Rows;
+    void Compute(int x0, int y0, int w, int h, real N[]) const;
+    GeoidGenerator& operator=(const GeoidGenerator&);
+  public:
+
+    /**
+     * Construct a GeoidGenerator.
+     *
+     * @param[in] model the gravity model.
+     * @param[in] ndeg the number of grid points per degree, in [1, 3600].
+     * @param[in] cachedir (optional) the directory in which the tiles are
+     *   kept; if this is empty (the default), the tiles are not saved.
+     * @param[in] tilesize (optional) the size of the tiles (default 256).
+     * @param[in] nthreads (optional) the number of threads used to compute
+     *   the rows of a tile (default 1).
+     * @exception GeographicErr if \e ndeg or \e tilesize is out of range.
+     *
+     * The grid has 360 \e ndeg columns and 180 \e ndeg + 1 rows.  The cost
+     * of computing a row of a tile is dominated by the construction of a
+     * GravityCircle, proportional to <i>N</i><sup>2</sup> for a model of
+     * degree \e N; so it's best to use a tile size which is not too much
+     * smaller than the width of the grid.
+     **********************************************************************/
+    GeoidGenerator(const GravityModel& model, int ndeg,
+                   const std::string& cachedir = "", int tilesize = 256,
+                   int nthreads = 1);
+
+    /** \name Implementation of Geoid::Source
+     **********************************************************************/
+    ///@{
+    /**
+     * @return 360 \e ndeg, the number of columns.
+     **********************************************************************/
+    int Width() const { return 360 * _ndeg; }
+    /**
+     * @return 180 \e ndeg + 1, the number of rows.
+     **********************************************************************/
+    int Height() const { return 180 * _ndeg + 1; }
+    /**
+     * @return the tile size.
+     **********************************************************************/
+    int TileSize() const { return _tilesize; }
+    /**
+     * @return the offset, -108 m.
+     **********************************************************************/
+    Math::real Offset() const { return -108; }
+    /**
+     * @return the scale, 0.003 m.
+     **********************************************************************/
+    Math::real Scale() const { return real(0.003); }
+    /**
+     * @return the name of the grid; this is the name of the gravity model
+     *   followed by its degree and \e ndeg, e.g., "egm96-n360-12".
+     **********************************************************************/
+    std::string Name() const { return _name; }
+    /**
+     * @return a description of the grid.
+     **********************************************************************/
+    std::string Description() const;
+    /**
+     * Compute the geoid heights for a block of the grid, reading them from
+     * the cache directory if possible.
+     *
+     * @param[in] x0 the first column of the block.
+     * @param[in] y0 the first row of the block.
+     * @param[in] w the number of columns of the block.
+     * @param[in] h the number of rows of the block.
+     * @param[out] N the \e w &times; \e h heights (meters), in row-major
+     *   order.
+     * @exception GeographicErr if a computed block can't be saved in the
+     *   cache directory.
+     **********************************************************************/
+    void Heights(int x0, int y0, int w, int h, Math::real N[]) const;
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEOIDGENERATOR_HPP
@@ -28,6 +28,10 @@ namespace GeographicLib {
    * Use GravityModel::Circle to create a GravityCircle object.  (The
    * constructor for this class is private.)
    *
+   * Once the object is constructed, evaluating the field at a point
+   * doesn't allocate memory; the rows reuse per-thread scratch space as
+   * described in CircularEngine.
+   *
    * See \ref gravityparallel for an example of using GravityCircle (together
    * with OpenMP) to speed up the computation of geoid heights.
    *
@@ -245,6 +249,68 @@ namespace GeographicLib {
 
     ///@}
 
+    /** \name Compute gravitational quantities for a row of longitudes
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the gravity for a row of equally spaced longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] W array of \e W at longitudes \e lon0 + \e j \e dlon for
+     *   \e j = 0, 1, ..., \e nlon &minus; 1.
+     * @param[out] gx array of the easterly components of the acceleration.
+     * @param[out] gy array of the northerly components of the acceleration.
+     * @param[out] gz array of the upward components of the acceleration.
+     * @exception std::bad_alloc if memory for the FFT can't be allocated.
+     *
+     * This gives the same results as GravityCircle::Gravity for each longitude
+     * (to within roundoff).  The sum over order is done with
+     * CircularEngine::EvaluateRow, which uses a fast Fourier transform when
+     * 360&deg;/\e dlon is an integer; this is much faster for rasterizing a
+     * grid with a high degree model.
+     **********************************************************************/
+    void GravityRow(real lon0, real dlon, int nlon,
+                    real W[], real gx[], real gy[], real gz[]) const;
+
+    /**
+     * Evaluate the gravity disturbance vector for a row of equally spaced
+     * longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] T array of the disturbing potentials.
+     * @param[out] deltax array of the easterly components of the disturbance
+     *   vector.
+     * @param[out] deltay array of the northerly components of the disturbance
+     *   vector.
+     * @param[out] deltaz array of the upward components of the disturbance
+     *   vector.
+     * @exception std::bad_alloc if memory for the FFT can't be allocated.
+     *
+     * This gives the same results as GravityCircle::Disturbance for each
+     * longitude (to within roundoff); see GravityCircle::GravityRow.
+     **********************************************************************/
+    void DisturbanceRow(real lon0, real dlon, int nlon, real T[],
+                        real deltax[], real deltay[], real deltaz[]) const;
+
+    /**
+     * Evaluate the geoid height for a row of equally spaced longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] N array of the geoid heights (meters).
+     * @exception std::bad_alloc if memory for the FFT can't be allocated.
+     *
+     * This gives the same results as GravityCircle::GeoidHeight for each
+     * longitude (to within roundoff); see GravityCircle::GravityRow.
+     **********************************************************************/
+    void GeoidHeightRow(real lon0, real dlon, int nlon, real N[]) const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,239 @@
+/**
+ * \file GravityCircleCache.hpp
+ * \brief Header for GeographicLib::GravityCircleCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GRAVITYCIRCLECACHE_HPP)
+#define GEOGRAPHICLIB_GRAVITYCIRCLECACHE_HPP 1
+
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A cache of recently used gravity circles
+   *
+   * Constructing a GravityCircle costs about as much as an evaluation of
+   * GravityModel::Gravity while evaluating the circle at a particular
+   * longitude costs about 1/<i>N</i> of this (where \e N is the degree of
+   * the model).  Applications which repeatedly visit the same latitudes
+   * (e.g., an aircraft in a holding pattern or a satellite ground track on a
+   * repeat cycle) can avoid the construction by obtaining the circles from a
+   * GravityCircleCache.  This holds up to a
+   * given number of GravityCircle objects, keyed on (\e lat, \e h); when it
+   * is full, the least recently used circle is discarded.
+   *
+   * The keys may be quantized by specifying the spacings \e dlat and \e dh
+   * of a grid of latitudes and heights.  GravityCircleCache::Circle then
+   * returns the circle for the nearest grid point, while the evaluation
+   * functions, e.g., GravityCircleCache::Gravity, interpolate linearly
+   * between the circles at the surrounding grid points.  The error in the
+   * interpolation is bounded by <i>d</i><sup>2</sup>/8 times the second
+   * derivative of the quantity in the direction of the grid spacing \e d.
+   * For a degree 2160 model, such as egm2008, \e dlat = 0.001&deg; and \e dh
+   * = 10 m give errors in the gravity disturbance of about 5 &mu;Gal
+   * (dominated by \e dlat); the errors in the geoid height are about 0.01 mm
+   * with \e dlat = 0.001&deg; and about 1 mm with \e dlat = 0.01&deg;.
+   * With \e dlat = \e dh = 0 (the default), no quantization or
+   * interpolation is done and the results are identical to those given by
+   * the circles returned by GravityModel::Circle.
+   *
+   * If the library was compiled with C++11 support, the member functions
+   * lock an internal mutex so that a single cache can be shared by several
+   * threads; see GravityCircleCache::ThreadSafe.  The construction of new
+   * circles and the evaluation of the cached circles take place outside the
+   * lock.
+   *
+   * Example of use:
+   * \include example-GravityCircleCache.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GravityCircleCache {
+  private:
+    typedef Math::real real;
+    class Impl;
+    Impl* _impl;
+    // copy constructor not allowed
+    GravityCircleCache(const GravityCircleCache&);
+    // nor copy assignment
+    GravityCircleCache& operator=(const GravityCircleCache&);
+  public:
+
+    /**
+     * Constructor for GravityCircleCache.
+     *
+     * @param[in] g the GravityModel used to construct the circles.
+     * @param[in] capacity the maximum number of circles held by the cache.
+     * @param[in] caps bitor'ed combination of GravityModel::mask values
+     *   specifying the capabilities of the cached circles (default
+     *   GravityModel::ALL).
+     * @param[in] dlat the spacing of the grid of latitudes (degrees); if 0
+     *   (the default), the latitudes are not quantized.
+     * @param[in] dh the spacing of the grid of heights (meters); if 0 (the
+     *   default), the heights are not quantized.
+     * @exception GeographicErr if \e dlat or \e dh is negative or not finite.
+     * @exception std::bad_alloc if the memory for the cache can't be
+     *   allocated.
+     *
+     * A reference to \e g is stored; so \e g must outlive the cache.  If \e
+     * capacity = 0, no circles are cached.  Interpolation requires up to 4
+     * circles; so \e capacity should be much larger than this.
+     **********************************************************************/
+    GravityCircleCache(const GravityModel& g, size_t capacity,
+                       unsigned caps = GravityModel::ALL,
+                       real dlat = 0, real dh = 0);
+
+    /**
+     * The destructor.
+     **********************************************************************/
+    ~GravityCircleCache();
+
+    /**
+     * Return a gravity circle, from the cache if possible.
+     *
+     * @param[in] lat latitude of the circle (degrees).
+     * @param[in] h the height of the circle above the ellipsoid (meters).
+     * @return a GravityCircle equivalent to g.Circle(\e lat, \e h, \e
+     *   caps) with \e lat and \e h replaced by the nearest grid values.
+     *
+     * If any of the arguments is a NaN, the circle is constructed and not
+     * cached.
+     **********************************************************************/
+    GravityCircle Circle(real lat, real h);
+
+    /**
+     * Evaluate the gravity at an arbitrary point.
+     *
+     * @param[in] lat the geographic latitude (degrees).
+     * @param[in] lon the geographic longitude (degrees).
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] gx the easterly component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gy the northerly component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gz the upward component of the acceleration
+     *   (m s<sup>&minus;2</sup>); this is usually negative.
+     * @return \e W the sum of the gravitational and centrifugal potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * See GravityModel::Gravity.  This requires \e caps to include
+     * GravityModel::GRAVITY.
+     **********************************************************************/
+    Math::real Gravity(real lat, real lon, real h,
+                       real& gx, real& gy, real& gz);
+
+    /**
+     * Evaluate the gravity disturbance vector at an arbitrary point.
+     *
+     * @param[in] lat the geographic latitude (degrees).
+     * @param[in] lon the geographic longitude (degrees).
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[out] deltax the easterly component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltay the northerly component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] deltaz the upward component of the disturbance vector
+     *   (m s<sup>&minus;2</sup>).
+     * @return \e T the corresponding disturbing potential
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * See GravityModel::Disturbance.  This requires \e caps to include
+     * GravityModel::DISTURBANCE.
+     **********************************************************************/
+    Math::real Disturbance(real lat, real lon, real h,
+                           real& deltax, real& deltay, real& deltaz);
+
+    /**
+     * Evaluate the geoid height.
+     *
+     * @param[in] lat the geographic latitude (degrees).
+     * @param[in] lon the geographic longitude (degrees).
+     * @return \e N the height of the geoid above the reference ellipsoid
+     *   (meters).
+     *
+     * See GravityModel::GeoidHeight.  This requires \e caps to include
+     * GravityModel::GEOID_HEIGHT.  Only the circles with \e h = 0 are used.
+     **********************************************************************/
+    Math::real GeoidHeight(real lat, real lon);
+
+    /**
+     * Remove all the circles from the cache.  The hit and miss counters are
+     * not changed.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Change the capacity of the cache.
+     *
+     * @param[in] capacity the new maximum number of circles.
+     *
+     * If the cache holds more than \e capacity circles, the least recently
+     * used ones are discarded.
+     **********************************************************************/
+    void SetCapacity(size_t capacity);
+
+    /**
+     * Reset the hit and miss counters to zero.
+     **********************************************************************/
+    void ResetCounters();
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the maximum number of circles held by the cache.
+     **********************************************************************/
+    size_t Capacity() const;
+
+    /**
+     * @return the number of circles currently in the cache.
+     **********************************************************************/
+    size_t Size() const;
+
+    /**
+     * @return the number of requests for a circle (including those made by
+     *   the evaluation functions) which were satisfied from the cache.
+     **********************************************************************/
+    unsigned long Hits() const;
+
+    /**
+     * @return the number of requests for a circle (including those made by
+     *   the evaluation functions) which required a new circle to be
+     *   constructed.
+     **********************************************************************/
+    unsigned long Misses() const;
+
+    /**
+     * @return the capabilities of the cached circles.  This is the \e caps
+     *   value used in the constructor.
+     **********************************************************************/
+    unsigned Capabilities() const;
+
+    /**
+     * @return \e dlat the spacing of the grid of latitudes (degrees).
+     **********************************************************************/
+    Math::real LatitudeSpacing() const;
+
+    /**
+     * @return \e dh the spacing of the grid of heights (meters).
+     **********************************************************************/
+    Math::real HeightSpacing() const;
+
+    /**
+     * @return true if the cache may be used by several threads
+     *   simultaneously.  This depends on whether the library was compiled
+     *   with C++11 support.
+     **********************************************************************/
+    static bool ThreadSafe();
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GRAVITYCIRCLECACHE_HPP
@@ -0,0 +1,326 @@
+/**
+ * \file GravityGrid.hpp
+ * \brief Header for GeographicLib::GravityGrid class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GRAVITYGRID_HPP)
+#define GEOGRAPHICLIB_GRAVITYGRID_HPP 1
+
+#include <string>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(MPI_VERSION) || defined(DOXYGEN)
+// MPI_VERSION is defined by mpi.h; this must be included first to get the
+// MPI driver, GravityGrid::WriteMPI.
+#  include <sstream>
+#endif
+
+namespace GeographicLib {
+
+  class GravityModel;
+
+  /**
+   * \brief A regular grid of a gravity field
+   *
+   * This evaluates a gravity field (the gravity, the gravity disturbance,
+   * the gravity anomaly and deflection of the vertical, or the geoid height)
+   * on a regular latitude-longitude grid at constant height, as needed to
+   * synthesize a global grid from a high degree model.  Row \e r of the
+   * grid is at latitude \e north &minus; \e r \e step and column \e j is at
+   * longitude \e west + \e j \e step.  The rows are independent: each is
+   * evaluated with a GravityCircle (constructed for several rows at a time
+   * with GravityModel::LatitudeCircles) and its row functions, which use a
+   * fast Fourier transform when this is faster.  So the work can be split
+   * by rows among the threads of a process (with the \e nthreads argument
+   * of GravityGrid::Rows) and among the processes of a cluster (with
+   * GravityGrid::Band).
+   *
+   * The values are in the units of the output of the Gravity utility: m
+   * s<sup>&minus;2</sup> for the gravity; mGal for the gravity disturbance
+   * and the gravity anomaly; arcseconds for the deflection of the vertical;
+   * meters for the geoid height.  The grid file written by
+   * GravityGrid::Encode (and by the <b>\--binary-output</b> option of
+   * <a href="Gravity.1.html">Gravity</a>) consists of the records for the
+   * points, in row-major order, each record being the GravityGrid::Fields()
+   * values for the point as little-endian doubles.  So the rows of the
+   * file are at fixed offsets (GravityGrid::Offset) and a band of rows can
+   * be written independently of the others.
+   *
+   * If the program including this header is compiled with MPI (and mpi.h is
+   * included before this header), GravityGrid::WriteMPI distributes the
+   * bands of a grid across the ranks of an MPI communicator and writes them
+   * to a file with MPI-IO.  The library itself needn't be compiled with
+   * MPI.  Construct the GravityModel with \e map = true so that the ranks
+   * on a node share a single copy of the coefficients (in the page cache)
+   * instead of each reading its own.
+   *
+   * The GravityModel must outlive the GravityGrid.
+   *
+   * Example of use:
+   * \include example-GravityGrid.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GravityGrid {
+  private:
+    typedef Math::real real;
+    const GravityModel* _g;
+    unsigned _quantity;
+    real _north, _west, _step, _h;
+    int _nlat, _nlon;
+    // How many rows' GravityCircles to construct together
+    static const int nrows_ = 8;
+    void RowRange(int r0, int r1, real* const v[]) const;
+  public:
+
+    /**
+     * The quantities which can be computed.
+     **********************************************************************/
+    enum quantity {
+      /**
+       * The gravity (3 fields, the easterly, northerly, and up components).
+       * @hideinitializer
+       **********************************************************************/
+      GRAVITY = 0,
+      /**
+       * The gravity disturbance (3 fields, the easterly, northerly, and up
+       * components).
+       * @hideinitializer
+       **********************************************************************/
+      DISTURBANCE = 1,
+      /**
+       * The gravity anomaly and the deflection of the vertical in the
+       * spherical approximation (3 fields, the anomaly, and the northerly
+       * and easterly components of the deflection).
+       * @hideinitializer
+       **********************************************************************/
+      ANOMALY = 2,
+      /**
+       * The geoid height (1 field).
+       * @hideinitializer
+       **********************************************************************/
+      GEOID_HEIGHT = 3,
+    };
+
+    /**
+     * Constructor for GravityGrid.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] q the quantity to compute (see GravityGrid::quantity).
+     * @param[in] north the latitude of the first row (degrees).
+     * @param[in] west the longitude of the first column (degrees).
+     * @param[in] step the spacing of the grid (degrees).
+     * @param[in] nlat the number of rows.
+     * @param[in] nlon the number of columns.
+     * @param[in] h the height above the ellipsoid (meters); default 0.
+     * @exception GeographicErr if \e q is invalid, if \e north is not in
+     *   [&minus;90&deg;, 90&deg;], if \e step is not positive, if \e nlat or
+     *   \e nlon is not positive, if \e h isn't finite, or if \e h is nonzero
+     *   and \e q = GravityGrid::GEOID_HEIGHT.
+     *
+     * Latitudes of rows south of the south pole are replaced by
+     * &minus;90&deg;.
+     **********************************************************************/
+    GravityGrid(const GravityModel& g, unsigned q,
+                real north, real west, real step, int nlat, int nlon,
+                real h = 0);
+
+    /**
+     * Evaluate a range of rows of the grid.
+     *
+     * @param[in] r0 the first row.
+     * @param[in] r1 one past the last row.
+     * @param[out] v the arrays for the values; for \e k in [0,
+     *   GravityGrid::Fields()), field \e k of the point in row \e r and
+     *   column \e j is put in
+     *   <i>v</i>[<i>k</i>][(<i>r</i> &minus; <i>r0</i>) <i>nlon</i> +
+     *   <i>j</i>].
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception GeographicErr if \e r0 and \e r1 don't make a range of
+     *   rows of the grid.
+     *
+     * The rows are divided into \e nthreads contiguous ranges which are run
+     * by the current Executor.  The results do not depend on \e nthreads.
+     **********************************************************************/
+    void Rows(int r0, int r1, real* const v[], int nthreads = 1) const;
+
+    /**
+     * Convert rows of values to the format of a grid file.
+     *
+     * @param[in] v the values for \e nr rows as returned by
+     *   GravityGrid::Rows.
+     * @param[in] nr the number of rows.
+     * @param[out] buf the records for the rows as little-endian doubles
+     *   (GravityGrid::Offset(\e nr) bytes).
+     **********************************************************************/
+    void Encode(const real* const v[], int nr, std::vector<char>& buf) const;
+
+    /**
+     * @param[in] r a row of the grid (0 &le; \e r &le; \e nlat).
+     * @return the offset of row \e r in the grid file (bytes).  With \e r =
+     *   \e nlat, this is the size of the file.
+     **********************************************************************/
+    unsigned long long Offset(int r) const {
+      return (unsigned long long)(r) * _nlon * Fields() * sizeof(double);
+    }
+
+    /**
+     * Divide the rows of a grid into bands.
+     *
+     * @param[in] nlat the number of rows.
+     * @param[in] nbands the number of bands.
+     * @param[in] k the band required, in [0, \e nbands).
+     * @param[out] r0 the first row of band \e k.
+     * @param[out] r1 one past the last row of band \e k.
+     *
+     * The bands are contiguous and in order and their sizes differ by at
+     * most one row.  Because each row costs about the same to evaluate,
+     * this balances the work of the bands.
+     **********************************************************************/
+    static void Band(int nlat, int nbands, int k, int& r0, int& r1) {
+      r0 = int((long long)(nlat) * k / nbands);
+      r1 = int((long long)(nlat) * (k + 1) / nbands);
+    }
+
+#if defined(MPI_VERSION) || defined(DOXYGEN)
+    /**
+     * Compute the grid with MPI and write it to a file.
+     *
+     * @param[in] filename the name of the grid file.
+     * @param[in] comm the MPI communicator.
+     * @param[in] nthreads the number of threads to use in each rank (default
+     *   1).
+     * @exception GeographicErr if the file can't be written or if the
+     *   evaluation of the grid fails in any rank.
+     *
+     * This is a collective operation: it must be called by every rank of \e
+     * comm with the same arguments.  Each rank evaluates its band of rows
+     * (given by GravityGrid::Band with the rank and the size of \e comm) in
+     * blocks of 8 \e nthreads rows and writes each block at its offset in
+     * the file with MPI_File_write_at.  The file is the same as that given
+     * by writing the output of GravityGrid::Encode for all the rows.  If an
+     * error occurs in any rank, the exception is thrown in all the ranks
+     * (after the file has been closed).
+     *
+     * This is only defined if mpi.h is included before GravityGrid.hpp.
+     **********************************************************************/
+    void WriteMPI(const std::string& filename, MPI_Comm comm,
+                  int nthreads = 1) const {
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      MPI_File fh;
+      if (MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+                        MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                        &fh) != MPI_SUCCESS)
+        throw GeographicErr("Cannot open " + filename + " for writing");
+      std::string err;
+      // Truncate an existing file; this is collective
+      if (MPI_File_set_size(fh, MPI_Offset(Offset(_nlat))) != MPI_SUCCESS)
+        err = "Cannot set the size of " + filename;
+      int r0, r1;
+      Band(_nlat, size, rank, r0, r1);
+      const int nf = Fields(), block = nrows_ * (nthreads > 1 ? nthreads : 1);
+      try {
+        const size_t nblock = size_t(block) * _nlon;
+        std::vector<real> vals(nf * nblock);
+        real* v[3];
+        for (int k = 0; k < nf; ++k) v[k] = &vals[k * nblock];
+        std::vector<char> buf;
+        for (int r = r0; err.empty() && r < r1; r += block) {
+          int nr = (r1 - r < block ? r1 - r : block);
+          Rows(r, r + nr, v, nthreads);
+          Encode(v, nr, buf);
+          MPI_Status status;
+          if (MPI_File_write_at(fh, MPI_Offset(Offset(r)), &buf[0],
+                                int(buf.size()), MPI_BYTE, &status)
+              != MPI_SUCCESS)
+            err = "Error writing " + filename;
+        }
+      }
+      catch (const std::exception& e) {
+        err = e.what();
+        if (err.empty()) err = "Unknown error";
+      }
+      MPI_File_close(&fh);
+      // Find the first rank with an error, if any
+      int bad = err.empty() ? size : rank, first;
+      MPI_Allreduce(&bad, &first, 1, MPI_INT, MPI_MIN, comm);
+      if (first < size) {
+        if (rank == first)
+          throw GeographicErr(err);
+        std::ostringstream str;
+        str << "Error in rank " << first;
+        throw GeographicErr(str.str());
+      }
+    }
+#endif
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the quantity computed (see GravityGrid::quantity).
+     **********************************************************************/
+    unsigned Quantity() const { return _quantity; }
+
+    /**
+     * @return the number of fields per point, 1 for
+     *   GravityGrid::GEOID_HEIGHT and 3 otherwise.
+     **********************************************************************/
+    int Fields() const { return _quantity == GEOID_HEIGHT ? 1 : 3; }
+
+    /**
+     * @return \e north the latitude of the first row (degrees).
+     **********************************************************************/
+    Math::real North() const { return _north; }
+
+    /**
+     * @return \e west the longitude of the first column (degrees).
+     **********************************************************************/
+    Math::real West() const { return _west; }
+
+    /**
+     * @return \e step the spacing of the grid (degrees).
+     **********************************************************************/
+    Math::real Step() const { return _step; }
+
+    /**
+     * @return \e h the height of the grid (meters).
+     **********************************************************************/
+    Math::real Height() const { return _h; }
+
+    /**
+     * @return \e nlat the number of rows.
+     **********************************************************************/
+    int RowCount() const { return _nlat; }
+
+    /**
+     * @return \e nlon the number of columns.
+     **********************************************************************/
+    int ColumnCount() const { return _nlon; }
+
+    /**
+     * @param[in] r a row of the grid.
+     * @return the latitude of row \e r (degrees).
+     **********************************************************************/
+    Math::real Latitude(int r) const {
+      real lat = _north - r * _step;
+      return lat < -90 ? real(-90) : lat;
+    }
+
+    /**
+     * @param[in] j a column of the grid.
+     * @return the longitude of column \e j (degrees).
+     **********************************************************************/
+    Math::real Longitude(int j) const { return _west + j * _step; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GRAVITYGRID_HPP
@@ -89,15 +89,52 @@ namespace GeographicLib {
     real _amodel, _GMmodel, _zeta0, _corrmult;
     SphericalHarmonic::normalization _norm;
     NormalGravity _earth;
-    std::vector<real> _Cx, _Sx, _CC, _CS, _zonal;
+    // The model coefficients interleaved; see SphericalEngine::coeff::pack
+    std::vector<real> _CSx, _CC, _CS, _zonal;
+    // The model coefficients stored as floats (if requested)
+    std::vector<float> _CSf;
     real _dzonal0;              // A left over contribution to _zonal.
     SphericalHarmonic _gravitational;
     SphericalHarmonic1 _disturbing;
     SphericalHarmonic _correction;
+    // The memory mapped coefficient file (if any)
+    char* _map;
+    unsigned long long _maplen;
+    void* _maphandle;
     void ReadMetadata(const std::string& name);
+    bool MapCoefficients(const std::string& coeff, bool hugepages);
+    void SetDisturbing();
+    GravityCircle MakeCircle(real lat, real h, unsigned caps,
+                             real X, real Y, real Z, const real M[],
+                             const CircularEngine& gravitational,
+                             const CircularEngine& disturbing,
+                             const CircularEngine& correction) const;
     Math::real InternalT(real X, real Y, real Z,
                          real& deltaX, real& deltaY, real& deltaZ,
                          bool gradp, bool correct) const;
+    Math::real FinishT(real X, real Y, real Z, real T,
+                       real& deltaX, real& deltaY, real& deltaZ,
+                       bool gradp, bool correct) const;
+    void Anomaly(real X, real Y, real Z, const real M[], real T,
+                 real deltax, real deltay, real deltaz,
+                 real& Dg01, real& xi, real& eta) const;
+    // The quantities computed by the batch functions
+    enum batchtype {
+      BATCH_GRAVITY,
+      BATCH_DISTURBANCE,
+      BATCH_GEOIDHEIGHT,
+      BATCH_ANOMALY,
+    };
+    // The number of points evaluated together by BatchRange
+    static const int batchsize_ = 64;
+    void BatchRange(batchtype kind,
+                    const real lat[], const real lon[], const real h[],
+                    size_t i0, size_t i1,
+                    real r0[], real r1[], real r2[], real r3[]) const;
+    void Batch(batchtype kind,
+               const real lat[], const real lon[], const real h[], size_t n,
+               real r0[], real r1[], real r2[], real r3[], int nthreads)
+      const;
     GravityModel(const GravityModel&); // copy constructor not allowed
     GravityModel& operator=(const GravityModel&); // nor copy assignment
 
@@ -165,6 +202,12 @@ namespace GeographicLib {
      *
      * @param[in] name the name of the model.
      * @param[in] path (optional) directory for data file.
+     * @param[in] map (optional) if true, use the coefficients in place in a
+     *   memory mapping of the coefficient file (default false).
+     * @param[in] single (optional) if true, store the coefficients of the
+     *   model as floats (default false).
+     * @param[in] hugepages (optional) if true, ask for the coefficients to be
+     *   stored in huge pages (default false).
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt.
      * @exception std::bad_alloc if the memory necessary for storing the model
@@ -179,9 +222,71 @@ namespace GeographicLib {
      * model.  The coefficients for the spherical harmonic sums are obtained
      * from a file obtained by appending ".cof" to metadata file (so the
      * filename ends in ".egm.cof").
+     *
+     * The coefficient file consists of aligned little-endian doubles; so, if
+     * \e map is true and the host is little-endian with \e real = double
+     * (see SphericalEngine::coeff::mappable), the file is mapped into memory
+     * copy-on-write (see Utility::mapfile) and the coefficients are used
+     * without being read or copied.  The construction is then nearly
+     * instantaneous (the pages of the file are read on demand) and the memory
+     * for the coefficients (about 80 MB for egm2008) is shared between all
+     * the processes using the model.  The results are identical to those
+     * obtained with \e map = false.  If the file can't be mapped, it is read
+     * as usual; use GravityModel::Mapped to check whether the mapping was
+     * made.
+     *
+     * If \e single is true, the coefficients of the gravitational potential
+     * are stored as floats (see SphericalEngine::coeff::coeff(const float*,
+     * int, int)) while the sums are still accumulated in \e real; \e map is
+     * then ignored.  This halves the memory for the coefficients (to about 40
+     * MB for egm2008) and the memory traffic when evaluating the model; this
+     * speeds up the evaluation of high degree models by about 5%.  The
+     * relative error in each coefficient is at most 6 &times;
+     * 10<sup>&minus;8</sup>, which is well below the uncertainty of the
+     * coefficients of any current model.  For a
+     * model of degree 2159 with the power spectrum of egm2008, the resulting
+     * errors are less than 0.2 mm in the geoid height and 0.3 &mu;Gal in the
+     * gravity disturbance.  The small correction used for the geoid height is
+     * always stored in \e real.
+     *
+     * If \e hugepages is true, the memory for the coefficients of the
+     * gravitational potential (or the mapping of the file) is requested to
+     * be backed by huge pages (see Utility::advisehugepages).  This reduces
+     * the TLB misses incurred in evaluating a high degree model and is
+     * worthwhile for egm2008 when many points are evaluated.
      **********************************************************************/
     explicit GravityModel(const std::string& name,
-                          const std::string& path = "");
+                          const std::string& path = "", bool map = false,
+                          bool single = false, bool hugepages = false);
+
+    /**
+     * Construct a truncated view of a gravity model.
+     *
+     * @param[in] g the gravity model.
+     * @param[in] Nmax the maximum degree of the truncated model; if
+     *   negative, the degree of \e g is used.
+     * @param[in] Mmax (optional) the maximum order of the truncated model;
+     *   if negative (the default), the order of \e g is used.
+     * @exception std::bad_alloc if the memory necessary for the object can't
+     *   be allocated.
+     *
+     * The result behaves like a gravity model with the coefficients of \e g
+     * with degree &gt; \e Nmax or order &gt; \e Mmax set to zero (\e Mmax
+     * is also limited by \e Nmax).  The correction for the geoid height is
+     * truncated in the same way.  Evaluating the truncated model costs about
+     * (\e Nmax / \e N)<sup>2</sup> as much as evaluating \e g, where \e N =
+     * g.Degree().  The view shares the coefficients of \e g, so it is cheap
+     * to construct (the file is not read again) and several views with
+     * different truncations may be used together; however \e g must outlive
+     * the view.
+     **********************************************************************/
+    GravityModel(const GravityModel& g, int Nmax, int Mmax = -1);
+
+    /**
+     * The destructor releases the memory mapping of the coefficient file, if
+     * any.
+     **********************************************************************/
+    ~GravityModel();
     ///@}
 
     /** \name Compute gravity in geodetic coordinates
@@ -262,6 +367,110 @@ namespace GeographicLib {
                           real& Dg01, real& xi, real& eta) const;
     ///@}
 
+    /** \name Compute gravity for arrays of points
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the gravity at an array of points.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] W array of the sums of the gravitational and centrifugal
+     *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gx array of the easterly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gy array of the northerly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gz array of the upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling GravityModel::Gravity for each
+     * point.  However, the spherical harmonic sums for groups of points are
+     * carried out together (see SphericalHarmonic::operator()(int, const
+     * real[], const real[], const real[], real[], real[], real[], real[])
+     * const), which, for high degree models, is several times faster.  The
+     * points are divided into \e nthreads contiguous ranges which are
+     * evaluated concurrently (if the library was compiled with C++11 thread
+     * support).  If the points lie on a few circles of latitude at fixed
+     * height, it is faster still to use GravityModel::Circle.
+     **********************************************************************/
+    void GravityBatch(const real lat[], const real lon[], const real h[],
+                      size_t n, real W[], real gx[], real gy[], real gz[],
+                      int nthreads = 1) const
+    { Batch(BATCH_GRAVITY, lat, lon, h, n, W, gx, gy, gz, nthreads); }
+
+    /**
+     * Evaluate the gravity disturbance vector at an array of points.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] T array of the disturbing potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] deltax array of the easterly components of the
+     *   disturbance vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltay array of the northerly components of the
+     *   disturbance vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltaz array of the upward components of the disturbance
+     *   vector (m s<sup>&minus;2</sup>).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling GravityModel::Disturbance for
+     * each point; see GravityModel::GravityBatch.
+     **********************************************************************/
+    void DisturbanceBatch(const real lat[], const real lon[], const real h[],
+                          size_t n, real T[],
+                          real deltax[], real deltay[], real deltaz[],
+                          int nthreads = 1) const
+    { Batch(BATCH_DISTURBANCE, lat, lon, h, n, T, deltax, deltay, deltaz,
+            nthreads); }
+
+    /**
+     * Evaluate the geoid height at an array of points.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] n the number of points.
+     * @param[out] N array of the heights of the geoid above the
+     *   ReferenceEllipsoid() (meters).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling GravityModel::GeoidHeight for
+     * each point; see GravityModel::GravityBatch.
+     **********************************************************************/
+    void GeoidHeightBatch(const real lat[], const real lon[], size_t n,
+                          real N[], int nthreads = 1) const
+    { Batch(BATCH_GEOIDHEIGHT, lat, lon, 0, n, N, 0, 0, 0, nthreads); }
+
+    /**
+     * Evaluate the components of the gravity anomaly vector using the
+     * spherical approximation at an array of points.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] Dg01 array of the gravity anomalies (m s<sup>&minus;2</sup>).
+     * @param[out] xi array of the northerly components of the deflection of
+     *   the vertical (degrees).
+     * @param[out] eta array of the easterly components of the deflection of
+     *   the vertical (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling GravityModel::SphericalAnomaly
+     * for each point; see GravityModel::GravityBatch.
+     **********************************************************************/
+    void SphericalAnomalyBatch(const real lat[], const real lon[],
+                               const real h[], size_t n,
+                               real Dg01[], real xi[], real eta[],
+                               int nthreads = 1) const
+    { Batch(BATCH_ANOMALY, lat, lon, h, n, Dg01, xi, eta, 0, nthreads); }
+    ///@}
+
     /** \name Compute gravity in geocentric coordinates
      **********************************************************************/
     ///@{
@@ -392,6 +601,8 @@ namespace GeographicLib {
      * @param[in] h the height of the point above the ellipsoid (meters).
      * @param[in] caps bitor'ed combination of GravityModel::mask values
      *   specifying the capabilities of the resulting GravityCircle object.
+     * @param[in] nthreads the number of threads to use in constructing the
+     *   GravityCircle (default 1).
      * @exception std::bad_alloc if the memory necessary for creating a
      *   GravityCircle can't be allocated.
      * @return a GravityCircle object whose member functions computes the
@@ -414,8 +625,70 @@ namespace GeographicLib {
      * functions will be substantially faster, especially for high-degree
      * models.  See \ref gravityparallel for an example of using GravityCircle
      * (together with OpenMP) to speed up the computation of geoid heights.
+     *
+     * The construction of the GravityCircle entails about
+     * <i>N</i><sup>2</sup> operations for each of the underlying spherical
+     * harmonic sums.  For a high degree model, this can be split between \e
+     * nthreads threads; the sums for the different orders are divided
+     * between the threads (see SphericalEngine::Circle).  The resulting
+     * GravityCircle is the same regardless of \e nthreads.
      **********************************************************************/
-    GravityCircle Circle(real lat, real h, unsigned caps = ALL) const;
+    GravityCircle Circle(real lat, real h, unsigned caps = ALL,
+                         int nthreads = 1) const;
+
+    /**
+     * Create GravityCircle objects for several heights at a given latitude.
+     *
+     * @param[in] lat latitude of the circles (degrees).
+     * @param[in] h array of the heights of the circles above the ellipsoid
+     *   (meters).
+     * @param[in] n the number of heights.
+     * @param[out] circles a vector which is set to the \e n GravityCircle
+     *   objects.
+     * @param[in] caps bitor'ed combination of GravityModel::mask values
+     *   specifying the capabilities of the resulting GravityCircle objects.
+     * @param[in] nthreads the number of threads to use in constructing the
+     *   GravityCircle objects (default 1).
+     * @exception std::bad_alloc if the memory necessary for creating the
+     *   GravityCircle objects can't be allocated.
+     *
+     * circles[i] is the same as Circle(\e lat, h[i], \e caps, \e nthreads).
+     * However, the spherical harmonic sums for several circles are carried
+     * out together with a single traversal of the coefficients (see
+     * SphericalEngine::Circles).  This is useful for evaluating the field on
+     * a three-dimensional grid; for a high degree model, it is about twice as
+     * fast as calling Circle for each height.
+     **********************************************************************/
+    void Circles(real lat, const real h[], int n,
+                 std::vector<GravityCircle>& circles, unsigned caps = ALL,
+                 int nthreads = 1) const;
+
+    /**
+     * Create GravityCircle objects for several latitudes at a given height.
+     *
+     * @param[in] lat array of the latitudes of the circles (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[in] h the height of the circles above the ellipsoid (meters).
+     * @param[out] circles a vector which is set to the \e n GravityCircle
+     *   objects.
+     * @param[in] caps bitor'ed combination of GravityModel::mask values
+     *   specifying the capabilities of the resulting GravityCircle objects.
+     * @param[in] nthreads the number of threads to use in constructing the
+     *   GravityCircle objects (default 1).
+     * @exception std::bad_alloc if the memory necessary for creating the
+     *   GravityCircle objects can't be allocated.
+     *
+     * circles[i] is the same as Circle(lat[i], \e h, \e caps, \e nthreads).
+     * This is the counterpart of GravityModel::Circles for evaluating the
+     * field on a latitude-longitude grid: the spherical harmonic sums for up
+     * to 8 rows of the grid are carried out with a single traversal of the
+     * coefficients and the rows can then be evaluated with, e.g.,
+     * GravityCircle::GeoidHeightRow.  For a high degree model, this is
+     * about twice as fast as calling Circle for each latitude.
+     **********************************************************************/
+    void LatitudeCircles(const real lat[], int n, real h,
+                         std::vector<GravityCircle>& circles,
+                         unsigned caps = ALL, int nthreads = 1) const;
     ///@}
 
     /** \name Inspector functions
@@ -454,6 +727,28 @@ namespace GeographicLib {
      **********************************************************************/
     const std::string& GravityModelDirectory() const { return _dir; }
 
+    /**
+     * @return true if the coefficient file is mapped into memory (see
+     *   GravityModel::GravityModel).
+     **********************************************************************/
+    bool Mapped() const { return _map != 0; }
+
+    /**
+     * @return true if the coefficients are stored as floats (see
+     *   GravityModel::GravityModel).
+     **********************************************************************/
+    bool Single() const { return !_CSf.empty(); }
+
+    /**
+     * @return \e Nmax the maximum degree of the gravitational sum.
+     **********************************************************************/
+    int Degree() const { return _gravitational.Coefficients().nmx(); }
+
+    /**
+     * @return \e Mmax the maximum order of the gravitational sum.
+     **********************************************************************/
+    int Order() const { return _gravitational.Coefficients().mmx(); }
+
     /**
      * @return \e a the equatorial radius of the ellipsoid (meters).
      **********************************************************************/
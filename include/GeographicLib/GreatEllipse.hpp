@@ -0,0 +1,506 @@
+/**
+ * \file GreatEllipse.hpp
+ * \brief Header for GeographicLib::GreatEllipse and
+ *   GeographicLib::GreatEllipseLine classes
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GREATELLIPSE_HPP)
+#define GEOGRAPHICLIB_GREATELLIPSE_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+
+namespace GeographicLib {
+
+  class GreatEllipseLine;
+
+  /**
+   * \brief Solve the direct and inverse great ellipse problems.
+   *
+   * A great ellipse is the intersection of the ellipsoid with a plane
+   * through its center.  The great ellipse through two points is sometimes
+   * used in place of the geodesic, e.g., for rendering and for coarse
+   * routing.  This class solves the direct and inverse problems for great
+   * ellipses with the same interface as Geodesic (for the quantities \e s12,
+   * \e azi1, and \e azi2).  No iteration is required: the great ellipse
+   * maps to a great circle on the auxiliary sphere whose latitude is the
+   * geocentric latitude, and the distance along it is given by the same
+   * series (in the second eccentricity of the great ellipse) as the
+   * geodesic distance in terms of the arc length on the auxiliary sphere.
+   * These series are accurate to roundoff for |<i>f</i>| &lt; 0.01.
+   *
+   * The great ellipse is never shorter than the geodesic.  For WGS84, the
+   * excess is about 1 cm for distances up to 1000 km and less than 10 m
+   * (1 ppm) for distances up to 9000 km; it grows to 12 ppm at 17000 km and
+   * is larger still for nearly antipodal points.  The azimuths differ from
+   * the geodesic azimuths by up to 0.015&deg; for distances up to 1000 km
+   * and by up to 0.18&deg; for distances up to 10000 km.  The great ellipse
+   * agrees with the geodesic for meridional and equatorial paths.  Great
+   * ellipses are discussed in more detail in \ref greatellipse.
+   *
+   * GreatEllipse::Inverse is about 4 times faster than Geodesic::Inverse.
+   * GreatEllipse::Direct costs about the same as Geodesic::Direct (which
+   * doesn't require iteration either).  The batch routines
+   * GreatEllipse::GenInverseBatch and GreatEllipse::GenDirectBatch compute
+   * the trigonometric functions of the inputs for blocks of problems with
+   * Math::sincosd(const T[], T[], T[], size_t), whose loops the compiler can
+   * vectorize, and may divide the work between several threads.
+   *
+   * Example of use:
+   * \include example-GreatEllipse.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GreatEllipse {
+  private:
+    typedef Math::real real;
+    friend class GreatEllipseLine;
+    real tiny_, _a, _f, _f1, _f12, _ep2;
+    // The inverse problem given the sines and cosines of the latitudes and of
+    // the longitude difference.
+    void GenInverse(real sphi1, real cphi1, real sphi2, real cphi2,
+                    real slam12, real clam12, unsigned outmask,
+                    real& s12, real& azi1, real& azi2) const;
+    // The batch calculations for the problems [i0, i1).
+    void GenInverseRange(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2,
+                         size_t i0, size_t i1, unsigned outmask,
+                         real* s12, real* azi1, real* azi2) const;
+    void GenDirectRange(const real* lat1, const real* lon1, const real* azi1,
+                        const real* s12, size_t i0, size_t i1,
+                        unsigned outmask,
+                        real* lat2, real* lon2, real* azi2) const;
+  public:
+
+    /**
+     * Bit masks for what calculations to do.  They specify which results to
+     * return in the general routines GreatEllipse::GenDirect and
+     * GreatEllipse::GenInverse.  GreatEllipseLine::mask is a duplication of
+     * this enum.  The values are the same as the corresponding values of
+     * Geodesic::mask.
+     **********************************************************************/
+    enum mask {
+      /**
+       * No output.
+       * @hideinitializer
+       **********************************************************************/
+      NONE          = 0U,
+      /**
+       * Calculate latitude \e lat2.
+       * @hideinitializer
+       **********************************************************************/
+      LATITUDE      = 1U<<7,
+      /**
+       * Calculate longitude \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONGITUDE     = 1U<<8,
+      /**
+       * Calculate azimuths \e azi1 and \e azi2.
+       * @hideinitializer
+       **********************************************************************/
+      AZIMUTH       = 1U<<9,
+      /**
+       * Calculate distance \e s12.
+       * @hideinitializer
+       **********************************************************************/
+      DISTANCE      = 1U<<10,
+      /**
+       * Unroll \e lon2 in the direct calculation.
+       * @hideinitializer
+       **********************************************************************/
+      LONG_UNROLL   = 1U<<15,
+      /**
+       * Calculate everything.  (LONG_UNROLL is not included in this mask.)
+       * @hideinitializer
+       **********************************************************************/
+      ALL           = 0x780U,
+    };
+
+    /**
+     * Constructor for a ellipsoid with
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
+     *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
+     *   flattening to 1/\e f.
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     **********************************************************************/
+    GreatEllipse(real a, real f);
+
+    /** \name Direct great ellipse problem.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the direct great ellipse problem.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * \e lat1 should be in the range [&minus;90&deg;, 90&deg;]; \e lon1 and \e
+     * azi1 should be in the range [&minus;540&deg;, 540&deg;).  The values of
+     * \e lon2 and \e azi2 returned are in the range [&minus;180&deg;,
+     * 180&deg;).
+     **********************************************************************/
+    void Direct(real lat1, real lon1, real azi1, real s12,
+                real& lat2, real& lon2, real& azi2) const {
+      GenDirect(lat1, lon1, azi1, s12, LATITUDE | LONGITUDE | AZIMUTH,
+                lat2, lon2, azi2);
+    }
+
+    /**
+     * Solve the direct great ellipse problem without the azimuth.
+     **********************************************************************/
+    void Direct(real lat1, real lon1, real azi1, real s12,
+                real& lat2, real& lon2) const {
+      real t;
+      GenDirect(lat1, lon1, azi1, s12, LATITUDE | LONGITUDE, lat2, lon2, t);
+    }
+
+    /**
+     * The general direct great ellipse problem.  GreatEllipse::Direct is
+     * defined in terms of this function.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[in] outmask a bitor'ed combination of GreatEllipse::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * The GreatEllipse::mask values possible for \e outmask are
+     * - \e outmask |= GreatEllipse::LATITUDE for the latitude \e lat2;
+     * - \e outmask |= GreatEllipse::LONGITUDE for the latitude \e lon2;
+     * - \e outmask |= GreatEllipse::AZIMUTH for the azimuth \e azi2;
+     * - \e outmask |= GreatEllipse::ALL for all of the above;
+     * - \e outmask |= GreatEllipse::LONG_UNROLL to unroll \e lon2 instead of
+     *   wrapping it into the range [&minus;180&deg;, 180&deg;).
+     * .
+     * With the GreatEllipse::LONG_UNROLL bit set, the quantity \e lon2
+     * &minus; \e lon1 indicates how many times and in what sense the great
+     * ellipse encircles the ellipsoid.
+     **********************************************************************/
+    void GenDirect(real lat1, real lon1, real azi1, real s12, unsigned outmask,
+                   real& lat2, real& lon2, real& azi2) const;
+
+    /**
+     * Solve the direct great ellipse problem for many points.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] s12 array of distances between point 1 and point 2
+     *   (meters).
+     * @param[in] n the number of problems.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GreatEllipse::mask values
+     *   specifying which of the output arrays should be set; default
+     *   GreatEllipse::LATITUDE | GreatEllipse::LONGITUDE |
+     *   GreatEllipse::AZIMUTH.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The \e i th problem is specified by \e lat1[\e i], \e lon1[\e i], \e
+     * azi1[\e i], \e s12[\e i], for 0 &le; \e i &lt; \e n.  The
+     * interpretation of \e outmask is the same as for
+     * GreatEllipse::GenDirect.  Output arrays not selected by \e outmask are
+     * not referenced and may be null pointers.  The results are identical to
+     * calling GreatEllipse::GenDirect \e n times.  The problems are divided
+     * between \e nthreads threads as described for Geodesic::GenDirectBatch.
+     **********************************************************************/
+    void GenDirectBatch(const real* lat1, const real* lon1, const real* azi1,
+                        const real* s12, size_t n,
+                        real* lat2, real* lon2, real* azi2,
+                        unsigned outmask = LATITUDE | LONGITUDE | AZIMUTH,
+                        int nthreads = 1) const;
+    ///@}
+
+    /** \name Inverse great ellipse problem.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse great ellipse problem.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * \e lat1 and \e lat2 should be in the range [&minus;90&deg;, 90&deg;];
+     * \e lon1 and \e lon2 should be in the range [&minus;540&deg;, 540&deg;).
+     * The values of \e azi1 and \e azi2 returned are in the range
+     * [&minus;180&deg;, 180&deg;).  The shorter of the two arcs of the great
+     * ellipse is returned.  If the points are antipodal, the meridian
+     * through the north pole is chosen.
+     **********************************************************************/
+    void Inverse(real lat1, real lon1, real lat2, real lon2,
+                 real& s12, real& azi1, real& azi2) const {
+      GenInverse(lat1, lon1, lat2, lon2, DISTANCE | AZIMUTH, s12, azi1, azi2);
+    }
+
+    /**
+     * Solve the inverse great ellipse problem without the azimuths.
+     **********************************************************************/
+    void Inverse(real lat1, real lon1, real lat2, real lon2,
+                 real& s12) const {
+      real t;
+      GenInverse(lat1, lon1, lat2, lon2, DISTANCE, s12, t, t);
+    }
+
+    /**
+     * The general inverse great ellipse problem.  GreatEllipse::Inverse is
+     * defined in terms of this function.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GreatEllipse::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * The GreatEllipse::mask values possible for \e outmask are
+     * - \e outmask |= GreatEllipse::DISTANCE for the distance \e s12;
+     * - \e outmask |= GreatEllipse::AZIMUTH for the azimuths \e azi1 and \e
+     *   azi2;
+     * - \e outmask |= GreatEllipse::ALL for all of the above.
+     **********************************************************************/
+    void GenInverse(real lat1, real lon1, real lat2, real lon2,
+                    unsigned outmask,
+                    real& s12, real& azi1, real& azi2) const;
+
+    /**
+     * Solve the inverse great ellipse problem for many pairs of points.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GreatEllipse::DISTANCE
+     *   and GreatEllipse::AZIMUTH specifying which of the output arrays
+     *   should be set; default GreatEllipse::DISTANCE |
+     *   GreatEllipse::AZIMUTH.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The \e i th problem is specified by \e lat1[\e i], \e lon1[\e i], \e
+     * lat2[\e i], \e lon2[\e i], for 0 &le; \e i &lt; \e n.  Output arrays
+     * not selected by \e outmask are not referenced and may be null
+     * pointers.  The results are identical to calling
+     * GreatEllipse::GenInverse \e n times.  The problems are divided between
+     * \e nthreads threads as described for Geodesic::GenInverseBatch.
+     **********************************************************************/
+    void GenInverseBatch(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2, size_t n,
+                         real* s12, real* azi1, real* azi2,
+                         unsigned outmask = DISTANCE | AZIMUTH,
+                         int nthreads = 1) const;
+    ///@}
+
+    /**
+     * Set up to compute several points on a single great ellipse.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] azi1 azimuth at point 1 (degrees).
+     * @return a GreatEllipseLine object.
+     *
+     * \e lat1 should be in the range [&minus;90&deg;, 90&deg;]; \e lon1 and \e
+     * azi1 should be in the range [&minus;540&deg;, 540&deg;).  If point 1
+     * is a pole, \e azi1 is interpreted as for Geodesic::Line.
+     **********************************************************************/
+    GreatEllipseLine Line(real lat1, real lon1, real azi1) const;
+
+    /** \name Inspector functions.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value used in the constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const { return _a; }
+
+    /**
+     * @return \e f the  flattening of the ellipsoid.  This is the
+     *   value used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _f; }
+    ///@}
+
+    /**
+     * A global instantiation of GreatEllipse with the parameters for the
+     * WGS84 ellipsoid.
+     **********************************************************************/
+    static const GreatEllipse& WGS84();
+  };
+
+  /**
+   * \brief Find a sequence of points on a single great ellipse.
+   *
+   * GreatEllipseLine facilitates the determination of a series of points on
+   * a single great ellipse.  The starting point (\e lat1, \e lon1) and the
+   * azimuth \e azi1 are specified in the call to GreatEllipse::Line which
+   * returns a GreatEllipseLine object.  GreatEllipseLine::Position returns
+   * the location of point 2 a distance \e s12 along the great ellipse.
+   *
+   * There is no public constructor for this class.  (Use GreatEllipse::Line
+   * to create an instance.)  The GreatEllipseLine object holds a copy of the
+   * parameters of the ellipsoid; so the GreatEllipse object used to create it
+   * need not stay in scope.
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GreatEllipseLine {
+  private:
+    typedef Math::real real;
+    friend class GreatEllipse;
+    static const int nC1_ = Geodesic::nC1_;
+    static const int nC1p_ = Geodesic::nC1p_;
+    real tiny_, _f12, _lat1, _lon1, _azi1;
+    // The great circle on the auxiliary sphere: alp0 is its azimuth at the
+    // equator and sig1 is the arc length from the equator to point 1.  The
+    // great ellipse has semi-axes a and _b, with _k = a/_b; tau is the
+    // distance along it divided by _b * (1 + _A1m1).
+    real _salp0, _calp0, _k, _b, _A1m1, _B11,
+      _ssig1, _csig1, _ssig1p, _csig1p, _stau1, _ctau1, _somg1, _comg1;
+    real _C1pa[nC1p_ + 1];
+    GreatEllipseLine(const GreatEllipse& ge, real lat1, real lon1, real azi1);
+    // The same given also the sines and cosines of lat1 and azi1
+    GreatEllipseLine(const GreatEllipse& ge, real lat1, real lon1, real azi1,
+                     real sphi1, real cphi1, real salp1, real calp1);
+    void Init(const GreatEllipse& ge,
+              real sphi1, real cphi1, real salp1, real calp1);
+  public:
+
+    /**
+     * This is a duplication of GreatEllipse::mask.
+     **********************************************************************/
+    enum mask {
+      /**
+       * No output.
+       * @hideinitializer
+       **********************************************************************/
+      NONE          = GreatEllipse::NONE,
+      /**
+       * Calculate latitude \e lat2.
+       * @hideinitializer
+       **********************************************************************/
+      LATITUDE      = GreatEllipse::LATITUDE,
+      /**
+       * Calculate longitude \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONGITUDE     = GreatEllipse::LONGITUDE,
+      /**
+       * Calculate azimuth \e azi2.
+       * @hideinitializer
+       **********************************************************************/
+      AZIMUTH       = GreatEllipse::AZIMUTH,
+      /**
+       * Unroll \e lon2.
+       * @hideinitializer
+       **********************************************************************/
+      LONG_UNROLL   = GreatEllipse::LONG_UNROLL,
+      /**
+       * Calculate everything.  (LONG_UNROLL is not included in this mask.)
+       * @hideinitializer
+       **********************************************************************/
+      ALL           = GreatEllipse::ALL,
+    };
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 (meters)
+     * from point 1.
+     *
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * The values of \e lon2 and \e azi2 returned are in the range
+     * [&minus;180&deg;, 180&deg;).
+     **********************************************************************/
+    void Position(real s12, real& lat2, real& lon2, real& azi2) const {
+      GenPosition(s12, LATITUDE | LONGITUDE | AZIMUTH, lat2, lon2, azi2);
+    }
+
+    /**
+     * Compute the position of point 2 which is a distance \e s12 (meters)
+     * from point 1.  The azimuth is not computed.
+     **********************************************************************/
+    void Position(real s12, real& lat2, real& lon2) const {
+      real t;
+      GenPosition(s12, LATITUDE | LONGITUDE, lat2, lon2, t);
+    }
+
+    /**
+     * The general position routine.  GreatEllipseLine::Position is defined
+     * in terms of this function.
+     *
+     * @param[in] s12 distance between point 1 and point 2 (meters); it can be
+     *   negative.
+     * @param[in] outmask a bitor'ed combination of GreatEllipseLine::mask
+     *   values specifying which of the following parameters should be set.
+     * @param[out] lat2 latitude of point 2 (degrees).
+     * @param[out] lon2 longitude of point 2 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     *
+     * The interpretation of \e outmask is the same as for
+     * GreatEllipse::GenDirect.
+     **********************************************************************/
+    void GenPosition(real s12, unsigned outmask,
+                     real& lat2, real& lon2, real& azi2) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+
+    /**
+     * @return \e lat1 the latitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Latitude() const { return _lat1; }
+
+    /**
+     * @return \e lon1 the longitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Longitude() const { return _lon1; }
+
+    /**
+     * @return \e azi1 the azimuth (degrees) of the great ellipse at point 1.
+     **********************************************************************/
+    Math::real Azimuth() const { return _azi1; }
+
+    /**
+     * @return \e b the semi-minor axis of the great ellipse (meters).  Its
+     *   semi-major axis is the equatorial radius of the ellipsoid.
+     **********************************************************************/
+    Math::real MinorAxis() const { return _b; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GREATELLIPSE_HPP
@@ -0,0 +1,164 @@
+/**
+ * \file GridMapper.hpp
+ * \brief Header for GeographicLib::GridMapper class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GRIDMAPPER_HPP)
+#define GEOGRAPHICLIB_GRIDMAPPER_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Map a regular grid through a coordinate transformation
+   *
+   * Reprojecting a raster requires, for each pixel of the destination grid,
+   * the coordinates of the corresponding point in the source grid.  These
+   * are given by a coordinate transformation, e.g.,
+   * TransverseMercator::Reverse followed by LambertConformalConic::Forward.
+   * Because the transformation is smooth, it can be approximated accurately
+   * by interpolation over small blocks of pixels.  GridMapper evaluates the
+   * transformation exactly on a coarse lattice of pixels (with spacing
+   * GridMapper::CellSize()) and fills each cell of the lattice by bilinear
+   * interpolation.  The accuracy of the interpolation is checked by
+   * evaluating the transformation exactly at the midpoints of the edges and
+   * at the center of the cell; if any of these differs from the interpolated
+   * value by more than GridMapper::Tolerance(), the cell is split into
+   * quarters (reusing the points already computed) and the process is
+   * repeated.  Cells no larger than 8 &times; 8 pixels which fail the check
+   * are computed exactly pixel by pixel; in particular, this is how the
+   * boundaries of regions where the transformation returns NaNs (e.g.,
+   * because the points lie outside the domain of a projection) are treated.
+   * This is the approach used by the approximate transformer in GDAL,
+   * extended to two dimensions.
+   *
+   * The transformation is supplied by deriving from GridMapper::Transform.
+   * Its batch function is called for whole rows of the coarse lattice and
+   * for the check points of each cell, so the cost of a virtual call is
+   * incurred once per batch instead of once per pixel.
+   *
+   * The rows of cells may be divided among several threads.  The
+   * GridMapper::Transform object is then called concurrently from these
+   * threads; the transformations provided by GeographicLib's projection
+   * classes (which are immutable) can be used in this way.
+   *
+   * Example of use:
+   * \include example-GridMapper.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GridMapper {
+  public:
+    /**
+     * \brief The coordinate transformation used by GridMapper
+     *
+     * Derive from this class and define the batch operator() to specify the
+     * transformation from destination coordinates to source coordinates.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Transform {
+    public:
+      /**
+       * Transform many points.
+       *
+       * @param[in] x array of destination x coordinates.
+       * @param[in] y array of destination y coordinates.
+       * @param[in] n the number of points.
+       * @param[out] u array of source x coordinates.
+       * @param[out] v array of source y coordinates.
+       *
+       * Points for which the transformation is undefined should be given
+       * NaNs for \e u and \e v.  This function must be safe to call
+       * concurrently from several threads if GridMapper::Map is called with
+       * \e nthreads &gt; 1.
+       **********************************************************************/
+      virtual void operator()(const Math::real x[], const Math::real y[],
+                              size_t n,
+                              Math::real u[], Math::real v[]) const = 0;
+      virtual ~Transform() {}
+    };
+
+  private:
+    typedef Math::real real;
+    // Cells at most this size (in pixels) which fail the check are computed
+    // exactly
+    static const int maxexact_ = 8;
+    real _tol;
+    int _cell;
+    void Rows(const Transform* t, real x0, real dx, int nx,
+              real y0, real dy, int ny, int r0, int r1,
+              real u[], real v[]) const;
+    void Cell(const Transform& t, real x0, real dx, int nx,
+              real y0, real dy,
+              int i0, int i1, int j0, int j1, bool closex, bool closey,
+              const real cu[], const real cv[],
+              real u[], real v[]) const;
+  public:
+
+    /**
+     * Constructor for GridMapper.
+     *
+     * @param[in] tol the maximum interpolation error in either source
+     *   coordinate (in the units of the source coordinates).
+     * @param[in] cell the spacing of the coarse lattice (in pixels); default
+     *   32.
+     * @exception GeographicErr if \e tol is negative or not finite or if \e
+     *   cell is not positive.
+     *
+     * The error in the interpolated values may exceed \e tol in the interior
+     * of a cell if the transformation varies rapidly between the check
+     * points.  Setting \e tol = 0 causes every pixel to be computed exactly
+     * (unless the transformation is linear).
+     **********************************************************************/
+    GridMapper(real tol, int cell = 32);
+
+    /**
+     * Compute the source coordinates for a grid.
+     *
+     * @param[in] t the transformation from destination to source
+     *   coordinates.
+     * @param[in] x0 the x coordinate of the first column of the grid.
+     * @param[in] dx the spacing of the columns.
+     * @param[in] nx the number of columns.
+     * @param[in] y0 the y coordinate of the first row of the grid.
+     * @param[in] dy the spacing of the rows.
+     * @param[in] ny the number of rows.
+     * @param[out] u array of source x coordinates.
+     * @param[out] v array of source y coordinates.
+     * @param[in] nthreads the number of threads to use; default 1.
+     *
+     * The destination point in column \e i and row \e j is (\e x0 + \e i \e
+     * dx, \e y0 + \e j \e dy), and its source coordinates are stored in \e
+     * u[\e j \e nx + \e i] and \e v[\e j \e nx + \e i].  The arrays \e u and
+     * \e v must each have at least \e nx \e ny elements.  If \e nthreads
+     * &gt; 1, the rows of cells are divided among \e nthreads threads (if
+     * the library was compiled with support for threads).  The results do
+     * not depend on \e nthreads.
+     **********************************************************************/
+    void Map(const Transform& t,
+             real x0, real dx, int nx, real y0, real dy, int ny,
+             real u[], real v[], int nthreads = 1) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e tol the maximum interpolation error used in the
+     *   constructor.
+     **********************************************************************/
+    Math::real Tolerance() const { return _tol; }
+
+    /**
+     * @return \e cell the spacing of the coarse lattice used in the
+     *   constructor.
+     **********************************************************************/
+    int CellSize() const { return _cell; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GRIDMAPPER_HPP
@@ -0,0 +1,393 @@
+/**
+ * \file Instrumentation.hpp
+ * \brief Header for GeographicLib::Instrumentation class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_INSTRUMENTATION_HPP)
+#define GEOGRAPHICLIB_INSTRUMENTATION_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+
+#if !defined(GEOGRAPHICLIB_INSTRUMENTATION)
+/**
+ * Whether the library records performance counters; see
+ * GeographicLib::Instrumentation.  This is set by the cmake option
+ * GEOGRAPHICLIB_INSTRUMENTATION (which writes its value into Config.h).  The
+ * default, 0, compiles the instrumentation out of the library, so that the
+ * calculations are unaffected.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_INSTRUMENTATION 0
+#endif
+
+#if GEOGRAPHICLIB_INSTRUMENTATION
+/**
+ * Increment the counter GeographicLib::Instrumentation::c (if the
+ * instrumentation is enabled).
+ **********************************************************************/
+#  define GEOGRAPHICLIB_COUNT(c) \
+  GeographicLib::Instrumentation::Count(GeographicLib::Instrumentation::c)
+/**
+ * Add an entry \e k to the histogram GeographicLib::Instrumentation::h (if
+ * the instrumentation is enabled).
+ **********************************************************************/
+#  define GEOGRAPHICLIB_HISTOGRAM(h, k) \
+  GeographicLib::Instrumentation::Record(GeographicLib::Instrumentation::h, \
+                                         int(k))
+/**
+ * Time the rest of the enclosing scope as the span
+ * GeographicLib::Instrumentation::s (if the instrumentation is enabled).
+ **********************************************************************/
+#  define GEOGRAPHICLIB_SPAN(s) \
+  GeographicLib::Instrumentation::Scope \
+  geographiclib_span_(GeographicLib::Instrumentation::s)
+#else
+#  define GEOGRAPHICLIB_COUNT(c) ((void)0)
+#  define GEOGRAPHICLIB_HISTOGRAM(h, k) ((void)0)
+#  define GEOGRAPHICLIB_SPAN(s) ((void)0)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Performance counters and tracing hooks
+   *
+   * If the library is configured with the cmake option
+   * GEOGRAPHICLIB_INSTRUMENTATION = ON, several classes record events which
+   * help to attribute the time spent in the library:
+   * - Instrumentation::LAMBDA12_ITERATIONS, a histogram of the number of
+   *   evaluations of the longitude difference when Geodesic solves the
+   *   inverse problem by Newton's method, and
+   *   Instrumentation::GEODESIC_INVERSE_FAIL, the number of these solutions
+   *   which hit the iteration limit;
+   * - Instrumentation::GEOID_CACHE_HIT and Instrumentation::GEOID_CACHE_MISS,
+   *   the number of geoid heights at grid points which were (or weren't)
+   *   found in the cache set up by Geoid::CacheArea, etc.;
+   * - Instrumentation::TMEXACT_ITERATIONS, a histogram of the number of
+   *   Newton iterations in the inversions in TransverseMercatorExact, and
+   *   Instrumentation::TMEXACT_ZETAINV_FAIL and
+   *   Instrumentation::TMEXACT_SIGMAINV_FAIL, the number of inversions which
+   *   hit the iteration limit;
+   * - Instrumentation::GEODESICINDEX_INVERSE, the number of geodesic
+   *   distances computed by GeodesicIndex, and
+   *   Instrumentation::GEODESICPOLYGON_INVERSE, the number of inverse
+   *   problems solved by GeodesicPolygon;
+   * - Instrumentation::SPHERICAL_VALUE, the calls to SphericalEngine::Value
+   *   (which is used by the SphericalHarmonic classes and so by the gravity
+   *   and magnetic models) and the time spent in them.
+   * .
+   * The counters are kept separately for each thread (so that counting
+   * involves no contention between threads).  Instrumentation::GetSnapshot
+   * combines the counters for all the threads (including those which have
+   * exited); Instrumentation::GetThreadSnapshot returns the counters for the
+   * calling thread.  Instrumentation::Reset sets all the counters to zero.
+   *
+   * A Instrumentation::Tracer may be registered with
+   * Instrumentation::SetTracer; its member functions are called at the
+   * beginning and end of each span, which allows the library to be connected
+   * to an external tracing system.  The tracer must be thread safe since it
+   * is called from all the threads using the library.
+   *
+   * With the default setting, GEOGRAPHICLIB_INSTRUMENTATION = OFF, nothing
+   * is recorded, the library code is unchanged, GetSnapshot returns false,
+   * and the tracer is never called.  The instrumentation requires the
+   * library to be compiled with C++11.
+   *
+   * The macros GEOGRAPHICLIB_COUNT, GEOGRAPHICLIB_HISTOGRAM, and
+   * GEOGRAPHICLIB_SPAN, which expand to nothing unless the instrumentation
+   * is enabled, are used to record the events.
+   *
+   * Example of use:
+   * \include example-Instrumentation.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Instrumentation {
+  public:
+    /**
+     * The events which are counted.
+     **********************************************************************/
+    enum counter {
+      /**
+       * Geodesic inverse solutions by Newton's method which hit the
+       * iteration limit.
+       * @hideinitializer
+       **********************************************************************/
+      GEODESIC_INVERSE_FAIL = 0,
+      /**
+       * Geoid grid points found in the cache.
+       * @hideinitializer
+       **********************************************************************/
+      GEOID_CACHE_HIT = 1,
+      /**
+       * Geoid grid points not found in the cache (and so read from the file
+       * or its memory map).
+       * @hideinitializer
+       **********************************************************************/
+      GEOID_CACHE_MISS = 2,
+      /**
+       * TransverseMercatorExact reverse inversions which hit the iteration
+       * limit numit_.
+       * @hideinitializer
+       **********************************************************************/
+      TMEXACT_ZETAINV_FAIL = 3,
+      /**
+       * TransverseMercatorExact forward inversions which hit the iteration
+       * limit numit_.
+       * @hideinitializer
+       **********************************************************************/
+      TMEXACT_SIGMAINV_FAIL = 4,
+      /**
+       * Geodesic distances computed by GeodesicIndex (for the points which
+       * could not be excluded by the cheaper bounds).
+       * @hideinitializer
+       **********************************************************************/
+      GEODESICINDEX_INVERSE = 5,
+      /**
+       * Geodesic inverse problems solved by GeodesicPolygon (for the edges
+       * which could not be classified by their latitude bounds).
+       * @hideinitializer
+       **********************************************************************/
+      GEODESICPOLYGON_INVERSE = 6,
+      /**
+       * The number of counters.
+       * @hideinitializer
+       **********************************************************************/
+      NCOUNTERS = 7,
+    };
+
+    /**
+     * The histograms.
+     **********************************************************************/
+    enum histogram {
+      /**
+       * The number of evaluations of Geodesic::Lambda12 in the inverse
+       * solutions by Newton's method.
+       * @hideinitializer
+       **********************************************************************/
+      LAMBDA12_ITERATIONS = 0,
+      /**
+       * The number of Newton iterations in the TransverseMercatorExact
+       * inversions.
+       * @hideinitializer
+       **********************************************************************/
+      TMEXACT_ITERATIONS = 1,
+      /**
+       * The number of histograms.
+       * @hideinitializer
+       **********************************************************************/
+      NHISTOGRAMS = 2,
+    };
+
+    /**
+     * The spans which are timed.
+     **********************************************************************/
+    enum span {
+      /**
+       * The calls to SphericalEngine::Value.
+       * @hideinitializer
+       **********************************************************************/
+      SPHERICAL_VALUE = 0,
+      /**
+       * The number of spans.
+       * @hideinitializer
+       **********************************************************************/
+      NSPANS = 1,
+    };
+
+    /**
+     * The number of bins in the histograms (the last bin also counts larger
+     * entries).
+     **********************************************************************/
+    static const int nbins_ = 32;
+
+    /**
+     * \brief The values of the counters
+     **********************************************************************/
+    struct GEOGRAPHICLIB_EXPORT Snapshot {
+      /**
+       * The counts of the events.
+       **********************************************************************/
+      unsigned long count[NCOUNTERS];
+      /**
+       * The histograms; \e hist[\e h][\e k] is the number of entries equal to
+       * \e k in histogram \e h.
+       **********************************************************************/
+      unsigned long hist[NHISTOGRAMS][nbins_];
+      /**
+       * The number of times each span was entered.
+       **********************************************************************/
+      unsigned long calls[NSPANS];
+      /**
+       * The total time spent in each span (seconds).
+       **********************************************************************/
+      double time[NSPANS];
+      /**
+       * Constructor setting all the values to zero.
+       **********************************************************************/
+      Snapshot();
+      /**
+       * Add the values from another Snapshot to this one.
+       *
+       * @param[in] s the other Snapshot.
+       **********************************************************************/
+      void Add(const Snapshot& s);
+    };
+
+    /**
+     * \brief The interface for tracing spans
+     *
+     * Derive from this class and register an instance with
+     * Instrumentation::SetTracer.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Tracer {
+    public:
+      virtual ~Tracer() {}
+      /**
+       * Called at the beginning of a span.
+       *
+       * @param[in] s the span.
+       **********************************************************************/
+      virtual void Begin(span s) = 0;
+      /**
+       * Called at the end of a span.
+       *
+       * @param[in] s the span.
+       * @param[in] t the time spent in the span (seconds).
+       **********************************************************************/
+      virtual void End(span s, double t) = 0;
+    };
+
+    /**
+     * \brief Time the lifetime of an object as a span
+     *
+     * This is used by the macro GEOGRAPHICLIB_SPAN.
+     **********************************************************************/
+    class Scope {
+    private:
+      span _s;
+      long long _t0;
+      Scope(const Scope&);            // copy constructor not allowed
+      Scope& operator=(const Scope&); // copy assignment not allowed
+    public:
+      /**
+       * Begin a span.
+       *
+       * @param[in] s the span.
+       **********************************************************************/
+      explicit Scope(span s) : _s(s), _t0(Begin(s)) {}
+      /**
+       * End the span.
+       **********************************************************************/
+      ~Scope() { End(_s, _t0); }
+    };
+
+    /**
+     * @return true if the library was compiled with the instrumentation
+     *   enabled.
+     **********************************************************************/
+    static bool Enabled();
+
+    /**
+     * Increment a counter for the calling thread.
+     *
+     * @param[in] c the counter.
+     **********************************************************************/
+    static void Count(counter c);
+
+    /**
+     * Add an entry to a histogram for the calling thread.
+     *
+     * @param[in] h the histogram.
+     * @param[in] k the entry; values greater than \e nbins_ &minus; 1 are
+     *   counted in the last bin.
+     **********************************************************************/
+    static void Record(histogram h, int k);
+
+    /**
+     * Begin a span.
+     *
+     * @param[in] s the span.
+     * @return the starting time (in implementation defined units) to be
+     *   passed to Instrumentation::End.
+     *
+     * This calls Tracer::Begin for the registered tracer, if any.
+     **********************************************************************/
+    static long long Begin(span s);
+
+    /**
+     * End a span.
+     *
+     * @param[in] s the span.
+     * @param[in] t0 the value returned by Instrumentation::Begin.
+     *
+     * This records the call and the time spent for the calling thread and
+     * calls Tracer::End for the registered tracer, if any.
+     **********************************************************************/
+    static void End(span s, long long t0);
+
+    /**
+     * Register a tracer.
+     *
+     * @param[in] tracer a pointer to the tracer; use 0 (the default) to
+     *   remove the current tracer.
+     * @return the previously registered tracer.
+     *
+     * The caller retains ownership of the tracer; it should not be deleted
+     * while the library may still be calling it.  This has no effect if the
+     * instrumentation is not enabled.
+     **********************************************************************/
+    static Tracer* SetTracer(Tracer* tracer = 0);
+
+    /**
+     * Get the counters for the whole program.
+     *
+     * @param[out] s the sum of the counters for all the threads, including
+     *   those which have exited.
+     * @param[in] reset if true, reset the counters to zero (default false).
+     * @return true if the instrumentation is enabled; otherwise \e s is set
+     *   to zero.
+     *
+     * Counts made by other threads while this function is running may or may
+     * not be included in \e s; if \e reset is true, these counts may also be
+     * lost.
+     **********************************************************************/
+    static bool GetSnapshot(Snapshot& s, bool reset = false);
+
+    /**
+     * Get the counters for the calling thread.
+     *
+     * @param[out] s the counters for the calling thread.
+     * @return true if the instrumentation is enabled; otherwise \e s is set
+     *   to zero.
+     **********************************************************************/
+    static bool GetThreadSnapshot(Snapshot& s);
+
+    /**
+     * Reset the counters for all the threads to zero.
+     **********************************************************************/
+    static void Reset();
+
+    /**
+     * @param[in] c a counter.
+     * @return its name, e.g., "GEOID_CACHE_HIT".
+     **********************************************************************/
+    static const char* Name(counter c);
+
+    /**
+     * @param[in] h a histogram.
+     * @return its name, e.g., "LAMBDA12_ITERATIONS".
+     **********************************************************************/
+    static const char* Name(histogram h);
+
+    /**
+     * @param[in] s a span.
+     * @return its name, e.g., "SPHERICAL_VALUE".
+     **********************************************************************/
+    static const char* Name(span s);
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_INSTRUMENTATION_HPP
@@ -0,0 +1,235 @@
+/**
+ * \file InverseCache.hpp
+ * \brief Header for GeographicLib::InverseCacheT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_INVERSECACHE_HPP)
+#define GEOGRAPHICLIB_INVERSECACHE_HPP 1
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/Rhumb.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A cache of the solutions of recently solved inverse problems
+   *
+   * Applications which repeatedly solve the inverse problem for the same
+   * pairs of points (e.g., the distances between airports or between city
+   * centers) can avoid repeating the solution by using an InverseCacheT.
+   * This holds the results of up to a given number of inverse problems,
+   * keyed on the positions of the two points and the output mask; when it
+   * is full, the least recently used results are discarded.  A hit saves
+   * the full solution of the problem (including the iterative solution for
+   * Geodesic) at the cost of a lookup in a balanced tree; for WGS84, a hit
+   * takes about 70 ns compared to about 1 &mu;s for Geodesic::Inverse.  A
+   * miss costs slightly more than solving the problem directly; so the
+   * cache is only worthwhile if the same problems recur frequently.
+   *
+   * By default the keys are the exact values of the arguments (with 0 and
+   * &minus;0 treated as distinct) and the results are identical to those
+   * returned by the underlying object.  Alternatively, the latitudes and
+   * longitudes may be quantized by specifying a spacing \e dq; the problem
+   * is then solved for the points rounded to multiples of \e dq, so that
+   * nearby queries share the same results.  This moves each point by at
+   * most about 79 km times \e dq (in degrees) and so changes the distance
+   * by at most about 157 km times \e dq; e.g., 1.6 m for \e dq =
+   * 10<sup>&minus;5</sup>&deg;.  Problems with NaN arguments are solved but
+   * not cached.
+   *
+   * The cache is divided into a number of shards, each with its own least
+   * recently used list and its own share of the capacity; a problem is
+   * assigned to a shard by hashing its arguments.  If the library was
+   * compiled with C++11 support, each shard has a mutex so that a single
+   * cache can be shared by several threads with little contention; see
+   * InverseCacheT::ThreadSafe.  The problems are solved outside the locks.
+   *
+   * @tparam GeodType the geodesic class to use.
+   *
+   * This class can be used with GeodType = Geodesic, GeodesicExact, or
+   * Rhumb.  In the last case, the rhumb line azimuth is returned in \e azi1
+   * and the other geodesic quantities (\e azi2, \e m12, \e M12, and \e M21)
+   * are not set.
+   *
+   * Example of use:
+   * \include example-InverseCache.cpp
+   **********************************************************************/
+
+  template <class GeodType = Geodesic>
+  class InverseCacheT {
+  private:
+    typedef Math::real real;
+    class Impl;
+    Impl* _impl;
+    // copy constructor not allowed
+    InverseCacheT(const InverseCacheT&);
+    // nor copy assignment
+    InverseCacheT& operator=(const InverseCacheT&);
+  public:
+
+    /**
+     * Constructor for InverseCacheT.
+     *
+     * @param[in] earth the GeodType object to use for the inverse
+     *   calculations.
+     * @param[in] capacity the maximum number of results held by the cache.
+     * @param[in] dq the spacing of the grid of latitudes and longitudes
+     *   (degrees); if 0 (the default), the positions are not quantized.
+     * @param[in] nshards the number of shards (default 16).
+     * @exception GeographicErr if \e dq is negative or not finite or if \e
+     *   nshards is not positive.
+     * @exception std::bad_alloc if the memory for the cache can't be
+     *   allocated.
+     *
+     * A copy of \e earth is stored.  If \e capacity = 0, no results are
+     * cached.  The capacity is divided evenly between the shards.
+     **********************************************************************/
+    InverseCacheT(const GeodType& earth, size_t capacity, real dq = 0,
+                  int nshards = 16);
+
+    /**
+     * The destructor.
+     **********************************************************************/
+    ~InverseCacheT();
+
+    /**
+     * The general inverse calculation, from the cache if possible.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodType::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length between point 1 and point 2 (degrees); this
+     *   is NaN for GeodType = Rhumb.
+     *
+     * This returns the same results as GeodType::GenInverse for the
+     * (possibly quantized) points.  Results computed with different values
+     * of \e outmask are cached separately.
+     **********************************************************************/
+    Math::real GenInverse(real lat1, real lon1, real lat2, real lon2,
+                          unsigned outmask,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12);
+
+    /**
+     * The distance between two points, from the cache if possible.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     **********************************************************************/
+    void Inverse(real lat1, real lon1, real lat2, real lon2, real& s12) {
+      real t;
+      GenInverse(lat1, lon1, lat2, lon2, GeodType::DISTANCE,
+                 s12, t, t, t, t, t, t);
+    }
+
+    /**
+     * Remove all the results from the cache.  The hit and miss counters are
+     * not changed.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Change the capacity of the cache.
+     *
+     * @param[in] capacity the new maximum number of results.
+     *
+     * If a shard holds more than its share of \e capacity results, the least
+     * recently used ones are discarded.
+     **********************************************************************/
+    void SetCapacity(size_t capacity);
+
+    /**
+     * Reset the hit and miss counters to zero.
+     **********************************************************************/
+    void ResetCounters();
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the maximum number of results held by the cache.
+     **********************************************************************/
+    size_t Capacity() const;
+
+    /**
+     * @return the number of results currently in the cache.
+     **********************************************************************/
+    size_t Size() const;
+
+    /**
+     * @return the number of inverse calculations which were satisfied from
+     *   the cache.
+     **********************************************************************/
+    unsigned long Hits() const;
+
+    /**
+     * @return the number of inverse calculations which required the problem
+     *   to be solved.
+     **********************************************************************/
+    unsigned long Misses() const;
+
+    /**
+     * @return \e dq the spacing of the grid of latitudes and longitudes
+     *   (degrees).
+     **********************************************************************/
+    Math::real Quantum() const;
+
+    /**
+     * @return the number of shards.
+     **********************************************************************/
+    int Shards() const;
+
+    /**
+     * @return true if the cache may be used by several threads
+     *   simultaneously.  This depends on whether the library was compiled
+     *   with C++11 support.
+     **********************************************************************/
+    static bool ThreadSafe();
+    ///@}
+
+  };
+
+  /**
+   * @relates InverseCacheT
+   *
+   * A cache of inverse solutions using Geodesic.
+   **********************************************************************/
+  typedef InverseCacheT<Geodesic> InverseCache;
+
+  /**
+   * @relates InverseCacheT
+   *
+   * A cache of inverse solutions using GeodesicExact.
+   **********************************************************************/
+  typedef InverseCacheT<GeodesicExact> InverseCacheExact;
+
+  /**
+   * @relates InverseCacheT
+   *
+   * A cache of inverse solutions using Rhumb.
+   **********************************************************************/
+  typedef InverseCacheT<Rhumb> InverseCacheRhumb;
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_INVERSECACHE_HPP
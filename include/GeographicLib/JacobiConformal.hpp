@@ -2,23 +2,22 @@
  * \file JacobiConformal.hpp
  * \brief Header for GeographicLib::JacobiConformal class
  *
- * <b>NOTE:</b> This is just sample code.  It is not part of GeographicLib
- * itself.
- *
  * Copyright (c) Charles Karney (2014-2015) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#if !defined(GEOGRAPHICLIB_JACOBICONFORMAL_HPP)
+#define GEOGRAPHICLIB_JACOBICONFORMAL_HPP 1
+
+#include <GeographicLib/Constants.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
 
 namespace GeographicLib {
+
   /**
    * \brief Jacobi's conformal projection of a triaxial ellipsoid
    *
-   * <b>NOTE:</b> This is just sample code.  It is not part of GeographicLib
-   * itself.
-   *
    * This is a conformal projection of the ellipsoid to a plane in which
    * the grid lines are straight; see Jacobi,
    * <a href="https://books.google.com/books?id=ryEOAAAAQAAJ&pg=PA212">
@@ -36,14 +35,46 @@ namespace GeographicLib {
    * points, \f$\left|\omega\right| = \left|\beta\right| = \frac12\pi\f$, lie
    * on middle principal ellipse in the plane \f$X=0\f$.
    *
+   * The projection is given by incomplete elliptic integrals of the third
+   * kind with moduli which depend only on the ellipsoid.  So the constructor
+   * sets up the Fourier series for these integrals with
+   * EllipticFunction::PrecomputeSeries and the projection of a point then
+   * costs the summation of two short series.  If a series doesn't converge
+   * (this happens for \e y if the ellipsoid is close to oblate, because the
+   * modulus is then close to 1), the integral is evaluated directly.  Many
+   * points can be projected with the array version of
+   * JacobiConformal::Forward.
+   *
    * For more information on this projection, see \ref jacobi.
+   *
+   * Example of use:
+   * \include example-JacobiConformal.cpp
    **********************************************************************/
-  class JacobiConformal {
+
+  class GEOGRAPHICLIB_EXPORT JacobiConformal {
+  private:
     typedef Math::real real;
     real _a, _b, _c, _ab2, _bc2, _ac2;
     EllipticFunction _ex, _ey;
+    // Whether _ex and _ey have saved their Fourier series
+    bool _sx, _sy;
     static void norm(real& x, real& y)
     { real z = Math::hypot(x, y); x /= z; y /= z; }
+    // The Pi(phi) integral for a normalized (sn, cn)
+    static real Pi(const EllipticFunction& e, bool series, real sn, real cn) {
+      return series ?
+        (std::atan2(sn, cn) + e.deltaPi(sn, cn, e.Delta(sn, cn))) *
+        e.Pi() / (Math::pi()/2) :
+        e.Pi(sn, cn, e.Delta(sn, cn));
+    }
+    static void sincosd(real ang, real& s, real& c) {
+      using std::abs; using std::sin; using std::cos;
+      real a = ang * Math::degree();
+      s = abs(ang) == 180 ? 0 : sin(a);
+      c = abs(ang) ==  90 ? 0 : cos(a);
+    }
+    void ForwardRange(const real* omg, const real* bet, size_t i0, size_t i1,
+                      real* x, real* y) const;
   public:
     /**
      * Constructor for a trixial ellipsoid with semi-axes
@@ -51,26 +82,15 @@ namespace GeographicLib {
      * @param[in] a the largest semi-axis.
      * @param[in] b the middle semi-axis.
      * @param[in] c the smallest semi-axis.
+     * @exception GeographicErr if the semi-axes are not in order or if \e
+     *   a = \e c.
      *
      * The semi-axes must satisfy \e a &ge; \e b &ge; \e c > 0 and \e a >
      * \e c.  This form of the constructor cannot be used to specify a
      * sphere (use the next constructor).
      **********************************************************************/
-    JacobiConformal(real a, real b, real c)
-      : _a(a), _b(b), _c(c)
-      , _ab2((_a - _b) * (_a + _b))
-      , _bc2((_b - _c) * (_b + _c))
-      , _ac2((_a - _c) * (_a + _c))
-      , _ex(_ab2 / _ac2 * Math::sq(_c / _b), -_ab2 / Math::sq(_b),
-            _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
-      , _ey(_bc2 / _ac2 * Math::sq(_a / _b), +_bc2 / Math::sq(_b),
-            _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
-    {
-      if (!(a >= b && b >= c && c > 0))
-        throw GeographicErr("JacobiConformal: axes are not in order");
-      if (!(a > c))
-        throw GeographicErr("JacobiConformal: use alternate constructor for sphere");
-    }
+    JacobiConformal(real a, real b, real c);
+
     /**
      * Alternate constructor for a triaxial ellipsoid.
      *
@@ -79,33 +99,21 @@ namespace GeographicLib {
      * @param[in] c the smallest semi-axis.
      * @param[in] ab the relative magnitude of \e a &minus; \e b.
      * @param[in] bc the relative magnitude of \e b &minus; \e c.
+     * @exception GeographicErr if the semi-axes are not in order or if \e
+     *   ab + \e bc is not positive.
      *
      * This form can be used to specify a sphere.  The semi-axes must
      * satisfy \e a &ge; \e b &ge; c > 0.  The ratio \e ab : \e bc must equal
      * (<i>a</i>&minus;<i>b</i>) : (<i>b</i>&minus;<i>c</i>) with \e ab
      * &ge; 0, \e bc &ge; 0, and \e ab + \e bc > 0.
      **********************************************************************/
-    JacobiConformal(real a, real b, real c, real ab, real bc)
-      : _a(a), _b(b), _c(c)
-      , _ab2(ab * (_a + _b))
-      , _bc2(bc * (_b + _c))
-      , _ac2(_ab2 + _bc2)
-      , _ex(_ab2 / _ac2 * Math::sq(_c / _b),
-            -(_a - _b) * (_a + _b) / Math::sq(_b),
-            _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
-      , _ey(_bc2 / _ac2 * Math::sq(_a / _b),
-            +(_b - _c) * (_b + _c) / Math::sq(_b),
-            _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
-    {
-      if (!(a >= b && b >= c && c > 0 && ab >= 0 && bc >= 0))
-        throw GeographicErr("JacobiConformal: axes are not in order");
-      if (!(ab + bc > 0))
-        throw GeographicErr("JacobiConformal: ab + bc must be positive");
-    }
+    JacobiConformal(real a, real b, real c, real ab, real bc);
+
     /**
      * @return the quadrant length in the \e x direction
      **********************************************************************/
     Math::real x() const { return Math::sq(_a / _b) * _ex.Pi(); }
+
     /**
      * The \e x projection
      *
@@ -115,9 +123,9 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real x(real somg, real comg) const {
       real somg1 = _b * somg, comg1 = _a * comg; norm(somg1, comg1);
-      return Math::sq(_a / _b)
-        * _ex.Pi(somg1, comg1, _ex.Delta(somg1, comg1));
+      return Math::sq(_a / _b) * Pi(_ex, _sx, somg1, comg1);
     }
+
     /**
      * The \e x projection
      *
@@ -127,17 +135,15 @@ namespace GeographicLib {
      * &omega; must be in (&minus;180&deg;, 180&deg;].
      **********************************************************************/
     Math::real x(real omg) const {
-      using std::abs; using std::sin; using std::cos;
-      real
-        a = omg * Math::degree(),
-        somg = abs(omg) == 180 ? 0 : sin(a),
-        comg = abs(omg) ==  90 ? 0 : cos(a);
+      real somg, comg; sincosd(omg, somg, comg);
       return x(somg, comg) / Math::degree();
     }
+
     /**
      * @return the quadrant length in the \e y direction
      **********************************************************************/
     Math::real y() const { return Math::sq(_c / _b) * _ey.Pi(); }
+
     /**
      * The \e y projection
      *
@@ -147,9 +153,9 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real y(real sbet, real cbet) const {
       real sbet1 = _b * sbet, cbet1 = _c * cbet; norm(sbet1, cbet1);
-      return Math::sq(_c / _b)
-        * _ey.Pi(sbet1, cbet1, _ey.Delta(sbet1, cbet1));
+      return Math::sq(_c / _b) * Pi(_ey, _sy, sbet1, cbet1);
     }
+
     /**
      * The \e y projection
      *
@@ -159,13 +165,46 @@ namespace GeographicLib {
      * &beta; must be in (&minus;180&deg;, 180&deg;].
      **********************************************************************/
     Math::real y(real bet) const {
-      using std::abs; using std::sin; using std::cos;
-      real
-        a = bet * Math::degree(),
-        sbet = abs(bet) == 180 ? 0 : sin(a),
-        cbet = abs(bet) ==  90 ? 0 : cos(a);
+      real sbet, cbet; sincosd(bet, sbet, cbet);
       return y(sbet, cbet) / Math::degree();
     }
+
+    /**
+     * Forward projection of a point.
+     *
+     * @param[in] omg &omega; (in degrees).
+     * @param[in] bet &beta; (in degrees).
+     * @param[out] x \e x (in degrees).
+     * @param[out] y \e y (in degrees).
+     *
+     * This is the same as \e x = JacobiConformal::x(\e omg) and \e y =
+     * JacobiConformal::y(\e bet).  &omega; and &beta; must be in
+     * (&minus;180&deg;, 180&deg;].
+     **********************************************************************/
+    void Forward(real omg, real bet, real& x, real& y) const
+    { x = this->x(omg); y = this->y(bet); }
+
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] omg array of &omega; (in degrees).
+     * @param[in] bet array of &beta; (in degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of \e x (in degrees).
+     * @param[out] y array of \e y (in degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling JacobiConformal::Forward for each
+     * point.  The points are divided into \e nthreads contiguous ranges which
+     * are projected by Executor::Default() (concurrently, if the executor
+     * permits).  If the library is compiled without C++11, all the work is
+     * done by the calling thread; in any case, the results do not depend on
+     * \e nthreads.
+     **********************************************************************/
+    void Forward(const real* omg, const real* bet, size_t n,
+                 real* x, real* y, int nthreads = 1) const;
   };
 
 } // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_JACOBICONFORMAL_HPP
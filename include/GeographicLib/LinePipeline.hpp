@@ -0,0 +1,124 @@
+/**
+ * \file LinePipeline.hpp
+ * \brief Header for GeographicLib::LinePipeline class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_LINEPIPELINE_HPP)
+#define GEOGRAPHICLIB_LINEPIPELINE_HPP 1
+
+#include <cstddef>
+#include <string>
+#include <iosfwd>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Process a stream of lines of text in parallel
+   *
+   * This implements the input loop of the command-line utilities: each line
+   * of the input is converted to some output (possibly an error message) by
+   * a Stage and the outputs are written in the order of the input.  With
+   * more than one thread, the input is read in large blocks; each block is
+   * split at line boundaries into \e nthreads pieces which are processed
+   * concurrently (with Executor::For) into separate buffers; and the buffers
+   * are written in order.  Only one block is held at a time, so the memory
+   * used is bounded by the block size (plus the size of its output) however
+   * long the input; and a slow reader of the output throttles the reading of
+   * the input.  With a single thread, the lines are read and processed one
+   * at a time (so that the output for each line appears as soon as the line
+   * has been read, as needed for interactive use).
+   *
+   * A Stage processes a line with its operator()() and a piece of a block
+   * with Stage::Block.  The default Block calls operator()() for each line;
+   * a Stage can override it to keep state (e.g., a cache) for the lines of
+   * a piece, or to parse all the lines of the piece, compute the results with
+   * one of the batch functions of the library, and then format the results.
+   *
+   * Example of use:
+   * \include example-LinePipeline.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT LinePipeline {
+  public:
+    /**
+     * \brief The processing of the lines
+     *
+     * The member functions are called concurrently from several threads if
+     * the LinePipeline has more than one thread.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Stage {
+    public:
+      /**
+       * Process a line.
+       *
+       * @param[in] line the line (without the terminating newline).
+       * @param[out] out the stream to which the output is written.
+       * @return 0 if the line was processed successfully and otherwise a
+       *   positive error code.
+       **********************************************************************/
+      virtual int operator()(const std::string& line, std::ostream& out)
+        const = 0;
+      /**
+       * Process several lines.
+       *
+       * @param[in] begin the start of the lines.
+       * @param[in] end the end of the lines.
+       * @param[out] out the stream to which the output is written.
+       * @return the largest of the codes returned for the lines.
+       *
+       * The lines in [\e begin, \e end) are separated by newlines; the last
+       * line need not be terminated by a newline.
+       **********************************************************************/
+      virtual int Block(const char* begin, const char* end,
+                        std::ostream& out) const;
+      virtual ~Stage() {}
+    };
+
+    /**
+     * Constructor for LinePipeline.
+     *
+     * @param[in] nthreads the number of pieces into which each block is
+     *   divided (default 1).
+     * @param[in] blocksize the number of bytes of input for each piece
+     *   (default 1 MB).
+     **********************************************************************/
+    explicit LinePipeline(int nthreads = 1,
+                          size_t blocksize = size_t(1) << 20);
+
+    /**
+     * Process a stream.
+     *
+     * @param[in] in the input stream.
+     * @param[out] out the output stream.
+     * @param[in] stage the processing of the lines.
+     * @exception any exception thrown by \e stage.
+     * @return the largest of the codes returned for the lines (0 if there
+     *   are no lines).
+     *
+     * The input is read until the end of the stream.
+     **********************************************************************/
+    int Run(std::istream& in, std::ostream& out, const Stage& stage) const;
+
+    /**
+     * @return the number of pieces into which each block is divided.
+     **********************************************************************/
+    int Threads() const { return _nthreads; }
+
+    /**
+     * @return the number of bytes of input for each piece.
+     **********************************************************************/
+    size_t BlockSize() const { return _blocksize; }
+
+  private:
+    int _nthreads;
+    size_t _blocksize;
+    class Pieces;
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_LINEPIPELINE_HPP
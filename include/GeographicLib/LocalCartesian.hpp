@@ -43,11 +43,75 @@ namespace GeographicLib {
     Geocentric _earth;
     real _lat0, _lon0, _h0;
     real _x0, _y0, _z0, _r[dim2_];
+    // The anchor for Recenter
+    real _lata, _lona, _sphia, _cphia, _slama, _clama;
     void IntForward(real lat, real lon, real h, real& x, real& y, real& z,
                     real M[dim2_]) const;
     void IntReverse(real x, real y, real z, real& lat, real& lon, real& h,
                     real M[dim2_]) const;
     void MatrixMultiply(real M[dim2_]) const;
+    static void SmallRotate(real d, real& s, real& c);
+    // The affine map, p = A . p1 + b, from the local system of lc to this one
+    void FrameTransform(const LocalCartesian& lc,
+                        real A[dim2_], real b[dim_]) const;
+    // Batch versions with strides is (input) and os (output).  The local
+    // coordinates are of type T.  Element k of the matrix for point i is
+    // stored in M[k * n + i].
+    template<typename T>
+    void IntForwardBatch(const real* lat, const real* lon, const real* h,
+                         size_t is, size_t n, T* x, T* y, T* z, size_t os,
+                         real* M) const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long nl = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (long i = 0; i < nl; ++i) {
+        size_t ji = size_t(i) * is, jo = size_t(i) * os;
+        real xr, yr, zr, t[dim2_];
+        IntForward(lat[ji], lon[ji], h[ji], xr, yr, zr, M ? t : NULL);
+        x[jo] = T(xr); y[jo] = T(yr); z[jo] = T(zr);
+        if (M)
+          for (size_t k = 0; k < dim2_; ++k) M[k * n + size_t(i)] = t[k];
+      }
+    }
+    template<typename T>
+    void IntReverseBatch(const T* x, const T* y, const T* z,
+                         size_t is, size_t n,
+                         real* lat, real* lon, real* h, size_t os,
+                         real* M) const {
+      long nl = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (long i = 0; i < nl; ++i) {
+        size_t ji = size_t(i) * is, jo = size_t(i) * os;
+        real t[dim2_];
+        IntReverse(real(x[ji]), real(y[ji]), real(z[ji]),
+                   lat[jo], lon[jo], h[jo], M ? t : NULL);
+        if (M)
+          for (size_t k = 0; k < dim2_; ++k) M[k * n + size_t(i)] = t[k];
+      }
+    }
+    template<typename T>
+    void IntFromFrameBatch(const LocalCartesian& lc,
+                           const T* x, const T* y, const T* z,
+                           size_t is, size_t n,
+                           T* x1, T* y1, T* z1, size_t os) const {
+      real A[dim2_], b[dim_];
+      FrameTransform(lc, A, b);
+      long nl = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for
+#endif
+      for (long i = 0; i < nl; ++i) {
+        size_t ji = size_t(i) * is, jo = size_t(i) * os;
+        real xr = real(x[ji]), yr = real(y[ji]), zr = real(z[ji]);
+        x1[jo] = T(A[0] * xr + A[1] * yr + A[2] * zr + b[0]);
+        y1[jo] = T(A[3] * xr + A[4] * yr + A[5] * zr + b[1]);
+        z1[jo] = T(A[6] * xr + A[7] * yr + A[8] * zr + b[2]);
+      }
+    }
   public:
 
     /**
@@ -91,6 +155,27 @@ namespace GeographicLib {
      **********************************************************************/
     void Reset(real lat0, real lon0, real h0 = 0);
 
+    /**
+     * Move the origin to a nearby point.
+     *
+     * @param[in] lat0 latitude at origin (degrees).
+     * @param[in] lon0 longitude at origin (degrees).
+     * @param[in] h0 height above ellipsoid at origin (meters); default 0.
+     *
+     * This is equivalent to LocalCartesian::Reset, but it is intended for a
+     * moving origin (e.g., the local navigation frame of a vehicle) which is
+     * updated frequently.  Instead of evaluating trigonometric functions of
+     * \e lat0 and \e lon0, the sines and cosines of the latitude and
+     * longitude of the origin given to the last call to LocalCartesian::Reset
+     * (the anchor) are rotated through the (small) differences in latitude
+     * and longitude and the rotation matrix is built from these.  This is
+     * nearly 3 times faster than LocalCartesian::Reset and the results differ
+     * only by roundoff.  If the origin is more than about 0.5&deg; in
+     * latitude or longitude from the anchor or if \e lat0 is &plusmn;90&deg;,
+     * LocalCartesian::Reset is called (and this sets a new anchor).
+     **********************************************************************/
+    void Recenter(real lat0, real lon0, real h0 = 0);
+
     /**
      * Convert from geodetic to local cartesian coordinates.
      *
@@ -201,6 +286,204 @@ namespace GeographicLib {
         IntReverse(x, y, z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert arrays of geodetic coordinates to local cartesian coordinates.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices for the points.
+     *   These are stored by component: element \e k (in row-major order) of
+     *   the matrix for point \e i is M[\e k \e n + \e i].
+     *
+     * Each point is converted in a single pass: geodetic to geocentric, the
+     * rotation to the local system, and (if \e M is given) the product of
+     * the rotation matrices, with no intermediate arrays.
+     *
+     * The calculation is carried out with Math::real (so that the origin and
+     * the rotation to the local system retain full precision) and the results
+     * are then rounded to type T.  With T = Math::real, the results are
+     * identical to those given by LocalCartesian::Forward; with T = float,
+     * the only additional error is that due to the rounding, at most
+     * 2<sup>&minus;24</sup> |\e x| (e.g., 0.06 mm at 1 km from the origin
+     * and 6 mm at 100 km).  Storing the local coordinates of a point cloud as
+     * floats thus halves the memory and bandwidth needed.  (No such variant
+     * is provided for Geocentric, because geocentric coordinates stored as
+     * floats have a resolution of only about 0.5 m.)  This function is
+     * defined in the header file; if the calling code is compiled with
+     * OpenMP, the points are divided among the threads.
+     **********************************************************************/
+    template<typename T>
+    void ForwardBatch(const real lat[], const real lon[], const real h[],
+                      size_t n, T x[], T y[], T z[], real M[] = 0) const
+    { IntForwardBatch(lat, lon, h, 1, n, x, y, z, 1, M); }
+
+    /**
+     * Convert an array of geodetic coordinates to local cartesian coordinates
+     * with interleaved storage.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] llh array of 3 \e n elements holding the latitude, longitude,
+     *   and height of each point in turn.
+     * @param[in] n the number of points.
+     * @param[out] xyz array of 3 \e n elements for the local coordinates \e
+     *   x, \e y, \e z of each point in turn.
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices (stored by
+     *   component).
+     *
+     * If T = Math::real, \e xyz may be the same as \e llh.  Otherwise, this
+     * is the same as the non-interleaved version of
+     * LocalCartesian::ForwardBatch.
+     **********************************************************************/
+    template<typename T>
+    void ForwardBatch(const real llh[], size_t n, T xyz[], real M[] = 0)
+      const {
+      IntForwardBatch(llh, llh + 1, llh + 2, dim_, n,
+                      xyz, xyz + 1, xyz + 2, dim_, M);
+    }
+
+    /**
+     * Convert arrays of local cartesian coordinates to geodetic coordinates.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] h array of heights above the ellipsoid (meters).
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices for the points.
+     *   These are stored by component: element \e k (in row-major order) of
+     *   the matrix for point \e i is M[\e k \e n + \e i].
+     *
+     * The local coordinates are converted to Math::real and the calculation
+     * is carried out with this type; thus the only error due to using T =
+     * float is that inherent in representing the local coordinates as
+     * floats.  The results are identical to those given by calling
+     * LocalCartesian::Reverse with the converted local coordinates.
+     **********************************************************************/
+    template<typename T>
+    void ReverseBatch(const T x[], const T y[], const T z[], size_t n,
+                      real lat[], real lon[], real h[], real M[] = 0) const
+    { IntReverseBatch(x, y, z, 1, n, lat, lon, h, 1, M); }
+
+    /**
+     * Convert an array of local cartesian coordinates to geodetic coordinates
+     * with interleaved storage.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] xyz array of 3 \e n elements holding the local coordinates
+     *   \e x, \e y, \e z of each point in turn.
+     * @param[in] n the number of points.
+     * @param[out] llh array of 3 \e n elements for the latitude, longitude,
+     *   and height of each point in turn.
+     * @param[out] M if not a null pointer (the default), an array of 9 \e n
+     *   elements which is filled with the rotation matrices (stored by
+     *   component).
+     *
+     * If T = Math::real, \e llh may be the same as \e xyz.  Otherwise, this
+     * is the same as the non-interleaved version of
+     * LocalCartesian::ReverseBatch.
+     **********************************************************************/
+    template<typename T>
+    void ReverseBatch(const T xyz[], size_t n, real llh[], real M[] = 0)
+      const {
+      IntReverseBatch(xyz, xyz + 1, xyz + 2, dim_, n,
+                      llh, llh + 1, llh + 2, dim_, M);
+    }
+
+    /**
+     * Convert from the local cartesian coordinates of another system to
+     * those of this system.
+     *
+     * @param[in] lc the other LocalCartesian object.
+     * @param[in] x local cartesian coordinate in \e lc (meters).
+     * @param[in] y local cartesian coordinate in \e lc (meters).
+     * @param[in] z local cartesian coordinate in \e lc (meters).
+     * @param[out] x1 local cartesian coordinate in this system (meters).
+     * @param[out] y1 local cartesian coordinate in this system (meters).
+     * @param[out] z1 local cartesian coordinate in this system (meters).
+     *
+     * The conversion is a rotation and a translation, computed from the
+     * origins and the rotation matrices of the two systems; this is the
+     * same as converting to geocentric coordinates with \e lc and back with
+     * this system, except for roundoff.  In particular, the ellipsoids of
+     * the two systems are not checked.  To convert many points use
+     * LocalCartesian::FromFrameBatch.
+     **********************************************************************/
+    void FromFrame(const LocalCartesian& lc, real x, real y, real z,
+                   real& x1, real& y1, real& z1) const
+    { IntFromFrameBatch(lc, &x, &y, &z, 1, 1, &x1, &y1, &z1, 1); }
+
+    /**
+     * Convert arrays of local cartesian coordinates of another system to
+     * those of this system.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] lc the other LocalCartesian object.
+     * @param[in] x array of local cartesian coordinates in \e lc (meters).
+     * @param[in] y array of local cartesian coordinates in \e lc (meters).
+     * @param[in] z array of local cartesian coordinates in \e lc (meters).
+     * @param[in] n the number of points.
+     * @param[out] x1 array of local cartesian coordinates in this system
+     *   (meters).
+     * @param[out] y1 array of local cartesian coordinates in this system
+     *   (meters).
+     * @param[out] z1 array of local cartesian coordinates in this system
+     *   (meters).
+     *
+     * The rotation and translation between the two systems (see
+     * LocalCartesian::FromFrame) are computed once, so each point costs
+     * only 9 multiplications and 9 additions.  This is much faster than
+     * calling LocalCartesian::Reverse with \e lc followed by
+     * LocalCartesian::Forward with this system.  The calculation is carried
+     * out with Math::real and the results are rounded to type T.  An output
+     * array may be the same as an input array.  This function is defined in
+     * the header file; if the calling code is compiled with OpenMP, the
+     * points are divided among the threads.
+     **********************************************************************/
+    template<typename T>
+    void FromFrameBatch(const LocalCartesian& lc,
+                        const T x[], const T y[], const T z[], size_t n,
+                        T x1[], T y1[], T z1[]) const
+    { IntFromFrameBatch(lc, x, y, z, 1, n, x1, y1, z1, 1); }
+
+    /**
+     * Convert an array of local cartesian coordinates of another system to
+     * those of this system, with the coordinates interleaved.
+     *
+     * @tparam T the type of the local coordinates, typically float or
+     *   Math::real.
+     * @param[in] lc the other LocalCartesian object.
+     * @param[in] xyz array of 3 \e n elements holding the local coordinates
+     *   in \e lc, \e x, \e y, \e z, for each point in turn (meters).
+     * @param[in] n the number of points.
+     * @param[out] xyz1 array of 3 \e n elements for the local coordinates in
+     *   this system (meters).
+     *
+     * This is otherwise the same as LocalCartesian::FromFrameBatch.
+     **********************************************************************/
+    template<typename T>
+    void FromFrameBatch(const LocalCartesian& lc, const T xyz[], size_t n,
+                        T xyz1[]) const {
+      IntFromFrameBatch(lc, xyz, xyz + 1, xyz + 2, dim_, n,
+                        xyz1, xyz1 + 1, xyz1 + 2, dim_);
+    }
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
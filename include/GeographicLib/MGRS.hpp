@@ -84,14 +84,14 @@ namespace GeographicLib {
       static const real angeps = pow(real(0.5), Math::digits() - 7);
       return angeps;
     }
-    static const std::string hemispheres_;
-    static const std::string utmcols_[3];
-    static const std::string utmrow_;
-    static const std::string upscols_[4];
-    static const std::string upsrows_[2];
-    static const std::string latband_;
-    static const std::string upsband_;
-    static const std::string digits_;
+    static const char* const hemispheres_;
+    static const char* const utmcols_[3];
+    static const char* const utmrow_;
+    static const char* const upscols_[4];
+    static const char* const upsrows_[2];
+    static const char* const latband_;
+    static const char* const upsband_;
+    static const char* const digits_;
 
     static const int mineasting_[4];
     static const int maxeasting_[4];
@@ -107,11 +107,36 @@ namespace GeographicLib {
       utmevenrowshift_ = 5,
       // Maximum precision is um
       maxprec_ = 5 + 6,
+      // Maximum length of an MGRS string: zone, 3 letters, easting + northing
+      maxlen_ = 2 + 3 + 2 * maxprec_,
     };
-    static void CheckCoords(bool utmp, bool& northp, real& x, real& y);
+    // If throwp = false, return false instead of throwing an exception.
+    static bool CheckCoords(bool utmp, bool& northp, real& x, real& y,
+                            bool throwp = true);
+    // Write the MGRS string (unterminated) to mgrs and return its length.  If
+    // throwp = false, return -1 instead of throwing an exception.
+    static int Encode(int zone, bool northp, real x, real y, real lat,
+                      int prec, char mgrs[], bool throwp);
+    // Tables for decoding the characters of an MGRS string.
+    class Decoder;
+    // A latitude which is good enough to determine the latitude band.
+    static real ApproxLatitude(int zone, bool northp, real x, real y,
+                               bool throwp);
+    // Versions of Reverse which, if throwp = false, return false instead of
+    // throwing an exception.
+    static bool Reverse(const char* mgrs, size_t n,
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp, bool throwp);
+    static bool Reverse(const std::string& mgrs,
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp, bool throwp) {
+      return Reverse(mgrs.data(), mgrs.size(), zone, northp, x, y, prec,
+                     centerp, throwp);
+    }
     static int UTMRow(int iband, int icol, int irow);
 
-    friend class UTMUPS;        // UTMUPS::StandardZone calls LatitudeBand
+    friend class UTMUPS;        // UTMUPS uses the tile constants
+    friend class GeoCoords;     // GeoCoords::Reset uses the throwp version
     // Return latitude band number [-10, 10) for the given latitude (degrees).
     // The bands are reckoned in include their southern edges.
     static int LatitudeBand(real lat) {
@@ -274,6 +299,87 @@ namespace GeographicLib {
     static void Forward(int zone, bool northp, real x, real y, real lat,
                         int prec, std::string& mgrs);
 
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate stored in a
+     * character array.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs the MGRS string (null terminated).
+     * @param[in] cap the size of the array \e mgrs.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @exception GeographicErr if \e cap is too small to hold the result.
+     * @return the length of the MGRS string (excluding the terminating null).
+     *
+     * This is the same as MGRS::Forward(int, bool, real, real, int,
+     * std::string&) except that the result is written to \e mgrs and no
+     * memory is allocated.  An MGRS string has at most 27 characters, so \e
+     * cap = 28 suffices for every \e prec.  If an error is thrown, then \e
+     * mgrs is unchanged.
+     **********************************************************************/
+    static size_t Forward(int zone, bool northp, real x, real y,
+                          int prec, char* mgrs, size_t cap);
+
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate stored in a
+     * character array when the latitude is known.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] lat latitude (degrees).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs the MGRS string (null terminated).
+     * @param[in] cap the size of the array \e mgrs.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @exception GeographicErr if \e lat is inconsistent with the given UTM
+     *   coordinates.
+     * @exception GeographicErr if \e cap is too small to hold the result.
+     * @return the length of the MGRS string (excluding the terminating null).
+     **********************************************************************/
+    static size_t Forward(int zone, bool northp, real x, real y, real lat,
+                          int prec, char* mgrs, size_t cap);
+
+    /**
+     * Convert an array of UTM or UPS coordinates to MGRS coordinates stored in
+     * a contiguous character array.
+     *
+     * @param[in] zone array of UTM zones (zero means UPS).
+     * @param[in] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] lat array of latitudes (degrees); this may be a null
+     *   pointer.
+     * @param[in] n the number of points.
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs the array of MGRS strings; this must have at least \e
+     *   n &times; \e stride elements.
+     * @param[in] stride the spacing of the strings in \e mgrs.
+     * @exception GeographicErr if \e prec is not in [&minus;1, 11].
+     * @exception GeographicErr if \e stride is too small to hold the results.
+     * @return the number of points for which the conversion failed.
+     *
+     * The MGRS string for point \e i is written, null terminated, starting
+     * at \e mgrs[\e i &times; \e stride].  \e stride must exceed the
+     * maximum length of the strings, namely max(5 + 2 \e prec, 7); thus
+     * \e stride = 28 suffices for every \e prec.  If \e lat is a null
+     * pointer, the latitudes are estimated as in MGRS::Forward(int, bool,
+     * real, real, int, std::string&).  If the conversion fails for a point
+     * (because the point is out of range, for example), the corresponding
+     * string is empty; no exception is thrown in this case.
+     **********************************************************************/
+    static size_t ForwardBatch(const int zone[], const bool northp[],
+                               const real x[], const real y[],
+                               const real lat[], size_t n,
+                               int prec, char* mgrs, size_t stride);
+
     /**
      * Convert a MGRS coordinate to UTM or UPS coordinates.
      *
@@ -323,6 +429,107 @@ namespace GeographicLib {
                         int& zone, bool& northp, real& x, real& y,
                         int& prec, bool centerp = true);
 
+    /**
+     * MGRS::Reverse returning a status instead of throwing an exception.
+     *
+     * @param[in] mgrs MGRS string.
+     * @param[out] zone UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @return true if \e mgrs was parsed successfully; otherwise false, in
+     *   which case the output arguments are unchanged.
+     *
+     * This does not throw an exception and no memory is allocated on the
+     * failure path, so it is suitable for processing data in which illegal
+     * MGRS strings are common.  The results are otherwise identical to those
+     * of MGRS::Reverse.
+     **********************************************************************/
+    static bool TryReverse(const std::string& mgrs,
+                           int& zone, bool& northp, real& x, real& y,
+                           int& prec, bool centerp = true)
+    { return Reverse(mgrs, zone, northp, x, y, prec, centerp, false); }
+
+    /**
+     * MGRS::Reverse for a character array.
+     *
+     * @param[in] mgrs pointer to the MGRS string.
+     * @param[in] n the number of characters in the MGRS string.
+     * @param[out] zone UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e mgrs is illegal.
+     *
+     * \e mgrs need not be null terminated, so this allows an MGRS string
+     * embedded in a larger buffer to be parsed without copying it.
+     **********************************************************************/
+    static void Reverse(const char* mgrs, size_t n,
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp = true)
+    { Reverse(mgrs, n, zone, northp, x, y, prec, centerp, true); }
+
+    /**
+     * MGRS::TryReverse for a character array.
+     *
+     * @param[in] mgrs pointer to the MGRS string.
+     * @param[in] n the number of characters in the MGRS string.
+     * @param[out] zone UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @return true if \e mgrs was parsed successfully; otherwise false, in
+     *   which case the output arguments are unchanged.
+     **********************************************************************/
+    static bool TryReverse(const char* mgrs, size_t n,
+                           int& zone, bool& northp, real& x, real& y,
+                           int& prec, bool centerp = true)
+    { return Reverse(mgrs, n, zone, northp, x, y, prec, centerp, false); }
+
+    /**
+     * Convert an array of MGRS coordinates to UTM or UPS coordinates.
+     *
+     * @param[in] buf the buffer holding the MGRS strings.
+     * @param[in] offsets array of \e n + 1 offsets into \e buf; MGRS string
+     *   \e i occupies [\e offsets[\e i], \e offsets[\e i + 1]).
+     * @param[in] n the number of MGRS strings.
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec array of precisions relative to 100 km.
+     * @param[out] valid array of flags indicating which strings were parsed
+     *   successfully; this may be a null pointer.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @return the number of strings which could not be parsed.
+     *
+     * A trailing newline (or carriage return + newline) on each string is
+     * ignored; thus for a buffer of newline-separated MGRS strings, \e
+     * offsets can be set to the positions of the starts of the lines (with
+     * the last entry equal to the length of the buffer).  The results are
+     * the same as those return by MGRS::Reverse, except that no exception is
+     * thrown for an illegal string; instead \e zone is set to
+     * UTMUPS::INVALID, \e northp to false, \e x and \e y to NaN, \e prec
+     * to &minus;2 (as for an "INVALID" MGRS string), and the corresponding
+     * element of \e valid is set to false.
+     **********************************************************************/
+    static size_t ReverseBatch(const char* buf, const size_t offsets[],
+                               size_t n,
+                               int zone[], bool northp[], real x[], real y[],
+                               int prec[], bool valid[] = 0,
+                               bool centerp = true);
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
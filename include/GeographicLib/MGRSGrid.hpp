@@ -0,0 +1,204 @@
+/**
+ * \file MGRSGrid.hpp
+ * \brief Header for GeographicLib::MGRSGrid class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MGRSGRID_HPP)
+#define GEOGRAPHICLIB_MGRSGRID_HPP 1
+
+#include <string>
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The MGRS grid squares and grid lines for a region
+   *
+   * This finds the MGRS grid squares of a given size which overlap a region
+   * specified by ranges of latitude and longitude (e.g., the viewport of a
+   * map) together with their labels, and the grid lines bounding these
+   * squares as polylines in geographic coordinates, as needed to draw an
+   * MGRS grid on a map.
+   *
+   * The region is split into pieces lying in a single UTM zone and
+   * hemisphere (following the standard rules for the zones, including the
+   * exceptions for Norway and Svalbard).  For each piece, the UTM
+   * coordinates of the lattice of grid corners covering the piece and of \e
+   * nseg &minus; 1 intermediate points on each edge of the lattice are
+   * converted to geographic coordinates with a single call to the array
+   * version of TransverseMercator::Reverse; so each corner is computed once
+   * even though it is shared by four squares and two lines.  The polylines
+   * are then clipped to the piece by linear interpolation between these
+   * points.  The grid squares returned are those whose boundaries (the
+   * polygons through the corners and intermediate points) overlap the
+   * piece.
+   *
+   * Only the UTM zones are covered, i.e., the region is restricted to
+   * latitudes in [&minus;80&deg;, 84&deg;]; the polar regions (which use
+   * UPS) are omitted.
+   *
+   * Example of use:
+   * \include example-MGRSGrid.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT MGRSGrid {
+  public:
+    /**
+     * \brief An MGRS grid square
+     **********************************************************************/
+    struct Square {
+      /**
+       * The UTM zone.
+       **********************************************************************/
+      int zone;
+      /**
+       * The hemisphere (true means north).
+       **********************************************************************/
+      bool northp;
+      /**
+       * The easting and northing of the southwest corner (meters).
+       **********************************************************************/
+      Math::real x, y;
+      /**
+       * The latitudes of the corners (degrees), in the order southwest,
+       * southeast, northeast, northwest.
+       **********************************************************************/
+      Math::real lat[4];
+      /**
+       * The longitudes of the corners (degrees), in the same order.
+       **********************************************************************/
+      Math::real lon[4];
+      /**
+       * The MGRS label of the square (empty if the square can't be
+       * labelled).
+       **********************************************************************/
+      std::string mgrs;
+      /**
+       * Is the square only partly within the region?
+       **********************************************************************/
+      bool partial;
+    };
+
+    /**
+     * \brief An MGRS grid line
+     **********************************************************************/
+    struct Line {
+      /**
+       * The UTM zone.
+       **********************************************************************/
+      int zone;
+      /**
+       * The hemisphere (true means north).
+       **********************************************************************/
+      bool northp;
+      /**
+       * Is this a line of constant easting (as opposed to constant
+       * northing)?
+       **********************************************************************/
+      bool eastingp;
+      /**
+       * The easting or northing of the line (meters).
+       **********************************************************************/
+      Math::real value;
+      /**
+       * The latitudes of the vertices of the polyline (degrees).
+       **********************************************************************/
+      std::vector<Math::real> lat;
+      /**
+       * The longitudes of the vertices of the polyline (degrees).
+       **********************************************************************/
+      std::vector<Math::real> lon;
+    };
+
+  private:
+    typedef Math::real real;
+    int _prec, _nseg;
+    real _spacing;
+  public:
+
+    /**
+     * Constructor for MGRSGrid.
+     *
+     * @param[in] prec the precision of the grid relative to 100 km, in [0,
+     *   5]; the squares have sides of 100 km for \e prec = 0, 10 km for \e
+     *   prec = 1, etc.
+     * @param[in] nseg the number of segments into which each side of a
+     *   square is divided in the polylines for the grid lines, in [1, 1000];
+     *   default 8.
+     * @exception GeographicErr if \e prec or \e nseg is out of range.
+     *
+     * The error in representing the sides of a square by \e nseg straight
+     * segments in geographic coordinates is proportional to
+     * (<i>s</i>/<i>nseg</i>)<sup>2</sup>, where \e s is the side of the
+     * square; the default, \e nseg = 8, is ample for rendering a map.
+     **********************************************************************/
+    MGRSGrid(int prec, int nseg = 8);
+
+    /**
+     * Find the grid squares and grid lines for a region.
+     *
+     * @param[in] lat0 the southern edge of the region (degrees).
+     * @param[in] lon0 the western edge of the region (degrees).
+     * @param[in] lat1 the northern edge of the region (degrees).
+     * @param[in] lon1 the eastern edge of the region (degrees).
+     * @param[out] squares the grid squares overlapping the region.
+     * @param[out] lines the grid lines, clipped to the region.
+     * @param[in] nthreads the number of threads to use for the projections;
+     *   default 1.
+     * @exception GeographicErr if \e lat0 or \e lat1 is not in [&minus;90&deg;,
+     *   90&deg;], if \e lat0 &gt; \e lat1, or if \e lon1 &minus; \e lon0 is
+     *   not in [0&deg;, 360&deg;].
+     * @exception std::bad_alloc if the memory for the results can't be
+     *   allocated.
+     *
+     * The results replace the previous contents of \e squares and \e lines.
+     * The region may straddle the antimeridian (e.g., \e lon0 = 170&deg;
+     * and \e lon1 = 190&deg;); the longitudes of the results lie in [\e
+     * lon0, \e lon1] as far as possible.  The squares are ordered by zone,
+     * hemisphere, northing and easting.  A grid line which leaves and
+     * re-enters the region (or crosses the equator) is broken into several
+     * Line objects.  The boundaries of the zones (which are meridians and
+     * not grid lines) are not included; the grid lines end there.  A square
+     * cut by the boundary of a zone is returned in full (with
+     * Square::partial = true) with the zone of the part inside the region.
+     * The latitude band in the label of a square which straddles a band
+     * boundary is that of the center of the square (moved into the region if
+     * necessary).
+     *
+     * The number of squares is proportional to the area of the region
+     * divided by the area of a square, so the precision should be chosen to
+     * suit the size of the region.
+     **********************************************************************/
+    void Generate(real lat0, real lon0, real lat1, real lon1,
+                  std::vector<Square>& squares, std::vector<Line>& lines,
+                  int nthreads = 1) const;
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e prec the precision used in the constructor.
+     **********************************************************************/
+    int Precision() const { return _prec; }
+
+    /**
+     * @return \e nseg the number of segments per side of a square used in
+     *   the constructor.
+     **********************************************************************/
+    int Segments() const { return _nseg; }
+
+    /**
+     * @return the side of a grid square (meters).
+     **********************************************************************/
+    Math::real Spacing() const { return _spacing; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MGRSGRID_HPP
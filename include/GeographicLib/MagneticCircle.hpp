@@ -27,6 +27,10 @@ namespace GeographicLib {
    * Use MagneticModel::Circle to create a MagneticCircle object.  (The
    * constructor for this class is private.)
    *
+   * Once the object is constructed, evaluating the field at a point
+   * doesn't allocate memory; the rows reuse per-thread scratch space as
+   * described in CircularEngine.
+   *
    * Example of use:
    * \include example-MagneticCircle.cpp
    *
@@ -132,6 +136,35 @@ namespace GeographicLib {
                     real& Bxt, real& Byt, real& Bzt) const {
       Field(lon, true, Bx, By, Bz, Bxt, Byt, Bzt);
     }
+
+    /**
+     * Evaluate the components of the geomagnetic field (and optionally their
+     * time derivatives) for a row of equally spaced longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla) at longitudes \e lon0 + \e j \e dlon for \e j = 0, 1,
+     *   ..., \e nlon &minus; 1.
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[out] Bxt array of the rates of change of \e Bx (nT/yr).
+     * @param[out] Byt array of the rates of change of \e By (nT/yr).
+     * @param[out] Bzt array of the rates of change of \e Bz (nT/yr).
+     * @exception std::bad_alloc if memory for the FFT can't be allocated.
+     *
+     * The rates of change are only computed if \e Bxt, \e Byt, and \e Bzt
+     * are all non-null.  The results are the same as those of
+     * MagneticCircle::operator()() for each longitude (to within roundoff).
+     * The sums over order are done with CircularEngine::EvaluateRow, which
+     * uses a fast Fourier transform when 360&deg;/\e dlon is an integer.
+     **********************************************************************/
+    void FieldRow(real lon0, real dlon, int nlon,
+                  real Bx[], real By[], real Bz[],
+                  real Bxt[] = 0, real Byt[] = 0, real Bzt[] = 0) const;
     ///@}
 
     /** \name Inspector functions
@@ -0,0 +1,221 @@
+/**
+ * \file MagneticCircleCache.hpp
+ * \brief Header for GeographicLib::MagneticCircleCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MAGNETICCIRCLECACHE_HPP)
+#define GEOGRAPHICLIB_MAGNETICCIRCLECACHE_HPP 1
+
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/MagneticCircle.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A cache of recently used magnetic circles
+   *
+   * This is the analogue of GravityCircleCache for MagneticModel.  It holds
+   * up to a given number of MagneticCircle objects; when it is full, the
+   * least recently used circle is discarded.  As with GravityCircleCache,
+   * the latitudes and heights may be quantized by specifying the spacings
+   * \e dlat and \e dh of a grid; the evaluation functions then interpolate
+   * linearly between the circles at the surrounding grid points.  The
+   * errors in the interpolation scale as the squares of the spacings; for a
+   * degree 13 model, \e dlat = 0.01&deg; and \e dh = 100 m give errors of
+   * less than 1 nT, which is much smaller than the uncertainty of such
+   * models.
+   *
+   * The time is not quantized.  A magnetic model varies linearly with time
+   * between its epochs; so the cache holds a circle for each epoch interval
+   * and the field at any time in the interval is given exactly by the field
+   * and its rate of change at a reference time in the interval.  Thus,
+   * with \e dlat = \e dh = 0 (the default), the results are the same (to
+   * within roundoff) as those given by MagneticModel.
+   *
+   * If the library was compiled with C++11 support, the member functions
+   * lock an internal mutex so that a single cache can be shared by several
+   * threads; see MagneticCircleCache::ThreadSafe.  The construction of new
+   * circles and the evaluation of the cached circles take place outside the
+   * lock.
+   *
+   * Example of use:
+   * \include example-MagneticCircleCache.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT MagneticCircleCache {
+  private:
+    typedef Math::real real;
+    class Impl;
+    Impl* _impl;
+    void Field(real t, real lat, real lon, real h, bool diffp,
+               real& Bx, real& By, real& Bz,
+               real& Bxt, real& Byt, real& Bzt);
+    // copy constructor not allowed
+    MagneticCircleCache(const MagneticCircleCache&);
+    // nor copy assignment
+    MagneticCircleCache& operator=(const MagneticCircleCache&);
+  public:
+
+    /**
+     * Constructor for MagneticCircleCache.
+     *
+     * @param[in] m the MagneticModel used to construct the circles.
+     * @param[in] capacity the maximum number of circles held by the cache.
+     * @param[in] dlat the spacing of the grid of latitudes (degrees); if 0
+     *   (the default), the latitudes are not quantized.
+     * @param[in] dh the spacing of the grid of heights (meters); if 0 (the
+     *   default), the heights are not quantized.
+     * @exception GeographicErr if \e dlat or \e dh is negative or not finite.
+     * @exception std::bad_alloc if the memory for the cache can't be
+     *   allocated.
+     *
+     * A reference to \e m is stored; so \e m must outlive the cache.  If \e
+     * capacity = 0, no circles are cached.
+     **********************************************************************/
+    MagneticCircleCache(const MagneticModel& m, size_t capacity,
+                        real dlat = 0, real dh = 0);
+
+    /**
+     * The destructor.
+     **********************************************************************/
+    ~MagneticCircleCache();
+
+    /**
+     * Return a magnetic circle, from the cache if possible.
+     *
+     * @param[in] t the time (years).
+     * @param[in] lat latitude of the circle (degrees).
+     * @param[in] h the height of the circle above the ellipsoid (meters).
+     * @return a MagneticCircle equivalent to m.Circle(\e t0, \e lat, \e h)
+     *   with \e lat and \e h replaced by the nearest grid values.
+     *
+     * \e t0 is the reference time for the epoch interval containing \e t
+     * (this is given by MagneticCircle::Time).  The field at \e t is
+     * obtained by evaluating the circle with the time derivatives and
+     * adding (\e t &minus; \e t0) times the derivatives to the field.  If
+     * \e lat or \e h is a NaN, the circle is constructed and not cached.
+     **********************************************************************/
+    MagneticCircle Circle(real t, real lat, real h);
+
+    /** \name Compute the magnetic field
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the components of the geomagnetic field.
+     *
+     * @param[in] t the time (years).
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     **********************************************************************/
+    void operator()(real t, real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz) {
+      real dummy;
+      Field(t, lat, lon, h, false, Bx, By, Bz, dummy, dummy, dummy);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives.
+     *
+     * @param[in] t the time (years).
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     **********************************************************************/
+    void operator()(real t, real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz,
+                    real& Bxt, real& Byt, real& Bzt) {
+      Field(t, lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
+    }
+    ///@}
+
+    /**
+     * Remove all the circles from the cache.  The hit and miss counters are
+     * not changed.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * Change the capacity of the cache.
+     *
+     * @param[in] capacity the new maximum number of circles.
+     *
+     * If the cache holds more than \e capacity circles, the least recently
+     * used ones are discarded.
+     **********************************************************************/
+    void SetCapacity(size_t capacity);
+
+    /**
+     * Reset the hit and miss counters to zero.
+     **********************************************************************/
+    void ResetCounters();
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the maximum number of circles held by the cache.
+     **********************************************************************/
+    size_t Capacity() const;
+
+    /**
+     * @return the number of circles currently in the cache.
+     **********************************************************************/
+    size_t Size() const;
+
+    /**
+     * @return the number of requests for a circle (including those made by
+     *   the evaluation functions) which were satisfied from the cache.
+     **********************************************************************/
+    unsigned long Hits() const;
+
+    /**
+     * @return the number of requests for a circle (including those made by
+     *   the evaluation functions) which required a new circle to be
+     *   constructed.
+     **********************************************************************/
+    unsigned long Misses() const;
+
+    /**
+     * @return \e dlat the spacing of the grid of latitudes (degrees).
+     **********************************************************************/
+    Math::real LatitudeSpacing() const;
+
+    /**
+     * @return \e dh the spacing of the grid of heights (meters).
+     **********************************************************************/
+    Math::real HeightSpacing() const;
+
+    /**
+     * @return true if the cache may be used by several threads
+     *   simultaneously.  This depends on whether the library was compiled
+     *   with C++11 support.
+     **********************************************************************/
+    static bool ThreadSafe();
+    ///@}
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MAGNETICCIRCLECACHE_HPP
@@ -0,0 +1,211 @@
+/**
+ * \file MagneticLocation.hpp
+ * \brief Header for GeographicLib::MagneticLocation class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MAGNETICLOCATION_HPP)
+#define GEOGRAPHICLIB_MAGNETICLOCATION_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geomagnetic field at a fixed location
+   *
+   * Evaluate the earth's magnetic field at a particular point as a function
+   * of time.  Within each interval between the epochs of a MagneticModel,
+   * the field is a linear function of time.  A MagneticLocation holds, for
+   * each interval, the field at the start of the interval and its rate of
+   * change at the point (each of which is given by spherical harmonic sums
+   * which are evaluated once, when the object is created).  The field at any
+   * time then costs just a few multiplications and additions.  This is
+   * useful for the long time series of a magnetic observatory or a base
+   * station.
+   *
+   * The results are the same as those of MagneticModel::operator()() to
+   * within roundoff.  A MagneticLocation is immutable and its member
+   * functions may be called concurrently from several threads.  It may be
+   * copied.
+   *
+   * Use MagneticModel::AtLocation to create a MagneticLocation object.  (The
+   * constructor for this class is private.)
+   *
+   * Example of use:
+   * \include example-MagneticLocation.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT MagneticLocation {
+  private:
+    typedef Math::real real;
+
+    real _lat, _lon, _h, _t0, _dt0;
+    int _Nmodels;
+    // For each interval, the easterly, northerly, and up components of the
+    // field at the start of the interval followed by their rates of change.
+    std::vector<real> _field;
+
+    MagneticLocation(real lat, real lon, real h, real t0, real dt0,
+                     int Nmodels, std::vector<real>& field)
+      : _lat(lat)
+      , _lon(lon)
+      , _h(h)
+      , _t0(t0)
+      , _dt0(dt0)
+      , _Nmodels(Nmodels)
+    { _field.swap(field); }
+
+    void Field(real t, bool diffp,
+               real& Bx, real& By, real& Bz,
+               real& Bxt, real& Byt, real& Bzt) const {
+      // Select the interval as in MagneticModel::Field
+      t -= _t0;
+      int n = (std::max)((std::min)(int(std::floor(t / _dt0)), _Nmodels - 1),
+                         0);
+      t -= n * _dt0;
+      const real* f = &_field[6 * n];
+      Bx = f[0] + t * f[3];
+      By = f[1] + t * f[4];
+      Bz = f[2] + t * f[5];
+      if (diffp) {
+        Bxt = f[3];
+        Byt = f[4];
+        Bzt = f[5];
+      }
+    }
+    void FieldBatch(const real t[], size_t n, bool diffp,
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[], real Byt[], real Bzt[]) const;
+
+    friend class MagneticModel; // MagneticModel calls the private constructor
+
+  public:
+
+    /**
+     * A default constructor.  This sets up an uninitialized object which can
+     * be later replaced by the MagneticModel::AtLocation.
+     **********************************************************************/
+    MagneticLocation() : _Nmodels(0) {}
+
+    /** \name Compute the magnetic field
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the components of the geomagnetic field.
+     *
+     * @param[in] t the time (years).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     **********************************************************************/
+    void operator()(real t, real& Bx, real& By, real& Bz) const {
+      real dummy;
+      Field(t, false, Bx, By, Bz, dummy, dummy, dummy);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives
+     *
+     * @param[in] t the time (years).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     **********************************************************************/
+    void operator()(real t, real& Bx, real& By, real& Bz,
+                    real& Bxt, real& Byt, real& Bzt) const {
+      Field(t, true, Bx, By, Bz, Bxt, Byt, Bzt);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field at an array of times.
+     *
+     * @param[in] t array of times (years).
+     * @param[in] n the number of times.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     *
+     * The results are identical to calling MagneticLocation::operator()() for
+     * each time.
+     **********************************************************************/
+    void operator()(const real t[], size_t n,
+                    real Bx[], real By[], real Bz[]) const
+    { FieldBatch(t, n, false, Bx, By, Bz, 0, 0, 0); }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives at an array of times.
+     *
+     * @param[in] t array of times (years).
+     * @param[in] n the number of times.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[out] Bxt array of the rates of change of \e Bx (nT/yr).
+     * @param[out] Byt array of the rates of change of \e By (nT/yr).
+     * @param[out] Bzt array of the rates of change of \e Bz (nT/yr).
+     *
+     * The results are identical to calling MagneticLocation::operator()() for
+     * each time.
+     **********************************************************************/
+    void operator()(const real t[], size_t n,
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[], real Byt[], real Bzt[]) const
+    { FieldBatch(t, n, true, Bx, By, Bz, Bxt, Byt, Bzt); }
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _Nmodels > 0; }
+    /**
+     * @return the latitude of the point (degrees).
+     **********************************************************************/
+    Math::real Latitude() const
+    { return Init() ? _lat : Math::NaN(); }
+    /**
+     * @return the longitude of the point (degrees).
+     **********************************************************************/
+    Math::real Longitude() const
+    { return Init() ? _lon : Math::NaN(); }
+    /**
+     * @return the height of the point above the ellipsoid (meters).
+     **********************************************************************/
+    Math::real Height() const
+    { return Init() ? _h : Math::NaN(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_MAGNETICLOCATION_HPP
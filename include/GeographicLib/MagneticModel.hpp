@@ -23,6 +23,8 @@
 namespace GeographicLib {
 
   class MagneticCircle;
+  class MagneticLocation;
+  class MagneticSnapshot;
 
   /**
    * \brief Model of the earth's magnetic field
@@ -63,19 +65,45 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT MagneticModel {
   private:
     typedef Math::real real;
+    friend class MagneticCircleCache;
     static const int idlength_ = 8;
     std::string _name, _dir, _description, _date, _filename, _id;
     real _t0, _dt0, _tmin, _tmax, _a, _hmin, _hmax;
     int _Nmodels, _Nconstants;
     SphericalHarmonic::normalization _norm;
     Geocentric _earth;
-    std::vector< std::vector<real> > _G;
-    std::vector< std::vector<real> > _H;
-    std::vector<SphericalHarmonic> _harm;
+    // These are filled in on demand if the coefficients are loaded lazily
+    mutable std::vector< std::vector<real> > _G;
+    mutable std::vector< std::vector<real> > _H;
+    mutable std::vector<SphericalHarmonic> _harm;
+    // The memory mapped coefficient file (if any)
+    char* _map;
+    unsigned long long _maplen;
+    void* _maphandle;
+    // The state for loading the coefficients lazily (if requested)
+    class Loader;
+    Loader* _loader;
+    const SphericalHarmonic& Harmonic(int k) const;
+    void LoadCoefficients(int k) const;
+    void FieldValues(int L, const SphericalEngine::coeff c[],
+                     real X, real Y, real Z,
+                     real BX[], real BY[], real BZ[]) const;
     void Field(real t, real lat, real lon, real h, bool diffp,
                real& Bx, real& By, real& Bz,
                real& Bxt, real& Byt, real& Bzt) const;
+    // The number of points evaluated together by FieldRange
+    static const int batchsize_ = 64;
+    void FieldRange(const real t[], const real lat[], const real lon[],
+                    const real h[], size_t i0, size_t i1, bool diffp,
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[], real Byt[], real Bzt[]) const;
+    void FieldBatch(const real t[], const real lat[], const real lon[],
+                    const real h[], size_t n, bool diffp,
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[], real Byt[], real Bzt[], int nthreads) const;
     void ReadMetadata(const std::string& name);
+    bool MapCoefficients(const std::string& coeff);
+    void ScanCoefficients(const std::string& coeff);
     MagneticModel(const MagneticModel&); // copy constructor not allowed
     MagneticModel& operator=(const MagneticModel&); // nor copy assignment
   public:
@@ -90,6 +118,10 @@ namespace GeographicLib {
      * @param[in] path (optional) directory for data file.
      * @param[in] earth (optional) Geocentric object for converting
      *   coordinates; default Geocentric::WGS84().
+     * @param[in] map (optional) if true, use the coefficients in place in a
+     *   memory mapping of the coefficient file (default false).
+     * @param[in] lazy (optional) if true, read the coefficients for each
+     *   epoch only when they are first needed (default false).
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt.
      * @exception std::bad_alloc if the memory necessary for storing the model
@@ -109,10 +141,37 @@ namespace GeographicLib {
      * The final earth argument to the constructor specifies an ellipsoid to
      * allow geodetic coordinates to the transformed into the spherical
      * coordinates used in the spherical harmonic sum.
+     *
+     * If \e map is true, the coefficient file is mapped into memory instead
+     * of being read; the results are the same.  See
+     * GravityModel::GravityModel for details.
+     *
+     * If \e lazy is true (and the file is not mapped), the constructor only
+     * reads the headers of the sets of coefficients in the ".wmm.cof" file
+     * (to check its structure and to find the offset of each set).  The
+     * coefficients for each epoch are read only when they are first needed,
+     * so that the time taken by the constructor and the memory used depend
+     * only on the epochs actually used.  This is useful for models with many
+     * epochs, such as IGRF, when only a few times are required; the results
+     * are the same.  In this case, the coefficient file is kept open during
+     * the lifetime of the MagneticModel, and the functions which evaluate
+     * the field throw GeographicErr if the coefficients can't be read (or
+     * are corrupt).  If the library was compiled with
+     * C++11 support, the loading is guarded by an internal mutex, so that
+     * the MagneticModel can still be used by several threads at once.  (With
+     * \e map = true, the coefficients are already loaded on demand, because
+     * only the pages of the mapping which are used are read from the file.)
      **********************************************************************/
     explicit MagneticModel(const std::string& name,
                            const std::string& path = "",
-                           const Geocentric& earth = Geocentric::WGS84());
+                           const Geocentric& earth = Geocentric::WGS84(),
+                           bool map = false, bool lazy = false);
+
+    /**
+     * The destructor releases the memory mapping of the coefficient file, if
+     * any.
+     **********************************************************************/
+    ~MagneticModel();
     ///@}
 
     /** \name Compute the magnetic field
@@ -158,6 +217,69 @@ namespace GeographicLib {
       Field(t, lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
     }
 
+    /**
+     * Evaluate the components of the geomagnetic field at an array of points.
+     *
+     * @param[in] t array of times (years).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling MagneticModel::operator()() for
+     * each point.  However, consecutive points whose times fall in the same
+     * epoch interval of the model are grouped and the spherical harmonic sums
+     * for each group are carried out together (see
+     * SphericalHarmonic::operator()(int, const real[], const real[], const
+     * real[], real[], real[], real[], real[]) const).  This is most effective
+     * if the points are ordered by time, as in a log.  The points are divided
+     * into \e nthreads contiguous ranges which are evaluated concurrently (if
+     * the library was compiled with C++11 thread support).
+     **********************************************************************/
+    void operator()(const real t[], const real lat[], const real lon[],
+                    const real h[], size_t n,
+                    real Bx[], real By[], real Bz[], int nthreads = 1) const
+    { FieldBatch(t, lat, lon, h, n, false, Bx, By, Bz, 0, 0, 0, nthreads); }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives at an array of points.
+     *
+     * @param[in] t array of times (years).
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[out] Bxt array of the rates of change of \e Bx (nT/yr).
+     * @param[out] Byt array of the rates of change of \e By (nT/yr).
+     * @param[out] Bzt array of the rates of change of \e Bz (nT/yr).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling MagneticModel::operator()() for
+     * each point; see MagneticModel::operator()(const real[], const real[],
+     * const real[], const real[], size_t, real[], real[], real[], int) const.
+     **********************************************************************/
+    void operator()(const real t[], const real lat[], const real lon[],
+                    const real h[], size_t n,
+                    real Bx[], real By[], real Bz[],
+                    real Bxt[], real Byt[], real Bzt[], int nthreads = 1)
+      const
+    { FieldBatch(t, lat, lon, h, n, true, Bx, By, Bz, Bxt, Byt, Bzt,
+                 nthreads); }
+
     /**
      * Create a MagneticCircle object to allow the geomagnetic field at many
      * points with constant \e lat, \e h, and \e t and varying \e lon to be
@@ -166,6 +288,8 @@ namespace GeographicLib {
      * @param[in] t the time (years).
      * @param[in] lat latitude of the point (degrees).
      * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[in] nthreads the number of threads to use in constructing the
+     *   MagneticCircle (default 1).
      * @exception std::bad_alloc if the memory necessary for creating a
      *   MagneticCircle can't be allocated.
      * @return a MagneticCircle object whose MagneticCircle::operator()(real
@@ -174,9 +298,80 @@ namespace GeographicLib {
      *
      * If the field at several points on a circle of latitude need to be
      * calculated then creating a MagneticCircle and using its member functions
-     * will be substantially faster, especially for high-degree models.
+     * will be substantially faster, especially for high-degree models.  The
+     * construction of the MagneticCircle can be split between \e nthreads
+     * threads (see SphericalEngine::Circle); the result is the same
+     * regardless of \e nthreads.
+     **********************************************************************/
+    MagneticCircle Circle(real t, real lat, real h, int nthreads = 1) const;
+
+    /**
+     * Create MagneticCircle objects for several heights at a given latitude
+     * and time.
+     *
+     * @param[in] t the time (years).
+     * @param[in] lat latitude of the circles (degrees).
+     * @param[in] h array of the heights of the circles above the ellipsoid
+     *   (meters).
+     * @param[in] n the number of heights.
+     * @param[out] circles a vector which is set to the \e n MagneticCircle
+     *   objects.
+     * @param[in] nthreads the number of threads to use in constructing the
+     *   MagneticCircle objects (default 1).
+     * @exception std::bad_alloc if the memory necessary for creating the
+     *   MagneticCircle objects can't be allocated.
+     *
+     * circles[i] is the same as Circle(\e t, \e lat, h[i], \e nthreads).
+     * However, the spherical harmonic sums for several circles are carried
+     * out together with a single traversal of the coefficients (see
+     * SphericalEngine::Circles).
+     **********************************************************************/
+    void Circles(real t, real lat, const real h[], int n,
+                 std::vector<MagneticCircle>& circles, int nthreads = 1)
+      const;
+
+    /**
+     * Create a MagneticSnapshot object to allow the geomagnetic field at many
+     * points at a fixed time \e t to be computed efficiently.
+     *
+     * @param[in] t the time (years).
+     * @exception std::bad_alloc if the memory necessary for creating a
+     *   MagneticSnapshot can't be allocated.
+     * @return a MagneticSnapshot object whose
+     *   MagneticSnapshot::operator()(real lat, real lon, real h, real& Bx,
+     *   real& By, real& Bz) const member function computes the field at
+     *   particular points.
+     *
+     * The coefficients of the models for the epochs bracketing \e t (and of
+     * the time independent model, if any) are combined once, so that the
+     * field is given by a single spherical harmonic sum (and its rate of
+     * change by another).  The results are the same as those of
+     * MagneticModel::operator()() to within roundoff.
+     **********************************************************************/
+    MagneticSnapshot AtTime(real t) const;
+
+    /**
+     * Create a MagneticLocation object to allow the geomagnetic field at a
+     * fixed point to be computed efficiently at many times.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @exception GeographicErr if the coefficients are loaded lazily and
+     *   can't be read.
+     * @exception std::bad_alloc if the memory necessary for creating a
+     *   MagneticLocation can't be allocated.
+     * @return a MagneticLocation object whose
+     *   MagneticLocation::operator()(real t, real& Bx, real& By, real& Bz)
+     *   const member function computes the field at particular times.
+     *
+     * The field of the model for each epoch (and of the time independent
+     * model, if any) is evaluated at the point once.  This requires the
+     * coefficients for all the epochs; so, if they are loaded lazily, they
+     * are all read.  The results are the same as those of
+     * MagneticModel::operator()() to within roundoff.
      **********************************************************************/
-    MagneticCircle Circle(real t, real lat, real h) const;
+    MagneticLocation AtLocation(real lat, real lon, real h) const;
 
     /**
      * Compute various quantities dependent on the magnetic field.
@@ -256,6 +451,18 @@ namespace GeographicLib {
      **********************************************************************/
     const std::string& MagneticModelDirectory() const { return _dir; }
 
+    /**
+     * @return true if the coefficient file is mapped into memory (see
+     *   MagneticModel::MagneticModel).
+     **********************************************************************/
+    bool Mapped() const { return _map != 0; }
+
+    /**
+     * @return true if the coefficients are loaded on demand (see
+     *   MagneticModel::MagneticModel).
+     **********************************************************************/
+    bool Lazy() const { return _loader != 0; }
+
     /**
      * @return the minimum height above the ellipsoid (in meters) for which
      *   this MagneticModel should be used.
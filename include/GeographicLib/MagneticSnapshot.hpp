@@ -0,0 +1,187 @@
+/**
+ * \file MagneticSnapshot.hpp
+ * \brief Header for GeographicLib::MagneticSnapshot class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP)
+#define GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Geomagnetic field at a fixed time
+   *
+   * Evaluate the earth's magnetic field at a particular time.  A
+   * MagneticModel represents the field as a sequence of models at fixed
+   * epochs (together with, possibly, a time independent model); the field at
+   * time \e t is obtained by interpolating between the models for the
+   * epochs bracketing \e t.  MagneticModel::operator()() does this by
+   * evaluating a spherical harmonic sum for each of the models.  A
+   * MagneticSnapshot holds the coefficients of the interpolated model (and of
+   * its rate of change) for a given time so that the field is given by a
+   * single spherical harmonic sum (and its rate of change by one more).
+   * This is useful when the field is needed at many points at the same time,
+   * e.g., at "now" in a real-time system.
+   *
+   * The results are the same as those of MagneticModel::operator()() to
+   * within roundoff.  A MagneticSnapshot holds its own copy of the
+   * coefficients; it is immutable and its member functions may be called
+   * concurrently from several threads.  It may be copied and, so, cached
+   * (e.g., for a particular day).
+   *
+   * Use MagneticModel::AtTime to create a MagneticSnapshot object.  (The
+   * constructor for this class is private.)
+   *
+   * Example of use:
+   * \include example-MagneticSnapshot.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT MagneticSnapshot {
+  private:
+    typedef Math::real real;
+
+    real _a, _t;
+    Geocentric _earth;
+    unsigned _norm;
+    int _N, _M;
+    std::vector<real> _G, _H, _Gt, _Ht;
+    // The sums for the field and its rate of change.  These refer to the
+    // vectors above which is why the copy constructor and assignment operator
+    // are defined.
+    SphericalHarmonic _field, _rate;
+
+    MagneticSnapshot(real a, const Geocentric& earth, unsigned norm,
+                     real t, int N, int M,
+                     std::vector<real>& G, std::vector<real>& H,
+                     std::vector<real>& Gt, std::vector<real>& Ht)
+      : _a(a)
+      , _t(t)
+      , _earth(earth)
+      , _norm(norm)
+      , _N(N)
+      , _M(M)
+    {
+      _G.swap(G); _H.swap(H); _Gt.swap(Gt); _Ht.swap(Ht);
+      Reset();
+    }
+
+    void Reset();
+    void Field(real lat, real lon, real h, bool diffp,
+               real& Bx, real& By, real& Bz,
+               real& Bxt, real& Byt, real& Bzt) const;
+
+    friend class MagneticModel; // MagneticModel calls the private constructor
+
+  public:
+
+    /**
+     * A default constructor.  This sets up an uninitialized object which can
+     * be later replaced by the MagneticModel::AtTime.
+     **********************************************************************/
+    MagneticSnapshot() : _a(-1) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param[in] s the MagneticSnapshot to copy.
+     **********************************************************************/
+    MagneticSnapshot(const MagneticSnapshot& s);
+
+    /**
+     * The assignment operator.
+     *
+     * @param[in] s the MagneticSnapshot to copy.
+     * @return a reference to this object.
+     **********************************************************************/
+    MagneticSnapshot& operator=(const MagneticSnapshot& s);
+
+    /** \name Compute the magnetic field
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the components of the geomagnetic field.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     **********************************************************************/
+    void operator()(real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz) const {
+      real dummy;
+      Field(lat, lon, h, false, Bx, By, Bz, dummy, dummy, dummy);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     **********************************************************************/
+    void operator()(real lat, real lon, real h,
+                    real& Bx, real& By, real& Bz,
+                    real& Bxt, real& Byt, real& Bzt) const {
+      Field(lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
+    }
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return true if the object has been initialized.
+     **********************************************************************/
+    bool Init() const { return _a > 0; }
+    /**
+     * @return the time (fractional years).
+     **********************************************************************/
+    Math::real Time() const
+    { return Init() ? _t : Math::NaN(); }
+    /**
+     * @return the maximum degree of the combined model.
+     **********************************************************************/
+    int Degree() const { return Init() ? _N : -1; }
+    /**
+     * @return the maximum order of the combined model.
+     **********************************************************************/
+    int Order() const { return Init() ? _M : -1; }
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value inherited from the MagneticModel object used in the
+     *   constructor.
+     **********************************************************************/
+    Math::real MajorRadius() const
+    { return Init() ? _earth.MajorRadius() : Math::NaN(); }
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value
+     *   inherited from the MagneticModel object used in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const
+    { return Init() ? _earth.Flattening() : Math::NaN(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MAGNETICSNAPSHOT_HPP
@@ -60,6 +60,38 @@
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <cstring>
+
+#if !defined(GEOGRAPHICLIB_CPU_DISPATCH)
+/**
+ * Whether the vectorizable loops in the library (the summations over blocks
+ * of points in the batch versions of TransverseMercator::Forward and
+ * TransverseMercator::Reverse and of SphericalEngine::Value) are compiled for
+ * several instruction sets (AVX-512, AVX2, and the baseline) with the best
+ * version for the CPU being selected when the library is loaded.  This is
+ * enabled by default for g++ 6 and later on x86-64 Linux systems with float
+ * or double precision.  Contraction of floating point operations to fused
+ * multiply-adds is disabled in these loops, so that the results are the same
+ * for all the versions.  This only has an effect when compiling the library.
+ **********************************************************************/
+#  if defined(__GNUC__) && !defined(__clang__) && \
+  !defined(__INTEL_COMPILER) && __GNUC__ >= 6 && defined(__x86_64__) && \
+  defined(__ELF__) && defined(__GLIBC__) && GEOGRAPHICLIB_PRECISION <= 2
+#    define GEOGRAPHICLIB_CPU_DISPATCH 1
+#  else
+#    define GEOGRAPHICLIB_CPU_DISPATCH 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_CPU_DISPATCH
+// Put this in front of the definition of a function to compile it for
+// several instruction sets.
+#  define GEOGRAPHICLIB_TARGET_CLONES                                   \
+  __attribute__((target_clones("avx512f", "avx2", "default"),           \
+                 optimize("fp-contract=off")))
+#else
+#  define GEOGRAPHICLIB_TARGET_CLONES
+#endif
 
 #if GEOGRAPHICLIB_PRECISION == 4
 #include <boost/version.hpp>
@@ -107,6 +139,45 @@ namespace GeographicLib {
                                   "Bad value of precision");
     }
     Math();                     // Disable constructor
+    // Byte swapping for objects of size n.  The specializations for n = 2,
+    // 4, and 8 use shifts on unsigned integers, which compilers turn into
+    // byte-swap instructions and vectorize in loops.
+    template<int n> struct sizetag {};
+    template<typename T, int n> static inline T swabn(T x, sizetag<n>) {
+      union {
+        T r;
+        unsigned char c[sizeof(T)];
+      } b;
+      b.r = x;
+      for (int i = sizeof(T)/2; i--; )
+        std::swap(b.c[i], b.c[sizeof(T) - 1 - i]);
+      return b.r;
+    }
+    template<typename T> static inline T swabn(T x, sizetag<2>) {
+      unsigned short u;
+      std::memcpy(&u, &x, 2);
+      u = (unsigned short)((u >> 8) | (u << 8));
+      std::memcpy(&x, &u, 2);
+      return x;
+    }
+    template<typename T> static inline T swabn(T x, sizetag<4>) {
+      unsigned u;
+      std::memcpy(&u, &x, 4);
+      u = (u >> 24) | ((u >> 8) & 0xff00U) | ((u << 8) & 0xff0000U) |
+        (u << 24);
+      std::memcpy(&x, &u, 4);
+      return x;
+    }
+    template<typename T> static inline T swabn(T x, sizetag<8>) {
+      unsigned long long u;
+      std::memcpy(&u, &x, 8);
+      u = (u >> 56) | ((u >> 40) & 0xff00ULL) |
+        ((u >> 24) & 0xff0000ULL) | ((u >> 8) & 0xff000000ULL) |
+        ((u << 8) & 0xff00000000ULL) | ((u << 24) & 0xff0000000000ULL) |
+        ((u << 40) & 0xff000000000000ULL) | (u << 56);
+      std::memcpy(&x, &u, 8);
+      return x;
+    }
   public:
 
 #if GEOGRAPHICLIB_HAVE_LONG_DOUBLE
@@ -241,7 +312,7 @@ namespace GeographicLib {
      * @param[in] x
      * @return <i>x</i><sup>2</sup>.
      **********************************************************************/
-    template<typename T> static inline T sq(T x)
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline T sq(T x)
     { return x * x; }
 
     /**
@@ -429,8 +500,13 @@ namespace GeographicLib {
      * <i>p</i><sub><i>n</i></sub> <i>x</i><sup><i>N</i>&minus;<i>n</i></sup>.
      * Return 0 if \e N &lt; 0.  Return <i>p</i><sub>0</sub>, if \e N = 0 (even
      * if \e x is infinite or a nan).  The evaluation uses Horner's method.
+     *
+     * With C++14, this is constexpr; so, for example, the coefficients of the
+     * series for TransverseMercator for a fixed ellipsoid can be evaluated at
+     * compile time.
      **********************************************************************/
-    template<typename T> static inline T polyval(int N, const T p[], T x)
+    template<typename T> static GEOGRAPHICLIB_CONSTEXPR14 inline
+    T polyval(int N, const T p[], T x)
     { T y = N < 0 ? 0 : *p++; while (--N >= 0) y = y * x + *p++; return y; }
 
     /**
@@ -445,6 +521,22 @@ namespace GeographicLib {
     template<typename T> static inline T AngNormalize(T x)
     { return x >= 180 ? x - 360 : (x < -180 ? x + 360 : x); }
 
+    /**
+     * Normalize an array of angles (restricted input range).
+     *
+     * @tparam T the type of the arguments and returned values.
+     * @param[in] x array of angles in degrees.
+     * @param[out] y array of angles reduced to the range [&minus;180&deg;,
+     *   180&deg;).
+     * @param[in] n the number of elements.
+     *
+     * The results are the same as those given by Math::AngNormalize(T).  \e x
+     * and \e y may be the same array.
+     **********************************************************************/
+    template<typename T> static inline
+    void AngNormalize(const T x[], T y[], size_t n)
+    { for (size_t i = 0; i < n; ++i) y[i] = AngNormalize(x[i]); }
+
     /**
      * Normalize an arbitrary angle.
      *
@@ -481,6 +573,23 @@ namespace GeographicLib {
       return d + t;
     }
 
+    /**
+     * Differences of two arrays of angles reduced to [&minus;180&deg;,
+     * 180&deg;]
+     *
+     * @tparam T the type of the arguments and returned values.
+     * @param[in] x array of first angles in degrees.
+     * @param[in] y array of second angles in degrees.
+     * @param[out] d array of differences \e y &minus; \e x.
+     * @param[in] n the number of elements.
+     *
+     * The results are the same as those given by Math::AngDiff(T, T).  \e d
+     * may be the same array as \e x or \e y.
+     **********************************************************************/
+    template<typename T> static inline
+    void AngDiff(const T x[], const T y[], T d[], size_t n)
+    { for (size_t i = 0; i < n; ++i) d[i] = AngDiff(x[i], y[i]); }
+
     /**
      * Coarsen a value close to zero.
      *
@@ -504,6 +613,92 @@ namespace GeographicLib {
       return x < 0 ? 0 - y : y;
     }
 
+    /**
+     * Coarsen an array of values close to zero.
+     *
+     * @tparam T the type of the arguments and returned values.
+     * @param[in] x array of values.
+     * @param[out] y array of coarsened values.
+     * @param[in] n the number of elements.
+     *
+     * The results are the same as those given by Math::AngRound(T).  \e x and
+     * \e y may be the same array.
+     **********************************************************************/
+    template<typename T> static inline
+    void AngRound(const T x[], T y[], size_t n)
+    { for (size_t i = 0; i < n; ++i) y[i] = AngRound(x[i]); }
+
+    /**
+     * Evaluate the sine and cosine function with the argument in degrees
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] x in degrees.
+     * @param[out] sinx sin(<i>x</i>).
+     * @param[out] cosx cos(<i>x</i>).
+     *
+     * The argument is reduced exactly to [&minus;45&deg;, 45&deg;] before
+     * being converted to radians, so that multiples of 90&deg; give exact
+     * results; e.g., sinx = 1 and cosx = 0 for \e x = 90&deg;.  The range of
+     * \e x is unrestricted.
+     **********************************************************************/
+    template<typename T> static inline void sincosd(T x, T& sinx, T& cosx) {
+      using std::sin; using std::cos; using std::fmod; using std::floor;
+      // fmod and the subtraction of 90 q are exact.
+      T r = fmod(x, T(360));
+      int q = int(floor(r / 90 + T(0.5)));
+      r -= 90 * q;
+      r *= degree<T>();
+      T s = sin(r), c = cos(r);
+      switch (unsigned(q) & 3U) {
+      case 0U: sinx =     s; cosx =     c; break;
+      case 1U: sinx =     c; cosx = 0 - s; break;
+      case 2U: sinx = 0 - s; cosx = 0 - c; break;
+      default: sinx = 0 - c; cosx =     s; break;
+      }
+    }
+
+    /**
+     * Evaluate the sine and cosine function for an array of arguments in
+     * degrees
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] x array of arguments in degrees.
+     * @param[out] sinx array of sin(<i>x</i>).
+     * @param[out] cosx array of cos(<i>x</i>).
+     * @param[in] n the number of elements.
+     *
+     * The results are the same as those given by Math::sincosd(T, T&, T&).
+     * The argument reduction and the quadrant selection are done in separate
+     * loops without branches so that they can be vectorized by the compiler
+     * (the switch in the scalar version prevents this).  Either \e sinx or
+     * \e cosx may be the same array as \e x.
+     **********************************************************************/
+    template<typename T> static inline
+    void sincosd(const T x[], T sinx[], T cosx[], size_t n) {
+      using std::sin; using std::cos; using std::fmod; using std::floor;
+      const size_t nblock = 32;
+      T r[nblock];
+      int q[nblock];
+      for (size_t i0 = 0; i0 < n; i0 += nblock) {
+        size_t nb = n - i0 < nblock ? n - i0 : nblock;
+        for (size_t i = 0; i < nb; ++i) {
+          T t = fmod(x[i0 + i], T(360));
+          q[i] = int(floor(t / 90 + T(0.5)));
+          r[i] = (t - 90 * q[i]) * degree<T>();
+        }
+        for (size_t i = 0; i < nb; ++i) {
+          // Swap sin and cos in quadrants 1 and 3; negate sin in quadrants 2
+          // and 3 and cos in quadrants 1 and 2.
+          T s = sin(r[i]), c = cos(r[i]);
+          unsigned qi = unsigned(q[i]);
+          bool swap = (qi & 1U) != 0;
+          T a = swap ? c : s, b = swap ? s : c;
+          sinx[i0 + i] = (qi & 2U) ? 0 - a : a;
+          cosx[i0 + i] = ((qi + 1U) & 2U) ? 0 - b : b;
+        }
+      }
+    }
+
     /**
      * Evaluate the tangent function with the argument in degrees
      *
@@ -566,7 +761,10 @@ namespace GeographicLib {
      * If <i>e</i><sup>2</sup> is negative (<i>e</i> is imaginary), the
      * expression is evaluated in terms of atan.
      **********************************************************************/
-    template<typename T> static T eatanhe(T x, T es);
+    template<typename T> static inline T eatanhe(T x, T es) {
+      using std::atan;
+      return es > T(0) ? es * atanh(es * x) : -es * atan(es * x);
+    }
 
     /**
      * tan&chi; in terms of tan&phi;
@@ -584,7 +782,12 @@ namespace GeographicLib {
      * J. Geodesy 85(8), 475--485 (Aug. 2011)
      * (preprint <a href="http://arxiv.org/abs/1002.1417">arXiv:1002.1417</a>).
      **********************************************************************/
-    template<typename T> static T taupf(T tau, T es);
+    template<typename T> static inline T taupf(T tau, T es) {
+      using std::sinh;
+      T tau1 = hypot(T(1), tau),
+        sig = sinh( eatanhe(tau / tau1, es ) );
+      return hypot(T(1), sig) * tau - sig * tau1;
+    }
 
     /**
      * tan&phi; in terms of tan&chi;
@@ -604,6 +807,58 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T tauf(T taup, T es);
 
+    /**
+     * Evaluate <i>e</i> atanh(<i>e x</i>) for an array of arguments.
+     *
+     * @tparam T the type of the arguments and the returned values.
+     * @param[in] x array of arguments.
+     * @param[out] y array of results.
+     * @param[in] n the number of elements.
+     * @param[in] es the signed eccentricity =  sign(<i>e</i><sup>2</sup>)
+     *    sqrt(|<i>e</i><sup>2</sup>|)
+     *
+     * The results are identical to those of Math::eatanhe(T, T).  \e x and
+     * \e y may be the same array.
+     **********************************************************************/
+    template<typename T> static void eatanhe(const T x[], T y[], size_t n,
+                                             T es);
+
+    /**
+     * tan&chi; in terms of tan&phi; for an array of arguments.
+     *
+     * @tparam T the type of the arguments and the returned values.
+     * @param[in] tau array of &tau; = tan&phi;
+     * @param[out] taup array of &tau;&prime; = tan&chi;
+     * @param[in] n the number of elements.
+     * @param[in] es the signed eccentricity = sign(<i>e</i><sup>2</sup>)
+     *   sqrt(|<i>e</i><sup>2</sup>|)
+     *
+     * The results are identical to those of Math::taupf(T, T).  \e tau and
+     * \e taup may be the same array.
+     **********************************************************************/
+    template<typename T> static void taupf(const T tau[], T taup[], size_t n,
+                                           T es);
+
+    /**
+     * tan&phi; in terms of tan&chi; for an array of arguments.
+     *
+     * @tparam T the type of the arguments and the returned values.
+     * @param[in] taup array of &tau;&prime; = tan&chi;
+     * @param[out] tau array of &tau; = tan&phi;
+     * @param[in] n the number of elements.
+     * @param[in] es the signed eccentricity = sign(<i>e</i><sup>2</sup>)
+     *   sqrt(|<i>e</i><sup>2</sup>|)
+     *
+     * The elements are processed in blocks and the Newton iterations are
+     * carried out in step over a block, so that each iteration is a simple
+     * loop over the block.  Each element is iterated until it has converged
+     * (the same criterion as Math::tauf(T, T)), so the results are identical
+     * to those of the scalar function.  \e taup and \e tau may be the same
+     * array.
+     **********************************************************************/
+    template<typename T> static void tauf(const T taup[], T tau[], size_t n,
+                                          T es);
+
     /**
      * Test for finiteness.
      *
@@ -674,16 +929,8 @@ namespace GeographicLib {
      * @param[in] x
      * @return x with its bytes swapped.
      **********************************************************************/
-    template<typename T> static inline T swab(T x) {
-      union {
-        T r;
-        unsigned char c[sizeof(T)];
-      } b;
-      b.r = x;
-      for (int i = sizeof(T)/2; i--; )
-        std::swap(b.c[i], b.c[sizeof(T) - 1 - i]);
-      return b.r;
-    }
+    template<typename T> static inline T swab(T x)
+    { return swabn(x, sizetag<sizeof(T)>()); }
 
 #if GEOGRAPHICLIB_PRECISION == 4
     typedef boost::math::policies::policy
@@ -133,6 +133,22 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real SurfaceGravity(real lat) const;
 
+    /**
+     * Evaluate the gravity on the surface of the ellipsoid for an array of
+     * latitudes.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] n the number of latitudes.
+     * @param[out] gamma array of the accelerations due to gravity, positive
+     *   downwards (m s<sup>&minus;2</sup>).
+     *
+     * The results are identical to calling NormalGravity::SurfaceGravity for
+     * each latitude.  This uses the closed form expression for the surface
+     * gravity, H+M, Eq 2-78, and the loop over the points is simple enough
+     * for the compiler to vectorize.  \e gamma may coincide with \e lat.
+     **********************************************************************/
+    void SurfaceGravityBatch(const real lat[], size_t n, real gamma[]) const;
+
     /**
      * Evaluate the gravity at an arbitrary point above (or below) the
      * ellipsoid.
@@ -154,6 +170,28 @@ namespace GeographicLib {
     Math::real Gravity(real lat, real h, real& gammay, real& gammaz)
       const;
 
+    /**
+     * Evaluate the gravity at an array of points above (or below) the
+     * ellipsoid.
+     *
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[in] n the number of points.
+     * @param[out] U array of the normal potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>).
+     * @param[out] gammay array of the northerly components of the
+     *   acceleration (m s<sup>&minus;2</sup>).
+     * @param[out] gammaz array of the upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     *
+     * The results are identical to calling NormalGravity::Gravity for each
+     * point.  If only the magnitude of the gravity on the surface of the
+     * ellipsoid is needed, NormalGravity::SurfaceGravityBatch is several
+     * times faster.
+     **********************************************************************/
+    void GravityBatch(const real lat[], const real h[], size_t n,
+                      real U[], real gammay[], real gammaz[]) const;
+
     /**
      * Evaluate the components of the acceleration due to gravity and the
      * centrifugal acceleration in geocentric coordinates.
@@ -0,0 +1,185 @@
+/**
+ * \file NumaReplicas.hpp
+ * \brief Header for GeographicLib::NumaReplicas class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_NUMAREPLICAS_HPP)
+#define GEOGRAPHICLIB_NUMAREPLICAS_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The NUMA topology of the machine
+   *
+   * This reports the NUMA nodes (with processors) of the machine and the
+   * node on which the calling thread is running, and it can run a task on a
+   * particular node.  This is used by NumaReplicas.  The topology is found on
+   * Linux (from /sys/devices/system/node) if the library was compiled with
+   * C++11 support; otherwise the machine is treated as a single node.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Numa {
+  public:
+    /**
+     * A task to be run on a particular node.
+     **********************************************************************/
+    class Task {
+    public:
+      /**
+       * Do the work.
+       **********************************************************************/
+      virtual void operator()() const = 0;
+      virtual ~Task() {}
+    };
+
+    /**
+     * @return the number of NUMA nodes with processors (at least 1).
+     **********************************************************************/
+    static int Nodes();
+
+    /**
+     * @return the index, in [0, Numa::Nodes()), of the node on which the
+     *   calling thread is currently running.
+     *
+     * A thread may be moved to another node by the operating system, so the
+     * result is only a hint unless the thread is bound to a node.
+     **********************************************************************/
+    static int CurrentNode();
+
+    /**
+     * Run a task on a node.
+     *
+     * @param[in] node the index of the node, in [0, Numa::Nodes()).
+     * @param[in] task the work to be done.
+     * @exception GeographicErr if \e node is out of range.
+     * @exception any exception thrown by \e task.
+     *
+     * With more than one node, \e task is run by a new thread bound to the
+     * processors of \e node, and this returns when \e task is finished.
+     * Memory which \e task allocates and initializes is then normally placed
+     * on \e node (this is the default "first touch" policy of Linux).  With a
+     * single node (or if the thread can't be started), \e task is run by the
+     * calling thread.
+     **********************************************************************/
+    static void RunOnNode(int node, const Task& task);
+  };
+
+  /**
+   * \brief Copies of read-only data, one per NUMA node
+   *
+   * On a machine with several NUMA nodes, threads which read large amounts
+   * of data held in the memory of another node run more slowly than if the
+   * data were local.  This is the case for the coefficients of a high degree
+   * GravityModel, MagneticModel, or SphericalHarmonic and for a Geoid whose
+   * data has been cached with Geoid::CacheAll.  NumaReplicas holds a separate
+   * copy of such an object for each node; each copy is created by a thread
+   * bound to its node so that its data is placed there.  Each thread then
+   * uses the copy for the node it's running on, obtained with
+   * NumaReplicas::Local.  On a machine with a single node, there is just one
+   * copy.
+   *
+   * @tparam T the type of the object.
+   * @tparam Factory the type of a function or function object which, when
+   *   called with no arguments, returns a pointer to a new T (allocated with
+   *   new).
+   *
+   * The objects are created by the factory (instead of being copied from an
+   * existing object) so that all their data is allocated on the right node.
+   * So the factory should fully load the data; for example, call
+   * Geoid::CacheAll, don't memory map the coefficients of a GravityModel
+   * (because the pages of a mapped file are shared between the nodes), and
+   * don't load a MagneticModel lazily.  A SphericalHarmonic refers to
+   * coefficient arrays owned by the caller; so T should be a class which
+   * holds both the arrays and the SphericalHarmonic.  The copies must only
+   * be used with their const member functions, which must be safe to call
+   * from several threads at once.
+   *
+   * Data which isn't replicated can instead be spread over the nodes by
+   * running the application under <code>numactl --interleave=all</code>.
+   *
+   * Example of use:
+   * \include example-NumaReplicas.cpp
+   **********************************************************************/
+  template<class T, class Factory = T* (*)()>
+  class NumaReplicas {
+  private:
+    std::vector<T*> _copies;
+    class Make : public Numa::Task {
+    private:
+      const Factory& _make;
+      T*& _copy;
+      Make& operator=(const Make&);
+    public:
+      Make(const Factory& make, T*& copy) : _make(make), _copy(copy) {}
+      void operator()() const { _copy = _make(); }
+    };
+    void Release() {
+      for (size_t k = 0; k < _copies.size(); ++k)
+        delete _copies[k];
+      _copies.clear();
+    }
+    // copy constructor not allowed
+    NumaReplicas(const NumaReplicas&);
+    // nor copy assignment
+    NumaReplicas& operator=(const NumaReplicas&);
+  public:
+    /**
+     * Constructor for NumaReplicas.
+     *
+     * @param[in] make the factory for the copies.
+     * @param[in] replicate if false, create just one copy (in the calling
+     *   thread) regardless of the number of nodes (default true).
+     * @exception any exception thrown by \e make.
+     *
+     * The copies are created one node at a time.
+     **********************************************************************/
+    explicit NumaReplicas(const Factory& make, bool replicate = true)
+      : _copies(replicate ? Numa::Nodes() : 1, (T*)0)
+    {
+      try {
+        if (_copies.size() == 1)
+          _copies[0] = make();
+        else
+          for (size_t k = 0; k < _copies.size(); ++k)
+            Numa::RunOnNode(int(k), Make(make, _copies[k]));
+      }
+      catch (...) {
+        Release();
+        throw;
+      }
+    }
+
+    /**
+     * The destructor deletes the copies.
+     **********************************************************************/
+    ~NumaReplicas() { Release(); }
+
+    /**
+     * @return the copy for the node on which the calling thread is running.
+     **********************************************************************/
+    const T& Local() const {
+      return *_copies[_copies.size() == 1 ? 0 :
+                      size_t(Numa::CurrentNode()) % _copies.size()];
+    }
+
+    /**
+     * @param[in] k the index of a copy, in [0, NumaReplicas::Count()).
+     * @return copy \e k (which is the copy for node \e k).
+     **********************************************************************/
+    const T& Copy(int k) const { return *_copies[k]; }
+
+    /**
+     * @return the number of copies.
+     **********************************************************************/
+    int Count() const { return int(_copies.size()); }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_NUMAREPLICAS_HPP
@@ -44,8 +44,8 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT OSGB {
   private:
     typedef Math::real real;
-    static const std::string letters_;
-    static const std::string digits_;
+    static const char* const letters_;
+    static const char* const digits_;
     static const TransverseMercator& OSGBTM();
     enum {
       base_ = 10,
@@ -60,9 +60,25 @@ namespace GeographicLib {
       maxy_ = (tilegrid_*tilegrid_ - tileoffy_) * tile_,
       // Maximum precision is um
       maxprec_ = 5 + 6,
+      // Maximum length of a grid reference: 2 letters + easting + northing
+      maxlen_ = 2 + 2 * maxprec_,
+      nblock_ = 64,             // Block size for ReverseBatch
     };
     static real computenorthoffset();
-    static void CheckCoords(real x, real y);
+    // If throwp = false, return false instead of throwing an exception.
+    static bool CheckCoords(real x, real y, bool throwp = true);
+    static void CheckPrecision(int prec);
+    // Write the grid reference (unterminated) to grid and return its length.
+    // If throwp = false, return -1 instead of throwing an exception for an
+    // out of range x or y.
+    static int Encode(real x, real y, int prec, char grid[], bool throwp);
+    // Tables for decoding the characters of a grid reference.
+    class Decoder;
+    // Version of GridReference which, if throwp = false, returns false
+    // instead of throwing an exception.
+    static bool GridReference(const char* gridref, size_t n,
+                              real& x, real& y, int& prec,
+                              bool centerp, bool throwp);
     OSGB();                     // Disable constructor
   public:
 
@@ -123,6 +139,44 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     *
+     * The results are identical to calling OSGB::Forward for each point.
+     * This uses the array version of TransverseMercator::Forward, which
+     * processes the points in blocks.  If \e gamma and \e k are both null
+     * pointers (the default), the convergence and scale are not computed.
+     **********************************************************************/
+    static void ForwardBatch(const real lat[], const real lon[], size_t n,
+                             real x[], real y[],
+                             real gamma[] = 0, real k[] = 0);
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     *
+     * The results are identical to calling OSGB::Reverse for each point.
+     * \e gamma and \e k may be null pointers.
+     **********************************************************************/
+    static void ReverseBatch(const real x[], const real y[], size_t n,
+                             real lat[], real lon[],
+                             real gamma[] = 0, real k[] = 0);
+
     /**
      * Convert OSGB coordinates to a grid reference.
      *
@@ -154,6 +208,54 @@ namespace GeographicLib {
      **********************************************************************/
     static void GridReference(real x, real y, int prec, std::string& gridref);
 
+    /**
+     * Convert OSGB coordinates to a grid reference stored in a character
+     * array.
+     *
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref National Grid reference (null terminated).
+     * @param[in] cap the size of the array \e gridref.
+     * @exception GeographicErr if \e prec, \e x, or \e y is outside its
+     *   allowed range.
+     * @exception GeographicErr if \e cap is too small to hold the result.
+     * @return the length of the grid reference (excluding the terminating
+     *   null).
+     *
+     * This is the same as OSGB::GridReference(real, real, int, std::string&)
+     * except that the result is written to \e gridref and no memory is
+     * allocated.  A grid reference has at most 24 characters, so \e cap =
+     * 25 suffices for every \e prec.
+     **********************************************************************/
+    static size_t GridReference(real x, real y, int prec,
+                                char* gridref, size_t cap);
+
+    /**
+     * Convert an array of OSGB coordinates to grid references stored in a
+     * contiguous character array.
+     *
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] n the number of points.
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref the array of grid references; this must have at
+     *   least \e n &times; \e stride elements.
+     * @param[in] stride the spacing of the strings in \e gridref.
+     * @exception GeographicErr if \e prec is not in [0, 11].
+     * @exception GeographicErr if \e stride is too small to hold the
+     *   results.
+     * @return the number of points for which the conversion failed.
+     *
+     * The grid reference for point \e i is written, null terminated,
+     * starting at \e gridref[\e i &times; \e stride].  \e stride must
+     * exceed max(2 + 2 \e prec, 7); thus \e stride = 25 suffices for every
+     * \e prec.  If a point is out of range, the corresponding string is
+     * empty; no exception is thrown in this case.
+     **********************************************************************/
+    static size_t GridReferenceBatch(const real x[], const real y[], size_t n,
+                                     int prec, char* gridref, size_t stride);
+
     /**
      * Convert OSGB coordinates to a grid reference.
      *
@@ -175,6 +277,51 @@ namespace GeographicLib {
                               real& x, real& y, int& prec,
                               bool centerp = true);
 
+    /**
+     * OSGB::GridReference for a character array.
+     *
+     * @param[in] gridref pointer to the National Grid reference.
+     * @param[in] n the number of characters in \e gridref.
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the grid square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e gridref is illegal.
+     *
+     * \e gridref need not be null terminated.
+     **********************************************************************/
+    static void GridReference(const char* gridref, size_t n,
+                              real& x, real& y, int& prec,
+                              bool centerp = true)
+    { GridReference(gridref, n, x, y, prec, centerp, true); }
+
+    /**
+     * Convert an array of grid references to OSGB coordinates.
+     *
+     * @param[in] buf the buffer holding the grid references.
+     * @param[in] offsets array of \e n + 1 offsets into \e buf; grid
+     *   reference \e i occupies [\e offsets[\e i], \e offsets[\e i + 1]).
+     * @param[in] n the number of grid references.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec array of precisions relative to 100 km.
+     * @param[out] valid array of flags indicating which strings were parsed
+     *   successfully; this may be a null pointer.
+     * @param[in] centerp if true (default), return center of the grid square,
+     *   else return SW (lower left) corner.
+     * @return the number of strings which could not be parsed.
+     *
+     * A trailing newline (or carriage return + newline) on each string is
+     * ignored.  No exception is thrown for an illegal string; instead \e x
+     * and \e y are set to NaN, \e prec to &minus;2, and the corresponding
+     * element of \e valid is set to false.  This is analogous to
+     * MGRS::ReverseBatch.
+     **********************************************************************/
+    static size_t GridReferenceBatch(const char* buf, const size_t offsets[],
+                                     size_t n, real x[], real y[], int prec[],
+                                     bool valid[] = 0, bool centerp = true);
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
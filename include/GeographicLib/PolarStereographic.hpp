@@ -34,6 +34,7 @@ namespace GeographicLib {
     typedef Math::real real;
     real _a, _f, _e2, _es, _e2m, _c;
     real _k0;
+    static const int nblock_ = 16; // Block size for array Reverse
   public:
 
     /**
@@ -116,6 +117,111 @@ namespace GeographicLib {
       Reverse(northp, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     *
+     * The results are identical to calling PolarStereographic::Forward for
+     * each point.  \e gamma and \e k may be null pointers (the default).
+     **********************************************************************/
+    void Forward(bool northp, const real* lat, const real* lon, size_t n,
+                 real* x, real* y, real* gamma = 0, real* k = 0) const;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     *
+     * The results are identical to calling PolarStereographic::Reverse for
+     * each point.  The points are processed in blocks with the Newton
+     * iterations for the conformal latitude (Math::tauf) carried out in step
+     * across the block; each point is iterated until it converges.  \e gamma
+     * and \e k may be null pointers (the default).
+     **********************************************************************/
+    void Reverse(bool northp, const real* x, const real* y, size_t n,
+                 real* lat, real* lon, real* gamma = 0, real* k = 0) const;
+
+    /**
+     * Forward projection of a regular grid of geographic coordinates.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] lat0 latitude of the first row of the grid (degrees).
+     * @param[in] dlat latitude spacing of the rows (degrees).
+     * @param[in] nlat the number of rows.
+     * @param[in] lon0 longitude of the first column of the grid (degrees).
+     * @param[in] dlon longitude spacing of the columns (degrees).
+     * @param[in] nlon the number of columns.
+     * @param[out] x array of \e nlat &times; \e nlon eastings (meters).
+     * @param[out] y array of \e nlat &times; \e nlon northings (meters).
+     * @param[out] gamma array of \e nlat &times; \e nlon meridian
+     *   convergences (degrees).
+     * @param[out] k array of \e nlat &times; \e nlon scales of projection.
+     *
+     * The grid point in row \e i and column \e j has latitude \e lat0 + \e
+     * i \e dlat and longitude \e lon0 + \e j \e dlon, and its results are
+     * stored in element \e i \e nlon + \e j of the output arrays.  The
+     * results are identical to calling PolarStereographic::Forward for each
+     * grid point; however the conformal latitude and the scale are computed
+     * once per row and the trigonometric functions of the longitude once per
+     * column.  \e gamma and \e k may be null pointers (the default).
+     **********************************************************************/
+    void ForwardGrid(bool northp,
+                     real lat0, real dlat, size_t nlat,
+                     real lon0, real dlon, size_t nlon,
+                     real* x, real* y, real* gamma = 0, real* k = 0) const;
+
+    /**
+     * Reverse projection of a regular grid of polar stereographic
+     * coordinates.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] x0 easting of the first column of the grid (meters).
+     * @param[in] dx easting spacing of the columns (meters).
+     * @param[in] nx the number of columns.
+     * @param[in] y0 northing of the first row of the grid (meters).
+     * @param[in] dy northing spacing of the rows (meters).
+     * @param[in] ny the number of rows.
+     * @param[out] lat array of \e ny &times; \e nx latitudes (degrees).
+     * @param[out] lon array of \e ny &times; \e nx longitudes (degrees).
+     * @param[out] gamma array of \e ny &times; \e nx meridian convergences
+     *   (degrees).
+     * @param[out] k array of \e ny &times; \e nx scales of projection.
+     *
+     * The grid point in row \e i and column \e j has easting \e x0 + \e j
+     * \e dx and northing \e y0 + \e i \e dy, and its results are stored in
+     * element \e i \e nx + \e j of the output arrays.  This is suitable for
+     * finding the geographic coordinates of the pixels of a raster in polar
+     * stereographic coordinates.  The results are identical to calling
+     * PolarStereographic::Reverse for each grid point.  Because all the
+     * quantities depend on both coordinates, the saving is less than for
+     * PolarStereographic::ForwardGrid; the grid points are converted by the
+     * array version of PolarStereographic::Reverse.  \e gamma and \e k may
+     * be null pointers (the default).
+     **********************************************************************/
+    void ReverseGrid(bool northp,
+                     real x0, real dx, size_t nx,
+                     real y0, real dy, size_t ny,
+                     real* lat, real* lon, real* gamma = 0, real* k = 0) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
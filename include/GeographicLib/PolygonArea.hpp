@@ -10,13 +10,19 @@
 #if !defined(GEOGRAPHICLIB_POLYGONAREA_HPP)
 #define GEOGRAPHICLIB_POLYGONAREA_HPP 1
 
+#include <vector>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/AuthalicSphere.hpp>
 #include <GeographicLib/Accumulator.hpp>
+#include <GeographicLib/Executor.hpp>
 
 namespace GeographicLib {
 
+  template <class T> class EditablePolygonAreaT;
+  class GeodesicPolygon;
+
   /**
    * \brief Polygon areas
    *
@@ -47,9 +53,9 @@ namespace GeographicLib {
    * polygon; in that case, only the perimeter is computed.
    *
    * This is a templated class to allow it to be used with Geodesic,
-   * GeodesicExact, and Rhumb.  GeographicLib::PolygonArea,
-   * GeographicLib::PolygonAreaExact, and GeographicLib::PolygonAreaRhumb are
-   * typedefs for these cases.
+   * GeodesicExact, Rhumb, and AuthalicSphere.  GeographicLib::PolygonArea,
+   * GeographicLib::PolygonAreaExact, GeographicLib::PolygonAreaRhumb, and
+   * GeographicLib::PolygonAreaAuthalic are typedefs for these cases.
    *
    * @tparam GeodType the geodesic class to use.
    *
@@ -96,6 +102,63 @@ namespace GeographicLib {
       return ( ((lon2 >= 0 && lon2 < 360) || lon2 < -360 ? 0 : 1) -
                ((lon1 >= 0 && lon1 < 360) || lon1 < -360 ? 0 : 1) );
     }
+    // Accumulate the contributions of the edges from point i to point i + 1
+    // of the arrays, for i0 <= i < i1.  If the buffers s12 and S12 (of size
+    // i1 - i0) are given, the contributions are stored there and added with
+    // Accumulator::AddArray; otherwise they are added as for AddPoint.
+    void EdgeSums(const real lat[], const real lon[], size_t i0, size_t i1,
+                  Accumulator<>& perimeter, Accumulator<>& area,
+                  int& crossings, real s12[] = 0, real S12[] = 0) const;
+    // Reduce the accumulated area (with the clockwise sense) to the requested
+    // range and sense.
+    real ReduceArea(Accumulator<>& area, int crossings,
+                    bool reverse, bool sign) const;
+    real ReduceArea(real area, int crossings, bool reverse, bool sign) const;
+    // The work of TestPoint and TestEdge given the current perimeter and
+    // area sums.
+    void TestPointSums(real lat, real lon, real perimeter0, real area0,
+                       bool reverse, bool sign,
+                       real& perimeter, real& area) const;
+    void TestEdgeSums(real azi, real s, real perimeter0, real area0,
+                      bool reverse, bool sign,
+                      real& perimeter, real& area) const;
+    // Compute the perimeter and area of the polygon given by n points.
+    void ComputeOne(const real lat[], const real lon[], size_t n,
+                    bool reverse, bool sign,
+                    real& perimeter, real& area) const;
+    // The number of edges in each of the chunks into which AddPoints divides
+    // the edges.  This is fixed so that the result doesn't depend on the
+    // number of threads.
+    static const size_t chunk_ = 1024;
+    // The body of the parallel loop in AddPoints: accumulate the edges of
+    // chunks [k0, k1) separately.  (This is a class rather than a lambda for
+    // compatibility with C++98.)
+    class ChunkSums {
+    private:
+      const PolygonAreaT& _p;
+      const real *_lat, *_lon;
+      size_t _n;
+      Accumulator<> *_perimeter, *_area;
+      int* _crossings;
+      ChunkSums& operator=(const ChunkSums&);
+    public:
+      ChunkSums(const PolygonAreaT& p, const real lat[], const real lon[],
+                size_t n, Accumulator<> perimeter[], Accumulator<> area[],
+                int crossings[])
+        : _p(p), _lat(lat), _lon(lon), _n(n)
+        , _perimeter(perimeter), _area(area), _crossings(crossings) {}
+      void operator()(size_t k0, size_t k1) const {
+        std::vector<real> s12(chunk_), S12(chunk_);
+        for (size_t k = k0; k < k1; ++k) {
+          size_t i0 = k * chunk_;
+          _p.EdgeSums(_lat, _lon, i0, (std::min)(_n - 1, i0 + chunk_),
+                      _perimeter[k], _area[k], _crossings[k],
+                      &s12[0], &S12[0]);
+        }
+      }
+    };
+    friend class EditablePolygonAreaT<GeodType>;
+    friend class GeodesicPolygon;
   public:
 
     /**
@@ -136,6 +199,52 @@ namespace GeographicLib {
      **********************************************************************/
     void AddPoint(real lat, real lon);
 
+    /**
+     * Add several points to the polygon or polyline.
+     *
+     * @param[in] lat the array of latitudes of the points (degrees).
+     * @param[in] lon the array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     *
+     * This is equivalent to calling PolygonAreaT::AddPoint for each point.
+     * However the edges are split into chunks of 1024 which are summed
+     * separately (in parallel, by Executor::Default()), with
+     * Accumulator::AddArray, before the partial sums are combined with
+     * Accumulator::Reduce.  The sums are accumulated
+     * with Accumulator objects, so the result agrees with that given by
+     * PolygonAreaT::AddPoint to within the round-off of the final sum.
+     * Because the chunks and the order in which they are combined are
+     * fixed, the result is bitwise identical for any executor and any
+     * number of threads.
+     *
+     * A polygon with a very large number of vertices can be processed with
+     * bounded memory by calling this function repeatedly with successive
+     * chunks of the vertices (the first point of each chunk is connected to
+     * the last point of the previous one).  Only running totals are kept, so
+     * PolygonAreaT::Compute can then be called without the full list of
+     * vertices.
+     **********************************************************************/
+    void AddPoints(const real lat[], const real lon[], size_t n) {
+      if (n == 0) return;
+      // The edge from the current point (if any) to the first point
+      AddPoint(lat[0], lon[0]);
+      if (n == 1) return;
+      size_t nc = (n - 2) / chunk_ + 1;
+      std::vector< Accumulator<> > perimeter(nc), area(nc);
+      std::vector<int> crossings(nc, 0);
+      // Each chunk is a separate task for the executor.
+      Executor::For(nc, nc, ChunkSums(*this, lat, lon, n, &perimeter[0],
+                                      &area[0], &crossings[0]));
+      _perimetersum += Accumulator<>::Reduce(&perimeter[0], nc);
+      if (!_polyline) {
+        _areasum += Accumulator<>::Reduce(&area[0], nc);
+        for (size_t k = 0; k < nc; ++k)
+          _crossings += crossings[k];
+      }
+      _lat1 = lat[n - 1]; _lon1 = Math::AngNormalize(lon[n - 1]);
+      _num += unsigned(n - 1);
+    }
+
     /**
      * Add an edge to the polygon or polyline.
      *
@@ -165,6 +274,80 @@ namespace GeographicLib {
     unsigned Compute(bool reverse, bool sign,
                      real& perimeter, real& area) const;
 
+    /**
+     * Compute the perimeters and areas of many polygons.
+     *
+     * @param[in] offsets array of the \e npoly + 1 offsets of the polygons.
+     * @param[in] lat the array of latitudes of the vertices (degrees).
+     * @param[in] lon the array of longitudes of the vertices (degrees).
+     * @param[in] npoly the number of polygons.
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter array of the perimeters of the polygons or lengths
+     *   of the polylines (meters).
+     * @param[out] area array of the areas of the polygons
+     *   (meters<sup>2</sup>); this is not referenced (and may be a null
+     *   pointer) if \e polyline is true in the constructor.
+     *
+     * The vertices of polygon \e k, 0 &le; \e k &lt; \e npoly, are (\e
+     * lat[\e i], \e lon[\e i]), for \e offsets[\e k] &le; \e i &lt; \e
+     * offsets[\e k + 1] (this is the "compressed sparse row" layout).  The
+     * results are identical to those obtained by calling
+     * PolygonAreaT::Clear, PolygonAreaT::AddPoint for each vertex, and
+     * PolygonAreaT::Compute.  However the polygon held by this object is not
+     * changed and no memory is allocated.  If the calling code is compiled
+     * with OpenMP support, the polygons are distributed among the OpenMP
+     * threads.
+     **********************************************************************/
+    void ComputeMany(const size_t offsets[],
+                     const real lat[], const real lon[], size_t npoly,
+                     bool reverse, bool sign,
+                     real perimeter[], real area[]) const {
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long np = long(npoly);
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 256)
+#endif
+      for (long k = 0; k < np; ++k) {
+        real t;
+        ComputeOne(lat + offsets[k], lon + offsets[k],
+                   offsets[k + 1] - offsets[k], reverse, sign,
+                   perimeter[k], _polyline ? t : area[k]);
+      }
+    }
+
+    /**
+     * Compute the areas of the cells of a latitude-longitude grid.
+     *
+     * @param[in] lat the array of latitudes of the edges of the cells
+     *   (degrees).
+     * @param[in] nlat the number of elements in \e lat.
+     * @param[in] dlon the width of the cells (degrees).
+     * @param[out] area the array of the \e nlat &minus; 1 areas of the cells
+     *   (meters<sup>2</sup>).
+     * @exception GeographicErr if \e dlon is not in (0&deg;, 180&deg;).
+     *
+     * Cell \e k, 0 &le; \e k &lt; \e nlat &minus; 1, is the quadrilateral
+     * with vertices (\e lat[\e k], 0), (\e lat[\e k], \e dlon), (\e
+     * lat[\e k + 1], \e dlon), (\e lat[\e k + 1], 0).  Its sides of
+     * constant longitude are meridians and its other two sides are the
+     * lines of the type used by this object (e.g., geodesics for
+     * PolygonArea; these are parallels of latitude for PolygonAreaRhumb).
+     * The area of a cell doesn't depend on its longitude, so this gives the
+     * areas of all the cells of a grid with cell width \e dlon.  Only \e
+     * nlat line calculations are needed (instead of four for each cell) and
+     * the result for each cell is the same as computing the polygon with
+     * PolygonAreaT::AddPoint and PolygonAreaT::Compute (with \e reverse =
+     * false and \e sign = true).  In particular, the area is negative if \e
+     * lat[\e k + 1] &lt; \e lat[\e k].  The polygon held by this object is
+     * not changed.
+     **********************************************************************/
+    void CellAreas(const real lat[], size_t nlat, real dlon,
+                   real area[]) const;
+
     /**
      * Return the results assuming a tentative final test point is added;
      * however, the data for the test point is not saved.  This lets you report
@@ -222,6 +405,105 @@ namespace GeographicLib {
     unsigned TestEdge(real azi, real s, bool reverse, bool sign,
                       real& perimeter, real& area) const;
 
+    /**
+     * Return the results for many tentative final test points.
+     *
+     * @param[in] lat the array of latitudes of the test points (degrees).
+     * @param[in] lon the array of longitudes of the test points (degrees).
+     * @param[in] n the number of test points.
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the array of the approximate perimeters of the
+     *   polygon or lengths of the polyline (meters).
+     * @param[out] area the array of the approximate areas of the polygon
+     *   (meters<sup>2</sup>); this is not referenced (and may be a null
+     *   pointer) if \e polyline is true in the constructor.
+     * @return the number of points.
+     *
+     * The results for test point \e i are identical to those given by
+     * PolygonAreaT::TestPoint(\e lat[\e i], \e lon[\e i], ...).  However
+     * the running sums for the polygon are only evaluated once and, if the
+     * calling code is compiled with OpenMP support, the test points are
+     * distributed among the OpenMP threads.  This lets many candidate
+     * vertices be evaluated together, e.g., when simplifying a polygon.
+     **********************************************************************/
+    unsigned TestPoints(const real lat[], const real lon[], size_t n,
+                        bool reverse, bool sign,
+                        real perimeter[], real area[]) const {
+      if (_num == 0) {
+        for (size_t i = 0; i < n; ++i) {
+          perimeter[i] = 0;
+          if (!_polyline)
+            area[i] = 0;
+        }
+        return 1;
+      }
+      real p0 = _perimetersum(), a0 = _polyline ? 0 : _areasum();
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long nn = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (long i = 0; i < nn; ++i) {
+        real t;
+        TestPointSums(lat[i], lon[i], p0, a0, reverse, sign,
+                      perimeter[i], _polyline ? t : area[i]);
+      }
+      return _num + 1;
+    }
+
+    /**
+     * Return the results for many tentative final test points given by
+     * azimuths and distances.
+     *
+     * @param[in] azi the array of azimuths at current point (degrees).
+     * @param[in] s the array of distances from current point to the final
+     *   test points (meters).
+     * @param[in] n the number of test points.
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the array of the approximate perimeters of the
+     *   polygon or lengths of the polyline (meters).
+     * @param[out] area the array of the approximate areas of the polygon
+     *   (meters<sup>2</sup>); this is not referenced (and may be a null
+     *   pointer) if \e polyline is true in the constructor.
+     * @return the number of points.
+     *
+     * The results for test point \e i are identical to those given by
+     * PolygonAreaT::TestEdge(\e azi[\e i], \e s[\e i], ...); the
+     * calculation is organized as for PolygonAreaT::TestPoints.
+     **********************************************************************/
+    unsigned TestEdges(const real azi[], const real s[], size_t n,
+                       bool reverse, bool sign,
+                       real perimeter[], real area[]) const {
+      if (_num == 0) {
+        for (size_t i = 0; i < n; ++i) {
+          perimeter[i] = Math::NaN();
+          if (!_polyline)
+            area[i] = Math::NaN();
+        }
+        return 0;
+      }
+      real p0 = _perimetersum(), a0 = _polyline ? 0 : _areasum();
+      // Use a signed loop variable for compatibility with OpenMP 2.0.
+      long nn = long(n);
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (long i = 0; i < nn; ++i) {
+        real t;
+        TestEdgeSums(azi[i], s[i], p0, a0, reverse, sign,
+                     perimeter[i], _polyline ? t : area[i]);
+      }
+      return _num + 1;
+    }
+
     /// \cond SKIP
     /**
      * <b>DEPRECATED</b>
@@ -287,6 +569,15 @@ namespace GeographicLib {
    **********************************************************************/
   typedef PolygonAreaT<Rhumb> PolygonAreaRhumb;
 
+  /**
+   * @relates PolygonAreaT
+   *
+   * Approximate polygon areas using great circles on the authalic sphere.
+   * This is several times faster than PolygonArea; see AuthalicSphere for the
+   * errors in this approximation.
+   **********************************************************************/
+  typedef PolygonAreaT<AuthalicSphere> PolygonAreaAuthalic;
+
 } // namespace GeographicLib
 
 #endif  // GEOGRAPHICLIB_POLYGONAREA_HPP
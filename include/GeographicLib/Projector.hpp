@@ -0,0 +1,292 @@
+/**
+ * \file Projector.hpp
+ * \brief Header for GeographicLib::Projector and related classes
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_PROJECTOR_HPP)
+#define GEOGRAPHICLIB_PROJECTOR_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/GridMapper.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/PolarStereographic.hpp>
+#include <GeographicLib/LambertConformalConic.hpp>
+#include <GeographicLib/AlbersEqualArea.hpp>
+#include <GeographicLib/CassiniSoldner.hpp>
+#include <GeographicLib/Gnomonic.hpp>
+#include <GeographicLib/AzimuthalEquidistant.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A common interface to the map projections
+   *
+   * The projection classes each have their own calling sequence for
+   * Forward and Reverse (with a central meridian, a choice of pole, a center
+   * point, etc.).  Projector is an abstract base class which represents a
+   * projection with all its parameters bound so that it is a mapping between
+   * geographic coordinates and projected coordinates (\e x, \e y) in
+   * meters.  The mapping is carried out on arrays of points by the virtual
+   * functions Projector::ForwardBatch and Projector::ReverseBatch; code
+   * which handles projections generically therefore incurs the cost of a
+   * virtual call once per batch instead of once per point.
+   *
+   * ProjectorT gives the implementations of this interface for the
+   * projection classes; these call the batch versions of Forward and Reverse
+   * in the projection classes and so return the same results.  Reprojector
+   * composes two Projector objects.
+   *
+   * Example of use:
+   * \include example-Projector.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Projector {
+  protected:
+    typedef Math::real real;
+  public:
+    virtual ~Projector();
+
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     *
+     * The input and output arrays must not overlap.
+     **********************************************************************/
+    virtual void ForwardBatch(const real lat[], const real lon[], size_t n,
+                              real x[], real y[]) const = 0;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     *
+     * The input and output arrays must not overlap.
+     **********************************************************************/
+    virtual void ReverseBatch(const real x[], const real y[], size_t n,
+                              real lat[], real lon[]) const = 0;
+
+    /**
+     * Forward projection of a single point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] x easting (meters).
+     * @param[out] y northing (meters).
+     **********************************************************************/
+    void Forward(real lat, real lon, real& x, real& y) const
+    { ForwardBatch(&lat, &lon, 1, &x, &y); }
+
+    /**
+     * Reverse projection of a single point.
+     *
+     * @param[in] x easting (meters).
+     * @param[in] y northing (meters).
+     * @param[out] lat latitude of the point (degrees).
+     * @param[out] lon longitude of the point (degrees).
+     **********************************************************************/
+    void Reverse(real x, real y, real& lat, real& lon) const
+    { ReverseBatch(&x, &y, 1, &lat, &lon); }
+  };
+
+  /**
+   * \brief The Projector interface for a projection class
+   *
+   * ProjectorT<Proj> holds a copy of a projection object of type \e Proj
+   * together with the parameters needed to call its Forward and Reverse
+   * functions.  It is specialized for TransverseMercator,
+   * TransverseMercatorExact, PolarStereographic, LambertConformalConic,
+   * AlbersEqualArea, CassiniSoldner, Gnomonic, and AzimuthalEquidistant.
+   * The results are identical to those returned by the projection classes.
+   * Because it holds a copy of the (immutable) projection, a ProjectorT
+   * object may be used concurrently from several threads.
+   *
+   * @tparam Proj the projection class.
+   **********************************************************************/
+  template<class Proj> class ProjectorT;
+
+  /// \cond SKIP
+  template<> class ProjectorT<TransverseMercator> : public Projector {
+  private:
+    TransverseMercator _tm;
+    real _lon0;
+  public:
+    ProjectorT(const TransverseMercator& tm, real lon0)
+      : _tm(tm), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _tm.Forward(_lon0, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _tm.Reverse(_lon0, x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<TransverseMercatorExact> : public Projector {
+  private:
+    TransverseMercatorExact _tm;
+    real _lon0;
+  public:
+    ProjectorT(const TransverseMercatorExact& tm, real lon0)
+      : _tm(tm), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const {
+      for (size_t i = 0; i < n; ++i)
+        _tm.Forward(_lon0, lat[i], lon[i], x[i], y[i]);
+    }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const {
+      for (size_t i = 0; i < n; ++i)
+        _tm.Reverse(_lon0, x[i], y[i], lat[i], lon[i]);
+    }
+  };
+
+  template<> class ProjectorT<PolarStereographic> : public Projector {
+  private:
+    PolarStereographic _ps;
+    bool _northp;
+  public:
+    ProjectorT(const PolarStereographic& ps, bool northp)
+      : _ps(ps), _northp(northp) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _ps.Forward(_northp, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _ps.Reverse(_northp, x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<LambertConformalConic> : public Projector {
+  private:
+    LambertConformalConic _lcc;
+    real _lon0;
+  public:
+    ProjectorT(const LambertConformalConic& lcc, real lon0)
+      : _lcc(lcc), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _lcc.ForwardBatch(_lon0, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _lcc.ReverseBatch(_lon0, x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<AlbersEqualArea> : public Projector {
+  private:
+    AlbersEqualArea _aea;
+    real _lon0;
+  public:
+    ProjectorT(const AlbersEqualArea& aea, real lon0)
+      : _aea(aea), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _aea.ForwardBatch(_lon0, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _aea.ReverseBatch(_lon0, x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<CassiniSoldner> : public Projector {
+  private:
+    CassiniSoldner _cs;
+  public:
+    explicit ProjectorT(const CassiniSoldner& cs)
+      : _cs(cs) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _cs.ForwardBatch(lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _cs.ReverseBatch(x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<Gnomonic> : public Projector {
+  private:
+    Gnomonic _gn;
+    real _lat0, _lon0;
+  public:
+    ProjectorT(const Gnomonic& gn, real lat0, real lon0)
+      : _gn(gn), _lat0(lat0), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _gn.ForwardBatch(_lat0, _lon0, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _gn.ReverseBatch(_lat0, _lon0, x, y, n, lat, lon); }
+  };
+
+  template<> class ProjectorT<AzimuthalEquidistant> : public Projector {
+  private:
+    AzimuthalEquidistant _az;
+    real _lat0, _lon0;
+  public:
+    ProjectorT(const AzimuthalEquidistant& az, real lat0, real lon0)
+      : _az(az), _lat0(lat0), _lon0(lon0) {}
+    void ForwardBatch(const real lat[], const real lon[], size_t n,
+                      real x[], real y[]) const
+    { _az.ForwardBatch(_lat0, _lon0, lat, lon, n, x, y); }
+    void ReverseBatch(const real x[], const real y[], size_t n,
+                      real lat[], real lon[]) const
+    { _az.ReverseBatch(_lat0, _lon0, x, y, n, lat, lon); }
+  };
+  /// \endcond
+
+  /**
+   * \brief Convert between two projections
+   *
+   * This converts projected coordinates in one projection to those in
+   * another by the reverse projection of the first followed by the forward
+   * projection of the second.  The points are processed in blocks so that
+   * the intermediate geographic coordinates remain in cache and each
+   * projection is called once per block.  A Reprojector is a
+   * GridMapper::Transform and so can be used to drive GridMapper; in this
+   * case, \e from should be the projection of the destination raster and \e
+   * to that of the source raster.
+   *
+   * A Reprojector holds references to the Projector objects passed to its
+   * constructor; these must outlive the Reprojector.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Reprojector : public GridMapper::Transform {
+  private:
+    typedef Math::real real;
+    static const size_t block_ = 256;
+    const Projector& _from;
+    const Projector& _to;
+    Reprojector& operator=(const Reprojector&); // Disallow assignment
+  public:
+    /**
+     * Constructor for Reprojector.
+     *
+     * @param[in] from the projection of the input coordinates.
+     * @param[in] to the projection of the output coordinates.
+     **********************************************************************/
+    Reprojector(const Projector& from, const Projector& to)
+      : _from(from), _to(to) {}
+
+    /**
+     * Convert many points.
+     *
+     * @param[in] x array of eastings in projection \e from (meters).
+     * @param[in] y array of northings in projection \e from (meters).
+     * @param[in] n the number of points.
+     * @param[out] u array of eastings in projection \e to (meters).
+     * @param[out] v array of northings in projection \e to (meters).
+     **********************************************************************/
+    void operator()(const real x[], const real y[], size_t n,
+                    real u[], real v[]) const;
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_PROJECTOR_HPP
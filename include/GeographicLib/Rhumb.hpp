@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_RHUMB_HPP)
 #define GEOGRAPHICLIB_RHUMB_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/Ellipsoid.hpp>
 
@@ -27,6 +28,7 @@ namespace GeographicLib {
 
   class RhumbLine;
   template <class T> class PolygonAreaT;
+  template <class T> class EditablePolygonAreaT;
 
   /**
    * \brief Solve of the direct and inverse rhumb problems.
@@ -68,13 +70,25 @@ namespace GeographicLib {
     typedef Math::real real;
     friend class RhumbLine;
     template <class T> friend class PolygonAreaT;
+    template <class T> friend class EditablePolygonAreaT;
     Ellipsoid _ell;
     bool _exact;
     real _c2;
+    int _nR;                    // the order of the area series used
     static const int tm_maxord = GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER;
     static const int maxpow_ = GEOGRAPHICLIB_RHUMBAREA_ORDER;
     // _R[0] unused
     real _R[maxpow_ + 1];
+    // With exact = true, the Fourier series for mu - chi in terms of chi and
+    // for chi - mu in terms of mu, given as for Krueger's series by
+    //   mu = chi + sum(_A[j] * sin(2*j*chi), j = 1.._nA)
+    //   chi = mu - sum(_B[j] * sin(2*j*mu), j = 1.._nA)
+    // (_A[0] and _B[0] unused); _nA = -1 if these aren't available.
+    std::vector<real> _A, _B;
+    int _nA;
+    // Max number of samples used by ExactSeries.
+    static const int maxsamples_ = 256;
+    void ExactSeries();
     static inline real gd(real x)
     { using std::atan; using std::sinh; return atan(sinh(x)); }
 
@@ -140,7 +154,12 @@ namespace GeographicLib {
     // Deatanhe(x,y) = eatanhe((x-y)/(1-e^2*x*y))/(x-y)
     inline real Deatanhe(real x, real y) const {
       real t = x - y, d = 1 - _ell._e2 * x * y;
-      return t ? Math::eatanhe(t / d, _ell._es) / t : _ell._e2 / d;
+      // For e^2 < 0, eatanhe is an atan and, as in Datan, the subtraction
+      // formula only holds for d > 0 (it's inaccurate unless d > 1/2).  d
+      // can be negative for e^2 < -1 and x*y < 0.
+      return t ? (2 * d > 1 ? Math::eatanhe(t / d, _ell._es) :
+                  Math::eatanhe(x, _ell._es) - Math::eatanhe(y, _ell._es)) / t :
+        _ell._e2 / d;
     }
     // (E(x) - E(y)) / (x - y) -- E = incomplete elliptic integral of 2nd kind
     real DE(real x, real y) const;
@@ -152,9 +171,9 @@ namespace GeographicLib {
     // (sum(c[j]*sin(2*j*x),j=1..n) - sum(c[j]*sin(2*j*x),j=1..n)) / (x - y)
     static real SinCosSeries(bool sinp,
                              real x, real y, const real c[], int n);
-    // (mux - muy) / (chix - chiy) using Krueger's series
+    // (mux - muy) / (chix - chiy) using Krueger's series (or _A)
     real DConformalToRectifying(real chix, real chiy) const;
-    // (chix - chiy) / (mux - muy) using Krueger's series
+    // (chix - chiy) / (mux - muy) using Krueger's series (or _B)
     real DRectifyingToConformal(real mux, real muy) const;
 
     // (mux - muy) / (psix - psiy)
@@ -162,9 +181,18 @@ namespace GeographicLib {
     real DIsometricToRectifying(real psix, real psiy) const;
     // (psix - psiy) / (mux - muy)
     real DRectifyingToIsometric(real mux, real muy) const;
+    // Same as DRectifyingToIsometric(mux, muy) given also the latitudes
+    // InverseRectifyingLatitude(mux/degree) and ...(muy/degree)
+    real DRectifyingToIsometric(real mux, real muy,
+                                real latx, real laty) const;
 
     real MeanSinXi(real psi1, real psi2) const;
 
+    // The inverse problem given the longitude difference and the isometric
+    // latitudes (all in degrees).
+    void InverseIsometric(real lon12, real psi1, real psi2, unsigned outmask,
+                          real& s12, real& azi12, real& S12) const;
+
     // The following two functions (with lots of ignored arguments) mimic the
     // interface to the corresponding Geodesic function.  These are needed by
     // PolygonAreaT.
@@ -240,15 +268,50 @@ namespace GeographicLib {
      * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
      *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
      *   flattening to 1/\e f.
-     * @param[in] exact if true (the default) use an addition theorem for
-     *   elliptic integrals to compute divided differences; otherwise use
-     *   series expansion (accurate for |<i>f</i>| < 0.01).
+     * @param[in] exact if true (the default) use Fourier series, whose
+     *   coefficients are found from the elliptic integrals, to compute
+     *   divided differences; otherwise use series expansion (accurate for
+     *   |<i>f</i>| < 0.01).
+     * @param[in] order the order of the series expansion used for the area
+     *   (default GEOGRAPHICLIB_RHUMBAREA_ORDER).
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
+     * @exception GeographicErr if \e order is not in [0,
+     *   GEOGRAPHICLIB_RHUMBAREA_ORDER].
      *
      * See \ref rhumb, for a detailed description of the \e exact parameter.
+     * With \e exact = true, the constructor finds the Fourier series
+     * relating the rectifying and conformal latitudes by sampling the
+     * latitudes (computed with elliptic integrals) at successively finer
+     * resolutions until the coefficients converge; the truncation error in
+     * the series is then less than the machine epsilon.  After this, the exact
+     * calculations are about as fast as those with the series expansions
+     * (which these series generalize).  The series converge if the third
+     * flattening \e n is in about [&minus;0.4, 0.4] (WGS84 needs 5 terms,
+     * \e f = 1/2 needs 55; setting them up costs about 15 &mu;s for WGS84).
+     * Otherwise, an addition theorem for elliptic integrals is used for the
+     * divided differences; this is about 3 times slower.  (In either mode,
+     * the constructor also saves the Fourier series for the elliptic
+     * integrals with EllipticFunction::PrecomputeSeries; this makes the
+     * conversions to and from the rectifying latitude, and so Rhumb::Direct
+     * and RhumbLine::Position, about 2 times faster.)
+     *
+     * Setting \e order to a value less than GEOGRAPHICLIB_RHUMBAREA_ORDER
+     * truncates the series for the area \e S12 (the distances and positions
+     * are unaffected); this trades accuracy for speed.  For the WGS84
+     * ellipsoid, the maximum errors in \e S12 are about 2 &times;
+     * 10<sup>8</sup> m<sup>2</sup> for \e order = 1, 3 &times;
+     * 10<sup>5</sup> m<sup>2</sup> for \e order = 2, 800 m<sup>2</sup> for
+     * \e order = 3, 2 m<sup>2</sup> for \e order = 4, and 0.02
+     * m<sup>2</sup> (the round-off error) for \e order = 5.  The errors scale
+     * as <i>n</i><sup><i>order</i>+1</sup> for other ellipsoids, where \e n
+     * is the third flattening.  The area series accounts for only a modest
+     * part of the cost of the area calculation, so with \e order = 3,
+     * PolygonAreaRhumb is only about 15% faster.  RhumbLine objects created
+     * from this object use the same order.
      **********************************************************************/
-    Rhumb(real a, real f, bool exact = true);
+    Rhumb(real a, real f, bool exact = true,
+          int order = GEOGRAPHICLIB_RHUMBAREA_ORDER);
 
     /**
      * Solve the direct rhumb problem returning also the area.
@@ -321,6 +384,58 @@ namespace GeographicLib {
     void GenDirect(real lat1, real lon1, real azi12, real s12, unsigned outmask,
                    real& lat2, real& lon2, real& S12) const;
 
+    /**
+     * Solve many direct rhumb problems.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[in] s12 array of distances between point 1 and point 2 (meters).
+     * @param[in] n the number of problems.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * The \e i th problem is specified by \e lat1[\e i], \e lon1[\e i], \e
+     * azi12[\e i], \e s12[\e i], for 0 &le; \e i &lt; \e n.  The results are
+     * identical to those returned by Rhumb::Direct.
+     **********************************************************************/
+    void DirectBatch(const real* lat1, const real* lon1, const real* azi12,
+                     const real* s12, size_t n,
+                     real* lat2, real* lon2, real* S12) const {
+      GenDirectBatch(lat1, lon1, azi12, s12, n, LATITUDE | LONGITUDE | AREA,
+                     lat2, lon2, S12);
+    }
+
+    /**
+     * The general direct rhumb calculation for many problems.
+     * Rhumb::DirectBatch is defined in terms of this function.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[in] s12 array of distances between point 1 and point 2 (meters).
+     * @param[in] n the number of problems.
+     * @param[in] outmask a bitor'ed combination of Rhumb::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * The interpretation of \e outmask is the same as for Rhumb::GenDirect.
+     * Output arrays not selected by \e outmask are not referenced and may be
+     * null pointers.  The results are identical to calling Rhumb::GenDirect
+     * \e n times.  The setup of the rhumb line (the computation of the
+     * rectifying and isometric latitudes of point 1) is reused for
+     * consecutive problems with the same \e lat1 and \e azi12 (for example,
+     * when computing many points along a single track).
+     **********************************************************************/
+    void GenDirectBatch(const real* lat1, const real* lon1, const real* azi12,
+                        const real* s12, size_t n, unsigned outmask,
+                        real* lat2, real* lon2, real* S12) const;
+
     /**
      * Solve the inverse rhumb problem returning also the area.
      *
@@ -383,6 +498,62 @@ namespace GeographicLib {
                     unsigned outmask,
                     real& s12, real& azi12, real& S12) const;
 
+    /**
+     * Solve many inverse rhumb problems.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[out] s12 array of rhumb distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * The input arrays are in "structure of arrays" form; the \e i th
+     * problem is specified by \e lat1[\e i], \e lon1[\e i], \e lat2[\e i],
+     * \e lon2[\e i], for 0 &le; \e i &lt; \e n.  The results are identical
+     * to those returned by Rhumb::Inverse.
+     **********************************************************************/
+    void InverseBatch(const real* lat1, const real* lon1,
+                      const real* lat2, const real* lon2, size_t n,
+                      real* s12, real* azi12, real* S12) const {
+      GenInverseBatch(lat1, lon1, lat2, lon2, n, DISTANCE | AZIMUTH | AREA,
+                      s12, azi12, S12);
+    }
+
+    /**
+     * The general inverse rhumb calculation for many pairs of points.
+     * Rhumb::InverseBatch is defined in terms of this function.
+     *
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] n the number of pairs of points.
+     * @param[in] outmask a bitor'ed combination of Rhumb::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of rhumb distances between point 1 and point 2
+     *   (meters).
+     * @param[out] azi12 array of azimuths of the rhumb lines (degrees).
+     * @param[out] S12 array of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * The interpretation of \e outmask is the same as for
+     * Rhumb::GenInverse.  Output arrays not selected by \e outmask are not
+     * referenced and may be null pointers.  The results are identical to
+     * calling Rhumb::GenInverse \e n times.  The isometric latitude of a
+     * point is reused if \e lat1 (or \e lat2) is the same as for the
+     * previous problem; this speeds up the calculation of the rhumb lines from
+     * a single point to many others.
+     **********************************************************************/
+    void GenInverseBatch(const real* lat1, const real* lon1,
+                         const real* lat2, const real* lon2, size_t n,
+                         unsigned outmask,
+                         real* s12, real* azi12, real* S12) const;
+
     /**
      * Set up to compute several points on a single rhumb line.
      *
@@ -417,8 +588,17 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real Flattening() const { return _ell.Flattening(); }
 
+    /**
+     * @return total area of ellipsoid in meters<sup>2</sup>.
+     **********************************************************************/
     Math::real EllipsoidArea() const { return _ell.Area(); }
 
+    /**
+     * @return the order of the series expansion used for the area.  This is
+     *   the value used in the constructor.
+     **********************************************************************/
+    int AreaOrder() const { return _nR; }
+
     /**
      * A global instantiation of Rhumb with the parameters for the WGS84
      * ellipsoid.
@@ -451,9 +631,12 @@ namespace GeographicLib {
     const Rhumb& _rh;
     bool _exact;
     real _lat1, _lon1, _azi12, _salp, _calp, _mu1, _psi1, _r1;
+    // The latitude for _mu1 as computed in DRectifyingToIsometric
+    real _lat1mu;
     RhumbLine& operator=(const RhumbLine&); // copy assignment not allowed
     RhumbLine(const Rhumb& rh, real lat1, real lon1, real azi12,
               bool exact);
+    void Init(real lat1, real lon1, real azi12);
   public:
 
     /**
@@ -570,6 +753,67 @@ namespace GeographicLib {
     void GenPosition(real s12, unsigned outmask,
                      real& lat2, real& lon2, real& S12) const;
 
+    /** \name Positions for arrays of distances
+     **********************************************************************/
+    ///@{
+    /**
+     * Compute the positions of many points on the rhumb line given their
+     * distances from point 1.
+     *
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     *
+     * The results are identical to calling RhumbLine::Position \e n times.
+     **********************************************************************/
+    void Positions(const real* s12, size_t n, real* lat2, real* lon2) const
+    { GenPositions(s12, n, LATITUDE | LONGITUDE, lat2, lon2, 0); }
+
+    /**
+     * The general position function for many points.  RhumbLine::Positions
+     * is defined in terms of this function.
+     *
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[in] n the number of points.
+     * @param[in] outmask a bitor'ed combination of RhumbLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] S12 array of areas under the rhumb line
+     *   (meters<sup>2</sup>).
+     *
+     * The interpretation of \e outmask is the same as for
+     * RhumbLine::GenPosition.  Output arrays not selected by \e outmask are
+     * not referenced and may be null pointers.  The results are identical to
+     * calling RhumbLine::GenPosition \e n times.
+     **********************************************************************/
+    void GenPositions(const real* s12, size_t n, unsigned outmask,
+                      real* lat2, real* lon2, real* S12) const;
+
+    /**
+     * Compute the positions of equally spaced points on the rhumb line, e.g.,
+     * to densify a track.
+     *
+     * @param[in] s12 the distance from point 1 to the first point (meters).
+     * @param[in] ds12 the spacing of the points (meters).
+     * @param[in] n the number of points.
+     * @param[in] outmask a bitor'ed combination of RhumbLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] S12 array of areas under the rhumb line
+     *   (meters<sup>2</sup>).
+     *
+     * Point \e i, for 0 &le; \e i &lt; \e n, is at a distance \e s12 + \e
+     * i \e ds12 from point 1; the results are identical to calling
+     * RhumbLine::GenPosition with this distance.  Output arrays not selected
+     * by \e outmask are not referenced and may be null pointers.
+     **********************************************************************/
+    void UniformPositions(real s12, real ds12, size_t n, unsigned outmask,
+                          real* lat2, real* lon2, real* S12 = 0) const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
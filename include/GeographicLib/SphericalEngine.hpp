@@ -40,9 +40,9 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT SphericalEngine {
   private:
     typedef Math::real real;
-    // A table of the square roots of integers
-    static std::vector<real> root_;
-    friend class CircularEngine; // CircularEngine needs access to root_, scale_
+    // The table of the square roots of integers
+    static const real* roots();
+    friend class CircularEngine; // CircularEngine needs access to roots, scale
     // An internal scaling of the coefficients to avoid overflow in
     // intermediate calculations.
     static real scale() {
@@ -57,7 +57,8 @@ namespace GeographicLib {
       return std::numeric_limits<real>::epsilon() *
         sqrt(std::numeric_limits<real>::epsilon());
     }
-    static const std::vector<real> Z_;
+    // The number of points handled together by the multi-point Value.
+    static const int npoints_ = 8;
     SphericalEngine();          // Disable constructor
   public:
     /**
@@ -96,12 +97,26 @@ namespace GeographicLib {
      *
      * The storage layout of the coefficients is documented in
      * SphericalHarmonic and SphericalHarmonic::SphericalHarmonic.
+     * Alternatively, the coefficients may be held in a single vector with \e
+     * C and \e S interleaved; see coeff::pack.  Such a vector may be stored
+     * as floats to save memory; see coeff::coeff(const float*, int, int).
+     * Optionally, a table of the factors for the Clenshaw recursion may be
+     * attached; see coeff::factors.
      **********************************************************************/
     class GEOGRAPHICLIB_EXPORT coeff {
     private:
       int _Nx, _nmx, _mmx;
-      std::vector<real>::const_iterator _Cnm;
-      std::vector<real>::const_iterator _Snm;
+      const real* _Cnm;
+      const real* _Snm;
+      // The spacing of the elements of C and S (2 if interleaved) and the
+      // offset of the start of S from index 0.
+      int _stride, _Soff;
+      // The precomputed recursion factors (0 if there are none).
+      const real* _AB;
+      // The coefficients if they are stored as floats (0 otherwise); these
+      // are used in place of _Cnm and _Snm.
+      const float* _Cnmf;
+      const float* _Snmf;
     public:
       /**
        * A default constructor
@@ -110,8 +125,13 @@ namespace GeographicLib {
         : _Nx(-1)
         , _nmx(-1)
         , _mmx(-1)
-        , _Cnm(Z_.begin())
-        , _Snm(Z_.begin()) {}
+        , _Cnm(0)
+        , _Snm(0)
+        , _stride(1)
+        , _Soff(0)
+        , _AB(0)
+        , _Cnmf(0)
+        , _Snmf(0) {}
       /**
        * The general constructor.
        *
@@ -133,8 +153,13 @@ namespace GeographicLib {
         : _Nx(N)
         , _nmx(nmx)
         , _mmx(mmx)
-        , _Cnm(C.begin())
-        , _Snm(S.begin())
+        , _Cnm(C.empty() ? 0 : &C[0])
+        , _Snm(S.empty() ? 0 : &S[0])
+        , _stride(1)
+        , _Soff(_Nx + 1)
+        , _AB(0)
+        , _Cnmf(0)
+        , _Snmf(0)
       {
         if (!(_Nx >= _nmx && _nmx >= _mmx && _mmx >= -1))
           throw GeographicErr("Bad indices for coeff");
@@ -161,8 +186,13 @@ namespace GeographicLib {
         : _Nx(N)
         , _nmx(N)
         , _mmx(N)
-        , _Cnm(C.begin())
-        , _Snm(S.begin())
+        , _Cnm(C.empty() ? 0 : &C[0])
+        , _Snm(S.empty() ? 0 : &S[0])
+        , _stride(1)
+        , _Soff(_Nx + 1)
+        , _AB(0)
+        , _Cnmf(0)
+        , _Snmf(0)
       {
         if (!(_Nx >= -1))
           throw GeographicErr("Bad indices for coeff");
@@ -171,6 +201,178 @@ namespace GeographicLib {
           throw GeographicErr("Arrays too small in coeff");
         SphericalEngine::RootTable(_nmx);
       }
+      /**
+       * The constructor for coefficients held in arrays.
+       *
+       * @param[in] C an array of coefficients for the cosine terms.
+       * @param[in] S an array of coefficients for the sine terms.
+       * @param[in] N the degree giving storage layout for \e C and \e S.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @exception GeographicErr if \e N, \e nmx, and \e mmx do not satisfy
+       *   \e N &ge; \e nmx &ge; \e mmx &ge; &minus;1.
+       * @exception std::bad_alloc if the memory for the square root table
+       *   can't be allocated.
+       *
+       * This is the same as the general constructor except that the storage
+       * is not owned by a vector, e.g., it is in a memory mapped file (see
+       * coeff::mapcoeffs).  The sizes of \e C and \e S can't be checked; so
+       * the caller must ensure that \e C holds at least coeff::Csize(\e N,
+       * \e mmx) elements and \e S at least coeff::Ssize(\e N, \e mmx).
+       **********************************************************************/
+      coeff(const real* C, const real* S, int N, int nmx, int mmx)
+        : _Nx(N)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _Cnm(C)
+        , _Snm(S)
+        , _stride(1)
+        , _Soff(_Nx + 1)
+        , _AB(0)
+        , _Cnmf(0)
+        , _Snmf(0)
+      {
+        if (!(_Nx >= _nmx && _nmx >= _mmx && _mmx >= -1))
+          throw GeographicErr("Bad indices for coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * The constructor for interleaved coefficients.
+       *
+       * @param[in] CS a vector of interleaved coefficients produced by
+       *   coeff::pack.
+       * @param[in] nmx the maximum degree.
+       * @param[in] mmx the maximum order.
+       * @exception GeographicErr if \e nmx and \e mmx do not satisfy \e nmx
+       *   &ge; \e mmx &ge; &minus;1.
+       * @exception GeographicErr if \e CS is not big enough to hold the
+       *   coefficients.
+       * @exception std::bad_alloc if the memory for the square root table
+       *   can't be allocated.
+       *
+       * The result is equivalent to a coeff object constructed with \e C and
+       * \e S (and \e N = \e nmx) and SphericalEngine::Value gives identical
+       * results with either.
+       **********************************************************************/
+      coeff(const std::vector<real>& CS, int nmx, int mmx)
+        : _Nx(nmx)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _Cnm(CS.empty() ? 0 : &CS[0])
+        , _Snm(CS.empty() ? 0 : &CS[0])
+        , _stride(2)
+        , _Soff(-1)
+        , _AB(0)
+        , _Cnmf(0)
+        , _Snmf(0)
+      {
+        if (!(_nmx >= _mmx && _mmx >= -1))
+          throw GeographicErr("Bad indices for coeff");
+        if (!(2 * (index(_nmx, _mmx) + 1) <= int(CS.size())))
+          throw GeographicErr("Array too small in coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * The constructor for interleaved coefficients stored as floats.
+       *
+       * @param[in] CS an array of interleaved coefficients, in the order
+       *   produced by coeff::pack, converted to float.
+       * @param[in] nmx the maximum degree.
+       * @param[in] mmx the maximum order.
+       * @exception GeographicErr if \e nmx and \e mmx do not satisfy \e nmx
+       *   &ge; \e mmx &ge; &minus;1.
+       * @exception std::bad_alloc if the memory for the square root table
+       *   can't be allocated.
+       *
+       * This halves the memory for the coefficients (and the memory traffic
+       * for the sums) compared to storing them as doubles.  The coefficients
+       * are converted to \e real as they are read and the sums are
+       * accumulated in \e real; so the only loss of accuracy is the rounding
+       * of each coefficient, a relative error of at most 2<sup>&minus;24</sup>
+       * = 6 &times; 10<sup>&minus;8</sup>.  The caller must ensure that \e CS
+       * holds at least 2 coeff::Csize(\e nmx, \e mmx) elements.
+       **********************************************************************/
+      coeff(const float* CS, int nmx, int mmx)
+        : _Nx(nmx)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _Cnm(0)
+        , _Snm(0)
+        , _stride(2)
+        , _Soff(-1)
+        , _AB(0)
+        , _Cnmf(CS)
+        , _Snmf(CS)
+      {
+        if (!(_nmx >= _mmx && _mmx >= -1))
+          throw GeographicErr("Bad indices for coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * The constructor for a truncated set of coefficients.
+       *
+       * @param[in] c a coeff object.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @exception GeographicErr if \e nmx and \e mmx do not satisfy \e
+       *   c.nmx() &ge; \e nmx &ge; \e mmx &ge; &minus;1 and \e mmx &le; \e
+       *   c.mmx().
+       *
+       * The result refers to the same storage as \e c (with the same layout)
+       * but only includes the terms with \e n &le; \e nmx and \e m &le; \e
+       * mmx.  Any recursion factors attached to \e c are retained if \e nmx
+       * = \e c.nmx().
+       **********************************************************************/
+      coeff(const coeff& c, int nmx, int mmx)
+        : _Nx(c._Nx)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _Cnm(c._Cnm)
+        , _Snm(c._Snm)
+        , _stride(c._stride)
+        , _Soff(c._Soff)
+        , _AB(nmx == c._nmx ? c._AB : 0)
+        , _Cnmf(c._Cnmf)
+        , _Snmf(c._Snmf)
+      {
+        if (!(c._nmx >= _nmx && _nmx >= _mmx && _mmx >= -1 &&
+              _mmx <= c._mmx))
+          throw GeographicErr("Bad indices for coeff");
+      }
+      /**
+       * The constructor attaching precomputed recursion factors.
+       *
+       * @param[in] c a coeff object.
+       * @param[in] AB the recursion factors produced by coeff::factors with
+       *   \e nmx = \e c.nmx() and \e mmx = \e c.mmx().
+       * @exception GeographicErr if \e AB is not the right size.
+       *
+       * The result is a copy of \e c which, when passed as the first element
+       * of the coefficient array to SphericalEngine::Value or
+       * SphericalEngine::Circle, uses \e AB instead of computing the factors
+       * for the Clenshaw sums over degree.  This removes a division and
+       * several multiplications from the evaluation of each term at the cost
+       * of storing 2 extra numbers per coefficient.  \e AB must have been
+       * computed with the same normalization as is used for the evaluation.
+       * The results differ from those without \e AB by roundoff.
+       **********************************************************************/
+      coeff(const coeff& c, const std::vector<real>& AB)
+        : _Nx(c._Nx)
+        , _nmx(c._nmx)
+        , _mmx(c._mmx)
+        , _Cnm(c._Cnm)
+        , _Snm(c._Snm)
+        , _stride(c._stride)
+        , _Soff(c._Soff)
+        , _AB(0)
+        , _Cnmf(c._Cnmf)
+        , _Snmf(c._Snmf)
+      {
+        if (!(int(AB.size()) == 2 * Csize(_nmx, _mmx)))
+          throw GeographicErr("Recursion factors are the wrong size");
+        if (!AB.empty())
+          _AB = &AB[0];
+      }
       /**
        * @return \e N the degree giving storage layout for \e C and \e S.
        **********************************************************************/
@@ -183,6 +385,11 @@ namespace GeographicLib {
        * @return \e mmx the maximum order to be used.
        **********************************************************************/
       inline int mmx() const { return _mmx; }
+      /**
+       * @return a pointer to the precomputed recursion factors (or 0 if
+       *   there are none).
+       **********************************************************************/
+      inline const Math::real* AB() const { return _AB; }
       /**
        * The one-dimensional index into \e C and \e S.
        *
@@ -198,14 +405,18 @@ namespace GeographicLib {
        * @param[in] k the one-dimensional index.
        * @return the value of the \e C coefficient.
        **********************************************************************/
-      inline Math::real Cv(int k) const { return *(_Cnm + k); }
+      inline Math::real Cv(int k) const
+      { return _Cnmf ? real(*(_Cnmf + _stride * k)) :
+          *(_Cnm + _stride * k); }
       /**
        * An element of \e S.
        *
        * @param[in] k the one-dimensional index.
        * @return the value of the \e S coefficient.
        **********************************************************************/
-      inline Math::real Sv(int k) const { return *(_Snm + (k - (_Nx + 1))); }
+      inline Math::real Sv(int k) const
+      { return _Snmf ? real(*(_Snmf + (_stride * k - _Soff))) :
+          *(_Snm + (_stride * k - _Soff)); }
       /**
        * An element of \e C with checking.
        *
@@ -217,7 +428,7 @@ namespace GeographicLib {
        *   and \e m are in range else 0.
        **********************************************************************/
       inline Math::real Cv(int k, int n, int m, real f) const
-      { return m > _mmx || n > _nmx ? 0 : *(_Cnm + k) * f; }
+      { return m > _mmx || n > _nmx ? 0 : Cv(k) * f; }
       /**
        * An element of \e S with checking.
        *
@@ -229,7 +440,7 @@ namespace GeographicLib {
        *   and \e m are in range else 0.
        **********************************************************************/
       inline Math::real Sv(int k, int n, int m, real f) const
-      { return m > _mmx || n > _nmx ? 0 : *(_Snm + (k - (_Nx + 1))) * f; }
+      { return m > _mmx || n > _nmx ? 0 : Sv(k) * f; }
 
       /**
        * The size of the coefficient vector for the cosine terms.
@@ -276,6 +487,103 @@ namespace GeographicLib {
        **********************************************************************/
       static void readcoeffs(std::istream& stream, int& N, int& M,
                              std::vector<real>& C, std::vector<real>& S);
+
+      /**
+       * Locate coefficients in memory mapped data.
+       *
+       * @param[in] data the start of the data (this should be aligned as for
+       *   a real, e.g., the start of a file mapped by Utility::mapfile).
+       * @param[in] len the length of the data (bytes).
+       * @param[in,out] pos the offset in \e data of the coefficients; on
+       *   return this is the offset of the following data.
+       * @param[out] N The maximum degree of the coefficients.
+       * @param[out] M The maximum order of the coefficients.
+       * @param[out] C The array of cosine coefficients.
+       * @param[out] S The array of sine coefficients.
+       * @exception GeographicErr if \e N and \e M do not satisfy \e N &ge;
+       *   \e M &ge; &minus;1.
+       * @exception GeographicErr if the data are too short or are misaligned.
+       * @exception GeographicErr if coeff::mappable() is false.
+       *
+       * This is the counterpart of coeff::readcoeffs for data which have
+       * been mapped into memory.  The data have the same format as read by
+       * readcoeffs; \e C and \e S point into \e data so that the
+       * coefficients are used in place (with
+       * SphericalEngine::coeff::coeff(const real*, const real*, int, int,
+       * int)) without being copied.
+       **********************************************************************/
+      static void mapcoeffs(char* data, unsigned long long len,
+                            unsigned long long& pos, int& N, int& M,
+                            real*& C, real*& S);
+
+      /**
+       * @return whether coeff::mapcoeffs can use coefficient data in place.
+       *
+       * This requires that \e real be an IEEE double and that the host be
+       * little-endian (matching the format of the data files).
+       **********************************************************************/
+      static bool mappable();
+
+      /**
+       * Interleave the cosine and sine coefficients.
+       *
+       * @param[in] C a vector of coefficients for the cosine terms.
+       * @param[in] S a vector of coefficients for the sine terms.
+       * @param[in] N the degree giving storage layout for \e C and \e S.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @param[out] CS the interleaved coefficients.
+       * @exception GeographicErr if \e N, \e nmx, and \e mmx do not satisfy
+       *   \e N &ge; \e nmx &ge; \e mmx &ge; &minus;1.
+       * @exception GeographicErr if \e C or \e S is not big enough to hold the
+       *   coefficients.
+       * @exception std::bad_alloc if the memory for \e CS can't be allocated.
+       *
+       * The coefficients with \e n &le; \e nmx and \e m &le; \e mmx are
+       * stored in column major order (as for \e C with \e N = \e nmx) with
+       * <i>C</i><sub><i>nm</i></sub> and <i>S</i><sub><i>nm</i></sub>
+       * adjacent (<i>S</i><sub><i>n</i>0</sub> = 0).  The data for a
+       * particular order \e m form a single contiguous stream which is read
+       * sequentially by SphericalEngine::Value (instead of two streams from
+       * separate vectors).  Use
+       * SphericalEngine::coeff::coeff(const std::vector<real>&, int, int) to
+       * construct a coeff object from \e CS.
+       **********************************************************************/
+      static void pack(const std::vector<real>& C, const std::vector<real>& S,
+                       int N, int nmx, int mmx, std::vector<real>& CS);
+
+      /**
+       * Precompute the factors for the Clenshaw recursion.
+       *
+       * @param[in] nmx the maximum degree.
+       * @param[in] mmx the maximum order.
+       * @param[in] norm the normalization, either SphericalEngine::FULL or
+       *   SphericalEngine::SCHMIDT.
+       * @param[out] AB the recursion factors.
+       * @exception GeographicErr if \e nmx and \e mmx do not satisfy \e nmx
+       *   &ge; \e mmx &ge; &minus;1 or if \e norm is unknown.
+       * @exception std::bad_alloc if the memory for \e AB can't be allocated.
+       *
+       * The recursion for the sum over degree \e n at order \e m involves
+       * alpha = \e q \e t <i>a</i><sub><i>nm</i></sub> and beta = \e
+       * q<sup>2</sup> <i>b</i><sub><i>nm</i></sub>, where
+       * <i>a</i><sub><i>nm</i></sub> and <i>b</i><sub><i>nm</i></sub> depend
+       * only on \e n, \e m, and the normalization.  These are stored in \e
+       * AB as adjacent pairs in column major order (as for \e C with \e N =
+       * \e nmx); the result uses 2 Csize(\e nmx, \e mmx) numbers.  Use
+       * SphericalEngine::coeff::coeff(const coeff&, const std::vector<real>&)
+       * to attach the table to a coeff object.  For example, to evaluate a
+       * spherical harmonic sum of degree \e N with precomputed factors,
+       * \code
+       std::vector<Math::real> AB;
+       SphericalEngine::coeff::factors(N, N, SphericalEngine::FULL, AB);
+       SphericalHarmonic h(SphericalEngine::coeff
+                           (SphericalEngine::coeff(C, S, N), AB), a);
+       \endcode
+       * (\e C, \e S, and \e AB must outlive \e h).
+       **********************************************************************/
+      static void factors(int nmx, int mmx, unsigned norm,
+                          std::vector<real>& AB);
     };
 
     /**
@@ -312,6 +620,75 @@ namespace GeographicLib {
                               real x, real y, real z, real a,
                               real& gradx, real& grady, real& gradz);
 
+    /**
+     * Evaluate a spherical harmonic sum and its gradient at several points.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] K the number of points.
+     * @param[in] x array of the \e x components of the positions.
+     * @param[in] y array of the \e y components of the positions.
+     * @param[in] z array of the \e z components of the positions.
+     * @param[in] a the normalizing radius.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This is equivalent to calling the single point version of
+     * SphericalEngine::Value for each of the \e K points and the results are
+     * identical.  However, the points are processed in groups of 8 which
+     * share a single pass through the coefficients; because the evaluation
+     * for large degree is limited by the memory traffic for the coefficients,
+     * this is considerably faster.  The arrays \e gradx, \e grady, and \e
+     * gradz are only accessed if \e gradp is true (otherwise they may be
+     * null).  This function never throws an exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Value(const coeff c[], const real f[], int K,
+                        const real x[], const real y[], const real z[],
+                        real a, real v[],
+                        real gradx[], real grady[], real gradz[]);
+
+    /**
+     * Evaluate several spherical harmonic sums and their gradients at a
+     * point with a single recursion.
+     *
+     * @tparam gradp should the gradients be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of sums; the library provides \e L = 2, 3, and 4.
+     * @param[in] c an array of \e L coeff objects.
+     * @param[in] f array of \e L multipliers for the sums.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] v array of \e L spherical harmonic sums.
+     * @param[out] gradx array of \e L \e x components of the gradients.
+     * @param[out] grady array of \e L \e y components of the gradients.
+     * @param[out] gradz array of \e L \e z components of the gradients.
+     *
+     * Unlike SphericalEngine::Value, which sums a single combination of the
+     * sets of coefficients, this computes a separate sum for each set: v[\e
+     * l] is the sum with coefficients f[\e l] times those of c[\e l].  The
+     * recursion factors are computed once for all the sets, e.g., this is
+     * used by MagneticModel to evaluate the models at the two bracketing
+     * epochs together.  This is most effective if the sets have the same
+     * degree and order; in this case, each result is identical to that given
+     * by SphericalEngine::Value with \e L = 1.  Otherwise the sets are
+     * padded with zero coefficients to the largest degree and order (and the
+     * results may differ by roundoff).  The arrays \e gradx, \e grady, and
+     * \e gradz are only accessed if \e gradp is true (otherwise they may be
+     * null).  This function never throws an exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Values(const coeff c[], const real f[],
+                         real x, real y, real z, real a, real v[],
+                         real gradx[], real grady[], real gradz[]);
+
     /**
      * Create a CircularEngine object
      *
@@ -324,10 +701,17 @@ namespace GeographicLib {
      *   <i>y</i><sup>2</sup>).
      * @param[in] z the height of the circle.
      * @param[in] a the normalizing radius.
+     * @param[in] nthreads the number of threads to use (default 1).
      * @exception std::bad_alloc if the memory for the CircularEngine can't be
      *   allocated.
      * @result the CircularEngine object.
      *
+     * The inner sums over \e n for the different orders \e m are
+     * independent.  If \e nthreads > 1, they are divided between \e
+     * nthreads threads (including the calling thread); the result does not
+     * depend on \e nthreads.  Threads are only used if the library was
+     * compiled with C++11 support; otherwise \e nthreads is ignored.
+     *
      * If you need to evaluate the spherical harmonic sum for several points
      * with constant \e f, \e p = sqrt(<i>x</i><sup>2</sup> +
      * <i>y</i><sup>2</sup>), \e z, and \e a, it is more efficient to construct
@@ -337,7 +721,38 @@ namespace GeographicLib {
      **********************************************************************/
     template<bool gradp, normalization norm, int L>
       static CircularEngine Circle(const coeff c[], const real f[],
-                                   real p, real z, real a);
+                                   real p, real z, real a,
+                                   int nthreads = 1);
+
+    /**
+     * Create CircularEngine objects for several circles.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] K the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles.
+     * @param[in] a the normalizing radius.
+     * @param[out] circ array of \e K CircularEngine objects.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * The results are identical to setting circ[i] = Circle(c, f, p[i],
+     * z[i], a, nthreads) for each \e i.  However, the inner sums for up to 8
+     * circles are carried out together, so that coefficients are fetched
+     * once for all of them.  This is useful, for example, to evaluate a field
+     * on a three-dimensional grid, where several circles at different
+     * heights share the same latitude; compared to calling Circle for each
+     * circle, this is about 2 times faster for high degree sums.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Circles(const coeff c[], const real f[], int K,
+                          const real p[], const real z[], real a,
+                          CircularEngine circ[], int nthreads = 1);
     /**
      * Check that the static table of square roots is big enough and enlarge it
      * if necessary.
@@ -347,12 +762,18 @@ namespace GeographicLib {
      *   be allocated.
      *
      * Typically, there's no need for an end-user to call this routine, because
-     * the constructors for SphericalEngine::coeff do so.  However, since this
-     * updates a static table, there's a possible race condition in a
+     * the constructors for SphericalEngine::coeff do so.  If the library was
+     * compiled with C++11 support, the table may be enlarged by one thread
+     * while others are using it (so that, for example, gravity and magnetic
+     * models can be constructed concurrently): the table is only ever
+     * replaced by a larger copy and the old copies are retained; enlarging
+     * the table takes a lock, but the check that the table is large enough
+     * does not.  Otherwise, there's a possible race condition in a
      * multi-threaded environment.  Because this routine does nothing if the
-     * table is already large enough, one way to avoid race conditions is to
-     * call this routine at program start up (when it's still single threaded),
-     * supplying the largest degree that your program will use.  E.g., \code
+     * table is already large enough, one way to avoid race conditions in that
+     * case is to call this routine at program start up (when it's still
+     * single threaded), supplying the largest degree that your program will
+     * use.  E.g., \code
      GeographicLib::SphericalEngine::RootTable(2190);
      \endcode
      * suffices to accommodate extant magnetic and gravity models.
@@ -366,10 +787,20 @@ namespace GeographicLib {
      * routine.  <b>It's safest not to call this routine at all.</b> (The space
      * used by the table is modest.)
      **********************************************************************/
-    static void ClearRootTable() {
-      std::vector<real> temp(0);
-      root_.swap(temp);
-    }
+    static void ClearRootTable();
+
+  private:
+    // Compute the inner sums for SphericalEngine::Circle for m = m0, m0 + dm,
+    // m0 + 2*dm, ...
+    template<bool gradp, normalization norm, int L>
+      static void circle(const coeff c[], const real f[],
+                         real t, real u, real q, int m0, int dm,
+                         CircularEngine* circ);
+    // The same for SphericalEngine::Circles for K circles
+    template<bool gradp, normalization norm, int L>
+      static void circles(const coeff c[], const real f[], int K,
+                          const real t[], const real u[], const real q[],
+                          int m0, int dm, CircularEngine* circ);
   };
 
 } // namespace GeographicLib
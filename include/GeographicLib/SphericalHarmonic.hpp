@@ -203,6 +203,34 @@ namespace GeographicLib {
       , _norm(norm)
     { _c[0] = SphericalEngine::coeff(C, S, N, nmx, mmx); }
 
+    /**
+     * Constructor with a SphericalEngine::coeff object.
+     *
+     * @param[in] c the coefficients.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic::FULL (the default) or
+     *   SphericalHarmonic::SCHMIDT.
+     *
+     * This allows the coefficients to be given in the interleaved layout
+     * produced by SphericalEngine::coeff::pack, e.g., \code
+     std::vector<double> CS;
+     SphericalEngine::coeff::pack(C, S, N, N, N, CS);
+     SphericalHarmonic h(SphericalEngine::coeff(CS, N, N), a);
+     \endcode
+     * For high degree sums, this is somewhat faster because the summation
+     * reads a single stream of data for each order; the results are
+     * identical.  The vectors of coefficients referenced by \e c should not
+     * be altered or destroyed during the lifetime of the SphericalHarmonic
+     * object.
+     **********************************************************************/
+    SphericalHarmonic(const SphericalEngine::coeff& c,
+                      real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm)
+    { _c[0] = c; }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
@@ -271,6 +299,68 @@ namespace GeographicLib {
       return v;
     }
 
+    /**
+     * Compute the spherical harmonic sum at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     *
+     * The results are identical to calling SphericalHarmonic::operator()()
+     * for each point in turn.  However, these are computed by
+     * SphericalEngine::Value in groups of points which share a pass through
+     * the coefficients; for large degree, this is several times faster.  This
+     * routine requires constant memory and thus never throws an exception.
+     **********************************************************************/
+    void operator()(int n, const real x[], const real y[], const real z[],
+                    real v[]) const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::Value<false, SphericalEngine::FULL, 1>
+          (_c, f, n, x, y, z, _a, v, 0, 0, 0);
+        break;
+      case SCHMIDT:
+        SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
+          (_c, f, n, x, y, z, _a, v, 0, 0, 0);
+        break;
+      }
+    }
+
+    /**
+     * Compute the spherical harmonic sum and its gradient at several points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This is the same as the previous function, except that the gradients
+     * are computed.  This routine requires constant memory and thus never
+     * throws an exception.
+     **********************************************************************/
+    void operator()(int n, const real x[], const real y[], const real z[],
+                    real v[], real gradx[], real grady[], real gradz[])
+      const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::Value<true, SphericalEngine::FULL, 1>
+          (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      case SCHMIDT:
+        SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
+          (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude.
@@ -279,6 +369,8 @@ namespace GeographicLib {
      * @param[in] z the height of the circle above the equatorial plane.
      * @param[in] gradp if true the returned object will be able to compute the
      *   gradient of the sum.
+     * @param[in] nthreads the number of threads to use in the construction
+     *   of the CircularEngine (default 1); see SphericalEngine::Circle.
      * @exception std::bad_alloc if the memory for the CircularEngine can't be
      *   allocated.
      * @return the CircularEngine object.
@@ -321,23 +413,65 @@ namespace GeographicLib {
      }
      \endcode
      **********************************************************************/
-    CircularEngine Circle(real p, real z, bool gradp) const {
+    CircularEngine Circle(real p, real z, bool gradp, int nthreads = 1)
+      const {
       real f[] = {1};
       switch (_norm) {
       case FULL:
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
+        break;
+      }
+    }
+
+    /**
+     * Create CircularEngine objects for several circles.
+     *
+     * @param[in] n the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles above the equatorial
+     *   plane.
+     * @param[in] gradp if true the returned objects will be able to compute
+     *   the gradient of the sum.
+     * @param[out] circ array of \e n CircularEngine objects.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * The results are identical to calling SphericalHarmonic::Circle for each
+     * circle in turn; however, the coefficients are traversed once for
+     * several circles; see SphericalEngine::Circles.
+     **********************************************************************/
+    void Circles(int n, const real p[], const real z[], bool gradp,
+                 CircularEngine circ[], int nthreads = 1) const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::FULL, 1>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::FULL, 1>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        break;
+      case SCHMIDT:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, p, z, _a, circ, nthreads);
         break;
       }
     }
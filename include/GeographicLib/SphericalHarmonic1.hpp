@@ -153,6 +153,39 @@ namespace GeographicLib {
       _c[1] = SphericalEngine::coeff(C1, S1, N1, nmx1, mmx1);
     }
 
+    /**
+     * Constructor with SphericalEngine::coeff objects.
+     *
+     * @param[in] c the coefficients <i>C</i><sub><i>nm</i></sub> and
+     *   <i>S</i><sub><i>nm</i></sub>.
+     * @param[in] c1 the coefficients <i>C'</i><sub><i>nm</i></sub> and
+     *   <i>S'</i><sub><i>nm</i></sub>.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic1::FULL (the default) or
+     *   SphericalHarmonic1::SCHMIDT.
+     * @exception GeographicErr if the maximum degree or order of \e c1
+     *   exceeds that of \e c.
+     *
+     * This allows the coefficients to be given in the interleaved layout
+     * produced by SphericalEngine::coeff::pack; see
+     * SphericalHarmonic::SphericalHarmonic(const SphericalEngine::coeff&,
+     * real, unsigned).
+     **********************************************************************/
+    SphericalHarmonic1(const SphericalEngine::coeff& c,
+                       const SphericalEngine::coeff& c1,
+                       real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm) {
+      if (!(c1.nmx() <= c.nmx()))
+        throw GeographicErr("nmx1 cannot be larger that nmx");
+      if (!(c1.mmx() <= c.mmx()))
+        throw GeographicErr("mmx1 cannot be larger that mmx");
+      _c[0] = c;
+      _c[1] = c1;
+    }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
@@ -224,6 +257,73 @@ namespace GeographicLib {
       return v;
     }
 
+    /**
+     * Compute a spherical harmonic sum with a correction term at several
+     * points.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     *
+     * The results are identical to calling SphericalHarmonic1::operator()()
+     * for each point in turn; see SphericalHarmonic::operator()(int, const
+     * real[], const real[], const real[], real[]) const.  This routine
+     * requires constant memory and thus never throws an exception.
+     **********************************************************************/
+    void operator()(real tau, int n,
+                    const real x[], const real y[], const real z[],
+                    real v[]) const {
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::Value<false, SphericalEngine::FULL, 2>
+          (_c, f, n, x, y, z, _a, v, 0, 0, 0);
+        break;
+      case SCHMIDT:
+        SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 2>
+          (_c, f, n, x, y, z, _a, v, 0, 0, 0);
+        break;
+      }
+    }
+
+    /**
+     * Compute a spherical harmonic sum with a correction term and its
+     * gradient at several points.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This is the same as the previous function, except that the gradients
+     * are computed.  This routine requires constant memory and thus never
+     * throws an exception.
+     **********************************************************************/
+    void operator()(real tau, int n,
+                    const real x[], const real y[], const real z[],
+                    real v[], real gradx[], real grady[], real gradz[])
+      const {
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        SphericalEngine::Value<true, SphericalEngine::FULL, 2>
+          (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      case SCHMIDT:
+        SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
+          (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude at a fixed value of \e tau.
@@ -233,6 +333,8 @@ namespace GeographicLib {
      * @param[in] z the height of the circle above the equatorial plane.
      * @param[in] gradp if true the returned object will be able to compute the
      *   gradient of the sum.
+     * @param[in] nthreads the number of threads to use in the construction
+     *   of the CircularEngine (default 1); see SphericalEngine::Circle.
      * @exception std::bad_alloc if the memory for the CircularEngine can't be
      *   allocated.
      * @return the CircularEngine object.
@@ -248,23 +350,66 @@ namespace GeographicLib {
      *
      * See SphericalHarmonic::Circle for an example of its use.
      **********************************************************************/
-    CircularEngine Circle(real tau, real p, real z, bool gradp) const {
+    CircularEngine Circle(real tau, real p, real z, bool gradp,
+                          int nthreads = 1) const {
       real f[] = {1, tau};
       switch (_norm) {
       case FULL:
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
+        break;
+      }
+    }
+
+    /**
+     * Create CircularEngine objects for several circles.
+     *
+     * @param[in] tau the multiplier for the correction coefficients.
+     * @param[in] n the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles above the equatorial
+     *   plane.
+     * @param[in] gradp if true the returned objects will be able to compute
+     *   the gradient of the sum.
+     * @param[out] circ array of \e n CircularEngine objects.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * The results are identical to calling SphericalHarmonic1::Circle for each
+     * circle in turn; however, the coefficients are traversed once for
+     * several circles; see SphericalEngine::Circles.
+     **********************************************************************/
+    void Circles(real tau, int n, const real p[], const real z[], bool gradp,
+                 CircularEngine circ[], int nthreads = 1) const {
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::FULL, 2>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::FULL, 2>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        break;
+      case SCHMIDT:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, p, z, _a, circ, nthreads);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, p, z, _a, circ, nthreads);
         break;
       }
     }
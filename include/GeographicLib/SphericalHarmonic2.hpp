@@ -261,6 +261,8 @@ namespace GeographicLib {
      * @param[in] z the height of the circle above the equatorial plane.
      * @param[in] gradp if true the returned object will be able to compute the
      *   gradient of the sum.
+     * @param[in] nthreads the number of threads to use in the construction
+     *   of the CircularEngine (default 1); see SphericalEngine::Circle.
      * @exception std::bad_alloc if the memory for the CircularEngine can't be
      *   allocated.
      * @return the CircularEngine object.
@@ -276,24 +278,25 @@ namespace GeographicLib {
      *
      * See SphericalHarmonic::Circle for an example of its use.
      **********************************************************************/
-    CircularEngine Circle(real tau1, real tau2, real p, real z, bool gradp)
+    CircularEngine Circle(real tau1, real tau2, real p, real z, bool gradp,
+                          int nthreads = 1)
       const {
       real f[] = {1, tau1, tau2};
       switch (_norm) {
       case FULL:
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::FULL, 3>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::FULL, 3>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 3>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, nthreads);
         break;
       }
     }
@@ -14,8 +14,9 @@
 
 #if !defined(GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER)
 /**
- * The order of the series approximation used in TransverseMercator.
- * GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER can be set to any integer in [4, 8].
+ * The default order of the series approximation used in TransverseMercator.
+ * GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER can be set to any integer in [4,
+ * 12].
  **********************************************************************/
 #  define GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER \
   (GEOGRAPHICLIB_PRECISION == 2 ? 6 : \
@@ -80,12 +81,40 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT TransverseMercator {
   private:
     typedef Math::real real;
-    static const int maxpow_ = GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER;
+    static const int maxpow_ = 12; // the maximum order of the series
     static const int numit_ = 5;
     real _a, _f, _k0, _e2, _es, _e2m,  _c, _n;
+    int _order;                 // the order of the series used
     // _alp[0] and _bet[0] unused
     real _a1, _b1, _alp[maxpow_ + 1], _bet[maxpow_ + 1];
     friend class Ellipsoid;           // For access to taupf, tauf.
+    // The number of points processed together by the array versions of
+    // Forward and Reverse.
+    static const int nblock_ = 8;
+    // Sum the series in Forward (sgn = 1, c = _alp) or Reverse (sgn = -1, c =
+    // _bet) for m <= nblock_ points; zetar and zetai are full arrays of
+    // length nblock_ (only the first m elements are used).  On output zetar
+    // and zetai are transformed, and, if gkp, yr and yi give the derivative.
+    void Clenshaw(int m, real sgn, const real c[], bool gkp,
+                  real zetar[], real zetai[], real yr[], real yi[]) const;
+    // The array versions of Forward and Reverse for the points [i0, i1).
+    void ForwardRange(real lon0, const real* lat, const real* lon,
+                      size_t i0, size_t i1,
+                      real* x, real* y, real* gamma, real* k) const;
+    void ReverseRange(real lon0, const real* x, const real* y,
+                      size_t i0, size_t i1,
+                      real* lat, real* lon, real* gamma, real* k) const;
+#if GEOGRAPHICLIB_PRECISION != 1
+    // The float versions of the array Forward and Reverse truncate the series
+    // at the order used for GEOGRAPHICLIB_PRECISION = 1 and process twice as
+    // many points at a time.
+    static const int floatpow_ = 4;
+    static const int nblockf_ = 2 * nblock_;
+    float _alpf[floatpow_ + 1], _betf[floatpow_ + 1];
+    void ClenshawF(int m, float sgn, const float c[], bool gkp,
+                   float zetar[], float zetai[], float yr[], float yi[])
+      const;
+#endif
   public:
 
     /**
@@ -96,10 +125,30 @@ namespace GeographicLib {
      *   Negative \e f gives a prolate ellipsoid.  If \e f &gt; 1, set
      *   flattening to 1/\e f.
      * @param[in] k0 central scale factor.
+     * @param[in] order the order of the series (default
+     *   GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER).
      * @exception GeographicErr if \e a, (1 &minus; \e f) \e a, or \e k0 is
      *   not positive.
+     * @exception GeographicErr if \e order is not in [4, 12].
+     *
+     * The error in the series grows with distance from the central
+     * meridian; increasing \e order reduces it.  For the WGS84 ellipsoid
+     * and |\e lat| &lt; 85&deg;, the maximum errors (compared with
+     * TransverseMercatorExact) for points within 10&deg;, 35&deg;, 60&deg;,
+     * and 70&deg; of the central meridian are
+     * - \e order = 4: 0.2 &mu;m, 6 &mu;m, 8 mm, 0.6 m;
+     * - \e order = 6: 8 nm, 8 nm, 11 &mu;m, 4 mm;
+     * - \e order = 8: 8 nm, 8 nm, 21 nm, 31 &mu;m;
+     * - \e order = 12: 8 nm, 8 nm, 8 nm, 13 nm.
+     * .
+     * Thus a low order suffices for the UTM zones while \e order = 12 is
+     * accurate over a much wider region.  The time to compute the projection
+     * depends only weakly on \e order (it is dominated by the evaluation of
+     * the transcendental functions); with any order, it is about 5 times
+     * faster than TransverseMercatorExact.
      **********************************************************************/
-    TransverseMercator(real a, real f, real k0);
+    TransverseMercator(real a, real f, real k0,
+                       int order = GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER);
 
     /**
      * Forward projection, from geographic to transverse Mercator.
@@ -155,6 +204,180 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling TransverseMercator::Forward for
+     * each point.  The points are processed in blocks so that the summation
+     * of the series for the points in a block can be vectorized by the
+     * compiler.  If \e gamma and \e k are both null pointers (the default),
+     * the convergence and scale are not computed; this saves about 25% of
+     * the time.
+     *
+     * The points are divided into \e nthreads contiguous ranges of whole
+     * blocks which are projected by Executor::Default() (concurrently, if
+     * the executor permits).  If the library is compiled without C++11, all
+     * the work is done by the calling thread; in any case, the results do
+     * not depend on \e nthreads.
+     **********************************************************************/
+    void Forward(real lon0, const real* lat, const real* lon, size_t n,
+                 real* x, real* y, real* gamma = 0, real* k = 0,
+                 int nthreads = 1) const;
+
+    /**
+     * Forward projection of a single point with several central meridians.
+     *
+     * @param[in] lon0 array of central meridians (degrees).
+     * @param[in] nz the number of central meridians.
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[out] x array of eastings of the point (meters).
+     * @param[out] y array of northings of the point (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     *
+     * Element \e j of the output arrays gives the projection with central
+     * meridian \e lon0[\e j] and the results are identical to those given by
+     * TransverseMercator::Forward.  This is useful for finding the
+     * coordinates of a point in several adjacent UTM zones; the quantities
+     * which depend on the latitude alone (e.g., the conformal latitude) are
+     * only computed once.  If \e gamma and \e k are both null pointers (the
+     * default), the convergence and scale are not computed.
+     **********************************************************************/
+    void Forward(const real* lon0, size_t nz, real lat, real lon,
+                 real* x, real* y, real* gamma = 0, real* k = 0) const;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to calling TransverseMercator::Reverse for
+     * each point.  If \e gamma and \e k are both null pointers (the
+     * default), the convergence and scale are not computed; this saves about
+     * 20% of the time.  The points are divided between \e nthreads threads
+     * as for the array version of TransverseMercator::Forward.
+     **********************************************************************/
+    void Reverse(real lon0, const real* x, const real* y, size_t n,
+                 real* lat, real* lon, real* gamma = 0, real* k = 0,
+                 int nthreads = 1) const;
+
+#if GEOGRAPHICLIB_PRECISION != 1
+    /**
+     * Forward projection of many points in single precision.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     *
+     * This is the same as the array version of TransverseMercator::Forward
+     * except that the arithmetic is carried out with floats and the series
+     * are truncated at 4th order (as they are when the library is compiled
+     * with GEOGRAPHICLIB_PRECISION = 1).  The errors are dominated by the
+     * roundoff in the floats; within 50&deg; of the central meridian, the
+     * error in the position is less than 3 m (about 2 units in the last
+     * place for a northing of 10<sup>7</sup> m),
+     * the error in \e gamma is less than 10<sup>&minus;5</sup>&deg;, and the
+     * relative error in \e k is less than 10<sup>&minus;6</sup>.  The
+     * summation of the series, which is vectorized, handles twice as many
+     * points per vector and the other float functions are also faster; so
+     * this is typically 1.2 to 1.8 times faster than the double version.
+     * This function is not available when the library is compiled with
+     * GEOGRAPHICLIB_PRECISION = 1 (in which case the double version uses
+     * floats).
+     **********************************************************************/
+    void Forward(real lon0, const float* lat, const float* lon, size_t n,
+                 float* x, float* y, float* gamma = 0, float* k = 0) const;
+
+    /**
+     * Reverse projection of many points in single precision.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     *
+     * See the float version of TransverseMercator::Forward.  The error in
+     * the position is less than 3 m within 50&deg; of the central
+     * meridian.
+     **********************************************************************/
+    void Reverse(real lon0, const float* x, const float* y, size_t n,
+                 float* lat, float* lon, float* gamma = 0, float* k = 0)
+      const;
+#endif
+
+    /**
+     * Transfer many points from one central meridian to another.
+     *
+     * @param[in] lon0in central meridian of the input coordinates (degrees).
+     * @param[in] xin array of input eastings (meters).
+     * @param[in] yin array of input northings (meters).
+     * @param[in] n the number of points.
+     * @param[in] lon0out central meridian of the output coordinates
+     *   (degrees).
+     * @param[out] xout array of output eastings (meters).
+     * @param[out] yout array of output northings (meters).
+     *
+     * This is equivalent to TransverseMercator::Reverse with \e lon0in
+     * followed by TransverseMercator::Forward with \e lon0out, e.g., to
+     * convert between UTM zones (after removing the false easting and
+     * northing).  However the geographic coordinates are not formed: the
+     * reverse series gives the conformal latitude and the sine and cosine of
+     * the longitude relative to \e lon0in; the longitude is rotated to \e
+     * lon0out and these are fed directly to the forward series.  This avoids
+     * the conversions between the geographic and the conformal latitudes
+     * (Math::tauf and Math::taupf) and the conversions to and from degrees.
+     * The results agree with those of Reverse followed by Forward to within
+     * roundoff.  The output arrays may be the same as the input arrays.
+     **********************************************************************/
+    void Transfer(real lon0in, const real* xin, const real* yin, size_t n,
+                  real lon0out, real* xout, real* yout) const;
+
+    /**
+     * Transfer a single point from one central meridian to another.
+     *
+     * @param[in] lon0in central meridian of the input coordinates (degrees).
+     * @param[in] xin input easting (meters).
+     * @param[in] yin input northing (meters).
+     * @param[in] lon0out central meridian of the output coordinates
+     *   (degrees).
+     * @param[out] xout output easting (meters).
+     * @param[out] yout output northing (meters).
+     *
+     * See the documentation for the array version of
+     * TransverseMercator::Transfer.
+     **********************************************************************/
+    void Transfer(real lon0in, real xin, real yin, real lon0out,
+                  real& xout, real& yout) const
+    { Transfer(lon0in, &xin, &yin, 1, lon0out, &xout, &yout); }
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -183,6 +406,12 @@ namespace GeographicLib {
      *   k0 used in the constructor and is the scale on the central meridian.
      **********************************************************************/
     Math::real CentralScale() const { return _k0; }
+
+    /**
+     * @return the order of the series.  This is the value used in the
+     *   constructor.
+     **********************************************************************/
+    int Order() const { return _order; }
     ///@}
 
     /**
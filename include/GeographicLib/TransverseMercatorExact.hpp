@@ -80,7 +80,7 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     static const int numit_ = 10;
-    real tol_, tol1_, tol2_, taytol_;
+    real tol_, tol1_, tol2_, taytol_, warmtol_;
     real _a, _f, _k0, _mu, _mv, _e;
     bool _extendp;
     EllipticFunction _Eu, _Ev;
@@ -99,8 +99,18 @@ namespace GeographicLib {
                  real v, real snv, real cnv, real dnv,
                  real& du, real& dv) const;
 
+    // The state carried from one point to the next by the array versions of
+    // Forward and Reverse: the solution (u, v) for the target (a, b) and the
+    // derivative (du, dv) of w with respect to the target.
+    struct Guess {
+      bool valid;
+      real a, b, u, v, du, dv;
+    };
+
     bool zetainv0(real psi, real lam, real& u, real& v) const;
-    void zetainv(real taup, real lam, real& u, real& v) const;
+    int zetainv(real taup, real lam, real& u, real& v, Guess* g = 0) const;
+    int zetanewton(real taup, real lam, real psi, real scal,
+                   real& u, real& v, Guess* g) const;
 
     void sigma(real u, real snu, real cnu, real dnu,
                real v, real snv, real cnv, real dnv,
@@ -111,13 +121,21 @@ namespace GeographicLib {
                   real& du, real& dv) const;
 
     bool sigmainv0(real xi, real eta, real& u, real& v) const;
-    void sigmainv(real xi, real eta, real& u, real& v) const;
+    int sigmainv(real xi, real eta, real& u, real& v, Guess* g = 0) const;
+    int sigmanewton(real xi, real eta, real& u, real& v, Guess* g) const;
 
     void Scale(real tau, real lam,
                real snu, real cnu, real dnu,
                real snv, real cnv, real dnv,
                real& gamma, real& k) const;
 
+    int GenForward(real lon0, real lat, real lon,
+                   real& x, real& y, real& gamma, real& k,
+                   bool scalep, Guess* g) const;
+    int GenReverse(real lon0, real x, real y,
+                   real& lat, real& lon, real& gamma, real& k,
+                   bool scalep, Guess* g) const;
+
   public:
 
     /**
@@ -228,6 +246,57 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     * @return the total number of Newton iterations.
+     *
+     * The projection requires the inversion of an elliptic function by
+     * Newton's method; normally this takes about 4 iterations.  Here the
+     * iteration for each point is started by extrapolating from the
+     * solution for the previous point, provided that the two points are
+     * close to one another and away from the branch point.  For spatially
+     * coherent input (e.g., sorted points or the points in a LiDAR scan) this
+     * reduces the number of iterations to about 2; otherwise the usual
+     * starting point is used.  The returned count (summed over all the
+     * points) measures how effective this is.  The results agree with those
+     * given by TransverseMercatorExact::Forward to round-off (about 10
+     * nanometers).  If \e gamma and \e k are both null pointers (the
+     * default), the convergence and scale are not computed.
+     **********************************************************************/
+    size_t Forward(real lon0, const real* lat, const real* lon, size_t n,
+                   real* x, real* y, real* gamma = 0, real* k = 0) const;
+
+    /**
+     * Reverse projection of many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[in] n the number of points.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of the projection.
+     * @return the total number of Newton iterations.
+     *
+     * The Newton iterations are warm started as described for the array
+     * version of TransverseMercatorExact::Forward.  The results agree with
+     * those given by TransverseMercatorExact::Reverse to round-off.  If \e
+     * gamma and \e k are both null pointers (the default), the convergence
+     * and scale are not computed.
+     **********************************************************************/
+    size_t Reverse(real lon0, const real* x, const real* y, size_t n,
+                   real* lat, real* lon, real* gamma = 0, real* k = 0) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -89,11 +89,47 @@ namespace GeographicLib {
     static const int epsgS   = 32761; // EPSG code for UPS   S
     static real CentralMeridian(int zone)
     { return real(6 * zone - 183); }
-    static void CheckLatLon(real lat, real lon);
+    // Throw an error if lat or lon is out of range.  If throwp = false,
+    // return bool instead.
+    static bool CheckLatLon(real lat, real lon, bool throwp = true);
     // Throw an error if easting or northing are outside standard ranges.  If
     // throwp = false, return bool instead.
     static bool CheckCoords(bool utmp, bool northp, real x, real y,
                             bool msgrlimits = false, bool throwp = true);
+    // Versions of Forward, Reverse, and DecodeZone which, if throwp = false,
+    // return a status code instead of throwing an exception.
+    static int Forward(real lat, real lon,
+                       int& zone, bool& northp, real& x, real& y,
+                       real& gamma, real& k,
+                       int setzone, bool mgrslimits, bool throwp);
+    static int Reverse(int zone, bool northp, real x, real y,
+                       real& lat, real& lon, real& gamma, real& k,
+                       bool mgrslimits, bool throwp);
+    static int DecodeZone(const std::string& zonestr, int& zone, bool& northp,
+                          bool throwp);
+    // Project a run of nr points in UTM zone zone (for ForwardBatch).
+    static int ForwardUTMRun(int zone, const real blat[], const real blon[],
+                             const bool bnorth[], const size_t bind[], int nr,
+                             bool mgrslimits,
+                             int zonev[], bool northpv[], real x[], real y[],
+                             real gamma[], real k[], int err[]);
+    // Project a point into nr UTM zones (for ForwardZones).
+    static int ForwardZonesRun(real lat, real lon, bool northp,
+                               const int bzone[], const size_t bind[], int nr,
+                               bool mgrslimits,
+                               int zonev[], real x[], real y[],
+                               real gamma[], real k[], int err[]);
+    static const int nbatch_ = 64; // Size of runs for ForwardBatch, etc.
+    // Throw an error for an illegal zone passed to StandardZone.
+    static void IllegalZone(int setzone);
+    // The MGRS latitude band for lat; this duplicates MGRS::LatitudeBand
+    // (MGRS.hpp includes this file) so that StandardZone can be inlined.
+    static int LatitudeBand(real lat) {
+      using std::floor;
+      int ilat = int(floor(lat));
+      return (std::max)(-10, (std::min)(9, (ilat + 80)/8 - 10));
+    }
+    friend class GeoCoords;     // GeoCoords::Reset uses the throwp versions
     UTMUPS();                   // Disable constructor
 
   public:
@@ -163,6 +199,34 @@ namespace GeographicLib {
       MAXZONE = 60,
     };
 
+    /**
+     * The status codes returned by UTMUPS::TryForward, UTMUPS::TryReverse,
+     * UTMUPS::TryDecodeZone, and UTMUPS::ForwardBatch.
+     **********************************************************************/
+    enum status {
+      /**
+       * The conversion succeeded (or the zone is UTMUPS::INVALID because an
+       * input is a NaN).
+       **********************************************************************/
+      OK = 0,
+      /**
+       * \e lat is not in [&minus;90&deg;, 90&deg;] or \e lon is not in
+       * [&minus;540&deg;, 540&deg;).
+       **********************************************************************/
+      BADLATLON = 1,
+      /**
+       * The zone is illegal (or malformed), the point is more than 60&deg;
+       * in longitude from the center of the UTM zone, or it is more than
+       * 20&deg; from the pole for UPS.
+       **********************************************************************/
+      BADZONE = 2,
+      /**
+       * The easting or northing is out of the allowed range (see
+       * UTMUPS::Reverse).
+       **********************************************************************/
+      BADCOORDS = 3,
+    };
+
     /**
      * The standard zone.
      *
@@ -177,7 +241,31 @@ namespace GeographicLib {
      *
      * This is exact.
      **********************************************************************/
-    static int StandardZone(real lat, real lon, int setzone = STANDARD);
+    static int StandardZone(real lat, real lon, int setzone = STANDARD) {
+      using std::floor;
+      if (!(setzone >= MINPSEUDOZONE && setzone <= MAXZONE))
+        IllegalZone(setzone);
+      if (setzone >= MINZONE || setzone == INVALID)
+        return setzone;
+      if (Math::isnan(lat) || Math::isnan(lon)) // Check if lat or lon is a NaN
+        return INVALID;
+      if (setzone == UTM || (lat >= -80 && lat < 84)) {
+        // Assume lon is in [-540, 540).
+        int ilon = int(floor(lon));
+        if (ilon >= 180)
+          ilon -= 360;
+        else if (ilon < -180)
+          ilon += 360;
+        int zone = (ilon + 186)/6;
+        int band = LatitudeBand(lat);
+        if (band == 7 && zone == 31 && ilon >= 3)
+          zone = 32;
+        else if (band == 9 && ilon >= 0 && ilon < 42)
+          zone = 2 * ((ilon + 183)/12) + 1;
+        return zone;
+      } else
+        return UPS;
+    }
 
     /**
      * Forward projection, from geographic to UTM/UPS.
@@ -276,6 +364,116 @@ namespace GeographicLib {
       Forward(lat, lon, zone, northp, x, y, gamma, k, setzone, mgrslimits);
     }
 
+    /**
+     * Forward projection of an array of points, from geographic to UTM/UPS.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     * @param[out] err array of status codes, one of UTMUPS::status.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if \e setzone is outside the range
+     *   [UTMUPS::MINPSEUDOZONE, UTMUPS::MAXZONE] = [&minus;4, 60].
+     * @return the number of points which could not be converted.
+     *
+     * This is equivalent to calling UTMUPS::Forward for each point, except
+     * that an error for a particular point does not throw an exception;
+     * instead \e zone is set to UTMUPS::INVALID, \e x, \e y, \e gamma, and
+     * \e k are set to NaN, and the reason is recorded in \e err.  The
+     * results for the other points are identical to those returned by
+     * UTMUPS::Forward.  \e gamma, \e k, and \e err may be null pointers, in
+     * which case these quantities are not returned (skipping \e gamma and \e
+     * k saves time).
+     *
+     * Consecutive points lying in the same UTM zone are converted together by
+     * the array version of TransverseMercator::Forward.  Thus this routine is
+     * most efficient when the points are ordered so that neighboring points
+     * usually share a zone, e.g., points along a track.
+     **********************************************************************/
+    static size_t ForwardBatch(const real* lat, const real* lon, size_t n,
+                               int* zone, bool* northp, real* x, real* y,
+                               real* gamma = 0, real* k = 0, int* err = 0,
+                               int setzone = STANDARD,
+                               bool mgrslimits = false);
+
+    /**
+     * Forward projection of a single point into several zones.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] setzone array of zone overrides.
+     * @param[in] nz the number of zones.
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] gamma array of meridian convergences (degrees).
+     * @param[out] k array of scales of projection.
+     * @param[out] err array of status codes, one of UTMUPS::status.
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if any \e setzone is outside the range
+     *   [UTMUPS::MINPSEUDOZONE, UTMUPS::MAXZONE] = [&minus;4, 60].
+     * @return the number of zones into which the point could not be
+     *   converted.
+     *
+     * Element \e j of the output arrays is the result of UTMUPS::Forward with
+     * \e setzone[\e j] as the zone override; typically the elements of \e
+     * setzone will be a few adjacent UTM zones (for points near a zone
+     * boundary), possibly together with UTMUPS::STANDARD.  Errors are
+     * treated as in UTMUPS::ForwardBatch.  The UTM projections are computed
+     * together by the multiple central meridian version of
+     * TransverseMercator::Forward so that the work which depends only on the
+     * latitude is shared.  \e gamma, \e k, and \e err may be null pointers.
+     **********************************************************************/
+    static size_t ForwardZones(real lat, real lon,
+                               const int* setzone, size_t nz,
+                               int* zone, bool& northp, real* x, real* y,
+                               real* gamma = 0, real* k = 0, int* err = 0,
+                               bool mgrslimits = false);
+
+    /**
+     * Forward projection of an array of points into several zones.
+     *
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] n the number of points.
+     * @param[in] setzone array of zone overrides.
+     * @param[in] nz the number of zones.
+     * @param[out] zone array of \e n \e nz UTM zones (zero means UPS).
+     * @param[out] northp array of \e n hemispheres (true means north, false
+     *   means south).
+     * @param[out] x array of \e n \e nz eastings (meters).
+     * @param[out] y array of \e n \e nz northings (meters).
+     * @param[out] gamma array of \e n \e nz meridian convergences (degrees).
+     * @param[out] k array of \e n \e nz scales of projection.
+     * @param[out] err array of \e n \e nz status codes.
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if any \e setzone is outside the range
+     *   [UTMUPS::MINPSEUDOZONE, UTMUPS::MAXZONE] = [&minus;4, 60].
+     * @return the total number of failed conversions.
+     *
+     * This calls UTMUPS::ForwardZones for each point; the results for point
+     * \e i and zone override \e j are stored in element \e i \e nz + \e j
+     * of the output arrays (except for \e northp).
+     **********************************************************************/
+    static size_t ForwardZonesBatch(const real* lat, const real* lon, size_t n,
+                                    const int* setzone, size_t nz,
+                                    int* zone, bool* northp,
+                                    real* x, real* y,
+                                    real* gamma = 0, real* k = 0,
+                                    int* err = 0, bool mgrslimits = false);
+
     /**
      * UTMUPS::Reverse without returning convergence and scale.
      **********************************************************************/
@@ -285,6 +483,64 @@ namespace GeographicLib {
       Reverse(zone, northp, x, y, lat, lon, gamma, k, mgrslimits);
     }
 
+    /**
+     * UTMUPS::Forward returning a status code instead of throwing an
+     * exception.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[out] zone the UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] gamma meridian convergence at point (degrees).
+     * @param[out] k scale of projection at point.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @return UTMUPS::OK on success, otherwise one of the other
+     *   UTMUPS::status codes; in this case, the output arguments are
+     *   unchanged.
+     *
+     * This does not throw an exception and no memory is allocated on the
+     * failure path, so it is suitable for processing data in which bad
+     * points are common.  The results are otherwise identical to those of
+     * UTMUPS::Forward.
+     **********************************************************************/
+    static int TryForward(real lat, real lon,
+                          int& zone, bool& northp, real& x, real& y,
+                          real& gamma, real& k,
+                          int setzone = STANDARD, bool mgrslimits = false) {
+      return Forward(lat, lon, zone, northp, x, y, gamma, k,
+                     setzone, mgrslimits, false);
+    }
+
+    /**
+     * UTMUPS::Reverse returning a status code instead of throwing an
+     * exception.
+     *
+     * @param[in] zone the UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[out] gamma meridian convergence at point (degrees).
+     * @param[out] k scale of projection at point.
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @return UTMUPS::OK on success, otherwise UTMUPS::BADZONE or
+     *   UTMUPS::BADCOORDS; in this case, the output arguments are unchanged.
+     *
+     * This does not throw an exception (see UTMUPS::TryForward).
+     **********************************************************************/
+    static int TryReverse(int zone, bool northp, real x, real y,
+                          real& lat, real& lon, real& gamma, real& k,
+                          bool mgrslimits = false) {
+      return Reverse(zone, northp, x, y, lat, lon, gamma, k,
+                     mgrslimits, false);
+    }
+
     /**
      * Transfer UTM/UPS coordinated from one zone to another.
      *
@@ -342,6 +598,20 @@ namespace GeographicLib {
      **********************************************************************/
     static void DecodeZone(const std::string& zonestr, int& zone, bool& northp);
 
+    /**
+     * UTMUPS::DecodeZone returning a status code instead of throwing an
+     * exception.
+     *
+     * @param[in] zonestr string representation of zone and hemisphere.
+     * @param[out] zone the UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @return UTMUPS::OK on success, otherwise UTMUPS::BADZONE; in this case,
+     *   the output arguments are unchanged.
+     **********************************************************************/
+    static int TryDecodeZone(const std::string& zonestr,
+                             int& zone, bool& northp)
+    { return DecodeZone(zonestr, zone, northp, false); }
+
     /**
      * Encode a UTM/UPS zone string.
      *
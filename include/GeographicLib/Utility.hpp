@@ -15,6 +15,7 @@
 #include <vector>
 #include <sstream>
 #include <cctype>
+#include <cstring>
 #include <ctime>
 
 #if defined(_MSC_VER)
@@ -23,6 +24,14 @@
 #  pragma warning (disable: 4127 4996)
 #endif
 
+#if !defined(GEOGRAPHICLIB_READARRAY_CHUNK)
+/**
+ * The number of bytes read at a time by Utility::readarray when the data
+ * needs to be byte-swapped or converted to a different type.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_READARRAY_CHUNK 65536
+#endif
+
 namespace GeographicLib {
 
   /**
@@ -45,6 +54,31 @@ namespace GeographicLib {
     static bool gregorian(int s) {
       return s >= 639799;       // 1752-09-14
     }
+    // The size of the buffers used for converting numbers to strings
+    static const int strbuf_ = 64;
+    static int intstr(char buf[], unsigned long long n, bool neg);
+    static std::string streamstr(Math::real x, int p);
+    template<typename T> static T streamnum(const std::string& s) {
+      T x;
+      std::string errmsg;
+      do {                     // Executed once (provides the ability to break)
+        std::istringstream is(s);
+        if (!(is >> x)) {
+          errmsg = "Cannot decode " + s;
+          break;
+        }
+        int pos = int(is.tellg()); // Returns -1 at end of string?
+        if (!(pos < 0 || pos == int(s.size()))) {
+          errmsg = "Extra text " + s.substr(pos) + " at end of " + s;
+          break;
+        }
+        return x;
+      } while (false);
+      x = std::numeric_limits<T>::is_integer ? 0 : nummatch<T>(s);
+      if (x == 0)
+        throw GeographicErr(errmsg);
+      return x;
+    }
   public:
 
     /**
@@ -272,8 +306,19 @@ namespace GeographicLib {
      *
      * If \e p &ge; 0, then the number fixed format is used with p bits of
      * precision.  With p < 0, there is no manipulation of the format.
+     * Integers (other than bool and the character types) are converted
+     * directly without using an ostringstream.
      **********************************************************************/
     template<typename T> static std::string str(T x, int p = -1) {
+      if (std::numeric_limits<T>::is_integer && sizeof(T) > 1) {
+        // x < 1 && x != 0 instead of x < 0 to avoid warnings about a
+        // comparison which is always false for unsigned types.
+        bool neg = x < T(1) && x != T(0);
+        char buf[strbuf_];
+        int n = intstr(buf, neg ? 0ULL - (unsigned long long)(x) :
+                       (unsigned long long)(x), neg);
+        return std::string(buf, n);
+      }
       std::ostringstream s;
       if (p >= 0) s << std::fixed << std::setprecision(p);
       s << x; return s.str();
@@ -289,30 +334,77 @@ namespace GeographicLib {
      *
      * If \e p &ge; 0, then the number fixed format is used with p bits of
      * precision.  With p < 0, there is no manipulation of the format.  This is
-     * an overload of str<T> which deals with inf and nan.
+     * an overload of str<T> which deals with inf and nan.  The conversion is
+     * done by Utility::str(char[], size_t, Math::real, int); the result does
+     * not depend on the locale.
      **********************************************************************/
     static std::string str(Math::real x, int p = -1) {
-      if (!Math::isfinite(x))
-        return x < 0 ? std::string("-inf") :
-          (x > 0 ? std::string("inf") : std::string("nan"));
-      std::ostringstream s;
-#if GEOGRAPHICLIB_PRECISION == 4
-      // boost-quadmath treats precision == 0 as "use as many digits as
-      // necessary", so...
-      using std::floor;
-      if (p == 0) {
-        long long ix = (long long)(floor(x + Math::real(0.5)));
-        // Implement the "round ties to even" rule
-        if (Math::real(ix) == x + Math::real(0.5) && (ix % 2) == 1)
-          --ix;
-        s << ix;
-        return s.str();
-      }
-#endif
-      if (p >= 0) s << std::fixed << std::setprecision(p);
-      s << x; return s.str();
+      char buf[strbuf_];
+      int n = str(buf, strbuf_, x, p);
+      return n < strbuf_ ? std::string(buf, n) : streamstr(x, p);
     }
 
+    /**
+     * Convert a Math::real object to a string in a buffer.
+     *
+     * @param[out] buf the buffer for the result.
+     * @param[in] len the size of \e buf.
+     * @param[in] x the value to be converted.
+     * @param[in] p the precision used (default &minus;1).
+     * @return the length of the string representation.
+     *
+     * The string representation is the same as that given by
+     * Utility::str(Math::real, int).  At most \e len &minus; 1 characters
+     * are written to \e buf followed by a null character (if \e len > 0);
+     * the result has been truncated if the return value is \e len or more.
+     * If \e p &ge; 0 and |\e x| 10<sup>\e p</sup> < 2<sup>52</sup> (and
+     * \e p &le; 22 and Math::real is a double), the number is converted
+     * directly without using an ostringstream (and so without allocating
+     * memory and independent of the locale).  The result is correctly
+     * rounded with ties rounded to even; this matches the output of the GNU C
+     * library with the default rounding mode.
+     **********************************************************************/
+    static int str(char buf[], size_t len, Math::real x, int p = -1);
+
+    /**
+     * Convert a Math::real object to the shortest string which reads back
+     * to the same value.
+     *
+     * @param[in] x the value to be converted.
+     * @exception std::bad_alloc if memory for the string can't be allocated.
+     * @return the string representation.
+     **********************************************************************/
+    static std::string shortstr(Math::real x) {
+      char buf[strbuf_];
+      int n = shortstr(buf, strbuf_, x);
+      if (n < strbuf_)
+        return std::string(buf, n);
+      std::vector<char> b(n + 1);
+      shortstr(&b[0], b.size(), x);
+      return std::string(&b[0], n);
+    }
+
+    /**
+     * Convert a Math::real object to the shortest string which reads back
+     * to the same value in a buffer.
+     *
+     * @param[out] buf the buffer for the result.
+     * @param[in] len the size of \e buf.
+     * @param[in] x the value to be converted.
+     * @return the length of the string representation.
+     *
+     * The result is the fixed format representation of \e x with the fewest
+     * digits after the decimal point for which Utility::num<Math::real>
+     * returns \e x, e.g., 0.1 and 1234.5 are converted to "0.1" and
+     * "1234.5".  If Math::real is a double, this is found exactly (without
+     * using an ostringstream) provided that the result has at most 22 digits
+     * after the point and at most 19 digits in all.  Otherwise, the
+     * representation in the default (%g) format with the fewest significant
+     * digits is returned (e.g., 1e+300).  The handling of \e buf and \e len
+     * is the same as for Utility::str(char[], size_t, Math::real, int).
+     **********************************************************************/
+    static int shortstr(char buf[], size_t len, Math::real x);
+
     /**
      * Convert a string to an object of type T.
      *
@@ -320,27 +412,92 @@ namespace GeographicLib {
      * @param[in] s the string to be converted.
      * @exception GeographicErr is \e s is not readable as a T.
      * @return object of type T
+     *
+     * Plain decimal numbers are converted by Utility::plainnum; otherwise the
+     * string is read using an istringstream.
      **********************************************************************/
     template<typename T> static T num(const std::string& s) {
       T x;
-      std::string errmsg;
-      do {                     // Executed once (provides the ability to break)
-        std::istringstream is(s);
-        if (!(is >> x)) {
-          errmsg = "Cannot decode " + s;
-          break;
-        }
-        int pos = int(is.tellg()); // Returns -1 at end of string?
-        if (!(pos < 0 || pos == int(s.size()))) {
-          errmsg = "Extra text " + s.substr(pos) + " at end of " + s;
-          break;
-        }
-        return x;
-      } while (false);
-      x = std::numeric_limits<T>::is_integer ? 0 : nummatch<T>(s);
-      if (x == 0)
-        throw GeographicErr(errmsg);
-      return x;
+      return plainnum<T>(s.data(), s.size(), x) ? x : streamnum<T>(s);
+    }
+
+    /**
+     * Convert an array of characters to an object of type T.
+     *
+     * @tparam T the type of the return value.
+     * @param[in] s the start of the characters to be converted.
+     * @param[in] len the number of characters.
+     * @exception GeographicErr is \e s is not readable as a T.
+     * @return object of type T
+     *
+     * This is the same as Utility::num<T>(const std::string&) except that
+     * the string need not be null terminated and it is not copied unless it
+     * falls outside the form accepted by Utility::plainnum.
+     **********************************************************************/
+    template<typename T> static T num(const char* s, size_t len) {
+      T x;
+      return plainnum<T>(s, len, x) ? x : streamnum<T>(std::string(s, len));
+    }
+
+    /**
+     * Convert a plain decimal number to an object of type T.
+     *
+     * @tparam T the type of the result.
+     * @param[in] s the start of the characters to be converted.
+     * @param[in] len the number of characters.
+     * @param[out] x the result.
+     * @return whether \e s was converted.
+     *
+     * This recognizes [+-]ddd[.ddd] (without white space) provided that the
+     * number of digits is small enough for the result to be computed
+     * exactly: at most std::numeric_limits<T>::digits10 digits in the case
+     * of integers (and no fractional part), and at most that many
+     * significant digits and at most that many digits after the decimal
+     * point in the case of IEEE floating point types.  The result is the
+     * same as reading the number with an istringstream; however no memory is
+     * allocated and the result does not depend on the locale.  This returns
+     * false (and \e x is not set) if \e s is not of this form; use
+     * Utility::num<T> to handle such cases.
+     **********************************************************************/
+    template<typename T> static bool plainnum(const char* s, size_t len,
+                                              T& x) {
+      bool integer = std::numeric_limits<T>::is_integer;
+      if (!(integer ? sizeof(T) > 1 : std::numeric_limits<T>::is_iec559))
+        return false;
+      const int maxdigits = std::numeric_limits<T>::digits10;
+      size_t i = 0;
+      bool neg = false;
+      if (i < len && (s[i] == '-' || s[i] == '+')) {
+        neg = s[i] == '-';
+        if (neg && !std::numeric_limits<T>::is_signed)
+          return false;
+        ++i;
+      }
+      T mant = 0, scale = 1;
+      int sigdigits = 0, fracdigits = 0;
+      bool pointseen = false, digitseen = false;
+      for (; i < len; ++i) {
+        char c = s[i];
+        if (c >= '0' && c <= '9') {
+          digitseen = true;
+          if ((mant != 0 || c != '0') && ++sigdigits > maxdigits)
+            return false;
+          mant = T(10) * mant + T(c - '0');
+          if (pointseen) {
+            if (++fracdigits > maxdigits)
+              return false;
+            scale *= T(10);
+          }
+        } else if (c == '.' && !pointseen && !integer)
+          pointseen = true;
+        else
+          return false;
+      }
+      if (!digitseen)
+        return false;
+      x = mant / scale;
+      if (neg) x = -x;
+      return true;
     }
 
     /**
@@ -407,6 +564,22 @@ namespace GeographicLib {
       return r == std::string::npos ? -1 : int(r);
     }
 
+    /**
+     * Lookup up a character in a C string.
+     *
+     * @param[in] s the null-terminated string to be searched.
+     * @param[in] c the character to look for.
+     * @return the index of the first occurrence character in the string or
+     *   &minus;1 is the character is not present.
+     *
+     * This is the same as the other version of lookup.  The null character
+     * is never found.
+     **********************************************************************/
+    static int lookup(const char* s, char c) {
+      const char* r = c ? std::strchr(s, toupper(c)) : 0;
+      return r ? int(r - s) : -1;
+    }
+
     /**
      * Read data of type ExtT from a binary stream to an array of type IntT.
      * The data in the file is in (bigendp ? big : little)-endian format.
@@ -423,37 +596,49 @@ namespace GeographicLib {
     template<typename ExtT, typename IntT, bool bigendp>
       static inline void readarray(std::istream& str,
                                    IntT array[], size_t num) {
+      // read this many values at a time
+      const size_t bufsize =
+        (std::max)(size_t(GEOGRAPHICLIB_READARRAY_CHUNK) / sizeof(ExtT),
+                   size_t(1));
 #if GEOGRAPHICLIB_PRECISION < 4
       if (sizeof(IntT) == sizeof(ExtT) &&
           std::numeric_limits<IntT>::is_integer ==
           std::numeric_limits<ExtT>::is_integer)
         {
           // Data is compatible (aside from the issue of endian-ness).
-          str.read(reinterpret_cast<char*>(array), num * sizeof(ExtT));
-          if (!str.good())
-            throw GeographicErr("Failure reading data");
-          if (bigendp != Math::bigendian) { // endian mismatch -> swap bytes
-            for (size_t i = num; i--;)
-              array[i] = Math::swab<IntT>(array[i]);
+          if (bigendp == Math::bigendian) {
+            str.read(reinterpret_cast<char*>(array), num * sizeof(ExtT));
+            if (!str.good())
+              throw GeographicErr("Failure reading data");
+          } else {
+            // endian mismatch -> swap bytes; this is done a chunk at a time
+            // so that the data is still in the cache.
+            for (size_t i = 0; i < num;) {
+              size_t n = (std::min)(num - i, bufsize);
+              str.read(reinterpret_cast<char*>(array + i), n * sizeof(ExtT));
+              if (!str.good())
+                throw GeographicErr("Failure reading data");
+              for (size_t j = i + n; i < j; ++i)
+                array[i] = Math::swab<IntT>(array[i]);
+            }
           }
         }
       else
 #endif
         {
-          const int bufsize = 1024; // read this many values at a time
-          ExtT buffer[bufsize];     // temporary buffer
-          int k = int(num);         // data values left to read
-          int i = 0;                // index into output array
-          while (k) {
-            int n = (std::min)(k, bufsize);
-            str.read(reinterpret_cast<char*>(buffer), n * sizeof(ExtT));
+          // temporary buffer
+          std::vector<ExtT> buffer((std::min)(num, bufsize));
+          for (size_t i = 0; i < num;) { // i = index into output array
+            size_t n = (std::min)(num - i, bufsize);
+            str.read(reinterpret_cast<char*>(&buffer[0]), n * sizeof(ExtT));
             if (!str.good())
               throw GeographicErr("Failure reading data");
-            for (int j = 0; j < n; ++j)
-              // fix endian-ness and cast to IntT
-              array[i++] = IntT(bigendp == Math::bigendian ? buffer[j] :
-                                Math::swab<ExtT>(buffer[j]));
-            k -= n;
+            if (bigendp != Math::bigendian) // fix endian-ness
+              for (size_t j = 0; j < n; ++j)
+                buffer[j] = Math::swab<ExtT>(buffer[j]);
+            for (size_t j = 0; j < n; ++j)
+              // cast to IntT
+              array[i++] = IntT(buffer[j]);
           }
         }
       return;
@@ -576,6 +761,88 @@ namespace GeographicLib {
      **********************************************************************/
     static int set_digits(int ndigits = 0);
 
+    /**
+     * Map a file into memory.
+     *
+     * @param[in] filename the name of the file.
+     * @param[out] len the length of the file (bytes).
+     * @param[out] handle an operating system handle for the mapping (this is
+     *   only used on Windows).
+     * @exception GeographicErr if the file can't be mapped or if memory
+     *   mapping is not supported on this system.
+     * @return a pointer to the start of the mapped file.
+     *
+     * @param[in] hugepages (optional) if true, ask for the mapping to be
+     *   backed by huge pages (see Utility::advisehugepages); default false.
+     *
+     * The file is mapped copy-on-write (using mmap with MAP_PRIVATE on POSIX
+     * systems and MapViewOfFile with FILE_MAP_COPY on Windows).  Thus the
+     * pages of the file are read on demand and are shared with other
+     * processes mapping the same file; changes to the data are private to
+     * this process (and only the pages changed are copied).  The start of
+     * the mapping is page aligned.  Release the mapping with
+     * Utility::unmapfile.
+     **********************************************************************/
+    static char* mapfile(const std::string& filename,
+                         unsigned long long& len, void*& handle,
+                         bool hugepages = false);
+
+    /**
+     * Release a memory mapping.
+     *
+     * @param[in] addr the pointer returned by Utility::mapfile.
+     * @param[in] len the length returned by Utility::mapfile.
+     * @param[in] handle the handle returned by Utility::mapfile.
+     *
+     * This does nothing if \e addr is null.
+     **********************************************************************/
+    static void unmapfile(char* addr, unsigned long long len, void* handle);
+
+    /**
+     * Ask for a range of memory to be backed by huge pages.
+     *
+     * @param[in] addr the start of the range.
+     * @param[in] len the length of the range (bytes).
+     * @return whether the request was accepted.
+     *
+     * Large read-only tables which are accessed at random (the data of a
+     * Geoid and the coefficients of a GravityModel) suffer many TLB misses
+     * when they are stored in ordinary 4 KB pages.  This asks the operating
+     * system to use 2 MB pages for the part of the range which lies within
+     * whole 2 MB pages (using madvise with MADV_HUGEPAGE on Linux).  This is
+     * only advice: it needs transparent huge pages to be enabled (they are
+     * if /sys/kernel/mm/transparent_hugepage/enabled is "always" or
+     * "madvise") and it should be given before the memory is first written;
+     * for a memory mapped file, it also needs kernel support for huge pages
+     * in the page cache.  The results obtained using the memory are
+     * unaffected.  On other systems, this does nothing and returns false.
+     **********************************************************************/
+    static bool advisehugepages(const void* addr, size_t len);
+
+    /**
+     * Reserve memory for a vector backed by huge pages.
+     *
+     * @tparam T the type of the elements of the vector.
+     * @param[in,out] v the vector; it is left empty.
+     * @param[in] n the number of elements to reserve.
+     * @exception std::bad_alloc if the memory can't be allocated.
+     *
+     * This reserves room for \e n elements and calls
+     * Utility::advisehugepages for the storage before it has been filled.
+     * The vector can then be grown to \e n elements (with resize, insert, or
+     * push_back) without the storage being moved.
+     **********************************************************************/
+    template<typename T>
+    static void reservehugepages(std::vector<T>& v, size_t n) {
+      std::vector<T>().swap(v);
+      if (n == 0) return;
+      v.reserve(n);
+      // Add one element to get at the storage.
+      v.push_back(T());
+      advisehugepages(&v[0], v.capacity() * sizeof(T));
+      v.clear();
+    }
+
   };
 
 } // namespace GeographicLib
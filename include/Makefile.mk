@@ -1,32 +1,59 @@
-MODULES = Accumulator \
+MODULES = --help \
+	Accumulator \
 	AlbersEqualArea \
+	AuthalicSphere \
 	AzimuthalEquidistant \
 	CassiniSoldner \
 	CircularEngine \
+	CompactGeodesicLine \
 	DMS \
+	EditablePolygonArea \
 	Ellipsoid \
 	EllipticFunction \
+	Executor \
 	GeoCoords \
 	Geocentric \
+	GeocentricTracker \
 	Geodesic \
+	GeodesicBuffer \
 	GeodesicExact \
+	GeodesicIndex \
+	GeodesicIntersect \
 	GeodesicLine \
+	GeodesicLineCache \
 	GeodesicLineExact \
+	GeodesicMatrix \
+	GeodesicPolygon \
 	Geohash \
 	Geoid \
+	GeoidGenerator \
 	Gnomonic \
 	GravityCircle \
+	GravityCircleCache \
+	GravityGrid \
 	GravityModel \
+	GreatEllipse \
+	GridMapper \
+	Instrumentation \
+	InverseCache \
+	JacobiConformal \
 	LambertConformalConic \
+	LinePipeline \
 	LocalCartesian \
 	MGRS \
+	MGRSGrid \
 	MagneticCircle \
+	MagneticCircleCache \
+	MagneticLocation \
 	MagneticModel \
+	MagneticSnapshot \
 	Math \
 	NormalGravity \
+	NumaReplicas \
 	OSGB \
 	PolarStereographic \
 	PolygonArea \
+	Projector \
 	Rhumb \
 	SphericalEngine \
 	TransverseMercator \
@@ -104,6 +104,38 @@ public  class Accumulator {
     else
       _t += u;                // otherwise just accumulate u to t.
   }
+  /**
+   * Add another accumulator to the accumulator.
+   * <p>
+   * @param a set <i>sum</i> += <i>a</i>.
+   * <p>
+   * Both components of <i>a</i> are added so that the combination of partial
+   * sums (e.g., computed by different threads) is as accurate as a single
+   * accumulation.
+   **********************************************************************/
+  public void Add(Accumulator a) { Add(a._t); Add(a._s); }
+  /**
+   * Combine an array of partial sums in a fixed order.
+   * <p>
+   * @param a the array of accumulators.
+   * @return a new Accumulator holding the sum of the partial sums.
+   * <p>
+   * The partial sums are combined pairwise in a balanced binary tree whose
+   * shape depends only on the length of <i>a</i>.  So, if a sum is split into
+   * partial sums over fixed ranges of its terms, the result is the same no
+   * matter how many threads computed the partial sums.
+   **********************************************************************/
+  public static Accumulator Reduce(Accumulator[] a) {
+    return Reduce(a, 0, a.length);
+  }
+  private static Accumulator Reduce(Accumulator[] a, int i0, int n) {
+    if (n == 0) return new Accumulator(0);
+    if (n == 1) return new Accumulator(a[i0]);
+    int m = n / 2;
+    Accumulator b = Reduce(a, i0, m);
+    b.Add(Reduce(a, i0 + m, n - m));
+    return b;
+  }
   /**
    * Negate an accumulator.
    * <p>
@@ -451,12 +451,41 @@ public class Geodesic {
    **********************************************************************/
   public GeodesicData Direct(double lat1, double lon1, double azi1,
                              boolean arcmode, double s12_a12, int outmask) {
+    return Direct(lat1, lon1, azi1, arcmode, s12_a12, outmask,
+                  new GeodesicData());
+  }
+
+  /**
+   * The general direct geodesic problem storing the results in a supplied
+   * object.
+   * <p>
+   * @param lat1 latitude of point 1 (degrees).
+   * @param lon1 longitude of point 1 (degrees).
+   * @param azi1 azimuth at point 1 (degrees).
+   * @param arcmode boolean flag determining the meaning of the
+   *   <i>s12_a12</i>.
+   * @param s12_a12 if <i>arcmode</i> is false, this is the distance between
+   *   point 1 and point 2 (meters); otherwise it is the arc length between
+   *   point 1 and point 2 (degrees); it can be negative.
+   * @param outmask a bitor'ed combination of {@link GeodesicMask} values
+   *   specifying which results should be returned.
+   * @param r a {@link GeodesicData} object in which to store the results.
+   * @return <i>r</i>.
+   * <p>
+   * This is the same as {@link #Direct(double, double, double, boolean,
+   * double, int) Direct(lat1, lon1, azi1, arcmode, s12_a12, outmask)},
+   * except that the results are stored in <i>r</i> (whose fields are first
+   * reset to Double.NaN) instead of a new object.
+   **********************************************************************/
+  public GeodesicData Direct(double lat1, double lon1, double azi1,
+                             boolean arcmode, double s12_a12, int outmask,
+                             GeodesicData r) {
     return new GeodesicLine(this, lat1, lon1, azi1,
                             // Automatically supply DISTANCE_IN if necessary
                             outmask | (arcmode ? GeodesicMask.NONE :
                                        GeodesicMask.DISTANCE_IN))
       .                         // Note the dot!
-      Position(arcmode, s12_a12, outmask);
+      Position(arcmode, s12_a12, outmask, r);
   }
 
   /**
@@ -526,8 +555,174 @@ public class Geodesic {
    **********************************************************************/
   public GeodesicData Inverse(double lat1, double lon1,
                               double lat2, double lon2, int outmask) {
-    outmask &= GeodesicMask.OUT_MASK;
+    return Inverse(lat1, lon1, lat2, lon2, outmask, new GeodesicData());
+  }
+
+  /**
+   * Solve the inverse geodesic problem storing the results in a supplied
+   * object.
+   * <p>
+   * @param lat1 latitude of point 1 (degrees).
+   * @param lon1 longitude of point 1 (degrees).
+   * @param lat2 latitude of point 2 (degrees).
+   * @param lon2 longitude of point 2 (degrees).
+   * @param outmask a bitor'ed combination of {@link GeodesicMask} values
+   *   specifying which results should be returned.
+   * @param r a {@link GeodesicData} object in which to store the results.
+   * @return <i>r</i>.
+   * <p>
+   * This is the same as {@link #Inverse(double, double, double, double, int)
+   * Inverse(lat1, lon1, lat2, lon2, outmask)}, except that the results are
+   * stored in <i>r</i> (whose fields are first reset to Double.NaN) instead
+   * of a new object.
+   **********************************************************************/
+  public GeodesicData Inverse(double lat1, double lon1,
+                              double lat2, double lon2, int outmask,
+                              GeodesicData r) {
+    return Inverse(lat1, lon1, lat2, lon2, outmask, r,
+                   new double[nC1_ + 1], new double[nC2_ + 1],
+                   new double[nC3_], new double[nC4_]);
+  }
+
+  /**
+   * Solve the inverse geodesic problem for arrays of points.
+   * <p>
+   * @param lat1 array of latitudes of point 1 (degrees).
+   * @param lon1 array of longitudes of point 1 (degrees).
+   * @param lat2 array of latitudes of point 2 (degrees).
+   * @param lon2 array of longitudes of point 2 (degrees).
+   * @param s12 array of distances between point 1 and point 2 (meters).
+   * @param azi1 array of azimuths at point 1 (degrees).
+   * @param azi2 array of (forward) azimuths at point 2 (degrees).
+   * @exception GeographicErr if the arrays have different lengths.
+   * <p>
+   * Element <i>i</i> of the output arrays gives the result for the points
+   * (<i>lat1</i>[<i>i</i>], <i>lon1</i>[<i>i</i>]) and
+   * (<i>lat2</i>[<i>i</i>], <i>lon2</i>[<i>i</i>]).  Any of the output
+   * arrays may be null, in which case the corresponding quantity is not
+   * computed.  The results are identical to those returned by {@link
+   * #Inverse(double, double, double, double) Inverse}.  No objects are
+   * allocated per point.
+   **********************************************************************/
+  public void Inverse(double[] lat1, double[] lon1,
+                      double[] lat2, double[] lon2,
+                      double[] s12, double[] azi1, double[] azi2) {
+    Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2, null, null, null, null);
+  }
+
+  /**
+   * Solve the inverse geodesic problem for arrays of points returning all
+   * the geodesic quantities.
+   * <p>
+   * @param lat1 array of latitudes of point 1 (degrees).
+   * @param lon1 array of longitudes of point 1 (degrees).
+   * @param lat2 array of latitudes of point 2 (degrees).
+   * @param lon2 array of longitudes of point 2 (degrees).
+   * @param s12 array of distances between point 1 and point 2 (meters).
+   * @param azi1 array of azimuths at point 1 (degrees).
+   * @param azi2 array of (forward) azimuths at point 2 (degrees).
+   * @param m12 array of reduced lengths of the geodesics (meters).
+   * @param M12 array of geodesic scales of point 2 relative to point 1
+   *   (dimensionless).
+   * @param M21 array of geodesic scales of point 1 relative to point 2
+   *   (dimensionless).
+   * @param S12 array of areas under the geodesics (meters<sup>2</sup>).
+   * @exception GeographicErr if the arrays have different lengths.
+   * <p>
+   * This is the same as {@link #Inverse(double[], double[], double[],
+   * double[], double[], double[], double[]) Inverse(lat1, lon1, lat2, lon2,
+   * s12, azi1, azi2)} with additional output arrays, any of which may be
+   * null.
+   **********************************************************************/
+  public void Inverse(double[] lat1, double[] lon1,
+                      double[] lat2, double[] lon2,
+                      double[] s12, double[] azi1, double[] azi2,
+                      double[] m12, double[] M12, double[] M21,
+                      double[] S12) {
+    int n = lat1.length;
+    CheckLength(n, lon1); CheckLength(n, lat2); CheckLength(n, lon2);
+    CheckLength(n, s12); CheckLength(n, azi1); CheckLength(n, azi2);
+    CheckLength(n, m12); CheckLength(n, M12); CheckLength(n, M21);
+    CheckLength(n, S12);
+    int outmask =
+      (s12 != null ? GeodesicMask.DISTANCE : GeodesicMask.NONE) |
+      (azi1 != null || azi2 != null ? GeodesicMask.AZIMUTH :
+       GeodesicMask.NONE) |
+      (m12 != null ? GeodesicMask.REDUCEDLENGTH : GeodesicMask.NONE) |
+      (M12 != null || M21 != null ? GeodesicMask.GEODESICSCALE :
+       GeodesicMask.NONE) |
+      (S12 != null ? GeodesicMask.AREA : GeodesicMask.NONE);
+    // The results holder and the coefficient arrays are reused for all the
+    // points.
     GeodesicData r = new GeodesicData();
+    double
+      C1a[] = new double[nC1_ + 1], C2a[] = new double[nC2_ + 1],
+      C3a[] = new double[nC3_], C4a[] = new double[nC4_];
+    for (int i = 0; i < n; ++i) {
+      Inverse(lat1[i], lon1[i], lat2[i], lon2[i], outmask, r,
+              C1a, C2a, C3a, C4a);
+      if (s12  != null) s12[i]  = r.s12;
+      if (azi1 != null) azi1[i] = r.azi1;
+      if (azi2 != null) azi2[i] = r.azi2;
+      if (m12  != null) m12[i]  = r.m12;
+      if (M12  != null) M12[i]  = r.M12;
+      if (M21  != null) M21[i]  = r.M21;
+      if (S12  != null) S12[i]  = r.S12;
+    }
+  }
+
+  /**
+   * Solve the direct geodesic problem for arrays of points.
+   * <p>
+   * @param lat1 array of latitudes of point 1 (degrees).
+   * @param lon1 array of longitudes of point 1 (degrees).
+   * @param azi1 array of azimuths at point 1 (degrees).
+   * @param s12 array of distances between point 1 and point 2 (meters).
+   * @param lat2 array of latitudes of point 2 (degrees).
+   * @param lon2 array of longitudes of point 2 (degrees).
+   * @param azi2 array of (forward) azimuths at point 2 (degrees).
+   * @exception GeographicErr if the arrays have different lengths.
+   * <p>
+   * Element <i>i</i> of the output arrays gives the result for the problem
+   * specified by element <i>i</i> of the input arrays.  Any of the output
+   * arrays may be null, in which case the corresponding quantity is not
+   * computed.  The results are identical to those returned by {@link
+   * #Direct(double, double, double, double) Direct}.  A single {@link
+   * GeodesicData} object is used to hold the results for all the points.
+   **********************************************************************/
+  public void Direct(double[] lat1, double[] lon1,
+                     double[] azi1, double[] s12,
+                     double[] lat2, double[] lon2, double[] azi2) {
+    int n = lat1.length;
+    CheckLength(n, lon1); CheckLength(n, azi1); CheckLength(n, s12);
+    CheckLength(n, lat2); CheckLength(n, lon2); CheckLength(n, azi2);
+    int outmask =
+      (lat2 != null ? GeodesicMask.LATITUDE : GeodesicMask.NONE) |
+      (lon2 != null ? GeodesicMask.LONGITUDE : GeodesicMask.NONE) |
+      (azi2 != null ? GeodesicMask.AZIMUTH : GeodesicMask.NONE);
+    GeodesicData r = new GeodesicData();
+    for (int i = 0; i < n; ++i) {
+      Direct(lat1[i], lon1[i], azi1[i], false, s12[i], outmask, r);
+      if (lat2 != null) lat2[i] = r.lat2;
+      if (lon2 != null) lon2[i] = r.lon2;
+      if (azi2 != null) azi2[i] = r.azi2;
+    }
+  }
+
+  private static void CheckLength(int n, double[] a) {
+    if (a != null && a.length != n)
+      throw new GeographicErr("Arrays have different lengths");
+  }
+
+  // The inverse problem with the caller supplying the arrays for the series
+  // coefficients; this is package private so that PolygonArea can use it.
+  GeodesicData Inverse(double lat1, double lon1,
+                       double lat2, double lon2, int outmask,
+                       GeodesicData r,
+                       double C1a[], double C2a[],
+                       double C3a[], double C4a[]) {
+    outmask &= GeodesicMask.OUT_MASK;
+    r.Reset();
     lon1 = GeoMath.AngNormalize(lon1);
     lon2 = GeoMath.AngNormalize(lon2);
     // Compute longitude difference (AngDiff does this carefully).  Result is
@@ -610,10 +805,7 @@ public class Geodesic {
 
     double a12, sig12, calp1, salp1, calp2, salp2;
     a12 = sig12 = calp1 = salp1 = calp2 = salp2 = Double.NaN;
-    // index zero elements of these arrays are unused
-    double C1a[] = new double[nC1_ + 1];
-    double C2a[] = new double[nC2_ + 1];
-    double C3a[] = new double[nC3_];
+    // index zero elements of the arrays C1a and C2a are unused
 
     boolean meridian = lat1 == -90 || slam12 == 0;
 
@@ -818,7 +1010,6 @@ public class Geodesic {
           ssig1 = p.first; csig1 = p.second; }
         { Pair p = GeoMath.norm(ssig2, csig2);
           ssig2 = p.first; csig2 = p.second; }
-        double C4a[] = new double[nC4_];
         C4f(eps, C4a);
         double
           B41 = SinCosSeries(false, ssig1, csig1, C4a),
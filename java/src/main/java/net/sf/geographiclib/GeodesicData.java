@@ -17,6 +17,14 @@ package net.sf.geographiclib;
  * Geodesic#Direct(double, double, double, double) Geodesic.Direct} and {@link
  * Geodesic#Inverse(double, double, double, double) Geodesic.Inverse} and it
  * always includes the field <i>a12</i>.
+ * <p>
+ * A GeodesicData object may be passed to the versions of {@link
+ * Geodesic#Direct(double, double, double, boolean, double, int,
+ * GeodesicData) Geodesic.Direct}, {@link Geodesic#Inverse(double, double,
+ * double, double, int, GeodesicData) Geodesic.Inverse}, and {@link
+ * GeodesicLine#Position(boolean, double, int, GeodesicData)
+ * GeodesicLine.Position} which store their results in it; this avoids
+ * allocating a new object for each calculation.
  **********************************************************************/
 public class GeodesicData {
   /**
@@ -71,7 +79,12 @@ public class GeodesicData {
   /**
    * Initialize all the fields to Double.NaN.
    **********************************************************************/
-  public GeodesicData() {
+  public GeodesicData() { Reset(); }
+  /**
+   * Set all the fields to Double.NaN.  This is called when a GeodesicData
+   * object is reused to hold the results of another calculation.
+   **********************************************************************/
+  public void Reset() {
     lat1 = lon1 = azi1 = lat2 = lon2 = azi2 =
       s12 = a12 = m12 = M12 = M21 = S12 = Double.NaN;
   }
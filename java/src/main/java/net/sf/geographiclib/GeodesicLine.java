@@ -397,8 +397,33 @@ public class GeodesicLine {
    **********************************************************************/
   public GeodesicData Position(boolean arcmode, double s12_a12,
                                int outmask) {
+    return Position(arcmode, s12_a12, outmask, new GeodesicData());
+  }
+
+  /**
+   * The general position function storing the results in a supplied
+   * object.
+   * <p>
+   * @param arcmode boolean flag determining the meaning of the second
+   *   parameter; if arcmode is false, then the GeodesicLine object must have
+   *   been constructed with <i>caps</i> |= {@link GeodesicMask#DISTANCE_IN}.
+   * @param s12_a12 if <i>arcmode</i> is false, this is the distance between
+   *   point 1 and point 2 (meters); otherwise it is the arc length between
+   *   point 1 and point 2 (degrees); this can be negative.
+   * @param outmask a bitor'ed combination of {@link GeodesicMask} values
+   *   specifying which results should be returned.
+   * @param r a {@link GeodesicData} object in which to store the results.
+   * @return <i>r</i>.
+   * <p>
+   * This is the same as {@link #Position(boolean, double, int)
+   * Position(arcmode, s12_a12, outmask)}, except that the results are
+   * stored in <i>r</i> (whose fields are first reset to Double.NaN) instead
+   * of a new object.
+   **********************************************************************/
+  public GeodesicData Position(boolean arcmode, double s12_a12,
+                               int outmask, GeodesicData r) {
     outmask &= _caps & GeodesicMask.OUT_MASK;
-    GeodesicData r = new GeodesicData();
+    r.Reset();
     if (!( Init() &&
            (arcmode ||
             (_caps & GeodesicMask.DISTANCE_IN & GeodesicMask.OUT_MASK) != 0) ))
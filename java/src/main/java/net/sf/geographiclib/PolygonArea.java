@@ -66,6 +66,10 @@ public class PolygonArea {
   private int _crossings;
   private Accumulator _areasum, _perimetersum;
   private double _lat0, _lon0, _lat1, _lon1;
+  // The number of edges in each of the chunks into which AddPoints divides
+  // the edges.  This is fixed so that the result doesn't depend on the
+  // number of threads.
+  private static final int chunk_ = 1024;
   private static int transit(double lon1, double lon2) {
     // Return 1 or -1 if crossing prime meridian in east or west direction.
     // Otherwise return zero.
@@ -148,6 +152,151 @@ public class PolygonArea {
     ++_num;
   }
 
+  /**
+   * Add several points to the polygon or polyline.
+   * <p>
+   * @param lat the array of latitudes of the points (degrees).
+   * @param lon the array of longitudes of the points (degrees).
+   * @exception GeographicErr if the arrays have different lengths.
+   * <p>
+   * This is the same as {@link #AddPoints(double[], double[], int)
+   * AddPoints(lat, lon, 1)}.
+   **********************************************************************/
+  public void AddPoints(double[] lat, double[] lon) {
+    AddPoints(lat, lon, 1);
+  }
+
+  /**
+   * Add several points to the polygon or polyline using several threads.
+   * <p>
+   * @param lat the array of latitudes of the points (degrees).
+   * @param lon the array of longitudes of the points (degrees).
+   * @param nthreads the number of threads to use.
+   * @exception GeographicErr if the arrays have different lengths.
+   * <p>
+   * This is equivalent to calling {@link #AddPoint AddPoint} for each point.
+   * However the edges are split into chunks of 1024 which are summed
+   * separately (by <i>nthreads</i> threads) with no objects allocated per
+   * edge.  The partial sums are then combined with {@link
+   * Accumulator#Reduce Accumulator.Reduce}.  So the result agrees with that
+   * given by AddPoint to within the round-off of the final sum.  Because the
+   * chunks and the order in which they are combined are fixed, the result is
+   * bitwise identical for any number of threads.
+   * <p>
+   * A polygon with a very large number of vertices can be processed with
+   * bounded memory by calling this function repeatedly with successive
+   * chunks of the vertices (the first point of each chunk is connected to
+   * the last point of the previous one).
+   **********************************************************************/
+  public void AddPoints(double[] lat, double[] lon, int nthreads) {
+    int n = lat.length;
+    if (lon.length != n)
+      throw new GeographicErr("Arrays have different lengths");
+    if (n == 0) return;
+    // The edge from the current point (if any) to the first point
+    AddPoint(lat[0], lon[0]);
+    if (n == 1) return;
+    int nc = (n - 2) / chunk_ + 1;
+    Accumulator[] perimeter = new Accumulator[nc], area = new Accumulator[nc];
+    int[] crossings = new int[nc];
+    ChunkSums(lat, lon, perimeter, area, crossings, nthreads);
+    _perimetersum.Add(Accumulator.Reduce(perimeter));
+    if (!_polyline) {
+      _areasum.Add(Accumulator.Reduce(area));
+      for (int k = 0; k < nc; ++k)
+        _crossings += crossings[k];
+    }
+    _lat1 = lat[n - 1]; _lon1 = GeoMath.AngNormalize(lon[n - 1]);
+    _num += n - 1;
+  }
+
+  // Accumulate the contributions of the edges from point i to point i + 1
+  // of the arrays, for i0 <= i < i1, and return the number of crossings of
+  // the prime meridian.
+  private int EdgeSums(double[] lat, double[] lon, int i0, int i1,
+                       Accumulator perimeter, Accumulator area) {
+    // The results holder and the coefficient arrays are reused for all the
+    // edges.
+    GeodesicData g = new GeodesicData();
+    double
+      C1a[] = new double[Geodesic.nC1_ + 1],
+      C2a[] = new double[Geodesic.nC2_ + 1],
+      C3a[] = new double[Geodesic.nC3_], C4a[] = new double[Geodesic.nC4_];
+    int crossings = 0;
+    double lon1 = GeoMath.AngNormalize(lon[i0]);
+    for (int i = i0; i < i1; ++i) {
+      double lon2 = GeoMath.AngNormalize(lon[i + 1]);
+      _earth.Inverse(lat[i], lon1, lat[i + 1], lon2, _mask, g,
+                     C1a, C2a, C3a, C4a);
+      perimeter.Add(g.s12);
+      if (!_polyline) {
+        area.Add(g.S12);
+        crossings += transit(lon1, lon2);
+      }
+      lon1 = lon2;
+    }
+    return crossings;
+  }
+
+  // Accumulate the edges of the arrays in chunks of chunk_ edges, chunk k
+  // going into perimeter[k], area[k], and crossings[k].  The chunks are
+  // divided into nthreads contiguous ranges, the last of which is done in
+  // the calling thread.
+  private void ChunkSums(final double[] lat, final double[] lon,
+                         final Accumulator[] perimeter,
+                         final Accumulator[] area, final int[] crossings,
+                         int nthreads) {
+    final int n = lat.length, nc = perimeter.length;
+    if (nthreads > nc) nthreads = nc;
+    if (nthreads < 1) nthreads = 1;
+    Thread[] threads = new Thread[nthreads - 1];
+    final RuntimeException[] errs = new RuntimeException[nthreads];
+    for (int t = 0; t < nthreads; ++t) {
+      final int
+        j = t,
+        k0 = (int)((long)nc * t / nthreads),
+        k1 = (int)((long)nc * (t + 1) / nthreads);
+      Runnable r = new Runnable() {
+          public void run() {
+            try {
+              for (int k = k0; k < k1; ++k) {
+                int i0 = k * chunk_;
+                perimeter[k] = new Accumulator(0);
+                area[k] = new Accumulator(0);
+                crossings[k] = EdgeSums(lat, lon, i0,
+                                        Math.min(n - 1, i0 + chunk_),
+                                        perimeter[k], area[k]);
+              }
+            }
+            catch (RuntimeException e) {
+              errs[j] = e;
+            }
+          }
+        };
+      if (t < nthreads - 1) {
+        threads[t] = new Thread(r);
+        threads[t].start();
+      } else
+        r.run();
+    }
+    boolean interrupted = false;
+    for (int t = 0; t < nthreads - 1; ++t) {
+      while (true) {
+        try {
+          threads[t].join();
+          break;
+        }
+        catch (InterruptedException e) {
+          interrupted = true;
+        }
+      }
+    }
+    if (interrupted)
+      Thread.currentThread().interrupt();
+    for (int t = 0; t < nthreads; ++t)
+      if (errs[t] != null) throw errs[t];
+  }
+
   /**
    * Add an edge to the polygon or polyline.
    * <p>
@@ -228,6 +377,32 @@ public class PolygonArea {
     return new PolygonResult(_num, _perimetersum.Sum(g.s12), 0 + tempsum.Sum());
   }
 
+  /**
+   * Return the perimeter and area of a polygon given by arrays of vertices.
+   * <p>
+   * @param lat the array of latitudes of the vertices (degrees).
+   * @param lon the array of longitudes of the vertices (degrees).
+   * @param reverse if true then clockwise (instead of counter-clockwise)
+   *   traversal counts as a positive area.
+   * @param sign if true then return a signed result for the area if
+   *   the polygon is traversed in the "wrong" direction instead of returning
+   *   the area for the rest of the earth.
+   * @param nthreads the number of threads to use.
+   * @exception GeographicErr if the arrays have different lengths.
+   * @return PolygonResult(<i>num</i>, <i>perimeter</i>, <i>area</i>) as
+   *   for {@link #Compute(boolean, boolean) Compute}.
+   * <p>
+   * The vertices are processed as by {@link #AddPoints(double[], double[],
+   * int) AddPoints}.  The ellipsoid and the polyline setting of this object
+   * are used; however, the polygon held by this object is not changed.
+   **********************************************************************/
+  public PolygonResult Compute(double[] lat, double[] lon,
+                               boolean reverse, boolean sign, int nthreads) {
+    PolygonArea p = new PolygonArea(_earth, _polyline);
+    p.AddPoints(lat, lon, nthreads);
+    return p.Compute(reverse, sign);
+  }
+
   /**
    * Return the results assuming a tentative final test point is added;
    * however, the data for the test point is not saved.  This lets you report
@@ -25,6 +25,7 @@
 
 #include "geodesic.h"
 #include <math.h>
+#include <stddef.h>
 
 #define GEOGRAPHICLIB_GEODESIC_ORDER 6
 #define nA1   GEOGRAPHICLIB_GEODESIC_ORDER
@@ -1876,4 +1877,100 @@ void geod_polygonarea(const struct geod_geodesic* g,
   geod_polygon_compute(g, &p, FALSE, TRUE, pA, pP);
 }
 
+void geod_inverse_n(const struct geod_geodesic* g, int n,
+                    const real* lat1, int lat1stride,
+                    const real* lon1, int lon1stride,
+                    const real* lat2, int lat2stride,
+                    const real* lon2, int lon2stride,
+                    real* s12, int s12stride,
+                    real* azi1, int azi1stride,
+                    real* azi2, int azi2stride) {
+  int i;
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (i = 0; i < n; ++i) {
+    ptrdiff_t k = i;
+    geod_geninverse(g, lat1[k * lat1stride], lon1[k * lon1stride],
+                    lat2[k * lat2stride], lon2[k * lon2stride],
+                    s12 ? s12 + k * s12stride : 0,
+                    azi1 ? azi1 + k * azi1stride : 0,
+                    azi2 ? azi2 + k * azi2stride : 0,
+                    0, 0, 0, 0);
+  }
+}
+
+void geod_direct_n(const struct geod_geodesic* g, int n,
+                   const real* lat1, int lat1stride,
+                   const real* lon1, int lon1stride,
+                   const real* azi1, int azi1stride,
+                   const real* s12, int s12stride,
+                   real* lat2, int lat2stride,
+                   real* lon2, int lon2stride,
+                   real* azi2, int azi2stride) {
+  int i;
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (i = 0; i < n; ++i) {
+    ptrdiff_t k = i;
+    geod_gendirect(g, lat1[k * lat1stride], lon1[k * lon1stride],
+                   azi1[k * azi1stride], GEOD_NOFLAGS, s12[k * s12stride],
+                   lat2 ? lat2 + k * lat2stride : 0,
+                   lon2 ? lon2 + k * lon2stride : 0,
+                   azi2 ? azi2 + k * azi2stride : 0,
+                   0, 0, 0, 0, 0);
+  }
+}
+
+void geod_polygonarea_n(const struct geod_geodesic* g,
+                        const real lats[], const real lons[],
+                        const int offsets[], int npoly,
+                        real A[], real P[]) {
+  int k;
+#if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (k = 0; k < npoly; ++k) {
+    int i;
+    struct geod_polygon p;
+    geod_polygon_init(&p, FALSE);
+    for (i = offsets[k]; i < offsets[k + 1]; ++i)
+      geod_polygon_addpoint(g, &p, lats[i], lons[i]);
+    geod_polygon_compute(g, &p, FALSE, TRUE,
+                         A ? A + k : 0, P ? P + k : 0);
+  }
+}
+
+void geod_cellareas(const struct geod_geodesic* g,
+                    const real lats[], int nlat, real dlon,
+                    real A[]) {
+  /* The area of cell k is S(lats[k]) - S(lats[k+1]), where S(lat) is the
+   * area under the geodesic from (lat, 0) to (lat, dlon). */
+  real S0 = 0, S1 = 0, t[2], area0 = 4 * pi * g->c2;
+  int k;
+  for (k = 0; k + 1 < nlat; ++k) {
+    if (!(dlon > 0 && dlon < 180)) {
+      A[k] = NaN;
+      continue;
+    }
+    if (k == 0)
+      geod_geninverse(g, lats[0], 0, lats[0], dlon, 0, 0, 0, 0, 0, 0, &S0);
+    geod_geninverse(g, lats[k + 1], 0, lats[k + 1], dlon,
+                    0, 0, 0, 0, 0, 0, &S1);
+    accini(t);
+    accadd(t, S0);
+    accadd(t, -S1);
+    /* Convert to the counter-clockwise convention and reduce to
+     * (-area0/2, area0/2] as in geod_polygon_compute. */
+    accneg(t);
+    if (t[0] > area0/2)
+      accadd(t, -area0);
+    else if (t[0] <= -area0/2)
+      accadd(t, +area0);
+    A[k] = 0 + t[0];
+    S0 = S1;
+  }
+}
+
 /** @endcond */
@@ -768,6 +768,144 @@ extern "C" {
                         double lats[], double lons[], int n,
                         double* pA, double* pP);
 
+  /**
+   * Solve the inverse geodesic problem for many pairs of points.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] n the number of pairs of points.
+   * @param[in] lat1 array of latitudes of point 1 (degrees).
+   * @param[in] lat1stride the spacing of the elements of \e lat1.
+   * @param[in] lon1 array of longitudes of point 1 (degrees).
+   * @param[in] lon1stride the spacing of the elements of \e lon1.
+   * @param[in] lat2 array of latitudes of point 2 (degrees).
+   * @param[in] lat2stride the spacing of the elements of \e lat2.
+   * @param[in] lon2 array of longitudes of point 2 (degrees).
+   * @param[in] lon2stride the spacing of the elements of \e lon2.
+   * @param[out] s12 array of distances between point 1 and point 2
+   *   (meters).
+   * @param[in] s12stride the spacing of the elements of \e s12.
+   * @param[out] azi1 array of azimuths at point 1 (degrees).
+   * @param[in] azi1stride the spacing of the elements of \e azi1.
+   * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+   * @param[in] azi2stride the spacing of the elements of \e azi2.
+   *
+   * Pair \e i, 0 &le; \e i &lt; \e n, consists of the points (\e lat1[\e
+   * i &times; \e lat1stride], \e lon1[\e i &times; \e lon1stride]) and
+   * (\e lat2[\e i &times; \e lat2stride], \e lon2[\e i &times; \e
+   * lon2stride]) and its results are stored in \e s12[\e i &times; \e
+   * s12stride], etc.  The strides are measured in units of doubles.  Thus
+   * columns of a table can be used by passing a stride of 1 and the fields
+   * of an array of structs by passing the size of the struct divided by
+   * sizeof(double).  A stride of 0 for an input array means that the same
+   * value is used for all the pairs, e.g., to compute the distances from a
+   * single point to many others.  Any of the output arrays may be replaced
+   * by 0, if you do not need some quantities computed.  The results are
+   * identical to those obtained by calling geod_inverse() for each pair.
+   * If geodesic.c is compiled with OpenMP support, the pairs are
+   * distributed among the OpenMP threads.
+   **********************************************************************/
+  void geod_inverse_n(const struct geod_geodesic* g, int n,
+                      const double* lat1, int lat1stride,
+                      const double* lon1, int lon1stride,
+                      const double* lat2, int lat2stride,
+                      const double* lon2, int lon2stride,
+                      double* s12, int s12stride,
+                      double* azi1, int azi1stride,
+                      double* azi2, int azi2stride);
+
+  /**
+   * Solve the direct geodesic problem for many starting points and
+   * distances.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] n the number of problems.
+   * @param[in] lat1 array of latitudes of point 1 (degrees).
+   * @param[in] lat1stride the spacing of the elements of \e lat1.
+   * @param[in] lon1 array of longitudes of point 1 (degrees).
+   * @param[in] lon1stride the spacing of the elements of \e lon1.
+   * @param[in] azi1 array of azimuths at point 1 (degrees).
+   * @param[in] azi1stride the spacing of the elements of \e azi1.
+   * @param[in] s12 array of distances between point 1 and point 2
+   *   (meters).
+   * @param[in] s12stride the spacing of the elements of \e s12.
+   * @param[out] lat2 array of latitudes of point 2 (degrees).
+   * @param[in] lat2stride the spacing of the elements of \e lat2.
+   * @param[out] lon2 array of longitudes of point 2 (degrees).
+   * @param[in] lon2stride the spacing of the elements of \e lon2.
+   * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+   * @param[in] azi2stride the spacing of the elements of \e azi2.
+   *
+   * The arrays are accessed as in geod_inverse_n(); in particular, the
+   * strides are measured in units of doubles, a stride of 0 for an input
+   * array means that the same value is used for all the problems, and any
+   * of the output arrays may be replaced by 0.  The results are identical
+   * to those obtained by calling geod_direct() for each problem.
+   **********************************************************************/
+  void geod_direct_n(const struct geod_geodesic* g, int n,
+                     const double* lat1, int lat1stride,
+                     const double* lon1, int lon1stride,
+                     const double* azi1, int azi1stride,
+                     const double* s12, int s12stride,
+                     double* lat2, int lat2stride,
+                     double* lon2, int lon2stride,
+                     double* azi2, int azi2stride);
+
+  /**
+   * The areas and perimeters of many polygons.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lats an array of latitudes of the polygon vertices (degrees).
+   * @param[in] lons an array of longitudes of the polygon vertices
+   *   (degrees).
+   * @param[in] offsets an array of the \e npoly + 1 offsets of the
+   *   polygons.
+   * @param[in] npoly the number of polygons.
+   * @param[out] A array of the areas of the polygons (meters<sup>2</sup>).
+   * @param[out] P array of the perimeters of the polygons (meters).
+   *
+   * The vertices of polygon \e k, 0 &le; \e k &lt; \e npoly, are (\e
+   * lats[\e i], \e lons[\e i]), for \e offsets[\e k] &le; \e i &lt; \e
+   * offsets[\e k + 1].  The results for polygon \e k, stored in \e A[\e
+   * k] and \e P[\e k], are identical to those obtained by calling
+   * geod_polygonarea() for its vertices.  Either of \e A and \e P may be
+   * replaced by 0, if you do not need that quantity.  If geodesic.c is
+   * compiled with OpenMP support, the polygons are distributed among the
+   * OpenMP threads.
+   **********************************************************************/
+  void geod_polygonarea_n(const struct geod_geodesic* g,
+                          const double lats[], const double lons[],
+                          const int offsets[], int npoly,
+                          double A[], double P[]);
+
+  /**
+   * The areas of the cells of a latitude-longitude grid.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lats an array of latitudes of the edges of the cells
+   *   (degrees).
+   * @param[in] nlat the number of elements in \e lats.
+   * @param[in] dlon the width of the cells (degrees).
+   * @param[out] A array of the \e nlat &minus; 1 areas of the cells
+   *   (meters<sup>2</sup>).
+   *
+   * Cell \e k, 0 &le; \e k &lt; \e nlat &minus; 1, is the geodesic
+   * quadrilateral with vertices (\e lats[\e k], 0), (\e lats[\e k], \e
+   * dlon), (\e lats[\e k + 1], \e dlon), (\e lats[\e k + 1], 0).  Its
+   * area doesn't depend on its longitude, so this gives the areas of all the
+   * cells of a grid with cell width \e dlon using \e nlat inverse
+   * calculations.  The result for each cell is the same as that given by
+   * geod_polygonarea() for its vertices; in particular, it is negative if \e
+   * lats[\e k + 1] &lt; \e lats[\e k].  \e dlon should be in (0&deg;,
+   * 180&deg;); otherwise the areas are set to NaN.
+   **********************************************************************/
+  void geod_cellareas(const struct geod_geodesic* g,
+                      const double lats[], int nlat, double dlon,
+                      double A[]);
+
   /**
    * mask values for the \e caps argument to geod_lineinit().
    **********************************************************************/
@@ -3,6 +3,7 @@ PROGRAMS = CartConvert \
 	GeoConvert \
 	GeodSolve \
 	GeodesicProj \
+	GeographicServer \
 	GeoidEval \
 	Gravity \
 	MagneticField \
@@ -1,5 +1,7 @@
 MATLAB_FILES = $(wildcard geographiclib/*.m)
-MATLAB_PRIVATE = $(wildcard geographiclib/private/*.m)
+MATLAB_PRIVATE = $(wildcard geographiclib/private/*.m) \
+	$(wildcard geographiclib/private/*.cpp) \
+	$(wildcard geographiclib/private/*.hpp)
 MATLAB_LEGACY = $(wildcard geographiclib-legacy/*.m) \
 	$(wildcard geographiclib-legacy/*.cpp)
 
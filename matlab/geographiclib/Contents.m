@@ -84,6 +84,7 @@
 %   defaultellipsoid - Return the WGS84 ellipsoid
 %   ecc2flat         - Convert eccentricity to flattening
 %   flat2ecc         - Convert flattening to eccentricity
+%   geographiclib_mex - Compile the optional mex backends
 %
 % Documentation
 %   geoddoc          - Geodesics on an ellipsoid of revolution
@@ -22,6 +22,9 @@ function [s12, azi1, azi2, S12, m12, M12, M21, a12] = geoddistance ...
 %   When given a combination of scalar and array inputs, the scalar inputs
 %   are automatically expanded to match the size of the arrays.
 %
+%   If the mex backends have been compiled with geographiclib_mex, this
+%   function calls the C++ library to compute the results.
+%
 %   This is an implementation of the algorithm given in
 %
 %     C. F. F. Karney, Algorithms for geodesics,
@@ -40,7 +43,7 @@ function [s12, azi1, azi2, S12, m12, M12, M21, a12] = geoddistance ...
 %     * Additional properties of the geodesic are calcuated.
 %
 %   See also GEODDOC, GEODRECKON, GEODAREA, GEODESICINVERSE,
-%     DEFAULTELLIPSOID.
+%     DEFAULTELLIPSOID, GEOGRAPHICLIB_MEX.
 
 % Copyright (c) Charles Karney (2012-2015) <charles@karney.com>.
 %
@@ -66,6 +69,15 @@ function [s12, azi1, azi2, S12, m12, M12, M21, a12] = geoddistance ...
   Z = zeros(S);
   lat1 = lat1 + Z; lon1 = lon1 + Z;
   lat2 = lat2 + Z; lon2 = lon2 + Z;
+  if usemex('geoddistance', lat1, lon1, lat2, lon2)
+    e2 = real(ellipsoid(2)^2);
+    r = cell(1, max(nargout, 1));
+    [r{:}] = geoddistance_mex(lat1, lon1, lat2, lon2, ellipsoid(1), ...
+                              e2 / (1 + sqrt(1 - e2)));
+    r(end+1:8) = {[]};
+    [s12, azi1, azi2, S12, m12, M12, M21, a12] = r{:};
+    return
+  end
   Z = Z(:);
 
   degree = pi/180;
@@ -48,6 +48,9 @@ function [lat2, lon2, azi2, S12, m12, M12, M21, a12_s12] = geodreckon ...
 %   of points along a single geodesic is efficiently computed by specifying
 %   an array for s12 only.)
 %
+%   If the mex backends have been compiled with geographiclib_mex, this
+%   function calls the C++ library to compute the results.
+%
 %   This is an implementation of the algorithm given in
 %
 %     C. F. F. Karney, Algorithms for geodesics,
@@ -67,7 +70,7 @@ function [lat2, lon2, azi2, S12, m12, M12, M21, a12_s12] = geodreckon ...
 %     * Additional properties of the geodesic are calcuated.
 %
 %   See also GEODDOC, GEODDISTANCE, GEODAREA, GEODESICDIRECT, GEODESICLINE,
-%     DEFAULTELLIPSOID.
+%     DEFAULTELLIPSOID, GEOGRAPHICLIB_MEX.
 
 % Copyright (c) Charles Karney (2012-2015) <charles@karney.com>.
 %
@@ -111,6 +114,16 @@ function [lat2, lon2, azi2, S12, m12, M12, M21, a12_s12] = geodreckon ...
   end
   arcmode = bitand(flags, 1);
   long_unroll = bitand(flags, 2);
+  if usemex('geodreckon', lat1, lon1, s12_a12, azi1)
+    Z = zeros(S);
+    e2 = real(ellipsoid(2)^2);
+    r = cell(1, max(nargout, 1));
+    [r{:}] = geodreckon_mex(lat1 + Z, lon1 + Z, s12_a12 + Z, azi1 + Z, ...
+                            ellipsoid(1), e2 / (1 + sqrt(1 - e2)), flags);
+    r(end+1:8) = {[]};
+    [lat2, lon2, azi2, S12, m12, M12, M21, a12_s12] = r{:};
+    return
+  end
 
   degree = pi/180;
   tiny = sqrt(realmin);
@@ -0,0 +1,88 @@
+function geographiclib_mex(incdir, libdir)
+%GEOGRAPHICLIB_MEX  Compile the optional mex backends
+%
+%   GEOGRAPHICLIB_MEX
+%   GEOGRAPHICLIB_MEX(installdir)
+%   GEOGRAPHICLIB_MEX(incdir, libdir)
+%
+%   compiles mex versions of geoddistance, geodreckon, tranmerc_fwd,
+%   utmups_fwd, and geoid_height which call the compiled C++ library,
+%   GeographicLib.  The mex files are placed in the private directory of
+%   this toolbox and, once compiled, these functions use them
+%   automatically.  The results agree with the native implementations to
+%   round off; the mex versions are faster (especially with large arrays
+%   or, for geoid_height, with many calls with a few points) and they
+%   distribute the work over several threads.  The number of threads can
+%   be set with the environment variable GEOGRAPHICLIB_MEX_THREADS (the
+%   default is the number of processors).  The mex backends are used only
+%   with double arguments and they can be disabled by setting the
+%   environment variable GEOGRAPHICLIB_MEX to 0.  The mex version of
+%   geoid_height keeps the geoid data in memory between calls; this is
+%   released by GEOID_HEIGHT([]).
+%
+%   With one argument GEOGRAPHICLIB_MEX looks for the compiled library in
+%   installdir/lib and the include files in installdir/include.
+%
+%   With no arguments, installdir is taked to be '/usr/local', on Unix and
+%   Linux systems, and 'C:/Program Files/GeographicLib', on Windows systems
+%
+%   With two arguments, the library is looked for in libdir and the include
+%   files in incdir.
+%
+%   A C++11 compiler is needed for the multithreading; with an older
+%   compiler the mex files run in a single thread.  Run 'mex -setup C++' to
+%   configure the C++ compiler for Matlab to use.  To remove the mex
+%   backends, delete the mex files in the private directory.
+
+% Copyright (c) Charles Karney (2015) <charles@karney.com>.
+%
+% This file was distributed with GeographicLib 1.43.
+
+  funs = {'geoddistance', 'geodreckon', 'tranmerc_fwd', 'utmups_fwd', ...
+          'geoid_height'};
+  lib='Geographic';
+  if (nargin < 2)
+    if (nargin == 0)
+      if ispc
+        installdir = 'C:/Program Files/GeographicLib';
+      else
+        installdir = '/usr/local';
+      end
+    else
+      installdir = incdir;
+    end
+    incdir=[installdir '/include'];
+    libdir=[installdir '/lib'];
+  end
+  testheader = [incdir '/GeographicLib/Constants.hpp'];
+  if (~ exist(testheader, 'file'))
+    error(['Cannot find ' testheader]);
+  end
+  privdir = [fileparts(mfilename('fullpath')) '/private'];
+  fprintf('Compiling mex backends for GeographicLib\n');
+  fprintf('Include directory: %s\nLibrary directory: %s\n', incdir, libdir);
+  octavep = exist('OCTAVE_VERSION', 'builtin') ~= 0;
+  if octavep
+    setenv('CXXFLAGS', [getenv('CXXFLAGS') ' -std=c++11 -pthread']);
+    setenv('LDFLAGS', [getenv('LDFLAGS') ' -pthread']);
+  end
+  for i=1:size(funs,2)
+    fprintf('Compiling %s...', funs{i});
+    src = [privdir '/' funs{i} '_mex.cpp'];
+    args = {['-I' incdir], ['-L' libdir], ['-l' lib]};
+    if octavep
+      args = [args, {'-o', [privdir '/' funs{i} '_mex.' mexext]}];
+    else
+      args = [args, {'-outdir', privdir}];
+    end
+    if ~(ispc || ismac)
+      args = [args, {['-Wl,-rpath=' libdir]}];
+      if ~octavep
+        args = [args, {'CXXFLAGS=$CXXFLAGS -std=c++11 -pthread', ...
+                       'LDFLAGS=$LDFLAGS -pthread'}];
+      end
+    end
+    mex(args{:}, src);
+    fprintf(' done.\n');
+  end
+end
@@ -57,7 +57,13 @@ function N = geoid_height(lat, lon, geoidname, geoiddir)
 %   GEOID_HEIGHT uses cubic interpolation on gridded data that has been
 %   quantized at a resolution of 3mm.
 %
-%   See also GEOID_LOAD.
+%   If the mex backends have been compiled with geographiclib_mex, this
+%   function (except when invoked with a geoid structure) calls the C++
+%   library to compute the results.  In this case, the geoid data is read
+%   into memory once and retained between calls; GEOID_HEIGHT([]) releases
+%   it.
+%
+%   See also GEOID_LOAD, GEOGRAPHICLIB_MEX.
 
 % Copyright (c) Charles Karney (2015) <charles@karney.com>.
 %
@@ -66,6 +72,7 @@ function N = geoid_height(lat, lon, geoidname, geoiddir)
   persistent saved_geoid
   if nargin == 1 && isempty(lat)
     saved_geoid = [];
+    if usemex('geoid_height'), geoid_height_mex; end
     return
   end
   narginchk(2, 4)
@@ -79,6 +86,17 @@ function N = geoid_height(lat, lon, geoidname, geoiddir)
       geoiddir = '';
     end
     geoidfile = geoid_file(geoidname, geoiddir);
+    if usemex('geoid_height', lat, lon)
+      try
+        S = size(lat + lon);
+      catch
+        error('lat, lon have incompatible sizes')
+      end
+      Z = zeros(S);
+      [geoiddir, geoidname] = fileparts(geoidfile);
+      N = geoid_height_mex(lat + Z, lon + Z, geoidname, geoiddir);
+      return
+    end
     if ~(isstruct(saved_geoid) && strcmp(saved_geoid.file, geoidfile))
       saved_geoid = geoid_load_file(geoidfile);
     end
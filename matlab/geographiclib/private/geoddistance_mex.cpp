@@ -0,0 +1,106 @@
+/**
+ * \file geoddistance_mex.cpp
+ * \brief Matlab mex backend for geoddistance
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// [s12, azi1, azi2, S12, m12, M12, M21, a12] =
+//    geoddistance_mex(lat1, lon1, lat2, lon2, a, f)
+//
+// The arrays must have the same size and the outputs have this size.  Only
+// the requested outputs are computed.  Called by geoddistance and compiled
+// by geographiclib_mex.
+
+#include <cmath>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include "mexutil.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+template<class G> class Inverse {
+private:
+  const G& _g;
+  unsigned _outmask;
+  const double *_lat1, *_lon1, *_lat2, *_lon2;
+  double *_s12, *_azi1, *_azi2, *_S12, *_m12, *_M12, *_M21, *_a12;
+  static double* Off(double* p, size_t i) { return p ? p + i : 0; }
+public:
+  Inverse(const G& g, unsigned outmask,
+          const double* lat1, const double* lon1,
+          const double* lat2, const double* lon2,
+          double* s12, double* azi1, double* azi2, double* S12,
+          double* m12, double* M12, double* M21, double* a12)
+    : _g(g), _outmask(outmask)
+    , _lat1(lat1), _lon1(lon1), _lat2(lat2), _lon2(lon2)
+    , _s12(s12), _azi1(azi1), _azi2(azi2), _S12(S12)
+    , _m12(m12), _M12(M12), _M21(M21), _a12(a12)
+  {}
+  void operator()(size_t i0, size_t i1) const {
+    _g.GenInverseBatch(_lat1 + i0, _lon1 + i0, _lat2 + i0, _lon2 + i0,
+                       i1 - i0, _outmask,
+                       Off(_s12, i0), Off(_azi1, i0), Off(_azi2, i0),
+                       Off(_m12, i0), Off(_M12, i0), Off(_M21, i0),
+                       Off(_S12, i0), Off(_a12, i0));
+  }
+};
+
+template<class G>
+void compute(double a, double f, int nlhs, mxArray* plhs[],
+             const mxArray* prhs[]) {
+  size_t n = mxGetNumberOfElements(prhs[0]);
+  const double
+    *lat1 = mexutil::Input(prhs[0], n, "lat1"),
+    *lon1 = mexutil::Input(prhs[1], n, "lon1"),
+    *lat2 = mexutil::Input(prhs[2], n, "lat2"),
+    *lon2 = mexutil::Input(prhs[3], n, "lon2");
+  double
+    *s12  = mexutil::Output(nlhs, plhs, 0, prhs[0]),
+    *azi1 = mexutil::Output(nlhs, plhs, 1, prhs[0]),
+    *azi2 = mexutil::Output(nlhs, plhs, 2, prhs[0]),
+    *S12  = mexutil::Output(nlhs, plhs, 3, prhs[0]),
+    *m12  = mexutil::Output(nlhs, plhs, 4, prhs[0]),
+    *M12  = mexutil::Output(nlhs, plhs, 5, prhs[0]),
+    *M21  = mexutil::Output(nlhs, plhs, 6, prhs[0]),
+    *a12  = mexutil::Output(nlhs, plhs, 7, prhs[0]);
+  if (n == 0) return;
+  // M12 and M21 (and azi1 and azi2) are computed together; supply scratch
+  // space for an unrequested partner.
+  vector<double>
+    scratch(M12 && !M21 ? n : 0), scratch2(azi1 && !azi2 ? n : 0);
+  if (M12 && !M21) M21 = &scratch[0];
+  if (azi1 && !azi2) azi2 = &scratch2[0];
+  unsigned outmask = G::DISTANCE |
+    (azi1 ? unsigned(G::AZIMUTH) : 0U) |
+    (S12 ? unsigned(G::AREA) : 0U) |
+    (m12 ? unsigned(G::REDUCEDLENGTH) : 0U) |
+    (M12 ? unsigned(G::GEODESICSCALE) : 0U);
+  const G g(a, f);
+  mexutil::ParallelFor(n, Inverse<G>(g, outmask, lat1, lon1, lat2, lon2,
+                                     s12, azi1, azi2, S12,
+                                     m12, M12, M21, a12));
+}
+
+void mexFunction(int nlhs, mxArray* plhs[],
+                 int nrhs, const mxArray* prhs[]) {
+  if (nrhs != 6)
+    mexErrMsgTxt("Six input arguments required.");
+  if (nlhs > 8)
+    mexErrMsgTxt("More than eight output arguments specified.");
+  double
+    a = mexutil::Scalar(prhs[4], "a"),
+    f = mexutil::Scalar(prhs[5], "f");
+  try {
+    if (std::abs(f) <= 0.02)
+      compute<Geodesic>(a, f, nlhs, plhs, prhs);
+    else
+      compute<GeodesicExact>(a, f, nlhs, plhs, prhs);
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
@@ -0,0 +1,146 @@
+/**
+ * \file geodreckon_mex.cpp
+ * \brief Matlab mex backend for geodreckon
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// [lat2, lon2, azi2, S12, m12, M12, M21, a12_s12] =
+//    geodreckon_mex(lat1, lon1, s12_a12, azi1, a, f, flags)
+//
+// The arrays must have the same size and the outputs have this size.  flags
+// is interpreted as in geodreckon.  Only the requested outputs are computed.
+// Called by geodreckon and compiled by geographiclib_mex.
+
+#include <cmath>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include "mexutil.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+// Geodesic has a batch version of GenDirect; GeodesicExact does not.
+inline void GenDirect(const Geodesic& g,
+                      const double* lat1, const double* lon1,
+                      const double* azi1, bool arcmode, const double* s12_a12,
+                      size_t n, unsigned outmask,
+                      double* lat2, double* lon2, double* azi2,
+                      double* s12, double* m12, double* M12, double* M21,
+                      double* S12, double* a12) {
+  g.GenDirectBatch(lat1, lon1, azi1, arcmode, s12_a12, n, outmask,
+                   lat2, lon2, azi2, s12, m12, M12, M21, S12, a12);
+}
+
+inline void GenDirect(const GeodesicExact& g,
+                      const double* lat1, const double* lon1,
+                      const double* azi1, bool arcmode, const double* s12_a12,
+                      size_t n, unsigned outmask,
+                      double* lat2, double* lon2, double* azi2,
+                      double* s12, double* m12, double* M12, double* M21,
+                      double* S12, double* a12) {
+  double tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12;
+  for (size_t i = 0; i < n; ++i) {
+    double ta12 = g.GenDirect(lat1[i], lon1[i], azi1[i], arcmode, s12_a12[i],
+                              outmask, tlat2, tlon2, tazi2,
+                              ts12, tm12, tM12, tM21, tS12);
+    lat2[i] = tlat2; lon2[i] = tlon2; azi2[i] = tazi2;
+    if (s12) s12[i] = ts12;
+    if (m12) m12[i] = tm12;
+    if (M12) { M12[i] = tM12; M21[i] = tM21; }
+    if (S12) S12[i] = tS12;
+    if (a12) a12[i] = ta12;
+  }
+}
+
+template<class G> class Direct {
+private:
+  const G& _g;
+  bool _arcmode;
+  unsigned _outmask;
+  const double *_lat1, *_lon1, *_s12_a12, *_azi1;
+  double *_lat2, *_lon2, *_azi2, *_S12, *_m12, *_M12, *_M21, *_a12_s12;
+  static double* Off(double* p, size_t i) { return p ? p + i : 0; }
+public:
+  Direct(const G& g, bool arcmode, unsigned outmask,
+         const double* lat1, const double* lon1,
+         const double* s12_a12, const double* azi1,
+         double* lat2, double* lon2, double* azi2, double* S12,
+         double* m12, double* M12, double* M21, double* a12_s12)
+    : _g(g), _arcmode(arcmode), _outmask(outmask)
+    , _lat1(lat1), _lon1(lon1), _s12_a12(s12_a12), _azi1(azi1)
+    , _lat2(lat2), _lon2(lon2), _azi2(azi2), _S12(S12)
+    , _m12(m12), _M12(M12), _M21(M21), _a12_s12(a12_s12)
+  {}
+  void operator()(size_t i0, size_t i1) const {
+    GenDirect(_g, _lat1 + i0, _lon1 + i0, _azi1 + i0, _arcmode,
+              _s12_a12 + i0, i1 - i0, _outmask,
+              _lat2 + i0, _lon2 + i0, _azi2 + i0,
+              _arcmode ? Off(_a12_s12, i0) : 0,
+              Off(_m12, i0), Off(_M12, i0), Off(_M21, i0), Off(_S12, i0),
+              _arcmode ? 0 : Off(_a12_s12, i0));
+  }
+};
+
+template<class G>
+void compute(double a, double f, bool arcmode, bool unroll,
+             int nlhs, mxArray* plhs[], const mxArray* prhs[]) {
+  size_t n = mxGetNumberOfElements(prhs[0]);
+  const double
+    *lat1    = mexutil::Input(prhs[0], n, "lat1"),
+    *lon1    = mexutil::Input(prhs[1], n, "lon1"),
+    *s12_a12 = mexutil::Input(prhs[2], n, "s12_a12"),
+    *azi1    = mexutil::Input(prhs[3], n, "azi1");
+  double
+    *lat2    = mexutil::Output(nlhs, plhs, 0, prhs[0]),
+    *lon2    = mexutil::Output(nlhs, plhs, 1, prhs[0]),
+    *azi2    = mexutil::Output(nlhs, plhs, 2, prhs[0]),
+    *S12     = mexutil::Output(nlhs, plhs, 3, prhs[0]),
+    *m12     = mexutil::Output(nlhs, plhs, 4, prhs[0]),
+    *M12     = mexutil::Output(nlhs, plhs, 5, prhs[0]),
+    *M21     = mexutil::Output(nlhs, plhs, 6, prhs[0]),
+    *a12_s12 = mexutil::Output(nlhs, plhs, 7, prhs[0]);
+  if (n == 0) return;
+  // The position is always computed; supply scratch space for the
+  // unrequested outputs which are computed together with requested ones.
+  vector<double> scratch(lon2 ? (azi2 ? 0 : n) : 2 * n),
+    scratch2(M12 && !M21 ? n : 0);
+  if (!lon2) lon2 = &scratch[n];
+  if (!azi2) azi2 = &scratch[0];
+  if (M12 && !M21) M21 = &scratch2[0];
+  unsigned outmask = G::LATITUDE | G::LONGITUDE | G::AZIMUTH |
+    (unroll ? unsigned(G::LONG_UNROLL) : 0U) |
+    (S12 ? unsigned(G::AREA) : 0U) |
+    (m12 ? unsigned(G::REDUCEDLENGTH) : 0U) |
+    (M12 ? unsigned(G::GEODESICSCALE) : 0U) |
+    (arcmode && a12_s12 ? unsigned(G::DISTANCE) : 0U);
+  const G g(a, f);
+  mexutil::ParallelFor(n, Direct<G>(g, arcmode, outmask,
+                                    lat1, lon1, s12_a12, azi1,
+                                    lat2, lon2, azi2, S12,
+                                    m12, M12, M21, a12_s12));
+}
+
+void mexFunction(int nlhs, mxArray* plhs[],
+                 int nrhs, const mxArray* prhs[]) {
+  if (nrhs != 7)
+    mexErrMsgTxt("Seven input arguments required.");
+  if (nlhs > 8)
+    mexErrMsgTxt("More than eight output arguments specified.");
+  double
+    a = mexutil::Scalar(prhs[4], "a"),
+    f = mexutil::Scalar(prhs[5], "f");
+  int flags = int(mexutil::Scalar(prhs[6], "flags"));
+  bool arcmode = (flags & 1) != 0, unroll = (flags & 2) != 0;
+  try {
+    if (std::abs(f) <= 0.02)
+      compute<Geodesic>(a, f, arcmode, unroll, nlhs, plhs, prhs);
+    else
+      compute<GeodesicExact>(a, f, arcmode, unroll, nlhs, plhs, prhs);
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
@@ -0,0 +1,108 @@
+/**
+ * \file geoid_height_mex.cpp
+ * \brief Matlab mex backend for geoid_height
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// N = geoid_height_mex(lat, lon, geoidname, geoiddir)
+//     geoid_height_mex
+//
+// lat and lon must have the same size and N has this size.  The geoid file
+// is geoiddir/geoidname.pgm.  The geoid is loaded into memory on the first
+// call and stays resident (for use by subsequent calls with the same file)
+// until geoid_height_mex is called with no arguments or the mex file is
+// cleared.  Points with invalid latitudes or longitudes give NaN.  Called by
+// geoid_height and compiled by geographiclib_mex.
+
+#include <cmath>
+#include <GeographicLib/Geoid.hpp>
+#include "mexutil.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+namespace {
+
+  // The resident geoid and its file name.
+  Geoid* geoid_ = 0;
+  std::string file_;
+
+  void Clear() {
+    delete geoid_;
+    geoid_ = 0;
+    file_.clear();
+  }
+
+  std::string String(const mxArray* a, const char* name) {
+    if (!mxIsChar(a))
+      mexErrMsgIdAndTxt("GeographicLib:mex", "%s must be a string", name);
+    char* s = mxArrayToString(a);
+    std::string str(s ? s : "");
+    mxFree(s);
+    return str;
+  }
+
+}
+
+class Height {
+private:
+  const Geoid& _g;
+  const double *_lat, *_lon;
+  double* _h;
+public:
+  Height(const Geoid& g, const double* lat, const double* lon, double* h)
+    : _g(g), _lat(lat), _lon(lon), _h(h) {}
+  void operator()(size_t i0, size_t i1) const {
+    // Copy blocks of points replacing invalid coordinates by NaNs.
+    const size_t nb = 1024;
+    double lat[nb], lon[nb];
+    for (size_t j0 = i0; j0 < i1; j0 += nb) {
+      size_t k = min(nb, i1 - j0);
+      for (size_t j = 0; j < k; ++j) {
+        bool ok = abs(_lat[j0 + j]) <= 90 && abs(_lon[j0 + j]) <= 540;
+        lat[j] = ok ? _lat[j0 + j] : Math::NaN();
+        lon[j] = ok ? _lon[j0 + j] : Math::NaN();
+      }
+      _g.HeightBatch(lat, lon, _h + j0, k);
+    }
+  }
+};
+
+void mexFunction(int nlhs, mxArray* plhs[],
+                 int nrhs, const mxArray* prhs[]) {
+  mexAtExit(Clear);
+  if (nrhs == 0) {
+    Clear();
+    return;
+  }
+  if (nrhs != 4)
+    mexErrMsgTxt("Four input arguments required.");
+  if (nlhs > 1)
+    mexErrMsgTxt("Only one output argument allowed.");
+  size_t n = mxGetNumberOfElements(prhs[0]);
+  const double
+    *lat = mexutil::Input(prhs[0], n, "lat"),
+    *lon = mexutil::Input(prhs[1], n, "lon");
+  std::string
+    name = String(prhs[2], "geoidname"),
+    dir = String(prhs[3], "geoiddir"),
+    file = dir + "/" + name + ".pgm";
+  try {
+    if (!geoid_ || file != file_) {
+      Clear();
+      // threadsafe = true reads the whole data set into memory so that the
+      // geoid can be used concurrently.
+      geoid_ = new Geoid(name, dir, true, true);
+      file_ = file;
+    }
+  }
+  catch (const std::exception& e) {
+    Clear();
+    mexErrMsgTxt(e.what());
+  }
+  double* h = mexutil::Output(nlhs, plhs, 0, prhs[0]);
+  mexutil::ParallelFor(n, Height(*geoid_, lat, lon, h));
+}
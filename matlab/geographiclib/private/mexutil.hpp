@@ -0,0 +1,129 @@
+/**
+ * \file mexutil.hpp
+ * \brief Common code for the optional mex backends of the matlab functions
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// The mex files are compiled by geographiclib_mex.  The calculations are
+// carried out by the batch functions in GeographicLib; the points are divided
+// into contiguous ranges which are evaluated concurrently (if the compiler
+// supports C++11 threads).  The number of threads is given by the
+// environment variable GEOGRAPHICLIB_MEX_THREADS, if set, and otherwise is
+// the number of hardware threads.  No mex functions are called from the
+// worker threads.
+
+#if !defined(GEOGRAPHICLIB_MEXUTIL_HPP)
+#define GEOGRAPHICLIB_MEXUTIL_HPP 1
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <GeographicLib/Constants.hpp>
+#include <mex.h>
+
+#if !defined(GEOGRAPHICLIB_MEX_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_MEX_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_MEX_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_MEX_THREADS
+#  include <thread>
+#  include <system_error>
+#endif
+
+namespace mexutil {
+
+  // Don't give a thread fewer than this many points.
+  const size_t minchunk_ = 8192;
+
+  inline size_t NumThreads(size_t n) {
+#if GEOGRAPHICLIB_MEX_THREADS
+    size_t nt = std::thread::hardware_concurrency();
+    const char* s = std::getenv("GEOGRAPHICLIB_MEX_THREADS");
+    if (s && std::atoi(s) > 0) nt = size_t(std::atoi(s));
+    return std::max(size_t(1), std::min(nt, n / minchunk_));
+#else
+    (void)n;
+    return 1;
+#endif
+  }
+
+  // Run func(i0, i1) on a range of points, catching any exception so that it
+  // can be reported in the matlab thread.
+  template<class Func>
+  void RunRange(const Func* func, size_t i0, size_t i1, std::string* err) {
+    try {
+      (*func)(i0, i1);
+    }
+    catch (const std::exception& e) {
+      *err = e.what();
+      if (err->empty()) *err = "Unknown error";
+    }
+  }
+
+  // Evaluate func(i0, i1) for contiguous ranges covering [0, n).  func must
+  // be safe to call concurrently on disjoint ranges.  An error is raised
+  // (with mexErrMsgTxt) if func throws an exception.
+  template<class Func> void ParallelFor(size_t n, const Func& func) {
+    size_t nt = NumThreads(n), per = (n + nt - 1) / std::max(nt, size_t(1));
+    std::vector<std::string> errs(nt);
+#if GEOGRAPHICLIB_MEX_THREADS
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nt; ++t) {
+      size_t i0 = std::min(n, t * per), i1 = std::min(n, i0 + per);
+      try {
+        threads.push_back(std::thread(&RunRange<Func>, &func, i0, i1,
+                                      &errs[t]));
+      }
+      catch (const std::system_error&) {
+        RunRange(&func, i0, i1, &errs[t]);
+      }
+    }
+#endif
+    RunRange(&func, size_t(0), std::min(n, per), &errs[0]);
+#if GEOGRAPHICLIB_MEX_THREADS
+    for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+#endif
+    for (size_t t = 0; t < nt; ++t)
+      if (!errs[t].empty())
+        mexErrMsgTxt(errs[t].c_str());
+  }
+
+  // The data of a real double argument with n elements.
+  inline const double* Input(const mxArray* a, size_t n, const char* name) {
+    if (!( mxIsDouble(a) && !mxIsComplex(a) && mxGetNumberOfElements(a) == n ))
+      mexErrMsgIdAndTxt("GeographicLib:mex", "%s must be a real double array "
+                        "of the same size as the other arrays", name);
+    return mxGetPr(a);
+  }
+
+  // The value of a real double scalar argument.
+  inline double Scalar(const mxArray* a, const char* name) {
+    if (!( mxIsDouble(a) && !mxIsComplex(a) && mxGetNumberOfElements(a) == 1 ))
+      mexErrMsgIdAndTxt("GeographicLib:mex", "%s must be a real scalar", name);
+    return mxGetScalar(a);
+  }
+
+  // Create output k with the same shape as shape (if it is requested) and
+  // return its data; otherwise return a null pointer.
+  inline double* Output(int nlhs, mxArray* plhs[], int k,
+                        const mxArray* shape) {
+    if (k >= std::max(nlhs, 1)) return 0;
+    plhs[k] = mxCreateNumericArray(mxGetNumberOfDimensions(shape),
+                                   mxGetDimensions(shape),
+                                   mxDOUBLE_CLASS, mxREAL);
+    return mxGetPr(plhs[k]);
+  }
+
+} // namespace mexutil
+
+#endif  // GEOGRAPHICLIB_MEXUTIL_HPP
@@ -0,0 +1,98 @@
+/**
+ * \file tranmerc_fwd_mex.cpp
+ * \brief Matlab mex backend for tranmerc_fwd
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// [x, y, gam, k] = tranmerc_fwd_mex(lat0, lon0, lat, lon, a, f)
+//
+// lat and lon must have the same size and the outputs have this size.  lat0
+// and lon0 are either scalars or arrays of this size.  The convergence and
+// scale are only computed if they are requested.  Called by tranmerc_fwd
+// and compiled by geographiclib_mex.
+
+#include <GeographicLib/TransverseMercator.hpp>
+#include "mexutil.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+class Forward {
+private:
+  const TransverseMercator& _tm;
+  const double *_lat0, *_lon0, *_lat, *_lon;
+  bool _scalar;
+  double *_x, *_y, *_gam, *_k;
+  static double* Off(double* p, size_t i) { return p ? p + i : 0; }
+  double Y0(double lat0) const {
+    double x0, y0;
+    if (lat0 == 0) return 0;
+    _tm.Forward(0, lat0, 0, x0, y0);
+    return y0;
+  }
+public:
+  Forward(const TransverseMercator& tm,
+          const double* lat0, const double* lon0, bool scalar,
+          const double* lat, const double* lon,
+          double* x, double* y, double* gam, double* k)
+    : _tm(tm), _lat0(lat0), _lon0(lon0), _lat(lat), _lon(lon)
+    , _scalar(scalar), _x(x), _y(y), _gam(gam), _k(k)
+  {}
+  void operator()(size_t i0, size_t i1) const {
+    if (_scalar) {
+      // A single central meridian; use the batch projection.
+      _tm.Forward(_lon0[0], _lat + i0, _lon + i0, i1 - i0,
+                  _x + i0, _y + i0, Off(_gam, i0), Off(_k, i0));
+      double y0 = Y0(_lat0[0]);
+      if (y0 != 0)
+        for (size_t i = i0; i < i1; ++i)
+          _y[i] -= y0;
+    } else {
+      double gam, k;
+      for (size_t i = i0; i < i1; ++i) {
+        _tm.Forward(_lon0[i], _lat[i], _lon[i], _x[i], _y[i], gam, k);
+        _y[i] -= Y0(_lat0[i]);
+        if (_gam) _gam[i] = gam;
+        if (_k) _k[i] = k;
+      }
+    }
+  }
+};
+
+void mexFunction(int nlhs, mxArray* plhs[],
+                 int nrhs, const mxArray* prhs[]) {
+  if (nrhs != 6)
+    mexErrMsgTxt("Six input arguments required.");
+  if (nlhs > 4)
+    mexErrMsgTxt("More than four output arguments specified.");
+  size_t n = mxGetNumberOfElements(prhs[2]);
+  bool scalar = mxGetNumberOfElements(prhs[0]) == 1 &&
+    mxGetNumberOfElements(prhs[1]) == 1;
+  const double
+    *lat0 = mexutil::Input(prhs[0], scalar ? 1 : n, "lat0"),
+    *lon0 = mexutil::Input(prhs[1], scalar ? 1 : n, "lon0"),
+    *lat  = mexutil::Input(prhs[2], n, "lat"),
+    *lon  = mexutil::Input(prhs[3], n, "lon");
+  double
+    a = mexutil::Scalar(prhs[4], "a"),
+    f = mexutil::Scalar(prhs[5], "f");
+  double *x = mexutil::Output(nlhs, plhs, 0, prhs[2]),
+    *y = mexutil::Output(nlhs, plhs, 1, prhs[2]),
+    *gam = mexutil::Output(nlhs, plhs, 2, prhs[2]),
+    *k = mexutil::Output(nlhs, plhs, 3, prhs[2]);
+  if (n == 0) return;
+  // y is needed even if it isn't requested
+  vector<double> ytemp(y ? 0 : n);
+  if (!y) y = &ytemp[0];
+  try {
+    const TransverseMercator tm(a, f, 1);
+    mexutil::ParallelFor(n, Forward(tm, lat0, lon0, scalar, lat, lon,
+                                    x, y, gam, k));
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+}
@@ -0,0 +1,21 @@
+function p = usemex(name, varargin)
+%USEMEX  Check whether a mex backend can be used
+%
+%   p = USEMEX(name, arg1, arg2, ...) returns true if the mex file
+%   name_mex has been compiled (by geographiclib_mex) into this directory
+%   and all the args are full real double arrays.  Set the environment
+%   variable GEOGRAPHICLIB_MEX to 0 to disable the mex backends.
+
+  persistent dir ext
+  if isempty(dir)
+    dir = fileparts(mfilename('fullpath'));
+    ext = mexext;
+  end
+  p = ~strcmp(getenv('GEOGRAPHICLIB_MEX'), '0') && ...
+      exist(fullfile(dir, [name '_mex.' ext]), 'file') ~= 0;
+  for i = 1:length(varargin)
+    if ~p, break, end
+    x = varargin{i};
+    p = isa(x, 'double') && isreal(x) && ~issparse(x);
+  end
+end
@@ -0,0 +1,89 @@
+/**
+ * \file utmups_fwd_mex.cpp
+ * \brief Matlab mex backend for utmups_fwd
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// [x, y, zone, isnorth, gam, k] = utmups_fwd_mex(lat, lon, setzone)
+//
+// lat and lon must have the same size and the outputs have this size.
+// setzone is a scalar in [-4, 60].  Points which can't be converted give
+// zone = -4, isnorth = false, and NaNs for the other outputs.  Called by
+// utmups_fwd and compiled by geographiclib_mex.
+
+#include <GeographicLib/UTMUPS.hpp>
+#include "mexutil.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+class Forward {
+private:
+  const double *_lat, *_lon;
+  int _setzone;
+  int* _zone;
+  bool* _northp;
+  double *_x, *_y, *_gam, *_k;
+  static double* Off(double* p, size_t i) { return p ? p + i : 0; }
+public:
+  Forward(const double* lat, const double* lon, int setzone,
+          int* zone, bool* northp,
+          double* x, double* y, double* gam, double* k)
+    : _lat(lat), _lon(lon), _setzone(setzone), _zone(zone), _northp(northp)
+    , _x(x), _y(y), _gam(gam), _k(k)
+  {}
+  void operator()(size_t i0, size_t i1) const {
+    UTMUPS::ForwardBatch(_lat + i0, _lon + i0, i1 - i0,
+                         _zone + i0, _northp + i0, _x + i0, _y + i0,
+                         Off(_gam, i0), Off(_k, i0), 0, _setzone);
+    for (size_t i = i0; i < i1; ++i)
+      if (_zone[i] == UTMUPS::INVALID) _northp[i] = false;
+  }
+};
+
+void mexFunction(int nlhs, mxArray* plhs[],
+                 int nrhs, const mxArray* prhs[]) {
+  if (nrhs != 3)
+    mexErrMsgTxt("Three input arguments required.");
+  if (nlhs > 6)
+    mexErrMsgTxt("More than six output arguments specified.");
+  size_t n = mxGetNumberOfElements(prhs[0]);
+  const double
+    *lat = mexutil::Input(prhs[0], n, "lat"),
+    *lon = mexutil::Input(prhs[1], n, "lon");
+  int setzone = int(mexutil::Scalar(prhs[2], "setzone"));
+  if (!(setzone >= UTMUPS::MINPSEUDOZONE && setzone <= UTMUPS::MAXZONE))
+    mexErrMsgTxt("setzone must be in [-4, 60]");
+  double
+    *x = mexutil::Output(nlhs, plhs, 0, prhs[0]),
+    *y = mexutil::Output(nlhs, plhs, 1, prhs[0]),
+    *zone = mexutil::Output(nlhs, plhs, 2, prhs[0]),
+    *gam = mexutil::Output(nlhs, plhs, 4, prhs[0]),
+    *k = mexutil::Output(nlhs, plhs, 5, prhs[0]);
+  // isnorth is always computed; it is destroyed below if not requested.
+  mxArray* north = mxCreateLogicalArray(mxGetNumberOfDimensions(prhs[0]),
+                                        mxGetDimensions(prhs[0]));
+  bool* isnorth = mxGetLogicals(north);
+  if (nlhs > 3)
+    plhs[3] = north;
+  if (n == 0) return;
+  // Scratch space for the other outputs which are always computed.
+  vector<int> izone(n);
+  vector<double> ytemp(y ? 0 : n);
+  if (!y) y = &ytemp[0];
+  try {
+    mexutil::ParallelFor(n, Forward(lat, lon, setzone, &izone[0], isnorth,
+                                    x, y, gam, k));
+  }
+  catch (const std::exception& e) {
+    mexErrMsgTxt(e.what());
+  }
+  if (zone)
+    for (size_t i = 0; i < n; ++i)
+      zone[i] = izone[i];
+  if (nlhs <= 3)
+    mxDestroyArray(north);
+}
@@ -36,8 +36,11 @@ function [x, y, gam, k] = tranmerc_fwd(lat0, lon0, lat, lon, ellipsoid)
 %   less than 1 mm within 7600 km of the central meridian).  The mapping
 %   can be continued accurately over the poles to the opposite meridian.
 %
+%   If the mex backends have been compiled with geographiclib_mex, this
+%   function calls the C++ library to compute the results.
+%
 %   See also PROJDOC, TRANMERC_INV, UTMUPS_FWD, UTMUPS_INV,
-%     DEFAULTELLIPSOID.
+%     DEFAULTELLIPSOID, GEOGRAPHICLIB_MEX.
 
 % Copyright (c) Charles Karney (2012-2015) <charles@karney.com>.
 %
@@ -53,6 +56,17 @@ function [x, y, gam, k] = tranmerc_fwd(lat0, lon0, lat, lon, ellipsoid)
   if length(ellipsoid(:)) ~= 2
     error('ellipsoid must be a vector of size 2')
   end
+  if usemex('tranmerc_fwd', lat0, lon0, lat, lon)
+    if ~(isscalar(lat0) && isscalar(lon0))
+      lat0 = lat0 + Z; lon0 = lon0 + Z;
+    end
+    r = cell(1, max(nargout, 1));
+    [r{:}] = tranmerc_fwd_mex(lat0, lon0, lat + Z, lon + Z, ...
+                              ellipsoid(1), real(ecc2flat(ellipsoid(2))));
+    r(end+1:4) = {[]};
+    [x, y, gam, k] = r{:};
+    return
+  end
 
   degree = pi/180;
   maxpow = 6;
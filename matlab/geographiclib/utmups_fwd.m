@@ -41,7 +41,12 @@ function [x, y, zone, isnorth, gam, k] = utmups_fwd(lat, lon, setzone)
 %   above.  If these conditions don't hold (x,y), gam, k are converted to
 %   NaN, zone to -4 and isnorthp to 0.
 %
-%   See also UTMUPS_INV, TRANMERC_FWD, POLARST_FWD, MGRS_FWD.
+%   If the mex backends have been compiled with geographiclib_mex and
+%   setzone is a scalar, this function calls the C++ library to compute
+%   the results.
+%
+%   See also UTMUPS_INV, TRANMERC_FWD, POLARST_FWD, MGRS_FWD,
+%     GEOGRAPHICLIB_MEX.
 
 % Copyright (c) Charles Karney (2015) <charles@karney.com>.
 %
@@ -55,6 +60,14 @@ function [x, y, zone, isnorth, gam, k] = utmups_fwd(lat, lon, setzone)
     error('lat, lon, setzone have incompatible sizes')
   end
   lat = lat + Z; lon = lon + Z;
+  if isscalar(setzone) && floor(setzone) >= -4 && floor(setzone) <= 60 && ...
+        usemex('utmups_fwd', lat, lon)
+    r = cell(1, max(nargout, 1));
+    [r{:}] = utmups_fwd_mex(lat, lon, floor(setzone));
+    r(end+1:6) = {[]};
+    [x, y, zone, isnorth, gam, k] = r{:};
+    return
+  end
   isnorth = lat >= 0;
   zone = StandardZone(lat, lon, setzone);
   Z = nan(size(Z));
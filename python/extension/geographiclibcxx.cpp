@@ -0,0 +1,1258 @@
+/**
+ * \file geographiclibcxx.cpp
+ * \brief Python extension module for the C++ GeographicLib classes
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed under
+ * the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+// This is built by cmake if GEOGRAPHICLIB_PYTHON_EXTENSION is ON.  To
+// compile it by hand, use, e.g.,
+// [Unix]
+// c++ -O2 -shared -fPIC $(python3-config --includes) -I/usr/local/include
+//    geographiclibcxx.cpp -L/usr/local/lib -Wl,-rpath=/usr/local/lib
+//    -lGeographic -o geographiclibcxx$(python3-config --extension-suffix)
+//
+// The batch methods take their array arguments as objects supporting the
+// buffer protocol (e.g., numpy arrays or array.array objects) which are
+// accessed in place.  The results are returned as array.array objects
+// (numpy.asarray wraps these without copying) or are written into the
+// buffers given in the out argument.  The global interpreter lock is
+// released during the computations.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Executor.hpp>
+
+#if GEOGRAPHICLIB_PRECISION != 2
+#  error "The python extension requires GEOGRAPHICLIB_PRECISION = 2"
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+#  define PyInt_FromLong PyLong_FromLong
+#endif
+
+using namespace std;
+using namespace GeographicLib;
+
+namespace {
+
+  PyObject* GeographicErrType = 0;  // geographiclibcxx.GeographicErr
+  PyObject* ArrayType = 0;          // array.array
+
+  // A Py_buffer which is released when it goes out of scope.  kind is 'd'
+  // (double), 'i' (int), 'z' (32-bit or 64-bit signed integer), or '?'
+  // (bool).
+  class View {
+  private:
+    Py_buffer _v;
+    bool _held;
+    View(const View&);
+    View& operator=(const View&);
+  public:
+    View() : _held(false) {}
+    ~View() { if (_held) PyBuffer_Release(&_v); }
+    bool Get(PyObject* obj, char kind, bool writable, const char* name) {
+      if (PyObject_GetBuffer(obj, &_v, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT |
+                             (writable ? PyBUF_WRITABLE : 0)) < 0)
+        return false;
+      _held = true;
+      const char* f = _v.format ? _v.format : "B";
+      if (*f == '@' || *f == '=') ++f;
+      bool ok = f[0] && !f[1] &&
+        (kind == 'd' ? f[0] == 'd' && _v.itemsize == sizeof(double) :
+         kind == 'i' ? (f[0] == 'i' || f[0] == 'l') &&
+         _v.itemsize == sizeof(int) :
+         kind == 'z' ? (f[0] == 'i' || f[0] == 'l' || f[0] == 'q' ||
+                        f[0] == 'n') &&
+         (_v.itemsize == 4 || _v.itemsize == 8) :
+         (f[0] == '?' || f[0] == 'b' || f[0] == 'B') && _v.itemsize == 1);
+      if (!ok) {
+        PyErr_Format(PyExc_TypeError, "%s must be a buffer of %s", name,
+                     kind == 'd' ? "doubles" :
+                     kind == 'i' ? "ints" :
+                     kind == 'z' ? "integers" : "bools");
+        return false;
+      }
+      return true;
+    }
+    Py_ssize_t Size() const { return _held ? _v.len / _v.itemsize : 0; }
+    void* Data() const { return _v.buf; }
+    // Element i of a buffer of kind 'z'
+    long long Integer(Py_ssize_t i) const {
+      return _v.itemsize == 4 ?
+        (long long)(static_cast<const int*>(_v.buf)[i]) :
+        static_cast<const long long*>(_v.buf)[i];
+    }
+  };
+
+  // The input arrays of a batch call, which must have the same length.
+  class Inputs {
+  private:
+    static const int maxin_ = 5;
+    int _k;
+    View _view[maxin_];
+  public:
+    Inputs() : _k(0) {}
+    bool Add(PyObject* obj, char kind, const char* name) {
+      return _view[_k++].Get(obj, kind, false, name);
+    }
+    // The common length of the arrays; -1 (with an exception set) if they
+    // differ.
+    Py_ssize_t Size() const {
+      Py_ssize_t n = _view[0].Size();
+      for (int i = 1; i < _k; ++i)
+        if (_view[i].Size() != n) {
+          PyErr_SetString(PyExc_ValueError, "arrays have different lengths");
+          return -1;
+        }
+      return n;
+    }
+    const double* D(int i) const
+    { return static_cast<const double*>(_view[i].Data()); }
+    const int* I(int i) const
+    { return static_cast<const int*>(_view[i].Data()); }
+    const unsigned char* B(int i) const
+    { return static_cast<const unsigned char*>(_view[i].Data()); }
+  };
+
+  // A copy of an array of flags (bytes) as bools.
+  class Flags {
+  private:
+    bool* _b;
+    Flags(const Flags&);
+    Flags& operator=(const Flags&);
+  public:
+    Flags(const unsigned char* p, size_t n) : _b(new bool[n ? n : 1]) {
+      for (size_t i = 0; i < n; ++i) _b[i] = p[i] != 0;
+    }
+    ~Flags() { delete[] _b; }
+    const bool* Data() const { return _b; }
+  };
+
+  // The output arrays of a batch call.  These are either the writable
+  // buffers supplied by the caller in out or new array.array objects.
+  class Outputs {
+  private:
+    static const int maxout_ = 9;
+    int _k;
+    PyObject* _obj[maxout_];
+    View _view[maxout_];
+  public:
+    Outputs() : _k(0) {}
+    ~Outputs() { for (int i = 0; i < _k; ++i) Py_XDECREF(_obj[i]); }
+    // kinds gives the kinds of the outputs, e.g., "dd" for two arrays of
+    // doubles.
+    bool Init(PyObject* out, const char* kinds, Py_ssize_t n) {
+      int k = int(strlen(kinds));
+      PyObject* seq = 0;
+      if (out && out != Py_None) {
+        seq = PySequence_Fast(out, "out must be a sequence");
+        if (!seq) return false;
+        if (PySequence_Fast_GET_SIZE(seq) != k) {
+          PyErr_Format(PyExc_ValueError, "out must have %d elements", k);
+          Py_DECREF(seq);
+          return false;
+        }
+      }
+      bool ok = true;
+      for (; ok && _k < k; ++_k) {
+        char kind = kinds[_k];
+        if (seq) {
+          _obj[_k] = PySequence_Fast_GET_ITEM(seq, _k);
+          Py_INCREF(_obj[_k]);
+        } else {
+          size_t size = kind == 'd' ? sizeof(double) :
+            kind == 'i' ? sizeof(int) : 1;
+          PyObject* bytes = PyBytes_FromStringAndSize(0, n * size);
+          if (!bytes) { ok = false; break; }
+          memset(PyBytes_AS_STRING(bytes), 0, n * size);
+          _obj[_k] = PyObject_CallFunction(ArrayType, "sO",
+                                           kind == 'd' ? "d" :
+                                           kind == 'i' ? "i" : "B", bytes);
+          Py_DECREF(bytes);
+          if (!_obj[_k]) { ok = false; break; }
+        }
+        ok = _view[_k].Get(_obj[_k], kind, true, "out");
+        if (ok && _view[_k].Size() != n) {
+          PyErr_SetString(PyExc_ValueError,
+                          "out arrays have the wrong length");
+          ok = false;
+        }
+      }
+      Py_XDECREF(seq);
+      return ok;
+    }
+    double* D(int i) const { return static_cast<double*>(_view[i].Data()); }
+    int* I(int i) const { return static_cast<int*>(_view[i].Data()); }
+    bool* B(int i) const { return static_cast<bool*>(_view[i].Data()); }
+    // A single array or a tuple of the arrays.
+    PyObject* Result() const {
+      if (_k == 1) {
+        Py_INCREF(_obj[0]);
+        return _obj[0];
+      }
+      PyObject* t = PyTuple_New(_k);
+      if (!t) return 0;
+      for (int i = 0; i < _k; ++i) {
+        Py_INCREF(_obj[i]);
+        PyTuple_SET_ITEM(t, i, _obj[i]);
+      }
+      return t;
+    }
+  };
+
+  // Release the global interpreter lock while in scope (if release is
+  // true).
+  class Unlock {
+  private:
+    PyThreadState* _save;
+    Unlock(const Unlock&);
+    Unlock& operator=(const Unlock&);
+  public:
+    explicit Unlock(bool release = true)
+      : _save(release ? PyEval_SaveThread() : 0) {}
+    ~Unlock() { if (_save) PyEval_RestoreThread(_save); }
+  };
+
+  // An exception caught while the lock was released; Raise sets the python
+  // exception and returns true if there was one.
+  class Error {
+  private:
+    string _msg;
+    PyObject* _type;
+  public:
+    Error() : _type(0) {}
+    void Set(const GeographicErr& e)
+    { _msg = e.what(); _type = GeographicErrType; }
+    void Set(const std::bad_alloc&) { _type = PyExc_MemoryError; }
+    void Set(const std::exception& e)
+    { _msg = e.what(); _type = PyExc_RuntimeError; }
+    bool Raise() const {
+      if (!_type) return false;
+      if (_type == PyExc_MemoryError)
+        PyErr_NoMemory();
+      else
+        PyErr_SetString(_type, _msg.c_str());
+      return true;
+    }
+  };
+
+#define GEOGRAPHICLIB_PY_CATCH(err)                             \
+  catch (const GeographicErr& e) { err.Set(e); }                \
+  catch (const std::bad_alloc& e) { err.Set(e); }               \
+  catch (const std::exception& e) { err.Set(e); }
+
+  // The python objects holding the C++ objects.
+  template<class T> struct Wrapper {
+    PyObject_HEAD
+    T* obj;
+  };
+
+  template<class T> void Dealloc(PyObject* self) {
+    delete reinterpret_cast<Wrapper<T>*>(self)->obj;
+    Py_TYPE(self)->tp_free(self);
+  }
+
+  template<class T> const T& Obj(PyObject* self)
+  { return *reinterpret_cast<Wrapper<T>*>(self)->obj; }
+
+  // Create a python object of the given type taking ownership of obj.
+  template<class T> PyObject* Wrap(PyTypeObject* type, T* obj) {
+    PyObject* self = type->tp_alloc(type, 0);
+    if (!self) {
+      delete obj;
+      return 0;
+    }
+    reinterpret_cast<Wrapper<T>*>(self)->obj = obj;
+    return self;
+  }
+
+  // The cast needed for the entries in PyMethodDef with METH_KEYWORDS
+  PyCFunction KeywordFunction(PyObject* (*f)(PyObject*, PyObject*,
+                                             PyObject*)) {
+    return reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(f));
+  }
+
+  int Nthreads(int nthreads) {
+    if (nthreads < 1) {
+      PyErr_SetString(PyExc_ValueError, "nthreads must be positive");
+      return 0;
+    }
+    return nthreads;
+  }
+
+  /* ------------------------------------------------------------------ */
+  /* TransverseMercator                                                   */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject TransverseMercatorType;
+
+  PyObject* TransverseMercatorNew(PyTypeObject* type, PyObject* args,
+                                  PyObject* kwds) {
+    static const char* kwlist[] = {"a", "f", "k0", 0};
+    double
+      a = Constants::WGS84_a(), f = Constants::WGS84_f(),
+      k0 = Constants::UTM_k0();
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ddd",
+                                     const_cast<char**>(kwlist),
+                                     &a, &f, &k0))
+      return 0;
+    try {
+      return Wrap(type, new TransverseMercator(a, f, k0));
+    }
+    catch (const GeographicErr& e) {
+      PyErr_SetString(GeographicErrType, e.what());
+      return 0;
+    }
+  }
+
+  // Forward and Reverse for TransverseMercator
+  PyObject* TransverseMercatorRun(PyObject* self, PyObject* args,
+                                  PyObject* kwds, bool fwd) {
+    static const char* kwlist[] = {"lon0", "a", "b", "scale", "out", 0};
+    double lon0;
+    PyObject *a, *b, *out = 0;
+    int scale = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dOO|iO",
+                                     const_cast<char**>(kwlist),
+                                     &lon0, &a, &b, &scale, &out))
+      return 0;
+    Inputs in;
+    if (!(in.Add(a, 'd', fwd ? "lat" : "x") &&
+          in.Add(b, 'd', fwd ? "lon" : "y")))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, scale ? "dddd" : "dd", n))
+      return 0;
+    const TransverseMercator& tm = Obj<TransverseMercator>(self);
+    {
+      Unlock unlock;
+      double
+        *gamma = scale ? res.D(2) : 0,
+        *k = scale ? res.D(3) : 0;
+      if (fwd)
+        tm.Forward(lon0, in.D(0), in.D(1), n, res.D(0), res.D(1), gamma, k);
+      else
+        tm.Reverse(lon0, in.D(0), in.D(1), n, res.D(0), res.D(1), gamma, k);
+    }
+    return res.Result();
+  }
+
+  PyObject* TransverseMercatorForward(PyObject* self, PyObject* args,
+                                      PyObject* kwds)
+  { return TransverseMercatorRun(self, args, kwds, true); }
+
+  PyObject* TransverseMercatorReverse(PyObject* self, PyObject* args,
+                                      PyObject* kwds)
+  { return TransverseMercatorRun(self, args, kwds, false); }
+
+  PyMethodDef TransverseMercatorMethods[] = {
+    {"Forward", KeywordFunction(TransverseMercatorForward),
+     METH_VARARGS | METH_KEYWORDS,
+     "Forward(lon0, lat, lon, scale=False, out=None)\n\n"
+     "Forward projection of arrays of latitudes and longitudes (degrees)\n"
+     "with central meridian lon0.  Returns (x, y) or, if scale is true,\n"
+     "(x, y, gamma, k)."},
+    {"Reverse", KeywordFunction(TransverseMercatorReverse),
+     METH_VARARGS | METH_KEYWORDS,
+     "Reverse(lon0, x, y, scale=False, out=None)\n\n"
+     "Reverse projection of arrays of eastings and northings (meters)\n"
+     "with central meridian lon0.  Returns (lat, lon) or, if scale is\n"
+     "true, (lat, lon, gamma, k)."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* UTMUPS                                                               */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject UTMUPSType;
+
+  PyObject* UTMUPSForward(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"lat", "lon", "setzone", "mgrslimits",
+                                   "scale", "out", 0};
+    PyObject *lat, *lon, *out = 0;
+    int setzone = UTMUPS::STANDARD, mgrslimits = 0, scale = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|iiiO",
+                                     const_cast<char**>(kwlist),
+                                     &lat, &lon, &setzone, &mgrslimits,
+                                     &scale, &out))
+      return 0;
+    Inputs in;
+    if (!(in.Add(lat, 'd', "lat") && in.Add(lon, 'd', "lon")))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, scale ? "i?dddd" : "i?dd", n))
+      return 0;
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        UTMUPS::ForwardBatch(in.D(0), in.D(1), n,
+                             res.I(0), res.B(1), res.D(2), res.D(3),
+                             scale ? res.D(4) : 0, scale ? res.D(5) : 0,
+                             0, setzone, mgrslimits != 0);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyObject* UTMUPSReverse(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"zone", "northp", "x", "y", "mgrslimits",
+                                   "scale", "out", 0};
+    PyObject *zone, *northp, *x, *y, *out = 0;
+    int mgrslimits = 0, scale = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|iiO",
+                                     const_cast<char**>(kwlist),
+                                     &zone, &northp, &x, &y, &mgrslimits,
+                                     &scale, &out))
+      return 0;
+    Inputs in;
+    if (!(in.Add(zone, 'i', "zone") && in.Add(northp, '?', "northp") &&
+          in.Add(x, 'd', "x") && in.Add(y, 'd', "y")))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, scale ? "dddd" : "dd", n))
+      return 0;
+    {
+      Unlock unlock;
+      double
+        *la = res.D(0), *lo = res.D(1),
+        *gamma = scale ? res.D(2) : 0, *k = scale ? res.D(3) : 0;
+      for (Py_ssize_t i = 0; i < n; ++i) {
+        double g, s;
+        try {
+          UTMUPS::Reverse(in.I(0)[i], in.B(1)[i] != 0, in.D(2)[i], in.D(3)[i],
+                          la[i], lo[i], g, s, mgrslimits != 0);
+        }
+        catch (const GeographicErr&) {
+          la[i] = lo[i] = g = s = Math::NaN();
+        }
+        if (scale) { gamma[i] = g; k[i] = s; }
+      }
+    }
+    return res.Result();
+  }
+
+  PyMethodDef UTMUPSMethods[] = {
+    {"Forward", KeywordFunction(UTMUPSForward),
+     METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+     "Forward(lat, lon, setzone=-1, mgrslimits=False, scale=False,\n"
+     "        out=None)\n\n"
+     "Convert arrays of latitudes and longitudes (degrees) to UTM/UPS.\n"
+     "Returns (zone, northp, x, y) or, if scale is true, (zone, northp,\n"
+     "x, y, gamma, k).  The zone is INVALID (-4) for points which cannot\n"
+     "be converted."},
+    {"Reverse", KeywordFunction(UTMUPSReverse),
+     METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+     "Reverse(zone, northp, x, y, mgrslimits=False, scale=False, out=None)\n"
+     "\n"
+     "Convert arrays of UTM/UPS coordinates to latitudes and longitudes.\n"
+     "Returns (lat, lon) or, if scale is true, (lat, lon, gamma, k).  The\n"
+     "results are NaNs for points which cannot be converted."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* MGRS                                                                 */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject MGRSType;
+
+  PyObject* MGRSForward(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"zone", "northp", "x", "y", "prec", "lat",
+                                   0};
+    PyObject *zone, *northp, *x, *y, *lat = 0;
+    int prec;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOOi|O",
+                                     const_cast<char**>(kwlist),
+                                     &zone, &northp, &x, &y, &prec, &lat))
+      return 0;
+    bool latp = lat && lat != Py_None;
+    Inputs in;
+    if (!(in.Add(zone, 'i', "zone") && in.Add(northp, '?', "northp") &&
+          in.Add(x, 'd', "x") && in.Add(y, 'd', "y") &&
+          (!latp || in.Add(lat, 'd', "lat"))))
+      return 0;
+    Py_ssize_t n = in.Size();
+    if (n < 0)
+      return 0;
+    const size_t stride = 28;
+    Error err;
+    vector<char> mgrs;
+    {
+      Unlock unlock;
+      try {
+        mgrs.resize(n * stride);
+        Flags northp1(in.B(1), n);
+        MGRS::ForwardBatch(in.I(0), northp1.Data(), in.D(2), in.D(3),
+                           latp ? in.D(4) : 0, n,
+                           prec, n ? &mgrs[0] : 0, stride);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    if (err.Raise())
+      return 0;
+    PyObject* list = PyList_New(n);
+    if (!list) return 0;
+    for (Py_ssize_t i = 0; i < n; ++i) {
+      PyObject* s = PyUnicode_FromString(&mgrs[i * stride]);
+      if (!s) {
+        Py_DECREF(list);
+        return 0;
+      }
+      PyList_SET_ITEM(list, i, s);
+    }
+    return list;
+  }
+
+  PyObject* MGRSReverse(PyObject*, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"mgrs", "centerp", "out", 0};
+    PyObject *strs, *out = 0;
+    int centerp = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|iO",
+                                     const_cast<char**>(kwlist),
+                                     &strs, &centerp, &out))
+      return 0;
+    PyObject* seq = PySequence_Fast(strs, "mgrs must be a sequence");
+    if (!seq) return 0;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    // Gather the strings into one buffer
+    string buf;
+    vector<size_t> offsets(1, 0);
+    for (Py_ssize_t i = 0; i < n; ++i) {
+      PyObject* item = PySequence_Fast_GET_ITEM(seq, i);
+      PyObject* bytes = PyUnicode_Check(item) ?
+        PyUnicode_AsUTF8String(item) : (Py_INCREF(item), item);
+      if (!bytes || !PyBytes_Check(bytes)) {
+        if (bytes)
+          PyErr_SetString(PyExc_TypeError, "mgrs must contain strings");
+        Py_XDECREF(bytes);
+        Py_DECREF(seq);
+        return 0;
+      }
+      buf.append(PyBytes_AS_STRING(bytes), PyBytes_GET_SIZE(bytes));
+      offsets.push_back(buf.size());
+      Py_DECREF(bytes);
+    }
+    Py_DECREF(seq);
+    Outputs res;
+    if (!res.Init(out, "i?ddi", n))
+      return 0;
+    {
+      Unlock unlock;
+      MGRS::ReverseBatch(buf.data(), &offsets[0], n,
+                         res.I(0), res.B(1), res.D(2), res.D(3), res.I(4),
+                         0, centerp != 0);
+    }
+    return res.Result();
+  }
+
+  PyMethodDef MGRSMethods[] = {
+    {"Forward", KeywordFunction(MGRSForward),
+     METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+     "Forward(zone, northp, x, y, prec, lat=None)\n\n"
+     "Convert arrays of UTM/UPS coordinates to a list of MGRS strings with\n"
+     "precision prec (relative to 100 km).  The string is empty for points\n"
+     "which cannot be converted."},
+    {"Reverse", KeywordFunction(MGRSReverse),
+     METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+     "Reverse(mgrs, centerp=True, out=None)\n\n"
+     "Convert a sequence of MGRS strings to UTM/UPS coordinates.  Returns\n"
+     "(zone, northp, x, y, prec).  The zone is INVALID (-4) and x and y\n"
+     "are NaNs for strings which cannot be parsed."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* Geoid                                                                */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject GeoidType;
+
+  PyObject* GeoidNew(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"name", "path", "cubic", "threadsafe", 0};
+    const char *name, *path = "";
+    int cubic = 1, threadsafe = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|sii",
+                                     const_cast<char**>(kwlist),
+                                     &name, &path, &cubic, &threadsafe))
+      return 0;
+    Geoid* g = 0;
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        g = new Geoid(name, path, cubic != 0, threadsafe != 0);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : Wrap(type, g);
+  }
+
+  // Height and ConvertHeight for Geoid.  The lock is only released if the
+  // Geoid may be used concurrently.
+  PyObject* GeoidRun(PyObject* self, PyObject* args, PyObject* kwds,
+                     bool convert) {
+    static const char* kwlist1[] = {"lat", "lon", "out", 0};
+    static const char* kwlist2[] = {"lat", "lon", "h", "direction", "out",
+                                    0};
+    PyObject *lat, *lon, *h = 0, *out = 0;
+    int d = Geoid::NONE;
+    if (!(convert ?
+          PyArg_ParseTupleAndKeywords(args, kwds, "OOOi|O",
+                                      const_cast<char**>(kwlist2),
+                                      &lat, &lon, &h, &d, &out) :
+          PyArg_ParseTupleAndKeywords(args, kwds, "OO|O",
+                                      const_cast<char**>(kwlist1),
+                                      &lat, &lon, &out)))
+      return 0;
+    if (convert && !(d == Geoid::ELLIPSOIDTOGEOID || d == Geoid::NONE ||
+                     d == Geoid::GEOIDTOELLIPSOID)) {
+      PyErr_SetString(PyExc_ValueError, "Bad direction");
+      return 0;
+    }
+    Inputs in;
+    if (!(in.Add(lat, 'd', "lat") && in.Add(lon, 'd', "lon") &&
+          (!convert || in.Add(h, 'd', "h"))))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, "d", n))
+      return 0;
+    const Geoid& g = Obj<Geoid>(self);
+    Error err;
+    {
+      Unlock unlock(g.Concurrent());
+      try {
+        if (convert)
+          g.ConvertHeightBatch(in.D(0), in.D(1), in.D(2), n,
+                               Geoid::convertflag(d), res.D(0));
+        else
+          g.HeightBatch(in.D(0), in.D(1), res.D(0), n);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyObject* GeoidHeight(PyObject* self, PyObject* args, PyObject* kwds)
+  { return GeoidRun(self, args, kwds, false); }
+
+  PyObject* GeoidConvertHeight(PyObject* self, PyObject* args,
+                               PyObject* kwds)
+  { return GeoidRun(self, args, kwds, true); }
+
+  PyObject* GeoidCache(PyObject* self, bool map) {
+    const Geoid& g = Obj<Geoid>(self);
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        if (map)
+          g.CacheMap();
+        else
+          g.CacheAll();
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    if (err.Raise())
+      return 0;
+    Py_RETURN_NONE;
+  }
+
+  PyObject* GeoidCacheAll(PyObject* self, PyObject*)
+  { return GeoidCache(self, false); }
+
+  PyObject* GeoidCacheMap(PyObject* self, PyObject*)
+  { return GeoidCache(self, true); }
+
+  PyObject* GeoidConcurrent(PyObject* self, PyObject*)
+  { return PyBool_FromLong(Obj<Geoid>(self).Concurrent()); }
+
+  PyMethodDef GeoidMethods[] = {
+    {"Height", KeywordFunction(GeoidHeight),
+     METH_VARARGS | METH_KEYWORDS,
+     "Height(lat, lon, out=None)\n\n"
+     "The heights of the geoid above the ellipsoid (meters) at arrays of\n"
+     "latitudes and longitudes (degrees)."},
+    {"ConvertHeight", KeywordFunction(GeoidConvertHeight),
+     METH_VARARGS | METH_KEYWORDS,
+     "ConvertHeight(lat, lon, h, direction, out=None)\n\n"
+     "Convert an array of heights between the geoid and the ellipsoid;\n"
+     "direction is one of ELLIPSOIDTOGEOID, NONE, or GEOIDTOELLIPSOID."},
+    {"CacheAll", (PyCFunction)GeoidCacheAll, METH_NOARGS,
+     "CacheAll()\n\nRead all the data into memory."},
+    {"CacheMap", (PyCFunction)GeoidCacheMap, METH_NOARGS,
+     "CacheMap()\n\nMap the data file into memory."},
+    {"Concurrent", (PyCFunction)GeoidConcurrent, METH_NOARGS,
+     "Concurrent()\n\n"
+     "Whether Height and ConvertHeight release the global interpreter\n"
+     "lock so that they may be called concurrently from several threads."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* GravityModel                                                         */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject GravityModelType;
+
+  PyObject* GravityModelNew(PyTypeObject* type, PyObject* args,
+                            PyObject* kwds) {
+    static const char* kwlist[] = {"name", "path", "map", 0};
+    const char *name, *path = "";
+    int map = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|si",
+                                     const_cast<char**>(kwlist),
+                                     &name, &path, &map))
+      return 0;
+    GravityModel* g = 0;
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        g = new GravityModel(name, path, map != 0);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : Wrap(type, g);
+  }
+
+  enum gravitykind { GRAVITY, DISTURBANCE, GEOIDHEIGHT, ANOMALY };
+
+  PyObject* GravityModelRun(PyObject* self, PyObject* args, PyObject* kwds,
+                            gravitykind kind) {
+    static const char* kwlist1[] = {"lat", "lon", "nthreads", "out", 0};
+    static const char* kwlist2[] = {"lat", "lon", "h", "nthreads", "out", 0};
+    PyObject *lat, *lon, *h = 0, *out = 0;
+    int nthreads = 1;
+    if (!(kind == GEOIDHEIGHT ?
+          PyArg_ParseTupleAndKeywords(args, kwds, "OO|iO",
+                                      const_cast<char**>(kwlist1),
+                                      &lat, &lon, &nthreads, &out) :
+          PyArg_ParseTupleAndKeywords(args, kwds, "OOO|iO",
+                                      const_cast<char**>(kwlist2),
+                                      &lat, &lon, &h, &nthreads, &out)))
+      return 0;
+    if (!Nthreads(nthreads))
+      return 0;
+    Inputs in;
+    if (!(in.Add(lat, 'd', "lat") && in.Add(lon, 'd', "lon") &&
+          (kind == GEOIDHEIGHT || in.Add(h, 'd', "h"))))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out,
+                           kind == GEOIDHEIGHT ? "d" :
+                           kind == ANOMALY ? "ddd" : "dddd", n))
+      return 0;
+    const GravityModel& g = Obj<GravityModel>(self);
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        switch (kind) {
+        case GRAVITY:
+          g.GravityBatch(in.D(0), in.D(1), in.D(2), n,
+                         res.D(0), res.D(1), res.D(2), res.D(3), nthreads);
+          break;
+        case DISTURBANCE:
+          g.DisturbanceBatch(in.D(0), in.D(1), in.D(2), n,
+                             res.D(0), res.D(1), res.D(2), res.D(3),
+                             nthreads);
+          break;
+        case GEOIDHEIGHT:
+          g.GeoidHeightBatch(in.D(0), in.D(1), n, res.D(0), nthreads);
+          break;
+        case ANOMALY:
+          g.SphericalAnomalyBatch(in.D(0), in.D(1), in.D(2), n,
+                                  res.D(0), res.D(1), res.D(2), nthreads);
+          break;
+        }
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyObject* GravityModelGravity(PyObject* self, PyObject* args,
+                                PyObject* kwds)
+  { return GravityModelRun(self, args, kwds, GRAVITY); }
+
+  PyObject* GravityModelDisturbance(PyObject* self, PyObject* args,
+                                    PyObject* kwds)
+  { return GravityModelRun(self, args, kwds, DISTURBANCE); }
+
+  PyObject* GravityModelGeoidHeight(PyObject* self, PyObject* args,
+                                    PyObject* kwds)
+  { return GravityModelRun(self, args, kwds, GEOIDHEIGHT); }
+
+  PyObject* GravityModelSphericalAnomaly(PyObject* self, PyObject* args,
+                                         PyObject* kwds)
+  { return GravityModelRun(self, args, kwds, ANOMALY); }
+
+  PyMethodDef GravityModelMethods[] = {
+    {"Gravity", KeywordFunction(GravityModelGravity),
+     METH_VARARGS | METH_KEYWORDS,
+     "Gravity(lat, lon, h, nthreads=1, out=None)\n\n"
+     "The gravity at arrays of points.  Returns (W, gx, gy, gz)."},
+    {"Disturbance", KeywordFunction(GravityModelDisturbance),
+     METH_VARARGS | METH_KEYWORDS,
+     "Disturbance(lat, lon, h, nthreads=1, out=None)\n\n"
+     "The gravity disturbance at arrays of points.  Returns (T, deltax,\n"
+     "deltay, deltaz)."},
+    {"GeoidHeight", KeywordFunction(GravityModelGeoidHeight),
+     METH_VARARGS | METH_KEYWORDS,
+     "GeoidHeight(lat, lon, nthreads=1, out=None)\n\n"
+     "The height of the geoid above the ellipsoid at arrays of points."},
+    {"SphericalAnomaly", KeywordFunction(GravityModelSphericalAnomaly),
+     METH_VARARGS | METH_KEYWORDS,
+     "SphericalAnomaly(lat, lon, h, nthreads=1, out=None)\n\n"
+     "The spherical approximations of the gravity anomaly and the\n"
+     "deflection of the vertical at arrays of points.  Returns (Dg01, xi,\n"
+     "eta)."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* MagneticModel                                                        */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject MagneticModelType;
+
+  PyObject* MagneticModelNew(PyTypeObject* type, PyObject* args,
+                             PyObject* kwds) {
+    static const char* kwlist[] = {"name", "path", "map", 0};
+    const char *name, *path = "";
+    int map = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|si",
+                                     const_cast<char**>(kwlist),
+                                     &name, &path, &map))
+      return 0;
+    MagneticModel* m = 0;
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        m = new MagneticModel(name, path, Geocentric::WGS84(), map != 0);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : Wrap(type, m);
+  }
+
+  PyObject* MagneticModelField(PyObject* self, PyObject* args,
+                               PyObject* kwds) {
+    static const char* kwlist[] = {"t", "lat", "lon", "h", "rate",
+                                   "nthreads", "out", 0};
+    PyObject *t, *lat, *lon, *h, *out = 0;
+    int rate = 0, nthreads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|iiO",
+                                     const_cast<char**>(kwlist),
+                                     &t, &lat, &lon, &h, &rate, &nthreads,
+                                     &out))
+      return 0;
+    if (!Nthreads(nthreads))
+      return 0;
+    Inputs in;
+    if (!(in.Add(t, 'd', "t") && in.Add(lat, 'd', "lat") &&
+          in.Add(lon, 'd', "lon") && in.Add(h, 'd', "h")))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, rate ? "dddddd" : "ddd", n))
+      return 0;
+    const MagneticModel& m = Obj<MagneticModel>(self);
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        if (rate)
+          m(in.D(0), in.D(1), in.D(2), in.D(3), n,
+            res.D(0), res.D(1), res.D(2), res.D(3), res.D(4), res.D(5),
+            nthreads);
+        else
+          m(in.D(0), in.D(1), in.D(2), in.D(3), n,
+            res.D(0), res.D(1), res.D(2), nthreads);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyMethodDef MagneticModelMethods[] = {
+    {"Field", KeywordFunction(MagneticModelField),
+     METH_VARARGS | METH_KEYWORDS,
+     "Field(t, lat, lon, h, rate=False, nthreads=1, out=None)\n\n"
+     "The magnetic field at arrays of times and points.  Returns (Bx, By,\n"
+     "Bz) or, if rate is true, (Bx, By, Bz, Bxt, Byt, Bzt)."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* PolygonArea                                                          */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject PolygonAreaType;
+
+  // A PolygonArea which records whether it's a polyline
+  class Polygons : public PolygonArea {
+  public:
+    bool polyline;
+    Polygons(const Geodesic& earth, bool pl)
+      : PolygonArea(earth, pl), polyline(pl) {}
+  };
+
+  PyObject* PolygonAreaNew(PyTypeObject* type, PyObject* args,
+                           PyObject* kwds) {
+    static const char* kwlist[] = {"a", "f", "polyline", 0};
+    double a = Constants::WGS84_a(), f = Constants::WGS84_f();
+    int polyline = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ddi",
+                                     const_cast<char**>(kwlist),
+                                     &a, &f, &polyline))
+      return 0;
+    try {
+      return Wrap(type, new Polygons(Geodesic(a, f), polyline != 0));
+    }
+    catch (const GeographicErr& e) {
+      PyErr_SetString(GeographicErrType, e.what());
+      return 0;
+    }
+  }
+
+  // The polygons [k0, k1) for ComputeMany
+  class PolygonRange {
+  private:
+    const PolygonArea& _p;
+    const size_t* _offsets;
+    const double *_lat, *_lon;
+    bool _reverse, _sign;
+    double *_perimeter, *_area;
+    PolygonRange& operator=(const PolygonRange&);
+  public:
+    PolygonRange(const PolygonArea& p, const size_t* offsets,
+                 const double* lat, const double* lon, bool reverse,
+                 bool sign, double* perimeter, double* area)
+      : _p(p), _offsets(offsets), _lat(lat), _lon(lon)
+      , _reverse(reverse), _sign(sign), _perimeter(perimeter), _area(area)
+    {}
+    void operator()(size_t k0, size_t k1) const {
+      _p.ComputeMany(_offsets + k0, _lat, _lon, k1 - k0, _reverse, _sign,
+                     _perimeter + k0, _area ? _area + k0 : 0);
+    }
+  };
+
+  PyObject* PolygonAreaComputeMany(PyObject* self, PyObject* args,
+                                   PyObject* kwds) {
+    static const char* kwlist[] = {"offsets", "lat", "lon", "reverse", "sign",
+                                   "nthreads", "out", 0};
+    PyObject *offsets, *lat, *lon, *out = 0;
+    int reverse = 0, sign = 1, nthreads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|iiiO",
+                                     const_cast<char**>(kwlist),
+                                     &offsets, &lat, &lon, &reverse, &sign,
+                                     &nthreads, &out))
+      return 0;
+    if (!Nthreads(nthreads))
+      return 0;
+    Inputs in;
+    View off;
+    if (!(in.Add(lat, 'd', "lat") && in.Add(lon, 'd', "lon") &&
+          off.Get(offsets, 'z', false, "offsets")))
+      return 0;
+    Py_ssize_t n = in.Size(), npoly = off.Size() - 1;
+    if (n < 0)
+      return 0;
+    if (npoly < 0) {
+      PyErr_SetString(PyExc_ValueError, "offsets must not be empty");
+      return 0;
+    }
+    // The offsets are checked and converted to size_t
+    vector<size_t> o(npoly + 1);
+    for (Py_ssize_t k = 0; k <= npoly; ++k) {
+      long long ok = off.Integer(k);
+      if (!(ok >= (k ? (long long)(o[k - 1]) : 0) && ok <= (long long)(n))) {
+        PyErr_SetString(PyExc_ValueError,
+                        "offsets must be nondecreasing and in [0, len(lat)]");
+        return 0;
+      }
+      o[k] = size_t(ok);
+    }
+    Outputs res;
+    if (!res.Init(out, "idd", npoly))
+      return 0;
+    const Polygons& p = Obj<Polygons>(self);
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        for (Py_ssize_t k = 0; k < npoly; ++k)
+          res.I(0)[k] = int(o[k + 1] - o[k]);
+        double* area = res.D(2);
+        if (p.polyline)
+          for (Py_ssize_t k = 0; k < npoly; ++k)
+            area[k] = Math::NaN();
+        Executor::For(size_t(npoly), size_t(nthreads),
+                      PolygonRange(p, npoly ? &o[0] : 0, in.D(0), in.D(1),
+                                   reverse != 0, sign != 0, res.D(1),
+                                   p.polyline ? 0 : area));
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyMethodDef PolygonAreaMethods[] = {
+    {"ComputeMany", KeywordFunction(PolygonAreaComputeMany),
+     METH_VARARGS | METH_KEYWORDS,
+     "ComputeMany(offsets, lat, lon, reverse=False, sign=True, nthreads=1,\n"
+     "            out=None)\n\n"
+     "The perimeters and areas of many polygons.  The vertices of polygon k\n"
+     "are (lat[i], lon[i]) for offsets[k] <= i < offsets[k+1]; offsets is a\n"
+     "buffer of 32-bit or 64-bit integers.  Returns (num, perimeter, area)\n"
+     "where num is the number of vertices of each polygon; the results are\n"
+     "the same as given by the Compute method of the C++ class."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* Geodesic                                                             */
+  /* ------------------------------------------------------------------ */
+
+  PyTypeObject GeodesicType;
+
+  PyObject* GeodesicNew(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    static const char* kwlist[] = {"a", "f", 0};
+    double a = Constants::WGS84_a(), f = Constants::WGS84_f();
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|dd",
+                                     const_cast<char**>(kwlist), &a, &f))
+      return 0;
+    try {
+      return Wrap(type, new Geodesic(a, f));
+    }
+    catch (const GeographicErr& e) {
+      PyErr_SetString(GeographicErrType, e.what());
+      return 0;
+    }
+  }
+
+  // GenInverse and GenDirect for Geodesic.  The results are returned in the
+  // order of the values returned by the corresponding methods of the python
+  // class; those not selected by outmask are not set.
+  PyObject* GeodesicRun(PyObject* self, PyObject* args, PyObject* kwds,
+                        bool inverse) {
+    static const char* kwlist[] = {"a", "b", "c", "d", "outmask", "nthreads",
+                                   "out", 0};
+    PyObject *a, *b, *c, *d, *out = 0;
+    unsigned outmask;
+    int nthreads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOOI|iO",
+                                     const_cast<char**>(kwlist),
+                                     &a, &b, &c, &d, &outmask, &nthreads,
+                                     &out))
+      return 0;
+    if (!Nthreads(nthreads))
+      return 0;
+    Inputs in;
+    if (!(in.Add(a, 'd', "lat1") && in.Add(b, 'd', "lon1") &&
+          in.Add(c, 'd', inverse ? "lat2" : "azi1") &&
+          in.Add(d, 'd', inverse ? "lon2" : "s12")))
+      return 0;
+    Py_ssize_t n = in.Size();
+    Outputs res;
+    if (n < 0 || !res.Init(out, inverse ? "dddddddd" : "ddddddddd", n))
+      return 0;
+    const Geodesic& g = Obj<Geodesic>(self);
+    Error err;
+    {
+      Unlock unlock;
+      try {
+        if (inverse)
+          // a12, s12, azi1, azi2, m12, M12, M21, S12
+          g.GenInverseBatch(in.D(0), in.D(1), in.D(2), in.D(3), n, outmask,
+                            res.D(1), res.D(2), res.D(3), res.D(4),
+                            res.D(5), res.D(6), res.D(7), res.D(0),
+                            nthreads);
+        else
+          // a12, lat2, lon2, azi2, s12, m12, M12, M21, S12
+          g.GenDirectBatch(in.D(0), in.D(1), in.D(2), false, in.D(3), n,
+                           outmask, res.D(1), res.D(2), res.D(3), res.D(4),
+                           res.D(5), res.D(6), res.D(7), res.D(8), res.D(0),
+                           nthreads);
+      }
+      GEOGRAPHICLIB_PY_CATCH(err)
+    }
+    return err.Raise() ? 0 : res.Result();
+  }
+
+  PyObject* GeodesicGenInverse(PyObject* self, PyObject* args,
+                               PyObject* kwds)
+  { return GeodesicRun(self, args, kwds, true); }
+
+  PyObject* GeodesicGenDirect(PyObject* self, PyObject* args, PyObject* kwds)
+  { return GeodesicRun(self, args, kwds, false); }
+
+  PyMethodDef GeodesicMethods[] = {
+    {"GenInverse", KeywordFunction(GeodesicGenInverse),
+     METH_VARARGS | METH_KEYWORDS,
+     "GenInverse(lat1, lon1, lat2, lon2, outmask, nthreads=1, out=None)\n\n"
+     "Solve many inverse geodesic problems.  outmask is as for the C++\n"
+     "class.  Returns (a12, s12, azi1, azi2, m12, M12, M21, S12); the\n"
+     "results not selected by outmask are not set (zero if out is None)."},
+    {"GenDirect", KeywordFunction(GeodesicGenDirect),
+     METH_VARARGS | METH_KEYWORDS,
+     "GenDirect(lat1, lon1, azi1, s12, outmask, nthreads=1, out=None)\n\n"
+     "Solve many direct geodesic problems.  outmask is as for the C++\n"
+     "class.  Returns (a12, lat2, lon2, azi2, s12, m12, M12, M21, S12);\n"
+     "the results not selected by outmask are not set (zero if out is\n"
+     "None)."},
+    {0, 0, 0, 0}
+  };
+
+  /* ------------------------------------------------------------------ */
+  /* The module                                                           */
+  /* ------------------------------------------------------------------ */
+
+  bool AddType(PyObject* module, PyTypeObject& type, const char* name,
+               size_t size, destructor dealloc, newfunc create,
+               PyMethodDef* methods, const char* doc) {
+    // The types are statically allocated and zero initialized
+    reinterpret_cast<PyObject*>(&type)->ob_refcnt = 1;
+    type.tp_name = name;
+    type.tp_basicsize = Py_ssize_t(size);
+    type.tp_dealloc = dealloc;
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = doc;
+    type.tp_methods = methods;
+    type.tp_new = create;
+    if (PyType_Ready(&type) < 0)
+      return false;
+    Py_INCREF(&type);
+    return PyModule_AddObject(module, strrchr(name, '.') + 1,
+                              reinterpret_cast<PyObject*>(&type)) == 0;
+  }
+
+  bool AddConstant(PyTypeObject& type, const char* name, long val) {
+    PyObject* v = PyInt_FromLong(val);
+    if (!v) return false;
+    int r = PyDict_SetItemString(type.tp_dict, name, v);
+    Py_DECREF(v);
+    return r == 0;
+  }
+
+  const char* module_doc =
+    "Batch interfaces to the C++ GeographicLib classes\n\n"
+    "The array arguments are objects supporting the buffer protocol (e.g.,\n"
+    "numpy arrays of float64) which are accessed without copying.  The\n"
+    "results are returned as array.array objects or are written into the\n"
+    "buffers given by the out argument.  The global interpreter lock is\n"
+    "released during the computations.";
+
+  bool InitModule(PyObject* m) {
+    PyObject* array = PyImport_ImportModule("array");
+    if (!array) return false;
+    ArrayType = PyObject_GetAttrString(array, "array");
+    Py_DECREF(array);
+    if (!ArrayType) return false;
+    GeographicErrType = PyErr_NewException
+      (const_cast<char*>("geographiclibcxx.GeographicErr"),
+       PyExc_RuntimeError, 0);
+    if (!GeographicErrType) return false;
+    Py_INCREF(GeographicErrType);
+    if (PyModule_AddObject(m, "GeographicErr", GeographicErrType) < 0)
+      return false;
+    if (!(AddType(m, GeodesicType, "geographiclibcxx.Geodesic",
+                  sizeof(Wrapper<Geodesic>), Dealloc<Geodesic>, GeodesicNew,
+                  GeodesicMethods,
+                  "Geodesic(a=WGS84 a, f=WGS84 f)\n\n"
+                  "Geodesics on an ellipsoid of revolution.") &&
+          AddType(m, TransverseMercatorType,
+                  "geographiclibcxx.TransverseMercator",
+                  sizeof(Wrapper<TransverseMercator>),
+                  Dealloc<TransverseMercator>, TransverseMercatorNew,
+                  TransverseMercatorMethods,
+                  "TransverseMercator(a=WGS84 a, f=WGS84 f, k0=UTM k0)\n\n"
+                  "The transverse Mercator projection.") &&
+          AddType(m, UTMUPSType, "geographiclibcxx.UTMUPS",
+                  sizeof(PyObject), 0, 0, UTMUPSMethods,
+                  "Conversions between geographic and UTM/UPS "
+                  "coordinates.") &&
+          AddType(m, MGRSType, "geographiclibcxx.MGRS",
+                  sizeof(PyObject), 0, 0, MGRSMethods,
+                  "Conversions between UTM/UPS and MGRS coordinates.") &&
+          AddType(m, GeoidType, "geographiclibcxx.Geoid",
+                  sizeof(Wrapper<Geoid>), Dealloc<Geoid>, GeoidNew,
+                  GeoidMethods,
+                  "Geoid(name, path='', cubic=True, threadsafe=False)\n\n"
+                  "The height of the geoid above the ellipsoid.") &&
+          AddType(m, GravityModelType, "geographiclibcxx.GravityModel",
+                  sizeof(Wrapper<GravityModel>), Dealloc<GravityModel>,
+                  GravityModelNew, GravityModelMethods,
+                  "GravityModel(name, path='', map=False)\n\n"
+                  "A model of the earth's gravity field.") &&
+          AddType(m, MagneticModelType, "geographiclibcxx.MagneticModel",
+                  sizeof(Wrapper<MagneticModel>), Dealloc<MagneticModel>,
+                  MagneticModelNew, MagneticModelMethods,
+                  "MagneticModel(name, path='', map=False)\n\n"
+                  "A model of the earth's magnetic field.") &&
+          AddType(m, PolygonAreaType, "geographiclibcxx.PolygonArea",
+                  sizeof(Wrapper<Polygons>), Dealloc<Polygons>,
+                  PolygonAreaNew, PolygonAreaMethods,
+                  "PolygonArea(a=WGS84 a, f=WGS84 f, polyline=False)\n\n"
+                  "The perimeters and areas of geodesic polygons.")))
+      return false;
+    return
+      AddConstant(UTMUPSType, "INVALID", UTMUPS::INVALID) &&
+      AddConstant(UTMUPSType, "STANDARD", UTMUPS::STANDARD) &&
+      AddConstant(UTMUPSType, "UTM", UTMUPS::UTM) &&
+      AddConstant(UTMUPSType, "UPS", UTMUPS::UPS) &&
+      AddConstant(GeoidType, "ELLIPSOIDTOGEOID", Geoid::ELLIPSOIDTOGEOID) &&
+      AddConstant(GeoidType, "NONE", Geoid::NONE) &&
+      AddConstant(GeoidType, "GEOIDTOELLIPSOID", Geoid::GEOIDTOELLIPSOID);
+  }
+
+#if PY_MAJOR_VERSION >= 3
+  PyModuleDef module_def;
+#endif
+
+} // namespace
+
+#if PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC PyInit_geographiclibcxx() {
+  PyModuleDef_Base base = PyModuleDef_HEAD_INIT;
+  module_def.m_base = base;
+  module_def.m_name = "geographiclibcxx";
+  module_def.m_doc = module_doc;
+  module_def.m_size = -1;
+  PyObject* m = PyModule_Create(&module_def);
+  if (m && !InitModule(m)) {
+    Py_DECREF(m);
+    return 0;
+  }
+  return m;
+}
+#else
+PyMODINIT_FUNC initgeographiclibcxx() {
+  PyObject* m = Py_InitModule3("geographiclibcxx", 0, module_doc);
+  if (m) InitModule(m);
+}
+#endif
@@ -1168,6 +1168,213 @@ class Geodesic(object):
     if outmask & Geodesic.AREA: result['S12'] = S12
     return result
 
+  def ArrayArgs(*args):
+    """Private: Return the number of problems and a list of sequences for
+    the arguments of InverseArray and DirectArray; a scalar argument is
+    repeated"""
+    n = None
+    for x in args:
+      try:
+        m = len(x)
+      except TypeError:
+        continue
+      if n is None:
+        n = m
+      elif m != n:
+        raise ValueError("arrays have different lengths " +
+                         str(n) + " and " + str(m))
+    if n is None: n = 1
+    seqs = []
+    for x in args:
+      try:
+        len(x)
+        seqs.append(x)
+      except TypeError:
+        seqs.append([x] * n)
+    return n, seqs
+  ArrayArgs = staticmethod(ArrayArgs)
+
+  def ArrayModule():
+    """Private: Return the geographiclibcxx extension module or None if it
+    is not available"""
+    try:
+      import geographiclibcxx
+    except ImportError:
+      return None
+    return geographiclibcxx
+  ArrayModule = staticmethod(ArrayModule)
+
+  def ArrayBuffer(x):
+    """Private: Return the sequence x as a buffer of doubles to pass to
+    geographiclibcxx"""
+    try:
+      import numpy
+    except ImportError:
+      import array
+      return array.array('d', x)
+    return numpy.ascontiguousarray(x, dtype = float)
+  ArrayBuffer = staticmethod(ArrayBuffer)
+
+  def ArrayResult(result):
+    """Private: Convert the sequences in result to NumPy arrays if possible
+    (or otherwise to lists)"""
+    try:
+      import numpy
+    except ImportError:
+      for k in result:
+        result[k] = list(result[k])
+      return result
+    for k in result:
+      result[k] = numpy.array(result[k], dtype = float)
+    return result
+  ArrayResult = staticmethod(ArrayResult)
+
+  def InverseArray(self, lat1, lon1, lat2, lon2,
+                   outmask = DISTANCE | AZIMUTH):
+    """Solve many inverse geodesic problems.  lat1, lon1, lat2, and lon2
+    are sequences (e.g., lists or NumPy arrays) of the same length giving
+    the end points of the geodesics; any of these may instead be a
+    scalar, in which case it applies to all the geodesics.  outmask is
+    as for Inverse.  Return a dictionary with the same entries as
+    Inverse; each entry is a NumPy array (or a list if NumPy is not
+    available) of the values for the geodesics.  The results are the
+    same as calling Inverse for each geodesic.  However the checking of
+    the arguments and the assembly of the results is done once for all
+    the geodesics, and a ValueError for an illegal argument is raised
+    before any of the geodesics are computed.  If the geographiclibcxx
+    extension module is available, the geodesics are computed by the C++
+    library (without the loop over the geodesics being done in python)
+    and the results agree with Inverse to within roundoff.
+
+    """
+
+    n, (lat1, lon1, lat2, lon2) = Geodesic.ArrayArgs(lat1, lon1, lat2, lon2)
+    # Check all the arguments first
+    lon1a = [Geodesic.CheckPosition(lat1[i], lon1[i]) for i in range(n)]
+    lon2a = [Geodesic.CheckPosition(lat2[i], lon2[i]) for i in range(n)]
+    unroll = outmask & Geodesic.LONG_UNROLL
+    om = outmask & Geodesic.OUT_MASK
+    keys = ['a12']
+    if om & Geodesic.DISTANCE: keys.append('s12')
+    if om & Geodesic.AZIMUTH: keys += ['azi1', 'azi2']
+    if om & Geodesic.REDUCEDLENGTH: keys.append('m12')
+    if om & Geodesic.GEODESICSCALE: keys += ['M12', 'M21']
+    if om & Geodesic.AREA: keys.append('S12')
+    result = {'lat1': list(lat1), 'lat2': list(lat2),
+              'lon1': list(lon1) if unroll else lon1a,
+              'lon2': ([lon1[i] + Math.AngDiff(lon1a[i], lon2a[i])
+                        for i in range(n)] if unroll else lon2a)}
+    # The order of the values returned by GenInverse
+    ind = {'a12': 0, 's12': 1, 'azi1': 2, 'azi2': 3,
+           'm12': 4, 'M12': 5, 'M21': 6, 'S12': 7}
+    cxx = Geodesic.ArrayModule()
+    if cxx is not None:
+      r = cxx.Geodesic(self._a, self._f).GenInverse(
+        *[Geodesic.ArrayBuffer(x) for x in (lat1, lon1a, lat2, lon2a)],
+        outmask = outmask)
+      vals = [r[ind[k]] for k in keys]
+    else:
+      vals = [[] for k in keys]
+      for i in range(n):
+        r = self.GenInverse(lat1[i], lon1a[i], lat2[i], lon2a[i], outmask)
+        for j in range(len(keys)):
+          vals[j].append(r[ind[keys[j]]])
+    for j in range(len(keys)):
+      result[keys[j]] = vals[j]
+    return Geodesic.ArrayResult(result)
+
+  def DirectArray(self, lat1, lon1, azi1, s12,
+                  outmask = LATITUDE | LONGITUDE | AZIMUTH):
+    """Solve many direct geodesic problems.  lat1, lon1, azi1, and s12
+    are sequences (e.g., lists or NumPy arrays) of the same length giving
+    the starting points, azimuths, and distances of the geodesics; any
+    of these may instead be a scalar, in which case it applies to all the
+    geodesics.  outmask is as for Direct.  Return a dictionary with the
+    same entries as Direct; each entry is a NumPy array (or a list if
+    NumPy is not available) of the values for the geodesics.  The results
+    are the same as calling Direct for each geodesic.  A ValueError for
+    an illegal argument is raised before any of the geodesics are
+    computed.  If the geographiclibcxx extension module is available, the
+    geodesics are computed by the C++ library and the results agree with
+    Direct to within roundoff.
+
+    """
+
+    from geographiclib.geodesicline import GeodesicLine
+    n, (lat1, lon1, azi1, s12) = Geodesic.ArrayArgs(lat1, lon1, azi1, s12)
+    unroll = outmask & Geodesic.LONG_UNROLL
+    lon1a = [Geodesic.CheckPosition(lat1[i], lon1[i]) for i in range(n)]
+    if unroll: lon1a = list(lon1)
+    azi1a = [Geodesic.CheckAzimuth(azi1[i]) for i in range(n)]
+    for i in range(n): Geodesic.CheckDistance(s12[i])
+    om = outmask & Geodesic.OUT_MASK
+    keys = ['a12']
+    if om & Geodesic.LATITUDE: keys.append('lat2')
+    if om & Geodesic.LONGITUDE: keys.append('lon2')
+    if om & Geodesic.AZIMUTH: keys.append('azi2')
+    if om & Geodesic.REDUCEDLENGTH: keys.append('m12')
+    if om & Geodesic.GEODESICSCALE: keys += ['M12', 'M21']
+    if om & Geodesic.AREA: keys.append('S12')
+    result = {'lat1': list(lat1), 'lon1': lon1a, 'azi1': azi1a,
+              's12': list(s12)}
+    # The order of the values returned by GenPosition
+    ind = {'a12': 0, 'lat2': 1, 'lon2': 2, 'azi2': 3,
+           'm12': 5, 'M12': 6, 'M21': 7, 'S12': 8}
+    cxx = Geodesic.ArrayModule()
+    if cxx is not None:
+      r = cxx.Geodesic(self._a, self._f).GenDirect(
+        *[Geodesic.ArrayBuffer(x) for x in (lat1, lon1a, azi1a, s12)],
+        outmask = outmask)
+      vals = [r[ind[k]] for k in keys]
+    else:
+      vals = [[] for k in keys]
+      caps = outmask | Geodesic.DISTANCE_IN
+      for i in range(n):
+        line = GeodesicLine(self, lat1[i], lon1a[i], azi1a[i], caps)
+        r = line.GenPosition(False, s12[i], outmask)
+        for j in range(len(keys)):
+          vals[j].append(r[ind[keys[j]]])
+    for j in range(len(keys)):
+      result[keys[j]] = vals[j]
+    return Geodesic.ArrayResult(result)
+
+  def CellAreas(self, lats, dlon):
+    """Return the areas of the cells of a latitude-longitude grid.  lats
+    is a sequence of the n latitudes of the edges of the cells and dlon
+    is the width of the cells, which must be in (0, 180).  Cell k is
+    the geodesic quadrilateral with vertices (lats[k], 0), (lats[k],
+    dlon), (lats[k+1], dlon), (lats[k+1], 0) and its area doesn't depend
+    on its longitude.  The n - 1 areas are returned as a NumPy array (or
+    a list if NumPy is not available) and are computed with n inverse
+    calculations.  The area of each cell is the same as that given by
+    Area for its vertices; in particular it is negative if lats[k+1] <
+    lats[k].
+
+    """
+
+    from geographiclib.accumulator import Accumulator
+    if not (dlon > 0 and dlon < 180):
+      raise ValueError("cell width " + str(dlon) + " not in (0, 180)")
+    for lat in lats: Geodesic.CheckPosition(lat, 0)
+    area0 = 4 * math.pi * self._c2
+    # The area of cell k is S[k] - S[k+1] where S[k] is the area under the
+    # geodesic from (lats[k], 0) to (lats[k], dlon)
+    S = [self.GenInverse(lat, 0, lat, dlon, Geodesic.AREA)[7]
+         for lat in lats]
+    areas = []
+    for k in range(len(lats) - 1):
+      tempsum = Accumulator(S[k])
+      tempsum.Add(-S[k + 1])
+      # Convert to the counter-clockwise convention and reduce to
+      # (-area0/2, area0/2] as in PolygonArea.Compute
+      tempsum.Negate()
+      if tempsum.Sum() > area0/2:
+        tempsum.Add( -area0 )
+      elif tempsum.Sum() <= -area0/2:
+        tempsum.Add(  area0 )
+      areas.append(0 + tempsum.Sum())
+    return Geodesic.ArrayResult({'area': areas})['area']
+
   def Line(self, lat1, lon1, azi1, caps = ALL):
     """Return a GeodesicLine object to compute points along a geodesic
     starting at lat1, lon1, with azimuth azi1.  caps is an or'ed
@@ -119,7 +119,7 @@ class PolygonArea(object):
     tempsum.Add(S12)
     crossings = self._crossings + PolygonArea.transit(self._lon1, self._lon0)
     if crossings & 1:
-      tempsum.Add( (1 if tempsum < 0 else -1) * self._area0/2 )
+      tempsum.Add( (1 if tempsum.Sum() < 0 else -1) * self._area0/2 )
     # area is with the clockwise sense.  If !reverse convert to
     # counter-clockwise convention.
     if not reverse: tempsum.Negate()
@@ -230,6 +230,67 @@ class PolygonArea(object):
     area = 0 + tempsum
     return num, perimeter, area
 
+  def ComputeMany(self, offsets, lats, lons, reverse = False, sign = True):
+    """Return the numbers of vertices, the perimeters, and the areas of many
+    polygons.  The vertices of polygon k are (lats[i], lons[i]) for
+    offsets[k] <= i < offsets[k+1] (the "compressed sparse row" layout
+    given, e.g., by the ring offsets of Shapely or GeoPandas geometries);
+    so offsets has one more element than the number of polygons.  reverse
+    and sign are as for Compute.  The polyline setting and ellipsoid of
+    this object are used but the polygon it holds is not changed.  Return
+    a tuple of three NumPy arrays (or lists if NumPy is not available).
+    The results are the same as calling Clear, AddPoint for each vertex,
+    and Compute for each polygon.  If the geographiclibcxx extension
+    module is available, the polygons are computed by the C++ library
+    (without the loop over the polygons being done in python) and the
+    results agree with Compute to within roundoff.
+
+    """
+
+    try:
+      import numpy
+    except ImportError:
+      numpy = None
+    n = len(lats)
+    if len(lons) != n:
+      raise ValueError("lats and lons have different lengths " +
+                       str(n) + " and " + str(len(lons)))
+    offs = [int(o) for o in offsets]
+    if (len(offs) == 0 or offs[0] < 0 or offs[-1] > n or
+        any(offs[k] > offs[k+1] for k in range(len(offs) - 1))):
+      raise ValueError("offsets must be nondecreasing and in [0, len(lats)]")
+    try:
+      import geographiclibcxx
+    except ImportError:
+      geographiclibcxx = None
+    if geographiclibcxx is not None:
+      if numpy is not None:
+        args = (numpy.array(offs, dtype = numpy.int64),
+                numpy.ascontiguousarray(lats, dtype = float),
+                numpy.ascontiguousarray(lons, dtype = float))
+      else:
+        import array
+        args = (array.array('q', offs),
+                array.array('d', lats), array.array('d', lons))
+      poly = geographiclibcxx.PolygonArea(self._earth._a, self._earth._f,
+                                          self._polyline)
+      result = poly.ComputeMany(*args, reverse = reverse, sign = sign)
+      result = [list(x) for x in result] if numpy is None else result
+    else:
+      poly = PolygonArea(self._earth, self._polyline)
+      result = [[], [], []]
+      for k in range(len(offs) - 1):
+        poly.Clear()
+        for i in range(offs[k], offs[k+1]):
+          poly.AddPoint(lats[i], lons[i])
+        r = poly.Compute(reverse, sign)
+        for j in range(3): result[j].append(r[j])
+    if numpy is not None:
+      result = [numpy.asarray(result[0], dtype = int),
+                numpy.asarray(result[1], dtype = float),
+                numpy.asarray(result[2], dtype = float)]
+    return tuple(result)
+
   def CurrentPoint(self):
     """Return the current point as a lat, lon tuple."""
     return self._lat1, self._lon1
@@ -7,6 +7,8 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/AlbersEqualArea.hpp>
 
 #if defined(_MSC_VER)
@@ -388,27 +390,92 @@ namespace GeographicLib {
                                 real& x, real& y, real& gamma, real& k)
     const {
     lon = Math::AngDiff(Math::AngNormalize(lon0), Math::AngNormalize(lon));
+    real drho, t, sx, cy, ctheta;
+    ForwardLat(lat, drho, t, k);
+    ForwardLon(lon, sx, cy, ctheta, gamma);
+    x = t * sx / _k0;
+    y = (_nrho0 * cy - drho * ctheta) / _k0;
+    y *= _sign;
+  }
+
+  void AlbersEqualArea::ForwardLat(real lat, real& drho, real& t, real& k)
+    const {
     lat *= _sign;
     real
-      lam = lon * Math::degree(),
       phi = lat * Math::degree(),
       sphi = sin(phi), cphi = abs(lat) != 90 ? cos(phi) : epsx_,
       tphi = sphi/cphi, txi = txif(tphi), sxi = txi/hyp(txi),
-      dq = _qZ * Dsn(txi, _txi0, sxi, _sxi0) * (txi - _txi0),
-      drho = - _a * dq / (sqrt(_m02 - _n0 * dq) + _nrho0 / _a),
-      theta = _k2 * _n0 * lam, stheta = sin(theta), ctheta = cos(theta),
-      t = _nrho0 + _n0 * drho;
-    x = t * (_n0 ? stheta / _n0 : _k2 * lam) / _k0;
-    y = (_nrho0 *
-         (_n0 ?
-          (ctheta < 0 ? 1 - ctheta : Math::sq(stheta)/(1 + ctheta)) / _n0 :
-          0)
-         - drho * ctheta) / _k0;
+      dq = _qZ * Dsn(txi, _txi0, sxi, _sxi0) * (txi - _txi0);
+    drho = - _a * dq / (sqrt(_m02 - _n0 * dq) + _nrho0 / _a);
+    t = _nrho0 + _n0 * drho;
     k = _k0 * (t ? t * hyp(_fm * tphi) / _a : 1);
-    y *= _sign;
+  }
+
+  void AlbersEqualArea::ForwardLon(real lon, real& sx, real& cy,
+                                   real& ctheta, real& gamma) const {
+    // lon is relative to the central meridian
+    real
+      lam = lon * Math::degree(),
+      theta = _k2 * _n0 * lam, stheta = sin(theta);
+    ctheta = cos(theta);
+    sx = _n0 ? stheta / _n0 : _k2 * lam;
+    cy = _n0 ?
+      (ctheta < 0 ? 1 - ctheta : Math::sq(stheta)/(1 + ctheta)) / _n0 : 0;
     gamma = _sign * theta / Math::degree();
   }
 
+  void AlbersEqualArea::ForwardBatch(real lon0,
+                                     const real lat[], const real lon[],
+                                     size_t n, real x[], real y[],
+                                     real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real g, kk;
+      Forward(lon0, lat[i], lon[i], x[i], y[i], g, kk);
+      if (gamma) gamma[i] = g;
+      if (k) k[i] = kk;
+    }
+  }
+
+  void AlbersEqualArea::ForwardGrid(real lon0,
+                                    real lat1, real dlat, int nlat,
+                                    real lon1, real dlon, int nlon,
+                                    real x[], real y[],
+                                    real gamma[], real k[]) const {
+    if (nlat <= 0 || nlon <= 0)
+      return;
+    // The longitude dependent quantities for each column
+    vector<real> sx(nlon), cy(nlon), ctheta(nlon), g(nlon);
+    real lon0a = Math::AngNormalize(lon0);
+    for (int j = 0; j < nlon; ++j)
+      ForwardLon(Math::AngDiff(lon0a, Math::AngNormalize(lon1 + j * dlon)),
+                 sx[j], cy[j], ctheta[j], g[j]);
+    for (int i = 0; i < nlat; ++i) {
+      real drho, t, kk;
+      ForwardLat(lat1 + i * dlat, drho, t, kk);
+      size_t l = size_t(i) * nlon;
+      for (int j = 0; j < nlon; ++j) {
+        x[l + j] = t * sx[j] / _k0;
+        y[l + j] = _sign * ((_nrho0 * cy[j] - drho * ctheta[j]) / _k0);
+      }
+      if (gamma)
+        copy(g.begin(), g.end(), gamma + l);
+      if (k)
+        fill(k + l, k + l + nlon, kk);
+    }
+  }
+
+  void AlbersEqualArea::ReverseBatch(real lon0,
+                                     const real x[], const real y[],
+                                     size_t n, real lat[], real lon[],
+                                     real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real g, kk;
+      Reverse(lon0, x[i], y[i], lat[i], lon[i], g, kk);
+      if (gamma) gamma[i] = g;
+      if (k) k[i] = kk;
+    }
+  }
+
   void AlbersEqualArea::Reverse(real lon0, real x, real y,
                                 real& lat, real& lon,
                                 real& gamma, real& k)
@@ -0,0 +1,162 @@
+/**
+ * \file AuthalicSphere.cpp
+ * \brief Implementation for GeographicLib::AuthalicSphere class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/AuthalicSphere.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  AuthalicSphere::AuthalicSphere(real a, real f)
+    : _ell(a, f)
+    , tiny_(sqrt(numeric_limits<real>::min()))
+    , _e2(_ell.EccentricitySq())
+    , _es((_e2 < 0 ? -1 : 1) * sqrt(abs(_e2)))
+    , _qp(q(1))
+    , _r(sqrt(_ell.Area() / (4 * Math::pi())))
+    , _c2(Math::sq(_r))
+  {}
+
+  const AuthalicSphere& AuthalicSphere::WGS84() {
+    static const AuthalicSphere
+      wgs84(Constants::WGS84_a(), Constants::WGS84_f());
+    return wgs84;
+  }
+
+  void AuthalicSphere::AuthalicSinCos(real phi, real& sxi, real& cxi) const {
+    if (abs(phi) == 90) {
+      // Ensure cxi = +epsilon at poles (as in Geodesic)
+      sxi = phi < 0 ? -1 : 1; cxi = tiny_;
+    } else {
+      // sin(xi) = q(sin(phi)) / q(1).  This is equivalent to
+      // Ellipsoid::AuthalicLatitude but avoids several transcendental
+      // function evaluations.
+      sxi = q(sin(phi * Math::degree())) / _qp;
+      cxi = max(tiny_, sqrt((1 - sxi) * (1 + sxi)));
+    }
+  }
+
+  void AuthalicSphere::GenInverse(real lat1, real lon1, real lat2, real lon2,
+                                  unsigned outmask,
+                                  real& s12, real& azi1, real& azi2,
+                                  real& S12) const {
+    real
+      lon12 = Math::AngDiff(Math::AngNormalize(lon1), Math::AngNormalize(lon2)),
+      lam12 = lon12 * Math::degree(),
+      slam12 = abs(lon12) == 180 ? 0 : sin(lam12),
+      clam12 = cos(lam12),
+      sbet1, cbet1, sbet2, cbet2;
+    AuthalicSinCos(lat1, sbet1, cbet1);
+    AuthalicSinCos(lat2, sbet2, cbet2);
+    // The azimuths of the great circle at its end points
+    real
+      salp1 = cbet2 * slam12,
+      calp1 = cbet1 * sbet2 - sbet1 * cbet2 * clam12,
+      salp2 = cbet1 * slam12,
+      calp2 = cbet1 * sbet2 * clam12 - sbet1 * cbet2;
+    if (outmask & DISTANCE)
+      s12 = _r * atan2(Math::hypot(salp1, calp1),
+                       sbet1 * sbet2 + cbet1 * cbet2 * clam12);
+    if (outmask & AZIMUTH) {
+      azi1 = Math::atan2d(salp1, calp1);
+      azi2 = Math::atan2d(salp2, calp2);
+    }
+    if (outmask & AREA) {
+      // The spherical excess of the quadrilateral; see Geodesic::GenInverse.
+      real alp12;
+      if (abs(lon12) < 135 && sbet2 - sbet1 < real(1.75)) {
+        // Use tan(Gamma/2) = tan(omg12/2)
+        // * (tan(bet1/2)+tan(bet2/2))/(1+tan(bet1/2)*tan(bet2/2))
+        // with tan(x/2) = sin(x)/(1+cos(x))
+        real
+          domg12 = 1 + clam12, dbet1 = 1 + cbet1, dbet2 = 1 + cbet2;
+        alp12 = 2 * atan2( slam12 * ( sbet1 * dbet2 + sbet2 * dbet1 ),
+                           domg12 * ( sbet1 * sbet2 + dbet1 * dbet2 ) );
+      } else {
+        // alp12 = alp2 - alp1, used in atan2 so no need to normalize
+        real
+          salp12 = salp2 * calp1 - calp2 * salp1,
+          calp12 = calp2 * calp1 + salp2 * salp1;
+        // The right thing appears to happen if alp1 = +/-180 and alp2 = 0,
+        // viz salp12 = -0 and alp12 = -180.  However this depends on the sign
+        // being attached to 0 correctly.  The following ensures the correct
+        // behavior.
+        if (salp12 == 0 && calp12 < 0) {
+          salp12 = tiny_ * calp1;
+          calp12 = -1;
+        }
+        alp12 = atan2(salp12, calp12);
+      }
+      S12 = _c2 * alp12;
+    }
+  }
+
+  void AuthalicSphere::GenDirect(real lat1, real lon1, real azi1, real s12,
+                                 unsigned outmask,
+                                 real& lat2, real& lon2, real& azi2,
+                                 real& S12) const {
+    real sbet1, cbet1;
+    AuthalicSinCos(lat1, sbet1, cbet1);
+    real
+      alp1 = Math::AngRound(Math::AngNormalize(azi1)) * Math::degree(),
+      // Make sure alp1 = 180 gives salp1 = +0
+      salp1 = abs(azi1) == 180 ? 0 : sin(alp1),
+      calp1 = abs(azi1) ==  90 ? 0 : cos(alp1),
+      // Measure the great circle from its northward equator crossing; alp0 is
+      // the azimuth there.
+      salp0 = salp1 * cbet1,
+      calp0 = Math::hypot(calp1, salp1 * sbet1),
+      ssig1 = sbet1, somg1 = salp0 * sbet1,
+      csig1 = sbet1 != 0 || calp1 != 0 ? cbet1 * calp1 : 1, comg1 = csig1,
+      sig12 = s12 / _r,
+      ssig12 = sin(sig12), csig12 = cos(sig12);
+    Math::norm(ssig1, csig1);   // sig1 in (-pi, pi]
+    real
+      ssig2 = ssig1 * csig12 + csig1 * ssig12,
+      csig2 = csig1 * csig12 - ssig1 * ssig12,
+      sbet2 = calp0 * ssig2,
+      cbet2 = Math::hypot(salp0, calp0 * csig2),
+      somg2 = salp0 * ssig2, comg2 = csig2,
+      salp2 = salp0, calp2 = calp0 * csig2;
+    if (cbet2 == 0)
+      // I.e., salp0 = 0, csig2 = 0.  Break the degeneracy in this case
+      cbet2 = calp2 = tiny_;
+    if (outmask & LATITUDE)
+      lat2 = _ell.InverseAuthalicLatitude(Math::atan2d(sbet2, cbet2));
+    if (outmask & LONGITUDE) {
+      if (outmask & LONG_UNROLL) {
+        real E = salp0 < 0 ? -1 : 1; // east-going?
+        real omg12 = E * (sig12
+                          - (atan2(   ssig2, csig2) - atan2(   ssig1, csig1))
+                          + (atan2(E*somg2, comg2) - atan2(E*somg1, comg1)));
+        lon2 = lon1 + omg12 / Math::degree();
+      } else {
+        real omg12 = atan2(somg2 * comg1 - comg2 * somg1,
+                           comg2 * comg1 + somg2 * somg1);
+        lon2 = Math::AngNormalize(Math::AngNormalize(lon1) +
+                                  Math::AngNormalize(omg12 / Math::degree()));
+      }
+    }
+    if (outmask & AZIMUTH)
+      azi2 = Math::atan2d(salp2, calp2);
+    if (outmask & AREA) {
+      // alp12 = alp2 - alp1, used in atan2 so no need to normalize
+      real
+        salp12 = salp2 * calp1 - calp2 * salp1,
+        calp12 = calp2 * calp1 + salp2 * salp1;
+      // See Geodesic::GenInverse for the treatment of this degenerate case
+      if (salp12 == 0 && calp12 < 0) {
+        salp12 = tiny_ * calp1;
+        calp12 = -1;
+      }
+      S12 = _c2 * atan2(salp12, calp12);
+    }
+  }
+
+} // namespace GeographicLib
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/AzimuthalEquidistant.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
 
 namespace GeographicLib {
 
@@ -39,4 +40,51 @@ namespace GeographicLib {
     rk = !(sig <= eps_) ? m / s : 1;
   }
 
+  void AzimuthalEquidistant::ForwardBatch(real lat0, real lon0,
+                                          const real lat[], const real lon[],
+                                          size_t n, real x[], real y[],
+                                          real azi[], real rk[]) const {
+    const Geodesic::Point p0(_earth, lat0, lon0);
+    for (size_t i = 0; i < n; ++i) {
+      real sig, s, azi0, azi2, m, t;
+      sig = _earth.GenInverse(p0, Geodesic::Point(_earth, lat[i], lon[i]),
+                              Geodesic::DISTANCE | Geodesic::AZIMUTH |
+                              Geodesic::REDUCEDLENGTH,
+                              s, azi0, azi2, m, t, t, t);
+      azi0 *= Math::degree();
+      x[i] = s * sin(azi0);
+      y[i] = s * cos(azi0);
+      if (azi) azi[i] = azi2;
+      if (rk) rk[i] = !(sig <= eps_) ? m / s : 1;
+    }
+  }
+
+  void AzimuthalEquidistant::ReverseBatch(real lat0, real lon0,
+                                          const real x[], const real y[],
+                                          size_t n, real lat[], real lon[],
+                                          real azi[], real rk[]) const {
+    // Follow Geodesic::Direct but keep the GeodesicLine while the direction
+    // is unchanged.
+    const unsigned outmask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH;
+    GeodesicLine line;
+    real azil = Math::NaN();
+    for (size_t i = 0; i < n; ++i) {
+      real
+        azi0 = atan2(x[i], y[i]) / Math::degree(),
+        s = Math::hypot(x[i], y[i]);
+      // Distinguish between +0 and -0
+      if (!(azi0 == azil && (azi0 != 0 || 1/azi0 == 1/azil))) {
+        line = GeodesicLine(_earth, lat0, lon0, azi0,
+                            outmask | Geodesic::DISTANCE_IN);
+        azil = azi0;
+      }
+      real sig, azi2, m, t;
+      sig = line.GenPosition(false, s, outmask,
+                             lat[i], lon[i], azi2, t, m, t, t, t);
+      if (azi) azi[i] = azi2;
+      if (rk) rk[i] = !(sig <= eps_) ? m / s : 1;
+    }
+  }
+
 } // namespace GeographicLib
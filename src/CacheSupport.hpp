@@ -0,0 +1,135 @@
+/**
+ * \file CacheSupport.hpp
+ * \brief Internal support for the least recently used caches
+ *
+ * This header is used by GravityCircleCache.cpp, MagneticCircleCache.cpp,
+ * and InverseCache.cpp; it is not installed.
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CACHESUPPORT_HPP)
+#define GEOGRAPHICLIB_CACHESUPPORT_HPP 1
+
+#include <list>
+#include <map>
+#include <algorithm>
+#include <GeographicLib/Math.hpp>
+
+#if !defined(GEOGRAPHICLIB_CACHE_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_CACHE_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_CACHE_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+#  include <mutex>
+#  include <memory>
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief A least recently used cache (internal)
+   *
+   * The values are held in order of use, most recent first, with an index
+   * into them.  The member functions don't lock the mutex; the caller
+   * holds a CacheGuard around them.
+   **********************************************************************/
+  template<class Key, class Value> class LRUCache {
+  public:
+    typedef std::list< std::pair<Key, Value> > list_t;
+    typedef std::map<Key, typename list_t::iterator> map_t;
+    list_t _values;
+    map_t _index;
+    size_t _capacity;
+    unsigned long _hits, _misses;
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+    mutable std::mutex _mutex;
+#endif
+    explicit LRUCache(size_t capacity = 0)
+      : _capacity(capacity), _hits(0), _misses(0) {}
+    // The value for key (moving it to the front of the list) or 0 if it's
+    // not in the cache.
+    const Value* Find(const Key& key) {
+      typename map_t::iterator i = _index.find(key);
+      if (i == _index.end()) {
+        ++_misses;
+        return 0;
+      }
+      ++_hits;
+      _values.splice(_values.begin(), _values, i->second);
+      return &i->second->second;
+    }
+    // Add a value unless the cache has no capacity or another thread has
+    // added it in the meantime.
+    void Insert(const Key& key, const Value& val) {
+      if (_capacity > 0 && _index.find(key) == _index.end()) {
+        _values.push_front(std::make_pair(key, val));
+        _index[key] = _values.begin();
+        Trim();
+      }
+    }
+    void Clear() { _index.clear(); _values.clear(); }
+    void SetCapacity(size_t capacity) { _capacity = capacity; Trim(); }
+    void Trim() {
+      // Discard the least recently used values
+      while (_values.size() > _capacity) {
+        _index.erase(_values.back().first);
+        _values.pop_back();
+      }
+    }
+  };
+
+  /**
+   * \brief Lock the mutex of an object for the lifetime of a CacheGuard
+   *   (internal)
+   *
+   * This does nothing if the caches are not thread safe.
+   **********************************************************************/
+  template<class T> class CacheGuard {
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+    std::lock_guard<std::mutex> _lock;
+  public:
+    explicit CacheGuard(const T& obj) : _lock(obj._mutex) {}
+#else
+  public:
+    explicit CacheGuard(const T&) {}
+#endif
+  };
+
+  /**
+   * The nodes \e xs and weights \e ws for linear interpolation at \e x on a
+   * grid with spacing \e d; for latitudes (\e latp = true), the nodes are
+   * limited to [&minus;90&deg;, 90&deg;].  Returns the number of nodes (1
+   * or 2).  (Internal, for the circle caches.)
+   **********************************************************************/
+  inline int CacheNodes(Math::real x, Math::real d, bool latp,
+                        Math::real xs[], Math::real ws[]) {
+    typedef Math::real real;
+    using std::floor; using std::max; using std::min;
+    xs[0] = x; ws[0] = 1;
+    if (!(d > 0 && Math::isfinite(x)))
+      return 1;
+    real x0 = floor(x / d) * d, x1 = x0 + d;
+    if (latp) {
+      x0 = max(x0, -real(90));
+      x1 = min(x1, real(90));
+    }
+    real w = (x - x0) / (x1 - x0);
+    if (!(w > 0 && w < 1)) {
+      xs[0] = w < 1 ? x0 : x1;
+      return 1;
+    }
+    xs[0] = x0; ws[0] = 1 - w;
+    xs[1] = x1; ws[1] = w;
+    return 2;
+  }
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_CACHESUPPORT_HPP
@@ -95,4 +95,30 @@ namespace GeographicLib {
     _earth.Direct(lat1, lon1, azi0 + 90, x, lat, lon, azi, rk, t);
   }
 
+  void CassiniSoldner::ForwardBatch(const real lat[], const real lon[],
+                                    size_t n, real x[], real y[],
+                                    real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    for (size_t i = 0; i < n; ++i) {
+      real a, k;
+      Forward(lat[i], lon[i], x[i], y[i], a, k);
+      if (azi) azi[i] = a;
+      if (rk) rk[i] = k;
+    }
+  }
+
+  void CassiniSoldner::ReverseBatch(const real x[], const real y[],
+                                    size_t n, real lat[], real lon[],
+                                    real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    for (size_t i = 0; i < n; ++i) {
+      real a, k;
+      Reverse(x[i], y[i], lat[i], lon[i], a, k);
+      if (azi) azi[i] = a;
+      if (rk) rk[i] = k;
+    }
+  }
+
 } // namespace GeographicLib
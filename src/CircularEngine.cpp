@@ -8,16 +8,201 @@
  **********************************************************************/
 
 #include <GeographicLib/CircularEngine.hpp>
+#include <complex>
+#include <algorithm>
+#include <limits>
+
+#if !defined(GEOGRAPHICLIB_CIRCULARENGINE_WORKSPACE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#    define GEOGRAPHICLIB_CIRCULARENGINE_WORKSPACE 1
+#  else
+#    define GEOGRAPHICLIB_CIRCULARENGINE_WORKSPACE 0
+#  endif
+#endif
 
 namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    typedef Math::real real;
+    typedef complex<real> cplx;
+
+    // The maximum number of factors of an int.
+    const int maxfac_ = numeric_limits<int>::digits;
+
+    // Factor n into primes, taking out 4s first, putting the nfac factors in
+    // fac[0..nfac-1] (which must have room for maxfac_ elements).  Return the
+    // sum of the factors (the work of the FFT is approximately n times this).
+    int factorize(int n, int fac[], int& nfac) {
+      int sum = 0;
+      nfac = 0;
+      while (n % 4 == 0) { fac[nfac++] = 4; sum += 4; n /= 4; }
+      for (int p = 2; p * p <= n; p += (p == 2 ? 1 : 2))
+        while (n % p == 0) { fac[nfac++] = p; sum += p; n /= p; }
+      if (n > 1) { fac[nfac++] = n; sum += n; }
+      return sum;
+    }
+
+    // Mixed radix decimation-in-time FFT, out[k] = sum(j = 0..n-1, in[j *
+    // stride] * exp(2*pi*i * j*k/n)) for k = 0..n-1.  fac[0..] are the
+    // factors of n, w[t] = exp(2*pi*i * t/P) where n divides P, and tmp has
+    // room for max(fac) elements.  The work for a factor p is O(n * p), so
+    // this is only efficient if n has no large prime factors.
+    void fft(int n, const int* fac, const cplx* in, int stride,
+             const cplx* w, int P, cplx* out, cplx* tmp) {
+      if (n == 1) {
+        out[0] = in[0];
+        return;
+      }
+      int p = fac[0], m = n / p, ws = P / n;
+      for (int r = 0; r < p; ++r)
+        fft(m, fac + 1, in + r * stride, stride * p, w, P, out + r * m, tmp);
+      // Combine the p transforms of length m
+      for (int k = 0; k < m; ++k) {
+        for (int q = 0; q < p; ++q) {
+          int kq = k + q * m;
+          cplx sum = out[k];
+          for (int r = 1; r < p; ++r)
+            sum += out[r * m + k] * w[(long long)(r) * kq % n * ws];
+          tmp[q] = sum;
+        }
+        for (int q = 0; q < p; ++q)
+          out[k + q * m] = tmp[q];
+      }
+    }
+  }
+
+  CircularEngine::Workspace::Workspace(int k, size_t n) {
+#if GEOGRAPHICLIB_CIRCULARENGINE_WORKSPACE
+    static thread_local vector<real> work[nwork_];
+    vector<real>& w = work[k];
+#else
+    (void)k;
+    vector<real>& w = _own;
+#endif
+    if (w.size() < n) w.resize(n);
+    _p = w.empty() ? 0 : &w[0];
+  }
+
+  bool CircularEngine::FFTRow(real dlon, int nlon, int& P) const {
+    // Use the FFT if 360/dlon is an integer P and the work of the FFT, about
+    // P * (sum of factors of P), is less than that of Clenshaw summation.
+    if (_M < 0 || nlon < 2 || !(Math::isfinite(dlon) && dlon != 0))
+      return false;
+    using std::abs; using std::floor;
+    real Px = 360 / abs(dlon);
+    if (!(Px < real(numeric_limits<int>::max() / 8)))
+      return false;
+    P = int(floor(Px + real(0.5)));
+    real tol = 360 * 64 * numeric_limits<real>::epsilon();
+    if (!(P >= 1 && abs(P * abs(dlon) - 360) <= tol))
+      return false;
+    int fac[maxfac_], nfac;
+    return real(P) * factorize(P, fac, nfac) < real(nlon) * (_M + 1);
+  }
+
+  void CircularEngine::Row(bool gradp, real lon0, real dlon, int nlon,
+                           real v[],
+                           real gradx[], real grady[], real gradz[]) const {
+    gradp = _gradp && gradp;
+    int P;
+    if (!FFTRow(dlon, nlon, P)) {
+      for (int j = 0; j < nlon; ++j) {
+        real lon = lon0 + j * dlon, coslon, sinlon, gx, gy, gz;
+        cossin(lon, coslon, sinlon);
+        v[j] = Value(gradp, coslon, sinlon, gx, gy, gz);
+        if (gradp) {
+          gradx[j] = gx; grady[j] = gy; gradz[j] = gz;
+        }
+      }
+      return;
+    }
+    const real* root_ = SphericalEngine::roots();
+    // The outer sum is V(lon) = sum(m = 0..M, F[m] * (Sc[m] * cos(m*lon) +
+    // Ss[m] * sin(m*lon))) where F[m] = q^(m+1) * P[m,m](t) / scale; and
+    // similarly for the sums for the derivatives.  With lon = lon0 + j *
+    // 360/P, this is the real part of the discrete Fourier transform of
+    // sum(m = k mod P, F[m] * (Sc[m] - i * Ss[m]) * exp(i*m*lon0)).  F[m]
+    // may underflow even though F[m] * Sc[m] doesn't, so hold it as a
+    // fraction and an exponent.
+    int nser = gradp ? 4 : 1, fac[maxfac_], nfac;
+    factorize(P, fac, nfac);
+    int maxp = nfac ? *max_element(fac, fac + nfac) : 1;
+    // The transforms Y, their inputs X, the roots of unity w, and the
+    // temporary space for fft.  std::complex<real> has the layout of real[2].
+    Workspace work(0, 2 * (size_t((2 * nser + 1) * P) + maxp));
+    cplx
+      *Y = reinterpret_cast<cplx*>(work.data()),
+      *X = Y + nser * P,
+      *w = X + nser * P,
+      *tmp = w + P;
+    fill(Y, Y + nser * P, cplx(0));
+    real Ff = _q / SphericalEngine::scale();
+    int Fe = 0;
+    for (int m = 0; m <= _M; ++m) {
+      if (m) {
+        switch (_norm) {
+        case FULL:
+          Ff *= _uq * (m == 1 ? root_[3] :
+                       root_[2 * m + 1] / (root_[2] * root_[m]));
+          break;
+        case SCHMIDT:
+          Ff *= _uq * (m == 1 ? 1 :
+                       root_[2 * m - 1] / (root_[2] * root_[m]));
+          break;
+        default: break;
+        }
+        int e;
+        Ff = frexp(Ff, &e); Fe += e;
+      }
+      real cm, sm;
+      Math::sincosd(fmod(m * Math::AngNormalize2(lon0), real(360)), sm, cm);
+      cplx ph(ldexp(Ff * cm, Fe), ldexp(Ff * sm, Fe));
+      int k = m % P;
+      const real* wm = &_w[nw() * m];
+      Y[k] += cplx(wm[0], -wm[1]) * ph;
+      if (gradp) {
+        Y[P + k]     += cplx(wm[2], -wm[3]) * ph;
+        Y[2 * P + k] += cplx(wm[4], -wm[5]) * ph;
+        Y[3 * P + k] += cplx(m * wm[1], m * wm[0]) * ph;
+      }
+    }
+    for (int t = 0; t < P; ++t) {
+      real c, s;
+      Math::sincosd(360 * real(t) / P, s, c);
+      w[t] = cplx(c, s);
+    }
+    for (int l = 0; l < nser; ++l)
+      fft(P, fac, Y + l * P, 1, w, P, X + l * P, tmp);
+    for (int j = 0; j < nlon; ++j) {
+      int k = j % P;
+      if (dlon < 0) k = (P - k) % P;
+      v[j] = X[k].real();
+      if (gradp) {
+        // The components of the gradient in circular coordinates are
+        // r: dV/dr
+        // theta: 1/r * dV/dtheta
+        // lambda: 1/(r*u) * dV/dlambda
+        real
+          vr = - X[P + k].real() / _r,
+          vt =   X[2 * P + k].real() / _r,
+          vl =   X[3 * P + k].real() / (_r * _u),
+          lon = lon0 + j * dlon, cl, sl;
+        cossin(lon, cl, sl);
+        // Rotate into cartesian (geocentric) coordinates
+        gradx[j] = cl * (_u * vr + _t * vt) - sl * vl;
+        grady[j] = sl * (_u * vr + _t * vt) + cl * vl;
+        gradz[j] =           _t * vr - _u * vt                ;
+      }
+    }
+  }
+
   Math::real CircularEngine::Value(bool gradp, real cl, real sl,
                                    real& gradx, real& grady, real& gradz)
     const {
     gradp = _gradp && gradp;
-    const vector<real>& root_( SphericalEngine::root_ );
+    const real* root_ = SphericalEngine::roots();
 
     // Initialize outer sum
     real vc  = 0, vc2  = 0, vs  = 0, vs2  = 0;   // v [N + 1], v [N + 2]
@@ -29,6 +214,7 @@ namespace GeographicLib {
     for (int m = _M; m >= 0; --m) {   // m = M .. 0
       // Now Sc[m] = wc, Ss[m] = ws
       // Sc'[m] = wtc, Ss'[m] = wtc
+      const real* wm = &_w[nw() * m];
       if (m) {
         real v, A, B;           // alpha[m], beta[m + 1]
         switch (_norm) {
@@ -45,15 +231,15 @@ namespace GeographicLib {
         default:
           A = B = 0;
         }
-        v = A * vc  + B * vc2  +  _wc[m] ; vc2  = vc ; vc  = v;
-        v = A * vs  + B * vs2  +  _ws[m] ; vs2  = vs ; vs  = v;
+        v = A * vc  + B * vc2  +   wm[0]; vc2  = vc ; vc  = v;
+        v = A * vs  + B * vs2  +   wm[1]; vs2  = vs ; vs  = v;
         if (gradp) {
-          v = A * vrc + B * vrc2 +  _wrc[m]; vrc2 = vrc; vrc = v;
-          v = A * vrs + B * vrs2 +  _wrs[m]; vrs2 = vrs; vrs = v;
-          v = A * vtc + B * vtc2 +  _wtc[m]; vtc2 = vtc; vtc = v;
-          v = A * vts + B * vts2 +  _wts[m]; vts2 = vts; vts = v;
-          v = A * vlc + B * vlc2 + m*_ws[m]; vlc2 = vlc; vlc = v;
-          v = A * vls + B * vls2 - m*_wc[m]; vls2 = vls; vls = v;
+          v = A * vrc + B * vrc2 +   wm[2]; vrc2 = vrc; vrc = v;
+          v = A * vrs + B * vrs2 +   wm[3]; vrs2 = vrs; vrs = v;
+          v = A * vtc + B * vtc2 +   wm[4]; vtc2 = vtc; vtc = v;
+          v = A * vts + B * vts2 +   wm[5]; vts2 = vts; vts = v;
+          v = A * vlc + B * vlc2 + m*wm[1]; vlc2 = vlc; vlc = v;
+          v = A * vls + B * vls2 - m*wm[0]; vls2 = vls; vls = v;
         }
       } else {
         real A, B, qs;
@@ -70,16 +256,16 @@ namespace GeographicLib {
           A = B = 0;
         }
         qs = _q / SphericalEngine::scale();
-        vc = qs * (_wc[m] + A * (cl * vc + sl * vs ) + B * vc2);
+        vc = qs * (wm[0] + A * (cl * vc + sl * vs ) + B * vc2);
         if (gradp) {
           qs /= _r;
           // The components of the gradient in circular coordinates are
           // r: dV/dr
           // theta: 1/r * dV/dtheta
           // lambda: 1/(r*u) * dV/dlambda
-          vrc =    - qs * (_wrc[m] + A * (cl * vrc + sl * vrs) + B * vrc2);
-          vtc =      qs * (_wtc[m] + A * (cl * vtc + sl * vts) + B * vtc2);
-          vlc = qs / _u * (          A * (cl * vlc + sl * vls) + B * vlc2);
+          vrc =    - qs * (wm[2] + A * (cl * vrc + sl * vrs) + B * vrc2);
+          vtc =      qs * (wm[4] + A * (cl * vtc + sl * vts) + B * vtc2);
+          vlc = qs / _u * (        A * (cl * vlc + sl * vls) + B * vlc2);
         }
       }
     }
@@ -0,0 +1,192 @@
+/**
+ * \file CompactGeodesicLine.cpp
+ * \brief Implementation for GeographicLib::CompactGeodesicLineT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ *
+ * The notation is the same as in GeodesicLine.cpp and the calculations
+ * follow those of GeodesicLine; the difference is that the quantities
+ * which depend only on eps are computed as needed.
+ **********************************************************************/
+
+#include <GeographicLib/CompactGeodesicLine.hpp>
+#include <limits>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  template <typename T>
+  CompactGeodesicLineT<T>::CompactGeodesicLineT(const Geodesic& g,
+                                                real lat1, real lon1,
+                                                real azi1)
+    : _g(&g)
+    , _lat1(T(lat1))
+    , _lon1(T(lon1))
+  {
+    // As in the GeodesicLine constructor; the stored (rounded) values of
+    // lat1 and azi1 are used.
+    real azi = Math::AngRound(Math::AngNormalize(azi1));
+    _azi1 = T(azi);
+    azi = _azi1;
+    real lat = _lat1, alp1 = azi * Math::degree();
+    real
+      salp1 =     azi  == -180 ? 0 : sin(alp1),
+      calp1 = abs(azi) ==   90 ? 0 : cos(alp1);
+    // At a pole, cbet1 is set to a tiny number which determines the
+    // magnitudes of salp0, csig1, and comg1.  Geodesic::tiny_ underflows
+    // when rounded to float, losing the longitude of the line; so use a
+    // value which is representable in T (this is the same as
+    // Geodesic::tiny_ if T = Math::real).
+    const real tiny = max(real(g.tiny_),
+                          real(sqrt(numeric_limits<T>::min())));
+    real cbet1, sbet1, phi;
+    phi = lat * Math::degree();
+    sbet1 = g._f1 * sin(phi);
+    cbet1 = abs(lat) == 90 ? tiny : cos(phi);
+    Math::norm(sbet1, cbet1);
+    real
+      salp0 = salp1 * cbet1,
+      calp0 = Math::hypot(calp1, salp1 * sbet1),
+      ssig1 = sbet1, somg1 = salp0 * sbet1,
+      csig1 = sbet1 != 0 || calp1 != 0 ? cbet1 * calp1 : 1,
+      comg1 = csig1;
+    Math::norm(ssig1, csig1);
+    _salp0 = T(salp0); _calp0 = T(calp0);
+    _ssig1 = T(ssig1); _csig1 = T(csig1);
+    _somg1 = T(somg1); _comg1 = T(comg1);
+    // tau1 = sig1 + B11
+    real
+      k2 = Math::sq(real(_calp0)) * g._ep2,
+      eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2),
+      C1a[nC1_ + 1];
+    Geodesic::C1f(eps, C1a, g._nC);
+    real
+      B11 = Geodesic::SinCosSeries(true, _ssig1, _csig1, C1a, g._nC),
+      s = sin(B11), c = cos(B11);
+    _stau1 = T(real(_ssig1) * c + real(_csig1) * s);
+    _ctau1 = T(real(_csig1) * c - real(_ssig1) * s);
+  }
+
+  template <typename T>
+  Math::real CompactGeodesicLineT<T>::GenPosition(bool arcmode, real s12_a12,
+                                                  unsigned outmask,
+                                                  real& lat2, real& lon2,
+                                                  real& azi2, real& s12)
+    const {
+    if (!Init())
+      return Math::NaN();
+    const Geodesic& g = *_g;
+    const int nC = g._nC;
+    real
+      lon1 = _lon1, salp0 = _salp0, calp0 = _calp0,
+      ssig1 = _ssig1, csig1 = _csig1,
+      k2 = Math::sq(calp0) * g._ep2,
+      eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2),
+      A1m1 = Geodesic::A1m1f(eps, nC),
+      C1a[nC1_ + 1];
+    // The C1 series is needed to convert a distance to an arc length and to
+    // compute the distance for a given arc length.
+    bool c1 = !arcmode || (outmask & DISTANCE);
+    if (c1)
+      Geodesic::C1f(eps, C1a, nC);
+    real B11 = c1 ? Geodesic::SinCosSeries(true, ssig1, csig1, C1a, nC) : 0;
+
+    real sig12, ssig12, csig12, B12 = 0;
+    if (arcmode) {
+      // Interpret s12_a12 as spherical arc length
+      sig12 = s12_a12 * Math::degree();
+      real s12a = abs(s12_a12);
+      s12a -= 180 * floor(s12a / 180);
+      ssig12 = s12a ==  0 ? 0 : sin(sig12);
+      csig12 = s12a == 90 ? 0 : cos(sig12);
+    } else {
+      // Interpret s12_a12 as distance; this is GeodesicLine::DistanceToArc
+      real
+        tau12 = s12_a12 / (g._b * (1 + A1m1)),
+        stau12 = sin(tau12), ctau12 = cos(tau12),
+        stau1 = _stau1, ctau1 = _ctau1,
+        C1pa[nC1p_ + 1];
+      Geodesic::C1pf(eps, C1pa, nC);
+      B12 = - Geodesic::SinCosSeries(true,
+                                     stau1 * ctau12 + ctau1 * stau12,
+                                     ctau1 * ctau12 - stau1 * stau12,
+                                     C1pa, nC);
+      sig12 = tau12 - (B12 - B11);
+      ssig12 = sin(sig12); csig12 = cos(sig12);
+      if (abs(g._f) > 0.01) {
+        // Correct sig12 with 1 Newton iteration
+        real
+          ssig2 = ssig1 * csig12 + csig1 * ssig12,
+          csig2 = csig1 * csig12 - ssig1 * ssig12;
+        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, C1a, nC);
+        real serr = (1 + A1m1) * (sig12 + (B12 - B11)) - s12_a12 / g._b;
+        sig12 = sig12 - serr / sqrt(1 + k2 * Math::sq(ssig2));
+        ssig12 = sin(sig12); csig12 = cos(sig12);
+      }
+    }
+
+    // The rest is GeodesicLine::GenPosition restricted to the latitude,
+    // longitude, azimuth, and distance.
+    real ssig2, csig2, sbet2, cbet2, salp2, calp2;
+    // sig2 = sig1 + sig12
+    ssig2 = ssig1 * csig12 + csig1 * ssig12;
+    csig2 = csig1 * csig12 - ssig1 * ssig12;
+    if (outmask & DISTANCE) {
+      if (arcmode) {
+        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, C1a, nC);
+        s12 = g._b * ((1 + A1m1) * sig12 + (1 + A1m1) * (B12 - B11));
+      } else
+        s12 = s12_a12;
+    }
+    // sin(bet2) = cos(alp0) * sin(sig2)
+    sbet2 = calp0 * ssig2;
+    cbet2 = Math::hypot(salp0, calp0 * csig2);
+    if (cbet2 == 0)
+      // I.e., salp0 = 0, csig2 = 0.  Break the degeneracy in this case
+      cbet2 = csig2 = g.tiny_;
+    // tan(alp0) = cos(sig2)*tan(alp2)
+    salp2 = salp0; calp2 = calp0 * csig2; // No need to normalize
+
+    if (outmask & LONGITUDE) {
+      real C3a[nC3_];
+      g.C3f(eps, C3a);
+      real
+        A3c = -g._f * salp0 * g.A3f(eps),
+        B31 = Geodesic::SinCosSeries(true, ssig1, csig1, C3a, nC-1),
+        somg1 = _somg1, comg1 = _comg1;
+      // tan(omg2) = sin(alp0) * tan(sig2)
+      real somg2 = salp0 * ssig2, comg2 = csig2;  // No need to normalize
+      int E = salp0 < 0 ? -1 : 1;                 // east-going?
+      // omg12 = omg2 - omg1
+      real omg12 = outmask & LONG_UNROLL
+        ? E * (sig12
+               - (atan2(    ssig2, csig2) - atan2(    ssig1, csig1))
+               + (atan2(E * somg2, comg2) - atan2(E * somg1, comg1)))
+        : atan2(somg2 * comg1 - comg2 * somg1,
+                comg2 * comg1 + somg2 * somg1);
+      real lam12 = omg12 + A3c *
+        ( sig12 + (Geodesic::SinCosSeries(true, ssig2, csig2, C3a, nC-1)
+                   - B31));
+      real lon12 = lam12 / Math::degree();
+      lon2 = outmask & LONG_UNROLL ? lon1 + lon12 :
+        Math::AngNormalize(Math::AngNormalize(lon1) +
+                           Math::AngNormalize2(lon12));
+    }
+
+    if (outmask & LATITUDE)
+      lat2 = atan2(sbet2, g._f1 * cbet2) / Math::degree();
+
+    if (outmask & AZIMUTH)
+      azi2 = Math::atan2d(salp2, calp2);
+
+    return arcmode ? s12_a12 : sig12 / Math::degree();
+  }
+
+  template class GEOGRAPHICLIB_EXPORT CompactGeodesicLineT<Math::real>;
+  template class GEOGRAPHICLIB_EXPORT CompactGeodesicLineT<float>;
+
+} // namespace GeographicLib
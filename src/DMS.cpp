@@ -7,6 +7,7 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <cstring>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
 
@@ -19,13 +20,32 @@ namespace GeographicLib {
 
   using namespace std;
 
-  const string DMS::hemispheres_ = "SNWE";
-  const string DMS::signs_ = "-+";
-  const string DMS::digits_ = "0123456789";
-  const string DMS::dmsindicators_ = "D'\":";
-  const string DMS::components_[] = {"degrees", "minutes", "seconds"};
+  const char* const DMS::hemispheres_ = "SNWE";
+  const char* const DMS::signs_ = "-+";
+  const char* const DMS::digits_ = "0123456789";
+  const char* const DMS::dmsindicators_ = "D'\":";
+  const char* const DMS::components_[] = {"degrees", "minutes", "seconds"};
+
+  bool DMS::PlainDecode(const char* dms, size_t len, real& val) {
+    // Recognize [+-]ddd[.ddd] surrounded by white space.  Utility::plainnum
+    // gives the same result as InternalDecode (which reads the number with
+    // an istringstream).
+    size_t beg = 0, end = len;
+    while (beg < end && isspace(dms[beg]))
+      ++beg;
+    while (beg < end && isspace(dms[end - 1]))
+      --end;
+    return Utility::plainnum<real>(dms + beg, end - beg, val);
+  }
 
   Math::real DMS::Decode(const std::string& dms, flag& ind) {
+    {
+      real val;
+      if (PlainDecode(dms.data(), dms.size(), val)) {
+        ind = NONE;
+        return val;
+      }
+    }
     string errormsg;
     string dmsa = dms;
     replace(dmsa, "\xc2\xb0", 'd');      // U+00b0 degree symbol
@@ -155,17 +175,17 @@ namespace GeographicLib {
             k = npiece;
           }
           if (unsigned(k) == npiece - 1) {
-            errormsg = "Repeated " + components_[k] +
+            errormsg = string("Repeated ") + components_[k] +
               " component in " + dmsa.substr(beg, end - beg);
             break;
           } else if (unsigned(k) < npiece) {
-            errormsg = components_[k] + " component follows "
+            errormsg = string(components_[k]) + " component follows "
               + components_[npiece - 1] + " component in "
               + dmsa.substr(beg, end - beg);
             break;
           }
           if (ncurrent == 0) {
-            errormsg = "Missing numbers in " + components_[k] +
+            errormsg = string("Missing numbers in ") + components_[k] +
               " component of " + dmsa.substr(beg, end - beg);
             break;
           }
@@ -295,13 +315,62 @@ namespace GeographicLib {
     return Math::AngNormalize(azi);
   }
 
+  namespace {
+    // Append characters to a buffer of size len, keeping count of the
+    // characters which don't fit.
+    class Sink {
+    private:
+      char* _buf;
+      size_t _len, _n;
+    public:
+      Sink(char buf[], size_t len) : _buf(buf), _len(len), _n(0) {}
+      void Put(char c) {
+        if (_n + 1 < _len) _buf[_n] = c;
+        ++_n;
+      }
+      void Put(const char* s, size_t k) {
+        if (_n + 1 < _len)
+          memcpy(_buf + _n, s, min(k, _len - 1 - _n));
+        _n += k;
+      }
+      // Put x with p digits after the point padded with 0s to width w
+      void Put(Math::real x, int p, int w) {
+        char tmp[64];
+        size_t k = size_t(Utility::str(tmp, sizeof(tmp), x, p));
+        for (; w > int(k); --w) Put('0');
+        if (k < sizeof(tmp))
+          Put(tmp, k);
+        else {
+          string t(Utility::str(x, p));
+          Put(t.data(), t.size());
+        }
+      }
+      size_t Size() const { return _n; }
+      // Null terminate the result and return its length
+      int Finish() {
+        if (_len > 0) _buf[min(_n, _len - 1)] = '\0';
+        return int(_n);
+      }
+    };
+  }
+
   string DMS::Encode(real angle, component trailing, unsigned prec, flag ind,
                      char dmssep) {
+    char buf[maxencode_];
+    int n = Encode(buf, maxencode_, angle, trailing, prec, ind, dmssep);
+    if (n < maxencode_)
+      return string(buf, n);
+    vector<char> b(n + 1);
+    Encode(&b[0], b.size(), angle, trailing, prec, ind, dmssep);
+    return string(&b[0], n);
+  }
+
+  int DMS::Encode(char buf[], size_t len, real angle, component trailing,
+                  unsigned prec, flag ind, char dmssep) {
     // Assume check on range of input angle has been made by calling
     // routine (which might be able to offer a better diagnostic).
     if (!Math::isfinite(angle))
-      return angle < 0 ? string("-inf") :
-        (angle > 0 ? string("inf") : string("nan"));
+      return Utility::str(buf, len, angle);
 
     // 15 - 2 * trailing = ceiling(log10(2^53/90/60^trailing)).
     // This suffices to give full real precision for numbers in [-90,90]
@@ -334,43 +403,108 @@ namespace GeographicLib {
       pieces[i - 1] = ip;
     }
     pieces[0] += idegree;
-    ostringstream s;
-    s << fixed << setfill('0');
+    Sink s(buf, len);
+    int p = int(prec), w = prec ? int(prec) + 1 : 0;
     if (ind == NONE && sign < 0)
-      s << '-';
+      s.Put('-');
     switch (trailing) {
     case DEGREE:
-      if (ind != NONE)
-        s << setw(1 + min(int(ind), 2) + prec + (prec ? 1 : 0));
-      s << Utility::str(pieces[0], prec);
+      s.Put(pieces[0], p, ind != NONE ? 1 + min(int(ind), 2) + w : 0);
       // Don't include degree designator (d) if it is the trailing component.
       break;
     default:
-      if (ind != NONE)
-        s << setw(1 + min(int(ind), 2));
-      s << int(pieces[0])
-        << (dmssep ? dmssep : char(tolower(dmsindicators_[0])));
+      s.Put(real(int(pieces[0])), 0, ind != NONE ? 1 + min(int(ind), 2) : 0);
+      s.Put(dmssep ? dmssep : char(tolower(dmsindicators_[0])));
       switch (trailing) {
       case MINUTE:
-        s << setw(2 + prec + (prec ? 1 : 0)) << Utility::str(pieces[1], prec);
+        s.Put(pieces[1], p, 2 + w);
         if (!dmssep)
-          s << char(tolower(dmsindicators_[1]));
+          s.Put(char(tolower(dmsindicators_[1])));
         break;
       case SECOND:
-        s << setw(2)
-          << int(pieces[1])
-          << (dmssep ? dmssep : char(tolower(dmsindicators_[1])))
-          << setw(2 + prec + (prec ? 1 : 0)) << Utility::str(pieces[2], prec);
+        s.Put(real(int(pieces[1])), 0, 2);
+        s.Put(dmssep ? dmssep : char(tolower(dmsindicators_[1])));
+        s.Put(pieces[2], p, 2 + w);
         if (!dmssep)
-          s << char(tolower(dmsindicators_[2]));
+          s.Put(char(tolower(dmsindicators_[2])));
         break;
       default:
         break;
       }
     }
     if (ind != NONE && ind != AZIMUTH)
-      s << hemispheres_[(ind == LATITUDE ? 0 : 2) + (sign < 0 ? 0 : 1)];
-    return s.str();
+      s.Put(hemispheres_[(ind == LATITUDE ? 0 : 2) + (sign < 0 ? 0 : 1)]);
+    return s.Finish();
+  }
+
+  size_t DMS::EncodeBatch(const real angle[], size_t n, unsigned prec,
+                          flag ind, char dmssep, char sep,
+                          char buf[], size_t len, size_t offsets[]) {
+    size_t pos = 0, k = 0;
+    if (offsets) offsets[0] = 0;
+    for (; k < n; ++k) {
+      size_t m = size_t(Encode(buf + pos, len - pos, angle[k], prec,
+                               ind, dmssep));
+      // The result is complete if it's shorter than the space available; if
+      // so, the null terminator can be replaced by sep.
+      if (m >= len - pos)
+        break;
+      if (sep) buf[pos + m++] = sep;
+      pos += m;
+      if (offsets) offsets[k + 1] = pos;
+    }
+    return k;
+  }
+
+  size_t DMS::EncodeLatLonBatch(const real lat[], const real lon[], size_t n,
+                                unsigned prec, bool dms,
+                                char dmssep, char sep,
+                                char buf[], size_t len, size_t offsets[]) {
+    size_t pos = 0, k = 0;
+    if (offsets) offsets[0] = 0;
+    for (; k < n; ++k) {
+      size_t m = size_t(Encode(buf + pos, len - pos, lat[k], prec,
+                               dms ? LATITUDE : NUMBER, dmssep));
+      if (m >= len - pos)
+        break;
+      buf[pos + m++] = ' ';
+      size_t m1 = size_t(Encode(buf + pos + m, len - pos - m, lon[k], prec,
+                                dms ? LONGITUDE : NUMBER, dmssep));
+      if (m1 >= len - pos - m)
+        break;
+      m += m1;
+      if (sep) buf[pos + m++] = sep;
+      pos += m;
+      if (offsets) offsets[k + 1] = pos;
+    }
+    return k;
+  }
+
+  void DMS::WriteLatLonBatch(std::ostream& os,
+                             const real lat[], const real lon[], size_t n,
+                             unsigned prec, bool dms, char dmssep, char eol) {
+    const size_t bufsize = 1 << 16;
+    vector<char> buf(bufsize);
+    vector<size_t> offsets(bufsize / 4 + 1);
+    for (size_t i = 0; i < n;) {
+      // Limit each batch so that offsets doesn't overflow
+      size_t
+        nb = min(n - i, bufsize / 4),
+        k = EncodeLatLonBatch(lat + i, lon + i, nb, prec, dms, dmssep, eol,
+                              &buf[0], bufsize, &offsets[0]);
+      if (k > 0) {
+        os.write(&buf[0], offsets[k]);
+        i += k;
+      } else {
+        // A single position which doesn't fit in the buffer (only possible
+        // for enormous angles)
+        os << Encode(lat[i], prec, dms ? LATITUDE : NUMBER, dmssep) << " "
+           << Encode(lon[i], prec, dms ? LONGITUDE : NUMBER, dmssep) << eol;
+        ++i;
+      }
+      if (!os.good())
+        throw GeographicErr("Failure writing data");
+    }
   }
 
 } // namespace GeographicLib
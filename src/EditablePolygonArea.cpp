@@ -0,0 +1,221 @@
+/**
+ * \file EditablePolygonArea.cpp
+ * \brief Implementation for GeographicLib::EditablePolygonAreaT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/EditablePolygonArea.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  template <class GeodType> const size_t EditablePolygonAreaT<GeodType>::nil_;
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Clear() {
+    _num = 0; _first = nil_; _cap = 0;
+    _lat.clear(); _lon.clear();
+    _next.clear(); _prev.clear(); _free.clear();
+    _perimeter.clear(); _area.clear(); _crossings.clear();
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Check(size_t id) const {
+    if (!(id < _next.size() && _next[id] != nil_))
+      throw GeographicErr("Vertex " + Utility::str(id) + " does not exist");
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Reserve(size_t n) {
+    // Make room for ids [0, n) doubling the size of the tree as needed.
+    if (n <= _cap) return;
+    size_t cap = max(size_t(16), _cap);
+    while (cap < n) cap *= 2;
+    vector< Accumulator<> > perimeter(2 * cap), area(2 * cap);
+    vector<int> crossings(2 * cap, 0);
+    for (size_t i = 0; i < _next.size(); ++i) {
+      perimeter[cap + i] = _perimeter[_cap + i];
+      area[cap + i] = _area[_cap + i];
+      crossings[cap + i] = _crossings[_cap + i];
+    }
+    _perimeter.swap(perimeter); _area.swap(area); _crossings.swap(crossings);
+    _cap = cap;
+    Rebuild();
+  }
+
+  template <class GeodType>
+  size_t EditablePolygonAreaT<GeodType>::NewVertex(real lat, real lon) {
+    size_t v;
+    if (!_free.empty()) {
+      v = _free.back(); _free.pop_back();
+    } else {
+      v = _next.size();
+      Reserve(v + 1);
+      _lat.push_back(0); _lon.push_back(0);
+      _next.push_back(v); _prev.push_back(v);
+    }
+    _lat[v] = lat; _lon[v] = Math::AngNormalize(lon);
+    _next[v] = _prev[v] = v;
+    ++_num;
+    return v;
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Link(size_t p, size_t v) {
+    // Put the new vertex v after p.
+    size_t n = _next[p];
+    _next[p] = v; _prev[v] = p;
+    _next[v] = n; _prev[n] = v;
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::SetLeaf(size_t i) {
+    // Compute the contributions of the edge from i to _next[i].  This is the
+    // same as PolygonAreaT::AddPoint.  There's no edge from a single vertex
+    // to itself or, for a polyline, from the last vertex to the first.
+    size_t j = _next[i], k = _cap + i;
+    real s12 = 0, S12 = 0;
+    int crossings = 0;
+    if (j != i && !(_poly._polyline && j == _first)) {
+      real t;
+      _poly._earth.GenInverse(_lat[i], _lon[i], _lat[j], _lon[j],
+                              _poly._mask, s12, t, t, t, t, t, S12);
+      if (_poly._polyline)
+        S12 = 0;
+      else
+        crossings = PolygonAreaT<GeodType>::transit(_lon[i], _lon[j]);
+    }
+    _perimeter[k] = s12; _area[k] = S12; _crossings[k] = crossings;
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Combine(size_t k) {
+    // Set node k to the sum of its children.
+    size_t l = 2 * k, r = l + 1;
+    _perimeter[k] = _perimeter[l]; _perimeter[k] += _perimeter[r];
+    _area[k] = _area[l]; _area[k] += _area[r];
+    _crossings[k] = _crossings[l] + _crossings[r];
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Update(size_t i) {
+    // Recompute leaf i and the nodes above it.
+    SetLeaf(i);
+    for (size_t k = (_cap + i) / 2; k > 0; k /= 2)
+      Combine(k);
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::Rebuild() {
+    for (size_t k = _cap; k-- > 1;)
+      Combine(k);
+  }
+
+  template <class GeodType>
+  size_t EditablePolygonAreaT<GeodType>::AddPoint(real lat, real lon) {
+    size_t v = NewVertex(lat, lon);
+    if (_first == nil_)
+      _first = v;
+    else {
+      size_t p = _prev[_first];
+      Link(p, v);
+      Update(p);
+    }
+    Update(v);
+    return v;
+  }
+
+  template <class GeodType>
+  size_t EditablePolygonAreaT<GeodType>::AddPoints(const real lat[],
+                                                   const real lon[],
+                                                   size_t n) {
+    if (n == 0) return nil_;
+    Reserve(_next.size() + n);
+    size_t p = _first == nil_ ? nil_ : _prev[_first], v0 = nil_;
+    for (size_t i = 0; i < n; ++i) {
+      size_t v = NewVertex(lat[i], lon[i]);
+      if (_first == nil_)
+        _first = v;
+      else
+        Link(_prev[_first], v);
+      if (i == 0) v0 = v;
+    }
+    // Set the leaves for the edges from p (if any) and the new vertices.
+    if (p != nil_) SetLeaf(p);
+    for (size_t v = v0, i = 0; i < n; ++i, v = _next[v])
+      SetLeaf(v);
+    Rebuild();
+    return v0;
+  }
+
+  template <class GeodType>
+  size_t EditablePolygonAreaT<GeodType>::InsertPoint(size_t id,
+                                                     real lat, real lon) {
+    Check(id);
+    size_t v = NewVertex(lat, lon), p = _prev[id];
+    Link(p, v);
+    if (id == _first)
+      _first = v;
+    Update(p);
+    Update(v);
+    return v;
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::MovePoint(size_t id,
+                                                 real lat, real lon) {
+    Check(id);
+    _lat[id] = lat; _lon[id] = Math::AngNormalize(lon);
+    Update(_prev[id]);
+    if (_prev[id] != id)
+      Update(id);
+  }
+
+  template <class GeodType>
+  void EditablePolygonAreaT<GeodType>::RemovePoint(size_t id) {
+    Check(id);
+    size_t p = _prev[id], n = _next[id];
+    _next[p] = n; _prev[n] = p;
+    _next[id] = _prev[id] = id;
+    Update(id);                 // Sets the leaf for id to zero
+    _next[id] = _prev[id] = nil_;
+    _free.push_back(id);
+    --_num;
+    if (_num == 0)
+      _first = nil_;
+    else {
+      if (id == _first)
+        _first = n;
+      Update(p);
+    }
+  }
+
+  template <class GeodType>
+  size_t EditablePolygonAreaT<GeodType>::Compute(bool reverse, bool sign,
+                                                 real& perimeter, real& area)
+    const {
+    if (_num < 2) {
+      perimeter = 0;
+      if (!_poly._polyline)
+        area = 0;
+      return _num;
+    }
+    perimeter = _perimeter[1]();
+    if (_poly._polyline)
+      return _num;
+    Accumulator<> tempsum(_area[1]);
+    area = _poly.ReduceArea(tempsum, _crossings[1], reverse, sign);
+    return _num;
+  }
+
+  template class GEOGRAPHICLIB_EXPORT EditablePolygonAreaT<Geodesic>;
+  template class GEOGRAPHICLIB_EXPORT EditablePolygonAreaT<GeodesicExact>;
+  template class GEOGRAPHICLIB_EXPORT EditablePolygonAreaT<Rhumb>;
+  template class GEOGRAPHICLIB_EXPORT EditablePolygonAreaT<AuthalicSphere>;
+
+} // namespace GeographicLib
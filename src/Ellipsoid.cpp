@@ -13,6 +13,27 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    typedef Math::real real;
+
+    // Evaluate sum(c[k-1] * sin(2*k*x), k, 1, n) using Clenshaw summation
+    // given sin(x) and cos(x); this is Geodesic::SinCosSeries with the
+    // coefficients offset by one.
+    inline real SinSeries(real sinx, real cosx, const real c[], int n) {
+      c += n;                   // Point to one beyond last element
+      real
+        ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
+        y0 = n & 1 ? *--c : 0, y1 = 0;          // accumulators for sum
+      // Now n is even
+      n /= 2;
+      while (n--) {
+        y1 = ar * y0 - y1 + *--c;
+        y0 = ar * y1 - y0 + *--c;
+      }
+      return 2 * sinx * cosx * y0;  // sin(2 * x) * y0
+    }
+  }
+
   Ellipsoid::Ellipsoid(real a, real f)
     : stol_(real(0.01) * sqrt(numeric_limits<real>::epsilon()))
     , _a(a)
@@ -27,7 +48,406 @@ namespace GeographicLib {
     , _tm(_a, _f, real(1))
     , _ell(-_e12)
     , _au(_a, _f, real(0), real(1), real(0), real(1), real(1))
-  {}
+    , _auxseries(abs(_n) <= real(0.003))
+  {
+    // The series for auxiliary latitude j in terms of auxiliary latitude i,
+    // for j = 0, 1, ..., 5 and i != j, in the order of Ellipsoid::auxlatitude
+    // (phi, beta, theta, mu, chi, xi).  The coefficient of sin(2*k*eta) is a
+    // polynomial in n starting at n^k, truncated at n^6.  These are the
+    // series computed by maxima/auxlat.mac and listed in the documentation
+    // (\ref auxlat).
+    static const real coeff[] = {
+      // phi-beta[1]/n^1, polynomial in n of order 5
+      0, 0, 0, 0, 0, 1, 1,
+      // phi-beta[2]/n^2, polynomial in n of order 4
+      0, 0, 0, 0, 1, 2,
+      // phi-beta[3]/n^3, polynomial in n of order 3
+      0, 0, 0, 1, 3,
+      // phi-beta[4]/n^4, polynomial in n of order 2
+      0, 0, 1, 4,
+      // phi-beta[5]/n^5, polynomial in n of order 1
+      0, 1, 5,
+      // phi-beta[6]/n^6, polynomial in n of order 0
+      1, 6,
+      // phi-theta[1]/n^1, polynomial in n of order 5
+      0, 2, 0, -2, 0, 2, 1,
+      // phi-theta[2]/n^2, polynomial in n of order 4
+      6, 0, -4, 0, 2, 1,
+      // phi-theta[3]/n^3, polynomial in n of order 3
+      0, -24, 0, 8, 3,
+      // phi-theta[4]/n^4, polynomial in n of order 2
+      -16, 0, 4, 1,
+      // phi-theta[5]/n^5, polynomial in n of order 1
+      0, 32, 5,
+      // phi-theta[6]/n^6, polynomial in n of order 0
+      32, 3,
+      // phi-mu[1]/n^1, polynomial in n of order 5
+      0, 269, 0, -432, 0, 768, 512,
+      // phi-mu[2]/n^2, polynomial in n of order 4
+      6759, 0, -7040, 0, 5376, 4096,
+      // phi-mu[3]/n^3, polynomial in n of order 3
+      0, -1251, 0, 604, 384,
+      // phi-mu[4]/n^4, polynomial in n of order 2
+      -15543, 0, 5485, 2560,
+      // phi-mu[5]/n^5, polynomial in n of order 1
+      0, 8011, 2560,
+      // phi-mu[6]/n^6, polynomial in n of order 0
+      293393, 61440,
+      // phi-chi[1]/n^1, polynomial in n of order 5
+      -2854, 390, 1740, -1350, -450, 1350, 675,
+      // phi-chi[2]/n^2, polynomial in n of order 4
+      2323, 8112, -4767, -1512, 2205, 945,
+      // phi-chi[3]/n^3, polynomial in n of order 3
+      73814, -34074, -11016, 10584, 2835,
+      // phi-chi[4]/n^4, polynomial in n of order 2
+      -799144, -268920, 192555, 28350,
+      // phi-chi[5]/n^5, polynomial in n of order 1
+      -724190, 413226, 31185,
+      // phi-chi[6]/n^6, polynomial in n of order 0
+      601676, 22275,
+      // phi-xi[1]/n^1, polynomial in n of order 5
+      28112932, 27361880, -38768730, -97297200, 18918900, 283783500, 212837625,
+      // phi-xi[2]/n^2, polynomial in n of order 4
+      251310128, -258181560, -539008470, 102702600, 652702050, 638512875,
+      // phi-xi[3]/n^3, polynomial in n of order 3
+      -43988240, -77303772, 14679522, 58764420, 54729675,
+      // phi-xi[4]/n^4, polynomial in n of order 2
+      -1472637812, 280316400, 818782965, 638512875,
+      // phi-xi[5]/n^5, polynomial in n of order 1
+      455935736, 1048691280, 638512875,
+      // phi-xi[6]/n^6, polynomial in n of order 0
+      4210684958LL, 1915538625,
+      // beta-phi[1]/n^1, polynomial in n of order 5
+      0, 0, 0, 0, 0, -1, 1,
+      // beta-phi[2]/n^2, polynomial in n of order 4
+      0, 0, 0, 0, 1, 2,
+      // beta-phi[3]/n^3, polynomial in n of order 3
+      0, 0, 0, -1, 3,
+      // beta-phi[4]/n^4, polynomial in n of order 2
+      0, 0, 1, 4,
+      // beta-phi[5]/n^5, polynomial in n of order 1
+      0, -1, 5,
+      // beta-phi[6]/n^6, polynomial in n of order 0
+      1, 6,
+      // beta-theta[1]/n^1, polynomial in n of order 5
+      0, 0, 0, 0, 0, 1, 1,
+      // beta-theta[2]/n^2, polynomial in n of order 4
+      0, 0, 0, 0, 1, 2,
+      // beta-theta[3]/n^3, polynomial in n of order 3
+      0, 0, 0, 1, 3,
+      // beta-theta[4]/n^4, polynomial in n of order 2
+      0, 0, 1, 4,
+      // beta-theta[5]/n^5, polynomial in n of order 1
+      0, 1, 5,
+      // beta-theta[6]/n^6, polynomial in n of order 0
+      1, 6,
+      // beta-mu[1]/n^1, polynomial in n of order 5
+      0, 205, 0, -432, 0, 768, 1536,
+      // beta-mu[2]/n^2, polynomial in n of order 4
+      4005, 0, -4736, 0, 3840, 12288,
+      // beta-mu[3]/n^3, polynomial in n of order 3
+      0, -225, 0, 116, 384,
+      // beta-mu[4]/n^4, polynomial in n of order 2
+      -7173, 0, 2695, 7680,
+      // beta-mu[5]/n^5, polynomial in n of order 1
+      0, 3467, 7680,
+      // beta-mu[6]/n^6, polynomial in n of order 0
+      38081, 61440,
+      // beta-chi[1]/n^1, polynomial in n of order 5
+      -3118, -1575, 3990, -1575, -3150, 4725, 4725,
+      // beta-chi[2]/n^2, polynomial in n of order 4
+      -1729, 4500, -1470, -1764, 1575, 1890,
+      // beta-chi[3]/n^3, polynomial in n of order 3
+      17564, -4725, -4590, 3024, 2835,
+      // beta-chi[4]/n^4, polynomial in n of order 2
+      -199508, -176400, 93105, 56700,
+      // beta-chi[5]/n^5, polynomial in n of order 1
+      -197708, 87417, 31185,
+      // beta-chi[6]/n^6, polynomial in n of order 0
+      797222, 155925,
+      // beta-xi[1]/n^1, polynomial in n of order 5
+      7947332, 5379920, -16246230, -31081050, 18918900, 70945875, 212837625,
+      // beta-xi[2]/n^2, polynomial in n of order 4
+      79893406, -136543680, -213152940, 91891800, 241215975, 1277025750,
+      // beta-xi[3]/n^3, polynomial in n of order 3
+      -8940890, -11825073, 4254822, 8899605, 54729675,
+      // beta-xi[4]/n^4, polynomial in n of order 2
+      -756131048, 243789000, 427161735, 2554051500LL,
+      // beta-xi[5]/n^5, polynomial in n of order 1
+      80274086, 121304820, 638512875,
+      // beta-xi[6]/n^6, polynomial in n of order 0
+      880980241, 3831077250LL,
+      // theta-phi[1]/n^1, polynomial in n of order 5
+      0, -2, 0, 2, 0, -2, 1,
+      // theta-phi[2]/n^2, polynomial in n of order 4
+      6, 0, -4, 0, 2, 1,
+      // theta-phi[3]/n^3, polynomial in n of order 3
+      0, 24, 0, -8, 3,
+      // theta-phi[4]/n^4, polynomial in n of order 2
+      -16, 0, 4, 1,
+      // theta-phi[5]/n^5, polynomial in n of order 1
+      0, -32, 5,
+      // theta-phi[6]/n^6, polynomial in n of order 0
+      32, 3,
+      // theta-beta[1]/n^1, polynomial in n of order 5
+      0, 0, 0, 0, 0, -1, 1,
+      // theta-beta[2]/n^2, polynomial in n of order 4
+      0, 0, 0, 0, 1, 2,
+      // theta-beta[3]/n^3, polynomial in n of order 3
+      0, 0, 0, -1, 3,
+      // theta-beta[4]/n^4, polynomial in n of order 2
+      0, 0, 1, 4,
+      // theta-beta[5]/n^5, polynomial in n of order 1
+      0, -1, 5,
+      // theta-beta[6]/n^6, polynomial in n of order 0
+      1, 6,
+      // theta-mu[1]/n^1, polynomial in n of order 5
+      0, 499, 0, -1104, 0, -768, 1536,
+      // theta-mu[2]/n^2, polynomial in n of order 4
+      6565, 0, -640, 0, 3840, 12288,
+      // theta-mu[3]/n^3, polynomial in n of order 3
+      0, -77, 0, 4, 128,
+      // theta-mu[4]/n^4, polynomial in n of order 2
+      -4037, 0, 1415, 7680,
+      // theta-mu[5]/n^5, polynomial in n of order 1
+      0, 1301, 7680,
+      // theta-mu[6]/n^6, polynomial in n of order 0
+      17089, 61440,
+      // theta-chi[1]/n^1, polynomial in n of order 5
+      -3658, 1050, 2100, -3150, -3150, 0, 4725,
+      // theta-chi[2]/n^2, polynomial in n of order 4
+      61, 204, -69, -36, 45, 135,
+      // theta-chi[3]/n^3, polynomial in n of order 3
+      9446, -3726, -1944, 1134, 2835,
+      // theta-chi[4]/n^4, polynomial in n of order 2
+      -69424, -36000, 18675, 28350,
+      // theta-chi[5]/n^5, polynomial in n of order 1
+      -11810, 5148, 4455,
+      // theta-chi[6]/n^6, polynomial in n of order 0
+      335882, 155925,
+      // theta-xi[1]/n^1, polynomial in n of order 5
+      17571492, 49614110, -31561530, -106756650, 18918900, -141891750,
+      212837625,
+      // theta-xi[2]/n^2, polynomial in n of order 4
+      117952358, -29713320, 42072030, -10810800, 227026800, 638512875,
+      // theta-xi[3]/n^3, polynomial in n of order 3
+      -7391576, -20709234, 3559842, -4478760, 54729675,
+      // theta-xi[4]/n^4, polynomial in n of order 2
+      -67048172, 9145500, 97162065, 638512875,
+      // theta-xi[5]/n^5, polynomial in n of order 1
+      46774256, 19593210, 638512875,
+      // theta-xi[6]/n^6, polynomial in n of order 0
+      253129538, 1915538625,
+      // mu-phi[1]/n^1, polynomial in n of order 5
+      0, -3, 0, 18, 0, -48, 32,
+      // mu-phi[2]/n^2, polynomial in n of order 4
+      135, 0, -960, 0, 1920, 2048,
+      // mu-phi[3]/n^3, polynomial in n of order 3
+      0, 315, 0, -560, 768,
+      // mu-phi[4]/n^4, polynomial in n of order 2
+      -189, 0, 315, 512,
+      // mu-phi[5]/n^5, polynomial in n of order 1
+      0, -693, 1280,
+      // mu-phi[6]/n^6, polynomial in n of order 0
+      1001, 2048,
+      // mu-beta[1]/n^1, polynomial in n of order 5
+      0, -1, 0, 6, 0, -16, 32,
+      // mu-beta[2]/n^2, polynomial in n of order 4
+      -9, 0, 64, 0, -128, 2048,
+      // mu-beta[3]/n^3, polynomial in n of order 3
+      0, 9, 0, -16, 768,
+      // mu-beta[4]/n^4, polynomial in n of order 2
+      3, 0, -5, 512,
+      // mu-beta[5]/n^5, polynomial in n of order 1
+      0, -7, 1280,
+      // mu-beta[6]/n^6, polynomial in n of order 0
+      -7, 2048,
+      // mu-theta[1]/n^1, polynomial in n of order 5
+      0, -15, 0, 26, 0, 16, 32,
+      // mu-theta[2]/n^2, polynomial in n of order 4
+      -1673, 0, 2112, 0, -128, 2048,
+      // mu-theta[3]/n^3, polynomial in n of order 3
+      0, 349, 0, -80, 256,
+      // mu-theta[4]/n^4, polynomial in n of order 2
+      963, 0, -261, 512,
+      // mu-theta[5]/n^5, polynomial in n of order 1
+      0, -921, 1280,
+      // mu-theta[6]/n^6, polynomial in n of order 0
+      -6037, 6144,
+      // mu-chi[1]/n^1, polynomial in n of order 5
+      31564, -66675, 34440, 47250, -100800, 75600, 151200,
+      // mu-chi[2]/n^2, polynomial in n of order 4
+      -1983433, 863232, 748608, -1161216, 524160, 1935360,
+      // mu-chi[3]/n^3, polynomial in n of order 3
+      670412, 406647, -533952, 184464, 725760,
+      // mu-chi[4]/n^4, polynomial in n of order 2
+      6601661, -7732800, 2230245, 7257600,
+      // mu-chi[5]/n^5, polynomial in n of order 1
+      -13675556, 3438171, 7983360,
+      // mu-chi[6]/n^6, polynomial in n of order 0
+      212378941, 319334400,
+      // mu-xi[1]/n^1, polynomial in n of order 5
+      101394584, -174824195, -386546160, 490540050, 605404800, -1135134000,
+      6810804000LL,
+      // mu-xi[2]/n^2, polynomial in n of order 4
+      -31621753811LL, -32531466240LL, 47460853440LL, 35978342400LL,
+      -52670217600LL, 1307674368000LL,
+      // mu-xi[3]/n^3, polynomial in n of order 3
+      -262758248, 438287499, 221899392, -309806640, 14010796800LL,
+      // mu-xi[4]/n^4, polynomial in n of order 2
+      10650637121LL, 3846460800LL, -5467156695LL, 326918592000LL,
+      // mu-xi[5]/n^5, polynomial in n of order 1
+      1640580776, -2457599235LL, 163459296000LL,
+      // mu-xi[6]/n^6, polynomial in n of order 0
+      -59109051671LL, 3923023104000LL,
+      // chi-phi[1]/n^1, polynomial in n of order 5
+      4642, 3360, -8610, 6300, 3150, -9450, 4725,
+      // chi-phi[2]/n^2, polynomial in n of order 4
+      -1522, 2712, -1365, -1008, 1575, 945,
+      // chi-phi[3]/n^3, polynomial in n of order 3
+      -12686, 4536, 4590, -4914, 2835,
+      // chi-phi[4]/n^4, polynomial in n of order 2
+      -49664, -68040, 55665, 28350,
+      // chi-phi[5]/n^5, polynomial in n of order 1
+      109598, -72666, 31185,
+      // chi-phi[6]/n^6, polynomial in n of order 0
+      444337, 155925,
+      // chi-beta[1]/n^1, polynomial in n of order 5
+      -998, 1890, -1680, 0, 3150, -4725, 4725,
+      // chi-beta[2]/n^2, polynomial in n of order 4
+      -140, -396, 798, -756, 315, 1890,
+      // chi-beta[3]/n^3, polynomial in n of order 3
+      580, -594, 432, -189, 2835,
+      // chi-beta[4]/n^4, polynomial in n of order 2
+      8492, -4320, 765, 56700,
+      // chi-beta[5]/n^5, polynomial in n of order 1
+      896, -297, 31185,
+      // chi-beta[6]/n^6, polynomial in n of order 0
+      149, 311850,
+      // chi-theta[1]/n^1, polynomial in n of order 5
+      1042, -1470, -1050, 3150, 3150, 0, 4725,
+      // chi-theta[2]/n^2, polynomial in n of order 4
+      -712, -84, 903, 252, -315, 945,
+      // chi-theta[3]/n^3, polynomial in n of order 3
+      274, 3348, 54, -1134, 2835,
+      // chi-theta[4]/n^4, polynomial in n of order 2
+      42136, -4320, -12375, 28350,
+      // chi-theta[5]/n^5, polynomial in n of order 1
+      -9202, -15246, 31185,
+      // chi-theta[6]/n^6, polynomial in n of order 0
+      -90263, 155925,
+      // chi-mu[1]/n^1, polynomial in n of order 5
+      -384796, 382725, 6720, -932400, 1612800, -1209600, 2419200,
+      // chi-mu[2]/n^2, polynomial in n of order 4
+      1118711, -1695744, 1174656, -258048, -80640, 3870720,
+      // chi-mu[3]/n^3, polynomial in n of order 3
+      -22276, 16929, 15984, -12852, 362880,
+      // chi-mu[4]/n^4, polynomial in n of order 2
+      830251, 158400, -197865, 7257600,
+      // chi-mu[5]/n^5, polynomial in n of order 1
+      435388, -453717, 15966720,
+      // chi-mu[6]/n^6, polynomial in n of order 0
+      -20648693, 638668800,
+      // chi-xi[1]/n^1, polynomial in n of order 5
+      -55271278, 61716200, -34714680, -59459400, 160810650, -141891750,
+      212837625,
+      // chi-xi[2]/n^2, polynomial in n of order 4
+      106691108, -269713080, 273828555, -124324200, 14189175, 638512875,
+      // chi-xi[3]/n^3, polynomial in n of order 3
+      5921152, -1666782, 2980692, -2046330, 54729675,
+      // chi-xi[4]/n^4, polynomial in n of order 2
+      151188656, -14501760, -22567545, 1277025750,
+      // chi-xi[5]/n^5, polynomial in n of order 1
+      2837636, -11848200, 638512875,
+      // chi-xi[6]/n^6, polynomial in n of order 0
+      -34761247, 1915538625,
+      // xi-phi[1]/n^1, polynomial in n of order 5
+      -670980, 1894984, 4846842, 11891880, -3783780, -56756700, 42567525,
+      // xi-phi[2]/n^2, polynomial in n of order 4
+      -12467764, -16922360, -37267230, 16216200, 160810650, 212837625,
+      // xi-phi[3]/n^3, polynomial in n of order 3
+      100320856, 225093960, -121351230, -1035134100, 1915538625,
+      // xi-phi[4]/n^4, polynomial in n of order 2
+      -17652372, 11145680, 90195105, 212837625,
+      // xi-phi[5]/n^5, polynomial in n of order 1
+      -9237712, -74388860, 212837625,
+      // xi-phi[6]/n^6, polynomial in n of order 0
+      570284222, 1915538625,
+      // xi-beta[1]/n^1, polynomial in n of order 5
+      -352480, 225316, 2144142, 4324320, -3783780, -14189175, 42567525,
+      // xi-beta[2]/n^2, polynomial in n of order 4
+      107672, 3632720, 15555540, -5405400, -33108075, 425675250,
+      // xi-beta[3]/n^3, polynomial in n of order 3
+      -661844, 28877940, 270270, -56081025, 1915538625,
+      // xi-beta[4]/n^4, polynomial in n of order 2
+      5703112, 1699880, -11966955, 851350500,
+      // xi-beta[5]/n^5, polynomial in n of order 1
+      390088, -1671215, 212837625,
+      // xi-beta[6]/n^6, polynomial in n of order 0
+      -18623681, 3831077250LL,
+      // xi-theta[1]/n^1, polynomial in n of order 5
+      -4286228, -17570462, 7009002, 25135110, -3783780, 28378350, 42567525,
+      // xi-theta[2]/n^2, polynomial in n of order 4
+      -184871814, 42176680, 185255070, -21621600, 18918900, 212837625,
+      // xi-theta[3]/n^3, polynomial in n of order 3
+      427003576, 2508334920LL, -218648430, -354053700, 1915538625,
+      // xi-theta[4]/n^4, polynomial in n of order 2
+      427770788, -26511940, -89083995, 212837625,
+      // xi-theta[5]/n^5, polynomial in n of order 1
+      -27459552, -145620020, 212837625,
+      // xi-theta[6]/n^6, polynomial in n of order 0
+      -1978771378, 1915538625,
+      // xi-mu[1]/n^1, polynomial in n of order 5
+      -669095352, 706529369, 1495638144, -1766484720, -1937295360, 3632428800LL,
+      21794572800LL,
+      // xi-mu[2]/n^2, polynomial in n of order 4
+      36019108271LL, 66112184320LL, -56906129280LL, -49816166400LL,
+      59329670400LL, 871782912000LL,
+      // xi-mu[3]/n^3, polynomial in n of order 3
+      24208036088LL, -17636440185LL, -12614041440LL, 12062150100LL,
+      245188944000LL,
+      // xi-mu[4]/n^4, polynomial in n of order 2
+      -9953862579LL, -5957544320LL, 4981961985LL, 108972864000LL,
+      // xi-mu[5]/n^5, polynomial in n of order 1
+      -7003656584LL, 5343626015LL, 108972864000LL,
+      // xi-mu[6]/n^6, polynomial in n of order 0
+      453002260127LL, 7846046208000LL,
+      // xi-chi[1]/n^1, polynomial in n of order 5
+      2706758, -25126010, 22144122, 6216210, -32162130, 28378350, 42567525,
+      // xi-chi[2]/n^2, polynomial in n of order 4
+      -340492279, 235209520, 51246195, -172972800, 89864775, 212837625,
+      // xi-chi[3]/n^3, polynomial in n of order 3
+      4430783356LL, 846985230, -2156484330LL, 837837000, 1915538625,
+      // xi-chi[4]/n^4, polynomial in n of order 2
+      372098616, -758008160, 240975735, 425675250,
+      // xi-chi[5]/n^5, polynomial in n of order 1
+      -651151712, 177472750, 212837625,
+      // xi-chi[6]/n^6, polynomial in n of order 0
+      2561772812LL, 1915538625,
+    };  // count = 810
+
+    GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) ==
+                                naux_ * (naux_ - 1) *
+                                (auxorder_ * (auxorder_ + 3)) / 2,
+                                "Coefficient array size mismatch for "
+                                "auxiliary latitudes");
+    fill(_auxc, _auxc + naux_ * naux_ * auxorder_, real(0));
+    if (!_auxseries)
+      return;
+    int o = 0;
+    for (int j = 0; j < naux_; ++j)
+      for (int i = 0; i < naux_; ++i) {
+        if (i == j) continue;
+        real* c = _auxc + (naux_ * j + i) * auxorder_, d = _n;
+        for (int l = 0; l < auxorder_; ++l) {
+          int m = auxorder_ - l - 1; // order of polynomial in n
+          c[l] = d * Math::polyval(m, coeff + o, _n) / coeff[o + m + 1];
+          o += m + 2;
+          d *= _n;
+        }
+      }
+    // o == sizeof(coeff) / sizeof(real)
+  }
 
   const Ellipsoid& Ellipsoid::WGS84() {
     static const Ellipsoid wgs84(Constants::WGS84_a(), Constants::WGS84_f());
@@ -45,18 +465,6 @@ namespace GeographicLib {
          sqrt(abs(_e2))))/2);
   }
 
-  Math::real Ellipsoid::ParametricLatitude(real phi) const
-  { return Math::atand(_f1 * Math::tand(phi)); }
-
-  Math::real Ellipsoid::InverseParametricLatitude(real beta) const
-  { return Math::atand(Math::tand(beta) / _f1); }
-
-  Math::real Ellipsoid::GeocentricLatitude(real phi) const
-  { return Math::atand(_f12 * Math::tand(phi)); }
-
-  Math::real Ellipsoid::InverseGeocentricLatitude(real theta) const
-  { return Math::atand(Math::tand(theta) / _f12); }
-
   Math::real Ellipsoid::RectifyingLatitude(real phi) const {
     return abs(phi) == 90 ? phi:
       90 * MeridianDistance(phi) / QuarterMeridian();
@@ -75,17 +483,163 @@ namespace GeographicLib {
   Math::real Ellipsoid::InverseAuthalicLatitude(real xi) const
   { return Math::atand(_au.tphif(Math::tand(xi))); }
 
-  Math::real Ellipsoid::ConformalLatitude(real phi) const
-  { return Math::atand(Math::taupf(Math::tand(phi), _es)); }
+  void Ellipsoid::RectifyingLatitude(const real phi[], size_t n, real mu[])
+    const {
+    real beta[nblock_], e[nblock_], L = QuarterMeridian();
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l)
+        beta[l] = ParametricLatitude(phi[i + l]);
+      _ell.Ed(beta, m, e);
+      for (int l = 0; l < m; ++l) {
+        real p = phi[i + l];
+        mu[i + l] = abs(p) == 90 ? p : 90 * (_b * e[l]) / L;
+      }
+    }
+  }
+
+  void Ellipsoid::InverseRectifyingLatitude(const real mu[], size_t n,
+                                            real phi[]) const {
+    // Einv solves for each latitude separately.
+    for (size_t i = 0; i < n; ++i)
+      phi[i] = InverseRectifyingLatitude(mu[i]);
+  }
+
+  void Ellipsoid::AuthalicLatitude(const real phi[], size_t n, real xi[])
+    const {
+    for (size_t i = 0; i < n; ++i)
+      xi[i] = AuthalicLatitude(phi[i]);
+  }
+
+  void Ellipsoid::InverseAuthalicLatitude(const real xi[], size_t n,
+                                          real phi[]) const {
+    for (size_t i = 0; i < n; ++i)
+      phi[i] = InverseAuthalicLatitude(xi[i]);
+  }
+
+  void Ellipsoid::ConformalLatitude(const real phi[], size_t n, real chi[])
+    const {
+    real t[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l)
+        t[l] = Math::tand(phi[i + l]);
+      Math::taupf(t, t, m, _es);
+      for (int l = 0; l < m; ++l)
+        chi[i + l] = Math::atand(t[l]);
+    }
+  }
+
+  void Ellipsoid::InverseConformalLatitude(const real chi[], size_t n,
+                                           real phi[]) const {
+    real t[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l)
+        t[l] = Math::tand(chi[i + l]);
+      Math::tauf(t, t, m, _es);
+      for (int l = 0; l < m; ++l)
+        phi[i + l] = Math::atand(t[l]);
+    }
+  }
+
+  void Ellipsoid::IsometricLatitude(const real phi[], size_t n, real psi[])
+    const {
+    real t[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l)
+        t[l] = Math::tand(phi[i + l]);
+      Math::taupf(t, t, m, _es);
+      for (int l = 0; l < m; ++l)
+        psi[i + l] = Math::asinh(t[l]) / Math::degree();
+    }
+  }
 
-  Math::real Ellipsoid::InverseConformalLatitude(real chi) const
-  { return Math::atand(Math::tauf(Math::tand(chi), _es)); }
+  void Ellipsoid::InverseIsometricLatitude(const real psi[], size_t n,
+                                           real phi[]) const {
+    real t[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l)
+        t[l] = sinh(psi[i + l] * Math::degree());
+      Math::tauf(t, t, m, _es);
+      for (int l = 0; l < m; ++l)
+        phi[i + l] = Math::atand(t[l]);
+    }
+  }
 
-  Math::real Ellipsoid::IsometricLatitude(real phi) const
-  { return Math::asinh(Math::taupf(Math::tand(phi), _es)) / Math::degree(); }
+  Math::real Ellipsoid::ToGeographic(int auxin, real eta) const {
+    switch (auxin) {
+    case PARAMETRIC: return InverseParametricLatitude(eta);
+    case GEOCENTRIC: return InverseGeocentricLatitude(eta);
+    case RECTIFYING: return InverseRectifyingLatitude(eta);
+    case CONFORMAL:  return InverseConformalLatitude(eta);
+    case AUTHALIC:   return InverseAuthalicLatitude(eta);
+    default:         return eta;
+    }
+  }
 
-  Math::real Ellipsoid::InverseIsometricLatitude(real psi) const
-  { return Math::atand(Math::tauf(sinh(psi * Math::degree()), _es)); }
+  Math::real Ellipsoid::FromGeographic(int auxout, real phi) const {
+    switch (auxout) {
+    case PARAMETRIC: return ParametricLatitude(phi);
+    case GEOCENTRIC: return GeocentricLatitude(phi);
+    case RECTIFYING: return RectifyingLatitude(phi);
+    case CONFORMAL:  return ConformalLatitude(phi);
+    case AUTHALIC:   return AuthalicLatitude(phi);
+    default:         return phi;
+    }
+  }
+
+  void Ellipsoid::ToGeographic(int auxin, const real eta[], size_t n,
+                               real phi[]) const {
+    switch (auxin) {
+    case RECTIFYING: InverseRectifyingLatitude(eta, n, phi); break;
+    case CONFORMAL:  InverseConformalLatitude(eta, n, phi); break;
+    case AUTHALIC:   InverseAuthalicLatitude(eta, n, phi); break;
+    default:
+      for (size_t i = 0; i < n; ++i)
+        phi[i] = ToGeographic(auxin, eta[i]);
+    }
+  }
+
+  void Ellipsoid::FromGeographic(int auxout, const real phi[], size_t n,
+                                 real zeta[]) const {
+    switch (auxout) {
+    case RECTIFYING: RectifyingLatitude(phi, n, zeta); break;
+    case CONFORMAL:  ConformalLatitude(phi, n, zeta); break;
+    case AUTHALIC:   AuthalicLatitude(phi, n, zeta); break;
+    default:
+      for (size_t i = 0; i < n; ++i)
+        zeta[i] = FromGeographic(auxout, phi[i]);
+    }
+  }
+
+  Math::real Ellipsoid::ConvertLatitude(auxlatitude auxin,
+                                        auxlatitude auxout,
+                                        real eta) const {
+    if (auxin == auxout)
+      return eta;
+    if (!_auxseries)
+      return FromGeographic(auxout, ToGeographic(auxin, eta));
+    real s, c;
+    Math::sincosd(eta, s, c);
+    // sin(2*eta) = 0 exactly at the poles so that these are preserved.
+    return eta + SinSeries(s, c, _auxc + (naux_ * auxout + auxin) * auxorder_,
+                           auxorder_) / Math::degree();
+  }
+
+  void Ellipsoid::ConvertLatitude(auxlatitude auxin, auxlatitude auxout,
+                                  const real eta[], size_t n, real zeta[])
+    const {
+    if (auxin == auxout || _auxseries) {
+      for (size_t i = 0; i < n; ++i)
+        zeta[i] = ConvertLatitude(auxin, auxout, eta[i]);
+    } else {
+      ToGeographic(auxin, eta, n, zeta);
+      FromGeographic(auxout, zeta, n, zeta);
+    }
+  }
 
   Math::real Ellipsoid::CircleRadius(real phi) const {
     return abs(phi) == 90 ? 0 :
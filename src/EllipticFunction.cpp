@@ -26,6 +26,56 @@ namespace GeographicLib {
    *   Numerical Algorithms 10, 13-26 (1995)
    */
 
+  namespace {
+    typedef Math::real real;
+
+    // The array versions of RF and RD apply the duplication steps to blocks
+    // of nblock_ problems.  The convergence test is applied to each problem
+    // and problems which have converged are left unchanged; so each problem
+    // undergoes the same operations as in the scalar version.
+    const int nblock_ = 8;
+
+    // The final steps of RF and RD (given the results of the duplication
+    // steps), shared by the scalar and array versions.
+    inline real RFfinal(real x, real y, real A0, real An, real mul) {
+      real
+        X = (A0 - x) / (mul * An),
+        Y = (A0 - y) / (mul * An),
+        Z = - (X + Y),
+        E2 = X*Y - Z*Z,
+        E3 = X*Y*Z;
+      // http://dlmf.nist.gov/19.36.E1
+      // Polynomial is
+      // (1 - E2/10 + E3/14 + E2^2/24 - 3*E2*E3/44
+      //    - 5*E2^3/208 + 3*E3^2/104 + E2^2*E3/16)
+      // convert to Horner form...
+      return (E3 * (6930 * E3 + E2 * (15015 * E2 - 16380) + 17160) +
+              E2 * ((10010 - 5775 * E2) * E2 - 24024) + 240240) /
+        (240240 * sqrt(An));
+    }
+
+    inline real RDfinal(real x, real y, real A0, real An, real mul, real s) {
+      real
+        X = (A0 - x) / (mul * An),
+        Y = (A0 - y) / (mul * An),
+        Z = -(X + Y) / 3,
+        E2 = X*Y - 6*Z*Z,
+        E3 = (3*X*Y - 8*Z*Z)*Z,
+        E4 = 3 * (X*Y - Z*Z) * Z*Z,
+        E5 = X*Y*Z*Z*Z;
+      // http://dlmf.nist.gov/19.36.E2
+      // Polynomial is
+      // (1 - 3*E2/14 + E3/6 + 9*E2^2/88 - 3*E4/22 - 9*E2*E3/52 + 3*E5/26
+      //    - E2^3/16 + 3*E3^2/40 + 3*E2*E4/20 + 45*E2^2*E3/272
+      //    - 9*(E3*E4+E2*E5)/68)
+      return ((471240 - 540540 * E2) * E5 +
+              (612612 * E2 - 540540 * E3 - 556920) * E4 +
+              E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) + 680680) +
+              E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
+        (4084080 * mul * An * sqrt(An)) + 3 * s;
+    }
+  }
+
   Math::real EllipticFunction::RF(real x, real y, real z) {
     // Carlson, eqs 2.2 - 2.7
     real tolRF =
@@ -47,20 +97,7 @@ namespace GeographicLib {
       z0 = (z0 + lam)/4;
       mul *= 4;
     }
-    real
-      X = (A0 - x) / (mul * An),
-      Y = (A0 - y) / (mul * An),
-      Z = - (X + Y),
-      E2 = X*Y - Z*Z,
-      E3 = X*Y*Z;
-    // http://dlmf.nist.gov/19.36.E1
-    // Polynomial is
-    // (1 - E2/10 + E3/14 + E2^2/24 - 3*E2*E3/44
-    //    - 5*E2^3/208 + 3*E3^2/104 + E2^2*E3/16)
-    // convert to Horner form...
-    return (E3 * (6930 * E3 + E2 * (15015 * E2 - 16380) + 17160) +
-            E2 * ((10010 - 5775 * E2) * E2 - 24024) + 240240) /
-      (240240 * sqrt(An));
+    return RFfinal(x, y, A0, An, mul);
   }
 
   Math::real EllipticFunction::RF(real x, real y) {
@@ -199,24 +236,113 @@ namespace GeographicLib {
       z0 = (z0 + lam)/4;
       mul *= 4;
     }
-    real
-      X = (A0 - x) / (mul * An),
-      Y = (A0 - y) / (mul * An),
-      Z = -(X + Y) / 3,
-      E2 = X*Y - 6*Z*Z,
-      E3 = (3*X*Y - 8*Z*Z)*Z,
-      E4 = 3 * (X*Y - Z*Z) * Z*Z,
-      E5 = X*Y*Z*Z*Z;
-    // http://dlmf.nist.gov/19.36.E2
-    // Polynomial is
-    // (1 - 3*E2/14 + E3/6 + 9*E2^2/88 - 3*E4/22 - 9*E2*E3/52 + 3*E5/26
-    //    - E2^3/16 + 3*E3^2/40 + 3*E2*E4/20 + 45*E2^2*E3/272
-    //    - 9*(E3*E4+E2*E5)/68)
-    return ((471240 - 540540 * E2) * E5 +
-            (612612 * E2 - 540540 * E3 - 556920) * E4 +
-            E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) + 680680) +
-            E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
-      (4084080 * mul * An * sqrt(An)) + 3 * s;
+    return RDfinal(x, y, A0, An, mul, s);
+  }
+
+  void EllipticFunction::RF(const real x[], const real y[], const real z[],
+                            size_t n, real rf[]) {
+    // Same as the scalar RF, applied to blocks of nblock_ problems.
+    real tolRF =
+      pow(3 * numeric_limits<real>::epsilon() * real(0.01), 1/real(8));
+    real A0[nblock_], An[nblock_], Q[nblock_],
+      x0[nblock_], y0[nblock_], z0[nblock_], mul[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      const real *xb = x + i, *yb = y + i, *zb = z + i;
+      for (int l = 0; l < m; ++l) {
+        An[l] = A0[l] = (xb[l] + yb[l] + zb[l])/3;
+        Q[l] = max(max(abs(A0[l]-xb[l]), abs(A0[l]-yb[l])),
+                   abs(A0[l]-zb[l])) / tolRF;
+        x0[l] = xb[l]; y0[l] = yb[l]; z0[l] = zb[l];
+        mul[l] = 1;
+      }
+      for (bool active = true; active;) {
+        active = false;
+        for (int l = 0; l < m; ++l) {
+          if (Q[l] >= mul[l] * abs(An[l])) {
+            active = true;
+            real lam = sqrt(x0[l])*sqrt(y0[l]) + sqrt(y0[l])*sqrt(z0[l]) +
+              sqrt(z0[l])*sqrt(x0[l]);
+            An[l] = (An[l] + lam)/4;
+            x0[l] = (x0[l] + lam)/4;
+            y0[l] = (y0[l] + lam)/4;
+            z0[l] = (z0[l] + lam)/4;
+            mul[l] *= 4;
+          }
+        }
+      }
+      for (int l = 0; l < m; ++l)
+        rf[i + l] = RFfinal(xb[l], yb[l], A0[l], An[l], mul[l]);
+    }
+  }
+
+  void EllipticFunction::RD(const real x[], const real y[], const real z[],
+                            size_t n, real rd[]) {
+    // Same as the scalar RD, applied to blocks of nblock_ problems.
+    real tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
+                     1/real(8));
+    real A0[nblock_], An[nblock_], Q[nblock_],
+      x0[nblock_], y0[nblock_], z0[nblock_], mul[nblock_], s[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      const real *xb = x + i, *yb = y + i, *zb = z + i;
+      for (int l = 0; l < m; ++l) {
+        An[l] = A0[l] = (xb[l] + yb[l] + 3*zb[l])/5;
+        Q[l] = max(max(abs(A0[l]-xb[l]), abs(A0[l]-yb[l])),
+                   abs(A0[l]-zb[l])) / tolRD;
+        x0[l] = xb[l]; y0[l] = yb[l]; z0[l] = zb[l];
+        mul[l] = 1; s[l] = 0;
+      }
+      for (bool active = true; active;) {
+        active = false;
+        for (int l = 0; l < m; ++l) {
+          if (Q[l] >= mul[l] * abs(An[l])) {
+            active = true;
+            real lam = sqrt(x0[l])*sqrt(y0[l]) + sqrt(y0[l])*sqrt(z0[l]) +
+              sqrt(z0[l])*sqrt(x0[l]);
+            s[l] += 1/(mul[l] * sqrt(z0[l]) * (z0[l] + lam));
+            An[l] = (An[l] + lam)/4;
+            x0[l] = (x0[l] + lam)/4;
+            y0[l] = (y0[l] + lam)/4;
+            z0[l] = (z0[l] + lam)/4;
+            mul[l] *= 4;
+          }
+        }
+      }
+      for (int l = 0; l < m; ++l)
+        rd[i + l] = RDfinal(xb[l], yb[l], A0[l], An[l], mul[l], s[l]);
+    }
+  }
+
+  void EllipticFunction::RG(const real x[], const real y[], const real z[],
+                            size_t n, real rg[]) {
+    real xb[nblock_], yb[nblock_], zb[nblock_], rf[nblock_], rd[nblock_];
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l) {
+        xb[l] = x[i + l]; yb[l] = y[i + l]; zb[l] = z[i + l];
+        if (zb[l] == 0)
+          swap(yb[l], zb[l]);
+      }
+      RF(xb, yb, zb, size_t(m), rf);
+      RD(xb, yb, zb, size_t(m), rd);
+      for (int l = 0; l < m; ++l)
+        // Carlson, eq 1.7
+        rg[i + l] = (zb[l] * rf[l] - (xb[l]-zb[l]) * (yb[l]-zb[l]) * rd[l] / 3
+                     + sqrt(xb[l] * yb[l] / zb[l])) / 2;
+    }
+  }
+
+  void EllipticFunction::RJ(const real x[], const real y[], const real z[],
+                            const real p[], size_t n, real rj[]) {
+    for (size_t i = 0; i < n; ++i)
+      rj[i] = RJ(x[i], y[i], z[i], p[i]);
+  }
+
+  void EllipticFunction::RC(const real x[], const real y[],
+                            size_t n, real rc[]) {
+    for (size_t i = 0; i < n; ++i)
+      rc[i] = RC(x[i], y[i]);
   }
 
   void EllipticFunction::Reset(real k2, real alpha2,
@@ -225,34 +351,73 @@ namespace GeographicLib {
     _kp2 = kp2;
     _alpha2 = alpha2;
     _alphap2 = alphap2;
+    _Jl = 0;
+    _Sn = 0;
     _eps = _k2/Math::sq(sqrt(_kp2) + 1);
+    // The complete integrals are given by
+    //   cel(kc, p, a, b) = int( (a cos(phi)^2 + b sin(phi)^2) /
+    //         ((cos(phi)^2 + p sin(phi)^2) *
+    //          sqrt(cos(phi)^2 + kc^2 sin(phi)^2)), phi, 0, pi/2)
+    // with kc^2 = kp2; the integrals with the same p are computed together.
+    // These are the same as the expressions in terms of Carlson's symmetric
+    // integrals given in http://dlmf.nist.gov/19.25.E1 and
+    // http://dlmf.nist.gov/19.25.E2 (but about 4 times faster).
     if (_k2) {
-      // Complete elliptic integral K(k), Carlson eq. 4.1
-      // http://dlmf.nist.gov/19.25.E1
-      _Kc = _kp2 ? RF(_kp2, 1) : Math::infinity();
-      // Complete elliptic integral E(k), Carlson eq. 4.2
-      // http://dlmf.nist.gov/19.25.E1
-      _Ec = _kp2 ? 2 * RG(_kp2, 1) : 1;
-      // D(k) = (K(k) - E(k))/k^2, Carlson eq.4.3
-      // http://dlmf.nist.gov/19.25.E1
-      _Dc = _kp2 ? RD(real(0), _kp2, 1) / 3 : Math::infinity();
+      if (_kp2) {
+        // K(k), E(k), and D(k) = (K(k) - E(k))/k^2
+        real a[] = {1, 1, 0}, b[] = {1, _kp2, 1}, c[3];
+        Complete(sqrt(_kp2), 1, a, b, 3, c);
+        _Kc = c[0]; _Ec = c[1]; _Dc = c[2];
+      } else {
+        _Kc = Math::infinity(); _Ec = 1; _Dc = Math::infinity();
+      }
     } else {
       _Kc = _Ec = Math::pi()/2; _Dc = _Kc/2;
     }
     if (_alpha2) {
-      // http://dlmf.nist.gov/19.25.E2
-      real rj = _kp2 ? RJ(0, _kp2, 1, _alphap2) : Math::infinity();
-      // Pi(alpha^2, k)
-      _Pic = _Kc + _alpha2 * rj / 3;
-      // G(alpha^2, k)
-      _Gc = _kp2 ? _Kc + (_alpha2 - _k2) * rj / 3 :  RC(1, _alphap2);
-      // H(alpha^2, k)
-      _Hc = _kp2 ? _Kc - _alphap2 * rj / 3 : RC(1, _alphap2);
+      if (_kp2) {
+        // Pi(alpha^2, k), G(alpha^2, k), and H(alpha^2, k)
+        real a[] = {1, 1, 1}, b[] = {1, _kp2, 0}, c[3];
+        Complete(sqrt(_kp2), _alphap2, a, b, 3, c);
+        _Pic = c[0]; _Gc = c[1]; _Hc = c[2];
+      } else {
+        _Pic = Math::infinity(); _Gc = _Hc = RC(1, _alphap2);
+      }
     } else {
       _Pic = _Kc; _Gc = _Ec; _Hc = _Kc - _Dc;
     }
   }
 
+  void EllipticFunction::Complete(real kc, real p,
+                                  const real a0[], const real b0[], int n,
+                                  real c[]) {
+    // Bulirsch (1969), algorithm cel, for kc > 0 and p > 0 (the case p < 0
+    // isn't needed because alpha^2 < 1).  The recurrences for a and b are
+    // linear in a and b, so several pairs can share the AGM-like sequence of
+    // kc, p, and m.
+    real tolJAC = sqrt(numeric_limits<real>::epsilon() * real(0.01));
+    real a[3], b[3], e = kc, m = 1;
+    p = sqrt(p);
+    for (int i = 0; i < n; ++i) { a[i] = a0[i]; b[i] = b0[i] / p; }
+    for (;;) {
+      // Max 6 trips
+      real g = e / p;
+      for (int i = 0; i < n; ++i) {
+        real f = a[i];
+        a[i] += b[i] / p;
+        b[i] = 2 * (b[i] + f * g);
+      }
+      p += g;
+      g = m;
+      m += kc;
+      if (!(abs(g - kc) > g * tolJAC)) break;
+      kc = 2 * sqrt(e);
+      e = kc * m;
+    }
+    for (int i = 0; i < n; ++i)
+      c[i] = (Math::pi()/2) * (b[i] + a[i] * m) / (m * (m + p));
+  }
+
   /*
    * Implementation of methods given in
    *
@@ -261,59 +426,195 @@ namespace GeographicLib {
    *   Numericshe Mathematik 7, 78-90 (1965)
    */
 
+  unsigned EllipticFunction::JacobiAGM(real m[], real n[],
+                                       real& c, real& d) const {
+    // The first part of Bulirsch's sncndn routine, p 89.  Compute the AGM
+    // sequence m[0..l-1] and n[0..l-1] and return l.  The argument is to be
+    // multiplied by d (if _kp2 < 0) and then by c.  Requires _kp2 != 0.
+    real tolJAC = sqrt(numeric_limits<real>::epsilon() * real(0.01));
+    real mc = _kp2;
+    d = 0;
+    if (_kp2 < 0) {
+      d = 1 - mc;
+      mc /= -d;
+      d = sqrt(d);
+    }
+    c = 0;              // To suppress warning about uninitialized variable
+    unsigned l = 0;
+    for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
+      // This converges quadratically.  Max 5 trips
+      m[l] = a;
+      n[l] = mc = sqrt(mc);
+      c = (a + mc) / 2;
+      if (!(abs(a - mc) > tolJAC * a)) {
+        ++l;
+        break;
+      }
+      mc *= a;
+      a = c;
+    }
+    return l;
+  }
+
+  void EllipticFunction::Jacobi(real x, unsigned l,
+                                const real m[], const real n[],
+                                real c, real d,
+                                real& sn, real& cn, real& dn) const {
+    // The rest of Bulirsch's sncndn routine given the results of JacobiAGM.
+    if (_kp2 < 0)
+      x *= d;
+    x *= c;
+    sn = sin(x);
+    cn = cos(x);
+    dn = 1;
+    if (sn != 0) {
+      real a = cn / sn;
+      c *= a;
+      while (l--) {
+        real b = m[l];
+        a *= c;
+        c *= dn;
+        dn = (n[l] + a) / (b + a);
+        a = c / b;
+      }
+      a = 1 / sqrt(c*c + 1);
+      sn = sn < 0 ? -a : a;
+      cn = c * sn;
+      if (_kp2 < 0) {
+        swap(cn, dn);
+        sn /= d;
+      }
+    }
+  }
+
   void EllipticFunction::sncndn(real x, real& sn, real& cn, real& dn)
     const {
-    // Bulirsch's sncndn routine, p 89.
-    real tolJAC = sqrt(numeric_limits<real>::epsilon() * real(0.01));
     if (_kp2 != 0) {
-      real mc = _kp2, d = 0;
-      if (_kp2 < 0) {
-        d = 1 - mc;
-        mc /= -d;
-        d = sqrt(d);
-        x *= d;
+      if (_Jl)
+        Jacobi(x, _Jl, _Jm, _Jn, _Jc, _Jd, sn, cn, dn);
+      else {
+        real m[num_], n[num_], c, d;
+        unsigned l = JacobiAGM(m, n, c, d);
+        Jacobi(x, l, m, n, c, d, sn, cn, dn);
       }
-      real c = 0;           // To suppress warning about uninitialized variable
-      real m[num_], n[num_];
-      unsigned l = 0;
-      for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
-        // This converges quadratically.  Max 5 trips
-        m[l] = a;
-        n[l] = mc = sqrt(mc);
-        c = (a + mc) / 2;
-        if (!(abs(a - mc) > tolJAC * a)) {
-          ++l;
-          break;
-        }
-        mc *= a;
-        a = c;
+    } else {
+      sn = tanh(x);
+      dn = cn = 1 / cosh(x);
+    }
+  }
+
+  void EllipticFunction::sncndn(const real x[], size_t n,
+                                real sn[], real cn[], real dn[]) const {
+    if (_kp2 != 0) {
+      real mt[num_], nt[num_], ct, dt;
+      unsigned lt = _Jl ? 0 : JacobiAGM(mt, nt, ct, dt);
+      for (size_t i = 0; i < n; ++i) {
+        if (_Jl)
+          Jacobi(x[i], _Jl, _Jm, _Jn, _Jc, _Jd, sn[i], cn[i], dn[i]);
+        else
+          Jacobi(x[i], lt, mt, nt, ct, dt, sn[i], cn[i], dn[i]);
+      }
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        sn[i] = tanh(x[i]);
+        dn[i] = cn[i] = 1 / cosh(x[i]);
       }
-      x *= c;
-      sn = sin(x);
-      cn = cos(x);
-      dn = 1;
-      if (sn != 0) {
-        real a = cn / sn;
-        c *= a;
-        while (l--) {
-          real b = m[l];
-          a *= c;
-          c *= dn;
-          dn = (n[l] + a) / (b + a);
-          a = c / b;
+    }
+  }
+
+  void EllipticFunction::PrecomputeJacobi() {
+    _Jl = _kp2 != 0 ? JacobiAGM(_Jm, _Jn, _Jc, _Jd) : 0;
+  }
+
+  Math::real EllipticFunction::SinSeries(real sn, real cn,
+                                         const real c[], int n) {
+    // Clenshaw summation of sum(c[j-1] * sin(2*j*phi), j, 1, n)
+    real
+      ar = 2 * (cn - sn) * (cn + sn), // 2 * cos(2 * phi)
+      y0 = 0, y1 = 0;
+    while (n > 0) {
+      real y = ar * y0 - y1 + c[--n];
+      y1 = y0; y0 = y;
+    }
+    return 2 * sn * cn * y0;    // sin(2 * phi) * y0
+  }
+
+  bool EllipticFunction::PrecomputeSeries() {
+    _Sn = 0;
+    if (_kp2 == 0)
+      // K is infinite
+      return false;
+    real
+      tol = numeric_limits<real>::epsilon(),
+      tolJAC = sqrt(numeric_limits<real>::epsilon() * real(0.01));
+    vector<real> f(nseries_ * maxsamples_), sinx(2 * maxsamples_);
+    _S.resize(nseries_ * maxsamples_);
+    // Sample the functions at phi[j] = j*pi/(2*n) for j in [1, n).  The
+    // discrete sine transform of the samples gives the coefficients of
+    // sin(2*k*phi) for k in [1, n).  The terms with k >= n are aliased to
+    // those with k < n; so the coefficients are accurate if those with k >=
+    // n/2 are negligible.  Otherwise double n and try again.
+    for (int n = 16; n <= maxsamples_; n *= 2) {
+      int m = n - 1;
+      for (int j = 1; j < n; ++j) {
+        real phi = j * Math::pi() / (2 * n),
+          sn = sin(phi), cn = cos(phi), dn = Delta(sn, cn);
+        f[nF_ * m + j - 1] = deltaF(sn, cn, dn);
+        f[nE_ * m + j - 1] = deltaE(sn, cn, dn);
+        f[nD_ * m + j - 1] = deltaD(sn, cn, dn);
+        f[nH_ * m + j - 1] = deltaH(sn, cn, dn);
+        // Pi(phi) is singular if alpha^2 >= 1
+        f[nPi_ * m + j - 1] = _alphap2 > 0 ? deltaPi(sn, cn, dn) : 0;
+      }
+      for (int l = 0; l < 2 * n; ++l)
+        // sin(l*pi/n)
+        sinx[l] = l % n == 0 ? 0 : sin(l * Math::pi() / n);
+      for (int i = 0; i < nseries_; ++i) {
+        if (i == nEinv_) {
+          // Sample deltaEinv by solving tau = phi + deltaE(phi) for phi
+          // using Newton's method with the series for deltaE.
+          _Sn = m;
+          for (int j = 1; j < n; ++j) {
+            real tau = j * Math::pi() / (2 * n),
+              phi = tau - Periodic(nE_, sin(tau), cos(tau));
+            for (int k = 0; k < num_ || GEOGRAPHICLIB_PANIC; ++k) {
+              real
+                sn = sin(phi),
+                cn = cos(phi),
+                err = (phi + Periodic(nE_, sn, cn) - tau) *
+                (_Ec / (Math::pi()/2)) / Delta(sn, cn);
+              phi = phi - err;
+              if (abs(err) < tolJAC)
+                break;
+            }
+            f[nEinv_ * m + j - 1] = phi - tau;
+          }
+          _Sn = 0;
         }
-        a = 1 / sqrt(c*c + 1);
-        sn = sn < 0 ? -a : a;
-        cn = c * sn;
-        if (_kp2 < 0) {
-          swap(cn, dn);
-          sn /= d;
+        for (int k = 1; k < n; ++k) {
+          real t = 0;
+          for (int j = 1; j < n; ++j)
+            t += f[i * m + j - 1] * sinx[(k * j) % (2 * n)];
+          _S[i * m + k - 1] = 2 * t / n;
         }
       }
-    } else {
-      sn = tanh(x);
-      dn = cn = 1 / cosh(x);
+      // The number of terms needed for all the series
+      int nt = 0;
+      for (int i = 0; i < nseries_; ++i)
+        for (int k = 1; k < n; ++k)
+          if (abs(_S[i * m + k - 1]) >= tol)
+            nt = max(nt, k);
+      if (nt < n/2) {
+        // Pack the coefficients with stride nt
+        for (int i = 0; i < nseries_; ++i)
+          for (int k = 0; k < nt; ++k)
+            _S[i * nt + k] = _S[i * m + k];
+        _S.resize(nseries_ * nt);
+        _Sn = nt;
+        return true;
+      }
     }
+    return false;
   }
 
   Math::real EllipticFunction::F(real sn, real cn, real dn) const {
@@ -407,12 +708,14 @@ namespace GeographicLib {
   }
 
   Math::real EllipticFunction::deltaF(real sn, real cn, real dn) const {
+    if (_Sn) return Periodic(nF_, sn, cn);
     // Function is periodic with period pi
     if (cn < 0) { cn = -cn; sn = -sn; }
     return F(sn, cn, dn) * (Math::pi()/2) / K() - atan2(sn, cn);
   }
 
   Math::real EllipticFunction::deltaE(real sn, real cn, real dn) const {
+    if (_Sn) return Periodic(nE_, sn, cn);
     // Function is periodic with period pi
     if (cn < 0) { cn = -cn; sn = -sn; }
     return E(sn, cn, dn) * (Math::pi()/2) / E() - atan2(sn, cn);
@@ -420,12 +723,14 @@ namespace GeographicLib {
 
   Math::real EllipticFunction::deltaPi(real sn, real cn, real dn)
     const {
+    if (_Sn && _alphap2 > 0) return Periodic(nPi_, sn, cn);
     // Function is periodic with period pi
     if (cn < 0) { cn = -cn; sn = -sn; }
     return Pi(sn, cn, dn) * (Math::pi()/2) / Pi() - atan2(sn, cn);
   }
 
   Math::real EllipticFunction::deltaD(real sn, real cn, real dn) const {
+    if (_Sn) return Periodic(nD_, sn, cn);
     // Function is periodic with period pi
     if (cn < 0) { cn = -cn; sn = -sn; }
     return D(sn, cn, dn) * (Math::pi()/2) / D() - atan2(sn, cn);
@@ -438,6 +743,7 @@ namespace GeographicLib {
   }
 
   Math::real EllipticFunction::deltaH(real sn, real cn, real dn) const {
+    if (_Sn) return Periodic(nH_, sn, cn);
     // Function is periodic with period pi
     if (cn < 0) { cn = -cn; sn = -sn; }
     return H(sn, cn, dn) * (Math::pi()/2) / H() - atan2(sn, cn);
@@ -460,7 +766,58 @@ namespace GeographicLib {
       phi = ang * Math::degree(),
       sn = abs(ang) == 180 ? 0 : sin(phi),
       cn = abs(ang) ==  90 ? 0 : cos(phi);
-    return E(sn, cn, Delta(sn, cn)) + 4 * E() * n;
+    return (_Sn ? (phi + Periodic(nE_, sn, cn)) * E() / (Math::pi()/2) :
+            E(sn, cn, Delta(sn, cn))) + 4 * E() * n;
+  }
+
+  void EllipticFunction::Ed(const real ang[], size_t n, real e[]) const {
+    // The same as the scalar Ed and E(sn, cn, dn) for blocks of nblock_
+    // angles; the Carlson integrals are evaluated for a block together.
+    if (_Sn) {
+      for (size_t i = 0; i < n; ++i)
+        e[i] = Ed(ang[i]);
+      return;
+    }
+    real sn[nblock_], cn[nblock_], dn[nblock_], nn[nblock_],
+      cn2[nblock_], dn2[nblock_], one[nblock_], rf[nblock_], rd[nblock_];
+    for (int l = 0; l < nblock_; ++l) one[l] = 1;
+    for (size_t i = 0; i < n; i += nblock_) {
+      int m = int(min(size_t(nblock_), n - i));
+      for (int l = 0; l < m; ++l) {
+        real a = ang[i + l];
+        nn[l] = ceil(a/360 - real(0.5));
+        a -= 360 * nn[l];
+        real phi = a * Math::degree();
+        sn[l] = abs(a) == 180 ? 0 : sin(phi);
+        cn[l] = abs(a) ==  90 ? 0 : cos(phi);
+        dn[l] = Delta(sn[l], cn[l]);
+        cn2[l] = cn[l]*cn[l]; dn2[l] = dn[l]*dn[l];
+      }
+      if (_k2 <= 0) {
+        RF(cn2, dn2, one, m, rf);
+        RD(cn2, dn2, one, m, rd);
+      } else if (_kp2 >= 0) {
+        RF(cn2, dn2, one, m, rf);
+        RD(cn2, one, dn2, m, rd);
+      } else
+        RD(dn2, one, cn2, m, rd);
+      for (int l = 0; l < m; ++l) {
+        real sn2 = sn[l]*sn[l],
+          ei = ( _k2 <= 0 ?
+                 rf[l] - _k2 * sn2 * rd[l] / 3 :
+                 ( _kp2 >= 0 ?
+                   _kp2 * rf[l] +
+                   _k2 * _kp2 * sn2 * rd[l] / 3 +
+                   _k2 * abs(cn[l]) / dn[l] :
+                   - _kp2 * sn2 * rd[l] / 3 + dn[l] / abs(cn[l]) ) );
+        ei *= abs(sn[l]);
+        if (cn[l] < 0)
+          ei = 2 * E() - ei;
+        if (sn[l] < 0)
+          ei = -ei;
+        e[i + l] = ei + 4 * E() * nn[l];
+      }
+    }
   }
 
   Math::real EllipticFunction::Pi(real phi) const {
@@ -489,6 +846,8 @@ namespace GeographicLib {
     x -= 2 * _Ec * n;           // x now in [-ec, ec)
     // Linear approximation
     real phi = Math::pi() * x / (2 * _Ec); // phi in [-pi/2, pi/2)
+    if (_Sn)
+      return n * Math::pi() + phi + Periodic(nEinv_, sin(phi), cos(phi));
     // First order correction
     phi -= _eps * sin(2 * phi) / 2;
     for (int i = 0; i < num_ || GEOGRAPHICLIB_PANIC; ++i) {
@@ -505,6 +864,7 @@ namespace GeographicLib {
   }
 
   Math::real EllipticFunction::deltaEinv(real stau, real ctau) const {
+    if (_Sn) return Periodic(nEinv_, stau, ctau);
     // Function is periodic with period pi
     if (ctau < 0) { ctau = -ctau; stau = -stau; }
     real tau = atan2(stau, ctau);
@@ -0,0 +1,215 @@
+/**
+ * \file Executor.cpp
+ * \brief Implementation for GeographicLib::Executor class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/Executor.hpp>
+
+#if !defined(GEOGRAPHICLIB_EXECUTOR_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_EXECUTOR_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_EXECUTOR_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_EXECUTOR_THREADS
+#  include <atomic>
+#  include <condition_variable>
+#  include <deque>
+#  include <exception>
+#  include <mutex>
+#  include <system_error>
+#  include <thread>
+#  include <vector>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+#if GEOGRAPHICLIB_EXECUTOR_THREADS
+    atomic<Executor*> current_(0);
+    // The built-in pool.  Visual Studio 2012 and 2013 don't initialize
+    // function-scope statics thread-safely, so this is created with
+    // call_once.  It is never destroyed: joining the workers in a static
+    // destructor can deadlock at process exit or when a DLL is unloaded on
+    // Windows; instead the idle workers are ended with the process.
+    once_flag builtinonce_;
+    Executor* builtin_ = 0;
+    void MakeBuiltin() { builtin_ = new ThreadPoolExecutor(); }
+#else
+    Executor* current_ = 0;
+#endif
+  }
+
+  Executor& Executor::Default() {
+    Executor* e = current_;
+    if (e) return *e;
+#if GEOGRAPHICLIB_EXECUTOR_THREADS
+    call_once(builtinonce_, MakeBuiltin);
+    return *builtin_;
+#else
+    static SerialExecutor builtin;
+    return builtin;
+#endif
+  }
+
+  void Executor::SetDefault(Executor* executor) { current_ = executor; }
+
+#if GEOGRAPHICLIB_EXECUTOR_THREADS
+  class ThreadPoolExecutor::Impl {
+  public:
+    // A parallel loop in progress
+    struct Job {
+      const Range* body;
+      size_t n, per, nchunks,
+        next,                   // the next chunk to be claimed
+        pending;                // the number of chunks not yet finished
+      exception_ptr err;
+    };
+    // A single mutex guards the queue and all the jobs; it's only held while
+    // claiming or finishing a chunk.
+    mutex _mutex;
+    condition_variable _work, _done;
+    deque<Job*> _queue;         // the jobs with unclaimed chunks
+    bool _stop;
+    vector<thread> _workers;
+    explicit Impl(int nworkers) : _stop(false) {
+      if (nworkers < 0)
+        nworkers = max(int(thread::hardware_concurrency()) - 1, 0);
+      for (int i = 0; i < nworkers; ++i) {
+        try {
+          _workers.push_back(thread(&Impl::Work, this));
+        }
+        catch (const system_error&) {
+          break;
+        }
+      }
+    }
+    ~Impl() {
+      {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+      }
+      _work.notify_all();
+      for (size_t i = 0; i < _workers.size(); ++i)
+        _workers[i].join();
+    }
+    // Claim the next chunk of the job at the front of the queue; the caller
+    // must hold the lock and the queue must not be empty.
+    static Job* Claim(deque<Job*>& queue, size_t& k) {
+      Job* job = queue.front();
+      k = job->next++;
+      if (job->next == job->nchunks) queue.pop_front();
+      return job;
+    }
+    // Run chunk k of job (without holding the lock) and record its
+    // completion.
+    void Run(Job* job, size_t k) {
+      exception_ptr err;
+      try {
+        size_t i0 = k * job->per;
+        (*job->body)(i0, min(job->n, i0 + job->per));
+      }
+      catch (...) {
+        err = current_exception();
+      }
+      lock_guard<mutex> lock(_mutex);
+      if (err && !job->err) job->err = err;
+      if (--job->pending == 0) _done.notify_all();
+    }
+    void Work() {
+      for (;;) {
+        Job* job;
+        size_t k;
+        {
+          unique_lock<mutex> lock(_mutex);
+          while (!_stop && _queue.empty())
+            _work.wait(lock);
+          if (_queue.empty()) return;
+          job = Claim(_queue, k);
+        }
+        Run(job, k);
+      }
+    }
+    void ParallelFor(size_t n, size_t nchunks, const Range& body) {
+      Job job;
+      job.body = &body;
+      job.n = n;
+      job.per = ChunkSize(n, nchunks);
+      job.nchunks = job.pending = Chunks(n, nchunks);
+      job.next = 0;
+      if (job.nchunks == 0) return;
+      {
+        lock_guard<mutex> lock(_mutex);
+        _queue.push_back(&job);
+      }
+      _work.notify_all();
+      // Run the chunks of this job in this thread until none are left to be
+      // claimed.  (Only this job's chunks are taken, so that the caller
+      // isn't delayed by unrelated work.)
+      for (;;) {
+        size_t k;
+        {
+          lock_guard<mutex> lock(_mutex);
+          if (job.next == job.nchunks) break;
+          // The job needn't be at the front of the queue; take the chunk
+          // directly.
+          k = job.next++;
+          if (job.next == job.nchunks) {
+            for (deque<Job*>::iterator i = _queue.begin();
+                 i != _queue.end(); ++i)
+              if (*i == &job) { _queue.erase(i); break; }
+          }
+        }
+        Run(&job, k);
+      }
+      // Wait for the chunks being run by the workers.
+      {
+        unique_lock<mutex> lock(_mutex);
+        while (job.pending)
+          _done.wait(lock);
+      }
+      if (job.err) rethrow_exception(job.err);
+    }
+  };
+
+  ThreadPoolExecutor::ThreadPoolExecutor(int nworkers)
+    : _impl(new Impl(nworkers))
+  {}
+
+  ThreadPoolExecutor::~ThreadPoolExecutor() { delete _impl; }
+
+  void ThreadPoolExecutor::ParallelFor(size_t n, size_t nchunks,
+                                       const Range& body) {
+    if (_impl->_workers.empty())
+      SerialExecutor().ParallelFor(n, nchunks, body);
+    else
+      _impl->ParallelFor(n, nchunks, body);
+  }
+
+  int ThreadPoolExecutor::Concurrency() const
+  { return int(_impl->_workers.size()) + 1; }
+#else
+  class ThreadPoolExecutor::Impl {};
+
+  ThreadPoolExecutor::ThreadPoolExecutor(int)
+    : _impl(0)
+  {}
+
+  ThreadPoolExecutor::~ThreadPoolExecutor() {}
+
+  void ThreadPoolExecutor::ParallelFor(size_t n, size_t nchunks,
+                                       const Range& body)
+  { SerialExecutor().ParallelFor(n, nchunks, body); }
+
+  int ThreadPoolExecutor::Concurrency() const { return 1; }
+#endif
+
+} // namespace GeographicLib
@@ -7,6 +7,7 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <cstring>
 #include <GeographicLib/GeoCoords.hpp>
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -16,27 +17,129 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    // Accumulate a null-terminated string in a character array of size cap
+    // supplied by the caller; no memory is allocated (except by Fixed when
+    // Utility::str needs an ostringstream).
+    class Writer {
+    private:
+      typedef Math::real real;
+      char* _buf;
+      size_t _cap, _len;
+    public:
+      Writer(char* buf, size_t cap) : _buf(buf), _cap(cap), _len(0) {}
+      void Put(const char* s, size_t n) {
+        if (!(_len + n < _cap))
+          throw GeographicErr("Buffer of size " + Utility::str(_cap)
+                              + " too small for coordinate string");
+        copy(s, s + n, _buf + _len);
+        _len += n;
+        _buf[_len] = '\0';
+      }
+      void Put(const char* s) { Put(s, strlen(s)); }
+      void Fill(char c, size_t n) {
+        if (!(_len + n < _cap))
+          throw GeographicErr("Buffer of size " + Utility::str(_cap)
+                              + " too small for coordinate string");
+        fill(_buf + _len, _buf + _len + n, c);
+        _len += n;
+        _buf[_len] = '\0';
+      }
+      // The same as Utility::str(x, p) for p >= 0, i.e., writing x in the
+      // classic locale with fixed and setprecision(p).
+      void Fixed(real x, int p) {
+        char t[64];
+        int n = Utility::str(t, sizeof(t), x, p);
+        if (n < int(sizeof(t)))
+          Put(t, size_t(n));
+        else {
+          string u = Utility::str(x, p);
+          Put(u.data(), u.size());
+        }
+      }
+      size_t Length() const { return _len; }
+    };
+  }
+
   void GeoCoords::Reset(const std::string& s, bool centerp, bool swaplatlong) {
-    vector<string> sa;
+    Reset(s, AUTOMATIC, centerp, swaplatlong, true);
+  }
+
+  bool GeoCoords::TryReset(const std::string& s,
+                           bool centerp, bool swaplatlong) {
+    return TryReset(s, AUTOMATIC, centerp, swaplatlong);
+  }
+
+  bool GeoCoords::TryReset(const std::string& s, inputform form,
+                           bool centerp, bool swaplatlong) {
+    if (Reset(s, form, centerp, swaplatlong, false))
+      return true;
+    *this = GeoCoords();
+    return false;
+  }
+
+  bool GeoCoords::Reset(const std::string& s, int form,
+                        bool centerp, bool swaplatlong, bool throwp) {
+    // At most 3 elements are used; keeping them in a fixed array (of short
+    // strings) avoids allocating memory for typical input.
+    string sa[3];
+    string::size_type pos[3], len[3];
+    unsigned nsa = 0;
     const char* spaces = " \t\n\v\f\r,"; // Include comma as a space
-    for (string::size_type pos0 = 0, pos1; pos0 != string::npos;) {
+    if (form == MGRSFORM) {
+      // Skip splitting s into elements; MGRS::Reverse rejects any embedded
+      // spaces.
+      string::size_type pos1 = s.find_first_not_of(spaces);
+      pos[0] = pos1 == string::npos ? 0 : pos1;
+      len[0] = pos1 == string::npos ? 0 :
+        s.find_last_not_of(spaces) + 1 - pos1;
+      nsa = 1;
+    }
+    for (string::size_type pos0 = nsa ? string::npos : 0, pos1;
+         pos0 != string::npos;) {
       pos1 = s.find_first_not_of(spaces, pos0);
       if (pos1 == string::npos)
         break;
       pos0 = s.find_first_of(spaces, pos1);
-      sa.push_back(s.substr(pos1, pos0 == string::npos ? pos0 : pos0 - pos1));
+      if (nsa < 3) {
+        pos[nsa] = pos1;
+        len[nsa] = pos0 == string::npos ? s.size() - pos1 : pos0 - pos1;
+      }
+      ++nsa;
     }
-    if (sa.size() == 1) {
+    if (form != AUTOMATIC && nsa != unsigned(form)) {
+      if (!throwp) return false;
+      throw GeographicErr("Coordinate requires " + Utility::str(form)
+                          + (form == 1 ? " element" : " elements"));
+    }
+    if (nsa == 1) {
       int prec;
-      MGRS::Reverse(sa[0], _zone, _northp, _easting, _northing, prec, centerp);
-      UTMUPS::Reverse(_zone, _northp, _easting, _northing,
-                      _lat, _long, _gamma, _k);
-    } else if (sa.size() == 2) {
-      DMS::DecodeLatLon(sa[0], sa[1], _lat, _long, swaplatlong);
+      if (!MGRS::Reverse(s.data() + pos[0], len[0],
+                         _zone, _northp, _easting, _northing, prec,
+                         centerp, throwp))
+        return false;
+      if (UTMUPS::Reverse(_zone, _northp, _easting, _northing,
+                          _lat, _long, _gamma, _k, false, throwp) != UTMUPS::OK)
+        return false;
+    } else if (nsa == 2) {
+      for (unsigned i = 0; i < nsa; ++i)
+        sa[i].assign(s, pos[i], len[i]);
+      // DMS has no non-throwing interface, so catch its exceptions here.
+      try {
+        DMS::DecodeLatLon(sa[0], sa[1], _lat, _long, swaplatlong);
+      }
+      catch (const GeographicErr&) {
+        if (!throwp) return false;
+        throw;
+      }
       _long = Math::AngNormalize(_long);
-      UTMUPS::Forward( _lat, _long,
-                       _zone, _northp, _easting, _northing, _gamma, _k);
-    } else if (sa.size() == 3) {
+      if (UTMUPS::Forward( _lat, _long,
+                           _zone, _northp, _easting, _northing, _gamma, _k,
+                           UTMUPS::STANDARD, false, throwp) != UTMUPS::OK)
+        return false;
+    } else if (nsa == 3) {
+      for (unsigned i = 0; i < nsa; ++i)
+        sa[i].assign(s, pos[i], len[i]);
       unsigned zoneind, coordind;
       if (sa[0].size() > 0 && isalpha(sa[0][sa[0].size() - 1])) {
         zoneind = 0;
@@ -44,19 +147,33 @@ namespace GeographicLib {
       } else if (sa[2].size() > 0 && isalpha(sa[2][sa[2].size() - 1])) {
         zoneind = 2;
         coordind = 0;
-      } else
+      } else {
+        if (!throwp) return false;
         throw GeographicErr("Neither " + sa[0] + " nor " + sa[2]
                             + " of the form UTM/UPS Zone + Hemisphere"
                             + " (ex: 38n, 09s, n)");
-      UTMUPS::DecodeZone(sa[zoneind], _zone, _northp);
-      for (unsigned i = 0; i < 2; ++i)
-        (i ? _northing : _easting) = DMS::Decode(sa[coordind + i]);
-      UTMUPS::Reverse(_zone, _northp, _easting, _northing,
-                      _lat, _long, _gamma, _k);
+      }
+      if (UTMUPS::DecodeZone(sa[zoneind], _zone, _northp, throwp)
+          != UTMUPS::OK)
+        return false;
+      try {
+        for (unsigned i = 0; i < 2; ++i)
+          (i ? _northing : _easting) = DMS::Decode(sa[coordind + i]);
+      }
+      catch (const GeographicErr&) {
+        if (!throwp) return false;
+        throw;
+      }
+      if (UTMUPS::Reverse(_zone, _northp, _easting, _northing,
+                          _lat, _long, _gamma, _k, false, throwp) != UTMUPS::OK)
+        return false;
       FixHemisphere();
-    } else
+    } else {
+      if (!throwp) return false;
       throw GeographicErr("Coordinate requires 1, 2, or 3 elements");
+    }
     CopyToAlt();
+    return true;
   }
 
   string GeoCoords::GeoRepresentation(int prec, bool swaplatlong) const {
@@ -160,6 +277,102 @@ namespace GeographicLib {
     return utm;
   }
 
+  size_t GeoCoords::GeoRepresentation(int prec, bool swaplatlong,
+                                      char* str, size_t cap) const {
+    prec = max(0, min(9 + Math::extra_digits(), prec) + 5);
+    Writer w(str, cap);
+    real a = swaplatlong ? _long : _lat;
+    real b = swaplatlong ? _lat : _long;
+    if (!Math::isnan(a))
+      w.Fixed(a, prec);
+    else
+      w.Put("nan");
+    w.Put(" ");
+    if (!Math::isnan(b))
+      w.Fixed(b, prec);
+    else
+      w.Put("nan");
+    return w.Length();
+  }
+
+  size_t GeoCoords::MGRSRepresentation(int prec, char* str, size_t cap) const {
+    // Max precision is um
+    prec = max(-1, min(6, prec) + 5);
+    return MGRS::Forward(_zone, _northp, _easting, _northing, _lat, prec,
+                         str, cap);
+  }
+
+  size_t GeoCoords::AltMGRSRepresentation(int prec, char* str, size_t cap)
+    const {
+    // Max precision is um
+    prec = max(-1, min(6, prec) + 5);
+    return MGRS::Forward(_alt_zone, _northp, _alt_easting, _alt_northing,
+                         _lat, prec, str, cap);
+  }
+
+  size_t GeoCoords::UTMUPSString(int zone, bool northp,
+                                 real easting, real northing, int prec,
+                                 bool abbrev, char* utm, size_t cap) {
+    Writer w(utm, cap);
+    prec = max(-5, min(9 + Math::extra_digits(), prec));
+    real scale = prec < 0 ? pow(real(10), -prec) : real(1);
+    // This matches UTMUPS::EncodeZone
+    if (zone == UTMUPS::INVALID)
+      w.Put(abbrev ? "inv" : "invalid");
+    else {
+      if (!(zone >= UTMUPS::MINZONE && zone <= UTMUPS::MAXZONE))
+        throw GeographicErr("Zone " + Utility::str(zone)
+                            + " not in range [0, 60]");
+      if (zone != UTMUPS::UPS) {
+        char t[] = { char('0' + zone / 10), char('0' + zone % 10) };
+        w.Put(t, 2);
+      }
+      w.Put(abbrev ? (northp ? "n" : "s") : (northp ? "north" : "south"));
+    }
+    for (int i = 0; i < 2; ++i) {
+      real z = i ? northing : easting;
+      if (Math::isfinite(z)) {
+        w.Put(" ");
+        w.Fixed(z / scale, max(0, prec));
+        if (prec < 0 && abs(z / scale) > real(0.5))
+          w.Fill('0', size_t(-prec));
+      } else
+        w.Put(" nan");
+    }
+    return w.Length();
+  }
+
+  size_t GeoCoords::UTMUPSRepresentation(int prec, bool abbrev,
+                                         char* str, size_t cap) const {
+    return UTMUPSString(_zone, _northp, _easting, _northing, prec, abbrev,
+                        str, cap);
+  }
+
+  size_t GeoCoords::UTMUPSRepresentation(bool northp, int prec, bool abbrev,
+                                         char* str, size_t cap) const {
+    real e, n;
+    int z;
+    UTMUPS::Transfer(_zone, _northp, _easting, _northing,
+                     _zone,  northp,  e,        n,       z);
+    return UTMUPSString(_zone, northp, e, n, prec, abbrev, str, cap);
+  }
+
+  size_t GeoCoords::AltUTMUPSRepresentation(int prec, bool abbrev,
+                                            char* str, size_t cap) const {
+    return UTMUPSString(_alt_zone, _northp, _alt_easting, _alt_northing, prec,
+                        abbrev, str, cap);
+  }
+
+  size_t GeoCoords::AltUTMUPSRepresentation(bool northp, int prec,
+                                            bool abbrev,
+                                            char* str, size_t cap) const {
+    real e, n;
+    int z;
+    UTMUPS::Transfer(_alt_zone, _northp, _alt_easting, _alt_northing,
+                     _alt_zone,  northp,      e,            n,       z);
+    return UTMUPSString(_alt_zone, northp, e, n, prec, abbrev, str, cap);
+  }
+
   void GeoCoords::FixHemisphere() {
     if (_lat == 0 || (_northp && _lat >= 0) || (!_northp && _lat < 0) ||
         Math::isnan(_lat))
@@ -0,0 +1,83 @@
+/**
+ * \file GeocentricTracker.cpp
+ * \brief Implementation for GeographicLib::GeocentricTracker class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeocentricTracker.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void GeocentricTracker::IntReverse(real X, real Y, real Z,
+                                     real& lat, real& lon, real& h,
+                                     real M[dim2_]) {
+    // The step limit, 0.01 rad, corresponds to about 60 km.
+    static const real
+      tol_ = sqrt(numeric_limits<real>::epsilon()),
+      maxstep_ = real(0.01);
+    const Geocentric& g = _earth;
+    real
+      R = Math::hypot(X, Y),
+      slam = R ? Y / R : 0,
+      clam = R ? X / R : 1,
+      D = Math::hypot(R, Z);
+    if (_valid && g._e4a != 0 && D >= g._a / 2 && D <= g._maxrad) {
+      // The geodetic latitude phi satisfies f(phi) = 0 where
+      //   f = R * sin(phi) - Z * cos(phi) - e^2 * N * sin(phi) * cos(phi)
+      // with N = a/W the radius of curvature in the prime vertical, W =
+      // sqrt(1 - e^2 * sin(phi)^2), and
+      //   f' = R * cos(phi) + Z * sin(phi)
+      //        - e^2 * a * (cos(phi)^2 - sin(phi)^2 + e^2 * sin(phi)^4) / W^3.
+      // Newton's method converges quadratically with a coefficient of
+      // order e^2, so a step of less than sqrt(epsilon) is the last one
+      // needed.  The steps are applied as rotations of (sphi, cphi).  The
+      // approximation tan(d) = d in the rotation is immaterial, since the
+      // final step is small.
+      real sphi = _sphi, cphi = _cphi;
+      for (int i = 0; i < maxit_; ++i) {
+        real
+          s2 = Math::sq(sphi),
+          W2 = 1 - g._e2 * s2,
+          W = sqrt(W2),
+          f = R * sphi - Z * cphi - g._e2 * g._a * sphi * cphi / W,
+          fp = R * cphi + Z * sphi -
+          g._e2 * g._a * (Math::sq(cphi) - s2 + g._e2 * Math::sq(s2)) /
+          (W2 * W),
+          d = -f / fp;
+        // Give up on a large step (or a NaN)
+        if (!(abs(d) <= maxstep_)) break;
+        real s = sphi + cphi * d;
+        cphi -= sphi * d; sphi = s;
+        Math::norm(sphi, cphi);
+        if (!(cphi >= 0)) break;
+        if (abs(d) <= tol_) {
+          h = R * cphi + Z * sphi - g._a * sqrt(1 - g._e2 * Math::sq(sphi));
+          // The other root of f, with the foot of the normal on the far side
+          // of the ellipsoid, has h < -a.  (This can arise after jumping
+          // between the poles.)  For the true root, h >= hypot(R, Z) - a.
+          if (!(h >= -g._a / 2)) break;
+          lat = atan2(sphi, cphi) / Math::degree();
+          lon = Math::atan2d(slam, clam);
+          if (M)
+            Geocentric::Rotation(sphi, cphi, slam, clam, M);
+          _sphi = sphi; _cphi = cphi;
+          return;
+        }
+      }
+    }
+    // Use the full method; the rotation matrix supplies sin(phi) and
+    // cos(phi) for the next call.
+    real t[dim2_];
+    g.IntReverse(X, Y, Z, lat, lon, h, t);
+    if (M)
+      copy(t, t + dim2_, M);
+    _sphi = t[8]; _cphi = t[7];
+    _valid = Math::isfinite(_sphi) && Math::isfinite(_cphi);
+  }
+
+} // namespace GeographicLib
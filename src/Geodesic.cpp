@@ -28,6 +28,8 @@
 
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Instrumentation.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about potentially uninitialized local variables and
@@ -35,11 +37,45 @@
 #  pragma warning (disable: 4701 4127)
 #endif
 
+#if !defined(GEOGRAPHICLIB_GEODESIC_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEODESIC_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GEODESIC_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+#if GEOGRAPHICLIB_GEODESIC_STATS
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#    define GEOGRAPHICLIB_THREAD_LOCAL thread_local
+#  elif defined(_MSC_VER)
+#    define GEOGRAPHICLIB_THREAD_LOCAL __declspec(thread)
+#  else
+#    define GEOGRAPHICLIB_THREAD_LOCAL __thread
+#  endif
+// Record a statistic for the inverse problem
+#  define GEOGRAPHICLIB_GEODESIC_STAT(x) x
+#else
+#  define GEOGRAPHICLIB_GEODESIC_STAT(x)
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
-  Geodesic::Geodesic(real a, real f)
+#if GEOGRAPHICLIB_GEODESIC_STATS
+  namespace {
+    // The statistics for the inverse problem for this thread.  This has
+    // static storage duration and so is initialized to zero.
+    GEOGRAPHICLIB_THREAD_LOCAL Geodesic::InverseStats stats_;
+  }
+#endif
+
+  Geodesic::Geodesic(real a, real f, int order)
     : maxit2_(maxit1_ + Math::digits() + 10)
       // Underflow guard.  We require
       //   tiny_ * epsilon() > 0
@@ -62,7 +98,8 @@ namespace GeographicLib {
     , _n(_f / ( 2 - _f))
     , _b(_a * _f1)
     , _c2((Math::sq(_a) + Math::sq(_b) *
-           Math::eatanhe(real(1), (_f < 0 ? -1 : 1) * sqrt(abs(_e2))) / _e2)
+           (_e2 == 0 ? 1 :
+            Math::eatanhe(real(1), (_f < 0 ? -1 : 1) * sqrt(abs(_e2))) / _e2))
           / 2) // authalic radius squared
       // The sig12 threshold for "really short".  Using the auxiliary sphere
       // solution with dnm computed at (bet1 + bet2) / 2, the relative error in
@@ -76,11 +113,22 @@ namespace GeographicLib {
       // spherical case.
     , _etol2(0.1 * tol2_ /
              sqrt( max(real(0.001), abs(_f)) * min(real(1), 1 - _f/2) / 2 ))
+    , _nC(order)
+      // A looser convergence criterion for Newton's method in the inverse
+      // problem when a reduced order is used.  This is matched to the
+      // truncation error of the series, roughly 0.001 * n^order, and often
+      // saves the last iteration.  With the full order, _tolv = 0 so that the
+      // results are unchanged.
+    , _tolv(_nC < GEOGRAPHICLIB_GEODESIC_ORDER ?
+            real(0.001) * pow(abs(_n), real(_nC)) : 0)
   {
     if (!(Math::isfinite(_a) && _a > 0))
       throw GeographicErr("Major radius is not positive");
     if (!(Math::isfinite(_b) && _b > 0))
       throw GeographicErr("Minor radius is not positive");
+    if (!(_nC >= 3 && _nC <= GEOGRAPHICLIB_GEODESIC_ORDER))
+      throw GeographicErr("Order of expansions not in [3, "
+                          + Utility::str(GEOGRAPHICLIB_GEODESIC_ORDER) + "]");
     A3coeff();
     C3coeff();
     C4coeff();
@@ -91,28 +139,20 @@ namespace GeographicLib {
     return wgs84;
   }
 
-  Math::real Geodesic::SinCosSeries(bool sinp,
-                                    real sinx, real cosx,
-                                    const real c[], int n) {
-    // Evaluate
-    // y = sinp ? sum(c[i] * sin( 2*i    * x), i, 1, n) :
-    //            sum(c[i] * cos((2*i+1) * x), i, 0, n-1)
-    // using Clenshaw summation.  N.B. c[0] is unused for sin series
-    // Approx operation count = (n + 5) mult and (2 * n + 2) add
-    c += (n + sinp);            // Point to one beyond last element
-    real
-      ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
-      y0 = n & 1 ? *--c : 0, y1 = 0;          // accumulators for sum
-    // Now n is even
-    n /= 2;
-    while (n--) {
-      // Unroll loop x 2, so accumulators return to their original role
-      y1 = ar * y0 - y1 + *--c;
-      y0 = ar * y1 - y0 + *--c;
-    }
-    return sinp
-      ? 2 * sinx * cosx * y0    // sin(2 * x) * y0
-      : cosx * (y0 - y1);       // cos(x) * (y0 - y1)
+  bool Geodesic::GetInverseStats(InverseStats& stats) {
+#if GEOGRAPHICLIB_GEODESIC_STATS
+    stats = stats_;
+    return true;
+#else
+    stats = InverseStats();
+    return false;
+#endif
+  }
+
+  void Geodesic::ResetInverseStats() {
+#if GEOGRAPHICLIB_GEODESIC_STATS
+    stats_ = InverseStats();
+#endif
   }
 
   GeodesicLine Geodesic::Line(real lat1, real lon1, real azi1, unsigned caps)
@@ -120,6 +160,160 @@ namespace GeographicLib {
     return GeodesicLine(*this, lat1, lon1, azi1, caps);
   }
 
+  void Geodesic::LineBatch(const real* lat1, const real* lon1,
+                           const real* azi1, size_t n, GeodesicLine* lines,
+                           unsigned caps, int nthreads) const {
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+    // Divide the lines into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    LineRange(lat1, lon1, azi1, i0, i1, caps, lines);
+                  });
+#else
+    (void)nthreads;
+    LineRange(lat1, lon1, azi1, 0, n, caps, lines);
+#endif
+  }
+
+  namespace {
+    // Set y[j] = Math::polyval(N, p, x[j]) for 0 <= j < k.  The loops over j
+    // are innermost so that they can be vectorized.
+    void polyvals(int N, const Math::real p[], const Math::real x[],
+                  size_t k, Math::real y[]) {
+      for (size_t j = 0; j < k; ++j)
+        y[j] = N < 0 ? 0 : p[0];
+      for (int i = 1; i <= N; ++i)
+        for (size_t j = 0; j < k; ++j)
+          y[j] = y[j] * x[j] + p[i];
+    }
+
+    // The loop in Geodesic::C1f, C1pf, and C2f for k values of eps; the
+    // coefficient l of value j is stored in c[l * ldc + j].
+    void sinseriesvals(const Math::real coeff[], int nC, int order,
+                       const Math::real eps[], const Math::real eps2[],
+                       size_t k, Math::real d[], Math::real y[],
+                       Math::real c[], size_t ldc) {
+      for (size_t j = 0; j < k; ++j)
+        d[j] = eps[j];
+      int o = 0;
+      for (int l = 1; l <= order; ++l) {
+        int m = (nC - l) / 2, mt = (order - l) / 2;
+        polyvals(mt, coeff + o + (m - mt), eps2, k, y);
+        for (size_t j = 0; j < k; ++j) {
+          c[l * ldc + j] = d[j] * y[j] / coeff[o + m + 1];
+          d[j] *= eps[j];
+        }
+        o += m + 2;
+      }
+    }
+  }
+
+  void Geodesic::LineRange(const real* lat1, const real* lon1,
+                           const real* azi1, size_t i0, size_t i1,
+                           unsigned caps, GeodesicLine* lines) const {
+    // The lines are constructed in blocks of nb.  The lines in a block are
+    // first constructed without the series, then the coefficients of the
+    // series are evaluated for the whole block, and finally they are copied
+    // into the lines and the series are evaluated at point 1.  The
+    // arithmetic is the same as in the GeodesicLine constructor.
+    static const size_t nb = 32;
+    static const int nCmax = nC4_ + 1;
+    real eps[nb], eps2[nb], d[nb], y[nb], A[nb], c[nCmax * nb];
+    unsigned ccaps = caps & CAP_MASK;
+    for (size_t b = i0; b < i1; b += nb) {
+      size_t k = min(nb, i1 - b);
+      GeodesicLine* l = lines + b;
+      for (size_t j = 0; j < k; ++j) {
+        l[j] = GeodesicLine(*this, lat1[b + j], lon1[b + j], azi1[b + j],
+                            caps & ~CAP_MASK);
+        l[j]._caps |= ccaps;
+        real k2 = l[j]._k2;
+        eps[j] = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
+        eps2[j] = Math::sq(eps[j]);
+      }
+      if (ccaps & CAP_C1) {
+        // As in A1m1f
+        const real* coeff = A1m1table();
+        int m = nA1_/2, mt = _nC/2;
+        polyvals(mt, coeff + (m - mt), eps2, k, y);
+        for (size_t j = 0; j < k; ++j) {
+          real t = y[j] / coeff[m + 1];
+          A[j] = (t + eps[j]) / (1 - eps[j]);
+        }
+        sinseriesvals(C1table(), nC1_, _nC, eps, eps2, k, d, y, c, nb);
+        for (size_t j = 0; j < k; ++j) {
+          l[j]._A1m1 = A[j];
+          for (int i = 1; i <= _nC; ++i)
+            l[j]._C1a[i] = c[i * nb + j];
+        }
+      }
+      if (ccaps & CAP_C1p) {
+        sinseriesvals(C1ptable(), nC1p_, _nC, eps, eps2, k, d, y, c, nb);
+        for (size_t j = 0; j < k; ++j)
+          for (int i = 1; i <= _nC; ++i)
+            l[j]._C1pa[i] = c[i * nb + j];
+      }
+      if (ccaps & CAP_C2) {
+        // As in A2m1f
+        const real* coeff = A2m1table();
+        int m = nA2_/2, mt = _nC/2;
+        polyvals(mt, coeff + (m - mt), eps2, k, y);
+        for (size_t j = 0; j < k; ++j) {
+          real t = y[j] / coeff[m + 1];
+          A[j] = t * (1 - eps[j]) - eps[j];
+        }
+        sinseriesvals(C2table(), nC2_, _nC, eps, eps2, k, d, y, c, nb);
+        for (size_t j = 0; j < k; ++j) {
+          l[j]._A2m1 = A[j];
+          for (int i = 1; i <= _nC; ++i)
+            l[j]._C2a[i] = c[i * nb + j];
+        }
+      }
+      if (ccaps & CAP_C3) {
+        // As in A3f and C3f
+        polyvals(_nC - 1, _A3x, eps, k, A);
+        for (size_t j = 0; j < k; ++j)
+          d[j] = 1;
+        int o = 0;
+        for (int i = 1; i < _nC; ++i) {
+          int m = _nC - i - 1;
+          polyvals(m, _C3x + o, eps, k, y);
+          for (size_t j = 0; j < k; ++j) {
+            d[j] *= eps[j];
+            c[i * nb + j] = d[j] * y[j];
+          }
+          o += m + 1;
+        }
+        for (size_t j = 0; j < k; ++j) {
+          l[j]._A3c = -_f * l[j]._salp0 * A[j];
+          for (int i = 1; i < _nC; ++i)
+            l[j]._C3a[i] = c[i * nb + j];
+        }
+      }
+      if (ccaps & CAP_C4) {
+        // As in C4f
+        for (size_t j = 0; j < k; ++j)
+          d[j] = 1;
+        int o = 0;
+        for (int i = 0; i < _nC; ++i) {
+          int m = _nC - i - 1;
+          polyvals(m, _C4x + o, eps, k, y);
+          for (size_t j = 0; j < k; ++j) {
+            c[i * nb + j] = d[j] * y[j];
+            d[j] *= eps[j];
+          }
+          o += m + 1;
+        }
+        for (size_t j = 0; j < k; ++j)
+          for (int i = 0; i < _nC; ++i)
+            l[j]._C4a[i] = c[i * nb + j];
+      }
+      for (size_t j = 0; j < k; ++j)
+        l[j].InitSums(*this);
+    }
+  }
+
   Math::real Geodesic::GenDirect(real lat1, real lon1, real azi1,
                                  bool arcmode, real s12_a12, unsigned outmask,
                                  real& lat2, real& lon2, real& azi2,
@@ -133,35 +327,456 @@ namespace GeographicLib {
                   lat2, lon2, azi2, s12, m12, M12, M21, S12);
   }
 
+  void Geodesic::GenDirectBatch(const real* lat1, const real* lon1,
+                                const real* azi1,
+                                bool arcmode, const real* s12_a12, size_t n,
+                                unsigned outmask,
+                                real* lat2, real* lon2, real* azi2,
+                                real* s12, real* m12, real* M12, real* M21,
+                                real* S12, real* a12, int nthreads) const {
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+    // Divide the problems into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    GenDirectRange(lat1, lon1, azi1, arcmode, s12_a12, i0, i1,
+                                   outmask, lat2, lon2, azi2, s12, m12, M12,
+                                   M21, S12, a12);
+                  });
+#else
+    (void)nthreads;
+    GenDirectRange(lat1, lon1, azi1, arcmode, s12_a12, 0, n, outmask,
+                   lat2, lon2, azi2, s12, m12, M12, M21, S12, a12);
+#endif
+  }
+
+  void Geodesic::GenDirectRange(const real* lat1, const real* lon1,
+                                const real* azi1,
+                                bool arcmode, const real* s12_a12,
+                                size_t i0, size_t i1, unsigned outmask,
+                                real* lat2, real* lon2, real* azi2,
+                                real* s12, real* m12, real* M12, real* M21,
+                                real* S12, real* a12) const {
+    // Work out the capabilities needed for the GeodesicLine objects once.
+    unsigned caps = outmask | (arcmode ? NONE : DISTANCE_IN);
+    bool
+      latp = (outmask & LATITUDE & OUT_MASK) != 0U,
+      lonp = (outmask & LONGITUDE & OUT_MASK) != 0U,
+      azip = (outmask & AZIMUTH & OUT_MASK) != 0U,
+      distp = (outmask & DISTANCE & OUT_MASK) != 0U,
+      redlp = (outmask & REDUCEDLENGTH & OUT_MASK) != 0U,
+      scalep = (outmask & GEODESICSCALE & OUT_MASK) != 0U,
+      areap = (outmask & AREA & OUT_MASK) != 0U,
+      arcp = a12 != 0;
+    real tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12;
+    for (size_t i = i0; i < i1; ++i) {
+      real ta12 = GeodesicLine(*this, lat1[i], lon1[i], azi1[i], caps)
+        .                       // Note the dot!
+        GenPosition(arcmode, s12_a12[i], outmask,
+                    tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12);
+      if (latp) lat2[i] = tlat2;
+      if (lonp) lon2[i] = tlon2;
+      if (azip) azi2[i] = tazi2;
+      if (distp) s12[i] = ts12;
+      if (redlp) m12[i] = tm12;
+      if (scalep) { M12[i] = tM12; M21[i] = tM21; }
+      if (areap) S12[i] = tS12;
+      if (arcp) a12[i] = ta12;
+    }
+  }
+
+  void Geodesic::GenDirectFan(real lat1, real lon1, const real* azi1,
+                              size_t na, bool arcmode, const real* s12_a12,
+                              size_t ns, unsigned outmask,
+                              real* lat2, real* lon2, real* azi2,
+                              real* s12, real* m12, real* M12, real* M21,
+                              real* S12, real* a12, int nthreads) const {
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+    // Divide the azimuths into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(na, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    GenDirectFanRange(lat1, lon1, azi1, arcmode, s12_a12, ns,
+                                      i0, i1, outmask, lat2, lon2, azi2, s12,
+                                      m12, M12, M21, S12, a12);
+                  });
+#else
+    (void)nthreads;
+    GenDirectFanRange(lat1, lon1, azi1, arcmode, s12_a12, ns, 0, na, outmask,
+                      lat2, lon2, azi2, s12, m12, M12, M21, S12, a12);
+#endif
+  }
+
+  void Geodesic::GenDirectFanRange(real lat1, real lon1, const real* azi1,
+                                   bool arcmode, const real* s12_a12,
+                                   size_t ns, size_t i0, size_t i1,
+                                   unsigned outmask,
+                                   real* lat2, real* lon2, real* azi2,
+                                   real* s12, real* m12, real* M12,
+                                   real* M21, real* S12, real* a12) const {
+    // The lines for a block of nb azimuths are constructed together by
+    // LineRange and each is then used for all the distances.
+    static const size_t nb = 32;
+    unsigned caps = outmask | (arcmode ? NONE : DISTANCE_IN);
+    bool
+      latp = (outmask & LATITUDE & OUT_MASK) != 0U,
+      lonp = (outmask & LONGITUDE & OUT_MASK) != 0U,
+      azip = (outmask & AZIMUTH & OUT_MASK) != 0U,
+      distp = (outmask & DISTANCE & OUT_MASK) != 0U,
+      redlp = (outmask & REDUCEDLENGTH & OUT_MASK) != 0U,
+      scalep = (outmask & GEODESICSCALE & OUT_MASK) != 0U,
+      areap = (outmask & AREA & OUT_MASK) != 0U,
+      arcp = a12 != 0;
+    real lat1s[nb], lon1s[nb];
+    for (size_t j = 0; j < nb; ++j) {
+      lat1s[j] = lat1; lon1s[j] = lon1;
+    }
+    vector<GeodesicLine> lines(min(nb, i1 - min(i0, i1)));
+    real tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12;
+    for (size_t b = i0; b < i1; b += nb) {
+      size_t k = min(nb, i1 - b);
+      LineRange(lat1s, lon1s, azi1 + b, 0, k, caps, &lines[0]);
+      for (size_t j = 0; j < k; ++j) {
+        const GeodesicLine& l = lines[j];
+        for (size_t m = 0, i = (b + j) * ns; m < ns; ++m, ++i) {
+          real ta12 = l.GenPosition(arcmode, s12_a12[m], outmask,
+                                    tlat2, tlon2, tazi2,
+                                    ts12, tm12, tM12, tM21, tS12);
+          if (latp) lat2[i] = tlat2;
+          if (lonp) lon2[i] = tlon2;
+          if (azip) azi2[i] = tazi2;
+          if (distp) s12[i] = ts12;
+          if (redlp) m12[i] = tm12;
+          if (scalep) { M12[i] = tM12; M21[i] = tM21; }
+          if (areap) S12[i] = tS12;
+          if (arcp) a12[i] = ta12;
+        }
+      }
+    }
+  }
+
+  void Geodesic::ReducedLatitude(real lat, real& sbet, real& cbet, real& dn)
+    const {
+    // lat has already been passed through AngRound.  The sign of sbet follows
+    // that of lat (including the sign of zero) so that the inverse solution
+    // can flip the sign of the latitude with sbet *= -1.
+    real phi = lat * Math::degree();
+    sbet = _f1 * sin(phi);
+    // Ensure cbet = +epsilon at poles
+    cbet = abs(lat) == 90 ? tiny_ : cos(phi);
+    Math::norm(sbet, cbet);
+    dn = sqrt(1 + _ep2 * Math::sq(sbet));
+  }
+
+  Geodesic::Point::Point(const Geodesic& geod, real lat, real lon)
+    // Mimic the preprocessing of the arguments in GenInverse
+    : _lat(Math::AngRound(lat))
+    , _lon(Math::AngNormalize(lon))
+  {
+    geod.ReducedLatitude(_lat, _sbet, _cbet, _dn);
+  }
+
   Math::real Geodesic::GenInverse(real lat1, real lon1, real lat2, real lon2,
                                   unsigned outmask,
                                   real& s12, real& azi1, real& azi2,
                                   real& m12, real& M12, real& M21, real& S12)
     const {
-    outmask &= OUT_MASK;
     // Compute longitude difference (AngDiff does this carefully).  Result is
     // in [-180, 180] but -180 is only for west-going geodesics.  180 is for
     // east-going and meridional geodesics.
     real lon12 = Math::AngDiff(Math::AngNormalize(lon1),
                                Math::AngNormalize(lon2));
+    // If really close to the equator, treat as on equator.
+    lat1 = Math::AngRound(lat1);
+    lat2 = Math::AngRound(lat2);
+    real sbet1, cbet1, dn1, sbet2, cbet2, dn2;
+    ReducedLatitude(lat1, sbet1, cbet1, dn1);
+    ReducedLatitude(lat2, sbet2, cbet2, dn2);
+    return GenInverse(lat1, sbet1, cbet1, dn1, lat2, sbet2, cbet2, dn2,
+                      lon12, outmask, s12, azi1, azi2, m12, M12, M21, S12);
+  }
+
+  template<unsigned outmask>
+  Math::real Geodesic::GenInverse(real lat1, real lon1, real lat2, real lon2,
+                                  real& s12, real& azi1, real& azi2,
+                                  real& m12, real& M12, real& M21, real& S12)
+    const {
+    // The preprocessing is the same as for GenInverse
+    real lon12 = Math::AngDiff(Math::AngNormalize(lon1),
+                               Math::AngNormalize(lon2));
+    lat1 = Math::AngRound(lat1);
+    lat2 = Math::AngRound(lat2);
+    real sbet1, cbet1, dn1, sbet2, cbet2, dn2;
+    ReducedLatitude(lat1, sbet1, cbet1, dn1);
+    ReducedLatitude(lat2, sbet2, cbet2, dn2);
+    return GenInverseT<outmask>(lat1, sbet1, cbet1, dn1,
+                                lat2, sbet2, cbet2, dn2,
+                                lon12, outmask,
+                                s12, azi1, azi2, m12, M12, M21, S12,
+                                0U, 0, 0);
+  }
+
+  // The instantiations of the specialized versions of GenInverse; these
+  // correspond to the overloaded versions of Inverse and to the combination
+  // used by PolygonArea.
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::AZIMUTH>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE |
+                                           Geodesic::AZIMUTH>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE |
+                                           Geodesic::AZIMUTH |
+                                           Geodesic::REDUCEDLENGTH>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE |
+                                           Geodesic::AZIMUTH |
+                                           Geodesic::GEODESICSCALE>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE |
+                                           Geodesic::AZIMUTH |
+                                           Geodesic::REDUCEDLENGTH |
+                                           Geodesic::GEODESICSCALE>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::DISTANCE |
+                                           Geodesic::AREA>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+  template Math::real Geodesic::GenInverse<Geodesic::ALL>
+  (Math::real, Math::real, Math::real, Math::real,
+   Math::real&, Math::real&, Math::real&,
+   Math::real&, Math::real&, Math::real&, Math::real&) const;
+
+  Math::real Geodesic::GenInverseBounded(real lat1, real lon1,
+                                         real lat2, real lon2,
+                                         unsigned outmask, unsigned maxit,
+                                         real& s12, real& azi1, real& azi2,
+                                         real& m12, real& M12, real& M21,
+                                         real& S12, real& ds12,
+                                         bool& converged) const {
+    // The preprocessing is the same as for GenInverse
+    real lon12 = Math::AngDiff(Math::AngNormalize(lon1),
+                               Math::AngNormalize(lon2));
+    lat1 = Math::AngRound(lat1);
+    lat2 = Math::AngRound(lat2);
+    real sbet1, cbet1, dn1, sbet2, cbet2, dn2;
+    ReducedLatitude(lat1, sbet1, cbet1, dn1);
+    ReducedLatitude(lat2, sbet2, cbet2, dn2);
+    return GenInverse(lat1, sbet1, cbet1, dn1, lat2, sbet2, cbet2, dn2,
+                      lon12, outmask, s12, azi1, azi2, m12, M12, M21, S12,
+                      max(maxit, 1U), &ds12, &converged);
+  }
+
+  void Geodesic::IntDistanceBounds(real sbet1, real cbet1,
+                                   real sbet2, real cbet2, real lon12,
+                                   real& lo, real& hi) const {
+    // The point (a*cbet*cos(lon), a*cbet*sin(lon), a*sbet) on the sphere of
+    // radius a maps to the ellipsoid by scaling z by b/a = _f1.  If l is the
+    // length of a curve on the sphere, the length of its image is the
+    // integral of sqrt(1 - (1 - _f1^2) * z'^2) dl, where z' = dz/dl.  With L
+    // the great circle distance and dz the change in z, this gives the
+    // bounds:
+    //   oblate:  max(_f1 * L, chord) <= s12 <= sqrt(L^2 - (1-_f1^2) * dz^2)
+    //   prolate: max(sqrt(L^2 + (_f1^2-1) * dz^2), chord) <= s12 <= _f1 * L
+    // where the upper bounds come from the image of the great circle (using
+    // Cauchy-Schwarz in the oblate case) and the lower bounds apply to the
+    // preimage of the geodesic (using Minkowski's inequality in the prolate
+    // case, and l >= L).
+    real slam, clam;
+    Math::sincosd(lon12, slam, clam);
+    // The quantities are bounded so that sqrt is safe to use here instead
+    // of hypot (which is slower).
+    real
+      dx = cbet2 * clam - cbet1, dy = cbet2 * slam, dz = sbet2 - sbet1,
+      ssig = sqrt(Math::sq(cbet1 * sbet2 - sbet1 * cbet2 * clam) +
+                  Math::sq(dy)),
+      csig = sbet1 * sbet2 + cbet1 * cbet2 * clam,
+      L = _a * atan2(ssig, csig),
+      chord = _a * sqrt(Math::sq(dx) + Math::sq(dy) + Math::sq(_f1 * dz)),
+      k2 = (1 - _f1) * (1 + _f1) * Math::sq(_a * dz);
+    if (_f >= 0) {
+      lo = max(_f1 * L, chord);
+      hi = sqrt(max(Math::sq(L) - k2, real(0)));
+    } else {
+      lo = max(sqrt(Math::sq(L) - k2), chord);
+      hi = _f1 * L;
+    }
+    // Allow for roundoff here and in the solution of the inverse problem.
+    real slack = tol1_ * max(_a, _b);
+    lo = max(lo * (1 - tol1_) - slack, real(0));
+    hi = hi * (1 + tol1_) + slack;
+  }
+
+  void Geodesic::DistanceBounds(real lat1, real lon1, real lat2, real lon2,
+                                real& lo, real& hi) const {
+    // The reduced latitudes as in ReducedLatitude, but skipping dn.
+    real sbet1, cbet1, sbet2, cbet2, t;
+    Math::sincosd(Math::AngRound(lat1), sbet1, cbet1);
+    sbet1 *= _f1; t = 1 / sqrt(Math::sq(sbet1) + Math::sq(cbet1));
+    sbet1 *= t; cbet1 *= t;
+    Math::sincosd(Math::AngRound(lat2), sbet2, cbet2);
+    sbet2 *= _f1; t = 1 / sqrt(Math::sq(sbet2) + Math::sq(cbet2));
+    sbet2 *= t; cbet2 *= t;
+    IntDistanceBounds(sbet1, cbet1, sbet2, cbet2,
+                      Math::AngDiff(Math::AngNormalize(lon1),
+                                    Math::AngNormalize(lon2)), lo, hi);
+  }
+
+  bool Geodesic::WithinDistance(real lat1, real lon1,
+                                real lat2, real lon2, real r) const {
+    real lon12 = Math::AngDiff(Math::AngNormalize(lon1),
+                               Math::AngNormalize(lon2));
+    lat1 = Math::AngRound(lat1);
+    lat2 = Math::AngRound(lat2);
+    real sbet1, cbet1, dn1, sbet2, cbet2, dn2, lo, hi;
+    ReducedLatitude(lat1, sbet1, cbet1, dn1);
+    ReducedLatitude(lat2, sbet2, cbet2, dn2);
+    IntDistanceBounds(sbet1, cbet1, sbet2, cbet2, lon12, lo, hi);
+    if (hi <= r) return true;
+    if (!(lo <= r)) return false;
+    real s12, t;
+    GenInverse(lat1, sbet1, cbet1, dn1, lat2, sbet2, cbet2, dn2,
+               lon12, DISTANCE, s12, t, t, t, t, t, t);
+    return s12 <= r;
+  }
+
+  void Geodesic::LatitudeRange(real lat1, real azi1, real lat2, real azi2,
+                               real& latmin, real& latmax) const {
+    latmin = min(lat1, lat2);
+    latmax = max(lat1, lat2);
+    if ((abs(azi1) < 90) != (abs(azi2) < 90)) {
+      // The geodesic passes through a vertex.  Clairaut's relation gives
+      // its reduced latitude, cos(bet0) = |sin(alp0)| = |sin(alp1)|
+      // cos(bet1).
+      real sbet1, cbet1, dn1, salp1, calp1;
+      ReducedLatitude(Math::AngRound(lat1), sbet1, cbet1, dn1);
+      Math::sincosd(azi1, salp1, calp1);
+      real
+        salp0 = salp1 * cbet1,
+        calp0 = Math::hypot(calp1, salp1 * sbet1),
+        lat0 = Math::atan2d(calp0, _f1 * abs(salp0));
+      if (abs(azi1) < 90)
+        latmax = max(latmax, lat0);
+      else
+        latmin = min(latmin, -lat0);
+    }
+  }
+
+  void Geodesic::SegmentBounds(real lat1, real lon1, real lat2, real lon2,
+                               real& latmin, real& latmax,
+                               real& lonmin, real& lonmax) const {
+    real
+      lon1x = Math::AngNormalize(lon1), lon2x = Math::AngNormalize(lon2),
+      lon12 = Math::AngDiff(lon1x, lon2x);
+    lat1 = Math::AngRound(lat1);
+    lat2 = Math::AngRound(lat2);
+    real sbet1, cbet1, dn1, sbet2, cbet2, dn2, azi1, azi2, t;
+    ReducedLatitude(lat1, sbet1, cbet1, dn1);
+    ReducedLatitude(lat2, sbet2, cbet2, dn2);
+    GenInverse(lat1, sbet1, cbet1, dn1, lat2, sbet2, cbet2, dn2,
+               lon12, AZIMUTH, t, azi1, azi2, t, t, t, t);
+    LatitudeRange(lat1, azi1, lat2, azi2, latmin, latmax);
+    lonmin = lon12 >= 0 ? lon1x : lon2x;
+    lonmax = lonmin + abs(lon12);
+  }
+
+  void Geodesic::SegmentBoundsBatch(const real* lat1, const real* lon1,
+                                    const real* lat2, const real* lon2,
+                                    size_t n,
+                                    real* latmin, real* latmax,
+                                    real* lonmin, real* lonmax,
+                                    int nthreads) const {
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+    // Divide the problems into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    SegmentBoundsRange(lat1, lon1, lat2, lon2, i0, i1, latmin,
+                                       latmax, lonmin, lonmax);
+                  });
+#else
+    (void)nthreads;
+    SegmentBoundsRange(lat1, lon1, lat2, lon2, 0, n,
+                       latmin, latmax, lonmin, lonmax);
+#endif
+  }
+
+  void Geodesic::SegmentBoundsRange(const real* lat1, const real* lon1,
+                                    const real* lat2, const real* lon2,
+                                    size_t i0, size_t i1,
+                                    real* latmin, real* latmax,
+                                    real* lonmin, real* lonmax) const {
+    for (size_t i = i0; i < i1; ++i)
+      SegmentBounds(lat1[i], lon1[i], lat2[i], lon2[i],
+                    latmin[i], latmax[i], lonmin[i], lonmax[i]);
+  }
+
+  Math::real Geodesic::GenInverse(real lat1,
+                                  real sbet1, real cbet1, real dn1,
+                                  real lat2,
+                                  real sbet2, real cbet2, real dn2,
+                                  real lon12, unsigned outmask,
+                                  real& s12, real& azi1, real& azi2,
+                                  real& m12, real& M12, real& M21, real& S12,
+                                  unsigned maxit, real* ds12, bool* converged)
+    const {
+    return GenInverseT<ALL>(lat1, sbet1, cbet1, dn1, lat2, sbet2, cbet2, dn2,
+                            lon12, outmask, s12, azi1, azi2, m12, M12, M21, S12,
+                            maxit, ds12, converged);
+  }
+
+  template<unsigned Mask>
+  Math::real Geodesic::GenInverseT(real lat1,
+                                   real sbet1, real cbet1, real dn1,
+                                   real lat2,
+                                   real sbet2, real cbet2, real dn2,
+                                   real lon12, unsigned outmask,
+                                   real& s12, real& azi1, real& azi2,
+                                   real& m12, real& M12, real& M21, real& S12,
+                                   unsigned maxit, real* ds12, bool* converged)
+    const {
+    // lat1 and lat2 have been processed with AngRound and (sbet1, cbet1, dn1)
+    // and (sbet2, cbet2, dn2) are the results of ReducedLatitude for them.
+    // lon12 is the longitude difference given by AngDiff.  Mask = ALL for
+    // the general version; otherwise, outmask = Mask is known at compile
+    // time and the branches for the outputs not requested are removed.
+    if (Mask != unsigned(ALL)) outmask = Mask;
+    outmask &= OUT_MASK;
+    GEOGRAPHICLIB_GEODESIC_STAT(++stats_.count);
     // If very close to being on the same half-meridian, then make it so.
     lon12 = Math::AngRound(lon12);
     // Make longitude difference positive.
     int lonsign = lon12 >= 0 ? 1 : -1;
     lon12 *= lonsign;
-    // If really close to the equator, treat as on equator.
-    lat1 = Math::AngRound(lat1);
-    lat2 = Math::AngRound(lat2);
     // Swap points so that point with higher (abs) latitude is point 1
     int swapp = abs(lat1) >= abs(lat2) ? 1 : -1;
     if (swapp < 0) {
       lonsign *= -1;
       swap(lat1, lat2);
+      swap(sbet1, sbet2);
+      swap(cbet1, cbet2);
+      swap(dn1, dn2);
     }
     // Make lat1 <= 0
     int latsign = lat1 < 0 ? 1 : -1;
     lat1 *= latsign;
     lat2 *= latsign;
+    sbet1 *= latsign;
+    sbet2 *= latsign;
     // Now we have
     //
     //     0 <= lon12 <= 180
@@ -174,19 +789,10 @@ namespace GeographicLib {
     // check, e.g., on verifying quadrants in atan2.  In addition, this
     // enforces some symmetries in the results returned.
 
-    real phi, sbet1, cbet1, sbet2, cbet2, s12x, m12x;
-
-    phi = lat1 * Math::degree();
-    // Ensure cbet1 = +epsilon at poles
-    sbet1 = _f1 * sin(phi);
-    cbet1 = lat1 == -90 ? tiny_ : cos(phi);
-    Math::norm(sbet1, cbet1);
-
-    phi = lat2 * Math::degree();
-    // Ensure cbet2 = +epsilon at poles
-    sbet2 = _f1 * sin(phi);
-    cbet2 = abs(lat2) == 90 ? tiny_ : cos(phi);
-    Math::norm(sbet2, cbet2);
+    real s12x = 0, m12x = 0;
+    // The residual in lam12 and whether Newton's method converged
+    real vres = 0;
+    bool conv = true;
 
     // If cbet1 < -sbet1, then cbet2 - cbet1 is a sensitive measure of the
     // |bet1| - |bet2|.  Alternatively (cbet1 >= -sbet1), abs(sbet2) + sbet1 is
@@ -197,17 +803,15 @@ namespace GeographicLib {
     // which failed with Visual Studio 10 (Release and Debug)
 
     if (cbet1 < -sbet1) {
-      if (cbet2 == cbet1)
+      if (cbet2 == cbet1) {
         sbet2 = sbet2 < 0 ? sbet1 : -sbet1;
+        dn2 = dn1;
+      }
     } else {
       if (abs(sbet2) == -sbet1)
         cbet2 = cbet1;
     }
 
-    real
-      dn1 = sqrt(1 + _ep2 * Math::sq(sbet1)),
-      dn2 = sqrt(1 + _ep2 * Math::sq(sbet2));
-
     real
       lam12 = lon12 * Math::degree(),
       slam12 = abs(lon12) == 180 ? 0 : sin(lam12),
@@ -238,9 +842,10 @@ namespace GeographicLib {
                     csig1 * csig2 + ssig1 * ssig2);
       {
         real dummy;
+        // m12x is needed for the test below
         Lengths(_n, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
-                cbet1, cbet2, s12x, m12x, dummy,
-                (outmask & GEODESICSCALE) != 0U, M12, M21, C1a, C2a);
+                cbet1, cbet2, outmask | DISTANCE | REDUCEDLENGTH,
+                s12x, m12x, dummy, M12, M21, C1a, C2a);
       }
       // Add the check for sig12 since zero length geodesics might yield m12 <
       // 0.  Test case was
@@ -250,6 +855,7 @@ namespace GeographicLib {
       // In fact, we will have sig12 > pi/2 for meridional geodesic which is
       // not a shortest path.
       if (sig12 < 1 || m12x >= 0) {
+        GEOGRAPHICLIB_GEODESIC_STAT(++stats_.meridional);
         m12x *= _b;
         s12x *= _b;
         a12 = sig12 / Math::degree();
@@ -265,6 +871,7 @@ namespace GeographicLib {
         (_f <= 0 || lam12 <= Math::pi() - _f * Math::pi())) {
 
       // Geodesic runs along equator
+      GEOGRAPHICLIB_GEODESIC_STAT(++stats_.equatorial);
       calp1 = calp2 = 0; salp1 = salp2 = 1;
       s12x = _a * lam12;
       sig12 = omg12 = lam12 / _f1;
@@ -287,6 +894,7 @@ namespace GeographicLib {
 
       if (sig12 >= 0) {
         // Short lines (InverseStart sets salp2, calp2, dnm)
+        GEOGRAPHICLIB_GEODESIC_STAT(++stats_.shortline);
         s12x = sig12 * _b * dnm;
         m12x = Math::sq(dnm) * _b * sin(sig12 / dnm);
         if (outmask & GEODESICSCALE)
@@ -324,7 +932,18 @@ namespace GeographicLib {
             - lam12;
           // 2 * tol0 is approximately 1 ulp for a number in [0, pi].
           // Reversed test to allow escape with NaNs
-          if (tripb || !(abs(v) >= (tripn ? 8 : 2) * tol0_)) break;
+          vres = v;
+          if (tripb || !(abs(v) >= (tripn ? 8 : 2) * tol0_) ||
+              abs(v) < _tolv) {
+            GEOGRAPHICLIB_GEODESIC_STAT(stats_.tripb += tripb);
+            break;
+          }
+          if (maxit > 0 && numit + 1 >= maxit) {
+            // Out of budget; stop here so that the results are for the
+            // values of alp1 and v given by this call to Lambda12.
+            conv = false;
+            break;
+          }
           // Update bracketing values
           if (v > 0 && (numit > maxit1_ || calp1/salp1 > calp1b/salp1b))
             { salp1b = salp1; calp1b = calp1; }
@@ -355,6 +974,7 @@ namespace GeographicLib {
           // 90deg:
           // the WGS84 test set: mean = 5.21, sd = 3.93, max = 24
           // WGS84 and random input: mean = 4.74, sd = 0.99
+          GEOGRAPHICLIB_GEODESIC_STAT(++stats_.bisection);
           salp1 = (salp1a + salp1b)/2;
           calp1 = (calp1a + calp1b)/2;
           Math::norm(salp1, calp1);
@@ -362,11 +982,19 @@ namespace GeographicLib {
           tripb = (abs(salp1a - salp1) + (calp1a - calp1) < tolb_ ||
                    abs(salp1 - salp1b) + (calp1 - calp1b) < tolb_);
         }
-        {
+        GEOGRAPHICLIB_HISTOGRAM(LAMBDA12_ITERATIONS, numit);
+        if (numit >= maxit2_) GEOGRAPHICLIB_COUNT(GEODESIC_INVERSE_FAIL);
+        if (numit >= maxit2_) conv = false;
+#if GEOGRAPHICLIB_GEODESIC_STATS
+        ++stats_.newton;
+        stats_.failed += numit >= maxit2_;
+        ++stats_.hist[min(numit, unsigned(InverseStats::nbins_ - 1))];
+#endif
+        if (outmask & (DISTANCE | REDUCEDLENGTH | GEODESICSCALE)) {
           real dummy;
           Lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
-                  cbet1, cbet2, s12x, m12x, dummy,
-                  (outmask & GEODESICSCALE) != 0U, M12, M21, C1a, C2a);
+                  cbet1, cbet2, outmask, s12x, m12x, dummy, M12, M21,
+                  C1a, C2a);
         }
         m12x *= _b;
         s12x *= _b;
@@ -375,6 +1003,11 @@ namespace GeographicLib {
       }
     }
 
+    // a * cbet2 is the radius of the circle of latitude through point 2; so
+    // this is the distance by which the geodesic misses point 2.
+    if (ds12) *ds12 = _a * cbet2 * abs(vres);
+    if (converged) *converged = conv;
+
     if (outmask & DISTANCE)
       s12 = 0 + s12x;           // Convert -0 to 0
 
@@ -401,8 +1034,8 @@ namespace GeographicLib {
         real C4a[nC4_];
         C4f(eps, C4a);
         real
-          B41 = SinCosSeries(false, ssig1, csig1, C4a, nC4_),
-          B42 = SinCosSeries(false, ssig2, csig2, C4a, nC4_);
+          B41 = SinCosSeries(false, ssig1, csig1, C4a, _nC),
+          B42 = SinCosSeries(false, ssig2, csig2, C4a, _nC);
         S12 = A4 * (B42 - B41);
       } else
         // Avoid problems with indeterminate sig1, sig2 on equator
@@ -460,38 +1093,176 @@ namespace GeographicLib {
     return a12;
   }
 
+  void Geodesic::GenInverseBatch(const real* lat1, const real* lon1,
+                                 const real* lat2, const real* lon2, size_t n,
+                                 unsigned outmask,
+                                 real* s12, real* azi1, real* azi2,
+                                 real* m12, real* M12, real* M21, real* S12,
+                                 real* a12, int nthreads) const {
+#if GEOGRAPHICLIB_GEODESIC_THREADS
+    // Divide the problems into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    GenInverseRange(lat1, lon1, lat2, lon2, i0, i1, outmask,
+                                    s12, azi1, azi2, m12, M12, M21, S12, a12);
+                  });
+#else
+    (void)nthreads;
+    GenInverseRange(lat1, lon1, lat2, lon2, 0, n, outmask,
+                    s12, azi1, azi2, m12, M12, M21, S12, a12);
+#endif
+  }
+
+  void Geodesic::GenInverseRange(const real* lat1, const real* lon1,
+                                 const real* lat2, const real* lon2,
+                                 size_t i0, size_t i1, unsigned outmask,
+                                 real* s12, real* azi1, real* azi2,
+                                 real* m12, real* M12, real* M21, real* S12,
+                                 real* a12) const {
+    outmask &= OUT_MASK;
+    // The problems are solved in blocks of nb.  The arguments in a block are
+    // first preprocessed as in GenInverse and each problem is assigned to
+    // one of the regimes distinguished in GenInverse: 0 = meridional, 1 =
+    // equatorial, 2 = probably short (the cheap test in InverseStart), 3 =
+    // Newton's method.  The problems are then solved regime by regime (so
+    // that the branches taken are the same for successive problems) and the
+    // results are scattered into the requested arrays.  Each problem is still
+    // solved by GenInverseT so that the results are identical to the scalar
+    // path; the classification only determines the order.  Use a specialized
+    // version of GenInverseT if there's one for outmask.
+    real (Geodesic::*inv)(real, real, real, real, real, real, real, real,
+                          real, unsigned,
+                          real&, real&, real&, real&, real&, real&, real&,
+                          unsigned, real*, bool*) const;
+    switch (outmask) {
+    case DISTANCE & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE>; break;
+    case AZIMUTH & OUT_MASK:
+      inv = &Geodesic::GenInverseT<AZIMUTH>; break;
+    case (DISTANCE | AZIMUTH) & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE | AZIMUTH>; break;
+    case (DISTANCE | AZIMUTH | REDUCEDLENGTH) & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE | AZIMUTH | REDUCEDLENGTH>; break;
+    case (DISTANCE | AZIMUTH | GEODESICSCALE) & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE | AZIMUTH | GEODESICSCALE>; break;
+    case (DISTANCE | AZIMUTH | REDUCEDLENGTH | GEODESICSCALE) & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE | AZIMUTH |
+                                   REDUCEDLENGTH | GEODESICSCALE>; break;
+    case (DISTANCE | AREA) & OUT_MASK:
+      inv = &Geodesic::GenInverseT<DISTANCE | AREA>; break;
+    default:
+      inv = &Geodesic::GenInverseT<ALL>; break;
+    }
+    bool
+      distp = (outmask & DISTANCE) != 0U,
+      azip = (outmask & AZIMUTH) != 0U,
+      redlp = (outmask & REDUCEDLENGTH) != 0U,
+      scalep = (outmask & GEODESICSCALE) != 0U,
+      areap = (outmask & AREA) != 0U,
+      arcp = a12 != 0;
+    static const size_t nb = 64;
+    static const int nregime = 4;
+    real tlat1[nb], tsbet1[nb], tcbet1[nb], tdn1[nb],
+      tlat2[nb], tsbet2[nb], tcbet2[nb], tdn2[nb], tlon12[nb];
+    int regime[nb];
+    size_t order[nb];
+    real ts12, tazi1, tazi2, tm12, tM12, tM21, tS12;
+    for (size_t b = i0; b < i1; b += nb) {
+      size_t k = min(nb, i1 - b);
+      size_t count[nregime + 1] = {0};
+      for (size_t j = 0; j < k; ++j) {
+        size_t i = b + j;
+        tlon12[j] = Math::AngDiff(Math::AngNormalize(lon1[i]),
+                                  Math::AngNormalize(lon2[i]));
+        tlat1[j] = Math::AngRound(lat1[i]);
+        tlat2[j] = Math::AngRound(lat2[i]);
+        ReducedLatitude(tlat1[j], tsbet1[j], tcbet1[j], tdn1[j]);
+        ReducedLatitude(tlat2[j], tsbet2[j], tcbet2[j], tdn2[j]);
+        real lon12 = abs(Math::AngRound(tlon12[j]));
+        int r;
+        if (abs(tlat1[j]) == 90 || abs(tlat2[j]) == 90 ||
+            lon12 == 0 || lon12 == 180)
+          r = 0;
+        else if (tlat1[j] == 0 && tlat2[j] == 0)
+          r = 1;
+        else {
+          real
+            sbet12 = abs(tsbet2[j] * tcbet1[j] - tcbet2[j] * tsbet1[j]),
+            cbet12 = tcbet2[j] * tcbet1[j] + tsbet2[j] * tsbet1[j];
+          r = cbet12 >= 0 && sbet12 < real(0.5) &&
+            max(tcbet1[j], tcbet2[j]) * lon12 * Math::degree() < real(0.5) ?
+            2 : 3;
+        }
+        regime[j] = r;
+        ++count[r + 1];
+      }
+      // A counting sort of the problems by regime
+      for (int r = 0; r < nregime; ++r)
+        count[r + 1] += count[r];
+      for (size_t j = 0; j < k; ++j)
+        order[count[regime[j]]++] = j;
+      for (size_t l = 0; l < k; ++l) {
+        size_t j = order[l], i = b + j;
+        real ta12 = (this->*inv)(tlat1[j], tsbet1[j], tcbet1[j], tdn1[j],
+                                 tlat2[j], tsbet2[j], tcbet2[j], tdn2[j],
+                                 tlon12[j], outmask,
+                                 ts12, tazi1, tazi2, tm12, tM12, tM21, tS12,
+                                 0U, 0, 0);
+        if (distp) s12[i] = ts12;
+        if (azip) { azi1[i] = tazi1; azi2[i] = tazi2; }
+        if (redlp) m12[i] = tm12;
+        if (scalep) { M12[i] = tM12; M21[i] = tM21; }
+        if (areap) S12[i] = tS12;
+        if (arcp) a12[i] = ta12;
+      }
+    }
+  }
+
   void Geodesic::Lengths(real eps, real sig12,
                          real ssig1, real csig1, real dn1,
                          real ssig2, real csig2, real dn2,
-                         real cbet1, real cbet2,
+                         real cbet1, real cbet2, unsigned outmask,
                          real& s12b, real& m12b, real& m0,
-                         bool scalep, real& M12, real& M21,
+                         real& M12, real& M21,
                          // Scratch areas of the right size
                          real C1a[], real C2a[]) const {
     // Return m12b = (reduced length)/_b; also calculate s12b = distance/_b,
     // and m0 = coefficient of secular term in expression for reduced length.
-    C1f(eps, C1a);
-    C2f(eps, C2a);
+    // Only the quantities selected by outmask (DISTANCE for s12b,
+    // REDUCEDLENGTH for m12b and m0, GEODESICSCALE for M12 and M21) are
+    // computed; the C2 series is only needed for the last two.
+    outmask &= OUT_MASK;
+    C1f(eps, C1a, _nC);
     real
-      A1m1 = A1m1f(eps),
-      AB1 = (1 + A1m1) * (SinCosSeries(true, ssig2, csig2, C1a, nC1_) -
-                          SinCosSeries(true, ssig1, csig1, C1a, nC1_)),
-      A2m1 = A2m1f(eps),
-      AB2 = (1 + A2m1) * (SinCosSeries(true, ssig2, csig2, C2a, nC2_) -
-                          SinCosSeries(true, ssig1, csig1, C2a, nC2_));
-    m0 = A1m1 - A2m1;
-    real J12 = m0 * sig12 + (AB1 - AB2);
-    // Missing a factor of _b.
-    // Add parens around (csig1 * ssig2) and (ssig1 * csig2) to ensure accurate
-    // cancellation in the case of coincident points.
-    m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) - csig1 * csig2 * J12;
-    // Missing a factor of _b
-    s12b = (1 + A1m1) * sig12 + AB1;
-    if (scalep) {
-      real csig12 = csig1 * csig2 + ssig1 * ssig2;
-      real t = _ep2 * (cbet1 - cbet2) * (cbet1 + cbet2) / (dn1 + dn2);
-      M12 = csig12 + (t * ssig2 - csig2 * J12) * ssig1 / dn1;
-      M21 = csig12 - (t * ssig1 - csig1 * J12) * ssig2 / dn2;
+      A1m1 = A1m1f(eps, _nC),
+      AB1 = (1 + A1m1) * (SinCosSeries(true, ssig2, csig2, C1a, _nC) -
+                          SinCosSeries(true, ssig1, csig1, C1a, _nC));
+    if (outmask & DISTANCE)
+      // Missing a factor of _b
+      s12b = (1 + A1m1) * sig12 + AB1;
+    if (outmask & (REDUCEDLENGTH | GEODESICSCALE)) {
+      C2f(eps, C2a, _nC);
+      real
+        A2m1 = A2m1f(eps, _nC),
+        AB2 = (1 + A2m1) * (SinCosSeries(true, ssig2, csig2, C2a, _nC) -
+                            SinCosSeries(true, ssig1, csig1, C2a, _nC)),
+        m0x = A1m1 - A2m1,
+        J12 = m0x * sig12 + (AB1 - AB2);
+      if (outmask & REDUCEDLENGTH) {
+        m0 = m0x;
+        // Missing a factor of _b.  Add parens around (csig1 * ssig2) and
+        // (ssig1 * csig2) to ensure accurate cancellation in the case of
+        // coincident points.
+        m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) -
+          csig1 * csig2 * J12;
+      }
+      if (outmask & GEODESICSCALE) {
+        real csig12 = csig1 * csig2 + ssig1 * ssig2;
+        real t = _ep2 * (cbet1 - cbet2) * (cbet1 + cbet2) / (dn1 + dn2);
+        M12 = csig12 + (t * ssig2 - csig2 * J12) * ssig1 / dn1;
+        M21 = csig12 - (t * ssig1 - csig1 * J12) * ssig2 / dn2;
+      }
     }
   }
 
@@ -646,7 +1417,7 @@ namespace GeographicLib {
         // Inverse.
         Lengths(_n, Math::pi() + bet12a,
                 sbet1, -cbet1, dn1, sbet2, cbet2, dn2,
-                cbet1, cbet2, dummy, m12b, m0, false,
+                cbet1, cbet2, REDUCEDLENGTH, dummy, m12b, m0,
                 dummy, dummy, C1a, C2a);
         x = -1 + m12b / (cbet1 * cbet2 * m0 * Math::pi());
         betscale = x < -real(0.01) ? sbet12a / x :
@@ -698,6 +1469,16 @@ namespace GeographicLib {
         //    5   455      1
         //    6    56      0
         //
+        // Replacing the solution of the astroid problem by an interpolated
+        // table of k(x, y) would not reduce the number of iterations, because
+        // the starting guess would be the same (the error in the guess comes
+        // from the neglect of higher order terms in f, not from the
+        // evaluation of k).  It would only save the cbrt and sqrt calls in
+        // Astroid, which are a small fraction of the cost of one call to
+        // Lambda12.  For random near-antipodal points (|lat1 + lat2| < 0.5,
+        // lon12 > 179.5) on the WGS84 ellipsoid, the mean number of iterations
+        // is 2.54 (max 6) with no bisection steps.
+        //
         // Because omg12 is near pi, estimate work with omg12a = pi - omg12
         real k = Astroid(x, y);
         real
@@ -780,8 +1561,8 @@ namespace GeographicLib {
     real k2 = Math::sq(calp0) * _ep2;
     eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
     C3f(eps, C3a);
-    B312 = (SinCosSeries(true, ssig2, csig2, C3a, nC3_-1) -
-            SinCosSeries(true, ssig1, csig1, C3a, nC3_-1));
+    B312 = (SinCosSeries(true, ssig2, csig2, C3a, _nC-1) -
+            SinCosSeries(true, ssig1, csig1, C3a, _nC-1));
     h0 = -_f * A3f(eps);
     domg12 = salp0 * h0 * (sig12 + B312);
     lam12 = omg12 + domg12;
@@ -792,8 +1573,8 @@ namespace GeographicLib {
       else {
         real dummy;
         Lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
-                cbet1, cbet2, dummy, dlam12, dummy,
-                false, dummy, dummy, C1a, C2a);
+                cbet1, cbet2, REDUCEDLENGTH, dummy, dlam12, dummy,
+                dummy, dummy, C1a, C2a);
         dlam12 *= _f1 / (calp2 * cbet2);
       }
     }
@@ -803,35 +1584,35 @@ namespace GeographicLib {
 
   Math::real Geodesic::A3f(real eps) const {
     // Evaluate A3
-    return Math::polyval(nA3_ - 1, _A3x, eps);
+    return Math::polyval(_nC - 1, _A3x, eps);
   }
 
   void Geodesic::C3f(real eps, real c[]) const {
     // Evaluate C3 coeffs
-    // Elements c[1] thru c[nC3_ - 1] are set
+    // Elements c[1] thru c[_nC - 1] are set
     real mult = 1;
     int o = 0;
-    for (int l = 1; l < nC3_; ++l) { // l is index of C3[l]
-      int m = nC3_ - l - 1;          // order of polynomial in eps
+    for (int l = 1; l < _nC; ++l) { // l is index of C3[l]
+      int m = _nC - l - 1;          // order of polynomial in eps
       mult *= eps;
       c[l] = mult * Math::polyval(m, _C3x + o, eps);
       o += m + 1;
     }
-    // Post condition: o == nC3x_
+    // Post condition: o == (_nC * (_nC - 1)) / 2
   }
 
   void Geodesic::C4f(real eps, real c[]) const {
     // Evaluate C4 coeffs
-    // Elements c[0] thru c[nC4_ - 1] are set
+    // Elements c[0] thru c[_nC - 1] are set
     real mult = 1;
     int o = 0;
-    for (int l = 0; l < nC4_; ++l) { // l is index of C4[l]
-      int m = nC4_ - l - 1;          // order of polynomial in eps
+    for (int l = 0; l < _nC; ++l) { // l is index of C4[l]
+      int m = _nC - l - 1;          // order of polynomial in eps
       c[l] = mult * Math::polyval(m, _C4x + o, eps);
       o += m + 1;
       mult *= eps;
     }
-    // Post condition: o == nC4x_
+    // Post condition: o == (_nC * (_nC + 1)) / 2
   }
 
   // The static const coefficient arrays in the following functions are
@@ -856,9 +1637,14 @@ namespace GeographicLib {
   //
   // where N = GEOGRAPHICLIB_GEODESIC_ORDER
   //         = nA1 = nA2 = nC1 = nC1p = nA3 = nC4
+  //
+  // Expansions of a lower order N' (the order argument or _nC) are obtained
+  // by truncating these expansions; terms of total degree N' or higher in eps
+  // and n are dropped by skipping the leading coefficients of each
+  // polynomial.  With N' = N the results are unchanged.
 
   // The scale factor A1-1 = mean value of (d/dsigma)I1 - 1
-  Math::real Geodesic::A1m1f(real eps) {
+  const Math::real* Geodesic::A1m1table() {
     // Generated by Maxima on 2015-05-05 18:08:12-04:00
 #if GEOGRAPHICLIB_GEODESIC_ORDER/2 == 1
     static const real coeff[] = {
@@ -885,13 +1671,18 @@ namespace GeographicLib {
 #endif
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) == nA1_/2 + 2,
                                 "Coefficient array size mismatch in A1m1f");
-    int m = nA1_/2;
-    real t = Math::polyval(m, coeff, Math::sq(eps)) / coeff[m + 1];
+    return coeff;
+  }
+
+  Math::real Geodesic::A1m1f(real eps, int order) {
+    const real* coeff = A1m1table();
+    int m = nA1_/2, mt = order/2;
+    real t = Math::polyval(mt, coeff + (m - mt), Math::sq(eps)) / coeff[m + 1];
     return (t + eps) / (1 - eps);
   }
 
   // The coefficients C1[l] in the Fourier expansion of B1
-  void Geodesic::C1f(real eps, real c[]) {
+  const Math::real* Geodesic::C1table() {
     // Generated by Maxima on 2015-05-05 18:08:12-04:00
 #if GEOGRAPHICLIB_GEODESIC_ORDER == 3
     static const real coeff[] = {
@@ -983,13 +1774,21 @@ namespace GeographicLib {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) ==
                                 (nC1_*nC1_ + 7*nC1_ - 2*(nC1_/2)) / 4,
                                 "Coefficient array size mismatch in C1f");
+    return coeff;
+  }
+
+  void Geodesic::C1f(real eps, real c[], int order) {
+    const real* coeff = C1table();
     real
       eps2 = Math::sq(eps),
       d = eps;
     int o = 0;
-    for (int l = 1; l <= nC1_; ++l) { // l is index of C1p[l]
-      int m = (nC1_ - l) / 2;         // order of polynomial in eps^2
-      c[l] = d * Math::polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+    for (int l = 1; l <= order; ++l) { // l is index of C1p[l]
+      int
+        m = (nC1_ - l) / 2,      // order of polynomial in eps^2
+        mt = (order - l) / 2;  // order of truncated polynomial
+      c[l] = d * Math::polyval(mt, coeff + o + (m - mt), eps2)
+        / coeff[o + m + 1];
       o += m + 2;
       d *= eps;
     }
@@ -997,7 +1796,7 @@ namespace GeographicLib {
   }
 
   // The coefficients C1p[l] in the Fourier expansion of B1p
-  void Geodesic::C1pf(real eps, real c[]) {
+  const Math::real* Geodesic::C1ptable() {
     // Generated by Maxima on 2015-05-05 18:08:12-04:00
 #if GEOGRAPHICLIB_GEODESIC_ORDER == 3
     static const real coeff[] = {
@@ -1089,13 +1888,21 @@ namespace GeographicLib {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) ==
                                 (nC1p_*nC1p_ + 7*nC1p_ - 2*(nC1p_/2)) / 4,
                                 "Coefficient array size mismatch in C1pf");
+    return coeff;
+  }
+
+  void Geodesic::C1pf(real eps, real c[], int order) {
+    const real* coeff = C1ptable();
     real
       eps2 = Math::sq(eps),
       d = eps;
     int o = 0;
-    for (int l = 1; l <= nC1p_; ++l) { // l is index of C1p[l]
-      int m = (nC1p_ - l) / 2;         // order of polynomial in eps^2
-      c[l] = d * Math::polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+    for (int l = 1; l <= order; ++l) { // l is index of C1p[l]
+      int
+        m = (nC1p_ - l) / 2,      // order of polynomial in eps^2
+        mt = (order - l) / 2;  // order of truncated polynomial
+      c[l] = d * Math::polyval(mt, coeff + o + (m - mt), eps2)
+        / coeff[o + m + 1];
       o += m + 2;
       d *= eps;
     }
@@ -1103,7 +1910,7 @@ namespace GeographicLib {
   }
 
   // The scale factor A2-1 = mean value of (d/dsigma)I2 - 1
-  Math::real Geodesic::A2m1f(real eps) {
+  const Math::real* Geodesic::A2m1table() {
     // Generated by Maxima on 2015-05-05 18:08:12-04:00
 #if GEOGRAPHICLIB_GEODESIC_ORDER/2 == 1
     static const real coeff[] = {
@@ -1130,13 +1937,18 @@ namespace GeographicLib {
 #endif
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) == nA2_/2 + 2,
                                 "Coefficient array size mismatch in A2m1f");
-    int m = nA2_/2;
-    real t = Math::polyval(m, coeff, Math::sq(eps)) / coeff[m + 1];
+    return coeff;
+  }
+
+  Math::real Geodesic::A2m1f(real eps, int order) {
+    const real* coeff = A2m1table();
+    int m = nA2_/2, mt = order/2;
+    real t = Math::polyval(mt, coeff + (m - mt), Math::sq(eps)) / coeff[m + 1];
     return t * (1 - eps) - eps;
   }
 
   // The coefficients C2[l] in the Fourier expansion of B2
-  void Geodesic::C2f(real eps, real c[]) {
+  const Math::real* Geodesic::C2table() {
     // Generated by Maxima on 2015-05-05 18:08:12-04:00
 #if GEOGRAPHICLIB_GEODESIC_ORDER == 3
     static const real coeff[] = {
@@ -1228,13 +2040,21 @@ namespace GeographicLib {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) ==
                                 (nC2_*nC2_ + 7*nC2_ - 2*(nC2_/2)) / 4,
                                 "Coefficient array size mismatch in C2f");
+    return coeff;
+  }
+
+  void Geodesic::C2f(real eps, real c[], int order) {
+    const real* coeff = C2table();
     real
       eps2 = Math::sq(eps),
       d = eps;
     int o = 0;
-    for (int l = 1; l <= nC2_; ++l) { // l is index of C2[l]
-      int m = (nC2_ - l) / 2;         // order of polynomial in eps^2
-      c[l] = d * Math::polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+    for (int l = 1; l <= order; ++l) { // l is index of C2[l]
+      int
+        m = (nC2_ - l) / 2,      // order of polynomial in eps^2
+        mt = (order - l) / 2;  // order of truncated polynomial
+      c[l] = d * Math::polyval(mt, coeff + o + (m - mt), eps2)
+        / coeff[o + m + 1];
       o += m + 2;
       d *= eps;
     }
@@ -1337,10 +2157,14 @@ namespace GeographicLib {
     int o = 0, k = 0;
     for (int j = nA3_ - 1; j >= 0; --j) { // coeff of eps^j
       int m = min(nA3_ - j - 1, j);       // order of polynomial in n
-      _A3x[k++] = Math::polyval(m, coeff + o, _n) / coeff[o + m + 1];
+      if (j < _nC) {
+        int mt = min(_nC - j - 1, j);     // order of truncated polynomial
+        _A3x[k++] =
+          Math::polyval(mt, coeff + o + (m - mt), _n) / coeff[o + m + 1];
+      }
       o += m + 2;
     }
-    // Post condition: o == sizeof(coeff) / sizeof(real) && k == nA3x_
+    // Post condition: o == sizeof(coeff) / sizeof(real) && k == _nC
   }
 
   // The coefficients C3[l] in the Fourier expansion of B3
@@ -1542,11 +2366,16 @@ namespace GeographicLib {
     for (int l = 1; l < nC3_; ++l) {        // l is index of C3[l]
       for (int j = nC3_ - 1; j >= l; --j) { // coeff of eps^j
         int m = min(nC3_ - j - 1, j);       // order of polynomial in n
-        _C3x[k++] = Math::polyval(m, coeff + o, _n) / coeff[o + m + 1];
+        if (j < _nC) {
+          int mt = min(_nC - j - 1, j);     // order of truncated polynomial
+          _C3x[k++] =
+            Math::polyval(mt, coeff + o + (m - mt), _n) / coeff[o + m + 1];
+        }
         o += m + 2;
       }
     }
-    // Post condition: o == sizeof(coeff) / sizeof(real) && k == nC3x_
+    // Post condition: o == sizeof(coeff) / sizeof(real) &&
+    // k == (_nC * (_nC - 1)) / 2
   }
 
   void Geodesic::C4coeff() {
@@ -1811,11 +2640,16 @@ namespace GeographicLib {
     for (int l = 0; l < nC4_; ++l) {        // l is index of C4[l]
       for (int j = nC4_ - 1; j >= l; --j) { // coeff of eps^j
         int m = nC4_ - j - 1;               // order of polynomial in n
-        _C4x[k++] = Math::polyval(m, coeff + o, _n) / coeff[o + m + 1];
+        if (j < _nC) {
+          int mt = _nC - j - 1;             // order of truncated polynomial
+          _C4x[k++] =
+            Math::polyval(mt, coeff + o + (m - mt), _n) / coeff[o + m + 1];
+        }
         o += m + 2;
       }
     }
-    // Post condition: o == sizeof(coeff) / sizeof(real) && k == nC4x_
+    // Post condition: o == sizeof(coeff) / sizeof(real) &&
+    // k == (_nC * (_nC + 1)) / 2
   }
 
 } // namespace GeographicLib
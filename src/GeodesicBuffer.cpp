@@ -0,0 +1,243 @@
+/**
+ * \file GeodesicBuffer.cpp
+ * \brief Implementation for GeographicLib::GeodesicBuffer class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicBuffer.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // Copy the n points lat, lon to the vectors, omitting repeated points
+    // (including a last point equal to the first if closed).
+    void Distinct(const Math::real lat[], const Math::real lon[], size_t n,
+                  bool closed,
+                  vector<Math::real>& tlat, vector<Math::real>& tlon) {
+      tlat.clear(); tlon.clear();
+      for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && lat[i] == tlat.back() &&
+            Math::AngDiff(tlon.back(), lon[i]) == 0)
+          continue;
+        tlat.push_back(lat[i]); tlon.push_back(lon[i]);
+      }
+      if (closed && tlat.size() > 1 && tlat.back() == tlat[0] &&
+          Math::AngDiff(tlon.back(), tlon[0]) == 0) {
+        tlat.pop_back(); tlon.pop_back();
+      }
+    }
+
+    // Find the crossing of the chords of a curve with points [loa, hia] and
+    // a curve with points [lob, hib] (the arrays lat, lon), which is nearest
+    // (in terms of the number of chords) to hia and lob.  If there's a
+    // crossing, set hia and lob to trim the curves and return true.
+    bool Crossing(const GeodesicIntersect& inter,
+                  const Math::real lat[], const Math::real lon[],
+                  size_t& hia, size_t loa, size_t& lob, size_t hib,
+                  Math::real& xlat, Math::real& xlon) {
+      size_t
+        na = hia > loa ? hia - loa : 0,
+        nb = hib > lob ? hib - lob : 0;
+      if (na == 0 || nb == 0)
+        return false;
+      for (size_t r = 0; r < na + nb - 1; ++r) {
+        for (size_t i = r < nb ? 0 : r - nb + 1; i <= min(r, na - 1); ++i) {
+          size_t
+            ia = hia - 1 - i,   // chord [ia, ia+1] of curve a
+            ib = lob + r - i;   // chord [ib, ib+1] of curve b
+          if (inter.SegmentIntersect(lat[ia], lon[ia], lat[ia+1], lon[ia+1],
+                                     lat[ib], lon[ib], lat[ib+1], lon[ib+1],
+                                     xlat, xlon)) {
+            hia = ia; lob = ib + 1;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+  }
+
+  GeodesicBuffer::GeodesicBuffer(const Geodesic& earth,
+                                 real distance, real tolerance)
+    : _earth(earth)
+    , _inter(earth)
+    , _d(distance)
+    , _tol(tolerance)
+  {
+    // The spacings are found for a sphere of radius b, whose curvature is
+    // the largest Gaussian curvature of the ellipsoid.
+    real r = _earth.MajorRadius() * (1 - _earth.Flattening());
+    if (!(Math::isfinite(r) && r > 0))
+      throw GeographicErr("GeodesicBuffer requires an oblate ellipsoid");
+    if (!(_d > 0 && _d < Math::pi() / 2 * r))
+      throw GeographicErr("Buffer distance " + Utility::str(_d)
+                          + " is not in (0, pi*b/2)");
+    if (!(Math::isfinite(_tol) && _tol > 0))
+      throw GeographicErr("Buffer tolerance " + Utility::str(_tol)
+                          + " is not positive");
+    real d = _d / r;
+    // The curve at a distance d from a geodesic has geodesic curvature
+    // tan(d)/r; a chord of length l departs from a curve of curvature k by
+    // k l^2/8.  The distance along the curve is cos(d) times the distance
+    // along the geodesic.
+    _ds = sqrt(8 * _tol * r / tan(d)) / cos(d);
+    // A chord subtending an angle t at the center of the circle of radius d
+    // departs from the circle by r sin(d) (1 - cos(t/2)).  Use at least 8
+    // chords for a full circle.
+    real c = 1 - _tol / (r * sin(d));
+    _dazi = c > cos(real(22.5) * Math::degree()) ?
+      2 * acos(c) / Math::degree() : real(45);
+  }
+
+  void GeodesicBuffer::Circle(real lat, real lon,
+                              vector<real>& blat, vector<real>& blon) const {
+    // Counter-clockwise, i.e., with decreasing azimuth
+    int n = int(ceil(360 / _dazi));
+    vector<real> azi(n);
+    for (int i = 0; i < n; ++i)
+      azi[i] = -real(360) * i / n;
+    blat.resize(n); blon.resize(n);
+    _earth.DirectFan(lat, lon, &azi[0], n, &_d, 1, &blat[0], &blon[0], 0,
+                     Geodesic::LATITUDE | Geodesic::LONGITUDE);
+  }
+
+  void GeodesicBuffer::Outline(const vector<real>& lat,
+                               const vector<real>& lon, bool path,
+                               vector<real>& blat, vector<real>& blon,
+                               int nthreads) const {
+    // The ring of vertices lat, lon is traversed counter-clockwise, so the
+    // outline lies to the right of each edge k from vertex k to vertex k+1.
+    // If path, the joints at vertices 0 and n/2 are u-turns.
+    size_t n = lat.size();
+    vector<real> azi1(n), azi2(n);
+    // The points on the edges and their perpendicular azimuths
+    vector<real> plat, plon, pazi;
+    // Edge k gives points [first[k], first[k+1])
+    vector<size_t> first(n + 1);
+    for (size_t k = 0; k < n; ++k) {
+      size_t k1 = (k + 1) % n;
+      real s12;
+      _earth.Inverse(lat[k], lon[k], lat[k1], lon[k1], s12, azi1[k], azi2[k]);
+      int m = max(1, int(ceil(s12 / _ds)));
+      GeodesicLine l = _earth.Line(lat[k], lon[k], azi1[k],
+                                   Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                                   Geodesic::AZIMUTH | Geodesic::DISTANCE_IN);
+      first[k] = plat.size();
+      for (int j = 0; j <= m; ++j) {
+        real tlat, tlon, tazi;
+        if (j == 0) {
+          tlat = lat[k]; tlon = lon[k]; tazi = azi1[k];
+        } else if (j == m) {
+          tlat = lat[k1]; tlon = lon[k1]; tazi = azi2[k];
+        } else
+          l.Position(s12 * j / m, tlat, tlon, tazi);
+        plat.push_back(tlat); plon.push_back(tlon); pazi.push_back(tazi + 90);
+      }
+    }
+    first[n] = plat.size();
+    size_t np = plat.size();
+    // The points at distance D from the edges
+    vector<real> dist(np, _d), opos(2 * np);
+    real* olat = &opos[0];
+    real* olon = olat + np;
+    _earth.DirectBatch(&plat[0], &plon[0], &pazi[0], &dist[0], np,
+                       olat, olon, 0,
+                       Geodesic::LATITUDE | Geodesic::LONGITUDE, nthreads);
+    // The ranges [lo[k], hi[k]] of the points of edge k in the outline and
+    // the points [jfirst[k], jfirst[k+1]) of jlat, jlon to include before
+    // them at joint k (the arc or the crossing).
+    vector<size_t> lo(first.begin(), first.end() - 1), hi(n), jfirst(n + 1);
+    for (size_t k = 0; k < n; ++k)
+      hi[k] = first[k + 1] - 1;
+    vector<real> jlat, jlon;
+    for (size_t k = 0; k < n; ++k) {
+      jfirst[k] = jlat.size();
+      size_t k0 = (k + n - 1) % n;
+      real turn = path && (k == 0 || k == n/2) ? -real(180) :
+        Math::AngDiff(azi2[k0], azi1[k]);
+      if (turn < 0) {
+        // A left turn; join the curves with an arc about vertex k.
+        int m = int(ceil(-turn / _dazi));
+        if (m > 1) {
+          vector<real> azi(m - 1);
+          for (int i = 1; i < m; ++i)
+            azi[i - 1] = azi2[k0] + 90 + turn * i / m;
+          size_t j = jlat.size();
+          jlat.resize(j + m - 1); jlon.resize(j + m - 1);
+          _earth.DirectFan(lat[k], lon[k], &azi[0], m - 1, &_d, 1,
+                           &jlat[j], &jlon[j], 0,
+                           Geodesic::LATITUDE | Geodesic::LONGITUDE);
+        }
+      } else if (turn > 0) {
+        // A right turn; trim the curves at their intersection.
+        real xlat, xlon;
+        if (Crossing(_inter, olat, olon, hi[k0], lo[k0], lo[k], hi[k],
+                     xlat, xlon)) {
+          jlat.push_back(xlat); jlon.push_back(xlon);
+        }
+      } else
+        // Straight on; the first point of edge k is the same as the last
+        // point of edge k-1.
+        ++lo[k];
+    }
+    jfirst[n] = jlat.size();
+    blat.clear(); blon.clear();
+    for (size_t k = 0; k < n; ++k) {
+      for (size_t j = jfirst[k]; j < jfirst[k + 1]; ++j) {
+        blat.push_back(jlat[j]); blon.push_back(jlon[j]);
+      }
+      for (size_t i = lo[k]; i <= hi[k]; ++i) {
+        blat.push_back(olat[i]); blon.push_back(olon[i]);
+      }
+    }
+  }
+
+  void GeodesicBuffer::Polyline(const real lat[], const real lon[], size_t n,
+                                vector<real>& blat, vector<real>& blon,
+                                int nthreads) const {
+    vector<real> tlat, tlon;
+    Distinct(lat, lon, n, false, tlat, tlon);
+    if (tlat.size() == 0) {
+      blat.clear(); blon.clear();
+    } else if (tlat.size() == 1)
+      Circle(tlat[0], tlon[0], blat, blon);
+    else {
+      // Go out along the path and come back, so that the outline is to the
+      // right of the ring.
+      for (size_t i = tlat.size() - 1; i-- > 1;) {
+        tlat.push_back(tlat[i]); tlon.push_back(tlon[i]);
+      }
+      Outline(tlat, tlon, true, blat, blon, nthreads);
+    }
+  }
+
+  void GeodesicBuffer::Polygon(const real lat[], const real lon[], size_t n,
+                               vector<real>& blat, vector<real>& blon,
+                               int nthreads) const {
+    vector<real> tlat, tlon;
+    Distinct(lat, lon, n, true, tlat, tlon);
+    if (tlat.size() < 3) {
+      Polyline(tlat.empty() ? 0 : &tlat[0], tlon.empty() ? 0 : &tlon[0],
+               tlat.size(), blat, blon, nthreads);
+      return;
+    }
+    // Make the polygon counter-clockwise.
+    PolygonArea poly(_earth);
+    poly.AddPoints(&tlat[0], &tlon[0], tlat.size());
+    real perimeter, area;
+    poly.Compute(false, true, perimeter, area);
+    if (area < 0) {
+      reverse(tlat.begin(), tlat.end()); reverse(tlon.begin(), tlon.end());
+    }
+    Outline(tlat, tlon, false, blat, blon, nthreads);
+  }
+
+} // namespace GeographicLib
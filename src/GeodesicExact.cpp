@@ -27,7 +27,9 @@
  **********************************************************************/
 
 #include <GeographicLib/GeodesicExact.hpp>
+#include <map>
 #include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about potentially uninitialized local variables and
@@ -35,11 +37,23 @@
 #  pragma warning (disable: 4701 4127)
 #endif
 
+#if !defined(GEOGRAPHICLIB_GEODESICEXACT_CACHE_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEODESICEXACT_CACHE_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_GEODESICEXACT_CACHE_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEODESICEXACT_CACHE_THREADSAFE
+#  include <mutex>
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
-  GeodesicExact::GeodesicExact(real a, real f)
+  GeodesicExact::GeodesicExact(real a, real f, int order)
     : maxit2_(maxit1_ + Math::digits() + 10)
       // Underflow guard.  We require
       //   tiny_ * epsilon() > 0
@@ -83,11 +97,16 @@ namespace GeographicLib {
       // spherical case.
     , _etol2(0.1 * tol2_ /
              sqrt( max(real(0.001), abs(_f)) * min(real(1), 1 - _f/2) / 2 ))
+    , _nC4(order)
   {
     if (!(Math::isfinite(_a) && _a > 0))
       throw GeographicErr("Major radius is not positive");
     if (!(Math::isfinite(_b) && _b > 0))
       throw GeographicErr("Minor radius is not positive");
+    if (!(_nC4 >= 6 && _nC4 <= GEOGRAPHICLIB_GEODESICEXACT_ORDER))
+      throw GeographicErr("Order of expansion not in [6, "
+                          + Utility::str(GEOGRAPHICLIB_GEODESICEXACT_ORDER)
+                          + "]");
     C4coeff();
   }
 
@@ -97,6 +116,22 @@ namespace GeographicLib {
     return wgs84;
   }
 
+  const GeodesicExact& GeodesicExact::Cached(real a, real f) {
+    typedef map<pair<real, real>, GeodesicExact> cache_t;
+    static cache_t cache;
+#if GEOGRAPHICLIB_GEODESICEXACT_CACHE_THREADSAFE
+    static mutex cachemutex;
+    lock_guard<mutex> lock(cachemutex);
+#endif
+    pair<real, real> key(a, f);
+    cache_t::iterator i = cache.find(key);
+    if (i == cache.end())
+      // The constructor throws for invalid (and NaN) a and f so these aren't
+      // inserted.
+      i = cache.insert(make_pair(key, GeodesicExact(a, f))).first;
+    return i->second;
+  }
+
   Math::real GeodesicExact::CosSeries(real sinx, real cosx,
                                       const real c[], int n) {
     // Evaluate
@@ -425,8 +460,8 @@ namespace GeographicLib {
         real C4a[nC4_];
         C4f(eps, C4a);
         real
-          B41 = CosSeries(ssig1, csig1, C4a, nC4_),
-          B42 = CosSeries(ssig2, csig2, C4a, nC4_);
+          B41 = CosSeries(ssig1, csig1, C4a, _nC4),
+          B42 = CosSeries(ssig2, csig2, C4a, _nC4);
         S12 = A4 * (B42 - B41);
       } else
         // Avoid problems with indeterminate sig1, sig2 on equator
@@ -484,6 +519,35 @@ namespace GeographicLib {
     return a12;
   }
 
+  void GeodesicExact::GenInverseBatch(const real* lat1, const real* lon1,
+                                      const real* lat2, const real* lon2,
+                                      size_t n, unsigned outmask,
+                                      real* s12, real* azi1, real* azi2,
+                                      real* m12, real* M12, real* M21,
+                                      real* S12, real* a12) const {
+    outmask &= OUT_MASK;
+    // Solve each problem with GenInverse (so that the results are identical
+    // to the scalar path) and scatter the results into the requested arrays.
+    bool
+      distp = (outmask & DISTANCE) != 0U,
+      azip = (outmask & AZIMUTH) != 0U,
+      redlp = (outmask & REDUCEDLENGTH) != 0U,
+      scalep = (outmask & GEODESICSCALE) != 0U,
+      areap = (outmask & AREA) != 0U,
+      arcp = a12 != 0;
+    real ts12, tazi1, tazi2, tm12, tM12, tM21, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      real ta12 = GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], outmask,
+                             ts12, tazi1, tazi2, tm12, tM12, tM21, tS12);
+      if (distp) s12[i] = ts12;
+      if (azip) { azi1[i] = tazi1; azi2[i] = tazi2; }
+      if (redlp) m12[i] = tm12;
+      if (scalep) { M12[i] = tM12; M21[i] = tM21; }
+      if (areap) S12[i] = tS12;
+      if (arcp) a12[i] = ta12;
+    }
+  }
+
   void GeodesicExact::Lengths(const EllipticFunction& E,
                               real sig12,
                               real ssig1, real csig1, real dn1,
@@ -825,18 +889,16 @@ namespace GeographicLib {
 
   void GeodesicExact::C4f(real eps, real c[]) const {
     // Evaluate C4 coeffs
-    // Elements c[0] thru c[nC4_ - 1] are set
+    // Elements c[0] thru c[_nC4 - 1] are set
     real mult = 1;
     int o = 0;
-    for (int l = 0; l < nC4_; ++l) { // l is index of C4[l]
-      int m = nC4_ - l - 1;          // order of polynomial in eps
+    for (int l = 0; l < _nC4; ++l) { // l is index of C4[l]
+      int m = _nC4 - l - 1;          // order of polynomial in eps
       c[l] = mult * Math::polyval(m, _C4x + o, eps);
       o += m + 1;
       mult *= eps;
     }
-    // Post condition: o == nC4x_
-    if  (!(o == nC4x_))
-      throw GeographicErr("C4 misalignment");
+    // Post condition: o == (_nC4 * (_nC4 + 1)) / 2
   }
 
 } // namespace GeographicLib
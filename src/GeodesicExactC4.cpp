@@ -24,7 +24,14 @@ namespace GeographicLib {
   // 0x2af9eaf25d * 2^52 + 0x149c52a73ee6d which is less than 2^90.
   // Both a and b are less that 2^52 and so are exactly representable by
   // doubles; then the computation of the full double coefficient involves only
-  // a single rounding operation.
+  // a single rounding operation.  (Float coefficients will suffer double
+  // rounding; however the accuracy is already lousy for floats.)
+  //
+  // reale is a macro (instead of a function calling ldexp) so that the
+  // elements of coeff are constant expressions.  This allows the compiler to
+  // initialize the array statically instead of generating code to fill it in
+  // on the first call to C4coeff (about 70 kB for doubles).
+#define reale(hi, lo) (real(hi) * real(4503599627370496.0) + real(lo))
 
   void GeodesicExact::C4coeff() {
     // Generated by Maxima on 2015-05-05 17:18:06-04:00
@@ -7863,17 +7870,28 @@ namespace GeographicLib {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(coeff) / sizeof(real) ==
                                 (nC4_ * (nC4_ + 1) * (nC4_ + 5)) / 6,
                                 "Coefficient array size mismatch in C4coeff");
+    // The expansion of a lower order _nC4 is obtained by dropping the terms
+    // of total degree _nC4 or higher in eps and n, i.e., by skipping the
+    // leading coefficients of each polynomial (as in Geodesic).
     int o = 0, k = 0;
     for (int l = 0; l < nC4_; ++l) {        // l is index of C4[l]
       for (int j = nC4_ - 1; j >= l; --j) { // coeff of eps^j
         int m = nC4_ - j - 1;               // order of polynomial in n
-        _C4x[k++] = Math::polyval(m, coeff + o, _n) / coeff[o + m + 1];
+        if (j < _nC4) {
+          int mt = _nC4 - j - 1;            // order of truncated polynomial
+          _C4x[k++] =
+            Math::polyval(mt, coeff + o + (m - mt), _n) / coeff[o + m + 1];
+        }
         o += m + 2;
       }
     }
-    // Post condition: o == sizeof(coeff) / sizeof(real) && k == nC4x_
-    if  (!(o == sizeof(coeff) / sizeof(real) && k == nC4x_))
+    // Post condition: o == sizeof(coeff) / sizeof(real) &&
+    // k == (_nC4 * (_nC4 + 1)) / 2
+    if  (!(o == sizeof(coeff) / sizeof(real) &&
+           k == (_nC4 * (_nC4 + 1)) / 2))
       throw GeographicErr("C4 misalignment");
   }
 
+#undef reale
+
 } // namespace GeographicLib
@@ -0,0 +1,291 @@
+/**
+ * \file GeodesicIndex.cpp
+ * \brief Implementation for GeographicLib::GeodesicIndex class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicIndex.hpp>
+#include <algorithm>
+#include <limits>
+#include <GeographicLib/Instrumentation.hpp>
+
+#if !defined(GEOGRAPHICLIB_GEODESICINDEX_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEODESICINDEX_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GEODESICINDEX_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEODESICINDEX_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    typedef Math::real real;
+
+    // Order points by one of their geocentric coordinates.
+    class CoordLess {
+    private:
+      const real* _xyz;
+      int _d;
+    public:
+      CoordLess(const real* xyz, int d) : _xyz(xyz), _d(d) {}
+      bool operator()(size_t a, size_t b) const
+      { return _xyz[3 * a + _d] < _xyz[3 * b + _d]; }
+    };
+
+    // The results of GeodesicIndex::Nearest are ordered by distance and then
+    // by index.
+    inline bool Before(real s1, size_t i1, real s2, size_t i2)
+    { return s1 < s2 || (s1 == s2 && i1 < i2); }
+
+    // ind[0..n-1] and s12[0..n-1] are a heap with the last result at the
+    // top.  Move the element at position k down to restore the heap.
+    void SiftDown(size_t ind[], real s12[], size_t n, size_t k) {
+      size_t i = ind[k]; real s = s12[k];
+      for (;;) {
+        size_t c = 2 * k + 1;
+        if (c >= n) break;
+        if (c + 1 < n && Before(s12[c], ind[c], s12[c + 1], ind[c + 1])) ++c;
+        if (!Before(s, i, s12[c], ind[c])) break;
+        ind[k] = ind[c]; s12[k] = s12[c];
+        k = c;
+      }
+      ind[k] = i; s12[k] = s;
+    }
+
+    // Add an element at position n to the heap ind[0..n-1], s12[0..n-1].
+    void SiftUp(size_t ind[], real s12[], size_t n) {
+      size_t k = n, i = ind[k]; real s = s12[k];
+      while (k > 0) {
+        size_t p = (k - 1) / 2;
+        if (!Before(s12[p], ind[p], s, i)) break;
+        ind[k] = ind[p]; s12[k] = s12[p];
+        k = p;
+      }
+      ind[k] = i; s12[k] = s;
+    }
+  }
+
+  GeodesicIndex::GeodesicIndex(const Geodesic& earth,
+                               const real lat[], const real lon[], size_t n)
+    : _earth(earth)
+    , _cart(earth.MajorRadius(), earth.Flattening())
+    , _n(n)
+    , _tol(64 * numeric_limits<real>::epsilon())
+    , _slack(_tol * earth.MajorRadius() * max(real(1),
+                                              1 - earth.Flattening()))
+  {
+    // While the tree is built, _xyz is indexed by the original index and
+    // _ind is permuted into tree order.
+    _xyz.resize(3 * _n);
+    _ind.reserve(_n);
+    for (size_t i = 0; i < _n; ++i) {
+      if (!(Math::isfinite(lat[i]) && Math::isfinite(lon[i])))
+        continue;
+      _cart.Forward(lat[i], lon[i], 0,
+                    _xyz[3 * i], _xyz[3 * i + 1], _xyz[3 * i + 2]);
+      _ind.push_back(i);
+    }
+    if (!_ind.empty())
+      Build(0, _ind.size());
+    vector<real> xyz(3 * _ind.size());
+    _pts.reserve(_ind.size());
+    for (size_t j = 0; j < _ind.size(); ++j) {
+      size_t i = _ind[j];
+      for (int d = 0; d < 3; ++d)
+        xyz[3 * j + d] = _xyz[3 * i + d];
+      _pts.push_back(Geodesic::Point(_earth, lat[i], lon[i]));
+    }
+    _xyz.swap(xyz);
+  }
+
+  size_t GeodesicIndex::Build(size_t i0, size_t i1) {
+    size_t k = _nodes.size();
+    _nodes.push_back(Node());
+    Node node;
+    node.i0 = i0; node.i1 = i1;
+    node.left = node.right = 0;
+    for (int d = 0; d < 3; ++d) {
+      node.lo[d] = node.hi[d] = _xyz[3 * _ind[i0] + d];
+      for (size_t j = i0 + 1; j < i1; ++j) {
+        real x = _xyz[3 * _ind[j] + d];
+        node.lo[d] = min(node.lo[d], x);
+        node.hi[d] = max(node.hi[d], x);
+      }
+    }
+    if (i1 - i0 > leafsize_) {
+      // Split at the median of the coordinate with the largest extent.
+      int dim = 0;
+      for (int d = 1; d < 3; ++d)
+        if (node.hi[d] - node.lo[d] > node.hi[dim] - node.lo[dim])
+          dim = d;
+      size_t im = i0 + (i1 - i0) / 2;
+      nth_element(_ind.begin() + i0, _ind.begin() + im, _ind.begin() + i1,
+                  CoordLess(&_xyz[0], dim));
+      node.left = Build(i0, im);
+      node.right = Build(im, i1);
+    }
+    _nodes[k] = node;
+    return k;
+  }
+
+  Math::real GeodesicIndex::Bound(const Node& node, const real q[]) const {
+    // The distance from q to the bounding box, reduced to allow for
+    // roundoff.
+    real d2 = 0;
+    for (int d = 0; d < 3; ++d) {
+      real t = max(max(node.lo[d] - q[d], q[d] - node.hi[d]), real(0));
+      d2 += t * t;
+    }
+    using std::sqrt;
+    return sqrt(d2) * (1 - _tol) - _slack;
+  }
+
+  Math::real GeodesicIndex::Chord(size_t i, const real q[]) const {
+    const real* x = &_xyz[3 * i];
+    using std::sqrt;
+    return sqrt(Math::sq(x[0] - q[0]) + Math::sq(x[1] - q[1]) +
+                Math::sq(x[2] - q[2])) * (1 - _tol) - _slack;
+  }
+
+  Math::real GeodesicIndex::Distance(const Geodesic::Point& p, size_t i)
+    const {
+    GEOGRAPHICLIB_COUNT(GEODESICINDEX_INVERSE);
+    real s12, t;
+    _earth.GenInverse(p, _pts[i], Geodesic::DISTANCE,
+                      s12, t, t, t, t, t, t);
+    return s12;
+  }
+
+  void GeodesicIndex::NearestNode(size_t k, const Geodesic::Point& p,
+                                  const real q[], size_t m, size_t& count,
+                                  size_t ind[], real s12[]) const {
+    const Node& node = _nodes[k];
+    if (node.left) {
+      // Visit the nearer child first, and skip the children which can't
+      // include a point closer than the current m'th.
+      real
+        bl = Bound(_nodes[node.left], q),
+        br = Bound(_nodes[node.right], q);
+      size_t
+        first = bl <= br ? node.left : node.right,
+        second = bl <= br ? node.right : node.left;
+      real bs = min(bl, br), bt = max(bl, br);
+      if (!(count == m && bs > s12[0]))
+        NearestNode(first, p, q, m, count, ind, s12);
+      if (!(count == m && bt > s12[0]))
+        NearestNode(second, p, q, m, count, ind, s12);
+      return;
+    }
+    for (size_t i = node.i0; i < node.i1; ++i) {
+      if (count == m && Chord(i, q) > s12[0])
+        continue;
+      real s = Distance(p, i);
+      size_t j = _ind[i];
+      if (count < m) {
+        ind[count] = j; s12[count] = s;
+        SiftUp(ind, s12, count);
+        ++count;
+      } else if (Before(s, j, s12[0], ind[0])) {
+        ind[0] = j; s12[0] = s;
+        SiftDown(ind, s12, count, 0);
+      }
+    }
+  }
+
+  size_t GeodesicIndex::Nearest(real lat, real lon, size_t m,
+                                size_t ind[], real s12[]) const {
+    if (m == 0 || _nodes.empty() ||
+        !(Math::isfinite(lat) && Math::isfinite(lon)))
+      return 0;
+    Geodesic::Point p(_earth, lat, lon);
+    real q[3];
+    _cart.Forward(lat, lon, 0, q[0], q[1], q[2]);
+    size_t count = 0;
+    NearestNode(0, p, q, m, count, ind, s12);
+    // Sort the heap into increasing order.
+    for (size_t c = count; c > 1; --c) {
+      swap(ind[0], ind[c - 1]); swap(s12[0], s12[c - 1]);
+      SiftDown(ind, s12, c - 1, 0);
+    }
+    return count;
+  }
+
+  void GeodesicIndex::WithinNode(size_t k, const Geodesic::Point& p,
+                                 const real q[], real r,
+                                 vector< pair<real, size_t> >& res) const {
+    const Node& node = _nodes[k];
+    if (Bound(node, q) > r)
+      return;
+    if (node.left) {
+      WithinNode(node.left, p, q, r, res);
+      WithinNode(node.right, p, q, r, res);
+      return;
+    }
+    for (size_t i = node.i0; i < node.i1; ++i) {
+      if (Chord(i, q) > r)
+        continue;
+      real s = Distance(p, i);
+      if (s <= r)
+        res.push_back(make_pair(s, _ind[i]));
+    }
+  }
+
+  size_t GeodesicIndex::Within(real lat, real lon, real r,
+                               vector<size_t>& ind, vector<real>& s12) const {
+    ind.clear(); s12.clear();
+    if (_nodes.empty() ||
+        !(Math::isfinite(lat) && Math::isfinite(lon) && r >= 0))
+      return 0;
+    Geodesic::Point p(_earth, lat, lon);
+    real q[3];
+    _cart.Forward(lat, lon, 0, q[0], q[1], q[2]);
+    vector< pair<real, size_t> > res;
+    WithinNode(0, p, q, r, res);
+    sort(res.begin(), res.end());
+    ind.resize(res.size()); s12.resize(res.size());
+    for (size_t i = 0; i < res.size(); ++i) {
+      s12[i] = res[i].first; ind[i] = res[i].second;
+    }
+    return res.size();
+  }
+
+  void GeodesicIndex::NearestRange(const real lat[], const real lon[],
+                                   size_t i0, size_t i1, size_t m,
+                                   size_t ind[], real s12[]) const {
+    for (size_t i = i0; i < i1; ++i) {
+      size_t* indi = ind + i * m;
+      real* s12i = s12 + i * m;
+      for (size_t j = Nearest(lat[i], lon[i], m, indi, s12i); j < m; ++j) {
+        indi[j] = _n; s12i[j] = Math::NaN();
+      }
+    }
+  }
+
+  void GeodesicIndex::NearestBatch(const real lat[], const real lon[],
+                                   size_t n, size_t m,
+                                   size_t ind[], real s12[],
+                                   int nthreads) const {
+#if GEOGRAPHICLIB_GEODESICINDEX_THREADS
+    // Divide the query points into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    NearestRange(lat, lon, i0, i1, m, ind, s12);
+                  });
+#else
+    (void)nthreads;
+    NearestRange(lat, lon, 0, n, m, ind, s12);
+#endif
+  }
+
+} // namespace GeographicLib
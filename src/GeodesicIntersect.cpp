@@ -0,0 +1,181 @@
+/**
+ * \file GeodesicIntersect.cpp
+ * \brief Implementation for GeographicLib::GeodesicIntersect class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicIntersect.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicIntersect::GeodesicIntersect(const Geodesic& earth)
+    : eps_(real(0.01) * sqrt(numeric_limits<real>::epsilon()))
+    , _earth(earth)
+    , _gnom(earth)
+    , _a(_earth.MajorRadius())
+    , _e2(_earth.Flattening() * (2 - _earth.Flattening()))
+  {}
+
+  void GeodesicIntersect::Cartesian(real lat, real lon, real r[]) const {
+    real sphi, cphi, slam, clam;
+    Math::sincosd(lat, sphi, cphi);
+    Math::sincosd(lon, slam, clam);
+    real n = _a / sqrt(1 - _e2 * Math::sq(sphi));
+    r[0] = n * cphi * clam;
+    r[1] = n * cphi * slam;
+    r[2] = n * (1 - _e2) * sphi;
+  }
+
+  Math::real GeodesicIntersect::Chord(real lat1, real lon1,
+                                      real lat2, real lon2) const {
+    real r1[3], r2[3];
+    Cartesian(lat1, lon1, r1);
+    Cartesian(lat2, lon2, r2);
+    return Math::hypot(Math::hypot(r2[0] - r1[0], r2[1] - r1[1]),
+                       r2[2] - r1[2]);
+  }
+
+  Math::real GeodesicIntersect::Centroid(const real lon[], int n) {
+    // Average the longitudes relative to the first one to avoid problems
+    // with the branch cut at 180 degrees.
+    real lon0 = Math::AngNormalize(lon[0]), d = 0;
+    for (int i = 1; i < n; ++i)
+      d += Math::AngDiff(lon0, Math::AngNormalize(lon[i]));
+    return lon0 + d / n;
+  }
+
+  bool GeodesicIntersect::Solve(const real lat[], const real lon[],
+                                real& lat0, real& lon0,
+                                real x[], real y[]) const {
+    for (int i = 0; i < maxit_; ++i) {
+      _gnom.ForwardBatch(lat0, lon0, lat, lon, 4, x, y);
+      // The lines through the projected points and their intersection in
+      // homogeneous coordinates.  Scale by 1/a to keep the products of
+      // modest size.
+      real
+        xa1 = x[0] / _a, ya1 = y[0] / _a, xa2 = x[1] / _a, ya2 = y[1] / _a,
+        xb1 = x[2] / _a, yb1 = y[2] / _a, xb2 = x[3] / _a, yb2 = y[3] / _a,
+        ua = ya1 - ya2, va = xa2 - xa1, wa = xa1 * ya2 - xa2 * ya1,
+        ub = yb1 - yb2, vb = xb2 - xb1, wb = xb1 * yb2 - xb2 * yb1,
+        w = ua * vb - va * ub;
+      // Reversed test to catch NaNs (points over the horizon) and parallel
+      // lines.
+      if (!(abs(w) > 0))
+        return false;
+      real
+        xi = _a * (va * wb - wa * vb) / w,
+        yi = _a * (wa * ub - ua * wb) / w,
+        lat1, lon1;
+      _gnom.Reverse(lat0, lon0, xi, yi, lat1, lon1);
+      if (Math::isnan(lat1))
+        return false;
+      lat0 = lat1; lon0 = lon1;
+      // Shift the projected points so that they are (approximately)
+      // relative to the new center.
+      for (int k = 0; k < 4; ++k) {
+        x[k] -= xi; y[k] -= yi;
+      }
+      if (Math::hypot(xi, yi) < eps_ * _a)
+        return true;
+    }
+    return false;
+  }
+
+  bool GeodesicIntersect::Intersect(real latA1, real lonA1,
+                                    real latA2, real lonA2,
+                                    real latB1, real lonB1,
+                                    real latB2, real lonB2,
+                                    real& lat, real& lon) const {
+    real
+      lats[] = {latA1, latA2, latB1, latB2},
+      lons[] = {lonA1, lonA2, lonB1, lonB2},
+      x[4], y[4];
+    lat = (latA1 + latA2 + latB1 + latB2) / 4;
+    lon = Centroid(lons, 4);
+    if (Solve(lats, lons, lat, lon, x, y))
+      return true;
+    lat = lon = Math::NaN();
+    return false;
+  }
+
+  bool GeodesicIntersect::SegmentIntersect(real latA1, real lonA1,
+                                           real latA2, real lonA2,
+                                           real latB1, real lonB1,
+                                           real latB2, real lonB2,
+                                           real& lat, real& lon) const {
+    real sA, sB;
+    _earth.Inverse(latA1, lonA1, latA2, lonA2, sA);
+    _earth.Inverse(latB1, lonB1, latB2, lonB2, sB);
+    lat = lon = Math::NaN();
+    // Each segment lies within a distance of its length from its first end
+    // and the chord is shorter than the geodesic; skip the iteration if the
+    // segments are too far apart.  Reversed test to catch NaNs.
+    if (!(Chord(latA1, lonA1, latB1, lonB1) <= sA + sB))
+      return false;
+    real
+      lats[] = {latA1, latA2, latB1, latB2},
+      lons[] = {lonA1, lonA2, lonB1, lonB2},
+      x[4], y[4], lat0 = (latA1 + latA2 + latB1 + latB2) / 4,
+      lon0 = Centroid(lons, 4);
+    if (!Solve(lats, lons, lat0, lon0, x, y))
+      return false;
+    // The intersection, at the origin, lies on a segment if the ends are on
+    // opposite sides of the origin (or an end is within the convergence
+    // tolerance of the origin).
+    real tol = eps_ * _a;
+    for (int k = 0; k < 4; k += 2)
+      if (!(x[k] * x[k+1] + y[k] * y[k+1] <= 0 ||
+            Math::hypot(x[k], y[k]) < tol ||
+            Math::hypot(x[k+1], y[k+1]) < tol))
+        return false;
+    lat = lat0; lon = lon0;
+    return true;
+  }
+
+  Math::real GeodesicIntersect::Nearest(real lat1, real lon1,
+                                        real lat2, real lon2,
+                                        real lat, real lon, bool segment,
+                                        real& latn, real& lonn) const {
+    real
+      lats[] = {lat1, lat2, lat},
+      lons[] = {lon1, lon2, lon},
+      x[3], y[3], t = 0;
+    // Start with the given point as the center.  For a sphere, the first
+    // iteration then gives the exact result.
+    latn = lat; lonn = lon;
+    for (int i = 0; i < maxit_; ++i) {
+      _gnom.ForwardBatch(latn, lonn, lats, lons, 3, x, y);
+      // The foot of the perpendicular from the given point to the line.
+      real
+        dx = x[1] - x[0], dy = y[1] - y[0], d2 = Math::sq(dx) + Math::sq(dy);
+      t = d2 > 0 ? ((x[2] - x[0]) * dx + (y[2] - y[0]) * dy) / d2 : 0;
+      if (segment)
+        t = min(max(t, real(0)), real(1));
+      real xf = x[0] + t * dx, yf = y[0] + t * dy, lat0, lon0;
+      _gnom.Reverse(latn, lonn, xf, yf, lat0, lon0);
+      // Reversed test to catch NaNs
+      if (!(Math::hypot(xf, yf) >= eps_ * _a)) {
+        if (Math::isnan(lat0)) break;
+        latn = lat0; lonn = lon0;
+        // Return the ends of a segment exactly
+        if (segment && t == 0) {
+          latn = lat1; lonn = Math::AngNormalize(lon1);
+        } else if (segment && t == 1) {
+          latn = lat2; lonn = Math::AngNormalize(lon2);
+        }
+        real s;
+        _earth.Inverse(lat, lon, latn, lonn, s);
+        return s;
+      }
+      latn = lat0; lonn = lon0;
+    }
+    latn = lonn = Math::NaN();
+    return Math::NaN();
+  }
+
+} // namespace GeographicLib
@@ -36,6 +36,7 @@ namespace GeographicLib {
                              real lat1, real lon1, real azi1,
                              unsigned caps)
     : tiny_(g.tiny_)
+    , _nC(g._nC)
     , _lat1(lat1)
     , _lon1(lon1)
     // Guard against underflow in salp0.  Also -0 is converted to +0.
@@ -84,37 +85,51 @@ namespace GeographicLib {
     real eps = _k2 / (2 * (1 + sqrt(1 + _k2)) + _k2);
 
     if (_caps & CAP_C1) {
-      _A1m1 = Geodesic::A1m1f(eps);
-      Geodesic::C1f(eps, _C1a);
-      _B11 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C1a, nC1_);
-      real s = sin(_B11), c = cos(_B11);
-      // tau1 = sig1 + B11
-      _stau1 = _ssig1 * c + _csig1 * s;
-      _ctau1 = _csig1 * c - _ssig1 * s;
-      // Not necessary because C1pa reverts C1a
-      //    _B11 = -SinCosSeries(true, _stau1, _ctau1, _C1pa, nC1p_);
+      _A1m1 = Geodesic::A1m1f(eps, _nC);
+      Geodesic::C1f(eps, _C1a, _nC);
     }
 
     if (_caps & CAP_C1p)
-      Geodesic::C1pf(eps, _C1pa);
+      Geodesic::C1pf(eps, _C1pa, _nC);
 
     if (_caps & CAP_C2) {
-      _A2m1 = Geodesic::A2m1f(eps);
-      Geodesic::C2f(eps, _C2a);
-      _B21 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C2a, nC2_);
+      _A2m1 = Geodesic::A2m1f(eps, _nC);
+      Geodesic::C2f(eps, _C2a, _nC);
     }
 
     if (_caps & CAP_C3) {
       g.C3f(eps, _C3a);
       _A3c = -_f * _salp0 * g.A3f(eps);
-      _B31 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C3a, nC3_-1);
     }
 
-    if (_caps & CAP_C4) {
+    if (_caps & CAP_C4)
       g.C4f(eps, _C4a);
+
+    InitSums(g);
+  }
+
+  void GeodesicLine::InitSums(const Geodesic& g) {
+    // Evaluate the series at point 1; the coefficients have been set.
+    if (_caps & CAP_C1) {
+      _B11 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C1a, _nC);
+      real s = sin(_B11), c = cos(_B11);
+      // tau1 = sig1 + B11
+      _stau1 = _ssig1 * c + _csig1 * s;
+      _ctau1 = _csig1 * c - _ssig1 * s;
+      // Not necessary because C1pa reverts C1a
+      //    _B11 = -SinCosSeries(true, _stau1, _ctau1, _C1pa, nC1p_);
+    }
+
+    if (_caps & CAP_C2)
+      _B21 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C2a, _nC);
+
+    if (_caps & CAP_C3)
+      _B31 = Geodesic::SinCosSeries(true, _ssig1, _csig1, _C3a, _nC-1);
+
+    if (_caps & CAP_C4) {
       // Multiplier = a^2 * e^2 * cos(alpha0) * sin(alpha0)
       _A4 = Math::sq(_a) * _calp0 * _salp0 * g._e2;
-      _B41 = Geodesic::SinCosSeries(false, _ssig1, _csig1, _C4a, nC4_);
+      _B41 = Geodesic::SinCosSeries(false, _ssig1, _csig1, _C4a, _nC);
     }
   }
 
@@ -131,7 +146,7 @@ namespace GeographicLib {
       return Math::NaN();
 
     // Avoid warning about uninitialized B12.
-    real sig12, ssig12, csig12, B12 = 0, AB1 = 0;
+    real sig12, ssig12, csig12, B12 = 0;
     if (arcmode) {
       // Interpret s12_a12 as spherical arc length
       sig12 = s12_a12 * Math::degree();
@@ -141,50 +156,73 @@ namespace GeographicLib {
       csig12 = s12a == 90 ? 0 : cos(sig12);
     } else {
       // Interpret s12_a12 as distance
+      real tau12 = s12_a12 / (_b * (1 + _A1m1));
+      DistanceToArc(s12_a12, sin(tau12), cos(tau12),
+                    sig12, ssig12, csig12, B12);
+    }
+
+    return GenPosition(arcmode, s12_a12, sig12, ssig12, csig12, B12, outmask,
+                       lat2, lon2, azi2, s12, m12, M12, M21, S12);
+  }
+
+  void GeodesicLine::DistanceToArc(real s12, real stau12, real ctau12,
+                                   real& sig12, real& ssig12, real& csig12,
+                                   real& B12) const {
+    // Find the arc length sig12 for the distance s12; stau12 and ctau12 are
+    // the sine and cosine of tau12 = s12 / (_b * (1 + _A1m1)).
+    real tau12 = s12 / (_b * (1 + _A1m1));
+    // tau2 = tau1 + tau12
+    B12 = - Geodesic::SinCosSeries(true,
+                                   _stau1 * ctau12 + _ctau1 * stau12,
+                                   _ctau1 * ctau12 - _stau1 * stau12,
+                                   _C1pa, _nC);
+    sig12 = tau12 - (B12 - _B11);
+    ssig12 = sin(sig12); csig12 = cos(sig12);
+    if (abs(_f) > 0.01) {
+      // Reverted distance series is inaccurate for |f| > 1/100, so correct
+      // sig12 with 1 Newton iteration.  The following table shows the
+      // approximate maximum error for a = WGS_a() and various f relative to
+      // GeodesicExact.
+      //     erri = the error in the inverse solution (nm)
+      //     errd = the error in the direct solution (series only) (nm)
+      //     errda = the error in the direct solution (series + 1 Newton) (nm)
+      //
+      //       f     erri  errd errda
+      //     -1/5    12e6 1.2e9  69e6
+      //     -1/10  123e3  12e6 765e3
+      //     -1/20   1110 108e3  7155
+      //     -1/50  18.63 200.9 27.12
+      //     -1/100 18.63 23.78 23.37
+      //     -1/150 18.63 21.05 20.26
+      //      1/150 22.35 24.73 25.83
+      //      1/100 22.35 25.03 25.31
+      //      1/50  29.80 231.9 30.44
+      //      1/20   5376 146e3  10e3
+      //      1/10  829e3  22e6 1.5e6
+      //      1/5   157e6 3.8e9 280e6
       real
-        tau12 = s12_a12 / (_b * (1 + _A1m1)),
-        s = sin(tau12),
-        c = cos(tau12);
-      // tau2 = tau1 + tau12
-      B12 = - Geodesic::SinCosSeries(true,
-                                     _stau1 * c + _ctau1 * s,
-                                     _ctau1 * c - _stau1 * s,
-                                     _C1pa, nC1p_);
-      sig12 = tau12 - (B12 - _B11);
+        ssig2 = _ssig1 * csig12 + _csig1 * ssig12,
+        csig2 = _csig1 * csig12 - _ssig1 * ssig12;
+      B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _C1a, _nC);
+      real serr = (1 + _A1m1) * (sig12 + (B12 - _B11)) - s12 / _b;
+      sig12 = sig12 - serr / sqrt(1 + _k2 * Math::sq(ssig2));
       ssig12 = sin(sig12); csig12 = cos(sig12);
-      if (abs(_f) > 0.01) {
-        // Reverted distance series is inaccurate for |f| > 1/100, so correct
-        // sig12 with 1 Newton iteration.  The following table shows the
-        // approximate maximum error for a = WGS_a() and various f relative to
-        // GeodesicExact.
-        //     erri = the error in the inverse solution (nm)
-        //     errd = the error in the direct solution (series only) (nm)
-        //     errda = the error in the direct solution (series + 1 Newton) (nm)
-        //
-        //       f     erri  errd errda
-        //     -1/5    12e6 1.2e9  69e6
-        //     -1/10  123e3  12e6 765e3
-        //     -1/20   1110 108e3  7155
-        //     -1/50  18.63 200.9 27.12
-        //     -1/100 18.63 23.78 23.37
-        //     -1/150 18.63 21.05 20.26
-        //      1/150 22.35 24.73 25.83
-        //      1/100 22.35 25.03 25.31
-        //      1/50  29.80 231.9 30.44
-        //      1/20   5376 146e3  10e3
-        //      1/10  829e3  22e6 1.5e6
-        //      1/5   157e6 3.8e9 280e6
-        real
-          ssig2 = _ssig1 * csig12 + _csig1 * ssig12,
-          csig2 = _csig1 * csig12 - _ssig1 * ssig12;
-        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _C1a, nC1_);
-        real serr = (1 + _A1m1) * (sig12 + (B12 - _B11)) - s12_a12 / _b;
-        sig12 = sig12 - serr / sqrt(1 + _k2 * Math::sq(ssig2));
-        ssig12 = sin(sig12); csig12 = cos(sig12);
-        // Update B12 below
-      }
+      // B12 is updated in GenPosition
     }
+  }
 
+  Math::real GeodesicLine::GenPosition(bool arcmode, real s12_a12,
+                                       real sig12, real ssig12, real csig12,
+                                       real B12, unsigned outmask,
+                                       real& lat2, real& lon2, real& azi2,
+                                       real& s12, real& m12,
+                                       real& M12, real& M21,
+                                       real& S12)
+  const {
+    // outmask has been masked by _caps & OUT_MASK, sig12 is the arc length
+    // (radians) with sine and cosine ssig12 and csig12; in distance mode with
+    // abs(_f) <= 0.01, B12 is the value of the C1 series at sig2.
+    real AB1 = 0;
     real ssig2, csig2, sbet2, cbet2, salp2, calp2;
     // sig2 = sig1 + sig12
     ssig2 = _ssig1 * csig12 + _csig1 * ssig12;
@@ -192,7 +230,7 @@ namespace GeographicLib {
     real dn2 = sqrt(1 + _k2 * Math::sq(ssig2));
     if (outmask & (DISTANCE | REDUCEDLENGTH | GEODESICSCALE)) {
       if (arcmode || abs(_f) > 0.01)
-        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _C1a, nC1_);
+        B12 = Geodesic::SinCosSeries(true, ssig2, csig2, _C1a, _nC);
       AB1 = (1 + _A1m1) * (B12 - _B11);
     }
     // sin(bet2) = cos(alp0) * sin(sig2)
@@ -220,7 +258,7 @@ namespace GeographicLib {
         : atan2(somg2 * _comg1 - comg2 * _somg1,
                 comg2 * _comg1 + somg2 * _somg1);
       real lam12 = omg12 + _A3c *
-        ( sig12 + (Geodesic::SinCosSeries(true, ssig2, csig2, _C3a, nC3_-1)
+        ( sig12 + (Geodesic::SinCosSeries(true, ssig2, csig2, _C3a, _nC-1)
                    - _B31));
       real lon12 = lam12 / Math::degree();
       // Use Math::AngNormalize2 because longitude might have wrapped
@@ -238,7 +276,7 @@ namespace GeographicLib {
 
     if (outmask & (REDUCEDLENGTH | GEODESICSCALE)) {
       real
-        B22 = Geodesic::SinCosSeries(true, ssig2, csig2, _C2a, nC2_),
+        B22 = Geodesic::SinCosSeries(true, ssig2, csig2, _C2a, _nC),
         AB2 = (1 + _A2m1) * (B22 - _B21),
         J12 = (_A1m1 - _A2m1) * sig12 + (AB1 - AB2);
       if (outmask & REDUCEDLENGTH)
@@ -255,7 +293,7 @@ namespace GeographicLib {
 
     if (outmask & AREA) {
       real
-        B42 = Geodesic::SinCosSeries(false, ssig2, csig2, _C4a, nC4_);
+        B42 = Geodesic::SinCosSeries(false, ssig2, csig2, _C4a, _nC);
       real salp12, calp12;
       if (_calp0 == 0 || _salp0 == 0) {
         // alp12 = alp2 - alp1, used in atan2 so no need to normalize
@@ -288,4 +326,130 @@ namespace GeographicLib {
     return arcmode ? s12_a12 : sig12 / Math::degree();
   }
 
+  void GeodesicLine::GenPositions(bool arcmode, const real* s12_a12, size_t n,
+                                  unsigned outmask,
+                                  real* lat2, real* lon2, real* azi2,
+                                  real* s12, real* m12, real* M12, real* M21,
+                                  real* S12, real* a12) const {
+    if (!( Init() && (arcmode || (_caps & DISTANCE_IN & OUT_MASK)) )) {
+      // Uninitialized or impossible distance calculation requested
+      if (a12)
+        for (size_t i = 0; i < n; ++i) a12[i] = Math::NaN();
+      return;
+    }
+    // The quantities which GenPosition will set
+    unsigned mask = outmask & _caps & OUT_MASK;
+    real tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      real ta12 = GenPosition(arcmode, s12_a12[i], outmask,
+                              tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21,
+                              tS12);
+      if (mask & LATITUDE) lat2[i] = tlat2;
+      if (mask & LONGITUDE) lon2[i] = tlon2;
+      if (mask & AZIMUTH) azi2[i] = tazi2;
+      if (mask & DISTANCE) s12[i] = ts12;
+      if (mask & REDUCEDLENGTH) m12[i] = tm12;
+      if (mask & GEODESICSCALE) { M12[i] = tM12; M21[i] = tM21; }
+      if (mask & AREA) S12[i] = tS12;
+      if (a12) a12[i] = ta12;
+    }
+  }
+
+  void GeodesicLine::UniformArcPositions(real a12, real da12, size_t n,
+                                         unsigned outmask,
+                                         real* lat2, real* lon2, real* azi2,
+                                         real* s12, real* m12,
+                                         real* M12, real* M21,
+                                         real* S12) const {
+    if (!Init()) return;
+    outmask &= _caps & OUT_MASK;
+    // The sine and cosine of the arc length are found by the angle-addition
+    // formulas, restarting every nsync_ points to limit the accumulation of
+    // round-off errors.
+    static const size_t nsync_ = 16;
+    real
+      dsig12 = da12 * Math::degree(),
+      sdsig12 = sin(dsig12), cdsig12 = cos(dsig12),
+      ssig12 = 0, csig12 = 1,
+      tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      real a = a12 + real(i) * da12, sig12 = a * Math::degree();
+      if (i % nsync_ == 0) {
+        // As in GenPosition
+        real s12a = abs(a);
+        s12a -= 180 * floor(s12a / 180);
+        ssig12 = s12a ==  0 ? 0 : sin(sig12);
+        csig12 = s12a == 90 ? 0 : cos(sig12);
+      } else {
+        real t = ssig12 * cdsig12 + csig12 * sdsig12;
+        csig12 = csig12 * cdsig12 - ssig12 * sdsig12;
+        ssig12 = t;
+      }
+      GenPosition(true, a, sig12, ssig12, csig12, 0, outmask,
+                  tlat2, tlon2, tazi2, ts12, tm12, tM12, tM21, tS12);
+      if (outmask & LATITUDE) lat2[i] = tlat2;
+      if (outmask & LONGITUDE) lon2[i] = tlon2;
+      if (outmask & AZIMUTH) azi2[i] = tazi2;
+      if (outmask & DISTANCE) s12[i] = ts12;
+      if (outmask & REDUCEDLENGTH) m12[i] = tm12;
+      if (outmask & GEODESICSCALE) { M12[i] = tM12; M21[i] = tM21; }
+      if (outmask & AREA) S12[i] = tS12;
+    }
+  }
+
+  GeodesicLine::Densifier::Densifier(const GeodesicLine* line, real step,
+                                     size_t maxpoints, bool arcmode)
+    : _line(line)
+    , _arcmode(arcmode)
+    , _step(step)
+    , _dang(arcmode ? step * Math::degree() :
+            step / (line->_b * (1 + line->_A1m1)))
+    , _sdang(sin(_dang))
+    , _cdang(cos(_dang))
+    , _sang(0)
+    , _cang(1)
+    , _maxpoints(line->Init() &&
+                 (arcmode || (line->_caps & DISTANCE_IN & OUT_MASK)) ?
+                 maxpoints : 0)
+    , _count(0)
+  {}
+
+  bool GeodesicLine::Densifier::GenNext(unsigned outmask,
+                                        real& lat2, real& lon2, real& azi2,
+                                        real& s12) {
+    // Evaluate the sine and cosine afresh every nsync_ points.
+    static const size_t nsync_ = 16;
+    if (_count >= _maxpoints) return false;
+    const GeodesicLine& l = *_line;
+    // d is the distance or arc length; ang is the corresponding angle, tau12
+    // or sig12, with sine and cosine _sang and _cang.
+    real d = real(_count) * _step,
+      ang = _arcmode ? d * Math::degree() : d / (l._b * (1 + l._A1m1));
+    if (_count % nsync_ == 0) {
+      if (_arcmode) {
+        // As in GenPosition
+        real da = abs(d);
+        da -= 180 * floor(da / 180);
+        _sang = da ==  0 ? 0 : sin(ang);
+        _cang = da == 90 ? 0 : cos(ang);
+      } else {
+        _sang = sin(ang); _cang = cos(ang);
+      }
+    } else {
+      real t = _sang * _cdang + _cang * _sdang;
+      _cang = _cang * _cdang - _sang * _sdang;
+      _sang = t;
+    }
+    ++_count;
+    real sig12 = ang, ssig12 = _sang, csig12 = _cang, B12 = 0;
+    if (!_arcmode)
+      l.DistanceToArc(d, _sang, _cang, sig12, ssig12, csig12, B12);
+    real t;
+    outmask &= (LATITUDE | LONGITUDE | AZIMUTH | DISTANCE | LONG_UNROLL) &
+      l._caps & OUT_MASK;
+    l.GenPosition(_arcmode, d, sig12, ssig12, csig12, B12, outmask,
+                  lat2, lon2, azi2, s12, t, t, t, t);
+    return true;
+  }
+
 } // namespace GeographicLib
@@ -0,0 +1,174 @@
+/**
+ * \file GeodesicLineCache.cpp
+ * \brief Implementation for GeographicLib::GeodesicLineCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <list>
+#include <map>
+#include <GeographicLib/GeodesicLineCache.hpp>
+
+#if !defined(GEOGRAPHICLIB_LINECACHE_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_LINECACHE_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_LINECACHE_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_LINECACHE_THREADSAFE
+#  include <mutex>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  class GeodesicLineCache::Impl {
+  public:
+    struct Key {
+      real lat1, lon1, azi1;
+      bool operator<(const Key& k) const {
+        return lat1 < k.lat1 || (lat1 == k.lat1 &&
+                                 (lon1 < k.lon1 || (lon1 == k.lon1 &&
+                                                    azi1 < k.azi1)));
+      }
+    };
+    // The lines in order of use, most recent first, and an index into them.
+    typedef list< pair<Key, GeodesicLine> > list_t;
+    typedef map<Key, list_t::iterator> map_t;
+    Geodesic _g;
+    unsigned _caps;
+    size_t _capacity;
+    list_t _lines;
+    map_t _index;
+    unsigned long _hits, _misses;
+#if GEOGRAPHICLIB_LINECACHE_THREADSAFE
+    mutable mutex _mutex;
+#endif
+    Impl(const Geodesic& g, size_t capacity, unsigned caps)
+      : _g(g)
+      , _caps(caps)
+      , _capacity(capacity)
+      , _hits(0)
+      , _misses(0)
+    {}
+    void Trim() {
+      // Discard the least recently used lines
+      while (_lines.size() > _capacity) {
+        _index.erase(_lines.back().first);
+        _lines.pop_back();
+      }
+    }
+  };
+
+  namespace {
+    // Lock the mutex of a GeodesicLineCache::Impl for the lifetime of this
+    // object (this does nothing if the cache is not thread safe).  This is a
+    // template so that the private class Impl need only be named within the
+    // member functions of GeodesicLineCache.
+    template<class T> class Guard {
+#if GEOGRAPHICLIB_LINECACHE_THREADSAFE
+      lock_guard<mutex> _lock;
+    public:
+      explicit Guard(const T* impl) : _lock(impl->_mutex) {}
+#else
+    public:
+      explicit Guard(const T*) {}
+#endif
+    };
+  }
+
+  GeodesicLineCache::GeodesicLineCache(const Geodesic& g, size_t capacity,
+                                       unsigned caps)
+    : _impl(new Impl(g, capacity, caps))
+  {}
+
+  GeodesicLineCache::~GeodesicLineCache() { delete _impl; }
+
+  GeodesicLine GeodesicLineCache::Line(real lat1, real lon1, real azi1) {
+    Impl::Key key = { lat1, lon1, azi1 };
+    // NaNs can't be used as keys in a map.
+    bool cacheable =
+      !(Math::isnan(lat1) || Math::isnan(lon1) || Math::isnan(azi1));
+    {
+      Guard<Impl> lock(_impl);
+      if (cacheable) {
+        Impl::map_t::iterator i = _impl->_index.find(key);
+        if (i != _impl->_index.end()) {
+          ++_impl->_hits;
+          // Move this line to the front of the list
+          _impl->_lines.splice(_impl->_lines.begin(), _impl->_lines,
+                               i->second);
+          return i->second->second;
+        }
+      }
+      ++_impl->_misses;
+    }
+    // Construct the line without holding the lock.
+    GeodesicLine line(_impl->_g, lat1, lon1, azi1, _impl->_caps);
+    if (cacheable) {
+      Guard<Impl> lock(_impl);
+      // Another thread may have inserted this line in the meantime.
+      if (_impl->_capacity > 0 &&
+          _impl->_index.find(key) == _impl->_index.end()) {
+        _impl->_lines.push_front(make_pair(key, line));
+        _impl->_index[key] = _impl->_lines.begin();
+        _impl->Trim();
+      }
+    }
+    return line;
+  }
+
+  void GeodesicLineCache::Clear() {
+    Guard<Impl> lock(_impl);
+    _impl->_index.clear();
+    _impl->_lines.clear();
+  }
+
+  void GeodesicLineCache::SetCapacity(size_t capacity) {
+    Guard<Impl> lock(_impl);
+    _impl->_capacity = capacity;
+    _impl->Trim();
+  }
+
+  void GeodesicLineCache::ResetCounters() {
+    Guard<Impl> lock(_impl);
+    _impl->_hits = _impl->_misses = 0;
+  }
+
+  size_t GeodesicLineCache::Capacity() const {
+    Guard<Impl> lock(_impl);
+    return _impl->_capacity;
+  }
+
+  size_t GeodesicLineCache::Size() const {
+    Guard<Impl> lock(_impl);
+    return _impl->_lines.size();
+  }
+
+  unsigned long GeodesicLineCache::Hits() const {
+    Guard<Impl> lock(_impl);
+    return _impl->_hits;
+  }
+
+  unsigned long GeodesicLineCache::Misses() const {
+    Guard<Impl> lock(_impl);
+    return _impl->_misses;
+  }
+
+  unsigned GeodesicLineCache::Capabilities() const { return _impl->_caps; }
+
+  bool GeodesicLineCache::ThreadSafe()
+  { return GEOGRAPHICLIB_LINECACHE_THREADSAFE != 0; }
+
+  Math::real GeodesicLineCache::MajorRadius() const
+  { return _impl->_g.MajorRadius(); }
+
+  Math::real GeodesicLineCache::Flattening() const
+  { return _impl->_g.Flattening(); }
+
+} // namespace GeographicLib
@@ -46,6 +46,7 @@ namespace GeographicLib {
     , _c2(g._c2)
     , _f1(g._f1)
     , _e2(g._e2)
+    , _nC4(g._nC4)
     , _E(0, 0)
       // Always allow latitude and azimuth and unrolling of longitude
     , _caps(caps | LATITUDE | AZIMUTH | LONG_UNROLL)
@@ -115,10 +116,27 @@ namespace GeographicLib {
       g.C4f(eps, _C4a);
       // Multiplier = a^2 * e^2 * cos(alpha0) * sin(alpha0)
       _A4 = Math::sq(_a) * _calp0 * _salp0 * _e2;
-      _B41 = GeodesicExact::CosSeries(_ssig1, _csig1, _C4a, nC4_);
+      _B41 = GeodesicExact::CosSeries(_ssig1, _csig1, _C4a, _nC4);
     }
   }
 
+  void GeodesicLineExact::PrecomputeSeries() {
+    if (!Init() || !_E.PrecomputeSeries())
+      return;
+    // Recompute the quantities for point 1 with the series so that they are
+    // consistent with those computed by GenPosition.
+    if (_caps & CAP_E) {
+      _E1 = _E.deltaE(_ssig1, _csig1, _dn1);
+      real s = sin(_E1), c = cos(_E1);
+      _stau1 = _ssig1 * c + _csig1 * s;
+      _ctau1 = _csig1 * c - _ssig1 * s;
+    }
+    if (_caps & CAP_D)
+      _D1 = _E.deltaD(_ssig1, _csig1, _dn1);
+    if (_caps & CAP_H)
+      _H1 = _E.deltaH(_ssig1, _csig1, _dn1);
+  }
+
   Math::real GeodesicLineExact::GenPosition(bool arcmode, real s12_a12,
                                             unsigned outmask,
                                             real& lat2, real& lon2, real& azi2,
@@ -220,7 +238,7 @@ namespace GeographicLib {
 
     if (outmask & AREA) {
       real
-        B42 = GeodesicExact::CosSeries(ssig2, csig2, _C4a, nC4_);
+        B42 = GeodesicExact::CosSeries(ssig2, csig2, _C4a, _nC4);
       real salp12, calp12;
       if (_calp0 == 0 || _salp0 == 0) {
         // alp12 = alp2 - alp1, used in atan2 so no need to normalize
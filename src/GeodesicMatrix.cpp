@@ -0,0 +1,63 @@
+/**
+ * \file GeodesicMatrix.cpp
+ * \brief Implementation for GeographicLib::GeodesicMatrix class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicMatrix.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicMatrix::GeodesicMatrix(const Geodesic& earth,
+                                 const real* lat, const real* lon, size_t n,
+                                 bool upper, size_t tile)
+    : _earth(earth)
+    , _n(n)
+    , _tile(tile)
+    , _nb(tile > 0 ? (n + tile - 1) / tile : 0)
+    , _upper(upper)
+  {
+    if (!(_tile > 0))
+      throw GeographicErr("Tile size must be positive");
+    _pts.reserve(_n);
+    for (size_t i = 0; i < _n; ++i)
+      _pts.push_back(Geodesic::Point(_earth, lat[i], lon[i]));
+  }
+
+  void GeodesicMatrix::ComputeTile(size_t k, unsigned outmask,
+                                   real* s12, real* azi1, real* azi2) const {
+    // Find the row bi and column bj of the tile.  For the upper triangle, the
+    // tiles in row bi are those with bi <= bj < _nb.
+    size_t bi, bj;
+    if (_upper) {
+      bi = 0;
+      while (k >= _nb - bi) { k -= _nb - bi; ++bi; }
+      bj = bi + k;
+    } else {
+      bi = k / _nb; bj = k % _nb;
+    }
+    size_t
+      i0 = bi * _tile, i1 = min(_n, i0 + _tile),
+      j0 = bj * _tile, j1 = min(_n, j0 + _tile);
+    outmask &= Geodesic::DISTANCE | Geodesic::AZIMUTH;
+    bool
+      distp = (outmask & Geodesic::DISTANCE) != 0U,
+      azip = (outmask & Geodesic::AZIMUTH) != 0U;
+    real ts12, tazi1, tazi2, t;
+    for (size_t i = i0; i < i1; ++i) {
+      for (size_t j = _upper ? max(j0, i + 1) : j0; j < j1; ++j) {
+        _earth.GenInverse(_pts[i], _pts[j], outmask,
+                          ts12, tazi1, tazi2, t, t, t, t);
+        size_t ij = Index(i, j);
+        if (distp) s12[ij] = ts12;
+        if (azip) { azi1[ij] = tazi1; azi2[ij] = tazi2; }
+      }
+    }
+  }
+
+} // namespace GeographicLib
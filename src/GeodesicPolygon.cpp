@@ -0,0 +1,199 @@
+/**
+ * \file GeodesicPolygon.cpp
+ * \brief Implementation for GeographicLib::GeodesicPolygon class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicPolygon.hpp>
+#include <algorithm>
+#include <limits>
+#include <GeographicLib/Instrumentation.hpp>
+
+#if !defined(GEOGRAPHICLIB_GEODESICPOLYGON_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEODESICPOLYGON_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GEODESICPOLYGON_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEODESICPOLYGON_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicPolygon::GeodesicPolygon(const Geodesic& earth,
+                                   const real lat[], const real lon[],
+                                   size_t n, bool reverse)
+    : _poly(earth)
+    , _n(n)
+    , _reverse(reverse)
+    , _crossings(0)
+    , _areasum(0)
+    , _perimetersum(0)
+    , _binwidth(360)
+  {
+    // The slack applied to the latitude bounds and the longitude bins to
+    // allow for roundoff.
+    static const real tol = sqrt(numeric_limits<real>::epsilon());
+    _pts.reserve(_n);
+    for (size_t i = 0; i < _n; ++i)
+      _pts.push_back(Geodesic::Point(_poly._earth, lat[i], lon[i]));
+    _edges.reserve(_n);
+    real span = 0;
+    for (size_t i = 0; _n > 1 && i < _n; ++i) {
+      // This follows PolygonArea::AddPoint.
+      size_t j = i + 1 < _n ? i + 1 : 0;
+      real s12, S12, azi1, azi2, t;
+      _poly._earth.GenInverse(_pts[i], _pts[j],
+                              _poly._mask | Geodesic::AZIMUTH,
+                              s12, azi1, azi2, t, t, t, S12);
+      _perimetersum += s12;
+      _areasum += S12;
+      _crossings += PolygonArea::transit(lon[i], lon[j]);
+      Edge e;
+      e.lon1 = _pts[i].Longitude(); e.lon2 = _pts[j].Longitude();
+      real lon12 = Math::AngDiff(e.lon1, e.lon2);
+      if (lon12 == 0)
+        // The edge doesn't cross any meridian.
+        continue;
+      _poly._earth.LatitudeRange(_pts[i].Latitude(), azi1,
+                                 _pts[j].Latitude(), azi2,
+                                 e.latlo, e.lathi);
+      e.latlo -= tol; e.lathi += tol;
+      if (lon12 > 0) {
+        e.w = i; e.aziw = azi1;
+      } else {
+        // Solve the inverse problem starting at the western end, so that an
+        // edge shared by two polygons is represented identically in both.
+        e.w = j;
+        _poly._earth.GenInverse(_pts[j], _pts[i], Geodesic::AZIMUTH,
+                                t, e.aziw, t, t, t, t, t);
+      }
+      _edges.push_back(e);
+      span += abs(lon12);
+    }
+    // Choose the number of bins so that a bin overlaps a few edges.
+    size_t ne = _edges.size(), nb = 1;
+    if (ne > 0) {
+      real nbr = ne * 360 / max(span, tol);
+      nb = size_t(max(real(1),
+                      min(nbr, real(min(16 * ne, size_t(1) << 22)))));
+    }
+    _binwidth = real(360) / nb;
+    // Two passes over the edges, counting and then filling the bins.
+    _binstart.assign(nb + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+      for (size_t k = 0; k < ne; ++k) {
+        const Edge& e = _edges[k];
+        real
+          lon12 = Math::AngDiff(e.lon1, e.lon2),
+          lo = (lon12 > 0 ? e.lon1 : e.lon2) + 180 - tol,
+          hi = lo + abs(lon12) + 2 * tol;
+        long
+          b0 = long(floor(lo / _binwidth)),
+          b1 = long(floor(hi / _binwidth));
+        if (b1 - b0 + 1 > long(nb) || abs(lon12) >= 180 - tol) {
+          b0 = 0; b1 = long(nb) - 1;
+        }
+        for (long b = b0; b <= b1; ++b) {
+          size_t c = size_t((b + long(nb)) % long(nb));
+          if (pass == 0)
+            ++_binstart[c + 1];
+          else
+            _bins[_binstart[c]++] = k;
+        }
+      }
+      if (pass == 0) {
+        for (size_t b = 0; b < nb; ++b)
+          _binstart[b + 1] += _binstart[b];
+        _bins.resize(_binstart[nb]);
+      } else {
+        // The fill advanced _binstart[b] to the start of bin b + 1.
+        for (size_t b = nb; b > 0; --b)
+          _binstart[b] = _binstart[b - 1];
+        _binstart[0] = 0;
+      }
+    }
+    // Whether the north pole is inside for reverse = false.  With an odd
+    // number of crossings of the prime meridian, the polygon encircles the
+    // pole; otherwise the pole is inside if the polygon is traversed
+    // clockwise (_areasum is accumulated with the clockwise sense).
+    _north = _crossings & 1 ? _crossings > 0 : _areasum() > 0;
+  }
+
+  bool GeodesicPolygon::Above(const Edge& e, const Geodesic::Point& p)
+    const {
+    // The edge crosses the meridian of p.  Compare the azimuth from its
+    // western end to p with that of the edge.
+    GEOGRAPHICLIB_COUNT(GEODESICPOLYGON_INVERSE);
+    real azi1, t;
+    _poly._earth.GenInverse(_pts[e.w], p, Geodesic::AZIMUTH,
+                            t, azi1, t, t, t, t, t);
+    return azi1 > e.aziw;
+  }
+
+  bool GeodesicPolygon::Contains(real lat, real lon) const {
+    if (!(Math::isfinite(lat) && Math::isfinite(lon)))
+      return false;
+    lon = Math::AngNormalize(lon);
+    size_t
+      nb = _binstart.size() - 1,
+      b = min(nb - 1, size_t(max(real(0), (lon + 180) / _binwidth)));
+    Geodesic::Point p;
+    bool havep = false, inside = _north;
+    for (size_t k = _binstart[b]; k < _binstart[b + 1]; ++k) {
+      const Edge& e = _edges[_bins[k]];
+      if (lat > e.lathi ||
+          PolygonArea::transit(Math::AngDiff(lon, e.lon1),
+                               Math::AngDiff(lon, e.lon2)) == 0)
+        continue;
+      if (lat >= e.latlo) {
+        if (!havep) {
+          p = Geodesic::Point(_poly._earth, lat, lon); havep = true;
+        }
+        if (!Above(e, p))
+          continue;
+      }
+      inside = !inside;
+    }
+    return inside != _reverse;
+  }
+
+  void GeodesicPolygon::ContainsRange(const real lat[], const real lon[],
+                                      size_t i0, size_t i1, bool inside[])
+    const {
+    for (size_t i = i0; i < i1; ++i)
+      inside[i] = Contains(lat[i], lon[i]);
+  }
+
+  void GeodesicPolygon::ContainsBatch(const real lat[], const real lon[],
+                                      size_t n, bool inside[], int nthreads)
+    const {
+#if GEOGRAPHICLIB_GEODESICPOLYGON_THREADS
+    // Divide the query points into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    ContainsRange(lat, lon, i0, i1, inside);
+                  });
+#else
+    (void)nthreads;
+    ContainsRange(lat, lon, 0, n, inside);
+#endif
+  }
+
+  Math::real GeodesicPolygon::Area() const {
+    if (_n < 3)
+      return 0;
+    Accumulator<> tempsum(_areasum);
+    return _poly.ReduceArea(tempsum, _crossings, _reverse, false);
+  }
+
+} // namespace GeographicLib
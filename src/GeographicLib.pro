@@ -5,36 +5,63 @@ TEMPLATE = lib
 INCLUDEPATH = ../include
 INCLUDEDIR = $$INCLUDEPATH/GeographicLib
 
+SOURCES += --help.cpp
 SOURCES += Accumulator.cpp
 SOURCES += AlbersEqualArea.cpp
+SOURCES += AuthalicSphere.cpp
 SOURCES += AzimuthalEquidistant.cpp
 SOURCES += CassiniSoldner.cpp
 SOURCES += CircularEngine.cpp
+SOURCES += CompactGeodesicLine.cpp
 SOURCES += DMS.cpp
+SOURCES += EditablePolygonArea.cpp
 SOURCES += Ellipsoid.cpp
 SOURCES += EllipticFunction.cpp
+SOURCES += Executor.cpp
 SOURCES += GeoCoords.cpp
 SOURCES += Geocentric.cpp
+SOURCES += GeocentricTracker.cpp
 SOURCES += Geodesic.cpp
+SOURCES += GeodesicBuffer.cpp
 SOURCES += GeodesicExact.cpp
 SOURCES += GeodesicExactC4.cpp
+SOURCES += GeodesicIndex.cpp
+SOURCES += GeodesicIntersect.cpp
 SOURCES += GeodesicLine.cpp
+SOURCES += GeodesicLineCache.cpp
 SOURCES += GeodesicLineExact.cpp
+SOURCES += GeodesicMatrix.cpp
+SOURCES += GeodesicPolygon.cpp
 SOURCES += Geohash.cpp
 SOURCES += Geoid.cpp
+SOURCES += GeoidGenerator.cpp
 SOURCES += Gnomonic.cpp
 SOURCES += GravityCircle.cpp
+SOURCES += GravityCircleCache.cpp
+SOURCES += GravityGrid.cpp
 SOURCES += GravityModel.cpp
+SOURCES += GreatEllipse.cpp
+SOURCES += GridMapper.cpp
+SOURCES += Instrumentation.cpp
+SOURCES += InverseCache.cpp
+SOURCES += JacobiConformal.cpp
 SOURCES += LambertConformalConic.cpp
+SOURCES += LinePipeline.cpp
 SOURCES += LocalCartesian.cpp
 SOURCES += MGRS.cpp
+SOURCES += MGRSGrid.cpp
 SOURCES += MagneticCircle.cpp
+SOURCES += MagneticCircleCache.cpp
+SOURCES += MagneticLocation.cpp
 SOURCES += MagneticModel.cpp
+SOURCES += MagneticSnapshot.cpp
 SOURCES += Math.cpp
 SOURCES += NormalGravity.cpp
+SOURCES += NumaReplicas.cpp
 SOURCES += OSGB.cpp
 SOURCES += PolarStereographic.cpp
 SOURCES += PolygonArea.cpp
+SOURCES += Projector.cpp
 SOURCES += Rhumb.cpp
 SOURCES += SphericalEngine.cpp
 SOURCES += TransverseMercator.cpp
@@ -42,36 +69,63 @@ SOURCES += TransverseMercatorExact.cpp
 SOURCES += UTMUPS.cpp
 SOURCES += Utility.cpp
 
+HEADERS += $$INCLUDEDIR/--help.hpp
 HEADERS += $$INCLUDEDIR/Accumulator.hpp
 HEADERS += $$INCLUDEDIR/AlbersEqualArea.hpp
+HEADERS += $$INCLUDEDIR/AuthalicSphere.hpp
 HEADERS += $$INCLUDEDIR/AzimuthalEquidistant.hpp
 HEADERS += $$INCLUDEDIR/CassiniSoldner.hpp
 HEADERS += $$INCLUDEDIR/CircularEngine.hpp
+HEADERS += $$INCLUDEDIR/CompactGeodesicLine.hpp
 HEADERS += $$INCLUDEDIR/Constants.hpp
 HEADERS += $$INCLUDEDIR/DMS.hpp
+HEADERS += $$INCLUDEDIR/EditablePolygonArea.hpp
 HEADERS += $$INCLUDEDIR/Ellipsoid.hpp
 HEADERS += $$INCLUDEDIR/EllipticFunction.hpp
+HEADERS += $$INCLUDEDIR/Executor.hpp
 HEADERS += $$INCLUDEDIR/GeoCoords.hpp
 HEADERS += $$INCLUDEDIR/Geocentric.hpp
+HEADERS += $$INCLUDEDIR/GeocentricTracker.hpp
 HEADERS += $$INCLUDEDIR/Geodesic.hpp
+HEADERS += $$INCLUDEDIR/GeodesicBuffer.hpp
 HEADERS += $$INCLUDEDIR/GeodesicExact.hpp
+HEADERS += $$INCLUDEDIR/GeodesicIndex.hpp
+HEADERS += $$INCLUDEDIR/GeodesicIntersect.hpp
 HEADERS += $$INCLUDEDIR/GeodesicLine.hpp
+HEADERS += $$INCLUDEDIR/GeodesicLineCache.hpp
 HEADERS += $$INCLUDEDIR/GeodesicLineExact.hpp
+HEADERS += $$INCLUDEDIR/GeodesicMatrix.hpp
+HEADERS += $$INCLUDEDIR/GeodesicPolygon.hpp
 HEADERS += $$INCLUDEDIR/Geohash.hpp
 HEADERS += $$INCLUDEDIR/Geoid.hpp
+HEADERS += $$INCLUDEDIR/GeoidGenerator.hpp
 HEADERS += $$INCLUDEDIR/Gnomonic.hpp
 HEADERS += $$INCLUDEDIR/GravityCircle.hpp
+HEADERS += $$INCLUDEDIR/GravityCircleCache.hpp
+HEADERS += $$INCLUDEDIR/GravityGrid.hpp
 HEADERS += $$INCLUDEDIR/GravityModel.hpp
+HEADERS += $$INCLUDEDIR/GreatEllipse.hpp
+HEADERS += $$INCLUDEDIR/GridMapper.hpp
+HEADERS += $$INCLUDEDIR/Instrumentation.hpp
+HEADERS += $$INCLUDEDIR/InverseCache.hpp
+HEADERS += $$INCLUDEDIR/JacobiConformal.hpp
 HEADERS += $$INCLUDEDIR/LambertConformalConic.hpp
+HEADERS += $$INCLUDEDIR/LinePipeline.hpp
 HEADERS += $$INCLUDEDIR/LocalCartesian.hpp
 HEADERS += $$INCLUDEDIR/MGRS.hpp
+HEADERS += $$INCLUDEDIR/MGRSGrid.hpp
 HEADERS += $$INCLUDEDIR/MagneticCircle.hpp
+HEADERS += $$INCLUDEDIR/MagneticCircleCache.hpp
+HEADERS += $$INCLUDEDIR/MagneticLocation.hpp
 HEADERS += $$INCLUDEDIR/MagneticModel.hpp
+HEADERS += $$INCLUDEDIR/MagneticSnapshot.hpp
 HEADERS += $$INCLUDEDIR/Math.hpp
 HEADERS += $$INCLUDEDIR/NormalGravity.hpp
+HEADERS += $$INCLUDEDIR/NumaReplicas.hpp
 HEADERS += $$INCLUDEDIR/OSGB.hpp
 HEADERS += $$INCLUDEDIR/PolarStereographic.hpp
 HEADERS += $$INCLUDEDIR/PolygonArea.hpp
+HEADERS += $$INCLUDEDIR/Projector.hpp
 HEADERS += $$INCLUDEDIR/Rhumb.hpp
 HEADERS += $$INCLUDEDIR/SphericalEngine.hpp
 HEADERS += $$INCLUDEDIR/SphericalHarmonic.hpp
@@ -82,3 +136,4 @@ HEADERS += $$INCLUDEDIR/TransverseMercatorExact.hpp
 HEADERS += $$INCLUDEDIR/UTMUPS.hpp
 HEADERS += $$INCLUDEDIR/Utility.hpp
 HEADERS += $$INCLUDEDIR/Config.h
+HEADERS += CacheSupport.hpp
@@ -7,38 +7,136 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <algorithm>
 #include <GeographicLib/Geohash.hpp>
+#include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/Utility.hpp>
 
+#if !defined(GEOGRAPHICLIB_GEOHASH_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEOHASH_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_GEOHASH_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEOHASH_THREADSAFE
+#  include <mutex>
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
   const int Geohash::decprec_[] = {-2, -1, 0, 0, 1, 2, 3, 3, 4, 5,
                                    6, 6, 7, 8, 9, 9, 10, 11, 12};
-  const string Geohash::lcdigits_ = "0123456789bcdefghjkmnpqrstuvwxyz";
-  const string Geohash::ucdigits_ = "0123456789BCDEFGHJKMNPQRSTUVWXYZ";
+  const char* const Geohash::lcdigits_ = "0123456789bcdefghjkmnpqrstuvwxyz";
+  const char* const Geohash::ucdigits_ = "0123456789BCDEFGHJKMNPQRSTUVWXYZ";
 
-  void Geohash::Forward(real lat, real lon, int len, std::string& geohash) {
+  // A table giving the index of each character in ucdigits_ (as returned by
+  // Utility::lookup), so that Geohash::Reverse need not search the string.
+  // This is filled in on the first call to Get.
+  class Geohash::Decoder {
+  private:
+    static Decoder decoder_;
+#if GEOGRAPHICLIB_GEOHASH_THREADSAFE
+    static once_flag init_;
+#else
+    static bool init_;
+#endif
+    static void Init() {
+      for (int c = 0; c < 256; ++c)
+        decoder_.digits[c] =
+          static_cast<signed char>(Utility::lookup(ucdigits_, char(c)));
+    }
+  public:
+    signed char digits[256];
+    int Index(char c) const { return digits[static_cast<unsigned char>(c)]; }
+    static const Decoder& Get() {
+#if GEOGRAPHICLIB_GEOHASH_THREADSAFE
+      // Visual Studio 2012 and 2013 don't initialize function-scope statics
+      // thread-safely; so fill in the tables with call_once.
+      call_once(init_, Init);
+#else
+      if (!init_) { Init(); init_ = true; }
+#endif
+      return decoder_;
+    }
+  };
+
+  // decoder_ has no constructor; so it's zero-initialized at load time and
+  // filled in by Init.
+  Geohash::Decoder Geohash::Decoder::decoder_;
+#if GEOGRAPHICLIB_GEOHASH_THREADSAFE
+  once_flag Geohash::Decoder::init_;
+#else
+  bool Geohash::Decoder::init_ = false;
+#endif
+
+  namespace {
+    // Spread the low 32 bits of x so that bit k moves to bit 2k.
+    inline unsigned long long Spread(unsigned long long x) {
+      x &= 0x00000000ffffffffULL;
+      x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+      x = (x | (x <<  8)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x <<  4)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x <<  2)) & 0x3333333333333333ULL;
+      x = (x | (x <<  1)) & 0x5555555555555555ULL;
+      return x;
+    }
+    // The inverse of Spread; move bit 2k of x to bit k.
+    inline unsigned long long Compact(unsigned long long x) {
+      x &= 0x5555555555555555ULL;
+      x = (x | (x >>  1)) & 0x3333333333333333ULL;
+      x = (x | (x >>  2)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x >>  4)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x >>  8)) & 0x0000ffff0000ffffULL;
+      x = (x | (x >> 16)) & 0x00000000ffffffffULL;
+      return x;
+    }
+    // Combine the column ilon and row ilat of a cell into the nbits bits of
+    // a geohash.  The last bit is a longitude bit if nbits is odd.
+    inline unsigned long long Interleave(unsigned long long ilon,
+                                         unsigned long long ilat, int nbits) {
+      return nbits & 1 ?
+        Spread(ilon) | (Spread(ilat) << 1) :
+        (Spread(ilon) << 1) | Spread(ilat);
+    }
+    // The inverse of Interleave.
+    inline void Deinterleave(unsigned long long bits, int nbits,
+                             unsigned long long& ilon,
+                             unsigned long long& ilat) {
+      ilon = nbits & 1 ? Compact(bits) : Compact(bits >> 1);
+      ilat = nbits & 1 ? Compact(bits >> 1) : Compact(bits);
+    }
+  }
+
+  bool Geohash::Quantize(real lat, real lon,
+                         unsigned long long& ulat, unsigned long long& ulon) {
     if (abs(lat) > 90)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-90d, 90d]");
     if (lon < -540 || lon >= 540)
       throw GeographicErr("Longitude " + Utility::str(lon)
                           + "d not in [-540d, 540d)");
-    if (Math::isnan(lat) || Math::isnan(lon)) {
-      geohash = "nan";
-      return;
-    }
+    if (Math::isnan(lat) || Math::isnan(lon))
+      return false;
     if (lat == 90) lat -= lateps() / 2;
     lon = Math::AngNormalize(lon); // lon in [-180,180)
     // lon/loneps in [-2^45,2^45); lon/loneps + shift in [0,2^46)
     // similarly for lat
+    ulon = (unsigned long long)(floor(lon/loneps()) + shift());
+    ulat = (unsigned long long)(floor(lat/lateps()) + shift());
+    return true;
+  }
+
+  int Geohash::Encode(real lat, real lon, int len, char geohash[]) {
+    unsigned long long ulat, ulon;
+    if (!Quantize(lat, lon, ulat, ulon)) {
+      geohash[0] = 'n'; geohash[1] = 'a'; geohash[2] = 'n';
+      return 3;
+    }
     len = max(0, min(int(maxlen_), len));
-    unsigned long long
-      ulon = (unsigned long long)(floor(lon/loneps()) + shift()),
-      ulat = (unsigned long long)(floor(lat/lateps()) + shift());
-    char geohash1[maxlen_];
     unsigned byte = 0;
     for (unsigned i = 0; i < 5 * unsigned(len);) {
       if ((i & 1) == 0) {
@@ -50,17 +148,207 @@ namespace GeographicLib {
       }
       ++i;
       if (i % 5 == 0) {
-        geohash1[(i/5)-1] = lcdigits_[byte];
+        geohash[(i/5)-1] = lcdigits_[byte];
         byte = 0;
       }
     }
-    geohash.resize(len);
-    copy(geohash1, geohash1 + len, geohash.begin());
+    return len;
+  }
+
+  void Geohash::Forward(real lat, real lon, int len, std::string& geohash) {
+    char geohash1[maxlen_];
+    int len1 = Encode(lat, lon, len, geohash1);
+    geohash.resize(len1);
+    copy(geohash1, geohash1 + len1, geohash.begin());
+  }
+
+  size_t Geohash::Forward(real lat, real lon, int len,
+                          char* geohash, size_t cap) {
+    char geohash1[maxlen_];
+    int len1 = Encode(lat, lon, len, geohash1);
+    if (!(size_t(len1) < cap))
+      throw GeographicErr("Buffer of size " + Utility::str(cap)
+                          + " too small for geohash");
+    copy(geohash1, geohash1 + len1, geohash);
+    geohash[len1] = '\0';
+    return size_t(len1);
+  }
+
+  void Geohash::ForwardBatch(const real lat[], const real lon[], size_t n,
+                             int len, char* geohash, size_t stride) {
+    len = max(0, min(int(maxlen_), len));
+    // The longest result is len characters or "nan", plus the terminator.
+    if (!(stride > size_t(max(len, 3))))
+      throw GeographicErr("Stride " + Utility::str(stride)
+                          + " too small for geohashes of length "
+                          + Utility::str(len));
+    for (size_t i = 0; i < n; ++i) {
+      char* geohash1 = geohash + i * stride;
+      geohash1[Encode(lat[i], lon[i], len, geohash1)] = '\0';
+    }
+  }
+
+  unsigned long long Geohash::EncodeBits(real lat, real lon, int nbits) {
+    unsigned long long ulat, ulon;
+    if (!Quantize(lat, lon, ulat, ulon))
+      throw GeographicErr("Cannot encode NaN position as geohash bits");
+    nbits = max(0, min(int(maxbits_), nbits));
+    int nlon = (nbits + 1) / 2, nlat = nbits / 2;
+    // Keep the leading nlon (resp. nlat) of the 46 bits in ulon (resp. ulat)
+    return Interleave(ulon >> (46 - nlon), ulat >> (46 - nlat), nbits);
+  }
+
+  void Geohash::EncodeBits(const real lat[], const real lon[], size_t n,
+                           int nbits, unsigned long long bits[]) {
+    for (size_t i = 0; i < n; ++i)
+      bits[i] = EncodeBits(lat[i], lon[i], nbits);
+  }
+
+  void Geohash::DecodeBits(unsigned long long bits, int nbits,
+                           real& lat, real& lon, bool centerp) {
+    nbits = max(0, min(int(maxbits_), nbits));
+    if (nbits < maxbits_)
+      bits &= (1ULL << nbits) - 1;
+    int nlon = (nbits + 1) / 2, nlat = nbits / 2;
+    unsigned long long ulon, ulat;
+    Deinterleave(bits, nbits, ulon, ulat);
+    ulon <<= 1; ulat <<= 1;
+    if (centerp) {
+      ulon += 1;
+      ulat += 1;
+    }
+    ulon <<= 45 - nlon;
+    ulat <<= 45 - nlat;
+    lon = ulon * loneps() - 180;
+    lat = ulat * lateps() - 90;
+  }
+
+  int Geohash::Neighbors(unsigned long long bits, int nbits,
+                         unsigned long long neighbors[]) {
+    nbits = max(0, min(int(maxbits_), nbits));
+    if (nbits < maxbits_)
+      bits &= (1ULL << nbits) - 1;
+    int nlon = (nbits + 1) / 2, nlat = nbits / 2;
+    unsigned long long ilon, ilat,
+      lonmask = (1ULL << nlon) - 1,
+      nrows = 1ULL << nlat;
+    Deinterleave(bits, nbits, ilon, ilat);
+    // N, NE, E, SE, S, SW, W, NW
+    static const int dlat[] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+    static const int dlon[] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+    int k = 0;
+    for (int d = 0; d < 8; ++d) {
+      // There are no neighbors across the poles.
+      if ((dlat[d] > 0 && ilat + 1 == nrows) || (dlat[d] < 0 && ilat == 0))
+        continue;
+      unsigned long long jlat = ilat + dlat[d],
+        // Longitudes wrap around
+        jlon = (ilon + dlon[d]) & lonmask,
+        id = Interleave(jlon, jlat, nbits);
+      // For very coarse cells, some of the neighbors coincide.
+      bool dup = id == bits;
+      for (int i = 0; i < k && !dup; ++i)
+        dup = neighbors[i] == id;
+      if (!dup)
+        neighbors[k++] = id;
+    }
+    return k;
+  }
+
+  void Geohash::Cover(real south, real west, real north, real east, int nbits,
+                      std::vector<unsigned long long>& cells) {
+    if (!(north >= south))
+      throw GeographicErr("North latitude " + Utility::str(north)
+                          + "d less than south latitude "
+                          + Utility::str(south) + "d");
+    real span = east - west;
+    if (!(Math::isfinite(span)))
+      throw GeographicErr("Illegal longitude range for geohash cover");
+    unsigned long long us, uw, un, ue;
+    Quantize(south, west, us, uw);
+    Quantize(north, east, un, ue);
+    nbits = max(0, min(int(maxbits_), nbits));
+    int nlon = (nbits + 1) / 2, nlat = nbits / 2;
+    unsigned long long
+      lonmask = (1ULL << nlon) - 1,
+      rs = us >> (46 - nlat), rn = un >> (46 - nlat),
+      cw = uw >> (46 - nlon), ce = ue >> (46 - nlon),
+      ncols;
+    if (span >= 360)
+      ncols = lonmask + 1;
+    else {
+      // The box extends eastwards from west to east; it wraps around if east
+      // is west of west (after reducing both to [-180, 180)).
+      if (span < 0) span = fmod(span, real(360)) + 360;
+      bool wrap = ue < uw || (ue == uw && span > 180);
+      ncols = min(lonmask + 1, ce - cw + (wrap ? lonmask + 1 : 0) + 1);
+    }
+    cells.clear();
+    cells.reserve(size_t((rn - rs + 1) * ncols));
+    for (unsigned long long r = rs; r <= rn; ++r)
+      for (unsigned long long c = 0; c < ncols; ++c)
+        cells.push_back(Interleave((cw + c) & lonmask, r, nbits));
+    sort(cells.begin(), cells.end());
+  }
+
+  void Geohash::CoverRadius(const Geodesic& g, real lat, real lon, real r,
+                            int nbits,
+                            std::vector<unsigned long long>& cells) {
+    if (!(r >= 0))
+      throw GeographicErr("Radius " + Utility::str(r) + "m is negative");
+    if (!(abs(lat) <= 90))
+      throw GeographicErr("Latitude " + Utility::str(lat)
+                          + "d not in [-90d, 90d]");
+    if (!(lon >= -540 && lon < 540))
+      throw GeographicErr("Longitude " + Utility::str(lon)
+                          + "d not in [-540d, 540d)");
+    real spolen, spoles, north = 90, south = -90, dlon = 180, t;
+    g.Inverse(lat, 0, 90, 0, spolen);
+    g.Inverse(lat, 0, -90, 0, spoles);
+    if (r < spolen)
+      g.Direct(lat, 0, 0, r, north, t);
+    if (r < spoles)
+      g.Direct(lat, 0, 180, r, south, t);
+    if (r < spolen && r < spoles) {
+      // The disc does not include a pole, so find the geodesic from the
+      // center which reaches the largest longitude.  lon2 is a unimodal
+      // function of azi1 in [0, 180], so use a golden-section search.
+      const real c = (3 - sqrt(real(5))) / 2;
+      real a = 0, b = 180, x1 = a + c * (b - a), x2 = b - c * (b - a),
+        f1, f2;
+      g.Direct(lat, 0, x1, r, t, f1);
+      g.Direct(lat, 0, x2, r, t, f2);
+      for (int i = 0; i < 100 && b - a > 8 * numeric_limits<real>::epsilon()
+             * 180; ++i) {
+        if (f1 < f2) {
+          a = x1; x1 = x2; f1 = f2;
+          x2 = b - c * (b - a);
+          g.Direct(lat, 0, x2, r, t, f2);
+        } else {
+          b = x2; x2 = x1; f2 = f1;
+          x1 = a + c * (b - a);
+          g.Direct(lat, 0, x1, r, t, f1);
+        }
+      }
+      dlon = max(f1, f2);
+    }
+    if (dlon >= 180)
+      Cover(south, -180, north, 180, nbits, cells);
+    else {
+      real west = Math::AngNormalize(lon) - dlon;
+      Cover(south, west, north, west + 2 * dlon, nbits, cells);
+    }
   }
 
   void Geohash::Reverse(const std::string& geohash, real& lat, real& lon,
                         int& len, bool centerp) {
-    len = min(int(maxlen_), int(geohash.length()));
+    Reverse(geohash.data(), geohash.size(), lat, lon, len, centerp);
+  }
+
+  void Geohash::Reverse(const char* geohash, size_t n, real& lat, real& lon,
+                        int& len, bool centerp) {
+    const Decoder& decoder = Decoder::Get();
+    len = min(int(maxlen_), int(n));
     if (len >= 3 &&
         toupper(geohash[0]) == 'N' &&
         toupper(geohash[1]) == 'A' &&
@@ -70,9 +358,10 @@ namespace GeographicLib {
     }
     unsigned long long ulon = 0, ulat = 0;
     for (unsigned k = 0, j = 0; k < unsigned(len); ++k) {
-      int byte = Utility::lookup(ucdigits_, geohash[k]);
+      int byte = decoder.Index(geohash[k]);
       if (byte < 0)
-        throw GeographicErr("Illegal character in geohash " + geohash);
+        throw GeographicErr("Illegal character in geohash "
+                            + string(geohash, n));
       for (unsigned m = 16; m; m >>= 1) {
         if (j == 0)
           ulon = (ulon << 1) + unsigned((byte & m) != 0);
@@ -2,7 +2,7 @@
  * \file Geoid.cpp
  * \brief Implementation for GeographicLib::Geoid class
  *
- * Copyright (c) Charles Karney (2009-2012) <charles@karney.com> and licensed
+ * Copyright (c) Charles Karney (2009-2015) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
@@ -10,6 +10,9 @@
 #include <GeographicLib/Geoid.hpp>
 // For getenv
 #include <cstdlib>
+#include <algorithm>
+#include <list>
+#include <map>
 #include <GeographicLib/Utility.hpp>
 
 #if !defined(GEOGRAPHICLIB_DATA)
@@ -24,6 +27,47 @@
 #  define GEOGRAPHICLIB_GEOID_DEFAULT_NAME "egm96-5"
 #endif
 
+#if !defined(GEOGRAPHICLIB_GEOID_MMAP)
+#  if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+#    define GEOGRAPHICLIB_GEOID_MMAP 1
+#  else
+#    define GEOGRAPHICLIB_GEOID_MMAP 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEOID_MMAP
+#  if defined(_WIN32)
+#    if !defined(WIN32_LEAN_AND_MEAN)
+#      define WIN32_LEAN_AND_MEAN 1
+#    endif
+#    if !defined(NOMINMAX)
+#      define NOMINMAX 1
+#    endif
+#    include <windows.h>
+#  else
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#  endif
+#endif
+
+#if !defined(GEOGRAPHICLIB_GEOID_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GEOID_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_GEOID_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+#  include <atomic>
+#  include <condition_variable>
+#  include <deque>
+#  include <mutex>
+#  include <thread>
+#endif
+
 #if defined(_MSC_VER)
 // Squelch warnings about unsafe use of getenv
 #  pragma warning (disable: 4996)
@@ -197,8 +241,510 @@ namespace GeographicLib {
      18,  -36,    2,   0,  -66,  -51, 0,   0,  102,  31,
   };
 
+  // The points of the 12-point stencil (in the order of the rows of the
+  // transfer matrices) and of the 4-point stencil for bilinear interpolation
+  const int Geoid::stencilc_[2 * stencilsize_] = {
+     0, -1,   1, -1,
+    -1,  0,   0,  0,   1,  0,   2,  0,
+    -1,  1,   0,  1,   1,  1,   2,  1,
+     0,  2,   1,  2,
+  };
+  const int Geoid::stencill_[2 * 4] = {
+     0,  0,   1,  0,
+     0,  1,   1,  1,
+  };
+
+  class Geoid::TileCache {
+  public:
+    // The tiles in order of use, most recent first, and an index into them.
+    typedef list< pair<int, vector<pixel_t> > > list_t;
+    typedef map<int, list_t::iterator> map_t;
+    const Geoid& _g;
+    const int _tsize, _ntx, _nty;
+    const size_t _maxtiles;
+    list_t _tiles;
+    map_t _index;
+    // The most recently used tile
+    int _lastid, _lastx, _lasty, _lastw;
+    const pixel_t* _last;
+    unsigned long _hits, _misses, _evictions;
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    mutex _mutex;
+    // The background prefetch
+    bool _prefetch, _stop;
+    deque<int> _queue;
+    condition_variable _cv;
+    thread _worker;
+#endif
+    TileCache(const Geoid& g, int tsize, size_t maxtiles, bool prefetch)
+      : _g(g)
+      , _tsize(tsize)
+      , _ntx((g._width + tsize - 1) / tsize)
+      , _nty((g._height + tsize - 1) / tsize)
+      , _maxtiles(maxtiles)
+      , _lastid(-1)
+      , _lastx(0)
+      , _lasty(0)
+      , _lastw(0)
+      , _last(0)
+      , _hits(0)
+      , _misses(0)
+      , _evictions(0)
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+      , _prefetch(prefetch)
+      , _stop(false)
+#endif
+    {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+      if (_prefetch)
+        _worker = thread(&TileCache::Prefetcher, this);
+#else
+      (void)prefetch;
+#endif
+    }
+    ~TileCache() {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+      if (_prefetch) {
+        {
+          lock_guard<mutex> lock(_mutex);
+          _stop = true;
+        }
+        _cv.notify_one();
+        _worker.join();
+      }
+#endif
+    }
+    // Read tile id from str
+    void Read(istream& str, int id, vector<pixel_t>& data) const {
+      int
+        tx = id % _ntx, ty = id / _ntx,
+        x0 = tx * _tsize, y0 = ty * _tsize,
+        w = (min)(_tsize, _g._width - x0), h = (min)(_tsize, _g._height - y0);
+      data.resize(size_t(w) * size_t(h));
+      if (_g._source) {
+        vector<real> heights(data.size());
+        _g._source->Heights(x0, y0, w, h, &heights[0]);
+        for (size_t i = 0; i < data.size(); ++i) {
+          real p = (heights[i] - _g._offset) / _g._scale;
+          if (Math::isnan(p))
+            throw GeographicErr("Invalid height from " + _g._filename);
+          p = floor(p + real(0.5));
+          data[i] = p <= 0 ? pixel_t(0) :
+            (p >= real(pixel_max_) ? pixel_t(pixel_max_) : pixel_t(p));
+        }
+        return;
+      }
+      if (_g._compressed) {
+        unsigned long long
+          off = _g._tileindex[id],
+          len = _g._tileindex[id + 1] - off;
+        vector<unsigned char> buf(size_t(len) + 1);
+        str.seekg(ios::streamoff(off));
+        str.read(reinterpret_cast<char*>(&buf[0]), streamsize(len));
+        if (!str.good())
+          throw GeographicErr("Failure reading data");
+        Decode(&buf[0], size_t(len), w, h, &data[0]);
+        return;
+      }
+      for (int y = 0; y < h; ++y) {
+        str.seekg(ios::streamoff
+                  (_g._datastart + pixel_size_ *
+                   (unsigned(y0 + y) * _g._swidth + unsigned(x0))));
+        Utility::readarray<pixel_t, pixel_t, true>
+          (str, &data[size_t(y) * size_t(w)], w);
+      }
+    }
+    // Read row ty of tiles from str into strip (a _g._width x h array, where h
+    // is the height of the tiles).
+    void Strip(istream& str, int ty, vector<pixel_t>& strip) const {
+      vector<pixel_t> tile;
+      int h = (min)(_tsize, _g._height - ty * _tsize);
+      strip.resize(size_t(_g._width) * size_t(h));
+      for (int tx = 0; tx < _ntx; ++tx) {
+        Read(str, ty * _ntx + tx, tile);
+        int x0 = tx * _tsize, w = (min)(_tsize, _g._width - x0);
+        for (int y = 0; y < h; ++y)
+          copy(tile.begin() + size_t(y) * w,
+               tile.begin() + size_t(y) * w + w,
+               strip.begin() + size_t(y) * _g._width + x0);
+      }
+    }
+    // Decode a compressed tile of w x h pixels.  Each pixel is stored as the
+    // difference from a planar prediction based on its neighbors to the
+    // west, north, and north-west; this is zigzag encoded and written as a
+    // sequence of 7-bit groups, least significant first, with the high bit
+    // set on all but the last byte.
+    static void Decode(const unsigned char* buf, size_t len, int w, int h,
+                       pixel_t* data) {
+      const long long maxval = (long long)(pixel_max_);
+      size_t k = 0;
+      for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+          unsigned long long z = 0;
+          unsigned c;
+          int shift = 0;
+          do {
+            if (k == len || shift > 28)
+              throw GeographicErr("Corrupt tile");
+            c = buf[k++];
+            z |= (unsigned long long)(c & 0x7fu) << shift;
+            shift += 7;
+          } while (c & 0x80u);
+          long long
+            r = (z & 1ULL) ? -(long long)(z >> 1) - 1 : (long long)(z >> 1),
+            p = y == 0 ? (x == 0 ? 0 : data[x - 1]) :
+            (x == 0 ? data[(y - 1) * w] :
+             (min)(maxval,
+                   (max)(0LL, (long long)(data[y * w + x - 1]) +
+                         data[(y - 1) * w + x] - data[(y - 1) * w + x - 1]))),
+            v = p + r;
+          if (v < 0 || v > maxval)
+            throw GeographicErr("Corrupt tile");
+          data[y * w + x] = pixel_t(v);
+        }
+      }
+      if (k != len)
+        throw GeographicErr("Corrupt tile");
+    }
+    // Insert a tile at the front of the list and discard the least recently
+    // used tiles.
+    void Insert(int id, vector<pixel_t>& data) {
+      _tiles.push_front(make_pair(id, vector<pixel_t>()));
+      _tiles.front().second.swap(data);
+      _index[id] = _tiles.begin();
+      while (_tiles.size() > _maxtiles) {
+        if (_tiles.back().first == _lastid) _lastid = -1;
+        _index.erase(_tiles.back().first);
+        _tiles.pop_back();
+        ++_evictions;
+      }
+    }
+    void Use(int id, const vector<pixel_t>& data) {
+      _lastid = id;
+      _lastx = (id % _ntx) * _tsize;
+      _lasty = (id / _ntx) * _tsize;
+      _lastw = (min)(_tsize, _g._width - _lastx);
+      _last = &data[0];
+    }
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    // Queue the neighbors of tile id (with _mutex locked).
+    void Neighbors(int id) {
+      int tx = id % _ntx, ty = id / _ntx;
+      for (int dy = -1; dy <= 1; ++dy) {
+        int ty1 = ty + dy;
+        if (ty1 < 0 || ty1 >= _nty) continue;
+        for (int dx = -1; dx <= 1; ++dx) {
+          if (dx == 0 && dy == 0) continue;
+          int tx1 = (tx + dx + _ntx) % _ntx;
+          _queue.push_back(ty1 * _ntx + tx1);
+        }
+      }
+      // Don't let the queue grow without bound.
+      while (_queue.size() > 4 * _maxtiles)
+        _queue.pop_front();
+      _cv.notify_one();
+    }
+    void Prefetcher() {
+      ifstream str(_g._filename.c_str(), ios::binary);
+      vector<pixel_t> data;
+      unique_lock<mutex> lock(_mutex);
+      while (true) {
+        _cv.wait(lock, [this]{ return _stop || !_queue.empty(); });
+        if (_stop) break;
+        int id = _queue.front();
+        _queue.pop_front();
+        if (_index.find(id) != _index.end()) continue;
+        lock.unlock();
+        bool ok = _g._source || str.good();
+        if (ok) {
+          try { Read(str, id, data); }
+          catch (const exception&) { ok = false; str.clear(); }
+        }
+        lock.lock();
+        if (ok && _index.find(id) == _index.end())
+          Insert(id, data);
+      }
+    }
+#endif
+  };
+
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+  class Geoid::Preloader {
+  public:
+    const Geoid& _g;
+    const int _xoffset, _yoffset, _xsize, _ysize;
+    vector<pixel_t> _data;
+    // The number of rows read; whether the thread has finished and whether it
+    // should stop.
+    atomic<int> _rows;
+    atomic<bool> _done, _stop;
+    string _error;              // Set before _done
+    thread _worker;
+    Preloader(const Geoid& g, int xoffset, int yoffset, int xsize, int ysize)
+      : _g(g)
+      , _xoffset(xoffset)
+      , _yoffset(yoffset)
+      , _xsize(xsize)
+      , _ysize(ysize)
+      , _rows(0)
+      , _done(false)
+      , _stop(false)
+    { _worker = thread(&Preloader::Run, this); }
+    ~Preloader() {
+      _stop = true;
+      if (_worker.joinable())
+        _worker.join();
+    }
+    void Run() {
+      try {
+        ifstream str;
+        _g.openstream(str);
+        size_t npixels = size_t(_xsize) * size_t(_ysize);
+        if (_g._hugepages)
+          Utility::reservehugepages(_data, npixels);
+        _data.resize(npixels);
+        // For a compressed file, the current row of tiles
+        TileCache reader(_g, (max)(1, _g._tilesize), 1, false);
+        vector<pixel_t> strip;
+        int ty0 = -1;
+        for (int iy = _yoffset; iy < _yoffset + _ysize && !_stop; ++iy) {
+          int iy1 = iy, iw1 = _xoffset;
+          if (iy < 0 || iy >= _g._height) {
+            // Allow points "beyond" the poles to support interpolation
+            iy1 = iy1 < 0 ? -iy1 : 2 * (_g._height - 1) - iy1;
+            iw1 += _g._width/2;
+            if (iw1 >= _g._width)
+              iw1 -= _g._width;
+          }
+          pixel_t* row = &_data[size_t(iy - _yoffset) * size_t(_xsize)];
+          if (!_g._compressed)
+            _g.readrow(str, iw1, iy1, _xsize, row);
+          else {
+            int ts = reader._tsize, ty = iy1 / ts;
+            if (ty != ty0) {
+              reader.Strip(str, ty, strip);
+              ty0 = ty;
+            }
+            const pixel_t* srow = &strip[size_t(iy1 - ty * ts) * _g._width];
+            for (int ix = 0; ix < _xsize; ++ix) {
+              int ix1 = iw1 + ix;
+              row[ix] = srow[ix1 < _g._width ? ix1 : ix1 - _g._width];
+            }
+          }
+          ++_rows;
+        }
+      }
+      catch (const bad_alloc&) {
+        _error = "Insufficient memory for caching " + _g._filename;
+      }
+      catch (const exception& e) {
+        _error = string("Error filling cache ") + e.what();
+      }
+      _done = true;
+    }
+  };
+#else
+  class Geoid::Preloader {};
+#endif
+
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+  class Geoid::AsyncReader {
+  public:
+    struct Request {
+      const real* lat;
+      const real* lon;
+      real* h;
+      size_t n;
+      Completion* done;
+    };
+    const Geoid& _g;
+    const int _tsize;
+    mutex _mutex;
+    condition_variable _work, _idle;
+    deque<Request> _queue;      // The requests waiting to be served
+    size_t _active;             // The number of requests being served
+    bool _stop;
+    thread _worker;
+    explicit AsyncReader(const Geoid& g)
+      : _g(g)
+      , _tsize(g._compressed ? g._tilesize : asynctile_)
+      , _active(0)
+      , _stop(false)
+    { _worker = thread(&AsyncReader::Run, this); }
+    ~AsyncReader() {
+      {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+      }
+      _work.notify_one();
+      _worker.join();
+    }
+    void Submit(const Request& r) {
+      {
+        lock_guard<mutex> lock(_mutex);
+        _queue.push_back(r);
+      }
+      _work.notify_one();
+    }
+    void Wait() {
+      unique_lock<mutex> lock(_mutex);
+      while (!_queue.empty() || _active)
+        _idle.wait(lock);
+    }
+    // The cell containing (lat, lon), as found by Geoid::height.
+    void CellIndex(real lat, real lon, int& ix, int& iy) const {
+      lon = Math::AngNormalize(lon);
+      ix = int(floor(lon * _g._rlonres));
+      iy = min((_g._height - 1)/2 - 1, int(floor(-lat * _g._rlatres))) +
+        (_g._height - 1)/2;
+      ix += ix < 0 ? _g._width : (ix >= _g._width ? -_g._width : 0);
+    }
+    // The position in the grid of point k of the stencil for cell (ix, iy)
+    void Point(int ix, int iy, unsigned k, int& x, int& y) const {
+      const int* d = _g.stencil();
+      x = ix + d[2 * k];
+      y = iy + d[2 * k + 1];
+      x += x < 0 ? _g._width : (x >= _g._width ? -_g._width : 0);
+      _g.reflect(x, y);
+    }
+    int TileId(int x, int y) const {
+      return (y / _tsize) * ((_g._width + _tsize - 1) / _tsize) + x / _tsize;
+    }
+    void Run() {
+      // The requests which arrive while a group is being served are
+      // served together as the next group.  The tiles read for a group are
+      // retained (up to a budget of 16 MB) in recent.
+      ifstream str;
+      try {
+        _g.openstream(str);
+      }
+      catch (const exception&) {
+        // The reads of the tiles fail and the errors are reported.
+      }
+      unsigned long long
+        tilebytes = (unsigned long long)(_tsize) * _tsize * pixel_size_;
+      TileCache recent(_g, _tsize,
+                       size_t((max)(1ULL, (16ULL << 20) / tilebytes)), false);
+      for (;;) {
+        deque<Request> group;
+        {
+          unique_lock<mutex> lock(_mutex);
+          while (!_stop && _queue.empty())
+            _work.wait(lock);
+          if (_queue.empty()) return;
+          group.swap(_queue);
+          _active = group.size();
+        }
+        Serve(str, recent, group);
+        {
+          lock_guard<mutex> lock(_mutex);
+          _active = 0;
+        }
+        _idle.notify_all();
+      }
+    }
+    void Serve(istream& str, TileCache& recent, deque<Request>& group) {
+      typedef map<int, vector<pixel_t> > tiles_t;
+      tiles_t tiles;
+      map<int, string> errors;
+      try {
+        // Find the tiles needed by the group.
+        for (size_t r = 0; r < group.size(); ++r) {
+          const Request& q = group[r];
+          for (size_t i = 0; i < q.n; ++i) {
+            if (Math::isnan(q.lat[i]) || Math::isnan(q.lon[i])) continue;
+            int ix, iy, x, y;
+            CellIndex(q.lat[i], q.lon[i], ix, iy);
+            for (unsigned k = 0; k < _g.nstencil(); ++k) {
+              Point(ix, iy, k, x, y);
+              tiles[TileId(x, y)];
+            }
+          }
+        }
+        // Take the tiles held in recent and read the others (in the order of
+        // the file).
+        for (tiles_t::iterator t = tiles.begin(); t != tiles.end(); ++t) {
+          TileCache::map_t::iterator j = recent._index.find(t->first);
+          if (j != recent._index.end()) {
+            t->second.swap(j->second->second);
+            recent._tiles.erase(j->second);
+            recent._index.erase(j);
+            continue;
+          }
+          try {
+            recent.Read(str, t->first, t->second);
+          }
+          catch (const exception& e) {
+            errors[t->first] = string("Error reading ") + _g._filename +
+              ": " + e.what();
+            t->second.clear();
+            str.clear();
+          }
+        }
+      }
+      catch (const bad_alloc&) {
+        tiles.clear();
+        for (size_t r = 0; r < group.size(); ++r)
+          (*group[r].done)("Insufficient memory for reading " + _g._filename);
+        return;
+      }
+      // Compute the heights using the tiles.
+      int ntx = (_g._width + _tsize - 1) / _tsize;
+      for (size_t r = 0; r < group.size(); ++r) {
+        const Request& q = group[r];
+        string error;
+        Cell cell;
+        real v[stencilsize_], gradn, grade;
+        int cx = -1, cy = -1;
+        for (size_t i = 0; i < q.n && error.empty(); ++i) {
+          real lat = q.lat[i], lon = q.lon[i];
+          if (!(Math::isnan(lat) || Math::isnan(lon))) {
+            int ix, iy;
+            CellIndex(lat, lon, ix, iy);
+            if (!(ix == cx && iy == cy)) {
+              for (unsigned k = 0; k < _g.nstencil() && error.empty(); ++k) {
+                int x, y;
+                Point(ix, iy, k, x, y);
+                int id = TileId(x, y);
+                const vector<pixel_t>& tile = tiles[id];
+                if (tile.empty()) {
+                  error = errors[id];
+                  break;
+                }
+                int x0 = (id % ntx) * _tsize, y0 = (id / ntx) * _tsize,
+                  w = (min)(_tsize, _g._width - x0);
+                v[k] = real(tile[size_t(y - y0) * w + (x - x0)]);
+              }
+              if (!error.empty()) break;
+              _g.fillcell(ix, iy, v, cell);
+              cx = ix; cy = iy;
+            }
+          }
+          // This uses the coefficients in cell without reading any data.
+          q.h[i] = _g.height(lat, lon, false, gradn, grade, cell, true, true);
+        }
+        (*q.done)(error);
+      }
+      // Retain the tiles for later requests.
+      for (tiles_t::iterator t = tiles.begin(); t != tiles.end(); ++t)
+        if (!t->second.empty())
+          recent.Insert(t->first, t->second);
+    }
+  };
+
+  namespace {
+    // The mutex guarding the creation of the reader for HeightAsync.
+    mutex& AsyncMutex() {
+      static mutex asyncmutex;
+      return asyncmutex;
+    }
+  }
+#else
+  class Geoid::AsyncReader {};
+#endif
+
   Geoid::Geoid(const std::string& name, const std::string& path, bool cubic,
-               bool threadsafe)
+               bool threadsafe, bool hugepages)
     : _name(name)
     , _dir(path)
     , _cubic(cubic)
@@ -207,6 +753,17 @@ namespace GeographicLib {
     , _degree( Math::degree() )
     , _eps( sqrt(numeric_limits<real>::epsilon()) )
     , _threadsafe(false)        // Set after cache is read
+    , _hugepages(hugepages)
+    , _compressed(false)
+    , _tilesize(0)
+    , _map(0)
+    , _maplen(0)
+    , _mapstart(0)
+    , _maphandle(0)
+    , _tiles(0)
+    , _preload(0)
+    , _async(0)
+    , _source(0)
   {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(pixel_t) == pixel_size_,
                                 "pixel_t has the wrong size");
@@ -214,11 +771,22 @@ namespace GeographicLib {
       _dir = DefaultGeoidPath();
     _filename = _dir + "/" + _name + (pixel_size_ != 4 ? ".pgm" : ".pgm4");
     _file.open(_filename.c_str(), ios::binary);
-    if (!(_file.good()))
-      throw GeographicErr("File not readable " + _filename);
+    if (!(_file.good())) {
+      // Fall back to the compressed tiled file
+      string filename = _dir + "/" + _name +
+        (pixel_size_ != 4 ? ".tgm" : ".tgm4");
+      _file.clear();
+      _file.open(filename.c_str(), ios::binary);
+      if (!(_file.good()))
+        throw GeographicErr("File not readable " + _filename);
+      _filename = filename;
+      _compressed = true;
+    }
     string s;
-    if (!(getline(_file, s) && s == "P5"))
-      throw GeographicErr("File not in PGM format " + _filename);
+    if (!(getline(_file, s) && s == (_compressed ? "TGM1" : "P5")))
+      throw GeographicErr(string("File not in ") +
+                          (_compressed ? "TGM" : "PGM") + " format " +
+                          _filename);
     _offset = numeric_limits<real>::max();
     _scale = 0;
     _maxerror = _rmserror = -1;
@@ -243,6 +811,9 @@ namespace GeographicLib {
         } else if (key == "Scale") {
           if (!(is >> _scale))
             throw GeographicErr("Error reading scale " + _filename);
+        } else if (_compressed && key == "TileSize") {
+          if (!(is >> _tilesize))
+            throw GeographicErr("Error reading tile size " + _filename);
         } else if (key == (_cubic ? "MaxCubicError" : "MaxBilinearError")) {
           // It's not an error if the error can't be read
           is >> _maxerror;
@@ -282,33 +853,283 @@ namespace GeographicLib {
     if (!(_height & 1))
       // This is so that latitude grid includes the equator.
       throw GeographicErr("Raster height is even " + _filename);
+    unsigned long long len =
+      _datastart + pixel_size_ * _swidth * (unsigned long long)(_height);
+    if (_compressed) {
+      if (!(_tilesize > 0))
+        throw GeographicErr("Tile size not set " + _filename);
+      // The index gives the file offsets of the tiles and of the end of the
+      // file.
+      _tileindex.resize(size_t((_width + _tilesize - 1) / _tilesize) *
+                        size_t((_height + _tilesize - 1) / _tilesize) + 1);
+      try {
+        _file.seekg(ios::streamoff(_datastart));
+        Utility::readarray<unsigned long long, unsigned long long, true>
+          (_file, _tileindex);
+      }
+      catch (const exception&) {
+        throw GeographicErr("Error reading tile index " + _filename);
+      }
+      if (_tileindex[0] != _datastart + 8ULL * _tileindex.size())
+        throw GeographicErr("Bad tile index " + _filename);
+      for (size_t i = 1; i < _tileindex.size(); ++i)
+        if (_tileindex[i] < _tileindex[i - 1])
+          throw GeographicErr("Bad tile index " + _filename);
+      len = _tileindex.back();
+    }
     _file.seekg(0, ios::end);
-    if (!_file.good() ||
-        _datastart + pixel_size_ * _swidth * (unsigned long long)(_height) !=
-        (unsigned long long)(_file.tellg()))
+    if (!_file.good() || len != (unsigned long long)(_file.tellg()))
       // Possibly this test should be "<" because the file contains, e.g., a
       // second image.  However, for now we are more strict.
       throw GeographicErr("File has the wrong length " + _filename);
     _rlonres = _width / real(360);
     _rlatres = (_height - 1) / real(180);
     _cache = false;
-    _ix = _width;
-    _iy = _height;
     // Ensure that file errors throw exceptions
     _file.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
+    if (_compressed)
+      // The compressed data can only be read a tile at a time.
+      CacheTiles(0);
     if (threadsafe) {
       CacheAll();
       _file.close();
+      delete _tiles;
+      _tiles = 0;
       _threadsafe = true;
     }
   }
 
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+  namespace {
+    // The mutex serializing the reads of the data files by
+    // Geoid::operator()(real, real, Cell&).  This is shared by all Geoid
+    // objects; the reads are slow in any case.
+    mutex& FileMutex() {
+      static mutex filemutex;
+      return filemutex;
+    }
+  }
+#endif
+
+  Math::real Geoid::fileval(int ix, int iy, bool shared) const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    if (shared) {
+      lock_guard<mutex> lock(FileMutex());
+      return fileval(ix, iy, false);
+    }
+#else
+    (void)shared;
+#endif
+    if (_compressed)
+      // Only happens if CacheClear couldn't set up a tile cache.
+      throw GeographicErr("No tile cache for " + _filename);
+    try {
+      filepos(ix, iy);
+      // initial values to suppress warnings in case get fails
+      char a = 0, b = 0;
+      _file.get(a);
+      _file.get(b);
+      unsigned r = ((unsigned char)(a) << 8) | (unsigned char)(b);
+      if (pixel_size_ == 4) {
+        _file.get(a);
+        _file.get(b);
+        r = (r << 16) | ((unsigned char)(a) << 8) | (unsigned char)(b);
+      }
+      return real(r);
+    }
+    catch (const std::exception& e) {
+      // throw GeographicErr("Error reading " + _filename + ": "
+      //                      + e.what());
+      // triggers complaints about the "binary '+'" under Visual Studio.
+      // So use '+=' instead.
+      std::string err("Error reading ");
+      err += _filename;
+      err += ": ";
+      err += e.what();
+      throw GeographicErr(err);
+    }
+  }
+
+  Math::real Geoid::tileval(int ix, int iy, bool shared) const {
+    TileCache& tc = *_tiles;
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    // The background thread may change the cache.
+    lock_guard<mutex> lock(tc._mutex);
+#endif
+    int id = (iy / tc._tsize) * tc._ntx + ix / tc._tsize;
+    if (id != tc._lastid) {
+      TileCache::map_t::iterator i = tc._index.find(id);
+      if (i != tc._index.end()) {
+        // Move this tile to the front of the list
+        tc._tiles.splice(tc._tiles.begin(), tc._tiles, i->second);
+      } else {
+        ++tc._misses;
+        vector<pixel_t> data;
+        try {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+          if (shared) {
+            lock_guard<mutex> filelock(FileMutex());
+            tc.Read(_file, id, data);
+          } else
+#else
+          (void)shared;
+#endif
+            tc.Read(_file, id, data);
+        }
+        catch (const exception& e) {
+          std::string err("Error reading ");
+          err += _filename;
+          err += ": ";
+          err += e.what();
+          throw GeographicErr(err);
+        }
+        tc.Insert(id, data);
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+        if (tc._prefetch) tc.Neighbors(id);
+#endif
+        tc.Use(id, tc._tiles.front().second);
+        return real(tc._last[(iy - tc._lasty) * tc._lastw + (ix - tc._lastx)]);
+      }
+      tc.Use(id, tc._tiles.front().second);
+    }
+    ++tc._hits;
+    return real(tc._last[(iy - tc._lasty) * tc._lastw + (ix - tc._lastx)]);
+  }
+
+  void Geoid::CacheTiles(unsigned long long maxbytes, bool prefetch,
+                         int tilesize) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    if (_compressed)
+      tilesize = _tilesize;
+    else if (!(tilesize > 0))
+      throw GeographicErr("Tile size must be positive");
+    delete _tiles;
+    _tiles = 0;
+    unsigned long long
+      tilebytes = (unsigned long long)(tilesize) * tilesize * pixel_size_;
+    if (maxbytes == 0) {
+      if (!_compressed)
+        return;
+      // The default budget for a compressed file
+      maxbytes = (max)(16ULL << 20,
+                       2ULL * ((_width + tilesize - 1) / tilesize) * tilebytes);
+    }
+    unsigned long long ntiles = (max)(1ULL, maxbytes / tilebytes);
+    _tiles = new TileCache(*this, tilesize,
+                           size_t((min)(ntiles,
+                                        (unsigned long long)(_width/tilesize + 1)
+                                        * (_height/tilesize + 1))),
+                           prefetch);
+  }
+
+  unsigned long Geoid::TileHits() const {
+    if (!_tiles) return 0;
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    lock_guard<mutex> lock(_tiles->_mutex);
+#endif
+    return _tiles->_hits;
+  }
+
+  unsigned long Geoid::TileMisses() const {
+    if (!_tiles) return 0;
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    lock_guard<mutex> lock(_tiles->_mutex);
+#endif
+    return _tiles->_misses;
+  }
+
+  unsigned long Geoid::TileEvictions() const {
+    if (!_tiles) return 0;
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    lock_guard<mutex> lock(_tiles->_mutex);
+#endif
+    return _tiles->_evictions;
+  }
+
+  bool Geoid::Concurrent() const
+  { return GEOGRAPHICLIB_GEOID_THREADSAFE || _threadsafe || _map != 0; }
+
+  void Geoid::fitcell(int ix, int iy, bool shared, real t[]) const {
+    const int* d = stencil();
+    real v[stencilsize_];
+    for (unsigned k = 0; k < nstencil(); ++k)
+      v[k] = rawval(ix + d[2 * k], iy + d[2 * k + 1], shared);
+    fitvalues(iy, v, t);
+  }
+
+  void Geoid::fitvalues(int iy, const real v[], real t[]) const {
+    if (!_cubic)
+      copy(v, v + 4, t);
+    else {
+      const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
+      int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
+      // Evaluate t = v . c3x as a sum of the rows of c3x; this allows the
+      // inner loop to be vectorized while preserving the order of the
+      // summations for each element of t.
+      for (unsigned i = 0; i < nterms_; ++i)
+        t[i] = 0;
+      for (unsigned j = 0; j < stencilsize_; ++j)
+        for (unsigned i = 0; i < nterms_; ++i)
+          t[i] += v[j] * c3x[nterms_ * j + i];
+      for (unsigned i = 0; i < nterms_; ++i)
+        t[i] /= c0x;
+    }
+  }
+
+  void Geoid::fillcell(int ix, int iy, const real v[], Cell& cell) const {
+    real t[nterms_];
+    fitvalues(iy, v, t);
+    cell._geoid = this;
+    cell._ix = ix;
+    cell._iy = iy;
+    if (!_cubic) {
+      cell._v00 = t[0];
+      cell._v01 = t[1];
+      cell._v10 = t[2];
+      cell._v11 = t[3];
+    } else
+      copy(t, t + nterms_, cell._t);
+  }
+
+  void Geoid::gradfactors(real lat, real fac[]) const {
+    if (!_cubic) {
+      real
+        phi = lat * _degree,
+        cosphi = cos(phi),
+        sinphi = sin(phi),
+        n = 1/sqrt(1 - _e2 * sinphi * sinphi);
+      fac[0] = cosphi;
+      fac[1] = sinphi;
+      fac[2] = _degree * _a * (1 - _e2) * n * n * n;
+      fac[3] = _degree * _a * n;
+    } else {
+      // Avoid 0/0 at the poles by backing off 1/100 of a cell size
+      lat = min(lat,  90 - 1/(100 * _rlatres));
+      lat = max(lat, -90 + 1/(100 * _rlatres));
+      real fy = (90 - lat) * _rlatres;
+      fy -= int(fy);
+      real
+        phi = lat * _degree,
+        cosphi = cos(phi),
+        sinphi = sin(phi),
+        n = 1/sqrt(1 - _e2 * sinphi * sinphi);
+      fac[0] = fy;
+      fac[1] = - _rlatres / (_degree * _a * (1 - _e2) * n * n * n) * _scale;
+      fac[2] = _rlonres / (_degree * _a * n * cosphi) * _scale;
+    }
+  }
+
   Math::real Geoid::height(real lat, real lon, bool gradp,
-                           real& gradn, real& grade) const {
+                           real& gradn, real& grade,
+                           Cell& cell, bool usecell, bool shared,
+                           const real* gradfac) const {
     if (Math::isnan(lat) || Math::isnan(lon)) {
       if (gradp) gradn = grade = Math::NaN();
       return Math::NaN();
     }
+    if (_preload && !shared)
+      preloadpoll();
     lon = Math::AngNormalize(lon);
     real
       fx =  lon * _rlonres,
@@ -323,45 +1144,31 @@ namespace GeographicLib {
     real v00 = 0, v01 = 0, v10 = 0, v11 = 0;
     real t[nterms_];
 
-    if (_threadsafe || !(ix == _ix && iy == _iy)) {
+    if (!(usecell && cell._geoid == this && ix == cell._ix && iy == cell._iy)) {
+      if (!_coeffs.empty() && iy >= _cyoffset && iy < _cyoffset + _cysize &&
+          ((ix >= _cxoffset && ix < _cxoffset + _cxsize) ||
+           (ix + _width >= _cxoffset && ix + _width < _cxoffset + _cxsize))) {
+        const real* c = &_coeffs[ncoeffs() *
+                                 (size_t(iy - _cyoffset) * size_t(_cxsize) +
+                                  size_t(ix >= _cxoffset ? ix - _cxoffset :
+                                         ix + _width - _cxoffset))];
+        copy(c, c + ncoeffs(), t);
+      } else
+        fitcell(ix, iy, shared, t);
       if (!_cubic) {
-        v00 = rawval(ix    , iy    );
-        v01 = rawval(ix + 1, iy    );
-        v10 = rawval(ix    , iy + 1);
-        v11 = rawval(ix + 1, iy + 1);
-      } else {
-        real v[stencilsize_];
-        int k = 0;
-        v[k++] = rawval(ix    , iy - 1);
-        v[k++] = rawval(ix + 1, iy - 1);
-        v[k++] = rawval(ix - 1, iy    );
-        v[k++] = rawval(ix    , iy    );
-        v[k++] = rawval(ix + 1, iy    );
-        v[k++] = rawval(ix + 2, iy    );
-        v[k++] = rawval(ix - 1, iy + 1);
-        v[k++] = rawval(ix    , iy + 1);
-        v[k++] = rawval(ix + 1, iy + 1);
-        v[k++] = rawval(ix + 2, iy + 1);
-        v[k++] = rawval(ix    , iy + 2);
-        v[k++] = rawval(ix + 1, iy + 2);
-
-        const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
-        int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
-        for (unsigned i = 0; i < nterms_; ++i) {
-          t[i] = 0;
-          for (unsigned j = 0; j < stencilsize_; ++j)
-            t[i] += v[j] * c3x[nterms_ * j + i];
-          t[i] /= c0x;
-        }
+        v00 = t[0];
+        v01 = t[1];
+        v10 = t[2];
+        v11 = t[3];
       }
     } else { // same cell; used cached coefficients
       if (!_cubic) {
-        v00 = _v00;
-        v01 = _v01;
-        v10 = _v10;
-        v11 = _v11;
+        v00 = cell._v00;
+        v01 = cell._v01;
+        v10 = cell._v10;
+        v11 = cell._v11;
       } else
-        copy(_t, _t + nterms_, t);
+        copy(cell._t, cell._t + nterms_, t);
     }
     if (!_cubic) {
       real
@@ -370,28 +1177,30 @@ namespace GeographicLib {
         c = (1 - fy) * a + fy * b,
         h = _offset + _scale * c;
       if (gradp) {
-        real
-          phi = lat * _degree,
-          cosphi = cos(phi),
-          sinphi = sin(phi),
-          n = 1/sqrt(1 - _e2 * sinphi * sinphi);
+        real fac[ngradfac_];
+        if (!gradfac) {
+          gradfactors(lat, fac);
+          gradfac = fac;
+        }
+        real cosphi = gradfac[0], sinphi = gradfac[1];
         gradn = ((1 - fx) * (v00 - v10) + fx * (v01 - v11)) *
-          _rlatres / (_degree * _a * (1 - _e2) * n * n * n);
+          _rlatres / gradfac[2];
         grade = (cosphi > _eps ?
                  ((1 - fy) * (v01 - v00) + fy * (v11 - v10)) /   cosphi :
                  (sinphi > 0 ? v11 - v10 : v01 - v00) *
                  _rlatres / _degree ) *
-          _rlonres / (_degree * _a * n);
+          _rlonres / gradfac[3];
         gradn *= _scale;
         grade *= _scale;
       }
-      if (!_threadsafe) {
-        _ix = ix;
-        _iy = iy;
-        _v00 = v00;
-        _v01 = v01;
-        _v10 = v10;
-        _v11 = v11;
+      if (usecell) {
+        cell._geoid = this;
+        cell._ix = ix;
+        cell._iy = iy;
+        cell._v00 = v00;
+        cell._v01 = v01;
+        cell._v10 = v10;
+        cell._v11 = v11;
       }
       return h;
     } else {
@@ -400,61 +1209,192 @@ namespace GeographicLib {
              fy * (t[5] + fx * t[8] + fy * t[9]));
       h = _offset + _scale * h;
       if (gradp) {
-        // Avoid 0/0 at the poles by backing off 1/100 of a cell size
-        lat = min(lat,  90 - 1/(100 * _rlatres));
-        lat = max(lat, -90 + 1/(100 * _rlatres));
-        fy = (90 - lat) * _rlatres;
-        fy -= int(fy);
-        real
-          phi = lat * _degree,
-          cosphi = cos(phi),
-          sinphi = sin(phi),
-          n = 1/sqrt(1 - _e2 * sinphi * sinphi);
+        real fac[ngradfac_];
+        if (!gradfac) {
+          gradfactors(lat, fac);
+          gradfac = fac;
+        }
+        fy = gradfac[0];
         gradn = t[2] + fx * (t[4] + fx * t[7]) +
           fy * (2 * t[5] + fx * 2 * t[8] + 3 * fy * t[9]);
         grade = t[1] + fx * (2 * t[3] + fx * 3 * t[6]) +
           fy * (t[4] + fx * 2 * t[7] + fy * t[8]);
-        gradn *= - _rlatres / (_degree * _a * (1 - _e2) * n * n * n) * _scale;
-        grade *= _rlonres / (_degree * _a * n * cosphi) * _scale;
+        gradn *= gradfac[1];
+        grade *= gradfac[2];
       }
-      if (!_threadsafe) {
-        _ix = ix;
-        _iy = iy;
-        copy(t, t + nterms_, _t);
+      if (usecell) {
+        cell._geoid = this;
+        cell._ix = ix;
+        cell._iy = iy;
+        copy(t, t + nterms_, cell._t);
       }
       return h;
     }
   }
 
+  void Geoid::HeightBatch(const real lat[], const real lon[], real h[],
+                          size_t n) const {
+    // Sort blocks of points by grid cell so that the interpolating
+    // coefficients for a cell are only computed once per block.
+    size_t nb = (min)(n, size_t(nsort_));
+    vector< pair<long long, size_t> > order(nb);
+    Cell cell;
+    real gradn, grade;
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = (min)(nb, n - i0);
+      for (size_t i = 0; i < m; ++i) {
+        real lat1 = lat[i0 + i], lon1 = lon[i0 + i];
+        long long key = -1;     // NaNs go first
+        if (!(Math::isnan(lat1) || Math::isnan(lon1))) {
+          // This need not be the same as the cell used by height; it's only
+          // used to group the points.
+          real
+            fx =  Math::AngNormalize(lon1) * _rlonres,
+            fy = -lat1 * _rlatres;
+          key = (long long)(floor(fy) + _height) * (2 * _width) +
+            (long long)(floor(fx) + _width);
+        }
+        order[i] = make_pair(key, i0 + i);
+      }
+      sort(order.begin(), order.begin() + m);
+      for (size_t i = 0; i < m; ++i) {
+        size_t j = order[i].second;
+        h[j] = height(lat[j], lon[j], false, gradn, grade, cell, true, true);
+      }
+    }
+  }
+
+  void Geoid::HeightAsync(const real lat[], const real lon[], real h[],
+                          size_t n, Completion& done) const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    if (!(_threadsafe || _map)) {
+      AsyncReader::Request r;
+      r.lat = lat; r.lon = lon; r.h = h; r.n = n; r.done = &done;
+      lock_guard<mutex> lock(AsyncMutex());
+      if (!_async)
+        _async = new AsyncReader(*this);
+      _async->Submit(r);
+      return;
+    }
+#endif
+    string error;
+    try {
+      HeightBatch(lat, lon, h, n);
+    }
+    catch (const exception& e) {
+      error = e.what();
+    }
+    done(error);
+  }
+
+  void Geoid::AsyncWait() const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    AsyncReader* async;
+    {
+      lock_guard<mutex> lock(AsyncMutex());
+      async = _async;
+    }
+    if (async) async->Wait();
+#endif
+  }
+
+  void Geoid::ConvertHeightBatch(const real lat[], const real lon[],
+                                 const real h[], size_t n, convertflag d,
+                                 real hout[]) const {
+    // Evaluate the geoid heights into hout (which may be the same as h).
+    size_t nb = (min)(n, size_t(nsort_));
+    vector<real> geoid(nb);
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = (min)(nb, n - i0);
+      HeightBatch(lat + i0, lon + i0, &geoid[0], m);
+      for (size_t i = 0; i < m; ++i)
+        hout[i0 + i] = h[i0 + i] + real(d) * geoid[i];
+    }
+  }
+
+  void Geoid::HeightGrid(real lat0, real dlat, size_t nlat,
+                         real lon0, real dlon, size_t nlon,
+                         real h[], real gradn[], real grade[]) const {
+    if (nlat == 0 || nlon == 0)
+      return;
+    bool gradp = gradn && grade;
+    // The cell cache for each column and the x index of the data cell for
+    // each column.  These indices are only used to decide whether to copy
+    // the cell of the previous column; height checks the cell in any case.
+    vector<Cell> cells(nlon);
+    vector<int> ixs(nlon);
+    for (size_t j = 0; j < nlon; ++j) {
+      real lon = lon0 + real(j) * dlon;
+      ixs[j] = Math::isnan(lon) ? -1 :
+        int(floor(Math::AngNormalize(lon) * _rlonres));
+      ixs[j] += ixs[j] < 0 ? _width : (ixs[j] >= _width ? -_width : 0);
+    }
+    real gn, ge, fac[ngradfac_];
+    for (size_t i = 0; i < nlat; ++i) {
+      real lat = lat0 + real(i) * dlat;
+      if (gradp)
+        // The factors for the gradient are the same for each point in a row.
+        gradfactors(lat, fac);
+      int iy = Math::isnan(lat) ? -1 :
+        min((_height - 1)/2 - 1, int(floor(-lat * _rlatres))) +
+        (_height - 1)/2;
+      for (size_t j = 0; j < nlon; ++j) {
+        Cell& cell = cells[j];
+        if (j > 0 && !(cell._geoid == this &&
+                       cell._ix == ixs[j] && cell._iy == iy)) {
+          const Cell& prev = cells[j - 1];
+          if (prev._geoid == this && prev._ix == ixs[j] && prev._iy == iy)
+            cell = prev;
+        }
+        size_t k = i * nlon + j;
+        h[k] = height(lat, lon0 + real(j) * dlon, gradp,
+                      gradp ? gradn[k] : gn, gradp ? grade[k] : ge,
+                      cell, true, true, fac);
+      }
+    }
+  }
+
   void Geoid::CacheClear() const {
     if (!_threadsafe) {
+      delete _preload;
+      _preload = 0;
+      delete _tiles;
+      _tiles = 0;
       _cache = false;
+      try {
+        // Use swap to release memory back to system
+        vector<real>().swap(_coeffs);
+      }
+      catch (const exception&) {
+      }
       try {
         _data.clear();
         // Use swap to release memory back to system
-        vector< vector<pixel_t> >().swap(_data);
+        vector<pixel_t>().swap(_data);
       }
       catch (const exception&) {
       }
+      if (_compressed) {
+        try {
+          CacheTiles(0);
+        }
+        catch (const exception&) {
+        }
+      }
     }
   }
 
-  void Geoid::CacheArea(real south, real west, real north, real east) const {
-    if (_threadsafe)
-      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
-    if (south > north) {
-      CacheClear();
-      return;
-    }
+  void Geoid::cacherange(real south, real west, real north, real east,
+                         int& iw, int& in, int& xsize, int& ysize) const {
     west = Math::AngNormalize(west); // west in [-180, 180)
     east = Math::AngNormalize(east);
     if (east <= west)
       east += 360;              // east - west in (0, 360]
     int
-      iw = int(floor(west * _rlonres)),
       ie = int(floor(east * _rlonres)),
-      in = int(floor(-north * _rlatres)) + (_height - 1)/2,
       is = int(floor(-south * _rlatres)) + (_height - 1)/2;
+    iw = int(floor(west * _rlonres));
+    in = int(floor(-north * _rlatres)) + (_height - 1)/2;
     in = max(0, min(_height - 2, in));
     is = max(0, min(_height - 2, is));
     is += 1;
@@ -473,16 +1413,52 @@ namespace GeographicLib {
       ie += iw < 0 ? _width : (iw >= _width ? -_width : 0);
       iw += iw < 0 ? _width : (iw >= _width ? -_width : 0);
     }
-    int oysize = int(_data.size());
-    _xsize = ie - iw + 1;
-    _ysize = is - in + 1;
+    xsize = ie - iw + 1;
+    ysize = is - in + 1;
+  }
+
+  void Geoid::readrow(istream& str, int ix, int iy, int n,
+                      pixel_t row[]) const {
+    int xs1 = min(_width - ix, n);
+    str.seekg(ios::streamoff
+              (_datastart + pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix))));
+    Utility::readarray<pixel_t, pixel_t, true>(str, row, xs1);
+    if (xs1 < n) {
+      // Wrap around longitude = 0
+      str.seekg(ios::streamoff(_datastart + pixel_size_ * unsigned(iy)*_swidth));
+      Utility::readarray<pixel_t, pixel_t, true>(str, row + xs1, n - xs1);
+    }
+  }
+
+  void Geoid::openstream(ifstream& str) const {
+    if (_source)
+      return;
+    str.open(_filename.c_str(), ios::binary);
+    if (!str.good())
+      throw GeographicErr("File not readable " + _filename);
+    str.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
+  }
+
+  void Geoid::CacheArea(real south, real west, real north, real east) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    delete _preload;
+    _preload = 0;
+    if (south > north) {
+      CacheClear();
+      return;
+    }
+    int iw, in;
+    cacherange(south, west, north, east, iw, in, _xsize, _ysize);
     _xoffset = iw;
     _yoffset = in;
+    int is = in + _ysize - 1;
 
     try {
-      _data.resize(_ysize, vector<pixel_t>(_xsize));
-      for (int iy = min(oysize, _ysize); iy--;)
-        _data[iy].resize(_xsize);
+      size_t npixels = size_t(_xsize) * size_t(_ysize);
+      if (_hugepages)
+        Utility::reservehugepages(_data, npixels);
+      _data.resize(npixels);
     }
     catch (const bad_alloc&) {
       CacheClear();
@@ -499,16 +1475,14 @@ namespace GeographicLib {
           if (iw1 >= _width)
             iw1 -= _width;
         }
-        int xs1 = min(_width - iw1, _xsize);
-        filepos(iw1, iy1);
-        Utility::readarray<pixel_t, pixel_t, true>
-          (_file, &(_data[iy - in][0]), xs1);
-        if (xs1 < _xsize) {
-          // Wrap around longitude = 0
-          filepos(0, iy1);
-          Utility::readarray<pixel_t, pixel_t, true>
-            (_file, &(_data[iy - in][xs1]), _xsize - xs1);
-        }
+        if (_compressed) {
+          for (int ix = 0; ix < _xsize; ++ix)
+            _data[size_t(iy - in) * size_t(_xsize) + ix] =
+              pixel_t(tileval(iw1 + ix - (iw1 + ix < _width ? 0 : _width),
+                              iy1, false));
+        } else
+          readrow(_file, iw1, iy1, _xsize,
+                  &_data[size_t(iy - in) * size_t(_xsize)]);
       }
       _cache = true;
     }
@@ -518,6 +1492,347 @@ namespace GeographicLib {
     }
   }
 
+  void Geoid::Preload(real south, real west, real north, real east) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    delete _preload;
+    _preload = 0;
+    if (south > north)
+      return;
+    int iw, in, xsize, ysize;
+    cacherange(south, west, north, east, iw, in, xsize, ysize);
+    _preload = new Preloader(*this, iw, in, xsize, ysize);
+#else
+    CacheArea(south, west, north, east);
+#endif
+  }
+
+  void Geoid::preloadpoll() const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    if (!_preload->_done)
+      return;
+    if (_preload->_error.empty()) {
+      _data.swap(_preload->_data);
+      _xoffset = _preload->_xoffset;
+      _yoffset = _preload->_yoffset;
+      _xsize = _preload->_xsize;
+      _ysize = _preload->_ysize;
+      _cache = true;
+    }
+    delete _preload;
+    _preload = 0;
+#endif
+  }
+
+  bool Geoid::PreloadDone() const {
+    if (_preload)
+      preloadpoll();
+    return !_preload;
+  }
+
+  void Geoid::PreloadWait() const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    if (!_preload)
+      return;
+    _preload->_worker.join();
+    string err(_preload->_error);
+    preloadpoll();
+    if (!err.empty())
+      throw GeographicErr(err);
+#endif
+  }
+
+  Math::real Geoid::PreloadProgress() const {
+#if GEOGRAPHICLIB_GEOID_THREADSAFE
+    if (_preload)
+      return _preload->_ysize > 0 ?
+        real(_preload->_rows) / _preload->_ysize : real(1);
+#endif
+    return 1;
+  }
+
+  void Geoid::CacheCoefficients(real south, real west, real north, real east)
+    const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    vector<real>().swap(_coeffs);
+    if (south > north)
+      return;
+    west = Math::AngNormalize(west); // west in [-180, 180)
+    east = Math::AngNormalize(east);
+    if (east <= west)
+      east += 360;              // east - west in (0, 360]
+    // The range of cells, as computed by height
+    int
+      iw = int(floor(west * _rlonres)),
+      ie = int(floor(east * _rlonres)),
+      in = int(floor(-north * _rlatres)) + (_height - 1)/2,
+      is = int(floor(-south * _rlatres)) + (_height - 1)/2;
+    in = max(0, min(_height - 2, in));
+    is = max(0, min(_height - 2, is));
+    if (ie - iw >= _width - 1) {
+      iw = 0;
+      ie = _width - 1;
+    } else {
+      ie += iw < 0 ? _width : (iw >= _width ? -_width : 0);
+      iw += iw < 0 ? _width : (iw >= _width ? -_width : 0);
+    }
+    int xsize = ie - iw + 1, ysize = is - in + 1;
+    vector<real> coeffs;
+    try {
+      coeffs.resize(ncoeffs() * size_t(xsize) * size_t(ysize));
+    }
+    catch (const bad_alloc&) {
+      throw GeographicErr("Insufficient memory for caching coefficients " +
+                          _filename);
+    }
+    for (int iy = 0; iy < ysize; ++iy)
+      for (int ix = 0; ix < xsize; ++ix) {
+        int ix1 = iw + ix;
+        fitcell(ix1 < _width ? ix1 : ix1 - _width, in + iy, false,
+                &coeffs[ncoeffs() * (size_t(iy) * size_t(xsize) +
+                                     size_t(ix))]);
+      }
+    _cxoffset = iw;
+    _cyoffset = in;
+    _cxsize = xsize;
+    _cysize = ysize;
+    _coeffs.swap(coeffs);
+  }
+
+  Geoid::Geoid(const Source& source, bool cubic)
+    : _name(source.Name())
+    , _cubic(cubic)
+    , _a( Constants::WGS84_a() )
+    , _e2( (2 - Constants::WGS84_f()) * Constants::WGS84_f() )
+    , _degree( Math::degree() )
+    , _eps( sqrt(numeric_limits<real>::epsilon()) )
+    , _description(source.Description())
+    , _datetime("UNKNOWN")
+    , _offset(source.Offset())
+    , _scale(source.Scale())
+    , _maxerror(-1)
+    , _rmserror(-1)
+    , _width(source.Width())
+    , _height(source.Height())
+    , _datastart(0)
+    , _swidth((unsigned long long)(_width))
+    , _threadsafe(false)
+    , _hugepages(false)
+    , _compressed(true)
+    , _tilesize(source.TileSize())
+    , _cache(false)
+    , _map(0)
+    , _maplen(0)
+    , _mapstart(0)
+    , _maphandle(0)
+    , _tiles(0)
+    , _preload(0)
+    , _async(0)
+    , _source(&source)
+  {
+    // The name of the source stands in for the file name in messages.
+    _filename = _name;
+    if (!(Math::isfinite(_offset) && Math::isfinite(_scale) && _scale > 0))
+      throw GeographicErr("Bad offset or scale for " + _filename);
+    if (_height < 2 || _width < 2 || (_width & 1) || !(_height & 1))
+      throw GeographicErr("Bad raster size for " + _filename);
+    if (!(_tilesize > 0))
+      throw GeographicErr("Tile size not set for " + _filename);
+    _rlonres = _width / real(360);
+    _rlatres = (_height - 1) / real(180);
+    CacheTiles(0);
+  }
+
+  Geoid::~Geoid() {
+    // Complete the queued requests
+    delete _async;
+    delete _preload;
+    delete _tiles;
+    CacheUnmap();
+  }
+
+  void Geoid::CacheMap() const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    if (_map)
+      return;
+    if (_compressed)
+      throw GeographicErr("Cannot map compressed file " + _filename);
+    // The length of the file was checked in the constructor.
+    mapfile(_filename, _datastart,
+            _datastart + pixel_size_ * _swidth * (unsigned long long)(_height));
+  }
+
+  void Geoid::mapfile(const std::string& filename, unsigned long long start,
+                      unsigned long long len) const {
+#if !GEOGRAPHICLIB_GEOID_MMAP
+    (void)start;
+    (void)len;
+    throw GeographicErr("Memory mapping not supported for " + filename);
+#elif defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, 0,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+      throw GeographicErr("Cannot open for mapping " + filename);
+    LARGE_INTEGER size;
+    // Check that the file hasn't changed since it was opened.
+    if (!GetFileSizeEx(file, &size) ||
+        (unsigned long long)(size.QuadPart) != len) {
+      CloseHandle(file);
+      throw GeographicErr("File has the wrong length " + filename);
+    }
+    // The mapping object keeps the file open.
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping)
+      throw GeographicErr("Cannot map " + filename);
+    const void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!addr) {
+      CloseHandle(mapping);
+      throw GeographicErr("Cannot map " + filename);
+    }
+    _maphandle = mapping;
+    _map = static_cast<const unsigned char*>(addr);
+    _maplen = len;
+    _mapstart = start;
+#else
+    if (len != (unsigned long long)(size_t(len)))
+      throw GeographicErr("File too large to map " + filename);
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("Cannot open for mapping " + filename);
+    struct stat st;
+    // Check that the file hasn't changed since it was opened.
+    if (fstat(fd, &st) != 0 ||
+        (unsigned long long)(st.st_size) != len) {
+      close(fd);
+      throw GeographicErr("File has the wrong length " + filename);
+    }
+    // The mapping remains valid after the file is closed.
+    void* addr = mmap(0, size_t(len), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw GeographicErr("Cannot map " + filename);
+    if (_hugepages)
+      Utility::advisehugepages(addr, size_t(len));
+    _map = static_cast<const unsigned char*>(addr);
+    _maplen = len;
+    _mapstart = start;
+#endif
+  }
+
+  std::string Geoid::sharedheader() const {
+    // The offset and scale are written exactly
+    return "# Shared copy of " + _filename + "\n" +
+      "# Description " + _description + "\n" +
+      "# DateTime " + _datetime + "\n" +
+      "# Offset " + Utility::shortstr(_offset) + "\n" +
+      "# Scale " + Utility::shortstr(_scale) + "\n";
+  }
+
+  bool Geoid::attachshared(const std::string& filename) const {
+    // Check the header of the shared copy; this needs to match the geometry
+    // of the data and the comments identifying the data file, its offset,
+    // and its scale.
+    ifstream str(filename.c_str(), ios::binary);
+    if (!str.good())
+      return false;
+    string s, comments;
+    int width, height;
+    unsigned maxval;
+    if (!(getline(str, s) && s == "P5"))
+      return false;
+    while (getline(str, s) && (s.empty() || s[0] == '#'))
+      if (!s.empty()) comments += s + "\n";
+    if (comments != sharedheader())
+      return false;
+    istringstream is(s);
+    if (!(is >> width >> height && width == _width && height == _height &&
+          str >> maxval && maxval == pixel_max_))
+      return false;
+    // Add 1 for whitespace after maxval
+    unsigned long long start = (unsigned long long)(str.tellg()) + 1ULL;
+    str.close();
+    mapfile(filename, start,
+            start + pixel_size_ * _swidth * (unsigned long long)(_height));
+    return true;
+  }
+
+  void Geoid::CacheShared(const std::string& filename) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    CacheUnmap();
+#if !GEOGRAPHICLIB_GEOID_MMAP
+    throw GeographicErr("Memory mapping not supported for " + filename);
+#else
+    if (attachshared(filename))
+      return;
+    // Write all the data to a temporary file and rename it, so that other
+    // processes never see a partially written file.
+    ostringstream tmp;
+#  if defined(_WIN32)
+    tmp << filename << ".tmp" << GetCurrentProcessId();
+#  else
+    tmp << filename << ".tmp" << getpid();
+#  endif
+    string tmpname(tmp.str());
+    try {
+      ofstream out(tmpname.c_str(), ios::binary);
+      if (!out.good())
+        throw GeographicErr("File not writable " + tmpname);
+      out.exceptions(ofstream::eofbit | ofstream::failbit | ofstream::badbit);
+      out << "P5\n" << sharedheader()
+          << _width << " " << _height << "\n" << pixel_max_ << "\n";
+      ifstream str;
+      openstream(str);
+      vector<pixel_t> row(_width), strip;
+      if (_compressed) {
+        TileCache reader(*this, _tilesize, 1, false);
+        for (int ty = 0; ty * _tilesize < _height; ++ty) {
+          reader.Strip(str, ty, strip);
+          Utility::writearray<pixel_t, pixel_t, true>(out, strip);
+        }
+      } else {
+        for (int iy = 0; iy < _height; ++iy) {
+          readrow(str, 0, iy, _width, &row[0]);
+          Utility::writearray<pixel_t, pixel_t, true>(out, row);
+        }
+      }
+      out.close();
+      // On Windows, this fails if another process created the file in the
+      // meantime; in this case, use that file.
+      if (rename(tmpname.c_str(), filename.c_str()) != 0)
+        remove(tmpname.c_str());
+    }
+    catch (const exception& e) {
+      remove(tmpname.c_str());
+      throw GeographicErr(string("Error creating shared cache ") + e.what());
+    }
+    if (!attachshared(filename))
+      throw GeographicErr("Cannot attach shared cache " + filename);
+#endif
+  }
+
+  void Geoid::CacheUnmap() const {
+    if (!_map)
+      return;
+#if GEOGRAPHICLIB_GEOID_MMAP
+#  if defined(_WIN32)
+    UnmapViewOfFile(_map);
+    CloseHandle(static_cast<HANDLE>(_maphandle));
+#  else
+    munmap(const_cast<unsigned char*>(_map), size_t(_maplen));
+#  endif
+#endif
+    _map = 0;
+    _maplen = 0;
+    _mapstart = 0;
+    _maphandle = 0;
+  }
+
   std::string Geoid::DefaultGeoidPath() {
     string path;
     char* geoidpath = getenv("GEOGRAPHICLIB_GEOID_PATH");
@@ -0,0 +1,138 @@
+/**
+ * \file GeoidGenerator.cpp
+ * \brief Implementation for GeographicLib::GeoidGenerator class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GeoidGenerator.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#if defined(_WIN32)
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#    define WIN32_LEAN_AND_MEAN 1
+#  endif
+#  if !defined(NOMINMAX)
+#    define NOMINMAX 1
+#  endif
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  // The body of the parallel loop over the rows of a block
+  class GeoidGenerator::Rows {
+  private:
+    const GravityModel& _model;
+    const real _ndeg;
+    const int _x0, _y0, _w;
+    real* _N;
+    Rows& operator=(const Rows&);
+  public:
+    Rows(const GravityModel& model, int ndeg, int x0, int y0, int w, real N[])
+      : _model(model), _ndeg(ndeg), _x0(x0), _y0(y0), _w(w), _N(N) {}
+    void operator()(size_t i0, size_t i1) const {
+      for (size_t j = i0; j < i1; ++j) {
+        real lat = 90 - (_y0 + int(j)) / _ndeg;
+        _model.Circle(lat, 0, GravityModel::GEOID_HEIGHT).
+          GeoidHeightRow(_x0 / _ndeg, 1 / _ndeg, _w, _N + j * size_t(_w));
+      }
+    }
+  };
+
+  GeoidGenerator::GeoidGenerator(const GravityModel& model, int ndeg,
+                                 const std::string& cachedir, int tilesize,
+                                 int nthreads)
+    : _model(model)
+    , _ndeg(ndeg)
+    , _tilesize(tilesize)
+    , _nthreads(max(nthreads, 1))
+    , _cachedir(cachedir)
+  {
+    if (!(_ndeg >= 1 && _ndeg <= 3600))
+      throw GeographicErr("Points per degree " + Utility::str(_ndeg)
+                          + " not in [1, 3600]");
+    if (!(_tilesize > 0))
+      throw GeographicErr("Tile size " + Utility::str(_tilesize)
+                          + " not positive");
+    _name = _model.GravityModelName() + "-n" +
+      Utility::str(_model.Degree()) + "-" + Utility::str(_ndeg);
+  }
+
+  std::string GeoidGenerator::Description() const {
+    return "Computed from " + _model.GravityModelName() + " (" +
+      _model.Description() + ")";
+  }
+
+  void GeoidGenerator::Compute(int x0, int y0, int w, int h, real N[])
+    const {
+    Executor::For(size_t(h), size_t(_nthreads),
+                  Rows(_model, _ndeg, x0, y0, w, N));
+  }
+
+  void GeoidGenerator::Heights(int x0, int y0, int w, int h, real N[])
+    const {
+    if (_cachedir.empty()) {
+      Compute(x0, y0, w, h, N);
+      return;
+    }
+    size_t n = size_t(w) * size_t(h);
+    string filename = _cachedir + "/" + _name + "-" + Utility::str(x0) + "-"
+      + Utility::str(y0) + "-" + Utility::str(w) + "-" + Utility::str(h)
+      + ".dat";
+    {
+      ifstream str(filename.c_str(), ios::binary);
+      if (str.good()) {
+        try {
+          Utility::readarray<float, real, true>(str, N, n);
+          if (str.peek() == char_traits<char>::eof())
+            return;
+        }
+        catch (const exception&) {
+          // Fall through to compute the block
+        }
+      }
+    }
+    Compute(x0, y0, w, h, N);
+    // Write to a temporary file and rename it, so that other threads and
+    // processes never see a partially written file.  Concurrent callers have
+    // different output arrays, so N distinguishes the threads of a process.
+    ostringstream tmp;
+#if defined(_WIN32)
+    tmp << filename << ".tmp" << GetCurrentProcessId();
+#else
+    tmp << filename << ".tmp" << getpid();
+#endif
+    tmp << "-" << static_cast<const void*>(N);
+    string tmpname(tmp.str());
+    try {
+      ofstream out(tmpname.c_str(), ios::binary);
+      if (!out.good())
+        throw GeographicErr("File not writable " + tmpname);
+      out.exceptions(ofstream::eofbit | ofstream::failbit | ofstream::badbit);
+      Utility::writearray<float, real, true>(out, N, n);
+      out.close();
+      // On Windows, this fails if another process created the file in the
+      // meantime; in this case, use that file.
+      if (rename(tmpname.c_str(), filename.c_str()) != 0)
+        remove(tmpname.c_str());
+    }
+    catch (const exception& e) {
+      remove(tmpname.c_str());
+      throw GeographicErr(string("Error saving geoid tile ") + e.what());
+    }
+  }
+
+} // namespace GeographicLib
@@ -26,6 +26,17 @@ namespace GeographicLib {
     , _f(_earth.Flattening())
   {}
 
+  void Gnomonic::Planar(real azi0, real m, real M, real& x, real& y) {
+    if (M <= 0)
+      x = y = Math::NaN();
+    else {
+      real rho = m/M;
+      azi0 *= Math::degree();
+      x = rho * sin(azi0);
+      y = rho * cos(azi0);
+    }
+  }
+
   void Gnomonic::Forward(real lat0, real lon0, real lat, real lon,
                          real& x, real& y, real& azi, real& rk)
     const {
@@ -35,31 +46,32 @@ namespace GeographicLib {
                       Geodesic::GEODESICSCALE,
                       t, azi0, azi, m, M, t, t);
     rk = M;
-    if (M <= 0)
-      x = y = Math::NaN();
-    else {
-      real rho = m/M;
-      azi0 *= Math::degree();
-      x = rho * sin(azi0);
-      y = rho * cos(azi0);
-    }
+    Planar(azi0, m, M, x, y);
   }
 
-  void Gnomonic::Reverse(real lat0, real lon0, real x, real y,
-                         real& lat, real& lon, real& azi, real& rk)
+  void Gnomonic::ForwardBatch(real lat0, real lon0,
+                              const real lat[], const real lon[], size_t n,
+                              real x[], real y[], real azi[], real rk[])
     const {
-    real
-      azi0 = atan2(x, y) / Math::degree(),
-      rho = Math::hypot(x, y),
-      s = _a * atan(rho/_a);
+    const Geodesic::Point p0(_earth, lat0, lon0);
+    for (size_t i = 0; i < n; ++i) {
+      real azi0, azi2, m, M, t;
+      _earth.GenInverse(p0, Geodesic::Point(_earth, lat[i], lon[i]),
+                        Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH |
+                        Geodesic::GEODESICSCALE,
+                        t, azi0, azi2, m, M, t, t);
+      Planar(azi0, m, M, x[i], y[i]);
+      if (azi) azi[i] = azi2;
+      if (rk) rk[i] = M;
+    }
+  }
+
+  void Gnomonic::Solve(const GeodesicLine& line, real rho,
+                       real& lat, real& lon, real& azi, real& rk) const {
+    real s = _a * atan(rho/_a);
     bool little = rho <= _a;
     if (!little)
       rho = 1/rho;
-    GeodesicLine line(_earth.Line(lat0, lon0, azi0,
-                                  Geodesic::LATITUDE | Geodesic::LONGITUDE |
-                                  Geodesic::AZIMUTH | Geodesic::DISTANCE_IN |
-                                  Geodesic::REDUCEDLENGTH |
-                                  Geodesic::GEODESICSCALE));
     int count = numit_, trip = 0;
     real lat1, lon1, azi1, M;
     while (count--) {
@@ -79,7 +91,34 @@ namespace GeographicLib {
       lat = lat1; lon = lon1; azi = azi1; rk = M;
     } else
       lat = lon = azi = rk = Math::NaN();
-    return;
+  }
+
+  void Gnomonic::Reverse(real lat0, real lon0, real x, real y,
+                         real& lat, real& lon, real& azi, real& rk)
+    const {
+    real azi0 = atan2(x, y) / Math::degree();
+    Solve(_earth.Line(lat0, lon0, azi0, LineCaps()), Math::hypot(x, y),
+          lat, lon, azi, rk);
+  }
+
+  void Gnomonic::ReverseBatch(real lat0, real lon0,
+                              const real x[], const real y[], size_t n,
+                              real lat[], real lon[], real azi[], real rk[])
+    const {
+    GeodesicLine line;
+    real azil = Math::NaN();
+    for (size_t i = 0; i < n; ++i) {
+      real azi0 = atan2(x[i], y[i]) / Math::degree(), azi2, rk2;
+      // Only construct a new line when the direction changes (distinguishing
+      // between +0 and -0).
+      if (!(azi0 == azil && (azi0 != 0 || 1/azi0 == 1/azil))) {
+        line = _earth.Line(lat0, lon0, azi0, LineCaps());
+        azil = azi0;
+      }
+      Solve(line, Math::hypot(x[i], y[i]), lat[i], lon[i], azi2, rk2);
+      if (azi) azi[i] = azi2;
+      if (rk) rk[i] = rk2;
+    }
   }
 
 } // namespace GeographicLib
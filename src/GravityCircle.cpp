@@ -68,6 +68,81 @@ namespace GeographicLib {
     eta = -(deltax/_gamma) / Math::degree();
   }
 
+  void GravityCircle::GravityRow(real lon0, real dlon, int nlon,
+                                 real W[], real gx[], real gy[], real gz[])
+    const {
+    if ((_caps & GRAVITY) != GRAVITY) {
+      for (int j = 0; j < nlon; ++j)
+        W[j] = gx[j] = gy[j] = gz[j] = Math::NaN();
+      return;
+    }
+    _gravitational.EvaluateRow(lon0, dlon, nlon, W, gx, gy, gz);
+    real f = _GMmodel / _amodel;
+    for (int j = 0; j < nlon; ++j) {
+      // Follow V, W, and Gravity
+      real clam, slam, M[Geocentric::dim2_];
+      CircularEngine::cossin(lon0 + j * dlon, clam, slam);
+      real
+        gX = gx[j] * f + _frot * clam,
+        gY = gy[j] * f + _frot * slam,
+        gZ = gz[j] * f;
+      W[j] = W[j] * f + _frot * _Px / 2;
+      Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+      Geocentric::Unrotate(M, gX, gY, gZ, gx[j], gy[j], gz[j]);
+    }
+  }
+
+  void GravityCircle::DisturbanceRow(real lon0, real dlon, int nlon, real T[],
+                                     real deltax[], real deltay[],
+                                     real deltaz[]) const {
+    if ((_caps & DISTURBANCE) != DISTURBANCE) {
+      for (int j = 0; j < nlon; ++j)
+        T[j] = deltax[j] = deltay[j] = deltaz[j] = Math::NaN();
+      return;
+    }
+    _disturbing.EvaluateRow(lon0, dlon, nlon, T, deltax, deltay, deltaz);
+    bool correct = _dzonal0 != 0;
+    real
+      f = _GMmodel / _amodel,
+      r3 = _GMmodel * _dzonal0 * _invR * _invR * _invR;
+    for (int j = 0; j < nlon; ++j) {
+      // Follow InternalT and Disturbance
+      real clam, slam, M[Geocentric::dim2_];
+      CircularEngine::cossin(lon0 + j * dlon, clam, slam);
+      T[j] = (T[j] / _amodel - (correct ? _dzonal0 : 0) * _invR) * _GMmodel;
+      real
+        dX = deltax[j] * f,
+        dY = deltay[j] * f,
+        dZ = deltaz[j] * f;
+      if (correct) {
+        dX += _Px * clam * r3;
+        dY += _Px * slam * r3;
+        dZ += _Z * r3;
+      }
+      Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+      Geocentric::Unrotate(M, dX, dY, dZ, deltax[j], deltay[j], deltaz[j]);
+    }
+  }
+
+  void GravityCircle::GeoidHeightRow(real lon0, real dlon, int nlon, real N[])
+    const {
+    if ((_caps & GEOID_HEIGHT) != GEOID_HEIGHT) {
+      for (int j = 0; j < nlon; ++j)
+        N[j] = Math::NaN();
+      return;
+    }
+    CircularEngine::Workspace work(1, nlon > 0 ? size_t(nlon) : 0);
+    real* correction = work.data();
+    _disturbing.EvaluateRow(lon0, dlon, nlon, N);
+    if (nlon > 0)
+      _correction.EvaluateRow(lon0, dlon, nlon, correction);
+    for (int j = 0; j < nlon; ++j) {
+      // Follow InternalT (with correct = false) and GeoidHeight
+      real T = N[j] / _amodel * _GMmodel;
+      N[j] = T/_gamma0 + _corrmult * correction[j];
+    }
+  }
+
   Math::real GravityCircle::W(real clam, real slam,
                               real& gX, real& gY, real& gZ) const {
     real Wres = V(clam, slam, gX, gY, gZ) + _frot * _Px / 2;
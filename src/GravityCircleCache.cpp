@@ -0,0 +1,195 @@
+/**
+ * \file GravityCircleCache.cpp
+ * \brief Implementation for GeographicLib::GravityCircleCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GravityCircleCache.hpp>
+#include <GeographicLib/Utility.hpp>
+#include "CacheSupport.hpp"
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  class GravityCircleCache::Impl {
+  public:
+    struct Key {
+      real lat, h;
+      bool operator<(const Key& k) const
+      { return lat < k.lat || (lat == k.lat && h < k.h); }
+    };
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+    // The circles are shared with the callers evaluating them so that the
+    // evaluation can take place without holding the lock.
+    typedef shared_ptr<const GravityCircle> circle_t;
+    typedef circle_t ref_t;
+    static ref_t Ref(const circle_t& c) { return c; }
+#else
+    typedef GravityCircle circle_t;
+    typedef const GravityCircle* ref_t;
+    static ref_t Ref(const circle_t& c) { return &c; }
+    // The most recent uncached circle
+    GravityCircle _scratch;
+#endif
+    typedef LRUCache<Key, circle_t> cache_t;
+    const GravityModel& _g;
+    unsigned _caps;
+    real _dlat, _dh;
+    cache_t _cache;
+    Impl(const GravityModel& g, size_t capacity, unsigned caps,
+         real dlat, real dh)
+      : _g(g)
+      , _caps(caps)
+      , _dlat(dlat)
+      , _dh(dh)
+      , _cache(capacity)
+    {
+      if (!(Math::isfinite(_dlat) && _dlat >= 0))
+        throw GeographicErr("Latitude spacing " + Utility::str(_dlat)
+                            + " is not a nonnegative number");
+      if (!(Math::isfinite(_dh) && _dh >= 0))
+        throw GeographicErr("Height spacing " + Utility::str(_dh)
+                            + " is not a nonnegative number");
+    }
+    // The circle for (lat, h).  (If the cache is not thread safe, the result
+    // is only valid until the next call.)
+    ref_t Get(real lat, real h) {
+      Key key = { lat, h };
+      // NaNs can't be used as keys in a map.
+      bool cacheable = !(Math::isnan(lat) || Math::isnan(h));
+      {
+        CacheGuard<cache_t> lock(_cache);
+        if (cacheable) {
+          const circle_t* c = _cache.Find(key);
+          if (c) return Ref(*c);
+        } else
+          ++_cache._misses;
+      }
+      // Construct the circle without holding the lock.
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+      const circle_t circle(new GravityCircle(_g.Circle(lat, h, _caps)));
+#else
+      _scratch = _g.Circle(lat, h, _caps);
+      const circle_t& circle = _scratch;
+#endif
+      if (cacheable) {
+        CacheGuard<cache_t> lock(_cache);
+        _cache.Insert(key, circle);
+      }
+      return Ref(circle);
+    }
+  };
+
+  GravityCircleCache::GravityCircleCache(const GravityModel& g,
+                                         size_t capacity, unsigned caps,
+                                         real dlat, real dh)
+    : _impl(new Impl(g, capacity, caps, dlat, dh))
+  {}
+
+  GravityCircleCache::~GravityCircleCache() { delete _impl; }
+
+  GravityCircle GravityCircleCache::Circle(real lat, real h) {
+    if (_impl->_dlat > 0 && Math::isfinite(lat))
+      lat = max(-real(90),
+                min(real(90),
+                    floor(lat / _impl->_dlat + real(0.5)) * _impl->_dlat));
+    if (_impl->_dh > 0 && Math::isfinite(h))
+      h = floor(h / _impl->_dh + real(0.5)) * _impl->_dh;
+    return *_impl->Get(lat, h);
+  }
+
+  Math::real GravityCircleCache::Gravity(real lat, real lon, real h,
+                                         real& gx, real& gy, real& gz) {
+    real lats[2], wlat[2], hs[2], wh[2];
+    int
+      nlat = CacheNodes(lat, _impl->_dlat, true, lats, wlat),
+      nh = CacheNodes(h, _impl->_dh, false, hs, wh);
+    real W = 0;
+    gx = gy = gz = 0;
+    for (int i = 0; i < nlat; ++i)
+      for (int j = 0; j < nh; ++j) {
+        real w = wlat[i] * wh[j], x, y, z;
+        W += w * _impl->Get(lats[i], hs[j])->Gravity(lon, x, y, z);
+        gx += w * x; gy += w * y; gz += w * z;
+      }
+    return W;
+  }
+
+  Math::real GravityCircleCache::Disturbance(real lat, real lon, real h,
+                                             real& deltax, real& deltay,
+                                             real& deltaz) {
+    real lats[2], wlat[2], hs[2], wh[2];
+    int
+      nlat = CacheNodes(lat, _impl->_dlat, true, lats, wlat),
+      nh = CacheNodes(h, _impl->_dh, false, hs, wh);
+    real T = 0;
+    deltax = deltay = deltaz = 0;
+    for (int i = 0; i < nlat; ++i)
+      for (int j = 0; j < nh; ++j) {
+        real w = wlat[i] * wh[j], x, y, z;
+        T += w * _impl->Get(lats[i], hs[j])->Disturbance(lon, x, y, z);
+        deltax += w * x; deltay += w * y; deltaz += w * z;
+      }
+    return T;
+  }
+
+  Math::real GravityCircleCache::GeoidHeight(real lat, real lon) {
+    real lats[2], wlat[2];
+    int nlat = CacheNodes(lat, _impl->_dlat, true, lats, wlat);
+    real N = 0;
+    for (int i = 0; i < nlat; ++i)
+      N += wlat[i] * _impl->Get(lats[i], 0)->GeoidHeight(lon);
+    return N;
+  }
+
+  void GravityCircleCache::Clear() {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache.Clear();
+  }
+
+  void GravityCircleCache::SetCapacity(size_t capacity) {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache.SetCapacity(capacity);
+  }
+
+  void GravityCircleCache::ResetCounters() {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache._hits = _impl->_cache._misses = 0;
+  }
+
+  size_t GravityCircleCache::Capacity() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._capacity;
+  }
+
+  size_t GravityCircleCache::Size() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._values.size();
+  }
+
+  unsigned long GravityCircleCache::Hits() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._hits;
+  }
+
+  unsigned long GravityCircleCache::Misses() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._misses;
+  }
+
+  unsigned GravityCircleCache::Capabilities() const { return _impl->_caps; }
+
+  Math::real GravityCircleCache::LatitudeSpacing() const
+  { return _impl->_dlat; }
+
+  Math::real GravityCircleCache::HeightSpacing() const
+  { return _impl->_dh; }
+
+  bool GravityCircleCache::ThreadSafe()
+  { return GEOGRAPHICLIB_CACHE_THREADSAFE != 0; }
+
+} // namespace GeographicLib
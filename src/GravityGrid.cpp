@@ -0,0 +1,139 @@
+/**
+ * \file GravityGrid.cpp
+ * \brief Implementation for GeographicLib::GravityGrid class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GravityGrid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/GravityCircle.hpp>
+#include <cstring>
+#include <algorithm>
+
+#if !defined(GEOGRAPHICLIB_GRAVITYGRID_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GRAVITYGRID_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GRAVITYGRID_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GRAVITYGRID_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GravityGrid::GravityGrid(const GravityModel& g, unsigned q,
+                           real north, real west, real step,
+                           int nlat, int nlon, real h)
+    : _g(&g)
+    , _quantity(q)
+    , _north(north)
+    , _west(west)
+    , _step(step)
+    , _h(h)
+    , _nlat(nlat)
+    , _nlon(nlon)
+  {
+    if (q > GEOID_HEIGHT)
+      throw GeographicErr("Invalid quantity for GravityGrid");
+    if (!(abs(_north) <= 90))
+      throw GeographicErr("Latitude of first row not in [-90d, 90d]");
+    if (!(Math::isfinite(_west) && Math::isfinite(_step) && _step > 0))
+      throw GeographicErr("Grid step must be positive");
+    if (!(_nlat > 0 && _nlon > 0))
+      throw GeographicErr("Grid must have at least one row and column");
+    if (!Math::isfinite(_h))
+      throw GeographicErr("Bad height");
+    if (q == GEOID_HEIGHT && _h != 0)
+      throw GeographicErr("Height should be zero for geoid heights");
+  }
+
+  void GravityGrid::Rows(int r0, int r1, real* const v[],
+                         int nthreads) const {
+    if (!(0 <= r0 && r0 <= r1 && r1 <= _nlat))
+      throw GeographicErr("Rows not in the grid");
+#if GEOGRAPHICLIB_GRAVITYGRID_THREADS
+    // Divide the rows into nthreads contiguous ranges which are run by the
+    // current Executor.
+    const int nf = Fields();
+    Executor::For(size_t(r1 - r0), size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    real* vk[3];
+                    for (int k = 0; k < nf; ++k)
+                      vk[k] = v[k] + i0 * _nlon;
+                    RowRange(r0 + int(i0), r0 + int(i1), vk);
+                  });
+#else
+    (void)nthreads;
+    RowRange(r0, r1, v);
+#endif
+  }
+
+  void GravityGrid::RowRange(int r0, int r1, real* const v[]) const {
+    // Evaluate rows r0 thru r1 - 1 in groups of nrows_, constructing the
+    // circles of a group together.
+    unsigned mask =
+      _quantity == GRAVITY ? GravityModel::GRAVITY :
+      (_quantity == DISTURBANCE ? GravityModel::DISTURBANCE :
+       (_quantity == ANOMALY ? GravityModel::SPHERICAL_ANOMALY :
+        GravityModel::GEOID_HEIGHT));
+    vector<real> t(_nlon), lat(nrows_);
+    vector<GravityCircle> circles;
+    for (int r = r0; r < r1; ++r) {
+      if ((r - r0) % nrows_ == 0) {
+        int k = min(nrows_, r1 - r);
+        for (int i = 0; i < k; ++i)
+          lat[i] = Latitude(r + i);
+        _g->LatitudeCircles(&lat[0], k, _h, circles, mask);
+      }
+      const GravityCircle& c = circles[(r - r0) % nrows_];
+      size_t o = size_t(r - r0) * _nlon;
+      switch (_quantity) {
+      case GRAVITY:
+        c.GravityRow(_west, _step, _nlon, &t[0], v[0] + o, v[1] + o, v[2] + o);
+        break;
+      case DISTURBANCE:
+        c.DisturbanceRow(_west, _step, _nlon, &t[0],
+                         v[0] + o, v[1] + o, v[2] + o);
+        // Convert to mGals
+        for (int j = 0; j < _nlon; ++j) {
+          v[0][o + j] *= 1e5; v[1][o + j] *= 1e5; v[2][o + j] *= 1e5;
+        }
+        break;
+      case ANOMALY:
+        for (int j = 0; j < _nlon; ++j) {
+          real Dg01, xi, eta;
+          c.SphericalAnomaly(Longitude(j), Dg01, xi, eta);
+          v[0][o + j] = Dg01 * 1e5; // Convert to mGals
+          v[1][o + j] = xi * 3600;  // Convert to arcsecs
+          v[2][o + j] = eta * 3600;
+        }
+        break;
+      case GEOID_HEIGHT:
+      default:
+        c.GeoidHeightRow(_west, _step, _nlon, v[0] + o);
+        break;
+      }
+    }
+  }
+
+  void GravityGrid::Encode(const real* const v[], int nr,
+                           vector<char>& buf) const {
+    const size_t nf = Fields(), n = size_t(max(nr, 0)) * _nlon;
+    buf.resize(n * nf * sizeof(double));
+    for (size_t i = 0; i < n; ++i)
+      for (size_t k = 0; k < nf; ++k) {
+        double d = double(v[k][i]);
+        if (Math::bigendian) d = Math::swab(d);
+        memcpy(&buf[(i * nf + k) * sizeof(double)], &d, sizeof(double));
+      }
+  }
+
+} // namespace GeographicLib
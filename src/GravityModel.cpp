@@ -25,6 +25,18 @@
 #  define GEOGRAPHICLIB_GRAVITY_DEFAULT_NAME "egm96"
 #endif
 
+#if !defined(GEOGRAPHICLIB_GRAVITYMODEL_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GRAVITYMODEL_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GRAVITYMODEL_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GRAVITYMODEL_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
 #if defined(_MSC_VER)
 // Squelch warnings about unsafe use of getenv
 #  pragma warning (disable: 4996)
@@ -34,7 +46,8 @@ namespace GeographicLib {
 
   using namespace std;
 
-  GravityModel::GravityModel(const std::string& name,const std::string& path)
+  GravityModel::GravityModel(const std::string& name,const std::string& path,
+                             bool map, bool single, bool hugepages)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -44,40 +57,104 @@ namespace GeographicLib {
     , _zeta0(0)
     , _corrmult(1)
     , _norm(SphericalHarmonic::FULL)
+    , _map(0)
+    , _maplen(0)
+    , _maphandle(0)
   {
     if (_dir.empty())
       _dir = DefaultGravityPath();
     ReadMetadata(_name);
     {
       string coeff = _filename + ".cof";
-      ifstream coeffstr(coeff.c_str(), ios::binary);
-      if (!coeffstr.good())
-        throw GeographicErr("Error opening " + coeff);
-      char id[idlength_ + 1];
-      coeffstr.read(id, idlength_);
-      if (!coeffstr.good())
-        throw GeographicErr("No header in " + coeff);
-      id[idlength_] = '\0';
-      if (_id != string(id))
-        throw GeographicErr("ID mismatch: " + _id + " vs " + id);
-      int N, M;
-      SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _Cx, _Sx);
-      if (!(M < 0 || _Cx[0] == 0))
-        throw GeographicErr("A degree 0 term should be zero");
-      _Cx[0] = 1;               // Include the 1/r term in the sum
-      _gravitational = SphericalHarmonic(_Cx, _Sx, N, N, M, _amodel, _norm);
-      SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _CC, _CS);
-      if (N < 0) {
-        N = M = 0;
-        _CC.resize(1, real(0));
+      if (!(map && !single && MapCoefficients(coeff, hugepages))) {
+        ifstream coeffstr(coeff.c_str(), ios::binary);
+        if (!coeffstr.good())
+          throw GeographicErr("Error opening " + coeff);
+        char id[idlength_ + 1];
+        coeffstr.read(id, idlength_);
+        if (!coeffstr.good())
+          throw GeographicErr("No header in " + coeff);
+        id[idlength_] = '\0';
+        if (_id != string(id))
+          throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+        int N, M;
+        vector<real> Cx, Sx;
+        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, Cx, Sx);
+        if (!(M < 0 || Cx[0] == 0))
+          throw GeographicErr("A degree 0 term should be zero");
+        Cx[0] = 1;                // Include the 1/r term in the sum
+        // Store C and S interleaved so that the evaluation of each order reads
+        // a single stream of coefficients.
+        if (hugepages && !single)
+          Utility::reservehugepages(_CSx,
+                                    2 * size_t(SphericalEngine::coeff::
+                                               Csize(N, M)));
+        SphericalEngine::coeff::pack(Cx, Sx, N, N, M, _CSx);
+        if (single) {
+          vector<real>().swap(Cx); vector<real>().swap(Sx);
+          if (hugepages)
+            Utility::reservehugepages(_CSf, _CSx.size());
+          _CSf.resize(_CSx.size());
+          for (size_t i = 0; i < _CSx.size(); ++i)
+            _CSf[i] = float(_CSx[i]);
+          vector<real>().swap(_CSx);
+          _gravitational =
+            SphericalHarmonic(SphericalEngine::coeff(&_CSf[0], N, M),
+                              _amodel, _norm);
+        } else
+          _gravitational =
+            SphericalHarmonic(SphericalEngine::coeff(_CSx, N, M),
+                              _amodel, _norm);
+        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _CC, _CS);
+        if (N < 0) {
+          N = M = 0;
+          _CC.resize(1, real(0));
+        }
+        _CC[0] += _zeta0 / _corrmult;
+        _correction = SphericalHarmonic(_CC, _CS, N, N, M, real(1), _norm);
+        int pos = int(coeffstr.tellg());
+        coeffstr.seekg(0, ios::end);
+        if (pos != coeffstr.tellg())
+          throw GeographicErr("Extra data in " + coeff);
       }
-      _CC[0] += _zeta0 / _corrmult;
-      _correction = SphericalHarmonic(_CC, _CS, N, N, M, real(1), _norm);
-      int pos = int(coeffstr.tellg());
-      coeffstr.seekg(0, ios::end);
-      if (pos != coeffstr.tellg())
-        throw GeographicErr("Extra data in " + coeff);
     }
+    SetDisturbing();
+  }
+
+  GravityModel::GravityModel(const GravityModel& g, int Nmax, int Mmax)
+    : _name(g._name)
+    , _dir(g._dir)
+    , _description(g._description)
+    , _date(g._date)
+    , _filename(g._filename)
+    , _id(g._id)
+    , _amodel(g._amodel)
+    , _GMmodel(g._GMmodel)
+    , _zeta0(g._zeta0)
+    , _corrmult(g._corrmult)
+    , _norm(g._norm)
+    , _earth(g._earth)
+    , _map(0)
+    , _maplen(0)
+    , _maphandle(0)
+  {
+    const SphericalEngine::coeff
+      &c = g._gravitational.Coefficients(),
+      &cc = g._correction.Coefficients();
+    int
+      nmx = Nmax < 0 ? c.nmx() : min(Nmax, c.nmx()),
+      mmx = min(nmx, Mmax < 0 ? c.mmx() : min(Mmax, c.mmx())),
+      nmxc = min(nmx, cc.nmx()),
+      mmxc = min(nmxc, min(mmx, cc.mmx()));
+    _gravitational = SphericalHarmonic(SphericalEngine::coeff(c, nmx, mmx),
+                                       _amodel, _norm);
+    _correction = SphericalHarmonic(SphericalEngine::coeff(cc, nmxc, mmxc),
+                                    real(1), _norm);
+    SetDisturbing();
+  }
+
+  void GravityModel::SetDisturbing() {
+    // Set up _disturbing = _gravitational minus the normal potential.
     int nmx = _gravitational.Coefficients().nmx();
     // Adjust the normalization of the normal potential to match the model.
     real mult = _earth._GM / _GMmodel;
@@ -95,7 +172,7 @@ namespace GeographicLib {
       // goes out to n = 18.
       mult *= amult;
       real
-        r = _Cx[n],                                        // the model term
+        r = _gravitational.Coefficients().Cv(n),           // the model term
         s = - mult * _earth.Jn(n) / sqrt(real(2 * n + 1)), // the normal term
         t = r - s;                                         // the difference
       if (t == r)               // the normal term is negligible
@@ -104,16 +181,69 @@ namespace GeographicLib {
       _zonal.push_back(s);
     }
     int nmx1 = int(_zonal.size()) - 1;
-    _disturbing = SphericalHarmonic1(_Cx, _Sx,
-                                     _gravitational.Coefficients().N(),
-                                     nmx, _gravitational.Coefficients().mmx(),
-                                     _zonal,
-                                     _zonal, // This is not accessed!
-                                     nmx1, nmx1, 0,
+    _disturbing = SphericalHarmonic1(_gravitational.Coefficients(),
+                                     SphericalEngine::coeff
+                                     (_zonal,
+                                      _zonal, // This is not accessed!
+                                      nmx1, nmx1, 0),
                                      _amodel,
                                      SphericalHarmonic1::normalization(_norm));
   }
 
+  GravityModel::~GravityModel() {
+    Utility::unmapfile(_map, _maplen, _maphandle);
+  }
+
+  bool GravityModel::MapCoefficients(const std::string& coeff,
+                                     bool hugepages) {
+    // Use the coefficients in place in a copy-on-write mapping of the file;
+    // only the pages holding the degree 0 terms, which are modified, are
+    // copied.  Return false (so that the file is read instead) if this isn't
+    // possible.
+    if (!SphericalEngine::coeff::mappable())
+      return false;
+    try {
+      _map = Utility::mapfile(coeff, _maplen, _maphandle, hugepages);
+    }
+    catch (const GeographicErr&) {
+      return false;
+    }
+    try {
+      if (!(_maplen >= unsigned(idlength_)))
+        throw GeographicErr("No header in " + coeff);
+      string id(_map, idlength_);
+      if (_id != id)
+        throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+      unsigned long long pos = idlength_;
+      int N, M, NC, MC;
+      real *C, *S, *CC, *CS;
+      SphericalEngine::coeff::mapcoeffs(_map, _maplen, pos, N, M, C, S);
+      SphericalEngine::coeff::mapcoeffs(_map, _maplen, pos, NC, MC, CC, CS);
+      if (pos != _maplen)
+        throw GeographicErr("Extra data in " + coeff);
+      if (N < 0 || NC < 0) {
+        // There's no degree 0 term to modify; read the file instead.
+        Utility::unmapfile(_map, _maplen, _maphandle);
+        _map = 0;
+        return false;
+      }
+      if (!(C[0] == 0))
+        throw GeographicErr("A degree 0 term should be zero");
+      C[0] = 1;                 // Include the 1/r term in the sum
+      _gravitational = SphericalHarmonic(SphericalEngine::coeff
+                                         (C, S, N, N, M), _amodel, _norm);
+      CC[0] += _zeta0 / _corrmult;
+      _correction = SphericalHarmonic(SphericalEngine::coeff
+                                      (CC, CS, NC, NC, MC), real(1), _norm);
+    }
+    catch (...) {
+      Utility::unmapfile(_map, _maplen, _maphandle);
+      _map = 0;
+      throw;
+    }
+    return true;
+  }
+
   void GravityModel::ReadMetadata(const std::string& name) {
     const char* spaces = " \t\n\v\f\r";
     _filename = _dir + "/" + name + ".egm";
@@ -196,14 +326,26 @@ namespace GeographicLib {
     // If correct, then produce the correct T = W - U.  Otherwise, neglect the
     // n = 0 term (which is proportial to the difference in the model and
     // reference values of GM).
-    if (_dzonal0 == 0)
-      // No need to do the correction
-      correct = false;
-    real T, invR = correct ? 1 / Math::hypot(Math::hypot(X, Y), Z) : 1;
+    real T;
     if (gradp) {
       // initial values to suppress warnings
       deltaX = deltaY = deltaZ = 0;
       T = _disturbing(-1, X, Y, Z, deltaX, deltaY, deltaZ);
+    } else
+      T = _disturbing(-1, X, Y, Z);
+    return FinishT(X, Y, Z, T, deltaX, deltaY, deltaZ, gradp, correct);
+  }
+
+  Math::real GravityModel::FinishT(real X, real Y, real Z, real T,
+                                   real& deltaX, real& deltaY, real& deltaZ,
+                                   bool gradp, bool correct) const {
+    // Convert the sum T (and its gradient) given by _disturbing into the
+    // disturbing potential.
+    if (_dzonal0 == 0)
+      // No need to do the correction
+      correct = false;
+    real invR = correct ? 1 / Math::hypot(Math::hypot(X, Y), Z) : 1;
+    if (gradp) {
       real f = _GMmodel / _amodel;
       deltaX *= f;
       deltaY *= f;
@@ -214,8 +356,7 @@ namespace GeographicLib {
         deltaY += Y * invR;
         deltaZ += Z * invR;
       }
-    } else
-      T = _disturbing(-1, X, Y, Z);
+    }
     T = (T / _amodel - (correct ? _dzonal0 : 0) * invR) * _GMmodel;
     return T;
   }
@@ -248,7 +389,14 @@ namespace GeographicLib {
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real
       deltax, deltay, deltaz,
-      T = InternalT(X, Y, Z, deltax, deltay, deltaz, true, false),
+      T = InternalT(X, Y, Z, deltax, deltay, deltaz, true, false);
+    Anomaly(X, Y, Z, M, T, deltax, deltay, deltaz, Dg01, xi, eta);
+  }
+
+  void GravityModel::Anomaly(real X, real Y, real Z, const real M[], real T,
+                             real deltax, real deltay, real deltaz,
+                             real& Dg01, real& xi, real& eta) const {
+    real
       clam = M[3], slam = -M[0],
       P = Math::hypot(X, Y),
       R = Math::hypot(P, Z),
@@ -300,15 +448,236 @@ namespace GeographicLib {
     return Tres;
   }
 
-  GravityCircle GravityModel::Circle(real lat, real h, unsigned caps) const {
+  void GravityModel::BatchRange(batchtype kind,
+                                const real lat[], const real lon[],
+                                const real h[], size_t i0, size_t i1,
+                                real r0[], real r1[], real r2[], real r3[])
+    const {
+    // Evaluate points i0 <= i < i1 in groups of batchsize_.  The operations
+    // on each point are the same as in the corresponding single point
+    // functions, so that the results are identical.
+    const int nb = batchsize_;
+    const Geocentric& earth = _earth.Earth();
+    real X[nb], Y[nb], Z[nb], M[nb * Geocentric::dim2_],
+      v[nb], vx[nb], vy[nb], vz[nb], corr[nb];
+    for (size_t j0 = i0; j0 < i1; j0 += nb) {
+      int k = int(min(size_t(nb), i1 - j0));
+      if (kind == BATCH_GEOIDHEIGHT)
+        for (int j = 0; j < k; ++j)
+          earth.IntForward(lat[j0 + j], lon[j0 + j], 0, X[j], Y[j], Z[j],
+                           NULL);
+      else
+        for (int j = 0; j < k; ++j)
+          earth.IntForward(lat[j0 + j], lon[j0 + j], h[j0 + j],
+                           X[j], Y[j], Z[j], M + j * Geocentric::dim2_);
+      switch (kind) {
+      case BATCH_GRAVITY:
+        {
+          _gravitational(k, X, Y, Z, v, vx, vy, vz);
+          real f = _GMmodel / _amodel;
+          for (int j = 0; j < k; ++j) {
+            size_t i = j0 + j;
+            real fX, fY,
+              gX = vx[j] * f, gY = vy[j] * f, gZ = vz[j] * f,
+              Wres = v[j] * f + _earth.Phi(X[j], Y[j], fX, fY);
+            gX += fX;
+            gY += fY;
+            Geocentric::Unrotate(M + j * Geocentric::dim2_,
+                                 gX, gY, gZ, r1[i], r2[i], r3[i]);
+            r0[i] = Wres;
+          }
+        }
+        break;
+      case BATCH_DISTURBANCE:
+        _disturbing(-1, k, X, Y, Z, v, vx, vy, vz);
+        for (int j = 0; j < k; ++j) {
+          size_t i = j0 + j;
+          real Tres = FinishT(X[j], Y[j], Z[j], v[j], vx[j], vy[j], vz[j],
+                              true, true);
+          Geocentric::Unrotate(M + j * Geocentric::dim2_,
+                               vx[j], vy[j], vz[j], r1[i], r2[i], r3[i]);
+          r0[i] = Tres;
+        }
+        break;
+      case BATCH_GEOIDHEIGHT:
+        {
+          _disturbing(-1, k, X, Y, Z, v);
+          // The unit vectors for the correction
+          for (int j = 0; j < k; ++j) {
+            real invR = 1 / Math::hypot(Math::hypot(X[j], Y[j]), Z[j]);
+            vx[j] = invR * X[j]; vy[j] = invR * Y[j]; vz[j] = invR * Z[j];
+          }
+          _correction(k, vx, vy, vz, corr);
+          // The normal gravity on the ellipsoid
+          real gamma0[nb];
+          _earth.SurfaceGravityBatch(lat + j0, k, gamma0);
+          real dummy;
+          for (int j = 0; j < k; ++j) {
+            size_t i = j0 + j;
+            real
+              T = FinishT(X[j], Y[j], Z[j], v[j], dummy, dummy, dummy,
+                          false, false),
+              correction = _corrmult * corr[j];
+            r0[i] = T/gamma0[j] + correction;
+          }
+        }
+        break;
+      case BATCH_ANOMALY:
+        _disturbing(-1, k, X, Y, Z, v, vx, vy, vz);
+        for (int j = 0; j < k; ++j) {
+          size_t i = j0 + j;
+          real T = FinishT(X[j], Y[j], Z[j], v[j], vx[j], vy[j], vz[j],
+                           true, false);
+          Anomaly(X[j], Y[j], Z[j], M + j * Geocentric::dim2_, T,
+                  vx[j], vy[j], vz[j], r0[i], r1[i], r2[i]);
+        }
+        break;
+      }
+    }
+  }
+
+  void GravityModel::Batch(batchtype kind,
+                           const real lat[], const real lon[], const real h[],
+                           size_t n,
+                           real r0[], real r1[], real r2[], real r3[],
+                           int nthreads) const {
+#if GEOGRAPHICLIB_GRAVITYMODEL_THREADS
+    // Divide the whole groups of points into nthreads contiguous ranges
+    // which are run by the current Executor.
+    size_t ngroups = (n + batchsize_ - 1) / batchsize_;
+    Executor::For(ngroups, size_t(max(nthreads, 1)),
+                  [&](size_t b0, size_t b1) {
+                    size_t
+                      i0 = min(n, b0 * batchsize_),
+                      i1 = min(n, b1 * batchsize_);
+                    BatchRange(kind, lat, lon, h, i0, i1, r0, r1, r2, r3);
+                  });
+#else
+    (void)nthreads;
+    BatchRange(kind, lat, lon, h, 0, n, r0, r1, r2, r3);
+#endif
+  }
+
+  GravityCircle GravityModel::Circle(real lat, real h, unsigned caps,
+                                     int nthreads) const {
     if (h != 0)
       // Disallow invoking GeoidHeight unless h is zero.
       caps &= ~(CAP_GAMMA0 | CAP_C);
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, 0, h, X, Y, Z, M);
     // Y = 0, cphi = M[7], sphi = M[8];
+    real invR = 1 / Math::hypot(X, Z);
+    return MakeCircle(lat, h, caps, X, Y, Z, M,
+                      caps & CAP_G ?
+                      _gravitational.Circle(X, Z, true, nthreads) :
+                      CircularEngine(),
+                      // N.B. If CAP_DELTA is set then CAP_T should be too.
+                      caps & CAP_T ?
+                      _disturbing.Circle(-1, X, Z, (caps & CAP_DELTA) != 0,
+                                         nthreads) :
+                      CircularEngine(),
+                      caps & CAP_C ?
+                      _correction.Circle(invR * X, invR * Z, false,
+                                         nthreads) :
+                      CircularEngine());
+  }
+
+  void GravityModel::Circles(real lat, const real h[], int n,
+                             std::vector<GravityCircle>& circles,
+                             unsigned caps, int nthreads) const {
+    circles.clear();
+    if (n <= 0)
+      return;
+    circles.reserve(n);
+    vector<real> X(n), Y(n), Z(n), M(n * Geocentric::dim2_);
+    for (int i = 0; i < n; ++i)
+      _earth.Earth().IntForward(lat, 0, h[i], X[i], Y[i], Z[i],
+                                &M[i * Geocentric::dim2_]);
+    vector<CircularEngine> grav, dist;
+    if (caps & CAP_G) {
+      grav.resize(n);
+      _gravitational.Circles(n, &X[0], &Z[0], true, &grav[0], nthreads);
+    }
+    if (caps & CAP_T) {
+      dist.resize(n);
+      _disturbing.Circles(-1, n, &X[0], &Z[0], (caps & CAP_DELTA) != 0,
+                          &dist[0], nthreads);
+    }
+    // The correction is only needed for h = 0 and all such circles are the
+    // same.
+    CircularEngine corr;
+    if (caps & CAP_C) {
+      for (int i = 0; i < n; ++i) {
+        if (h[i] == 0) {
+          real invR = 1 / Math::hypot(X[i], Z[i]);
+          corr = _correction.Circle(invR * X[i], invR * Z[i], false,
+                                    nthreads);
+          break;
+        }
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      unsigned capsi = h[i] != 0 ? caps & ~(CAP_GAMMA0 | CAP_C) : caps;
+      circles.push_back(MakeCircle(lat, h[i], capsi, X[i], Y[i], Z[i],
+                                   &M[i * Geocentric::dim2_],
+                                   capsi & CAP_G ? grav[i] : CircularEngine(),
+                                   capsi & CAP_T ? dist[i] : CircularEngine(),
+                                   capsi & CAP_C ? corr : CircularEngine()));
+    }
+  }
+
+  void GravityModel::LatitudeCircles(const real lat[], int n, real h,
+                                     std::vector<GravityCircle>& circles,
+                                     unsigned caps, int nthreads) const {
+    circles.clear();
+    if (n <= 0)
+      return;
+    if (h != 0)
+      // Disallow invoking GeoidHeight unless h is zero.
+      caps &= ~(CAP_GAMMA0 | CAP_C);
+    circles.reserve(n);
+    vector<real> X(n), Y(n), Z(n), M(n * Geocentric::dim2_);
+    for (int i = 0; i < n; ++i)
+      _earth.Earth().IntForward(lat[i], 0, h, X[i], Y[i], Z[i],
+                                &M[i * Geocentric::dim2_]);
+    vector<CircularEngine> grav, dist, corr;
+    if (caps & CAP_G) {
+      grav.resize(n);
+      _gravitational.Circles(n, &X[0], &Z[0], true, &grav[0], nthreads);
+    }
+    if (caps & CAP_T) {
+      dist.resize(n);
+      _disturbing.Circles(-1, n, &X[0], &Z[0], (caps & CAP_DELTA) != 0,
+                          &dist[0], nthreads);
+    }
+    if (caps & CAP_C) {
+      // The correction is evaluated on the unit sphere.
+      vector<real> p(n), z(n);
+      for (int i = 0; i < n; ++i) {
+        real invR = 1 / Math::hypot(X[i], Z[i]);
+        p[i] = invR * X[i]; z[i] = invR * Z[i];
+      }
+      corr.resize(n);
+      _correction.Circles(n, &p[0], &z[0], false, &corr[0], nthreads);
+    }
+    for (int i = 0; i < n; ++i)
+      circles.push_back(MakeCircle(lat[i], h, caps, X[i], Y[i], Z[i],
+                                   &M[i * Geocentric::dim2_],
+                                   caps & CAP_G ? grav[i] : CircularEngine(),
+                                   caps & CAP_T ? dist[i] : CircularEngine(),
+                                   caps & CAP_C ? corr[i] : CircularEngine()));
+  }
+
+  GravityCircle GravityModel::MakeCircle(real lat, real h, unsigned caps,
+                                         real X, real Y, real Z,
+                                         const real M[],
+                                         const CircularEngine& gravitational,
+                                         const CircularEngine& disturbing,
+                                         const CircularEngine& correction)
+    const {
+    // Assemble a GravityCircle from the CircularEngines for the circle
+    // through the geocentric point (X, Y = 0, Z).
     real
-      invR = 1 / Math::hypot(X, Z),
       gamma0 = (caps & CAP_GAMMA0 ?_earth.SurfaceGravity(lat)
                 : Math::NaN()),
       fx, fy, fz, gamma;
@@ -322,16 +691,7 @@ namespace GeographicLib {
                          _earth._a, _earth._f, lat, h, Z, X, M[7], M[8],
                          _amodel, _GMmodel, _dzonal0, _corrmult,
                          gamma0, gamma, fx,
-                         caps & CAP_G ?
-                         _gravitational.Circle(X, Z, true) :
-                         CircularEngine(),
-                         // N.B. If CAP_DELTA is set then CAP_T should be too.
-                         caps & CAP_T ?
-                         _disturbing.Circle(-1, X, Z, (caps & CAP_DELTA) != 0) :
-                         CircularEngine(),
-                         caps & CAP_C ?
-                         _correction.Circle(invR * X, invR * Z, false) :
-                         CircularEngine());
+                         gravitational, disturbing, correction);
   }
 
   std::string GravityModel::DefaultGravityPath() {
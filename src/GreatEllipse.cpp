@@ -0,0 +1,374 @@
+/**
+ * \file GreatEllipse.cpp
+ * \brief Implementation for GeographicLib::GreatEllipse and
+ *   GeographicLib::GreatEllipseLine classes
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GreatEllipse.hpp>
+
+#if !defined(GEOGRAPHICLIB_GREATELLIPSE_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GREATELLIPSE_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GREATELLIPSE_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GREATELLIPSE_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  // The geocentric latitude theta of a point with geographic latitude phi is
+  // given by tan(theta) = (1-f)^2 * tan(phi).  A plane through the center of
+  // the ellipsoid cuts the auxiliary sphere, on which the latitude is theta,
+  // in a great circle.  If the great circle has azimuth alp0 at the equator,
+  // the great ellipse has semi-axes a and b = a/k where k^2 = 1 + k'^2 and
+  // k'^2 = e'^2 * cos(alp0)^2.  If sig is the arc length on the sphere from
+  // the equator, then tan(sig') = k * tan(sig) where sig' is the parametric
+  // angle on the ellipse and the distance along the ellipse is
+  //
+  //   s = b * int(sqrt(1 + k'^2 * sin(sig')^2), sig')
+  //
+  // which is the same integral as for the geodesic distance (with k'^2 in
+  // place of k^2).  The azimuths on the ellipsoid and on the sphere are
+  // related by tan(alp) = tan(gam) * cos(phi - theta).
+
+  GreatEllipse::GreatEllipse(real a, real f)
+    : tiny_(sqrt(numeric_limits<real>::min()))
+    , _a(a)
+    , _f(f <= 1 ? f : 1/f)
+    , _f1(1 - _f)
+    , _f12(Math::sq(_f1))
+    , _ep2(_f * (2 - _f) / _f12)
+  {
+    if (!(Math::isfinite(_a) && _a > 0))
+      throw GeographicErr("Major radius is not positive");
+    if (!(Math::isfinite(_f1 * _a) && _f1 * _a > 0))
+      throw GeographicErr("Minor radius is not positive");
+  }
+
+  const GreatEllipse& GreatEllipse::WGS84() {
+    static const GreatEllipse
+      wgs84(Constants::WGS84_a(), Constants::WGS84_f());
+    return wgs84;
+  }
+
+  GreatEllipseLine GreatEllipse::Line(real lat1, real lon1, real azi1) const
+  { return GreatEllipseLine(*this, lat1, lon1, azi1); }
+
+  void GreatEllipse::GenDirect(real lat1, real lon1, real azi1, real s12,
+                               unsigned outmask,
+                               real& lat2, real& lon2, real& azi2) const {
+    GreatEllipseLine(*this, lat1, lon1, azi1)
+      .GenPosition(s12, outmask, lat2, lon2, azi2);
+  }
+
+  void GreatEllipse::GenInverse(real lat1, real lon1, real lat2, real lon2,
+                                unsigned outmask,
+                                real& s12, real& azi1, real& azi2) const {
+    real sphi1, cphi1, sphi2, cphi2, slam12, clam12;
+    Math::sincosd(Math::AngRound(lat1), sphi1, cphi1);
+    Math::sincosd(Math::AngRound(lat2), sphi2, cphi2);
+    Math::sincosd(Math::AngRound(Math::AngDiff(Math::AngNormalize(lon1),
+                                               Math::AngNormalize(lon2))),
+                  slam12, clam12);
+    GenInverse(sphi1, cphi1, sphi2, cphi2, slam12, clam12, outmask,
+               s12, azi1, azi2);
+  }
+
+  void GreatEllipse::GenInverse(real sphi1, real cphi1,
+                                real sphi2, real cphi2,
+                                real slam12, real clam12, unsigned outmask,
+                                real& s12, real& azi1, real& azi2) const {
+    // The geocentric latitudes
+    real
+      sth1 = _f12 * sphi1, cth1 = cphi1,
+      sth2 = _f12 * sphi2, cth2 = cphi2;
+    Math::norm(sth1, cth1); cth1 = max(tiny_, cth1);
+    Math::norm(sth2, cth2); cth2 = max(tiny_, cth2);
+    // The azimuths of the great circle on the sphere
+    real
+      sgam1 = cth2 * slam12,
+      cgam1 = cth1 * sth2 - sth1 * cth2 * clam12,
+      sgam2 = cth1 * slam12,
+      cgam2 = cth1 * sth2 * clam12 - sth1 * cth2,
+      // The arc length on the sphere
+      ssig12 = Math::hypot(sgam1, cgam1),
+      csig12 = sth1 * sth2 + cth1 * cth2 * clam12;
+    if (ssig12 == 0) {
+      // The points are coincident or antipodal.  Use the meridian (through
+      // the north pole in the antipodal case).
+      sgam1 = sgam2 = 0; cgam1 = 1; cgam2 = csig12 < 0 ? -1 : 1;
+      csig12 = csig12 < 0 ? -1 : 1;
+    } else {
+      Math::norm(sgam1, cgam1);
+      Math::norm(sgam2, cgam2);
+      Math::norm(ssig12, csig12);
+    }
+    if (outmask & DISTANCE) {
+      real
+        calp0 = Math::hypot(cgam1, sgam1 * sth1),
+        // sig1 is measured from the northward equator crossing
+        ssig1 = sth1, csig1 = sth1 != 0 || cgam1 != 0 ? cth1 * cgam1 : 1;
+      Math::norm(ssig1, csig1);
+      real
+        ssig2 = ssig1 * csig12 + csig1 * ssig12,
+        csig2 = csig1 * csig12 - ssig1 * ssig12,
+        kp2 = _ep2 * Math::sq(calp0),
+        k = sqrt(1 + kp2),
+        eps = kp2 / (2 * (1 + k) + kp2),
+        // The parametric angles sig' on the great ellipse
+        ssig1p = k * ssig1, csig1p = csig1,
+        ssig2p = k * ssig2, csig2p = csig2;
+      Math::norm(ssig1p, csig1p);
+      Math::norm(ssig2p, csig2p);
+      real
+        C1a[Geodesic::nC1_ + 1],
+        // sig12' = sig2' - sig1' in [0, pi]
+        sig12p = atan2(max(real(0), csig1p * ssig2p - ssig1p * csig2p),
+                       csig1p * csig2p + ssig1p * ssig2p);
+      Geodesic::C1f(eps, C1a, Geodesic::nC1_);
+      real
+        B12 = Geodesic::SinCosSeries(true, ssig2p, csig2p, C1a, Geodesic::nC1_)
+        - Geodesic::SinCosSeries(true, ssig1p, csig1p, C1a, Geodesic::nC1_);
+      s12 = 0 + _a / k * (1 + Geodesic::A1m1f(eps, Geodesic::nC1_)) *
+        (sig12p + B12);
+    }
+    if (outmask & AZIMUTH) {
+      // cos(phi - theta) at the two points
+      real
+        c1 = cphi1 * cth1 + sphi1 * sth1,
+        c2 = cphi2 * cth2 + sphi2 * sth2;
+      azi1 = Math::atan2d(sgam1 * c1, cgam1);
+      azi2 = Math::atan2d(sgam2 * c2, cgam2);
+    }
+  }
+
+  void GreatEllipse::GenInverseBatch(const real* lat1, const real* lon1,
+                                     const real* lat2, const real* lon2,
+                                     size_t n,
+                                     real* s12, real* azi1, real* azi2,
+                                     unsigned outmask, int nthreads) const {
+#if GEOGRAPHICLIB_GREATELLIPSE_THREADS
+    // Divide the problems into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    GenInverseRange(lat1, lon1, lat2, lon2, i0, i1, outmask,
+                                    s12, azi1, azi2);
+                  });
+#else
+    (void)nthreads;
+    GenInverseRange(lat1, lon1, lat2, lon2, 0, n, outmask, s12, azi1, azi2);
+#endif
+  }
+
+  void GreatEllipse::GenInverseRange(const real* lat1, const real* lon1,
+                                     const real* lat2, const real* lon2,
+                                     size_t i0, size_t i1, unsigned outmask,
+                                     real* s12, real* azi1, real* azi2)
+    const {
+    // Evaluate the trigonometric functions for a block of problems using the
+    // vectorizable array version of Math::sincosd (which gives the same
+    // results as the scalar version).
+    const size_t nblock = 32;
+    real x[nblock], sphi1[nblock], cphi1[nblock], sphi2[nblock],
+      cphi2[nblock], slam12[nblock], clam12[nblock];
+    bool
+      distp = (outmask & DISTANCE) != 0U,
+      azip = (outmask & AZIMUTH) != 0U;
+    for (size_t j0 = i0; j0 < i1; j0 += nblock) {
+      size_t nb = min(nblock, i1 - j0);
+      Math::AngRound(lat1 + j0, x, nb);
+      Math::sincosd(x, sphi1, cphi1, nb);
+      Math::AngRound(lat2 + j0, x, nb);
+      Math::sincosd(x, sphi2, cphi2, nb);
+      for (size_t j = 0; j < nb; ++j)
+        x[j] = Math::AngRound(Math::AngDiff(Math::AngNormalize(lon1[j0 + j]),
+                                            Math::AngNormalize(lon2[j0 + j])));
+      Math::sincosd(x, slam12, clam12, nb);
+      for (size_t j = 0; j < nb; ++j) {
+        real s, a1, a2;
+        GenInverse(sphi1[j], cphi1[j], sphi2[j], cphi2[j],
+                   slam12[j], clam12[j], outmask, s, a1, a2);
+        if (distp) s12[j0 + j] = s;
+        if (azip) { azi1[j0 + j] = a1; azi2[j0 + j] = a2; }
+      }
+    }
+  }
+
+  void GreatEllipse::GenDirectBatch(const real* lat1, const real* lon1,
+                                    const real* azi1, const real* s12,
+                                    size_t n,
+                                    real* lat2, real* lon2, real* azi2,
+                                    unsigned outmask, int nthreads) const {
+#if GEOGRAPHICLIB_GREATELLIPSE_THREADS
+    // Divide the problems into nthreads contiguous ranges which are run
+    // by the current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    GenDirectRange(lat1, lon1, azi1, s12, i0, i1, outmask,
+                                   lat2, lon2, azi2);
+                  });
+#else
+    (void)nthreads;
+    GenDirectRange(lat1, lon1, azi1, s12, 0, n, outmask, lat2, lon2, azi2);
+#endif
+  }
+
+  void GreatEllipse::GenDirectRange(const real* lat1, const real* lon1,
+                                    const real* azi1, const real* s12,
+                                    size_t i0, size_t i1, unsigned outmask,
+                                    real* lat2, real* lon2, real* azi2)
+    const {
+    const size_t nblock = 32;
+    real x[nblock], sphi1[nblock], cphi1[nblock],
+      salp1[nblock], calp1[nblock];
+    bool
+      latp = (outmask & LATITUDE) != 0U,
+      lonp = (outmask & LONGITUDE) != 0U,
+      azip = (outmask & AZIMUTH) != 0U;
+    for (size_t j0 = i0; j0 < i1; j0 += nblock) {
+      size_t nb = min(nblock, i1 - j0);
+      Math::AngRound(lat1 + j0, x, nb);
+      Math::sincosd(x, sphi1, cphi1, nb);
+      for (size_t j = 0; j < nb; ++j)
+        x[j] = Math::AngRound(Math::AngNormalize(azi1[j0 + j]));
+      Math::sincosd(x, salp1, calp1, nb);
+      for (size_t j = 0; j < nb; ++j) {
+        real t1, t2, t3;
+        GreatEllipseLine(*this, lat1[j0 + j], lon1[j0 + j], azi1[j0 + j],
+                         sphi1[j], cphi1[j], salp1[j], calp1[j])
+          .GenPosition(s12[j0 + j], outmask, t1, t2, t3);
+        if (latp) lat2[j0 + j] = t1;
+        if (lonp) lon2[j0 + j] = t2;
+        if (azip) azi2[j0 + j] = t3;
+      }
+    }
+  }
+
+  GreatEllipseLine::GreatEllipseLine(const GreatEllipse& ge,
+                                     real lat1, real lon1, real azi1)
+    : tiny_(ge.tiny_)
+    , _f12(ge._f12)
+    , _lat1(lat1)
+    , _lon1(lon1)
+    , _azi1(Math::AngNormalize(azi1))
+  {
+    real sphi1, cphi1, salp1, calp1;
+    Math::sincosd(Math::AngRound(lat1), sphi1, cphi1);
+    Math::sincosd(Math::AngRound(_azi1), salp1, calp1);
+    Init(ge, sphi1, cphi1, salp1, calp1);
+  }
+
+  GreatEllipseLine::GreatEllipseLine(const GreatEllipse& ge,
+                                     real lat1, real lon1, real azi1,
+                                     real sphi1, real cphi1,
+                                     real salp1, real calp1)
+    : tiny_(ge.tiny_)
+    , _f12(ge._f12)
+    , _lat1(lat1)
+    , _lon1(lon1)
+    , _azi1(Math::AngNormalize(azi1))
+  { Init(ge, sphi1, cphi1, salp1, calp1); }
+
+  void GreatEllipseLine::Init(const GreatEllipse& ge,
+                              real sphi1, real cphi1,
+                              real salp1, real calp1) {
+    // The geocentric latitude of point 1 and the azimuth on the sphere
+    real sth1 = _f12 * sphi1, cth1 = cphi1;
+    Math::norm(sth1, cth1); cth1 = max(tiny_, cth1);
+    real sgam1 = salp1, cgam1 = calp1 * (cphi1 * cth1 + sphi1 * sth1);
+    Math::norm(sgam1, cgam1);
+    _salp0 = sgam1 * cth1;
+    _calp0 = Math::hypot(cgam1, sgam1 * sth1);
+    _ssig1 = sth1; _somg1 = _salp0 * sth1;
+    _csig1 = _comg1 = sth1 != 0 || cgam1 != 0 ? cth1 * cgam1 : 1;
+    Math::norm(_ssig1, _csig1); // sig1 in (-pi, pi]
+    // Math::norm(_somg1, _comg1); -- don't need to normalize!
+    real kp2 = ge._ep2 * Math::sq(_calp0),
+      eps = kp2 / (2 * (1 + sqrt(1 + kp2)) + kp2);
+    _k = sqrt(1 + kp2);
+    _b = ge._a / _k;
+    _ssig1p = _k * _ssig1; _csig1p = _csig1;
+    Math::norm(_ssig1p, _csig1p);
+    _A1m1 = Geodesic::A1m1f(eps, nC1_);
+    real C1a[nC1_ + 1];
+    Geodesic::C1f(eps, C1a, nC1_);
+    _B11 = Geodesic::SinCosSeries(true, _ssig1p, _csig1p, C1a, nC1_);
+    real s = sin(_B11), c = cos(_B11);
+    // tau1 = sig1' + B11
+    _stau1 = _ssig1p * c + _csig1p * s;
+    _ctau1 = _csig1p * c - _ssig1p * s;
+    Geodesic::C1pf(eps, _C1pa, nC1p_);
+  }
+
+  void GreatEllipseLine::GenPosition(real s12, unsigned outmask,
+                                     real& lat2, real& lon2, real& azi2)
+    const {
+    outmask &= GreatEllipse::ALL | GreatEllipse::LONG_UNROLL;
+    // As in GeodesicLine::GenPosition, except that the last step, the
+    // conversion of the parametric angle sig2' to the arc length sig2 on the
+    // sphere, is exact.
+    real
+      tau12 = s12 / (_b * (1 + _A1m1)),
+      s = sin(tau12),
+      c = cos(tau12),
+      // tau2 = tau1 + tau12
+      B12 = - Geodesic::SinCosSeries(true,
+                                     _stau1 * c + _ctau1 * s,
+                                     _ctau1 * c - _stau1 * s,
+                                     _C1pa, nC1p_),
+      sig12p = tau12 - (B12 - _B11),
+      ssig12p = sin(sig12p), csig12p = cos(sig12p),
+      ssig2p = _ssig1p * csig12p + _csig1p * ssig12p,
+      csig2p = _csig1p * csig12p - _ssig1p * ssig12p,
+      ssig2 = ssig2p, csig2 = _k * csig2p;
+    Math::norm(ssig2, csig2);
+    real
+      sth2 = _calp0 * ssig2,
+      cth2 = Math::hypot(_salp0, _calp0 * csig2),
+      sgam2 = _salp0, cgam2 = _calp0 * csig2;
+    if (cth2 == 0)
+      // I.e., salp0 = 0, csig2 = 0.  Break the degeneracy in this case
+      cth2 = cgam2 = tiny_;
+    // The geographic latitude of point 2: tan(phi) = tan(theta) / (1-f)^2
+    real sphi2 = sth2, cphi2 = _f12 * cth2;
+    Math::norm(sphi2, cphi2);
+    if (outmask & GreatEllipse::LATITUDE)
+      lat2 = Math::atan2d(sphi2, cphi2);
+    if (outmask & GreatEllipse::LONGITUDE) {
+      real somg2 = _salp0 * ssig2, comg2 = csig2;
+      if (outmask & GreatEllipse::LONG_UNROLL) {
+        real E = _salp0 < 0 ? -1 : 1; // east-going?
+        // sig12 on the sphere = sig12' + (sig2 - sig2') - (sig1 - sig1')
+        real
+          sig12 = sig12p
+          + atan2(ssig2 * csig2p - csig2 * ssig2p,
+                  csig2 * csig2p + ssig2 * ssig2p)
+          - atan2(_ssig1 * _csig1p - _csig1 * _ssig1p,
+                  _csig1 * _csig1p + _ssig1 * _ssig1p),
+          omg12 = E * (sig12
+                       - (atan2(    ssig2, csig2) - atan2(    _ssig1, _csig1))
+                       + (atan2(E * somg2, comg2) - atan2(E * _somg1, _comg1)));
+        lon2 = _lon1 + omg12 / Math::degree();
+      } else {
+        real omg12 = atan2(somg2 * _comg1 - comg2 * _somg1,
+                           comg2 * _comg1 + somg2 * _somg1);
+        lon2 = Math::AngNormalize(Math::AngNormalize(_lon1) +
+                                  Math::AngNormalize(omg12 / Math::degree()));
+      }
+    }
+    if (outmask & GreatEllipse::AZIMUTH)
+      azi2 = Math::atan2d(sgam2 * (cphi2 * cth2 + sphi2 * sth2), cgam2);
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,222 @@
+/**
+ * \file GridMapper.cpp
+ * \brief Implementation for GeographicLib::GridMapper class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/GridMapper.hpp>
+#include <vector>
+#include <algorithm>
+
+#if !defined(GEOGRAPHICLIB_GRIDMAPPER_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_GRIDMAPPER_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_GRIDMAPPER_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_GRIDMAPPER_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // Bilinear interpolation between the corners c[0] = (0,0), c[1] = (1,0),
+    // c[2] = (0,1), c[3] = (1,1).  This returns the corner values exactly.
+    inline Math::real Bilinear(const Math::real c[], Math::real fx,
+                               Math::real fy) {
+      return (1 - fy) * ((1 - fx) * c[0] + fx * c[1]) +
+        fy * ((1 - fx) * c[2] + fx * c[3]);
+    }
+  }
+
+  GridMapper::GridMapper(real tol, int cell)
+    : _tol(tol)
+    , _cell(cell)
+  {
+    if (!(Math::isfinite(_tol) && _tol >= 0))
+      throw GeographicErr("Tolerance is not non-negative");
+    if (!(_cell > 0))
+      throw GeographicErr("Cell size is not positive");
+  }
+
+  void GridMapper::Map(const Transform& t,
+                       real x0, real dx, int nx, real y0, real dy, int ny,
+                       real u[], real v[], int nthreads) const {
+    if (!(nx > 0 && ny > 0))
+      return;
+    // The number of rows of cells
+    int ncy = max(1, (ny - 1 + _cell - 1) / _cell);
+#if GEOGRAPHICLIB_GRIDMAPPER_THREADS
+    // Divide the rows of cells into nthreads contiguous ranges which are
+    // run by the current Executor.
+    Executor::For(size_t(ncy), size_t(max(nthreads, 1)),
+                  [&](size_t r0, size_t r1) {
+                    Rows(&t, x0, dx, nx, y0, dy, ny, int(r0), int(r1), u, v);
+                  });
+#else
+    (void)nthreads;
+    Rows(&t, x0, dx, nx, y0, dy, ny, 0, ncy, u, v);
+#endif
+  }
+
+  void GridMapper::Rows(const Transform* t, real x0, real dx, int nx,
+                        real y0, real dy, int ny, int r0, int r1,
+                        real u[], real v[]) const {
+    // Compute rows r0 thru r1 - 1 of cells.  Evaluate the lattice points
+    // bounding these cells in one batch.
+    int
+      ncx = max(1, (nx - 1 + _cell - 1) / _cell),
+      ncy = max(1, (ny - 1 + _cell - 1) / _cell),
+      nr = r1 - r0 + 1, nc = ncx + 1;
+    vector<real> x(size_t(nr) * nc), y(x.size()), lu(x.size()), lv(x.size());
+    for (int r = 0; r < nr; ++r) {
+      int j = min((r0 + r) * _cell, ny - 1);
+      for (int k = 0; k < nc; ++k) {
+        int i = min(k * _cell, nx - 1);
+        x[size_t(r) * nc + k] = x0 + i * dx;
+        y[size_t(r) * nc + k] = y0 + j * dy;
+      }
+    }
+    (*t)(&x[0], &y[0], x.size(), &lu[0], &lv[0]);
+    for (int r = r0; r < r1; ++r) {
+      int
+        j0 = min(r * _cell, ny - 1),
+        j1 = min((r + 1) * _cell, ny - 1);
+      for (int k = 0; k < ncx; ++k) {
+        int
+          i0 = min(k * _cell, nx - 1),
+          i1 = min((k + 1) * _cell, nx - 1);
+        size_t l = size_t(r - r0) * nc + k;
+        real
+          cu[] = {lu[l], lu[l + 1], lu[l + nc], lu[l + nc + 1]},
+          cv[] = {lv[l], lv[l + 1], lv[l + nc], lv[l + nc + 1]};
+        Cell(*t, x0, dx, nx, y0, dy, i0, i1, j0, j1,
+             k == ncx - 1, r == ncy - 1, cu, cv, u, v);
+      }
+    }
+  }
+
+  void GridMapper::Cell(const Transform& t, real x0, real dx, int nx,
+                        real y0, real dy,
+                        int i0, int i1, int j0, int j1,
+                        bool closex, bool closey,
+                        const real cu[], const real cv[],
+                        real u[], real v[]) const {
+    // Fill in the pixels i0 <= i < i1 and j0 <= j < j1 of a cell given the
+    // values at its corners.  The pixels with i = i1 (resp. j = j1) are
+    // included if closex (resp. closey) is true; otherwise they belong to
+    // the adjacent cell.
+    int
+      w = i1 - i0, h = j1 - j0,
+      ie = closex ? i1 : i1 - 1,
+      je = closey ? j1 : j1 - 1;
+    if (w <= 1 && h <= 1) {
+      // All the pixels are corners
+      for (int j = j0; j <= je; ++j)
+        for (int i = i0; i <= ie; ++i) {
+          int c = (i > i0 ? 1 : 0) + (j > j0 ? 2 : 0);
+          u[size_t(j) * nx + i] = cu[c];
+          v[size_t(j) * nx + i] = cv[c];
+        }
+      return;
+    }
+    // The nodes of the cell are the corners together with the midpoints in
+    // the directions in which the cell can be split.
+    int
+      ci[] = {i0, i0 + w/2, i1},
+      cj[] = {j0, j0 + h/2, j1},
+      ni = w > 1 ? 3 : 2,
+      nj = h > 1 ? 3 : 2;
+    if (ni == 2) ci[1] = i1;
+    if (nj == 2) cj[1] = j1;
+    real nu[3][3], nv[3][3];
+    nu[0][0] = cu[0]; nu[0][ni-1] = cu[1];
+    nu[nj-1][0] = cu[2]; nu[nj-1][ni-1] = cu[3];
+    nv[0][0] = cv[0]; nv[0][ni-1] = cv[1];
+    nv[nj-1][0] = cv[2]; nv[nj-1][ni-1] = cv[3];
+    // Evaluate the transformation at the other nodes
+    real px[5], py[5], pu[5], pv[5];
+    int np = 0;
+    for (int jj = 0; jj < nj; ++jj)
+      for (int ii = 0; ii < ni; ++ii) {
+        if ((ii == 0 || ii == ni - 1) && (jj == 0 || jj == nj - 1))
+          continue;
+        px[np] = x0 + ci[ii] * dx;
+        py[np] = y0 + cj[jj] * dy;
+        ++np;
+      }
+    t(px, py, np, pu, pv);
+    bool ok = true;
+    np = 0;
+    for (int jj = 0; jj < nj; ++jj)
+      for (int ii = 0; ii < ni; ++ii) {
+        if ((ii == 0 || ii == ni - 1) && (jj == 0 || jj == nj - 1))
+          continue;
+        nu[jj][ii] = pu[np]; nv[jj][ii] = pv[np];
+        real
+          fx = w > 0 ? real(ci[ii] - i0) / w : 0,
+          fy = h > 0 ? real(cj[jj] - j0) / h : 0;
+        // Reversed test to treat NaNs as failures
+        if (!(abs(Bilinear(cu, fx, fy) - pu[np]) <= _tol &&
+              abs(Bilinear(cv, fx, fy) - pv[np]) <= _tol))
+          ok = false;
+        ++np;
+      }
+    if (ok) {
+      for (int j = j0; j <= je; ++j) {
+        real fy = h > 0 ? real(j - j0) / h : 0;
+        for (int i = i0; i <= ie; ++i) {
+          real fx = w > 0 ? real(i - i0) / w : 0;
+          u[size_t(j) * nx + i] = Bilinear(cu, fx, fy);
+          v[size_t(j) * nx + i] = Bilinear(cv, fx, fy);
+        }
+      }
+      return;
+    }
+    if (w <= maxexact_ && h <= maxexact_) {
+      // Evaluate the transformation at all the pixels of a small cell; only
+      // the pixels belonging to this cell are included.
+      real
+        ex[(maxexact_ + 1) * (maxexact_ + 1)],
+        ey[(maxexact_ + 1) * (maxexact_ + 1)],
+        eu[(maxexact_ + 1) * (maxexact_ + 1)],
+        ev[(maxexact_ + 1) * (maxexact_ + 1)];
+      int ne = 0;
+      for (int j = j0; j <= je; ++j)
+        for (int i = i0; i <= ie; ++i) {
+          ex[ne] = x0 + i * dx;
+          ey[ne] = y0 + j * dy;
+          ++ne;
+        }
+      t(ex, ey, ne, eu, ev);
+      ne = 0;
+      for (int j = j0; j <= je; ++j)
+        for (int i = i0; i <= ie; ++i) {
+          u[size_t(j) * nx + i] = eu[ne];
+          v[size_t(j) * nx + i] = ev[ne];
+          ++ne;
+        }
+      return;
+    }
+    // Split the cell reusing the values at the nodes
+    for (int jj = 0; jj < nj - 1; ++jj)
+      for (int ii = 0; ii < ni - 1; ++ii) {
+        real
+          su[] = {nu[jj][ii], nu[jj][ii+1], nu[jj+1][ii], nu[jj+1][ii+1]},
+          sv[] = {nv[jj][ii], nv[jj][ii+1], nv[jj+1][ii], nv[jj+1][ii+1]};
+        Cell(t, x0, dx, nx, y0, dy,
+             ci[ii], ci[ii+1], cj[jj], cj[jj+1],
+             closex && ii == ni - 2, closey && jj == nj - 2,
+             su, sv, u, v);
+      }
+  }
+
+} // namespace GeographicLib
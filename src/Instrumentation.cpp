@@ -0,0 +1,228 @@
+/**
+ * \file Instrumentation.cpp
+ * \brief Implementation for GeographicLib::Instrumentation class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/Instrumentation.hpp>
+
+#if GEOGRAPHICLIB_INSTRUMENTATION
+#  if !(__cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#    error "GEOGRAPHICLIB_INSTRUMENTATION requires C++11"
+#  endif
+#  include <atomic>
+#  include <chrono>
+#  include <mutex>
+#  include <vector>
+#  include <algorithm>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  Instrumentation::Snapshot::Snapshot() {
+    for (int i = 0; i < NCOUNTERS; ++i) count[i] = 0;
+    for (int h = 0; h < NHISTOGRAMS; ++h)
+      for (int k = 0; k < nbins_; ++k) hist[h][k] = 0;
+    for (int i = 0; i < NSPANS; ++i) { calls[i] = 0; time[i] = 0; }
+  }
+
+  void Instrumentation::Snapshot::Add(const Snapshot& s) {
+    for (int i = 0; i < NCOUNTERS; ++i) count[i] += s.count[i];
+    for (int h = 0; h < NHISTOGRAMS; ++h)
+      for (int k = 0; k < nbins_; ++k) hist[h][k] += s.hist[h][k];
+    for (int i = 0; i < NSPANS; ++i) {
+      calls[i] += s.calls[i]; time[i] += s.time[i];
+    }
+  }
+
+#if GEOGRAPHICLIB_INSTRUMENTATION
+  namespace {
+
+    typedef atomic<unsigned long> counter_t;
+
+    // The counters for one thread.  These are only incremented by the
+    // owning thread; atomics are used so that other threads may read and
+    // reset them.  The times are in nanoseconds.
+    struct Block {
+      counter_t count[Instrumentation::NCOUNTERS];
+      counter_t hist[Instrumentation::NHISTOGRAMS][Instrumentation::nbins_];
+      counter_t calls[Instrumentation::NSPANS];
+      atomic<long long> time[Instrumentation::NSPANS];
+      Block() { Reset(); }
+      void Reset() {
+        for (int i = 0; i < Instrumentation::NCOUNTERS; ++i)
+          count[i].store(0, memory_order_relaxed);
+        for (int h = 0; h < Instrumentation::NHISTOGRAMS; ++h)
+          for (int k = 0; k < Instrumentation::nbins_; ++k)
+            hist[h][k].store(0, memory_order_relaxed);
+        for (int i = 0; i < Instrumentation::NSPANS; ++i) {
+          calls[i].store(0, memory_order_relaxed);
+          time[i].store(0, memory_order_relaxed);
+        }
+      }
+      void Get(Instrumentation::Snapshot& s) const {
+        for (int i = 0; i < Instrumentation::NCOUNTERS; ++i)
+          s.count[i] = count[i].load(memory_order_relaxed);
+        for (int h = 0; h < Instrumentation::NHISTOGRAMS; ++h)
+          for (int k = 0; k < Instrumentation::nbins_; ++k)
+            s.hist[h][k] = hist[h][k].load(memory_order_relaxed);
+        for (int i = 0; i < Instrumentation::NSPANS; ++i) {
+          s.calls[i] = calls[i].load(memory_order_relaxed);
+          s.time[i] = time[i].load(memory_order_relaxed) * 1e-9;
+        }
+      }
+    };
+
+    // The blocks of the running threads and the sum of the counters for the
+    // threads which have exited.
+    struct Registry {
+      mutex lock;
+      vector<Block*> blocks;
+      Instrumentation::Snapshot retired;
+    };
+
+    Registry& registry() {
+      static Registry r;
+      return r;
+    }
+
+    // The block for a thread registers itself on construction and adds its
+    // counts to the retired total when the thread exits.
+    struct ThreadBlock {
+      Block b;
+      ThreadBlock() {
+        Registry& r = registry();
+        lock_guard<mutex> g(r.lock);
+        r.blocks.push_back(&b);
+      }
+      ~ThreadBlock() {
+        Registry& r = registry();
+        lock_guard<mutex> g(r.lock);
+        Instrumentation::Snapshot s;
+        b.Get(s);
+        r.retired.Add(s);
+        r.blocks.erase(remove(r.blocks.begin(), r.blocks.end(), &b),
+                       r.blocks.end());
+      }
+    };
+
+    Block& block() {
+      static thread_local ThreadBlock t;
+      return t.b;
+    }
+
+    atomic<Instrumentation::Tracer*> tracer_(nullptr);
+
+    inline long long Now() {
+      return chrono::duration_cast<chrono::nanoseconds>
+        (chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+  }
+#endif
+
+  bool Instrumentation::Enabled() {
+    return GEOGRAPHICLIB_INSTRUMENTATION != 0;
+  }
+
+#if GEOGRAPHICLIB_INSTRUMENTATION
+  void Instrumentation::Count(counter c) {
+    block().count[c].fetch_add(1, memory_order_relaxed);
+  }
+
+  void Instrumentation::Record(histogram h, int k) {
+    block().hist[h][min(max(k, 0), nbins_ - 1)]
+      .fetch_add(1, memory_order_relaxed);
+  }
+
+  long long Instrumentation::Begin(span s) {
+    Tracer* t = tracer_.load(memory_order_acquire);
+    if (t) t->Begin(s);
+    return Now();
+  }
+
+  void Instrumentation::End(span s, long long t0) {
+    long long dt = Now() - t0;
+    Block& b = block();
+    b.calls[s].fetch_add(1, memory_order_relaxed);
+    b.time[s].fetch_add(dt, memory_order_relaxed);
+    Tracer* t = tracer_.load(memory_order_acquire);
+    if (t) t->End(s, dt * 1e-9);
+  }
+
+  Instrumentation::Tracer* Instrumentation::SetTracer(Tracer* tracer) {
+    return tracer_.exchange(tracer, memory_order_acq_rel);
+  }
+
+  bool Instrumentation::GetSnapshot(Snapshot& s, bool reset) {
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    s = r.retired;
+    for (size_t i = 0; i < r.blocks.size(); ++i) {
+      Snapshot t;
+      r.blocks[i]->Get(t);
+      s.Add(t);
+      if (reset) r.blocks[i]->Reset();
+    }
+    if (reset) r.retired = Snapshot();
+    return true;
+  }
+
+  bool Instrumentation::GetThreadSnapshot(Snapshot& s) {
+    block().Get(s);
+    return true;
+  }
+
+  void Instrumentation::Reset() {
+    Snapshot s;
+    GetSnapshot(s, true);
+  }
+#else
+  void Instrumentation::Count(counter) {}
+  void Instrumentation::Record(histogram, int) {}
+  long long Instrumentation::Begin(span) { return 0; }
+  void Instrumentation::End(span, long long) {}
+  Instrumentation::Tracer* Instrumentation::SetTracer(Tracer*) { return 0; }
+
+  bool Instrumentation::GetSnapshot(Snapshot& s, bool) {
+    s = Snapshot();
+    return false;
+  }
+
+  bool Instrumentation::GetThreadSnapshot(Snapshot& s) {
+    s = Snapshot();
+    return false;
+  }
+
+  void Instrumentation::Reset() {}
+#endif
+
+  const char* Instrumentation::Name(counter c) {
+    static const char* const names[NCOUNTERS] = {
+      "GEODESIC_INVERSE_FAIL", "GEOID_CACHE_HIT", "GEOID_CACHE_MISS",
+      "TMEXACT_ZETAINV_FAIL", "TMEXACT_SIGMAINV_FAIL",
+      "GEODESICINDEX_INVERSE", "GEODESICPOLYGON_INVERSE",
+    };
+    return c >= 0 && c < NCOUNTERS ? names[c] : "";
+  }
+
+  const char* Instrumentation::Name(histogram h) {
+    static const char* const names[NHISTOGRAMS] = {
+      "LAMBDA12_ITERATIONS", "TMEXACT_ITERATIONS",
+    };
+    return h >= 0 && h < NHISTOGRAMS ? names[h] : "";
+  }
+
+  const char* Instrumentation::Name(span s) {
+    static const char* const names[NSPANS] = {
+      "SPHERICAL_VALUE",
+    };
+    return s >= 0 && s < NSPANS ? names[s] : "";
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,276 @@
+/**
+ * \file InverseCache.cpp
+ * \brief Implementation for GeographicLib::InverseCacheT class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <vector>
+#include <GeographicLib/InverseCache.hpp>
+#include <GeographicLib/Utility.hpp>
+#include "CacheSupport.hpp"
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // x < y, with -0 < 0
+    bool Less(Math::real x, Math::real y) {
+      return x < y || (x == 0 && y == 0 && 1/x < 0 && 1/y > 0);
+    }
+
+    // Whether the output given by the mask value m is selected by outmask.
+    // The mask values include the capability bits needed for the output
+    // (e.g., DISTANCE includes CAP_C1); so all the bits of m must be set.
+    bool Selected(unsigned outmask, unsigned m)
+    { return (outmask & m) == m; }
+
+    // Copy the results v selected by outmask to the output arguments.
+    template<class GeodType>
+    void Copy(const GeodType&, unsigned outmask, const Math::real v[],
+              Math::real& s12, Math::real& azi1, Math::real& azi2,
+              Math::real& m12, Math::real& M12, Math::real& M21,
+              Math::real& S12) {
+      if (Selected(outmask, GeodType::DISTANCE)) s12 = v[0];
+      if (Selected(outmask, GeodType::AZIMUTH)) { azi1 = v[1]; azi2 = v[2]; }
+      if (Selected(outmask, GeodType::REDUCEDLENGTH)) m12 = v[3];
+      if (Selected(outmask, GeodType::GEODESICSCALE))
+        { M12 = v[4]; M21 = v[5]; }
+      if (Selected(outmask, GeodType::AREA)) S12 = v[6];
+    }
+
+    // Solve the problem putting the results in v; return a12.
+    template<class GeodType>
+    Math::real Solve(const GeodType& earth,
+                     Math::real lat1, Math::real lon1,
+                     Math::real lat2, Math::real lon2, unsigned outmask,
+                     Math::real v[]) {
+      return earth.GenInverse(lat1, lon1, lat2, lon2, outmask,
+                              v[0], v[1], v[2], v[3], v[4], v[5], v[6]);
+    }
+
+    // Rhumb has no arc length.
+    Math::real Solve(const Rhumb& earth,
+                     Math::real lat1, Math::real lon1,
+                     Math::real lat2, Math::real lon2, unsigned outmask,
+                     Math::real v[]) {
+      earth.GenInverse(lat1, lon1, lat2, lon2, outmask, v[0], v[1], v[6]);
+      return Math::NaN();
+    }
+
+    // Rhumb only sets s12, azi1 (= azi12), and S12.
+    void Copy(const Rhumb&, unsigned outmask, const Math::real v[],
+              Math::real& s12, Math::real& azi1, Math::real&,
+              Math::real&, Math::real&, Math::real&,
+              Math::real& S12) {
+      if (outmask & Rhumb::DISTANCE) s12 = v[0];
+      if (outmask & Rhumb::AZIMUTH) azi1 = v[1];
+      if (outmask & Rhumb::AREA) S12 = v[6];
+    }
+  }
+
+  template <class GeodType>
+  class InverseCacheT<GeodType>::Impl {
+  public:
+    struct Key {
+      real x[4];                // lat1, lon1, lat2, lon2
+      unsigned outmask;
+      bool operator<(const Key& k) const {
+        for (int i = 0; i < 4; ++i) {
+          if (Less(x[i], k.x[i])) return true;
+          if (Less(k.x[i], x[i])) return false;
+        }
+        return outmask < k.outmask;
+      }
+    };
+    struct Value {
+      real v[8];                // s12, azi1, azi2, m12, M12, M21, S12, a12
+    };
+    typedef LRUCache<Key, Value> Shard;
+    const GeodType _earth;
+    real _dq;
+    // The total capacity (guarded by _mutex, which also serializes calls to
+    // SetCapacity)
+    size_t _capacity;
+    vector<Shard> _shards;
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+    mutable mutex _mutex;
+#endif
+    Impl(const GeodType& earth, size_t capacity, real dq, int nshards)
+      : _earth(earth)
+      , _dq(dq)
+      , _capacity(capacity)
+    {
+      if (!(Math::isfinite(_dq) && _dq >= 0))
+        throw GeographicErr("Quantum " + Utility::str(_dq)
+                            + " is not a nonnegative number");
+      if (!(nshards > 0))
+        throw GeographicErr("Number of shards " + Utility::str(nshards)
+                            + " is not positive");
+      vector<Shard>(nshards).swap(_shards);
+      SetCapacity(capacity);
+    }
+    void SetCapacity(size_t capacity) {
+      CacheGuard<Impl> lock(*this);
+      _capacity = capacity;
+      size_t n = _shards.size();
+      for (size_t i = 0; i < n; ++i) {
+        CacheGuard<Shard> lockshard(_shards[i]);
+        // Divide the capacity as evenly as possible
+        _shards[i].SetCapacity(capacity / n + (i < capacity % n ? 1 : 0));
+      }
+    }
+    // Assign a problem to a shard.  This only needs to spread the problems
+    // evenly over the shards.
+    Shard& Select(const Key& key) {
+      real t = 0;
+      for (int i = 0; i < 4; ++i)
+        t = t * real(1.6180339887498948482) + key.x[i];
+      t = fmod(abs(t) * 65536, real(4294967296.0));
+      unsigned long h = (unsigned long)(t) + key.outmask;
+      h ^= h >> 16;
+      return _shards[h % _shards.size()];
+    }
+    real GenInverse(real lat1, real lon1, real lat2, real lon2,
+                    unsigned outmask,
+                    real& s12, real& azi1, real& azi2,
+                    real& m12, real& M12, real& M21, real& S12) {
+      if (_dq > 0) {
+        lat1 = Quantize(lat1, true); lon1 = Quantize(lon1, false);
+        lat2 = Quantize(lat2, true); lon2 = Quantize(lon2, false);
+      }
+      Key key = { { lat1, lon1, lat2, lon2 }, outmask & GeodType::ALL };
+      // NaNs can't be used as keys in a map (and infinities can't be
+      // hashed).
+      bool cacheable = Math::isfinite(lat1) && Math::isfinite(lon1) &&
+        Math::isfinite(lat2) && Math::isfinite(lon2);
+      Shard* shard = cacheable ? &Select(key) : 0;
+      if (cacheable) {
+        CacheGuard<Shard> lock(*shard);
+        const Value* val = shard->Find(key);
+        if (val) {
+          Copy(_earth, outmask, val->v,
+               s12, azi1, azi2, m12, M12, M21, S12);
+          return val->v[7];
+        }
+      }
+      // Solve the problem without holding the lock.
+      Value val = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+      real* v = val.v;
+      v[7] = Solve(_earth, lat1, lon1, lat2, lon2, outmask, v);
+      Copy(_earth, outmask, v, s12, azi1, azi2, m12, M12, M21, S12);
+      if (cacheable) {
+        CacheGuard<Shard> lock(*shard);
+        shard->Insert(key, val);
+      }
+      return v[7];
+    }
+    real Quantize(real x, bool latp) const {
+      if (!Math::isfinite(x)) return x;
+      x = floor(x / _dq + real(0.5)) * _dq;
+      return latp ? max(-real(90), min(real(90), x)) : x;
+    }
+  };
+
+  template <class GeodType>
+  InverseCacheT<GeodType>::InverseCacheT(const GeodType& earth,
+                                         size_t capacity, real dq,
+                                         int nshards)
+    : _impl(new Impl(earth, capacity, dq, nshards))
+  {}
+
+  template <class GeodType>
+  InverseCacheT<GeodType>::~InverseCacheT() { delete _impl; }
+
+  template <class GeodType>
+  Math::real InverseCacheT<GeodType>::GenInverse(real lat1, real lon1,
+                                                 real lat2, real lon2,
+                                                 unsigned outmask,
+                                                 real& s12,
+                                                 real& azi1, real& azi2,
+                                                 real& m12, real& M12,
+                                                 real& M21, real& S12) {
+    return _impl->GenInverse(lat1, lon1, lat2, lon2, outmask,
+                             s12, azi1, azi2, m12, M12, M21, S12);
+  }
+
+  template <class GeodType>
+  void InverseCacheT<GeodType>::Clear() {
+    for (size_t i = 0; i < _impl->_shards.size(); ++i) {
+      typename Impl::Shard& shard = _impl->_shards[i];
+      CacheGuard<typename Impl::Shard> lock(shard);
+      shard.Clear();
+    }
+  }
+
+  template <class GeodType>
+  void InverseCacheT<GeodType>::SetCapacity(size_t capacity)
+  { _impl->SetCapacity(capacity); }
+
+  template <class GeodType>
+  void InverseCacheT<GeodType>::ResetCounters() {
+    for (size_t i = 0; i < _impl->_shards.size(); ++i) {
+      typename Impl::Shard& shard = _impl->_shards[i];
+      CacheGuard<typename Impl::Shard> lock(shard);
+      shard._hits = shard._misses = 0;
+    }
+  }
+
+  template <class GeodType>
+  size_t InverseCacheT<GeodType>::Capacity() const {
+    CacheGuard<Impl> lock(*_impl);
+    return _impl->_capacity;
+  }
+
+  template <class GeodType>
+  size_t InverseCacheT<GeodType>::Size() const {
+    size_t n = 0;
+    for (size_t i = 0; i < _impl->_shards.size(); ++i) {
+      const typename Impl::Shard& shard = _impl->_shards[i];
+      CacheGuard<typename Impl::Shard> lock(shard);
+      n += shard._values.size();
+    }
+    return n;
+  }
+
+  template <class GeodType>
+  unsigned long InverseCacheT<GeodType>::Hits() const {
+    unsigned long n = 0;
+    for (size_t i = 0; i < _impl->_shards.size(); ++i) {
+      const typename Impl::Shard& shard = _impl->_shards[i];
+      CacheGuard<typename Impl::Shard> lock(shard);
+      n += shard._hits;
+    }
+    return n;
+  }
+
+  template <class GeodType>
+  unsigned long InverseCacheT<GeodType>::Misses() const {
+    unsigned long n = 0;
+    for (size_t i = 0; i < _impl->_shards.size(); ++i) {
+      const typename Impl::Shard& shard = _impl->_shards[i];
+      CacheGuard<typename Impl::Shard> lock(shard);
+      n += shard._misses;
+    }
+    return n;
+  }
+
+  template <class GeodType>
+  Math::real InverseCacheT<GeodType>::Quantum() const { return _impl->_dq; }
+
+  template <class GeodType>
+  int InverseCacheT<GeodType>::Shards() const
+  { return int(_impl->_shards.size()); }
+
+  template <class GeodType>
+  bool InverseCacheT<GeodType>::ThreadSafe()
+  { return GEOGRAPHICLIB_CACHE_THREADSAFE != 0; }
+
+  template class GEOGRAPHICLIB_EXPORT InverseCacheT<Geodesic>;
+  template class GEOGRAPHICLIB_EXPORT InverseCacheT<GeodesicExact>;
+  template class GEOGRAPHICLIB_EXPORT InverseCacheT<Rhumb>;
+
+} // namespace GeographicLib
@@ -0,0 +1,90 @@
+/**
+ * \file JacobiConformal.cpp
+ * \brief Implementation for GeographicLib::JacobiConformal class
+ *
+ * Copyright (c) Charles Karney (2014-2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/JacobiConformal.hpp>
+
+#if !defined(GEOGRAPHICLIB_JACOBICONFORMAL_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_JACOBICONFORMAL_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_JACOBICONFORMAL_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_JACOBICONFORMAL_THREADS
+#  include <GeographicLib/Executor.hpp>
+#  include <algorithm>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  JacobiConformal::JacobiConformal(real a, real b, real c)
+    : _a(a), _b(b), _c(c)
+    , _ab2((_a - _b) * (_a + _b))
+    , _bc2((_b - _c) * (_b + _c))
+    , _ac2((_a - _c) * (_a + _c))
+    , _ex(_ab2 / _ac2 * Math::sq(_c / _b), -_ab2 / Math::sq(_b),
+          _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
+    , _ey(_bc2 / _ac2 * Math::sq(_a / _b), +_bc2 / Math::sq(_b),
+          _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
+  {
+    if (!(a >= b && b >= c && c > 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(a > c))
+      throw GeographicErr
+        ("JacobiConformal: use alternate constructor for sphere");
+    _sx = _ex.PrecomputeSeries();
+    _sy = _ey.PrecomputeSeries();
+  }
+
+  JacobiConformal::JacobiConformal(real a, real b, real c, real ab, real bc)
+    : _a(a), _b(b), _c(c)
+    , _ab2(ab * (_a + _b))
+    , _bc2(bc * (_b + _c))
+    , _ac2(_ab2 + _bc2)
+    , _ex(_ab2 / _ac2 * Math::sq(_c / _b),
+          -(_a - _b) * (_a + _b) / Math::sq(_b),
+          _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
+    , _ey(_bc2 / _ac2 * Math::sq(_a / _b),
+          +(_b - _c) * (_b + _c) / Math::sq(_b),
+          _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
+  {
+    if (!(a >= b && b >= c && c > 0 && ab >= 0 && bc >= 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(ab + bc > 0))
+      throw GeographicErr("JacobiConformal: ab + bc must be positive");
+    _sx = _ex.PrecomputeSeries();
+    _sy = _ey.PrecomputeSeries();
+  }
+
+  void JacobiConformal::Forward(const real* omg, const real* bet, size_t n,
+                                real* x, real* y, int nthreads) const {
+#if GEOGRAPHICLIB_JACOBICONFORMAL_THREADS
+    // Divide the points into nthreads contiguous ranges which are run by the
+    // current Executor.
+    Executor::For(n, size_t(max(nthreads, 1)),
+                  [&](size_t i0, size_t i1) {
+                    ForwardRange(omg, bet, i0, i1, x, y);
+                  });
+#else
+    (void)nthreads;
+    ForwardRange(omg, bet, 0, n, x, y);
+#endif
+  }
+
+  void JacobiConformal::ForwardRange(const real* omg, const real* bet,
+                                     size_t i0, size_t i1,
+                                     real* x, real* y) const {
+    for (size_t i = i0; i < i1; ++i)
+      Forward(omg[i], bet[i], x[i], y[i]);
+  }
+
+} // namespace GeographicLib
@@ -7,6 +7,8 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/LambertConformalConic.hpp>
 
 namespace GeographicLib {
@@ -345,33 +347,100 @@ namespace GeographicLib {
     //
     // where nrho0 = n * rho0, drho = rho - rho0
     // and drho is evaluated with divided differences
+    real drho, sx, cy, ctheta;
+    ForwardLat(lat, drho, k);
+    ForwardLon(lon, sx, cy, ctheta, gamma);
+    x = (_nrho0 + _n * drho) * sx;
+    y = _nrho0 * cy - drho * ctheta;
+    y *= _sign;
+  }
+
+  void LambertConformalConic::ForwardLat(real lat, real& drho, real& k)
+    const {
     real
-      lam = lon * Math::degree(),
       phi = _sign * lat * Math::degree(),
       sphi = sin(phi), cphi = abs(lat) != 90 ? cos(phi) : epsx_,
       tphi = sphi/cphi, scbet = hyp(_fm * tphi),
       scphi = 1/cphi, shxi = sinh(Math::eatanhe(sphi, _es)),
       tchi = hyp(shxi) * tphi - shxi * scphi, scchi = hyp(tchi),
       psi = Math::asinh(tchi),
-      theta = _n * lam, stheta = sin(theta), ctheta = cos(theta),
-      dpsi = Dasinh(tchi, _tchi0, scchi, _scchi0) * (tchi - _tchi0),
-      drho = - _scale * (2 * _nc < 1 && dpsi != 0 ?
-                         (exp(Math::sq(_nc)/(1 + _n) * psi ) *
-                          (tchi > 0 ? 1/(scchi + tchi) : (scchi - tchi))
-                          - (_t0nm1 + 1))/(-_n) :
-                         Dexp(-_n * psi, -_n * _psi0) * dpsi);
-    x = (_nrho0 + _n * drho) * (_n ? stheta / _n : lam);
-    y = _nrho0 *
-      (_n ?
-       (ctheta < 0 ? 1 - ctheta : Math::sq(stheta)/(1 + ctheta)) / _n : 0)
-      - drho * ctheta;
+      dpsi = Dasinh(tchi, _tchi0, scchi, _scchi0) * (tchi - _tchi0);
+    drho = - _scale * (2 * _nc < 1 && dpsi != 0 ?
+                       (exp(Math::sq(_nc)/(1 + _n) * psi ) *
+                        (tchi > 0 ? 1/(scchi + tchi) : (scchi - tchi))
+                        - (_t0nm1 + 1))/(-_n) :
+                       Dexp(-_n * psi, -_n * _psi0) * dpsi);
     k = _k0 * (scbet/_scbet0) /
       (exp( - (Math::sq(_nc)/(1 + _n)) * dpsi )
        * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) / (_scchi0 + _tchi0));
-    y *= _sign;
+  }
+
+  void LambertConformalConic::ForwardLon(real lon, real& sx, real& cy,
+                                         real& ctheta, real& gamma) const {
+    // lon is relative to the central meridian
+    real
+      lam = lon * Math::degree(),
+      theta = _n * lam, stheta = sin(theta);
+    ctheta = cos(theta);
+    sx = _n ? stheta / _n : lam;
+    cy = _n ?
+      (ctheta < 0 ? 1 - ctheta : Math::sq(stheta)/(1 + ctheta)) / _n : 0;
     gamma = _sign * theta / Math::degree();
   }
 
+  void LambertConformalConic::ForwardBatch(real lon0,
+                                           const real lat[], const real lon[],
+                                           size_t n, real x[], real y[],
+                                           real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real g, kk;
+      Forward(lon0, lat[i], lon[i], x[i], y[i], g, kk);
+      if (gamma) gamma[i] = g;
+      if (k) k[i] = kk;
+    }
+  }
+
+  void LambertConformalConic::ForwardGrid(real lon0,
+                                          real lat1, real dlat, int nlat,
+                                          real lon1, real dlon, int nlon,
+                                          real x[], real y[],
+                                          real gamma[], real k[]) const {
+    if (nlat <= 0 || nlon <= 0)
+      return;
+    // The longitude dependent quantities for each column
+    vector<real> sx(nlon), cy(nlon), ctheta(nlon), g(nlon);
+    real lon0a = Math::AngNormalize(lon0);
+    for (int j = 0; j < nlon; ++j)
+      ForwardLon(Math::AngDiff(lon0a, Math::AngNormalize(lon1 + j * dlon)),
+                 sx[j], cy[j], ctheta[j], g[j]);
+    for (int i = 0; i < nlat; ++i) {
+      real drho, kk;
+      ForwardLat(lat1 + i * dlat, drho, kk);
+      real nrho = _nrho0 + _n * drho;
+      size_t l = size_t(i) * nlon;
+      for (int j = 0; j < nlon; ++j) {
+        x[l + j] = nrho * sx[j];
+        y[l + j] = _sign * (_nrho0 * cy[j] - drho * ctheta[j]);
+      }
+      if (gamma)
+        copy(g.begin(), g.end(), gamma + l);
+      if (k)
+        fill(k + l, k + l + nlon, kk);
+    }
+  }
+
+  void LambertConformalConic::ReverseBatch(real lon0,
+                                           const real x[], const real y[],
+                                           size_t n, real lat[], real lon[],
+                                           real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real g, kk;
+      Reverse(lon0, x[i], y[i], lat[i], lon[i], g, kk);
+      if (gamma) gamma[i] = g;
+      if (k) k[i] = kk;
+    }
+  }
+
   void LambertConformalConic::Reverse(real lon0, real x, real y,
                                       real& lat, real& lon,
                                       real& gamma, real& k)
@@ -0,0 +1,113 @@
+/**
+ * \file LinePipeline.cpp
+ * \brief Implementation for GeographicLib::LinePipeline class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/LinePipeline.hpp>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <vector>
+#include <GeographicLib/Executor.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  int LinePipeline::Stage::Block(const char* begin, const char* end,
+                                 std::ostream& out) const {
+    int retval = 0;
+    string s;
+    while (begin < end) {
+      const char* nl = find(begin, end, '\n');
+      s.assign(begin, nl);
+      retval = max(retval, (*this)(s, out));
+      begin = nl == end ? end : nl + 1;
+    }
+    return retval;
+  }
+
+  // The body of the parallel loop over the pieces of a block
+  class LinePipeline::Pieces {
+  private:
+    const Stage& _stage;
+    const vector<const char*>& _piece;
+    vector<string>& _out;
+    vector<int>& _ret;
+    Pieces& operator=(const Pieces&);
+  public:
+    Pieces(const Stage& stage, const vector<const char*>& piece,
+           vector<string>& out, vector<int>& ret)
+      : _stage(stage), _piece(piece), _out(out), _ret(ret) {}
+    void operator()(size_t k0, size_t k1) const {
+      for (size_t k = k0; k < k1; ++k) {
+        ostringstream output;
+        _ret[k] = _stage.Block(_piece[k], _piece[k + 1], output);
+        _out[k] = output.str();
+      }
+    }
+  };
+
+  LinePipeline::LinePipeline(int nthreads, size_t blocksize)
+    : _nthreads(max(nthreads, 1))
+    , _blocksize(max(blocksize, size_t(1)))
+  {}
+
+  int LinePipeline::Run(std::istream& in, std::ostream& out,
+                        const Stage& stage) const {
+    int retval = 0;
+    if (_nthreads == 1) {
+      string s;
+      while (getline(in, s))
+        retval = max(retval, stage(s, out));
+      return retval;
+    }
+    const size_t nthreads = size_t(_nthreads);
+    vector<char> buf;
+    vector<string> outs(nthreads);
+    vector<int> ret(nthreads, 0);
+    vector<const char*> piece(nthreads + 1);
+    size_t carry = 0;           // Bytes carried over from the last block
+    bool eof = false;
+    while (!eof) {
+      buf.resize(max(buf.size(), carry + nthreads * _blocksize));
+      in.read(&buf[carry], streamsize(buf.size() - carry));
+      size_t n = carry + size_t(in.gcount());
+      eof = !in;
+      // Process complete lines (or everything at the end of the input)
+      size_t end = n;
+      if (!eof) {
+        while (end > 0 && buf[end - 1] != '\n') --end;
+        if (end == 0) {
+          // No newline in the buffer; read more
+          carry = n;
+          buf.resize(2 * buf.size());
+          continue;
+        }
+      }
+      const char* start = &buf[0];
+      fill(piece.begin(), piece.end(), start + end);
+      piece[0] = start;
+      for (size_t k = 1; k < nthreads; ++k) {
+        // Start piece k after the newline preceding k * end / nthreads
+        const char* p = max(piece[k - 1], start + k * end / nthreads);
+        while (p > piece[k - 1] && p[-1] != '\n') --p;
+        piece[k] = p;
+      }
+      Executor::For(nthreads, nthreads, Pieces(stage, piece, outs, ret));
+      for (size_t k = 0; k < nthreads; ++k) {
+        out.write(outs[k].data(), streamsize(outs[k].size()));
+        retval = max(retval, ret[k]);
+      }
+      carry = n - end;
+      copy(buf.begin() + end, buf.begin() + n, buf.begin());
+    }
+    return retval;
+  }
+
+} // namespace GeographicLib
@@ -26,6 +26,65 @@ namespace GeographicLib {
       slam = _lon0 == -180 ? 0 : sin(lam),
       clam = abs(_lon0) == 90 ? 0 : cos(lam);
     Geocentric::Rotation(sphi, cphi, slam, clam, _r);
+    _lata = _lat0; _lona = _lon0;
+    _sphia = sphi; _cphia = cphi; _slama = slam; _clama = clam;
+  }
+
+  void LocalCartesian::Recenter(real lat0, real lon0, real h0) {
+    // Above 0.01 rad the series for sin and cos below need more terms.
+    static const real maxstep = real(0.01);
+    // The changes are measured from the anchor (the origin given to the last
+    // call to Reset), so that roundoff does not accumulate.
+    lon0 = Math::AngNormalize(lon0);
+    real
+      dphi = (lat0 - _lata) * Math::degree(),
+      dlam = Math::AngDiff(_lona, lon0) * Math::degree();
+    if (!(abs(dphi) <= maxstep && abs(dlam) <= maxstep && abs(lat0) < 90)) {
+      Reset(lat0, lon0, h0);
+      return;
+    }
+    real
+      sphi = _sphia, cphi = _cphia, slam = _slama, clam = _clama;
+    SmallRotate(dphi, sphi, cphi);
+    SmallRotate(dlam, slam, clam);
+    _lat0 = lat0;
+    _lon0 = lon0;
+    _h0 = h0;
+    // This is Geocentric::IntForward
+    real n = _earth._a / sqrt(1 - _earth._e2 * Math::sq(sphi));
+    _z0 = (_earth._e2m * n + _h0) * sphi;
+    _x0 = (n + _h0) * cphi;
+    _y0 = _x0 * slam;
+    _x0 *= clam;
+    Geocentric::Rotation(sphi, cphi, slam, clam, _r);
+  }
+
+  void LocalCartesian::SmallRotate(real d, real& s, real& c) {
+    // Rotate (s, c) through the angle d with |d| <= 0.01 using the Taylor
+    // series for sin(d) and cos(d); the truncation error is less than
+    // d^9/9! = 3e-24.
+    real
+      d2 = Math::sq(d),
+      sd = d * (1 - d2/6 * (1 - d2/20 * (1 - d2/42))),
+      cd = 1 - d2/2 * (1 - d2/12 * (1 - d2/30 * (1 - d2/56))),
+      t = s * cd + c * sd;
+    c = c * cd - s * sd;
+    s = t;
+  }
+
+  void LocalCartesian::FrameTransform(const LocalCartesian& lc,
+                                      real A[dim2_], real b[dim_]) const {
+    // p = r' . (r1 . p1 + o1 - o), so A = r' . r1 and b = r' . (o1 - o).
+    real
+      dx = lc._x0 - _x0,
+      dy = lc._y0 - _y0,
+      dz = lc._z0 - _z0;
+    for (size_t i = 0; i < dim_; ++i) {
+      for (size_t j = 0; j < dim_; ++j)
+        A[dim_ * i + j] = _r[i] * lc._r[j] + _r[i+3] * lc._r[j+3] +
+          _r[i+6] * lc._r[j+6];
+      b[i] = _r[i] * dx + _r[i+3] * dy + _r[i+6] * dz;
+    }
   }
 
   void LocalCartesian::MatrixMultiply(real M[dim2_]) const {
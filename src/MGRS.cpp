@@ -10,20 +10,84 @@
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/Utility.hpp>
 
+#if !defined(GEOGRAPHICLIB_MGRS_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_MGRS_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_MGRS_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_MGRS_THREADSAFE
+#  include <mutex>
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
-  const string MGRS::hemispheres_ = "SN";
-  const string MGRS::utmcols_[3] = { "ABCDEFGH", "JKLMNPQR", "STUVWXYZ" };
-  const string MGRS::utmrow_ = "ABCDEFGHJKLMNPQRSTUV";
-  const string MGRS::upscols_[4] =
+  const char* const MGRS::hemispheres_ = "SN";
+  const char* const MGRS::utmcols_[3] = { "ABCDEFGH", "JKLMNPQR", "STUVWXYZ" };
+  const char* const MGRS::utmrow_ = "ABCDEFGHJKLMNPQRSTUV";
+  const char* const MGRS::upscols_[4] =
     { "JKLPQRSTUXYZ", "ABCFGHJKLPQR", "RSTUXYZ", "ABCFGHJ" };
-  const string MGRS::upsrows_[2] =
+  const char* const MGRS::upsrows_[2] =
     { "ABCDEFGHJKLMNPQRSTUVWXYZ", "ABCDEFGHJKLMNP" };
-  const string MGRS::latband_ = "CDEFGHJKLMNPQRSTUVWX";
-  const string MGRS::upsband_ = "ABYZ";
-  const string MGRS::digits_ = "0123456789";
+  const char* const MGRS::latband_ = "CDEFGHJKLMNPQRSTUVWX";
+  const char* const MGRS::upsband_ = "ABYZ";
+  const char* const MGRS::digits_ = "0123456789";
+
+  // Tables giving the index of each character in the strings above (as
+  // returned by Utility::lookup), so that MGRS::Reverse need not search the
+  // strings.  These are filled in on the first call to Get (instead of when
+  // the library is loaded).
+  class MGRS::Decoder {
+  private:
+    static Decoder decoder_;
+#if GEOGRAPHICLIB_MGRS_THREADSAFE
+    static once_flag init_;
+#else
+    static bool init_;
+#endif
+    static void Fill(signed char t[], const char* s) {
+      for (int c = 0; c < 256; ++c)
+        t[c] = static_cast<signed char>(Utility::lookup(s, char(c)));
+    }
+    static void Init() {
+      Decoder& d = decoder_;
+      Fill(d.digits, digits_);
+      Fill(d.latband, latband_);
+      Fill(d.upsband, upsband_);
+      for (int i = 0; i < 3; ++i) Fill(d.utmcols[i], utmcols_[i]);
+      Fill(d.utmrow, utmrow_);
+      for (int i = 0; i < 4; ++i) Fill(d.upscols[i], upscols_[i]);
+      for (int i = 0; i < 2; ++i) Fill(d.upsrows[i], upsrows_[i]);
+    }
+  public:
+    signed char digits[256], latband[256], upsband[256], utmcols[3][256],
+      utmrow[256], upscols[4][256], upsrows[2][256];
+    static int Index(const signed char t[], char c)
+    { return t[static_cast<unsigned char>(c)]; }
+    static const Decoder& Get() {
+#if GEOGRAPHICLIB_MGRS_THREADSAFE
+      // Visual Studio 2012 and 2013 don't initialize function-scope statics
+      // thread-safely; so fill in the tables with call_once.
+      call_once(init_, Init);
+#else
+      if (!init_) { Init(); init_ = true; }
+#endif
+      return decoder_;
+    }
+  };
+
+  // decoder_ has no constructor; so it's zero-initialized at load time and
+  // filled in by Init.
+  MGRS::Decoder MGRS::Decoder::decoder_;
+#if GEOGRAPHICLIB_MGRS_THREADSAFE
+  once_flag MGRS::Decoder::init_;
+#else
+  bool MGRS::Decoder::init_ = false;
+#endif
 
   const int MGRS::mineasting_[4] =
     { minupsSind_, minupsNind_, minutmcol_, minutmcol_ };
@@ -38,22 +102,82 @@ namespace GeographicLib {
 
   void MGRS::Forward(int zone, bool northp, real x, real y, real lat,
                      int prec, std::string& mgrs) {
+    // Fixed char array for accumulating string.
+    char mgrs1[maxlen_];
+    int mlen = Encode(zone, northp, x, y, lat, prec, mgrs1, true);
+    mgrs.resize(mlen);
+    copy(mgrs1, mgrs1 + mlen, mgrs.begin());
+  }
+
+  size_t MGRS::Forward(int zone, bool northp, real x, real y, real lat,
+                       int prec, char* mgrs, size_t cap) {
+    char mgrs1[maxlen_];
+    int mlen = Encode(zone, northp, x, y, lat, prec, mgrs1, true);
+    if (!(size_t(mlen) < cap))
+      throw GeographicErr("Buffer of size " + Utility::str(cap)
+                          + " too small for MGRS string");
+    copy(mgrs1, mgrs1 + mlen, mgrs);
+    mgrs[mlen] = '\0';
+    return size_t(mlen);
+  }
+
+  size_t MGRS::Forward(int zone, bool northp, real x, real y,
+                       int prec, char* mgrs, size_t cap) {
+    return Forward(zone, northp, x, y, ApproxLatitude(zone, northp, x, y, true),
+                   prec, mgrs, cap);
+  }
+
+  size_t MGRS::ForwardBatch(const int zone[], const bool northp[],
+                            const real x[], const real y[], const real lat[],
+                            size_t n, int prec, char* mgrs, size_t stride) {
+    if (!(prec >= -1 && prec <= maxprec_))
+      throw GeographicErr("MGRS precision " + Utility::str(prec)
+                          + " not in [-1, "
+                          + Utility::str(int(maxprec_)) + "]");
+    // Longest possible result is for UTM or "INVALID", plus the terminator.
+    if (!(stride > size_t((max)(2 + 3 + 2 * prec, 7))))
+      throw GeographicErr("Stride " + Utility::str(stride)
+                          + " too small for MGRS strings with precision "
+                          + Utility::str(prec));
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      char* mgrs1 = mgrs + i * stride;
+      real lat1 = lat ? lat[i] :
+        ApproxLatitude(zone[i], northp[i], x[i], y[i], false);
+      int mlen = Encode(zone[i], northp[i], x[i], y[i], lat1, prec, mgrs1,
+                        false);
+      if (mlen < 0) {
+        mlen = 0;
+        ++nbad;
+      }
+      mgrs1[mlen] = '\0';
+    }
+    return nbad;
+  }
+
+  int MGRS::Encode(int zone, bool northp, real x, real y, real lat,
+                   int prec, char mgrs1[], bool throwp) {
     if (zone == UTMUPS::INVALID ||
         Math::isnan(x) || Math::isnan(y) || Math::isnan(lat)) {
-      mgrs = "INVALID";
-      return;
+      const char* invalid = "INVALID";
+      copy(invalid, invalid + 7, mgrs1);
+      return 7;
     }
     bool utmp = zone != 0;
-    CheckCoords(utmp, northp, x, y);
-    if (!(zone >= UTMUPS::MINZONE && zone <= UTMUPS::MAXZONE))
+    if (!CheckCoords(utmp, northp, x, y, throwp))
+      return -1;
+    if (!(zone >= UTMUPS::MINZONE && zone <= UTMUPS::MAXZONE)) {
+      if (!throwp) return -1;
       throw GeographicErr("Zone " + Utility::str(zone) + " not in [0,60]");
-    if (!(prec >= -1 && prec <= maxprec_))
+    }
+    if (!(prec >= -1 && prec <= maxprec_)) {
+      if (!throwp) return -1;
       throw GeographicErr("MGRS precision " + Utility::str(prec)
                           + " not in [-1, "
                           + Utility::str(int(maxprec_)) + "]");
-    // Fixed char array for accumulating string.  Allow space for zone, 3 block
-    // letters, easting + northing.  Don't need to allow for terminating null.
-    char mgrs1[2 + 3 + 2 * maxprec_];
+    }
+    // mgrs1 has space for zone, 3 block letters, easting + northing.  Don't
+    // need to allow for terminating null.
     int
       zone1 = zone - 1,
       z = utmp ? 2 : 0,
@@ -76,9 +200,11 @@ namespace GeographicLib {
         iband = abs(lat) > angeps() ? LatitudeBand(lat) : (northp ? 0 : -1),
         icol = xh - minutmcol_,
         irow = UTMRow(iband, icol, yh % utmrowperiod_);
-      if (irow != yh - (northp ? minutmNrow_ : maxutmSrow_))
+      if (irow != yh - (northp ? minutmNrow_ : maxutmSrow_)) {
+        if (!throwp) return -1;
         throw GeographicErr("Latitude " + Utility::str(lat)
                             + " is inconsistent with UTM coordinates");
+      }
       mgrs1[z++] = latband_[10 + iband];
       mgrs1[z++] = utmcols_[zone1 % 3][icol];
       mgrs1[z++] = utmrow_[(yh + (zone1 & 1 ? utmevenrowshift_ : 0))
@@ -116,13 +242,18 @@ namespace GeographicLib {
         }
       }
     }
-    mgrs.resize(mlen);
-    copy(mgrs1, mgrs1 + mlen, mgrs.begin());
+    return mlen;
   }
 
   void MGRS::Forward(int zone, bool northp, real x, real y,
                      int prec, std::string& mgrs) {
-    real lat, lon;
+    Forward(zone, northp, x, y, ApproxLatitude(zone, northp, x, y, true),
+            prec, mgrs);
+  }
+
+  Math::real MGRS::ApproxLatitude(int zone, bool northp, real x, real y,
+                                  bool throwp) {
+    real lat = 0, lon, gamma, k;
     if (zone > 0) {
       // Does a rough estimate for latitude determine the latitude band?
       real ys = northp ? y : y - utmNshift_;
@@ -146,21 +277,32 @@ namespace GeographicLib {
         if (LatitudeBand(latp) == LatitudeBand(late))
           lat = latp;
         else
-          // bounds straddle a band boundary so need to compute lat accurately
-          UTMUPS::Reverse(zone, northp, x, y, lat, lon);
+          // bounds straddle a band boundary so need to compute lat accurately.
+          // If TryReverse fails, Encode will reject x and y.
+          if (throwp)
+            UTMUPS::Reverse(zone, northp, x, y, lat, lon);
+          else
+            UTMUPS::TryReverse(zone, northp, x, y, lat, lon, gamma, k);
       }
-    } else
-      // Latitude isn't needed for UPS specs or for INVALID
-      lat = 0;
-    Forward(zone, northp, x, y, lat, prec, mgrs);
+    }
+    // Latitude isn't needed for UPS specs or for INVALID
+    return lat;
   }
 
   void MGRS::Reverse(const std::string& mgrs,
                      int& zone, bool& northp, real& x, real& y,
                      int& prec, bool centerp) {
+    Reverse(mgrs.data(), mgrs.size(), zone, northp, x, y, prec, centerp,
+            true);
+  }
+
+  bool MGRS::Reverse(const char* mgrs, size_t n,
+                     int& zone, bool& northp, real& x, real& y,
+                     int& prec, bool centerp, bool throwp) {
+    const Decoder& decoder = Decoder::Get();
     int
       p = 0,
-      len = int(mgrs.size());
+      len = int(n);
     if (len >= 3 &&
         toupper(mgrs[0]) == 'I' &&
         toupper(mgrs[1]) == 'N' &&
@@ -169,30 +311,40 @@ namespace GeographicLib {
       northp = false;
       x = y = Math::NaN();
       prec = -2;
-      return;
+      return true;
     }
     int zone1 = 0;
     while (p < len) {
-      int i = Utility::lookup(digits_, mgrs[p]);
+      int i = Decoder::Index(decoder.digits, mgrs[p]);
       if (i < 0)
         break;
       zone1 = 10 * zone1 + i;
       ++p;
     }
-    if (p > 0 && !(zone1 >= UTMUPS::MINUTMZONE && zone1 <= UTMUPS::MAXUTMZONE))
+    if (p > 0 &&
+        !(zone1 >= UTMUPS::MINUTMZONE && zone1 <= UTMUPS::MAXUTMZONE)) {
+      if (!throwp) return false;
       throw GeographicErr("Zone " + Utility::str(zone1) + " not in [1,60]");
-    if (p > 2)
+    }
+    if (p > 2) {
+      if (!throwp) return false;
       throw GeographicErr("More than 2 digits_ at start of MGRS "
-                          + mgrs.substr(0, p));
-    if (len - p < 1)
-      throw GeographicErr("MGRS string too short " + mgrs);
+                          + string(mgrs, p));
+    }
+    if (len - p < 1) {
+      if (!throwp) return false;
+      throw GeographicErr("MGRS string too short " + string(mgrs, n));
+    }
     bool utmp = zone1 != UTMUPS::UPS;
     int zonem1 = zone1 - 1;
-    const string& band = utmp ? latband_ : upsband_;
-    int iband = Utility::lookup(band, mgrs[p++]);
-    if (iband < 0)
+    const char* band = utmp ? latband_ : upsband_;
+    int iband = Decoder::Index(utmp ? decoder.latband : decoder.upsband,
+                               mgrs[p++]);
+    if (iband < 0) {
+      if (!throwp) return false;
       throw GeographicErr("Band letter " + Utility::str(mgrs[p-1]) + " not in "
                           + (utmp ? "UTM" : "UPS") + " set " + band);
+    }
     bool northp1 = iband >= (utmp ? 10 : 2);
     if (p == len) {             // Grid zone only (ignore centerp)
       // Approx length of a degree of meridian arc in units of tile.
@@ -213,32 +365,43 @@ namespace GeographicLib {
         y = upseasting_ * tile_;
       }
       prec = -1;
-      return;
-    } else if (len - p < 2)
-      throw GeographicErr("Missing row letter in " + mgrs);
-    const string& col = utmp ? utmcols_[zonem1 % 3] : upscols_[iband];
-    const string& row = utmp ? utmrow_ : upsrows_[northp1];
-    int icol = Utility::lookup(col, mgrs[p++]);
-    if (icol < 0)
+      return true;
+    } else if (len - p < 2) {
+      if (!throwp) return false;
+      throw GeographicErr("Missing row letter in "
+                          + string(mgrs, n));
+    }
+    const char* col = utmp ? utmcols_[zonem1 % 3] : upscols_[iband];
+    const char* row = utmp ? utmrow_ : upsrows_[northp1];
+    int icol = Decoder::Index(utmp ? decoder.utmcols[zonem1 % 3] :
+                              decoder.upscols[iband], mgrs[p++]);
+    if (icol < 0) {
+      if (!throwp) return false;
       throw GeographicErr("Column letter " + Utility::str(mgrs[p-1])
                           + " not in "
-                          + (utmp ? "zone " + mgrs.substr(0, p-2) :
+                          + (utmp ? "zone " + string(mgrs, p-2) :
                              "UPS band " + Utility::str(mgrs[p-2]))
                           + " set " + col );
-    int irow = Utility::lookup(row, mgrs[p++]);
-    if (irow < 0)
+    }
+    int irow = Decoder::Index(utmp ? decoder.utmrow :
+                              decoder.upsrows[northp1], mgrs[p++]);
+    if (irow < 0) {
+      if (!throwp) return false;
       throw GeographicErr("Row letter " + Utility::str(mgrs[p-1]) + " not in "
                           + (utmp ? "UTM" :
                              "UPS " + Utility::str(hemispheres_[northp1]))
                           + " set " + row);
+    }
     if (utmp) {
       if (zonem1 & 1)
         irow = (irow + utmrowperiod_ - utmevenrowshift_) % utmrowperiod_;
       iband -= 10;
       irow = UTMRow(iband, icol, irow);
-      if (irow == maxutmSrow_)
-        throw GeographicErr("Block " + mgrs.substr(p-2, 2)
-                            + " not in zone/band " + mgrs.substr(0, p-2));
+      if (irow == maxutmSrow_) {
+        if (!throwp) return false;
+        throw GeographicErr("Block " + string(mgrs + p-2, 2)
+                            + " not in zone/band " + string(mgrs, p-2));
+      }
 
       irow = northp1 ? irow : irow + 100;
       icol = icol + minutmcol_;
@@ -255,24 +418,31 @@ namespace GeographicLib {
     for (int i = 0; i < prec1; ++i) {
       unit /= base_;
       int
-        ix = Utility::lookup(digits_, mgrs[p + i]),
-        iy = Utility::lookup(digits_, mgrs[p + i + prec1]);
-      if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
+        ix = Decoder::Index(decoder.digits, mgrs[p + i]),
+        iy = Decoder::Index(decoder.digits, mgrs[p + i + prec1]);
+      if (ix < 0 || iy < 0) {
+        if (!throwp) return false;
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(mgrs + p, len - p));
+      }
       x1 += unit * ix;
       y1 += unit * iy;
     }
     if ((len - p) % 2) {
-      if (Utility::lookup(digits_, mgrs[len - 1]) < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
+      if (!throwp) return false;
+      if (Decoder::Index(decoder.digits, mgrs[len - 1]) < 0)
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(mgrs + p, len - p));
       else
         throw GeographicErr("Not an even number of digits_ in "
-                            + mgrs.substr(p));
+                            + string(mgrs + p, len - p));
     }
-    if (prec1 > maxprec_)
+    if (prec1 > maxprec_) {
+      if (!throwp) return false;
       throw GeographicErr("More than " + Utility::str(2*maxprec_)
                           + " digits_ in "
-                          + mgrs.substr(p));
+                          + string(mgrs + p, len - p));
+    }
     if (centerp) {
       x1 += unit/2;
       y1 += unit/2;
@@ -282,9 +452,36 @@ namespace GeographicLib {
     x = x1;
     y = y1;
     prec = prec1;
+    return true;
+  }
+
+  size_t MGRS::ReverseBatch(const char* buf, const size_t offsets[],
+                            size_t n,
+                            int zone[], bool northp[], real x[], real y[],
+                            int prec[], bool valid[], bool centerp) {
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const char* mgrs = buf + offsets[i];
+      size_t len = offsets[i + 1] - offsets[i];
+      // Ignore a trailing newline (LF or CR LF).
+      if (len > 0 && mgrs[len - 1] == '\n') --len;
+      if (len > 0 && mgrs[len - 1] == '\r') --len;
+      bool ok = Reverse(mgrs, len, zone[i], northp[i], x[i], y[i], prec[i],
+                        centerp, false);
+      if (!ok) {
+        zone[i] = UTMUPS::INVALID;
+        northp[i] = false;
+        x[i] = y[i] = Math::NaN();
+        prec[i] = -2;
+        ++nbad;
+      }
+      if (valid) valid[i] = ok;
+    }
+    return nbad;
   }
 
-  void MGRS::CheckCoords(bool utmp, bool& northp, real& x, real& y) {
+  bool MGRS::CheckCoords(bool utmp, bool& northp, real& x, real& y,
+                         bool throwp) {
     // Limits are all multiples of 100km and are all closed on the lower end
     // and open on the upper end -- and this is reflected in the error
     // messages.  However if a coordinate lies on the excluded upper end (e.g.,
@@ -297,7 +494,8 @@ namespace GeographicLib {
     if (! (ix >= mineasting_[ind] && ix < maxeasting_[ind]) ) {
       if (ix == maxeasting_[ind] && x == maxeasting_[ind] * tile_)
         x -= eps();
-      else
+      else {
+        if (!throwp) return false;
         throw GeographicErr("Easting " + Utility::str(int(floor(x/1000)))
                             + "km not in MGRS/"
                             + (utmp ? "UTM" : "UPS") + " range for "
@@ -306,11 +504,13 @@ namespace GeographicLib {
                             + "km, "
                             + Utility::str(maxeasting_[ind]*tile_/1000)
                             + "km)");
+      }
     }
     if (! (iy >= minnorthing_[ind] && iy < maxnorthing_[ind]) ) {
       if (iy == maxnorthing_[ind] && y == maxnorthing_[ind] * tile_)
         y -= eps();
-      else
+      else {
+        if (!throwp) return false;
         throw GeographicErr("Northing " + Utility::str(int(floor(y/1000)))
                             + "km not in MGRS/"
                             + (utmp ? "UTM" : "UPS") + " range for "
@@ -319,6 +519,7 @@ namespace GeographicLib {
                             + "km, "
                             + Utility::str(maxnorthing_[ind]*tile_/1000)
                             + "km)");
+      }
     }
 
     // Correct the UTM northing and hemisphere if necessary
@@ -336,6 +537,7 @@ namespace GeographicLib {
         }
       }
     }
+    return true;
   }
 
   int MGRS::UTMRow(int iband, int icol, int irow) {
@@ -0,0 +1,372 @@
+/**
+ * \file MGRSGrid.cpp
+ * \brief Implementation for GeographicLib::MGRSGrid class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/MGRSGrid.hpp>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    typedef Math::real real;
+    typedef pair<real, real> Interval;
+
+    // A rectangle in geographic coordinates
+    struct Rect {
+      real lat0, lat1, lon0, lon1;
+    };
+
+    // The latitudes of the boundaries of the regions in which the UTM zones
+    // are the same; the zones are split at the equator because the two
+    // hemispheres have different northings.
+    const real regionlat_[] = {-80, 0, 56, 64, 72, 84};
+    const int nregion_ = 5;
+
+    // The range of longitudes, [lon0, lon1), of a zone in a region; return
+    // false if the zone doesn't exist in this region.  This follows
+    // UTMUPS::StandardZone.
+    bool ZoneRange(int region, int zone, real& lon0, real& lon1) {
+      if (region == 2 && (zone == 31 || zone == 32)) { // Band V, Norway
+        lon0 = zone == 31 ? 0 : 3; lon1 = zone == 31 ? 3 : 12;
+        return true;
+      } else if (region == 4 && zone >= 31 && zone <= 37) { // Band X, Svalbard
+        if (zone % 2 == 0) return false;
+        lon0 = zone == 31 ? 0 : 12 * ((zone - 31) / 2) - 3;
+        lon1 = zone == 37 ? 42 : 12 * ((zone - 29) / 2) - 3;
+        return true;
+      }
+      lon0 = 6 * zone - 186; lon1 = lon0 + 6;
+      return true;
+    }
+
+    // Clip the segment from a to b to the rectangle r by the method of Liang
+    // and Barsky.  This returns in [t0, t1] the range of the parameter along
+    // the segment within r; the return value is false if this range is empty
+    // or a single point.
+    bool Clip(const Rect& r, real lata, real lona, real latb, real lonb,
+              real& t0, real& t1) {
+      real
+        dlat = latb - lata, dlon = lonb - lona,
+        p[4] = {-dlon, dlon, -dlat, dlat},
+        q[4] = {lona - r.lon0, r.lon1 - lona, lata - r.lat0, r.lat1 - lata};
+      t0 = 0; t1 = 1;
+      for (int k = 0; k < 4; ++k) {
+        if (p[k] == 0) {
+          if (q[k] < 0) return false;
+        } else {
+          real t = q[k] / p[k];
+          if (p[k] < 0)
+            t0 = max(t0, t);
+          else
+            t1 = min(t1, t);
+          if (!(t0 < t1)) return false;
+        }
+      }
+      return true;
+    }
+
+    // Is a point in one of the rectangles (including their boundaries)?
+    bool Inside(const vector<Rect>& rs, real lat, real lon) {
+      for (size_t k = 0; k < rs.size(); ++k)
+        if (lat >= rs[k].lat0 && lat <= rs[k].lat1 &&
+            lon >= rs[k].lon0 && lon <= rs[k].lon1)
+          return true;
+      return false;
+    }
+
+    // The sorted ranges of the parameter along the segment from a to b which
+    // lie in the rectangles, with touching ranges merged.
+    void Intervals(const vector<Rect>& rs, real lata, real lona,
+                   real latb, real lonb, vector<Interval>& iv) {
+      iv.clear();
+      real t0, t1;
+      for (size_t k = 0; k < rs.size(); ++k)
+        if (Clip(rs[k], lata, lona, latb, lonb, t0, t1))
+          iv.push_back(Interval(t0, t1));
+      if (iv.size() < 2) return;
+      sort(iv.begin(), iv.end());
+      size_t m = 0;
+      for (size_t k = 1; k < iv.size(); ++k) {
+        if (iv[k].first <= iv[m].second)
+          iv[m].second = max(iv[m].second, iv[k].second);
+        else
+          iv[++m] = iv[k];
+      }
+      iv.resize(m + 1);
+    }
+
+    // Add the point at parameter t along the segment from a to b to a line.
+    void AddPoint(MGRSGrid::Line& line, real t,
+                  real lata, real lona, real latb, real lonb) {
+      line.lat.push_back(t == 0 ? lata : (t == 1 ? latb :
+                                          lata + t * (latb - lata)));
+      line.lon.push_back(t == 0 ? lona : (t == 1 ? lonb :
+                                          lona + t * (lonb - lona)));
+    }
+
+    // Add the parts of the polyline with n vertices (lat[k], lon[k]) which
+    // lie in the rectangles to lines, as copies of proto.
+    void ClipLine(const vector<Rect>& rs, const real lat[], const real lon[],
+                  size_t n, const MGRSGrid::Line& proto,
+                  vector<MGRSGrid::Line>& lines) {
+      vector<Interval> iv;
+      bool open = false;        // Does the last line end at vertex k?
+      for (size_t k = 0; k + 1 < n; ++k) {
+        Intervals(rs, lat[k], lon[k], lat[k + 1], lon[k + 1], iv);
+        bool next = false;
+        for (size_t l = 0; l < iv.size(); ++l) {
+          if (!(open && l == 0 && iv[l].first == 0)) {
+            lines.push_back(proto);
+            AddPoint(lines.back(), iv[l].first,
+                     lat[k], lon[k], lat[k + 1], lon[k + 1]);
+          }
+          AddPoint(lines.back(), iv[l].second,
+                   lat[k], lon[k], lat[k + 1], lon[k + 1]);
+          next = iv[l].second == 1;
+        }
+        open = next;
+      }
+    }
+
+    // Is a point inside the polygon with n vertices (lat[k], lon[k])?
+    bool InPolygon(const real lat[], const real lon[], size_t n,
+                   real plat, real plon) {
+      bool in = false;
+      for (size_t k = 0, l = n - 1; k < n; l = k++) {
+        if ((lat[k] > plat) != (lat[l] > plat) &&
+            plon < lon[l] + (lon[k] - lon[l]) *
+            (plat - lat[l]) / (lat[k] - lat[l]))
+          in = !in;
+      }
+      return in;
+    }
+  }
+
+  MGRSGrid::MGRSGrid(int prec, int nseg)
+    : _prec(prec)
+    , _nseg(nseg)
+  {
+    if (!(_prec >= 0 && _prec <= 5))
+      throw GeographicErr("Precision " + Utility::str(_prec)
+                          + " not in [0, 5]");
+    if (!(_nseg >= 1 && _nseg <= 1000))
+      throw GeographicErr("Number of segments " + Utility::str(_nseg)
+                          + " not in [1, 1000]");
+    _spacing = 100000;
+    for (int i = 0; i < _prec; ++i)
+      _spacing /= 10;
+  }
+
+  void MGRSGrid::Generate(real lat0, real lon0, real lat1, real lon1,
+                          std::vector<Square>& squares,
+                          std::vector<Line>& lines, int nthreads) const {
+    if (!(abs(lat0) <= 90 && abs(lat1) <= 90))
+      throw GeographicErr("Latitude not in [-90d, 90d]");
+    if (!(lat0 <= lat1))
+      throw GeographicErr("Southern edge north of northern edge");
+    if (!(lon1 - lon0 >= 0 && lon1 - lon0 <= 360))
+      throw GeographicErr("Longitude range not in [0d, 360d]");
+    squares.clear();
+    lines.clear();
+    // Shift the longitudes so that lon0 is in [-180d, 180d); the zones are
+    // then in [-180d, 540d).
+    real dlon = -360 * floor((lon0 + 180) / 360);
+    lon0 += dlon; lon1 += dlon;
+
+    // The rectangles making up the region in each zone, hemisphere, and
+    // shift of the zone by 360d.  The key orders these by zone, then
+    // hemisphere, then shift.
+    map<int, vector<Rect> > pieces;
+    for (int region = 0; region < nregion_; ++region) {
+      real
+        rlat0 = max(lat0, regionlat_[region]),
+        rlat1 = min(lat1, regionlat_[region + 1]);
+      if (!(rlat0 < rlat1)) continue;
+      bool northp = region > 0;
+      for (int zone = UTMUPS::MINUTMZONE; zone <= UTMUPS::MAXUTMZONE;
+           ++zone) {
+        real zlon0, zlon1;
+        if (!ZoneRange(region, zone, zlon0, zlon1)) continue;
+        for (int shift = 0; shift < 2; ++shift) {
+          Rect r;
+          r.lat0 = rlat0; r.lat1 = rlat1;
+          r.lon0 = max(lon0, zlon0 + 360 * shift);
+          r.lon1 = min(lon1, zlon1 + 360 * shift);
+          if (!(r.lon0 < r.lon1)) continue;
+          vector<Rect>& rs = pieces[(2 * zone + int(northp)) * 2 + shift];
+          // Merge with the rectangle to the south if possible
+          if (!rs.empty() && rs.back().lat1 == r.lat0 &&
+              rs.back().lon0 == r.lon0 && rs.back().lon1 == r.lon1)
+            rs.back().lat1 = r.lat1;
+          else
+            rs.push_back(r);
+        }
+      }
+    }
+
+    const TransverseMercator& tm = TransverseMercator::UTM();
+    const real
+      s = _spacing, ds = s / _nseg,
+      feast = 500000;           // The false easting of UTM
+    const int nseg = _nseg;
+    for (map<int, vector<Rect> >::const_iterator it = pieces.begin();
+         it != pieces.end(); ++it) {
+      const vector<Rect>& rs = it->second;
+      int
+        zone = it->first / 4,
+        shift = it->first % 2;
+      bool northp = (it->first / 2) % 2 != 0;
+      real
+        lonc = 6 * zone - 183 + 360 * shift, // The central meridian
+        fnorth = northp ? 0 : UTMUPS::UTMShift(),
+        latmin = rs[0].lat0, latmax = rs[0].lat1;
+      // The range of eastings and northings of the rectangles.  The
+      // extremes lie at the corners or where the northern and southern edges
+      // cross the central meridian.
+      vector<real> blat, blon;
+      for (size_t k = 0; k < rs.size(); ++k) {
+        const Rect& r = rs[k];
+        latmin = min(latmin, r.lat0); latmax = max(latmax, r.lat1);
+        real lonm = min(max(lonc, r.lon0), r.lon1);
+        real
+          clat[] = {r.lat0, r.lat0, r.lat0, r.lat1, r.lat1, r.lat1},
+          clon[] = {r.lon0, lonm, r.lon1, r.lon0, lonm, r.lon1};
+        blat.insert(blat.end(), clat, clat + 6);
+        blon.insert(blon.end(), clon, clon + 6);
+      }
+      vector<real> bx(blat.size()), by(blat.size());
+      tm.Forward(lonc, &blat[0], &blon[0], blat.size(), &bx[0], &by[0]);
+      real
+        xmin = *min_element(bx.begin(), bx.end()) + feast,
+        xmax = *max_element(bx.begin(), bx.end()) + feast,
+        ymin = *min_element(by.begin(), by.end()) + fnorth,
+        ymax = *max_element(by.begin(), by.end()) + fnorth;
+      int
+        ix0 = int(floor(xmin / s)), ix1 = max(ix0 + 1, int(ceil(xmax / s))),
+        iy0 = int(floor(ymin / s)), iy1 = max(iy0 + 1, int(ceil(ymax / s))),
+        nx = ix1 - ix0 + 1, ny = iy1 - iy0 + 1;
+      size_t
+        // The number of points on a line of constant easting and northing
+        mv = size_t(ny - 1) * nseg + 1, mh = size_t(nx - 1) * nseg + 1,
+        // Points on the lines of constant easting followed by those on the
+        // lines of constant northing which aren't corners
+        nv = size_t(nx) * mv,
+        n = nv + size_t(ny) * (nx - 1) * (nseg - 1);
+      vector<real> x(n), y(n);
+      for (int i = 0; i < nx; ++i)
+        for (size_t t = 0; t < mv; ++t) {
+          x[i * mv + t] = (ix0 + i) * s - feast;
+          y[i * mv + t] = iy0 * s + t * ds - fnorth;
+        }
+      for (int j = 0, l = 0; j < ny; ++j)
+        for (size_t t = 0; t < mh; ++t)
+          if (t % nseg != 0) {
+            x[nv + l] = ix0 * s + t * ds - feast;
+            y[nv + l] = (iy0 + j) * s - fnorth;
+            ++l;
+          }
+      vector<real> plat(n), plon(n);
+      if (n > 0)
+        tm.Reverse(real(0), &x[0], &y[0], n, &plat[0], &plon[0], 0, 0,
+                   nthreads);
+      for (size_t k = 0; k < n; ++k)
+        plon[k] += lonc - dlon;
+      // The same shift for the rectangles
+      vector<Rect> rsh(rs);
+      for (size_t k = 0; k < rsh.size(); ++k) {
+        rsh[k].lon0 -= dlon; rsh[k].lon1 -= dlon;
+      }
+      // Lines of constant easting are vlat[i * mv + t]; lines of constant
+      // northing are hlat[j * mh + t].
+      const real* vlat = &plat[0];
+      const real* vlon = &plon[0];
+      vector<real> hlat(size_t(ny) * mh), hlon(hlat.size());
+      for (int j = 0, l = 0; j < ny; ++j)
+        for (size_t t = 0; t < mh; ++t) {
+          size_t k = t % nseg == 0 ? (t / nseg) * mv + size_t(j) * nseg :
+            nv + l++;
+          hlat[j * mh + t] = plat[k]; hlon[j * mh + t] = plon[k];
+        }
+
+      // The squares
+      vector<real> qlat(4 * nseg), qlon(4 * nseg);
+      Square sq;
+      sq.zone = zone; sq.northp = northp;
+      for (int j = 0; j + 1 < ny; ++j)
+        for (int i = 0; i + 1 < nx; ++i) {
+          // The boundary of the square, counterclockwise from the southwest
+          // corner
+          size_t
+            v0 = size_t(i) * mv + size_t(j) * nseg, v1 = v0 + mv,
+            h0 = size_t(j) * mh + size_t(i) * nseg, h1 = h0 + mh;
+          for (int t = 0; t < nseg; ++t) {
+            qlat[t] = hlat[h0 + t]; qlon[t] = hlon[h0 + t];
+            qlat[nseg + t] = vlat[v1 + t]; qlon[nseg + t] = vlon[v1 + t];
+            qlat[2*nseg + t] = hlat[h1 + nseg - t];
+            qlon[2*nseg + t] = hlon[h1 + nseg - t];
+            qlat[3*nseg + t] = vlat[v0 + nseg - t];
+            qlon[3*nseg + t] = vlon[v0 + nseg - t];
+          }
+          bool overlap = false, partial = false;
+          for (int t = 0; t < 4 * nseg; ++t) {
+            int t1 = (t + 1) % (4 * nseg);
+            real c0, c1;
+            for (size_t k = 0; k < rsh.size() && !overlap; ++k)
+              overlap = Clip(rsh[k], qlat[t], qlon[t], qlat[t1], qlon[t1],
+                             c0, c1);
+            partial = partial || !Inside(rsh, qlat[t], qlon[t]);
+          }
+          // Is the region inside the square?
+          for (size_t k = 0; k < rsh.size() && !overlap; ++k)
+            overlap = InPolygon(&qlat[0], &qlon[0], qlat.size(),
+                                (rsh[k].lat0 + rsh[k].lat1) / 2,
+                                (rsh[k].lon0 + rsh[k].lon1) / 2);
+          if (!overlap) continue;
+          sq.x = (ix0 + i) * s; sq.y = (iy0 + j) * s;
+          size_t corner[] = {v0, v1, v1 + nseg, v0 + nseg};
+          real latc = 0;
+          for (int c = 0; c < 4; ++c) {
+            sq.lat[c] = vlat[corner[c]]; sq.lon[c] = vlon[corner[c]];
+            latc += sq.lat[c] / 4;
+          }
+          sq.partial = partial;
+          try {
+            MGRS::Forward(zone, northp, sq.x + s/2, sq.y + s/2,
+                          min(max(latc, latmin), latmax), _prec, sq.mgrs);
+          }
+          catch (const GeographicErr&) {
+            sq.mgrs.clear();
+          }
+          squares.push_back(sq);
+        }
+
+      // The lines
+      Line proto;
+      proto.zone = zone; proto.northp = northp;
+      proto.eastingp = true;
+      for (int i = 0; i < nx; ++i) {
+        proto.value = (ix0 + i) * s;
+        ClipLine(rsh, vlat + i * mv, vlon + i * mv, mv, proto, lines);
+      }
+      proto.eastingp = false;
+      for (int j = 0; j < ny; ++j) {
+        proto.value = (iy0 + j) * s;
+        ClipLine(rsh, &hlat[j * mh], &hlon[j * mh], mh, proto, lines);
+      }
+    }
+  }
+
+} // namespace GeographicLib
@@ -49,4 +49,55 @@ namespace GeographicLib {
     Bz *= - _a;
   }
 
+  void MagneticCircle::FieldRow(real lon0, real dlon, int nlon,
+                                real Bx[], real By[], real Bz[],
+                                real Bxt[], real Byt[], real Bzt[]) const {
+    if (nlon <= 0)
+      return;
+    bool diffp = Bxt && Byt && Bzt;
+    // The components in geocentric basis for the circles (after the value of
+    // the potential, which is not needed).
+    CircularEngine::Workspace work(1, 4 * nlon * (_constterm ? 3 : 2));
+    real *B0 = work.data(), *B1 = B0 + 4 * nlon, *Bc = B1 + 4 * nlon;
+    _circ0.EvaluateRow(lon0, dlon, nlon,
+                       B0, B0 + nlon, B0 + 2 * nlon, B0 + 3 * nlon);
+    _circ1.EvaluateRow(lon0, dlon, nlon,
+                       B1, B1 + nlon, B1 + 2 * nlon, B1 + 3 * nlon);
+    if (_constterm)
+      _circ2.EvaluateRow(lon0, dlon, nlon,
+                         Bc, Bc + nlon, Bc + 2 * nlon, Bc + 3 * nlon);
+    for (int j = 0; j < nlon; ++j) {
+      // Follow Field
+      real clam, slam;
+      CircularEngine::cossin(lon0 + j * dlon, clam, slam);
+      real M[Geocentric::dim2_];
+      Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+      real
+        BX0 = B0[nlon + j], BY0 = B0[2 * nlon + j], BZ0 = B0[3 * nlon + j],
+        BX1 = B1[nlon + j], BY1 = B1[2 * nlon + j], BZ1 = B1[3 * nlon + j],
+        BXc = 0, BYc = 0, BZc = 0;
+      if (_constterm) {
+        BXc = Bc[nlon + j]; BYc = Bc[2 * nlon + j]; BZc = Bc[3 * nlon + j];
+      }
+      if (_interpolate) {
+        BX1 = (BX1 - BX0) / _dt0;
+        BY1 = (BY1 - BY0) / _dt0;
+        BZ1 = (BZ1 - BZ0) / _dt0;
+      }
+      BX0 += _t1 * BX1 + BXc;
+      BY0 += _t1 * BY1 + BYc;
+      BZ0 += _t1 * BZ1 + BZc;
+      if (diffp) {
+        Geocentric::Unrotate(M, BX1, BY1, BZ1, Bxt[j], Byt[j], Bzt[j]);
+        Bxt[j] *= - _a;
+        Byt[j] *= - _a;
+        Bzt[j] *= - _a;
+      }
+      Geocentric::Unrotate(M, BX0, BY0, BZ0, Bx[j], By[j], Bz[j]);
+      Bx[j] *= - _a;
+      By[j] *= - _a;
+      Bz[j] *= - _a;
+    }
+  }
+
 } // namespace GeographicLib
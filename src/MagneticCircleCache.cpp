@@ -0,0 +1,190 @@
+/**
+ * \file MagneticCircleCache.cpp
+ * \brief Implementation for GeographicLib::MagneticCircleCache class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/MagneticCircleCache.hpp>
+#include <GeographicLib/Utility.hpp>
+#include "CacheSupport.hpp"
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  class MagneticCircleCache::Impl {
+  public:
+    struct Key {
+      real lat, h;
+      int n;                    // the epoch interval
+      bool operator<(const Key& k) const {
+        return n < k.n || (n == k.n &&
+                           (lat < k.lat || (lat == k.lat && h < k.h)));
+      }
+    };
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+    // The circles are shared with the callers evaluating them so that the
+    // evaluation can take place without holding the lock.
+    typedef shared_ptr<const MagneticCircle> circle_t;
+    typedef circle_t ref_t;
+    static ref_t Ref(const circle_t& c) { return c; }
+#else
+    typedef MagneticCircle circle_t;
+    typedef const MagneticCircle* ref_t;
+    static ref_t Ref(const circle_t& c) { return &c; }
+    // The most recent uncached circle
+    MagneticCircle _scratch;
+#endif
+    typedef LRUCache<Key, circle_t> cache_t;
+    const MagneticModel& _m;
+    // The epoch, spacing of the epochs, and number of models
+    real _t0, _dt0;
+    int _Nmodels;
+    real _dlat, _dh;
+    cache_t _cache;
+    Impl(const MagneticModel& m, real t0, real dt0, int Nmodels,
+         size_t capacity, real dlat, real dh)
+      : _m(m)
+      , _t0(t0)
+      , _dt0(dt0)
+      , _Nmodels(Nmodels)
+      , _dlat(dlat)
+      , _dh(dh)
+      , _cache(capacity)
+    {
+      if (!(Math::isfinite(_dlat) && _dlat >= 0))
+        throw GeographicErr("Latitude spacing " + Utility::str(_dlat)
+                            + " is not a nonnegative number");
+      if (!(Math::isfinite(_dh) && _dh >= 0))
+        throw GeographicErr("Height spacing " + Utility::str(_dh)
+                            + " is not a nonnegative number");
+    }
+    // The epoch interval used by MagneticModel for time t
+    int Interval(real t) const {
+      return Math::isnan(t) ? 0 :
+        max(min(int(floor((t - _t0) / _dt0)), _Nmodels - 1), 0);
+    }
+    // The reference time for epoch interval n; this is the middle of the
+    // interval so that it is unambiguously in the interval.
+    real Time(int n) const
+    { return _Nmodels > 1 ? _t0 + (n + real(0.5)) * _dt0 : _t0; }
+    // The circle for (lat, h) and epoch interval n.  (If the cache is not
+    // thread safe, the result is only valid until the next call.)
+    ref_t Get(real lat, real h, int n) {
+      Key key = { lat, h, n };
+      // NaNs can't be used as keys in a map.
+      bool cacheable = !(Math::isnan(lat) || Math::isnan(h));
+      {
+        CacheGuard<cache_t> lock(_cache);
+        if (cacheable) {
+          const circle_t* c = _cache.Find(key);
+          if (c) return Ref(*c);
+        } else
+          ++_cache._misses;
+      }
+      // Construct the circle without holding the lock.
+#if GEOGRAPHICLIB_CACHE_THREADSAFE
+      const circle_t circle(new MagneticCircle(_m.Circle(Time(n), lat, h)));
+#else
+      _scratch = _m.Circle(Time(n), lat, h);
+      const circle_t& circle = _scratch;
+#endif
+      if (cacheable) {
+        CacheGuard<cache_t> lock(_cache);
+        _cache.Insert(key, circle);
+      }
+      return Ref(circle);
+    }
+  };
+
+  MagneticCircleCache::MagneticCircleCache(const MagneticModel& m,
+                                           size_t capacity,
+                                           real dlat, real dh)
+    : _impl(new Impl(m, m._t0, m._dt0, m._Nmodels, capacity, dlat, dh))
+  {}
+
+  MagneticCircleCache::~MagneticCircleCache() { delete _impl; }
+
+  MagneticCircle MagneticCircleCache::Circle(real t, real lat, real h) {
+    if (_impl->_dlat > 0 && Math::isfinite(lat))
+      lat = max(-real(90),
+                min(real(90),
+                    floor(lat / _impl->_dlat + real(0.5)) * _impl->_dlat));
+    if (_impl->_dh > 0 && Math::isfinite(h))
+      h = floor(h / _impl->_dh + real(0.5)) * _impl->_dh;
+    return *_impl->Get(lat, h, _impl->Interval(t));
+  }
+
+  void MagneticCircleCache::Field(real t, real lat, real lon, real h,
+                                  bool diffp,
+                                  real& Bx, real& By, real& Bz,
+                                  real& Bxt, real& Byt, real& Bzt) {
+    real lats[2], wlat[2], hs[2], wh[2];
+    int
+      nlat = CacheNodes(lat, _impl->_dlat, true, lats, wlat),
+      nh = CacheNodes(h, _impl->_dh, false, hs, wh),
+      n = _impl->Interval(t);
+    t -= _impl->Time(n);
+    Bx = By = Bz = 0;
+    if (diffp) Bxt = Byt = Bzt = 0;
+    for (int i = 0; i < nlat; ++i)
+      for (int j = 0; j < nh; ++j) {
+        real w = wlat[i] * wh[j], x, y, z, xt, yt, zt;
+        (*_impl->Get(lats[i], hs[j], n))(lon, x, y, z, xt, yt, zt);
+        Bx += w * (x + t * xt);
+        By += w * (y + t * yt);
+        Bz += w * (z + t * zt);
+        if (diffp) {
+          Bxt += w * xt; Byt += w * yt; Bzt += w * zt;
+        }
+      }
+  }
+
+  void MagneticCircleCache::Clear() {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache.Clear();
+  }
+
+  void MagneticCircleCache::SetCapacity(size_t capacity) {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache.SetCapacity(capacity);
+  }
+
+  void MagneticCircleCache::ResetCounters() {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    _impl->_cache._hits = _impl->_cache._misses = 0;
+  }
+
+  size_t MagneticCircleCache::Capacity() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._capacity;
+  }
+
+  size_t MagneticCircleCache::Size() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._values.size();
+  }
+
+  unsigned long MagneticCircleCache::Hits() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._hits;
+  }
+
+  unsigned long MagneticCircleCache::Misses() const {
+    CacheGuard<Impl::cache_t> lock(_impl->_cache);
+    return _impl->_cache._misses;
+  }
+
+  Math::real MagneticCircleCache::LatitudeSpacing() const
+  { return _impl->_dlat; }
+
+  Math::real MagneticCircleCache::HeightSpacing() const
+  { return _impl->_dh; }
+
+  bool MagneticCircleCache::ThreadSafe()
+  { return GEOGRAPHICLIB_CACHE_THREADSAFE != 0; }
+
+} // namespace GeographicLib
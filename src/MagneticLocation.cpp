@@ -0,0 +1,27 @@
+/**
+ * \file MagneticLocation.cpp
+ * \brief Implementation for GeographicLib::MagneticLocation class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/MagneticLocation.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void MagneticLocation::FieldBatch(const real t[], size_t n, bool diffp,
+                                    real Bx[], real By[], real Bz[],
+                                    real Bxt[], real Byt[], real Bzt[])
+    const {
+    real dummy;
+    for (size_t i = 0; i < n; ++i)
+      Field(t[i], diffp, Bx[i], By[i], Bz[i],
+            diffp ? Bxt[i] : dummy, diffp ? Byt[i] : dummy,
+            diffp ? Bzt[i] : dummy);
+  }
+
+} // namespace GeographicLib
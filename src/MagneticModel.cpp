@@ -11,6 +11,8 @@
 #include <fstream>
 #include <GeographicLib/SphericalEngine.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
+#include <GeographicLib/MagneticLocation.hpp>
+#include <GeographicLib/MagneticSnapshot.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if !defined(GEOGRAPHICLIB_DATA)
@@ -25,6 +27,21 @@
 #  define GEOGRAPHICLIB_MAGNETIC_DEFAULT_NAME "wmm2015"
 #endif
 
+#if !defined(GEOGRAPHICLIB_MAGNETICMODEL_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_MAGNETICMODEL_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_MAGNETICMODEL_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_MAGNETICMODEL_THREADS
+#  include <GeographicLib/Executor.hpp>
+#  include <memory>
+#  include <mutex>
+#  include <atomic>
+#endif
+
 #if defined(_MSC_VER)
 // Squelch warnings about unsafe use of getenv
 #  pragma warning (disable: 4996)
@@ -34,8 +51,31 @@ namespace GeographicLib {
 
   using namespace std;
 
+  // The offsets of the sets of coefficients in the coefficient file and
+  // whether each set has been loaded.
+  class MagneticModel::Loader {
+  public:
+    string _coeff;
+    ifstream _stream;
+    vector<unsigned long long> _offset;
+#if GEOGRAPHICLIB_MAGNETICMODEL_THREADS
+    mutex _mutex;
+    unique_ptr<atomic<bool>[]> _loaded;
+    explicit Loader(int n)
+      : _loaded(new atomic<bool>[n])
+    { for (int k = 0; k < n; ++k) _loaded[k] = false; }
+    bool Loaded(int k) const { return _loaded[k].load(memory_order_acquire); }
+    void SetLoaded(int k) { _loaded[k].store(true, memory_order_release); }
+#else
+    vector<bool> _loaded;
+    explicit Loader(int n) : _loaded(n, false) {}
+    bool Loaded(int k) const { return _loaded[k]; }
+    void SetLoaded(int k) { _loaded[k] = true; }
+#endif
+  };
+
   MagneticModel::MagneticModel(const std::string& name,const std::string& path,
-                               const Geocentric& earth)
+                               const Geocentric& earth, bool map, bool lazy)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -51,15 +91,61 @@ namespace GeographicLib {
     , _Nconstants(0)
     , _norm(SphericalHarmonic::SCHMIDT)
     , _earth(earth)
+    , _map(0)
+    , _maplen(0)
+    , _maphandle(0)
+    , _loader(0)
   {
     if (_dir.empty())
       _dir = DefaultMagneticPath();
     ReadMetadata(_name);
-    _G.resize(_Nmodels + 1 + _Nconstants);
-    _H.resize(_Nmodels + 1 + _Nconstants);
     {
       string coeff = _filename + ".cof";
-      ifstream coeffstr(coeff.c_str(), ios::binary);
+      bool mapped = map && MapCoefficients(coeff);
+      if (!mapped && lazy)
+        ScanCoefficients(coeff);
+      else if (!mapped) {
+        _G.resize(_Nmodels + 1 + _Nconstants);
+        _H.resize(_Nmodels + 1 + _Nconstants);
+        ifstream coeffstr(coeff.c_str(), ios::binary);
+        if (!coeffstr.good())
+          throw GeographicErr("Error opening " + coeff);
+        char id[idlength_ + 1];
+        coeffstr.read(id, idlength_);
+        if (!coeffstr.good())
+          throw GeographicErr("No header in " + coeff);
+        id[idlength_] = '\0';
+        if (_id != string(id))
+          throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+        for (int i = 0; i < _Nmodels + 1 + _Nconstants; ++i) {
+          int N, M;
+          SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _G[i], _H[i]);
+          if (!(M < 0 || _G[i][0] == 0))
+            throw GeographicErr("A degree 0 term is not permitted");
+          _harm.push_back(SphericalHarmonic(_G[i], _H[i], N, N, M, _a, _norm));
+        }
+        int pos = int(coeffstr.tellg());
+        coeffstr.seekg(0, ios::end);
+        if (pos != coeffstr.tellg())
+          throw GeographicErr("Extra data in " + coeff);
+      }
+    }
+  }
+
+  MagneticModel::~MagneticModel() {
+    Utility::unmapfile(_map, _maplen, _maphandle);
+    delete _loader;
+  }
+
+  void MagneticModel::ScanCoefficients(const std::string& coeff) {
+    // Record the offset of each set of coefficients, checking the degree and
+    // order in its header and skipping the coefficients themselves.  The
+    // file is kept open for LoadCoefficients.
+    int n = _Nmodels + 1 + _Nconstants;
+    Loader* loader = new Loader(n);
+    try {
+      ifstream& coeffstr = loader->_stream;
+      coeffstr.open(coeff.c_str(), ios::binary);
       if (!coeffstr.good())
         throw GeographicErr("Error opening " + coeff);
       char id[idlength_ + 1];
@@ -69,18 +155,144 @@ namespace GeographicLib {
       id[idlength_] = '\0';
       if (_id != string(id))
         throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+      coeffstr.seekg(0, ios::end);
+      unsigned long long
+        len = (unsigned long long)(coeffstr.tellg()),
+        pos = idlength_;
+      coeffstr.seekg(pos);
+      const unsigned long long maxskip = 1ULL << 16;
+      loader->_coeff = coeff;
+      loader->_offset.resize(n);
+      for (int i = 0; i < n; ++i) {
+        int nm[2];
+        loader->_offset[i] = pos;
+        Utility::readarray<int, int, false>(coeffstr, nm, 2);
+        int N = nm[0], M = nm[1];
+        if (!(N >= M && M >= -1 && N * M >= 0))
+          throw GeographicErr("Bad degree and order " +
+                              Utility::str(N) + " " + Utility::str(M));
+        // The coefficients are stored as doubles
+        unsigned long long skip = 8ULL *
+          (SphericalEngine::coeff::Csize(N, M) +
+           SphericalEngine::coeff::Ssize(N, M));
+        pos += sizeof(nm) + skip;
+        if (pos > len)
+          throw GeographicErr("Coefficient data too short in " + coeff);
+        // Skipping short sets (e.g., for IGRF) by reading through them is
+        // quicker than seeking, which discards the stream's buffer.
+        if (skip <= maxskip)
+          coeffstr.ignore(streamsize(skip));
+        else
+          coeffstr.seekg(pos);
+      }
+      if (pos != len)
+        throw GeographicErr("Extra data in " + coeff);
+    }
+    catch (...) {
+      delete loader;
+      throw;
+    }
+    _G.resize(n);
+    _H.resize(n);
+    _harm.resize(n);
+    _loader = loader;
+  }
+
+  void MagneticModel::LoadCoefficients(int k) const {
+#if GEOGRAPHICLIB_MAGNETICMODEL_THREADS
+    lock_guard<mutex> lock(_loader->_mutex);
+#endif
+    if (_loader->Loaded(k))
+      return;
+    ifstream& coeffstr = _loader->_stream;
+    coeffstr.clear();
+    coeffstr.seekg(_loader->_offset[k]);
+    int N, M;
+    SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _G[k], _H[k]);
+    if (!(M < 0 || _G[k][0] == 0))
+      throw GeographicErr("A degree 0 term is not permitted");
+    _harm[k] = SphericalHarmonic(_G[k], _H[k], N, N, M, _a, _norm);
+    _loader->SetLoaded(k);
+  }
+
+  const SphericalHarmonic& MagneticModel::Harmonic(int k) const {
+    if (_loader && !_loader->Loaded(k))
+      LoadCoefficients(k);
+    return _harm[k];
+  }
+
+  void MagneticModel::FieldValues(int L, const SphericalEngine::coeff c[],
+                                  real X, real Y, real Z,
+                                  real BX[], real BY[], real BZ[]) const {
+    // Evaluate the gradients of L sets of coefficients with the same degree
+    // and order (L = 1, 2, 3) sharing the recursion factors.
+    static const real f[] = {1, 1, 1};
+    real v[3];
+    bool full = _norm == SphericalHarmonic::FULL;
+    switch (L) {
+    case 1:
+      if (full)
+        SphericalEngine::Value<true, SphericalEngine::FULL, 1>
+          (c, f, X, Y, Z, _a, BX[0], BY[0], BZ[0]);
+      else
+        SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
+          (c, f, X, Y, Z, _a, BX[0], BY[0], BZ[0]);
+      break;
+    case 2:
+      if (full)
+        SphericalEngine::Values<true, SphericalEngine::FULL, 2>
+          (c, f, X, Y, Z, _a, v, BX, BY, BZ);
+      else
+        SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 2>
+          (c, f, X, Y, Z, _a, v, BX, BY, BZ);
+      break;
+    default:
+      if (full)
+        SphericalEngine::Values<true, SphericalEngine::FULL, 3>
+          (c, f, X, Y, Z, _a, v, BX, BY, BZ);
+      else
+        SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 3>
+          (c, f, X, Y, Z, _a, v, BX, BY, BZ);
+      break;
+    }
+  }
+
+  bool MagneticModel::MapCoefficients(const std::string& coeff) {
+    // Use the coefficients in place in a memory mapping of the file.  Return
+    // false (so that the file is read instead) if this isn't possible.
+    if (!SphericalEngine::coeff::mappable())
+      return false;
+    try {
+      _map = Utility::mapfile(coeff, _maplen, _maphandle);
+    }
+    catch (const GeographicErr&) {
+      return false;
+    }
+    try {
+      if (!(_maplen >= unsigned(idlength_)))
+        throw GeographicErr("No header in " + coeff);
+      string id(_map, idlength_);
+      if (_id != id)
+        throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+      unsigned long long pos = idlength_;
       for (int i = 0; i < _Nmodels + 1 + _Nconstants; ++i) {
         int N, M;
-        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _G[i], _H[i]);
-        if (!(M < 0 || _G[i][0] == 0))
+        real *G, *H;
+        SphericalEngine::coeff::mapcoeffs(_map, _maplen, pos, N, M, G, H);
+        if (!(M < 0 || G[0] == 0))
           throw GeographicErr("A degree 0 term is not permitted");
-        _harm.push_back(SphericalHarmonic(_G[i], _H[i], N, N, M, _a, _norm));
+        _harm.push_back(SphericalHarmonic(SphericalEngine::coeff
+                                          (G, H, N, N, M), _a, _norm));
       }
-      int pos = int(coeffstr.tellg());
-      coeffstr.seekg(0, ios::end);
-      if (pos != coeffstr.tellg())
+      if (pos != _maplen)
         throw GeographicErr("Extra data in " + coeff);
     }
+    catch (...) {
+      Utility::unmapfile(_map, _maplen, _maphandle);
+      _map = 0;
+      throw;
+    }
+    return true;
   }
 
   void MagneticModel::ReadMetadata(const std::string& name) {
@@ -180,14 +392,24 @@ namespace GeographicLib {
     real X, Y, Z;
     real M[Geocentric::dim2_];
     _earth.IntForward(lat, lon, h, X, Y, Z, M);
-    // Components in geocentric basis
-    // initial values to suppress warning
-    real BX0 = 0, BY0 = 0, BZ0 = 0, BX1 = 0, BY1 = 0, BZ1 = 0;
-    real BXc = 0, BYc = 0, BZc = 0;
-    _harm[n](X, Y, Z, BX0, BY0, BZ0);
-    _harm[n + 1](X, Y, Z, BX1, BY1, BZ1);
-    if (_Nconstants)
-      _harm[_Nmodels + 1](X, Y, Z, BXc, BYc, BZc);
+    // Components in geocentric basis.  The sets of coefficients for the two
+    // bracketing models (and the constant terms) which have the same degree
+    // and order are evaluated with a single recursion.
+    const SphericalEngine::coeff c[] = {
+      Harmonic(n).Coefficients(), Harmonic(n + 1).Coefficients(),
+      _Nconstants ? Harmonic(_Nmodels + 1).Coefficients() :
+      SphericalEngine::coeff() };
+    real BX[] = {0, 0, 0}, BY[] = {0, 0, 0}, BZ[] = {0, 0, 0};
+    int L = c[1].nmx() == c[0].nmx() && c[1].mmx() == c[0].mmx() ?
+      (_Nconstants &&
+       c[2].nmx() == c[0].nmx() && c[2].mmx() == c[0].mmx() ? 3 : 2) : 1;
+    FieldValues(L, c, X, Y, Z, BX, BY, BZ);
+    for (int l = L; l < (_Nconstants ? 3 : 2); ++l)
+      FieldValues(1, c + l, X, Y, Z, BX + l, BY + l, BZ + l);
+    real
+      BX0 = BX[0], BY0 = BY[0], BZ0 = BZ[0],
+      BX1 = BX[1], BY1 = BY[1], BZ1 = BZ[1],
+      BXc = BX[2], BYc = BY[2], BZc = BZ[2];
     if (interpolate) {
       // Convert to a time derivative
       BX1 = (BX1 - BX0) / _dt0;
@@ -209,7 +431,105 @@ namespace GeographicLib {
     Bz *= - _a;
   }
 
-  MagneticCircle MagneticModel::Circle(real t, real lat, real h) const {
+  void MagneticModel::FieldRange(const real t[], const real lat[],
+                                 const real lon[], const real h[],
+                                 size_t i0, size_t i1, bool diffp,
+                                 real Bx[], real By[], real Bz[],
+                                 real Bxt[], real Byt[], real Bzt[]) const {
+    // Evaluate points i0 <= i < i1 in groups of at most batchsize_
+    // consecutive points which use the same pair of models.  The operations
+    // on each point are the same as in Field, so that the results are
+    // identical.
+    const int nb = batchsize_;
+    real X[nb], Y[nb], Z[nb], M[nb * Geocentric::dim2_], t1[nb],
+      dummy[nb], BX0[nb], BY0[nb], BZ0[nb], BX1[nb], BY1[nb], BZ1[nb],
+      BXc[nb], BYc[nb], BZc[nb];
+    for (size_t j0 = i0; j0 < i1;) {
+      int k = 0, n = 0;
+      for (; k < nb && j0 + k < i1; ++k) {
+        size_t i = j0 + k;
+        real tt = t[i] - _t0;
+        int nn = max(min(int(floor(tt / _dt0)), _Nmodels - 1), 0);
+        if (k == 0)
+          n = nn;
+        else if (nn != n)
+          break;
+        t1[k] = tt - n * _dt0;
+        _earth.IntForward(lat[i], lon[i], h[i], X[k], Y[k], Z[k],
+                          M + k * Geocentric::dim2_);
+      }
+      bool interpolate = n + 1 < _Nmodels;
+      Harmonic(n)(k, X, Y, Z, dummy, BX0, BY0, BZ0);
+      Harmonic(n + 1)(k, X, Y, Z, dummy, BX1, BY1, BZ1);
+      if (_Nconstants)
+        Harmonic(_Nmodels + 1)(k, X, Y, Z, dummy, BXc, BYc, BZc);
+      else
+        for (int j = 0; j < k; ++j)
+          BXc[j] = BYc[j] = BZc[j] = 0;
+      for (int j = 0; j < k; ++j) {
+        size_t i = j0 + j;
+        real* Mj = M + j * Geocentric::dim2_;
+        if (interpolate) {
+          // Convert to a time derivative
+          BX1[j] = (BX1[j] - BX0[j]) / _dt0;
+          BY1[j] = (BY1[j] - BY0[j]) / _dt0;
+          BZ1[j] = (BZ1[j] - BZ0[j]) / _dt0;
+        }
+        BX0[j] += t1[j] * BX1[j] + BXc[j];
+        BY0[j] += t1[j] * BY1[j] + BYc[j];
+        BZ0[j] += t1[j] * BZ1[j] + BZc[j];
+        if (diffp) {
+          Geocentric::Unrotate(Mj, BX1[j], BY1[j], BZ1[j],
+                               Bxt[i], Byt[i], Bzt[i]);
+          Bxt[i] *= - _a;
+          Byt[i] *= - _a;
+          Bzt[i] *= - _a;
+        }
+        Geocentric::Unrotate(Mj, BX0[j], BY0[j], BZ0[j], Bx[i], By[i], Bz[i]);
+        Bx[i] *= - _a;
+        By[i] *= - _a;
+        Bz[i] *= - _a;
+      }
+      j0 += k;
+    }
+  }
+
+  void MagneticModel::FieldBatch(const real t[], const real lat[],
+                                 const real lon[], const real h[], size_t n,
+                                 bool diffp,
+                                 real Bx[], real By[], real Bz[],
+                                 real Bxt[], real Byt[], real Bzt[],
+                                 int nthreads) const {
+    if (_loader) {
+      // Load the coefficients which are needed here, so that any error is
+      // reported to the caller and not thrown by another thread.
+      for (size_t i = 0; i < n; ++i) {
+        int k = max(min(int(floor((t[i] - _t0) / _dt0)), _Nmodels - 1), 0);
+        Harmonic(k); Harmonic(k + 1);
+      }
+      if (_Nconstants)
+        Harmonic(_Nmodels + 1);
+    }
+#if GEOGRAPHICLIB_MAGNETICMODEL_THREADS
+    // Divide the whole groups of points into nthreads contiguous ranges
+    // which are run by the current Executor.
+    size_t ngroups = (n + batchsize_ - 1) / batchsize_;
+    Executor::For(ngroups, size_t(max(nthreads, 1)),
+                  [&](size_t b0, size_t b1) {
+                    size_t
+                      i0 = min(n, b0 * batchsize_),
+                      i1 = min(n, b1 * batchsize_);
+                    FieldRange(t, lat, lon, h, i0, i1, diffp, Bx, By, Bz, Bxt,
+                               Byt, Bzt);
+                  });
+#else
+    (void)nthreads;
+    FieldRange(t, lat, lon, h, 0, n, diffp, Bx, By, Bz, Bxt, Byt, Bzt);
+#endif
+  }
+
+  MagneticCircle MagneticModel::Circle(real t, real lat, real h,
+                                       int nthreads) const {
     real t1 = t - _t0;
     int n = max(min(int(floor(t1 / _dt0)), _Nmodels - 1), 0);
     bool interpolate = n + 1 < _Nmodels;
@@ -221,13 +541,136 @@ namespace GeographicLib {
     return (_Nconstants == 0 ?
             MagneticCircle(_a, _earth._f, lat, h, t,
                            M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true)) :
+                           Harmonic(n).Circle(X, Z, true, nthreads),
+                           Harmonic(n + 1).Circle(X, Z, true, nthreads)) :
             MagneticCircle(_a, _earth._f, lat, h, t,
                            M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true),
-                           _harm[_Nmodels + 1].Circle(X, Z, true)));
+                           Harmonic(n).Circle(X, Z, true, nthreads),
+                           Harmonic(n + 1).Circle(X, Z, true, nthreads),
+                           Harmonic(_Nmodels + 1).Circle(X, Z, true,
+                                                         nthreads)));
+  }
+
+  void MagneticModel::Circles(real t, real lat, const real h[], int n,
+                              std::vector<MagneticCircle>& circles,
+                              int nthreads) const {
+    circles.clear();
+    if (n <= 0)
+      return;
+    circles.reserve(n);
+    real t1 = t - _t0;
+    int m = max(min(int(floor(t1 / _dt0)), _Nmodels - 1), 0);
+    bool interpolate = m + 1 < _Nmodels;
+    t1 -= m * _dt0;
+    vector<real> X(n), Z(n), M(n * Geocentric::dim2_);
+    for (int i = 0; i < n; ++i) {
+      real Y;
+      _earth.IntForward(lat, 0, h[i], X[i], Y, Z[i],
+                        &M[i * Geocentric::dim2_]);
+    }
+    vector<CircularEngine> c0(n), c1(n), cc(_Nconstants ? n : 0);
+    Harmonic(m).Circles(n, &X[0], &Z[0], true, &c0[0], nthreads);
+    Harmonic(m + 1).Circles(n, &X[0], &Z[0], true, &c1[0], nthreads);
+    if (_Nconstants)
+      Harmonic(_Nmodels + 1).Circles(n, &X[0], &Z[0], true, &cc[0], nthreads);
+    for (int i = 0; i < n; ++i) {
+      const real* Mi = &M[i * Geocentric::dim2_];
+      circles.push_back(_Nconstants == 0 ?
+                        MagneticCircle(_a, _earth._f, lat, h[i], t,
+                                       Mi[7], Mi[8], t1, _dt0, interpolate,
+                                       c0[i], c1[i]) :
+                        MagneticCircle(_a, _earth._f, lat, h[i], t,
+                                       Mi[7], Mi[8], t1, _dt0, interpolate,
+                                       c0[i], c1[i], cc[i]));
+    }
+  }
+
+  namespace {
+    // Add f times the coefficients in c to C and S which have the layout for
+    // degree N.
+    void AddCoeffs(const SphericalEngine::coeff& c, Math::real f, int N,
+                   vector<Math::real>& C, vector<Math::real>& S) {
+      for (int m = 0; m <= c.mmx(); ++m)
+        for (int n = m; n <= c.nmx(); ++n) {
+          int k = c.index(n, m), l = m * N - m * (m - 1) / 2 + n;
+          C[l] += f * c.Cv(k);
+          if (m)
+            S[l - (N + 1)] += f * c.Sv(k);
+        }
+    }
+  }
+
+  MagneticSnapshot MagneticModel::AtTime(real t) const {
+    real t1 = t - _t0;
+    int n = max(min(int(floor(t1 / _dt0)), _Nmodels - 1), 0);
+    bool interpolate = n + 1 < _Nmodels;
+    t1 -= n * _dt0;
+    const SphericalEngine::coeff
+      &c0 = Harmonic(n).Coefficients(),
+      &c1 = Harmonic(n + 1).Coefficients();
+    int
+      N = max(c0.nmx(), c1.nmx()),
+      M = max(c0.mmx(), c1.mmx());
+    if (_Nconstants) {
+      const SphericalEngine::coeff& cc = Harmonic(_Nmodels + 1).Coefficients();
+      N = max(N, cc.nmx());
+      M = max(M, cc.mmx());
+    }
+    int
+      csize = SphericalEngine::coeff::Csize(N, M),
+      ssize = max(SphericalEngine::coeff::Ssize(N, M), 0);
+    vector<real> G(csize, 0), H(ssize, 0), Gt(csize, 0), Ht(ssize, 0);
+    // The rate of change
+    AddCoeffs(c1, 1, N, Gt, Ht);
+    if (interpolate) {
+      AddCoeffs(c0, -1, N, Gt, Ht);
+      for (int k = 0; k < csize; ++k) Gt[k] /= _dt0;
+      for (int k = 0; k < ssize; ++k) Ht[k] /= _dt0;
+    }
+    // The field at t
+    AddCoeffs(c0, 1, N, G, H);
+    for (int k = 0; k < csize; ++k) G[k] += t1 * Gt[k];
+    for (int k = 0; k < ssize; ++k) H[k] += t1 * Ht[k];
+    if (_Nconstants)
+      AddCoeffs(Harmonic(_Nmodels + 1).Coefficients(), 1, N, G, H);
+    return MagneticSnapshot(_a, _earth, _norm, t, N, M, G, H, Gt, Ht);
+  }
+
+  MagneticLocation MagneticModel::AtLocation(real lat, real lon, real h)
+    const {
+    real X, Y, Z;
+    real M[Geocentric::dim2_];
+    _earth.IntForward(lat, lon, h, X, Y, Z, M);
+    // Components in geocentric basis of the model for each epoch and of the
+    // constant terms
+    vector<real> B(3 * (_Nmodels + 1));
+    for (int k = 0; k <= _Nmodels; ++k)
+      Harmonic(k)(X, Y, Z, B[3 * k], B[3 * k + 1], B[3 * k + 2]);
+    real BXc = 0, BYc = 0, BZc = 0;
+    if (_Nconstants)
+      Harmonic(_Nmodels + 1)(X, Y, Z, BXc, BYc, BZc);
+    // The field at the start of each interval and its rate of change,
+    // following MagneticModel::Field
+    vector<real> field(6 * _Nmodels);
+    for (int n = 0; n < _Nmodels; ++n) {
+      bool interpolate = n + 1 < _Nmodels;
+      const real *B0 = &B[3 * n], *B1 = &B[3 * (n + 1)];
+      real
+        BX1 = B1[0], BY1 = B1[1], BZ1 = B1[2];
+      if (interpolate) {
+        // Convert to a time derivative
+        BX1 = (BX1 - B0[0]) / _dt0;
+        BY1 = (BY1 - B0[1]) / _dt0;
+        BZ1 = (BZ1 - B0[2]) / _dt0;
+      }
+      real* f = &field[6 * n];
+      Geocentric::Unrotate(M, B0[0] + BXc, B0[1] + BYc, B0[2] + BZc,
+                           f[0], f[1], f[2]);
+      Geocentric::Unrotate(M, BX1, BY1, BZ1, f[3], f[4], f[5]);
+      for (int j = 0; j < 6; ++j)
+        f[j] *= - _a;
+    }
+    return MagneticLocation(lat, lon, h, _t0, _dt0, _Nmodels, field);
   }
 
   void MagneticModel::FieldComponents(real Bx, real By, real Bz,
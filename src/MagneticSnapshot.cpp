@@ -0,0 +1,82 @@
+/**
+ * \file MagneticSnapshot.cpp
+ * \brief Implementation for GeographicLib::MagneticSnapshot class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/MagneticSnapshot.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  MagneticSnapshot::MagneticSnapshot(const MagneticSnapshot& s)
+    : _a(s._a)
+    , _t(s._t)
+    , _earth(s._earth)
+    , _norm(s._norm)
+    , _N(s._N)
+    , _M(s._M)
+    , _G(s._G)
+    , _H(s._H)
+    , _Gt(s._Gt)
+    , _Ht(s._Ht)
+  {
+    if (Init())
+      Reset();
+  }
+
+  MagneticSnapshot& MagneticSnapshot::operator=(const MagneticSnapshot& s) {
+    if (this != &s) {
+      _a = s._a;
+      _t = s._t;
+      _earth = s._earth;
+      _norm = s._norm;
+      _N = s._N;
+      _M = s._M;
+      _G = s._G;
+      _H = s._H;
+      _Gt = s._Gt;
+      _Ht = s._Ht;
+      if (Init())
+        Reset();
+      else
+        _field = _rate = SphericalHarmonic();
+    }
+    return *this;
+  }
+
+  void MagneticSnapshot::Reset() {
+    // Point the sums at this object's copy of the coefficients
+    _field = SphericalHarmonic(_G, _H, _N, _N, _M, _a, _norm);
+    _rate = SphericalHarmonic(_Gt, _Ht, _N, _N, _M, _a, _norm);
+  }
+
+  void MagneticSnapshot::Field(real lat, real lon, real h, bool diffp,
+                               real& Bx, real& By, real& Bz,
+                               real& Bxt, real& Byt, real& Bzt) const {
+    // Follow MagneticModel::Field with the combined coefficients
+    real X, Y, Z;
+    real M[Geocentric::dim2_];
+    _earth.IntForward(lat, lon, h, X, Y, Z, M);
+    // Components in geocentric basis
+    real BX, BY, BZ;
+    _field(X, Y, Z, BX, BY, BZ);
+    if (diffp) {
+      real BXt, BYt, BZt;
+      _rate(X, Y, Z, BXt, BYt, BZt);
+      Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt, Byt, Bzt);
+      Bxt *= - _a;
+      Byt *= - _a;
+      Bzt *= - _a;
+    }
+    Geocentric::Unrotate(M, BX, BY, BZ, Bx, By, Bz);
+    Bx *= - _a;
+    By *= - _a;
+    Bz *= - _a;
+  }
+
+} // namespace GeographicLib
@@ -8,35 +8,62 @@ INCLUDEPATH = ../include
 PREFIX = /usr/local
 GEOGRAPHICLIB_DATA = $(PREFIX)/share/GeographicLib
 
-MODULES = Accumulator \
+MODULES = --help \
+	Accumulator \
 	AlbersEqualArea \
+	AuthalicSphere \
 	AzimuthalEquidistant \
 	CassiniSoldner \
 	CircularEngine \
+	CompactGeodesicLine \
 	DMS \
+	EditablePolygonArea \
 	Ellipsoid \
 	EllipticFunction \
+	Executor \
 	GeoCoords \
 	Geocentric \
+	GeocentricTracker \
 	Geodesic \
+	GeodesicBuffer \
 	GeodesicExact \
+	GeodesicIndex \
+	GeodesicIntersect \
 	GeodesicLine \
+	GeodesicLineCache \
 	GeodesicLineExact \
+	GeodesicMatrix \
+	GeodesicPolygon \
 	Geohash \
 	Geoid \
+	GeoidGenerator \
 	Gnomonic \
 	GravityCircle \
+	GravityCircleCache \
+	GravityGrid \
 	GravityModel \
+	GreatEllipse \
+	GridMapper \
+	Instrumentation \
+	InverseCache \
+	JacobiConformal \
 	LambertConformalConic \
+	LinePipeline \
 	LocalCartesian \
 	MGRS \
+	MGRSGrid \
 	MagneticCircle \
+	MagneticCircleCache \
+	MagneticLocation \
 	MagneticModel \
+	MagneticSnapshot \
 	Math \
 	NormalGravity \
+	NumaReplicas \
 	OSGB \
 	PolarStereographic \
 	PolygonArea \
+	Projector \
 	Rhumb \
 	SphericalEngine \
 	TransverseMercator \
@@ -78,62 +105,129 @@ TAGS: $(HEADERS) $(SOURCES)
 
 Accumulator.o: Accumulator.hpp Config.h Constants.hpp Math.hpp
 AlbersEqualArea.o: AlbersEqualArea.hpp Config.h Constants.hpp Math.hpp
+AuthalicSphere.o: AlbersEqualArea.hpp AuthalicSphere.hpp Config.h Constants.hpp \
+	Ellipsoid.hpp EllipticFunction.hpp Math.hpp TransverseMercator.hpp
 AzimuthalEquidistant.o: AzimuthalEquidistant.hpp Config.h Constants.hpp \
-	Geodesic.hpp Math.hpp
+	Geodesic.hpp GeodesicLine.hpp Math.hpp
 CassiniSoldner.o: CassiniSoldner.hpp Config.h Constants.hpp Geodesic.hpp \
 	GeodesicLine.hpp Math.hpp
 CircularEngine.o: CircularEngine.hpp Config.h Constants.hpp Math.hpp \
 	SphericalEngine.hpp
+CompactGeodesicLine.o: CompactGeodesicLine.hpp Config.h Constants.hpp \
+	Geodesic.hpp GeodesicLine.hpp Math.hpp
 DMS.o: Config.h Constants.hpp DMS.hpp Math.hpp Utility.hpp
+EditablePolygonArea.o: Accumulator.hpp AuthalicSphere.hpp Config.h \
+	Constants.hpp EditablePolygonArea.hpp Executor.hpp Geodesic.hpp \
+	GeodesicExact.hpp Math.hpp PolygonArea.hpp Rhumb.hpp Utility.hpp
 Ellipsoid.o: Config.h Constants.hpp Ellipsoid.hpp AlbersEqualArea.hpp \
 	EllipticFunction.hpp Math.hpp TransverseMercator.hpp
 EllipticFunction.o: Config.h Constants.hpp EllipticFunction.hpp Math.hpp
+Executor.o: Config.h Constants.hpp Executor.hpp Math.hpp
 GeoCoords.o: Config.h Constants.hpp DMS.hpp GeoCoords.hpp MGRS.hpp Math.hpp \
 	UTMUPS.hpp Utility.hpp
 Geocentric.o: Config.h Constants.hpp Geocentric.hpp Math.hpp
-Geodesic.o: Config.h Constants.hpp Geodesic.hpp GeodesicLine.hpp Math.hpp
+GeocentricTracker.o: Config.h Constants.hpp Geocentric.hpp \
+	GeocentricTracker.hpp Math.hpp
+Geodesic.o: Config.h Constants.hpp Executor.hpp Geodesic.hpp GeodesicLine.hpp \
+	Instrumentation.hpp Math.hpp Utility.hpp
+GeodesicBuffer.o: Accumulator.hpp AuthalicSphere.hpp Config.h Constants.hpp \
+	Executor.hpp Geodesic.hpp GeodesicBuffer.hpp GeodesicExact.hpp \
+	GeodesicIntersect.hpp GeodesicLine.hpp Gnomonic.hpp Math.hpp \
+	PolygonArea.hpp Rhumb.hpp Utility.hpp
 GeodesicExact.o: Config.h Constants.hpp GeodesicExact.hpp \
-	GeodesicLineExact.hpp Math.hpp
+	GeodesicLineExact.hpp Math.hpp Utility.hpp
 GeodesicExactC4.o: Config.h Constants.hpp GeodesicExact.hpp Math.hpp
+GeodesicIndex.o: Config.h Constants.hpp Executor.hpp Geocentric.hpp \
+	Geodesic.hpp GeodesicIndex.hpp Instrumentation.hpp Math.hpp
+GeodesicIntersect.o: Config.h Constants.hpp Geodesic.hpp GeodesicIntersect.hpp \
+	GeodesicLine.hpp Gnomonic.hpp Math.hpp
 GeodesicLine.o: Config.h Constants.hpp Geodesic.hpp GeodesicLine.hpp Math.hpp
+GeodesicLineCache.o: Config.h Constants.hpp Geodesic.hpp GeodesicLine.hpp \
+	GeodesicLineCache.hpp Math.hpp
 GeodesicLineExact.o: Config.h Constants.hpp GeodesicExact.hpp \
 	GeodesicLineExact.hpp Math.hpp
-Geohash.o: Config.h Constants.hpp Geohash.hpp Utility.hpp
-Geoid.o: Config.h Constants.hpp Geoid.hpp Math.hpp
+GeodesicMatrix.o: Config.h Constants.hpp Geodesic.hpp GeodesicMatrix.hpp \
+	Math.hpp
+GeodesicPolygon.o: Accumulator.hpp Config.h Constants.hpp Executor.hpp \
+	Geodesic.hpp GeodesicPolygon.hpp Instrumentation.hpp Math.hpp \
+	PolygonArea.hpp
+Geohash.o: Config.h Constants.hpp Geodesic.hpp Geohash.hpp Math.hpp Utility.hpp
+Geoid.o: Config.h Constants.hpp Geoid.hpp Instrumentation.hpp Math.hpp
+GeoidGenerator.o: CircularEngine.hpp Config.h Constants.hpp Executor.hpp \
+	Geocentric.hpp Geoid.hpp GeoidGenerator.hpp GravityCircle.hpp \
+	GravityModel.hpp Instrumentation.hpp Math.hpp NormalGravity.hpp \
+	SphericalEngine.hpp SphericalHarmonic.hpp SphericalHarmonic1.hpp \
+	Utility.hpp
 Gnomonic.o: Config.h Constants.hpp Geodesic.hpp GeodesicLine.hpp Gnomonic.hpp \
 	Math.hpp
 GravityCircle.o: CircularEngine.hpp Config.h Constants.hpp Geocentric.hpp \
 	GravityCircle.hpp GravityModel.hpp Math.hpp NormalGravity.hpp \
 	SphericalEngine.hpp SphericalHarmonic.hpp SphericalHarmonic1.hpp
-GravityModel.o: CircularEngine.hpp Config.h Constants.hpp Geocentric.hpp \
-	GravityCircle.hpp GravityModel.hpp Math.hpp NormalGravity.hpp \
-	SphericalEngine.hpp SphericalHarmonic.hpp SphericalHarmonic1.hpp \
-	Utility.hpp
+GravityCircleCache.o: CacheSupport.hpp CircularEngine.hpp Config.h \
+	Constants.hpp Geocentric.hpp GravityCircle.hpp GravityCircleCache.hpp GravityModel.hpp \
+	Math.hpp NormalGravity.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	SphericalHarmonic1.hpp Utility.hpp
+GravityGrid.o: CircularEngine.hpp Config.h Constants.hpp Executor.hpp \
+	Geocentric.hpp GravityCircle.hpp GravityGrid.hpp GravityModel.hpp \
+	Math.hpp NormalGravity.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	SphericalHarmonic1.hpp
+GravityModel.o: CircularEngine.hpp Config.h Constants.hpp Executor.hpp \
+	Geocentric.hpp GravityCircle.hpp GravityModel.hpp Math.hpp \
+	NormalGravity.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	SphericalHarmonic1.hpp Utility.hpp
+GreatEllipse.o: Config.h Constants.hpp Executor.hpp Geodesic.hpp \
+	GreatEllipse.hpp Math.hpp
+GridMapper.o: Config.h Constants.hpp Executor.hpp GridMapper.hpp Math.hpp
+Instrumentation.o: Config.h Constants.hpp Instrumentation.hpp Math.hpp
+InverseCache.o: AlbersEqualArea.hpp CacheSupport.hpp Config.h Constants.hpp \
+	Ellipsoid.hpp EllipticFunction.hpp Geodesic.hpp GeodesicExact.hpp \
+	InverseCache.hpp Math.hpp Rhumb.hpp TransverseMercator.hpp Utility.hpp
+JacobiConformal.o: Config.h Constants.hpp EllipticFunction.hpp Executor.hpp \
+	JacobiConformal.hpp Math.hpp
 LambertConformalConic.o: Config.h Constants.hpp LambertConformalConic.hpp \
 	Math.hpp
+LinePipeline.o: Config.h Constants.hpp Executor.hpp LinePipeline.hpp Math.hpp
 LocalCartesian.o: Config.h Constants.hpp Geocentric.hpp LocalCartesian.hpp \
 	Math.hpp
 MGRS.o: Config.h Constants.hpp MGRS.hpp Math.hpp UTMUPS.hpp Utility.hpp
+MGRSGrid.o: Config.h Constants.hpp MGRS.hpp MGRSGrid.hpp Math.hpp \
+	TransverseMercator.hpp UTMUPS.hpp Utility.hpp
 MagneticCircle.o: CircularEngine.hpp Config.h Constants.hpp Geocentric.hpp \
 	MagneticCircle.hpp Math.hpp SphericalEngine.hpp
-MagneticModel.o: CircularEngine.hpp Config.h Constants.hpp Geocentric.hpp \
-	MagneticCircle.hpp MagneticModel.hpp Math.hpp SphericalEngine.hpp \
-	SphericalHarmonic.hpp Utility.hpp
+MagneticCircleCache.o: CacheSupport.hpp CircularEngine.hpp Config.h \
+	Constants.hpp Geocentric.hpp MagneticCircle.hpp MagneticCircleCache.hpp \
+	MagneticModel.hpp Math.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	Utility.hpp
+MagneticLocation.o: Config.h Constants.hpp MagneticLocation.hpp Math.hpp
+MagneticModel.o: CircularEngine.hpp Config.h Constants.hpp Executor.hpp \
+	Geocentric.hpp MagneticCircle.hpp MagneticLocation.hpp MagneticModel.hpp \
+	MagneticSnapshot.hpp Math.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	Utility.hpp
+MagneticSnapshot.o: CircularEngine.hpp Config.h Constants.hpp \
+	Geocentric.hpp MagneticSnapshot.hpp Math.hpp SphericalEngine.hpp \
+	SphericalHarmonic.hpp
 Math.o: Config.h Constants.hpp Math.hpp
 NormalGravity.o: Config.h Constants.hpp Geocentric.hpp Math.hpp \
 	NormalGravity.hpp
+NumaReplicas.o: Config.h Constants.hpp Math.hpp NumaReplicas.hpp Utility.hpp
 OSGB.o: Config.h Constants.hpp Math.hpp OSGB.hpp TransverseMercator.hpp \
 	Utility.hpp
 PolarStereographic.o: Config.h Constants.hpp Math.hpp PolarStereographic.hpp
-PolygonArea.o: Accumulator.hpp Config.h Constants.hpp Geodesic.hpp Math.hpp \
-	PolygonArea.hpp
+PolygonArea.o: Accumulator.hpp Config.h Constants.hpp Executor.hpp \
+	Geodesic.hpp Math.hpp PolygonArea.hpp
+Projector.o: AlbersEqualArea.hpp AzimuthalEquidistant.hpp CassiniSoldner.hpp \
+	Config.h Constants.hpp EllipticFunction.hpp Geodesic.hpp GeodesicLine.hpp \
+	Gnomonic.hpp GridMapper.hpp LambertConformalConic.hpp Math.hpp \
+	PolarStereographic.hpp Projector.hpp TransverseMercator.hpp \
+	TransverseMercatorExact.hpp
 Rhumb.o: Config.h Constants.hpp Ellipsoid.hpp Math.hpp Rhumb.hpp \
-	AlbersEqualArea.hpp EllipticFunction.hpp TransverseMercator.hpp
-SphericalEngine.o: CircularEngine.hpp Config.h Constants.hpp Math.hpp \
-	SphericalEngine.hpp Utility.hpp
-TransverseMercator.o: Config.h Constants.hpp Math.hpp TransverseMercator.hpp
+	AlbersEqualArea.hpp EllipticFunction.hpp TransverseMercator.hpp Utility.hpp
+SphericalEngine.o: CircularEngine.hpp Config.h Constants.hpp Executor.hpp \
+	Instrumentation.hpp Math.hpp SphericalEngine.hpp Utility.hpp
+TransverseMercator.o: Config.h Constants.hpp Executor.hpp Math.hpp \
+	TransverseMercator.hpp Utility.hpp
 TransverseMercatorExact.o: Config.h Constants.hpp EllipticFunction.hpp \
-	Math.hpp TransverseMercatorExact.hpp
+	Instrumentation.hpp Math.hpp TransverseMercatorExact.hpp
 UTMUPS.o: Config.h Constants.hpp MGRS.hpp Math.hpp PolarStereographic.hpp \
 	TransverseMercator.hpp UTMUPS.hpp Utility.hpp
 Utility.o: Config.h Constants.hpp Math.hpp Utility.hpp
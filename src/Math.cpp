@@ -20,20 +20,11 @@ namespace GeographicLib {
 
   using namespace std;
 
-  template<typename T> T Math::eatanhe(T x, T es)  {
-    return es > T(0) ? es * atanh(es * x) : -es * atan(es * x);
-  }
-
-  template<typename T> T Math::taupf(T tau, T es) {
-    T tau1 = hypot(T(1), tau),
-      sig = sinh( eatanhe(tau / tau1, es ) );
-    return hypot(T(1), sig) * tau - sig * tau1;
-  }
-
   template<typename T> T Math::tauf(T taup, T es) {
     static const int numit = 5;
     static const T tol = sqrt(numeric_limits<T>::epsilon()) / T(10);
-    T e2m = T(1) - sq(es),
+    // es < 0 denotes a prolate ellipsoid with e^2 = -es^2.
+    T e2m = T(1) - (es < 0 ? -1 : 1) * sq(es),
       // To lowest order in e^2, taup = (1 - e^2) * tau = _e2m * tau; so use
       // tau = taup/_e2m as a starting guess.  (This starting guess is the
       // geocentric latitude which, to first order in the flattening, is equal
@@ -55,10 +46,75 @@ namespace GeographicLib {
     return tau;
   }
 
+  template<typename T> void Math::eatanhe(const T x[], T y[], size_t n,
+                                          T es) {
+    // Hoist the test on the sign of es out of the loop.
+    if (es > T(0))
+      for (size_t i = 0; i < n; ++i)
+        y[i] = es * atanh(es * x[i]);
+    else
+      for (size_t i = 0; i < n; ++i)
+        y[i] = -es * atan(es * x[i]);
+  }
+
+  template<typename T> void Math::taupf(const T tau[], T taup[], size_t n,
+                                        T es) {
+    for (size_t i = 0; i < n; ++i) {
+      T tau1 = hypot(T(1), tau[i]),
+        sig = sinh( eatanhe(tau[i] / tau1, es ) );
+      taup[i] = hypot(T(1), sig) * tau[i] - sig * tau1;
+    }
+  }
+
+  template<typename T> void Math::tauf(const T taup[], T tau[], size_t n,
+                                       T es) {
+    // See the scalar version for the choice of starting guess, etc.
+    static const int numit = 5, nblock = 16;
+    static const T tol = sqrt(numeric_limits<T>::epsilon()) / T(10);
+    T e2m = T(1) - (es < 0 ? -1 : 1) * sq(es),
+      tp[nblock], t[nblock], stol[nblock];
+    bool active[nblock];
+    for (size_t i0 = 0; i0 < n; i0 += nblock) {
+      int nb = int((min)(size_t(nblock), n - i0));
+      for (int i = 0; i < nb; ++i) {
+        tp[i] = taup[i0 + i];
+        t[i] = tp[i]/e2m;
+        stol[i] = tol * max(T(1), abs(tp[i]));
+        active[i] = true;
+      }
+      for (int it = 0, nact = nb;
+           nact > 0 && (it < numit || GEOGRAPHICLIB_PANIC); ++it) {
+        nact = 0;
+        for (int i = 0; i < nb; ++i) {
+          if (!active[i]) continue;
+          T taupa = taupf(t[i], es),
+            dtau = (tp[i] - taupa) * (1 + e2m * sq(t[i])) /
+            ( e2m * hypot(T(1), t[i]) * hypot(T(1), taupa) );
+          t[i] += dtau;
+          active[i] = abs(dtau) >= stol[i];
+          nact += active[i] ? 1 : 0;
+        }
+      }
+      copy(t, t + nb, tau + i0);
+    }
+  }
+
   // Instantiate
   template Math::real Math::eatanhe<Math::real>(Math::real, Math::real);
   template Math::real Math::taupf<Math::real>(Math::real, Math::real);
   template Math::real Math::tauf<Math::real>(Math::real, Math::real);
+  template void Math::eatanhe<Math::real>(const Math::real[], Math::real[],
+                                         size_t, Math::real);
+  template void Math::taupf<Math::real>(const Math::real[], Math::real[],
+                                       size_t, Math::real);
+  template void Math::tauf<Math::real>(const Math::real[], Math::real[],
+                                      size_t, Math::real);
+#if GEOGRAPHICLIB_PRECISION != 1
+  // Used by the float versions of the batch routines
+  template float Math::eatanhe<float>(float, float);
+  template float Math::taupf<float>(float, float);
+  template float Math::tauf<float>(float, float);
+#endif
 
   /// \endcond
 
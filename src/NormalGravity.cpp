@@ -153,6 +153,18 @@ namespace GeographicLib {
     return _gammae * (1 + _k * sphi2) / sqrt(1 - _e2 * sphi2);
   }
 
+  void NormalGravity::SurfaceGravityBatch(const real lat[], size_t n,
+                                          real gamma[]) const {
+    // Follow SurfaceGravity with the constants hoisted out of the loop.
+    const real gammae = _gammae, k = _k, e2 = _e2;
+    for (size_t i = 0; i < n; ++i) {
+      real
+        phi = lat[i] * Math::degree(),
+        sphi2 = abs(lat[i]) == 90 ? 1 : Math::sq(sin(phi));
+      gamma[i] = gammae * (1 + k * sphi2) / sqrt(1 - e2 * sphi2);
+    }
+  }
+
   Math::real NormalGravity::V0(real X, real Y, real Z,
                                real& GammaX, real& GammaY, real& GammaZ)
     const {
@@ -230,6 +242,13 @@ namespace GeographicLib {
     return Ures;
   }
 
+  void NormalGravity::GravityBatch(const real lat[], const real h[],
+                                   size_t n, real U[],
+                                   real gammay[], real gammaz[]) const {
+    for (size_t i = 0; i < n; ++i)
+      U[i] = Gravity(lat[i], h[i], gammay[i], gammaz[i]);
+  }
+
   Math::real NormalGravity::J2ToFlattening(real a, real GM,
                                            real omega, real J2) {
     real
@@ -0,0 +1,148 @@
+/**
+ * \file NumaReplicas.cpp
+ * \brief Implementation for GeographicLib::Numa class
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/NumaReplicas.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#if !defined(GEOGRAPHICLIB_NUMA_LINUX)
+#  if defined(__linux__) && \
+  (__cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700))
+#    define GEOGRAPHICLIB_NUMA_LINUX 1
+#  else
+#    define GEOGRAPHICLIB_NUMA_LINUX 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_NUMA_LINUX
+#  include <sched.h>
+#  include <exception>
+#  include <fstream>
+#  include <sstream>
+#  include <system_error>
+#  include <thread>
+#endif
+
+namespace GeographicLib {
+
+  using namespace std;
+
+#if GEOGRAPHICLIB_NUMA_LINUX
+  namespace {
+    // Parse a list of the form "0-3,8,10-11" as written by the kernel.
+    vector<int> ParseList(const string& s) {
+      vector<int> l;
+      istringstream str(s);
+      string item;
+      while (getline(str, item, ',')) {
+        int a, b;
+        char dash;
+        istringstream istr(item);
+        if (!(istr >> a)) continue;
+        if (istr >> dash >> b && dash == '-') {
+          for (int i = a; i <= b; ++i) l.push_back(i);
+        } else
+          l.push_back(a);
+      }
+      return l;
+    }
+
+    string ReadLine(const string& filename) {
+      ifstream file(filename.c_str());
+      string line;
+      getline(file, line);
+      return line;
+    }
+
+    // The nodes with processors, the processors of each node, and the
+    // index of the node of each processor.
+    struct Topology {
+      vector< vector<int> > cpus;
+      vector<int> node;
+      Topology() {
+        const string dir = "/sys/devices/system/node/";
+        vector<int> online = ParseList(ReadLine(dir + "online"));
+        for (size_t i = 0; i < online.size(); ++i) {
+          vector<int> c = ParseList(ReadLine(dir + "node" +
+                                             Utility::str(online[i]) +
+                                             "/cpulist"));
+          if (c.empty()) continue; // A node with memory only
+          for (size_t j = 0; j < c.size(); ++j) {
+            if (c[j] >= int(node.size())) node.resize(c[j] + 1, 0);
+            node[c[j]] = int(cpus.size());
+          }
+          cpus.push_back(c);
+        }
+      }
+    };
+
+    const Topology& Machine() {
+      // Initialization of a function-scope static is thread safe with C++11.
+      static const Topology topology;
+      return topology;
+    }
+
+    // The body of the thread started by RunOnNode
+    void Bound(const vector<int>* cpus, const Numa::Task* task,
+               exception_ptr* err) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (size_t i = 0; i < cpus->size(); ++i)
+        if ((*cpus)[i] < CPU_SETSIZE) CPU_SET((*cpus)[i], &set);
+      // If the thread can't be bound, the task is still run.
+      (void)sched_setaffinity(0, sizeof(set), &set);
+      try {
+        (*task)();
+      }
+      catch (...) {
+        *err = current_exception();
+      }
+    }
+  }
+
+  int Numa::Nodes()
+  { return max(int(Machine().cpus.size()), 1); }
+
+  int Numa::CurrentNode() {
+    const Topology& t = Machine();
+    int cpu = sched_getcpu();
+    return cpu >= 0 && cpu < int(t.node.size()) ? t.node[cpu] : 0;
+  }
+
+  void Numa::RunOnNode(int node, const Task& task) {
+    if (!(node >= 0 && node < Nodes()))
+      throw GeographicErr("Node " + Utility::str(node) + " not in [0, "
+                          + Utility::str(Nodes()) + ")");
+    if (Nodes() == 1) {
+      task();
+      return;
+    }
+    exception_ptr err;
+    try {
+      thread t(Bound, &Machine().cpus[node], &task, &err);
+      t.join();
+    }
+    catch (const system_error&) {
+      task();
+      return;
+    }
+    if (err) rethrow_exception(err);
+  }
+#else
+  int Numa::Nodes() { return 1; }
+
+  int Numa::CurrentNode() { return 0; }
+
+  void Numa::RunOnNode(int node, const Task& task) {
+    if (node != 0)
+      throw GeographicErr("Node " + Utility::str(node) + " not in [0, 1)");
+    task();
+  }
+#endif
+
+} // namespace GeographicLib
@@ -2,7 +2,7 @@
  * \file OSGB.cpp
  * \brief Implementation for GeographicLib::OSGB class
  *
- * Copyright (c) Charles Karney (2010-2014) <charles@karney.com> and licensed
+ * Copyright (c) Charles Karney (2010-2015) <charles@karney.com> and licensed
  * under the MIT/X11 License.  For more information, see
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
@@ -10,12 +10,24 @@
 #include <GeographicLib/OSGB.hpp>
 #include <GeographicLib/Utility.hpp>
 
+#if !defined(GEOGRAPHICLIB_OSGB_THREADSAFE)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_OSGB_THREADSAFE 1
+#  else
+#    define GEOGRAPHICLIB_OSGB_THREADSAFE 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_OSGB_THREADSAFE
+#  include <mutex>
+#endif
+
 namespace GeographicLib {
 
   using namespace std;
 
-  const string OSGB::letters_ = "ABCDEFGHJKLMNOPQRSTUVWXYZ";
-  const string OSGB::digits_ = "0123456789";
+  const char* const OSGB::letters_ = "ABCDEFGHJKLMNOPQRSTUVWXYZ";
+  const char* const OSGB::digits_ = "0123456789";
 
   const TransverseMercator& OSGB::OSGBTM() {
     static const TransverseMercator osgbtm(MajorRadius(), Flattening(),
@@ -31,17 +43,130 @@ namespace GeographicLib {
     return northoffset;
   }
 
+  // Tables giving the index of each character in letters_ and digits_ (as
+  // returned by Utility::lookup); these are filled in on the first call to
+  // Get.
+  class OSGB::Decoder {
+  private:
+    static Decoder decoder_;
+#if GEOGRAPHICLIB_OSGB_THREADSAFE
+    static once_flag init_;
+#else
+    static bool init_;
+#endif
+    static void Fill(signed char t[], const char* s) {
+      for (int c = 0; c < 256; ++c)
+        t[c] = static_cast<signed char>(Utility::lookup(s, char(c)));
+    }
+    static void Init() {
+      Fill(decoder_.letters, letters_);
+      Fill(decoder_.digits, digits_);
+    }
+  public:
+    signed char letters[256], digits[256];
+    static int Index(const signed char t[], char c)
+    { return t[static_cast<unsigned char>(c)]; }
+    static const Decoder& Get() {
+#if GEOGRAPHICLIB_OSGB_THREADSAFE
+      // Visual Studio 2012 and 2013 don't initialize function-scope statics
+      // thread-safely; so fill in the tables with call_once.
+      call_once(init_, Init);
+#else
+      if (!init_) { Init(); init_ = true; }
+#endif
+      return decoder_;
+    }
+  };
+
+  // decoder_ has no constructor; so it's zero-initialized at load time and
+  // filled in by Init.
+  OSGB::Decoder OSGB::Decoder::decoder_;
+#if GEOGRAPHICLIB_OSGB_THREADSAFE
+  once_flag OSGB::Decoder::init_;
+#else
+  bool OSGB::Decoder::init_ = false;
+#endif
+
+  void OSGB::ForwardBatch(const real lat[], const real lon[], size_t n,
+                          real x[], real y[], real gamma[], real k[]) {
+    OSGBTM().Forward(OriginLongitude(), lat, lon, n, x, y, gamma, k);
+    real x0 = FalseEasting(), y0 = computenorthoffset();
+    for (size_t i = 0; i < n; ++i) {
+      x[i] += x0;
+      y[i] += y0;
+    }
+  }
+
+  void OSGB::ReverseBatch(const real x[], const real y[], size_t n,
+                          real lat[], real lon[], real gamma[], real k[]) {
+    real x0 = FalseEasting(), y0 = computenorthoffset(),
+      bx[nblock_], by[nblock_];
+    for (size_t i0 = 0; i0 < n; i0 += nblock_) {
+      size_t nb = (min)(size_t(nblock_), n - i0);
+      for (size_t i = 0; i < nb; ++i) {
+        bx[i] = x[i0 + i] - x0;
+        by[i] = y[i0 + i] - y0;
+      }
+      OSGBTM().Reverse(OriginLongitude(), bx, by, nb, lat + i0, lon + i0,
+                       gamma ? gamma + i0 : 0, k ? k + i0 : 0);
+    }
+  }
+
   void OSGB::GridReference(real x, real y, int prec, std::string& gridref) {
-    CheckCoords(x, y);
+    char grid[maxlen_];
+    int mlen = Encode(x, y, prec, grid, true);
+    gridref.resize(mlen);
+    copy(grid, grid + mlen, gridref.begin());
+  }
+
+  size_t OSGB::GridReference(real x, real y, int prec,
+                             char* gridref, size_t cap) {
+    char grid[maxlen_];
+    int mlen = Encode(x, y, prec, grid, true);
+    if (!(size_t(mlen) < cap))
+      throw GeographicErr("Buffer of size " + Utility::str(cap)
+                          + " too small for OSGB string");
+    copy(grid, grid + mlen, gridref);
+    gridref[mlen] = '\0';
+    return size_t(mlen);
+  }
+
+  size_t OSGB::GridReferenceBatch(const real x[], const real y[], size_t n,
+                                  int prec, char* gridref, size_t stride) {
+    CheckPrecision(prec);
+    // Longest possible result is for "INVALID" or maxprec_, plus terminator.
+    if (!(stride > size_t((max)(2 + 2 * prec, 7))))
+      throw GeographicErr("Stride " + Utility::str(stride)
+                          + " too small for OSGB strings with precision "
+                          + Utility::str(prec));
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      char* grid = gridref + i * stride;
+      int mlen = Encode(x[i], y[i], prec, grid, false);
+      if (mlen < 0) {
+        mlen = 0;
+        ++nbad;
+      }
+      grid[mlen] = '\0';
+    }
+    return nbad;
+  }
+
+  void OSGB::CheckPrecision(int prec) {
     if (!(prec >= 0 && prec <= maxprec_))
       throw GeographicErr("OSGB precision " + Utility::str(prec)
                           + " not in [0, "
                           + Utility::str(int(maxprec_)) + "]");
+  }
+
+  int OSGB::Encode(real x, real y, int prec, char grid[], bool throwp) {
+    if (!CheckCoords(x, y, throwp)) return -1;
+    CheckPrecision(prec);
     if (Math::isnan(x) || Math::isnan(y)) {
-      gridref = "INVALID";
-      return;
+      static const char invalid[] = "INVALID";
+      copy(invalid, invalid + 7, grid);
+      return 7;
     }
-    char grid[2 + 2 * maxprec_];
     int
       xh = int(floor(x / tile_)),
       yh = int(floor(y / tile_));
@@ -78,46 +203,60 @@ namespace GeographicLib {
         iy /= base_;
       }
     }
-    int mlen = z + 2 * prec;
-    gridref.resize(mlen);
-    copy(grid, grid + mlen, gridref.begin());
+    return z + 2 * prec;
   }
 
   void OSGB::GridReference(const std::string& gridref,
                            real& x, real& y, int& prec,
                            bool centerp) {
+    GridReference(gridref.data(), gridref.size(), x, y, prec, centerp, true);
+  }
+
+  bool OSGB::GridReference(const char* gridref, size_t n,
+                           real& x, real& y, int& prec,
+                           bool centerp, bool throwp) {
+    const Decoder& decoder = Decoder::Get();
     int
-      len = int(gridref.size()),
+      len = int(n),
       p = 0;
     if (len >= 2 &&
         toupper(gridref[0]) == 'I' &&
         toupper(gridref[1]) == 'N') {
       x = y = Math::NaN();
       prec = -2;                // For compatibility with MGRS::Reverse.
-      return;
+      return true;
     }
-    char grid[2 + 2 * maxprec_];
+    char grid[maxlen_];
     for (int i = 0; i < len; ++i) {
       if (!isspace(gridref[i])) {
-        if (p >= 2 + 2 * maxprec_)
-          throw GeographicErr("OSGB string " + gridref + " too long");
+        if (p >= maxlen_) {
+          if (!throwp) return false;
+          throw GeographicErr("OSGB string " + string(gridref, n)
+                              + " too long");
+        }
         grid[p++] = gridref[i];
       }
     }
     len = p;
     p = 0;
-    if (len < 2)
-      throw GeographicErr("OSGB string " + gridref + " too short");
-    if (len % 2)
-      throw GeographicErr("OSGB string " + gridref +
+    if (len < 2) {
+      if (!throwp) return false;
+      throw GeographicErr("OSGB string " + string(gridref, n) + " too short");
+    }
+    if (len % 2) {
+      if (!throwp) return false;
+      throw GeographicErr("OSGB string " + string(gridref, n) +
                           " has odd number of characters");
+    }
     int
       xh = 0,
       yh = 0;
     while (p < 2) {
-      int i = Utility::lookup(letters_, grid[p++]);
-      if (i < 0)
-        throw GeographicErr("Illegal prefix character " + gridref);
+      int i = Decoder::Index(decoder.letters, grid[p++]);
+      if (i < 0) {
+        if (!throwp) return false;
+        throw GeographicErr("Illegal prefix character " + string(gridref, n));
+      }
       yh = yh * tilegrid_ + tilegrid_ - (i / tilegrid_) - 1;
       xh = xh * tilegrid_ + (i % tilegrid_);
     }
@@ -132,10 +271,13 @@ namespace GeographicLib {
     for (int i = 0; i < prec1; ++i) {
       unit /= base_;
       int
-        ix = Utility::lookup(digits_, grid[p + i]),
-        iy = Utility::lookup(digits_, grid[p + i + prec1]);
-      if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + gridref);
+        ix = Decoder::Index(decoder.digits, grid[p + i]),
+        iy = Decoder::Index(decoder.digits, grid[p + i + prec1]);
+      if (ix < 0 || iy < 0) {
+        if (!throwp) return false;
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(gridref, n));
+      }
       x1 += unit * ix;
       y1 += unit * iy;
     }
@@ -146,22 +288,50 @@ namespace GeographicLib {
     x = x1;
     y = y1;
     prec = prec1;
+    return true;
+  }
+
+  size_t OSGB::GridReferenceBatch(const char* buf, const size_t offsets[],
+                                  size_t n, real x[], real y[], int prec[],
+                                  bool valid[], bool centerp) {
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const char* gridref = buf + offsets[i];
+      size_t len = offsets[i + 1] - offsets[i];
+      // Ignore a trailing newline (LF or CR LF).
+      if (len > 0 && gridref[len - 1] == '\n') --len;
+      if (len > 0 && gridref[len - 1] == '\r') --len;
+      bool ok = GridReference(gridref, len, x[i], y[i], prec[i],
+                              centerp, false);
+      if (!ok) {
+        x[i] = y[i] = Math::NaN();
+        prec[i] = -2;
+        ++nbad;
+      }
+      if (valid) valid[i] = ok;
+    }
+    return nbad;
   }
 
-  void OSGB::CheckCoords(real x, real y) {
+  bool OSGB::CheckCoords(real x, real y, bool throwp) {
     // Limits are all multiples of 100km and are all closed on the lower end
     // and open on the upper end -- and this is reflected in the error
     // messages.  NaNs are let through.
-    if (x < minx_ || x >= maxx_)
+    if (x < minx_ || x >= maxx_) {
+      if (!throwp) return false;
       throw GeographicErr("Easting " + Utility::str(int(floor(x/1000)))
                           + "km not in OSGB range ["
                           + Utility::str(minx_/1000) + "km, "
                           + Utility::str(maxx_/1000) + "km)");
-    if (y < miny_ || y >= maxy_)
+    }
+    if (y < miny_ || y >= maxy_) {
+      if (!throwp) return false;
       throw GeographicErr("Northing " + Utility::str(int(floor(y/1000)))
                           + "km not in OSGB range ["
                           + Utility::str(miny_/1000) + "km, "
                           + Utility::str(maxy_/1000) + "km)");
+    }
+    return true;
   }
 
 } // namespace GeographicLib
@@ -95,6 +95,106 @@ namespace GeographicLib {
     gamma = northp ? lon : -lon;
   }
 
+  void PolarStereographic::Forward(bool northp,
+                                   const real* lat, const real* lon, size_t n,
+                                   real* x, real* y, real* gamma, real* k)
+    const {
+    for (size_t i = 0; i < n; ++i) {
+      real gamma1, k1;
+      Forward(northp, lat[i], lon[i], x[i], y[i], gamma1, k1);
+      if (gamma) gamma[i] = gamma1;
+      if (k) k[i] = k1;
+    }
+  }
+
+  void PolarStereographic::Reverse(bool northp,
+                                   const real* x, const real* y, size_t n,
+                                   real* lat, real* lon,
+                                   real* gamma, real* k) const {
+    real s = 2 * _k0 * _a / _c;
+    real rho[nblock_], tau[nblock_];
+    for (size_t i0 = 0; i0 < n; i0 += nblock_) {
+      int nb = int((min)(size_t(nblock_), n - i0));
+      for (int i = 0; i < nb; ++i) {
+        rho[i] = Math::hypot(x[i0 + i], y[i0 + i]);
+        real t = rho[i] / s;
+        tau[i] = (1 / t - t) / 2;
+      }
+      Math::tauf(tau, tau, size_t(nb), _es);
+      for (int i = 0; i < nb; ++i) {
+        size_t j = i0 + i;
+        real
+          phi = atan(tau[i]),
+          lon1 = 0 - atan2( -x[j], northp ? -y[j] : y[j] ) / Math::degree();
+        if (k) {
+          real secphi = Math::hypot(real(1), tau[i]);
+          k[j] = rho[i] ?
+            (rho[i] / _a) * secphi * sqrt(_e2m + _e2 / Math::sq(secphi)) :
+            _k0;
+        }
+        lat[j] = (northp ? 1 : -1) * (rho[i] ? phi / Math::degree() : 90);
+        lon[j] = lon1;
+        if (gamma) gamma[j] = northp ? lon1 : -lon1;
+      }
+    }
+  }
+
+  void PolarStereographic::ForwardGrid(bool northp,
+                                       real lat0, real dlat, size_t nlat,
+                                       real lon0, real dlon, size_t nlon,
+                                       real* x, real* y,
+                                       real* gamma, real* k) const {
+    if (nlat == 0 || nlon == 0) return;
+    // Store the longitude dependent factors in the first row of x and y and
+    // then fill in the rows in reverse order so that the first row is
+    // overwritten last.
+    for (size_t j = 0; j < nlon; ++j) {
+      real lon = Math::AngNormalize(lon0 + real(j) * dlon),
+        lam = lon * Math::degree();
+      x[j] = lon == -180 ? 0 : sin(lam);
+      y[j] = abs(lon) == 90 ? 0 : cos(lam);
+      if (gamma) gamma[j] = northp ? lon : -lon;
+    }
+    for (size_t i = nlat; i--;) {
+      real lat = (northp ? 1 : -1) * (lat0 + real(i) * dlat);
+      real
+        tau = Math::tand(lat),
+        secphi = Math::hypot(real(1), tau),
+        taup = Math::taupf(tau, _es),
+        rho = Math::hypot(real(1), taup) + abs(taup);
+      rho = taup >= 0 ? (lat != 90 ? 1/rho : 0) : rho;
+      rho *= 2 * _k0 * _a / _c;
+      real k1 = lat != 90 ?
+        (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::sq(secphi)) : _k0,
+        rhoy = northp ? -rho : rho;
+      real* xi = x + i * nlon; real* yi = y + i * nlon;
+      for (size_t j = 0; j < nlon; ++j) {
+        xi[j] = rho * x[j];
+        yi[j] = rhoy * y[j];
+      }
+      if (gamma && i) copy(gamma, gamma + nlon, gamma + i * nlon);
+      if (k) fill(k + i * nlon, k + (i + 1) * nlon, k1);
+    }
+  }
+
+  void PolarStereographic::ReverseGrid(bool northp,
+                                       real x0, real dx, size_t nx,
+                                       real y0, real dy, size_t ny,
+                                       real* lat, real* lon,
+                                       real* gamma, real* k) const {
+    real xb[nblock_], yb[nblock_];
+    for (size_t i = 0; i < ny; ++i) {
+      real y1 = y0 + real(i) * dy;
+      for (int l = 0; l < nblock_; ++l) yb[l] = y1;
+      for (size_t j0 = 0; j0 < nx; j0 += nblock_) {
+        size_t nb = (min)(size_t(nblock_), nx - j0), o = i * nx + j0;
+        for (size_t l = 0; l < nb; ++l) xb[l] = x0 + real(j0 + l) * dx;
+        Reverse(northp, xb, yb, nb, lat + o, lon + o,
+                gamma ? gamma + o : 0, k ? k + o : 0);
+      }
+    }
+  }
+
   void PolarStereographic::SetScale(real lat, real k) {
     if (!(Math::isfinite(k) && k > 0))
       throw GeographicErr("Scale is not positive");
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Utility.hpp>
 
 namespace GeographicLib {
 
@@ -32,6 +33,35 @@ namespace GeographicLib {
     ++_num;
   }
 
+  template <class GeodType>
+  void PolygonAreaT<GeodType>::EdgeSums(const real lat[], const real lon[],
+                                        size_t i0, size_t i1,
+                                        Accumulator<>& perimeter,
+                                        Accumulator<>& area,
+                                        int& crossings,
+                                        real s12[], real S12[]) const {
+    // This is the same as AddPoint for the points i0 + 1 thru i1.
+    if (!(i0 < i1)) return;
+    real lat1 = lat[i0], lon1 = Math::AngNormalize(lon[i0]);
+    for (size_t i = i0 + 1; i <= i1; ++i) {
+      real lat2 = lat[i], lon2 = Math::AngNormalize(lon[i]), s, S, t;
+      _earth.GenInverse(lat1, lon1, lat2, lon2, _mask, s, t, t, t, t, t, S);
+      if (s12) {
+        s12[i - i0 - 1] = s; S12[i - i0 - 1] = S;
+      } else {
+        perimeter += s;
+        if (!_polyline) area += S;
+      }
+      if (!_polyline)
+        crossings += transit(lon1, lon2);
+      lat1 = lat2; lon1 = lon2;
+    }
+    if (s12) {
+      perimeter.AddArray(s12, i1 - i0);
+      if (!_polyline) area.AddArray(S12, i1 - i0);
+    }
+  }
+
   template <class GeodType>
   void PolygonAreaT<GeodType>::AddEdge(real azi, real s) {
     if (_num) {                 // Do nothing if _num is zero
@@ -68,7 +98,16 @@ namespace GeographicLib {
     perimeter = _perimetersum(s12);
     Accumulator<> tempsum(_areasum);
     tempsum += S12;
-    int crossings = _crossings + transit(_lon1, _lon0);
+    area = ReduceArea(tempsum, _crossings + transit(_lon1, _lon0),
+                      reverse, sign);
+    return _num;
+  }
+
+  template <class GeodType>
+  Math::real PolygonAreaT<GeodType>::ReduceArea(Accumulator<>& tempsum,
+                                                int crossings,
+                                                bool reverse, bool sign)
+    const {
     if (crossings & 1)
       tempsum += (tempsum < 0 ? 1 : -1) * _area0/2;
     // area is with the clockwise sense.  If !reverse convert to
@@ -87,41 +126,67 @@ namespace GeographicLib {
       else if (tempsum < 0)
         tempsum += _area0;
     }
-    area = 0 + tempsum();
-    return _num;
+    return 0 + tempsum();
   }
 
   template <class GeodType>
-  unsigned PolygonAreaT<GeodType>::TestPoint(real lat, real lon,
-                                             bool reverse, bool sign,
-                                             real& perimeter, real& area) const
-  {
-    if (_num == 0) {
+  void PolygonAreaT<GeodType>::ComputeOne(const real lat[], const real lon[],
+                                          size_t n, bool reverse, bool sign,
+                                          real& perimeter, real& area) const {
+    // This is the same as Clear, AddPoint for each point, and Compute.
+    if (n < 2) {
       perimeter = 0;
       if (!_polyline)
         area = 0;
-      return 1;
+      return;
     }
-    perimeter = _perimetersum();
-    real tempsum = _polyline ? 0 : _areasum();
-    int crossings = _crossings;
-    unsigned num = _num + 1;
-    for (int i = 0; i < (_polyline ? 1 : 2); ++i) {
-      real s12, S12, t;
-      _earth.GenInverse(i == 0 ? _lat1 : lat, i == 0 ? _lon1 : lon,
-                        i != 0 ? _lat0 : lat, i != 0 ? _lon0 : lon,
-                        _mask, s12, t, t, t, t, t, S12);
-      perimeter += s12;
-      if (!_polyline) {
-        tempsum += S12;
-        crossings += transit(i == 0 ? _lon1 : lon,
-                             i != 0 ? _lon0 : lon);
-      }
+    Accumulator<> perimetersum, areasum;
+    int crossings = 0;
+    EdgeSums(lat, lon, 0, n - 1, perimetersum, areasum, crossings);
+    if (_polyline) {
+      perimeter = perimetersum();
+      return;
     }
+    real
+      lat1 = lat[n - 1], lon1 = Math::AngNormalize(lon[n - 1]),
+      lat0 = lat[0], lon0 = Math::AngNormalize(lon[0]),
+      s12, S12, t;
+    _earth.GenInverse(lat1, lon1, lat0, lon0, _mask, s12, t, t, t, t, t, S12);
+    perimeter = perimetersum(s12);
+    areasum += S12;
+    area = ReduceArea(areasum, crossings + transit(lon1, lon0), reverse, sign);
+  }
 
-    if (_polyline)
-      return num;
+  template <class GeodType>
+  void PolygonAreaT<GeodType>::CellAreas(const real lat[], size_t nlat,
+                                         real dlon, real area[]) const {
+    if (!(dlon > 0 && dlon < 180))
+      throw GeographicErr("Cell width " + Utility::str(dlon)
+                          + "d not in (0d, 180d)");
+    // The area of cell k is S(lat[k]) - S(lat[k+1]), where S(lat) is the area
+    // under the line from (lat, 0) to (lat, dlon); the meridians contribute
+    // nothing and reversing a line changes the sign of its area.
+    real s12, S0, S1, t;
+    unsigned mask = GeodType::AREA;
+    for (size_t k = 0; k + 1 < nlat; ++k) {
+      if (k == 0)
+        _earth.GenInverse(lat[0], 0, lat[0], dlon, mask,
+                          s12, t, t, t, t, t, S0);
+      _earth.GenInverse(lat[k + 1], 0, lat[k + 1], dlon, mask,
+                        s12, t, t, t, t, t, S1);
+      Accumulator<> areasum(S0);
+      areasum += -S1;
+      area[k] = ReduceArea(areasum, 0, false, true);
+      S0 = S1;
+    }
+  }
 
+  template <class GeodType>
+  Math::real PolygonAreaT<GeodType>::ReduceArea(real tempsum, int crossings,
+                                                bool reverse, bool sign)
+    const {
+    // The same as ReduceArea(Accumulator<>&, ...) with ordinary floating
+    // point arithmetic.
     if (crossings & 1)
       tempsum += (tempsum < 0 ? 1 : -1) * _area0/2;
     // area is with the clockwise sense.  If !reverse convert to
@@ -140,26 +205,44 @@ namespace GeographicLib {
       else if (tempsum < 0)
         tempsum += _area0;
     }
-    area = 0 + tempsum;
-    return num;
+    return 0 + tempsum;
   }
 
   template <class GeodType>
-  unsigned PolygonAreaT<GeodType>::TestEdge(real azi, real s,
-                                            bool reverse, bool sign,
-                                            real& perimeter, real& area) const {
-    if (_num == 0) {            // we don't have a starting point!
-      perimeter = Math::NaN();
-      if (!_polyline)
-        area = Math::NaN();
-      return 0;
+  void PolygonAreaT<GeodType>::TestPointSums(real lat, real lon,
+                                             real perimeter0, real area0,
+                                             bool reverse, bool sign,
+                                             real& perimeter, real& area)
+    const {
+    perimeter = perimeter0;
+    real tempsum = area0;
+    int crossings = _crossings;
+    for (int i = 0; i < (_polyline ? 1 : 2); ++i) {
+      real s12, S12, t;
+      _earth.GenInverse(i == 0 ? _lat1 : lat, i == 0 ? _lon1 : lon,
+                        i != 0 ? _lat0 : lat, i != 0 ? _lon0 : lon,
+                        _mask, s12, t, t, t, t, t, S12);
+      perimeter += s12;
+      if (!_polyline) {
+        tempsum += S12;
+        crossings += transit(i == 0 ? _lon1 : lon,
+                             i != 0 ? _lon0 : lon);
+      }
     }
-    unsigned num = _num + 1;
-    perimeter = _perimetersum() + s;
-    if (_polyline)
-      return num;
+    if (!_polyline)
+      area = ReduceArea(tempsum, crossings, reverse, sign);
+  }
 
-    real tempsum =  _areasum();
+  template <class GeodType>
+  void PolygonAreaT<GeodType>::TestEdgeSums(real azi, real s,
+                                            real perimeter0, real area0,
+                                            bool reverse, bool sign,
+                                            real& perimeter, real& area)
+    const {
+    perimeter = perimeter0 + s;
+    if (_polyline)
+      return;
+    real tempsum = area0;
     int crossings = _crossings;
     {
       real lat, lon, s12, S12, t;
@@ -173,31 +256,43 @@ namespace GeographicLib {
       tempsum += S12;
       crossings += transit(lon, _lon0);
     }
+    area = ReduceArea(tempsum, crossings, reverse, sign);
+  }
 
-    if (crossings & 1)
-      tempsum += (tempsum < 0 ? 1 : -1) * _area0/2;
-    // area is with the clockwise sense.  If !reverse convert to
-    // counter-clockwise convention.
-    if (!reverse)
-      tempsum *= -1;
-    // If sign put area in (-area0/2, area0/2], else put area in [0, area0)
-    if (sign) {
-      if (tempsum > _area0/2)
-        tempsum -= _area0;
-      else if (tempsum <= -_area0/2)
-        tempsum += _area0;
-    } else {
-      if (tempsum >= _area0)
-        tempsum -= _area0;
-      else if (tempsum < 0)
-        tempsum += _area0;
+  template <class GeodType>
+  unsigned PolygonAreaT<GeodType>::TestPoint(real lat, real lon,
+                                             bool reverse, bool sign,
+                                             real& perimeter, real& area) const
+  {
+    if (_num == 0) {
+      perimeter = 0;
+      if (!_polyline)
+        area = 0;
+      return 1;
+    }
+    TestPointSums(lat, lon, _perimetersum(), _polyline ? 0 : _areasum(),
+                  reverse, sign, perimeter, area);
+    return _num + 1;
+  }
+
+  template <class GeodType>
+  unsigned PolygonAreaT<GeodType>::TestEdge(real azi, real s,
+                                            bool reverse, bool sign,
+                                            real& perimeter, real& area) const {
+    if (_num == 0) {            // we don't have a starting point!
+      perimeter = Math::NaN();
+      if (!_polyline)
+        area = Math::NaN();
+      return 0;
     }
-    area = 0 + tempsum;
-    return num;
+    TestEdgeSums(azi, s, _perimetersum(), _polyline ? 0 : _areasum(),
+                 reverse, sign, perimeter, area);
+    return _num + 1;
   }
 
   template class GEOGRAPHICLIB_EXPORT PolygonAreaT<Geodesic>;
   template class GEOGRAPHICLIB_EXPORT PolygonAreaT<GeodesicExact>;
   template class GEOGRAPHICLIB_EXPORT PolygonAreaT<Rhumb>;
+  template class GEOGRAPHICLIB_EXPORT PolygonAreaT<AuthalicSphere>;
 
 } // namespace GeographicLib
@@ -0,0 +1,29 @@
+/**
+ * \file Projector.cpp
+ * \brief Implementation for GeographicLib::Projector and related classes
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <GeographicLib/Projector.hpp>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  Projector::~Projector() {}
+
+  void Reprojector::operator()(const real x[], const real y[], size_t n,
+                               real u[], real v[]) const {
+    real lat[block_], lon[block_];
+    for (size_t i0 = 0; i0 < n; i0 += block_) {
+      size_t nb = min(size_t(block_), n - i0);
+      _from.ReverseBatch(x + i0, y + i0, nb, lat, lon);
+      _to.ForwardBatch(lat, lon, nb, u + i0, v + i0);
+    }
+  }
+
+} // namespace GeographicLib
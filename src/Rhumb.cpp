@@ -10,16 +10,22 @@
 
 #include <algorithm>
 #include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/Utility.hpp>
 
 namespace GeographicLib {
 
   using namespace std;
 
-  Rhumb::Rhumb(real a, real f, bool exact)
+  Rhumb::Rhumb(real a, real f, bool exact, int order)
     : _ell(a, f)
     , _exact(exact)
     , _c2(_ell.Area() / 720)
+    , _nR(order)
+    , _nA(-1)
   {
+    if (!(_nR >= 0 && _nR <= maxpow_))
+      throw GeographicErr("Order of area series not in [0, "
+                          + Utility::str(maxpow_) + "]");
     // Generated by Maxima on 2015-05-15 08:24:04-04:00
 #if GEOGRAPHICLIB_RHUMBAREA_ORDER == 4
     static const real coeff[] = {
@@ -137,6 +143,64 @@ namespace GeographicLib {
       d *= _ell._n;
     }
     // Post condition: o == sizeof(alpcoeff) / sizeof(real)
+    // Speed up the conversions to and from the rectifying latitude (by
+    // RhumbLine and ExactSeries).
+    _ell._ell.PrecomputeSeries();
+    if (_exact)
+      ExactSeries();
+  }
+
+  void Rhumb::ExactSeries() {
+    // Sample mu - chi at chi[j] = j*pi/(2*n) and chi - mu at mu[j] =
+    // j*pi/(2*n) for j in [1, n), computing the latitudes with
+    // Ellipsoid::RectifyingLatitude, etc.; the discrete sine transforms of
+    // the samples give the coefficients of sin(2*k*x) for k in [1, n).  As
+    // in EllipticFunction::PrecomputeSeries, double n until the
+    // coefficients with k >= n/2 are negligible.  The truncation error is
+    // then less than epsilon.
+    real tol = numeric_limits<real>::epsilon();
+    vector<real> f(2 * maxsamples_), sinx(2 * maxsamples_);
+    _A.resize(maxsamples_);
+    _B.resize(maxsamples_);
+    for (int n = 16; n <= maxsamples_; n *= 2) {
+      for (int j = 1; j < n; ++j) {
+        real
+          x = j * Math::pi() / (2 * n),
+          xd = j * real(90) / n,
+          // chi = x
+          phi = Math::atand(Math::tauf(Math::tand(xd), _ell._es));
+        f[j] = _ell.RectifyingLatitude(phi) * Math::degree() - x;
+        // mu = x
+        phi = _ell.InverseRectifyingLatitude(xd);
+        f[n + j] = x - atan(Math::taupf(Math::tand(phi), _ell._es));
+      }
+      for (int l = 0; l < 2 * n; ++l)
+        // sin(l*pi/n)
+        sinx[l] = l % n == 0 ? 0 : sin(l * Math::pi() / n);
+      int nt = 0;
+      for (int k = 1; k < n; ++k) {
+        real a = 0, b = 0;
+        for (int j = 1; j < n; ++j) {
+          real t = sinx[(k * j) % (2 * n)];
+          a += f[j] * t;
+          b += f[n + j] * t;
+        }
+        _A[k] = 2 * a / n;
+        _B[k] = 2 * b / n;
+        if (max(abs(_A[k]), abs(_B[k])) >= tol)
+          nt = k;
+      }
+      if (nt < n/2) {
+        _nA = nt;
+        _A.resize(_nA + 1);
+        _B.resize(_nA + 1);
+        return;
+      }
+    }
+    // The series don't converge; use the addition theorem for the elliptic
+    // integrals instead.
+    _A.clear();
+    _B.clear();
   }
 
   const Rhumb& Rhumb::WGS84() {
@@ -147,10 +211,17 @@ namespace GeographicLib {
   void Rhumb::GenInverse(real lat1, real lon1, real lat2, real lon2,
                          unsigned outmask,
                          real& s12, real& azi12, real& S12) const {
+    InverseIsometric(Math::AngDiff(Math::AngNormalize(lon1),
+                                   Math::AngNormalize(lon2)),
+                     _ell.IsometricLatitude(lat1),
+                     _ell.IsometricLatitude(lat2),
+                     outmask, s12, azi12, S12);
+  }
+
+  void Rhumb::InverseIsometric(real lon12, real psi1, real psi2,
+                               unsigned outmask,
+                               real& s12, real& azi12, real& S12) const {
     real
-      lon12 = Math::AngDiff(Math::AngNormalize(lon1), Math::AngNormalize(lon2)),
-      psi1 = _ell.IsometricLatitude(lat1),
-      psi2 = _ell.IsometricLatitude(lat2),
       psi12 = psi2 - psi1,
       h = Math::hypot(lon12, psi12);
     if (outmask & AZIMUTH)
@@ -164,6 +235,38 @@ namespace GeographicLib {
         MeanSinXi(psi2 * Math::degree(), psi1 * Math::degree());
   }
 
+  void Rhumb::GenInverseBatch(const real* lat1, const real* lon1,
+                              const real* lat2, const real* lon2, size_t n,
+                              unsigned outmask,
+                              real* s12, real* azi12, real* S12) const {
+    bool
+      distp = (outmask & DISTANCE) != 0U,
+      azip = (outmask & AZIMUTH) != 0U,
+      areap = (outmask & AREA) != 0U;
+    // The isometric latitudes are reused when the latitude is unchanged.
+    // Zero latitudes are excluded from the comparisons, because lat = -0 and
+    // lat = +0 give psi with different signs (which determine the azimuth of
+    // an east-west line).  NaNs never compare equal.
+    real
+      la1 = Math::NaN(), psi1 = Math::NaN(),
+      la2 = Math::NaN(), psi2 = Math::NaN(),
+      ts12, tazi12, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      if (!(lat1[i] == la1 && la1 != 0)) {
+        la1 = lat1[i]; psi1 = _ell.IsometricLatitude(la1);
+      }
+      if (!(lat2[i] == la2 && la2 != 0)) {
+        la2 = lat2[i]; psi2 = _ell.IsometricLatitude(la2);
+      }
+      InverseIsometric(Math::AngDiff(Math::AngNormalize(lon1[i]),
+                                     Math::AngNormalize(lon2[i])),
+                       psi1, psi2, outmask, ts12, tazi12, tS12);
+      if (distp) s12[i] = ts12;
+      if (azip) azi12[i] = tazi12;
+      if (areap) S12[i] = tS12;
+    }
+  }
+
   RhumbLine Rhumb::Line(real lat1, real lon1, real azi12) const
   { return RhumbLine(*this, lat1, lon1, azi12, _exact); }
 
@@ -172,6 +275,34 @@ namespace GeographicLib {
                         real& lat2, real& lon2, real& S12) const
   { Line(lat1, lon1, azi12).GenPosition(s12, outmask, lat2, lon2, S12); }
 
+  void Rhumb::GenDirectBatch(const real* lat1, const real* lon1,
+                             const real* azi12, const real* s12, size_t n,
+                             unsigned outmask,
+                             real* lat2, real* lon2, real* S12) const {
+    if (n == 0) return;
+    bool
+      latp = (outmask & LATITUDE) != 0U,
+      lonp = (outmask & LONGITUDE) != 0U,
+      areap = (outmask & AREA) != 0U;
+    RhumbLine line(Line(lat1[0], lon1[0], azi12[0]));
+    real tlat2, tlon2, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      if (i > 0) {
+        // Only the longitude needs to be updated if lat1 and azi12 are
+        // unchanged; exclude zeros for the reason given in GenInverseBatch.
+        if (lat1[i] == line._lat1 && line._lat1 != 0 &&
+            azi12[i] == azi12[i-1] && azi12[i] != 0)
+          line._lon1 = lon1[i];
+        else
+          line.Init(lat1[i], lon1[i], azi12[i]);
+      }
+      line.GenPosition(s12[i], outmask, tlat2, tlon2, tS12);
+      if (latp) lat2[i] = tlat2;
+      if (lonp) lon2[i] = tlon2;
+      if (areap) S12[i] = tS12;
+    }
+  }
+
   Math::real Rhumb::DE(real x, real y) const {
     const EllipticFunction& ei = _ell._ell;
     real d = x - y;
@@ -289,17 +420,21 @@ namespace GeographicLib {
   }
 
   Math::real Rhumb::DConformalToRectifying(real chix, real chiy) const {
-    return 1 + SinCosSeries(true, chix, chiy,
-                            _ell.ConformalToRectifyingCoeffs(), tm_maxord);
+    return 1 + (_nA >= 0 ?
+                SinCosSeries(true, chix, chiy, &_A[0], _nA) :
+                SinCosSeries(true, chix, chiy,
+                             _ell.ConformalToRectifyingCoeffs(), tm_maxord));
   }
 
   Math::real Rhumb::DRectifyingToConformal(real mux, real muy) const {
-    return 1 - SinCosSeries(true, mux, muy,
-                            _ell.RectifyingToConformalCoeffs(), tm_maxord);
+    return 1 - (_nA >= 0 ?
+                SinCosSeries(true, mux, muy, &_B[0], _nA) :
+                SinCosSeries(true, mux, muy,
+                             _ell.RectifyingToConformalCoeffs(), tm_maxord));
   }
 
   Math::real Rhumb::DIsometricToRectifying(real psix, real psiy) const {
-    if (_exact) {
+    if (_exact && _nA < 0) {
       real
         latx = _ell.InverseIsometricLatitude(psix),
         laty = _ell.InverseIsometricLatitude(psiy);
@@ -312,10 +447,15 @@ namespace GeographicLib {
   }
 
   Math::real Rhumb::DRectifyingToIsometric(real mux, real muy) const {
-    real
-      latx = _ell.InverseRectifyingLatitude(mux/Math::degree()),
-      laty = _ell.InverseRectifyingLatitude(muy/Math::degree());
-    return _exact ?
+    return DRectifyingToIsometric
+      (mux, muy,
+       _ell.InverseRectifyingLatitude(mux/Math::degree()),
+       _ell.InverseRectifyingLatitude(muy/Math::degree()));
+  }
+
+  Math::real Rhumb::DRectifyingToIsometric(real mux, real muy,
+                                           real latx, real laty) const {
+    return _exact && _nA < 0 ?
       DIsometric(latx, laty) / DRectifying(latx, laty) :
       Dgdinv(Math::taupf(Math::tand(latx), _ell._es),
              Math::taupf(Math::tand(laty), _ell._es)) *
@@ -324,23 +464,29 @@ namespace GeographicLib {
 
   Math::real Rhumb::MeanSinXi(real psix, real psiy) const {
     return Dlog(cosh(psix), cosh(psiy)) * Dcosh(psix, psiy)
-      + SinCosSeries(false, gd(psix), gd(psiy), _R, maxpow_) * Dgd(psix, psiy);
+      + SinCosSeries(false, gd(psix), gd(psiy), _R, _nR) * Dgd(psix, psiy);
   }
 
   RhumbLine::RhumbLine(const Rhumb& rh, real lat1, real lon1, real azi12,
                        bool exact)
     : _rh(rh)
     , _exact(exact)
-    , _lat1(lat1)
-    , _lon1(lon1)
-    , _azi12(Math::AngNormalize(azi12))
-  {
+  { Init(lat1, lon1, azi12); }
+
+  void RhumbLine::Init(real lat1, real lon1, real azi12) {
+    _lat1 = lat1;
+    _lon1 = lon1;
+    _azi12 = Math::AngNormalize(azi12);
     real alp12 = _azi12 * Math::degree();
     _salp =     _azi12  == -180 ? 0 : sin(alp12);
     _calp = abs(_azi12) ==   90 ? 0 : cos(alp12);
     _mu1 = _rh._ell.RectifyingLatitude(lat1);
     _psi1 = _rh._ell.IsometricLatitude(lat1);
     _r1 = _rh._ell.CircleRadius(lat1);
+    // Needed by GenPosition (unless the line runs east-west).
+    _lat1mu = _calp ?
+      _rh._ell.InverseRectifyingLatitude((_mu1 * Math::degree()) /
+                                         Math::degree()) : _lat1;
   }
 
   void RhumbLine::GenPosition(real s12, unsigned outmask,
@@ -352,8 +498,13 @@ namespace GeographicLib {
     if (abs(mu2) <= 90) {
       if (_calp) {
         lat2x = _rh._ell.InverseRectifyingLatitude(mu2);
-        real psi12 = _rh.DRectifyingToIsometric(  mu2 * Math::degree(),
-                                                 _mu1 * Math::degree()) * mu12;
+        // Reuse lat2x in DRectifyingToIsometric if the conversion of mu2 to
+        // radians and back is exact (this is usually the case).
+        real mux = mu2 * Math::degree(), mu2x = mux / Math::degree();
+        real psi12 = _rh.DRectifyingToIsometric
+          (mux, _mu1 * Math::degree(),
+           mu2x == mu2 ? lat2x : _rh._ell.InverseRectifyingLatitude(mu2x),
+           _lat1mu) * mu12;
         lon2x = _salp * psi12 / _calp;
         psi2 = _psi1 + psi12;
       } else {
@@ -380,4 +531,35 @@ namespace GeographicLib {
     if (outmask & LONGITUDE) lon2 = lon2x;
   }
 
+  void RhumbLine::GenPositions(const real* s12, size_t n, unsigned outmask,
+                               real* lat2, real* lon2, real* S12) const {
+    bool
+      latp = (outmask & LATITUDE) != 0U,
+      lonp = (outmask & LONGITUDE) != 0U,
+      areap = (outmask & AREA) != 0U;
+    real tlat2, tlon2, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      GenPosition(s12[i], outmask, tlat2, tlon2, tS12);
+      if (latp) lat2[i] = tlat2;
+      if (lonp) lon2[i] = tlon2;
+      if (areap) S12[i] = tS12;
+    }
+  }
+
+  void RhumbLine::UniformPositions(real s12, real ds12, size_t n,
+                                   unsigned outmask,
+                                   real* lat2, real* lon2, real* S12) const {
+    bool
+      latp = (outmask & LATITUDE) != 0U,
+      lonp = (outmask & LONGITUDE) != 0U,
+      areap = (outmask & AREA) != 0U;
+    real tlat2, tlon2, tS12;
+    for (size_t i = 0; i < n; ++i) {
+      GenPosition(s12 + real(i) * ds12, outmask, tlat2, tlon2, tS12);
+      if (latp) lat2[i] = tlat2;
+      if (lonp) lon2[i] = tlon2;
+      if (areap) S12[i] = tS12;
+    }
+  }
+
 } // namespace GeographicLib
@@ -131,8 +131,24 @@
  **********************************************************************/
 
 #include <GeographicLib/SphericalEngine.hpp>
+#include <cstring>
 #include <GeographicLib/CircularEngine.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Instrumentation.hpp>
+
+#if !defined(GEOGRAPHICLIB_SPHERICALENGINE_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_SPHERICALENGINE_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_SPHERICALENGINE_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+#  include <atomic>
+#  include <mutex>
+#  include <GeographicLib/Executor.hpp>
+#endif
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions and potentially
@@ -144,18 +160,46 @@ namespace GeographicLib {
 
   using namespace std;
 
-  const vector<Math::real> SphericalEngine::Z_(0);
-  vector<Math::real> SphericalEngine::root_(0);
+  namespace {
+    // The table of square roots.  This is only ever replaced by a larger
+    // table and the earlier tables are retained (until ClearRootTable is
+    // called).  So a pointer to the table obtained by a thread remains valid
+    // even if another thread enlarges the table; and because a thread calls
+    // RootTable (via the coeff constructor) before using the table, the table
+    // it sees is large enough.  The current table is published with a
+    // release store of its size, so that readers can check the size without
+    // a lock.
+    vector<Math::real*> roottables_;
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    atomic<const Math::real*> roottable_(0);
+    atomic<int> rootsize_(0);
+    mutex rootmutex_;
+#else
+    const Math::real* roottable_ = 0;
+    int rootsize_ = 0;
+#endif
+  }
+
+  const Math::real* SphericalEngine::roots() {
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    return roottable_.load(memory_order_acquire);
+#else
+    return roottable_;
+#endif
+  }
 
   template<bool gradp, SphericalEngine::normalization norm, int L>
   Math::real SphericalEngine::Value(const coeff c[], const real f[],
                                     real x, real y, real z, real a,
                                     real& gradx, real& grady, real& gradz)
     {
+    GEOGRAPHICLIB_SPAN(SPHERICAL_VALUE);
+    const real* root_ = roots();
     GEOGRAPHICLIB_STATIC_ASSERT(L > 0, "L must be positive");
     GEOGRAPHICLIB_STATIC_ASSERT(norm == FULL || norm == SCHMIDT,
                                 "Unknown normalization");
     int N = c[0].nmx(), M = c[0].mmx();
+    const real* AB = c[0].AB();
 
     real
       p = Math::hypot(x, y),
@@ -185,24 +229,31 @@ namespace GeographicLib {
       real wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
       for (int l = 0; l < L; ++l)
         k[l] = c[l].index(N, m) + 1;
+      // The recursion factors for order m (indexed by n)
+      const real* ABm = AB ? AB + 2 * (m * N - m * (m - 1) / 2) : 0;
       for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
         real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
-        switch (norm) {
-        case FULL:
-          w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
-          Ax = q * w * root_[2 * n + 3];
-          A = t * Ax;
-          B = - q2 * root_[2 * n + 5] /
-            (w * root_[n - m + 2] * root_[n + m + 2]);
-          break;
-        case SCHMIDT:
-          w = root_[n - m + 1] * root_[n + m + 1];
-          Ax = q * (2 * n + 1) / w;
+        if (ABm) {
+          Ax = q * ABm[2 * n];
           A = t * Ax;
-          B = - q2 * w / (root_[n - m + 2] * root_[n + m + 2]);
-          break;
-        default: break;       // To suppress warning message from Visual Studio
-        }
+          B = q2 * ABm[2 * n + 1];
+        } else
+          switch (norm) {
+          case FULL:
+            w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+            Ax = q * w * root_[2 * n + 3];
+            A = t * Ax;
+            B = - q2 * root_[2 * n + 5] /
+              (w * root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          case SCHMIDT:
+            w = root_[n - m + 1] * root_[n + m + 1];
+            Ax = q * (2 * n + 1) / w;
+            A = t * Ax;
+            B = - q2 * w / (root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
         R = c[0].Cv(--k[0]);
         for (int l = 1; l < L; ++l)
           R += c[l].Cv(--k[l], n, m, f[l]);
@@ -291,49 +342,442 @@ namespace GeographicLib {
   }
 
   template<bool gradp, SphericalEngine::normalization norm, int L>
-  CircularEngine SphericalEngine::Circle(const coeff c[], const real f[],
-                                         real p, real z, real a) {
+  GEOGRAPHICLIB_TARGET_CLONES
+  void SphericalEngine::Value(const coeff c[], const real f[], int K,
+                              const real x[], const real y[], const real z[],
+                              real a, real v[],
+                              real gradx[], real grady[], real gradz[]) {
+    GEOGRAPHICLIB_SPAN(SPHERICAL_VALUE);
+    const real* root_ = roots();
+    // This is the same computation as the single point version of Value
+    // (including the order of the floating point operations, so that the
+    // results are identical), except that the Clenshaw recursions for up to
+    // npoints_ points are carried out together.  The coefficients and the
+    // quantities involving root_ are fetched once for all the points.
+    GEOGRAPHICLIB_STATIC_ASSERT(L > 0, "L must be positive");
+    GEOGRAPHICLIB_STATIC_ASSERT(norm == FULL || norm == SCHMIDT,
+                                "Unknown normalization");
+    int N = c[0].nmx(), M = c[0].mmx();
+    const real* AB = c[0].AB();
+    const int nb = npoints_;
+    for (int i0 = 0; i0 < K; i0 += nb) {
+      int nk = min(nb, K - i0);
+      real cl[nb], sl[nb], r[nb], t[nb], u[nb], q[nb], q2[nb], uq[nb],
+        uq2[nb], tu[nb];
+      // The outer sums for each point
+      real vc [nb], vc2 [nb], vs [nb], vs2 [nb];
+      real vrc[nb], vrc2[nb], vrs[nb], vrs2[nb];
+      real vtc[nb], vtc2[nb], vts[nb], vts2[nb];
+      real vlc[nb], vlc2[nb], vls[nb], vls2[nb];
+      for (int j = 0; j < nk; ++j) {
+        real
+          xj = x[i0 + j], yj = y[i0 + j], zj = z[i0 + j],
+          p = Math::hypot(xj, yj);
+        cl[j] = p ? xj / p : 1;  // cos(lambda); at pole, pick lambda = 0
+        sl[j] = p ? yj / p : 0;  // sin(lambda)
+        r[j] = Math::hypot(zj, p);
+        t[j] = r[j] ? zj / r[j] : 0; // cos(theta); at origin, theta = pi/2
+        u[j] = r[j] ? max(p / r[j], eps()) : 1; // sin(theta); avoid the pole
+        q[j] = a / r[j];
+        q2[j] = Math::sq(q[j]);
+        uq[j] = u[j] * q[j];
+        uq2[j] = Math::sq(uq[j]);
+        tu[j] = t[j] / u[j];
+        vc [j] = vc2 [j] = vs [j] = vs2 [j] = 0;
+        vrc[j] = vrc2[j] = vrs[j] = vrs2[j] = 0;
+        vtc[j] = vtc2[j] = vts[j] = vts2[j] = 0;
+        vlc[j] = vlc2[j] = vls[j] = vls2[j] = 0;
+      }
+      int k[L];
+      for (int m = M; m >= 0; --m) {   // m = M .. 0
+        // The inner sums for each point
+        real wc [nb], wc2 [nb], ws [nb], ws2 [nb];
+        real wrc[nb], wrc2[nb], wrs[nb], wrs2[nb];
+        real wtc[nb], wtc2[nb], wts[nb], wts2[nb];
+        for (int j = 0; j < nk; ++j) {
+          wc [j] = wc2 [j] = ws [j] = ws2 [j] = 0;
+          wrc[j] = wrc2[j] = wrs[j] = wrs2[j] = 0;
+          wtc[j] = wtc2[j] = wts[j] = wts2[j] = 0;
+        }
+        for (int l = 0; l < L; ++l)
+          k[l] = c[l].index(N, m) + 1;
+        const real* ABm = AB ? AB + 2 * (m * N - m * (m - 1) / 2) : 0;
+        for (int n = N; n >= m; --n) {           // n = N .. m; l = N - m .. 0
+          real w, d, r3, r5, Rc, Rs = 0;
+          if (ABm) {
+            w = ABm[2 * n]; d = ABm[2 * n + 1];
+          } else {
+            switch (norm) {
+            case FULL:
+              w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+              d = w * root_[n - m + 2] * root_[n + m + 2];
+              break;
+            case SCHMIDT:
+              w = root_[n - m + 1] * root_[n + m + 1];
+              d = root_[n - m + 2] * root_[n + m + 2];
+              break;
+            default: break;   // To suppress warning message from Visual Studio
+            }
+            r3 = root_[2 * n + 3]; r5 = root_[2 * n + 5];
+          }
+          Rc = c[0].Cv(--k[0]);
+          for (int l = 1; l < L; ++l)
+            Rc += c[l].Cv(--k[l], n, m, f[l]);
+          Rc *= scale();
+          if (m) {
+            Rs = c[0].Sv(k[0]);
+            for (int l = 1; l < L; ++l)
+              Rs += c[l].Sv(k[l], n, m, f[l]);
+            Rs *= scale();
+          }
+          real A[nb], B[nb], uAx[nb]; // alpha[l], beta[l + 1], u*alpha[l]/t
+          for (int j = 0; j < nk; ++j) {
+            real Ax, s;
+            if (ABm) {
+              // w and d hold the precomputed factors a[n,m] and b[n,m]
+              Ax = q[j] * w;
+              B[j] = q2[j] * d;
+            } else
+              switch (norm) {
+              case FULL:
+                Ax = q[j] * w * r3;
+                B[j] = - q2[j] * r5 / d;
+                break;
+              case SCHMIDT:
+                Ax = q[j] * (2 * n + 1) / w;
+                B[j] = - q2[j] * w / d;
+                break;
+              default: break; // To suppress warning message from Visual Studio
+              }
+            A[j] = t[j] * Ax;
+            uAx[j] = u[j]*Ax;
+            s = A[j] * wc[j] + B[j] * wc2[j] + Rc; wc2[j] = wc[j]; wc[j] = s;
+            if (gradp) {
+              s = A[j] * wrc[j] + B[j] * wrc2[j] + (n + 1) * Rc;
+              wrc2[j] = wrc[j]; wrc[j] = s;
+              s = A[j] * wtc[j] + B[j] * wtc2[j] - uAx[j] * wc2[j];
+              wtc2[j] = wtc[j]; wtc[j] = s;
+            }
+          }
+          if (m) {
+            for (int j = 0; j < nk; ++j) {
+              real s;
+              s = A[j] * ws[j] + B[j] * ws2[j] + Rs; ws2[j] = ws[j]; ws[j] = s;
+              if (gradp) {
+                s = A[j] * wrs[j] + B[j] * wrs2[j] + (n + 1) * Rs;
+                wrs2[j] = wrs[j]; wrs[j] = s;
+                s = A[j] * wts[j] + B[j] * wts2[j] - uAx[j] * ws2[j];
+                wts2[j] = wts[j]; wts[j] = s;
+              }
+            }
+          }
+        }
+        if (m) {
+          real vv, Bv;
+          switch (norm) {
+          case FULL:
+            vv = root_[2] * root_[2 * m + 3] / root_[m + 1];
+            Bv = - vv * root_[2 * m + 5] / (root_[8] * root_[m + 2]);
+            break;
+          case SCHMIDT:
+            vv = root_[2] * root_[2 * m + 1] / root_[m + 1];
+            Bv = - vv * root_[2 * m + 3] / (root_[8] * root_[m + 2]);
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+          for (int j = 0; j < nk; ++j) {
+            real
+              A = cl[j] * vv * uq[j], // alpha[m]
+              B = Bv * uq2[j],        // beta[m + 1]
+              s;
+            s = A * vc [j] + B * vc2 [j] + wc [j]; vc2 [j] = vc [j]; vc [j] = s;
+            s = A * vs [j] + B * vs2 [j] + ws [j]; vs2 [j] = vs [j]; vs [j] = s;
+            if (gradp) {
+              wtc[j] += m * tu[j] * wc[j]; wts[j] += m * tu[j] * ws[j];
+              s = A * vrc[j] + B * vrc2[j] + wrc[j];
+              vrc2[j] = vrc[j]; vrc[j] = s;
+              s = A * vrs[j] + B * vrs2[j] + wrs[j];
+              vrs2[j] = vrs[j]; vrs[j] = s;
+              s = A * vtc[j] + B * vtc2[j] + wtc[j];
+              vtc2[j] = vtc[j]; vtc[j] = s;
+              s = A * vts[j] + B * vts2[j] + wts[j];
+              vts2[j] = vts[j]; vts[j] = s;
+              s = A * vlc[j] + B * vlc2[j] + m*ws[j];
+              vlc2[j] = vlc[j]; vlc[j] = s;
+              s = A * vls[j] + B * vls2[j] - m*wc[j];
+              vls2[j] = vls[j]; vls[j] = s;
+            }
+          }
+        } else {
+          for (int j = 0; j < nk; ++j) {
+            real A, B, qs;
+            switch (norm) {
+            case FULL:
+              A = root_[3] * uq[j];       // F[1]/(q*cl) or F[1]/(q*sl)
+              B = - root_[15]/2 * uq2[j]; // beta[1]/q
+              break;
+            case SCHMIDT:
+              A = uq[j];
+              B = - root_[3]/2 * uq2[j];
+              break;
+            default: break;   // To suppress warning message from Visual Studio
+            }
+            qs = q[j] / scale();
+            vc[j] = qs * (wc[j] + A * (cl[j] * vc[j] + sl[j] * vs[j]) +
+                          B * vc2[j]);
+            if (gradp) {
+              qs /= r[j];
+              vrc[j] = - qs * (wrc[j] + A * (cl[j] * vrc[j] + sl[j] * vrs[j])
+                               + B * vrc2[j]);
+              vtc[j] =   qs * (wtc[j] + A * (cl[j] * vtc[j] + sl[j] * vts[j])
+                               + B * vtc2[j]);
+              vlc[j] = qs / u[j] * (A * (cl[j] * vlc[j] + sl[j] * vls[j]) +
+                                    B * vlc2[j]);
+            }
+          }
+        }
+      }
+      for (int j = 0; j < nk; ++j) {
+        v[i0 + j] = vc[j];
+        if (gradp) {
+          // Rotate into cartesian (geocentric) coordinates
+          gradx[i0 + j] = cl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) -
+            sl[j] * vlc[j];
+          grady[i0 + j] = sl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) +
+            cl[j] * vlc[j];
+          gradz[i0 + j] = t[j] * vrc[j] - u[j] * vtc[j];
+        }
+      }
+    }
+  }
 
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::Values(const coeff c[], const real f[],
+                               real x, real y, real z, real a,
+                               real v[], real gradx[], real grady[],
+                               real gradz[]) {
+    // This is SphericalEngine::Value with the accumulators replaced by arrays
+    // of L accumulators, one for each set of coefficients.  The recursion
+    // factors are computed once for all the sets.
+    GEOGRAPHICLIB_SPAN(SPHERICAL_VALUE);
+    const real* root_ = roots();
     GEOGRAPHICLIB_STATIC_ASSERT(L > 0, "L must be positive");
     GEOGRAPHICLIB_STATIC_ASSERT(norm == FULL || norm == SCHMIDT,
                                 "Unknown normalization");
     int N = c[0].nmx(), M = c[0].mmx();
+    for (int l = 1; l < L; ++l) {
+      N = max(N, c[l].nmx()); M = max(M, c[l].mmx());
+    }
+    // If all the sets have the same degree and order, the coefficients can
+    // be read without checking; in this case, use the precomputed recursion
+    // factors if all the sets have them (they are then the same).
+    bool same = true;
+    for (int l = 0; l < L; ++l)
+      same = same && c[l].nmx() == N && c[l].mmx() == M;
+    const real* AB = same ? c[0].AB() : 0;
+    for (int l = 0; l < L; ++l)
+      if (!c[l].AB()) AB = 0;
 
     real
+      p = Math::hypot(x, y),
+      cl = p ? x / p : 1,       // cos(lambda); at pole, pick lambda = 0
+      sl = p ? y / p : 0,       // sin(lambda)
       r = Math::hypot(z, p),
       t = r ? z / r : 0,            // cos(theta); at origin, pick theta = pi/2
       u = r ? max(p / r, eps()) : 1, // sin(theta); but avoid the pole
       q = a / r;
     real
       q2 = Math::sq(q),
+      uq = u * q,
+      uq2 = Math::sq(uq),
       tu = t / u;
-    CircularEngine circ(M, gradp, norm, a, r, u, t);
+    // Initialize outer sums
+    real vc[L], vc2[L], vs[L], vs2[L], vrc[L], vrc2[L], vrs[L], vrs2[L],
+      vtc[L], vtc2[L], vts[L], vts2[L], vlc[L], vlc2[L], vls[L], vls2[L];
+    for (int l = 0; l < L; ++l) {
+      vc [l] = vc2 [l] = vs [l] = vs2 [l] = 0;
+      vrc[l] = vrc2[l] = vrs[l] = vrs2[l] = 0;
+      vtc[l] = vtc2[l] = vts[l] = vts2[l] = 0;
+      vlc[l] = vlc2[l] = vls[l] = vls2[l] = 0;
+    }
     int k[L];
     for (int m = M; m >= 0; --m) {   // m = M .. 0
-      // Initialize inner sum
-      real wc  = 0, wc2  = 0, ws  = 0, ws2  = 0; // w [N - m + 1], w [N - m + 2]
-      real wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0; // wr[N - m + 1], wr[N - m + 2]
-      real wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
-      for (int l = 0; l < L; ++l)
+      // Initialize inner sums
+      real wc[L], wc2[L], ws[L], ws2[L], wrc[L], wrc2[L], wrs[L], wrs2[L],
+        wtc[L], wtc2[L], wts[L], wts2[L];
+      for (int l = 0; l < L; ++l) {
+        wc [l] = wc2 [l] = ws [l] = ws2 [l] = 0;
+        wrc[l] = wrc2[l] = wrs[l] = wrs2[l] = 0;
+        wtc[l] = wtc2[l] = wts[l] = wts2[l] = 0;
         k[l] = c[l].index(N, m) + 1;
+      }
+      // The recursion factors for order m (indexed by n)
+      const real* ABm = AB ? AB + 2 * (m * N - m * (m - 1) / 2) : 0;
       for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
         real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
+        if (ABm) {
+          Ax = q * ABm[2 * n];
+          A = t * Ax;
+          B = q2 * ABm[2 * n + 1];
+        } else
+          switch (norm) {
+          case FULL:
+            w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+            Ax = q * w * root_[2 * n + 3];
+            A = t * Ax;
+            B = - q2 * root_[2 * n + 5] /
+              (w * root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          case SCHMIDT:
+            w = root_[n - m + 1] * root_[n + m + 1];
+            Ax = q * (2 * n + 1) / w;
+            A = t * Ax;
+            B = - q2 * w / (root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+        for (int l = 0; l < L; ++l) {
+          R = (same ? c[l].Cv(--k[l]) * f[l] :
+               c[l].Cv(--k[l], n, m, f[l])) * scale();
+          w = A * wc[l] + B * wc2[l] + R; wc2[l] = wc[l]; wc[l] = w;
+          if (gradp) {
+            w = A * wrc[l] + B * wrc2[l] + (n + 1) * R;
+            wrc2[l] = wrc[l]; wrc[l] = w;
+            w = A * wtc[l] + B * wtc2[l] -  u*Ax * wc2[l];
+            wtc2[l] = wtc[l]; wtc[l] = w;
+          }
+          if (m) {
+            R = (same ? c[l].Sv(k[l]) * f[l] :
+                 c[l].Sv(k[l], n, m, f[l])) * scale();
+            w = A * ws[l] + B * ws2[l] + R; ws2[l] = ws[l]; ws[l] = w;
+            if (gradp) {
+              w = A * wrs[l] + B * wrs2[l] + (n + 1) * R;
+              wrs2[l] = wrs[l]; wrs[l] = w;
+              w = A * wts[l] + B * wts2[l] -  u*Ax * ws2[l];
+              wts2[l] = wts[l]; wts[l] = w;
+            }
+          }
+        }
+      }
+      if (m) {
+        real v1, A, B;          // alpha[m], beta[m + 1]
         switch (norm) {
         case FULL:
-          w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
-          Ax = q * w * root_[2 * n + 3];
-          A = t * Ax;
-          B = - q2 * root_[2 * n + 5] /
-            (w * root_[n - m + 2] * root_[n + m + 2]);
+          v1 = root_[2] * root_[2 * m + 3] / root_[m + 1];
+          A = cl * v1 * uq;
+          B = - v1 * root_[2 * m + 5] / (root_[8] * root_[m + 2]) * uq2;
           break;
         case SCHMIDT:
-          w = root_[n - m + 1] * root_[n + m + 1];
-          Ax = q * (2 * n + 1) / w;
-          A = t * Ax;
-          B = - q2 * w / (root_[n - m + 2] * root_[n + m + 2]);
+          v1 = root_[2] * root_[2 * m + 1] / root_[m + 1];
+          A = cl * v1 * uq;
+          B = - v1 * root_[2 * m + 3] / (root_[8] * root_[m + 2]) * uq2;
           break;
         default: break;       // To suppress warning message from Visual Studio
         }
+        for (int l = 0; l < L; ++l) {
+          v1 = A * vc[l] + B * vc2[l] + wc[l]; vc2[l] = vc[l]; vc[l] = v1;
+          v1 = A * vs[l] + B * vs2[l] + ws[l]; vs2[l] = vs[l]; vs[l] = v1;
+          if (gradp) {
+            // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
+            wtc[l] += m * tu * wc[l]; wts[l] += m * tu * ws[l];
+            v1 = A * vrc[l] + B * vrc2[l] + wrc[l];
+            vrc2[l] = vrc[l]; vrc[l] = v1;
+            v1 = A * vrs[l] + B * vrs2[l] + wrs[l];
+            vrs2[l] = vrs[l]; vrs[l] = v1;
+            v1 = A * vtc[l] + B * vtc2[l] + wtc[l];
+            vtc2[l] = vtc[l]; vtc[l] = v1;
+            v1 = A * vts[l] + B * vts2[l] + wts[l];
+            vts2[l] = vts[l]; vts[l] = v1;
+            v1 = A * vlc[l] + B * vlc2[l] + m*ws[l];
+            vlc2[l] = vlc[l]; vlc[l] = v1;
+            v1 = A * vls[l] + B * vls2[l] - m*wc[l];
+            vls2[l] = vls[l]; vls[l] = v1;
+          }
+        }
+      } else {
+        real A, B, qs;
+        switch (norm) {
+        case FULL:
+          A = root_[3] * uq;       // F[1]/(q*cl) or F[1]/(q*sl)
+          B = - root_[15]/2 * uq2; // beta[1]/q
+          break;
+        case SCHMIDT:
+          A = uq;
+          B = - root_[3]/2 * uq2;
+          break;
+        default: break;       // To suppress warning message from Visual Studio
+        }
+        for (int l = 0; l < L; ++l) {
+          qs = q / scale();
+          vc[l] = qs * (wc[l] + A * (cl * vc[l] + sl * vs[l]) + B * vc2[l]);
+          if (gradp) {
+            qs /= r;
+            vrc[l] = - qs *
+              (wrc[l] + A * (cl * vrc[l] + sl * vrs[l]) + B * vrc2[l]);
+            vtc[l] = qs *
+              (wtc[l] + A * (cl * vtc[l] + sl * vts[l]) + B * vtc2[l]);
+            vlc[l] = qs / u *
+              (         A * (cl * vlc[l] + sl * vls[l]) + B * vlc2[l]);
+          }
+        }
+      }
+    }
+
+    for (int l = 0; l < L; ++l) {
+      v[l] = vc[l];
+      if (gradp) {
+        // Rotate into cartesian (geocentric) coordinates
+        gradx[l] = cl * (u * vrc[l] + t * vtc[l]) - sl * vlc[l];
+        grady[l] = sl * (u * vrc[l] + t * vtc[l]) + cl * vlc[l];
+        gradz[l] =       t * vrc[l] - u * vtc[l]               ;
+      }
+    }
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::circle(const coeff c[], const real f[],
+                               real t, real u, real q, int m0, int dm,
+                               CircularEngine* circ) {
+    const real* root_ = roots();
+    // Do the inner sums for m = m0, m0 + dm, m0 + 2*dm, ... (m <= M).
+    int N = c[0].nmx(), M = c[0].mmx();
+    const real* AB = c[0].AB();
+    real
+      q2 = Math::sq(q),
+      tu = t / u;
+    int k[L];
+    for (int m = m0; m <= M; m += dm) {
+      // Initialize inner sum
+      real wc  = 0, wc2  = 0, ws  = 0, ws2  = 0; // w [N - m + 1], w [N - m + 2]
+      real wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0; // wr[N - m + 1], wr[N - m + 2]
+      real wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
+      for (int l = 0; l < L; ++l)
+        k[l] = c[l].index(N, m) + 1;
+      // The recursion factors for order m (indexed by n)
+      const real* ABm = AB ? AB + 2 * (m * N - m * (m - 1) / 2) : 0;
+      for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
+        real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
+        if (ABm) {
+          Ax = q * ABm[2 * n];
+          A = t * Ax;
+          B = q2 * ABm[2 * n + 1];
+        } else
+          switch (norm) {
+          case FULL:
+            w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+            Ax = q * w * root_[2 * n + 3];
+            A = t * Ax;
+            B = - q2 * root_[2 * n + 5] /
+              (w * root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          case SCHMIDT:
+            w = root_[n - m + 1] * root_[n + m + 1];
+            Ax = q * (2 * n + 1) / w;
+            A = t * Ax;
+            B = - q2 * w / (root_[n - m + 2] * root_[n + m + 2]);
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
         R = c[0].Cv(--k[0]);
         for (int l = 1; l < L; ++l)
           R += c[l].Cv(--k[l], n, m, f[l]);
@@ -356,25 +800,246 @@ namespace GeographicLib {
         }
       }
       if (!gradp)
-        circ.SetCoeff(m, wc, ws);
+        circ->SetCoeff(m, wc, ws);
       else {
         // Include the terms Sc[m] * P'[m,m](t) and  Ss[m] * P'[m,m](t)
         wtc += m * tu * wc; wts += m * tu * ws;
-        circ.SetCoeff(m, wc, ws, wrc, wrs, wtc, wts);
+        circ->SetCoeff(m, wc, ws, wrc, wrs, wtc, wts);
       }
     }
 
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  CircularEngine SphericalEngine::Circle(const coeff c[], const real f[],
+                                         real p, real z, real a,
+                                         int nthreads) {
+
+    GEOGRAPHICLIB_STATIC_ASSERT(L > 0, "L must be positive");
+    GEOGRAPHICLIB_STATIC_ASSERT(norm == FULL || norm == SCHMIDT,
+                                "Unknown normalization");
+    int M = c[0].mmx();
+
+    real
+      r = Math::hypot(z, p),
+      t = r ? z / r : 0,            // cos(theta); at origin, pick theta = pi/2
+      u = r ? max(p / r, eps()) : 1, // sin(theta); but avoid the pole
+      q = a / r;
+    CircularEngine circ(M, gradp, norm, a, r, u, t);
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    // The inner sums for the different m are independent.  The work for
+    // order m is proportional to N - m + 1; so balance the load by giving
+    // task i the orders m = i, i + nthreads, i + 2 * nthreads, ....  The
+    // tasks are run by the current Executor.
+    int nt = max(min(nthreads, M + 1), 1);
+    Executor::For(size_t(nt), size_t(nt),
+                  [&](size_t i0, size_t i1) {
+                    for (size_t i = i0; i < i1; ++i)
+                      circle<gradp, norm, L>(c, f, t, u, q, int(i), nt,
+                                             &circ);
+                  });
+#else
+    (void)nthreads;
+    circle<gradp, norm, L>(c, f, t, u, q, 0, 1, &circ);
+#endif
     return circ;
   }
 
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::circles(const coeff c[], const real f[], int K,
+                                const real t[], const real u[], const real q[],
+                                int m0, int dm, CircularEngine* circ) {
+    const real* root_ = roots();
+    // This is the same computation as circle (including the order of the
+    // floating point operations, so that the results are identical), except
+    // that the inner sums for up to npoints_ circles are carried out
+    // together (as in the multi-point version of Value).
+    int N = c[0].nmx(), M = c[0].mmx();
+    const real* AB = c[0].AB();
+    const int nb = npoints_;
+    for (int i0 = 0; i0 < K; i0 += nb) {
+      int nk = min(nb, K - i0);
+      const real *tb = t + i0, *ub = u + i0, *qb = q + i0;
+      real q2[nb], tu[nb];
+      for (int j = 0; j < nk; ++j) {
+        q2[j] = Math::sq(qb[j]);
+        tu[j] = tb[j] / ub[j];
+      }
+      int k[L];
+      for (int m = m0; m <= M; m += dm) {
+        // The inner sums for each circle
+        real wc [nb], wc2 [nb], ws [nb], ws2 [nb];
+        real wrc[nb], wrc2[nb], wrs[nb], wrs2[nb];
+        real wtc[nb], wtc2[nb], wts[nb], wts2[nb];
+        for (int j = 0; j < nk; ++j) {
+          wc [j] = wc2 [j] = ws [j] = ws2 [j] = 0;
+          wrc[j] = wrc2[j] = wrs[j] = wrs2[j] = 0;
+          wtc[j] = wtc2[j] = wts[j] = wts2[j] = 0;
+        }
+        for (int l = 0; l < L; ++l)
+          k[l] = c[l].index(N, m) + 1;
+        const real* ABm = AB ? AB + 2 * (m * N - m * (m - 1) / 2) : 0;
+        for (int n = N; n >= m; --n) {           // n = N .. m; l = N - m .. 0
+          real w, d, r3, r5, Rc, Rs = 0;
+          if (ABm) {
+            w = ABm[2 * n]; d = ABm[2 * n + 1];
+          } else {
+            switch (norm) {
+            case FULL:
+              w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+              d = w * root_[n - m + 2] * root_[n + m + 2];
+              break;
+            case SCHMIDT:
+              w = root_[n - m + 1] * root_[n + m + 1];
+              d = root_[n - m + 2] * root_[n + m + 2];
+              break;
+            default: break;   // To suppress warning message from Visual Studio
+            }
+            r3 = root_[2 * n + 3]; r5 = root_[2 * n + 5];
+          }
+          Rc = c[0].Cv(--k[0]);
+          for (int l = 1; l < L; ++l)
+            Rc += c[l].Cv(--k[l], n, m, f[l]);
+          Rc *= scale();
+          if (m) {
+            Rs = c[0].Sv(k[0]);
+            for (int l = 1; l < L; ++l)
+              Rs += c[l].Sv(k[l], n, m, f[l]);
+            Rs *= scale();
+          }
+          real A[nb], B[nb], uAx[nb]; // alpha[l], beta[l + 1], u*alpha[l]/t
+          for (int j = 0; j < nk; ++j) {
+            real Ax, s;
+            if (ABm) {
+              // w and d hold the precomputed factors a[n,m] and b[n,m]
+              Ax = qb[j] * w;
+              B[j] = q2[j] * d;
+            } else
+              switch (norm) {
+              case FULL:
+                Ax = qb[j] * w * r3;
+                B[j] = - q2[j] * r5 / d;
+                break;
+              case SCHMIDT:
+                Ax = qb[j] * (2 * n + 1) / w;
+                B[j] = - q2[j] * w / d;
+                break;
+              default: break; // To suppress warning message from Visual Studio
+              }
+            A[j] = tb[j] * Ax;
+            uAx[j] = ub[j]*Ax;
+            s = A[j] * wc[j] + B[j] * wc2[j] + Rc; wc2[j] = wc[j]; wc[j] = s;
+            if (gradp) {
+              s = A[j] * wrc[j] + B[j] * wrc2[j] + (n + 1) * Rc;
+              wrc2[j] = wrc[j]; wrc[j] = s;
+              s = A[j] * wtc[j] + B[j] * wtc2[j] - uAx[j] * wc2[j];
+              wtc2[j] = wtc[j]; wtc[j] = s;
+            }
+          }
+          if (m) {
+            for (int j = 0; j < nk; ++j) {
+              real s;
+              s = A[j] * ws[j] + B[j] * ws2[j] + Rs; ws2[j] = ws[j]; ws[j] = s;
+              if (gradp) {
+                s = A[j] * wrs[j] + B[j] * wrs2[j] + (n + 1) * Rs;
+                wrs2[j] = wrs[j]; wrs[j] = s;
+                s = A[j] * wts[j] + B[j] * wts2[j] - uAx[j] * ws2[j];
+                wts2[j] = wts[j]; wts[j] = s;
+              }
+            }
+          }
+        }
+        for (int j = 0; j < nk; ++j) {
+          if (!gradp)
+            circ[i0 + j].SetCoeff(m, wc[j], ws[j]);
+          else {
+            // Include the terms Sc[m] * P'[m,m](t) and  Ss[m] * P'[m,m](t)
+            wtc[j] += m * tu[j] * wc[j]; wts[j] += m * tu[j] * ws[j];
+            circ[i0 + j].SetCoeff(m, wc[j], ws[j], wrc[j], wrs[j],
+                                  wtc[j], wts[j]);
+          }
+        }
+      }
+    }
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::Circles(const coeff c[], const real f[], int K,
+                                const real p[], const real z[], real a,
+                                CircularEngine circ[], int nthreads) {
+    GEOGRAPHICLIB_STATIC_ASSERT(L > 0, "L must be positive");
+    GEOGRAPHICLIB_STATIC_ASSERT(norm == FULL || norm == SCHMIDT,
+                                "Unknown normalization");
+    if (K <= 0)
+      return;
+    int M = c[0].mmx();
+    vector<real> t(K), u(K), q(K);
+    for (int i = 0; i < K; ++i) {
+      real r = Math::hypot(z[i], p[i]);
+      // cos(theta) and sin(theta); at origin, theta = pi/2; avoid the pole
+      t[i] = r ? z[i] / r : 0;
+      u[i] = r ? max(p[i] / r, eps()) : 1;
+      q[i] = a / r;
+      circ[i] = CircularEngine(M, gradp, norm, a, r, u[i], t[i]);
+    }
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    // Divide the orders between the threads as in Circle.
+    int nt = max(min(nthreads, M + 1), 1);
+    Executor::For(size_t(nt), size_t(nt),
+                  [&](size_t i0, size_t i1) {
+                    for (size_t i = i0; i < i1; ++i)
+                      circles<gradp, norm, L>(c, f, K, &t[0], &u[0], &q[0],
+                                              int(i), nt, circ);
+                  });
+#else
+    (void)nthreads;
+    circles<gradp, norm, L>(c, f, K, &t[0], &u[0], &q[0], 0, 1, circ);
+#endif
+  }
+
   void SphericalEngine::RootTable(int N) {
     // Need square roots up to max(2 * N + 5, 15).
-    int L = max(2 * N + 5, 15) + 1, oldL = int(root_.size());
+    int L = max(2 * N + 5, 15) + 1;
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    if (rootsize_.load(memory_order_acquire) >= L)
+      return;
+    lock_guard<mutex> lock(rootmutex_);
+    int oldL = rootsize_.load(memory_order_relaxed);
+#else
+    int oldL = rootsize_;
+#endif
     if (oldL >= L)
       return;
-    root_.resize(L);
+    roottables_.reserve(roottables_.size() + 1);
+    const real* oldtable = roots();
+    real* table = new real[L];
+    for (int l = 0; l < oldL; ++l)
+      table[l] = oldtable[l];
     for (int l = oldL; l < L; ++l)
-      root_[l] = sqrt(real(l));
+      table[l] = sqrt(real(l));
+    roottables_.push_back(table);
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    roottable_.store(table, memory_order_release);
+    rootsize_.store(L, memory_order_release);
+#else
+    roottable_ = table;
+    rootsize_ = L;
+#endif
+  }
+
+  void SphericalEngine::ClearRootTable() {
+#if GEOGRAPHICLIB_SPHERICALENGINE_THREADS
+    lock_guard<mutex> lock(rootmutex_);
+    roottable_.store(0, memory_order_release);
+    rootsize_.store(0, memory_order_release);
+#else
+    roottable_ = 0;
+    rootsize_ = 0;
+#endif
+    for (size_t i = 0; i < roottables_.size(); ++i)
+      delete[] roottables_[i];
+    vector<real*> temp(0);
+    roottables_.swap(temp);
   }
 
   void SphericalEngine::coeff::readcoeffs(std::istream& stream, int& N, int& M,
@@ -394,6 +1059,80 @@ namespace GeographicLib {
     return;
   }
 
+  void SphericalEngine::coeff::mapcoeffs(char* data, unsigned long long len,
+                                         unsigned long long& pos,
+                                         int& N, int& M, real*& C, real*& S) {
+    if (!mappable())
+      throw GeographicErr("Coefficients can't be used in place");
+    int nm[2];
+    if (!(pos + sizeof(nm) <= len))
+      throw GeographicErr("Coefficient data too short");
+    // The data are little-endian 4-byte ints, the same as the host.
+    memcpy(nm, data + pos, sizeof(nm));
+    pos += sizeof(nm);
+    N = nm[0]; M = nm[1];
+    if (!(N >= M && M >= -1 && N * M >= 0))
+      // The last condition is that M = -1 implies N = -1 and vice versa.
+      throw GeographicErr("Bad degree and order " +
+                          Utility::str(N) + " " + Utility::str(M));
+    unsigned long long
+      nC = Csize(N, M), nS = Ssize(N, M),
+      end = pos + sizeof(real) * (nC + nS);
+    if (!(end <= len))
+      throw GeographicErr("Coefficient data too short");
+    if ((reinterpret_cast<size_t>(data) + size_t(pos)) % sizeof(real) != 0)
+      throw GeographicErr("Coefficient data misaligned");
+    C = reinterpret_cast<real*>(data + pos);
+    S = C + nC;
+    pos = end;
+  }
+
+  bool SphericalEngine::coeff::mappable() {
+    return GEOGRAPHICLIB_PRECISION == 2 && !Math::bigendian &&
+      sizeof(int) == 4 && numeric_limits<real>::is_iec559;
+  }
+
+  void SphericalEngine::coeff::pack(const std::vector<real>& C,
+                                    const std::vector<real>& S,
+                                    int N, int nmx, int mmx,
+                                    std::vector<real>& CS) {
+    coeff c(C, S, N, nmx, mmx); // Check the arguments
+    CS.resize(2 * Csize(nmx, mmx));
+    for (int m = 0, k = 0; m <= mmx; ++m) {
+      int k0 = c.index(m, m);
+      for (int n = m; n <= nmx; ++n, ++k) {
+        CS[2 * k] = c.Cv(k0 + n - m);
+        CS[2 * k + 1] = m ? c.Sv(k0 + n - m) : 0;
+      }
+    }
+  }
+
+  void SphericalEngine::coeff::factors(int nmx, int mmx, unsigned norm,
+                                       std::vector<real>& AB) {
+    if (!(nmx >= mmx && mmx >= -1))
+      throw GeographicErr("Bad indices for factors");
+    if (!(norm == FULL || norm == SCHMIDT))
+      throw GeographicErr("Unknown normalization");
+    SphericalEngine::RootTable(nmx);
+    const real* root_ = roots();
+    AB.resize(2 * Csize(nmx, mmx));
+    // These are the factors computed in the inner loop of Value.
+    for (int m = 0, k = 0; m <= mmx; ++m)
+      for (int n = m; n <= nmx; ++n, ++k) {
+        real w;
+        if (norm == FULL) {
+          w = root_[2 * n + 1] / (root_[n - m + 1] * root_[n + m + 1]);
+          AB[2 * k] = w * root_[2 * n + 3];
+          AB[2 * k + 1] = - root_[2 * n + 5] /
+            (w * root_[n - m + 2] * root_[n + m + 2]);
+        } else {
+          w = root_[n - m + 1] * root_[n + m + 1];
+          AB[2 * k] = (2 * n + 1) / w;
+          AB[2 * k + 1] = - w / (root_[n - m + 2] * root_[n + m + 2]);
+        }
+      }
+  }
+
   /// \cond SKIP
   template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::FULL, 1>
@@ -434,44 +1173,197 @@ namespace GeographicLib {
   SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
 
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], int, const real[], const real[], const real[],
+   real, real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 4>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 4>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 4>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 4>
+  (const coeff[], const real[], real, real, real, real,
+   real[], real[], real[], real[]);
+
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
 
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
 
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::FULL, 3>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::FULL, 3>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 3>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
-  (const coeff[], const real[], real, real, real);
+  (const coeff[], const real[], real, real, real, int);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], int, const real[], const real[], real,
+   CircularEngine[], int);
   /// \endcond
 
 } // namespace GeographicLib
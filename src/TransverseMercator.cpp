@@ -29,10 +29,11 @@
  *  - evaluating the convergence and scale using the expression for the
  *    projection or its inverse.
  *
- * If the preprocessor variable GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER is set
- * to an integer between 4 and 8, then this specifies the order of the series
- * used for the forward and reverse transformations.  The default value is 6.
- * (The series accurate to 12th order is given in \ref tmseries.)
+ * The order of the series used for the forward and reverse transformations
+ * is given by the \e order argument of the constructor, an integer between 4
+ * and 12.  Its default value is set by the preprocessor variable
+ * GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER, which is 6 by default.  (The
+ * series accurate to 12th order is given in \ref tmseries.)
  *
  * Other equivalent implementations are given in
  *  - http://www.ign.fr/DISPLAY/000/526/702/5267021/NTG_76.pdf
@@ -40,12 +41,29 @@
  **********************************************************************/
 
 #include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#if !defined(GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS 1
+#  else
+#    define GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS
+#  include <GeographicLib/Executor.hpp>
+#endif
 
 namespace GeographicLib {
 
   using namespace std;
 
-  TransverseMercator::TransverseMercator(real a, real f, real k0)
+  // If a coefficient is greater than 2^63 - 1, express it as a pair [a, b]
+  // which is combined with a*2^52 + b (as in GeodesicExactC4.cpp).
+#define reale(hi, lo) (real(hi) * real(4503599627370496.0) + real(lo))
+
+  TransverseMercator::TransverseMercator(real a, real f, real k0, int order)
     : _a(a)
     , _f(f <= 1 ? f : 1/f)
     , _k0(k0)
@@ -56,6 +74,7 @@ namespace GeographicLib {
       // See, for example, Lee (1976), p 100.
     , _c( sqrt(_e2m) * exp(Math::eatanhe(real(1), _es)) )
     , _n(_f / (2 - _f))
+    , _order(order)
   {
     if (!(Math::isfinite(_a) && _a > 0))
       throw GeographicErr("Major radius is not positive");
@@ -63,192 +82,144 @@ namespace GeographicLib {
       throw GeographicErr("Minor radius is not positive");
     if (!(Math::isfinite(_k0) && _k0 > 0))
       throw GeographicErr("Scale is not positive");
+    if (!(_order >= 4 && _order <= maxpow_))
+      throw GeographicErr("Order of series not in [4, "
+                          + Utility::str(maxpow_) + "]");
 
-    // Generated by Maxima on 2015-05-14 22:55:13-04:00
-#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER/2 == 2
+    // The coefficients of the series to order maxpow_ = 12 in n.  These are
+    // the last set printed by printtm() in tmseries.mac (with maxpow:12$);
+    // see also \ref tmseries.  Lower orders are obtained by truncation,
+    // i.e., by skipping the leading coefficients of each polynomial.
     static const real b1coeff[] = {
-      // b1*(n+1), polynomial in n2 of order 2
-      1, 16, 64, 64,
-    };  // count = 4
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER/2 == 3
-    static const real b1coeff[] = {
-      // b1*(n+1), polynomial in n2 of order 3
-      1, 4, 64, 256, 256,
-    };  // count = 5
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER/2 == 4
-    static const real b1coeff[] = {
-      // b1*(n+1), polynomial in n2 of order 4
-      25, 64, 256, 4096, 16384, 16384,
-    };  // count = 6
-#else
-#error "Bad value for GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER"
-#endif
+      // b1*(n+1), polynomial in n2 of order 6
+      441, 784, 1600, 4096, 16384, 262144, 1048576, 1048576,
+    };  // count = 8
 
-#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 4
-    static const real alpcoeff[] = {
-      // alp[1]/n^1, polynomial in n of order 3
-      164, 225, -480, 360, 720,
-      // alp[2]/n^2, polynomial in n of order 2
-      557, -864, 390, 1440,
-      // alp[3]/n^3, polynomial in n of order 1
-      -1236, 427, 1680,
-      // alp[4]/n^4, polynomial in n of order 0
-      49561, 161280,
-    };  // count = 14
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 5
     static const real alpcoeff[] = {
-      // alp[1]/n^1, polynomial in n of order 4
-      -635, 328, 450, -960, 720, 1440,
-      // alp[2]/n^2, polynomial in n of order 3
-      4496, 3899, -6048, 2730, 10080,
-      // alp[3]/n^3, polynomial in n of order 2
-      15061, -19776, 6832, 26880,
-      // alp[4]/n^4, polynomial in n of order 1
-      -171840, 49561, 161280,
-      // alp[5]/n^5, polynomial in n of order 0
-      34729, 80640,
-    };  // count = 20
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 6
-    static const real alpcoeff[] = {
-      // alp[1]/n^1, polynomial in n of order 5
-      31564, -66675, 34440, 47250, -100800, 75600, 151200,
-      // alp[2]/n^2, polynomial in n of order 4
-      -1983433, 863232, 748608, -1161216, 524160, 1935360,
-      // alp[3]/n^3, polynomial in n of order 3
-      670412, 406647, -533952, 184464, 725760,
-      // alp[4]/n^4, polynomial in n of order 2
-      6601661, -7732800, 2230245, 7257600,
-      // alp[5]/n^5, polynomial in n of order 1
-      -13675556, 3438171, 7983360,
-      // alp[6]/n^6, polynomial in n of order 0
-      212378941, 319334400,
-    };  // count = 27
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 7
-    static const real alpcoeff[] = {
-      // alp[1]/n^1, polynomial in n of order 6
-      1804025, 2020096, -4267200, 2204160, 3024000, -6451200, 4838400, 9676800,
-      // alp[2]/n^2, polynomial in n of order 5
-      4626384, -9917165, 4316160, 3743040, -5806080, 2620800, 9676800,
-      // alp[3]/n^3, polynomial in n of order 4
-      -67102379, 26816480, 16265880, -21358080, 7378560, 29030400,
-      // alp[4]/n^4, polynomial in n of order 3
-      155912000, 72618271, -85060800, 24532695, 79833600,
-      // alp[5]/n^5, polynomial in n of order 2
-      102508609, -109404448, 27505368, 63866880,
-      // alp[6]/n^6, polynomial in n of order 1
-      -12282192400LL, 2760926233LL, 4151347200LL,
-      // alp[7]/n^7, polynomial in n of order 0
-      1522256789, 1383782400,
-    };  // count = 35
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 8
-    static const real alpcoeff[] = {
-      // alp[1]/n^1, polynomial in n of order 7
-      -75900428, 37884525, 42422016, -89611200, 46287360, 63504000, -135475200,
-      101606400, 203212800,
-      // alp[2]/n^2, polynomial in n of order 6
-      148003883, 83274912, -178508970, 77690880, 67374720, -104509440,
-      47174400, 174182400,
-      // alp[3]/n^3, polynomial in n of order 5
-      318729724, -738126169, 294981280, 178924680, -234938880, 81164160,
-      319334400,
-      // alp[4]/n^4, polynomial in n of order 4
-      -40176129013LL, 14967552000LL, 6971354016LL, -8165836800LL, 2355138720LL,
-      7664025600LL,
-      // alp[5]/n^5, polynomial in n of order 3
-      10421654396LL, 3997835751LL, -4266773472LL, 1072709352, 2490808320LL,
-      // alp[6]/n^6, polynomial in n of order 2
-      175214326799LL, -171950693600LL, 38652967262LL, 58118860800LL,
-      // alp[7]/n^7, polynomial in n of order 1
-      -67039739596LL, 13700311101LL, 12454041600LL,
-      // alp[8]/n^8, polynomial in n of order 0
-      1424729850961LL, 743921418240LL,
-    };  // count = 44
-#else
-#error "Bad value for GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER"
-#endif
+      // alp[1]/n^1, polynomial in n of order 11
+      real(4431210117088828LL), real(-6717715507419345LL),
+      real(2716088720304960LL), real(4294847668391280LL),
+      real(-7736560986211200LL), real(3861584787060000LL),
+      real(4324093059686400LL), real(-9134105460480000LL),
+      real(4718089119744000LL), real(6472988121600000LL),
+      real(-13809041326080000LL), real(10356780994560000LL),
+      real(20713561989120000LL),
+      // alp[2]/n^2, polynomial in n of order 10
+      real(-5927429666137029LL), real(3845469906312160LL),
+      real(1549973856419170LL), real(-4436193970091520LL),
+      real(2488951699634400LL), real(1400417540121600LL),
+      real(-3001949646696000LL), real(1306511990784000LL),
+      real(1133027191296000LL), real(-1757514350592000LL),
+      real(793322449920000LL), real(2929190584320000LL),
+      // alp[3]/n^3, polynomial in n of order 9
+      real(30643233026094236LL), real(3724623933082815LL),
+      real(-22182400548863520LL), real(13012649967091320LL),
+      real(4385466018460800LL), real(-10156025584504800LL),
+      real(4058706427776000LL), real(2461860457056000LL),
+      real(-3232571037696000LL), real(1116753910272000LL),
+      real(4393785876480000LL),
+      // alp[4]/n^4, polynomial in n of order 8
+      real(152161926556090753LL), reale(-3879, 1653067557371904LL),
+      reale(2296, 460801430964224LL), real(2341173065124741120LL),
+      real(-5896441539367142400LL), real(2196709775769600000LL),
+      real(1023149377887436800LL), real(-1198457404784640000LL),
+      real(345651463213056000LL), real(1124809184378880000LL),
+      // alp[5]/n^5, polynomial in n of order 7
+      real(-5470082496121881004LL), real(3202186557737811189LL),
+      real(531945896758203648LL), real(-1434999203380612800LL),
+      real(500039315243596800LL), real(191819357601580800LL),
+      real(-204723204605337600LL), real(51469452876441600LL),
+      real(119510975840256000LL),
+      // alp[6]/n^6, polynomial in n of order 6
+      reale(2847, 4255047270510725LL), real(1686179094682601760LL),
+      real(-4740976356772562130LL), real(1546570292687400960LL),
+      real(514709606404742400LL), real(-505122357519360000LL),
+      real(113546956628851200LL), real(170729965486080000LL),
+      // alp[7]/n^7, polynomial in n of order 5
+      real(5292781327398738004LL), reale(-3333, 4388769322462413LL),
+      real(4584349623542871840LL), real(1376330123342088360LL),
+      real(-1247260947235660800LL), real(254891547971884800LL),
+      real(231704953159680000LL),
+      // alp[8]/n^8, polynomial in n of order 4
+      reale(-1314912, 4258879717189655LL), reale(376313, 2127126692749312LL),
+      reale(104985, 4457713932401760LL), reale(-88059, 1283622379474944LL),
+      reale(16553, 2329549521465712LL), reale(8643, 1820551463043072LL),
+      // alp[9]/n^9, polynomial in n of order 3
+      reale(81020, 1860645823578404LL), reale(21489, 1784037071908961LL),
+      reale(-16712, 4432977657169312LL), reale(2915, 291344053015240LL),
+      real(3784514234941440000LL),
+      // alp[10]/n^10, polynomial in n of order 2
+      reale(1833588, 492752236796035LL), reale(-1324068, 508332046956000LL),
+      reale(215798, 453496907913346LL), reale(33277, 478903673028608LL),
+      // alp[11]/n^11, polynomial in n of order 1
+      reale(-4710571, 1920807083215500LL), reale(721253, 2087944477571587LL),
+      reale(57982, 3768616763260928LL),
+      // alp[12]/n^12, polynomial in n of order 0
+      reale(497518565, 4367993141576441LL),
+      reale(20409958, 2494810220920832LL),
+    };  // count = 90
 
-#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 4
     static const real betcoeff[] = {
-      // bet[1]/n^1, polynomial in n of order 3
-      -4, 555, -960, 720, 1440,
-      // bet[2]/n^2, polynomial in n of order 2
-      -437, 96, 30, 1440,
-      // bet[3]/n^3, polynomial in n of order 1
-      -148, 119, 3360,
-      // bet[4]/n^4, polynomial in n of order 0
-      4397, 161280,
-    };  // count = 14
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 5
-    static const real betcoeff[] = {
-      // bet[1]/n^1, polynomial in n of order 4
-      -3645, -64, 8880, -15360, 11520, 23040,
-      // bet[2]/n^2, polynomial in n of order 3
-      4416, -3059, 672, 210, 10080,
-      // bet[3]/n^3, polynomial in n of order 2
-      -627, -592, 476, 13440,
-      // bet[4]/n^4, polynomial in n of order 1
-      -3520, 4397, 161280,
-      // bet[5]/n^5, polynomial in n of order 0
-      4583, 161280,
-    };  // count = 20
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 6
-    static const real betcoeff[] = {
-      // bet[1]/n^1, polynomial in n of order 5
-      384796, -382725, -6720, 932400, -1612800, 1209600, 2419200,
-      // bet[2]/n^2, polynomial in n of order 4
-      -1118711, 1695744, -1174656, 258048, 80640, 3870720,
-      // bet[3]/n^3, polynomial in n of order 3
-      22276, -16929, -15984, 12852, 362880,
-      // bet[4]/n^4, polynomial in n of order 2
-      -830251, -158400, 197865, 7257600,
-      // bet[5]/n^5, polynomial in n of order 1
-      -435388, 453717, 15966720,
-      // bet[6]/n^6, polynomial in n of order 0
-      20648693, 638668800,
-    };  // count = 27
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 7
-    static const real betcoeff[] = {
-      // bet[1]/n^1, polynomial in n of order 6
-      -5406467, 6156736, -6123600, -107520, 14918400, -25804800, 19353600,
-      38707200,
-      // bet[2]/n^2, polynomial in n of order 5
-      829456, -5593555, 8478720, -5873280, 1290240, 403200, 19353600,
-      // bet[3]/n^3, polynomial in n of order 4
-      9261899, 3564160, -2708640, -2557440, 2056320, 58060800,
-      // bet[4]/n^4, polynomial in n of order 3
-      14928352, -9132761, -1742400, 2176515, 79833600,
-      // bet[5]/n^5, polynomial in n of order 2
-      -8005831, -1741552, 1814868, 63866880,
-      // bet[6]/n^6, polynomial in n of order 1
-      -261810608, 268433009, 8302694400LL,
-      // bet[7]/n^7, polynomial in n of order 0
-      219941297, 5535129600LL,
-    };  // count = 35
-#elif GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER == 8
-    static const real betcoeff[] = {
-      // bet[1]/n^1, polynomial in n of order 7
-      31777436, -37845269, 43097152, -42865200, -752640, 104428800, -180633600,
-      135475200, 270950400,
-      // bet[2]/n^2, polynomial in n of order 6
-      24749483, 14930208, -100683990, 152616960, -105719040, 23224320, 7257600,
-      348364800,
-      // bet[3]/n^3, polynomial in n of order 5
-      -232468668, 101880889, 39205760, -29795040, -28131840, 22619520,
-      638668800,
-      // bet[4]/n^4, polynomial in n of order 4
-      324154477, 1433121792, -876745056, -167270400, 208945440, 7664025600LL,
-      // bet[5]/n^5, polynomial in n of order 3
-      457888660, -312227409, -67920528, 70779852, 2490808320LL,
-      // bet[6]/n^6, polynomial in n of order 2
-      -19841813847LL, -3665348512LL, 3758062126LL, 116237721600LL,
-      // bet[7]/n^7, polynomial in n of order 1
-      -1989295244, 1979471673, 49816166400LL,
-      // bet[8]/n^8, polynomial in n of order 0
-      191773887257LL, 3719607091200LL,
-    };  // count = 44
-#else
-#error "Bad value for GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER"
-#endif
+      // bet[1]/n^1, polynomial in n of order 11
+      real(-52097725573472LL), real(-4593728129265LL), real(99489183793560LL),
+      real(-241063892493930LL), real(373740780283200LL),
+      real(-445105777762800LL), real(506874224102400LL),
+      real(-504146190240000LL), real(-8851949568000LL),
+      real(1228208002560000LL), real(-2124467896320000LL),
+      real(1593350922240000LL), real(3186701844480000LL),
+      // bet[2]/n^2, polynomial in n of order 10
+      real(6339155669701909LL), real(-6547392780343520LL),
+      real(4993840898500090LL), real(-3867736652881920LL),
+      real(3329656845715200LL), real(2008626575155200LL),
+      real(-13545460184256000LL), real(20532231143424000LL),
+      real(-14222847614976000LL), real(3124469956608000LL),
+      real(976396861440000LL), real(46867049349120000LL),
+      // bet[3]/n^3, polynomial in n of order 9
+      real(-6478352282806732LL), real(-1964815446325935LL),
+      real(-5729132344514880LL), real(37439612655485040LL),
+      real(-51177326347929600LL), real(22428792446860800LL),
+      real(8631038287872000LL), real(-6559294629888000LL),
+      real(-6193145806848000LL), real(4979623993344000LL),
+      real(140601148047360000LL),
+      // bet[4]/n^4, polynomial in n of order 8
+      real(-537877266968267441LL), real(825983117318553600LL),
+      real(-38325402591866880LL), real(-542150636788776960LL),
+      real(95148933972019200LL), real(420663666357043200LL),
+      real(-257350625589657600LL), real(-49098813603840000LL),
+      real(61331671425024000LL), real(2249618368757760000LL),
+      // bet[5]/n^5, polynomial in n of order 7
+      real(1954586849731204LL), real(102134758808271LL),
+      real(-1811389377750288LL), real(710208887528700LL),
+      real(646172476992000LL), real(-440615319580800LL),
+      real(-95849449113600LL), real(99884527142400LL),
+      real(3515028701184000LL),
+      // bet[6]/n^6, polynomial in n of order 6
+      real(-21678380925301381LL), real(-63388053145955040LL),
+      real(27996394052361990LL), real(21354319429908480LL),
+      real(-14571828089236800LL), real(-2691831947212800LL),
+      real(2759920825334400LL), real(85364982743040000LL),
+      // bet[7]/n^7, polynomial in n of order 5
+      real(-558259067639970668LL), real(269986136438814645LL),
+      real(158557749196287360LL), real(-110835025663344480LL),
+      real(-18505220077785600LL), real(18413837290915200LL),
+      real(463409906319360000LL),
+      // bet[8]/n^8, polynomial in n of order 4
+      reale(8707, 628584633892575LL), reale(4259, 2947449907849216LL),
+      reale(-3021, 3201512721644256LL), real(-2059701208116203520LL),
+      real(2006952084921956400LL), reale(8643, 1820551463043072LL),
+      // bet[9]/n^9, polynomial in n of order 3
+      real(2769071366073514116LL), real(-1987764870905723245LL),
+      real(-275684168729026960LL), real(263953865991151980LL),
+      real(3784514234941440000LL),
+      // bet[10]/n^10, polynomial in n of order 2
+      reale(-53751, 3244137474556627LL), reale(-6878, 2057388638212832LL),
+      reale(6489, 663855519215574LL), reale(66554, 957807346057216LL),
+      // bet[11]/n^11, polynomial in n of order 1
+      reale(-34842, 3737315598453076LL), reale(32464, 2362038081226121LL),
+      reale(231931, 1563668170932224LL),
+      // bet[12]/n^12, polynomial in n of order 0
+      reale(37939, 4173923897270389LL), reale(184705, 2284566421176320LL),
+    };  // count = 90
 
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(b1coeff) / sizeof(real) ==
                                 maxpow_/2 + 2,
@@ -259,22 +230,32 @@ namespace GeographicLib {
     GEOGRAPHICLIB_STATIC_ASSERT(sizeof(betcoeff) / sizeof(real) ==
                                 (maxpow_ * (maxpow_ + 3))/2,
                                 "Coefficient array size mismatch for bet");
-    int m = maxpow_/2;
-    _b1 = Math::polyval(m, b1coeff, Math::sq(_n)) / (b1coeff[m + 1] * (1+_n));
+    int m = maxpow_/2, mt = _order/2;
+    _b1 = Math::polyval(mt, b1coeff + (m - mt), Math::sq(_n)) /
+      (b1coeff[m + 1] * (1+_n));
     // _a1 is the equivalent radius for computing the circumference of
     // ellipse.
     _a1 = _b1 * _a;
     int o = 0;
     real d = _n;
-    for (int l = 1; l <= maxpow_; ++l) {
+    for (int l = 1; l <= _order; ++l) {
       m = maxpow_ - l;
-      _alp[l] = d * Math::polyval(m, alpcoeff + o, _n) / alpcoeff[o + m + 1];
-      _bet[l] = d * Math::polyval(m, betcoeff + o, _n) / betcoeff[o + m + 1];
+      mt = _order - l;          // order of truncated polynomial
+      _alp[l] = d * Math::polyval(mt, alpcoeff + o + (m - mt), _n)
+        / alpcoeff[o + m + 1];
+      _bet[l] = d * Math::polyval(mt, betcoeff + o + (m - mt), _n)
+        / betcoeff[o + m + 1];
       o += m + 2;
       d *= _n;
     }
-    // Post condition: o == sizeof(alpcoeff) / sizeof(real) &&
-    // o == sizeof(betcoeff) / sizeof(real)
+#if GEOGRAPHICLIB_PRECISION != 1
+    // The terms of higher order than floatpow_ included in the first
+    // floatpow_ coefficients are far smaller than the float roundoff.
+    _alpf[0] = _betf[0] = 0;
+    for (int l = 1; l <= floatpow_; ++l) {
+      _alpf[l] = float(_alp[l]); _betf[l] = float(_bet[l]);
+    }
+#endif
   }
 
   const TransverseMercator& TransverseMercator::UTM() {
@@ -427,11 +408,11 @@ namespace GeographicLib {
     // The conversion from conformal to rectifying latitude can be expressed as
     // a series in _n:
     //
-    //   zeta = zeta' + sum(h[j-1]' * sin(2 * j * zeta'), j = 1..maxpow_)
+    //   zeta = zeta' + sum(h[j-1]' * sin(2 * j * zeta'), j = 1.._order)
     //
     // where h[j]' = O(_n^j).  The reversion of this series gives
     //
-    //   zeta' = zeta - sum(h[j-1] * sin(2 * j * zeta), j = 1..maxpow_)
+    //   zeta' = zeta - sum(h[j-1] * sin(2 * j * zeta), j = 1.._order)
     //
     // which is used in Reverse.
     //
@@ -456,7 +437,7 @@ namespace GeographicLib {
     //    a(n, x) = 2 * cos(x)
     //    b(n, x) = -1
     //    [ sin(A+B) - 2*cos(B)*sin(A) + sin(A-B) = 0, A = n*x, B = x ]
-    //    N = maxpow_
+    //    N = _order
     //    c[k] = _alp[k]
     //    S = y[1] * sin(x)
     //
@@ -473,12 +454,12 @@ namespace GeographicLib {
       c0 = cos(2 * xip), ch0 = cosh(2 * etap),
       s0 = sin(2 * xip), sh0 = sinh(2 * etap),
       ar = 2 * c0 * ch0, ai = -2 * s0 * sh0; // 2 * cos(2*zeta')
-    int n = maxpow_;
+    int n = _order;
     real
       xi0 = (n & 1 ? _alp[n] : 0), eta0 = 0,
       xi1 = 0, eta1 = 0;
     real                        // Accumulators for dzeta/dzeta'
-      yr0 = (n & 1 ? 2 * maxpow_ * _alp[n--] : 0), yi0 = 0,
+      yr0 = (n & 1 ? 2 * _order * _alp[n--] : 0), yi0 = 0,
       yr1 = 0, yi1 = 0;
     while (n) {
       xi1  = ar * xi0 - ai * eta0 - xi1 + _alp[n];
@@ -534,12 +515,12 @@ namespace GeographicLib {
       c0 = cos(2 * xi), ch0 = cosh(2 * eta),
       s0 = sin(2 * xi), sh0 = sinh(2 * eta),
       ar = 2 * c0 * ch0, ai = -2 * s0 * sh0; // 2 * cos(2*zeta)
-    int n = maxpow_;
+    int n = _order;
     real                        // Accumulators for zeta'
       xip0 = (n & 1 ? -_bet[n] : 0), etap0 = 0,
       xip1 = 0, etap1 = 0;
     real                        // Accumulators for dzeta'/dzeta
-      yr0 = (n & 1 ? - 2 * maxpow_ * _bet[n--] : 0), yi0 = 0,
+      yr0 = (n & 1 ? - 2 * _order * _bet[n--] : 0), yi0 = 0,
       yr1 = 0, yi1 = 0;
     while (n) {
       xip1  = ar * xip0 - ai * etap0 - xip1 - _bet[n];
@@ -602,4 +583,622 @@ namespace GeographicLib {
     k *= _k0;
   }
 
+  GEOGRAPHICLIB_TARGET_CLONES
+  void TransverseMercator::Clenshaw(int m, real sgn, const real c[],
+                                    bool gkp, real zetar[], real zetai[],
+                                    real yr[], real yi[]) const {
+    // This carries out the summations in Forward and Reverse for m points at
+    // once; the arithmetic is the same as in those routines, so that the
+    // results are identical.  The innermost loops are over the points.
+    real
+      ar[nblock_], ai[nblock_], br[nblock_], bi[nblock_],
+      xi0[nblock_], eta0[nblock_], xi1[nblock_], eta1[nblock_],
+      yr0[nblock_], yi0[nblock_], yr1[nblock_], yi1[nblock_];
+    for (int l = 0; l < m; ++l) {
+      real
+        c0 = cos(2 * zetar[l]), ch0 = cosh(2 * zetai[l]),
+        s0 = sin(2 * zetar[l]), sh0 = sinh(2 * zetai[l]);
+      ar[l] = 2 * c0 * ch0; ai[l] = -2 * s0 * sh0; // 2 * cos(2*zeta)
+      br[l] = s0 * ch0; bi[l] = c0 * sh0;          // sin(2*zeta)
+    }
+    int n = _order;
+    for (int l = 0; l < m; ++l) {
+      xi0[l] = (n & 1 ? sgn * c[n] : 0); eta0[l] = 0;
+      xi1[l] = 0; eta1[l] = 0;
+    }
+    if (gkp) {
+      for (int l = 0; l < m; ++l) {
+        yr0[l] = (n & 1 ? sgn * (2 * _order * c[n]) : 0); yi0[l] = 0;
+        yr1[l] = 0; yi1[l] = 0;
+      }
+    }
+    if (n & 1) --n;
+    while (n) {
+      for (int l = 0; l < m; ++l) {
+        xi1[l]  = ar[l] * xi0[l] - ai[l] * eta0[l] - xi1[l] + sgn * c[n];
+        eta1[l] = ai[l] * xi0[l] + ar[l] * eta0[l] - eta1[l];
+      }
+      if (gkp) {
+        for (int l = 0; l < m; ++l) {
+          yr1[l] = ar[l] * yr0[l] - ai[l] * yi0[l] - yr1[l] +
+            sgn * (2 * n * c[n]);
+          yi1[l] = ai[l] * yr0[l] + ar[l] * yi0[l] - yi1[l];
+        }
+      }
+      --n;
+      for (int l = 0; l < m; ++l) {
+        xi0[l]  = ar[l] * xi1[l] - ai[l] * eta1[l] - xi0[l] + sgn * c[n];
+        eta0[l] = ai[l] * xi1[l] + ar[l] * eta1[l] - eta0[l];
+      }
+      if (gkp) {
+        for (int l = 0; l < m; ++l) {
+          yr0[l] = ar[l] * yr1[l] - ai[l] * yi1[l] - yr0[l] +
+            sgn * (2 * n * c[n]);
+          yi0[l] = ai[l] * yr1[l] + ar[l] * yi1[l] - yi0[l];
+        }
+      }
+      --n;
+    }
+    if (gkp) {
+      for (int l = 0; l < m; ++l) {
+        real cr = ar[l] / 2, ci = ai[l] / 2; // cos(2*zeta)
+        yr[l] = 1 - yr1[l] + cr * yr0[l] - ci * yi0[l];
+        yi[l] =   - yi1[l] + ci * yr0[l] + cr * yi0[l];
+      }
+    }
+    for (int l = 0; l < m; ++l) {
+      real xi = zetar[l], eta = zetai[l];
+      zetar[l] = xi  + br[l] * xi0[l] - bi[l] * eta0[l];
+      zetai[l] = eta + bi[l] * xi0[l] + br[l] * eta0[l];
+    }
+  }
+
+  void TransverseMercator::Forward(real lon0,
+                                   const real* lat, const real* lon, size_t n,
+                                   real* x, real* y, real* gamma, real* k,
+                                   int nthreads) const {
+#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS
+    // Divide the whole blocks of points into nthreads contiguous ranges
+    // which are run by the current Executor.
+    size_t nblocks = (n + nblock_ - 1) / nblock_;
+    Executor::For(nblocks, size_t(max(nthreads, 1)),
+                  [&](size_t b0, size_t b1) {
+                    size_t
+                      i0 = min(n, b0 * nblock_),
+                      i1 = min(n, b1 * nblock_);
+                    ForwardRange(lon0, lat, lon, i0, i1, x, y, gamma, k);
+                  });
+#else
+    (void)nthreads;
+    ForwardRange(lon0, lat, lon, 0, n, x, y, gamma, k);
+#endif
+  }
+
+  void TransverseMercator::ForwardRange(real lon0,
+                                        const real* lat, const real* lon,
+                                        size_t i0, size_t i1,
+                                        real* x, real* y,
+                                        real* gamma, real* k) const {
+    bool gkp = gamma || k;
+    lon0 = Math::AngNormalize(lon0);
+    real
+      xip[nblock_], etap[nblock_], yr[nblock_], yi[nblock_],
+      tgamma[nblock_], tk[nblock_];
+    int latsign[nblock_], lonsign[nblock_];
+    bool backside[nblock_];
+    for (size_t j0 = i0; j0 < i1; j0 += nblock_) {
+      int m = int(min(size_t(nblock_), i1 - j0));
+      // Map to the Gauss-Schreiber coordinates as in the scalar Forward.
+      for (int l = 0; l < m; ++l) {
+        real
+          tlat = lat[j0 + l],
+          tlon = Math::AngDiff(lon0, Math::AngNormalize(lon[j0 + l]));
+        latsign[l] = tlat < 0 ? -1 : 1;
+        lonsign[l] = tlon < 0 ? -1 : 1;
+        tlon *= lonsign[l];
+        tlat *= latsign[l];
+        backside[l] = tlon > 90;
+        if (backside[l]) {
+          if (tlat == 0)
+            latsign[l] = -1;
+          tlon = 180 - tlon;
+        }
+        real
+          phi = tlat * Math::degree(),
+          lam = tlon * Math::degree();
+        if (tlat != 90) {
+          real
+            c = max(real(0), cos(lam)),
+            tau = tan(phi),
+            taup = Math::taupf(tau, _es);
+          xip[l] = atan2(taup, c);
+          etap[l] = Math::asinh(sin(lam) / Math::hypot(taup, c));
+          if (gkp) {
+            tgamma[l] = atan(Math::tand(tlon) *
+                             taup / Math::hypot(real(1), taup));
+            tk[l] = sqrt(_e2m + _e2 * Math::sq(cos(phi))) *
+              Math::hypot(real(1), tau) / Math::hypot(taup, c);
+          }
+        } else {
+          xip[l] = Math::pi()/2;
+          etap[l] = 0;
+          tgamma[l] = lam;
+          tk[l] = _c;
+        }
+      }
+      Clenshaw(m, real(1), _alp, gkp, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        real xi = xip[l], eta = etap[l];
+        y[j0 + l] =
+          _a1 * _k0 * (backside[l] ? Math::pi() - xi : xi) * latsign[l];
+        x[j0 + l] = _a1 * _k0 * eta * lonsign[l];
+        if (gkp) {
+          real g = tgamma[l], kk = tk[l];
+          g -= atan2(yi[l], yr[l]);
+          kk *= _b1 * Math::hypot(yr[l], yi[l]);
+          g /= Math::degree();
+          if (backside[l])
+            g = 180 - g;
+          g *= latsign[l] * lonsign[l];
+          kk *= _k0;
+          if (gamma) gamma[j0 + l] = g;
+          if (k) k[j0 + l] = kk;
+        }
+      }
+    }
+  }
+
+  void TransverseMercator::Forward(const real* lon0, size_t nz,
+                                   real lat, real lon,
+                                   real* x, real* y, real* gamma, real* k)
+    const {
+    bool gkp = gamma || k;
+    lon = Math::AngNormalize(lon);
+    // The quantities depending only on the latitude are computed once.
+    int latsign0 = lat < 0 ? -1 : 1;
+    lat *= latsign0;
+    real
+      phi = lat * Math::degree(),
+      tau = tan(phi),
+      taup = Math::taupf(tau, _es),
+      taupn = Math::hypot(real(1), taup),
+      kphi = sqrt(_e2m + _e2 * Math::sq(cos(phi))) * Math::hypot(real(1), tau);
+    real
+      xip[nblock_], etap[nblock_], yr[nblock_], yi[nblock_],
+      tgamma[nblock_], tk[nblock_];
+    int latsign[nblock_], lonsign[nblock_];
+    bool backside[nblock_];
+    for (size_t j0 = 0; j0 < nz; j0 += nblock_) {
+      int m = int(min(size_t(nblock_), nz - j0));
+      for (int l = 0; l < m; ++l) {
+        real tlon = Math::AngDiff(Math::AngNormalize(lon0[j0 + l]), lon);
+        latsign[l] = latsign0;
+        lonsign[l] = tlon < 0 ? -1 : 1;
+        tlon *= lonsign[l];
+        backside[l] = tlon > 90;
+        if (backside[l]) {
+          if (lat == 0)
+            latsign[l] = -1;
+          tlon = 180 - tlon;
+        }
+        real lam = tlon * Math::degree();
+        if (lat != 90) {
+          real c = max(real(0), cos(lam));
+          xip[l] = atan2(taup, c);
+          etap[l] = Math::asinh(sin(lam) / Math::hypot(taup, c));
+          if (gkp) {
+            tgamma[l] = atan(Math::tand(tlon) * taup / taupn);
+            tk[l] = kphi / Math::hypot(taup, c);
+          }
+        } else {
+          xip[l] = Math::pi()/2;
+          etap[l] = 0;
+          tgamma[l] = lam;
+          tk[l] = _c;
+        }
+      }
+      Clenshaw(m, real(1), _alp, gkp, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        real xi = xip[l], eta = etap[l];
+        y[j0 + l] =
+          _a1 * _k0 * (backside[l] ? Math::pi() - xi : xi) * latsign[l];
+        x[j0 + l] = _a1 * _k0 * eta * lonsign[l];
+        if (gkp) {
+          real g = tgamma[l], kk = tk[l];
+          g -= atan2(yi[l], yr[l]);
+          kk *= _b1 * Math::hypot(yr[l], yi[l]);
+          g /= Math::degree();
+          if (backside[l])
+            g = 180 - g;
+          g *= latsign[l] * lonsign[l];
+          kk *= _k0;
+          if (gamma) gamma[j0 + l] = g;
+          if (k) k[j0 + l] = kk;
+        }
+      }
+    }
+  }
+
+  void TransverseMercator::Reverse(real lon0,
+                                   const real* x, const real* y, size_t n,
+                                   real* lat, real* lon, real* gamma, real* k,
+                                   int nthreads) const {
+#if GEOGRAPHICLIB_TRANSVERSEMERCATOR_THREADS
+    // Divide the whole blocks of points into nthreads contiguous ranges
+    // which are run by the current Executor.
+    size_t nblocks = (n + nblock_ - 1) / nblock_;
+    Executor::For(nblocks, size_t(max(nthreads, 1)),
+                  [&](size_t b0, size_t b1) {
+                    size_t
+                      i0 = min(n, b0 * nblock_),
+                      i1 = min(n, b1 * nblock_);
+                    ReverseRange(lon0, x, y, i0, i1, lat, lon, gamma, k);
+                  });
+#else
+    (void)nthreads;
+    ReverseRange(lon0, x, y, 0, n, lat, lon, gamma, k);
+#endif
+  }
+
+  void TransverseMercator::ReverseRange(real lon0,
+                                        const real* x, const real* y,
+                                        size_t i0, size_t i1,
+                                        real* lat, real* lon,
+                                        real* gamma, real* k) const {
+    bool gkp = gamma || k;
+    lon0 = Math::AngNormalize(lon0);
+    real xip[nblock_], etap[nblock_], yr[nblock_], yi[nblock_];
+    int xisign[nblock_], etasign[nblock_];
+    bool backside[nblock_];
+    for (size_t j0 = i0; j0 < i1; j0 += nblock_) {
+      int m = int(min(size_t(nblock_), i1 - j0));
+      for (int l = 0; l < m; ++l) {
+        real
+          xi = y[j0 + l] / (_a1 * _k0),
+          eta = x[j0 + l] / (_a1 * _k0);
+        xisign[l] = xi < 0 ? -1 : 1;
+        etasign[l] = eta < 0 ? -1 : 1;
+        xi *= xisign[l];
+        eta *= etasign[l];
+        backside[l] = xi > Math::pi()/2;
+        if (backside[l])
+          xi = Math::pi() - xi;
+        xip[l] = xi; etap[l] = eta;
+      }
+      Clenshaw(m, real(-1), _bet, gkp, xip, etap, yr, yi);
+      // Convert from the Gauss-Schreiber coordinates as in the scalar
+      // Reverse.
+      for (int l = 0; l < m; ++l) {
+        real g = 0, kk = 0;
+        if (gkp) {
+          g = atan2(yi[l], yr[l]);
+          kk = _b1 / Math::hypot(yr[l], yi[l]);
+        }
+        real lam, phi;
+        real
+          s = sinh(etap[l]),
+          c = max(real(0), cos(xip[l])),
+          r = Math::hypot(s, c);
+        if (r != 0) {
+          lam = atan2(s, c);
+          real
+            sxip = sin(xip[l]),
+            tau = Math::tauf(sxip/r, _es);
+          phi = atan(tau);
+          if (gkp) {
+            g += atan2(sxip * tanh(etap[l]), c);
+            kk *= sqrt(_e2m + _e2 * Math::sq(cos(phi))) *
+              Math::hypot(real(1), tau) * r;
+          }
+        } else {
+          phi = Math::pi()/2;
+          lam = 0;
+          kk *= _c;
+        }
+        lat[j0 + l] = phi / Math::degree() * xisign[l];
+        real tlon = lam / Math::degree();
+        if (backside[l])
+          tlon = 180 - tlon;
+        tlon *= etasign[l];
+        lon[j0 + l] = Math::AngNormalize(tlon + lon0);
+        if (gkp) {
+          g /= Math::degree();
+          if (backside[l])
+            g = 180 - g;
+          g *= xisign[l] * etasign[l];
+          kk *= _k0;
+          if (gamma) gamma[j0 + l] = g;
+          if (k) k[j0 + l] = kk;
+        }
+      }
+    }
+  }
+
+#if GEOGRAPHICLIB_PRECISION != 1
+  GEOGRAPHICLIB_TARGET_CLONES
+  void TransverseMercator::ClenshawF(int m, float sgn, const float c[],
+                                     bool gkp, float zetar[], float zetai[],
+                                     float yr[], float yi[]) const {
+    // The same as Clenshaw with floats and the series truncated at floatpow_.
+    typedef float T;
+    T ar[nblockf_], ai[nblockf_], br[nblockf_], bi[nblockf_],
+      xi0[nblockf_], eta0[nblockf_], xi1[nblockf_], eta1[nblockf_],
+      yr0[nblockf_], yi0[nblockf_], yr1[nblockf_], yi1[nblockf_];
+    for (int l = 0; l < m; ++l) {
+      T
+        c0 = cos(2 * zetar[l]), ch0 = cosh(2 * zetai[l]),
+        s0 = sin(2 * zetar[l]), sh0 = sinh(2 * zetai[l]);
+      ar[l] = 2 * c0 * ch0; ai[l] = -2 * s0 * sh0; // 2 * cos(2*zeta)
+      br[l] = s0 * ch0; bi[l] = c0 * sh0;          // sin(2*zeta)
+    }
+    // floatpow_ is even
+    int n = floatpow_;
+    for (int l = 0; l < m; ++l) {
+      xi0[l] = eta0[l] = xi1[l] = eta1[l] = 0;
+    }
+    if (gkp) {
+      for (int l = 0; l < m; ++l)
+        yr0[l] = yi0[l] = yr1[l] = yi1[l] = 0;
+    }
+    while (n) {
+      for (int l = 0; l < m; ++l) {
+        xi1[l]  = ar[l] * xi0[l] - ai[l] * eta0[l] - xi1[l] + sgn * c[n];
+        eta1[l] = ai[l] * xi0[l] + ar[l] * eta0[l] - eta1[l];
+      }
+      if (gkp) {
+        for (int l = 0; l < m; ++l) {
+          yr1[l] = ar[l] * yr0[l] - ai[l] * yi0[l] - yr1[l] +
+            sgn * (2 * n * c[n]);
+          yi1[l] = ai[l] * yr0[l] + ar[l] * yi0[l] - yi1[l];
+        }
+      }
+      --n;
+      for (int l = 0; l < m; ++l) {
+        xi0[l]  = ar[l] * xi1[l] - ai[l] * eta1[l] - xi0[l] + sgn * c[n];
+        eta0[l] = ai[l] * xi1[l] + ar[l] * eta1[l] - eta0[l];
+      }
+      if (gkp) {
+        for (int l = 0; l < m; ++l) {
+          yr0[l] = ar[l] * yr1[l] - ai[l] * yi1[l] - yr0[l] +
+            sgn * (2 * n * c[n]);
+          yi0[l] = ai[l] * yr1[l] + ar[l] * yi1[l] - yi0[l];
+        }
+      }
+      --n;
+    }
+    if (gkp) {
+      for (int l = 0; l < m; ++l) {
+        T cr = ar[l] / 2, ci = ai[l] / 2; // cos(2*zeta)
+        yr[l] = 1 - yr1[l] + cr * yr0[l] - ci * yi0[l];
+        yi[l] =   - yi1[l] + ci * yr0[l] + cr * yi0[l];
+      }
+    }
+    for (int l = 0; l < m; ++l) {
+      T xi = zetar[l], eta = zetai[l];
+      zetar[l] = xi  + br[l] * xi0[l] - bi[l] * eta0[l];
+      zetai[l] = eta + bi[l] * xi0[l] + br[l] * eta0[l];
+    }
+  }
+
+  void TransverseMercator::Forward(real lon0,
+                                   const float* lat, const float* lon,
+                                   size_t n, float* x, float* y,
+                                   float* gamma, float* k) const {
+    typedef float T;
+    bool gkp = gamma || k;
+    const T
+      lon0f = T(Math::AngNormalize(lon0)), degree = Math::degree<T>(),
+      pi = Math::pi<T>(), es = T(_es), e2 = T(_e2), e2m = T(_e2m),
+      c0 = T(_c), a1k0 = T(_a1 * _k0), b1k0 = T(_b1 * _k0);
+    T
+      xip[nblockf_], etap[nblockf_], yr[nblockf_], yi[nblockf_],
+      tgamma[nblockf_], tk[nblockf_];
+    int latsign[nblockf_], lonsign[nblockf_];
+    bool backside[nblockf_];
+    for (size_t i0 = 0; i0 < n; i0 += nblockf_) {
+      int m = int(min(size_t(nblockf_), n - i0));
+      for (int l = 0; l < m; ++l) {
+        T
+          tlat = lat[i0 + l],
+          tlon = Math::AngDiff(lon0f, Math::AngNormalize(lon[i0 + l]));
+        latsign[l] = tlat < 0 ? -1 : 1;
+        lonsign[l] = tlon < 0 ? -1 : 1;
+        tlon *= lonsign[l];
+        tlat *= latsign[l];
+        backside[l] = tlon > 90;
+        if (backside[l]) {
+          if (tlat == 0)
+            latsign[l] = -1;
+          tlon = 180 - tlon;
+        }
+        T
+          phi = tlat * degree,
+          lam = tlon * degree;
+        if (tlat != 90) {
+          T
+            c = max(T(0), cos(lam)),
+            tau = tan(phi),
+            taup = Math::taupf(tau, es);
+          xip[l] = atan2(taup, c);
+          etap[l] = Math::asinh(sin(lam) / Math::hypot(taup, c));
+          if (gkp) {
+            tgamma[l] = atan(Math::tand(tlon) *
+                             taup / Math::hypot(T(1), taup));
+            tk[l] = sqrt(e2m + e2 * Math::sq(cos(phi))) *
+              Math::hypot(T(1), tau) / Math::hypot(taup, c);
+          }
+        } else {
+          xip[l] = pi/2;
+          etap[l] = 0;
+          tgamma[l] = lam;
+          tk[l] = c0;
+        }
+      }
+      ClenshawF(m, T(1), _alpf, gkp, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        T xi = xip[l], eta = etap[l];
+        y[i0 + l] = a1k0 * (backside[l] ? pi - xi : xi) * latsign[l];
+        x[i0 + l] = a1k0 * eta * lonsign[l];
+        if (gkp) {
+          T g = tgamma[l] - atan2(yi[l], yr[l]),
+            kk = tk[l] * b1k0 * Math::hypot(yr[l], yi[l]);
+          g /= degree;
+          if (backside[l])
+            g = 180 - g;
+          g *= latsign[l] * lonsign[l];
+          if (gamma) gamma[i0 + l] = g;
+          if (k) k[i0 + l] = kk;
+        }
+      }
+    }
+  }
+
+  void TransverseMercator::Reverse(real lon0,
+                                   const float* x, const float* y, size_t n,
+                                   float* lat, float* lon,
+                                   float* gamma, float* k) const {
+    typedef float T;
+    bool gkp = gamma || k;
+    const T
+      lon0f = T(Math::AngNormalize(lon0)), degree = Math::degree<T>(),
+      pi = Math::pi<T>(), es = T(_es), e2 = T(_e2), e2m = T(_e2m),
+      c0 = T(_c), a1k0 = T(_a1 * _k0), b1 = T(_b1), k0 = T(_k0);
+    T xip[nblockf_], etap[nblockf_], yr[nblockf_], yi[nblockf_];
+    int xisign[nblockf_], etasign[nblockf_];
+    bool backside[nblockf_];
+    for (size_t i0 = 0; i0 < n; i0 += nblockf_) {
+      int m = int(min(size_t(nblockf_), n - i0));
+      for (int l = 0; l < m; ++l) {
+        T
+          xi = y[i0 + l] / a1k0,
+          eta = x[i0 + l] / a1k0;
+        xisign[l] = xi < 0 ? -1 : 1;
+        etasign[l] = eta < 0 ? -1 : 1;
+        xi *= xisign[l];
+        eta *= etasign[l];
+        backside[l] = xi > pi/2;
+        if (backside[l])
+          xi = pi - xi;
+        xip[l] = xi; etap[l] = eta;
+      }
+      ClenshawF(m, T(-1), _betf, gkp, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        T g = 0, kk = 0;
+        if (gkp) {
+          g = atan2(yi[l], yr[l]);
+          kk = b1 / Math::hypot(yr[l], yi[l]);
+        }
+        T lam, phi;
+        T
+          s = sinh(etap[l]),
+          c = max(T(0), cos(xip[l])),
+          r = Math::hypot(s, c);
+        if (r != 0) {
+          lam = atan2(s, c);
+          T
+            sxip = sin(xip[l]),
+            tau = Math::tauf(sxip/r, es);
+          phi = atan(tau);
+          if (gkp) {
+            g += atan2(sxip * tanh(etap[l]), c);
+            kk *= sqrt(e2m + e2 * Math::sq(cos(phi))) *
+              Math::hypot(T(1), tau) * r;
+          }
+        } else {
+          phi = pi/2;
+          lam = 0;
+          kk *= c0;
+        }
+        lat[i0 + l] = phi / degree * xisign[l];
+        T tlon = lam / degree;
+        if (backside[l])
+          tlon = 180 - tlon;
+        tlon *= etasign[l];
+        lon[i0 + l] = Math::AngNormalize(tlon + lon0f);
+        if (gkp) {
+          g /= degree;
+          if (backside[l])
+            g = 180 - g;
+          g *= xisign[l] * etasign[l];
+          kk *= k0;
+          if (gamma) gamma[i0 + l] = g;
+          if (k) k[i0 + l] = kk;
+        }
+      }
+    }
+  }
+#endif
+
+  void TransverseMercator::Transfer(real lon0in,
+                                    const real* xin, const real* yin,
+                                    size_t n, real lon0out,
+                                    real* xout, real* yout) const {
+    // The rotation from lon0in to lon0out
+    real sdlon, cdlon;
+    Math::sincosd(Math::AngDiff(Math::AngNormalize(lon0out),
+                                Math::AngNormalize(lon0in)), sdlon, cdlon);
+    real xip[nblock_], etap[nblock_], yr[nblock_], yi[nblock_];
+    int latsign[nblock_], lonsign[nblock_];
+    bool backside[nblock_];
+    for (size_t i0 = 0; i0 < n; i0 += nblock_) {
+      int m = int(min(size_t(nblock_), n - i0));
+      // Reverse to the Gauss-Schreiber coordinates as in Reverse
+      for (int l = 0; l < m; ++l) {
+        real
+          xi = yin[i0 + l] / (_a1 * _k0),
+          eta = xin[i0 + l] / (_a1 * _k0);
+        latsign[l] = xi < 0 ? -1 : 1;
+        lonsign[l] = eta < 0 ? -1 : 1;
+        xi *= latsign[l];
+        eta *= lonsign[l];
+        backside[l] = xi > Math::pi()/2;
+        if (backside[l])
+          xi = Math::pi() - xi;
+        xip[l] = xi; etap[l] = eta;
+      }
+      Clenshaw(m, real(-1), _bet, false, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        real
+          s = sinh(etap[l]),
+          c = max(real(0), cos(xip[l])),
+          r = Math::hypot(s, c);
+        if (r != 0) {
+          // tan(phi') and the longitude relative to lon0in
+          real
+            taup = sin(xip[l]) / r,
+            slam = lonsign[l] * s / r,
+            clam = (backside[l] ? -c : c) / r,
+            // Rotate to the longitude relative to lon0out and map to the
+            // Gauss-Schreiber coordinates as in Forward.
+            slam1 = slam * cdlon + clam * sdlon,
+            clam1 = clam * cdlon - slam * sdlon;
+          lonsign[l] = slam1 < 0 ? -1 : 1;
+          slam1 *= lonsign[l];
+          backside[l] = clam1 < 0;
+          if (backside[l]) {
+            if (taup == 0)
+              latsign[l] = -1;
+            clam1 = -clam1;
+          }
+          c = max(real(0), clam1);
+          xip[l] = atan2(taup, c);
+          etap[l] = Math::asinh(slam1 / Math::hypot(taup, c));
+        } else {
+          // At a pole
+          lonsign[l] = 1;
+          backside[l] = false;
+          xip[l] = Math::pi()/2;
+          etap[l] = 0;
+        }
+      }
+      Clenshaw(m, real(1), _alp, false, xip, etap, yr, yi);
+      for (int l = 0; l < m; ++l) {
+        real xi = xip[l], eta = etap[l];
+        yout[i0 + l] =
+          _a1 * _k0 * (backside[l] ? Math::pi() - xi : xi) * latsign[l];
+        xout[i0 + l] = _a1 * _k0 * eta * lonsign[l];
+      }
+    }
+  }
+
 } // namespace GeographicLib
@@ -40,6 +40,7 @@
  **********************************************************************/
 
 #include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/Instrumentation.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions
@@ -56,6 +57,7 @@ namespace GeographicLib {
     , tol1_(real(0.1) * sqrt(tol_))
     , tol2_(real(0.1) * tol_)
     , taytol_(pow(tol_, real(0.6)))
+    , warmtol_(real(1)/128)
     , _a(a)
     , _f(f <= 1 ? f : 1/f)
     , _k0(k0)
@@ -74,6 +76,9 @@ namespace GeographicLib {
       throw GeographicErr("Minor radius is not positive");
     if (!(Math::isfinite(_k0) && _k0 > 0))
       throw GeographicErr("Scale is not positive");
+    // The moduli are fixed so save the AGM sequences used by sncndn.
+    _Eu.PrecomputeJacobi();
+    _Ev.PrecomputeJacobi();
   }
 
   const TransverseMercatorExact& TransverseMercatorExact::UTM() {
@@ -182,13 +187,36 @@ namespace GeographicLib {
   }
 
   // Invert zeta using Newton's method
-  void TransverseMercatorExact::zetainv(real taup, real lam, real& u, real& v)
-    const  {
+  int TransverseMercatorExact::zetainv(real taup, real lam, real& u, real& v,
+                                       Guess* g) const {
     real
       psi = Math::asinh(taup),
       scal = 1/Math::hypot(real(1), taup);
+    // Only points away from the branch point are used for warm starts
+    bool regular = lam <= (1 - 2 * _e) * Math::pi()/2;
+    if (g) {
+      bool warm = g->valid && regular &&
+        abs(psi - g->a) + abs(lam - g->b) < warmtol_;
+      g->valid = false;
+      if (warm) {
+        // Extrapolate from the previous solution using dw/dzeta
+        real dpsi = psi - g->a, dlam = lam - g->b;
+        u = g->u + (g->du * dpsi - g->dv * dlam);
+        v = g->v + (g->dv * dpsi + g->du * dlam);
+        int n = zetanewton(taup, lam, psi, scal, u, v, regular ? g : 0);
+        if (n > 0)
+          return n;
+        // Else fall back to the usual starting point
+      }
+    }
     if (zetainv0(psi, lam, u, v))
-      return;
+      return 0;
+    return abs(zetanewton(taup, lam, psi, scal, u, v, regular ? g : 0));
+  }
+
+  int TransverseMercatorExact::zetanewton(real taup, real lam,
+                                          real psi, real scal,
+                                          real& u, real& v, Guess* g) const {
     real stol2 = tol2_ / Math::sq(max(psi, real(1)));
     // min iterations = 2, max iterations = 6; mean = 4.0
     for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
@@ -206,12 +234,23 @@ namespace GeographicLib {
         delv = tau1 * dv1 + lam1 * du1;
       u -= delu;
       v -= delv;
-      if (trip)
-        break;
+      if (trip) {
+        if (g) {
+          g->valid = true;
+          g->a = psi; g->b = lam;
+          g->u = u; g->v = v;
+          g->du = du1; g->dv = dv1;
+        }
+        GEOGRAPHICLIB_HISTOGRAM(TMEXACT_ITERATIONS, i + 1);
+        return i + 1;
+      }
       real delw2 = Math::sq(delu) + Math::sq(delv);
       if (!(delw2 >= stol2))
         ++trip;
     }
+    GEOGRAPHICLIB_HISTOGRAM(TMEXACT_ITERATIONS, numit_);
+    GEOGRAPHICLIB_COUNT(TMEXACT_ZETAINV_FAIL);
+    return -numit_;
   }
 
   void TransverseMercatorExact::sigma(real /*u*/, real snu, real cnu, real dnu,
@@ -290,10 +329,32 @@ namespace GeographicLib {
   }
 
   // Invert sigma using Newton's method
-  void TransverseMercatorExact::sigmainv(real xi, real eta, real& u, real& v)
-    const {
+  int TransverseMercatorExact::sigmainv(real xi, real eta, real& u, real& v,
+                                        Guess* g) const {
+    // Only points where sigmainv0 uses w = sigma * Eu.K/Eu.E are used for
+    // warm starts
+    bool regular = eta <= real(0.75) * _Ev.KE() && xi >= -real(0.25) * _Eu.E();
+    if (g) {
+      bool warm = g->valid && regular &&
+        abs(xi - g->a) + abs(eta - g->b) < warmtol_;
+      g->valid = false;
+      if (warm) {
+        // Extrapolate from the previous solution using dw/dsigma
+        real dxi = xi - g->a, deta = eta - g->b;
+        u = g->u + (g->du * dxi - g->dv * deta);
+        v = g->v + (g->dv * dxi + g->du * deta);
+        int n = sigmanewton(xi, eta, u, v, regular ? g : 0);
+        if (n > 0)
+          return n;
+      }
+    }
     if (sigmainv0(xi, eta, u, v))
-      return;
+      return 0;
+    return abs(sigmanewton(xi, eta, u, v, regular ? g : 0));
+  }
+
+  int TransverseMercatorExact::sigmanewton(real xi, real eta,
+                                           real& u, real& v, Guess* g) const {
     // min iterations = 2, max iterations = 7; mean = 3.9
     for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       real snu, cnu, dnu, snv, cnv, dnv;
@@ -309,12 +370,23 @@ namespace GeographicLib {
         delv = xi1 * dv1 + eta1 * du1;
       u -= delu;
       v -= delv;
-      if (trip)
-        break;
+      if (trip) {
+        if (g) {
+          g->valid = true;
+          g->a = xi; g->b = eta;
+          g->u = u; g->v = v;
+          g->du = du1; g->dv = dv1;
+        }
+        GEOGRAPHICLIB_HISTOGRAM(TMEXACT_ITERATIONS, i + 1);
+        return i + 1;
+      }
       real delw2 = Math::sq(delu) + Math::sq(delv);
       if (!(delw2 >= tol2_))
         ++trip;
     }
+    GEOGRAPHICLIB_HISTOGRAM(TMEXACT_ITERATIONS, numit_);
+    GEOGRAPHICLIB_COUNT(TMEXACT_SIGMAINV_FAIL);
+    return -numit_;
   }
 
   void TransverseMercatorExact::Scale(real tau, real /*lam*/,
@@ -346,6 +418,29 @@ namespace GeographicLib {
   void TransverseMercatorExact::Forward(real lon0, real lat, real lon,
                                         real& x, real& y, real& gamma, real& k)
     const {
+    GenForward(lon0, lat, lon, x, y, gamma, k, true, 0);
+  }
+
+  size_t TransverseMercatorExact::Forward(real lon0,
+                                          const real* lat, const real* lon,
+                                          size_t n, real* x, real* y,
+                                          real* gamma, real* k) const {
+    bool scalep = gamma || k;
+    real t;
+    size_t nit = 0;
+    Guess g;
+    g.valid = false;
+    for (size_t i = 0; i < n; ++i) {
+      nit += GenForward(lon0, lat[i], lon[i], x[i], y[i],
+                        gamma ? gamma[i] : t, k ? k[i] : t, scalep, &g);
+    }
+    return nit;
+  }
+
+  int TransverseMercatorExact::GenForward(real lon0, real lat, real lon,
+                                          real& x, real& y,
+                                          real& gamma, real& k,
+                                          bool scalep, Guess* g) const {
     lon = Math::AngDiff(Math::AngNormalize(lon0), Math::AngNormalize(lon));
     // Explicitly enforce the parity
     int
@@ -365,6 +460,7 @@ namespace GeographicLib {
 
     // u,v = coordinates for the Thompson TM, Lee 54
     real u, v;
+    int nit = 0;
     if (lat == 90) {
       u = _Eu.K();
       v = 0;
@@ -373,7 +469,7 @@ namespace GeographicLib {
       v = _Ev.K();
     } else
       // tau = tan(phi), taup = sinh(psi)
-      zetainv(Math::taupf(tau, _e), lam, u, v);
+      nit = zetainv(Math::taupf(tau, _e), lam, u, v, g);
 
     real snu, cnu, dnu, snv, cnv, dnv;
     _Eu.sncndn(u, snu, cnu, dnu);
@@ -385,6 +481,8 @@ namespace GeographicLib {
       xi = 2 * _Eu.E() - xi;
     y = xi * _a * _k0 * latsign;
     x = eta * _a * _k0 * lonsign;
+    if (!scalep)
+      return nit;
 
     if (lat == 90) {
       gamma = lon;
@@ -400,12 +498,35 @@ namespace GeographicLib {
       gamma = 180 - gamma;
     gamma *= latsign * lonsign;
     k *= _k0;
+    return nit;
   }
 
   void TransverseMercatorExact::Reverse(real lon0, real x, real y,
                                         real& lat, real& lon,
                                         real& gamma, real& k)
     const {
+    GenReverse(lon0, x, y, lat, lon, gamma, k, true, 0);
+  }
+
+  size_t TransverseMercatorExact::Reverse(real lon0,
+                                          const real* x, const real* y,
+                                          size_t n, real* lat, real* lon,
+                                          real* gamma, real* k) const {
+    bool scalep = gamma || k;
+    real t;
+    size_t nit = 0;
+    Guess g;
+    g.valid = false;
+    for (size_t i = 0; i < n; ++i)
+      nit += GenReverse(lon0, x[i], y[i], lat[i], lon[i],
+                        gamma ? gamma[i] : t, k ? k[i] : t, scalep, &g);
+    return nit;
+  }
+
+  int TransverseMercatorExact::GenReverse(real lon0, real x, real y,
+                                          real& lat, real& lon,
+                                          real& gamma, real& k,
+                                          bool scalep, Guess* g) const {
     // This undoes the steps in Forward.
     real
       xi = y / (_a * _k0),
@@ -422,11 +543,12 @@ namespace GeographicLib {
 
     // u,v = coordinates for the Thompson TM, Lee 54
     real u, v;
+    int nit = 0;
     if (xi == 0 && eta == _Ev.KE()) {
       u = 0;
       v = _Ev.K();
     } else
-      sigmainv(xi, eta, u, v);
+      nit = sigmainv(xi, eta, u, v, g);
 
     real snu, cnu, dnu, snv, cnv, dnv;
     _Eu.sncndn(u, snu, cnu, dnu);
@@ -438,8 +560,10 @@ namespace GeographicLib {
       phi = atan(tau);
       lat = phi / Math::degree();
       lon = lam / Math::degree();
-      Scale(tau, lam, snu, cnu, dnu, snv, cnv, dnv, gamma, k);
-      gamma /= Math::degree();
+      if (scalep) {
+        Scale(tau, lam, snu, cnu, dnu, snv, cnv, dnv, gamma, k);
+        gamma /= Math::degree();
+      }
     } else {
       lat = 90;
       lon = lam = gamma = 0;
@@ -451,10 +575,13 @@ namespace GeographicLib {
     lon *= lonsign;
     lon = Math::AngNormalize(lon + Math::AngNormalize(lon0));
     lat *= latsign;
+    if (!scalep)
+      return nit;
     if (backside)
       gamma = 180 - gamma;
     gamma *= latsign * lonsign;
     k *= _k0;
+    return nit;
   }
 
 } // namespace GeographicLib
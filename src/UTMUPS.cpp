@@ -7,6 +7,7 @@
  * http://geographiclib.sourceforge.net/
  **********************************************************************/
 
+#include <cstring>
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/PolarStereographic.hpp>
@@ -39,43 +40,33 @@ namespace GeographicLib {
       (MGRS::maxutmSrow_ + MGRS::maxutmNrow_ - MGRS::minutmNrow_) * MGRS::tile_,
       MGRS::maxutmNrow_ * MGRS::tile_ };
 
-  int UTMUPS::StandardZone(real lat, real lon, int setzone) {
-    if (!(setzone >= MINPSEUDOZONE && setzone <= MAXZONE))
-      throw GeographicErr("Illegal zone requested " + Utility::str(setzone));
-    if (setzone >= MINZONE || setzone == INVALID)
-      return setzone;
-    if (Math::isnan(lat) || Math::isnan(lon)) // Check if lat or lon is a NaN
-      return INVALID;
-    if (setzone == UTM || (lat >= -80 && lat < 84)) {
-      // Assume lon is in [-540, 540).
-      int ilon = int(floor(lon));
-      if (ilon >= 180)
-        ilon -= 360;
-      else if (ilon < -180)
-        ilon += 360;
-      int zone = (ilon + 186)/6;
-      int band = MGRS::LatitudeBand(lat);
-      if (band == 7 && zone == 31 && ilon >= 3)
-        zone = 32;
-      else if (band == 9 && ilon >= 0 && ilon < 42)
-        zone = 2 * ((ilon + 183)/12) + 1;
-      return zone;
-    } else
-      return UPS;
+  void UTMUPS::IllegalZone(int setzone) {
+    throw GeographicErr("Illegal zone requested " + Utility::str(setzone));
   }
 
   void UTMUPS::Forward(real lat, real lon,
                        int& zone, bool& northp, real& x, real& y,
                        real& gamma, real& k,
                        int setzone, bool mgrslimits) {
-    CheckLatLon(lat, lon);
+    Forward(lat, lon, zone, northp, x, y, gamma, k, setzone, mgrslimits, true);
+  }
+
+  int UTMUPS::Forward(real lat, real lon,
+                      int& zone, bool& northp, real& x, real& y,
+                      real& gamma, real& k,
+                      int setzone, bool mgrslimits, bool throwp) {
+    if (!CheckLatLon(lat, lon, throwp)) return BADLATLON;
+    if (!(setzone >= MINPSEUDOZONE && setzone <= MAXZONE)) {
+      if (!throwp) return BADZONE;
+      throw GeographicErr("Illegal zone requested " + Utility::str(setzone));
+    }
     bool northp1 = lat >= 0;
     int zone1 = StandardZone(lat, lon, setzone);
     if (zone1 == INVALID) {
       zone = zone1;
       northp = northp1;
       x = y = gamma = k = Math::NaN();
-      return;
+      return OK;
     }
     real x1, y1, gamma1, k1;
     bool utmp = zone1 != UPS;
@@ -84,49 +75,244 @@ namespace GeographicLib {
         lon0 = CentralMeridian(zone1),
         dlon = lon - lon0;
       dlon = abs(dlon - 360 * floor((dlon + 180)/360));
-      if (!(dlon <= 60))
+      if (!(dlon <= 60)) {
+        if (!throwp) return BADZONE;
         // Check isn't really necessary because CheckCoords catches this case.
         // But this allows a more meaningful error message to be given.
         throw GeographicErr("Longitude " + Utility::str(lon)
                             + "d more than 60d from center of UTM zone "
                             + Utility::str(zone1));
+      }
       TransverseMercator::UTM().Forward(lon0, lat, lon, x1, y1, gamma1, k1);
     } else {
-      if (abs(lat) < 70)
+      if (abs(lat) < 70) {
+        if (!throwp) return BADZONE;
         // Check isn't really necessary ... (see above).
         throw GeographicErr("Latitude " + Utility::str(lat)
                             + "d more than 20d from "
                             + (northp1 ? "N" : "S") + " pole");
+      }
       PolarStereographic::UPS().Forward(northp1, lat, lon, x1, y1, gamma1, k1);
     }
     int ind = (utmp ? 2 : 0) + (northp1 ? 1 : 0);
     x1 += falseeasting_[ind];
     y1 += falsenorthing_[ind];
-    if (! CheckCoords(zone1 != UPS, northp1, x1, y1, mgrslimits, false) )
+    if (! CheckCoords(zone1 != UPS, northp1, x1, y1, mgrslimits, false) ) {
+      if (!throwp) return BADCOORDS;
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + ", longitude " + Utility::str(lon)
                           + " out of legal range for "
                           + (utmp ? "UTM zone " + Utility::str(zone1) : "UPS"));
+    }
     zone = zone1;
     northp = northp1;
     x = x1;
     y = y1;
     gamma = gamma1;
     k = k1;
+    return OK;
+  }
+
+  int UTMUPS::ForwardUTMRun(int zone, const real blat[], const real blon[],
+                            const bool bnorth[], const size_t bind[], int nr,
+                            bool mgrslimits,
+                            int zonev[], bool northpv[], real x[], real y[],
+                            real gamma[], real k[], int err[]) {
+    real bx[nbatch_], by[nbatch_], bgamma[nbatch_], bk[nbatch_];
+    TransverseMercator::UTM().Forward(CentralMeridian(zone), blat, blon, nr,
+                                      bx, by,
+                                      gamma ? bgamma : 0, k ? bk : 0);
+    int nbad = 0;
+    for (int j = 0; j < nr; ++j) {
+      size_t i = bind[j];
+      int ind = 2 + (bnorth[j] ? 1 : 0);
+      real x1 = bx[j] + falseeasting_[ind], y1 = by[j] + falsenorthing_[ind];
+      bool ok = CheckCoords(true, bnorth[j], x1, y1, mgrslimits, false);
+      zonev[i] = ok ? zone : int(INVALID);
+      northpv[i] = bnorth[j];
+      x[i] = ok ? x1 : Math::NaN();
+      y[i] = ok ? y1 : Math::NaN();
+      if (gamma) gamma[i] = ok ? bgamma[j] : Math::NaN();
+      if (k) k[i] = ok ? bk[j] : Math::NaN();
+      if (err) err[i] = ok ? OK : BADCOORDS;
+      if (!ok) ++nbad;
+    }
+    return nbad;
+  }
+
+  size_t UTMUPS::ForwardBatch(const real* lat, const real* lon, size_t n,
+                              int* zone, bool* northp, real* x, real* y,
+                              real* gamma, real* k, int* err,
+                              int setzone, bool mgrslimits) {
+    if (!(setzone >= MINPSEUDOZONE && setzone <= MAXZONE))
+      throw GeographicErr("Illegal zone requested " + Utility::str(setzone));
+    // The pending run of UTM points, all in zone rzone.
+    real blat[nbatch_], blon[nbatch_];
+    bool bnorth[nbatch_];
+    size_t bind[nbatch_];
+    int nr = 0, rzone = INVALID;
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      real lat1 = lat[i], lon1 = lon[i];
+      if (CheckLatLon(lat1, lon1, false)) {
+        int zone1 = StandardZone(lat1, lon1, setzone);
+        if (zone1 != INVALID && zone1 != UPS) {
+          real dlon = lon1 - CentralMeridian(zone1);
+          dlon = abs(dlon - 360 * floor((dlon + 180)/360));
+          if (dlon <= 60) {
+            // Defer this point to be converted with the rest of the run.
+            if (nr == nbatch_ || (nr > 0 && zone1 != rzone)) {
+              nbad += ForwardUTMRun(rzone, blat, blon, bnorth, bind, nr,
+                                    mgrslimits, zone, northp, x, y,
+                                    gamma, k, err);
+              nr = 0;
+            }
+            rzone = zone1;
+            blat[nr] = lat1; blon[nr] = lon1;
+            bnorth[nr] = lat1 >= 0; bind[nr] = i;
+            ++nr;
+            continue;
+          }
+        }
+      }
+      // UPS, INVALID, and erroneous points are handled individually.
+      real gamma1, k1;
+      int e = Forward(lat1, lon1, zone[i], northp[i], x[i], y[i], gamma1, k1,
+                      setzone, mgrslimits, false);
+      if (e != OK) {
+        zone[i] = INVALID;
+        northp[i] = lat1 >= 0;
+        x[i] = y[i] = gamma1 = k1 = Math::NaN();
+        ++nbad;
+      }
+      if (gamma) gamma[i] = gamma1;
+      if (k) k[i] = k1;
+      if (err) err[i] = e;
+    }
+    if (nr > 0)
+      nbad += ForwardUTMRun(rzone, blat, blon, bnorth, bind, nr,
+                            mgrslimits, zone, northp, x, y, gamma, k, err);
+    return nbad;
+  }
+
+  int UTMUPS::ForwardZonesRun(real lat, real lon, bool northp,
+                              const int bzone[], const size_t bind[], int nr,
+                              bool mgrslimits,
+                              int zonev[], real x[], real y[],
+                              real gamma[], real k[], int err[]) {
+    real blon0[nbatch_], bx[nbatch_], by[nbatch_],
+      bgamma[nbatch_], bk[nbatch_];
+    for (int j = 0; j < nr; ++j)
+      blon0[j] = CentralMeridian(bzone[j]);
+    TransverseMercator::UTM().Forward(blon0, size_t(nr), lat, lon, bx, by,
+                                      gamma ? bgamma : 0, k ? bk : 0);
+    int ind = 2 + (northp ? 1 : 0), nbad = 0;
+    for (int j = 0; j < nr; ++j) {
+      size_t i = bind[j];
+      real x1 = bx[j] + falseeasting_[ind], y1 = by[j] + falsenorthing_[ind];
+      bool ok = CheckCoords(true, northp, x1, y1, mgrslimits, false);
+      zonev[i] = ok ? bzone[j] : int(INVALID);
+      x[i] = ok ? x1 : Math::NaN();
+      y[i] = ok ? y1 : Math::NaN();
+      if (gamma) gamma[i] = ok ? bgamma[j] : Math::NaN();
+      if (k) k[i] = ok ? bk[j] : Math::NaN();
+      if (err) err[i] = ok ? OK : BADCOORDS;
+      if (!ok) ++nbad;
+    }
+    return nbad;
+  }
+
+  size_t UTMUPS::ForwardZones(real lat, real lon,
+                              const int* setzone, size_t nz,
+                              int* zone, bool& northp, real* x, real* y,
+                              real* gamma, real* k, int* err,
+                              bool mgrslimits) {
+    for (size_t j = 0; j < nz; ++j)
+      if (!(setzone[j] >= MINPSEUDOZONE && setzone[j] <= MAXZONE))
+        throw GeographicErr("Illegal zone requested "
+                            + Utility::str(setzone[j]));
+    bool okll = CheckLatLon(lat, lon, false);
+    northp = lat >= 0;
+    // The pending UTM zones; these are converted together.
+    int bzone[nbatch_];
+    size_t bind[nbatch_];
+    int nr = 0;
+    size_t nbad = 0;
+    for (size_t j = 0; j < nz; ++j) {
+      if (okll) {
+        int zone1 = StandardZone(lat, lon, setzone[j]);
+        if (zone1 != INVALID && zone1 != UPS) {
+          real dlon = lon - CentralMeridian(zone1);
+          dlon = abs(dlon - 360 * floor((dlon + 180)/360));
+          if (dlon <= 60) {
+            if (nr == nbatch_) {
+              nbad += ForwardZonesRun(lat, lon, northp, bzone, bind, nr,
+                                      mgrslimits, zone, x, y, gamma, k, err);
+              nr = 0;
+            }
+            bzone[nr] = zone1; bind[nr] = j;
+            ++nr;
+            continue;
+          }
+        }
+      }
+      // UPS, INVALID, and erroneous cases are handled individually.
+      real gamma1, k1;
+      bool northp1;
+      int e = Forward(lat, lon, zone[j], northp1, x[j], y[j], gamma1, k1,
+                      setzone[j], mgrslimits, false);
+      if (e != OK) {
+        zone[j] = INVALID;
+        x[j] = y[j] = gamma1 = k1 = Math::NaN();
+        ++nbad;
+      }
+      if (gamma) gamma[j] = gamma1;
+      if (k) k[j] = k1;
+      if (err) err[j] = e;
+    }
+    if (nr > 0)
+      nbad += ForwardZonesRun(lat, lon, northp, bzone, bind, nr,
+                              mgrslimits, zone, x, y, gamma, k, err);
+    return nbad;
+  }
+
+  size_t UTMUPS::ForwardZonesBatch(const real* lat, const real* lon, size_t n,
+                                   const int* setzone, size_t nz,
+                                   int* zone, bool* northp,
+                                   real* x, real* y,
+                                   real* gamma, real* k, int* err,
+                                   bool mgrslimits) {
+    size_t nbad = 0;
+    for (size_t i = 0; i < n; ++i) {
+      size_t o = i * nz;
+      nbad += ForwardZones(lat[i], lon[i], setzone, nz, zone + o, northp[i],
+                           x + o, y + o, gamma ? gamma + o : 0,
+                           k ? k + o : 0, err ? err + o : 0, mgrslimits);
+    }
+    return nbad;
   }
 
   void UTMUPS::Reverse(int zone, bool northp, real x, real y,
                        real& lat, real& lon, real& gamma, real& k,
                        bool mgrslimits) {
+    Reverse(zone, northp, x, y, lat, lon, gamma, k, mgrslimits, true);
+  }
+
+  int UTMUPS::Reverse(int zone, bool northp, real x, real y,
+                      real& lat, real& lon, real& gamma, real& k,
+                      bool mgrslimits, bool throwp) {
     if (zone == INVALID || Math::isnan(x) || Math::isnan(y)) {
       lat = lon = gamma = k = Math::NaN();
-      return;
+      return OK;
     }
-    if (!(zone >= MINZONE && zone <= MAXZONE))
+    if (!(zone >= MINZONE && zone <= MAXZONE)) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("Zone " + Utility::str(zone)
                           + " not in range [0, 60]");
+    }
     bool utmp = zone != UPS;
-    CheckCoords(utmp, northp, x, y, mgrslimits);
+    if (!CheckCoords(utmp, northp, x, y, mgrslimits, throwp))
+      return BADCOORDS;
     int ind = (utmp ? 2 : 0) + (northp ? 1 : 0);
     x -= falseeasting_[ind];
     y -= falsenorthing_[ind];
@@ -135,16 +321,22 @@ namespace GeographicLib {
                                         x, y, lat, lon, gamma, k);
     else
       PolarStereographic::UPS().Reverse(northp, x, y, lat, lon, gamma, k);
+    return OK;
   }
 
-  void UTMUPS::CheckLatLon(real lat, real lon) {
-    if (abs(lat) > 90)
+  bool UTMUPS::CheckLatLon(real lat, real lon, bool throwp) {
+    if (abs(lat) > 90) {
+      if (!throwp) return false;
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-90d, 90d]");
-    if (lon < -540 || lon >= 540)
+    }
+    if (lon < -540 || lon >= 540) {
+      if (!throwp) return false;
       throw GeographicErr("Longitude " + Utility::str(lon)
                           + "d not in [-540d, 540d)");
     }
+    return true;
+  }
 
   bool UTMUPS::CheckCoords(bool utmp, bool northp, real x, real y,
                            bool mgrslimits, bool throwp) {
@@ -212,13 +404,22 @@ namespace GeographicLib {
   }
 
   void UTMUPS::DecodeZone(const std::string& zonestr, int& zone, bool& northp) {
+    DecodeZone(zonestr, zone, northp, true);
+  }
+
+  int UTMUPS::DecodeZone(const std::string& zonestr, int& zone, bool& northp,
+                         bool throwp) {
     unsigned zlen = unsigned(zonestr.size());
-    if (zlen == 0)
+    if (zlen == 0) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("Empty zone specification");
+    }
     // Longest zone spec is 32north, 42south, invalid = 7
-    if (zlen > 7)
+    if (zlen > 7) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("More than 7 characters in zone specification "
                           + zonestr);
+    }
 
     const char* c = zonestr.c_str();
     char* q;
@@ -226,33 +427,49 @@ namespace GeographicLib {
     // if (zone1 == 0) zone1 = UPS; (not necessary)
 
     if (zone1 == UPS) {
-      if (!(q == c))
+      if (!(q == c)) {
+        if (!throwp) return BADZONE;
         // Don't allow 0n as an alternative to n for UPS coordinates
         throw GeographicErr("Illegal zone 0 in " + zonestr +
                             ", use just the hemisphere for UPS");
-    } else if (!(zone1 >= MINUTMZONE && zone1 <= MAXUTMZONE))
+      }
+    } else if (!(zone1 >= MINUTMZONE && zone1 <= MAXUTMZONE)) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("Zone " + Utility::str(zone1)
                           + " not in range [1, 60]");
-    else if (!isdigit(zonestr[0]))
+    } else if (!isdigit(zonestr[0])) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("Must use unsigned number for zone "
                           + Utility::str(zone1));
-    else if (q - c > 2)
+    } else if (q - c > 2) {
+      if (!throwp) return BADZONE;
       throw GeographicErr("More than 2 digits use to specify zone "
                           + Utility::str(zone1));
+    }
 
-    string hemi = zonestr.substr(q - c);
-    transform(hemi.begin(), hemi.end(), hemi.begin(), (int(*)(int))tolower);
-    if (q == c && (hemi == "inv" || hemi == "invalid")) {
+    // The hemisphere is at most 7 characters, so lower case it into a fixed
+    // buffer.
+    char hemi[8];
+    int hlen = int(zlen - (q - c));
+    for (int i = 0; i < hlen; ++i)
+      hemi[i] = char(tolower(q[i]));
+    hemi[hlen] = '\0';
+    if (q == c &&
+        (strcmp(hemi, "inv") == 0 || strcmp(hemi, "invalid") == 0)) {
       zone = INVALID;
       northp = false;
-      return;
+      return OK;
     }
-    bool northp1 = hemi == "north" || hemi == "n";
-    if (!(northp1 || hemi == "south" || hemi == "s"))
+    bool northp1 = strcmp(hemi, "north") == 0 || strcmp(hemi, "n") == 0;
+    if (!(northp1 ||
+          strcmp(hemi, "south") == 0 || strcmp(hemi, "s") == 0)) {
+      if (!throwp) return BADZONE;
       throw GeographicErr(string("Illegal hemisphere ") + hemi + " in "
                           + zonestr + ", specify north or south");
+    }
     zone = zone1;
     northp = northp1;
+    return OK;
   }
 
   std::string UTMUPS::EncodeZone(int zone, bool northp, bool abbrev) {
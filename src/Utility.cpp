@@ -8,8 +8,34 @@
  **********************************************************************/
 
 #include <cstdlib>
+#include <cstring>
 #include <GeographicLib/Utility.hpp>
 
+#if !defined(GEOGRAPHICLIB_UTILITY_MMAP)
+#  if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+#    define GEOGRAPHICLIB_UTILITY_MMAP 1
+#  else
+#    define GEOGRAPHICLIB_UTILITY_MMAP 0
+#  endif
+#endif
+
+#if GEOGRAPHICLIB_UTILITY_MMAP
+#  if defined(_WIN32)
+#    if !defined(WIN32_LEAN_AND_MEAN)
+#      define WIN32_LEAN_AND_MEAN 1
+#    endif
+#    if !defined(NOMINMAX)
+#      define NOMINMAX 1
+#    endif
+#    include <windows.h>
+#  else
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#  endif
+#endif
+
 #if defined(_MSC_VER)
 // Squelch warnings about unsafe use of getenv
 #  pragma warning (disable: 4996)
@@ -19,6 +45,266 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    // Copy the n characters of s to buf and return n; the result is
+    // truncated and null terminated as with snprintf.
+    inline int Output(char buf[], size_t len, const char* s, size_t n) {
+      if (len > 0) {
+        size_t m = min(n, len - 1);
+        memcpy(buf, s, m);
+        buf[m] = '\0';
+      }
+      return int(n);
+    }
+
+    // Write the digits of n in reverse order ending just before end, giving
+    // at least mindigits digits, and return the start.
+    inline char* Digits(char* end, unsigned long long n, int mindigits) {
+      while (mindigits-- > 0 || n) {
+        *--end = char('0' + n % 10U);
+        n /= 10U;
+      }
+      return end;
+    }
+
+    // x in the default (%g) format with prec significant digits
+    inline string GeneralStr(Math::real x, int prec) {
+      ostringstream s;
+      s << setprecision(prec) << x;
+      return s.str();
+    }
+
+    // Enough for a sign, the 20 digits of a 64-bit integer, the point, and
+    // 22 leading zeros
+    const int fixedbuf_ = 48;
+
+    // Write -n/10^p (if neg) or n/10^p with p digits after the point ending
+    // just before end, for 0 <= p <= 22, and return the start.
+    inline char* Fixed(char* end, unsigned long long n, int p, bool neg) {
+      char* q = end;
+      if (p > 0) {
+        // 10^19 is the largest power of 10 representable in 64 bits; if p >
+        // 19, all the digits of n follow the point.
+        unsigned long long s = 1;
+        for (int k = min(p, 19); k--;) s *= 10U;
+        q = Digits(q, n % s, p);
+        *--q = '.';
+        n /= s;
+      }
+      q = Digits(q, n, 1);
+      if (neg) *--q = '-';
+      return q;
+    }
+
+#if GEOGRAPHICLIB_PRECISION == 2
+    // Split x into hi + lo where each part has at most 26 significant bits.
+    inline void Split(double x, double& hi, double& lo) {
+      int e;
+      double m = frexp(x, &e);
+      hi = ldexp(floor(ldexp(m, 26) + 0.5), e - 26);
+      lo = x - hi;
+    }
+
+    // The error, a * b - y, in y = a * b (Dekker's TwoProduct).  This is
+    // computed exactly in the absence of overflow and underflow.
+    inline double ProductError(double a, double b, double y) {
+      double ah, al, bh, bl;
+      Split(a, ah, al); Split(b, bh, bl);
+      return al * bl - (((y - ah * bh) - al * bh) - ah * bl);
+    }
+
+    // Round a * 10^p to the nearest integer, with ties to even, for 0 <= p <=
+    // 22 and 0 <= a.  Return false if a * 10^p >= 2^52 (in which case the
+    // product may not be representable to the nearest half integer).
+    inline bool Scaled(double a, int p, double& n, double& scale) {
+      static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+      };
+      scale = pow10[p];
+      double y = a * scale;
+      // Reversed test to reject NaNs
+      if (!(y < 4503599627370496.0)) // 2^52
+        return false;
+      // Since y < 2^52, the half integers are representable and y differs
+      // from a * 10^p by at most half an ulp; so only when y is a half
+      // integer does the error in y affect the rounding.
+      n = floor(y);
+      double f = y - n;
+      if (f > 0.5)
+        n += 1;
+      else if (f == 0.5) {
+        double e = ProductError(a, scale, y);
+        if (e > 0 || (e == 0 && fmod(n, 2.0) != 0))
+          n += 1;
+      }
+      return true;
+    }
+
+    // Unsigned 128-bit integers, hi * 2^64 + lo
+    struct U128 {
+      unsigned long long hi, lo;
+      U128(unsigned long long h, unsigned long long l) : hi(h), lo(l) {}
+      bool operator<(const U128& b) const
+      { return hi < b.hi || (hi == b.hi && lo < b.lo); }
+      bool operator==(const U128& b) const
+      { return hi == b.hi && lo == b.lo; }
+      U128 operator-(const U128& b) const
+      { return U128(hi - b.hi - (lo < b.lo ? 1U : 0U), lo - b.lo); }
+      // Shifts by 0 <= k < 128
+      U128 operator>>(int k) const {
+        return k == 0 ? *this : k >= 64 ? U128(0, hi >> (k - 64)) :
+          U128(hi >> k, (lo >> k) | (hi << (64 - k)));
+      }
+      U128 operator<<(int k) const {
+        return k == 0 ? *this : k >= 64 ? U128(lo << (k - 64), 0) :
+          U128((hi << k) | (lo >> (64 - k)), lo << k);
+      }
+      // The low k bits, 0 < k < 128
+      U128 Low(int k) const {
+        return k >= 64 ?
+          U128(k == 64 ? 0 : hi & ((1ULL << (k - 64)) - 1), lo) :
+          U128(0, lo & ((1ULL << k) - 1));
+      }
+      static U128 Mul(unsigned long long a, unsigned long long b) {
+        unsigned long long
+          a0 = a & 0xffffffffULL, a1 = a >> 32,
+          b0 = b & 0xffffffffULL, b1 = b >> 32,
+          p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1,
+          mid = (p00 >> 32) + (p01 & 0xffffffffULL) + (p10 & 0xffffffffULL);
+        return U128(p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32),
+                    (mid << 32) | (p00 & 0xffffffffULL));
+      }
+    };
+
+    // Find the number n / 10^p, for the smallest p <= 22, which reads back
+    // to a > 0.  Return false if there's no such number with n < 2^64.
+    inline bool Shortest(double a, unsigned long long& n, int& p) {
+      int e;
+      // a = m / 2^E with 2^52 <= m < 2^53 (for normal numbers)
+      unsigned long long m = (unsigned long long)(ldexp(frexp(a, &e), 53));
+      int E = 53 - e;
+      bool pow2 = m == (1ULL << 52);
+      unsigned long long five = 1; // 5^p < 2^52
+      for (p = 0; p <= 22; ++p, five *= 5U) {
+        // With A = m * 5^p and S = E - p, a * 10^p = A / 2^S.  The rounding
+        // error in n = round(A / 2^S) is R / 2^S, and n / 10^p differs from
+        // a by R / (5^p 2^E).  This reads back to a if it lies within half
+        // the spacing of the doubles around a, 2^-E (or 2^-(E+1) below a if
+        // a is a power of 2), i.e., if 2 |R| < 5^p.  (There are no ties
+        // since 5^p is odd.)
+        U128 A = U128::Mul(m, five);
+        int S = E - p;
+        if (S <= 0) {
+          // a * 10^p = A * 2^-S is an integer
+          int k = -S;
+          if (A.hi != 0 || k >= 64 || (k > 0 && (A.lo >> (64 - k)) != 0))
+            return false;
+          n = A.lo << k;
+          return true;
+        }
+        if (S >= 126)           // so that 4 |R| < 2^128
+          continue;
+        U128 q = A >> S, r = A.Low(S), half = U128(0, 1) << (S - 1);
+        if (q.hi != 0)
+          return false;
+        n = q.lo;
+        bool up = half < r || (r == half && (n & 1U));
+        // 2 |R|, doubled below a if pow2
+        U128 R2 = up ? (half - (r - half)) << 1 : r << (pow2 ? 2 : 1);
+        bool ok = R2 < U128(0, five);
+        if (up) {
+          if (n == ~0ULL)
+            return false;
+          ++n;
+        }
+        if (ok)
+          return true;
+      }
+      return false;
+    }
+#endif
+  }
+
+  int Utility::intstr(char buf[], unsigned long long n, bool neg) {
+    // buf has at least strbuf_ elements which is enough for any integer type
+    char tmp[strbuf_], *end = tmp + strbuf_, *q = Digits(end, n, 1);
+    if (neg) *--q = '-';
+    return Output(buf, strbuf_, q, end - q);
+  }
+
+  std::string Utility::streamstr(Math::real x, int p) {
+    if (!Math::isfinite(x))
+      return x < 0 ? std::string("-inf") :
+        (x > 0 ? std::string("inf") : std::string("nan"));
+    std::ostringstream s;
+    s.imbue(std::locale::classic());
+#if GEOGRAPHICLIB_PRECISION == 4
+    // boost-quadmath treats precision == 0 as "use as many digits as
+    // necessary", so...
+    using std::floor;
+    if (p == 0) {
+      long long ix = (long long)(floor(x + Math::real(0.5)));
+      // Implement the "round ties to even" rule
+      if (Math::real(ix) == x + Math::real(0.5) && (ix % 2) == 1)
+        --ix;
+      s << ix;
+      return s.str();
+    }
+#endif
+    if (p >= 0) s << std::fixed << std::setprecision(p);
+    s << x; return s.str();
+  }
+
+  int Utility::str(char buf[], size_t len, Math::real x, int p) {
+    if (!Math::isfinite(x))
+      return x < 0 ? Output(buf, len, "-inf", 4) :
+        (x > 0 ? Output(buf, len, "inf", 3) : Output(buf, len, "nan", 3));
+#if GEOGRAPHICLIB_PRECISION == 2
+    if (p >= 0 && p <= 22) {
+      bool neg = x < 0 || (x == 0 && 1/x < 0);
+      double n, scale;
+      if (Scaled(abs(x), p, n, scale)) {
+        char tmp[fixedbuf_], *end = tmp + fixedbuf_,
+          *q = Fixed(end, (unsigned long long)(n), p, neg);
+        return Output(buf, len, q, end - q);
+      }
+    }
+#endif
+    string s(streamstr(x, p));
+    return Output(buf, len, s.data(), s.size());
+  }
+
+  int Utility::shortstr(char buf[], size_t len, Math::real x) {
+    if (!Math::isfinite(x))
+      return str(buf, len, x);
+#if GEOGRAPHICLIB_PRECISION == 2
+    {
+      bool neg = x < 0 || (x == 0 && 1/x < 0);
+      unsigned long long n = 0;
+      int p = 0;
+      if (x == 0 || Shortest(abs(x), n, p)) {
+        char tmp[fixedbuf_], *end = tmp + fixedbuf_,
+          *q = Fixed(end, n, p, neg);
+        return Output(buf, len, q, end - q);
+      }
+    }
+#endif
+    // Otherwise find the fewest significant digits in the default format by
+    // bisection; the result with maxprec digits always reads back to x.
+    const int maxprec = 2 + numeric_limits<Math::real>::digits * 30103 / 100000;
+    int lo = 0, hi = maxprec;
+    while (hi - lo > 1) {
+      int prec = (lo + hi) / 2;
+      if (streamnum<Math::real>(GeneralStr(x, prec)) == x)
+        hi = prec;
+      else
+        lo = prec;
+    }
+    string s(GeneralStr(x, hi));
+    return Output(buf, len, s.data(), s.size());
+  }
+
   bool Utility::ParseLine(const std::string& line,
                           std::string& key, std::string& val) {
     const char* spaces = " \t\n\v\f\r";
@@ -58,4 +344,94 @@ namespace GeographicLib {
     return Math::set_digits(ndigits);
   }
 
+  bool Utility::advisehugepages(const void* addr, size_t len) {
+#if GEOGRAPHICLIB_UTILITY_MMAP && defined(MADV_HUGEPAGE)
+    // Restrict the advice to the whole 2 MB pages in the range.
+    const size_t huge = size_t(1) << 21;
+    size_t
+      a = (reinterpret_cast<size_t>(addr) + (huge - 1)) & ~(huge - 1),
+      b = (reinterpret_cast<size_t>(addr) + len) & ~(huge - 1);
+    return a < b &&
+      madvise(reinterpret_cast<void*>(a), b - a, MADV_HUGEPAGE) == 0;
+#else
+    (void)addr;
+    (void)len;
+    return false;
+#endif
+  }
+
+  char* Utility::mapfile(const std::string& filename,
+                         unsigned long long& len, void*& handle,
+                         bool hugepages) {
+    handle = 0;
+#if !GEOGRAPHICLIB_UTILITY_MMAP
+    (void)hugepages;
+    len = 0;
+    throw GeographicErr("Memory mapping not supported for " + filename);
+#elif defined(_WIN32)
+    // Large pages aren't available for file mappings on Windows.
+    (void)hugepages;
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, 0,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+      throw GeographicErr("Cannot open for mapping " + filename);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+      CloseHandle(file);
+      throw GeographicErr("Cannot map empty file " + filename);
+    }
+    // The mapping object keeps the file open.
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping)
+      throw GeographicErr("Cannot map " + filename);
+    void* addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!addr) {
+      CloseHandle(mapping);
+      throw GeographicErr("Cannot map " + filename);
+    }
+    handle = mapping;
+    len = (unsigned long long)(size.QuadPart);
+    return static_cast<char*>(addr);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("Cannot open for mapping " + filename);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 ||
+        (unsigned long long)(st.st_size) !=
+        (unsigned long long)(size_t(st.st_size))) {
+      close(fd);
+      throw GeographicErr("Cannot map " + filename);
+    }
+    len = (unsigned long long)(st.st_size);
+    // The mapping remains valid after the file is closed.
+    void* addr = mmap(0, size_t(len), PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw GeographicErr("Cannot map " + filename);
+    if (hugepages)
+      advisehugepages(addr, size_t(len));
+    return static_cast<char*>(addr);
+#endif
+  }
+
+  void Utility::unmapfile(char* addr, unsigned long long len, void* handle) {
+    if (!addr)
+      return;
+#if !GEOGRAPHICLIB_UTILITY_MMAP
+    (void)len;
+    (void)handle;
+#elif defined(_WIN32)
+    (void)len;
+    UnmapViewOfFile(addr);
+    CloseHandle(handle);
+#else
+    (void)handle;
+    munmap(addr, size_t(len));
+#endif
+  }
+
 } // namespace GeographicLib
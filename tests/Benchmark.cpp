@@ -0,0 +1,618 @@
+/**
+ * \file Benchmark.cpp
+ * \brief Micro-benchmarks for the main GeographicLib classes
+ *
+ * Each benchmark times a single operation (e.g., one inverse geodesic
+ * calculation) applied cyclically to a pool of synthetic inputs generated
+ * with a fixed seed, so that the runs are reproducible.  The number of
+ * repetitions is increased until the elapsed time exceeds the minimum time.
+ * The results are written in the JSON format used by Google Benchmark so
+ * that successive runs can be compared with the usual tools.
+ **********************************************************************/
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <exception>
+
+#if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#  include <chrono>
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 1
+#else
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 0
+#endif
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real real;
+
+int usage(int retval) {
+  ( retval ? cerr : cout ) <<
+"Benchmark [ --filter str ] [ --min-time t ] [ --geoid-name name ]\n\
+    [ --geoid-path dir ] [ --output-file file ] [ --list ] [ -h ]\n\
+\n\
+Time the main GeographicLib classes and write the results in JSON (in\n\
+the format used by Google Benchmark) to standard output.\n\
+\n\
+--filter str only run the benchmarks whose names contain str\n\
+--min-time t run each benchmark for at least t seconds (default 0.5)\n\
+--geoid-name name the geoid for the Geoid benchmarks\n\
+--geoid-path dir the directory containing the geoid data\n\
+--output-file file write the results to file instead of standard output\n\
+--list list the benchmarks and exit\n\
+\n\
+The Geoid benchmarks are reported with an error message if the geoid data\n\
+is not installed.\n";
+  return retval;
+}
+
+// A reproducible source of uniform deviates (the 64-bit LCG of Knuth).
+class Random {
+private:
+  unsigned long long _s;
+public:
+  explicit Random(unsigned long long seed) : _s(seed) {}
+  double Uniform() {
+    _s = _s * 6364136223846793005ULL + 1442695040888963407ULL;
+    return double(_s >> 11) / 9007199254740992.0; // [0, 1)
+  }
+  real Uniform(real a, real b) { return a + (b - a) * real(Uniform()); }
+  // A latitude uniformly distributed in area
+  real Latitude(real a = -90, real b = 90) {
+    using std::sin; using std::asin;
+    return asin(Uniform(sin(a * Math::degree()), sin(b * Math::degree())))
+      / Math::degree();
+  }
+};
+
+// The size of the pool of inputs, a power of 2
+const unsigned npool_ = 1024;
+
+// The base class for the benchmarks.  Op(k) performs the operation on the
+// k-th element of the pool and returns some result; the results are
+// accumulated so that the compiler can't skip the computations.
+class Case {
+public:
+  virtual ~Case() {}
+  virtual double Op(unsigned k) = 0;
+};
+
+template<class G> class GeodInverse : public Case {
+private:
+  G _g;
+  vector<real> _lat1, _lon1, _lat2, _lon2;
+public:
+  enum regime { EASY, ANTIPODAL, EQUATORIAL };
+  explicit GeodInverse(regime r)
+    : _g(Constants::WGS84_a(), Constants::WGS84_f())
+    , _lat1(npool_), _lon1(npool_), _lat2(npool_), _lon2(npool_) {
+    Random rnd(1);
+    for (unsigned k = 0; k < npool_; ++k) {
+      switch (r) {
+      case EASY:
+        _lat1[k] = rnd.Latitude(); _lon1[k] = rnd.Uniform(-180, 180);
+        _lat2[k] = rnd.Latitude(); _lon2[k] = rnd.Uniform(-180, 180);
+        break;
+      case ANTIPODAL:
+        _lat1[k] = rnd.Latitude(); _lon1[k] = rnd.Uniform(-180, 180);
+        _lat2[k] = -_lat1[k] + rnd.Uniform(-real(0.5), real(0.5));
+        _lon2[k] = _lon1[k] + 180 - rnd.Uniform(0, 1);
+        break;
+      case EQUATORIAL:
+        _lat1[k] = rnd.Uniform(-real(0.1), real(0.1));
+        _lon1[k] = rnd.Uniform(-180, 180);
+        _lat2[k] = rnd.Uniform(-real(0.1), real(0.1));
+        _lon2[k] = _lon1[k] + rnd.Uniform(-179, 179);
+        break;
+      }
+    }
+  }
+  double Op(unsigned k) {
+    real s12, azi1, azi2;
+    _g.Inverse(_lat1[k], _lon1[k], _lat2[k], _lon2[k], s12, azi1, azi2);
+    return s12 + azi1 + azi2;
+  }
+};
+
+template<class G> class GeodDirect : public Case {
+private:
+  G _g;
+  vector<real> _lat1, _lon1, _azi1, _s12;
+public:
+  enum regime { EASY, ANTIPODAL, EQUATORIAL };
+  explicit GeodDirect(regime r)
+    : _g(Constants::WGS84_a(), Constants::WGS84_f())
+    , _lat1(npool_), _lon1(npool_), _azi1(npool_), _s12(npool_) {
+    Random rnd(2);
+    for (unsigned k = 0; k < npool_; ++k) {
+      _lon1[k] = rnd.Uniform(-180, 180);
+      switch (r) {
+      case EASY:
+        _lat1[k] = rnd.Latitude(); _azi1[k] = rnd.Uniform(-180, 180);
+        _s12[k] = rnd.Uniform(0, real(2e7));
+        break;
+      case ANTIPODAL:
+        _lat1[k] = rnd.Latitude(); _azi1[k] = rnd.Uniform(-180, 180);
+        _s12[k] = rnd.Uniform(real(1.99e7), real(2.0e7));
+        break;
+      case EQUATORIAL:
+        _lat1[k] = rnd.Uniform(-real(0.1), real(0.1));
+        _azi1[k] = 90 + rnd.Uniform(-real(0.1), real(0.1));
+        _s12[k] = rnd.Uniform(0, real(2e7));
+        break;
+      }
+    }
+  }
+  double Op(unsigned k) {
+    real lat2, lon2, azi2;
+    _g.Direct(_lat1[k], _lon1[k], _azi1[k], _s12[k], lat2, lon2, azi2);
+    return lat2 + lon2 + azi2;
+  }
+};
+
+// Points within UTM zone 31 together with their projected coordinates.
+class ZonePool {
+protected:
+  vector<real> _lat, _lon, _x, _y;
+  ZonePool() : _lat(npool_), _lon(npool_), _x(npool_), _y(npool_) {
+    Random rnd(3);
+    for (unsigned k = 0; k < npool_; ++k) {
+      _lat[k] = rnd.Uniform(-80, 84);
+      _lon[k] = rnd.Uniform(0, 6);
+      real gam, t;
+      TransverseMercator::UTM().Forward(3, _lat[k], _lon[k],
+                                        _x[k], _y[k], gam, t);
+    }
+  }
+};
+
+template<class TM> class TMCase : public Case, private ZonePool {
+private:
+  const TM& _tm;
+  bool _forward;
+public:
+  explicit TMCase(bool forward) : _tm(TM::UTM()), _forward(forward) {}
+  double Op(unsigned k) {
+    real u, v, gam, kk;
+    if (_forward)
+      _tm.Forward(3, _lat[k], _lon[k], u, v, gam, kk);
+    else
+      _tm.Reverse(3, _x[k], _y[k], u, v, gam, kk);
+    return u + v + gam + kk;
+  }
+};
+
+class UTMUPSCase : public Case, private ZonePool {
+private:
+  bool _forward;
+public:
+  explicit UTMUPSCase(bool forward) : _forward(forward) {
+    for (unsigned k = 0; k < npool_; ++k) _x[k] += 500000;
+    for (unsigned k = 0; k < npool_; ++k) if (_y[k] < 0) _y[k] += 10000000;
+  }
+  double Op(unsigned k) {
+    if (_forward) {
+      int zone; bool northp; real x, y;
+      UTMUPS::Forward(_lat[k], _lon[k], zone, northp, x, y);
+      return x + y + zone;
+    } else {
+      real lat, lon;
+      UTMUPS::Reverse(31, _lat[k] >= 0, _x[k], _y[k], lat, lon);
+      return lat + lon;
+    }
+  }
+};
+
+class MGRSCase : public Case {
+private:
+  bool _format;
+  vector<int> _zone;
+  vector<char> _northp;
+  vector<real> _x, _y;
+  vector<string> _mgrs;
+public:
+  explicit MGRSCase(bool format)
+    : _format(format), _zone(npool_), _northp(npool_), _x(npool_)
+    , _y(npool_), _mgrs(npool_) {
+    Random rnd(4);
+    for (unsigned k = 0; k < npool_; ++k) {
+      bool northp;
+      UTMUPS::Forward(rnd.Latitude(-80, 84), rnd.Uniform(-180, 180),
+                      _zone[k], northp, _x[k], _y[k]);
+      _northp[k] = northp;
+      MGRS::Forward(_zone[k], northp, _x[k], _y[k], 5, _mgrs[k]);
+    }
+  }
+  double Op(unsigned k) {
+    if (_format) {
+      string mgrs;
+      MGRS::Forward(_zone[k], _northp[k] != 0, _x[k], _y[k], 5, mgrs);
+      return double(mgrs.size());
+    } else {
+      int zone, prec; bool northp; real x, y;
+      MGRS::Reverse(_mgrs[k], zone, northp, x, y, prec);
+      return x + y;
+    }
+  }
+};
+
+class GeoidCase : public Case {
+private:
+  Geoid _geoid;
+  vector<real> _lat, _lon;
+public:
+  GeoidCase(const string& name, const string& path, bool cached)
+    : _geoid(name, path), _lat(npool_), _lon(npool_) {
+    // Points in a 20d x 20d area (which is cached if requested)
+    Random rnd(5);
+    for (unsigned k = 0; k < npool_; ++k) {
+      _lat[k] = rnd.Uniform(30, 50);
+      _lon[k] = rnd.Uniform(0, 20);
+    }
+    if (cached)
+      _geoid.CacheArea(30, 0, 50, 20);
+  }
+  double Op(unsigned k) { return _geoid(_lat[k], _lon[k]); }
+};
+
+class HarmonicCase : public Case {
+private:
+  vector<real> _c, _s, _x, _y, _z;
+  SphericalHarmonic _h;
+public:
+  explicit HarmonicCase(int N)
+    : _c((N + 1) * (N + 2) / 2), _s(N * (N + 1) / 2)
+    , _x(npool_), _y(npool_), _z(npool_) {
+    // Random fully normalized coefficients decreasing as 1/n^2
+    Random rnd(6);
+    for (int m = 0, k = 0; m <= N; ++m)
+      for (int n = m; n <= N; ++n, ++k)
+        _c[k] = rnd.Uniform(-1, 1) / Math::sq(real(n + 1));
+    for (int m = 1, k = 0; m <= N; ++m)
+      for (int n = m; n <= N; ++n, ++k)
+        _s[k] = rnd.Uniform(-1, 1) / Math::sq(real(n + 1));
+    _h = SphericalHarmonic(_c, _s, N, Constants::WGS84_a());
+    for (unsigned k = 0; k < npool_; ++k) {
+      real
+        phi = rnd.Latitude() * Math::degree(),
+        lam = rnd.Uniform(-180, 180) * Math::degree(),
+        r = Constants::WGS84_a() + rnd.Uniform(0, 1000);
+      _x[k] = r * cos(phi) * cos(lam);
+      _y[k] = r * cos(phi) * sin(lam);
+      _z[k] = r * sin(phi);
+    }
+  }
+  double Op(unsigned k) { return _h(_x[k], _y[k], _z[k]); }
+};
+
+class PolygonCase : public Case {
+private:
+  PolygonArea _poly;
+  static const int nv_ = 20;
+  vector<real> _lat, _lon;
+public:
+  PolygonCase() : _poly(Geodesic::WGS84()), _lat(npool_), _lon(npool_) {
+    // Regular 20-gons of radius 100 km with random centers
+    Random rnd(7);
+    for (unsigned k = 0; k < npool_; k += nv_) {
+      real lat0 = rnd.Latitude(-80, 80), lon0 = rnd.Uniform(-180, 180), t;
+      for (int j = 0; j < nv_ && k + j < npool_; ++j)
+        Geodesic::WGS84().Direct(lat0, lon0, j * real(360) / nv_, 100e3,
+                                 _lat[k + j], _lon[k + j], t);
+    }
+  }
+  // One operation is the computation of the area of one polygon
+  double Op(unsigned k) {
+    unsigned k0 = (k % (npool_ / nv_)) * nv_;
+    _poly.Clear();
+    for (int j = 0; j < nv_ && k0 + j < npool_; ++j)
+      _poly.AddPoint(_lat[k0 + j], _lon[k0 + j]);
+    real perimeter, area;
+    _poly.Compute(false, true, perimeter, area);
+    return area;
+  }
+};
+
+class RhumbCase : public Case {
+private:
+  const Rhumb& _rh;
+  bool _inverse;
+  vector<real> _lat1, _lon1, _lat2, _lon2;
+public:
+  explicit RhumbCase(bool inverse)
+    : _rh(Rhumb::WGS84()), _inverse(inverse)
+    , _lat1(npool_), _lon1(npool_), _lat2(npool_), _lon2(npool_) {
+    Random rnd(8);
+    for (unsigned k = 0; k < npool_; ++k) {
+      _lat1[k] = rnd.Latitude(-85, 85); _lon1[k] = rnd.Uniform(-180, 180);
+      if (inverse) {
+        _lat2[k] = rnd.Latitude(-85, 85); _lon2[k] = rnd.Uniform(-180, 180);
+      } else {
+        _lat2[k] = rnd.Uniform(-180, 180); // azimuth
+        _lon2[k] = rnd.Uniform(0, real(5e6)); // distance
+      }
+    }
+  }
+  double Op(unsigned k) {
+    real u, v;
+    if (_inverse)
+      _rh.Inverse(_lat1[k], _lon1[k], _lat2[k], _lon2[k], u, v);
+    else
+      _rh.Direct(_lat1[k], _lon1[k], _lat2[k], _lon2[k], u, v);
+    return u + v;
+  }
+};
+
+class DMSCase : public Case {
+private:
+  bool _decode;
+  vector<real> _ang;
+  vector<string> _str;
+public:
+  explicit DMSCase(bool decode) : _decode(decode), _ang(npool_), _str(npool_)
+  {
+    Random rnd(9);
+    for (unsigned k = 0; k < npool_; ++k) {
+      _ang[k] = rnd.Uniform(-90, 90);
+      _str[k] = DMS::Encode(_ang[k], DMS::SECOND, 5, DMS::LATITUDE);
+    }
+  }
+  double Op(unsigned k) {
+    if (_decode) {
+      DMS::flag ind;
+      return DMS::Decode(_str[k], ind);
+    } else
+      return double(DMS::Encode(_ang[k], DMS::SECOND, 5,
+                                DMS::LATITUDE).size());
+  }
+};
+
+// Options passed to the factories
+struct Options {
+  string geoidname, geoidpath;
+};
+
+typedef Case* (*Factory)(const Options&);
+
+template<class G, int R> Case* MakeInverse(const Options&)
+{ return new GeodInverse<G>(typename GeodInverse<G>::regime(R)); }
+template<class G, int R> Case* MakeDirect(const Options&)
+{ return new GeodDirect<G>(typename GeodDirect<G>::regime(R)); }
+template<class TM, bool F> Case* MakeTM(const Options&)
+{ return new TMCase<TM>(F); }
+template<bool F> Case* MakeUTMUPS(const Options&)
+{ return new UTMUPSCase(F); }
+template<bool F> Case* MakeMGRS(const Options&)
+{ return new MGRSCase(F); }
+template<bool C> Case* MakeGeoid(const Options& o)
+{ return new GeoidCase(o.geoidname, o.geoidpath, C); }
+template<int N> Case* MakeHarmonic(const Options&)
+{ return new HarmonicCase(N); }
+Case* MakePolygon(const Options&) { return new PolygonCase(); }
+template<bool I> Case* MakeRhumb(const Options&)
+{ return new RhumbCase(I); }
+template<bool D> Case* MakeDMS(const Options&)
+{ return new DMSCase(D); }
+
+struct Entry {
+  const char* name;
+  Factory make;
+};
+
+const Entry benchmarks_[] = {
+  { "Geodesic/Inverse/easy", MakeInverse<Geodesic, 0> },
+  { "Geodesic/Inverse/antipodal", MakeInverse<Geodesic, 1> },
+  { "Geodesic/Inverse/equatorial", MakeInverse<Geodesic, 2> },
+  { "Geodesic/Direct/easy", MakeDirect<Geodesic, 0> },
+  { "Geodesic/Direct/antipodal", MakeDirect<Geodesic, 1> },
+  { "Geodesic/Direct/equatorial", MakeDirect<Geodesic, 2> },
+  { "GeodesicExact/Inverse/easy", MakeInverse<GeodesicExact, 0> },
+  { "GeodesicExact/Inverse/antipodal", MakeInverse<GeodesicExact, 1> },
+  { "GeodesicExact/Inverse/equatorial", MakeInverse<GeodesicExact, 2> },
+  { "GeodesicExact/Direct/easy", MakeDirect<GeodesicExact, 0> },
+  { "GeodesicExact/Direct/antipodal", MakeDirect<GeodesicExact, 1> },
+  { "GeodesicExact/Direct/equatorial", MakeDirect<GeodesicExact, 2> },
+  { "TransverseMercator/Forward", MakeTM<TransverseMercator, true> },
+  { "TransverseMercator/Reverse", MakeTM<TransverseMercator, false> },
+  { "TransverseMercatorExact/Forward",
+    MakeTM<TransverseMercatorExact, true> },
+  { "TransverseMercatorExact/Reverse",
+    MakeTM<TransverseMercatorExact, false> },
+  { "UTMUPS/Forward", MakeUTMUPS<true> },
+  { "UTMUPS/Reverse", MakeUTMUPS<false> },
+  { "MGRS/Format", MakeMGRS<true> },
+  { "MGRS/Parse", MakeMGRS<false> },
+  { "Geoid/uncached", MakeGeoid<false> },
+  { "Geoid/cached", MakeGeoid<true> },
+  { "SphericalHarmonic/12", MakeHarmonic<12> },
+  { "SphericalHarmonic/360", MakeHarmonic<360> },
+  { "SphericalHarmonic/2190", MakeHarmonic<2190> },
+  { "PolygonArea/20", MakePolygon },
+  { "Rhumb/Inverse", MakeRhumb<true> },
+  { "Rhumb/Direct", MakeRhumb<false> },
+  { "DMS/Decode", MakeDMS<true> },
+  { "DMS/Encode", MakeDMS<false> },
+};
+
+class Timer {
+private:
+  clock_t _cpu;
+#if GEOGRAPHICLIB_BENCHMARK_CHRONO
+  std::chrono::steady_clock::time_point _real;
+#endif
+public:
+  Timer() : _cpu(clock())
+#if GEOGRAPHICLIB_BENCHMARK_CHRONO
+          , _real(std::chrono::steady_clock::now())
+#endif
+  {}
+  // CPU time since construction (seconds)
+  double CPU() const { return double(clock() - _cpu) / CLOCKS_PER_SEC; }
+  // Elapsed time since construction (seconds); the CPU time if a
+  // monotonic clock is not available.
+  double Real() const {
+#if GEOGRAPHICLIB_BENCHMARK_CHRONO
+    return std::chrono::duration<double>
+      (std::chrono::steady_clock::now() - _real).count();
+#else
+    return CPU();
+#endif
+  }
+};
+
+volatile double sink_ = 0;
+
+// Run c for at least mintime seconds; return the number of iterations and
+// the times per iteration (in ns).
+void Measure(Case& c, double mintime,
+             unsigned long long& iters, double& cpu, double& real) {
+  unsigned long long n = 1;
+  for (;;) {
+    double sum = 0;
+    Timer t;
+    for (unsigned long long i = 0; i < n; ++i)
+      sum += c.Op(unsigned(i) & (npool_ - 1));
+    double tcpu = t.CPU(), treal = t.Real();
+    sink_ += sum;
+    if (treal >= mintime || n >= (1ULL << 40)) {
+      iters = n;
+      cpu = tcpu * 1e9 / double(n);
+      real = treal * 1e9 / double(n);
+      return;
+    }
+    // Aim for 1.4 x mintime on the next pass, growing by a factor of 10 at
+    // most.
+    double f = treal > 0 ? 1.4 * mintime / treal : 10;
+    n = (unsigned long long)(double(n) * (f < 10 ? (f > 2 ? f : 2) : 10));
+  }
+}
+
+string JSONString(const string& s) {
+  string r("\"");
+  for (size_t i = 0; i < s.size(); ++i) {
+    char c = s[i];
+    if (c == '"' || c == '\\') { r += '\\'; r += c; }
+    else if (c == '\n') r += "\\n";
+    else if (c == '\t') r += "\\t";
+    else if ((unsigned char)(c) < 0x20) r += ' ';
+    else r += c;
+  }
+  return r + "\"";
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    Options opts;
+    opts.geoidname = Geoid::DefaultGeoidName();
+    string filter, ofile;
+    double mintime = 0.5;
+    bool list = false;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "--filter" && m + 1 < argc)
+        filter = argv[++m];
+      else if (arg == "--min-time" && m + 1 < argc)
+        mintime = Utility::num<double>(string(argv[++m]));
+      else if (arg == "--geoid-name" && m + 1 < argc)
+        opts.geoidname = argv[++m];
+      else if (arg == "--geoid-path" && m + 1 < argc)
+        opts.geoidpath = argv[++m];
+      else if (arg == "--output-file" && m + 1 < argc)
+        ofile = argv[++m];
+      else if (arg == "--list")
+        list = true;
+      else
+        return usage(arg == "-h" ? 0 : 1);
+    }
+    const size_t nb = sizeof(benchmarks_) / sizeof(benchmarks_[0]);
+    if (list) {
+      for (size_t i = 0; i < nb; ++i)
+        if (string(benchmarks_[i].name).find(filter) != string::npos)
+          cout << benchmarks_[i].name << "\n";
+      return 0;
+    }
+    ofstream outfile;
+    if (!ofile.empty()) {
+      outfile.open(ofile.c_str());
+      if (!outfile.is_open()) {
+        cerr << "Cannot open " << ofile << " for writing\n";
+        return 1;
+      }
+    }
+    ostream& out = ofile.empty() ? cout : outfile;
+    char date[64];
+    time_t now = time(0);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"date\": " << JSONString(date) << ",\n"
+        << "    \"library_version\": "
+        << JSONString(GEOGRAPHICLIB_VERSION_STRING) << ",\n"
+        << "    \"precision_digits\": " << Math::digits() << ",\n"
+        << "    \"min_time\": " << mintime << ",\n"
+        << "    \"pool_size\": " << npool_ << "\n"
+        << "  },\n"
+        << "  \"benchmarks\": [";
+    bool first = true;
+    for (size_t i = 0; i < nb; ++i) {
+      string name(benchmarks_[i].name);
+      if (name.find(filter) == string::npos) continue;
+      out << (first ? "\n" : ",\n") << "    {\n"
+          << "      \"name\": " << JSONString(name) << ",\n";
+      first = false;
+      try {
+        Case* c = benchmarks_[i].make(opts);
+        unsigned long long iters; double cpu, real;
+        try {
+          Measure(*c, mintime, iters, cpu, real);
+        }
+        catch (...) {
+          delete c;
+          throw;
+        }
+        delete c;
+        out << "      \"iterations\": " << iters << ",\n"
+            << fixed << setprecision(3)
+            << "      \"real_time\": " << real << ",\n"
+            << "      \"cpu_time\": " << cpu << ",\n"
+            << "      \"time_unit\": \"ns\"\n";
+        out.unsetf(ios::floatfield);
+      }
+      catch (const exception& e) {
+        out << "      \"error_occurred\": true,\n"
+            << "      \"error_message\": " << JSONString(e.what()) << "\n";
+      }
+      out << "    }";
+      out.flush();
+    }
+    out << "\n  ]\n}\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
@@ -19,12 +19,24 @@
 #include <algorithm>
 #include <limits>
 
+#if !defined(GEODTEST_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEODTEST_THREADS 1
+#  else
+#    define GEODTEST_THREADS 0
+#  endif
+#endif
+
+#if GEODTEST_THREADS
+#  include <thread>
+#endif
+
 using namespace std;
 using namespace GeographicLib;
 
 int usage(int retval) {
   ( retval ? cerr : cout ) <<
-"GeodTest [ -a | -c | -t0 | -t1 | -t2 | -t3 | -h ]\n\
+"GeodTest [ -a | -E | -F | -c | -t0 | -t1 | -t2 | -t3 | -h ] [ -j n ]\n\
 \n\
 Check GeographicLib::Geodesic class.\n\
 -a (default) accuracy test (reads test data on standard input)\n\
@@ -36,8 +48,14 @@ Check GeographicLib::Geodesic class.\n\
 -t1 time GeodecicLine with angles using synthetic data\n\
 -t2 time Geodecic::Direct using synthetic data\n\
 -t3 time Geodecic::Inverse with synthetic data\n\
+-j n use n threads for the accuracy tests (default 1)\n\
+\n\
+-c requires an instrumented version of Geodesic.\n\
 \n\
--c requires an instrumented version of Geodesic.\n";
+With -j, the test data is read in blocks and the lines of each block are\n\
+divided between the threads; the results are the same as with one thread.\n\
+This is useful for the high precision versions of the library (in which\n\
+case each thread sets the precision given by GEOGRAPHICLIB_DIGITS).\n";
   return retval;
 }
 
@@ -179,6 +197,106 @@ void GeodError(const test& tgeod,
   }
 }
 
+// The maximum errors for a chunk of test data and the indices of the lines
+// where they occur.
+struct ChunkErrors {
+  vector<Math::real> err;
+  vector<unsigned> errind;
+  unsigned cnt;                 // the number of lines processed
+  bool bad;                     // whether a line couldn't be parsed
+  ChunkErrors(unsigned n) : err(n, 0), errind(n, 0), cnt(0), bad(false) {}
+};
+
+// Record the error erra for line ind if it increases the maximum (a NaN is
+// recorded once and then retained).
+void UpdateErrors(vector<Math::real>& err, vector<unsigned>& errind,
+                  const vector<Math::real>& erra, const vector<unsigned>& ind) {
+  for (unsigned i = 0; i < err.size(); ++i) {
+    if (Math::isfinite(err[i]) && !(erra[i] <= err[i])) {
+      err[i] = erra[i];
+      errind[i] = ind[i];
+    }
+  }
+}
+
+// Run the accuracy test for lines[beg, end); cnt0 is the index of lines[0].
+// Processing stops at the first line which can't be parsed.  digits is the
+// precision to use (this matters for GEOGRAPHICLIB_PRECISION = 5, where the
+// precision is set separately for each thread).
+template<class test>
+void AccuracyChunk(const test* tgeod, int digits,
+                   const vector<string>* lines, size_t beg, size_t end,
+                   unsigned cnt0, ChunkErrors* res) {
+  Math::set_digits(digits);
+  unsigned NUMERR = unsigned(res->err.size());
+  vector<Math::real> erra(NUMERR);
+  for (size_t k = beg; k < end; ++k) {
+    istringstream str((*lines)[k]);
+    Math::real lat1l, lon1l, azi1l, lat2l, lon2l, azi2l,
+      s12l, a12l, m12l, S12l;
+    if (!(str >> lat1l >> lon1l >> azi1l
+              >> lat2l >> lon2l >> azi2l
+              >> s12l >> a12l >> m12l)) {
+      res->bad = true;
+      break;
+    }
+    if (!(str >> S12l))
+      S12l = Math::NaN();
+    GeodError<test>(*tgeod, lat1l, lon1l, azi1l,
+                    lat2l, lon2l, azi2l,
+                    s12l, a12l, m12l, S12l,
+                    erra);
+    UpdateErrors(res->err, res->errind, erra,
+                 vector<unsigned>(NUMERR, cnt0 + unsigned(k)));
+    ++res->cnt;
+  }
+}
+
+// Run the accuracy test on the data on standard input using nthreads
+// threads.
+template<class test>
+void AccuracyTest(const test& tgeod, int nthreads,
+                  vector<Math::real>& err, vector<unsigned>& errind) {
+  const size_t blocksize = 1024 * size_t(nthreads);
+  int digits = Math::digits();
+  unsigned cnt = 0;
+  vector<string> lines;
+  lines.reserve(blocksize);
+  bool done = false;
+  while (!done) {
+    lines.clear();
+    string s;
+    while (lines.size() < blocksize && getline(cin, s))
+      lines.push_back(s);
+    if (lines.size() < blocksize) done = true;
+    if (lines.empty()) break;
+    size_t n = lines.size();
+    vector<ChunkErrors> res(nthreads, ChunkErrors(unsigned(err.size())));
+#if GEODTEST_THREADS
+    vector<thread> threads;
+    for (int k = 1; k < nthreads; ++k)
+      threads.push_back(thread(AccuracyChunk<test>, &tgeod, digits, &lines,
+                               n * k / nthreads, n * (k + 1) / nthreads,
+                               cnt, &res[k]));
+    AccuracyChunk<test>(&tgeod, digits, &lines, 0, n / nthreads, cnt,
+                        &res[0]);
+    for (size_t k = 0; k < threads.size(); ++k)
+      threads[k].join();
+#else
+    AccuracyChunk<test>(&tgeod, digits, &lines, 0, n, cnt, &res[0]);
+#endif
+    // Combine the results in order, so that they are the same as with a
+    // single thread, stopping at the first line which can't be parsed.
+    for (int k = 0; k < nthreads; ++k) {
+      UpdateErrors(err, errind, res[k].err, res[k].errind);
+      cnt += res[k].cnt;
+      if (res[k].bad) {
+        done = true;
+        break;
+      }
+    }
+  }
+}
 
 int main(int argc, char* argv[]) {
   Utility::set_digits();
@@ -189,6 +307,24 @@ int main(int argc, char* argv[]) {
   bool accuracytest = true;
   bool coverage = false;
   bool exact = false;
+  int nthreads = 1;
+  if (argc >= 3 && string(argv[argc - 2]) == "-j") {
+    try {
+      nthreads = Utility::num<int>(string(argv[argc - 1]));
+    }
+    catch (const exception& e) {
+      cerr << "Error decoding argument of -j: " << e.what() << "\n";
+      return 1;
+    }
+    if (!(nthreads > 0)) {
+      cerr << "Number of threads must be positive\n";
+      return 1;
+    }
+#if !GEODTEST_THREADS
+    nthreads = 1;
+#endif
+    argc -= 2;
+  }
   if (argc == 2) {
     string arg = argv[1];
     if (arg == "-a") {
@@ -332,50 +468,30 @@ int main(int argc, char* argv[]) {
     const unsigned NUMERR = 7;
 
     cout << fixed << setprecision(2);
-    vector<Math::real> erra(NUMERR);
     vector<Math::real> err(NUMERR, 0.0);
     vector<unsigned> errind(NUMERR);
-    unsigned cnt = 0;
+    if (accuracytest) {
+      exact ?
+        AccuracyTest<GeodesicExact>(geode, nthreads, err, errind) :
+        AccuracyTest<Geodesic>(geod, nthreads, err, errind);
+    }
     string s;
-    while (getline(cin, s)) {
+    while (coverage && getline(cin, s)) {
       istringstream str(s);
       Math::real lat1l, lon1l, azi1l, lat2l, lon2l, azi2l,
-        s12l, a12l, m12l, S12l;
+        s12l, a12l, m12l;
       if (!(str >> lat1l >> lon1l >> azi1l
                 >> lat2l >> lon2l >> azi2l
                 >> s12l >> a12l >> m12l))
         break;
-      if (!(str >> S12l))
-        S12l = Math::NaN();
-      if (coverage) {
 #if defined(GEOD_DIAG) && GEOD_DIAG
-        Math::real
-          lat1 = lat1l, lon1 = lon1l,
-          lat2 = lat2l, lon2 = lon2l,
-          azi1, azi2, s12, m12;
-        geod.Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2, m12);
-        cout << geod.coverage << " " << geod.niter << "\n";
+      Math::real
+        lat1 = lat1l, lon1 = lon1l,
+        lat2 = lat2l, lon2 = lon2l,
+        azi1, azi2, s12, m12;
+      geod.Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2, m12);
+      cout << geod.coverage << " " << geod.niter << "\n";
 #endif
-      } else {
-        exact ?
-          GeodError< GeodesicExact >
-          (geode, lat1l, lon1l, azi1l,
-           lat2l, lon2l, azi2l,
-           s12l, a12l, m12l, S12l,
-           erra) :
-          GeodError< Geodesic >
-          (geod, lat1l, lon1l, azi1l,
-           lat2l, lon2l, azi2l,
-           s12l, a12l, m12l, S12l,
-           erra);
-        for (unsigned i = 0; i < NUMERR; ++i) {
-          if (Math::isfinite(err[i]) && !(erra[i] <= err[i])) {
-            err[i] = erra[i];
-            errind[i] = cnt;
-          }
-        }
-        ++cnt;
-      }
     }
     if (accuracytest) {
       Math::real mult = Math::extra_digits() == 0 ? 1e9l :
@@ -0,0 +1,56 @@
+/**
+ * \file LibTest.cpp
+ * \brief Regression tests for library classes not used by the tools
+ *
+ * Usage: LibTest name; this runs the test called name, printing the
+ * result; the exit status is 0 if the test passes and 1 otherwise.
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ **********************************************************************/
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/CompactGeodesicLine.hpp>
+
+using namespace GeographicLib;
+using namespace std;
+
+typedef Math::real real;
+
+// The maximum error (meters) of the positions given by a
+// CompactGeodesicLineT<float> starting at a pole.  This was 1.3e7 m when the
+// initial quantities underflowed in float.
+real CompactFloatPole() {
+  const Geodesic& g = Geodesic::WGS84();
+  real err = 0;
+  for (int p = -1; p <= 1; p += 2)
+    for (int a = -180; a < 180; a += 15)
+      for (real s = 1000; s < 2e7; s *= 3) {
+        real lat1 = 90 * p, lon1 = 17, azi1 = a, lat2, lon2, lat2x, lon2x, d;
+        CompactGeodesicLineT<float> l(g, lat1, lon1, azi1);
+        l.Position(s, lat2, lon2);
+        g.Direct(lat1, lon1, azi1, s, lat2x, lon2x);
+        g.Inverse(lat2, lon2, lat2x, lon2x, d);
+        err = max(err, d);
+      }
+  return err;
+}
+
+int main(int argc, char* argv[]) {
+  string test(argc > 1 ? argv[1] : "");
+  bool ok;
+  if (test == "compact-float-pole") {
+    real err = CompactFloatPole();
+    cout << test << " max error " << err << " m\n";
+    ok = err < 1;
+  } else {
+    cerr << "Usage: LibTest compact-float-pole\n";
+    return 1;
+  }
+  cout << (ok ? "PASS" : "FAIL") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,558 @@
+/**
+ * \file PipelineBench.cpp
+ * \brief End-to-end benchmark of a parse, UTM, geoid, and format pipeline
+ *
+ * Each point passes through the chain of calls of a typical production
+ * conversion: a line "lat lon h" (with h the height above the geoid) is
+ * parsed; the position is converted to UTM/UPS; the height is converted to
+ * a height above the ellipsoid; and the line "zone easting northing h" is
+ * formatted.  The points are generated (with a fixed seed) and processed in
+ * blocks, and the time spent in each of the four stages is accumulated
+ * separately; so the interactions between the stages (e.g., the effect of
+ * the formatting on the cache used by the geoid) are included in the
+ * times, but the generation of the input is not.  Each workload is run in
+ * two modes:
+ * - scalar: each line is split into std::string fields which are decoded
+ *   with DMS::DecodeLatLon and Utility::num; the points are converted one
+ *   at a time with UTMUPS::Forward and Geoid::ConvertHeight; the output is
+ *   built with Utility::str.
+ * - batch: the fields are decoded in place with DMS::Decode(const char*,
+ *   size_t, flag&); the block is converted with UTMUPS::ForwardBatch and
+ *   Geoid::ConvertHeightBatch; the output is written into a buffer with
+ *   Utility::str(char[], size_t, real, int).
+ * .
+ * The outputs of the two modes are identical (as shown by their
+ * checksums).  If the library was compiled with
+ * GEOGRAPHICLIB_INSTRUMENTATION, the counters recorded during each run
+ * (e.g., the geoid cache hits and misses) are included in the results,
+ * which are written in JSON.
+ **********************************************************************/
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstring>
+#include <exception>
+
+#if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#  include <chrono>
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 1
+#else
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 0
+#endif
+
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Instrumentation.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real real;
+
+int usage(int retval) {
+  ( retval ? cerr : cout ) <<
+"PipelineBench [ --points n ] [ --block n ] [ --filter str ] [ --dms ]\n\
+    [ --geoid-name name ] [ --geoid-path dir ] [ --cache-all ]\n\
+    [ --output-file file ] [ --list ] [ -h ]\n\
+\n\
+Time the chain DMS::DecodeLatLon -> UTMUPS::Forward ->\n\
+Geoid::ConvertHeight -> Utility::str on n (default 10000000) synthetic\n\
+points, in scalar and batch modes, and write the times for each stage in\n\
+JSON.\n\
+\n\
+--points n the number of points for each run\n\
+--block n the number of points processed together (default 65536)\n\
+--filter str only run the workloads whose names contain str\n\
+--dms give the input positions in DMS with hemisphere designators\n\
+  instead of in decimal degrees\n\
+--geoid-name name, --geoid-path dir the geoid; if its data is not\n\
+  installed, a synthetic geoid on a 5' grid is used instead\n\
+--cache-all cache the whole geoid in memory before the runs\n\
+--output-file file write the results to file instead of standard output\n\
+--list list the workloads and exit\n";
+  return retval;
+}
+
+// A reproducible source of uniform deviates (the 64-bit LCG of Knuth).
+class Random {
+private:
+  unsigned long long _s;
+public:
+  explicit Random(unsigned long long seed) : _s(seed) {}
+  double Uniform() {
+    _s = _s * 6364136223846793005ULL + 1442695040888963407ULL;
+    return double(_s >> 11) / 9007199254740992.0; // [0, 1)
+  }
+  real Uniform(real a, real b) { return a + (b - a) * real(Uniform()); }
+  // A latitude uniformly distributed in area
+  real Latitude(real a = -90, real b = 90) {
+    using std::sin; using std::asin;
+    return asin(Uniform(sin(a * Math::degree()), sin(b * Math::degree())))
+      / Math::degree();
+  }
+};
+
+// A smooth synthetic geoid on the grid of egm96-5 for use when no geoid
+// data is installed.  The heights lie in [-100 m, 80 m].  The trigonometric
+// functions of the latitudes and longitudes of the grid are tabulated so
+// that reading a tile costs about as much as reading it from a file.
+class SyntheticGeoid : public Geoid::Source {
+private:
+  enum { width_ = 4320, height_ = 2161 };
+  vector<real> _s2phi, _c5phi, _c3lam, _s2lam, _s7lam;
+public:
+  SyntheticGeoid()
+    : _s2phi(height_), _c5phi(height_)
+    , _c3lam(width_), _s2lam(width_), _s7lam(width_)
+  {
+    for (int y = 0; y < height_; ++y) {
+      real phi = (90 - y * real(180) / (height_ - 1)) * Math::degree();
+      _s2phi[y] = sin(2 * phi); _c5phi[y] = cos(5 * phi);
+    }
+    for (int x = 0; x < width_; ++x) {
+      real lam = x * real(360) / width_ * Math::degree();
+      _c3lam[x] = cos(3 * lam); _s2lam[x] = sin(2 * lam + 1);
+      _s7lam[x] = sin(7 * lam);
+    }
+  }
+  int Width() const { return width_; }
+  int Height() const { return height_; }
+  int TileSize() const { return 256; }
+  real Offset() const { return -108; }
+  real Scale() const { return real(0.003); }
+  string Name() const { return "synthetic"; }
+  void Heights(int x0, int y0, int w, int h, real N[]) const {
+    for (int j = 0; j < h; ++j)
+      for (int i = 0; i < w; ++i)
+        N[j * w + i] = -10 + 50 * _s2phi[y0 + j] * _c3lam[x0 + i]
+          + 30 * _c5phi[y0 + j] * _s2lam[x0 + i] + 10 * _s7lam[x0 + i];
+  }
+};
+
+// The generated points: a buffer of lines "lat lon h".
+struct Input {
+  string text;
+  size_t n;
+};
+
+// The point distributions.  Generate appends n lines to in.
+class Workload {
+public:
+  virtual ~Workload() {}
+  virtual void Generate(Random& r, size_t n, bool dms, Input& in) = 0;
+protected:
+  static void Line(real lat, real lon, real h, bool dms, Input& in) {
+    if (dms)
+      in.text += DMS::Encode(lat, 10, DMS::LATITUDE) + " " +
+        DMS::Encode(lon, 10, DMS::LONGITUDE);
+    else
+      in.text += Utility::str(lat, 6) + " " + Utility::str(lon, 6);
+    in.text += " " + Utility::str(h, 3) + "\n";
+    ++in.n;
+  }
+};
+
+// Points scattered uniformly over the earth.
+class ScatterCase : public Workload {
+public:
+  void Generate(Random& r, size_t n, bool dms, Input& in) {
+    for (size_t i = 0; i < n; ++i) {
+      real lat = r.Latitude(), lon = r.Uniform(-180, 180),
+        h = r.Uniform(-100, 5000);
+      Line(lat, lon, h, dms, in);
+    }
+  }
+};
+
+// Points 100 m apart along meandering tracks of 10000 points, so that
+// neighboring points usually lie in the same UTM zone and the same cell of
+// the geoid grid.
+class TrackCase : public Workload {
+private:
+  real _lat, _lon, _azi, _h;
+  size_t _k;
+public:
+  TrackCase() : _lat(0), _lon(0), _azi(0), _h(0), _k(0) {}
+  void Generate(Random& r, size_t n, bool dms, Input& in) {
+    const real step = 100 / real(111e3); // degrees
+    for (size_t i = 0; i < n; ++i, ++_k) {
+      if (_k % 10000 == 0) {
+        _lat = r.Latitude(-80, 80); _lon = r.Uniform(-180, 180);
+        _azi = r.Uniform(-180, 180); _h = r.Uniform(0, 2000);
+      }
+      _azi += r.Uniform(-5, 5);
+      _lat += step * cos(_azi * Math::degree());
+      _lon += step * sin(_azi * Math::degree()) / cos(_lat * Math::degree());
+      if (abs(_lat) > 85) { _lat = _lat > 0 ? 85 : -85; _azi += 180; }
+      _lon = Math::AngNormalize(_lon);
+      _h = max(real(-100), _h + r.Uniform(-5, 5));
+      Line(_lat, _lon, _h, dms, in);
+    }
+  }
+};
+
+typedef Workload* (*Factory)();
+
+Workload* MakeScatter() { return new ScatterCase(); }
+Workload* MakeTrack() { return new TrackCase(); }
+
+struct Entry {
+  const char* name;
+  Factory make;
+};
+
+const Entry workloads_[] = {
+  { "track", MakeTrack },
+  { "scatter", MakeScatter },
+};
+
+// The elapsed time (seconds) since some fixed point; the CPU time if a
+// monotonic clock is not available.
+double Now() {
+#if GEOGRAPHICLIB_BENCHMARK_CHRONO
+  return std::chrono::duration<double>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return double(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+// The stages of the pipeline
+enum { PARSE, UTM, GEOID, FORMAT, NSTAGES };
+const char* const stagenames_[NSTAGES] = { "parse", "utm", "geoid", "format" };
+
+// The state of a run: the arrays for a block, the output, and the timers.
+class Pipeline {
+private:
+  const Geoid& _geoid;
+  vector<real> _lat, _lon, _h, _x, _y;
+  vector<int> _zone;
+  vector<char> _buf;
+  bool* _northp;
+  vector<bool> _northv;
+  vector<string> _fields;
+  string _out;
+  unsigned long long _sum;
+  // Fold the output into the checksum (FNV-1a)
+  void Checksum(const char* s, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      _sum = (_sum ^ (unsigned char)(s[i])) * 1099511628211ULL;
+  }
+  // The result of DMS::DecodeLatLon for the characters [a, a + na) and [b,
+  // b + nb) without copying them to strings.
+  static void DecodeLatLon(const char* a, size_t na, const char* b, size_t nb,
+                           real& lat, real& lon) {
+    DMS::flag ia, ib;
+    real va = DMS::Decode(a, na, ia), vb = DMS::Decode(b, nb, ib);
+    if (ia == DMS::NONE && ib == DMS::NONE) {
+      ia = DMS::LATITUDE; ib = DMS::LONGITUDE;
+    } else if (ia == DMS::NONE)
+      ia = DMS::flag(DMS::LATITUDE + DMS::LONGITUDE - ib);
+    else if (ib == DMS::NONE)
+      ib = DMS::flag(DMS::LATITUDE + DMS::LONGITUDE - ia);
+    if (ia == ib)
+      throw GeographicErr("Both " + string(a, na) + " and " + string(b, nb)
+                          + " interpreted as the same coordinate");
+    lat = ia == DMS::LATITUDE ? va : vb;
+    lon = ia == DMS::LATITUDE ? vb : va;
+    if (abs(lat) > 90)
+      throw GeographicErr("Latitude not in [-90d, 90d]");
+    if (lon < -540 || lon >= 540)
+      throw GeographicErr("Longitude not in [-540d, 540d)");
+  }
+  // Split [p, end) into fields separated by blanks; return the end of the
+  // line.
+  static const char* Split(const char* p, const char* end,
+                           const char* f[], size_t len[], int nf) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (!eol) eol = end;
+    int k = 0;
+    while (p < eol && k < nf) {
+      while (p < eol && *p == ' ') ++p;
+      const char* q = p;
+      while (q < eol && *q != ' ') ++q;
+      if (q > p) { f[k] = p; len[k] = size_t(q - p); ++k; }
+      p = q;
+    }
+    if (k < nf)
+      throw GeographicErr("Incomplete input: " + string(p, eol));
+    return eol < end ? eol + 1 : end;
+  }
+public:
+  double time[NSTAGES];
+  explicit Pipeline(const Geoid& geoid)
+    : _geoid(geoid), _northp(0), _sum(14695981039346656037ULL) {
+    for (int i = 0; i < NSTAGES; ++i) time[i] = 0;
+  }
+  ~Pipeline() { delete[] _northp; }
+  unsigned long long Sum() const { return _sum; }
+  void Resize(size_t n) {
+    if (_lat.size() >= n) return;
+    _lat.resize(n); _lon.resize(n); _h.resize(n); _x.resize(n); _y.resize(n);
+    _zone.resize(n); _northv.resize(n);
+    delete[] _northp; _northp = new bool[n];
+    // Enough for the output lines
+    _buf.resize(n * 64);
+  }
+  void Scalar(const Input& in) {
+    size_t n = in.n;
+    Resize(n);
+    double t0 = Now();
+    {
+      istringstream str(in.text);
+      string line, f[3];
+      for (size_t i = 0; i < n; ++i) {
+        getline(str, line);
+        istringstream l(line);
+        if (!(l >> f[0] >> f[1] >> f[2]))
+          throw GeographicErr("Incomplete input: " + line);
+        DMS::DecodeLatLon(f[0], f[1], _lat[i], _lon[i]);
+        _h[i] = Utility::num<real>(f[2]);
+      }
+    }
+    double t1 = Now();
+    for (size_t i = 0; i < n; ++i) {
+      bool northp;
+      UTMUPS::Forward(_lat[i], _lon[i], _zone[i], northp, _x[i], _y[i]);
+      _northv[i] = northp;
+    }
+    double t2 = Now();
+    for (size_t i = 0; i < n; ++i)
+      _h[i] = _geoid.ConvertHeight(_lat[i], _lon[i], _h[i],
+                                   Geoid::GEOIDTOELLIPSOID);
+    double t3 = Now();
+    _out.clear();
+    for (size_t i = 0; i < n; ++i)
+      _out += Utility::str(_zone[i]) + (_northv[i] ? "n " : "s ")
+        + Utility::str(_x[i], 3) + " " + Utility::str(_y[i], 3) + " "
+        + Utility::str(_h[i], 3) + "\n";
+    double t4 = Now();
+    Checksum(_out.data(), _out.size());
+    time[PARSE] += t1 - t0; time[UTM] += t2 - t1;
+    time[GEOID] += t3 - t2; time[FORMAT] += t4 - t3;
+  }
+  void Batch(const Input& in) {
+    size_t n = in.n;
+    Resize(n);
+    double t0 = Now();
+    {
+      const char *p = in.text.data(), *end = p + in.text.size(), *f[3];
+      size_t len[3];
+      for (size_t i = 0; i < n; ++i) {
+        p = Split(p, end, f, len, 3);
+        DecodeLatLon(f[0], len[0], f[1], len[1], _lat[i], _lon[i]);
+        DMS::flag ind;
+        _h[i] = DMS::Decode(f[2], len[2], ind);
+        if (ind != DMS::NONE)
+          throw GeographicErr("Height " + string(f[2], len[2])
+                              + " includes a hemisphere");
+      }
+    }
+    double t1 = Now();
+    UTMUPS::ForwardBatch(&_lat[0], &_lon[0], n, &_zone[0], _northp,
+                         &_x[0], &_y[0]);
+    double t2 = Now();
+    _geoid.ConvertHeightBatch(&_lat[0], &_lon[0], &_h[0], n,
+                              Geoid::GEOIDTOELLIPSOID, &_h[0]);
+    double t3 = Now();
+    char* b = &_buf[0];
+    const size_t len = _buf.size();
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+      // The lengths of the fields are bounded (|x|, |y| < 1e7), so the
+      // buffer can't overflow.
+      k += Utility::str(b + k, len - k, real(_zone[i]), 0);
+      b[k++] = _northp[i] ? 'n' : 's'; b[k++] = ' ';
+      k += Utility::str(b + k, len - k, _x[i], 3); b[k++] = ' ';
+      k += Utility::str(b + k, len - k, _y[i], 3); b[k++] = ' ';
+      k += Utility::str(b + k, len - k, _h[i], 3); b[k++] = '\n';
+    }
+    double t4 = Now();
+    Checksum(b, k);
+    time[PARSE] += t1 - t0; time[UTM] += t2 - t1;
+    time[GEOID] += t3 - t2; time[FORMAT] += t4 - t3;
+  }
+};
+
+string JSONString(const string& s) {
+  string r("\"");
+  for (size_t i = 0; i < s.size(); ++i) {
+    char c = s[i];
+    if (c == '"' || c == '\\') { r += '\\'; r += c; }
+    else if ((unsigned char)(c) < 0x20) r += ' ';
+    else r += c;
+  }
+  return r + "\"";
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    string filter, ofile,
+      geoidname = Geoid::DefaultGeoidName(), geoidpath;
+    unsigned long long npoints = 10000000ULL;
+    size_t block = 65536;
+    bool list = false, dms = false, cacheall = false;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "--points" && m + 1 < argc)
+        npoints = Utility::num<unsigned long long>(string(argv[++m]));
+      else if (arg == "--block" && m + 1 < argc)
+        block = max(size_t(1), Utility::num<size_t>(string(argv[++m])));
+      else if (arg == "--filter" && m + 1 < argc)
+        filter = argv[++m];
+      else if (arg == "--dms")
+        dms = true;
+      else if (arg == "--geoid-name" && m + 1 < argc)
+        geoidname = argv[++m];
+      else if (arg == "--geoid-path" && m + 1 < argc)
+        geoidpath = argv[++m];
+      else if (arg == "--cache-all")
+        cacheall = true;
+      else if (arg == "--output-file" && m + 1 < argc)
+        ofile = argv[++m];
+      else if (arg == "--list")
+        list = true;
+      else
+        return usage(arg == "-h" ? 0 : 1);
+    }
+    const size_t nw = sizeof(workloads_) / sizeof(workloads_[0]);
+    const char* const modes[] = { "scalar", "batch" };
+    if (list) {
+      for (size_t i = 0; i < nw; ++i)
+        for (int m = 0; m < 2; ++m) {
+          string name = string(modes[m]) + "/" + workloads_[i].name;
+          if (name.find(filter) != string::npos)
+            cout << name << "\n";
+        }
+      return 0;
+    }
+    SyntheticGeoid synthetic;
+    Geoid* geoid;
+    string geoiddesc;
+    try {
+      geoid = new Geoid(geoidname, geoidpath);
+      geoiddesc = geoidname;
+    }
+    catch (const exception& e) {
+      geoid = new Geoid(synthetic);
+      geoiddesc = "synthetic (" + string(e.what()) + ")";
+    }
+    if (cacheall)
+      geoid->CacheAll();
+    ofstream outfile;
+    if (!ofile.empty()) {
+      outfile.open(ofile.c_str());
+      if (!outfile.is_open()) {
+        cerr << "Cannot open " << ofile << " for writing\n";
+        delete geoid;
+        return 1;
+      }
+    }
+    ostream& out = ofile.empty() ? cout : outfile;
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"library_version\": "
+        << JSONString(GEOGRAPHICLIB_VERSION_STRING) << ",\n"
+        << "    \"points\": " << npoints << ",\n"
+        << "    \"block\": " << block << ",\n"
+        << "    \"input\": " << JSONString(dms ? "dms" : "decimal") << ",\n"
+        << "    \"geoid\": " << JSONString(geoiddesc) << ",\n"
+        << "    \"geoid_cached\": " << (cacheall ? "true" : "false") << ",\n"
+        << "    \"instrumentation\": "
+        << (Instrumentation::Enabled() ? "true" : "false") << "\n"
+        << "  },\n"
+        << "  \"runs\": [";
+    bool first = true;
+    for (size_t i = 0; i < nw; ++i) {
+      for (int m = 0; m < 2; ++m) {
+        string name = string(modes[m]) + "/" + workloads_[i].name;
+        if (name.find(filter) == string::npos) continue;
+        out << (first ? "\n" : ",\n") << "    {\n"
+            << "      \"name\": " << JSONString(name) << ",\n";
+        first = false;
+        Workload* w = 0;
+        try {
+          w = workloads_[i].make();
+          // The same points for both modes
+          Random r(i + 1);
+          Pipeline p(*geoid);
+          Input in;
+          Instrumentation::Reset();
+          unsigned long long n = 0;
+          while (n < npoints) {
+            in.text.clear(); in.n = 0;
+            w->Generate(r, size_t(min(npoints - n,
+                                      (unsigned long long)(block))),
+                        dms, in);
+            if (m == 0)
+              p.Scalar(in);
+            else
+              p.Batch(in);
+            n += in.n;
+          }
+          Instrumentation::Snapshot s;
+          bool instr = Instrumentation::GetSnapshot(s);
+          double total = 0;
+          for (int k = 0; k < NSTAGES; ++k) total += p.time[k];
+          out << "      \"points\": " << n << ",\n"
+              << "      \"stages\": {\n";
+          for (int k = 0; k < NSTAGES; ++k)
+            out << "        " << JSONString(stagenames_[k]) << ": {"
+                << fixed << setprecision(3)
+                << " \"time\": " << p.time[k] << ","
+                << setprecision(1)
+                << " \"ns_per_point\": " << 1e9 * p.time[k] / double(n)
+                << " }" << (k + 1 < NSTAGES ? ",\n" : "\n");
+          out << "      },\n"
+              << setprecision(3)
+              << "      \"total_time\": " << total << ",\n"
+              << "      \"time_unit\": \"s\",\n"
+              << setprecision(0)
+              << "      \"points_per_second\": " << double(n) / total << ",\n";
+          out.unsetf(ios::floatfield);
+          out << "      \"output_checksum\": \"" << hex << setfill('0')
+              << setw(16) << p.Sum() << dec << setfill(' ') << "\"";
+          if (instr) {
+            out << ",\n      \"counters\": {";
+            bool f1 = true;
+            for (int k = 0; k < Instrumentation::NCOUNTERS; ++k) {
+              if (!s.count[k]) continue;
+              out << (f1 ? " " : ", ") << JSONString
+                (Instrumentation::Name(Instrumentation::counter(k)))
+                  << ": " << s.count[k];
+              f1 = false;
+            }
+            out << " }";
+          }
+          out << "\n";
+        }
+        catch (const exception& ex) {
+          out << "      \"error_occurred\": true,\n"
+              << "      \"error_message\": " << JSONString(ex.what()) << "\n";
+        }
+        delete w;
+        out << "    }";
+        out.flush();
+      }
+    }
+    out << "\n  ]\n}\n";
+    delete geoid;
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
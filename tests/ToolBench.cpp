@@ -0,0 +1,660 @@
+/**
+ * \file ToolBench.cpp
+ * \brief Throughput benchmarks for the command line tools
+ *
+ * Generate large streams of input for GeodSolve, GeoConvert, CartConvert,
+ * GeoidEval, Planimeter, and MagneticField and measure how fast they are
+ * processed.  The processing of each line is split into the same three
+ * stages as in the tools:
+ * - parse: split the line into fields and decode them (DMS::DecodeLatLon,
+ *   Utility::num, etc.);
+ * - compute: the geodesic, projection, geoid, etc., calculation;
+ * - format: convert the results to text (DMS::Encode, Utility::str, etc.).
+ * .
+ * These stages are run in-process (in blocks of lines, so the cost of
+ * reading the clock is negligible) using the same library calls as the
+ * tools.  If --tool-dir is given, the tools themselves are also run on the
+ * generated input to give the end-to-end throughput, which includes the
+ * line I/O.  The results are written in JSON.
+ **********************************************************************/
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <cmath>
+#include <exception>
+
+#if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#  include <chrono>
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 1
+#else
+#  define GEOGRAPHICLIB_BENCHMARK_CHRONO 0
+#endif
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeoCoords.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real real;
+
+int usage(int retval) {
+  ( retval ? cerr : cout ) <<
+"ToolBench [ --lines n ] [ --filter str ] [ --tool-dir dir ]\n\
+    [ --geoid-name name ] [ --geoid-path dir ]\n\
+    [ --magnetic-name name ] [ --magnetic-path dir ]\n\
+    [ --output-file file ] [ --list ] [ -h ]\n\
+ToolBench --generate workload [ --lines n ]\n\
+\n\
+Measure the throughput of the command line tools on n (default 1000000)\n\
+lines of synthetic input and write the results in JSON.\n\
+\n\
+--lines n the number of lines of input for each workload\n\
+--filter str only run the workloads whose names contain str\n\
+--tool-dir dir also run the tools in dir on the generated input (written\n\
+  to ToolBench-<workload>.txt in the current directory and removed\n\
+  afterwards) and report the end-to-end throughput\n\
+--geoid-name name, --geoid-path dir the geoid for GeoidEval\n\
+--magnetic-name name, --magnetic-path dir the model for MagneticField\n\
+--output-file file write the results to file instead of standard output\n\
+--list list the workloads and exit\n\
+--generate workload write the input for workload to standard output\n";
+  return retval;
+}
+
+// A reproducible source of uniform deviates (the 64-bit LCG of Knuth).
+class Random {
+private:
+  unsigned long long _s;
+public:
+  explicit Random(unsigned long long seed) : _s(seed) {}
+  double Uniform() {
+    _s = _s * 6364136223846793005ULL + 1442695040888963407ULL;
+    return double(_s >> 11) / 9007199254740992.0; // [0, 1)
+  }
+  real Uniform(real a, real b) { return a + (b - a) * real(Uniform()); }
+  // A latitude uniformly distributed in area
+  real Latitude(real a = -90, real b = 90) {
+    using std::sin; using std::asin;
+    return asin(Uniform(sin(a * Math::degree()), sin(b * Math::degree())))
+      / Math::degree();
+  }
+  // Round x to a multiple of 10^-d (as in the test data sets)
+  static real Round(real x, int d) {
+    real m = real(pow(real(10), d));
+    return floor(x * m + real(0.5)) / m;
+  }
+};
+
+// Options passed to the workloads
+struct Options {
+  string geoidname, geoidpath, magneticname, magneticpath;
+};
+
+// The base class for the workloads.  Generate appends one record (a line
+// or, for Planimeter, a polygon) to the input and returns the number of
+// lines.  Parse, Compute, and Format process a block of records.
+class Workload {
+public:
+  virtual ~Workload() {}
+  virtual unsigned Generate(Random& r, ostream& str) = 0;
+  virtual void Parse(const vector<string>& lines) = 0;
+  virtual void Compute() = 0;
+  virtual void Format(ostream& out) = 0;
+};
+
+// Split s into the fields f; throw an error unless there are between
+// nmin and nmax fields.
+inline void Fields(const string& s, string f[], int nmin, int nmax) {
+  istringstream str(s);
+  int n = 0;
+  while (n < nmax && str >> f[n]) ++n;
+  string extra;
+  if (n < nmin)
+    throw GeographicErr("Incomplete input: " + s);
+  if (str >> extra)
+    throw GeographicErr("Extraneous input: " + extra);
+}
+
+// GeodSolve (direct) and GeodSolve -i with the distribution of the
+// "randomly distributed" entries in GeodTest.dat: lat1 in [0, 90], lon1 =
+// 0, azi1 in [0, 180], s12 in [0, 20003931.4586254] m.
+class GeodSolveCase : public Workload {
+private:
+  const Geodesic& _g;
+  bool _inverse;
+  vector<real> _lat1, _lon1, _u, _v, _lat2, _lon2, _azi2;
+public:
+  explicit GeodSolveCase(bool inverse)
+    : _g(Geodesic::WGS84()), _inverse(inverse) {}
+  unsigned Generate(Random& r, ostream& str) {
+    real
+      lat1 = Random::Round(r.Latitude(0, 90), 12),
+      azi1 = Random::Round(r.Uniform(0, 180), 12),
+      s12 = Random::Round(r.Uniform(0, real(20003931.4586254)), 7);
+    if (_inverse) {
+      real lat2, lon2;
+      _g.Direct(lat1, 0, azi1, s12, lat2, lon2);
+      str << Utility::str(lat1, 12) << " 0 "
+          << Utility::str(lat2, 18) << " " << Utility::str(lon2, 18) << "\n";
+    } else
+      str << Utility::str(lat1, 12) << " 0 " << Utility::str(azi1, 12) << " "
+          << Utility::str(s12, 7) << "\n";
+    return 1;
+  }
+  void Parse(const vector<string>& lines) {
+    size_t n = lines.size();
+    _lat1.resize(n); _lon1.resize(n); _u.resize(n); _v.resize(n);
+    string f[4];
+    for (size_t i = 0; i < n; ++i) {
+      Fields(lines[i], f, 4, 4);
+      DMS::DecodeLatLon(f[0], f[1], _lat1[i], _lon1[i]);
+      if (_inverse)
+        DMS::DecodeLatLon(f[2], f[3], _u[i], _v[i]);
+      else {
+        _u[i] = DMS::DecodeAzimuth(f[2]);
+        _v[i] = Utility::num<real>(f[3]);
+      }
+    }
+  }
+  void Compute() {
+    size_t n = _lat1.size();
+    _lat2.resize(n); _lon2.resize(n); _azi2.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      if (_inverse)
+        // _lat2 = azi1, _lon2 = s12
+        _g.Inverse(_lat1[i], _lon1[i], _u[i], _v[i],
+                   _lon2[i], _lat2[i], _azi2[i]);
+      else
+        _g.Direct(_lat1[i], _lon1[i], _u[i], _v[i],
+                  _lat2[i], _lon2[i], _azi2[i]);
+    }
+  }
+  void Format(ostream& out) {
+    const int prec = 3;
+    for (size_t i = 0; i < _lat2.size(); ++i) {
+      if (_inverse)
+        out << DMS::Encode(_lat2[i], prec + 5, DMS::NUMBER) << " "
+            << DMS::Encode(_azi2[i], prec + 5, DMS::NUMBER) << " "
+            << Utility::str(_lon2[i], prec) << "\n";
+      else
+        out << DMS::Encode(_lat2[i], prec + 5, DMS::NUMBER) << " "
+            << DMS::Encode(_lon2[i], prec + 5, DMS::NUMBER) << " "
+            << DMS::Encode(_azi2[i], prec + 5, DMS::NUMBER) << "\n";
+    }
+  }
+};
+
+// GeoConvert -u with random points (6 decimal places).  GeoCoords::Reset
+// (string) both decodes the coordinates and converts them to UTM/UPS;
+// these steps are counted in the parse and compute stages respectively.
+class GeoConvertCase : public Workload {
+private:
+  vector<real> _lat, _lon;
+  vector<GeoCoords> _p;
+public:
+  unsigned Generate(Random& r, ostream& str) {
+    str << Utility::str(Random::Round(r.Latitude(), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(-180, 180), 6), 6) << "\n";
+    return 1;
+  }
+  void Parse(const vector<string>& lines) {
+    size_t n = lines.size();
+    _lat.resize(n); _lon.resize(n);
+    string f[2];
+    for (size_t i = 0; i < n; ++i) {
+      Fields(lines[i], f, 2, 2);
+      DMS::DecodeLatLon(f[0], f[1], _lat[i], _lon[i]);
+    }
+  }
+  void Compute() {
+    _p.resize(_lat.size());
+    for (size_t i = 0; i < _lat.size(); ++i)
+      _p[i].Reset(_lat[i], _lon[i]);
+  }
+  void Format(ostream& out) {
+    char buf[256];
+    for (size_t i = 0; i < _p.size(); ++i) {
+      out.write(buf, streamsize(_p[i].AltUTMUPSRepresentation(0, false,
+                                                              buf,
+                                                              sizeof(buf))));
+      out << "\n";
+    }
+  }
+};
+
+// CartConvert with random points with heights in [-100, 10000] m.
+class CartConvertCase : public Workload {
+private:
+  const Geocentric& _ec;
+  vector<real> _lat, _lon, _h, _x, _y, _z;
+public:
+  CartConvertCase() : _ec(Geocentric::WGS84()) {}
+  unsigned Generate(Random& r, ostream& str) {
+    str << Utility::str(Random::Round(r.Latitude(), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(-180, 180), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(-100, 10000), 3), 3) << "\n";
+    return 1;
+  }
+  void Parse(const vector<string>& lines) {
+    size_t n = lines.size();
+    _lat.resize(n); _lon.resize(n); _h.resize(n);
+    string f[3];
+    for (size_t i = 0; i < n; ++i) {
+      Fields(lines[i], f, 3, 3);
+      DMS::DecodeLatLon(f[0], f[1], _lat[i], _lon[i]);
+      _h[i] = Utility::num<real>(f[2]);
+    }
+  }
+  void Compute() {
+    size_t n = _lat.size();
+    _x.resize(n); _y.resize(n); _z.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      _ec.Forward(_lat[i], _lon[i], _h[i], _x[i], _y[i], _z[i]);
+  }
+  void Format(ostream& out) {
+    const int prec = 10 + Math::extra_digits();
+    for (size_t i = 0; i < _x.size(); ++i)
+      out << Utility::str(_x[i], prec) << " "
+          << Utility::str(_y[i], prec) << " "
+          << Utility::str(_z[i], prec) << "\n";
+  }
+};
+
+// GeoidEval with random points as in GeoidHeights.dat.  As in the tool,
+// the points are converted with GeoCoords (which computes the UTM/UPS
+// coordinates); this is counted in the compute stage.
+class GeoidEvalCase : public Workload {
+private:
+  Geoid _g;
+  vector<real> _lat, _lon, _h;
+  GeoCoords _p;
+public:
+  explicit GeoidEvalCase(const Options& o) : _g(o.geoidname, o.geoidpath) {}
+  unsigned Generate(Random& r, ostream& str) {
+    str << Utility::str(Random::Round(r.Latitude(), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(-180, 180), 6), 6) << "\n";
+    return 1;
+  }
+  void Parse(const vector<string>& lines) {
+    size_t n = lines.size();
+    _lat.resize(n); _lon.resize(n);
+    string f[2];
+    for (size_t i = 0; i < n; ++i) {
+      Fields(lines[i], f, 2, 2);
+      DMS::DecodeLatLon(f[0], f[1], _lat[i], _lon[i]);
+    }
+  }
+  void Compute() {
+    size_t n = _lat.size();
+    _h.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      _p.Reset(_lat[i], _lon[i]);
+      _h[i] = _g(_p.Latitude(), _p.Longitude());
+    }
+  }
+  void Format(ostream& out) {
+    for (size_t i = 0; i < _h.size(); ++i)
+      out << Utility::str(_h[i], 4) << "\n";
+  }
+};
+
+// Planimeter with polygons of 4 to 20 vertices of radius up to 100 km,
+// separated by blank lines.  The lines counted are the vertices.
+class PlanimeterCase : public Workload {
+private:
+  PolygonArea _poly;
+  vector<real> _lat, _lon, _perim, _area;
+  vector<size_t> _start;
+  vector<unsigned> _num;
+  GeoCoords _p;
+public:
+  PlanimeterCase() : _poly(Geodesic::WGS84()) {}
+  unsigned Generate(Random& r, ostream& str) {
+    unsigned n = 4 + unsigned(r.Uniform() * 17);
+    real lat0 = r.Latitude(-80, 80), lon0 = r.Uniform(-180, 180),
+      rad = r.Uniform(1e3, 100e3);
+    for (unsigned j = 0; j < n; ++j) {
+      real lat, lon;
+      Geodesic::WGS84().Direct(lat0, lon0, j * real(360) / n, rad, lat, lon);
+      str << Utility::str(Random::Round(lat, 6), 6) << " "
+          << Utility::str(Random::Round(lon, 6), 6) << "\n";
+    }
+    str << "\n";
+    return n;
+  }
+  void Parse(const vector<string>& lines) {
+    _lat.clear(); _lon.clear(); _start.assign(1, 0);
+    string f[2];
+    for (size_t i = 0; i < lines.size(); ++i) {
+      if (lines[i].empty()) {
+        _start.push_back(_lat.size());
+        continue;
+      }
+      Fields(lines[i], f, 2, 2);
+      real lat, lon;
+      DMS::DecodeLatLon(f[0], f[1], lat, lon);
+      _lat.push_back(lat); _lon.push_back(lon);
+    }
+  }
+  void Compute() {
+    size_t np = _start.size() - 1;
+    _perim.resize(np); _area.resize(np); _num.resize(np);
+    for (size_t k = 0; k < np; ++k) {
+      _poly.Clear();
+      for (size_t i = _start[k]; i < _start[k + 1]; ++i) {
+        _p.Reset(_lat[i], _lon[i]);
+        _poly.AddPoint(_p.Latitude(), _p.Longitude());
+      }
+      _num[k] = _poly.Compute(false, true, _perim[k], _area[k]);
+    }
+  }
+  void Format(ostream& out) {
+    const int prec = 6;
+    for (size_t k = 0; k < _num.size(); ++k)
+      out << _num[k] << " " << Utility::str(_perim[k], prec) << " "
+          << Utility::str(_area[k], max(0, prec - 5)) << "\n";
+  }
+};
+
+// MagneticField with "time lat lon h" in the range of the model.
+class MagneticFieldCase : public Workload {
+private:
+  MagneticModel _m;
+  vector<real> _t, _lat, _lon, _h, _r;
+public:
+  explicit MagneticFieldCase(const Options& o)
+    : _m(o.magneticname, o.magneticpath) {}
+  unsigned Generate(Random& r, ostream& str) {
+    str << Utility::str(Random::Round(r.Uniform(_m.MinTime(), _m.MaxTime()),
+                                      2), 2) << " "
+        << Utility::str(Random::Round(r.Latitude(), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(-180, 180), 6), 6) << " "
+        << Utility::str(Random::Round(r.Uniform(0, 10000), 1), 1) << "\n";
+    return 1;
+  }
+  void Parse(const vector<string>& lines) {
+    size_t n = lines.size();
+    _t.resize(n); _lat.resize(n); _lon.resize(n); _h.resize(n);
+    string f[4];
+    for (size_t i = 0; i < n; ++i) {
+      Fields(lines[i], f, 3, 4);
+      _t[i] = Utility::fractionalyear<real>(f[0]);
+      DMS::DecodeLatLon(f[1], f[2], _lat[i], _lon[i]);
+      _h[i] = f[3].empty() ? 0 : Utility::num<real>(f[3]);
+    }
+  }
+  void Compute() {
+    size_t n = _t.size();
+    _r.resize(14 * n);
+    for (size_t i = 0; i < n; ++i) {
+      real bx, by, bz, bxt, byt, bzt, H, F, D, I, Ht, Ft, Dt, It,
+        *r = &_r[14 * i];
+      _m(_t[i], _lat[i], _lon[i], _h[i], bx, by, bz, bxt, byt, bzt);
+      MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
+                                     H, F, D, I, Ht, Ft, Dt, It);
+      r[0] = D;  r[1] = I;  r[2] = H;  r[3] = by;  r[4] = bx;  r[5] = -bz;
+      r[6] = F;
+      r[7] = Dt; r[8] = It; r[9] = Ht; r[10] = byt; r[11] = bxt;
+      r[12] = -bzt; r[13] = Ft;
+    }
+  }
+  void Format(ostream& out) {
+    const int prec = 1;
+    for (size_t i = 0; i < _t.size(); ++i) {
+      const real* r = &_r[14 * i];
+      for (int k = 0; k < 2; ++k, r += 7)
+        out << DMS::Encode(r[0], prec + 1, DMS::NUMBER) << " "
+            << DMS::Encode(r[1], prec + 1, DMS::NUMBER) << " "
+            << Utility::str(r[2], prec) << " "
+            << Utility::str(r[3], prec) << " "
+            << Utility::str(r[4], prec) << " "
+            << Utility::str(r[5], prec) << " "
+            << Utility::str(r[6], prec) << "\n";
+    }
+  }
+};
+
+typedef Workload* (*Factory)(const Options&);
+
+template<bool I> Workload* MakeGeodSolve(const Options&)
+{ return new GeodSolveCase(I); }
+Workload* MakeGeoConvert(const Options&) { return new GeoConvertCase(); }
+Workload* MakeCartConvert(const Options&) { return new CartConvertCase(); }
+Workload* MakeGeoidEval(const Options& o) { return new GeoidEvalCase(o); }
+Workload* MakePlanimeter(const Options&) { return new PlanimeterCase(); }
+Workload* MakeMagneticField(const Options& o)
+{ return new MagneticFieldCase(o); }
+
+struct Entry {
+  const char* name;             // the name of the workload
+  const char* tool;             // the tool
+  const char* args;             // the arguments for the tool
+  Factory make;
+};
+
+const Entry workloads_[] = {
+  { "GeodSolve", "GeodSolve", "", MakeGeodSolve<false> },
+  { "GeodSolve-i", "GeodSolve", "-i", MakeGeodSolve<true> },
+  { "GeoConvert-u", "GeoConvert", "-u", MakeGeoConvert },
+  { "CartConvert", "CartConvert", "", MakeCartConvert },
+  { "GeoidEval", "GeoidEval", "", MakeGeoidEval },
+  { "Planimeter", "Planimeter", "", MakePlanimeter },
+  { "MagneticField", "MagneticField", "-r", MakeMagneticField },
+};
+
+// The elapsed time (seconds) since some fixed point; the CPU time if a
+// monotonic clock is not available.
+double Now() {
+#if GEOGRAPHICLIB_BENCHMARK_CHRONO
+  return std::chrono::duration<double>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return double(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+// Generate records totalling at least n lines and split them into lines.
+size_t GenerateBlock(Workload& w, Random& r, size_t n,
+                     vector<string>& lines) {
+  ostringstream str;
+  size_t k = 0;
+  while (k < n) k += w.Generate(r, str);
+  lines.clear();
+  istringstream in(str.str());
+  string s;
+  while (getline(in, s)) lines.push_back(s);
+  return k;
+}
+
+string JSONString(const string& s) {
+  string r("\"");
+  for (size_t i = 0; i < s.size(); ++i) {
+    char c = s[i];
+    if (c == '"' || c == '\\') { r += '\\'; r += c; }
+    else if ((unsigned char)(c) < 0x20) r += ' ';
+    else r += c;
+  }
+  return r + "\"";
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    Options opts;
+    opts.geoidname = Geoid::DefaultGeoidName();
+    opts.magneticname = MagneticModel::DefaultMagneticName();
+    string filter, ofile, tooldir, generate;
+    unsigned long long nlines = 1000000ULL;
+    bool list = false;
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "--lines" && m + 1 < argc)
+        nlines = Utility::num<unsigned long long>(string(argv[++m]));
+      else if (arg == "--filter" && m + 1 < argc)
+        filter = argv[++m];
+      else if (arg == "--tool-dir" && m + 1 < argc)
+        tooldir = argv[++m];
+      else if (arg == "--geoid-name" && m + 1 < argc)
+        opts.geoidname = argv[++m];
+      else if (arg == "--geoid-path" && m + 1 < argc)
+        opts.geoidpath = argv[++m];
+      else if (arg == "--magnetic-name" && m + 1 < argc)
+        opts.magneticname = argv[++m];
+      else if (arg == "--magnetic-path" && m + 1 < argc)
+        opts.magneticpath = argv[++m];
+      else if (arg == "--output-file" && m + 1 < argc)
+        ofile = argv[++m];
+      else if (arg == "--generate" && m + 1 < argc)
+        generate = argv[++m];
+      else if (arg == "--list")
+        list = true;
+      else
+        return usage(arg == "-h" ? 0 : 1);
+    }
+    const size_t nw = sizeof(workloads_) / sizeof(workloads_[0]);
+    // The number of lines processed in each block
+    const size_t block = 65536;
+    if (list) {
+      for (size_t i = 0; i < nw; ++i)
+        if (string(workloads_[i].name).find(filter) != string::npos)
+          cout << workloads_[i].name << "\n";
+      return 0;
+    }
+    if (!generate.empty()) {
+      for (size_t i = 0; i < nw; ++i) {
+        if (generate != workloads_[i].name) continue;
+        Workload* w = workloads_[i].make(opts);
+        Random r(i + 1);
+        for (unsigned long long k = 0; k < nlines;)
+          k += w->Generate(r, cout);
+        delete w;
+        return 0;
+      }
+      cerr << "Unknown workload " << generate << "\n";
+      return 1;
+    }
+    ofstream outfile;
+    if (!ofile.empty()) {
+      outfile.open(ofile.c_str());
+      if (!outfile.is_open()) {
+        cerr << "Cannot open " << ofile << " for writing\n";
+        return 1;
+      }
+    }
+    ostream& out = ofile.empty() ? cout : outfile;
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"library_version\": "
+        << JSONString(GEOGRAPHICLIB_VERSION_STRING) << ",\n"
+        << "    \"lines\": " << nlines << ",\n"
+        << "    \"block\": " << block << "\n"
+        << "  },\n"
+        << "  \"workloads\": [";
+    bool first = true;
+    for (size_t i = 0; i < nw; ++i) {
+      const Entry& e = workloads_[i];
+      if (string(e.name).find(filter) == string::npos) continue;
+      out << (first ? "\n" : ",\n") << "    {\n"
+          << "      \"name\": " << JSONString(e.name) << ",\n"
+          << "      \"tool\": "
+          << JSONString(string(e.tool) +
+                        (*e.args ? string(" ") + e.args : string(""))) << ",\n";
+      first = false;
+      Workload* w = 0;
+      try {
+        w = e.make(opts);
+        Random r(i + 1);
+        vector<string> lines;
+        ostringstream sink;
+        double tparse = 0, tcompute = 0, tformat = 0;
+        unsigned long long n = 0;
+        while (n < nlines) {
+          n += GenerateBlock(*w, r,
+                             size_t(min(nlines - n,
+                                        (unsigned long long)(block))),
+                             lines);
+          double t0 = Now();
+          w->Parse(lines);
+          double t1 = Now();
+          w->Compute();
+          double t2 = Now();
+          w->Format(sink);
+          double t3 = Now();
+          tparse += t1 - t0; tcompute += t2 - t1; tformat += t3 - t2;
+          sink.str("");
+        }
+        double total = tparse + tcompute + tformat;
+        out << fixed << setprecision(3)
+            << "      \"lines\": " << n << ",\n"
+            << "      \"parse_time\": " << tparse << ",\n"
+            << "      \"compute_time\": " << tcompute << ",\n"
+            << "      \"format_time\": " << tformat << ",\n"
+            << "      \"time_unit\": \"s\",\n"
+            << setprecision(0)
+            << "      \"lines_per_second\": " << n / total;
+        out.unsetf(ios::floatfield);
+        if (!tooldir.empty()) {
+          // Write the same input to a file and run the tool on it
+          string
+            infile = string("ToolBench-") + e.name + ".txt",
+            cmd = "\"" + tooldir + "/" + e.tool + "\" " + e.args +
+            " < " + infile + " > " +
+#if defined(_WIN32)
+            "NUL"
+#else
+            "/dev/null"
+#endif
+            ;
+          {
+            ofstream in(infile.c_str());
+            Random r1(i + 1);
+            for (unsigned long long k = 0; k < nlines;)
+              k += w->Generate(r1, in);
+          }
+          double t0 = Now();
+          int status = system(cmd.c_str());
+          double t1 = Now();
+          remove(infile.c_str());
+          if (status != 0)
+            out << ",\n      \"tool_error\": "
+                << JSONString("Command failed: " + cmd);
+          else
+            out << ",\n" << fixed << setprecision(0)
+                << "      \"tool_lines_per_second\": " << n / (t1 - t0);
+          out.unsetf(ios::floatfield);
+        }
+        out << "\n";
+      }
+      catch (const exception& ex) {
+        out << "      \"error_occurred\": true,\n"
+            << "      \"error_message\": " << JSONString(ex.what()) << "\n";
+      }
+      delete w;
+      out << "    }";
+      out.flush();
+    }
+    out << "\n  ]\n}\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+  return 0;
+}
@@ -14,8 +14,11 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/GeoCoords.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/LinePipeline.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/MGRS.hpp>
 
@@ -24,38 +27,284 @@
 #  pragma warning (disable: 4127)
 #endif
 
+#if !defined(GEOCONVERT_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOCONVERT_THREADS 1
+#  else
+#    define GEOCONVERT_THREADS 0
+#  endif
+#endif
+
+#if GEOCONVERT_THREADS
+#  include <thread>
+#endif
+
+#if !defined(GEOCONVERT_SERVER)
+#  if GEOCONVERT_THREADS && !defined(_WIN32)
+#    define GEOCONVERT_SERVER 1
+#  else
+#    define GEOCONVERT_SERVER 0
+#  endif
+#endif
+
+#if GEOCONVERT_SERVER
+#  include <cerrno>
+#  include <csignal>
+#  include <cstring>
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
 #include "GeoConvert.usage"
 
+// The settings which control the processing of each line of input
+struct Settings {
+  enum { GEOGRAPHIC, DMS, UTMUPS, MGRS, CONVERGENCE };
+  int outputmode, prec, zone;
+  GeographicLib::GeoCoords::inputform form;
+  bool centerp, swaplatlong, sethemisphere, northp, abbrev;
+  char dmssep;
+  std::string cdelim;
+};
+
+// Process a line of input, s, using p to hold the position and writing the
+// result (or an error message) to out.  Return 1 if there's an error and 0
+// otherwise.
+int ProcessLine(const Settings& c, GeographicLib::GeoCoords& p,
+                std::string s, std::ostream& out) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  const int prec = c.prec;
+  const bool swaplatlong = c.swaplatlong, abbrev = c.abbrev;
+  std::string os;
+  // Scratch space for the representations
+  char buf[256];
+  int retval = 0;
+  std::string eol("\n");
+  try {
+    if (!c.cdelim.empty()) {
+      std::string::size_type m = s.find(c.cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        s = s.substr(0, m);
+      }
+    }
+    if (c.form == GeoCoords::AUTOMATIC)
+      p.Reset(s, c.centerp, swaplatlong);
+    else
+      p.Reset(s, c.form, c.centerp, swaplatlong);
+    p.SetAltZone(c.zone);
+    switch (c.outputmode) {
+    case Settings::GEOGRAPHIC:
+      os.assign(buf, p.GeoRepresentation(prec, swaplatlong,
+                                         buf, sizeof(buf)));
+      break;
+    case Settings::DMS:
+      os = p.DMSRepresentation(prec, swaplatlong, c.dmssep);
+      break;
+    case Settings::UTMUPS:
+      os.assign(buf, c.sethemisphere
+                ? p.AltUTMUPSRepresentation(c.northp, prec, abbrev,
+                                            buf, sizeof(buf))
+                : p.AltUTMUPSRepresentation(prec, abbrev,
+                                            buf, sizeof(buf)));
+      break;
+    case Settings::MGRS:
+      os.assign(buf, p.AltMGRSRepresentation(prec, buf, sizeof(buf)));
+      break;
+    case Settings::CONVERGENCE:
+      {
+        real
+          gamma = p.AltConvergence(),
+          k = p.AltScale();
+        int prec1 = std::max(-5, std::min(Math::extra_digits() + 8, prec));
+        os = Utility::str(gamma, prec1 + 5) + " "
+          + Utility::str(k, prec1 + 7);
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    // Write error message to cout so output lines match input lines
+    os = std::string("ERROR: ") + e.what();
+    retval = 1;
+  }
+  out << os << eol;
+  return retval;
+}
+
+// The processing of the lines of text input.  This is called concurrently
+// from several threads with -j.  Block reuses a GeoCoords for the lines of a
+// piece.
+class LineConverter : public GeographicLib::LinePipeline::Stage {
+private:
+  const Settings& _c;
+  LineConverter& operator=(const LineConverter&);
+public:
+  explicit LineConverter(const Settings& c) : _c(c) {}
+  int operator()(const std::string& s, std::ostream& out) const {
+    GeographicLib::GeoCoords p;
+    return ProcessLine(_c, p, s, out);
+  }
+  int Block(const char* begin, const char* end, std::ostream& out) const {
+    GeographicLib::GeoCoords p;
+    int retval = 0;
+    std::string s;
+    while (begin < end) {
+      const char* nl = std::find(begin, end, '\n');
+      s.assign(begin, nl);
+      retval = std::max(retval, ProcessLine(_c, p, s, out));
+      begin = nl == end ? end : nl + 1;
+    }
+    return retval;
+  }
+};
+
+#if GEOCONVERT_SERVER
+// Create a Unix domain socket listening at path, replacing a stale socket of
+// the same name.  Return the file descriptor, or -1 (with errno set) on
+// failure.
+int ServerListen(const std::string& path) {
+  sockaddr_un addr;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    unlink(path.c_str());
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(fd, SOMAXCONN) < 0) {
+    int e = errno;
+    close(fd);
+    errno = e;
+    return -1;
+  }
+  return fd;
+}
+
+// Send all of s to the socket fd.  Return false if the client has gone away.
+bool SendAll(int fd, const std::string& s) {
+  const char* p = s.data();
+  size_t n = s.size();
+  while (n > 0) {
+    ssize_t k = send(fd, p, n, 0);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += k; n -= size_t(k);
+  }
+  return true;
+}
+
+// Accept connections on the listening socket fd and answer each line
+// received with the output of ProcessLine.  The results for the complete
+// lines in each read from the socket are sent together.  This is run by
+// each of the worker threads with --server.
+void ServeConnections(const Settings* c, int fd) {
+  GeographicLib::GeoCoords p;
+  std::vector<char> buf(65536);
+  std::string pending;
+  while (true) {
+    int cfd = accept(fd, 0, 0);
+    if (cfd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    pending.clear();
+    bool ok = true;
+    while (ok) {
+      ssize_t k = recv(cfd, &buf[0], buf.size(), 0);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) break;
+      pending.append(&buf[0], size_t(k));
+      std::ostringstream out;
+      std::string::size_type b = 0, nl;
+      while ((nl = pending.find('\n', b)) != std::string::npos) {
+        ProcessLine(*c, p, pending.substr(b, nl - b), out);
+        b = nl + 1;
+      }
+      pending.erase(0, b);
+      ok = SendAll(cfd, out.str());
+    }
+    if (ok && !pending.empty()) {
+      // A final line without a newline
+      std::ostringstream out;
+      ProcessLine(*c, p, pending, out);
+      SendAll(cfd, out.str());
+    }
+    close(cfd);
+  }
+}
+
+// Serve requests on the Unix domain socket path with nthreads worker
+// threads.  This only returns if there's an error.
+int RunServer(const Settings& c, const std::string& path, int nthreads) {
+  int fd = ServerListen(path);
+  if (fd < 0) {
+    std::cerr << "Cannot listen on " << path << ": "
+              << std::strerror(errno) << "\n";
+    return 1;
+  }
+  // A client which disconnects early shouldn't kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+  std::vector<std::thread> threads;
+  for (int k = 1; k < nthreads; ++k)
+    threads.push_back(std::thread(ServeConnections, &c, fd));
+  ServeConnections(&c, fd);
+  int e = errno;
+  for (size_t k = 0; k < threads.size(); ++k)
+    threads[k].join();
+  std::cerr << "Error accepting connections on " << path << ": "
+            << std::strerror(e) << "\n";
+  close(fd);
+  return 1;
+}
+#else
+int RunServer(const Settings&, const std::string&, int) {
+  std::cerr << "--server is not supported on this system\n";
+  return 1;
+}
+#endif
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
-    enum { GEOGRAPHIC, DMS, UTMUPS, MGRS, CONVERGENCE };
-    int outputmode = GEOGRAPHIC;
-    int prec = 0;
+    int outputmode = Settings::GEOGRAPHIC;
+    int prec = 0, nthreads = 1;
     int zone = UTMUPS::MATCH;
+    GeoCoords::inputform form = GeoCoords::AUTOMATIC;
     bool centerp = true, swaplatlong = false;
-    std::string istring, ifile, ofile, cdelim;
+    std::string istring, ifile, ofile, cdelim, server;
     char lsep = ';', dmssep = char(0);
     bool sethemisphere = false, northp = false, abbrev = true;
 
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
       if (arg == "-g")
-        outputmode = GEOGRAPHIC;
+        outputmode = Settings::GEOGRAPHIC;
       else if (arg == "-d") {
-        outputmode = DMS;
+        outputmode = Settings::DMS;
         dmssep = '\0';
       } else if (arg == "-:") {
-        outputmode = DMS;
+        outputmode = Settings::DMS;
         dmssep = ':';
       } else if (arg == "-u")
-        outputmode = UTMUPS;
+        outputmode = Settings::UTMUPS;
       else if (arg == "-m")
-        outputmode = MGRS;
+        outputmode = Settings::MGRS;
       else if (arg == "-c")
-        outputmode = CONVERGENCE;
+        outputmode = Settings::CONVERGENCE;
       else if (arg == "-n")
         centerp = false;
       else if (arg == "-w")
@@ -100,6 +349,37 @@ int main(int argc, char* argv[]) {
       } else if (arg == "-t") {
         zone = UTMUPS::UTM;
         sethemisphere = false;
+      } else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--input-format") {
+        if (++m == argc) return usage(1, true);
+        std::string formstr(argv[m]);
+        if (formstr == "mgrs")
+          form = GeoCoords::MGRSFORM;
+        else if (formstr == "geographic")
+          form = GeoCoords::GEOGRAPHICFORM;
+        else if (formstr == "utmups")
+          form = GeoCoords::UTMUPSFORM;
+        else if (formstr == "auto")
+          form = GeoCoords::AUTOMATIC;
+        else {
+          std::cerr << "Unknown input format " << formstr << "\n";
+          return 1;
+        }
+      } else if (arg == "--server") {
+        if (++m == argc) return usage(1, true);
+        server = argv[m];
       } else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
@@ -132,6 +412,11 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!server.empty() &&
+        !(ifile.empty() && istring.empty() && ofile.empty())) {
+      std::cerr << "Cannot specify --server with input or output files\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -165,56 +450,18 @@ int main(int argc, char* argv[]) {
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
 
-    GeoCoords p;
-    std::string s;
-    std::string os;
+    Settings c;
+    c.outputmode = outputmode; c.prec = prec; c.zone = zone; c.form = form;
+    c.centerp = centerp; c.swaplatlong = swaplatlong;
+    c.sethemisphere = sethemisphere; c.northp = northp; c.abbrev = abbrev;
+    c.dmssep = dmssep; c.cdelim = cdelim;
     int retval = 0;
-
-    while (std::getline(*input, s)) {
-      std::string eol("\n");
-      try {
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
-          }
-        }
-        p.Reset(s, centerp, swaplatlong);
-        p.SetAltZone(zone);
-        switch (outputmode) {
-        case GEOGRAPHIC:
-          os = p.GeoRepresentation(prec, swaplatlong);
-          break;
-        case DMS:
-          os = p.DMSRepresentation(prec, swaplatlong, dmssep);
-          break;
-        case UTMUPS:
-          os = (sethemisphere
-                ? p.AltUTMUPSRepresentation(northp, prec, abbrev)
-                : p.AltUTMUPSRepresentation(prec, abbrev));
-          break;
-        case MGRS:
-          os = p.AltMGRSRepresentation(prec);
-          break;
-        case CONVERGENCE:
-          {
-            real
-              gamma = p.AltConvergence(),
-              k = p.AltScale();
-            int prec1 = std::max(-5, std::min(Math::extra_digits() + 8, prec));
-            os = Utility::str(gamma, prec1 + 5) + " "
-              + Utility::str(k, prec1 + 7);
-          }
-        }
-      }
-      catch (const std::exception& e) {
-        // Write error message to cout so output lines match input lines
-        os = std::string("ERROR: ") + e.what();
-        retval = 1;
-      }
-      *output << os << eol;
-    }
+#if !GEOCONVERT_THREADS
+    nthreads = 1;
+#endif
+    if (!server.empty())
+      return RunServer(c, server, nthreads);
+    retval = LinePipeline(nthreads).Run(*input, *output, LineConverter(c));
     return retval;
   }
   catch (const std::exception& e) {
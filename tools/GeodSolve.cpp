@@ -14,11 +14,15 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicLine.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/GeodesicLineExact.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/LinePipeline.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -27,6 +31,36 @@
 #  pragma warning (disable: 4127 4701)
 #endif
 
+#if !defined(GEODSOLVE_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEODSOLVE_THREADS 1
+#  else
+#    define GEODSOLVE_THREADS 0
+#  endif
+#endif
+
+#if GEODSOLVE_THREADS
+#  include <thread>
+#endif
+
+#if !defined(GEODSOLVE_SERVER)
+#  if GEODSOLVE_THREADS && !defined(_WIN32)
+#    define GEODSOLVE_SERVER 1
+#  else
+#    define GEODSOLVE_SERVER 0
+#  endif
+#endif
+
+#if GEODSOLVE_SERVER
+#  include <cerrno>
+#  include <csignal>
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
 #include "GeodSolve.usage"
 
 typedef GeographicLib::Math::real real;
@@ -64,6 +98,422 @@ real ReadDistance(const std::string& s, bool arcmode) {
   return arcmode ? DMS::DecodeAngle(s) : Utility::num<real>(s);
 }
 
+// Binary records are sequences of doubles in little-endian byte order.
+// BinaryInput reads them from a file mapped into memory or, if this isn't
+// possible (e.g., for standard input, specified by "-"), from a stream.
+class BinaryInput {
+private:
+  std::string _name;
+  std::ifstream _file;
+  std::istream* _in;
+  char* _map;
+  void* _handle;
+  unsigned long long _len, _pos;
+  std::vector<char> _buf;
+  BinaryInput(const BinaryInput&);            // Disallow copy
+  BinaryInput& operator=(const BinaryInput&); // and assignment
+public:
+  BinaryInput() : _in(0), _map(0), _handle(0), _len(0), _pos(0) {}
+  ~BinaryInput() { GeographicLib::Utility::unmapfile(_map, _len, _handle); }
+  // Open the input; return false if this fails.
+  bool Open(const std::string& name) {
+    _name = name;
+    if (name == "-") {
+      _in = &std::cin;
+      return true;
+    }
+    try {
+      _map = GeographicLib::Utility::mapfile(name, _len, _handle);
+      return true;
+    }
+    catch (const std::exception&) {
+      // Fall back to reading the file
+    }
+    _file.open(name.c_str(), std::ios::binary);
+    _in = &_file;
+    return _file.is_open();
+  }
+  // Read up to n records of nf fields into the arrays x[0], ..., x[nf-1].
+  // Return the number of records read (0 at the end of the input).
+  size_t Read(size_t nf, size_t n, real* const x[]) {
+    using namespace GeographicLib;
+    const size_t rec = nf * sizeof(double);
+    size_t nbytes = n * rec;
+    const char* p;
+    if (_map) {
+      nbytes = size_t(std::min((unsigned long long)(nbytes), _len - _pos));
+      p = _map + _pos;
+      _pos += nbytes;
+    } else {
+      _buf.resize(nbytes);
+      _in->read(&_buf[0], std::streamsize(nbytes));
+      nbytes = size_t(_in->gcount());
+      p = &_buf[0];
+    }
+    n = nbytes / rec;
+    if (n * rec != nbytes)
+      throw GeographicErr("File " + _name + " ends with a partial record");
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nf; ++j) {
+        double d;
+        std::memcpy(&d, p + (i * nf + j) * sizeof(double), sizeof(double));
+        x[j][i] = real(Math::bigendian ? Math::swab(d) : d);
+      }
+    return n;
+  }
+};
+
+// Write n records of the nf fields x[0], ..., x[nf-1] to out as
+// little-endian doubles using buf as the buffer.
+void WriteRecords(std::ostream& out, size_t nf, size_t n,
+                  const real* const x[], std::vector<char>& buf) {
+  using namespace GeographicLib;
+  buf.resize(n * nf * sizeof(double));
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < nf; ++j) {
+      double d = double(x[j][i]);
+      if (Math::bigendian) d = Math::swab(d);
+      std::memcpy(&buf[(i * nf + j) * sizeof(double)], &d, sizeof(double));
+    }
+  out.write(&buf[0], std::streamsize(buf.size()));
+}
+
+// The settings which control the processing of each line of input
+struct Settings {
+  bool linecalc, inverse, arcmode, dms, full, exact, unroll;
+  real lat1, lon1, azi1, azi2sense;
+  int prec;
+  char dmssep;
+  unsigned outmask;
+  std::string cdelim;
+  const GeographicLib::Geodesic* geods;
+  const GeographicLib::GeodesicExact* geode;
+  const GeographicLib::GeodesicLine* ls;
+  const GeographicLib::GeodesicLineExact* le;
+};
+
+// Process a line of input, s, writing the result (or an error message) to
+// out.  Return 1 if there's an error and 0 otherwise.
+int ProcessLine(const Settings& c, std::string s, std::ostream& out) {
+  using namespace GeographicLib;
+  const bool linecalc = c.linecalc, inverse = c.inverse, arcmode = c.arcmode,
+    dms = c.dms, full = c.full, exact = c.exact, unroll = c.unroll;
+  const int prec = c.prec;
+  const char dmssep = c.dmssep;
+  const unsigned outmask = c.outmask;
+  const std::string& cdelim = c.cdelim;
+  const real azi2sense = c.azi2sense;
+  const Geodesic& geods = *c.geods;
+  const GeodesicExact& geode = *c.geode;
+  const GeodesicLine& ls = *c.ls;
+  const GeodesicLineExact& le = *c.le;
+  real lat1 = c.lat1, lon1 = c.lon1, azi1 = c.azi1,
+    lat2, lon2, azi2, s12, m12, a12, M12, M21, S12;
+  std::ostream* output = &out;
+  int retval = 0;
+  try {
+    std::string eol("\n");
+    if (!cdelim.empty()) {
+      std::string::size_type m = s.find(cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        s = s.substr(0, m);
+      }
+    }
+    std::istringstream str(s);
+    if (inverse) {
+      std::string slat1, slon1, slat2, slon2;
+      if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
+        throw GeographicErr("Incomplete input: " + s);
+      std::string strc;
+      if (str >> strc)
+        throw GeographicErr("Extraneous input: " + strc);
+      DMS::DecodeLatLon(slat1, slon1, lat1, lon1);
+      DMS::DecodeLatLon(slat2, slon2, lat2, lon2);
+      a12 = exact ?
+        geode.GenInverse(lat1, lon1, lat2, lon2, outmask,
+                         s12, azi1, azi2, m12, M12, M21, S12) :
+        geods.GenInverse(lat1, lon1, lat2, lon2, outmask,
+                         s12, azi1, azi2, m12, M12, M21, S12);
+      if (full) {
+        lon2 = Math::AngNormalize(lon2);
+        if (unroll)
+          lon2 = lon1 + Math::AngDiff(Math::AngNormalize(lon1), lon2);
+        else
+          lon1 = Math::AngNormalize(lon1);
+        *output << LatLonString(lat1, lon1, prec, dms, dmssep) << " ";
+      }
+      *output << AzimuthString(azi1, prec, dms, dmssep) << " ";
+      if (full)
+        *output << LatLonString(lat2, lon2, prec, dms, dmssep) << " ";
+      *output << AzimuthString(azi2 + azi2sense, prec, dms, dmssep) << " "
+              << DistanceStrings(s12, a12, full, arcmode, prec, dms);
+      if (full)
+        *output << " " << Utility::str(m12, prec)
+                << " " << Utility::str(M12, prec+7)
+                << " " << Utility::str(M21, prec+7)
+                << " " << Utility::str(S12, std::max(prec-7, 0));
+      *output << eol;
+    } else {
+      if (linecalc) {
+        std::string ss12;
+        if (!(str >> ss12))
+          throw GeographicErr("Incomplete input: " + s);
+        std::string strc;
+        if (str >> strc)
+          throw GeographicErr("Extraneous input: " + strc);
+        s12 = ReadDistance(ss12, arcmode);
+        a12 = exact ?
+          le.GenPosition(arcmode, s12, outmask,
+                         lat2, lon2, azi2, s12, m12, M12, M21, S12) :
+          ls.GenPosition(arcmode, s12, outmask,
+                         lat2, lon2, azi2, s12, m12, M12, M21, S12);
+      } else {
+        std::string slat1, slon1, sazi1, ss12;
+        if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
+          throw GeographicErr("Incomplete input: " + s);
+        std::string strc;
+        if (str >> strc)
+          throw GeographicErr("Extraneous input: " + strc);
+        DMS::DecodeLatLon(slat1, slon1, lat1, lon1);
+        azi1 = DMS::DecodeAzimuth(sazi1);
+        s12 = ReadDistance(ss12, arcmode);
+        a12 = exact ?
+          geode.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
+                          lat2, lon2, azi2, s12, m12, M12, M21, S12) :
+          geods.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
+                          lat2, lon2, azi2, s12, m12, M12, M21, S12);
+      }
+      if (full)
+        *output
+          << LatLonString(lat1, unroll ? lon1 : Math::AngNormalize(lon1),
+                          prec, dms, dmssep) << " "
+          << AzimuthString(azi1, prec, dms, dmssep) << " ";
+      *output << LatLonString(lat2, lon2, prec, dms, dmssep) << " "
+              << AzimuthString(azi2 + azi2sense, prec, dms, dmssep);
+      if (full)
+        *output << " "
+                << DistanceStrings(s12, a12, full, arcmode, prec, dms)
+                << " " << Utility::str(m12, prec)
+                << " " << Utility::str(M12, prec+7)
+                << " " << Utility::str(M21, prec+7)
+                << " " << Utility::str(S12, std::max(prec-7, 0));
+      *output << eol;
+    }
+  }
+  catch (const std::exception& e) {
+    // Write error message cout so output lines match input lines
+    *output << "ERROR: " << e.what() << "\n";
+    retval = 1;
+  }
+  return retval;
+}
+
+// The processing of the lines of text input.  This is called concurrently
+// from several threads with -j.
+class LineSolver : public GeographicLib::LinePipeline::Stage {
+private:
+  const Settings& _c;
+  LineSolver& operator=(const LineSolver&);
+public:
+  explicit LineSolver(const Settings& c) : _c(c) {}
+  int operator()(const std::string& s, std::ostream& out) const
+  { return ProcessLine(_c, s, out); }
+};
+
+#if GEODSOLVE_SERVER
+// Create a Unix domain socket listening at path, replacing a stale socket of
+// the same name.  Return the file descriptor, or -1 (with errno set) on
+// failure.
+int ServerListen(const std::string& path) {
+  sockaddr_un addr;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    unlink(path.c_str());
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(fd, SOMAXCONN) < 0) {
+    int e = errno;
+    close(fd);
+    errno = e;
+    return -1;
+  }
+  return fd;
+}
+
+// Send all of s to the socket fd.  Return false if the client has gone away.
+bool SendAll(int fd, const std::string& s) {
+  const char* p = s.data();
+  size_t n = s.size();
+  while (n > 0) {
+    ssize_t k = send(fd, p, n, 0);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += k; n -= size_t(k);
+  }
+  return true;
+}
+
+// Accept connections on the listening socket fd and answer each line
+// received with the output of ProcessLine.  The results for the complete
+// lines in each read from the socket are sent together.  This is run by
+// each of the worker threads with --server.
+void ServeConnections(const Settings* c, int fd) {
+  std::vector<char> buf(65536);
+  std::string pending;
+  while (true) {
+    int cfd = accept(fd, 0, 0);
+    if (cfd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    pending.clear();
+    bool ok = true;
+    while (ok) {
+      ssize_t k = recv(cfd, &buf[0], buf.size(), 0);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) break;
+      pending.append(&buf[0], size_t(k));
+      std::ostringstream out;
+      std::string::size_type b = 0, nl;
+      while ((nl = pending.find('\n', b)) != std::string::npos) {
+        ProcessLine(*c, pending.substr(b, nl - b), out);
+        b = nl + 1;
+      }
+      pending.erase(0, b);
+      ok = SendAll(cfd, out.str());
+    }
+    if (ok && !pending.empty()) {
+      // A final line without a newline
+      std::ostringstream out;
+      ProcessLine(*c, pending, out);
+      SendAll(cfd, out.str());
+    }
+    close(cfd);
+  }
+}
+
+// Serve requests on the Unix domain socket path with nthreads worker
+// threads.  This only returns if there's an error.
+int RunServer(const Settings& c, const std::string& path, int nthreads) {
+  int fd = ServerListen(path);
+  if (fd < 0) {
+    std::cerr << "Cannot listen on " << path << ": "
+              << std::strerror(errno) << "\n";
+    return 1;
+  }
+  // A client which disconnects early shouldn't kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+  std::vector<std::thread> threads;
+  for (int k = 1; k < nthreads; ++k)
+    threads.push_back(std::thread(ServeConnections, &c, fd));
+  ServeConnections(&c, fd);
+  int e = errno;
+  for (size_t k = 0; k < threads.size(); ++k)
+    threads[k].join();
+  std::cerr << "Error accepting connections on " << path << ": "
+            << std::strerror(e) << "\n";
+  close(fd);
+  return 1;
+}
+#else
+int RunServer(const Settings&, const std::string&, int) {
+  std::cerr << "--server is not supported on this system\n";
+  return 1;
+}
+#endif
+
+// Solve the problems given by binary records [i0, i1).  The input fields
+// are in the arrays in, (lat1, lon1, lat2, lon2) for the inverse problem,
+// (lat1, lon1, azi1, s12) for the direct problem, and (s12) with -l; with
+// -a, s12 is replaced by a12.  The output fields, in the order of the
+// output of -f, are put into the 12 arrays w.  This is called concurrently
+// from several threads with -j.
+void SolveRecords(const Settings* c, size_t i0, size_t i1,
+                  real* const* in, real* const* w) {
+  using namespace GeographicLib;
+  size_t n = i1 - i0;
+  if (n == 0) return;
+  real
+    *lat1 = w[0] + i0, *lon1 = w[1] + i0, *azi1 = w[2] + i0,
+    *lat2 = w[3] + i0, *lon2 = w[4] + i0, *azi2 = w[5] + i0,
+    *s12 = w[6] + i0, *a12 = w[7] + i0, *m12 = w[8] + i0,
+    *M12 = w[9] + i0, *M21 = w[10] + i0, *S12 = w[11] + i0;
+  if (c->inverse) {
+    std::copy(in[0] + i0, in[0] + i1, lat1);
+    std::copy(in[1] + i0, in[1] + i1, lon1);
+    std::copy(in[2] + i0, in[2] + i1, lat2);
+    std::copy(in[3] + i0, in[3] + i1, lon2);
+    if (c->exact)
+      c->geode->GenInverseBatch(lat1, lon1, lat2, lon2, n, c->outmask,
+                                s12, azi1, azi2, m12, M12, M21, S12, a12);
+    else
+      c->geods->GenInverseBatch(lat1, lon1, lat2, lon2, n, c->outmask,
+                                s12, azi1, azi2, m12, M12, M21, S12, a12);
+    if (c->full) {
+      for (size_t i = 0; i < n; ++i) {
+        lon2[i] = Math::AngNormalize(lon2[i]);
+        if (c->unroll)
+          lon2[i] = lon1[i] + Math::AngDiff(Math::AngNormalize(lon1[i]),
+                                            lon2[i]);
+        else
+          lon1[i] = Math::AngNormalize(lon1[i]);
+      }
+    }
+  } else {
+    const real* s12_a12 = in[c->linecalc ? 0 : 3] + i0;
+    if (c->linecalc) {
+      for (size_t i = 0; i < n; ++i) {
+        lat1[i] = c->lat1; lon1[i] = c->lon1; azi1[i] = c->azi1;
+        a12[i] = c->exact ?
+          c->le->GenPosition(c->arcmode, s12_a12[i], c->outmask,
+                             lat2[i], lon2[i], azi2[i], s12[i],
+                             m12[i], M12[i], M21[i], S12[i]) :
+          c->ls->GenPosition(c->arcmode, s12_a12[i], c->outmask,
+                             lat2[i], lon2[i], azi2[i], s12[i],
+                             m12[i], M12[i], M21[i], S12[i]);
+      }
+    } else {
+      std::copy(in[0] + i0, in[0] + i1, lat1);
+      std::copy(in[1] + i0, in[1] + i1, lon1);
+      for (size_t i = 0; i < n; ++i)
+        azi1[i] = Math::AngNormalize(in[2][i0 + i]);
+      if (c->exact) {
+        // There's no batch version of GeodesicExact::GenDirect
+        for (size_t i = 0; i < n; ++i)
+          a12[i] = c->geode->GenDirect(lat1[i], lon1[i], azi1[i],
+                                       c->arcmode, s12_a12[i], c->outmask,
+                                       lat2[i], lon2[i], azi2[i], s12[i],
+                                       m12[i], M12[i], M21[i], S12[i]);
+      } else
+        c->geods->GenDirectBatch(lat1, lon1, azi1, c->arcmode, s12_a12, n,
+                                 c->outmask, lat2, lon2, azi2, s12,
+                                 m12, M12, M21, S12, a12);
+    }
+    if (c->full && !c->unroll) {
+      for (size_t i = 0; i < n; ++i)
+        lon1[i] = Math::AngNormalize(lon1[i]);
+    }
+  }
+  // Follow AzimuthString in reducing azimuths to [-180d, 180d)
+  for (size_t i = 0; i < n; ++i) {
+    azi2[i] += c->azi2sense;
+    if (azi1[i] >= 180) azi1[i] -= 360;
+    if (azi2[i] >= 180) azi2[i] -= 360;
+  }
+}
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
@@ -73,10 +523,10 @@ int main(int argc, char* argv[]) {
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
-    real lat1, lon1, azi1, lat2, lon2, azi2, s12, m12, a12, M12, M21, S12;
+    real lat1 = 0, lon1 = 0, azi1 = 0;
     real azi2sense = 0;
-    int prec = 3;
-    std::string istring, ifile, ofile, cdelim;
+    int prec = 3, nthreads = 1;
+    std::string istring, ifile, ofile, cdelim, bfile, bofile, server;
     char lsep = ';', dmssep = char(0);
 
     for (int m = 1; m < argc; ++m) {
@@ -134,7 +584,24 @@ int main(int argc, char* argv[]) {
         }
       } else if (arg == "-E")
         exact = true;
-      else if (arg == "--input-string") {
+      else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      }
+      else if (arg == "--server") {
+        if (++m == argc) return usage(1, true);
+        server = argv[m];
+      } else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
@@ -143,6 +610,12 @@ int main(int argc, char* argv[]) {
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -165,6 +638,26 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (bfile.empty() != bofile.empty()) {
+      std::cerr << "--binary-file and --binary-output must be given "
+                << "together\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
+    if (!server.empty() &&
+        !(ifile.empty() && istring.empty() && ofile.empty() && bfile.empty())) {
+      std::cerr << "Cannot specify --server with input or output files\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -197,6 +690,20 @@ int main(int argc, char* argv[]) {
       }
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    BinaryInput binin;
+    if (!bfile.empty() && !binin.Open(bfile)) {
+      std::cerr << "Cannot open " << bfile << " for reading\n";
+      return 1;
+    }
+    std::ofstream binfile;
+    if (!bofile.empty() && bofile != "-") {
+      binfile.open(bofile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
+    std::ostream* binoutput = bofile != "-" ? &binfile : &std::cout;
 
     // GeodesicExact mask values are the same as Geodesic
     unsigned outmask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
@@ -215,114 +722,75 @@ int main(int argc, char* argv[]) {
     GeodesicLine      ls;
     GeodesicLineExact le;
     if (linecalc) {
-      if (exact)
+      if (exact) {
         le = geode.Line(lat1, lon1, azi1, outmask);
-      else
+        // Many points are usually computed on the line
+        le.PrecomputeSeries();
+      } else
         ls = geods.Line(lat1, lon1, azi1, outmask);
     }
 
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s;
+    Settings c;
+    c.linecalc = linecalc; c.inverse = inverse; c.arcmode = arcmode;
+    c.dms = dms; c.full = full; c.exact = exact; c.unroll = unroll;
+    c.lat1 = lat1; c.lon1 = lon1; c.azi1 = azi1; c.azi2sense = azi2sense;
+    c.prec = prec; c.dmssep = dmssep; c.outmask = outmask; c.cdelim = cdelim;
+    c.geods = &geods; c.geode = &geode; c.ls = &ls; c.le = &le;
     int retval = 0;
-    while (std::getline(*input, s)) {
-      try {
-        std::string eol("\n");
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
-          }
-        }
-        std::istringstream str(s);
-        if (inverse) {
-          std::string slat1, slon1, slat2, slon2;
-          if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
-            throw GeographicErr("Incomplete input: " + s);
-          std::string strc;
-          if (str >> strc)
-            throw GeographicErr("Extraneous input: " + strc);
-          DMS::DecodeLatLon(slat1, slon1, lat1, lon1);
-          DMS::DecodeLatLon(slat2, slon2, lat2, lon2);
-          a12 = exact ?
-            geode.GenInverse(lat1, lon1, lat2, lon2, outmask,
-                             s12, azi1, azi2, m12, M12, M21, S12) :
-            geods.GenInverse(lat1, lon1, lat2, lon2, outmask,
-                             s12, azi1, azi2, m12, M12, M21, S12);
-          if (full) {
-            lon2 = Math::AngNormalize(lon2);
-            if (unroll)
-              lon2 = lon1 + Math::AngDiff(Math::AngNormalize(lon1), lon2);
-            else
-              lon1 = Math::AngNormalize(lon1);
-            *output << LatLonString(lat1, lon1, prec, dms, dmssep) << " ";
-          }
-          *output << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          if (full)
-            *output << LatLonString(lat2, lon2, prec, dms, dmssep) << " ";
-          *output << AzimuthString(azi2 + azi2sense, prec, dms, dmssep) << " "
-                  << DistanceStrings(s12, a12, full, arcmode, prec, dms);
-          if (full)
-            *output << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
-        } else {
-          if (linecalc) {
-            std::string ss12;
-            if (!(str >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            std::string strc;
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            s12 = ReadDistance(ss12, arcmode);
-            a12 = exact ?
-              le.GenPosition(arcmode, s12, outmask,
-                             lat2, lon2, azi2, s12, m12, M12, M21, S12) :
-              ls.GenPosition(arcmode, s12, outmask,
-                             lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          } else {
-            std::string slat1, slon1, sazi1, ss12;
-            if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            std::string strc;
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            DMS::DecodeLatLon(slat1, slon1, lat1, lon1);
-            azi1 = DMS::DecodeAzimuth(sazi1);
-            s12 = ReadDistance(ss12, arcmode);
-            a12 = exact ?
-              geode.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
-                              lat2, lon2, azi2, s12, m12, M12, M21, S12) :
-              geods.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
-                              lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          }
-          if (full)
-            *output
-              << LatLonString(lat1, unroll ? lon1 : Math::AngNormalize(lon1),
-                              prec, dms, dmssep) << " "
-              << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep) << " "
-                  << AzimuthString(azi2 + azi2sense, prec, dms, dmssep);
-          if (full)
-            *output << " "
-                    << DistanceStrings(s12, a12, full, arcmode, prec, dms)
-                    << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
-        }
+#if !GEODSOLVE_THREADS
+    nthreads = 1;
+#endif
+    if (!server.empty())
+      return RunServer(c, server, nthreads);
+    if (!bfile.empty()) {
+      // Read the binary records in chunks and split each chunk between the
+      // threads.  The output records are written in the order of the input.
+      const size_t chunk = 65536 * size_t(nthreads),
+        nin = linecalc ? 1 : 4, nw = 12;
+      std::vector<real> inbuf(nin * chunk), wbuf(nw * chunk);
+      real* in[4];
+      real* w[12];
+      for (size_t j = 0; j < nin; ++j) in[j] = &inbuf[j * chunk];
+      for (size_t j = 0; j < nw; ++j) w[j] = &wbuf[j * chunk];
+      // The output fields are those printed for text input
+      const real* out[12];
+      size_t nout = 3;
+      if (full) {
+        nout = nw;
+        for (size_t j = 0; j < nw; ++j) out[j] = w[j];
+      } else if (inverse) {
+        out[0] = w[2]; out[1] = w[5]; out[2] = w[arcmode ? 7 : 6];
+      } else {
+        out[0] = w[3]; out[1] = w[4]; out[2] = w[5];
+      }
+      std::vector<char> obuf;
+      size_t n;
+      while ((n = binin.Read(nin, chunk, in)) > 0) {
+#if GEODSOLVE_THREADS
+        std::vector<std::thread> threads;
+        for (int k = 1; k < nthreads; ++k)
+          threads.push_back(std::thread(SolveRecords, &c,
+                                        n * k / nthreads,
+                                        n * (k + 1) / nthreads, in, w));
+#endif
+        SolveRecords(&c, 0, n / nthreads, in, w);
+#if GEODSOLVE_THREADS
+        for (size_t k = 0; k < threads.size(); ++k)
+          threads[k].join();
+#endif
+        WriteRecords(*binoutput, nout, n, out, obuf);
       }
-      catch (const std::exception& e) {
-        // Write error message cout so output lines match input lines
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+      binoutput->flush();
+      if (!*binoutput) {
+        std::cerr << "Error writing " << bofile << "\n";
+        return 1;
       }
+      return 0;
     }
+    retval = LinePipeline(nthreads).Run(*input, *output, LineSolver(c));
     return retval;
   }
   catch (const std::exception& e) {
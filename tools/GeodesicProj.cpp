@@ -14,6 +14,9 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/AzimuthalEquidistant.hpp>
 #include <GeographicLib/CassiniSoldner.hpp>
@@ -29,6 +32,88 @@
 
 #include "GeodesicProj.usage"
 
+typedef GeographicLib::Math::real real;
+
+// Binary records are sequences of doubles in little-endian byte order.
+// BinaryInput reads them from a file mapped into memory or, if this isn't
+// possible (e.g., for standard input, specified by "-"), from a stream.
+class BinaryInput {
+private:
+  std::string _name;
+  std::ifstream _file;
+  std::istream* _in;
+  char* _map;
+  void* _handle;
+  unsigned long long _len, _pos;
+  std::vector<char> _buf;
+  BinaryInput(const BinaryInput&);            // Disallow copy
+  BinaryInput& operator=(const BinaryInput&); // and assignment
+public:
+  BinaryInput() : _in(0), _map(0), _handle(0), _len(0), _pos(0) {}
+  ~BinaryInput() { GeographicLib::Utility::unmapfile(_map, _len, _handle); }
+  // Open the input; return false if this fails.
+  bool Open(const std::string& name) {
+    _name = name;
+    if (name == "-") {
+      _in = &std::cin;
+      return true;
+    }
+    try {
+      _map = GeographicLib::Utility::mapfile(name, _len, _handle);
+      return true;
+    }
+    catch (const std::exception&) {
+      // Fall back to reading the file
+    }
+    _file.open(name.c_str(), std::ios::binary);
+    _in = &_file;
+    return _file.is_open();
+  }
+  // Read up to n records of nf fields into the arrays x[0], ..., x[nf-1].
+  // Return the number of records read (0 at the end of the input).
+  size_t Read(size_t nf, size_t n, real* const x[]) {
+    using namespace GeographicLib;
+    const size_t rec = nf * sizeof(double);
+    size_t nbytes = n * rec;
+    const char* p;
+    if (_map) {
+      nbytes = size_t(std::min((unsigned long long)(nbytes), _len - _pos));
+      p = _map + _pos;
+      _pos += nbytes;
+    } else {
+      _buf.resize(nbytes);
+      _in->read(&_buf[0], std::streamsize(nbytes));
+      nbytes = size_t(_in->gcount());
+      p = &_buf[0];
+    }
+    n = nbytes / rec;
+    if (n * rec != nbytes)
+      throw GeographicErr("File " + _name + " ends with a partial record");
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nf; ++j) {
+        double d;
+        std::memcpy(&d, p + (i * nf + j) * sizeof(double), sizeof(double));
+        x[j][i] = real(Math::bigendian ? Math::swab(d) : d);
+      }
+    return n;
+  }
+};
+
+// Write n records of the nf fields x[0], ..., x[nf-1] to out as
+// little-endian doubles using buf as the buffer.
+void WriteRecords(std::ostream& out, size_t nf, size_t n,
+                  const real* const x[], std::vector<char>& buf) {
+  using namespace GeographicLib;
+  buf.resize(n * nf * sizeof(double));
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < nf; ++j) {
+      double d = double(x[j][i]);
+      if (Math::bigendian) d = Math::swab(d);
+      std::memcpy(&buf[(i * nf + j) * sizeof(double)], &d, sizeof(double));
+    }
+  out.write(&buf[0], std::streamsize(buf.size()));
+}
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
@@ -40,7 +125,7 @@ int main(int argc, char* argv[]) {
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     int prec = 6;
-    std::string istring, ifile, ofile, cdelim;
+    std::string istring, ifile, ofile, cdelim, bfile, bofile;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -91,6 +176,12 @@ int main(int argc, char* argv[]) {
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -113,6 +204,21 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (bfile.empty() != bofile.empty()) {
+      std::cerr << "--binary-file and --binary-output must be given "
+                << "together\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -145,6 +251,20 @@ int main(int argc, char* argv[]) {
       }
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    BinaryInput binin;
+    if (!bfile.empty() && !binin.Open(bfile)) {
+      std::cerr << "Cannot open " << bfile << " for reading\n";
+      return 1;
+    }
+    std::ofstream binfile;
+    if (!bofile.empty() && bofile != "-") {
+      binfile.open(bofile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
+    std::ostream* binoutput = bofile != "-" ? &binfile : &std::cout;
 
     if (!(azimuthal || cassini || gnomonic)) {
       std::cerr << "Must specify \"-z lat0 lon0\" or "
@@ -161,6 +281,47 @@ int main(int argc, char* argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
+    if (!bfile.empty()) {
+      // Read the binary records in chunks.  The input records are (lat,
+      // lon), or (x, y) with -r; the output records are (x, y, azi, rk), or
+      // (lat, lon, azi, rk) with -r.
+      const size_t chunk = 65536, nin = 2, nout = 4;
+      std::vector<real> buf((nin + nout) * chunk);
+      real* in[2];
+      real* out[4];
+      for (size_t j = 0; j < nin; ++j) in[j] = &buf[j * chunk];
+      for (size_t j = 0; j < nout; ++j) out[j] = &buf[(nin + j) * chunk];
+      std::vector<char> obuf;
+      size_t n;
+      while ((n = binin.Read(nin, chunk, in)) > 0) {
+        if (reverse) {
+          if (cassini)
+            cs.ReverseBatch(in[0], in[1], n, out[0], out[1], out[2], out[3]);
+          else if (azimuthal)
+            az.ReverseBatch(lat0, lon0, in[0], in[1], n,
+                            out[0], out[1], out[2], out[3]);
+          else
+            gn.ReverseBatch(lat0, lon0, in[0], in[1], n,
+                            out[0], out[1], out[2], out[3]);
+        } else {
+          if (cassini)
+            cs.ForwardBatch(in[0], in[1], n, out[0], out[1], out[2], out[3]);
+          else if (azimuthal)
+            az.ForwardBatch(lat0, lon0, in[0], in[1], n,
+                            out[0], out[1], out[2], out[3]);
+          else
+            gn.ForwardBatch(lat0, lon0, in[0], in[1], n,
+                            out[0], out[1], out[2], out[3]);
+        }
+        WriteRecords(*binoutput, nout, n, out, obuf);
+      }
+      binoutput->flush();
+      if (!*binoutput) {
+        std::cerr << "Error writing " << bofile << "\n";
+        return 1;
+      }
+      return 0;
+    }
     std::string s;
     int retval = 0;
     std::cout << std::fixed;
@@ -0,0 +1,993 @@
+/**
+ * \file GeographicServer.cpp
+ * \brief A persistent HTTP service for batches of geodesic, rhumb line,
+ *   coordinate conversion, geoid, and area calculations
+ *
+ * Copyright (c) Charles Karney (2015) <charles@karney.com> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * http://geographiclib.sourceforge.net/
+ *
+ * See the <a href="GeographicServer.1.html">man page</a> for usage
+ * information.
+ **********************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <limits>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#if !defined(GEOGRAPHICSERVER_THREADS)
+#  if __cplusplus >= 201103
+#    define GEOGRAPHICSERVER_THREADS 1
+#  else
+#    define GEOGRAPHICSERVER_THREADS 0
+#  endif
+#endif
+
+#if GEOGRAPHICSERVER_THREADS
+#  include <thread>
+#endif
+
+#include "GeographicServer.usage"
+
+using namespace GeographicLib;
+typedef Math::real real;
+
+// An error to be reported to the client with an HTTP status code.  close
+// is set if the framing of the request has been lost, so that the
+// connection must be closed.
+struct HttpError {
+  int status;
+  std::string message;
+  bool close;
+  HttpError(int s, const std::string& m, bool c = false)
+    : status(s), message(m), close(c) {}
+};
+
+struct Request {
+  std::string method, path, query, type, body;
+  bool keepalive;
+};
+
+struct Response {
+  int status;
+  std::string type, body;
+  Response() : status(200), type("application/json") {}
+};
+
+// The source and destination of the bytes of a connection: a socket (or
+// standard input and output with --inetd) or, for --input-string, a string
+// and standard output.
+class Channel {
+public:
+  // Read up to n bytes into buf; return 0 at the end of the input (or on a
+  // timeout or an error).
+  virtual size_t Read(char* buf, size_t n) = 0;
+  // Wait up to t seconds for input; return false if none arrives.
+  virtual bool Wait(int /*t*/) { return true; }
+  virtual void Write(const char* buf, size_t n) = 0;
+  virtual ~Channel() {}
+};
+
+class FdChannel : public Channel {
+private:
+  int _in, _out;
+public:
+  FdChannel(int in, int out) : _in(in), _out(out) {}
+  size_t Read(char* buf, size_t n) {
+    for (;;) {
+      ssize_t k = read(_in, buf, n);
+      if (k >= 0) return size_t(k);
+      if (errno != EINTR) return 0;
+    }
+  }
+  bool Wait(int t) {
+    struct pollfd pfd;
+    pfd.fd = _in; pfd.events = POLLIN; pfd.revents = 0;
+    for (;;) {
+      int k = poll(&pfd, 1, t * 1000);
+      if (k >= 0) return k > 0;
+      if (errno != EINTR) return false;
+    }
+  }
+  void Write(const char* buf, size_t n) {
+    while (n > 0) {
+      ssize_t k = write(_out, buf, n);
+      if (k < 0) {
+        if (errno == EINTR) continue;
+        throw GeographicErr("Connection closed by client");
+      }
+      buf += k; n -= size_t(k);
+    }
+  }
+};
+
+class StringChannel : public Channel {
+private:
+  std::string _in;
+  size_t _pos;
+  std::ostream& _out;
+  StringChannel& operator=(const StringChannel&);
+public:
+  StringChannel(const std::string& in, std::ostream& out)
+    : _in(in), _pos(0), _out(out) {}
+  size_t Read(char* buf, size_t n) {
+    n = std::min(n, _in.size() - _pos);
+    std::memcpy(buf, _in.data() + _pos, n);
+    _pos += n;
+    return n;
+  }
+  void Write(const char* buf, size_t n) {
+    _out.write(buf, std::streamsize(n));
+    _out.flush();
+  }
+};
+
+std::string Lower(std::string s) {
+  for (size_t i = 0; i < s.size(); ++i)
+    s[i] = char(std::tolower(s[i]));
+  return s;
+}
+
+std::string Trim(const std::string& s) {
+  size_t b = s.find_first_not_of(" \t\r"), e = s.find_last_not_of(" \t\r");
+  return b == std::string::npos ? std::string() : s.substr(b, e + 1 - b);
+}
+
+// Read HTTP/1.x requests from a channel and write the responses.
+class HttpConnection {
+private:
+  static const size_t maxheader_ = 16384;
+  Channel& _ch;
+  size_t _maxbody;
+  int _idle;
+  bool _first;
+  std::string _buf;
+  HttpConnection& operator=(const HttpConnection&);
+  bool Fill() {
+    char tmp[65536];
+    size_t k = _ch.Read(tmp, sizeof(tmp));
+    if (k == 0) return false;
+    _buf.append(tmp, k);
+    return true;
+  }
+  // The end of the header (the start of the body) or npos
+  size_t HeaderEnd() const {
+    size_t crlf = _buf.find("\r\n\r\n"), lf = _buf.find("\n\n");
+    if (crlf != std::string::npos && (lf == std::string::npos || crlf < lf))
+      return crlf + 4;
+    return lf == std::string::npos ? lf : lf + 2;
+  }
+public:
+  // A kept-alive connection is closed if the next request doesn't start
+  // within idle seconds.
+  HttpConnection(Channel& ch, size_t maxbody, int idle)
+    : _ch(ch), _maxbody(maxbody), _idle(idle), _first(true) {}
+  // Read the next request; return false at the end of the input.
+  bool Next(Request& req) {
+    size_t hend;
+    for (;;) {
+      // Skip empty lines before the request
+      size_t start = _buf.find_first_not_of("\r\n");
+      _buf.erase(0, start == std::string::npos ? _buf.size() : start);
+      if ((hend = HeaderEnd()) != std::string::npos)
+        break;
+      if (_buf.size() > maxheader_)
+        throw HttpError(431, "Request header too large", true);
+      if (_buf.empty() && !_first && !_ch.Wait(_idle))
+        return false;
+      if (!Fill()) {
+        if (_buf.empty()) return false;
+        throw HttpError(400, "Incomplete request header", true);
+      }
+    }
+    std::istringstream header(_buf.substr(0, hend));
+    std::string line, version, target;
+    std::getline(header, line);
+    {
+      std::istringstream str(line);
+      if (!(str >> req.method >> target >> version) ||
+          version.compare(0, 5, "HTTP/") != 0)
+        throw HttpError(400, "Malformed request line", true);
+    }
+    size_t q = target.find('?');
+    req.path = target.substr(0, q);
+    req.query = q == std::string::npos ? std::string() : target.substr(q + 1);
+    req.type.clear();
+    req.keepalive = version != "HTTP/1.0";
+    size_t len = 0;
+    while (std::getline(header, line)) {
+      size_t colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      std::string
+        name = Lower(Trim(line.substr(0, colon))),
+        value = Trim(line.substr(colon + 1));
+      if (name == "content-length") {
+        char* end;
+        unsigned long l = std::strtoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0')
+          throw HttpError(400, "Bad Content-Length", true);
+        if (l > _maxbody)
+          throw HttpError(413, "Request body too large", true);
+        len = size_t(l);
+      } else if (name == "content-type")
+        req.type = Lower(value.substr(0, value.find(';')));
+      else if (name == "connection") {
+        value = Lower(value);
+        if (value == "close")
+          req.keepalive = false;
+        else if (value == "keep-alive")
+          req.keepalive = true;
+      } else if (name == "transfer-encoding" && Lower(value) != "identity")
+        throw HttpError(501, "Transfer-Encoding not supported", true);
+    }
+    while (_buf.size() < hend + len)
+      if (!Fill()) throw HttpError(400, "Incomplete request body", true);
+    req.body = _buf.substr(hend, len);
+    _buf.erase(0, hend + len);
+    _first = false;
+    return true;
+  }
+  void Send(const Response& resp, bool keepalive) {
+    const char* reason =
+      resp.status == 200 ? "OK" :
+      resp.status == 400 ? "Bad Request" :
+      resp.status == 404 ? "Not Found" :
+      resp.status == 405 ? "Method Not Allowed" :
+      resp.status == 413 ? "Payload Too Large" :
+      resp.status == 431 ? "Request Header Fields Too Large" :
+      resp.status == 501 ? "Not Implemented" : "Internal Server Error";
+    std::ostringstream str;
+    str << "HTTP/1.1 " << resp.status << " " << reason << "\r\n"
+        << "Content-Type: " << resp.type << "\r\n"
+        << "Content-Length: " << resp.body.size() << "\r\n"
+        << "Connection: " << (keepalive ? "keep-alive" : "close") << "\r\n"
+        << "\r\n" << resp.body;
+    std::string s(str.str());
+    _ch.Write(s.data(), s.size());
+  }
+};
+
+// Decode %XX and + in a component of a query string.
+std::string Unescape(const std::string& s) {
+  std::string r;
+  for (size_t i = 0; i < s.size(); ++i) {
+    if (s[i] == '+')
+      r += ' ';
+    else if (s[i] == '%' && i + 2 < s.size() &&
+             std::isxdigit(s[i + 1]) && std::isxdigit(s[i + 2])) {
+      r += char(std::strtol(s.substr(i + 1, 2).c_str(), 0, 16));
+      i += 2;
+    } else
+      r += s[i];
+  }
+  return r;
+}
+
+// Look up a key in a query string; return the default if it's absent.
+std::string QueryValue(const std::string& query, const std::string& key,
+                       const std::string& def = "") {
+  std::string val = def;
+  size_t p = 0;
+  while (p <= query.size()) {
+    size_t amp = std::min(query.find('&', p), query.size());
+    std::string item = query.substr(p, amp - p);
+    size_t eq = item.find('=');
+    if (Unescape(item.substr(0, eq)) == key)
+      val = eq == std::string::npos ? "" : Unescape(item.substr(eq + 1));
+    p = amp + 1;
+  }
+  return val;
+}
+
+// Parse a JSON array of records, each a flat array of numbers, into v; null
+// is treated as NaN.  start receives the offsets into v of the records
+// followed by v.size().  The numbers are read with Utility::num, as in the
+// other tools, rather than with strtod, which depends on the C locale.
+void ParseJSON(const std::string& s, std::vector<real>& v,
+               std::vector<size_t>& start) {
+  v.clear(); start.clear();
+  int depth = 0;
+  bool done = false, value = false; // value: may a value come next?
+  const char* p = s.c_str();
+  const char* end = p + s.size();
+  while (p < end) {
+    char c = *p;
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      ++p; continue;
+    }
+    if (done)
+      throw HttpError(400, "Unexpected data after JSON array");
+    if (c == '[') {
+      if (depth > 0 && !value)
+        throw HttpError(400, "Missing comma in JSON array");
+      if (depth == 2)
+        throw HttpError(400, "JSON record " + Utility::str(start.size() - 1)
+                        + " is not a flat array of numbers");
+      if (depth == 1) start.push_back(v.size());
+      ++depth; ++p; value = true;
+    } else if (c == ']') {
+      if (depth == 0)
+        throw HttpError(400, "Unbalanced brackets in JSON array");
+      --depth; ++p; value = false;
+      done = depth == 0;
+    } else if (c == ',') {
+      if (depth == 0 || value)
+        throw HttpError(400, "Misplaced comma in JSON array");
+      ++p; value = true;
+    } else if (depth == 0) {
+      throw HttpError(400, "Payload is not a JSON array");
+    } else {
+      if (!value)
+        throw HttpError(400, "Missing comma in JSON array");
+      if (depth == 1)
+        throw HttpError(400, "JSON record " + Utility::str(start.size())
+                        + " is not an array");
+      if (end - p >= 4 && std::strncmp(p, "null", 4) == 0) {
+        v.push_back(Math::NaN());
+        p += 4;
+      } else {
+        const char* q = p;
+        while (q < end && (std::isdigit(*q) || *q == '-' || *q == '+' ||
+                           *q == '.' || *q == 'e' || *q == 'E'))
+          ++q;
+        try {
+          if (q == p) throw GeographicErr("empty");
+          v.push_back(Utility::num<real>(p, size_t(q - p)));
+        }
+        catch (const GeographicErr&) {
+          throw HttpError(400, "Bad value in JSON array");
+        }
+        p = q;
+      }
+      value = false;
+    }
+  }
+  if (!done)
+    throw HttpError(400, "Incomplete JSON array");
+  start.push_back(v.size());
+}
+
+// Convert a body of little-endian doubles into v.
+void ParseBinary(const std::string& s, std::vector<real>& v) {
+  size_t n = s.size() / sizeof(double);
+  if (n * sizeof(double) != s.size())
+    throw HttpError(400, "Binary payload ends with a partial double");
+  v.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    double d;
+    std::memcpy(&d, s.data() + i * sizeof(double), sizeof(double));
+    v[i] = real(Math::bigendian ? Math::swab(d) : d);
+  }
+}
+
+void WriteNumber(std::ostream& str, real x) {
+  if (Math::isfinite(x))
+    str << x;
+  else
+    str << "null";
+}
+
+// Format n records of nf fields (in rows) as JSON or binary.
+void Format(const std::vector<real>& out, size_t nf, bool binary, int prec,
+            std::string& body) {
+  size_t n = nf ? out.size() / nf : 0;
+  if (binary) {
+    body.resize(out.size() * sizeof(double));
+    for (size_t i = 0; i < out.size(); ++i) {
+      double d = double(out[i]);
+      if (Math::bigendian) d = Math::swab(d);
+      std::memcpy(&body[i * sizeof(double)], &d, sizeof(double));
+    }
+    return;
+  }
+  std::ostringstream str;
+  str.precision(prec);
+  str << "[";
+  for (size_t i = 0; i < n; ++i) {
+    str << (i ? ",[" : "[");
+    for (size_t j = 0; j < nf; ++j) {
+      if (j) str << ",";
+      WriteNumber(str, out[i * nf + j]);
+    }
+    str << "]";
+  }
+  str << "]\n";
+  body = str.str();
+}
+
+// Format the MGRS strings, held at intervals of stride in buf, as JSON.
+void MgrsJSON(const std::vector<char>& buf, size_t stride, size_t n,
+              std::string& body) {
+  body = "[";
+  for (size_t i = 0; i < n; ++i) {
+    if (i) body += ",";
+    const char* m = &buf[i * stride];
+    if (*m) {
+      body += "\""; body += m; body += "\"";
+    } else
+      body += "null";
+  }
+  body += "]\n";
+}
+
+// Is lat a latitude in [-90, 90] and is x an angle in [-540, 540)?  These
+// are the ranges accepted by DMS::DecodeLatLon and DMS::DecodeAzimuth in
+// GeodSolve, RhumbSolve, and GeoConvert.  NaNs are rejected.
+bool LatOK(real lat) { return std::abs(lat) <= 90; }
+bool AngleOK(real x) { return x >= -540 && x < 540; }
+
+// A bool array (std::vector<bool> can't be passed as a bool*).
+struct BoolArray {
+  bool* p;
+  explicit BoolArray(size_t n) : p(new bool[n]) {}
+  ~BoolArray() { delete[] p; }
+private:
+  BoolArray(const BoolArray&);
+  BoolArray& operator=(const BoolArray&);
+};
+
+// The state shared by the workers.  This is not changed once the server has
+// started; the Geoid is constructed to be thread safe.
+struct Service {
+  Geodesic geod;
+  Rhumb rhumb;
+  const Geoid* geoid;
+  int prec;
+  Service(real a, real f, const Geoid* g, int p)
+    : geod(a, f), rhumb(a, f), geoid(g), prec(p) {}
+};
+
+const char* const operations_ =
+  "GeographicServer operations (POST a JSON array or, with Content-Type\n"
+  "application/octet-stream, little-endian doubles):\n"
+  "  /geodesic/inverse  lat1 lon1 lat2 lon2 -> azi1 azi2 s12\n"
+  "  /geodesic/direct   lat1 lon1 azi1 s12 -> lat2 lon2 azi2\n"
+  "  /rhumb/inverse     lat1 lon1 lat2 lon2 -> azi12 s12\n"
+  "  /rhumb/direct      lat1 lon1 azi12 s12 -> lat2 lon2\n"
+  "  /utm               lat lon -> zone northp easting northing\n"
+  "  /mgrs              lat lon -> MGRS string (JSON only)\n"
+  "  /geoid             lat lon -> height\n"
+  "  /area              polygons of lat lon -> number perimeter area\n";
+
+// Compute the result of a request.
+void Compute(const Service& svc, const Request& req, Response& resp) {
+  if (req.path == "/" && (req.method == "GET" || req.method == "HEAD")) {
+    resp.type = "text/plain";
+    resp.body = operations_;
+    return;
+  }
+  bool
+    geodinv = req.path == "/geodesic/inverse",
+    geoddir = req.path == "/geodesic/direct",
+    rhumbinv = req.path == "/rhumb/inverse",
+    rhumbdir = req.path == "/rhumb/direct",
+    utm = req.path == "/utm", mgrs = req.path == "/mgrs",
+    geoid = req.path == "/geoid", area = req.path == "/area";
+  if (!(geodinv || geoddir || rhumbinv || rhumbdir ||
+        utm || mgrs || geoid || area))
+    throw HttpError(404, "Unknown operation " + req.path);
+  if (req.method != "POST")
+    throw HttpError(405, "Use POST for " + req.path);
+  if (geoid && !svc.geoid)
+    throw HttpError(404, "No geoid loaded (use the -n option)");
+  bool binary = req.type == "application/octet-stream";
+  if (mgrs && binary)
+    throw HttpError(400, "Binary output is not available for /mgrs");
+
+  std::vector<real> in;
+  std::vector<size_t> start;
+  if (binary)
+    ParseBinary(req.body, in);
+  else
+    ParseJSON(req.body, in, start);
+
+  int prec = svc.prec;
+  std::string p = QueryValue(req.query, "prec");
+  if (!p.empty()) {
+    try { prec = Utility::num<int>(p); }
+    catch (const std::exception&) {
+      throw HttpError(400, "Bad precision " + p);
+    }
+  }
+  if (!binary) resp.type = "application/json";
+  else resp.type = "application/octet-stream";
+
+  if (area) {
+    // Polygons: in JSON, the elements of the outer array; in binary, pairs
+    // of doubles separated by a pair of NaNs.
+    std::vector<real> lat, lon;
+    std::vector<size_t> offsets(1, 0);
+    if (binary) {
+      if (in.size() % 2)
+        throw HttpError(400, "Binary payload has a partial vertex");
+      for (size_t i = 0; i < in.size(); i += 2) {
+        if (Math::isnan(in[i]) && Math::isnan(in[i + 1]))
+          offsets.push_back(lat.size());
+        else {
+          lat.push_back(in[i]); lon.push_back(in[i + 1]);
+        }
+      }
+      if (offsets.back() != lat.size())
+        offsets.push_back(lat.size());
+    } else {
+      for (size_t k = 0; k + 1 < start.size(); ++k) {
+        if ((start[k + 1] - start[k]) % 2)
+          throw HttpError(400, "Polygon " + Utility::str(k) +
+                          " has a partial vertex");
+        for (size_t i = start[k]; i < start[k + 1]; i += 2) {
+          lat.push_back(in[i]); lon.push_back(in[i + 1]);
+        }
+        offsets.push_back(lat.size());
+      }
+    }
+    size_t npoly = offsets.size() - 1;
+    // A polygon with a vertex out of range gives a record of NaNs
+    std::vector<char> bad(npoly, 0);
+    for (size_t k = 0; k < npoly; ++k)
+      for (size_t i = offsets[k]; i < offsets[k + 1]; ++i)
+        if (!(LatOK(lat[i]) && AngleOK(lon[i]))) {
+          bad[k] = 1; lat[i] = lon[i] = 0;
+        }
+    std::vector<real> perimeter(npoly), areas(npoly), out(3 * npoly);
+    if (npoly)
+      PolygonArea(svc.geod).ComputeMany(&offsets[0], &lat[0], &lon[0],
+                                        npoly, false, true,
+                                        &perimeter[0], &areas[0]);
+    for (size_t k = 0; k < npoly; ++k) {
+      out[3 * k] = bad[k] ? Math::NaN() : real(offsets[k + 1] - offsets[k]);
+      out[3 * k + 1] = bad[k] ? Math::NaN() : perimeter[k];
+      out[3 * k + 2] = bad[k] ? Math::NaN() : areas[k];
+    }
+    Format(out, 3, binary, prec, resp.body);
+    return;
+  }
+
+  const size_t nin = geodinv || geoddir || rhumbinv || rhumbdir ? 4 : 2;
+  for (size_t k = 0; k + 1 < start.size(); ++k)
+    if (start[k + 1] - start[k] != nin)
+      throw HttpError(400, "Record " + Utility::str(k) + " does not have " +
+                      Utility::str(nin) + " values");
+  if (in.size() % nin)
+    throw HttpError(400, "Payload is not a whole number of records of " +
+                    Utility::str(nin) + " values");
+  const size_t n = in.size() / nin;
+  if (n == 0) {
+    resp.body = binary ? "" : "[]\n";
+    return;
+  }
+  // Transpose into structure of arrays
+  std::vector<real> x(in.size());
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < nin; ++j)
+      x[j * n + i] = in[i * nin + j];
+  // A record with a value out of range gives a record of NaNs (or, for
+  // /mgrs, "INVALID"); its values are replaced by zeros for the calculation.
+  std::vector<char> bad(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    bool ok = LatOK(x[i]) && AngleOK(x[n + i]);
+    if (nin > 2)
+      ok = ok && (geodinv || rhumbinv ?
+                  LatOK(x[2 * n + i]) && AngleOK(x[3 * n + i]) :
+                  AngleOK(x[2 * n + i]) && Math::isfinite(x[3 * n + i]));
+    if (!ok) {
+      bad[i] = 1;
+      for (size_t j = 0; j < nin; ++j) x[j * n + i] = 0;
+    }
+  }
+  const real* c[4] = {&x[0], &x[0] + n, &x[0] + (nin > 2 ? 2 * n : 0),
+                      &x[0] + (nin > 2 ? 3 * n : 0)};
+  std::vector<real> out;
+  size_t nout = 0;
+  if (geodinv || geoddir || rhumbinv || rhumbdir) {
+    // An ellipsoid other than the default may be given in the query
+    std::string
+      as = QueryValue(req.query, "a"),
+      fs = QueryValue(req.query, "f");
+    real a = svc.geod.MajorRadius(), f = svc.geod.Flattening();
+    if (!as.empty() || !fs.empty()) {
+      try {
+        if (!as.empty()) a = Utility::num<real>(as);
+        if (!fs.empty()) f = Utility::fract<real>(fs);
+      }
+      catch (const std::exception& e) {
+        throw HttpError(400, std::string("Bad ellipsoid: ") + e.what());
+      }
+    }
+    bool custom = !(a == svc.geod.MajorRadius() &&
+                    f == svc.geod.Flattening());
+    nout = geodinv || geoddir ? 3 : 2;
+    std::vector<real> y(nout * n);
+    real* r[3] = {&y[0], &y[0] + n, &y[0] + 2 * n};
+    try {
+      if (geodinv || geoddir) {
+        Geodesic g(custom ? Geodesic(a, f) : svc.geod);
+        if (geodinv)
+          // Output azi1 azi2 s12 as GeodSolve -i does
+          g.InverseBatch(c[0], c[1], c[2], c[3], n, r[2], r[0], r[1]);
+        else
+          g.DirectBatch(c[0], c[1], c[2], c[3], n, r[0], r[1], r[2]);
+      } else {
+        Rhumb rh(custom ? Rhumb(a, f) : svc.rhumb);
+        std::vector<real> S12(n);
+        if (rhumbinv)
+          rh.InverseBatch(c[0], c[1], c[2], c[3], n, r[1], r[0], &S12[0]);
+        else
+          rh.DirectBatch(c[0], c[1], c[2], c[3], n, r[0], r[1], &S12[0]);
+      }
+    }
+    catch (const GeographicErr& e) {
+      throw HttpError(400, e.what());
+    }
+    out.resize(nout * n);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nout; ++j)
+        out[i * nout + j] = y[j * n + i];
+  } else if (geoid) {
+    nout = 1;
+    out.resize(n);
+    svc.geoid->HeightBatch(c[0], c[1], &out[0], n);
+  } else {
+    std::vector<int> zone(n);
+    BoolArray northp(n);
+    std::vector<real> e(n), nn(n);
+    UTMUPS::ForwardBatch(c[0], c[1], n, &zone[0], northp.p, &e[0], &nn[0],
+                         0, 0, 0, UTMUPS::STANDARD, mgrs);
+    for (size_t i = 0; i < n; ++i)
+      if (bad[i])
+        zone[i] = UTMUPS::INVALID;
+      else if (zone[i] == UTMUPS::INVALID)
+        bad[i] = 1;
+    if (utm) {
+      nout = 4;
+      out.resize(4 * n);
+      for (size_t i = 0; i < n; ++i) {
+        out[4 * i] = real(zone[i]);
+        out[4 * i + 1] = northp.p[i] ? 1 : 0;
+        out[4 * i + 2] = e[i];
+        out[4 * i + 3] = nn[i];
+      }
+    } else {
+      // The default precision for MGRS is 1 m
+      int mprec = p.empty() ? 5 : prec;
+      if (!(mprec >= -1 && mprec <= 11))
+        throw HttpError(400, "MGRS precision not in [-1, 11]");
+      const size_t stride = 28;
+      std::vector<char> buf(stride * n);
+      MGRS::ForwardBatch(&zone[0], northp.p, &e[0], &nn[0], c[0], n,
+                         mprec, &buf[0], stride);
+      MgrsJSON(buf, stride, n, resp.body);
+      return;
+    }
+  }
+  for (size_t i = 0; i < n; ++i)
+    if (bad[i])
+      for (size_t j = 0; j < nout; ++j)
+        out[i * nout + j] = Math::NaN();
+  Format(out, nout, binary, prec, resp.body);
+}
+
+// Serve the requests on a connection until it's closed or is idle for idle
+// seconds.
+void Serve(const Service& svc, Channel& ch, size_t maxbody, int idle) {
+  HttpConnection conn(ch, maxbody, idle);
+  Request req;
+  for (;;) {
+    Response resp;
+    bool keepalive = true;
+    try {
+      if (!conn.Next(req)) break;
+      keepalive = req.keepalive;
+      Compute(svc, req, resp);
+      if (req.method == "HEAD") resp.body.clear();
+    }
+    catch (const HttpError& e) {
+      resp.status = e.status;
+      resp.type = "text/plain";
+      resp.body = e.message + "\n";
+      if (e.close) keepalive = false;
+    }
+    catch (const std::bad_alloc&) {
+      resp.status = 500;
+      resp.type = "text/plain";
+      resp.body = "Out of memory\n";
+      keepalive = false;
+    }
+    try {
+      conn.Send(resp, keepalive);
+    }
+    catch (const GeographicErr&) {
+      break;
+    }
+    if (!keepalive) break;
+  }
+}
+
+// A worker accepts connections on the listening socket and serves them one
+// at a time.  Idle kept-alive connections are closed after idle seconds, so
+// that a worker is soon free to accept another connection.
+class Worker {
+private:
+  const Service& _svc;
+  int _listen, _timeout, _idle;
+  size_t _maxbody;
+  Worker& operator=(const Worker&);
+public:
+  Worker(const Service& svc, int listen, int timeout, int idle,
+         size_t maxbody)
+    : _svc(svc), _listen(listen), _timeout(timeout), _idle(idle)
+    , _maxbody(maxbody) {}
+  void operator()() const {
+    for (;;) {
+      int fd = accept(_listen, 0, 0);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE ||
+            errno == ENFILE)
+          continue;
+        break;
+      }
+      struct timeval tv;
+      tv.tv_sec = _timeout; tv.tv_usec = 0;
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      FdChannel ch(fd, fd);
+      Serve(_svc, ch, _maxbody, _idle);
+      close(fd);
+    }
+  }
+};
+
+int main(int argc, char* argv[]) {
+  try {
+    Utility::set_digits();
+    real
+      a = Constants::WGS84_a(),
+      f = Constants::WGS84_f();
+    int port = 8080, nworkers = 8, timeout = 30, idle = 5, prec = 17;
+    double maxsize = 64;
+    bool inetd = false, cubic = true;
+    std::string address = "127.0.0.1", istring, geoid, dir;
+    char lsep = ';';
+
+    for (int m = 1; m < argc; ++m) {
+      std::string arg(argv[m]);
+      if (arg == "-e") {
+        if (m + 2 >= argc) return usage(1, true);
+        try {
+          a = Utility::num<real>(std::string(argv[m + 1]));
+          f = Utility::fract<real>(std::string(argv[m + 2]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding arguments of -e: " << e.what() << "\n";
+          return 1;
+        }
+        m += 2;
+      } else if (arg == "-n") {
+        if (++m == argc) return usage(1, true);
+        geoid = argv[m];
+      } else if (arg == "-d") {
+        if (++m == argc) return usage(1, true);
+        dir = argv[m];
+      } else if (arg == "-l")
+        cubic = false;
+      else if (arg == "-p") {
+        if (++m == argc) return usage(1, true);
+        try {
+          prec = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Precision " << argv[m] << " is not a number\n";
+          return 1;
+        }
+        if (!(prec >= 1 && prec <= 21)) {
+          std::cerr << "Precision " << prec << " not in [1, 21]\n";
+          return 1;
+        }
+      } else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nworkers = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Number of workers " << argv[m]
+                    << " is not a number\n";
+          return 1;
+        }
+        if (!(nworkers > 0)) {
+          std::cerr << "Number of workers must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--address") {
+        if (++m == argc) return usage(1, true);
+        address = argv[m];
+      } else if (arg == "--port") {
+        if (++m == argc) return usage(1, true);
+        try {
+          port = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Port " << argv[m] << " is not a number\n";
+          return 1;
+        }
+        if (!(port >= 0 && port <= 65535)) {
+          std::cerr << "Port " << port << " not in [0, 65535]\n";
+          return 1;
+        }
+      } else if (arg == "--timeout") {
+        if (++m == argc) return usage(1, true);
+        try {
+          timeout = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Timeout " << argv[m] << " is not a number\n";
+          return 1;
+        }
+        if (!(timeout > 0)) {
+          std::cerr << "Timeout must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--keep-alive") {
+        if (++m == argc) return usage(1, true);
+        try {
+          idle = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Keep-alive time " << argv[m] << " is not a number\n";
+          return 1;
+        }
+        if (!(idle >= 0)) {
+          std::cerr << "Keep-alive time must be non-negative\n";
+          return 1;
+        }
+      } else if (arg == "--max-size") {
+        if (++m == argc) return usage(1, true);
+        try {
+          maxsize = Utility::num<double>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Size " << argv[m] << " is not a number\n";
+          return 1;
+        }
+        if (!(maxsize > 0 && maxsize <= 4096)) {
+          std::cerr << "Size " << maxsize << " MB not in (0, 4096]\n";
+          return 1;
+        }
+      } else if (arg == "--inetd")
+        inetd = true;
+      else if (arg == "--input-string") {
+        if (++m == argc) return usage(1, true);
+        istring = argv[m];
+      } else if (arg == "--line-separator") {
+        if (++m == argc) return usage(1, true);
+        if (std::string(argv[m]).size() != 1) {
+          std::cerr << "Line separator must be a single character\n";
+          return 1;
+        }
+        lsep = argv[m][0];
+      } else if (arg == "--version") {
+        std::cout << argv[0] << ": GeographicLib version "
+                  << GEOGRAPHICLIB_VERSION_STRING << "\n";
+        return 0;
+      } else
+        return usage(!(arg == "-h" || arg == "--help"), arg != "--help");
+    }
+
+    if (inetd && !istring.empty()) {
+      std::cerr << "Cannot specify --inetd and --input-string together\n";
+      return 1;
+    }
+    const size_t maxbody = size_t(maxsize * 1024 * 1024);
+
+    // Load the geoid into memory once so that it can be shared by the
+    // workers.
+    Geoid* g = 0;
+    if (!geoid.empty()) {
+      try {
+        g = new Geoid(geoid, dir, cubic, true);
+      }
+      catch (const std::exception& e) {
+        std::cerr << "Error loading geoid: " << e.what() << "\n";
+        return 1;
+      }
+    }
+    const Service svc(a, f, g, prec);
+
+    if (!istring.empty()) {
+      std::string::size_type m = 0;
+      while (true) {
+        m = istring.find(lsep, m);
+        if (m == std::string::npos)
+          break;
+        istring[m] = '\n';
+      }
+      StringChannel ch(istring, std::cout);
+      Serve(svc, ch, maxbody, idle);
+      delete g;
+      return 0;
+    }
+    // A client closing its connection early would otherwise kill the server
+    signal(SIGPIPE, SIG_IGN);
+    if (inetd) {
+      FdChannel ch(0, 1);
+      Serve(svc, ch, maxbody, idle);
+      delete g;
+      return 0;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      std::cerr << "Cannot create socket: " << std::strerror(errno) << "\n";
+      return 1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<unsigned short>(port));
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+      std::cerr << "Bad IPv4 address " << address << "\n";
+      return 1;
+    }
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+             sizeof(addr)) != 0 ||
+        listen(fd, 128) != 0) {
+      std::cerr << "Cannot listen on " << address << ":" << port << ": "
+                << std::strerror(errno) << "\n";
+      return 1;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+    std::cout << "Listening on " << address << ":" << ntohs(addr.sin_port)
+              << std::endl;
+
+    Worker worker(svc, fd, timeout, idle, maxbody);
+#if GEOGRAPHICSERVER_THREADS
+    std::vector<std::thread> threads;
+    for (int k = 1; k < nworkers; ++k)
+      threads.push_back(std::thread(worker));
+    worker();
+    for (size_t k = 0; k < threads.size(); ++k)
+      threads[k].join();
+#else
+    // Without threads, the connections are served one at a time
+    (void)nworkers;
+    worker();
+#endif
+    close(fd);
+    delete g;
+    return 0;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Caught unknown exception\n";
+    return 1;
+  }
+}
@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/Geoid.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -24,8 +26,298 @@
 #  pragma warning (disable: 4127 4701)
 #endif
 
+#if !defined(GEOIDEVAL_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define GEOIDEVAL_THREADS 1
+#  else
+#    define GEOIDEVAL_THREADS 0
+#  endif
+#endif
+
+#if GEOIDEVAL_THREADS
+#  include <thread>
+#endif
+
+#if !defined(GEOIDEVAL_SERVER)
+#  if GEOIDEVAL_THREADS && !defined(_WIN32)
+#    define GEOIDEVAL_SERVER 1
+#  else
+#    define GEOIDEVAL_SERVER 0
+#  endif
+#endif
+
+#if GEOIDEVAL_SERVER
+#  include <cerrno>
+#  include <csignal>
+#  include <cstring>
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
 #include "GeoidEval.usage"
 
+// Evaluate records [i0, i1) of a chunk of binary input, in, putting the
+// results in out.  Each input record is (lat, lon) or, if heightmult is
+// nonzero, (lat, lon, height); each output record is the geoid height (or
+// the converted height) optionally followed by the two gradients.  Errors
+// are returned in err.
+void EvalChunk(const GeographicLib::Geoid* g, const double* in, double* out,
+               size_t i0, size_t i1,
+               GeographicLib::Geoid::convertflag heightmult, bool gradp,
+               std::string* err) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  try {
+    size_t n = i1 - i0, nin = heightmult ? 3 : 2, nout = gradp ? 3 : 1;
+    std::vector<real> lat(n), lon(n), h(n);
+    for (size_t i = 0; i < n; ++i) {
+      lat[i] = real(in[nin * (i0 + i)    ]);
+      lon[i] = real(in[nin * (i0 + i) + 1]);
+      if (heightmult) h[i] = real(in[nin * (i0 + i) + 2]);
+    }
+    if (gradp) {
+      // Gradients are computed a point at a time with the internal cache of
+      // g; so this is only called from a single thread.
+      for (size_t i = 0; i < n; ++i) {
+        real gradn, grade;
+        out[nout * (i0 + i)    ] = double((*g)(lat[i], lon[i], gradn, grade));
+        out[nout * (i0 + i) + 1] = double(gradn);
+        out[nout * (i0 + i) + 2] = double(grade);
+      }
+    } else {
+      if (heightmult)
+        g->ConvertHeightBatch(&lat[0], &lon[0], &h[0], n, heightmult, &h[0]);
+      else
+        g->HeightBatch(&lat[0], &lon[0], &h[0], n);
+      for (size_t i = 0; i < n; ++i)
+        out[i0 + i] = double(h[i]);
+    }
+  }
+  catch (const std::exception& e) {
+    *err = e.what();
+  }
+}
+
+// The settings which control the processing of each line of input
+struct Settings {
+  GeographicLib::Geoid::convertflag heightmult;
+  bool gradp, northp;
+  int zonenum;
+  std::string cdelim;
+  const GeographicLib::Geoid* g;
+};
+
+// Process a line of input, s, using p to hold the position and writing the
+// result (or an error message) to out.  The heights are evaluated with cell
+// (if it's not null) instead of the internal cell cache of the Geoid.
+// Return 1 if there's an error and 0 otherwise.
+int ProcessLine(const Settings& c, GeographicLib::Geoid::Cell* cell,
+                GeographicLib::GeoCoords& p, std::string s, std::ostream& out) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  const Geoid& g = *c.g;
+  const Geoid::convertflag heightmult = c.heightmult;
+  const char* spaces = " \t\n\v\f\r,"; // Include comma as space
+  std::string suff;
+  int retval = 0;
+  try {
+    std::string eol("\n");
+    if (!c.cdelim.empty()) {
+      std::string::size_type m = s.find(c.cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        std::string::size_type m1 =
+          m > 0 ? s.find_last_not_of(spaces, m - 1) : std::string::npos;
+        s = s.substr(0, m1 != std::string::npos ? m1 + 1 : m);
+      }
+    }
+    real height = 0;
+    if (c.zonenum != UTMUPS::INVALID) {
+      // Expect "easting northing" if heightmult == 0, or
+      // "easting northing height" if heightmult != 0.
+      std::string::size_type pa = 0, pb = 0;
+      real easting = 0, northing = 0;
+      for (int i = 0; i < (heightmult ? 3 : 2); ++i) {
+        if (pb == std::string::npos)
+          throw GeographicErr("Incomplete input: " + s);
+        // Start of i'th token
+        pa = s.find_first_not_of(spaces, pb);
+        if (pa == std::string::npos)
+          throw GeographicErr("Incomplete input: " + s);
+        // End of i'th token
+        pb = s.find_first_of(spaces, pa);
+        (i == 2 ? height : (i == 0 ? easting : northing)) =
+          Utility::num<real>(s.substr(pa, (pb == std::string::npos ?
+                                           pb : pb - pa)));
+      }
+      p.Reset(c.zonenum, c.northp, easting, northing);
+      if (heightmult) {
+        suff = pb == std::string::npos ? "" : s.substr(pb);
+        s = s.substr(0, pa);
+      }
+    } else {
+      if (heightmult) {
+        // Treat last token as height
+        // pb = last char of last token
+        // pa = last char preceding white space
+        // px = last char of 2nd last token
+        std::string::size_type pb = s.find_last_not_of(spaces);
+        std::string::size_type pa = s.find_last_of(spaces, pb);
+        if (pa == std::string::npos || pb == std::string::npos)
+          throw GeographicErr("Incomplete input: " + s);
+        height = Utility::num<real>(s.substr(pa + 1, pb - pa));
+        s = s.substr(0, pa + 1);
+      }
+      p.Reset(s);
+    }
+    if (heightmult) {
+      real h = cell ? g(p.Latitude(), p.Longitude(), *cell) :
+        g(p.Latitude(), p.Longitude());
+      out << s
+          << Utility::str(height + real(heightmult) * h, 4)
+          << suff << eol;
+    } else {
+      if (c.gradp) {
+        real gradn, grade;
+        real h = g(p.Latitude(), p.Longitude(), gradn, grade);
+        out << Utility::str(h, 4) << " "
+            << Utility::str(gradn * 1e6, 2)
+            << (Math::isnan(gradn) ? " " : "e-6 ")
+            << Utility::str(grade * 1e6, 2)
+            << (Math::isnan(grade) ? "" : "e-6")
+            << eol;
+      } else {
+        real h = cell ? g(p.Latitude(), p.Longitude(), *cell) :
+          g(p.Latitude(), p.Longitude());
+        out << Utility::str(h, 4) << eol;
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    out << "ERROR: " << e.what() << "\n";
+    retval = 1;
+  }
+  return retval;
+}
+
+#if GEOIDEVAL_SERVER
+// Create a Unix domain socket listening at path, replacing a stale socket of
+// the same name.  Return the file descriptor, or -1 (with errno set) on
+// failure.
+int ServerListen(const std::string& path) {
+  sockaddr_un addr;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    unlink(path.c_str());
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(fd, SOMAXCONN) < 0) {
+    int e = errno;
+    close(fd);
+    errno = e;
+    return -1;
+  }
+  return fd;
+}
+
+// Send all of s to the socket fd.  Return false if the client has gone away.
+bool SendAll(int fd, const std::string& s) {
+  const char* p = s.data();
+  size_t n = s.size();
+  while (n > 0) {
+    ssize_t k = send(fd, p, n, 0);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += k; n -= size_t(k);
+  }
+  return true;
+}
+
+// Accept connections on the listening socket fd and answer each line
+// received with the output of ProcessLine.  The results for the complete
+// lines in each read from the socket are sent together.  This is run by
+// each of the worker threads with --server.
+void ServeConnections(const Settings* c, int fd) {
+  GeographicLib::Geoid::Cell cell;
+  GeographicLib::GeoCoords p;
+  std::vector<char> buf(65536);
+  std::string pending;
+  while (true) {
+    int cfd = accept(fd, 0, 0);
+    if (cfd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    pending.clear();
+    bool ok = true;
+    while (ok) {
+      ssize_t k = recv(cfd, &buf[0], buf.size(), 0);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) break;
+      pending.append(&buf[0], size_t(k));
+      std::ostringstream out;
+      std::string::size_type b = 0, nl;
+      while ((nl = pending.find('\n', b)) != std::string::npos) {
+        ProcessLine(*c, &cell, p, pending.substr(b, nl - b), out);
+        b = nl + 1;
+      }
+      pending.erase(0, b);
+      ok = SendAll(cfd, out.str());
+    }
+    if (ok && !pending.empty()) {
+      // A final line without a newline
+      std::ostringstream out;
+      ProcessLine(*c, &cell, p, pending, out);
+      SendAll(cfd, out.str());
+    }
+    close(cfd);
+  }
+}
+
+// Serve requests on the Unix domain socket path with nthreads worker
+// threads.  This only returns if there's an error.
+int RunServer(const Settings& c, const std::string& path, int nthreads) {
+  int fd = ServerListen(path);
+  if (fd < 0) {
+    std::cerr << "Cannot listen on " << path << ": "
+              << std::strerror(errno) << "\n";
+    return 1;
+  }
+  // A client which disconnects early shouldn't kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+  std::vector<std::thread> threads;
+  for (int k = 1; k < nthreads; ++k)
+    threads.push_back(std::thread(ServeConnections, &c, fd));
+  ServeConnections(&c, fd);
+  int e = errno;
+  for (size_t k = 0; k < threads.size(); ++k)
+    threads[k].join();
+  std::cerr << "Error accepting connections on " << path << ": "
+            << std::strerror(e) << "\n";
+  close(fd);
+  return 1;
+}
+#else
+int RunServer(const Settings&, const std::string&, int) {
+  std::cerr << "--server is not supported on this system\n";
+  return 1;
+}
+#endif
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
@@ -37,10 +329,10 @@ int main(int argc, char* argv[]) {
     std::string dir;
     std::string geoid = Geoid::DefaultGeoidName();
     Geoid::convertflag heightmult = Geoid::NONE;
-    std::string istring, ifile, ofile, cdelim;
+    std::string istring, ifile, ofile, cdelim, bfile, bofile, server;
     char lsep = ';';
     bool northp = false;
-    int zonenum = UTMUPS::INVALID;
+    int zonenum = UTMUPS::INVALID, nthreads = 1;
 
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
@@ -93,15 +385,38 @@ int main(int argc, char* argv[]) {
         gradp = true;
       else if (arg == "-v")
         verbose = true;
-      else if (arg == "--input-string") {
+      else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      }
+      else if (arg == "--server") {
+        if (++m == argc) return usage(1, true);
+        server = argv[m];
+      } else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
         if (++m == argc) return usage(1, true);
         ifile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -130,6 +445,29 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (!bfile.empty() && zonenum != UTMUPS::INVALID) {
+      std::cerr << "Cannot specify --binary-file with -z\n";
+      return 1;
+    }
+    if (!bofile.empty() && bfile.empty()) {
+      std::cerr << "--binary-output requires --binary-file\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
+    if (!server.empty() &&
+        !(ifile.empty() && istring.empty() && ofile.empty() && bfile.empty())) {
+      std::cerr << "Cannot specify --server with input or output files\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -151,6 +489,22 @@ int main(int argc, char* argv[]) {
     }
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
+    std::ifstream binfile;
+    if (!bfile.empty()) {
+      binfile.open(bfile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bfile << " for reading\n";
+        return 1;
+      }
+    }
+    std::ofstream binout;
+    if (!bofile.empty()) {
+      binout.open(bofile.c_str(), std::ios::binary);
+      if (!binout.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
@@ -191,86 +545,110 @@ int main(int argc, char* argv[]) {
                    << "\n";
       }
 
-      GeoCoords p;
-      std::string s, suff;
-      const char* spaces = " \t\n\v\f\r,"; // Include comma as space
-      while (std::getline(*input, s)) {
-        try {
-          std::string eol("\n");
-          if (!cdelim.empty()) {
-            std::string::size_type m = s.find(cdelim);
-            if (m != std::string::npos) {
-              eol = " " + s.substr(m) + "\n";
-              std::string::size_type m1 =
-                m > 0 ? s.find_last_not_of(spaces, m - 1) : std::string::npos;
-              s = s.substr(0, m1 != std::string::npos ? m1 + 1 : m);
-            }
+      if (!bfile.empty()) {
+        // The input records are (lat, lon) or, with --msltohae or
+        // --haetomsl, (lat, lon, height) as little-endian doubles.
+        // These are read in chunks, and each chunk is split between the
+        // threads which share g.  The output is in the same order as the
+        // input.
+        if (!(g.Cache() || g.Compressed())) {
+          // Map the data file so that the threads don't need to serialize
+          // their reads.
+          try {
+            g.CacheMap();
           }
-          real height = 0;
-          if (zonenum != UTMUPS::INVALID) {
-            // Expect "easting northing" if heightmult == 0, or
-            // "easting northing height" if heightmult != 0.
-            std::string::size_type pa = 0, pb = 0;
-            real easting = 0, northing = 0;
-            for (int i = 0; i < (heightmult ? 3 : 2); ++i) {
-              if (pb == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              // Start of i'th token
-              pa = s.find_first_not_of(spaces, pb);
-              if (pa == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              // End of i'th token
-              pb = s.find_first_of(spaces, pa);
-              (i == 2 ? height : (i == 0 ? easting : northing)) =
-                Utility::num<real>(s.substr(pa, (pb == std::string::npos ?
-                                                 pb : pb - pa)));
-            }
-            p.Reset(zonenum, northp, easting, northing);
-            if (heightmult) {
-              suff = pb == std::string::npos ? "" : s.substr(pb);
-              s = s.substr(0, pa);
-            }
-          } else {
-            if (heightmult) {
-              // Treat last token as height
-              // pb = last char of last token
-              // pa = last char preceding white space
-              // px = last char of 2nd last token
-              std::string::size_type pb = s.find_last_not_of(spaces);
-              std::string::size_type pa = s.find_last_of(spaces, pb);
-              if (pa == std::string::npos || pb == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              height = Utility::num<real>(s.substr(pa + 1, pb - pa));
-              s = s.substr(0, pa + 1);
+          catch (const std::exception&) {
+          }
+        }
+        if (gradp || !g.Concurrent())
+          nthreads = 1;
+#if !GEOIDEVAL_THREADS
+        nthreads = 1;
+#endif
+        const size_t chunk = 65536 * size_t(nthreads),
+          nin = heightmult ? 3 : 2, nout = gradp ? 3 : 1;
+        std::vector<double> buf(nin * chunk), res(nout * chunk);
+        std::vector<std::string> err(nthreads);
+        while (binfile) {
+          binfile.read(reinterpret_cast<char*>(&buf[0]),
+                       std::streamsize(buf.size() * sizeof(double)));
+          size_t nbytes = size_t(binfile.gcount()),
+            n = nbytes / (nin * sizeof(double));
+          if (n * nin * sizeof(double) != nbytes) {
+            std::cerr << "File " << bfile << " ends with a partial record\n";
+            return 1;
+          }
+          if (n == 0) break;
+          if (Math::bigendian)
+            for (size_t i = 0; i < nin * n; ++i) buf[i] = Math::swab(buf[i]);
+#if GEOIDEVAL_THREADS
+          if (nthreads > 1) {
+            std::vector<std::thread> threads;
+            for (int k = 0; k < nthreads; ++k)
+              threads.push_back(std::thread(EvalChunk, &g, &buf[0], &res[0],
+                                            n * k / nthreads,
+                                            n * (k + 1) / nthreads,
+                                            heightmult, gradp, &err[k]));
+            for (int k = 0; k < nthreads; ++k)
+              threads[k].join();
+          } else
+#endif
+            EvalChunk(&g, &buf[0], &res[0], 0, n, heightmult, gradp, &err[0]);
+          for (int k = 0; k < nthreads; ++k) {
+            if (!err[k].empty()) {
+              std::cerr << "ERROR: " << err[k] << "\n";
+              return 1;
             }
-            p.Reset(s);
           }
-          if (heightmult) {
-            real h = g(p.Latitude(), p.Longitude());
-            *output << s
-                    << Utility::str(height + real(heightmult) * h, 4)
-                    << suff << eol;
+          if (!bofile.empty()) {
+            if (Math::bigendian)
+              for (size_t i = 0; i < nout * n; ++i) res[i] = Math::swab(res[i]);
+            binout.write(reinterpret_cast<const char*>(&res[0]),
+                         std::streamsize(nout * n * sizeof(double)));
           } else {
-            if (gradp) {
-            real gradn, grade;
-            real h = g(p.Latitude(), p.Longitude(), gradn, grade);
-            *output << Utility::str(h, 4) << " "
-                    << Utility::str(gradn * 1e6, 2)
-                    << (Math::isnan(gradn) ? " " : "e-6 ")
-                    << Utility::str(grade * 1e6, 2)
-                    << (Math::isnan(grade) ? "" : "e-6")
-                    << eol;
-            } else {
-            real h = g(p.Latitude(), p.Longitude());
-            *output << Utility::str(h, 4) << eol;
+            for (size_t i = 0; i < n; ++i) {
+              *output << Utility::str(real(res[nout * i]), 4);
+              if (gradp) {
+                real gradn = real(res[nout * i + 1]),
+                  grade = real(res[nout * i + 2]);
+                *output << " " << Utility::str(gradn * 1e6, 2)
+                        << (Math::isnan(gradn) ? " " : "e-6 ")
+                        << Utility::str(grade * 1e6, 2)
+                        << (Math::isnan(grade) ? "" : "e-6");
+              }
+              *output << "\n";
             }
           }
         }
-        catch (const std::exception& e) {
-          *output << "ERROR: " << e.what() << "\n";
-          retval = 1;
+        if (!bofile.empty()) {
+          binout.close();
+          if (!binout) {
+            std::cerr << "Error writing " << bofile << "\n";
+            return 1;
+          }
         }
       }
+
+      Settings c;
+      c.heightmult = heightmult; c.gradp = gradp; c.zonenum = zonenum;
+      c.northp = northp; c.cdelim = cdelim; c.g = &g;
+      if (!server.empty()) {
+        if (!(g.Cache() || g.Compressed())) {
+          try {
+            g.CacheMap();
+          }
+          catch (const std::exception&) {
+          }
+        }
+        // Gradients are computed with the internal cache of g
+        if (gradp || !g.Concurrent())
+          nthreads = 1;
+        return RunServer(c, server, nthreads);
+      }
+      GeoCoords p;
+      std::string s;
+      while (bfile.empty() && std::getline(*input, s))
+        retval = std::max(retval, ProcessLine(c, 0, p, s, *output));
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << geoid << ": " << e.what() << "\n";
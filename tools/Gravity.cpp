@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/GravityModel.hpp>
 #include <GeographicLib/GravityCircle.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -24,27 +26,57 @@
 #  pragma warning (disable: 4127 4701)
 #endif
 
+// Set GRAVITY_MPI to 1 to include the --mpi option; this needs MPI.
+#if !defined(GRAVITY_MPI)
+#  define GRAVITY_MPI 0
+#endif
+
+#if GRAVITY_MPI
+// mpi.h must be included before GravityGrid.hpp
+#  include <mpi.h>
+#endif
+
+#include <GeographicLib/GravityGrid.hpp>
+
 #include "Gravity.usage"
 
+typedef GeographicLib::Math::real real;
+
+#if GRAVITY_MPI
+// If init is true, initialize MPI in the constructor and finalize it in
+// the destructor, so that MPI is finalized however main returns.
+class MPISession {
+private:
+  bool _init;
+  MPISession(const MPISession&);
+  MPISession& operator=(const MPISession&);
+public:
+  MPISession(bool init, int* argc, char*** argv) : _init(init)
+  { if (_init) MPI_Init(argc, argv); }
+  ~MPISession() { if (_init) MPI_Finalize(); }
+};
+#endif
+
+enum {
+  GRAVITY = 0,
+  DISTURBANCE = 1,
+  ANOMALY = 2,
+  UNDULATION = 3,
+};
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
     bool verbose = false;
     std::string dir;
     std::string model = GravityModel::DefaultGravityName();
-    std::string istring, ifile, ofile, cdelim;
+    std::string istring, ifile, ofile, cdelim, bofile;
     char lsep = ';';
     real lat = 0, h = 0;
-    bool circle = false;
-    int prec = -1;
-    enum {
-      GRAVITY = 0,
-      DISTURBANCE = 1,
-      ANOMALY = 2,
-      UNDULATION = 3,
-    };
+    bool circle = false, gridp = false, mpi = false;
+    real south = 0, west = 0, north = 0, east = 0, step = 0, gridh = 0;
+    int prec = -1, nthreads = 1;
     unsigned mode = GRAVITY;
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
@@ -80,7 +112,45 @@ int main(int argc, char* argv[]) {
                     << e.what() << "\n";
           return 1;
         }
-      } else if (arg == "-p") {
+      } else if (arg == "--grid") {
+        if (m + 6 >= argc) return usage(1, true);
+        try {
+          DMS::DecodeLatLon(std::string(argv[m + 1]), std::string(argv[m + 2]),
+                            south, west);
+          DMS::DecodeLatLon(std::string(argv[m + 3]), std::string(argv[m + 4]),
+                            north, east);
+          step = DMS::DecodeAngle(std::string(argv[m + 5]));
+          gridh = Utility::num<real>(std::string(argv[m + 6]));
+          if (!(south <= north))
+            throw GeographicErr("South edge is north of north edge");
+          if (!(Math::isfinite(step) && step > 0))
+            throw GeographicErr("Grid step must be positive");
+          if (!Math::isfinite(gridh))
+            throw GeographicErr("Bad height");
+          gridp = true;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of " << arg << ": "
+                    << e.what() << "\n";
+          return 1;
+        }
+        m += 6;
+      } else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--mpi")
+        mpi = true;
+      else if (arg == "-p") {
         if (++m == argc) return usage(1, true);
         try {
           prec = Utility::num<int>(std::string(argv[m]));
@@ -100,6 +170,9 @@ int main(int argc, char* argv[]) {
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -130,6 +203,35 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (gridp && circle) {
+      std::cerr << "Cannot specify --grid and -c together\n";
+      return 1;
+    }
+    if (gridp && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --grid with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (!bofile.empty() && !gridp) {
+      std::cerr << "--binary-output requires --grid\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
+#if GRAVITY_MPI
+    if (mpi && !(gridp && !bofile.empty() && bofile != "-")) {
+      std::cerr << "--mpi requires --grid and --binary-output to a file\n";
+      return 1;
+    }
+#else
+    if (mpi) {
+      std::cerr << "Gravity was compiled without MPI; --mpi is not allowed\n";
+      return 1;
+    }
+#endif
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -162,6 +264,16 @@ int main(int argc, char* argv[]) {
       }
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    std::ofstream binfile;
+    // With --mpi, the ranks open the file with MPI-IO
+    if (!bofile.empty() && bofile != "-" && !mpi) {
+      binfile.open(bofile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
+    std::ostream* binoutput = bofile != "-" ? &binfile : &std::cout;
 
     switch (mode) {
     case GRAVITY:
@@ -176,16 +288,22 @@ int main(int argc, char* argv[]) {
       prec = std::min(12 + Math::extra_digits(), prec < 0 ? 4 : prec);
       break;
     }
-    int retval = 0;
+    int retval = 0, rank = 0;
+#if GRAVITY_MPI
+    const MPISession session(mpi, &argc, &argv);
+    if (mpi) MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
     try {
-      const GravityModel g(model, dir);
+      // With --mpi, map the coefficient file so that the ranks on a node
+      // share one copy of the coefficients.
+      const GravityModel g(model, dir, mpi);
       if (circle) {
         if (!Math::isfinite(h))
           throw GeographicErr("Bad height");
         else if (mode == UNDULATION && h != 0)
           throw GeographicErr("Height should be zero for geoid undulations");
       }
-      if (verbose) {
+      if (verbose && rank == 0) {
         std::cerr << "Gravity file: " << g.GravityFile()      << "\n"
                   << "Name: "         << g.GravityModelName() << "\n"
                   << "Description: "  << g.Description()      << "\n"
@@ -195,6 +313,71 @@ int main(int argc, char* argv[]) {
                        (mode == DISTURBANCE ? GravityModel::DISTURBANCE :
                         (mode == ANOMALY ? GravityModel::SPHERICAL_ANOMALY :
                          GravityModel::GEOID_HEIGHT))); // mode == UNDULATION
+      if (gridp) {
+        if (mode == UNDULATION && gridh != 0)
+          throw GeographicErr("Height should be zero for geoid undulations");
+        if (east < west) east += 360;
+        // Allow for roundoff in the number of steps
+        real
+          tol = 1e-9,
+          ny = std::floor((north - south) / step + tol) + 1,
+          nx = std::floor((east - west) / step + tol) + 1;
+        if (!(ny * nx <= real(std::numeric_limits<int>::max())))
+          throw GeographicErr("Grid is too large");
+        const GravityGrid grid(g, mode, north, west, step, int(ny), int(nx),
+                               gridh);
+        if (verbose && rank == 0)
+          std::cerr << "Grid: " << grid.RowCount() << " rows (from latitude "
+                    << north << " south) by " << grid.ColumnCount()
+                    << " columns (from longitude " << west << " east)\n";
+#if GRAVITY_MPI
+        if (mpi) {
+          // Each rank computes and writes its band of rows
+          grid.WriteMPI(bofile, MPI_COMM_WORLD, nthreads);
+          return retval;
+        }
+#endif
+        // Evaluate the grid in blocks of rows which are split between the
+        // threads; the output is in the order of the rows.
+        const int nf = grid.Fields(),
+          block = 8 * nthreads,
+          lprec = std::min(15, std::max(0, int(std::ceil(-std::log10(step))))
+                           + 3);
+        const size_t nblock =
+          size_t(std::min(block, grid.RowCount())) * grid.ColumnCount();
+        std::vector<real> vals(nf * nblock);
+        real* v[3];
+        for (int k = 0; k < nf; ++k) v[k] = &vals[k * nblock];
+        std::vector<char> buf;
+        for (int r0 = 0; r0 < grid.RowCount(); r0 += block) {
+          int r1 = std::min(grid.RowCount(), r0 + block);
+          grid.Rows(r0, r1, v, nthreads);
+          if (!bofile.empty()) {
+            grid.Encode(v, r1 - r0, buf);
+            binoutput->write(&buf[0], std::streamsize(buf.size()));
+          } else {
+            size_t n = size_t(r1 - r0) * grid.ColumnCount();
+            for (size_t i = 0; i < n; ++i) {
+              int
+                r = r0 + int(i / grid.ColumnCount()),
+                j = int(i % grid.ColumnCount());
+              *output << Utility::str(grid.Latitude(r), lprec) << " "
+                      << Utility::str(grid.Longitude(j), lprec);
+              for (int k = 0; k < nf; ++k)
+                *output << " " << Utility::str(v[k][i], prec);
+              *output << "\n";
+            }
+          }
+        }
+        if (!bofile.empty()) {
+          binoutput->flush();
+          if (!*binoutput) {
+            std::cerr << "Error writing " << bofile << "\n";
+            return 1;
+          }
+        }
+        return retval;
+      }
       const GravityCircle c(circle ? g.Circle(lat, h, mask) : GravityCircle());
       std::string s, stra, strb;
       while (std::getline(*input, s)) {
@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/MagneticModel.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -23,8 +25,147 @@
 #  pragma warning (disable: 4127)
 #endif
 
+#if !defined(MAGNETICFIELD_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define MAGNETICFIELD_THREADS 1
+#  else
+#    define MAGNETICFIELD_THREADS 0
+#  endif
+#endif
+
+#if MAGNETICFIELD_THREADS
+#  include <thread>
+#endif
+
 #include "MagneticField.usage"
 
+// Convert the field (bx, by, bz) and its rate of change to the 7 output
+// quantities and their rates, r[0..13], in the order printed.
+void Components(GeographicLib::Math::real bx, GeographicLib::Math::real by,
+                GeographicLib::Math::real bz, GeographicLib::Math::real bxt,
+                GeographicLib::Math::real byt, GeographicLib::Math::real bzt,
+                GeographicLib::Math::real r[]) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  real H, F, D, I, Ht, Ft, Dt, It;
+  MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
+                                 H, F, D, I, Ht, Ft, Dt, It);
+  r[0] = D;  r[1] = I;  r[2] = H;  r[3] = by;  r[4] = bx;  r[5] = -bz;
+  r[6] = F;
+  r[7] = Dt; r[8] = It; r[9] = Ht; r[10] = byt; r[11] = bxt;
+  r[12] = -bzt; r[13] = Ft;
+}
+
+// Print the output quantities r[0..6] (and, if rate, their rates
+// r[7..13]) terminating each line with eol.
+void Print(std::ostream& out, const GeographicLib::Math::real r[],
+           bool rate, int prec, const std::string& eol) {
+  using namespace GeographicLib;
+  for (int k = 0; k < (rate ? 2 : 1); ++k, r += 7)
+    out << DMS::Encode(r[0], prec + 1, DMS::NUMBER) << " "
+        << DMS::Encode(r[1], prec + 1, DMS::NUMBER) << " "
+        << Utility::str(r[2], prec) << " "
+        << Utility::str(r[3], prec) << " "
+        << Utility::str(r[4], prec) << " "
+        << Utility::str(r[5], prec) << " "
+        << Utility::str(r[6], prec) << eol;
+}
+
+// Evaluate records [i0, i1) of a chunk of binary input, in, putting the
+// results in out.  Each input record is (time, lat, lon, h) or, if timeset,
+// (lat, lon, h) or, if c is non-null, (lon); each output record is the 7
+// output quantities optionally followed by their rates.  Records which are
+// invalid or too far outside the range of the model give NaNs.  If group,
+// runs of consecutive records with the same time, lat, and h are evaluated
+// with a MagneticCircle.  Errors are returned in err.
+void EvalChunk(const GeographicLib::MagneticModel* m,
+               const GeographicLib::MagneticCircle* c,
+               const double* in, double* out, size_t i0, size_t i1,
+               bool timeset, GeographicLib::Math::real time,
+               GeographicLib::Math::real tguard,
+               GeographicLib::Math::real hguard,
+               bool group, bool rate, std::string* err) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  try {
+    using std::abs;
+    size_t n = i1 - i0, nin = c ? 1 : (timeset ? 3 : 4), nout = rate ? 14 : 7;
+    std::vector<real> t(n), lat(n), lon(n), h(n),
+      B(6 * n), r(14, Math::NaN());
+    std::vector<bool> valid(n);
+    for (size_t i = 0; i < n; ++i) {
+      const double* rec = in + nin * (i0 + i);
+      if (c) {
+        lon[i] = real(rec[0]);
+        valid[i] = lon[i] >= -540 && lon[i] < 540;
+      } else {
+        t[i] = timeset ? time : real(*rec++);
+        lat[i] = real(rec[0]); lon[i] = real(rec[1]); h[i] = real(rec[2]);
+        valid[i] =
+          t[i] >= m->MinTime() - tguard && t[i] <= m->MaxTime() + tguard &&
+          abs(lat[i]) <= 90 && lon[i] >= -540 && lon[i] < 540 &&
+          h[i] >= m->MinHeight() - hguard && h[i] <= m->MaxHeight() + hguard;
+        if (!valid[i])
+          t[i] = lat[i] = lon[i] = h[i] = 0;
+      }
+    }
+    // The records to be evaluated with MagneticModel::operator()
+    std::vector<size_t> ind;
+    std::vector<real> tb, latb, lonb, hb;
+    if (c) {
+      for (size_t i = 0; i < n; ++i)
+        if (valid[i])
+          (*c)(lon[i], B[6*i], B[6*i+1], B[6*i+2],
+               B[6*i+3], B[6*i+4], B[6*i+5]);
+    } else {
+      for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        if (group && valid[i])
+          while (j < n && valid[j] && t[j] == t[i] && lat[j] == lat[i] &&
+                 h[j] == h[i])
+            ++j;
+        if (j - i > 1) {
+          MagneticCircle circ(m->Circle(t[i], lat[i], h[i]));
+          for (size_t k = i; k < j; ++k)
+            circ(lon[k], B[6*k], B[6*k+1], B[6*k+2],
+                 B[6*k+3], B[6*k+4], B[6*k+5]);
+        } else if (valid[i]) {
+          ind.push_back(i);
+          tb.push_back(t[i]); latb.push_back(lat[i]);
+          lonb.push_back(lon[i]); hb.push_back(h[i]);
+        }
+        i = j;
+      }
+      size_t nb = ind.size();
+      if (nb) {
+        std::vector<real> Bb(6 * nb);
+        if (rate)
+          (*m)(&tb[0], &latb[0], &lonb[0], &hb[0], nb,
+               &Bb[0], &Bb[nb], &Bb[2*nb], &Bb[3*nb], &Bb[4*nb], &Bb[5*nb]);
+        else
+          (*m)(&tb[0], &latb[0], &lonb[0], &hb[0], nb,
+               &Bb[0], &Bb[nb], &Bb[2*nb]);
+        for (size_t k = 0; k < nb; ++k)
+          for (int l = 0; l < (rate ? 6 : 3); ++l)
+            B[6 * ind[k] + l] = Bb[l * nb + k];
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (valid[i])
+        Components(B[6*i], B[6*i+1], B[6*i+2],
+                   rate ? B[6*i+3] : 0, rate ? B[6*i+4] : 0,
+                   rate ? B[6*i+5] : 0, &r[0]);
+      else
+        std::fill(r.begin(), r.end(), Math::NaN());
+      for (size_t l = 0; l < nout; ++l)
+        out[nout * (i0 + i) + l] = double(r[l]);
+    }
+  }
+  catch (const std::exception& e) {
+    *err = e.what();
+  }
+}
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
@@ -33,12 +174,12 @@ int main(int argc, char* argv[]) {
     bool verbose = false;
     std::string dir;
     std::string model = MagneticModel::DefaultMagneticName();
-    std::string istring, ifile, ofile, cdelim;
+    std::string istring, ifile, ofile, cdelim, bfile, bofile;
     char lsep = ';';
     real time = 0, lat = 0, h = 0;
-    bool timeset = false, circle = false, rate = false;
+    bool timeset = false, circle = false, rate = false, group = false;
     real hguard = 500000, tguard = 50;
-    int prec = 1;
+    int prec = 1, nthreads = 1;
 
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
@@ -113,15 +254,36 @@ int main(int argc, char* argv[]) {
         }
       } else if (arg == "-v")
         verbose = true;
+      else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--group")
+        group = true;
       else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
         if (++m == argc) return usage(1, true);
         ifile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -152,6 +314,20 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (!bofile.empty() && bfile.empty()) {
+      std::cerr << "--binary-output requires --binary-file\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -173,6 +349,22 @@ int main(int argc, char* argv[]) {
     }
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
+    std::ifstream binfile;
+    if (!bfile.empty()) {
+      binfile.open(bfile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bfile << " for reading\n";
+        return 1;
+      }
+    }
+    std::ofstream binout;
+    if (!bofile.empty()) {
+      binout.open(bofile.c_str(), std::ios::binary);
+      if (!binout.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
@@ -230,8 +422,91 @@ int main(int argc, char* argv[]) {
                   << m.MaxHeight()/1000 << "km]\n";
       const MagneticCircle c(circle ? m.Circle(time, lat, h) :
                              MagneticCircle());
+      if (!bfile.empty()) {
+        // The input records are (time, lat, lon, h) or, with -t, (lat, lon,
+        // h) or, with -c, (lon) as little-endian doubles.  These are
+        // read in chunks, and each chunk is split between the threads which
+        // share m.  The output is in the same order as the input.
+#if !MAGNETICFIELD_THREADS
+        nthreads = 1;
+#endif
+        const size_t chunk = 65536 * size_t(nthreads),
+          nin = circle ? 1 : (timeset ? 3 : 4), nout = rate ? 14 : 7;
+        std::vector<double> buf(nin * chunk), res(nout * chunk);
+        std::vector<std::string> err(nthreads);
+        std::vector<size_t> split(nthreads + 1);
+        std::vector<real> r(nout);
+        while (binfile) {
+          binfile.read(reinterpret_cast<char*>(&buf[0]),
+                       std::streamsize(buf.size() * sizeof(double)));
+          size_t nbytes = size_t(binfile.gcount()),
+            n = nbytes / (nin * sizeof(double));
+          if (n * nin * sizeof(double) != nbytes) {
+            std::cerr << "File " << bfile << " ends with a partial record\n";
+            return 1;
+          }
+          if (n == 0) break;
+          if (Math::bigendian)
+            for (size_t i = 0; i < nin * n; ++i) buf[i] = Math::swab(buf[i]);
+          // Split the chunk evenly between the threads, except that, with
+          // --group, a run of records on the same circle is not split, so
+          // that the results don't depend on the number of threads.
+          for (int k = 0; k <= nthreads; ++k) {
+            size_t i = n * k / nthreads;
+            if (group && !circle && k > 0)
+              while (i < n && i > split[k - 1] &&
+                     std::equal(&buf[nin * i], &buf[nin * i] + nin - 3,
+                                &buf[nin * (i - 1)]) &&
+                     buf[nin * i + nin - 3] == buf[nin * (i - 1) + nin - 3] &&
+                     buf[nin * i + nin - 1] == buf[nin * (i - 1) + nin - 1])
+                ++i;
+            split[k] = std::max(i, k > 0 ? split[k - 1] : 0);
+          }
+#if MAGNETICFIELD_THREADS
+          if (nthreads > 1) {
+            std::vector<std::thread> threads;
+            for (int k = 0; k < nthreads; ++k)
+              threads.push_back(std::thread(EvalChunk, &m,
+                                            circle ? &c : 0,
+                                            &buf[0], &res[0],
+                                            split[k], split[k + 1],
+                                            timeset, time, tguard, hguard,
+                                            group, rate, &err[k]));
+            for (int k = 0; k < nthreads; ++k)
+              threads[k].join();
+          } else
+#endif
+            EvalChunk(&m, circle ? &c : 0, &buf[0], &res[0], 0, n,
+                      timeset, time, tguard, hguard, group, rate, &err[0]);
+          for (int k = 0; k < nthreads; ++k) {
+            if (!err[k].empty()) {
+              std::cerr << "ERROR: " << err[k] << "\n";
+              return 1;
+            }
+          }
+          if (!bofile.empty()) {
+            if (Math::bigendian)
+              for (size_t i = 0; i < nout * n; ++i) res[i] = Math::swab(res[i]);
+            binout.write(reinterpret_cast<const char*>(&res[0]),
+                         std::streamsize(nout * n * sizeof(double)));
+          } else {
+            for (size_t i = 0; i < n; ++i) {
+              for (size_t l = 0; l < nout; ++l)
+                r[l] = real(res[nout * i + l]);
+              Print(*output, &r[0], rate, prec, "\n");
+            }
+          }
+        }
+        if (!bofile.empty()) {
+          binout.close();
+          if (!binout) {
+            std::cerr << "Error writing " << bofile << "\n";
+            return 1;
+          }
+        }
+      }
       std::string s, stra, strb;
-      while (std::getline(*input, s)) {
+      while (bfile.empty() && std::getline(*input, s)) {
         try {
           std::string eol("\n");
           if (!cdelim.empty()) {
@@ -295,25 +570,9 @@ int main(int argc, char* argv[]) {
             c(lon, bx, by, bz, bxt, byt, bzt);
           else
             m(time, lat, lon, h, bx, by, bz, bxt, byt, bzt);
-          real H, F, D, I, Ht, Ft, Dt, It;
-          MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
-                                         H, F, D, I, Ht, Ft, Dt, It);
-
-          *output << DMS::Encode(D, prec + 1, DMS::NUMBER) << " "
-                  << DMS::Encode(I, prec + 1, DMS::NUMBER) << " "
-                  << Utility::str(H, prec) << " "
-                  << Utility::str(by, prec) << " "
-                  << Utility::str(bx, prec) << " "
-                  << Utility::str(-bz, prec) << " "
-                  << Utility::str(F, prec) << eol;
-          if (rate)
-            *output << DMS::Encode(Dt, prec + 1, DMS::NUMBER) << " "
-                    << DMS::Encode(It, prec + 1, DMS::NUMBER) << " "
-                    << Utility::str(Ht, prec) << " "
-                    << Utility::str(byt, prec) << " "
-                    << Utility::str(bxt, prec) << " "
-                    << Utility::str(-bzt, prec) << " "
-                    << Utility::str(Ft, prec) << eol;
+          real r[14];
+          Components(bx, by, bz, bxt, byt, bzt, r);
+          Print(*output, r, rate, prec, eol);
         }
         catch (const std::exception& e) {
           *output << "ERROR: " << e.what() << "\n";
@@ -3,6 +3,7 @@ PROGRAMS = CartConvert \
 	GeoConvert \
 	GeodSolve \
 	GeodesicProj \
+	GeographicServer \
 	GeoidEval \
 	Gravity \
 	MagneticField \
@@ -48,6 +49,7 @@ ConicProj: ConicProj.o
 GeoConvert: GeoConvert.o
 GeodSolve: GeodSolve.o
 GeodesicProj: GeodesicProj.o
+GeographicServer: GeographicServer.o
 GeoidEval: GeoidEval.o
 Gravity: Gravity.o
 MagneticField: MagneticField.o
@@ -56,22 +58,25 @@ RhumbSolve: RhumbSolve.o
 TransverseMercatorProj: TransverseMercatorProj.o
 
 CartConvert.o: CartConvert.usage Config.h Constants.hpp DMS.hpp Geocentric.hpp \
-	LocalCartesian.hpp Math.hpp Utility.hpp
+	LinePipeline.hpp LocalCartesian.hpp Math.hpp Utility.hpp
 ConicProj.o: ConicProj.usage Config.h AlbersEqualArea.hpp Constants.hpp \
-	DMS.hpp LambertConformalConic.hpp Math.hpp Utility.hpp
+	DMS.hpp LambertConformalConic.hpp LinePipeline.hpp Math.hpp Utility.hpp
 GeoConvert.o: GeoConvert.usage Config.h Constants.hpp DMS.hpp GeoCoords.hpp \
-	Math.hpp UTMUPS.hpp Utility.hpp
+	LinePipeline.hpp Math.hpp UTMUPS.hpp Utility.hpp
 GeodSolve.o: GeodSolve.usage Config.h Constants.hpp DMS.hpp Geodesic.hpp \
-	GeodesicExact.hpp GeodesicLine.hpp GeodesicLineExact.hpp Math.hpp \
-	Utility.hpp
+	GeodesicExact.hpp GeodesicLine.hpp GeodesicLineExact.hpp \
+	LinePipeline.hpp Math.hpp Utility.hpp
 GeodesicProj.o: GeodesicProj.usage Config.h AzimuthalEquidistant.hpp \
 	CassiniSoldner.hpp Constants.hpp DMS.hpp Geodesic.hpp GeodesicLine.hpp \
 	Gnomonic.hpp Math.hpp Utility.hpp
+GeographicServer.o: GeographicServer.usage Config.h Accumulator.hpp \
+	Constants.hpp Geodesic.hpp Geoid.hpp MGRS.hpp Math.hpp \
+	PolygonArea.hpp Rhumb.hpp UTMUPS.hpp Utility.hpp
 GeoidEval.o: GeoidEval.usage Config.h Constants.hpp DMS.hpp GeoCoords.hpp \
 	Geoid.hpp Math.hpp UTMUPS.hpp Utility.hpp
 Gravity.o: Gravity.usage Config.h CircularEngine.hpp Constants.hpp DMS.hpp \
-	Geocentric.hpp GravityCircle.hpp GravityModel.hpp Math.hpp \
-	NormalGravity.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
+	Geocentric.hpp GravityCircle.hpp GravityGrid.hpp GravityModel.hpp \
+	Math.hpp NormalGravity.hpp SphericalEngine.hpp SphericalHarmonic.hpp \
 	SphericalHarmonic1.hpp Utility.hpp
 MagneticField.o: MagneticField.usage Config.h CircularEngine.hpp Constants.hpp \
 	DMS.hpp Geocentric.hpp MagneticCircle.hpp MagneticModel.hpp Math.hpp \
@@ -82,8 +87,8 @@ Planimeter.o: Planimeter.usage Config.h Accumulator.hpp Constants.hpp DMS.hpp \
 RhumbSolve.o: RhumbSolve.usage Config.h Constants.hpp DMS.hpp Ellipsoid.hpp \
 	Math.hpp Utility.hpp
 TransverseMercatorProj.o: TransverseMercatorProj.usage Config.h Constants.hpp \
-	DMS.hpp EllipticFunction.hpp Math.hpp TransverseMercator.hpp \
-	TransverseMercatorExact.hpp Utility.hpp
+	DMS.hpp EllipticFunction.hpp LinePipeline.hpp Math.hpp \
+	TransverseMercator.hpp TransverseMercatorExact.hpp Utility.hpp
 
 %: %.sh
 	sed -e "s%@GEOGRAPHICLIB_DATA@%$(GEOGRAPHICLIB_DATA)%" $< > $@
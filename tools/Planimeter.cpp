@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <GeographicLib/PolygonArea.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -24,21 +26,175 @@
 #  pragma warning (disable: 4127)
 #endif
 
+#if !defined(PLANIMETER_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define PLANIMETER_THREADS 1
+#  else
+#    define PLANIMETER_THREADS 0
+#  endif
+#endif
+
+#if PLANIMETER_THREADS
+#  include <thread>
+#endif
+
 #include "Planimeter.usage"
 
+typedef GeographicLib::Math::real real;
+
+// The settings and the polygon objects used to compute many polygons
+struct Settings {
+  enum { GEODESIC, EXACT, AUTHALIC, RHUMB };
+  int linetype, prec;
+  bool reverse, sign, polyline;
+  std::string cdelim;
+  const GeographicLib::Ellipsoid* ellip;
+  const GeographicLib::PolygonArea* poly;
+  const GeographicLib::PolygonAreaExact* polye;
+  const GeographicLib::PolygonAreaRhumb* polyr;
+};
+
+// Write the summary line for a polygon with num vertices (nothing is written
+// if num = 0).
+void WriteResult(const Settings& c, unsigned num, real perimeter, real area,
+                 const std::string& eol, std::ostream& out) {
+  using namespace GeographicLib;
+  if (num > 0) {
+    out << num << " " << Utility::str(perimeter, c.prec);
+    if (!c.polyline) {
+      out << " " << Utility::str(area, std::max(0, c.prec - 5));
+    }
+    out << eol;
+  }
+}
+
+// Compute polygons k0 thru k1 - 1 of a set of polygons in compressed sparse
+// row form; the vertices of polygon k are offsets[k] thru offsets[k + 1] - 1
+// of lat and lon.  This is called concurrently from several threads with -j.
+void ComputePolygons(const Settings* c, const size_t* offsets,
+                     const real* lat, const real* lon, size_t k0, size_t k1,
+                     real* perimeter, real* area) {
+  switch (c->linetype) {
+  case Settings::EXACT:
+    c->polye->ComputeMany(offsets + k0, lat, lon, k1 - k0,
+                          c->reverse, c->sign, perimeter + k0, area + k0);
+    break;
+  case Settings::RHUMB:
+    c->polyr->ComputeMany(offsets + k0, lat, lon, k1 - k0,
+                          c->reverse, c->sign, perimeter + k0, area + k0);
+    break;
+  default:                      // geodesic + authalic
+    c->poly->ComputeMany(offsets + k0, lat, lon, k1 - k0,
+                         c->reverse, c->sign, perimeter + k0, area + k0);
+    break;
+  }
+}
+
+// Compute all the polygons in offsets, lat, lon dividing them among nthreads
+// threads.  The results are written to out in order with eol[k] ending the
+// line for polygon k (or "\n" if eol is null).
+void ComputeAll(const Settings& c, const std::vector<size_t>& offsets,
+                const std::vector<real>& lat, const std::vector<real>& lon,
+                const std::vector<std::string>* eol, int nthreads,
+                std::ostream& out) {
+  size_t npoly = offsets.size() - 1;
+  if (npoly == 0) return;
+  std::vector<real> perimeter(npoly), area(npoly);
+  nthreads = int(std::min(size_t(std::max(nthreads, 1)), npoly));
+  size_t per = (npoly + nthreads - 1) / nthreads;
+#if PLANIMETER_THREADS
+  std::vector<std::thread> threads;
+  for (int t = 1; t < nthreads; ++t) {
+    size_t k0 = std::min(npoly, t * per), k1 = std::min(npoly, k0 + per);
+    if (k0 == k1) break;
+    threads.push_back(std::thread(ComputePolygons, &c, &offsets[0],
+                                  &lat[0], &lon[0], k0, k1,
+                                  &perimeter[0], &area[0]));
+  }
+#endif
+  ComputePolygons(&c, &offsets[0], &lat[0], &lon[0], 0, std::min(npoly, per),
+                  &perimeter[0], &area[0]);
+#if PLANIMETER_THREADS
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+#endif
+  const std::string nl("\n");
+  for (size_t k = 0; k < npoly; ++k)
+    WriteResult(c, unsigned(offsets[k + 1] - offsets[k]),
+                perimeter[k], area[k], eol ? (*eol)[k] : nl, out);
+}
+
+// Process the lines of input in [begin, end) putting the results in *out.
+// The polygons are terminated in the same way as for the serial reading of
+// the input; the input must therefore be split only after blank lines.  The
+// vertices are collected in compressed sparse row form and the polygons are
+// computed with PolygonAreaT::ComputeMany.  This is called concurrently from
+// several threads with -j.
+void ProcessPolygons(const Settings* c, const char* begin, const char* end,
+                     std::string* out) {
+  using namespace GeographicLib;
+  GeoCoords p;
+  std::vector<real> lat, lon;
+  std::vector<size_t> offsets(1, 0);
+  std::vector<std::string> eols;
+  std::string s, eol("\n");
+  while (begin < end) {
+    const char* nl = std::find(begin, end, '\n');
+    s.assign(begin, nl);
+    begin = nl == end ? end : nl + 1;
+    if (!c->cdelim.empty()) {
+      std::string::size_type m = s.find(c->cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        s = s.substr(0, m);
+      }
+    }
+    bool endpoly = s.empty();
+    if (!endpoly) {
+      try {
+        p.Reset(s);
+        if (Math::isnan(p.Latitude()) || Math::isnan(p.Longitude()))
+          endpoly = true;
+      }
+      catch (const GeographicErr&) {
+        endpoly = true;
+      }
+    }
+    if (endpoly) {
+      if (lat.size() > offsets.back()) {
+        offsets.push_back(lat.size());
+        eols.push_back(eol);
+      }
+      eol = "\n";
+    } else {
+      lat.push_back(c->linetype == Settings::AUTHALIC ?
+                    c->ellip->AuthalicLatitude(p.Latitude()) :
+                    p.Latitude());
+      lon.push_back(p.Longitude());
+    }
+  }
+  // A polygon ended by the end of the input
+  if (lat.size() > offsets.back()) {
+    offsets.push_back(lat.size());
+    eols.push_back(eol);
+  }
+  std::ostringstream output;
+  ComputeAll(*c, offsets, lat, lon, &eols, 1, output);
+  *out = output.str();
+}
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
-    enum { GEODESIC, EXACT, AUTHALIC, RHUMB };
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
-    bool reverse = false, sign = true, polyline = false;
-    int linetype = GEODESIC;
-    int prec = 6;
-    std::string istring, ifile, ofile, cdelim;
+    bool reverse = false, sign = true, polyline = false, cells = false;
+    real dlon = 0;
+    int linetype = Settings::GEODESIC;
+    int prec = 6, nthreads = 1;
+    std::string istring, ifile, ofile, cdelim, bfile;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -70,19 +226,50 @@ int main(int argc, char* argv[]) {
           return 1;
         }
       } else if (arg == "-G")
-        linetype = GEODESIC;
+        linetype = Settings::GEODESIC;
       else if (arg == "-E")
-        linetype = EXACT;
+        linetype = Settings::EXACT;
       else if (arg == "-Q")
-        linetype = AUTHALIC;
+        linetype = Settings::AUTHALIC;
       else if (arg == "-R")
-        linetype = RHUMB;
-      else if (arg == "--input-string") {
+        linetype = Settings::RHUMB;
+      else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--cells") {
+        if (++m == argc) return usage(1, true);
+        try {
+          dlon = Utility::num<real>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of --cells: "
+                    << e.what() << "\n";
+          return 1;
+        }
+        if (!(dlon > 0 && dlon < 180)) {
+          std::cerr << "Cell width must be in (0, 180)\n";
+          return 1;
+        }
+        cells = true;
+      } else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
         if (++m == argc) return usage(1, true);
         ifile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
@@ -108,6 +295,15 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (cells && (polyline || !bfile.empty())) {
+      std::cerr << "Cannot specify --cells with -l or --binary-file\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -129,6 +325,14 @@ int main(int argc, char* argv[]) {
     }
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
+    std::ifstream binfile;
+    if (!bfile.empty()) {
+      binfile.open(bfile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bfile << " for reading\n";
+        return 1;
+      }
+    }
 
     std::ofstream outfile;
     if (ofile == "-") ofile.clear();
@@ -142,7 +346,7 @@ int main(int argc, char* argv[]) {
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
 
     const Ellipsoid ellip(a, f);
-    if (linetype == AUTHALIC) {
+    if (linetype == Settings::AUTHALIC) {
       using std::sqrt;
       a = sqrt(ellip.Area() / (4 * Math::pi()));
       f = 0;
@@ -158,11 +362,193 @@ int main(int argc, char* argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
+    Settings c;
+    c.linetype = linetype; c.prec = prec;
+    c.reverse = reverse; c.sign = sign; c.polyline = polyline;
+    c.cdelim = cdelim; c.ellip = &ellip;
+    c.poly = &poly; c.polye = &polye; c.polyr = &polyr;
+#if !PLANIMETER_THREADS
+    nthreads = 1;
+#endif
     std::string s;
     real perimeter, area;
     unsigned num;
     std::string eol("\n");
-    while (std::getline(*input, s)) {
+    if (cells) {
+      // Each set of latitudes (ended by a blank line or the end of input)
+      // gives the edges of a column of cells of width dlon.  The areas of the
+      // cells are computed with PolygonAreaT::CellAreas.
+      std::vector<real> lat, cellarea;
+      bool eof = false, first = true;
+      while (!eof) {
+        eof = !std::getline(*input, s);
+        if (!eof) {
+          if (!cdelim.empty()) {
+            std::string::size_type m = s.find(cdelim);
+            if (m != std::string::npos)
+              s = s.substr(0, m);
+          }
+          if (s.find_first_not_of(" \t") != std::string::npos) {
+            DMS::flag ind;
+            real l = DMS::Decode(s, ind);
+            if (ind == DMS::LONGITUDE || !(std::abs(l) <= 90))
+              throw GeographicErr("Bad latitude " + s);
+            lat.push_back(linetype == Settings::AUTHALIC ?
+                          ellip.AuthalicLatitude(l) : l);
+            continue;
+          }
+        }
+        if (lat.size() > 1) {
+          cellarea.resize(lat.size() - 1);
+          linetype == Settings::EXACT ?
+            polye.CellAreas(&lat[0], lat.size(), dlon, &cellarea[0]) :
+            linetype == Settings::RHUMB ?
+            polyr.CellAreas(&lat[0], lat.size(), dlon, &cellarea[0]) :
+            poly.CellAreas(&lat[0], lat.size(), dlon, &cellarea[0]);
+          if (!first) *output << "\n";
+          first = false;
+          for (size_t k = 0; k < cellarea.size(); ++k)
+            *output << Utility::str(reverse ? -cellarea[k] : cellarea[k],
+                                    std::max(0, prec - 5)) << "\n";
+        }
+        lat.clear();
+      }
+      return 0;
+    }
+    if (!bfile.empty()) {
+      // The vertices are pairs of little-endian doubles (latitude,
+      // longitude) with a pair of NaNs separating polygons.  Read these in
+      // chunks.  The polygons completed within a chunk are held in compressed
+      // sparse row form and are computed by PolygonAreaT::ComputeMany (divided
+      // among the threads with -j).  An incomplete polygon at the end of a
+      // chunk is carried over to the next chunk, unless it has more than
+      // chunk vertices, in which case its vertices are passed to
+      // PolygonAreaT::AddPoints, so that the memory usage is bounded.
+      const size_t chunk = 65536 * size_t(nthreads);
+      std::vector<double> buf(2 * chunk);
+      std::vector<real> lat(2 * chunk), lon(2 * chunk);
+      std::vector<size_t> offsets(1, 0);
+      size_t k = 0;             // The number of vertices held
+      bool stream = false;      // Is the current polygon given to AddPoints?
+      bool eof = false;
+      while (!eof) {
+        binfile.read(reinterpret_cast<char*>(&buf[0]),
+                     std::streamsize(buf.size() * sizeof(double)));
+        size_t nbytes = size_t(binfile.gcount()),
+          n = nbytes / (2 * sizeof(double));
+        if (n * 2 * sizeof(double) != nbytes) {
+          std::cerr << "File " << bfile << " ends with a partial vertex\n";
+          return 1;
+        }
+        eof = !binfile;
+        if (Math::bigendian)
+          for (size_t i = 0; i < 2 * n; ++i) buf[i] = Math::swab(buf[i]);
+        for (size_t i = 0; i < n; ++i) {
+          if (Math::isnan(buf[2 * i]) || Math::isnan(buf[2 * i + 1])) {
+            if (stream) {
+              // This is the first polygon of the chunk
+              linetype == Settings::EXACT ?
+                polye.AddPoints(&lat[0], &lon[0], k) :
+                linetype == Settings::RHUMB ?
+                polyr.AddPoints(&lat[0], &lon[0], k) :
+                poly.AddPoints(&lat[0], &lon[0], k);
+              num =
+                linetype == Settings::EXACT ?
+                polye.Compute(reverse, sign, perimeter, area) :
+                linetype == Settings::RHUMB ?
+                polyr.Compute(reverse, sign, perimeter, area) :
+                poly.Compute(reverse, sign, perimeter, area);
+              WriteResult(c, num, perimeter, area, eol, *output);
+              linetype == Settings::EXACT ? polye.Clear() :
+                linetype == Settings::RHUMB ? polyr.Clear() : poly.Clear();
+              stream = false;
+              k = 0;
+            } else
+              offsets.push_back(k);
+          } else {
+            lat[k] = linetype == Settings::AUTHALIC ?
+              ellip.AuthalicLatitude(real(buf[2 * i])) : real(buf[2 * i]);
+            lon[k] = real(buf[2 * i + 1]);
+            ++k;
+          }
+        }
+        if (eof && !stream)
+          // The end of the file ends the last polygon
+          offsets.push_back(k);
+        ComputeAll(c, offsets, lat, lon, 0, nthreads, *output);
+        size_t k0 = offsets.back();
+        if (stream || k - k0 > chunk) {
+          linetype == Settings::EXACT ?
+            polye.AddPoints(&lat[k0], &lon[k0], k - k0) :
+            linetype == Settings::RHUMB ?
+            polyr.AddPoints(&lat[k0], &lon[k0], k - k0) :
+            poly.AddPoints(&lat[k0], &lon[k0], k - k0);
+          stream = true;
+          k = 0;
+        } else {
+          std::copy(lat.begin() + k0, lat.begin() + k, lat.begin());
+          std::copy(lon.begin() + k0, lon.begin() + k, lon.begin());
+          k -= k0;
+        }
+        offsets.assign(1, 0);
+      }
+    } else if (nthreads > 1) {
+      // Read the input in large blocks and split each block after blank lines
+      // (which always end a polygon) into nthreads pieces.  The polygons in
+      // each piece are read and computed concurrently and the output of each
+      // block is written in the order of the input.
+      const size_t blocksize = size_t(1) << 20; // bytes per thread
+      std::vector<char> buf;
+      std::vector<std::string> out(nthreads);
+      size_t carry = 0;         // Bytes carried over from the last block
+      bool eof = false;
+      while (!eof) {
+        buf.resize(std::max(buf.size(), carry + nthreads * blocksize));
+        input->read(&buf[carry], std::streamsize(buf.size() - carry));
+        size_t n = carry + size_t(input->gcount());
+        eof = !*input;
+        const char* start = &buf[0];
+        // Process the input up to the last blank line (or everything at the
+        // end of the input).  The buffer starts at the beginning of a line.
+        size_t end = n;
+        if (!eof) {
+          while (end > 0 &&
+                 !(buf[end - 1] == '\n' && (end == 1 || buf[end - 2] == '\n')))
+            --end;
+          if (end == 0) {
+            // No blank line in the buffer; read more
+            carry = n;
+            buf.resize(2 * buf.size());
+            continue;
+          }
+        }
+        std::vector<const char*> piece(nthreads + 1, start + end);
+        piece[0] = start;
+        for (int t = 1; t < nthreads; ++t) {
+          // Start piece t after the blank line preceding t * end / nthreads
+          const char* p =
+            std::max(piece[t - 1], start + size_t(t) * end / nthreads);
+          while (p > piece[t - 1] &&
+                 !(p[-1] == '\n' && (p - 1 == start || p[-2] == '\n')))
+            --p;
+          piece[t] = p;
+        }
+#if PLANIMETER_THREADS
+        std::vector<std::thread> threads;
+        for (int t = 1; t < nthreads; ++t)
+          threads.push_back(std::thread(ProcessPolygons, &c, piece[t],
+                                        piece[t + 1], &out[t]));
+        ProcessPolygons(&c, piece[0], piece[1], &out[0]);
+        for (size_t t = 0; t < threads.size(); ++t)
+          threads[t].join();
+#endif
+        for (int t = 0; t < nthreads; ++t)
+          output->write(out[t].data(), std::streamsize(out[t].size()));
+        carry = n - end;
+        std::copy(buf.begin() + end, buf.begin() + n, buf.begin());
+      }
+    }
+    while (bfile.empty() && nthreads == 1 && std::getline(*input, s)) {
       if (!cdelim.empty()) {
         std::string::size_type m = s.find(cdelim);
         if (m != std::string::npos) {
@@ -183,41 +569,35 @@ int main(int argc, char* argv[]) {
       }
       if (endpoly) {
         num =
-          linetype == EXACT ? polye.Compute(reverse, sign, perimeter, area) :
-          linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
+          linetype == Settings::EXACT ?
+          polye.Compute(reverse, sign, perimeter, area) :
+          linetype == Settings::RHUMB ?
+          polyr.Compute(reverse, sign, perimeter, area) :
           poly.Compute(reverse, sign, perimeter, area); // geodesic + authalic
-        if (num > 0) {
-          *output << num << " " << Utility::str(perimeter, prec);
-          if (!polyline) {
-            *output << " " << Utility::str(area, std::max(0, prec - 5));
-          }
-          *output << eol;
-        }
-        linetype == EXACT ? polye.Clear() :
-          linetype == RHUMB ? polyr.Clear() : poly.Clear();
+        WriteResult(c, num, perimeter, area, eol, *output);
+        linetype == Settings::EXACT ? polye.Clear() :
+          linetype == Settings::RHUMB ? polyr.Clear() : poly.Clear();
         eol = "\n";
       } else {
-        linetype == EXACT ? polye.AddPoint(p.Latitude(), p.Longitude()) :
-          linetype == RHUMB ? polyr.AddPoint(p.Latitude(), p.Longitude()) :
-          poly.AddPoint(linetype == AUTHALIC ?
+        linetype == Settings::EXACT ?
+          polye.AddPoint(p.Latitude(), p.Longitude()) :
+          linetype == Settings::RHUMB ?
+          polyr.AddPoint(p.Latitude(), p.Longitude()) :
+          poly.AddPoint(linetype == Settings::AUTHALIC ?
                         ellip.AuthalicLatitude(p.Latitude()) :
                         p.Latitude(),
                         p.Longitude());
       }
     }
     num =
-      linetype == EXACT ? polye.Compute(reverse, sign, perimeter, area) :
-      linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
+      linetype == Settings::EXACT ?
+      polye.Compute(reverse, sign, perimeter, area) :
+      linetype == Settings::RHUMB ?
+      polyr.Compute(reverse, sign, perimeter, area) :
       poly.Compute(reverse, sign, perimeter, area);
-    if (num > 0) {
-      *output << num << " " << Utility::str(perimeter, prec);
-      if (!polyline) {
-        *output << " " << Utility::str(area, std::max(0, prec - 5));
-      }
-      *output << eol;
-    }
-    linetype == EXACT ? polye.Clear() :
-      linetype == RHUMB ? polyr.Clear() : poly.Clear();
+    WriteResult(c, num, perimeter, area, eol, *output);
+    linetype == Settings::EXACT ? polye.Clear() :
+      linetype == Settings::RHUMB ? polyr.Clear() : poly.Clear();
     eol = "\n";
     return 0;
   }
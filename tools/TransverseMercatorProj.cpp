@@ -15,10 +15,14 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <GeographicLib/EllipticFunction.hpp>
 #include <GeographicLib/TransverseMercatorExact.hpp>
 #include <GeographicLib/TransverseMercator.hpp>
 #include <GeographicLib/DMS.hpp>
+#include <GeographicLib/LinePipeline.hpp>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -27,8 +31,210 @@
 #  pragma warning (disable: 4127 4701)
 #endif
 
+#if !defined(TRANSVERSEMERCATORPROJ_THREADS)
+#  if __cplusplus >= 201103 || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#    define TRANSVERSEMERCATORPROJ_THREADS 1
+#  else
+#    define TRANSVERSEMERCATORPROJ_THREADS 0
+#  endif
+#endif
+
+#if TRANSVERSEMERCATORPROJ_THREADS
+#  include <thread>
+#endif
+
 #include "TransverseMercatorProj.usage"
 
+typedef GeographicLib::Math::real real;
+
+// Binary records are sequences of doubles in little-endian byte order.
+// BinaryInput reads them from a file mapped into memory or, if this isn't
+// possible (e.g., for standard input, specified by "-"), from a stream.
+class BinaryInput {
+private:
+  std::string _name;
+  std::ifstream _file;
+  std::istream* _in;
+  char* _map;
+  void* _handle;
+  unsigned long long _len, _pos;
+  std::vector<char> _buf;
+  BinaryInput(const BinaryInput&);            // Disallow copy
+  BinaryInput& operator=(const BinaryInput&); // and assignment
+public:
+  BinaryInput() : _in(0), _map(0), _handle(0), _len(0), _pos(0) {}
+  ~BinaryInput() { GeographicLib::Utility::unmapfile(_map, _len, _handle); }
+  // Open the input; return false if this fails.
+  bool Open(const std::string& name) {
+    _name = name;
+    if (name == "-") {
+      _in = &std::cin;
+      return true;
+    }
+    try {
+      _map = GeographicLib::Utility::mapfile(name, _len, _handle);
+      return true;
+    }
+    catch (const std::exception&) {
+      // Fall back to reading the file
+    }
+    _file.open(name.c_str(), std::ios::binary);
+    _in = &_file;
+    return _file.is_open();
+  }
+  // Read up to n records of nf fields into the arrays x[0], ..., x[nf-1].
+  // Return the number of records read (0 at the end of the input).
+  size_t Read(size_t nf, size_t n, real* const x[]) {
+    using namespace GeographicLib;
+    const size_t rec = nf * sizeof(double);
+    size_t nbytes = n * rec;
+    const char* p;
+    if (_map) {
+      nbytes = size_t(std::min((unsigned long long)(nbytes), _len - _pos));
+      p = _map + _pos;
+      _pos += nbytes;
+    } else {
+      _buf.resize(nbytes);
+      _in->read(&_buf[0], std::streamsize(nbytes));
+      nbytes = size_t(_in->gcount());
+      p = &_buf[0];
+    }
+    n = nbytes / rec;
+    if (n * rec != nbytes)
+      throw GeographicErr("File " + _name + " ends with a partial record");
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nf; ++j) {
+        double d;
+        std::memcpy(&d, p + (i * nf + j) * sizeof(double), sizeof(double));
+        x[j][i] = real(Math::bigendian ? Math::swab(d) : d);
+      }
+    return n;
+  }
+};
+
+// Write n records of the nf fields x[0], ..., x[nf-1] to out as
+// little-endian doubles using buf as the buffer.
+void WriteRecords(std::ostream& out, size_t nf, size_t n,
+                  const real* const x[], std::vector<char>& buf) {
+  using namespace GeographicLib;
+  buf.resize(n * nf * sizeof(double));
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < nf; ++j) {
+      double d = double(x[j][i]);
+      if (Math::bigendian) d = Math::swab(d);
+      std::memcpy(&buf[(i * nf + j) * sizeof(double)], &d, sizeof(double));
+    }
+  out.write(&buf[0], std::streamsize(buf.size()));
+}
+
+// The settings which control the processing of each line of input
+struct Settings {
+  bool series, reverse, csv;
+  int prec;
+  real lon0;
+  std::string cdelim;
+  const GeographicLib::TransverseMercator* tms;
+  const GeographicLib::TransverseMercatorExact* tme;
+};
+
+// Process a line of input, s, writing the result (or an error message) to
+// out.  Return 1 if there's an error and 0 otherwise.
+int ProcessLine(const Settings& c, std::string s, std::ostream& out) {
+  using namespace GeographicLib;
+  const int prec = c.prec;
+  const real lon0 = c.lon0;
+  // The output field separator
+  const char* sep = c.csv ? "," : " ";
+  int retval = 0;
+  try {
+    std::string eol("\n");
+    if (!c.cdelim.empty()) {
+      std::string::size_type m = s.find(c.cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        s = s.substr(0, m);
+      }
+    }
+    if (c.csv)
+      std::replace(s.begin(), s.end(), ',', ' ');
+    std::istringstream str(s);
+    real lat, lon, x, y, gamma, k;
+    std::string stra, strb;
+    if (!(str >> stra >> strb))
+      throw GeographicErr("Incomplete input: " + s);
+    if (c.reverse) {
+      x = Utility::num<real>(stra);
+      y = Utility::num<real>(strb);
+    } else
+      DMS::DecodeLatLon(stra, strb, lat, lon);
+    std::string strc;
+    if (str >> strc)
+      throw GeographicErr("Extraneous input: " + strc);
+    if (c.reverse) {
+      if (c.series)
+        c.tms->Reverse(lon0, x, y, lat, lon, gamma, k);
+      else
+        c.tme->Reverse(lon0, x, y, lat, lon, gamma, k);
+      out << Utility::str(lat, prec + 5) << sep
+          << Utility::str(lon, prec + 5) << sep
+          << Utility::str(gamma, prec + 6) << sep
+          << Utility::str(k, prec + 6) << eol;
+    } else {
+      if (c.series)
+        c.tms->Forward(lon0, lat, lon, x, y, gamma, k);
+      else
+        c.tme->Forward(lon0, lat, lon, x, y, gamma, k);
+      out << Utility::str(x, prec) << sep
+          << Utility::str(y, prec) << sep
+          << Utility::str(gamma, prec + 6) << sep
+          << Utility::str(k, prec + 6) << eol;
+    }
+  }
+  catch (const std::exception& e) {
+    out << "ERROR: " << e.what() << "\n";
+    retval = 1;
+  }
+  return retval;
+}
+
+// The processing of the lines of text input.  This is called concurrently
+// from several threads with -j.
+class LineProjector : public GeographicLib::LinePipeline::Stage {
+private:
+  const Settings& _c;
+  LineProjector& operator=(const LineProjector&);
+public:
+  explicit LineProjector(const Settings& c) : _c(c) {}
+  int operator()(const std::string& s, std::ostream& out) const
+  { return ProcessLine(_c, s, out); }
+};
+
+// Project binary records [i0, i1).  The input fields, (lat, lon) or, with
+// -r, (x, y), are in the arrays in and the output fields, (x, y, gamma, k)
+// or, with -r, (lat, lon, gamma, k), are put into the arrays out.  This is
+// called concurrently from several threads with -j.
+void ProjectRecords(const Settings* c, size_t i0, size_t i1,
+                    real* const* in, real* const* out) {
+  size_t n = i1 - i0;
+  if (n == 0) return;
+  if (c->reverse) {
+    if (c->series)
+      c->tms->Reverse(c->lon0, in[0] + i0, in[1] + i0, n,
+                      out[0] + i0, out[1] + i0, out[2] + i0, out[3] + i0);
+    else
+      c->tme->Reverse(c->lon0, in[0] + i0, in[1] + i0, n,
+                      out[0] + i0, out[1] + i0, out[2] + i0, out[3] + i0);
+  } else {
+    if (c->series)
+      c->tms->Forward(c->lon0, in[0] + i0, in[1] + i0, n,
+                      out[0] + i0, out[1] + i0, out[2] + i0, out[3] + i0);
+    else
+      c->tme->Forward(c->lon0, in[0] + i0, in[1] + i0, n,
+                      out[0] + i0, out[1] + i0, out[2] + i0, out[3] + i0);
+  }
+}
+
+
 int main(int argc, char* argv[]) {
   try {
     using namespace GeographicLib;
@@ -41,7 +247,9 @@ int main(int argc, char* argv[]) {
       k0 = Constants::UTM_k0(),
       lon0 = 0;
     int prec = 6;
-    std::string istring, ifile, ofile, cdelim;
+    int nthreads = 1;
+    bool csv = false;
+    std::string istring, ifile, ofile, cdelim, bfile, bofile;
     char lsep = ';';
 
     for (int m = 1; m < argc; ++m) {
@@ -102,7 +310,22 @@ int main(int argc, char* argv[]) {
           std::cerr << "Precision " << argv[m] << " is not a number\n";
           return 1;
         }
-      } else if (arg == "--input-string") {
+      } else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::num<int>(std::string(argv[m]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of -j: " << e.what() << "\n";
+          return 1;
+        }
+        if (!(nthreads > 0)) {
+          std::cerr << "Number of threads must be positive\n";
+          return 1;
+        }
+      } else if (arg == "--csv")
+        csv = true;
+      else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
       } else if (arg == "--input-file") {
@@ -111,6 +334,12 @@ int main(int argc, char* argv[]) {
       } else if (arg == "--output-file") {
         if (++m == argc) return usage(1, true);
         ofile = argv[m];
+      } else if (arg == "--binary-file") {
+        if (++m == argc) return usage(1, true);
+        bfile = argv[m];
+      } else if (arg == "--binary-output") {
+        if (++m == argc) return usage(1, true);
+        bofile = argv[m];
       } else if (arg == "--line-separator") {
         if (++m == argc) return usage(1, true);
         if (std::string(argv[m]).size() != 1) {
@@ -133,6 +362,21 @@ int main(int argc, char* argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (!bfile.empty() && !(ifile.empty() && istring.empty())) {
+      std::cerr << "Cannot specify --binary-file with "
+                << "--input-string or --input-file\n";
+      return 1;
+    }
+    if (bfile.empty() != bofile.empty()) {
+      std::cerr << "--binary-file and --binary-output must be given "
+                << "together\n";
+      return 1;
+    }
+    if (!bofile.empty() && !ofile.empty()) {
+      std::cerr << "Cannot specify --binary-output and --output-file "
+                << "together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
     std::ifstream infile;
     std::istringstream instring;
@@ -165,6 +409,20 @@ int main(int argc, char* argv[]) {
       }
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+    BinaryInput binin;
+    if (!bfile.empty() && !binin.Open(bfile)) {
+      std::cerr << "Cannot open " << bfile << " for reading\n";
+      return 1;
+    }
+    std::ofstream binfile;
+    if (!bofile.empty() && bofile != "-") {
+      binfile.open(bofile.c_str(), std::ios::binary);
+      if (!binfile.is_open()) {
+        std::cerr << "Cannot open " << bofile << " for writing\n";
+        return 1;
+      }
+    }
+    std::ostream* binoutput = bofile != "-" ? &binfile : &std::cout;
 
     const TransverseMercator& TMS =
       series ? TransverseMercator(a, f, k0) : TransverseMercator(1, 0, 1);
@@ -176,58 +434,50 @@ int main(int argc, char* argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s;
-    int retval = 0;
     std::cout << std::fixed;
-    while (std::getline(*input, s)) {
-      try {
-        std::string eol("\n");
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
-          }
-        }
-        std::istringstream str(s);
-        real lat, lon, x, y;
-        std::string stra, strb;
-        if (!(str >> stra >> strb))
-          throw GeographicErr("Incomplete input: " + s);
-        if (reverse) {
-          x = Utility::num<real>(stra);
-          y = Utility::num<real>(strb);
-        } else
-          DMS::DecodeLatLon(stra, strb, lat, lon);
-        std::string strc;
-        if (str >> strc)
-          throw GeographicErr("Extraneous input: " + strc);
-        real gamma, k;
-        if (reverse) {
-          if (series)
-            TMS.Reverse(lon0, x, y, lat, lon, gamma, k);
-          else
-            TME.Reverse(lon0, x, y, lat, lon, gamma, k);
-          *output << Utility::str(lat, prec + 5) << " "
-                  << Utility::str(lon, prec + 5) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
-        } else {
-          if (series)
-            TMS.Forward(lon0, lat, lon, x, y, gamma, k);
-          else
-            TME.Forward(lon0, lat, lon, x, y, gamma, k);
-          *output << Utility::str(x, prec) << " "
-                  << Utility::str(y, prec) << " "
-                  << Utility::str(gamma, prec + 6) << " "
-                  << Utility::str(k, prec + 6) << eol;
-        }
+    Settings c;
+    c.series = series; c.reverse = reverse; c.csv = csv; c.prec = prec;
+    c.lon0 = lon0; c.cdelim = cdelim; c.tms = &TMS; c.tme = &TME;
+    int retval = 0;
+#if !TRANSVERSEMERCATORPROJ_THREADS
+    nthreads = 1;
+#endif
+    if (!bfile.empty()) {
+      // Read the binary records in chunks and split each chunk between the
+      // threads.  The output records are written in the order of the input.
+      const size_t chunk = 65536 * size_t(nthreads), nin = 2, nout = 4;
+      std::vector<real> buf((nin + nout) * chunk);
+      real* in[nin];
+      real* out[nout];
+      for (size_t j = 0; j < nin; ++j)
+        in[j] = &buf[j * chunk];
+      for (size_t j = 0; j < nout; ++j)
+        out[j] = &buf[(nin + j) * chunk];
+      std::vector<char> obuf;
+      size_t n;
+      while ((n = binin.Read(nin, chunk, in)) > 0) {
+#if TRANSVERSEMERCATORPROJ_THREADS
+        std::vector<std::thread> threads;
+        for (int k = 1; k < nthreads; ++k)
+          threads.push_back(std::thread(ProjectRecords, &c,
+                                        n * k / nthreads,
+                                        n * (k + 1) / nthreads, in, out));
+#endif
+        ProjectRecords(&c, 0, n / nthreads, in, out);
+#if TRANSVERSEMERCATORPROJ_THREADS
+        for (size_t k = 0; k < threads.size(); ++k)
+          threads[k].join();
+#endif
+        WriteRecords(*binoutput, nout, n, out, obuf);
       }
-      catch (const std::exception& e) {
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+      binoutput->flush();
+      if (!*binoutput) {
+        std::cerr << "Error writing " << bofile << "\n";
+        return 1;
       }
+      return 0;
     }
+    retval = LinePipeline(nthreads).Run(*input, *output, LineProjector(c));
     return retval;
   }
   catch (const std::exception& e) {
@@ -162,6 +162,19 @@ add_test (NAME GeodSolve24 COMMAND GeodSolve
   -l 40 -75 -10 --input-string "2e7" -E)
 set_tests_properties (GeodSolve21 GeodSolve22 GeodSolve23 GeodSolve24
   PROPERTIES PASS_REGULAR_EXPRESSION "-39\\.[0-9]* 105\\.[0-9]* -170\\.[0-9]*")
+# The lines processed in parallel with -j are output in order
+add_test (NAME GeodSolve25 COMMAND GeodSolve -i -j 2 -p 0
+  --input-string "40.6 -73.8 49d01'N 2d33'E;0 0 1 1")
+set_tests_properties (GeodSolve25 PROPERTIES PASS_REGULAR_EXPRESSION
+  "53\\.47022 111\\.59367 5853226\n45\\.18804 45\\.19677 156900")
+# Points on an exact geodesic line are computed with Fourier series for
+# the elliptic integrals; these should agree with the direct calculation
+add_test (NAME GeodSolve26 COMMAND GeodSolve -e 6.4e6 -1/50 -E -p 0
+  --input-string "40 -75 -10 1e6;40 -75 -10 1.5e7;40 -75 -10 -3e6")
+add_test (NAME GeodSolve27 COMMAND GeodSolve -e 6.4e6 -1/50 -E -p 0
+  -l 40 -75 -10 --input-string "1e6;1.5e7;-3e6")
+set_tests_properties (GeodSolve26 GeodSolve27 PROPERTIES PASS_REGULAR_EXPRESSION
+  "48\\.70455 -77\\.37333 -11\\.66397\n5\\.58300 111\\.94722 -172\\.38130\n14\\.14662 -70\\.35020 -7\\.82893")
 
 # Check fix for pole-encircling bug found 2011-03-16
 add_test (NAME Planimeter0 COMMAND Planimeter
@@ -219,6 +232,22 @@ add_test (NAME Planimeter13 COMMAND Planimeter
 set_tests_properties (Planimeter13 PROPERTIES PASS_REGULAR_EXPRESSION
   "6 1160741\\..* 32415230256\\.")
 
+# Check the areas of grid cells computed with --cells.  These equal the
+# areas of the corresponding polygons.
+add_test (NAME Planimeter14 COMMAND Planimeter
+  --cells 2.5 --input-string "0;0.25;0.5")
+set_tests_properties (Planimeter14 PROPERTIES PASS_REGULAR_EXPRESSION
+  "7694375285\\.6\n7694232578\\.2")
+add_test (NAME Planimeter15 COMMAND Planimeter
+  -R --cells 1 --input-string "10;20")
+set_tests_properties (Planimeter15 PROPERTIES PASS_REGULAR_EXPRESSION
+  "118855188514\\.8")
+# Check that the area on a sphere is finite (-Q uses a sphere)
+add_test (NAME Planimeter16 COMMAND Planimeter
+  -Q --input-string "10 0;10 1;20 1;20 0")
+set_tests_properties (Planimeter16 PROPERTIES PASS_REGULAR_EXPRESSION
+  "4 2429392\\.819809 118857587625\\.9")
+
 # Check fix for AlbersEqualArea::Reverse bug found 2011-05-01
 add_test (NAME ConicProj0 COMMAND ConicProj
   -a 40d58 39d56 -l 77d45W -r --input-string "220e3 -52e3")
@@ -256,6 +285,17 @@ set_tests_properties (ConicProj7 PROPERTIES PASS_REGULAR_EXPRESSION
 add_test (NAME ConicProj8 COMMAND ConicProj -r -c 90 90 --input-string "0 -inf")
 set_tests_properties (ConicProj8 PROPERTIES PASS_REGULAR_EXPRESSION
   "^-90\\.0+ -?0\\.00[0-9]+ ")
+# CSV input and output with the lines processed in parallel
+add_test (NAME ConicProj9 COMMAND ConicProj -c 30 50 -j 2 --csv
+  --input-string "40,-100;35 , 10")
+set_tests_properties (ConicProj9 PROPERTIES PASS_REGULAR_EXPRESSION
+  "^-6737230\\.540683,4232783\\.141631,-64\\.615970931513,0\\.984839777189
+900803\\.335565,-524088\\.331515,6\\.461597093151,0\\.988863779230")
+# Check the inverse conformal latitude for a prolate ellipsoid
+add_test (NAME ConicProj10 COMMAND ConicProj
+  -r -c 40 60 -e 6378137 -1/3 -p 10 --input-string "100000 3000000")
+set_tests_properties (ConicProj10 PROPERTIES PASS_REGULAR_EXPRESSION
+  "^79\\.97199051556")
 
 add_test (NAME CartConvert0 COMMAND CartConvert
   -e 6.4e6 1/100 -r --input-string "10e3 0 1e3")
@@ -278,6 +318,13 @@ add_test (NAME TransverseMercatorProj1 COMMAND TransverseMercatorProj
   -k 1 -r --input-string "0 10001965.7293127228")
 set_tests_properties (TransverseMercatorProj1 PROPERTIES PASS_REGULAR_EXPRESSION
   "(90\\.0+ 0\\.0+ 0\\.0+|(90\\.0+|89\\.99999999999[0-9]+) -?180\\.0+ -?180\\.0+) (1\\.0000+|0\\.9999+)")
+# CSV input and output with the lines processed in parallel
+add_test (NAME TransverseMercatorProj2 COMMAND TransverseMercatorProj
+  -j 2 --csv --input-string "10,20;30, 4")
+set_tests_properties (TransverseMercatorProj2 PROPERTIES
+  PASS_REGULAR_EXPRESSION
+  "^2235209\\.504622,1175297\\.345031,3\\.619475622759,1\\.062074627143
+385948\\.582762,3325528\\.347173,2\\.002477080266,1\\.001438262637")
 
 # Test fix to bad handling of pole by RhumbSolve -i
 # Reported  2015-02-24 by Thomas Murray <thomas.murray56@gmail.com>;
@@ -287,6 +334,42 @@ add_test (NAME RhumbSolve1 COMMAND RhumbSolve
   -p 3 -i --input-string "0 0 90 0" -s)
 set_tests_properties (RhumbSolve0 RhumbSolve1 PROPERTIES PASS_REGULAR_EXPRESSION
   "^0\\.0+ 10001965\\.729 ")
+# With the exact option, the Fourier series for the rectifying latitude
+# are used for the divided differences; check a line crossing the equator
+# on a strongly prolate ellipsoid (the direct evaluation of the divided
+# differences gave 102811230.8 m for this case)
+add_test (NAME RhumbSolve2 COMMAND RhumbSolve -p 3 -i -e 6378137 -0.5
+  --input-string "63.81336027468245 0 -63.42039921945911 175.7654655332516")
+set_tests_properties (RhumbSolve2 PROPERTIES PASS_REGULAR_EXPRESSION
+  "^146\\.64038592 25310998\\.536 ")
+# For f = -1.5 the series don't converge and the divided differences are
+# evaluated directly.  For e^2 < -1, the difference of the eatanhe terms of
+# the isometric latitude, Rhumb::Deatanhe, was off by pi for lines crossing
+# the equator, giving -257708118.136 m for this case.
+add_test (NAME RhumbSolve3 COMMAND RhumbSolve -p 3 -i -e 6378137 -1.5
+  --input-string "40 0 -50 30")
+set_tests_properties (RhumbSolve3 PROPERTIES PASS_REGULAR_EXPRESSION
+  "^175\\.33642463 31303922\\.947 ")
+
+if (NOT WIN32)
+  # Two requests on a kept-alive connection to GeographicServer
+  add_test (NAME GeographicServer0 COMMAND GeographicServer -p 12
+    --input-string "POST /geodesic/inverse HTTP/1.1;Content-Length: 11;;[[0,0,1,1]]POST /area HTTP/1.1;Content-Length: 19;;[[0,0,0,1,1,1,1,0]]")
+  set_tests_properties (GeographicServer0 PROPERTIES PASS_REGULAR_EXPRESSION
+    "200 OK.*\\[\\[45\\.1880402294,45\\.1967673216,156899\\.568291\\]\\].*200 OK.*\\[\\[4,443770\\.917248,12308778361\\.5\\]\\]")
+  # An unknown operation and a malformed body give errors
+  add_test (NAME GeographicServer1 COMMAND GeographicServer
+    --input-string "POST /nope HTTP/1.1;;POST /rhumb/direct HTTP/1.1;Content-Length: 5;;[[0,]")
+  set_tests_properties (GeographicServer1 PROPERTIES PASS_REGULAR_EXPRESSION
+    "404 Not Found.*400 Bad Request")
+  # A latitude out of range gives a record of nulls and records of the
+  # wrong length (here two records of 2 values for /geodesic/inverse) are
+  # rejected
+  add_test (NAME GeographicServer2 COMMAND GeographicServer -p 8
+    --input-string "POST /utm HTTP/1.1;Content-Length: 14;;[[91,0],[0,0]]POST /geodesic/inverse HTTP/1.1;Content-Length: 13;;[[0,0],[1,1]]")
+  set_tests_properties (GeographicServer2 PROPERTIES PASS_REGULAR_EXPRESSION
+    "\\[\\[null,null,null,null\\],\\[31,1,166021\\.44,0\\]\\].*400 Bad Request.*Record 0 does not have 4 values")
+endif ()
 
 if (EXISTS ${GEOGRAPHICLIB_DATA}/geoids/egm96-5.pgm)
   # Check fix for single-cell cache bug found 2010-11-23